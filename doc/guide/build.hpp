@@ -186,6 +186,8 @@ The full list of options mlpack allows:
        of CXXFLAGS (default OFF)
  - USE_OPENMP=(ON/OFF): if ON, then use OpenMP if the compiler supports it; if
        OFF, OpenMP support is manually disabled (default ON)
+ - USE_MPI=(ON/OFF): if ON, find MPI and build the programs that need it, like
+       mlpack_mpi_kmeans (default OFF)
 
 Each option can be specified to CMake with the '-D' flag.  Other tools can also
 be used to configure CMake, but those are not documented here.
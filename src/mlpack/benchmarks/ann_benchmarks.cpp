@@ -0,0 +1,129 @@
+/**
+ * @file benchmarks/ann_benchmarks.cpp
+ *
+ * Benchmarks of the forward and backward passes of single neural network
+ * layers and of a whole FFN.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "benchmark.hpp"
+
+#include <mlpack/methods/ann/ffn.hpp>
+#include <mlpack/methods/ann/layer/layer.hpp>
+#include <mlpack/methods/ann/loss_functions/mean_squared_error.hpp>
+
+using namespace mlpack;
+using namespace mlpack::ann;
+using namespace mlpack::benchmark;
+
+//! The size of the batches given to the layers.
+static const size_t batchSize = 256;
+
+//! Time the forward pass and the backward pass of a Linear layer, and the
+//! computation of its gradient.
+void LinearBenchmark(Benchmark& b)
+{
+  const size_t inSize = 512, outSize = 512;
+  b.Parameter("input_size", inSize);
+  b.Parameter("output_size", outSize);
+  b.Parameter("batch_size", batchSize);
+
+  Linear<> layer(inSize, outSize);
+  layer.Parameters().randn();
+  layer.Reset();
+
+  const arma::mat input(inSize, batchSize, arma::fill::randn);
+  const arma::mat error(outSize, batchSize, arma::fill::randn);
+  arma::mat output, delta;
+  arma::mat gradient(layer.Parameters().n_rows, 1);
+
+  b.Run("forward", [&]() { layer.Forward(input, output); });
+  b.Run("backward", [&]() { layer.Backward(input, error, delta); });
+  b.Run("gradient", [&]() { layer.Gradient(input, error, gradient); });
+}
+
+MLPACK_REGISTER_BENCHMARK("ann/linear", LinearBenchmark);
+
+//! Time the forward and backward passes of an activation layer.
+template<typename LayerType>
+void ActivationBenchmark(Benchmark& b)
+{
+  const size_t size = 4096;
+  b.Parameter("size", size);
+  b.Parameter("batch_size", batchSize);
+
+  LayerType layer;
+  const arma::mat input(size, batchSize, arma::fill::randn);
+  const arma::mat error(size, batchSize, arma::fill::randn);
+  arma::mat output, delta;
+  layer.Forward(input, output);
+
+  b.Run("forward", [&]() { layer.Forward(input, output); });
+  b.Run("backward", [&]() { layer.Backward(output, error, delta); });
+}
+
+MLPACK_REGISTER_BENCHMARK("ann/relu", ActivationBenchmark<ReLULayer<>>);
+MLPACK_REGISTER_BENCHMARK("ann/sigmoid", ActivationBenchmark<SigmoidLayer<>>);
+MLPACK_REGISTER_BENCHMARK("ann/tanh", ActivationBenchmark<TanHLayer<>>);
+
+//! Time the forward and backward passes of a convolution layer.
+void ConvolutionBenchmark(Benchmark& b)
+{
+  const size_t inMaps = 8, outMaps = 16, size = 32, kernel = 3;
+  const size_t convBatch = 32;
+  b.Parameter("input_maps", inMaps);
+  b.Parameter("output_maps", outMaps);
+  b.Parameter("input_size", size);
+  b.Parameter("kernel_size", kernel);
+  b.Parameter("batch_size", convBatch);
+
+  Convolution<> layer(inMaps, outMaps, kernel, kernel, 1, 1, 1, 1, size, size);
+  layer.Parameters().randn();
+  layer.Reset();
+
+  const arma::mat input(inMaps * size * size, convBatch, arma::fill::randn);
+  arma::mat output, delta;
+  layer.Forward(input, output);
+  const arma::mat error(output.n_rows, output.n_cols, arma::fill::randn);
+  arma::mat gradient(layer.Parameters().n_rows, 1);
+
+  b.Run("forward", [&]() { layer.Forward(input, output); });
+  b.Run("backward", [&]() { layer.Backward(output, error, delta); });
+  b.Run("gradient", [&]() { layer.Gradient(input, error, gradient); });
+}
+
+MLPACK_REGISTER_BENCHMARK("ann/convolution", ConvolutionBenchmark);
+
+//! Time the forward and backward passes of a multilayer perceptron.
+void FFNBenchmark(Benchmark& b)
+{
+  const size_t inSize = 256, hiddenSize = 512, outSize = 10;
+  b.Parameter("input_size", inSize);
+  b.Parameter("hidden_size", hiddenSize);
+  b.Parameter("output_size", outSize);
+  b.Parameter("batch_size", batchSize);
+
+  FFN<MeanSquaredError<>> model;
+  model.Add<Linear<>>(inSize, hiddenSize);
+  model.Add<ReLULayer<>>();
+  model.Add<Linear<>>(hiddenSize, hiddenSize);
+  model.Add<ReLULayer<>>();
+  model.Add<Linear<>>(hiddenSize, outSize);
+
+  const arma::mat input(inSize, batchSize, arma::fill::randn);
+  const arma::mat targets(outSize, batchSize, arma::fill::randu);
+  arma::mat output, gradients;
+  model.Forward(input, output);
+
+  b.Run("forward", [&]() { model.Forward(input, output); });
+  b.Run("forward_backward", [&]()
+  {
+    model.Forward(input, output);
+    model.Backward(input, targets, gradients);
+  });
+}
+
+MLPACK_REGISTER_BENCHMARK("ann/ffn", FFNBenchmark);
@@ -0,0 +1,134 @@
+/**
+ * @file benchmarks/benchmark.cpp
+ *
+ * Implementation of the benchmark harness.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "benchmark.hpp"
+
+#include <mlpack/core/util/version.hpp>
+
+#include <fstream>
+
+using namespace mlpack;
+using namespace mlpack::benchmark;
+
+std::map<std::string, BenchmarkFunction>& benchmark::Registry()
+{
+  static std::map<std::string, BenchmarkFunction> registry;
+  return registry;
+}
+
+std::string Benchmark::DataFile(const std::string& filename)
+{
+  const std::string path = options.dataDir + "/" + filename;
+  std::ifstream stream(path.c_str());
+  if (!stream.is_open())
+  {
+    Log::Warn << name << ": dataset '" << path << "' not found; skipping."
+        << std::endl;
+    skipped = true;
+    return "";
+  }
+
+  return path;
+}
+
+arma::mat Benchmark::Clusters(const size_t dimensionality,
+                              const size_t points,
+                              const size_t clusters,
+                              arma::Row<size_t>* labels) const
+{
+  const arma::mat centers(dimensionality, clusters, arma::fill::randu);
+
+  arma::mat data(dimensionality, points, arma::fill::randn);
+  data *= 0.05;
+  if (labels)
+    labels->set_size(points);
+  for (size_t i = 0; i < points; ++i)
+  {
+    const size_t cluster = math::RandInt(clusters);
+    data.col(i) += centers.col(cluster);
+    if (labels)
+      (*labels)[i] = cluster;
+  }
+
+  return data;
+}
+
+std::string Benchmark::TemporaryFile(const std::string& filename) const
+{
+  return "mlpack_benchmark_" + filename;
+}
+
+namespace {
+
+//! Write the given string as a JSON string.
+void WriteString(std::ostream& stream, const std::string& str)
+{
+  stream << '"';
+  for (const char c : str)
+  {
+    if (c == '"' || c == '\\')
+      stream << '\\';
+    stream << c;
+  }
+  stream << '"';
+}
+
+} // anonymous namespace
+
+void benchmark::WriteJSON(std::ostream& stream,
+                          const Options& options,
+                          const std::vector<Result>& results,
+                          const std::vector<std::string>& skipped)
+{
+  stream.precision(9);
+
+  stream << "{" << std::endl;
+  stream << "  \"mlpack_version\": ";
+  WriteString(stream, util::GetVersion());
+  stream << "," << std::endl;
+
+  size_t threads = 1;
+  #ifdef HAS_OPENMP
+  threads = omp_get_max_threads();
+  #endif
+  stream << "  \"threads\": " << threads << "," << std::endl;
+  stream << "  \"seed\": " << options.seed << "," << std::endl;
+  stream << "  \"scale\": " << options.scale << "," << std::endl;
+
+  stream << "  \"results\": [";
+  for (size_t i = 0; i < results.size(); ++i)
+  {
+    const Result& r = results[i];
+    stream << (i == 0 ? "" : ",") << std::endl << "    {\"name\": ";
+    WriteString(stream, r.name);
+    stream << ", \"repetitions\": " << r.repetitions << ", \"min_s\": "
+        << r.minimum << ", \"median_s\": " << r.median << ", \"mean_s\": "
+        << r.mean << ", \"parameters\": {";
+
+    bool first = true;
+    for (auto& it : r.parameters)
+    {
+      stream << (first ? "" : ", ");
+      WriteString(stream, it.first);
+      stream << ": " << it.second;
+      first = false;
+    }
+    stream << "}}";
+  }
+  stream << std::endl << "  ]," << std::endl;
+
+  stream << "  \"skipped\": [";
+  for (size_t i = 0; i < skipped.size(); ++i)
+  {
+    stream << (i == 0 ? "" : ", ");
+    WriteString(stream, skipped[i]);
+  }
+  stream << "]" << std::endl << "}" << std::endl;
+}
@@ -0,0 +1,250 @@
+/**
+ * @file benchmarks/benchmark.hpp
+ *
+ * The harness of the mlpack_benchmarks program: registration, timing at fixed
+ * seeds, and JSON results.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_BENCHMARKS_BENCHMARK_HPP
+#define MLPACK_BENCHMARKS_BENCHMARK_HPP
+
+#include <mlpack/core.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <ostream>
+
+namespace mlpack {
+namespace benchmark {
+
+//! The options of a run of the benchmarks.
+struct Options
+{
+  Options() :
+      seed(42),
+      scale(1.0),
+      minTime(0.5),
+      minRepetitions(3),
+      maxRepetitions(1000),
+      warmup(1)
+  { }
+
+  //! The seed of the random number generators, set before the setup of each
+  //! benchmark and before each repetition.
+  size_t seed;
+  //! Factor applied to the size of the synthetic datasets.
+  double scale;
+  //! Each timed function is repeated for at least this many seconds...
+  double minTime;
+  //! ... and at least this many times...
+  size_t minRepetitions;
+  //! ... but at most this many times.
+  size_t maxRepetitions;
+  //! The number of untimed runs before the timed repetitions.
+  size_t warmup;
+  //! The directory of the standard datasets.
+  std::string dataDir;
+};
+
+//! The timings of one timed function.
+struct Result
+{
+  //! The full name: the name of the benchmark, '/', and the label.
+  std::string name;
+  //! The number of timed repetitions.
+  size_t repetitions;
+  //! The fastest repetition, in seconds.
+  double minimum;
+  //! The median repetition, in seconds.
+  double median;
+  //! The mean repetition, in seconds.
+  double mean;
+  //! The parameters of the benchmark (e.g. dataset sizes) when it ran.
+  std::map<std::string, double> parameters;
+};
+
+/**
+ * A Benchmark is given to each benchmark function, which sets up its data and
+ * then times one or more functions with Run().  For example:
+ *
+ * @code
+ * void KMeansBenchmark(benchmark::Benchmark& b)
+ * {
+ *   arma::mat data = b.Clusters(10, b.Scaled(100000), 5);
+ *   b.Parameter("points", data.n_cols);
+ *
+ *   arma::mat centroids;
+ *   b.Run("cluster", [&]() { kmeans::KMeans<> k(10); k.Cluster(data, 5,
+ *       centroids); });
+ * }
+ * MLPACK_REGISTER_BENCHMARK("kmeans/naive", KMeansBenchmark);
+ * @endcode
+ */
+class Benchmark
+{
+ public:
+  /**
+   * Create the benchmark with the given name.
+   *
+   * @param name Name of the benchmark.
+   * @param options Options of the run.
+   * @param results The results of Run() are appended to this.
+   */
+  Benchmark(const std::string& name,
+            const Options& options,
+            std::vector<Result>& results) :
+      name(name), options(options), results(results), skipped(false) { }
+
+  //! Get the name of the benchmark.
+  const std::string& Name() const { return name; }
+  //! Get the options of the run.
+  const Options& Settings() const { return options; }
+
+  /**
+   * Time the given function: after the warmup runs, it is repeated as set by
+   * the options, resetting the random seed before each run, and the result is
+   * recorded under the given label.
+   *
+   * @param label Name of the timed function (e.g. "train").
+   * @param f Function to time.
+   */
+  template<typename FunctionType>
+  void Run(const std::string& label, FunctionType&& f);
+
+  //! Record a parameter of the benchmark; it is attached to the results of the
+  //! following calls to Run().
+  void Parameter(const std::string& key, const double value)
+  {
+    parameters[key] = value;
+  }
+
+  //! Scale the given number of points with the scale option (at least 1).
+  size_t Scaled(const size_t points) const
+  {
+    return std::max(size_t(1), size_t(points * options.scale));
+  }
+
+  /**
+   * Return the path of the given standard dataset, or an empty string (and
+   * mark the benchmark skipped) if it isn't in the data directory.
+   *
+   * @param filename Name of the dataset file.
+   */
+  std::string DataFile(const std::string& filename);
+
+  //! Return whether DataFile() could not find a dataset.
+  bool Skipped() const { return skipped; }
+
+  /**
+   * Generate a synthetic dataset of Gaussian clusters around uniformly random
+   * centers in the unit cube.
+   *
+   * @param dimensionality Dimensionality of the points.
+   * @param points Number of points.
+   * @param clusters Number of clusters.
+   * @param labels If given, set to the cluster of each point.
+   */
+  arma::mat Clusters(const size_t dimensionality,
+                     const size_t points,
+                     const size_t clusters,
+                     arma::Row<size_t>* labels = NULL) const;
+
+  //! Get the path of a temporary file with the given name.
+  std::string TemporaryFile(const std::string& filename) const;
+
+ private:
+  //! The name of the benchmark.
+  std::string name;
+  //! The options of the run.
+  const Options& options;
+  //! The list of all results.
+  std::vector<Result>& results;
+  //! The current parameters.
+  std::map<std::string, double> parameters;
+  //! Whether a dataset could not be found.
+  bool skipped;
+};
+
+//! A benchmark function.
+typedef void (*BenchmarkFunction)(Benchmark&);
+
+//! Get all registered benchmarks, by name.
+std::map<std::string, BenchmarkFunction>& Registry();
+
+//! Registers a benchmark when it is constructed; use
+//! MLPACK_REGISTER_BENCHMARK().
+struct Registrar
+{
+  Registrar(const std::string& name, BenchmarkFunction function)
+  {
+    Registry()[name] = function;
+  }
+};
+
+/**
+ * Write the results as a JSON object, with the version of mlpack, the options,
+ * the list of results, and the names of the skipped benchmarks.
+ */
+void WriteJSON(std::ostream& stream,
+               const Options& options,
+               const std::vector<Result>& results,
+               const std::vector<std::string>& skipped);
+
+template<typename FunctionType>
+void Benchmark::Run(const std::string& label, FunctionType&& f)
+{
+  typedef std::chrono::steady_clock Clock;
+
+  for (size_t i = 0; i < options.warmup; ++i)
+  {
+    math::RandomSeed(options.seed);
+    f();
+  }
+
+  std::vector<double> times;
+  double total = 0.0;
+  while (times.size() < options.maxRepetitions &&
+      (times.size() < options.minRepetitions || total < options.minTime))
+  {
+    math::RandomSeed(options.seed);
+    const Clock::time_point start = Clock::now();
+    f();
+    const double time = std::chrono::duration<double>(Clock::now() -
+        start).count();
+
+    times.push_back(time);
+    total += time;
+  }
+
+  Result result;
+  result.name = name + "/" + label;
+  result.repetitions = times.size();
+  result.mean = total / times.size();
+  std::sort(times.begin(), times.end());
+  result.minimum = times[0];
+  result.median = (times.size() % 2 == 1) ? times[times.size() / 2] :
+      (times[times.size() / 2 - 1] + times[times.size() / 2]) / 2.0;
+  result.parameters = parameters;
+  results.push_back(result);
+}
+
+} // namespace benchmark
+} // namespace mlpack
+
+#define MLPACK_BENCHMARK_CONCAT_INNER(A, B) A ## B
+#define MLPACK_BENCHMARK_CONCAT(A, B) MLPACK_BENCHMARK_CONCAT_INNER(A, B)
+
+/**
+ * Register the given benchmark function under the given name; the name should
+ * be of the form "category/variant".
+ */
+#define MLPACK_REGISTER_BENCHMARK(NAME, ...) \
+    static ::mlpack::benchmark::Registrar MLPACK_BENCHMARK_CONCAT( \
+        benchmarkRegistrar, __LINE__)(NAME, __VA_ARGS__)
+
+#endif
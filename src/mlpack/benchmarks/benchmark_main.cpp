@@ -0,0 +1,142 @@
+/**
+ * @file benchmarks/benchmark_main.cpp
+ *
+ * The mlpack_benchmarks program, which runs the registered benchmarks and
+ * writes their timings as JSON.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "benchmark.hpp"
+
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+
+using namespace mlpack;
+using namespace mlpack::benchmark;
+
+static void PrintUsage(const char* program)
+{
+  std::cerr << "Usage: " << program << " [options]" << std::endl
+      << std::endl
+      << "Run the mlpack benchmarks and write their timings as JSON."
+      << std::endl << std::endl
+      << "  --filter <string>     Only run benchmarks whose name contains the "
+      << "string." << std::endl
+      << "  --list                List the benchmarks and exit." << std::endl
+      << "  --output <file>       Write the JSON results to the file (default:"
+      << " standard output)." << std::endl
+      << "  --seed <n>            Random seed (default: 42)." << std::endl
+      << "  --scale <x>           Scale of the synthetic datasets (default: 1)."
+      << std::endl
+      << "  --min_time <seconds>  Minimum time of each timed function "
+      << "(default: 0.5)." << std::endl
+      << "  --max_repetitions <n> Maximum repetitions of each timed function "
+      << "(default: 1000)." << std::endl
+      << "  --data_dir <dir>      Directory of the standard datasets (default: "
+      << MLPACK_BENCHMARK_DATA_DIR << ")." << std::endl;
+}
+
+int main(int argc, char** argv)
+{
+  Options options;
+  options.dataDir = MLPACK_BENCHMARK_DATA_DIR;
+  std::string filter, output;
+  bool list = false;
+
+  for (int i = 1; i < argc; ++i)
+  {
+    const std::string arg = argv[i];
+    if (arg == "--list")
+    {
+      list = true;
+      continue;
+    }
+    else if (arg == "--help" || arg == "-h" || i + 1 == argc)
+    {
+      PrintUsage(argv[0]);
+      return (arg == "--help" || arg == "-h") ? 0 : 1;
+    }
+
+    const std::string value = argv[++i];
+    if (arg == "--filter")
+      filter = value;
+    else if (arg == "--output")
+      output = value;
+    else if (arg == "--seed")
+      options.seed = std::strtoul(value.c_str(), NULL, 10);
+    else if (arg == "--scale")
+      options.scale = std::atof(value.c_str());
+    else if (arg == "--min_time")
+      options.minTime = std::atof(value.c_str());
+    else if (arg == "--max_repetitions")
+      options.maxRepetitions = std::strtoul(value.c_str(), NULL, 10);
+    else if (arg == "--data_dir")
+      options.dataDir = value;
+    else
+    {
+      PrintUsage(argv[0]);
+      return 1;
+    }
+  }
+
+  if (options.scale <= 0.0 || options.maxRepetitions == 0)
+  {
+    std::cerr << "--scale and --max_repetitions must be positive." << std::endl;
+    return 1;
+  }
+  options.minRepetitions = std::min(options.minRepetitions,
+      options.maxRepetitions);
+
+  std::vector<Result> results;
+  std::vector<std::string> skipped;
+  for (auto& it : Registry())
+  {
+    if (it.first.find(filter) == std::string::npos)
+      continue;
+
+    if (list)
+    {
+      std::cout << it.first << std::endl;
+      continue;
+    }
+
+    std::cerr << it.first << "..." << std::endl;
+    const size_t firstResult = results.size();
+    Benchmark b(it.first, options, results);
+    math::RandomSeed(options.seed);
+    it.second(b);
+    if (b.Skipped())
+      skipped.push_back(it.first);
+
+    for (size_t i = firstResult; i < results.size(); ++i)
+    {
+      std::cerr << "  " << results[i].name << ": " << results[i].median
+          << "s (median of " << results[i].repetitions << ")" << std::endl;
+    }
+  }
+
+  if (list)
+    return 0;
+
+  if (output.empty())
+  {
+    WriteJSON(std::cout, options, results, skipped);
+  }
+  else
+  {
+    std::ofstream stream(output.c_str());
+    if (!stream.is_open())
+    {
+      std::cerr << "Cannot open file '" << output << "'." << std::endl;
+      return 1;
+    }
+
+    WriteJSON(stream, options, results, skipped);
+  }
+
+  return 0;
+}
@@ -0,0 +1,161 @@
+/**
+ * @file benchmarks/data_benchmarks.cpp
+ *
+ * Benchmarks of dataset loading (CSV and ARFF) and of model serialization.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "benchmark.hpp"
+
+#include <mlpack/methods/neighbor_search/neighbor_search.hpp>
+#include <mlpack/methods/random_forest/random_forest.hpp>
+
+#include <cstdio>
+#include <fstream>
+
+using namespace mlpack;
+using namespace mlpack::benchmark;
+
+//! Load a synthetic numeric CSV file.
+void CSVBenchmark(Benchmark& b)
+{
+  const arma::mat dataset = b.Clusters(20, b.Scaled(100000), 10);
+  b.Parameter("dimensionality", dataset.n_rows);
+  b.Parameter("points", dataset.n_cols);
+
+  const std::string file = b.TemporaryFile("data.csv");
+  data::Save(file, dataset, true);
+
+  arma::mat loaded;
+  b.Run("load", [&]() { data::Load(file, loaded, true); });
+
+  std::remove(file.c_str());
+}
+
+MLPACK_REGISTER_BENCHMARK("load/csv_synthetic", CSVBenchmark);
+
+//! Load a standard CSV file.
+void CSVStandardBenchmark(Benchmark& b)
+{
+  const std::string file = b.DataFile("nbc_high_dim_train.csv");
+  if (file.empty())
+    return;
+
+  arma::mat loaded;
+  data::Load(file, loaded, true);
+  b.Parameter("dimensionality", loaded.n_rows);
+  b.Parameter("points", loaded.n_cols);
+
+  b.Run("load", [&]() { data::Load(file, loaded, true); });
+}
+
+MLPACK_REGISTER_BENCHMARK("load/csv_nbc_high_dim", CSVStandardBenchmark);
+
+//! Load a synthetic ARFF file with numeric and nominal attributes.
+void ARFFBenchmark(Benchmark& b)
+{
+  const size_t numeric = 10, nominal = 2, points = b.Scaled(50000);
+  b.Parameter("numeric_dimensions", numeric);
+  b.Parameter("nominal_dimensions", nominal);
+  b.Parameter("points", points);
+
+  const std::string file = b.TemporaryFile("data.arff");
+  {
+    std::ofstream stream(file.c_str());
+    stream << "@relation benchmark" << std::endl;
+    for (size_t d = 0; d < numeric; ++d)
+      stream << "@attribute x" << d << " numeric" << std::endl;
+    for (size_t d = 0; d < nominal; ++d)
+      stream << "@attribute c" << d << " {red, green, blue}" << std::endl;
+    stream << "@data" << std::endl;
+
+    const char* values[] = { "red", "green", "blue" };
+    for (size_t i = 0; i < points; ++i)
+    {
+      for (size_t d = 0; d < numeric; ++d)
+        stream << math::Random() << ",";
+      for (size_t d = 0; d < nominal; ++d)
+        stream << values[math::RandInt(3)] << (d + 1 < nominal ? "," : "");
+      stream << std::endl;
+    }
+  }
+
+  arma::mat loaded;
+  b.Run("load", [&]()
+  {
+    data::DatasetInfo info;
+    data::Load(file, loaded, info, true);
+  });
+
+  std::remove(file.c_str());
+}
+
+MLPACK_REGISTER_BENCHMARK("load/arff_synthetic", ARFFBenchmark);
+
+/**
+ * Save and load the given model in each format.
+ *
+ * @param b The benchmark.
+ * @param name Name of the model in the files.
+ * @param model Model to serialize.
+ */
+template<typename ModelType>
+void SerializationBenchmark(Benchmark& b,
+                            const std::string& name,
+                            ModelType& model)
+{
+  const std::vector<std::pair<std::string, data::format>> formats = {
+      { "xml", data::format::xml },
+      { "text", data::format::text },
+      { "binary", data::format::binary },
+      { "portable_binary", data::format::portable_binary } };
+
+  for (const std::pair<std::string, data::format>& f : formats)
+  {
+    const std::string file = b.TemporaryFile(name + "." + f.first);
+    b.Run("save_" + f.first, [&]()
+    {
+      data::Save(file, name, model, true, f.second);
+    });
+
+    ModelType loaded;
+    b.Run("load_" + f.first, [&]()
+    {
+      data::Load(file, name, loaded, true, f.second);
+    });
+
+    std::remove(file.c_str());
+  }
+}
+
+//! Serialize a KNN model, which holds a kd-tree and its reference set.
+void KNNSerializationBenchmark(Benchmark& b)
+{
+  const arma::mat referenceSet = b.Clusters(5, b.Scaled(50000), 20);
+  b.Parameter("dimensionality", referenceSet.n_rows);
+  b.Parameter("points", referenceSet.n_cols);
+
+  neighbor::KNN knn(referenceSet);
+  SerializationBenchmark(b, "knn", knn);
+}
+
+MLPACK_REGISTER_BENCHMARK("serialization/knn", KNNSerializationBenchmark);
+
+//! Serialize a RandomForest, which holds many small objects.
+void RandomForestSerializationBenchmark(Benchmark& b)
+{
+  arma::Row<size_t> labels;
+  const arma::mat dataset = b.Clusters(10, b.Scaled(10000), 5, &labels);
+  b.Parameter("dimensionality", dataset.n_rows);
+  b.Parameter("points", dataset.n_cols);
+  b.Parameter("trees", 20);
+
+  tree::RandomForest<> forest(dataset, labels, 5, 20);
+  SerializationBenchmark(b, "random_forest", forest);
+}
+
+MLPACK_REGISTER_BENCHMARK("serialization/random_forest",
+    RandomForestSerializationBenchmark);
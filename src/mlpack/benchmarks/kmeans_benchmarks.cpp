@@ -0,0 +1,55 @@
+/**
+ * @file benchmarks/kmeans_benchmarks.cpp
+ *
+ * Benchmarks of k-means clustering with each Lloyd step type.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "benchmark.hpp"
+
+#include <mlpack/methods/kmeans/kmeans.hpp>
+#include <mlpack/methods/kmeans/elkan_kmeans.hpp>
+#include <mlpack/methods/kmeans/hamerly_kmeans.hpp>
+#include <mlpack/methods/kmeans/pelleg_moore_kmeans.hpp>
+#include <mlpack/methods/kmeans/dual_tree_kmeans.hpp>
+
+using namespace mlpack;
+using namespace mlpack::benchmark;
+using namespace mlpack::kmeans;
+
+/**
+ * Run 10 iterations of k-means with 20 clusters, from the same initial
+ * centroids for each step type.
+ */
+template<template<class, class> class LloydStepType>
+void KMeansBenchmark(Benchmark& b)
+{
+  const arma::mat data = b.Clusters(10, b.Scaled(50000), 20);
+  const arma::mat initialCentroids = data.cols(0, 19);
+  b.Parameter("dimensionality", data.n_rows);
+  b.Parameter("points", data.n_cols);
+  b.Parameter("clusters", 20);
+  b.Parameter("iterations", 10);
+
+  KMeans<metric::EuclideanDistance, SampleInitialization,
+      MaxVarianceNewCluster, LloydStepType> kmeans(10);
+  arma::mat centroids;
+  b.Run("cluster", [&]()
+  {
+    centroids = initialCentroids;
+    kmeans.Cluster(data, 20, centroids, true);
+  });
+}
+
+MLPACK_REGISTER_BENCHMARK("kmeans/naive", KMeansBenchmark<NaiveKMeans>);
+MLPACK_REGISTER_BENCHMARK("kmeans/elkan", KMeansBenchmark<ElkanKMeans>);
+MLPACK_REGISTER_BENCHMARK("kmeans/hamerly", KMeansBenchmark<HamerlyKMeans>);
+MLPACK_REGISTER_BENCHMARK("kmeans/pelleg_moore",
+    KMeansBenchmark<PellegMooreKMeans>);
+MLPACK_REGISTER_BENCHMARK("kmeans/dual_tree",
+    KMeansBenchmark<DefaultDualTreeKMeans>);
+MLPACK_REGISTER_BENCHMARK("kmeans/dual_tree_cover_tree",
+    KMeansBenchmark<CoverTreeDualTreeKMeans>);
@@ -0,0 +1,123 @@
+/**
+ * @file benchmarks/neighbor_search_benchmarks.cpp
+ *
+ * Benchmarks of k-nearest-neighbor search with each tree type, and of kernel
+ * density estimation.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "benchmark.hpp"
+
+#include <mlpack/core/tree/cover_tree.hpp>
+#include <mlpack/core/tree/octree.hpp>
+#include <mlpack/core/tree/rectangle_tree.hpp>
+#include <mlpack/methods/neighbor_search/neighbor_search.hpp>
+#include <mlpack/methods/kde/kde.hpp>
+
+using namespace mlpack;
+using namespace mlpack::benchmark;
+using namespace mlpack::neighbor;
+
+/**
+ * Build the tree on a reference set and find the 5 nearest neighbors of a
+ * query set, with the dual-tree and single-tree algorithms.
+ */
+template<template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void KNNBenchmark(Benchmark& b)
+{
+  typedef NeighborSearch<NearestNeighborSort, metric::EuclideanDistance,
+      arma::mat, TreeType> KNNType;
+
+  const arma::mat referenceSet = b.Clusters(5, b.Scaled(50000), 20);
+  const arma::mat querySet = b.Clusters(5, b.Scaled(5000), 20);
+  b.Parameter("dimensionality", referenceSet.n_rows);
+  b.Parameter("reference_points", referenceSet.n_cols);
+  b.Parameter("query_points", querySet.n_cols);
+  b.Parameter("k", 5);
+
+  b.Run("train", [&]() { KNNType knn(referenceSet); });
+
+  KNNType knn(referenceSet);
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  b.Run("dual_tree_search", [&]()
+  {
+    knn.SearchMode() = DUAL_TREE_MODE;
+    knn.Search(querySet, 5, neighbors, distances);
+  });
+  b.Run("single_tree_search", [&]()
+  {
+    knn.SearchMode() = SINGLE_TREE_MODE;
+    knn.Search(querySet, 5, neighbors, distances);
+  });
+}
+
+MLPACK_REGISTER_BENCHMARK("knn/kd_tree", KNNBenchmark<tree::KDTree>);
+MLPACK_REGISTER_BENCHMARK("knn/ball_tree", KNNBenchmark<tree::BallTree>);
+MLPACK_REGISTER_BENCHMARK("knn/cover_tree",
+    KNNBenchmark<tree::StandardCoverTree>);
+MLPACK_REGISTER_BENCHMARK("knn/r_tree", KNNBenchmark<tree::RTree>);
+MLPACK_REGISTER_BENCHMARK("knn/r_star_tree", KNNBenchmark<tree::RStarTree>);
+MLPACK_REGISTER_BENCHMARK("knn/octree", KNNBenchmark<tree::Octree>);
+MLPACK_REGISTER_BENCHMARK("knn/vp_tree", KNNBenchmark<tree::VPTree>);
+MLPACK_REGISTER_BENCHMARK("knn/rp_tree", KNNBenchmark<tree::RPTree>);
+
+/**
+ * The all-nearest-neighbors search of a standard dataset with a kd-tree.
+ */
+void KNNStandardBenchmark(Benchmark& b)
+{
+  const std::string file = b.DataFile("thyroid_train.csv");
+  if (file.empty())
+    return;
+
+  arma::mat dataset;
+  data::Load(file, dataset, true);
+  b.Parameter("dimensionality", dataset.n_rows);
+  b.Parameter("points", dataset.n_cols);
+  b.Parameter("k", 5);
+
+  KNN knn(dataset);
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  b.Run("all_knn", [&]() { knn.Search(5, neighbors, distances); });
+}
+
+MLPACK_REGISTER_BENCHMARK("knn/kd_tree_thyroid", KNNStandardBenchmark);
+
+/**
+ * Estimate the Gaussian kernel density of a query set, with the dual-tree
+ * algorithm.
+ */
+template<template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void KDEBenchmark(Benchmark& b)
+{
+  typedef kde::KDE<kernel::GaussianKernel, metric::EuclideanDistance,
+      arma::mat, TreeType> KDEType;
+
+  const arma::mat referenceSet = b.Clusters(3, b.Scaled(20000), 10);
+  const arma::mat querySet = b.Clusters(3, b.Scaled(2000), 10);
+  b.Parameter("dimensionality", referenceSet.n_rows);
+  b.Parameter("reference_points", referenceSet.n_cols);
+  b.Parameter("query_points", querySet.n_cols);
+  b.Parameter("relative_error", 0.05);
+  b.Parameter("bandwidth", 0.1);
+
+  KDEType kde(0.05, 0.0, kernel::GaussianKernel(0.1));
+  b.Run("train", [&]() { kde.Train(referenceSet); });
+
+  arma::vec estimations;
+  b.Run("evaluate", [&]() { kde.Evaluate(querySet, estimations); });
+}
+
+MLPACK_REGISTER_BENCHMARK("kde/kd_tree", KDEBenchmark<tree::KDTree>);
+MLPACK_REGISTER_BENCHMARK("kde/ball_tree", KDEBenchmark<tree::BallTree>);
+MLPACK_REGISTER_BENCHMARK("kde/cover_tree",
+    KDEBenchmark<tree::StandardCoverTree>);
@@ -0,0 +1,95 @@
+/**
+ * @file benchmarks/tree_benchmarks.cpp
+ *
+ * Benchmarks of DecisionTree and RandomForest training and classification.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "benchmark.hpp"
+
+#include <mlpack/methods/decision_tree/decision_tree.hpp>
+#include <mlpack/methods/random_forest/random_forest.hpp>
+
+using namespace mlpack;
+using namespace mlpack::benchmark;
+using namespace mlpack::tree;
+
+/**
+ * Train a model of the given type with the given function, then classify the
+ * training set.
+ */
+template<typename ModelType, typename TrainFunctionType>
+void TrainAndClassify(Benchmark& b,
+                      const arma::mat& dataset,
+                      const TrainFunctionType& train)
+{
+  b.Run("train", [&]() { ModelType model = train(); });
+
+  const ModelType model = train();
+  arma::Row<size_t> predictions;
+  b.Run("classify", [&]() { model.Classify(dataset, predictions); });
+}
+
+//! Train a DecisionTree on synthetic data.
+void DecisionTreeBenchmark(Benchmark& b)
+{
+  arma::Row<size_t> labels;
+  const arma::mat dataset = b.Clusters(10, b.Scaled(20000), 5, &labels);
+  b.Parameter("dimensionality", dataset.n_rows);
+  b.Parameter("points", dataset.n_cols);
+  b.Parameter("classes", 5);
+  b.Parameter("minimum_leaf_size", 10);
+
+  TrainAndClassify<DecisionTree<>>(b, dataset, [&]()
+  {
+    return DecisionTree<>(dataset, labels, 5, 10);
+  });
+}
+
+MLPACK_REGISTER_BENCHMARK("decision_tree/synthetic", DecisionTreeBenchmark);
+
+//! Train a RandomForest on synthetic data.
+void RandomForestBenchmark(Benchmark& b)
+{
+  arma::Row<size_t> labels;
+  const arma::mat dataset = b.Clusters(10, b.Scaled(20000), 5, &labels);
+  b.Parameter("dimensionality", dataset.n_rows);
+  b.Parameter("points", dataset.n_cols);
+  b.Parameter("classes", 5);
+  b.Parameter("trees", 20);
+
+  TrainAndClassify<RandomForest<>>(b, dataset, [&]()
+  {
+    return RandomForest<>(dataset, labels, 5, 20);
+  });
+}
+
+MLPACK_REGISTER_BENCHMARK("random_forest/synthetic", RandomForestBenchmark);
+
+//! Train a RandomForest on the vertebral column dataset.
+void RandomForestStandardBenchmark(Benchmark& b)
+{
+  const std::string file = b.DataFile("vc2.csv");
+  const std::string labelsFile = b.DataFile("vc2_labels.txt");
+  if (file.empty() || labelsFile.empty())
+    return;
+
+  arma::mat dataset;
+  arma::Row<size_t> labels;
+  data::Load(file, dataset, true);
+  data::Load(labelsFile, labels, true);
+  b.Parameter("dimensionality", dataset.n_rows);
+  b.Parameter("points", dataset.n_cols);
+  b.Parameter("classes", 3);
+  b.Parameter("trees", 20);
+
+  TrainAndClassify<RandomForest<>>(b, dataset, [&]()
+  {
+    return RandomForest<>(dataset, labels, 3, 20);
+  });
+}
+
+MLPACK_REGISTER_BENCHMARK("random_forest/vc2", RandomForestStandardBenchmark);
@@ -71,8 +71,8 @@ class ROption
     data.input = input;
     data.loaded = false;
 
-    // Only "verbose" will be persistent.
-    if (identifier == "verbose")
+    // Only "verbose" and "threads" will be persistent.
+    if (identifier == "verbose" || identifier == "threads")
       data.persistent = true;
     else
       data.persistent = false;
@@ -82,7 +82,7 @@ class ROption
     data.value = boost::any(defaultValue);
 
     // Restore the parameters for this program.
-    if (identifier != "verbose")
+    if (identifier != "verbose" && identifier != "threads")
       IO::RestoreSettings(IO::ProgramName(), false);
 
     // Set the function pointers that we'll need.  All of these function
@@ -108,7 +108,7 @@ class ROption
     // import more than one .so or .o that uses IO, so we have to keep the
     // options separate.  programName is a global variable from mlpack_main.hpp.
     IO::Add(std::move(data));
-    if (identifier != "verbose")
+    if (identifier != "verbose" && identifier != "threads")
       IO::StoreSettings(IO::ProgramName());
     IO::ClearSettings();
   }
@@ -14,6 +14,9 @@
 #define MLPACK_BINDINGS_CLI_END_PROGRAM_HPP
 
 #include <mlpack/core/util/io.hpp>
+#include <mlpack/core/util/profiler.hpp>
+
+#include <fstream>
 
 namespace mlpack {
 namespace bindings {
@@ -66,6 +69,29 @@ inline void EndProgram()
     }
   }
 
+  if (IO::HasParam("timing"))
+  {
+    const std::string& filename = IO::GetParam<std::string>("timing");
+    std::ofstream stream(filename.c_str());
+    if (!stream.is_open())
+    {
+      Log::Warn << "Cannot open file '" << filename << "' to write the timers "
+          << "to." << std::endl;
+    }
+    else
+    {
+      stream << "{\"timers_us\": {";
+      bool first = true;
+      for (auto& it2 : IO::GetSingleton().timer.GetAllTimers())
+      {
+        stream << (first ? "" : ", ") << "\"" << it2.first << "\": "
+            << it2.second.count();
+        first = false;
+      }
+      stream << "}, \"profile\": " << Profiler::ToJSON() << "}" << std::endl;
+    }
+  }
+
   // Lastly clean up any memory.  If we are holding any pointers, then we "own"
   // them.  But we may hold the same pointer twice, so we have to be careful to
   // not delete it multiple times.
@@ -14,6 +14,7 @@
 
 #include <mlpack/prereqs.hpp>
 #include "parameter_type.hpp"
+#include "standard_stream.hpp"
 
 namespace mlpack {
 namespace bindings {
@@ -58,7 +59,9 @@ T& GetParam(
   if (d.input && !d.loaded)
   {
     // Call correct data::Load() function.
-    if (arma::is_Row<T>::value || arma::is_Col<T>::value)
+    if (IsStandardStream(value))
+      LoadStandardInput(matrix, !d.noTranspose);
+    else if (arma::is_Row<T>::value || arma::is_Col<T>::value)
       data::Load(value, matrix, true);
     else
       data::Load(value, matrix, true, !d.noTranspose);
@@ -87,7 +90,16 @@ T& GetParam(
   T& t = std::get<0>(*tuple);
   if (d.input && !d.loaded)
   {
-    data::Load(value, std::get<1>(t), std::get<0>(t), true, !d.noTranspose);
+    // Matrices read from the standard input are numeric.
+    if (IsStandardStream(value))
+    {
+      LoadStandardInput(std::get<1>(t), !d.noTranspose);
+      std::get<0>(t) = data::DatasetInfo(std::get<1>(t).n_rows);
+    }
+    else
+    {
+      data::Load(value, std::get<1>(t), std::get<0>(t), true, !d.noTranspose);
+    }
     d.loaded = true;
   }
 
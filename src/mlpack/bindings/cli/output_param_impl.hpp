@@ -13,6 +13,7 @@
 #define MLPACK_CORE_UTIL_OUTPUT_PARAM_IMPL_HPP
 
 #include "output_param.hpp"
+#include "standard_stream.hpp"
 #include <mlpack/core/data/save.hpp>
 #include <iostream>
 
@@ -60,7 +61,10 @@ void OutputParamImpl(
 
   if (output.n_elem > 0 && filename != "")
   {
-    if (arma::is_Row<T>::value || arma::is_Col<T>::value)
+    if (IsStandardStream(filename))
+      SaveStandardOutput(filename, output, arma::is_Row<T>::value ||
+          arma::is_Col<T>::value || !data.noTranspose);
+    else if (arma::is_Row<T>::value || arma::is_Col<T>::value)
       data::Save(filename, output, false);
     else
       data::Save(filename, output, false, !data.noTranspose);
@@ -103,7 +107,9 @@ void OutputParamImpl(
 
   // The mapping isn't taken into account.  We should write a data::Save()
   // overload for this.
-  if (filename != "")
+  if (IsStandardStream(filename))
+    SaveStandardOutput(filename, matrix, !data.noTranspose);
+  else if (filename != "")
     data::Save(filename, matrix, false, !data.noTranspose);
 }
 
@@ -27,7 +27,24 @@ PARAM_FLAG("help", "Default help info.", "h");
 PARAM_STRING_IN("info", "Print help on a specific option.", "", "");
 PARAM_FLAG("verbose", "Display informational messages and the full list of "
     "parameters and timers at the end of execution.", "v");
+PARAM_INT_IN("threads", "Maximum number of threads to use; 0 uses the OpenMP "
+    "default (the OMP_NUM_THREADS environment variable, or the number of "
+    "cores).", "", 0);
 PARAM_FLAG("version", "Display the version of mlpack.", "V");
+PARAM_STRING_IN("timing", "If specified, the program timers and the profile of "
+    "the instrumented code are written to this file as JSON.", "", "");
+PARAM_STRING_IN("serve", "If specified, run as a server: the matrix input "
+    "parameter with this name is set to each batch of points read from the "
+    "standard input (or from --serve_socket), and the --serve_output "
+    "parameters are written back after each batch.  Models are loaded once.",
+    "", "");
+PARAM_VECTOR_IN(std::string, "serve_output", "Matrix output parameters "
+    "written back after each batch in --serve mode.", "");
+PARAM_STRING_IN("serve_socket", "If specified with --serve, the Unix socket "
+    "to serve on instead of the standard input and output.", "", "");
+PARAM_FLAG("serve_binary", "If specified with --serve, batches are framed in "
+    "binary (the numbers of points and of values as 64-bit integers, then the "
+    "values as doubles) instead of CSV.", "");
 
 /**
  * Parse the command line, setting all of the options inside of the CLI object
@@ -129,12 +146,36 @@ void ParseCommandLine(int argc, char** argv)
     Log::Info.ignoreInput = false;
   }
 
-  // Now, issue an error if we forgot any required options.
+  // If a matrix is written to the standard output, everything else is written
+  // to the standard error, so that the matrix can be piped.
+  for (ItType it = parameters.begin(); it != parameters.end(); ++it)
+  {
+    util::ParamData& d = it->second;
+    bool usesStandardStream = false;
+    if (!d.input)
+    {
+      IO::GetSingleton().functionMap[d.tname]["UsesStandardStream"](d, NULL,
+          (void*) &usesStandardStream);
+    }
+    if (usesStandardStream)
+    {
+      RedirectStandardOutput();
+      break;
+    }
+  }
+
+  // Collect the hot-path profile only when it will be written.
+  if (IO::HasParam("timing"))
+    Profiler::Enable();
+
+  // Now, issue an error if we forgot any required options.  In --serve mode,
+  // the served input is given by each batch instead.
+  const std::string& served = IO::GetParam<std::string>("serve");
   for (std::map<std::string, util::ParamData>::const_iterator iter =
        parameters.begin(); iter != parameters.end(); ++iter)
   {
     util::ParamData d = iter->second;
-    if (d.required)
+    if (d.required && d.name != served && d.name + "_file" != served)
     {
       // CLI11 expects the parameter name to have "--" prepended.
       std::string cliName;
@@ -0,0 +1,453 @@
+/**
+ * @file bindings/cli/serve.hpp
+ *
+ * Run a command-line program as a server: the program (and its models and
+ * other inputs) is set up once, then mlpackMain() is run for each batch of
+ * queries read from the standard input or from a Unix socket, and the outputs
+ * are written back after each batch.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_BINDINGS_CLI_SERVE_HPP
+#define MLPACK_BINDINGS_CLI_SERVE_HPP
+
+#include <mlpack/core/util/io.hpp>
+#include "get_param.hpp"
+
+#include <iomanip>
+#include <iostream>
+
+#ifndef _WIN32
+  #include <cerrno>
+  #include <cstring>
+  #include <sys/socket.h>
+  #include <sys/un.h>
+  #include <unistd.h>
+#endif
+
+namespace mlpack {
+namespace bindings {
+namespace cli {
+
+/**
+ * Read a batch of points in CSV framing: one point per line, with the values
+ * separated by commas or spaces, and an empty line (or the end of the stream)
+ * after the last point.  Return false if the stream ended before any point.
+ *
+ * @param stream Stream to read from.
+ * @param batch The points, one per row.
+ */
+inline bool ReadCSVBatch(std::istream& stream, arma::mat& batch)
+{
+  std::vector<std::vector<double>> points;
+  std::string line, error;
+  while (std::getline(stream, line))
+  {
+    if (!line.empty() && line.back() == '\r')
+      line.pop_back();
+
+    // Empty lines before the first point are ignored.
+    if (line.find_first_not_of(" \t") == std::string::npos)
+    {
+      if (points.empty())
+        continue;
+      break;
+    }
+
+    // After an error, the rest of the batch is skipped.
+    if (!error.empty())
+      continue;
+
+    std::replace(line.begin(), line.end(), ',', ' ');
+    std::istringstream lineStream(line);
+    points.push_back(std::vector<double>());
+    double value;
+    while (lineStream >> value)
+      points.back().push_back(value);
+
+    if (!lineStream.eof())
+      error = "cannot parse line " + std::to_string(points.size());
+    else if (points.back().size() != points[0].size())
+      error = "the points do not all have the same number of values";
+  }
+
+  if (!error.empty())
+    throw std::invalid_argument("invalid batch: " + error);
+  if (points.empty())
+    return false;
+
+  batch.set_size(points.size(), points[0].size());
+  for (size_t i = 0; i < points.size(); ++i)
+    for (size_t j = 0; j < points[i].size(); ++j)
+      batch(i, j) = points[i][j];
+
+  return true;
+}
+
+/**
+ * Read a batch of points in binary framing: the number of points and the
+ * number of values of each point, as two 64-bit unsigned integers, then the
+ * values as doubles, point after point.  All numbers are in the native byte
+ * order.  Return false if the stream ended before the batch.
+ *
+ * @param stream Stream to read from.
+ * @param batch The points, one per row.
+ */
+inline bool ReadBinaryBatch(std::istream& stream, arma::mat& batch)
+{
+  uint64_t size[2];
+  if (!stream.read((char*) size, sizeof(size)))
+    return false;
+
+  // The values are stored point after point, so read them transposed.
+  arma::mat values(size[1], size[0]);
+  if (!stream.read((char*) values.memptr(), values.n_elem * sizeof(double)))
+    return false;
+
+  batch = values.t();
+  return true;
+}
+
+/**
+ * Write a batch of points (one per row) in CSV or binary framing.
+ *
+ * @param stream Stream to write to.
+ * @param batch The points, one per row.
+ * @param binary Whether to use binary framing.
+ */
+inline void WriteBatch(std::ostream& stream,
+                       const arma::mat& batch,
+                       const bool binary)
+{
+  if (binary)
+  {
+    const uint64_t size[2] = { batch.n_rows, batch.n_cols };
+    stream.write((const char*) size, sizeof(size));
+    const arma::mat values = batch.t();
+    stream.write((const char*) values.memptr(), values.n_elem *
+        sizeof(double));
+    return;
+  }
+
+  stream << std::setprecision(std::numeric_limits<double>::digits10);
+  for (size_t i = 0; i < batch.n_rows; ++i)
+  {
+    for (size_t j = 0; j < batch.n_cols; ++j)
+      stream << ((j == 0) ? "" : ",") << batch(i, j);
+    stream << "\n";
+  }
+  stream << "\n";
+}
+
+/**
+ * Set the given matrix parameter to a batch of points (one per row, as in a
+ * file), if it has the type T.  Return false if it has another type.
+ */
+template<typename T>
+bool SetServeInput(util::ParamData& d, const arma::mat& batch)
+{
+  if (d.tname != TYPENAME(T))
+    return false;
+
+  // Mark the parameter as loaded, so that it is not loaded from a file.
+  d.loaded = true;
+  T& matrix = GetParam<T>(d);
+  if (arma::is_Row<T>::value || arma::is_Col<T>::value)
+    matrix = arma::conv_to<T>::from(arma::vectorise(batch));
+  else if (d.noTranspose)
+    matrix = arma::conv_to<T>::from(batch);
+  else
+    matrix = arma::conv_to<T>::from(batch.t());
+
+  return true;
+}
+
+/**
+ * Get the given matrix parameter as a batch of points (one per row, as in a
+ * file), if it has the type T, and empty the parameter.  Return false if it
+ * has another type.
+ */
+template<typename T>
+bool GetServeOutput(util::ParamData& d, arma::mat& batch)
+{
+  if (d.tname != TYPENAME(T))
+    return false;
+
+  T& matrix = GetParam<T>(d);
+  if (arma::is_Row<T>::value || arma::is_Col<T>::value)
+    batch = arma::conv_to<arma::vec>::from(arma::vectorise(matrix));
+  else if (d.noTranspose)
+    batch = arma::conv_to<arma::mat>::from(matrix);
+  else
+    batch = arma::conv_to<arma::mat>::from(matrix).t();
+
+  matrix.reset();
+  return true;
+}
+
+//! Set a matrix parameter of any supported type to a batch of points.
+inline bool SetServeInput(util::ParamData& d, const arma::mat& batch)
+{
+  return SetServeInput<arma::mat>(d, batch) ||
+      SetServeInput<arma::Mat<size_t>>(d, batch) ||
+      SetServeInput<arma::rowvec>(d, batch) ||
+      SetServeInput<arma::Row<size_t>>(d, batch) ||
+      SetServeInput<arma::vec>(d, batch) ||
+      SetServeInput<arma::Col<size_t>>(d, batch);
+}
+
+//! Get and empty a matrix parameter of any supported type.
+inline bool GetServeOutput(util::ParamData& d, arma::mat& batch)
+{
+  return GetServeOutput<arma::mat>(d, batch) ||
+      GetServeOutput<arma::Mat<size_t>>(d, batch) ||
+      GetServeOutput<arma::rowvec>(d, batch) ||
+      GetServeOutput<arma::Row<size_t>>(d, batch) ||
+      GetServeOutput<arma::vec>(d, batch) ||
+      GetServeOutput<arma::Col<size_t>>(d, batch);
+}
+
+/**
+ * Answer every batch of the input stream: each batch is given to the input
+ * parameter, mlpackMain() is run, and each output parameter is written to the
+ * output stream, in order.  If a batch fails, a warning is printed and the
+ * outputs are written empty, so that the client stays in sync.
+ */
+inline void ServeStream(std::istream& input,
+                        std::ostream& output,
+                        void (*mlpackMain)(),
+                        util::ParamData& inputParam,
+                        const std::vector<util::ParamData*>& outputParams,
+                        const bool binary)
+{
+  arma::mat batch;
+  while (true)
+  {
+    bool failed = false;
+    try
+    {
+      if (!(binary ? ReadBinaryBatch(input, batch) :
+          ReadCSVBatch(input, batch)))
+        break;
+
+      SetServeInput(inputParam, batch);
+      mlpackMain();
+    }
+    catch (std::exception& e)
+    {
+      Log::Warn << "Batch failed: " << e.what() << std::endl;
+      failed = true;
+
+      // Restart the program timers, which may have been left running.
+      IO::GetSingleton().timer.StopAllTimers();
+      Timer::Start("total_time");
+    }
+
+    for (size_t i = 0; i < outputParams.size(); ++i)
+    {
+      GetServeOutput(*outputParams[i], batch);
+      if (failed)
+        batch.reset();
+      WriteBatch(output, batch, binary);
+    }
+    output.flush();
+  }
+}
+
+#ifndef _WIN32
+/**
+ * A stream buffer over a file descriptor (a connected socket), for both
+ * reading and writing.
+ */
+class FileDescriptorBuffer : public std::streambuf
+{
+ public:
+  FileDescriptorBuffer(const int fd) : fd(fd)
+  {
+    setg(inBuffer, inBuffer, inBuffer);
+    setp(outBuffer, outBuffer + sizeof(outBuffer));
+  }
+
+  ~FileDescriptorBuffer() { sync(); }
+
+ protected:
+  int_type underflow()
+  {
+    ssize_t count;
+    do
+    {
+      count = read(fd, inBuffer, sizeof(inBuffer));
+    } while (count < 0 && errno == EINTR);
+
+    if (count <= 0)
+      return traits_type::eof();
+
+    setg(inBuffer, inBuffer, inBuffer + count);
+    return traits_type::to_int_type(inBuffer[0]);
+  }
+
+  int_type overflow(int_type c)
+  {
+    if (sync() != 0)
+      return traits_type::eof();
+
+    if (!traits_type::eq_int_type(c, traits_type::eof()))
+    {
+      *pptr() = traits_type::to_char_type(c);
+      pbump(1);
+    }
+    return traits_type::not_eof(c);
+  }
+
+  int sync()
+  {
+    const char* begin = pbase();
+    while (begin < pptr())
+    {
+      const ssize_t count = write(fd, begin, pptr() - begin);
+      if (count < 0 && errno == EINTR)
+        continue;
+      if (count <= 0)
+        return -1;
+      begin += count;
+    }
+    setp(outBuffer, outBuffer + sizeof(outBuffer));
+    return 0;
+  }
+
+ private:
+  int fd;
+  char inBuffer[65536];
+  char outBuffer[65536];
+};
+#endif
+
+/**
+ * Run the program as a server (--serve): the matrix input parameter named by
+ * --serve receives each batch of points, read from the standard input or from
+ * the clients of the Unix socket --serve_socket, and the matrix output
+ * parameters named by --serve_output are written back after each batch.
+ * Models and other inputs are loaded only once, since parameters keep their
+ * loaded values between runs of mlpackMain().
+ *
+ * While serving on the standard output, the messages of the program are
+ * redirected to the standard error.
+ *
+ * @param mlpackMain The main function of the program.
+ */
+inline void Serve(void (*mlpackMain)())
+{
+  std::map<std::string, util::ParamData>& parameters = IO::Parameters();
+
+  // Find a parameter by its name, with or without the "_file" suffix of its
+  // command-line option.
+  auto findParam = [&parameters](std::string name) -> util::ParamData*
+  {
+    if (parameters.count(name) == 0 && name.size() > 5 &&
+        name.compare(name.size() - 5, 5, "_file") == 0)
+      name = name.substr(0, name.size() - 5);
+    return (parameters.count(name) == 0) ? NULL : &parameters.at(name);
+  };
+
+  const std::string& inputName = IO::GetParam<std::string>("serve");
+  util::ParamData* inputParam = findParam(inputName);
+  arma::mat probe;
+  if (!inputParam || !inputParam->input ||
+      !SetServeInput(*inputParam, probe))
+  {
+    Log::Fatal << "--serve: '" << inputName << "' is not a matrix input "
+        << "parameter!" << std::endl;
+  }
+  inputParam->wasPassed = true;
+
+  const std::vector<std::string>& outputNames =
+      IO::GetParam<std::vector<std::string>>("serve_output");
+  if (outputNames.empty())
+    Log::Fatal << "--serve requires at least one --serve_output!" << std::endl;
+
+  std::vector<util::ParamData*> outputParams;
+  for (size_t i = 0; i < outputNames.size(); ++i)
+  {
+    util::ParamData* outputParam = findParam(outputNames[i]);
+    if (!outputParam || outputParam->input ||
+        !GetServeOutput(*outputParam, probe))
+    {
+      Log::Fatal << "--serve_output: '" << outputNames[i] << "' is not a "
+          << "matrix output parameter!" << std::endl;
+    }
+    outputParam->wasPassed = true;
+    outputParams.push_back(outputParam);
+  }
+
+  const bool binary = IO::HasParam("serve_binary");
+  const std::string& socketPath = IO::GetParam<std::string>("serve_socket");
+  if (socketPath.empty())
+  {
+    // Keep the standard output for the answers.
+    std::streambuf* coutBuffer = std::cout.rdbuf(std::cerr.rdbuf());
+    std::ostream output(coutBuffer);
+    ServeStream(std::cin, output, mlpackMain, *inputParam, outputParams,
+        binary);
+    std::cout.rdbuf(coutBuffer);
+    return;
+  }
+
+#ifdef _WIN32
+  Log::Fatal << "--serve_socket is not supported on Windows!" << std::endl;
+#else
+  sockaddr_un address;
+  memset(&address, 0, sizeof(address));
+  address.sun_family = AF_UNIX;
+  if (socketPath.size() >= sizeof(address.sun_path))
+  {
+    Log::Fatal << "--serve_socket: the path '" << socketPath << "' is too "
+        << "long!" << std::endl;
+  }
+  strncpy(address.sun_path, socketPath.c_str(), sizeof(address.sun_path) - 1);
+
+  const int server = socket(AF_UNIX, SOCK_STREAM, 0);
+  unlink(socketPath.c_str());
+  if (server < 0 || bind(server, (sockaddr*) &address, sizeof(address)) != 0 ||
+      listen(server, 16) != 0)
+  {
+    Log::Fatal << "--serve_socket: cannot listen on '" << socketPath << "': "
+        << strerror(errno) << "!" << std::endl;
+  }
+
+  // Answer the clients one after the other, until the server is stopped.
+  Log::Info << "Serving on '" << socketPath << "'." << std::endl;
+  while (true)
+  {
+    const int client = accept(server, NULL, NULL);
+    if (client < 0)
+    {
+      if (errno == EINTR)
+        continue;
+      Log::Warn << "--serve_socket: cannot accept a client: "
+          << strerror(errno) << "." << std::endl;
+      break;
+    }
+
+    {
+      FileDescriptorBuffer buffer(client);
+      std::istream input(&buffer);
+      std::ostream output(&buffer);
+      ServeStream(input, output, mlpackMain, *inputParam, outputParams,
+          binary);
+    }
+    close(client);
+  }
+
+  close(server);
+  unlink(socketPath.c_str());
+#endif
+}
+
+} // namespace cli
+} // namespace bindings
+} // namespace mlpack
+
+#endif
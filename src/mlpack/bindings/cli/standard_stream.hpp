@@ -0,0 +1,256 @@
+/**
+ * @file bindings/cli/standard_stream.hpp
+ *
+ * Read matrix parameters from the standard input and write them to the
+ * standard output, so that command-line programs can be chained with pipes.
+ * A matrix parameter uses the standard stream when its filename is "-", or "-"
+ * followed by an extension that gives the format of an output (for instance
+ * "-.csv").
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_BINDINGS_CLI_STANDARD_STREAM_HPP
+#define MLPACK_BINDINGS_CLI_STANDARD_STREAM_HPP
+
+#include <mlpack/core.hpp>
+
+#include <cstring>
+#include <iostream>
+
+#ifdef _WIN32
+  #include <fcntl.h>
+  #include <io.h>
+#endif
+
+namespace mlpack {
+namespace bindings {
+namespace cli {
+
+//! Return whether the given filename designates the standard input or output.
+inline bool IsStandardStream(const std::string& filename)
+{
+  return (filename == "-") ||
+      (filename.size() > 2 && filename.compare(0, 2, "-.") == 0);
+}
+
+/**
+ * Get the buffer of the standard output, which is kept for matrices once
+ * RedirectStandardOutput() has sent everything else to the standard error.
+ */
+inline std::streambuf*& StandardOutputBuffer()
+{
+  static std::streambuf* buffer = NULL;
+  return buffer;
+}
+
+/**
+ * Keep the standard output for the matrices written to it: everything else
+ * that is written to std::cout (such as Log::Info and the other output
+ * parameters) goes to the standard error instead.
+ */
+inline void RedirectStandardOutput()
+{
+  if (StandardOutputBuffer() != NULL)
+    return;
+
+#ifdef _WIN32
+  _setmode(_fileno(stdout), _O_BINARY);
+#endif
+  std::cout.flush();
+  StandardOutputBuffer() = std::cout.rdbuf(std::cerr.rdbuf());
+}
+
+/**
+ * Read a matrix from the standard input, which can only be done once.  The
+ * format is detected: either the columnar layout of data::SaveMapped() (which
+ * is never transposed, like in data::Load()), or any format that Armadillo
+ * detects, like Armadillo binary or CSV.
+ *
+ * @param matrix Matrix to read.
+ * @param transpose Whether to transpose the matrix (unless it is columnar).
+ */
+template<typename eT>
+void LoadStandardInput(arma::Mat<eT>& matrix, const bool transpose)
+{
+  static bool consumed = false;
+  if (consumed)
+  {
+    Log::Fatal << "Only one input matrix can be read from the standard "
+        << "input!" << std::endl;
+  }
+  consumed = true;
+
+  Timer::Start("loading_data");
+#ifdef _WIN32
+  _setmode(_fileno(stdin), _O_BINARY);
+#endif
+  std::ostringstream contents;
+  contents << std::cin.rdbuf();
+  const std::string buffer = contents.str();
+
+  data::mapped::Header header;
+  if (buffer.size() >= sizeof(header) && std::memcmp(buffer.data(),
+      data::mapped::magic, sizeof(data::mapped::magic)) == 0)
+  {
+    std::memcpy(&header, buffer.data(), sizeof(header));
+    if (header.elemSize != sizeof(eT) || (buffer.size() - sizeof(header)) /
+        sizeof(eT) < header.nRows * header.nCols)
+    {
+      Timer::Stop("loading_data");
+      Log::Fatal << "The standard input does not hold a valid mapped matrix "
+          << "of " << sizeof(eT) << "-byte elements!" << std::endl;
+    }
+
+    Log::Info << "Loading standard input as mapped matrix." << std::endl;
+    matrix.set_size(header.nRows, header.nCols);
+    std::memcpy(matrix.memptr(), buffer.data() + sizeof(header),
+        matrix.n_elem * sizeof(eT));
+    Timer::Stop("loading_data");
+    return;
+  }
+
+  std::istringstream stream(buffer);
+  if (!matrix.load(stream, arma::auto_detect))
+  {
+    Timer::Stop("loading_data");
+    Log::Fatal << "Loading from the standard input failed." << std::endl;
+  }
+  Log::Info << "Loaded a " << matrix.n_rows << " x " << matrix.n_cols
+      << " matrix from the standard input." << std::endl;
+
+  if (transpose)
+    arma::inplace_trans(matrix);
+  Timer::Stop("loading_data");
+}
+
+/**
+ * Read a vector from the standard input; the matrix that is read must have one
+ * row or one column.
+ */
+template<typename eT>
+void LoadStandardInput(arma::Row<eT>& vector, const bool /* transpose */)
+{
+  arma::Mat<eT> matrix;
+  LoadStandardInput(matrix, false);
+  if (matrix.n_rows > 1 && matrix.n_cols > 1)
+  {
+    Log::Fatal << "The standard input holds a " << matrix.n_rows << " x "
+        << matrix.n_cols << " matrix, but a vector was expected!" << std::endl;
+  }
+  vector = arma::Row<eT>(matrix.memptr(), matrix.n_elem);
+}
+
+//! Read a vector from the standard input.
+template<typename eT>
+void LoadStandardInput(arma::Col<eT>& vector, const bool /* transpose */)
+{
+  arma::Row<eT> row;
+  LoadStandardInput(row, false);
+  vector = row.t();
+}
+
+/**
+ * Write a matrix to the standard output.  The format is given by the extension
+ * of the filename: Armadillo binary for "-" or "-.bin", the columnar layout of
+ * data::SaveMapped() (never transposed) for "-.mapped", CSV for "-.csv" and
+ * space-separated text for "-.txt".
+ *
+ * @param filename Filename of the parameter ("-" or "-.ext").
+ * @param matrix Matrix to write.
+ * @param transpose Whether to transpose the matrix (unless it is columnar).
+ */
+template<typename eT>
+void SaveStandardOutput(const std::string& filename,
+                        const arma::Mat<eT>& matrix,
+                        const bool transpose)
+{
+  const std::string extension = (filename == "-") ? "bin" : filename.substr(2);
+
+  Timer::Start("saving_data");
+  std::ostream stream((StandardOutputBuffer() != NULL) ?
+      StandardOutputBuffer() : std::cout.rdbuf());
+  bool success = true;
+  if (extension == "mapped")
+  {
+    data::mapped::WriteStream(stream, matrix, std::string());
+  }
+  else
+  {
+    arma::file_type type = arma::file_type_unknown;
+    if (extension == "bin")
+      type = arma::arma_binary;
+    else if (extension == "csv")
+      type = arma::csv_ascii;
+    else if (extension == "txt")
+      type = arma::raw_ascii;
+
+    if (type == arma::file_type_unknown)
+    {
+      Timer::Stop("saving_data");
+      Log::Fatal << "Unknown format '" << extension << "' for the standard "
+          << "output; use '-', '-.bin', '-.mapped', '-.csv' or '-.txt'!"
+          << std::endl;
+    }
+
+    if (transpose)
+      success = arma::Mat<eT>(matrix.t()).save(stream, type);
+    else
+      success = matrix.save(stream, type);
+  }
+
+  stream.flush();
+  Timer::Stop("saving_data");
+  if (!success || !stream.good())
+    Log::Fatal << "Writing to the standard output failed." << std::endl;
+}
+
+//! Parameters that are not matrices never use the standard streams.
+template<typename T>
+bool UsesStandardStreamInternal(
+    util::ParamData& /* d */,
+    const typename boost::disable_if<arma::is_arma_type<T>>::type* = 0,
+    const typename boost::disable_if<std::is_same<T,
+        std::tuple<mlpack::data::DatasetInfo, arma::mat>>>::type* = 0)
+{
+  return false;
+}
+
+//! Return whether the given matrix parameter uses the standard stream.
+template<typename T>
+bool UsesStandardStreamInternal(
+    util::ParamData& d,
+    const typename std::enable_if<
+        arma::is_arma_type<T>::value ||
+        std::is_same<T,
+            std::tuple<mlpack::data::DatasetInfo, arma::mat>>::value>::type* =
+        0)
+{
+  typedef std::tuple<T, std::string> TupleType;
+  return IsStandardStream(std::get<1>(*boost::any_cast<TupleType>(&d.value)));
+}
+
+/**
+ * Store whether the given parameter uses the standard input or output in the
+ * bool pointed to by output.
+ *
+ * @param d Parameter information.
+ * @param * (input) Unused parameter.
+ * @param output Pointer to the bool to store the result in.
+ */
+template<typename T>
+void UsesStandardStream(util::ParamData& d,
+                        const void* /* input */,
+                        void* output)
+{
+  *((bool*) output) =
+      UsesStandardStreamInternal<typename std::remove_pointer<T>::type>(d);
+}
+
+} // namespace cli
+} // namespace bindings
+} // namespace mlpack
+
+#endif
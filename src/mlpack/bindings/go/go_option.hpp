@@ -79,8 +79,9 @@ class GoOption
     data.required = required;
     data.input = input;
     data.loaded = false;
-    // Only "verbose" and "copy_all_inputs" will be persistent.
-    if (identifier == "verbose" /*|| identifier == "copy_all_inputs"*/)
+    // Only "verbose", "threads" and "copy_all_inputs" will be persistent.
+    if (identifier == "verbose" || identifier == "threads"
+        /*|| identifier == "copy_all_inputs"*/)
       data.persistent = true;
     else
       data.persistent = false;
@@ -89,7 +90,8 @@ class GoOption
     data.value = boost::any(defaultValue);
 
     // Restore the parameters for this program.
-    if (identifier != "verbose" /*&& identifier != "copy_all_inputs"*/)
+    if (identifier != "verbose" && identifier != "threads"
+        /*&& identifier != "copy_all_inputs"*/)
       IO::RestoreSettings(programName, false);
 
     // Set the function pointers that we'll need.  All of these function
@@ -120,7 +122,8 @@ class GoOption
     // import more than one .so that uses IO, so we have to keep the options
     // separate.  programName is a global variable from mlpack_main.hpp.
     IO::Add(std::move(data));
-    if (identifier != "verbose" /*&& identifier != "copy_all_inputs"*/)
+    if (identifier != "verbose" && identifier != "threads"
+        /*&& identifier != "copy_all_inputs"*/)
       IO::StoreSettings(programName);
     IO::ClearSettings();
   }
@@ -65,8 +65,8 @@ class JuliaOption
     data.input = input;
     data.loaded = false;
 
-    // Only "verbose" will be persistent.
-    if (identifier == "verbose")
+    // Only "verbose" and "threads" will be persistent.
+    if (identifier == "verbose" || identifier == "threads")
       data.persistent = true;
     else
       data.persistent = false;
@@ -76,7 +76,7 @@ class JuliaOption
     data.value = boost::any(defaultValue);
 
     // Restore the parameters for this program.
-    if (identifier != "verbose")
+    if (identifier != "verbose" && identifier != "threads")
       IO::RestoreSettings(programName, false);
 
     // Set the function pointers that we'll need.  All of these function
@@ -108,7 +108,7 @@ class JuliaOption
     // import more than one .so that uses IO, so we have to keep the options
     // separate.  programName is a global variable from mlpack_main.hpp.
     IO::Add(std::move(data));
-    if (identifier != "verbose")
+    if (identifier != "verbose" && identifier != "threads")
       IO::StoreSettings(programName);
     IO::ClearSettings();
   }
@@ -61,8 +61,11 @@ class MDOption
     data.input = input;
     data.loaded = false;
     // Several options from Python and CLI bindings are persistent.
-    if (identifier == "verbose" || identifier == "copy_all_inputs" ||
-        identifier == "help" || identifier == "info" || identifier == "version")
+    if (identifier == "verbose" || identifier == "threads" ||
+        identifier == "copy_all_inputs" ||
+        identifier == "help" || identifier == "info" ||
+        identifier == "version" || identifier == "timing" ||
+        identifier.compare(0, 5, "serve") == 0)
       data.persistent = true;
     else
       data.persistent = false;
@@ -72,7 +75,8 @@ class MDOption
     data.value = boost::any(defaultValue);
 
     // Restore the parameters for this program.
-    if (identifier != "verbose" && identifier != "copy_all_inputs")
+    if (identifier != "verbose" && identifier != "threads" &&
+        identifier != "copy_all_inputs")
       IO::RestoreSettings(bindingName, false);
 
     // Set the function pointers that we'll need.  Most of these simply delegate
@@ -95,8 +99,11 @@ class MDOption
 
     // Add the option.
     IO::Add(std::move(data));
-    if (identifier != "verbose" && identifier != "copy_all_inputs" &&
-        identifier != "help" && identifier != "info" && identifier != "version")
+    if (identifier != "verbose" && identifier != "threads" &&
+        identifier != "copy_all_inputs" &&
+        identifier != "help" && identifier != "info" &&
+        identifier != "version" && identifier != "timing" &&
+        identifier.compare(0, 5, "serve") != 0)
       IO::StoreSettings(bindingName);
     IO::ClearSettings();
   }
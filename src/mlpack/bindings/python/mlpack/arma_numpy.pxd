@@ -25,9 +25,22 @@ from libcpp cimport bool
 Convert a numpy ndarray to a matrix.
 """
 cdef arma.Mat[double]* numpy_to_mat_d(numpy.ndarray[numpy.double_t, ndim=2] X, \
-                                      bool takeOwnership) except +
+                                      bool takeOwnership, \
+                                      bool transposeInPlace=*) except +
 cdef arma.Mat[size_t]* numpy_to_mat_s(numpy.ndarray[numpy.npy_intp, ndim=2] X, \
-                                      bool takeOwnership) except +
+                                      bool takeOwnership, \
+                                      bool transposeInPlace=*) except +
+
+"""
+Protect the memory of a Fortran-ordered array that numpy_to_mat_d() or
+numpy_to_mat_s() transposed in place, and give the array its layout back once
+the program is done.
+"""
+cdef bool pin_mat_d(numpy.ndarray X, bool takeOwnership, arma.Mat[double]& m) \
+    except *
+cdef bool pin_mat_s(numpy.ndarray X, bool takeOwnership, arma.Mat[size_t]& m) \
+    except *
+cdef void restore_layout(numpy.ndarray X) except *
 
 """
 Convert an Armadillo object to a numpy ndarray of the given type.
@@ -4,10 +4,13 @@ arma_numpy.pyx: Armadillo/numpy interface functionality.
 
 This file defines a number of functions useful for converting between Armadillo
 and numpy objects without actually copying memory.  Note that if a numpy matrix
-is converted to an Armadillo object, then the Armadillo object will "own" the
-matrix and free the memory upon destruction (and the numpy object will no longer
-"own" the matrix).  Similarly, if an Armadillo object is converted to a numpy
-object, then the numpy object will "own" the matrix.
+is converted to an Armadillo object with takeOwnership set, then the Armadillo
+object will "own" the matrix and free the memory upon destruction (and the numpy
+object will no longer "own" the matrix); otherwise, the Armadillo object uses
+the memory of the numpy array (which may be a view or a memory map) without
+copying it.  Similarly, if an Armadillo object is converted to a numpy object,
+then the numpy object will "own" the matrix; only if the Armadillo object was
+itself using borrowed memory is the memory copied.
 
 Thus, know that if you convert a matrix type, remember that the resulting type
 is what "owns" the allocated memory.
@@ -42,18 +45,45 @@ cdef extern from "<mlpack/bindings/python/mlpack/arma_util.hpp>":
   size_t* GetMemory(arma.Mat[size_t]& m)
   size_t* GetMemory(arma.Col[size_t]& m)
   size_t* GetMemory(arma.Row[size_t]& m)
+  void InplaceTranspose[T](T& m)
+  void PinMemory[T](T& m)
+
+cdef bool transposes_in_place(numpy.ndarray X, bool takeOwnership):
+  """
+  Return whether numpy_to_mat_d() or numpy_to_mat_s() wraps X after
+  transposing it in place, instead of copying it.  This is done for writeable
+  Fortran-ordered arrays whose memory mlpack does not take over: their memory
+  holds the transpose of the layout mlpack uses (one point per column).
+  """
+  return X.flags.f_contiguous and not X.flags.c_contiguous and \
+      X.flags.writeable and not takeOwnership and not isWin
 
 cdef arma.Mat[double]* numpy_to_mat_d(numpy.ndarray[numpy.double_t, ndim=2] X, \
-                                      bool takeOwnership) except +:
+                                      bool takeOwnership, \
+                                      bool transposeInPlace=True) except +:
   """
   Convert a numpy ndarray to a matrix.  The memory will still be owned by numpy.
+  If transposeInPlace is set, a Fortran-ordered array is transposed within its
+  own memory rather than copied; pin_mat_d() and restore_layout() must then be
+  used to protect that memory and give the array its layout back.
   """
-  if not X.flags.c_contiguous or (not X.flags.owndata and not isWin):
-    # If needed, make a copy where we own the memory.
+  cdef arma.Mat[double]* m
+  if transposeInPlace and transposes_in_place(X, takeOwnership):
+    m = new arma.Mat[double](<double*> X.data, X.shape[0], X.shape[1], False,
+        False)
+    InplaceTranspose[arma.Mat[double]](m[0])
+    return m
+
+  if not X.flags.c_contiguous or not X.flags.writeable or \
+      (takeOwnership and not X.flags.owndata and not isWin):
+    # A copy is only needed if the memory layout is wrong, if the memory is
+    # read-only (mlpack may modify its inputs), or if we should take ownership
+    # of memory that numpy does not own; arrays that only reference their
+    # memory (views, memory maps) are otherwise used directly.
     X = X.copy(order="C")
     takeOwnership = True
 
-  cdef arma.Mat[double]* m = new arma.Mat[double](<double*> X.data, X.shape[1],\
+  m = new arma.Mat[double](<double*> X.data, X.shape[1],\
       X.shape[0], isWin, False)
 
   # Take ownership of the memory, if we need to and we are not on Windows.
@@ -64,17 +94,31 @@ cdef arma.Mat[double]* numpy_to_mat_d(numpy.ndarray[numpy.double_t, ndim=2] X, \
   return m
 
 cdef arma.Mat[size_t]* numpy_to_mat_s(numpy.ndarray[numpy.npy_intp, ndim=2] X, \
-                                      bool takeOwnership) except +:
+                                      bool takeOwnership, \
+                                      bool transposeInPlace=True) except +:
   """
   Convert a numpy ndarray to a matrix.  The memory will still be owned by numpy.
+  If transposeInPlace is set, a Fortran-ordered array is transposed within its
+  own memory rather than copied; pin_mat_s() and restore_layout() must then be
+  used to protect that memory and give the array its layout back.
   """
-  if not X.flags.c_contiguous or (not X.flags.owndata and not isWin):
-    # If needed, make a copy where we own the memory, except on Windows where
-    # we never copy.
+  cdef arma.Mat[size_t]* m
+  if transposeInPlace and transposes_in_place(X, takeOwnership):
+    m = new arma.Mat[size_t](<size_t*> X.data, X.shape[0], X.shape[1], False,
+        False)
+    InplaceTranspose[arma.Mat[size_t]](m[0])
+    return m
+
+  if not X.flags.c_contiguous or not X.flags.writeable or \
+      (takeOwnership and not X.flags.owndata and not isWin):
+    # A copy is only needed if the memory layout is wrong, if the memory is
+    # read-only (mlpack may modify its inputs), or if we should take ownership
+    # of memory that numpy does not own; arrays that only reference their
+    # memory (views, memory maps) are otherwise used directly.
     X = X.copy(order="C")
     takeOwnership = True
 
-  cdef arma.Mat[size_t]* m = new arma.Mat[size_t](<size_t*> X.data, X.shape[1],
+  m = new arma.Mat[size_t](<size_t*> X.data, X.shape[1],
       X.shape[0], isWin, False)
 
   # Take ownership of the memory, if we need to.
@@ -84,6 +128,55 @@ cdef arma.Mat[size_t]* numpy_to_mat_s(numpy.ndarray[numpy.npy_intp, ndim=2] X, \
 
   return m
 
+cdef bool pin_mat_d(numpy.ndarray X, bool takeOwnership, arma.Mat[double]& m) \
+    except *:
+  """
+  If numpy_to_mat_d() transposed X in place, mark m (the matrix that now holds
+  the memory of X) so that the memory is never freed or taken over; the program
+  may then move m, but that makes a copy.  Returns whether restore_layout() has
+  to be called on X once the program is done with m.
+  """
+  if not transposes_in_place(X, takeOwnership) or \
+      <char*> m.memptr() != X.data:
+    return False
+
+  PinMemory[arma.Mat[double]](m)
+  return True
+
+cdef bool pin_mat_s(numpy.ndarray X, bool takeOwnership, arma.Mat[size_t]& m) \
+    except *:
+  """
+  If numpy_to_mat_s() transposed X in place, mark m (the matrix that now holds
+  the memory of X) so that the memory is never freed or taken over; the program
+  may then move m, but that makes a copy.  Returns whether restore_layout() has
+  to be called on X once the program is done with m.
+  """
+  if not transposes_in_place(X, takeOwnership) or \
+      <char*> m.memptr() != X.data:
+    return False
+
+  PinMemory[arma.Mat[size_t]](m)
+  return True
+
+cdef void restore_layout(numpy.ndarray X) except *:
+  """
+  Transpose the memory of X back after numpy_to_mat_d() or numpy_to_mat_s()
+  transposed it in place, so that X again holds the Fortran-ordered values it
+  was passed with (including any changes the program made to them).
+  """
+  cdef arma.Mat[double]* d
+  cdef arma.Mat[size_t]* s
+  if X.dtype == numpy.double:
+    d = new arma.Mat[double](<double*> X.data, X.shape[1], X.shape[0], False,
+        False)
+    InplaceTranspose[arma.Mat[double]](d[0])
+    del d
+  else:
+    s = new arma.Mat[size_t](<size_t*> X.data, X.shape[1], X.shape[0], False,
+        False)
+    InplaceTranspose[arma.Mat[size_t]](s[0])
+    del s
+
 cdef numpy.ndarray[numpy.double_t, ndim=2] mat_to_numpy_d(arma.Mat[double]& X) \
     except +:
   """
@@ -97,9 +190,12 @@ cdef numpy.ndarray[numpy.double_t, ndim=2] mat_to_numpy_d(arma.Mat[double]& X) \
       numpy.PyArray_SimpleNewFromData(2, &dims[0], numpy.NPY_DOUBLE, GetMemory(X))
   if isWin:
     output = output.copy(order="C")
-
-  # Transfer memory ownership, if needed.
-  if GetMemState[arma.Mat[double]](X) == 0 and not isWin:
+  elif GetMemState[arma.Mat[double]](X) != 0:
+    # The memory is borrowed from somewhere else (i.e. from an input array), so
+    # the returned array must have its own copy.
+    output = output.copy(order="C")
+  else:
+    # Transfer memory ownership.
     SetMemState[arma.Mat[double]](X, 1)
     PyArray_ENABLEFLAGS(output, numpy.NPY_OWNDATA)
 
@@ -118,9 +214,12 @@ cdef numpy.ndarray[numpy.npy_intp, ndim=2] mat_to_numpy_s(arma.Mat[size_t]& X) \
       numpy.PyArray_SimpleNewFromData(2, &dims[0], numpy.NPY_INTP, GetMemory(X))
   if isWin:
     output = output.copy(order="C")
-
-  # Transfer memory ownership, if needed.
-  if GetMemState[arma.Mat[size_t]](X) == 0 and not isWin:
+  elif GetMemState[arma.Mat[size_t]](X) != 0:
+    # The memory is borrowed from somewhere else (i.e. from an input array), so
+    # the returned array must have its own copy.
+    output = output.copy(order="C")
+  else:
+    # Transfer memory ownership.
     SetMemState[arma.Mat[size_t]](X, 1)
     PyArray_ENABLEFLAGS(output, numpy.NPY_OWNDATA)
 
@@ -132,9 +231,12 @@ cdef arma.Row[double]* numpy_to_row_d(numpy.ndarray[numpy.double_t, ndim=1] X, \
   Convert a numpy one-dimensional ndarray to a row.  The memory will still be
   owned by numpy.
   """
-  if not X.flags.c_contiguous or (not X.flags.owndata and not isWin):
-    # If needed, make a copy where we own the memory, except on Windows where
-    # we never copy.
+  if not X.flags.c_contiguous or not X.flags.writeable or \
+      (takeOwnership and not X.flags.owndata and not isWin):
+    # A copy is only needed if the memory layout is wrong, if the memory is
+    # read-only (mlpack may modify its inputs), or if we should take ownership
+    # of memory that numpy does not own; arrays that only reference their
+    # memory (views, memory maps) are otherwise used directly.
     X = X.copy(order="C")
     takeOwnership = True
 
@@ -154,9 +256,12 @@ cdef arma.Row[size_t]* numpy_to_row_s(numpy.ndarray[numpy.npy_intp, ndim=1] X, \
   Convert a numpy one-dimensional ndarray to a row.  The memory will still be
   owned by numpy.
   """
-  if not X.flags.c_contiguous or (not X.flags.owndata and not isWin):
-    # If needed, make a copy where we own the memory, except on Windows where
-    # we never copy.
+  if not X.flags.c_contiguous or not X.flags.writeable or \
+      (takeOwnership and not X.flags.owndata and not isWin):
+    # A copy is only needed if the memory layout is wrong, if the memory is
+    # read-only (mlpack may modify its inputs), or if we should take ownership
+    # of memory that numpy does not own; arrays that only reference their
+    # memory (views, memory maps) are otherwise used directly.
     X = X.copy(order="C")
     takeOwnership = True
 
@@ -181,9 +286,12 @@ cdef numpy.ndarray[numpy.double_t, ndim=1] row_to_numpy_d(arma.Row[double]& X) \
       numpy.PyArray_SimpleNewFromData(1, &dim, numpy.NPY_DOUBLE, GetMemory(X))
   if isWin:
     output = output.copy(order="C")
-
-  # Transfer memory ownership, if needed.
-  if GetMemState[arma.Row[double]](X) == 0 and not isWin:
+  elif GetMemState[arma.Row[double]](X) != 0:
+    # The memory is borrowed from somewhere else (i.e. from an input array), so
+    # the returned array must have its own copy.
+    output = output.copy(order="C")
+  else:
+    # Transfer memory ownership.
     SetMemState[arma.Row[double]](X, 1)
     PyArray_ENABLEFLAGS(output, numpy.NPY_OWNDATA)
 
@@ -201,9 +309,12 @@ cdef numpy.ndarray[numpy.npy_intp, ndim=1] row_to_numpy_s(arma.Row[size_t]& X) \
       numpy.PyArray_SimpleNewFromData(1, &dim, numpy.NPY_INTP, GetMemory(X))
   if isWin:
     output = output.copy(order="C")
-
-  # Transfer memory ownership, if needed.
-  if GetMemState[arma.Row[size_t]](X) == 0 and not isWin:
+  elif GetMemState[arma.Row[size_t]](X) != 0:
+    # The memory is borrowed from somewhere else (i.e. from an input array), so
+    # the returned array must have its own copy.
+    output = output.copy(order="C")
+  else:
+    # Transfer memory ownership.
     SetMemState[arma.Row[size_t]](X, 1)
     PyArray_ENABLEFLAGS(output, numpy.NPY_OWNDATA)
 
@@ -215,9 +326,12 @@ cdef arma.Col[double]* numpy_to_col_d(numpy.ndarray[numpy.double_t, ndim=1] X, \
   Convert a numpy one-dimensional ndarray to a column vector.  The memory will
   still be owned by numpy.
   """
-  if not X.flags.c_contiguous or (not X.flags.owndata and not isWin):
-    # If needed, make a copy where we own the memory, except on Windows where
-    # we never copy.
+  if not X.flags.c_contiguous or not X.flags.writeable or \
+      (takeOwnership and not X.flags.owndata and not isWin):
+    # A copy is only needed if the memory layout is wrong, if the memory is
+    # read-only (mlpack may modify its inputs), or if we should take ownership
+    # of memory that numpy does not own; arrays that only reference their
+    # memory (views, memory maps) are otherwise used directly.
     X = X.copy(order="C")
     takeOwnership = True
 
@@ -237,9 +351,12 @@ cdef arma.Col[size_t]* numpy_to_col_s(numpy.ndarray[numpy.npy_intp, ndim=1] X, \
   Convert a numpy one-dimensional ndarray to a column vector.  The memory will
   still be owned by numpy.
   """
-  if not X.flags.c_contiguous or (not X.flags.owndata and not isWin):
-    # If needed, make a copy where we own the memory, except on Windows where
-    # we never copy.
+  if not X.flags.c_contiguous or not X.flags.writeable or \
+      (takeOwnership and not X.flags.owndata and not isWin):
+    # A copy is only needed if the memory layout is wrong, if the memory is
+    # read-only (mlpack may modify its inputs), or if we should take ownership
+    # of memory that numpy does not own; arrays that only reference their
+    # memory (views, memory maps) are otherwise used directly.
     X = X.copy(order="C")
     takeOwnership = True
 
@@ -264,9 +381,12 @@ cdef numpy.ndarray[numpy.double_t, ndim=1] col_to_numpy_d(arma.Col[double]& X) \
       numpy.PyArray_SimpleNewFromData(1, &dim, numpy.NPY_DOUBLE, GetMemory(X))
   if isWin:
     output = output.copy(order="C")
-
-  # Transfer memory ownership, if needed.
-  if GetMemState[arma.Col[double]](X) == 0 and not isWin:
+  elif GetMemState[arma.Col[double]](X) != 0:
+    # The memory is borrowed from somewhere else (i.e. from an input array), so
+    # the returned array must have its own copy.
+    output = output.copy(order="C")
+  else:
+    # Transfer memory ownership.
     SetMemState[arma.Col[double]](X, 1)
     PyArray_ENABLEFLAGS(output, numpy.NPY_OWNDATA)
 
@@ -283,9 +403,12 @@ cdef numpy.ndarray[numpy.npy_intp, ndim=1] col_to_numpy_s(arma.Col[size_t]& X) \
       numpy.PyArray_SimpleNewFromData(1, &dim, numpy.NPY_INTP, GetMemory(X))
   if isWin:
     output = output.copy(order="C")
-
-  # Transfer memory ownership, if needed.
-  if GetMemState[arma.Col[size_t]](X) == 0 and not isWin:
+  elif GetMemState[arma.Col[size_t]](X) != 0:
+    # The memory is borrowed from somewhere else (i.e. from an input array), so
+    # the returned array must have its own copy.
+    output = output.copy(order="C")
+  else:
+    # Transfer memory ownership.
     SetMemState[arma.Col[size_t]](X, 1)
     PyArray_ENABLEFLAGS(output, numpy.NPY_OWNDATA)
 
@@ -60,4 +60,27 @@ inline typename T::elem_type* GetMemory(T& m)
   }
 }
 
+/**
+ * Transpose the given Armadillo matrix within its own memory, without
+ * allocating a second copy of it; this also works for matrices that use
+ * borrowed memory.
+ */
+template<typename T>
+void InplaceTranspose(T& m)
+{
+  arma::inplace_strans(m, "lowmem");
+}
+
+/**
+ * Mark the given Armadillo object, which uses borrowed memory, so that
+ * Armadillo will neither free nor take over that memory: moving from the object
+ * then copies the memory instead of stealing it.
+ */
+template<typename T>
+void PinMemory(T& t)
+{
+  const_cast<arma::uhword&>(t.mem_state) = 0;
+  const_cast<arma::uword&>(t.n_alloc) = 0;
+}
+
 #endif
@@ -38,6 +38,11 @@ cdef extern from "<mlpack/core/util/io.hpp>" namespace "mlpack" nogil:
     @staticmethod
     void ClearSettings() nogil except +
 
+  # An IO::Context holds the parameters of one binding call; it is bound on the
+  # calling thread for as long as it lives.
+  cdef cppclass IOContext "mlpack::IO::Context":
+    IOContext() nogil except +
+
 cdef extern from "<mlpack/bindings/python/mlpack/io_util.hpp>" \
     namespace "mlpack::util" nogil:
   void SetParam[T](string, T&) nogil except +
@@ -47,29 +47,49 @@ def to_matrix(x, dtype=np.double, copy=False):
       not hasattr(x, '__array__'):
     raise TypeError("given argument is not array-like")
 
-  if (isinstance(x, np.ndarray) and x.dtype == dtype and x.flags.c_contiguous):
+  if (isinstance(x, np.ndarray) and x.dtype == dtype and
+      (x.flags.c_contiguous or x.flags.f_contiguous)):
+    # A Fortran-ordered array is also given as-is: the bindings can transpose it
+    # in place instead of copying it.
     if copy: # Copy the matrix if required.
       return x.copy("C"), True
     else:
       return x, False
-  elif (isinstance(x, np.ndarray) and x.dtype == dtype and x.flags.f_contiguous):
-    # A copy is always necessary here.
-    return x.copy("C"), True
   else:
     if isinstance(x, pd.core.series.Series) or isinstance(x, pd.DataFrame):
       # We can only avoid a copy if the dtype is the same and the copy flag is
-      # false.  I'm actually not sure if this is possible, since in everything I
-      # have found, Pandas stores with F_CONTIGUOUS not C_CONTIGUOUS.
+      # false.  Pandas usually stores with F_CONTIGUOUS, not C_CONTIGUOUS.
       y = x.values
       if copy == False and y.dtype == dtype and y.flags.c_contiguous:
         return np.ndarray(y.shape, buffer=x.values, dtype=dtype, order='C'),\
             False
+      elif copy == False and y.dtype == dtype and y.flags.f_contiguous:
+        return y, False
       else:
         # We have to make a copy or change the dtype, so just do this directly.
         return np.array(y, dtype=dtype, order='C', copy=True), True
     else:
       return np.array(x, copy=True, dtype=dtype, order='C'), True
 
+def shares_memory(x, inputs):
+  """
+  Given the ndarray x made from one of the given inputs of a binding, return
+  whether a Fortran-ordered x may share its memory with any other input; if so,
+  it must not be transposed in place.
+  """
+  if not x.flags.f_contiguous or x.flags.c_contiguous:
+    return False
+
+  n = 0
+  for y in inputs:
+    if isinstance(y, pd.DataFrame) or isinstance(y, pd.Series):
+      y = y.values
+    if isinstance(y, np.ndarray) and np.may_share_memory(x, y):
+      n += 1
+
+  return n > 1
+
+
 
 def to_matrix_with_info(x, dtype, copy=False):
   """
@@ -0,0 +1,64 @@
+/**
+ * @file bindings/python/mlpack/model_inference.hpp
+ *
+ * Functions that run inference with a model directly, without going through
+ * IO, for the classify() and search() methods of the Python model classes.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_BINDINGS_PYTHON_CYTHON_MODEL_INFERENCE_HPP
+#define MLPACK_BINDINGS_PYTHON_CYTHON_MODEL_INFERENCE_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/methods/neighbor_search/search_statistics.hpp>
+
+namespace mlpack {
+namespace bindings {
+namespace python {
+
+/**
+ * Classify the given points with the model.  The model is not modified, so
+ * this may be called from several threads at once.
+ *
+ * @param model Model to classify with.
+ * @param data Points to classify.
+ * @param predictions Vector to store the predicted labels in.
+ */
+template<typename ModelType>
+void ModelClassify(const ModelType& model,
+                   const arma::mat& data,
+                   arma::Row<size_t>& predictions)
+{
+  model.Classify(data, predictions);
+}
+
+/**
+ * Search for the k neighbors of the given query points with the model, using
+ * the reentrant search, so that this may be called from several threads at
+ * once.
+ *
+ * @param model Model to search with.
+ * @param querySet Points to search the neighbors of.
+ * @param k Number of neighbors to search for.
+ * @param neighbors Matrix to store the indices of the neighbors in.
+ * @param distances Matrix to store the distances to the neighbors in.
+ */
+template<typename ModelType>
+void ModelSearch(const ModelType& model,
+                 const arma::mat& querySet,
+                 const size_t k,
+                 arma::Mat<size_t>& neighbors,
+                 arma::mat& distances)
+{
+  neighbor::SearchStatistics statistics;
+  model.Search(querySet, k, neighbors, distances, statistics);
+}
+
+} // namespace python
+} // namespace bindings
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,17 @@
+#!/usr/bin/python
+"""
+model_inference.pxd: direct inference functions for mlpack models.
+
+This makes the functions of model_inference.hpp, which the classify() and
+search() methods of the model classes use, available from Python.
+"""
+cimport cython
+cimport arma
+
+cdef extern from "model_inference.hpp" namespace "mlpack::bindings::python" \
+    nogil:
+  void ModelClassify[T](T& model, arma.Mat[double]& data,
+                        arma.Row[size_t]& predictions) nogil except +
+  void ModelSearch[T](T& model, arma.Mat[double]& querySet, size_t k,
+                      arma.Mat[size_t]& neighbors,
+                      arma.Mat[double]& distances) nogil except +
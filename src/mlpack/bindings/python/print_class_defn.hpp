@@ -15,9 +15,153 @@
 #include "strip_type.hpp"
 
 namespace mlpack {
+namespace neighbor {
+
+// Forward declaration; the reentrant search of a model takes one.
+class SearchStatistics;
+
+} // namespace neighbor
+
 namespace bindings {
 namespace python {
 
+/**
+ * HasClassify<T>::value is true if a const T can classify the columns of an
+ * arma::mat into an arma::Row<size_t>.
+ */
+template<typename T>
+struct HasClassify
+{
+  template<typename U>
+  static auto Check(int) -> decltype(std::declval<const U&>().Classify(
+      std::declval<const arma::mat&>(), std::declval<arma::Row<size_t>&>()),
+      std::true_type());
+
+  template<typename U>
+  static std::false_type Check(...);
+
+  static const bool value = decltype(Check<T>(0))::value;
+};
+
+/**
+ * HasSearch<T>::value is true if a const T can search for the neighbors of the
+ * columns of an arma::mat, like NSModel::Search() does without modifying the
+ * model.
+ */
+template<typename T>
+struct HasSearch
+{
+  template<typename U>
+  static auto Check(int) -> decltype(std::declval<const U&>().Search(
+      std::declval<const arma::mat&>(), size_t(),
+      std::declval<arma::Mat<size_t>&>(), std::declval<arma::mat&>(),
+      std::declval<neighbor::SearchStatistics&>()), std::true_type());
+
+  template<typename U>
+  static std::false_type Check(...);
+
+  static const bool value = decltype(Check<T>(0))::value;
+};
+
+/**
+ * Print the code that converts the matrix argument 'name' of a model method to
+ * an arma::mat pointer called 'name_mat'.  These methods may run on several
+ * threads at once with the same input, so a Fortran-ordered input is copied
+ * rather than transposed in place.
+ */
+inline void PrintMethodMatrixInput(const std::string& name)
+{
+  std::cout << "    " << name << "_tuple = to_matrix(" << name
+      << ", dtype=np.double, copy=False)" << std::endl;
+  std::cout << "    if len(" << name << "_tuple[0].shape) < 2:" << std::endl;
+  std::cout << "      " << name << "_tuple[0].shape = (" << name
+      << "_tuple[0].shape[0], 1)" << std::endl;
+  std::cout << "    cdef arma.Mat[double]* " << name << "_mat = "
+      << "arma_numpy.numpy_to_mat_d(" << name << "_tuple[0], " << name
+      << "_tuple[1], False)" << std::endl;
+}
+
+/**
+ * Print the methods of a model class that run inference directly on the C++
+ * model, without going through IO and the whole binding.  Models get a
+ * classify() method if they have a const Classify(), and a search() method if
+ * they have a reentrant Search(); the GIL is released while the model runs, so
+ * a model can serve several Python threads at once.
+ */
+template<typename T>
+void PrintInferenceMethods()
+{
+  if (HasClassify<T>::value)
+  {
+    /**
+     * This will produce code like:
+     *
+     * @code
+     *   def classify(self, test):
+     *     """..."""
+     *     test_tuple = to_matrix(test, dtype=np.double, copy=False)
+     *     ...
+     *     cdef arma.Mat[double]* test_mat = arma_numpy.numpy_to_mat_d(...)
+     *     cdef arma.Row[size_t] predictions
+     *     try:
+     *       with nogil:
+     *         ModelClassify(dereference(self.modelptr),
+     *             dereference(test_mat), predictions)
+     *     finally:
+     *       del test_mat
+     *     return arma_numpy.row_to_numpy_s(predictions)
+     * @endcode
+     */
+    std::cout << "  def classify(self, test):" << std::endl;
+    std::cout << "    \"\"\"" << std::endl;
+    std::cout << "    Classify the points in the given matrix (one point per "
+        << "row) with the model," << std::endl;
+    std::cout << "    without calling the binding, and return the predicted "
+        << "labels.  The GIL is" << std::endl;
+    std::cout << "    released while the model runs." << std::endl;
+    std::cout << "    \"\"\"" << std::endl;
+    PrintMethodMatrixInput("test");
+    std::cout << "    cdef arma.Row[size_t] predictions" << std::endl;
+    std::cout << "    try:" << std::endl;
+    std::cout << "      with nogil:" << std::endl;
+    std::cout << "        ModelClassify(dereference(self.modelptr), "
+        << "dereference(test_mat)," << std::endl;
+    std::cout << "            predictions)" << std::endl;
+    std::cout << "    finally:" << std::endl;
+    std::cout << "      del test_mat" << std::endl;
+    std::cout << "    return arma_numpy.row_to_numpy_s(predictions)"
+        << std::endl;
+    std::cout << std::endl;
+  }
+
+  if (HasSearch<T>::value)
+  {
+    std::cout << "  def search(self, query, k):" << std::endl;
+    std::cout << "    \"\"\"" << std::endl;
+    std::cout << "    Search for the k neighbors of the points in the given "
+        << "matrix (one point per" << std::endl;
+    std::cout << "    row) with the model, without calling the binding, and "
+        << "return the tuple" << std::endl;
+    std::cout << "    (neighbors, distances).  The GIL is released while the "
+        << "model runs." << std::endl;
+    std::cout << "    \"\"\"" << std::endl;
+    PrintMethodMatrixInput("query");
+    std::cout << "    cdef arma.Mat[size_t] neighbors" << std::endl;
+    std::cout << "    cdef arma.Mat[double] distances" << std::endl;
+    std::cout << "    cdef size_t k_value = k" << std::endl;
+    std::cout << "    try:" << std::endl;
+    std::cout << "      with nogil:" << std::endl;
+    std::cout << "        ModelSearch(dereference(self.modelptr), "
+        << "dereference(query_mat), k_value," << std::endl;
+    std::cout << "            neighbors, distances)" << std::endl;
+    std::cout << "    finally:" << std::endl;
+    std::cout << "      del query_mat" << std::endl;
+    std::cout << "    return (arma_numpy.mat_to_numpy_s(neighbors), "
+        << "arma_numpy.mat_to_numpy_d(distances))" << std::endl;
+    std::cout << std::endl;
+  }
+}
+
 /**
  * Non-serializable models don't require any special definitions, so this prints
  * nothing.
@@ -100,6 +244,8 @@ void PrintClassDefn(
   std::cout << "    return (self.__class__, (), self.__getstate__())"
       << std::endl;
   std::cout << std::endl;
+
+  PrintInferenceMethods<T>();
 }
 
 /**
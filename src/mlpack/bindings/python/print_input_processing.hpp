@@ -266,10 +266,15 @@ void PrintInputProcessing(
    *       param_name_tuple[0].shape[1] == 1:
    *     param_name_tuple[0].shape = (param_name_tuple[0].size,)
    *   param_name_mat = arma_numpy.numpy_to_mat_s(param_name_tuple[0],
-   *       param_name_tuple[1])
+   *       param_name_tuple[1], not shares_memory(param_name_tuple[0],
+   *       matrix_inputs))
    *   SetParam[mat](\<const string\> 'param_name', dereference(param_name_mat))
+   *   if arma_numpy.pin_mat_s(param_name_tuple[0], param_name_tuple[1],
+   *       IO.GetParam[mat]('param_name')):
+   *     transposed.append(param_name_tuple[0])
    *   IO.SetPassed(\<const string\> 'param_name')
    *
+   * (The pin_mat_s() call is only printed for matrices, not rows or columns.)
    */
   std::cout << prefix << "# Detect if the parameter was passed; set if so."
       << std::endl;
@@ -310,10 +315,17 @@ void PrintInputProcessing(
           << "_tuple[0].shape[0], 1)" << std::endl;
       std::cout << prefix << "  " << d.name << "_mat = arma_numpy.numpy_to_"
           << GetArmaType<T>() << "_" << GetNumpyTypeChar<T>() << "(" << d.name
-          << "_tuple[0], " << d.name << "_tuple[1])" << std::endl;
+          << "_tuple[0], " << d.name << "_tuple[1], not shares_memory("
+          << d.name << "_tuple[0], matrix_inputs))" << std::endl;
       std::cout << prefix << "  SetParam[" << GetCythonType<T>(d)
           << "](<const string> '" << d.name << "', dereference("
           << d.name << "_mat))"<< std::endl;
+      std::cout << prefix << "  if arma_numpy.pin_mat_"
+          << GetNumpyTypeChar<T>() << "(" << d.name << "_tuple[0], "
+          << d.name << "_tuple[1], IO.GetParam[" << GetCythonType<T>(d)
+          << "]('" << d.name << "')):" << std::endl;
+      std::cout << prefix << "    transposed.append(" << d.name
+          << "_tuple[0])" << std::endl;
       std::cout << prefix << "  IO.SetPassed(<const string> '" << d.name
           << "')" << std::endl;
       std::cout << prefix << "  del " << d.name << "_mat" << std::endl;
@@ -353,10 +365,17 @@ void PrintInputProcessing(
           << "_tuple[0].shape[0], 1)" << std::endl;
       std::cout << prefix << d.name << "_mat = arma_numpy.numpy_to_"
           << GetArmaType<T>() << "_" << GetNumpyTypeChar<T>() << "(" << d.name
-          << "_tuple[0], " << d.name << "_tuple[1])" << std::endl;
+          << "_tuple[0], " << d.name << "_tuple[1], not shares_memory("
+          << d.name << "_tuple[0], matrix_inputs))" << std::endl;
       std::cout << prefix << "SetParam[" << GetCythonType<T>(d)
           << "](<const string> '" << d.name << "', dereference(" << d.name
           << "_mat))" << std::endl;
+      std::cout << prefix << "if arma_numpy.pin_mat_"
+          << GetNumpyTypeChar<T>() << "(" << d.name << "_tuple[0], "
+          << d.name << "_tuple[1], IO.GetParam[" << GetCythonType<T>(d)
+          << "]('" << d.name << "')):" << std::endl;
+      std::cout << prefix << "  transposed.append(" << d.name
+          << "_tuple[0])" << std::endl;
       std::cout << prefix << "IO.SetPassed(<const string> '" << d.name << "')"
           << std::endl;
       std::cout << prefix << "del " << d.name << "_mat" << std::endl;
@@ -458,12 +477,16 @@ void PrintInputProcessing(
    *   param_name_tuple = to_matrix_with_info(param_name)
    *   if len(param_name_tuple[0].shape) < 2:
    *     param_name_tuple[0].shape = (param_name_tuple[0].size,)
-   *   param_name_mat = arma_numpy.numpy_to_matrix_d(param_name_tuple[0])
+   *   param_name_mat = arma_numpy.numpy_to_matrix_d(param_name_tuple[0],
+   *       param_name_tuple[1], not shares_memory(param_name_tuple[0],
+   *       matrix_inputs))
    *   SetParamWithInfo[mat](\<const string\> 'param_name',
    *       dereference(param_name_mat), &param_name_tuple[1][0])
+   *   if arma_numpy.pin_mat_d(param_name_tuple[0], param_name_tuple[1],
+   *       GetParamWithInfo[mat]('param_name')):
+   *     transposed.append(param_name_tuple[0])
    *   IO.SetPassed(\<const string\> 'param_name')
    */
-  std::cout << prefix << "cdef np.ndarray " << d.name << "_dims" << std::endl;
   std::cout << prefix << "# Detect if the parameter was passed; set if so."
       << std::endl;
   if (!d.required)
@@ -477,12 +500,20 @@ void PrintInputProcessing(
     std::cout << prefix << "    " << d.name << "_tuple[0].shape = (" << d.name
         << "_tuple[0].shape[0], 1)" << std::endl;
     std::cout << prefix << "  " << d.name << "_mat = arma_numpy.numpy_to_mat_d("
-        << d.name << "_tuple[0], " << d.name << "_tuple[1])" << std::endl;
+        << d.name << "_tuple[0], " << d.name << "_tuple[1], not shares_memory("
+        << d.name << "_tuple[0], matrix_inputs))" << std::endl;
     std::cout << prefix << "  " << d.name << "_dims = " << d.name
         << "_tuple[2]" << std::endl;
     std::cout << prefix << "  SetParamWithInfo[arma.Mat[double]](<const "
         << "string> '" << d.name << "', dereference(" << d.name << "_mat), "
-        << "<const cbool*> " << d.name << "_dims.data)" << std::endl;
+        << "<const cbool*> (<np.ndarray> " << d.name << "_dims).data)"
+        << std::endl;
+    std::cout << prefix << "  if arma_numpy.pin_mat_d(" << d.name
+        << "_tuple[0], " << d.name << "_tuple[1], "
+        << "GetParamWithInfo[arma.Mat[double]]('" << d.name << "')):"
+        << std::endl;
+    std::cout << prefix << "    transposed.append(" << d.name << "_tuple[0])"
+        << std::endl;
     std::cout << prefix << "  IO.SetPassed(<const string> '" << d.name
         << "')" << std::endl;
     std::cout << prefix << "  del " << d.name << "_mat" << std::endl;
@@ -497,12 +528,20 @@ void PrintInputProcessing(
     std::cout << prefix << "  " << d.name << "_tuple[0].shape = (" << d.name
         << "_tuple[0].shape[0], 1)" << std::endl;
     std::cout << prefix << d.name << "_mat = arma_numpy.numpy_to_mat_d("
-        << d.name << "_tuple[0], " << d.name << "_tuple[1])" << std::endl;
+        << d.name << "_tuple[0], " << d.name << "_tuple[1], not shares_memory("
+        << d.name << "_tuple[0], matrix_inputs))" << std::endl;
     std::cout << prefix << d.name << "_dims = " << d.name << "_tuple[2]"
         << std::endl;
     std::cout << prefix << "SetParamWithInfo[arma.Mat[double]](<const "
         << "string> '" << d.name << "', dereference(" << d.name << "_mat), "
-        << "<const cbool*> " << d.name << "_dims.data)" << std::endl;
+        << "<const cbool*> (<np.ndarray> " << d.name << "_dims).data)"
+        << std::endl;
+    std::cout << prefix << "if arma_numpy.pin_mat_d(" << d.name
+        << "_tuple[0], " << d.name << "_tuple[1], "
+        << "GetParamWithInfo[arma.Mat[double]]('" << d.name << "')):"
+        << std::endl;
+    std::cout << prefix << "  transposed.append(" << d.name << "_tuple[0])"
+        << std::endl;
     std::cout << prefix << "IO.SetPassed(<const string> '" << d.name << "')"
         << std::endl;
     std::cout << prefix << "del " << d.name << "_mat" << std::endl;
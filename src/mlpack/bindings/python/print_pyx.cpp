@@ -74,13 +74,15 @@ void PrintPYX(const util::BindingDetails& doc,
   // Now import all the necessary packages.
   cout << "cimport arma" << endl;
   cout << "cimport arma_numpy" << endl;
-  cout << "from io cimport IO" << endl;
+  cout << "from io cimport IO, IOContext" << endl;
   cout << "from io cimport SetParam, SetParamPtr, SetParamWithInfo, "
       << "GetParamPtr" << endl;
   cout << "from io cimport EnableVerbose, DisableVerbose, DisableBacktrace, "
       << "ResetTimers, EnableTimers" << endl;
-  cout << "from matrix_utils import to_matrix, to_matrix_with_info" << endl;
+  cout << "from matrix_utils import to_matrix, to_matrix_with_info, "
+      << "shares_memory" << endl;
   cout << "from serialization cimport SerializeIn, SerializeOut" << endl;
+  cout << "from model_inference cimport ModelClassify, ModelSearch" << endl;
   cout << endl;
   cout << "import numpy as np" << endl;
   cout << "cimport numpy as np" << endl;
@@ -96,7 +98,8 @@ void PrintPYX(const util::BindingDetails& doc,
 
   // Import the program we will be using.
   cout << "cdef extern from \"<" << mainFilename << ">\" nogil:" << endl;
-  cout << "  cdef void mlpackMain() nogil except +RuntimeError" << endl;
+  cout << "  cdef void mlpackMainWithThreads() nogil except +RuntimeError"
+      << endl;
   cout << "  " << endl;
   // Print any class definitions we need to have.
   std::set<std::string> classes;
@@ -185,6 +188,12 @@ void PrintPYX(const util::BindingDetails& doc,
       << "returned." << endl;
   cout << "  \"\"\"" << endl;
 
+  // Each call gets its own IO parameters: the context is bound from here until
+  // the function returns (or raises), so calls on other Python threads do not
+  // share them.
+  cout << "  cdef IOContext context" << endl;
+  cout << endl;
+
   // Reset any timers and disable backtraces.
   cout << "  ResetTimers()" << endl;
   cout << "  EnableTimers()" << endl;
@@ -206,27 +215,51 @@ void PrintPYX(const util::BindingDetails& doc,
       << "\'bool'!\")" << endl;
   cout << endl;
 
-  // Do any input processing.
+  // Do any input processing.  Fortran-ordered input matrices are transposed
+  // in place instead of copied; they are collected in 'transposed' and given
+  // their layout back when the program is done, even if it fails.
+  // An array that shares its memory with another input is not transposed, so
+  // every matrix input is listed in 'matrix_inputs'.
+  cout << "  matrix_inputs = [";
+  bool first = true;
   for (size_t i = 0; i < inputOptions.size(); ++i)
   {
     util::ParamData& d = parameters.at(inputOptions[i]);
+    if (d.cppType.find("arma::") == std::string::npos)
+      continue;
 
-    size_t indent = 2;
+    cout << (first ? "" : ", ") << d.name;
+    first = false;
+  }
+  cout << "]" << endl;
+  cout << "  transposed = []" << endl;
+  cout << "  try:" << endl;
+  for (size_t i = 0; i < inputOptions.size(); ++i)
+  {
+    util::ParamData& d = parameters.at(inputOptions[i]);
+
+    size_t indent = 4;
     IO::GetSingleton().functionMap[d.tname]["PrintInputProcessing"](d,
         (void*) &indent, NULL);
   }
 
   // Set all output options as passed.
-  cout << "  # Mark all output options as passed." << endl;
+  cout << "    # Mark all output options as passed." << endl;
   for (size_t i = 0; i < outputOptions.size(); ++i)
   {
     util::ParamData& d = parameters.at(outputOptions[i]);
-    cout << "  IO.SetPassed(<const string> '" << d.name << "')" << endl;
+    cout << "    IO.SetPassed(<const string> '" << d.name << "')" << endl;
   }
 
-  // Call the method.
-  cout << "  # Call the mlpack program." << endl;
-  cout << "  mlpackMain()" << endl;
+  // Call the method.  The GIL is not needed while the program runs, so other
+  // Python threads (including other mlpack bindings, since each call has its
+  // own IO context) may continue in the meantime.
+  cout << "    # Call the mlpack program." << endl;
+  cout << "    with nogil:" << endl;
+  cout << "      mlpackMainWithThreads()" << endl;
+  cout << "  finally:" << endl;
+  cout << "    for transposed_array in transposed:" << endl;
+  cout << "      arma_numpy.restore_layout(transposed_array)" << endl;
 
   // Do any output processing and return.
   cout << "  # Initialize result dictionary." << endl;
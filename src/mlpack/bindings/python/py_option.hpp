@@ -64,8 +64,9 @@ class PyOption
     data.required = required;
     data.input = input;
     data.loaded = false;
-    // Only "verbose" and "copy_all_inputs" will be persistent.
-    if (identifier == "verbose" || identifier == "copy_all_inputs")
+    // Only "verbose", "threads" and "copy_all_inputs" will be persistent.
+    if (identifier == "verbose" || identifier == "threads" ||
+        identifier == "copy_all_inputs")
       data.persistent = true;
     else
       data.persistent = false;
@@ -75,7 +76,8 @@ class PyOption
     data.value = boost::any(defaultValue);
 
     // Restore the parameters for this program.
-    if (identifier != "verbose" && identifier != "copy_all_inputs")
+    if (identifier != "verbose" && identifier != "threads" &&
+        identifier != "copy_all_inputs")
       IO::RestoreSettings(programName, false);
 
     // Set the function pointers that we'll need.  All of these function
@@ -104,7 +106,8 @@ class PyOption
     // import more than one .so that uses IO, so we have to keep the options
     // separate.  programName is a global variable from mlpack_main.hpp.
     IO::Add(std::move(data));
-    if (identifier != "verbose" && identifier != "copy_all_inputs")
+    if (identifier != "verbose" && identifier != "threads" &&
+        identifier != "copy_all_inputs")
       IO::StoreSettings(programName);
     IO::ClearSettings();
   }
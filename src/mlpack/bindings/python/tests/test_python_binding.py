@@ -13,6 +13,7 @@ import unittest
 import pandas as pd
 import numpy as np
 import copy
+import threading
 
 from mlpack.test_python_binding import test_python_binding
 
@@ -157,6 +158,34 @@ class TestPythonBinding(unittest.TestCase):
       self.assertEqual(2 * x[j, 2], output['matrix_out'][j, 2])
 
 
+  def testNumpyMatrixView(self):
+    """
+    A view of another matrix should be usable without a copy, and the output
+    should still own its memory.
+    """
+    y = np.random.rand(200, 5)
+    x = copy.deepcopy(y[50:150])
+    z = y[50:150]
+    self.assertFalse(z.flags.owndata)
+
+    output = test_python_binding(string_in='hello',
+                                 int_in=12,
+                                 double_in=4.0,
+                                 mat_req_in=[[1.0]],
+                                 col_req_in=[1.0],
+                                 matrix_in=z)
+
+    self.assertEqual(output['matrix_out'].shape[0], 100)
+    self.assertEqual(output['matrix_out'].shape[1], 4)
+    self.assertEqual(output['matrix_out'].dtype, np.double)
+    self.assertTrue(output['matrix_out'].flags.owndata)
+    for i in [0, 1, 3]:
+      for j in range(100):
+        self.assertEqual(x[j, i], output['matrix_out'][j, i])
+
+    for j in range(100):
+      self.assertEqual(2 * x[j, 2], output['matrix_out'][j, 2])
+
   def testNumpyFContiguousMatrix(self):
     """
     The matrix with F_CONTIGUOUS set we pass in, we should get back with the third
@@ -182,6 +211,61 @@ class TestPythonBinding(unittest.TestCase):
     for j in range(100):
       self.assertEqual(2 * x[j, 2], output['matrix_out'][j, 2])
 
+  def testNumpyFContiguousMatrixUnchanged(self):
+    """
+    A matrix with F_CONTIGUOUS set is transposed in place instead of copied;
+    make sure that we get the right output and that it is given back unchanged.
+    """
+    x = np.array(np.random.rand(100, 5), order='F');
+    z = copy.deepcopy(x)
+
+    output = test_python_binding(string_in='hello',
+                                 int_in=12,
+                                 double_in=4.0,
+                                 mat_req_in=[[1.0]],
+                                 col_req_in=[1.0],
+                                 matrix_in=x)
+
+    self.assertEqual(output['matrix_out'].shape[0], 100)
+    self.assertEqual(output['matrix_out'].shape[1], 4)
+    for i in [0, 1, 3]:
+      for j in range(100):
+        self.assertEqual(z[j, i], output['matrix_out'][j, i])
+
+    for j in range(100):
+      self.assertEqual(2 * z[j, 2], output['matrix_out'][j, 2])
+
+    self.assertTrue(x.flags.f_contiguous)
+    self.assertTrue((x == z).all())
+
+  def testNumpyFContiguousMatrixShared(self):
+    """
+    The same F_CONTIGUOUS matrix passed as two inputs must not be transposed in
+    place (twice); both outputs should be right, and the input unchanged.
+    """
+    x = np.array(np.random.rand(100, 5), order='F');
+    z = copy.deepcopy(x)
+
+    output = test_python_binding(string_in='hello',
+                                 int_in=12,
+                                 double_in=4.0,
+                                 mat_req_in=[[1.0]],
+                                 col_req_in=[1.0],
+                                 matrix_in=x,
+                                 smatrix_in=x)
+
+    self.assertEqual(output['matrix_out'].shape[0], 100)
+    self.assertEqual(output['matrix_out'].shape[1], 4)
+    self.assertEqual(output['smatrix_out'].shape[0], 100)
+    self.assertEqual(output['smatrix_out'].shape[1], 5)
+    for j in range(100):
+      self.assertEqual(z[j, 0], output['matrix_out'][j, 0])
+      self.assertEqual(2 * z[j, 2], output['matrix_out'][j, 2])
+      for i in range(5):
+        self.assertEqual(2 * z[j, i], output['smatrix_out'][j, i])
+
+    self.assertTrue((x == z).all())
+
   def testNumpyFContiguousMatrixForceCopy(self):
     """
     The matrix with F_CONTIGUOUS set we pass in, we should get back with the third
@@ -1336,5 +1420,38 @@ class TestPythonBinding(unittest.TestCase):
     self.assertEqual(output2['model_bw_out'], 20.0)
     self.assertEqual(output3['model_bw_out'], 20.0)
 
+  def testModelThreads(self):
+    """
+    Calling bindings from several threads at once should give the same results
+    as calling them serially, reusing the same model.
+    """
+    output = test_python_binding(string_in='hello',
+                                 int_in=12,
+                                 double_in=4.0,
+                                 mat_req_in=[[1.0]],
+                                 col_req_in=[1.0],
+                                 build_model=True)
+    model = output['model_out']
+
+    results = [None] * 8
+    def run(i):
+      results[i] = test_python_binding(string_in='hello',
+                                       int_in=12,
+                                       double_in=4.0,
+                                       mat_req_in=[[1.0]],
+                                       col_req_in=[1.0],
+                                       model_in=model,
+                                       flag1=(i % 2 == 0))
+
+    threads = [threading.Thread(target=run, args=(i,)) for i in range(8)]
+    for t in threads:
+      t.start()
+    for t in threads:
+      t.join()
+
+    for i in range(8):
+      self.assertEqual(results[i]['model_bw_out'], 20.0)
+      self.assertEqual(results[i]['int_out'], 13 if i % 2 == 0 else 11)
+
 if __name__ == '__main__':
   unittest.main()
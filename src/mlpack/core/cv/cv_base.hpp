@@ -17,6 +17,19 @@
 namespace mlpack {
 namespace cv {
 
+/**
+ * The type of the result of Metric::Evaluate() for the given model and data:
+ * double for a single metric, or arma::vec for a bundle of metrics such as
+ * ClassificationMetrics.
+ */
+template<typename Metric,
+         typename MLAlgorithm,
+         typename MatType,
+         typename PredictionsType>
+using MetricEvaluationType = decltype(Metric::Evaluate(
+    std::declval<MLAlgorithm&>(), std::declval<const MatType&>(),
+    std::declval<const PredictionsType&>()));
+
 /**
  * An auxiliary class for cross-validation. It serves to handle basic non-data
  * constructor parameters of a machine learning algorithm (like datasetInfo or
@@ -44,6 +44,11 @@ namespace cv {
  * the @c Shuffle() function.  Shuffling is performed at construction time if
  * the parameter @c shuffle is set to @c true in the constructor.
  *
+ * The k models are trained and evaluated in parallel with OpenMP (see
+ * @c NumThreads()).  Since the training subsets are aliases of one extended
+ * copy of the data, running the folds concurrently does not need any more
+ * copies of the data, only k models at a time.
+ *
  * @tparam MLAlgorithm A machine learning algorithm.
  * @tparam Metric A metric to assess the quality of a trained model.
  * @tparam MatType The type of data.
@@ -65,6 +70,12 @@ template<typename MLAlgorithm,
 class KFoldCV
 {
  public:
+  //! The type of the result of Evaluate(): double for a single metric, or
+  //! arma::vec for a bundle of metrics (the average over the folds of each
+  //! value).
+  typedef MetricEvaluationType<Metric, MLAlgorithm, MatType, PredictionsType>
+      EvaluationType;
+
   /**
    * This constructor can be used for regression algorithms and for binary
    * classification algorithms.
@@ -175,11 +186,28 @@ class KFoldCV
    *     ones in the constructor).
    */
   template<typename... MLAlgorithmArgs>
-  double Evaluate(const MLAlgorithmArgs& ...args);
+  EvaluationType Evaluate(const MLAlgorithmArgs& ...args);
 
   //! Access and modify a model from the last run of k-fold cross-validation.
   MLAlgorithm& Model();
 
+  //! Get the number of threads used to train the folds (0 means that OpenMP
+  //! decides).
+  size_t NumThreads() const { return numThreads; }
+  //! Modify the number of threads used to train the folds (0 means that OpenMP
+  //! decides).  The default is 0; set it to 1 to train the folds one at a time,
+  //! i.e. when MLAlgorithm is not safe to train from several threads.
+  size_t& NumThreads() { return numThreads; }
+
+  //! Get the fraction of each training subset that models are trained on.
+  double TrainingFraction() const { return trainingFraction; }
+  //! Modify the fraction of each training subset that models are trained on.
+  //! The default is 1; smaller values train on the first points of each
+  //! training subset only, and are used for budget-aware hyper-parameter
+  //! search (see hpt::SuccessiveHalving).  The validation subsets are not
+  //! affected.
+  double& TrainingFraction() { return trainingFraction; }
+
  private:
   //! A short alias for CVBase.
   using Base = CVBase<MLAlgorithm, MatType, PredictionsType, WeightsType>;
@@ -225,6 +253,15 @@ class KFoldCV
   //! A pointer to a model from the last run of k-fold cross-validation.
   std::unique_ptr<MLAlgorithm> modelPtr;
 
+  //! The number of threads used to train the folds.
+  size_t numThreads;
+
+  //! The fraction of each training subset to train on.
+  double trainingFraction;
+
+  //! Get the number of threads to train the folds with.
+  size_t FoldThreads() const;
+
   /**
    * Assert the k parameter and data consistency and initialize fields required
    * for running k-fold cross-validation.
@@ -259,7 +296,7 @@ class KFoldCV
   template<typename... MLAlgorithmArgs,
            bool Enabled = !Base::MIE::SupportsWeights,
            typename = typename std::enable_if<Enabled>::type>
-  double TrainAndEvaluate(const MLAlgorithmArgs& ...mlAlgorithmArgs);
+  EvaluationType TrainAndEvaluate(const MLAlgorithmArgs& ...mlAlgorithmArgs);
 
   /**
    * Train and run evaluation in the case of supporting weighted learning.
@@ -268,7 +305,22 @@ class KFoldCV
            bool Enabled = Base::MIE::SupportsWeights,
            typename = typename std::enable_if<Enabled>::type,
            typename = void>
-  double TrainAndEvaluate(const MLAlgorithmArgs& ...mlAlgorithmArgs);
+  EvaluationType TrainAndEvaluate(const MLAlgorithmArgs& ...mlAlgorithmArgs);
+
+  /**
+   * Average the evaluations of the folds.  If ignoreInvalid is true, the NaN
+   * and infinite evaluations are ignored (with a warning).
+   */
+  static double MeanEvaluation(const std::vector<double>& evaluations,
+                               const bool ignoreInvalid);
+
+  /**
+   * Average each value of the evaluations of the folds, for a bundle of
+   * metrics.  If ignoreInvalid is true, the NaN and infinite values are
+   * ignored.
+   */
+  static arma::vec MeanEvaluation(const std::vector<arma::vec>& evaluations,
+                                  const bool ignoreInvalid);
 
   /**
    * Calculate the index of the first column of the ith validation subset.
@@ -278,6 +330,12 @@ class KFoldCV
    */
   inline size_t ValidationSubsetFirstCol(const size_t i);
 
+  /**
+   * Calculate the number of points of the ith training subset that are used
+   * for training (see TrainingFraction()).
+   */
+  inline size_t TrainingSubsetSize(const size_t i) const;
+
   /**
    * Get the ith training subset from a variable of a matrix type.
    */
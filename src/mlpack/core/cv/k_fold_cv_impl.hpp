@@ -135,7 +135,9 @@ KFoldCV<MLAlgorithm,
                               const PredictionsType& ys,
                               const bool shuffle) :
     base(std::move(base)),
-    k(k)
+    k(k),
+    numThreads(0),
+    trainingFraction(1.0)
 {
   if (k < 2)
     throw std::invalid_argument("KFoldCV: k should not be less than 2");
@@ -166,7 +168,9 @@ KFoldCV<MLAlgorithm,
                               const WeightsType& weights,
                               const bool shuffle) :
     base(std::move(base)),
-    k(k)
+    k(k),
+    numThreads(0),
+    trainingFraction(1.0)
 {
   Base::AssertWeightsConsistency(xs, weights);
 
@@ -185,11 +189,16 @@ template<typename MLAlgorithm,
          typename PredictionsType,
          typename WeightsType>
 template<typename... MLAlgorithmArgs>
-double KFoldCV<MLAlgorithm,
-               Metric,
-               MatType,
-               PredictionsType,
-               WeightsType>::Evaluate(const MLAlgorithmArgs&... args)
+typename KFoldCV<MLAlgorithm,
+                 Metric,
+                 MatType,
+                 PredictionsType,
+                 WeightsType>::EvaluationType
+KFoldCV<MLAlgorithm,
+        Metric,
+        MatType,
+        PredictionsType,
+        WeightsType>::Evaluate(const MLAlgorithmArgs&... args)
 {
   return TrainAndEvaluate(args...);
 }
@@ -212,6 +221,26 @@ MLAlgorithm& KFoldCV<MLAlgorithm,
   return *modelPtr;
 }
 
+template<typename MLAlgorithm,
+         typename Metric,
+         typename MatType,
+         typename PredictionsType,
+         typename WeightsType>
+size_t KFoldCV<MLAlgorithm,
+               Metric,
+               MatType,
+               PredictionsType,
+               WeightsType>::FoldThreads() const
+{
+  #ifdef HAS_OPENMP
+  const size_t threads = (numThreads == 0) ? (size_t) omp_get_max_threads() :
+      numThreads;
+  return std::min(threads, k);
+  #else
+  return 1;
+  #endif
+}
+
 template<typename MLAlgorithm,
          typename Metric,
          typename MatType,
@@ -238,40 +267,144 @@ template<typename MLAlgorithm,
          typename PredictionsType,
          typename WeightsType>
 template<typename... MLAlgorithmArgs, bool Enabled, typename>
+typename KFoldCV<MLAlgorithm,
+                 Metric,
+                 MatType,
+                 PredictionsType,
+                 WeightsType>::EvaluationType
+KFoldCV<MLAlgorithm,
+        Metric,
+        MatType,
+        PredictionsType,
+        WeightsType>::TrainAndEvaluate(
+    const MLAlgorithmArgs&... args)
+{
+  std::vector<EvaluationType> evaluations(k);
+
+  // The folds are independent, so they can all be trained at once.  An
+  // exception thrown by one fold is rethrown once all of them are done.
+  std::exception_ptr exception;
+  const size_t threads = FoldThreads();
+  #pragma omp parallel for num_threads(threads) schedule(dynamic)
+  for (omp_size_t i = 0; i < (omp_size_t) k; ++i)
+  {
+    try
+    {
+      MLAlgorithm&& model  = base.Train(GetTrainingSubset(xs, i),
+          GetTrainingSubset(ys, i), args...);
+      evaluations[i] = Metric::Evaluate(model, GetValidationSubset(xs, i),
+          GetValidationSubset(ys, i));
+      if ((size_t) i == k - 1)
+        modelPtr.reset(new MLAlgorithm(std::move(model)));
+    }
+    catch (...)
+    {
+      #pragma omp critical
+      {
+        if (!exception)
+          exception = std::current_exception();
+      }
+    }
+  }
+
+  if (exception)
+    std::rethrow_exception(exception);
+
+  return MeanEvaluation(evaluations, true);
+}
+
+template<typename MLAlgorithm,
+         typename Metric,
+         typename MatType,
+         typename PredictionsType,
+         typename WeightsType>
+template<typename... MLAlgorithmArgs, bool Enabled, typename, typename>
+typename KFoldCV<MLAlgorithm,
+                 Metric,
+                 MatType,
+                 PredictionsType,
+                 WeightsType>::EvaluationType
+KFoldCV<MLAlgorithm,
+        Metric,
+        MatType,
+        PredictionsType,
+        WeightsType>::TrainAndEvaluate(
+    const MLAlgorithmArgs&... args)
+{
+  std::vector<EvaluationType> evaluations(k);
+
+  // The folds are independent, so they can all be trained at once.  An
+  // exception thrown by one fold is rethrown once all of them are done.
+  std::exception_ptr exception;
+  const size_t threads = FoldThreads();
+  #pragma omp parallel for num_threads(threads) schedule(dynamic)
+  for (omp_size_t i = 0; i < (omp_size_t) k; ++i)
+  {
+    try
+    {
+      MLAlgorithm&& model = (weights.n_elem > 0) ?
+          base.Train(GetTrainingSubset(xs, i), GetTrainingSubset(ys, i),
+              GetTrainingSubset(weights, i), args...) :
+          base.Train(GetTrainingSubset(xs, i), GetTrainingSubset(ys, i),
+              args...);
+      evaluations[i] = Metric::Evaluate(model, GetValidationSubset(xs, i),
+          GetValidationSubset(ys, i));
+      if ((size_t) i == k - 1)
+        modelPtr.reset(new MLAlgorithm(std::move(model)));
+    }
+    catch (...)
+    {
+      #pragma omp critical
+      {
+        if (!exception)
+          exception = std::current_exception();
+      }
+    }
+  }
+
+  if (exception)
+    std::rethrow_exception(exception);
+
+  return MeanEvaluation(evaluations, false);
+}
+
+template<typename MLAlgorithm,
+         typename Metric,
+         typename MatType,
+         typename PredictionsType,
+         typename WeightsType>
 double KFoldCV<MLAlgorithm,
-                Metric,
-                MatType,
-                PredictionsType,
-                WeightsType>::TrainAndEvaluate(const MLAlgorithmArgs&... args)
+               Metric,
+               MatType,
+               PredictionsType,
+               WeightsType>::MeanEvaluation(
+    const std::vector<double>& evaluations,
+    const bool ignoreInvalid)
 {
-  arma::vec evaluations(k);
+  const arma::vec scores(evaluations);
+  if (!ignoreInvalid)
+    return arma::mean(scores);
 
   size_t numInvalidScores = 0;
-  for (size_t i = 0; i < k; ++i)
+  for (size_t i = 0; i < scores.n_elem; ++i)
   {
-    MLAlgorithm&& model  = base.Train(GetTrainingSubset(xs, i),
-        GetTrainingSubset(ys, i), args...);
-    evaluations(i) = Metric::Evaluate(model, GetValidationSubset(xs, i),
-        GetValidationSubset(ys, i));
-    if (std::isnan(evaluations(i)) || std::isinf(evaluations(i)))
+    if (std::isnan(scores(i)) || std::isinf(scores(i)))
     {
       ++numInvalidScores;
       Log::Warn << "KFoldCV::TrainAndEvaluate(): fold " << i << " returned "
-          << "a score of " << evaluations(i) << "; ignoring when computing "
+          << "a score of " << scores(i) << "; ignoring when computing "
           << "the average score." << std::endl;
     }
-    if (i == k - 1)
-      modelPtr.reset(new MLAlgorithm(std::move(model)));
   }
 
-  if (numInvalidScores == k)
+  if (numInvalidScores == scores.n_elem)
   {
     Log::Warn << "KFoldCV::TrainAndEvaluate(): all folds returned invalid "
         << "scores!  Returning 0.0 as overall score." << std::endl;
     return 0.0;
   }
 
-  return arma::mean(evaluations.elem(arma::find_finite(evaluations)));
+  return arma::mean(scores.elem(arma::find_finite(scores)));
 }
 
 template<typename MLAlgorithm,
@@ -279,29 +412,34 @@ template<typename MLAlgorithm,
          typename MatType,
          typename PredictionsType,
          typename WeightsType>
-template<typename... MLAlgorithmArgs, bool Enabled, typename, typename>
-double KFoldCV<MLAlgorithm,
-                Metric,
-                MatType,
-                PredictionsType,
-                WeightsType>::TrainAndEvaluate(const MLAlgorithmArgs&... args)
+arma::vec KFoldCV<MLAlgorithm,
+                  Metric,
+                  MatType,
+                  PredictionsType,
+                  WeightsType>::MeanEvaluation(
+    const std::vector<arma::vec>& evaluations,
+    const bool ignoreInvalid)
 {
-  arma::vec evaluations(k);
-
-  for (size_t i = 0; i < k; ++i)
+  // One column per fold.
+  arma::mat scores(evaluations[0].n_elem, evaluations.size());
+  for (size_t i = 0; i < evaluations.size(); ++i)
+    scores.col(i) = evaluations[i];
+
+  if (!ignoreInvalid)
+    return arma::mean(scores, 1);
+
+  // Each value is averaged over the folds where it is valid (or is 0 if it is
+  // valid for no fold).
+  arma::vec means(scores.n_rows, arma::fill::zeros);
+  for (size_t j = 0; j < scores.n_rows; ++j)
   {
-    MLAlgorithm&& model = (weights.n_elem > 0) ?
-        base.Train(GetTrainingSubset(xs, i), GetTrainingSubset(ys, i),
-            GetTrainingSubset(weights, i), args...) :
-        base.Train(GetTrainingSubset(xs, i), GetTrainingSubset(ys, i),
-            args...);
-    evaluations(i) = Metric::Evaluate(model, GetValidationSubset(xs, i),
-        GetValidationSubset(ys, i));
-    if (i == k - 1)
-      modelPtr.reset(new MLAlgorithm(std::move(model)));
+    const arma::rowvec values = scores.row(j);
+    const arma::uvec finite = arma::find_finite(values);
+    if (finite.n_elem > 0)
+      means[j] = arma::mean(values.elem(finite));
   }
 
-  return arma::mean(evaluations);
+  return means;
 }
 
 template<typename MLAlgorithm,
@@ -371,6 +509,30 @@ size_t KFoldCV<MLAlgorithm,
   return (i == 0) ? binSize * (k - 1) : binSize * (i - 1);
 }
 
+template<typename MLAlgorithm,
+         typename Metric,
+         typename MatType,
+         typename PredictionsType,
+         typename WeightsType>
+size_t KFoldCV<MLAlgorithm,
+               Metric,
+               MatType,
+               PredictionsType,
+               WeightsType>::TrainingSubsetSize(const size_t i) const
+{
+  // If this is not the first fold, we have to handle it a little bit
+  // differently, since the last fold may contain slightly more than 'binSize'
+  // points.
+  const size_t subsetSize = (i != 0) ? lastBinSize + (k - 2) * binSize :
+      (k - 1) * binSize;
+
+  if (trainingFraction >= 1.0)
+    return subsetSize;
+
+  return std::max((size_t) 1,
+      (size_t) std::ceil(trainingFraction * subsetSize));
+}
+
 template<typename MLAlgorithm,
          typename Metric,
          typename MatType,
@@ -385,11 +547,7 @@ arma::Mat<ElementType> KFoldCV<MLAlgorithm,
     arma::Mat<ElementType>& m,
     const size_t i)
 {
-  // If this is not the first fold, we have to handle it a little bit
-  // differently, since the last fold may contain slightly more than 'binSize'
-  // points.
-  const size_t subsetSize = (i != 0) ? lastBinSize + (k - 2) * binSize :
-      (k - 1) * binSize;
+  const size_t subsetSize = TrainingSubsetSize(i);
 
   return arma::Mat<ElementType>(m.colptr(binSize * i), m.n_rows, subsetSize,
       false, true);
@@ -409,11 +567,7 @@ arma::Row<ElementType> KFoldCV<MLAlgorithm,
     arma::Row<ElementType>& r,
     const size_t i)
 {
-  // If this is not the first fold, we have to handle it a little bit
-  // differently, since the last fold may contain slightly more than 'binSize'
-  // points.
-  const size_t subsetSize = (i != 0) ? lastBinSize + (k - 2) * binSize :
-      (k - 1) * binSize;
+  const size_t subsetSize = TrainingSubsetSize(i);
 
   return arma::Row<ElementType>(r.colptr(binSize * i), subsetSize, false, true);
 }
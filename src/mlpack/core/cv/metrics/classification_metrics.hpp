@@ -0,0 +1,105 @@
+/**
+ * @file core/cv/metrics/classification_metrics.hpp
+ *
+ * The ClassificationMetrics bundle, which computes accuracy, precision, recall
+ * and F1 from one classification of the data.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_CV_METRICS_CLASSIFICATION_METRICS_HPP
+#define MLPACK_CORE_CV_METRICS_CLASSIFICATION_METRICS_HPP
+
+#include <mlpack/core.hpp>
+#include <mlpack/core/cv/metrics/average_strategy.hpp>
+
+namespace mlpack {
+namespace cv {
+
+/**
+ * ClassificationMetrics is a bundle of the Accuracy, Precision, Recall and F1
+ * metrics.  Each of those metrics classifies the data when it is evaluated, so
+ * evaluating all four classifies the data four times; ClassificationMetrics
+ * classifies it once, builds the confusion matrix of the predictions (with
+ * data::ConfusionMatrix()), and derives every metric from it.  The values are
+ * the same as those of Accuracy, Precision<AS, PositiveClass>,
+ * Recall<AS, PositiveClass> and F1<AS, PositiveClass>.
+ *
+ * Evaluate() returns a vector of the four values, indexed by AccuracyIndex,
+ * PrecisionIndex, RecallIndex and F1Index.  It can be used as the metric of
+ * KFoldCV and SimpleCV, which then return the (averaged) vector:
+ *
+ * @code
+ * typedef ClassificationMetrics<Macro> Metrics;
+ * KFoldCV<RandomForest<>, Metrics> cv(10, data, labels, numClasses);
+ * arma::vec results = cv.Evaluate(numTrees, minimumLeafSize);
+ * double f1 = results[Metrics::F1Index];
+ * @endcode
+ *
+ * Since the result is not one value, ClassificationMetrics cannot be used by
+ * the hyper-parameter tuner.
+ *
+ * @tparam AS An average strategy.
+ * @tparam PositiveClass In the case of binary classification (AS = Binary)
+ *     positives are assumed to have labels equal to this value.
+ */
+template<AverageStrategy AS, size_t PositiveClass = 1>
+class ClassificationMetrics
+{
+ public:
+  //! The index of the accuracy in the results.
+  static const size_t AccuracyIndex = 0;
+  //! The index of the precision in the results.
+  static const size_t PrecisionIndex = 1;
+  //! The index of the recall in the results.
+  static const size_t RecallIndex = 2;
+  //! The index of the F1 score in the results.
+  static const size_t F1Index = 3;
+
+  /**
+   * Run classification once and calculate every metric.
+   *
+   * @param model A classification model.
+   * @param data Column-major data containing test items.
+   * @param labels Ground truth (correct) labels for the test items.
+   * @return The accuracy, precision, recall and F1 score.
+   */
+  template<typename MLAlgorithm, typename DataType>
+  static arma::vec Evaluate(MLAlgorithm& model,
+                            const DataType& data,
+                            const arma::Row<size_t>& labels);
+
+  /**
+   * Calculate every metric from already computed predictions.
+   *
+   * @param predictions Predicted labels of the test items.
+   * @param labels Ground truth (correct) labels for the test items.
+   * @return The accuracy, precision, recall and F1 score.
+   */
+  static arma::vec Evaluate(const arma::Row<size_t>& predictions,
+                            const arma::Row<size_t>& labels);
+
+  /**
+   * Information for hyper-parameter tuning code. It indicates that we want
+   * to maximize the metrics.
+   */
+  static const bool NeedsMinimization = false;
+
+ private:
+  //! Compute the precision, recall and F1 score of one class.
+  static void ClassMetrics(const arma::Mat<size_t>& confusion,
+                           const size_t c,
+                           double& precision,
+                           double& recall,
+                           double& f1);
+};
+
+} // namespace cv
+} // namespace mlpack
+
+// Include implementation.
+#include "classification_metrics_impl.hpp"
+
+#endif
@@ -0,0 +1,114 @@
+/**
+ * @file core/cv/metrics/classification_metrics_impl.hpp
+ *
+ * Implementation of the ClassificationMetrics bundle.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_CV_METRICS_CLASSIFICATION_METRICS_IMPL_HPP
+#define MLPACK_CORE_CV_METRICS_CLASSIFICATION_METRICS_IMPL_HPP
+
+#include <mlpack/core/cv/metrics/facilities.hpp>
+#include <mlpack/core/data/confusion_matrix.hpp>
+
+namespace mlpack {
+namespace cv {
+
+template<AverageStrategy AS, size_t PC /* PositiveClass */>
+template<typename MLAlgorithm, typename DataType>
+arma::vec ClassificationMetrics<AS, PC>::Evaluate(
+    MLAlgorithm& model,
+    const DataType& data,
+    const arma::Row<size_t>& labels)
+{
+  AssertSizes(data, labels, "ClassificationMetrics::Evaluate()");
+
+  arma::Row<size_t> predictedLabels;
+  model.Classify(data, predictedLabels);
+
+  return Evaluate(predictedLabels, labels);
+}
+
+template<AverageStrategy AS, size_t PC /* PositiveClass */>
+arma::vec ClassificationMetrics<AS, PC>::Evaluate(
+    const arma::Row<size_t>& predictions,
+    const arma::Row<size_t>& labels)
+{
+  if (predictions.n_elem != labels.n_elem)
+  {
+    std::ostringstream oss;
+    oss << "ClassificationMetrics::Evaluate(): number of predictions ("
+        << predictions.n_elem << ") does not match number of labels ("
+        << labels.n_elem << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  // As for the other metrics, the classes are [0, max(labels)]; the confusion
+  // matrix also has a row for each predicted label (and for the positive class
+  // of binary classification).
+  const size_t numClasses = (labels.n_elem == 0) ? 0 : arma::max(labels) + 1;
+  size_t confusionSize = std::max(numClasses, PC + 1);
+  if (predictions.n_elem > 0)
+  {
+    confusionSize = std::max(confusionSize,
+        (size_t) arma::max(predictions) + 1);
+  }
+
+  // The rows are the predicted classes and the columns are the actual classes.
+  arma::Mat<size_t> confusion;
+  data::ConfusionMatrix(predictions, labels, confusion, confusionSize);
+
+  arma::vec results(4);
+  results[AccuracyIndex] = (double) arma::trace(confusion) / labels.n_elem;
+
+  if (AS == Binary)
+  {
+    ClassMetrics(confusion, PC, results[PrecisionIndex], results[RecallIndex],
+        results[F1Index]);
+  }
+  else if (AS == Micro)
+  {
+    // Microaveraged precision, recall and F1 are all the same as accuracy.
+    results[PrecisionIndex] = results[AccuracyIndex];
+    results[RecallIndex] = results[AccuracyIndex];
+    results[F1Index] = results[AccuracyIndex];
+  }
+  else
+  {
+    arma::vec precisions(numClasses), recalls(numClasses), f1s(numClasses);
+    for (size_t c = 0; c < numClasses; ++c)
+      ClassMetrics(confusion, c, precisions[c], recalls[c], f1s[c]);
+
+    results[PrecisionIndex] = arma::mean(precisions);
+    results[RecallIndex] = arma::mean(recalls);
+    results[F1Index] = arma::mean(f1s);
+  }
+
+  return results;
+}
+
+template<AverageStrategy AS, size_t PC /* PositiveClass */>
+void ClassificationMetrics<AS, PC>::ClassMetrics(
+    const arma::Mat<size_t>& confusion,
+    const size_t c,
+    double& precision,
+    double& recall,
+    double& f1)
+{
+  const size_t tp = confusion(c, c);
+  const size_t positivePredictions = arma::accu(confusion.row(c));
+  const size_t positiveLabels = arma::accu(confusion.col(c));
+
+  precision = double(tp) / positivePredictions;
+  recall = double(tp) / positiveLabels;
+  f1 = (precision + recall == 0.0) ? 0.0 :
+      2.0 * precision * recall / (precision + recall);
+}
+
+} // namespace cv
+} // namespace mlpack
+
+#endif
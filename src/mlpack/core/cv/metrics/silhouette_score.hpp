@@ -36,6 +36,13 @@ namespace cv {
  * @f}
  *
  * The Overall Silhouette Score is the mean of individual silhoutte scores.
+ *
+ * When the distances are not precomputed, the full distance matrix is never
+ * stored: the sums of the distances from each point to each cluster are
+ * accumulated block by block, in parallel over blocks of points (with OpenMP).
+ * For the Euclidean and squared Euclidean distances, the distances of a block
+ * are computed with one matrix multiplication.  ApproximateOverall() estimates
+ * the overall score from a sample of the points, with its standard error.
  */
 class SilhouetteScore
 {
@@ -78,6 +85,28 @@ class SilhouetteScore
                                    const arma::Row<size_t>& labels,
                                    const Metric& metric);
 
+  /**
+   * Estimate the overall silhouette score from the scores of a random sample
+   * of the points (each of which is still computed exactly, against every
+   * point).  The standard error of the estimate is also returned; a 95%
+   * confidence interval of the overall score is the estimate plus or minus
+   * 1.96 standard errors.  If numSamples is at least the number of points,
+   * the exact overall score is returned, with a standard error of 0.
+   *
+   * @param X Column-major data used for clustering.
+   * @param labels Labels assigned to data by clustering.
+   * @param metric Metric to be used to calculate dissimilarity.
+   * @param numSamples Number of points to sample.
+   * @param standardError Standard error of the estimate.
+   * @return (double) estimated silhouette score.
+   */
+  template<typename DataType, typename Metric>
+  static double ApproximateOverall(const DataType& X,
+                                   const arma::Row<size_t>& labels,
+                                   const Metric& metric,
+                                   const size_t numSamples,
+                                   double& standardError);
+
   /**
    * Find mean distance of element from a given cluster.
    *
@@ -97,6 +126,41 @@ class SilhouetteScore
    * to maximize the metric.
    */
   static const bool NeedsMinimization = false;
+
+ private:
+  /**
+   * Compute the silhouette scores of the given points (indices into X),
+   * without storing the distance matrix.
+   */
+  template<typename DataType, typename Metric>
+  static arma::rowvec PointsScore(const DataType& X,
+                                  const arma::Row<size_t>& labels,
+                                  const arma::uvec& points,
+                                  const Metric& metric);
+
+  /**
+   * Compute the distances between the given query points (indices into X) and
+   * the reference points [begin, end) of X, one row per query point.
+   */
+  template<typename DataType, typename Metric>
+  static void BlockDistances(const DataType& X,
+                             const arma::uvec& queries,
+                             const size_t begin,
+                             const size_t end,
+                             const Metric& metric,
+                             arma::mat& distances);
+
+  /**
+   * Compute the Euclidean (or squared Euclidean) distances of a block with a
+   * matrix multiplication, from ||x - y||^2 = ||x||^2 + ||y||^2 - 2 x^T y.
+   */
+  template<typename DataType, bool TakeRoot>
+  static void BlockDistances(const DataType& X,
+                             const arma::uvec& queries,
+                             const size_t begin,
+                             const size_t end,
+                             const metric::LMetric<2, TakeRoot>& metric,
+                             arma::mat& distances);
 };
 
 } // namespace cv
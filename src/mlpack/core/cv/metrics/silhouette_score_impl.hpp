@@ -26,6 +26,39 @@ double SilhouetteScore::Overall(const DataType& X,
   return arma::mean(SamplesScore(X, labels, metric));
 }
 
+template<typename DataType, typename Metric>
+double SilhouetteScore::ApproximateOverall(const DataType& X,
+                                           const arma::Row<size_t>& labels,
+                                           const Metric& metric,
+                                           const size_t numSamples,
+                                           double& standardError)
+{
+  AssertSizes(X, labels, "SilhouetteScore::ApproximateOverall()");
+  if (numSamples == 0)
+  {
+    throw std::invalid_argument("SilhouetteScore::ApproximateOverall(): "
+        "numSamples must be positive!");
+  }
+
+  const size_t n = X.n_cols;
+  if (numSamples >= n)
+  {
+    standardError = 0.0;
+    return Overall(X, labels, metric);
+  }
+
+  const arma::uvec samples = arma::sort(arma::randperm(n, numSamples));
+  const arma::rowvec scores = PointsScore(X, labels, samples, metric);
+
+  // The standard error of the mean of a sample drawn without replacement,
+  // with the finite population correction.
+  const double variance = (numSamples > 1) ? arma::var(scores) : 0.0;
+  standardError = std::sqrt(variance / numSamples *
+      (double) (n - numSamples) / (double) (n - 1));
+
+  return arma::mean(scores);
+}
+
 template<typename DataType>
 arma::rowvec SilhouetteScore::SamplesScore(const DataType& distances,
                                            const arma::Row<size_t>& labels)
@@ -77,14 +110,150 @@ arma::rowvec SilhouetteScore::SamplesScore(const DataType& X,
                                            const Metric& metric)
 {
   AssertSizes(X, labels, "SilhouetteScore::SamplesScore()");
-  DataType distances = PairwiseDistances(X, metric);
-  return SamplesScore(distances, labels);
+  if (X.n_cols == 0)
+    return arma::rowvec();
+
+  return PointsScore(X, labels, arma::regspace<arma::uvec>(0, X.n_cols - 1),
+      metric);
+}
+
+template<typename DataType, typename Metric>
+arma::rowvec SilhouetteScore::PointsScore(const DataType& X,
+                                          const arma::Row<size_t>& labels,
+                                          const arma::uvec& points,
+                                          const Metric& metric)
+{
+  const size_t n = X.n_cols;
+
+  // Map the labels (which may be any values, for instance the noise label of
+  // DBSCAN) to cluster indices.
+  const arma::Row<size_t> uniqueLabels = arma::unique(labels);
+  const size_t numClusters = uniqueLabels.n_elem;
+  arma::uvec clusters(n);
+  arma::uvec clusterSizes(numClusters, arma::fill::zeros);
+  for (size_t i = 0; i < n; ++i)
+  {
+    clusters[i] = std::lower_bound(uniqueLabels.begin(), uniqueLabels.end(),
+        labels[i]) - uniqueLabels.begin();
+    ++clusterSizes[clusters[i]];
+  }
+
+  // The sum of the distances from each point to each cluster.  Each block of
+  // points is handled by one thread, and only writes its own columns.
+  const size_t queryBlockSize = 64;
+  const size_t referenceBlockSize = 1024;
+  const size_t numBlocks = (points.n_elem + queryBlockSize - 1) /
+      queryBlockSize;
+  arma::mat sums(numClusters, points.n_elem, arma::fill::zeros);
+
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+  {
+    const size_t queryBegin = b * queryBlockSize;
+    const size_t queryEnd = std::min(queryBegin + queryBlockSize,
+        (size_t) points.n_elem);
+    const arma::uvec queries = points.subvec(queryBegin, queryEnd - 1);
+
+    arma::mat distances;
+    for (size_t begin = 0; begin < n; begin += referenceBlockSize)
+    {
+      const size_t end = std::min(begin + referenceBlockSize, n);
+      BlockDistances(X, queries, begin, end, metric, distances);
+
+      for (size_t q = 0; q < queries.n_elem; ++q)
+      {
+        double* pointSums = sums.colptr(queryBegin + q);
+        for (size_t j = begin; j < end; ++j)
+        {
+          if (j != queries[q])
+            pointSums[clusters[j]] += distances(q, j - begin);
+        }
+      }
+    }
+  }
+
+  arma::rowvec sampleScores(points.n_elem);
+  for (size_t q = 0; q < points.n_elem; ++q)
+  {
+    const size_t cluster = clusters[points[q]];
+    if (clusterSizes[cluster] == 1)
+    {
+      // The point is the only element in the cluster.
+      sampleScores[q] = 0.0;
+      continue;
+    }
+
+    const double intraClusterDistance = sums(cluster, q) /
+        (clusterSizes[cluster] - 1);
+    if (intraClusterDistance == 0)
+    {
+      sampleScores[q] = 0.0;
+      continue;
+    }
+
+    double minInterClusterDistance = DBL_MAX;
+    for (size_t c = 0; c < numClusters; ++c)
+    {
+      if (c != cluster)
+      {
+        minInterClusterDistance = std::min(minInterClusterDistance,
+            sums(c, q) / clusterSizes[c]);
+      }
+    }
+
+    sampleScores[q] = (minInterClusterDistance - intraClusterDistance) /
+        std::max(intraClusterDistance, minInterClusterDistance);
+  }
+
+  return sampleScores;
+}
+
+template<typename DataType, typename Metric>
+void SilhouetteScore::BlockDistances(const DataType& X,
+                                     const arma::uvec& queries,
+                                     const size_t begin,
+                                     const size_t end,
+                                     const Metric& metric,
+                                     arma::mat& distances)
+{
+  distances.set_size(queries.n_elem, end - begin);
+  for (size_t j = begin; j < end; ++j)
+    for (size_t q = 0; q < queries.n_elem; ++q)
+      distances(q, j - begin) = metric.Evaluate(X.col(queries[q]), X.col(j));
+}
+
+template<typename DataType, bool TakeRoot>
+void SilhouetteScore::BlockDistances(
+    const DataType& X,
+    const arma::uvec& queries,
+    const size_t begin,
+    const size_t end,
+    const metric::LMetric<2, TakeRoot>& /* metric */,
+    arma::mat& distances)
+{
+  const arma::mat queryPoints = arma::conv_to<arma::mat>::from(
+      X.cols(queries));
+  const arma::mat referencePoints = arma::conv_to<arma::mat>::from(
+      X.cols(begin, end - 1));
+  const arma::vec queryNorms = arma::sum(arma::square(queryPoints), 0).t();
+  const arma::rowvec referenceNorms = arma::sum(arma::square(referencePoints),
+      0);
+
+  distances = -2.0 * queryPoints.t() * referencePoints;
+  distances.each_col() += queryNorms;
+  distances.each_row() += referenceNorms;
+
+  // Rounding may make some of the squared distances slightly negative.
+  distances.transform([](const double d) { return std::max(d, 0.0); });
+  if (TakeRoot)
+    distances = arma::sqrt(distances);
 }
 
-double SilhouetteScore::MeanDistanceFromCluster(const arma::colvec& distances,
-                                                const arma::Row<size_t>& labels,
-                                                const size_t& elemLabel,
-                                                const bool& sameCluster)
+inline double SilhouetteScore::MeanDistanceFromCluster(
+    const arma::colvec& distances,
+    const arma::Row<size_t>& labels,
+    const size_t& elemLabel,
+    const bool& sameCluster)
 {
   // Find indices of elements with same label as elemLabel.
   arma::uvec sameClusterIndices = arma::find(labels == elemLabel);
@@ -68,6 +68,11 @@ template<typename MLAlgorithm,
 class SimpleCV
 {
  public:
+  //! The type of the result of Evaluate(): double for a single metric, or
+  //! arma::vec for a bundle of metrics.
+  typedef MetricEvaluationType<Metric, MLAlgorithm, MatType, PredictionsType>
+      EvaluationType;
+
   /**
    * This constructor can be used for regression algorithms and for binary
    * classification algorithms.
@@ -206,11 +211,19 @@ class SimpleCV
    *     (in addition to the passed ones in the SimpleCV constructor).
    */
   template<typename... MLAlgorithmArgs>
-  double Evaluate(const MLAlgorithmArgs&... args);
+  EvaluationType Evaluate(const MLAlgorithmArgs&... args);
 
   //! Access and modify the last trained model.
   MLAlgorithm& Model();
 
+  //! Get the fraction of the training set that models are trained on.
+  double TrainingFraction() const { return trainingFraction; }
+  //! Modify the fraction of the training set that models are trained on.  The
+  //! default is 1; smaller values train on the first points of the training
+  //! set only, and are used for budget-aware hyper-parameter search (see
+  //! hpt::SuccessiveHalving).  The validation set is not affected.
+  double& TrainingFraction() { return trainingFraction; }
+
  private:
   //! A short alias for CVBase.
   using Base = CVBase<MLAlgorithm, MatType, PredictionsType, WeightsType>;
@@ -240,6 +253,9 @@ class SimpleCV
   //! The pointer to the last trained model.
   std::unique_ptr<MLAlgorithm> modelPtr;
 
+  //! The fraction of the training set to train on.
+  double trainingFraction;
+
   /**
    * Assert data consistency and initialize fields required for running
    * cross-validation.
@@ -269,6 +285,12 @@ class SimpleCV
    */
   size_t CalculateAndAssertNumberOfTrainingPoints(const double validationSize);
 
+  /**
+   * Get the index of the last training point that is used for training (see
+   * TrainingFraction()).
+   */
+  size_t TrainingLastCol() const;
+
   /**
    * Get the specified submatrix without coping the data.
    */
@@ -291,7 +313,7 @@ class SimpleCV
   template<typename... MLAlgorithmArgs,
            bool Enabled = !Base::MIE::SupportsWeights,
            typename = typename std::enable_if<Enabled>::type>
-  double TrainAndEvaluate(const MLAlgorithmArgs&... args);
+  EvaluationType TrainAndEvaluate(const MLAlgorithmArgs&... args);
 
   /**
    * Train and run evaluation in the case of supporting weighted learning.
@@ -300,7 +322,7 @@ class SimpleCV
            bool Enabled = Base::MIE::SupportsWeights,
            typename = typename std::enable_if<Enabled>::type,
            typename = void>
-  double TrainAndEvaluate(const MLAlgorithmArgs&... args);
+  EvaluationType TrainAndEvaluate(const MLAlgorithmArgs&... args);
 };
 
 } // namespace cv
@@ -143,7 +143,8 @@ SimpleCV<MLAlgorithm,
                                 PIT&& ys) :
     base(std::move(base)),
     xs(std::forward<MIT>(xs)),
-    ys(std::forward<PIT>(ys))
+    ys(std::forward<PIT>(ys)),
+    trainingFraction(1.0)
 {
   Base::AssertDataConsistency(this->xs, this->ys);
 
@@ -188,11 +189,16 @@ template<typename MLAlgorithm,
          typename PredictionsType,
          typename WeightsType>
 template<typename... MLAlgorithmArgs>
-double SimpleCV<MLAlgorithm,
-                Metric,
-                MatType,
-                PredictionsType,
-                WeightsType>::Evaluate(const MLAlgorithmArgs&... args)
+typename SimpleCV<MLAlgorithm,
+                  Metric,
+                  MatType,
+                  PredictionsType,
+                  WeightsType>::EvaluationType
+SimpleCV<MLAlgorithm,
+         Metric,
+         MatType,
+         PredictionsType,
+         WeightsType>::Evaluate(const MLAlgorithmArgs&... args)
 {
   return TrainAndEvaluate(args...);
 }
@@ -243,6 +249,24 @@ size_t SimpleCV<MLAlgorithm,
   return trainingPoints;
 }
 
+template<typename MLAlgorithm,
+         typename Metric,
+         typename MatType,
+         typename PredictionsType,
+         typename WeightsType>
+size_t SimpleCV<MLAlgorithm,
+                Metric,
+                MatType,
+                PredictionsType,
+                WeightsType>::TrainingLastCol() const
+{
+  if (trainingFraction >= 1.0)
+    return trainingXs.n_cols - 1;
+
+  return std::max((size_t) 1,
+      (size_t) std::ceil(trainingFraction * trainingXs.n_cols)) - 1;
+}
+
 template<typename MLAlgorithm,
          typename Metric,
          typename MatType,
@@ -287,13 +311,21 @@ template<typename MLAlgorithm,
          typename PredictionsType,
          typename WeightsType>
 template<typename... MLAlgorithmArgs, bool Enabled, typename>
-double SimpleCV<MLAlgorithm,
-                Metric,
-                MatType,
-                PredictionsType,
-                WeightsType>::TrainAndEvaluate(const MLAlgorithmArgs&... args)
+typename SimpleCV<MLAlgorithm,
+                  Metric,
+                  MatType,
+                  PredictionsType,
+                  WeightsType>::EvaluationType
+SimpleCV<MLAlgorithm,
+         Metric,
+         MatType,
+         PredictionsType,
+         WeightsType>::TrainAndEvaluate(
+    const MLAlgorithmArgs&... args)
 {
-  modelPtr.reset(new MLAlgorithm(base.Train(trainingXs, trainingYs, args...)));
+  const size_t lastCol = TrainingLastCol();
+  modelPtr.reset(new MLAlgorithm(base.Train(GetSubset(trainingXs, 0, lastCol),
+      GetSubset(trainingYs, 0, lastCol), args...)));
 
   return Metric::Evaluate(*modelPtr, validationXs, validationYs);
 }
@@ -304,18 +336,28 @@ template<typename MLAlgorithm,
          typename PredictionsType,
          typename WeightsType>
 template<typename... MLAlgorithmArgs, bool Enabled, typename, typename>
-double SimpleCV<MLAlgorithm,
-                Metric,
-                MatType,
-                PredictionsType,
-                WeightsType>::TrainAndEvaluate(const MLAlgorithmArgs&... args)
+typename SimpleCV<MLAlgorithm,
+                  Metric,
+                  MatType,
+                  PredictionsType,
+                  WeightsType>::EvaluationType
+SimpleCV<MLAlgorithm,
+         Metric,
+         MatType,
+         PredictionsType,
+         WeightsType>::TrainAndEvaluate(
+    const MLAlgorithmArgs&... args)
 {
+  const size_t lastCol = TrainingLastCol();
   if (trainingWeights.n_elem > 0)
     modelPtr.reset(new MLAlgorithm(
-        base.Train(trainingXs, trainingYs, trainingWeights, args...)));
+        base.Train(GetSubset(trainingXs, 0, lastCol),
+            GetSubset(trainingYs, 0, lastCol),
+            GetSubset(trainingWeights, 0, lastCol), args...)));
   else
     modelPtr.reset(new MLAlgorithm(
-        base.Train(trainingXs, trainingYs, args...)));
+        base.Train(GetSubset(trainingXs, 0, lastCol),
+            GetSubset(trainingYs, 0, lastCol), args...)));
 
   return Metric::Evaluate(*modelPtr, validationXs, validationYs);
 }
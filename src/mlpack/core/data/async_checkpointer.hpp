@@ -0,0 +1,210 @@
+/**
+ * @file core/data/async_checkpointer.hpp
+ *
+ * Definition of AsyncCheckpointer, which saves snapshots of a model on a
+ * background thread, and of CheckpointCallback, which checkpoints a model at
+ * the end of the epochs of an ensmallen optimization.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_ASYNC_CHECKPOINTER_HPP
+#define MLPACK_CORE_DATA_ASYNC_CHECKPOINTER_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "save.hpp"
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace mlpack {
+namespace data {
+
+/**
+ * The AsyncCheckpointer saves checkpoints of a model without stalling the
+ * training: Save() only copies the model, and the copy is serialized and
+ * written with data::Save() on a background thread while the training goes on.
+ * The checkpoints are numbered; given the filename "ffn.bin", they are written
+ * to "ffn-1.bin", "ffn-2.bin", and so on, and only the last Keep() of them are
+ * kept on disk.  Each checkpoint is first written to a temporary file (e.g.
+ * "ffn-1.partial.bin") and then renamed, so that a crash during a write never
+ * leaves a truncated checkpoint behind.
+ *
+ * @code
+ * data::AsyncCheckpointer checkpointer("checkpoints/model.bin", 3);
+ * for (size_t round = 0; round < rounds; ++round)
+ * {
+ *   // ... train the model for a while ...
+ *   checkpointer.Save("model", model);
+ * }
+ * checkpointer.Wait();
+ * @endcode
+ *
+ * If a new checkpoint is requested while the previous one is still being
+ * written, it is held until the write finishes; if yet another one is requested
+ * meanwhile, it replaces the waiting one (which is counted in NumSkipped()).
+ * The waiting copy is released before the new copy is made, so that at most
+ * two copies of the model (the one being written and the one waiting) exist at
+ * any time no matter how slow the disk is, as long as Save() is only called
+ * from one thread at a time.  An error thrown while a checkpoint is written is
+ * thrown again by the next call to Save() or Wait().  The destructor writes the
+ * waiting checkpoint, if any, before it returns.
+ */
+class AsyncCheckpointer
+{
+ public:
+  /**
+   * Create the checkpointer and start its background thread.  The format of
+   * the checkpoints is given by the extension of the filename, as for
+   * data::Save(); a std::invalid_argument is thrown if it has no extension, or
+   * if keep is 0.
+   *
+   * @param filename Name of the checkpoints, before they are numbered.
+   * @param keep Number of checkpoints kept on disk.
+   */
+  AsyncCheckpointer(const std::string& filename, const size_t keep = 3);
+
+  // The background thread uses the checkpointer.
+  AsyncCheckpointer(const AsyncCheckpointer& other) = delete;
+  AsyncCheckpointer& operator=(const AsyncCheckpointer& other) = delete;
+
+  //! Write the waiting checkpoint, if any, and stop the background thread.
+  ~AsyncCheckpointer();
+
+  /**
+   * Copy the given object and write the copy to the next checkpoint on the
+   * background thread.  The object must be copyable and serializable.
+   *
+   * @param name Name of the object in the checkpoint, as for data::Save().
+   * @param object Object to checkpoint.
+   */
+  template<typename T>
+  void Save(const std::string& name, const T& object);
+
+  //! Wait until all the requested checkpoints are written.
+  void Wait();
+
+  //! Get the files of the checkpoints kept on disk, from oldest to newest.
+  std::vector<std::string> Checkpoints();
+
+  //! Get the number of checkpoints replaced before they were written.
+  size_t NumSkipped();
+
+  //! Get the number of checkpoints kept on disk.
+  size_t Keep() const { return keep; }
+
+ private:
+  //! Get the file of the given checkpoint.
+  std::string Filename(const size_t checkpoint, const bool partial) const;
+
+  //! Throw the error of the background thread, if any; lock must be held.
+  void RethrowError();
+
+  //! Write the requested checkpoints; this runs on the background thread.
+  void Work();
+
+  //! The filename of the checkpoints, without its extension.
+  std::string base;
+  //! The extension of the checkpoints, with its dot.
+  std::string extension;
+  //! The number of checkpoints kept on disk.
+  size_t keep;
+
+  //! The checkpoint waiting to be written, if any; it is given its filename.
+  std::function<void(const std::string&)> waiting;
+  //! Whether a checkpoint is being written.
+  bool writing;
+  //! The number of the last checkpoint written.
+  size_t last;
+  //! The files of the checkpoints kept on disk.
+  std::deque<std::string> checkpoints;
+  //! The number of checkpoints replaced before they were written.
+  size_t skipped;
+  //! Whether the background thread must stop.
+  bool stop;
+  //! The error thrown while a checkpoint was written, if any.
+  std::exception_ptr error;
+
+  //! The lock of the waiting checkpoint and the state.
+  std::mutex lock;
+  //! Signaled when a checkpoint is requested or written, or on stop.
+  std::condition_variable condition;
+  //! The background thread.
+  std::thread worker;
+};
+
+/**
+ * CheckpointCallback is an ensmallen callback that checkpoints a model with an
+ * AsyncCheckpointer at the end of every period epochs of its training.  Since
+ * FFN and RNN are optimized in place, the model holds the current parameters
+ * at the end of each epoch.
+ *
+ * @code
+ * data::AsyncCheckpointer checkpointer("checkpoints/ffn.bin");
+ * data::CheckpointCallback<FFN<>> checkpoint(model, checkpointer, "ffn", 5);
+ * model.Train(trainData, trainLabels, optimizer, checkpoint);
+ * @endcode
+ *
+ * @tparam ModelType The type of the checkpointed model.
+ */
+template<typename ModelType>
+class CheckpointCallback
+{
+ public:
+  /**
+   * Create the callback.
+   *
+   * @param model The trained model.
+   * @param checkpointer The checkpointer that saves the model.
+   * @param name Name of the model in the checkpoints.
+   * @param period Number of epochs between two checkpoints.
+   */
+  CheckpointCallback(const ModelType& model,
+                     AsyncCheckpointer& checkpointer,
+                     const std::string& name,
+                     const size_t period = 1) :
+      model(model),
+      checkpointer(checkpointer),
+      name(name),
+      period(std::max(period, (size_t) 1))
+  { /* Nothing to do. */ }
+
+  //! Checkpoint the model if the epoch ends a period.
+  template<typename OptimizerType, typename FunctionType, typename MatType>
+  bool EndEpoch(OptimizerType& /* optimizer */,
+                FunctionType& /* function */,
+                const MatType& /* coordinates */,
+                const size_t epoch,
+                const double /* objective */)
+  {
+    if (epoch % period == 0)
+      checkpointer.Save(name, model);
+
+    return false;
+  }
+
+ private:
+  //! The trained model.
+  const ModelType& model;
+  //! The checkpointer that saves the model.
+  AsyncCheckpointer& checkpointer;
+  //! The name of the model in the checkpoints.
+  std::string name;
+  //! The number of epochs between two checkpoints.
+  size_t period;
+};
+
+} // namespace data
+} // namespace mlpack
+
+// Include implementation.
+#include "async_checkpointer_impl.hpp"
+
+#endif
@@ -0,0 +1,195 @@
+/**
+ * @file core/data/async_checkpointer_impl.hpp
+ *
+ * Implementation of AsyncCheckpointer.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_ASYNC_CHECKPOINTER_IMPL_HPP
+#define MLPACK_CORE_DATA_ASYNC_CHECKPOINTER_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "async_checkpointer.hpp"
+
+#include <cstdio>
+
+namespace mlpack {
+namespace data {
+
+inline AsyncCheckpointer::AsyncCheckpointer(const std::string& filename,
+                                            const size_t keep) :
+    keep(keep),
+    writing(false),
+    last(0),
+    skipped(0),
+    stop(false)
+{
+  const size_t dot = filename.rfind('.');
+  const size_t slash = filename.find_last_of("/\\");
+  if (dot == std::string::npos ||
+      (slash != std::string::npos && dot < slash))
+  {
+    throw std::invalid_argument("AsyncCheckpointer::AsyncCheckpointer(): the "
+        "filename '" + filename + "' has no extension to give the format of "
+        "the checkpoints!");
+  }
+
+  if (keep == 0)
+  {
+    throw std::invalid_argument("AsyncCheckpointer::AsyncCheckpointer(): at "
+        "least one checkpoint must be kept!");
+  }
+
+  base = filename.substr(0, dot);
+  extension = filename.substr(dot);
+  worker = std::thread(&AsyncCheckpointer::Work, this);
+}
+
+inline AsyncCheckpointer::~AsyncCheckpointer()
+{
+  {
+    std::lock_guard<std::mutex> guard(lock);
+    stop = true;
+  }
+  condition.notify_all();
+
+  if (worker.joinable())
+    worker.join();
+}
+
+template<typename T>
+void AsyncCheckpointer::Save(const std::string& name, const T& object)
+{
+  // The waiting checkpoint is stale now, so drop it before the new copy is
+  // made; otherwise it would be a third copy next to the one being written.
+  std::function<void(const std::string&)> stale;
+  {
+    std::lock_guard<std::mutex> guard(lock);
+    RethrowError();
+    if (waiting)
+    {
+      ++skipped;
+      stale = std::move(waiting);
+      waiting = nullptr;
+    }
+  }
+  stale = nullptr;
+
+  // The copy is the only part of the checkpoint that the caller waits for.
+  std::shared_ptr<T> snapshot = std::make_shared<T>(object);
+  std::function<void(const std::string&)> checkpoint =
+      [name, snapshot](const std::string& filename)
+      {
+        data::Save(filename, name, *snapshot, true);
+      };
+
+  std::lock_guard<std::mutex> guard(lock);
+  if (waiting)
+  {
+    // Another thread saved a checkpoint while the copy was made.
+    ++skipped;
+  }
+  waiting = std::move(checkpoint);
+  condition.notify_all();
+}
+
+inline void AsyncCheckpointer::Wait()
+{
+  std::unique_lock<std::mutex> guard(lock);
+  condition.wait(guard, [this]() { return !waiting && !writing; });
+  RethrowError();
+}
+
+inline std::vector<std::string> AsyncCheckpointer::Checkpoints()
+{
+  std::lock_guard<std::mutex> guard(lock);
+  return std::vector<std::string>(checkpoints.begin(), checkpoints.end());
+}
+
+inline size_t AsyncCheckpointer::NumSkipped()
+{
+  std::lock_guard<std::mutex> guard(lock);
+  return skipped;
+}
+
+inline std::string AsyncCheckpointer::Filename(const size_t checkpoint,
+                                               const bool partial) const
+{
+  std::ostringstream oss;
+  oss << base << "-" << checkpoint << (partial ? ".partial" : "")
+      << extension;
+  return oss.str();
+}
+
+inline void AsyncCheckpointer::RethrowError()
+{
+  if (error)
+  {
+    std::exception_ptr writeError = error;
+    error = nullptr;
+    std::rethrow_exception(writeError);
+  }
+}
+
+inline void AsyncCheckpointer::Work()
+{
+  std::unique_lock<std::mutex> guard(lock);
+  while (true)
+  {
+    condition.wait(guard, [this]() { return stop || waiting; });
+
+    // The waiting checkpoint is still written when the thread is stopped.
+    if (!waiting)
+      return;
+
+    std::function<void(const std::string&)> checkpoint = std::move(waiting);
+    waiting = nullptr;
+    writing = true;
+    const std::string filename = Filename(++last, false);
+    const std::string partialFilename = Filename(last, true);
+    guard.unlock();
+
+    bool written = false;
+    try
+    {
+      checkpoint(partialFilename);
+      if (std::rename(partialFilename.c_str(), filename.c_str()) != 0)
+      {
+        throw std::runtime_error("AsyncCheckpointer: cannot rename '" +
+            partialFilename + "' to '" + filename + "'!");
+      }
+      written = true;
+    }
+    catch (...)
+    {
+      std::remove(partialFilename.c_str());
+      guard.lock();
+      error = std::current_exception();
+      guard.unlock();
+    }
+
+    // Release the snapshot before the next one is taken.
+    checkpoint = nullptr;
+
+    guard.lock();
+    if (written)
+    {
+      checkpoints.push_back(filename);
+      while (checkpoints.size() > keep)
+      {
+        std::remove(checkpoints.front().c_str());
+        checkpoints.pop_front();
+      }
+    }
+    writing = false;
+    condition.notify_all();
+  }
+}
+
+} // namespace data
+} // namespace mlpack
+
+#endif
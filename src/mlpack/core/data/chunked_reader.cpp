@@ -0,0 +1,268 @@
+/**
+ * @file core/data/chunked_reader.cpp
+ *
+ * Implementation of ChunkedReader.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "chunked_reader.hpp"
+#include "extension.hpp"
+#include "load_csv.hpp"
+
+#include <fstream>
+
+namespace mlpack {
+namespace data {
+
+//! The header of Armadillo binary files holding double elements.
+static const std::string armaBinaryHeader = "ARMA_MAT_BIN_FN008";
+
+ChunkedReader::ChunkedReader(const std::string& filename,
+                             const size_t chunkSize) :
+    filename(filename),
+    format(TEXT_FORMAT),
+    chunkSize(chunkSize),
+    numChunks(0),
+    numColumns(0),
+    nextChunk(0),
+    dataOffset(0)
+{
+  if (chunkSize == 0)
+    throw std::invalid_argument("ChunkedReader: chunkSize must be positive!");
+
+  std::ifstream stream(filename.c_str(), std::ios::binary);
+  if (!stream.is_open())
+    throw std::runtime_error("Cannot open file '" + filename + "'.");
+
+  // Detect the format from the contents of the file first, and then from its
+  // extension.
+  mapped::Header header;
+  std::string firstLine;
+  if (mapped::ReadHeader(stream, header))
+  {
+    if (header.elemSize != sizeof(double))
+    {
+      throw std::runtime_error("ChunkedReader: file '" + filename + "' does "
+          "not hold double elements.");
+    }
+
+    format = MAPPED_FORMAT;
+    mapped = std::make_shared<MappedMatrix<double>>(filename);
+    numColumns = mapped->Matrix().n_cols;
+    if (mapped->HasMetadata())
+    {
+      arma::Row<size_t> labels;
+      mapped->LoadMetadata(info, labels);
+    }
+    else
+    {
+      info.SetDimensionality(mapped->Matrix().n_rows);
+    }
+  }
+  else if (std::getline(stream, firstLine) &&
+      firstLine.compare(0, 12, armaBinaryHeader, 0, 12) == 0)
+  {
+    if (firstLine != armaBinaryHeader)
+    {
+      throw std::runtime_error("ChunkedReader: file '" + filename + "' does "
+          "not hold double elements.");
+    }
+
+    format = ARMA_BINARY_FORMAT;
+    IndexArmaBinary();
+  }
+  else
+  {
+    const std::string extension = Extension(filename);
+    if (extension != "csv" && extension != "tsv" && extension != "txt")
+    {
+      throw std::invalid_argument("ChunkedReader: unsupported format of file '"
+          + filename + "'.");
+    }
+
+    format = TEXT_FORMAT;
+    IndexText();
+  }
+
+  numChunks = (numColumns + chunkSize - 1) / chunkSize;
+}
+
+void ChunkedReader::IndexText()
+{
+  std::ifstream stream(filename.c_str(), std::ios::binary);
+  csv = std::make_shared<LoadCSV>(filename);
+
+  // Take a pass through the file to find the first line of each chunk, the
+  // dimensionality, and (if the policy needs it) which dimensions are
+  // categorical.
+  std::string line;
+  std::streamoff offset = 0;
+  size_t lineIndex = 0;
+  while (std::getline(stream, line))
+  {
+    if (lineIndex % chunkSize == 0)
+      chunkOffsets.push_back(offset);
+    offset += line.size() + 1;
+
+    if (lineIndex == 0)
+    {
+      size_t dimensionality = 0;
+      std::string firstLine(line);
+      csv->Tokenize(firstLine, [&dimensionality](std::string&&)
+          { ++dimensionality; });
+      info.SetDimensionality(dimensionality);
+    }
+
+    size_t dim = 0;
+    const bool success = csv->Tokenize(line, [&](std::string&& token)
+    {
+      if (IncrementPolicy::NeedsFirstPass && dim < Dimensionality())
+        info.MapFirstPass<double>(std::move(token), dim);
+      ++dim;
+    });
+
+    if (!success || dim != Dimensionality())
+    {
+      std::ostringstream oss;
+      oss << "ChunkedReader: wrong number of dimensions (" << dim << ") on "
+          << "line " << lineIndex << " of '" << filename << "'; should be "
+          << Dimensionality() << " dimensions.";
+      throw std::runtime_error(oss.str());
+    }
+
+    ++lineIndex;
+  }
+  numColumns = lineIndex;
+
+  // If any dimension is categorical, map its values in the order they appear
+  // in the file, so that every chunk uses the same mappings.
+  bool categorical = false;
+  for (size_t d = 0; d < Dimensionality(); ++d)
+    categorical |= (info.Type(d) == Datatype::categorical);
+
+  if (categorical)
+  {
+    stream.clear();
+    stream.seekg(0, std::ios::beg);
+    while (std::getline(stream, line))
+    {
+      size_t dim = 0;
+      csv->Tokenize(line, [&](std::string&& token)
+      {
+        if (info.Type(dim) == Datatype::categorical)
+          info.MapString<double>(std::move(token), dim);
+        ++dim;
+      });
+    }
+  }
+}
+
+void ChunkedReader::IndexArmaBinary()
+{
+  std::ifstream stream(filename.c_str(), std::ios::binary);
+  std::string header;
+  size_t rows, cols;
+  stream >> header >> rows >> cols;
+  // A single newline follows the dimensions.
+  stream.get();
+  if (!stream.good())
+  {
+    throw std::runtime_error("ChunkedReader: cannot read the header of '" +
+        filename + "'.");
+  }
+
+  dataOffset = stream.tellg();
+  stream.seekg(0, std::ios::end);
+  const std::streamoff fileSize = stream.tellg();
+  if (fileSize - dataOffset < std::streamoff(rows * cols * sizeof(double)))
+  {
+    throw std::runtime_error("ChunkedReader: file '" + filename + "' is too "
+        "small for its matrix.");
+  }
+
+  // data::Save() stores one point per row.
+  numColumns = rows;
+  info.SetDimensionality(cols);
+}
+
+bool ChunkedReader::Next(arma::mat& chunk)
+{
+  if (nextChunk == numChunks)
+    return false;
+
+  arma::mat responses;
+  Load(nextChunk++, chunk, responses);
+  return true;
+}
+
+void ChunkedReader::Load(const size_t chunk,
+                         arma::mat& predictors,
+                         arma::mat& responses)
+{
+  if (chunk >= numChunks)
+    throw std::runtime_error("ChunkedReader::Load(): invalid chunk index!");
+
+  const size_t first = chunk * chunkSize;
+  const size_t count = std::min(chunkSize, numColumns - first);
+  responses.clear();
+
+  if (format == MAPPED_FORMAT)
+  {
+    predictors = mapped->Matrix().cols(first, first + count - 1);
+    return;
+  }
+
+  std::ifstream stream(filename.c_str(), std::ios::binary);
+  if (!stream.is_open())
+    throw std::runtime_error("Cannot open file '" + filename + "'.");
+
+  predictors.set_size(Dimensionality(), count);
+  if (format == ARMA_BINARY_FORMAT)
+  {
+    // Each dimension is stored contiguously, so read the part of each one that
+    // belongs to the chunk.
+    std::vector<double> buffer(count);
+    for (size_t d = 0; d < Dimensionality(); ++d)
+    {
+      stream.seekg(dataOffset + std::streamoff((d * numColumns + first) *
+          sizeof(double)));
+      if (!stream.read((char*) buffer.data(), count * sizeof(double)))
+      {
+        throw std::runtime_error("ChunkedReader: cannot read chunk " +
+            std::to_string(chunk) + " of '" + filename + "'.");
+      }
+
+      for (size_t i = 0; i < count; ++i)
+        predictors(d, i) = buffer[i];
+    }
+
+    return;
+  }
+
+  stream.seekg(chunkOffsets[chunk]);
+  std::string line;
+  for (size_t i = 0; i < count; ++i)
+  {
+    if (!std::getline(stream, line))
+    {
+      throw std::runtime_error("ChunkedReader: cannot read chunk " +
+          std::to_string(chunk) + " of '" + filename + "'.");
+    }
+
+    // All the mappings were made by the constructor, so this only looks them
+    // up.
+    size_t dim = 0;
+    csv->Tokenize(line, [&](std::string&& token)
+    {
+      if (dim < Dimensionality())
+        predictors(dim, i) = info.MapString<double>(std::move(token), dim);
+      ++dim;
+    });
+  }
+}
+
+} // namespace data
+} // namespace mlpack
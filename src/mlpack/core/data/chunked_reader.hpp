@@ -0,0 +1,146 @@
+/**
+ * @file core/data/chunked_reader.hpp
+ *
+ * Definition of ChunkedReader, which reads a dataset stored in a file in
+ * batches of points, without loading the whole file.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_CHUNKED_READER_HPP
+#define MLPACK_CORE_DATA_CHUNKED_READER_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "dataset_mapper.hpp"
+#include "mapped_matrix.hpp"
+
+#include <memory>
+
+namespace mlpack {
+namespace data {
+
+// Forward declaration; the CSV rules are only needed by the implementation.
+class LoadCSV;
+
+/**
+ * A ChunkedReader reads the points of a dataset from a file in chunks of (at
+ * most) chunkSize points, one point per column, so that datasets larger than
+ * memory can be used by learners that train incrementally (or one batch at a
+ * time).  Only one chunk is read into memory at once.
+ *
+ * The following formats are supported:
+ *
+ *  - CSV, TSV and whitespace-separated text files (by extension), with one
+ *    point per line.  The constructor takes a pass over the file to find where
+ *    each chunk starts and to build a DatasetInfo for the whole file (and a
+ *    second one, if there are categorical dimensions, to map their values in
+ *    the order they appear), so every chunk uses the same mappings.
+ *  - Armadillo binary files written by data::Save() (one point per row of the
+ *    stored matrix, as data::Save() transposes).
+ *  - Mapped matrix files written by data::SaveMapped(), with double elements;
+ *    the DatasetInfo saved with the matrix is used, if there is one.
+ *
+ * The chunks can be read in order with Next(), or in any order with Load();
+ * since Load() matches the chunk source interface, a ChunkedReader can be
+ * given to a PrefetchLoader to read the next chunks on a background thread.
+ *
+ * @code
+ * data::ChunkedReader reader("large_dataset.csv", 10000);
+ * arma::mat chunk;
+ * while (reader.Next(chunk))
+ * {
+ *   // ... train on the chunk ...
+ * }
+ * @endcode
+ */
+class ChunkedReader
+{
+ public:
+  /**
+   * Open the given file and find its chunks.  A std::runtime_error is thrown
+   * if the file can't be opened or parsed, and a std::invalid_argument if its
+   * format is not supported or chunkSize is 0.
+   *
+   * @param filename Name of the file to read.
+   * @param chunkSize Maximum number of points of each chunk.
+   */
+  ChunkedReader(const std::string& filename, const size_t chunkSize);
+
+  //! Get the number of chunks.
+  size_t NumChunks() const { return numChunks; }
+  //! Get the maximum number of points of each chunk.
+  size_t ChunkSize() const { return chunkSize; }
+  //! Get the total number of points in the file.
+  size_t NumColumns() const { return numColumns; }
+  //! Get the dimensionality of the points.
+  size_t Dimensionality() const { return info.Dimensionality(); }
+
+  //! Get the DatasetInfo shared by all the chunks.
+  const DatasetInfo& Info() const { return info; }
+
+  /**
+   * Read the next chunk.  Returns false and leaves the matrix untouched once
+   * all chunks have been read; call Reset() to start again.
+   *
+   * @param chunk Matrix to read the points of the chunk into.
+   */
+  bool Next(arma::mat& chunk);
+
+  //! Start reading from the first chunk again.
+  void Reset() { nextChunk = 0; }
+
+  /**
+   * Read the given chunk.  A std::runtime_error is thrown if it can't be read.
+   *
+   * @param chunk Index of the chunk.
+   * @param predictors Matrix to read the points of the chunk into.
+   * @param responses Set to an empty matrix.
+   */
+  void Load(const size_t chunk, arma::mat& predictors, arma::mat& responses);
+
+ private:
+  //! The formats that can be read.
+  enum FormatType
+  {
+    TEXT_FORMAT,
+    ARMA_BINARY_FORMAT,
+    MAPPED_FORMAT
+  };
+
+  //! Find the chunks of a text file and build the DatasetInfo.
+  void IndexText();
+
+  //! Read the header of an Armadillo binary file.
+  void IndexArmaBinary();
+
+  //! The name of the file.
+  std::string filename;
+  //! The format of the file.
+  FormatType format;
+  //! The maximum number of points of each chunk.
+  size_t chunkSize;
+  //! The number of chunks.
+  size_t numChunks;
+  //! The total number of points.
+  size_t numColumns;
+  //! The index of the chunk Next() returns.
+  size_t nextChunk;
+  //! The DatasetInfo shared by all the chunks.
+  DatasetInfo info;
+
+  //! For text files: the rules to split lines with.
+  std::shared_ptr<LoadCSV> csv;
+  //! For text files: the position of the first line of each chunk.
+  std::vector<std::streamoff> chunkOffsets;
+  //! For Armadillo binary files: the position of the elements.
+  std::streamoff dataOffset;
+  //! For mapped matrix files: the mapped matrix.
+  std::shared_ptr<MappedMatrix<double>> mapped;
+};
+
+} // namespace data
+} // namespace mlpack
+
+#endif
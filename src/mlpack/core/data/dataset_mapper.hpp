@@ -16,9 +16,11 @@
 #define MLPACK_CORE_DATA_DATASET_INFO_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <type_traits>
 #include <unordered_map>
 
 #include "map_policies/increment_policy.hpp"
+#include "string_pool.hpp"
 
 namespace mlpack {
 namespace data {
@@ -34,6 +36,11 @@ namespace data {
  * can be specified with the InputType template parameter.  By default, the
  * InputType parameter is std::string.
  *
+ * The one-to-one mappings of IncrementPolicy from std::string (that is, those
+ * of DatasetInfo) are stored compactly in a StringPool for each dimension, so
+ * that dimensions with millions of categories fit in memory; UnmapString()
+ * then returns a copy of the string instead of a reference.
+ *
  * @tparam PolicyType Mapping policy used to specify MapString().
  * @tparam InputType Type of input to be mapped.
  */
@@ -48,6 +55,14 @@ class DatasetMapper
    */
   explicit DatasetMapper(const size_t dimensionality = 0);
 
+  //! Whether the mappings of each dimension are stored in a StringPool.
+  static const bool Pooled = std::is_same<PolicyType, IncrementPolicy>::value &&
+      std::is_same<InputType, std::string>::value;
+
+  //! The type returned by UnmapString().
+  using UnmappedType = typename std::conditional<Pooled, InputType,
+      const InputType&>::type;
+
   /**
    * Create the DatasetMapper object with the given policy and dimensionality.
    * Note that the dimensionality cannot be changed later; you will have to
@@ -106,9 +121,9 @@ class DatasetMapper
    * @param unmappingIndex Index of non-unique unmapping (optional).
    */
   template<typename T>
-  const InputType& UnmapString(const T value,
-                               const size_t dimension,
-                               const size_t unmappingIndex = 0) const;
+  UnmappedType UnmapString(const T value,
+                           const size_t dimension,
+                           const size_t unmappingIndex = 0) const;
 
   /**
    * Get the number of possible unmappings for a string in a given dimension.
@@ -151,10 +166,10 @@ class DatasetMapper
    * Serialize the dataset information.
    */
   template<typename Archive>
-  void serialize(Archive& ar, const unsigned int /* version */)
+  void serialize(Archive& ar, const unsigned int version)
   {
     ar & BOOST_SERIALIZATION_NVP(types);
-    ar & BOOST_SERIALIZATION_NVP(maps);
+    SerializeMaps(ar, version);
   }
 
   //! Return the policy of the mapper.
@@ -180,9 +195,13 @@ class DatasetMapper
 
   // Mappings from strings to integers.
   // Map entries will only exist for dimensions that are categorical.
-  // MapType = map<dimension, pair<bimap<string, MappedType>, numMappings>>
-  using MapType = std::unordered_map<size_t, std::pair<ForwardMapType,
+  // MapType = map<dimension, pair<bimap<string, MappedType>, numMappings>>,
+  // or map<dimension, StringPool> if the mappings are pooled.
+  using GenericMapType = std::unordered_map<size_t, std::pair<ForwardMapType,
       ReverseMapType>>;
+  using PooledMapType = std::unordered_map<size_t, StringPool>;
+  using MapType = typename std::conditional<Pooled, PooledMapType,
+      GenericMapType>::type;
 
   //! maps object stores string and numerical pairs.
   MapType maps;
@@ -190,6 +209,84 @@ class DatasetMapper
   //! policy object tells dataset mapper how the categorical values should be
   //  mapped to the maps object. It is used in MapString() and MapTokens().
   PolicyType policy;
+
+  // The implementations of the public methods for the generic and the pooled
+  // mappings.
+  template<typename T, bool P = Pooled>
+  T MapStringImpl(const InputType& input,
+                  const size_t dimension,
+                  const typename std::enable_if<!P>::type* = 0);
+
+  template<typename T, bool P = Pooled>
+  T MapStringImpl(const InputType& input,
+                  const size_t dimension,
+                  const typename std::enable_if<P>::type* = 0);
+
+  template<typename T, bool P = Pooled>
+  UnmappedType UnmapStringImpl(const T value,
+                               const size_t dimension,
+                               const size_t unmappingIndex,
+                               const typename std::enable_if<!P>::type* = 0)
+      const;
+
+  template<typename T, bool P = Pooled>
+  UnmappedType UnmapStringImpl(const T value,
+                               const size_t dimension,
+                               const size_t unmappingIndex,
+                               const typename std::enable_if<P>::type* = 0)
+      const;
+
+  template<typename T, bool P = Pooled>
+  size_t NumUnmappingsImpl(const T value,
+                           const size_t dimension,
+                           const typename std::enable_if<!P>::type* = 0)
+      const;
+
+  template<typename T, bool P = Pooled>
+  size_t NumUnmappingsImpl(const T value,
+                           const size_t dimension,
+                           const typename std::enable_if<P>::type* = 0)
+      const;
+
+  template<bool P = Pooled>
+  typename PolicyType::MappedType UnmapValueImpl(
+      const InputType& input,
+      const size_t dimension,
+      const typename std::enable_if<!P>::type* = 0);
+
+  template<bool P = Pooled>
+  typename PolicyType::MappedType UnmapValueImpl(
+      const InputType& input,
+      const size_t dimension,
+      const typename std::enable_if<P>::type* = 0);
+
+  template<bool P = Pooled>
+  size_t NumMappingsImpl(const size_t dimension,
+                         const typename std::enable_if<!P>::type* = 0) const;
+
+  template<bool P = Pooled>
+  size_t NumMappingsImpl(const size_t dimension,
+                         const typename std::enable_if<P>::type* = 0) const;
+
+  template<typename Archive, bool P = Pooled>
+  void SerializeMaps(Archive& ar,
+                     const unsigned int version,
+                     const typename std::enable_if<!P>::type* = 0);
+
+  //! Version 0 stored the pooled mappings in hash maps; they are converted.
+  template<typename Archive, bool P = Pooled>
+  void SerializeMaps(Archive& ar,
+                     const unsigned int version,
+                     const typename std::enable_if<P>::type* = 0);
+
+  /**
+   * Get the index in the given pool of the string mapped to the given value.
+   * Returns false if no string is mapped to it.
+   */
+  template<typename T>
+  static bool PooledIndex(const T value,
+                          const StringPool& pool,
+                          size_t& index);
 };
 
 // Use typedef to provide backward compatibility
@@ -198,6 +295,9 @@ using DatasetInfo = DatasetMapper<data::IncrementPolicy>;
 } // namespace data
 } // namespace mlpack
 
+//! Version 1 stores the mappings of DatasetInfo in string pools.
+BOOST_TEMPLATE_CLASS_VERSION(template<>, mlpack::data::DatasetInfo, 1);
+
 #include "dataset_mapper_impl.hpp"
 
 #endif
@@ -85,10 +85,30 @@ template<typename T>
 inline T DatasetMapper<PolicyType, InputType>::MapString(
     const InputType& input,
     const size_t dimension)
+{
+  return MapStringImpl<T>(input, dimension);
+}
+
+template<typename PolicyType, typename InputType>
+template<typename T, bool P>
+inline T DatasetMapper<PolicyType, InputType>::MapStringImpl(
+    const InputType& input,
+    const size_t dimension,
+    const typename std::enable_if<!P>::type* /* junk */)
 {
   return policy.template MapString<MapType, T>(input, dimension, maps, types);
 }
 
+template<typename PolicyType, typename InputType>
+template<typename T, bool P>
+inline T DatasetMapper<PolicyType, InputType>::MapStringImpl(
+    const InputType& input,
+    const size_t dimension,
+    const typename std::enable_if<P>::type* /* junk */)
+{
+  return policy.template MapString<T>(input, dimension, maps, types);
+}
+
 /**
  * A safe version of isnan() that only gets called when the type has a NaN at
  * all.  This is a workaround for Visual Studio, which doesn't seem to support
@@ -122,10 +142,23 @@ inline bool isnanSafe(const long double& t)
 // Return the input corresponding to a value in a given dimension.
 template<typename PolicyType, typename InputType>
 template<typename T>
-inline const InputType& DatasetMapper<PolicyType, InputType>::UnmapString(
+inline typename DatasetMapper<PolicyType, InputType>::UnmappedType
+DatasetMapper<PolicyType, InputType>::UnmapString(
     const T value,
     const size_t dimension,
     const size_t unmappingIndex) const
+{
+  return UnmapStringImpl(value, dimension, unmappingIndex);
+}
+
+template<typename PolicyType, typename InputType>
+template<typename T, bool P>
+inline typename DatasetMapper<PolicyType, InputType>::UnmappedType
+DatasetMapper<PolicyType, InputType>::UnmapStringImpl(
+    const T value,
+    const size_t dimension,
+    const size_t unmappingIndex,
+    const typename std::enable_if<!P>::type* /* junk */) const
 {
   // If the value is std::numeric_limits<T>::quiet_NaN(), we can't use it as a
   // key---so we will use something else...
@@ -155,11 +188,54 @@ inline const InputType& DatasetMapper<PolicyType, InputType>::UnmapString(
   return maps.at(dimension).second.at(usedValue)[unmappingIndex];
 }
 
+template<typename PolicyType, typename InputType>
+template<typename T, bool P>
+inline typename DatasetMapper<PolicyType, InputType>::UnmappedType
+DatasetMapper<PolicyType, InputType>::UnmapStringImpl(
+    const T value,
+    const size_t dimension,
+    const size_t unmappingIndex,
+    const typename std::enable_if<P>::type* /* junk */) const
+{
+  // Throw an exception if the value doesn't exist.
+  const StringPool& pool = maps.at(dimension);
+  size_t index;
+  if (!PooledIndex(value, pool, index))
+  {
+    std::ostringstream oss;
+    oss << "DatasetMapper<PolicyType, InputType>::UnmapString(): value '"
+        << value << "' unknown for dimension " << dimension;
+    throw std::invalid_argument(oss.str());
+  }
+
+  // The pooled mappings are one-to-one.
+  if (unmappingIndex >= 1)
+  {
+    std::ostringstream oss;
+    oss << "DatasetMapper<PolicyType, InputType>::UnmapString(): value '"
+        << value << "' only has 1 unmappings, but unmappingIndex is "
+        << unmappingIndex << "!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  return pool.String(index);
+}
+
 template<typename PolicyType, typename InputType>
 template<typename T>
 inline size_t DatasetMapper<PolicyType, InputType>::NumUnmappings(
     const T value,
     const size_t dimension) const
+{
+  return NumUnmappingsImpl(value, dimension);
+}
+
+template<typename PolicyType, typename InputType>
+template<typename T, bool P>
+inline size_t DatasetMapper<PolicyType, InputType>::NumUnmappingsImpl(
+    const T value,
+    const size_t dimension,
+    const typename std::enable_if<!P>::type* /* junk */) const
 {
   // If the value is std::numeric_limits<T>::quiet_NaN(), we can't use it as a
   // key---so we will use something else...
@@ -172,12 +248,42 @@ inline size_t DatasetMapper<PolicyType, InputType>::NumUnmappings(
   return maps.at(dimension).second.at(value).size();
 }
 
+template<typename PolicyType, typename InputType>
+template<typename T, bool P>
+inline size_t DatasetMapper<PolicyType, InputType>::NumUnmappingsImpl(
+    const T value,
+    const size_t dimension,
+    const typename std::enable_if<P>::type* /* junk */) const
+{
+  size_t index;
+  if (!PooledIndex(value, maps.at(dimension), index))
+  {
+    std::ostringstream oss;
+    oss << "DatasetMapper<PolicyType, InputType>::NumUnmappings(): value '"
+        << value << "' unknown for dimension " << dimension;
+    throw std::out_of_range(oss.str());
+  }
+
+  return 1;
+}
+
 // Return the value corresponding to an input in a given dimension.
 template<typename PolicyType, typename InputType>
 inline typename PolicyType::MappedType
 DatasetMapper<PolicyType, InputType>::UnmapValue(
     const InputType& input,
     const size_t dimension)
+{
+  return UnmapValueImpl(input, dimension);
+}
+
+template<typename PolicyType, typename InputType>
+template<bool P>
+inline typename PolicyType::MappedType
+DatasetMapper<PolicyType, InputType>::UnmapValueImpl(
+    const InputType& input,
+    const size_t dimension,
+    const typename std::enable_if<!P>::type* /* junk */)
 {
   // Throw an exception if the value doesn't exist.
   if (maps[dimension].first.count(input) == 0)
@@ -191,6 +297,27 @@ DatasetMapper<PolicyType, InputType>::UnmapValue(
   return maps[dimension].first.at(input);
 }
 
+template<typename PolicyType, typename InputType>
+template<bool P>
+inline typename PolicyType::MappedType
+DatasetMapper<PolicyType, InputType>::UnmapValueImpl(
+    const InputType& input,
+    const size_t dimension,
+    const typename std::enable_if<P>::type* /* junk */)
+{
+  // Throw an exception if the value doesn't exist.
+  size_t index;
+  if (maps.count(dimension) == 0 || !maps.at(dimension).Find(input, index))
+  {
+    std::ostringstream oss;
+    oss << "DatasetMapper<PolicyType, InputType>::UnmapValue(): input '"
+        << input << "' unknown for dimension " << dimension;
+    throw std::invalid_argument(oss.str());
+  }
+
+  return index;
+}
+
 // Get the type of a particular dimension.
 template<typename PolicyType, typename InputType>
 inline Datatype DatasetMapper<PolicyType, InputType>::Type(
@@ -220,10 +347,82 @@ inline Datatype& DatasetMapper<PolicyType, InputType>::Type(
 template<typename PolicyType, typename InputType>
 inline size_t
 DatasetMapper<PolicyType, InputType>::NumMappings(const size_t dimension) const
+{
+  return NumMappingsImpl(dimension);
+}
+
+template<typename PolicyType, typename InputType>
+template<bool P>
+inline size_t DatasetMapper<PolicyType, InputType>::NumMappingsImpl(
+    const size_t dimension,
+    const typename std::enable_if<!P>::type* /* junk */) const
 {
   return (maps.count(dimension) == 0) ? 0 : maps.at(dimension).first.size();
 }
 
+template<typename PolicyType, typename InputType>
+template<bool P>
+inline size_t DatasetMapper<PolicyType, InputType>::NumMappingsImpl(
+    const size_t dimension,
+    const typename std::enable_if<P>::type* /* junk */) const
+{
+  return (maps.count(dimension) == 0) ? 0 : maps.at(dimension).Size();
+}
+
+template<typename PolicyType, typename InputType>
+template<typename Archive, bool P>
+void DatasetMapper<PolicyType, InputType>::SerializeMaps(
+    Archive& ar,
+    const unsigned int /* version */,
+    const typename std::enable_if<!P>::type* /* junk */)
+{
+  ar & BOOST_SERIALIZATION_NVP(maps);
+}
+
+template<typename PolicyType, typename InputType>
+template<typename Archive, bool P>
+void DatasetMapper<PolicyType, InputType>::SerializeMaps(
+    Archive& ar,
+    const unsigned int version,
+    const typename std::enable_if<P>::type* /* junk */)
+{
+  if (!Archive::is_loading::value || version > 0)
+  {
+    ar & BOOST_SERIALIZATION_NVP(maps);
+    return;
+  }
+
+  // IncrementPolicy mapped the strings of each dimension to 0, 1, 2, ..., so
+  // the pool is filled in the order of the values.
+  GenericMapType oldMaps;
+  ar & boost::serialization::make_nvp("maps", oldMaps);
+  maps.clear();
+  for (typename GenericMapType::const_iterator it = oldMaps.begin();
+       it != oldMaps.end(); ++it)
+  {
+    StringPool& pool = maps[it->first];
+    for (size_t i = 0; i < it->second.second.size(); ++i)
+      pool.Insert(it->second.second.at(i).front());
+  }
+}
+
+template<typename PolicyType, typename InputType>
+template<typename T>
+inline bool DatasetMapper<PolicyType, InputType>::PooledIndex(
+    const T value,
+    const StringPool& pool,
+    size_t& index)
+{
+  // This also rejects NaN.
+  const double position = (double) value;
+  if (!(position >= 0.0) || position >= (double) pool.Size() ||
+      position != std::floor(position))
+    return false;
+
+  index = (size_t) position;
+  return true;
+}
+
 template<typename PolicyType, typename InputType>
 inline size_t DatasetMapper<PolicyType, InputType>::Dimensionality() const
 {
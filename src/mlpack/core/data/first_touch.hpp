@@ -0,0 +1,77 @@
+/**
+ * @file core/data/first_touch.hpp
+ *
+ * Placement of the memory of a matrix on the NUMA nodes of the threads that
+ * will process it, through the first-touch policy of the operating system.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_FIRST_TOUCH_HPP
+#define MLPACK_CORE_DATA_FIRST_TOUCH_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace data {
+
+/**
+ * Set every element of the given matrix to zero in parallel, so that on a NUMA
+ * machine each page of its memory is placed on the node of the thread that
+ * first writes it (the default policy of Linux and Windows).  This only has an
+ * effect on memory that has not been written yet, so it should be called right
+ * after the matrix is allocated (data::Load() does so for numeric text files).
+ *
+ * By default, the columns are split in contiguous ranges, one for each thread,
+ * like the static schedule of the parallel loops over points (for instance in
+ * NaiveKMeans); each range then lives on the node of the thread that processes
+ * it.  With interleave, the pages are instead dealt to the threads in turn, so
+ * that they are spread over all nodes; this suits code whose threads access
+ * all points (such as the bootstrap samples of RandomForest).
+ *
+ * The threads must stay on their nodes for this to help; with OpenMP, this is
+ * done with the OMP_PROC_BIND (e.g. "spread") and OMP_PLACES (e.g. "cores")
+ * environment variables.
+ *
+ * @param matrix Matrix whose memory should be placed.
+ * @param interleave Whether to interleave the pages over the threads, instead
+ *     of giving each thread a contiguous range of columns.
+ */
+template<typename eT>
+void FirstTouch(arma::Mat<eT>& matrix, const bool interleave = false)
+{
+  eT* memory = matrix.memptr();
+  if (interleave)
+  {
+    // The usual page size; a larger page size is still spread over the
+    // threads, in larger units.
+    const size_t pageSize = std::max(size_t(1), size_t(4096 / sizeof(eT)));
+    const size_t pages = (matrix.n_elem + pageSize - 1) / pageSize;
+
+    #pragma omp parallel for schedule(static, 1)
+    for (omp_size_t p = 0; p < (omp_size_t) pages; ++p)
+    {
+      const size_t begin = (size_t) p * pageSize;
+      const size_t end = std::min(begin + pageSize, (size_t) matrix.n_elem);
+      std::fill(memory + begin, memory + end, eT(0));
+    }
+  }
+  else
+  {
+    const size_t columnSize = matrix.n_rows;
+
+    #pragma omp parallel for schedule(static)
+    for (omp_size_t c = 0; c < (omp_size_t) matrix.n_cols; ++c)
+    {
+      std::fill(memory + c * columnSize, memory + (c + 1) * columnSize,
+          eT(0));
+    }
+  }
+}
+
+} // namespace data
+} // namespace mlpack
+
+#endif
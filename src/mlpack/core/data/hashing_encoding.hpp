@@ -0,0 +1,146 @@
+/**
+ * @file core/data/hashing_encoding.hpp
+ *
+ * Definition of the HashingEncoding class, which maps tokens and categorical
+ * values into a sparse matrix of fixed dimensionality with the hashing trick.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_HASHING_ENCODING_HPP
+#define MLPACK_CORE_DATA_HASHING_ENCODING_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/boost_backport/boost_backport_string_view.hpp>
+#include <vector>
+
+namespace mlpack {
+namespace data {
+
+/**
+ * HashingEncoding encodes a set of strings (or of categorical values) with the
+ * hashing trick: each token is hashed to one of Dimensionality() rows of the
+ * output, and the column of each dataset item accumulates the (optionally
+ * signed) counts of its tokens.  Unlike StringEncoding, no dictionary is kept,
+ * so the memory does not depend on the vocabulary, and the data is encoded in
+ * a single pass.  The output is an arma::sp_mat, which can be given directly
+ * to the sparse linear models (e.g. LogisticRegression<arma::sp_mat>).
+ *
+ * With the alternate sign (Weinberger et al., 2009), a second part of the hash
+ * chooses the sign of each token, so that the collisions cancel out on average
+ * in the inner products.
+ *
+ * @code
+ * @inproceedings{weinberger2009feature,
+ *   title={Feature Hashing for Large Scale Multitask Learning},
+ *   author={Weinberger, Kilian and Dasgupta, Anirban and Langford, John and
+ *       Smola, Alex and Attenberg, Josh},
+ *   booktitle={Proceedings of the 26th Annual International Conference on
+ *       Machine Learning},
+ *   pages={1113--1120},
+ *   year={2009}
+ * }
+ * @endcode
+ *
+ * An example on how to use the interface is shown below:
+ *
+ * @code
+ * std::vector<std::string> input; // The documents to encode.
+ * arma::sp_mat output;
+ *
+ * HashingEncoding encoder(1 << 20);
+ * encoder.Encode(input, output, SplitByAnyOf(" .,"));
+ * @endcode
+ */
+class HashingEncoding
+{
+ public:
+  /**
+   * Create the encoder.
+   *
+   * @param dimensionality Number of rows of the output.
+   * @param alternateSign Whether to choose the sign of each token with the
+   *     hash.
+   */
+  HashingEncoding(const size_t dimensionality = 1048576,
+                  const bool alternateSign = true);
+
+  /**
+   * Encode the given text and write the result to the given sparse matrix,
+   * one column per string of the input.
+   *
+   * @tparam TokenizerType Type of the tokenizer.
+   *
+   * @param input Corpus of text to encode.
+   * @param output Output matrix to store the result.
+   * @param tokenizer The tokenizer object.
+   *
+   * The tokenization algorithm has to be an object with two public methods:
+   * 1. operator() which accepts a reference to boost::string_view, extracts
+   * the next token from the given view, removes the prefix containing
+   * the extracted token and returns the token;
+   * 2. IsTokenEmpty() that accepts a token and returns true if the given
+   *    token is empty.
+   */
+  template<typename TokenizerType>
+  void Encode(const std::vector<std::string>& input,
+              arma::sp_mat& output,
+              const TokenizerType& tokenizer) const;
+
+  /**
+   * Encode the given categorical data and write the result to the given sparse
+   * matrix, one column per item of the input.  input[i][j] is the value of the
+   * j-th categorical field of the i-th item; the field index is hashed
+   * together with the value, so that equal values of different fields do not
+   * collide.
+   *
+   * @param input Categorical values to encode.
+   * @param output Output matrix to store the result.
+   */
+  void Encode(const std::vector<std::vector<std::string>>& input,
+              arma::sp_mat& output) const;
+
+  //! Get the number of rows of the output.
+  size_t Dimensionality() const { return dimensionality; }
+  //! Modify the number of rows of the output.
+  size_t& Dimensionality() { return dimensionality; }
+
+  //! Get whether the sign of each token is chosen with the hash.
+  bool AlternateSign() const { return alternateSign; }
+  //! Modify whether the sign of each token is chosen with the hash.
+  bool& AlternateSign() { return alternateSign; }
+
+  /**
+   * Serialize the class to the given archive.
+   */
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */);
+
+ private:
+  //! Add the entry of the given hash for the given column.
+  void AddEntry(const size_t hash,
+                const size_t column,
+                std::vector<arma::uword>& locations,
+                std::vector<double>& values) const;
+
+  //! Build the output from the collected entries.
+  void BuildMatrix(const std::vector<arma::uword>& locations,
+                   const std::vector<double>& values,
+                   const size_t numColumns,
+                   arma::sp_mat& output) const;
+
+  //! The number of rows of the output.
+  size_t dimensionality;
+  //! Whether the sign of each token is chosen with the hash.
+  bool alternateSign;
+};
+
+} // namespace data
+} // namespace mlpack
+
+// Include implementation.
+#include "hashing_encoding_impl.hpp"
+
+#endif
@@ -0,0 +1,135 @@
+/**
+ * @file core/data/hashing_encoding_impl.hpp
+ *
+ * Implementation of the HashingEncoding class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_HASHING_ENCODING_IMPL_HPP
+#define MLPACK_CORE_DATA_HASHING_ENCODING_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "hashing_encoding.hpp"
+
+#include <boost/functional/hash.hpp>
+
+namespace mlpack {
+namespace data {
+
+inline HashingEncoding::HashingEncoding(const size_t dimensionality,
+                                        const bool alternateSign) :
+    dimensionality(dimensionality),
+    alternateSign(alternateSign)
+{
+  if (dimensionality == 0)
+  {
+    throw std::invalid_argument("HashingEncoding::HashingEncoding(): the "
+        "dimensionality must be positive!");
+  }
+}
+
+template<typename TokenizerType>
+void HashingEncoding::Encode(const std::vector<std::string>& input,
+                             arma::sp_mat& output,
+                             const TokenizerType& tokenizer) const
+{
+  std::vector<arma::uword> locations;
+  std::vector<double> values;
+
+  // The tokens are hashed as they are extracted, so only one pass is needed.
+  for (size_t i = 0; i < input.size(); ++i)
+  {
+    boost::string_view strView(input[i]);
+    auto token = tokenizer(strView);
+
+    typedef typename std::remove_reference<decltype(token)>::type TokenType;
+    boost::hash<TokenType> hasher;
+
+    while (!tokenizer.IsTokenEmpty(token))
+    {
+      AddEntry(hasher(token), i, locations, values);
+      token = tokenizer(strView);
+    }
+  }
+
+  BuildMatrix(locations, values, input.size(), output);
+}
+
+inline void HashingEncoding::Encode(
+    const std::vector<std::vector<std::string>>& input,
+    arma::sp_mat& output) const
+{
+  std::vector<arma::uword> locations;
+  std::vector<double> values;
+
+  for (size_t i = 0; i < input.size(); ++i)
+  {
+    for (size_t j = 0; j < input[i].size(); ++j)
+    {
+      // Hash the field index with the value, so that the same value in two
+      // fields gives two different features.
+      size_t hash = boost::hash_range(input[i][j].begin(), input[i][j].end());
+      boost::hash_combine(hash, j);
+      AddEntry(hash, i, locations, values);
+    }
+  }
+
+  BuildMatrix(locations, values, input.size(), output);
+}
+
+template<typename Archive>
+void HashingEncoding::serialize(Archive& ar, const unsigned int /* version */)
+{
+  ar & BOOST_SERIALIZATION_NVP(dimensionality);
+  ar & BOOST_SERIALIZATION_NVP(alternateSign);
+}
+
+inline void HashingEncoding::AddEntry(const size_t hash,
+                                      const size_t column,
+                                      std::vector<arma::uword>& locations,
+                                      std::vector<double>& values) const
+{
+  // The hash of small integers (like the tokens of CharExtract) is the
+  // identity, so the bits are mixed before use (the MurmurHash3 finalizer).
+  uint64_t mixed = (uint64_t) hash;
+  mixed ^= mixed >> 33;
+  mixed *= 0xff51afd7ed558ccdULL;
+  mixed ^= mixed >> 33;
+  mixed *= 0xc4ceb9fe1a85ec53ULL;
+  mixed ^= mixed >> 33;
+
+  // The low bits give the row, and the highest bit gives the sign.
+  locations.push_back(mixed % dimensionality);
+  locations.push_back(column);
+  values.push_back((alternateSign && (mixed >> 63)) ? -1.0 : 1.0);
+}
+
+inline void HashingEncoding::BuildMatrix(
+    const std::vector<arma::uword>& locations,
+    const std::vector<double>& values,
+    const size_t numColumns,
+    arma::sp_mat& output) const
+{
+  if (values.empty())
+  {
+    output.zeros(dimensionality, numColumns);
+    return;
+  }
+
+  // The batch constructor sums the entries of tokens that appear more than
+  // once in an item (or that collide).
+  const arma::umat locationMat(const_cast<arma::uword*>(locations.data()), 2,
+      values.size(), false, true);
+  const arma::vec valueVec(const_cast<double*>(values.data()), values.size(),
+      false, true);
+  output = arma::sp_mat(true, locationMat, valueVec, dimensionality,
+      numColumns);
+}
+
+} // namespace data
+} // namespace mlpack
+
+#endif
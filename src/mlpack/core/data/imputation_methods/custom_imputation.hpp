@@ -71,6 +71,42 @@ class CustomImputation
     }
   }
 
+  /**
+   * Impute all the given dimensions at once, in one parallel pass over the
+   * points (or over the dimensions, for row-major data).  Each dimension must
+   * appear only once.
+   *
+   * @param input Matrix that contains the mapped values.
+   * @param mappedValues Value that the user wants to get rid of, for each of
+   *     the given dimensions.
+   * @param dimensions Indices of the dimensions to impute.
+   * @param columnMajor State of whether the input matrix is columnMajor or not.
+   */
+  void Impute(arma::Mat<T>& input,
+              const std::vector<T>& mappedValues,
+              const std::vector<size_t>& dimensions,
+              const bool columnMajor = true)
+  {
+    if (!columnMajor)
+    {
+      #pragma omp parallel for schedule(dynamic)
+      for (omp_size_t k = 0; k < (omp_size_t) dimensions.size(); ++k)
+        Impute(input, mappedValues[k], dimensions[k], columnMajor);
+      return;
+    }
+
+    #pragma omp parallel for schedule(static)
+    for (omp_size_t i = 0; i < (omp_size_t) input.n_cols; ++i)
+    {
+      for (size_t k = 0; k < dimensions.size(); ++k)
+      {
+        T& value = input(dimensions[k], i);
+        if (value == mappedValues[k] || std::isnan(value))
+          value = customValue;
+      }
+    }
+  }
+
  private:
   //! A user-defined value that the user wants to replace missing values with.
   T customValue;
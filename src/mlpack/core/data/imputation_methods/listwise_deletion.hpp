@@ -66,6 +66,53 @@ class ListwiseDeletion
       input = input.rows(arma::uvec(colsToKeep));
     }
   }
+
+  /**
+   * Impute all the given dimensions at once: every case that has a missing
+   * value in any of the dimensions is removed.  The cases are checked in
+   * parallel, and the matrix is only shrunk once.  Each dimension must appear
+   * only once.
+   *
+   * @param input Matrix that contains the mapped values.
+   * @param mappedValues Value that the user wants to get rid of, for each of
+   *     the given dimensions.
+   * @param dimensions Indices of the dimensions to impute.
+   * @param columnMajor State of whether the input matrix is columnMajor or not.
+   */
+  void Impute(arma::Mat<T>& input,
+              const std::vector<T>& mappedValues,
+              const std::vector<size_t>& dimensions,
+              const bool columnMajor = true)
+  {
+    const size_t numCases = columnMajor ? input.n_cols : input.n_rows;
+    std::vector<char> keep(numCases, 1);
+    #pragma omp parallel for schedule(static)
+    for (omp_size_t i = 0; i < (omp_size_t) numCases; ++i)
+    {
+      for (size_t k = 0; k < dimensions.size(); ++k)
+      {
+        const T value = columnMajor ? input(dimensions[k], i) :
+            input(i, dimensions[k]);
+        if (value == mappedValues[k] || std::isnan(value))
+        {
+          keep[i] = 0;
+          break;
+        }
+      }
+    }
+
+    std::vector<arma::uword> casesToKeep;
+    for (size_t i = 0; i < numCases; ++i)
+    {
+      if (keep[i])
+        casesToKeep.push_back(i);
+    }
+
+    if (columnMajor)
+      input = input.cols(arma::uvec(casesToKeep));
+    else
+      input = input.rows(arma::uvec(casesToKeep));
+  }
 }; // class ListwiseDeletion
 
 } // namespace data
@@ -96,6 +96,83 @@ class MeanImputation
       input(target.first, target.second) = mean;
     }
   }
+
+  /**
+   * Impute all the given dimensions at once.  For column-major data, this
+   * takes one parallel pass over the points to compute the means and another
+   * to replace the missing values; otherwise, the dimensions are processed in
+   * parallel.  Each dimension must appear only once.
+   *
+   * @param input Matrix that contains the mapped values.
+   * @param mappedValues Value that the user wants to get rid of, for each of
+   *     the given dimensions.
+   * @param dimensions Indices of the dimensions to impute.
+   * @param columnMajor State of whether the input matrix is columnMajor or not.
+   */
+  void Impute(arma::Mat<T>& input,
+              const std::vector<T>& mappedValues,
+              const std::vector<size_t>& dimensions,
+              const bool columnMajor = true)
+  {
+    if (!columnMajor)
+    {
+      // Each dimension is contiguous, so impute them separately.
+      #pragma omp parallel for schedule(dynamic)
+      for (omp_size_t k = 0; k < (omp_size_t) dimensions.size(); ++k)
+        Impute(input, mappedValues[k], dimensions[k], columnMajor);
+      return;
+    }
+
+    const size_t numDims = dimensions.size();
+    size_t numBlocks = 1;
+    #ifdef HAS_OPENMP
+    numBlocks = std::max(size_t(1), std::min(size_t(input.n_cols),
+        size_t(omp_get_max_threads())));
+    #endif
+
+    // Sum the valid elements of each dimension in each block of points.
+    arma::mat sums(numDims, numBlocks, arma::fill::zeros);
+    arma::Mat<size_t> counts(numDims, numBlocks, arma::fill::zeros);
+    #pragma omp parallel for schedule(static, 1)
+    for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+    {
+      const size_t begin = b * input.n_cols / numBlocks;
+      const size_t end = (b + 1) * input.n_cols / numBlocks;
+      for (size_t i = begin; i < end; ++i)
+      {
+        for (size_t k = 0; k < numDims; ++k)
+        {
+          const T value = input(dimensions[k], i);
+          if (!(value == mappedValues[k] || std::isnan(value)))
+          {
+            sums(k, b) += value;
+            ++counts(k, b);
+          }
+        }
+      }
+    }
+
+    const arma::vec sum = arma::sum(sums, 1);
+    const arma::Col<size_t> elems = arma::sum(counts, 1);
+    for (size_t k = 0; k < numDims; ++k)
+    {
+      if (elems[k] == 0)
+        Log::Fatal << "it is impossible to calculate mean; no valid elements "
+            << "in the dimension" << std::endl;
+    }
+    const arma::vec means = sum / arma::conv_to<arma::vec>::from(elems);
+
+    #pragma omp parallel for schedule(static)
+    for (omp_size_t i = 0; i < (omp_size_t) input.n_cols; ++i)
+    {
+      for (size_t k = 0; k < numDims; ++k)
+      {
+        T& value = input(dimensions[k], i);
+        if (value == mappedValues[k] || std::isnan(value))
+          value = means[k];
+      }
+    }
+  }
 }; // class MeanImputation
 
 } // namespace data
@@ -85,6 +85,26 @@ class MedianImputation
        input(target.first, target.second) = median;
     }
   }
+
+  /**
+   * Impute all the given dimensions at once, with the dimensions processed in
+   * parallel.  Each dimension must appear only once.
+   *
+   * @param input Matrix that contains the mapped values.
+   * @param mappedValues Value that the user wants to get rid of, for each of
+   *     the given dimensions.
+   * @param dimensions Indices of the dimensions to impute.
+   * @param columnMajor State of whether the input matrix is columnMajor or not.
+   */
+  void Impute(arma::Mat<T>& input,
+              const std::vector<T>& mappedValues,
+              const std::vector<size_t>& dimensions,
+              const bool columnMajor = true)
+  {
+    #pragma omp parallel for schedule(dynamic)
+    for (omp_size_t k = 0; k < (omp_size_t) dimensions.size(); ++k)
+      Impute(input, mappedValues[k], dimensions[k], columnMajor);
+  }
 }; // class MedianImputation
 
 } // namespace data
@@ -344,8 +344,13 @@ extern template bool Load<double, IncrementPolicy>(
  *  - xml, denoted by .xml
  *  - binary, denoted by .bin
  *
+ * and also portable binary (see PortableBinaryOArchive), denoted by .pbin,
+ * which is much faster than text and xml for large models and, unlike binary,
+ * can be read on any platform.
+ *
  * The format parameter can take any of the values in the 'format' enum:
- * 'format::autodetect', 'format::text', 'format::xml', and 'format::binary'.
+ * 'format::autodetect', 'format::text', 'format::xml', 'format::binary', and
+ * 'format::portable_binary'.
  * The autodetect functionality operates on the file extension (so, "file.txt"
  * would be autodetected as text).
  *
@@ -384,19 +389,31 @@ bool Load(const std::string& filename,
           const bool fatal = false);
 
 /**
- * Load the image file into the given matrix.
+ * Load the image files into the given matrix, one image per column.  The
+ * images are decoded in parallel (with OpenMP), directly into the columns of
+ * the matrix.  The size of the first image gives the size of all images, unless
+ * resizeWidth and resizeHeight are given, in which case every image is resized
+ * (with bilinear interpolation) to that size while it is loaded.  Afterwards,
+ * info holds the size of the images in the matrix.
  *
  * @param files A vector consisting of filenames.
  * @param matrix Matrix to save the image from.
  * @param info An object of ImageInfo class.
  * @param fatal If an error should be reported as fatal (default false).
+ * @param resizeWidth Width to resize the images to (0 to keep the size).
+ * @param resizeHeight Height to resize the images to (0 to keep the size).
+ * @param normalize If true, pixel values are scaled from [0, 255] to [0, 1];
+ *     this is only useful for matrices with floating-point elements.
  * @return Boolean value indicating success or failure of load.
  */
 template<typename eT>
 bool Load(const std::vector<std::string>& files,
           arma::Mat<eT>& matrix,
           ImageInfo& info,
-          const bool fatal = false);
+          const bool fatal = false,
+          const size_t resizeWidth = 0,
+          const size_t resizeHeight = 0,
+          const bool normalize = false);
 
 // Implementation found in load_image.cpp.
 bool LoadImage(const std::string& filename,
@@ -404,6 +421,17 @@ bool LoadImage(const std::string& filename,
                ImageInfo& info,
                const bool fatal = false);
 
+/**
+ * Decode the image file into the given matrix, like LoadImage(), but without
+ * printing anything; if the image can't be decoded, false is returned and the
+ * reason is stored in error.  This can be called from several threads at once.
+ * Implementation found in load_image.cpp.
+ */
+bool DecodeImage(const std::string& filename,
+                 arma::Mat<unsigned char>& matrix,
+                 ImageInfo& info,
+                 std::string& error);
+
 } // namespace data
 } // namespace mlpack
 
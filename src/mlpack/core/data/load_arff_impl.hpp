@@ -18,9 +18,200 @@
 #include <boost/algorithm/string/trim.hpp>
 #include "is_naninf.hpp"
 
+#include <cstdlib>
+#include <unordered_map>
+
 namespace mlpack {
 namespace data {
 
+namespace arff {
+
+/**
+ * Split a line of the @data section at commas into tokens[0, ..., numTokens),
+ * like boost::escaped_list_separator with '\\' as the escape character and '"'
+ * as the quote character.  The strings of tokens are reused, so that no memory
+ * is allocated once they are long enough.
+ */
+inline void Tokenize(const std::string& line,
+                     std::vector<std::string>& tokens,
+                     size_t& numTokens)
+{
+  numTokens = 0;
+  auto nextToken = [&]() -> std::string&
+  {
+    if (numTokens == tokens.size())
+      tokens.emplace_back();
+    std::string& token = tokens[numTokens++];
+    token.clear();
+    return token;
+  };
+
+  std::string* token = &nextToken();
+  bool quoted = false;
+  for (size_t i = 0; i < line.size(); ++i)
+  {
+    const char c = line[i];
+    if (c == '\\')
+    {
+      if (i + 1 == line.size())
+        throw std::runtime_error("cannot end with escape");
+
+      const char escaped = line[++i];
+      if (escaped == 'n')
+        token->push_back('\n');
+      else if (escaped == '\\' || escaped == ',' || escaped == '"')
+        token->push_back(escaped);
+      else
+        throw std::runtime_error("unknown escape sequence");
+    }
+    else if (c == '"')
+    {
+      quoted = !quoted;
+    }
+    else if (c == ',' && !quoted)
+    {
+      token = &nextToken();
+    }
+    else
+    {
+      token->push_back(c);
+    }
+  }
+}
+
+//! Parse a numeric token of a floating-point type; returns false on failure.
+template<typename eT>
+bool ParseNumeric(const std::string& token,
+                  eT& val,
+                  const typename std::enable_if<
+                      std::is_floating_point<eT>::value>::type* = 0)
+{
+  // std::strtod() also handles NaN and inf.
+  const char* begin = token.c_str();
+  char* end;
+  val = eT(std::strtod(begin, &end));
+  return (end != begin);
+}
+
+//! Parse a numeric token of any other type; returns false on failure.
+template<typename eT>
+bool ParseNumeric(const std::string& token,
+                  eT& val,
+                  const typename std::enable_if<
+                      !std::is_floating_point<eT>::value>::type* = 0)
+{
+  std::stringstream stream(token);
+  val = eT(0);
+  stream >> val;
+
+  return !stream.fail() || IsNaNInf(val, token);
+}
+
+//! Return the error for a category that is not in the given categories.
+inline std::string UnknownCategoryError(
+    const size_t line,
+    const size_t col,
+    const std::string& token,
+    const std::vector<std::string>& categories)
+{
+  std::stringstream error;
+  error << "Parse error at line " << line << " token " << col << ": category "
+      << "\"" << token << "\" not in the set of known categories for this "
+      << "dimension (";
+  for (size_t i = 0; i < categories.size() - 1; ++i)
+    error << "\"" << categories[i] << "\", ";
+  error << "\"" << categories.back() << "\").";
+  return error.str();
+}
+
+/**
+ * Tokenize a line of the @data section, and store its numeric values and its
+ * known categories in the given row of the matrix.  Tokens of deferred
+ * dimensions are left in tokens, to be mapped afterwards.  This only reads
+ * the DatasetMapper, so it can be called by several threads at once.
+ */
+template<typename eT, typename PolicyType>
+void ParseLine(std::string& line,
+               std::vector<std::string>& tokens,
+               size_t& numTokens,
+               const size_t row,
+               const size_t lineNumber,
+               arma::Mat<eT>& matrix,
+               const DatasetMapper<PolicyType>& info,
+               const std::vector<std::unordered_map<std::string, eT>>&
+                   categoryValues,
+               const std::vector<bool>& deferred,
+               const std::map<size_t, std::vector<std::string>>&
+                   categoryStrings)
+{
+  boost::trim(line);
+
+  // If the first character is {, it is sparse data, and we can just say this
+  // is not handled for now...
+  if (line[0] == '{')
+    throw std::runtime_error("cannot yet parse sparse ARFF data");
+
+  // Each line of the @data section must be a CSV.  The '?' representing a
+  // missing value is not allowed, so if that occurs we throw an exception.  We
+  // also throw an exception if any piece of data does not match its type
+  // (categorical or numeric).
+  Tokenize(line, tokens, numTokens);
+  if (numTokens > matrix.n_rows)
+  {
+    std::stringstream error;
+    error << "Too many columns in line " << lineNumber << ".";
+    throw std::runtime_error(error.str());
+  }
+
+  for (size_t col = 0; col < numTokens; ++col)
+  {
+    std::string& token = tokens[col];
+    if (deferred[col])
+    {
+      continue;
+    }
+    else if (info.Type(col) == Datatype::categorical)
+    {
+      // Strip spaces before looking up the category.
+      boost::trim(token);
+      typename std::unordered_map<std::string, eT>::const_iterator it =
+          categoryValues[col].find(token);
+      if (it == categoryValues[col].end())
+      {
+        throw std::runtime_error(UnknownCategoryError(lineNumber, col, token,
+            categoryStrings.at(col)));
+      }
+
+      // We load transposed.
+      matrix(col, row) = it->second;
+    }
+    else
+    {
+      eT val;
+      if (!ParseNumeric(token, val))
+      {
+        // If it's '?', we issue a specific error, otherwise we issue a general
+        // error.
+        std::stringstream error;
+        std::string tokenStr = token;
+        boost::trim(tokenStr);
+        if (tokenStr == "?")
+          error << "Missing values ('?') not supported, ";
+        else
+          error << "Parse error ";
+        error << "at line " << lineNumber << " token " << col << ": \""
+            << tokenStr << "\".";
+        throw std::runtime_error(error.str());
+      }
+
+      // We load transposed.
+      matrix(col, row) = val;
+    }
+  }
+}
+
+} // namespace arff
+
 template<typename eT, typename PolicyType>
 void LoadARFF(const std::string& filename,
               arma::Mat<eT>& matrix,
@@ -178,61 +369,94 @@ void LoadARFF(const std::string& filename,
 
   // We need to find out how many lines of data are in the file.
   std::streampos pos = ifs.tellg();
-  size_t row = 0;
+  size_t rows = 0;
   while (ifs.good())
   {
     std::getline(ifs, line, '\n');
-    ++row;
+    ++rows;
   }
   // Uncount the EOF row.
-  --row;
+  --rows;
 
   // Since we've hit the EOF, we have to call clear() so we can seek again.
   ifs.clear();
   ifs.seekg(pos);
 
   // Now, set the size of the matrix.
-  matrix.set_size(dimensionality, row);
+  matrix.set_size(dimensionality, rows);
+
+  // Categories that were given in the header can be looked up in parallel, as
+  // long as the policy maps each known category to a fixed value (as
+  // IncrementPolicy does).  Every other categorical token is mapped serially,
+  // in the order of the file, so that new categories get the same values as if
+  // the whole file were mapped one token at a time.
+  const bool lookupCategories = std::is_same<PolicyType, IncrementPolicy>::value;
+  std::vector<std::unordered_map<std::string, eT>> categoryValues(
+      dimensionality);
+  std::vector<bool> deferred(dimensionality, false);
+  for (size_t d = 0; d < dimensionality; ++d)
+  {
+    if (info.Type(d) != Datatype::categorical)
+      continue;
 
-  // Now we are looking at the @data section.
-  row = 0;
-  while (ifs.good())
+    if (lookupCategories && categoryStrings.count(d) > 0)
+    {
+      for (const std::string& str : categoryStrings.at(d))
+        categoryValues[d][str] = (eT) info.UnmapValue(str, d);
+    }
+    else
+    {
+      deferred[d] = true;
+    }
+  }
+
+  // Now we are looking at the @data section.  It is read in blocks of lines;
+  // the lines of each block are tokenized and parsed in parallel.  The buffers
+  // are reused across blocks, so tokenizing does not allocate once they have
+  // grown large enough.
+  const size_t blockSize = 4096;
+  std::vector<std::string> lines(blockSize);
+  std::vector<std::vector<std::string>> tokens(blockSize);
+  std::vector<size_t> numTokens(blockSize);
+  std::vector<std::string> errors(blockSize);
+  for (size_t blockStart = 0; blockStart < rows; blockStart += blockSize)
   {
-    std::getline(ifs, line, '\n');
-    boost::trim(line);
-    // Each line of the @data section must be a CSV (except sparse data, which
-    // we will handle later).  So now we can tokenize the
-    // CSV and parse it.  The '?' representing a missing value is not allowed,
-    // so if that occurs we throw an exception.  We also throw an exception if
-    // any piece of data does not match its type (categorical or numeric).
-
-    // If the first character is {, it is sparse data, and we can just say this
-    // is not handled for now...
-    if (line[0] == '{')
-      throw std::runtime_error("cannot yet parse sparse ARFF data");
-
-    // Tokenize the line.
-    typedef boost::tokenizer<boost::escaped_list_separator<char>> Tokenizer;
-    boost::escaped_list_separator<char> sep("\\", ",", "\"");
-    Tokenizer tok(line, sep);
-
-    size_t col = 0;
-    std::stringstream token;
-    for (Tokenizer::iterator it = tok.begin(); it != tok.end(); ++it)
+    const size_t blockRows = std::min(blockSize, rows - blockStart);
+    for (size_t i = 0; i < blockRows; ++i)
+      std::getline(ifs, lines[i], '\n');
+
+    #pragma omp parallel for schedule(static)
+    for (omp_size_t i = 0; i < (omp_size_t) blockRows; ++i)
     {
-      // Check that we are not too many columns in.
-      if (col >= matrix.n_rows)
+      const size_t row = blockStart + i;
+      errors[i].clear();
+      try
       {
-        std::stringstream error;
-        error << "Too many columns in line " << (headerLines + row) << ".";
-        throw std::runtime_error(error.str());
+        arff::ParseLine(lines[i], tokens[i], numTokens[i], row,
+            headerLines + row, matrix, info, categoryValues, deferred,
+            categoryStrings);
       }
+      catch (std::exception& e)
+      {
+        errors[i] = e.what();
+      }
+    }
 
-      // What should this token be?
-      if (info.Type(col) == Datatype::categorical)
+    // Map the remaining categorical tokens in order, stopping at the first
+    // line with an error (as a serial parse would).
+    for (size_t i = 0; i < blockRows; ++i)
+    {
+      if (!errors[i].empty())
+        throw std::runtime_error(errors[i]);
+
+      const size_t row = blockStart + i;
+      for (size_t col = 0; col < numTokens[i]; ++col)
       {
+        if (!deferred[col])
+          continue;
+
         // Strip spaces before mapping.
-        std::string token = *it;
+        std::string& token = tokens[i][col];
         boost::trim(token);
         const size_t currentNumMappings = info.NumMappings(col);
         const eT result = info.template MapString<eT>(token, col);
@@ -242,55 +466,14 @@ void LoadARFF(const std::string& filename,
         if (categoryStrings.count(col) > 0 &&
             currentNumMappings < info.NumMappings(col))
         {
-          std::stringstream error;
-          error << "Parse error at line " << (headerLines + row) << " token "
-              << col << ": category \"" << token << "\" not in the set of known"
-              << " categories for this dimension (";
-          for (size_t i = 0; i < categoryStrings.at(col).size() - 1; ++i)
-            error << "\"" << categoryStrings.at(col)[i] << "\", ";
-          error << "\"" << categoryStrings.at(col).back() << "\").";
-          throw std::runtime_error(error.str());
+          throw std::runtime_error(arff::UnknownCategoryError(
+              headerLines + row, col, token, categoryStrings.at(col)));
         }
 
         // We load transposed.
         matrix(col, row) = result;
       }
-      else if (info.Type(col) == Datatype::numeric)
-      {
-        // Attempt to read as numeric.
-        token.clear();
-        token.str(*it);
-
-        eT val = eT(0);
-        token >> val;
-
-        if (token.fail())
-        {
-          // Check for NaN or inf.
-          if (!IsNaNInf(val, token.str()))
-          {
-            // Okay, it's not NaN or inf.  If it's '?', we issue a specific
-            // error, otherwise we issue a general error.
-            std::stringstream error;
-            std::string tokenStr = token.str();
-            boost::trim(tokenStr);
-            if (tokenStr == "?")
-              error << "Missing values ('?') not supported, ";
-            else
-              error << "Parse error ";
-            error << "at line " << (headerLines + row) << " token " << col
-                << ": \"" << tokenStr << "\".";
-            throw std::runtime_error(error.str());
-          }
-        }
-
-        // If we made it to here, we have a value.
-        matrix(col, row) = val; // We load transposed.
-      }
-
-      ++col;
     }
-    ++row;
   }
 }
 
@@ -204,6 +204,35 @@ class LoadCSV
     }
   }
 
+  /**
+   * Split a single line of the file into its tokens, with the same rules that
+   * are used when loading, and call f(token) for each (whitespace-trimmed)
+   * token.  This is used to read files one line at a time.
+   *
+   * @param line Line to split; it is trimmed in place.
+   * @param f Function to call with each token, as a std::string.
+   * @return false if the line could not be parsed.
+   */
+  template<typename FunctionType>
+  bool Tokenize(std::string& line, FunctionType&& f)
+  {
+    using namespace boost::spirit;
+
+    // Remove whitespace from either side.
+    boost::trim(line);
+
+    auto callToken = [&f](const iter_type& iter)
+    {
+      std::string str(iter.begin(), iter.end());
+      boost::trim(str);
+
+      f(std::move(str));
+    };
+
+    return qi::parse(line.begin(), line.end(),
+        stringRule[callToken] % delimiterRule);
+  }
+
  private:
   using iter_type = boost::iterator_range<std::string::iterator>;
 
@@ -24,10 +24,10 @@
 namespace mlpack {
 namespace data {
 
-bool LoadImage(const std::string& filename,
-               arma::Mat<unsigned char>& matrix,
-               ImageInfo& info,
-               const bool fatal)
+bool DecodeImage(const std::string& filename,
+                 arma::Mat<unsigned char>& matrix,
+                 ImageInfo& info,
+                 std::string& error)
 {
   unsigned char* image;
 
@@ -39,15 +39,7 @@ bool LoadImage(const std::string& filename,
     for (auto extension : loadFileTypes)
       oss << " " << extension;
     oss << "." << std::endl;
-
-    if (fatal)
-    {
-      Log::Fatal << oss.str();
-    }
-    else
-    {
-      Log::Warn << oss.str();
-    }
+    error = oss.str();
 
     return false;
   }
@@ -55,8 +47,10 @@ bool LoadImage(const std::string& filename,
   // Temporary variables needed as stb_image.h supports int parameters.
   int tempWidth, tempHeight, tempChannels;
 
-  // For grayscale images.
-  if (info.Channels() == 1)
+  // For grayscale images.  Images are converted to the requested number of
+  // channels, which may not be the number of channels of the file.
+  const size_t channels = (info.Channels() == 1) ? 1 : 3;
+  if (channels == 1)
   {
     image = stbi_load(filename.c_str(), &tempWidth, &tempHeight, &tempChannels,
         STBI_grey);
@@ -69,23 +63,17 @@ bool LoadImage(const std::string& filename,
 
   if (!image)
   {
-    if (fatal)
-    {
-      Log::Fatal << "Load(): failed to load image '" << filename << "': "
-          << stbi_failure_reason() << std::endl;
-    }
-    else
-    {
-      Log::Warn << "Load(): failed to load image '" << filename << "': "
-          << stbi_failure_reason() << std::endl;
-    }
+    std::ostringstream oss;
+    oss << "Load(): failed to load image '" << filename << "': "
+        << stbi_failure_reason() << std::endl;
+    error = oss.str();
 
     return false;
   }
 
   info.Width() = tempWidth;
   info.Height() = tempHeight;
-  info.Channels() = tempChannels;
+  info.Channels() = channels;
 
   // Copy image into armadillo Mat.
   matrix = arma::Mat<unsigned char>(image, info.Width() * info.Height() *
@@ -96,6 +84,25 @@ bool LoadImage(const std::string& filename,
   return true;
 }
 
+bool LoadImage(const std::string& filename,
+               arma::Mat<unsigned char>& matrix,
+               ImageInfo& info,
+               const bool fatal)
+{
+  std::string error;
+  if (!DecodeImage(filename, matrix, info, error))
+  {
+    if (fatal)
+      Log::Fatal << error;
+    else
+      Log::Warn << error;
+
+    return false;
+  }
+
+  return true;
+}
+
 } // namespace data
 } // namespace mlpack
 
@@ -123,6 +130,16 @@ bool LoadImage(const std::string& /* filename */,
   return false;
 }
 
+bool DecodeImage(const std::string& /* filename */,
+                 arma::Mat<unsigned char>& /* matrix */,
+                 ImageInfo& /* info */,
+                 std::string& error)
+{
+  error = "Load(): mlpack was not compiled with STB support, so images cannot "
+      "be loaded!\n";
+  return false;
+}
+
 } // namespace data
 } // namespace mlpack
 
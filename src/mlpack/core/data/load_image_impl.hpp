@@ -1,96 +1,204 @@
-/**
+/**
  * @file core/data/load_image_impl.hpp
- * @author Mehul Kumar Nirala
- *
- * An image loading utility implementation.
- *
- * mlpack is free software; you may redistribute it and/or modify it under the
- * terms of the 3-clause BSD license.  You should have received a copy of the
- * 3-clause BSD license along with mlpack.  If not, see
- * http://www.opensource.org/licenses/BSD-3-Clause for more information.
- */
-
-#ifndef MLPACK_CORE_DATA_LOAD_IMAGE_IMPL_HPP
-#define MLPACK_CORE_DATA_LOAD_IMAGE_IMPL_HPP
-
-// In case it hasn't been included yet.
-#include "load.hpp"
-
-namespace mlpack {
-namespace data {
-
-// Image loading API.
-template<typename eT>
-bool Load(const std::string& filename,
-          arma::Mat<eT>& matrix,
-          ImageInfo& info,
-          const bool fatal)
-{
-  Timer::Start("loading_image");
-
-  // STB loads into unsigned char matrices, so we may have to convert once
-  // loaded.
-  arma::Mat<unsigned char> tempMatrix;
-  const bool result = LoadImage(filename, tempMatrix, info, fatal);
-
-  // If fatal is true, then the program will have already thrown an exception.
-  if (!result)
-  {
-    Timer::Stop("loading_image");
-    return false;
-  }
-
-  matrix = arma::conv_to<arma::Mat<eT>>::from(tempMatrix);
-  Timer::Stop("loading_image");
-  return true;
-}
-
-// Image loading API for multiple files.
-template<typename eT>
-bool Load(const std::vector<std::string>& files,
-          arma::Mat<eT>& matrix,
-          ImageInfo& info,
-          const bool fatal)
-{
-  if (files.size() == 0)
-  {
-    std::ostringstream oss;
-    oss << "Load(): vector of image files is empty." << std::endl;
-
-    if (fatal)
-      Log::Fatal << oss.str();
-    else
-      Log::Warn << oss.str();
-
-    return false;
-  }
-
-  arma::Mat<unsigned char> img;
-  bool status = LoadImage(files[0], img, info, fatal);
-
-  if (!status)
-    return false;
-
-  // Decide matrix dimension using the image height and width.
-  arma::Mat<unsigned char> tmpMatrix(
-      info.Width() * info.Height() * info.Channels(), files.size());
-  tmpMatrix.col(0) = img;
-
-  for (size_t i = 1; i < files.size() ; ++i)
-  {
-    arma::Mat<unsigned char> colImg(tmpMatrix.colptr(i), tmpMatrix.n_rows, 1,
-        false, true);
-    status = LoadImage(files[i], colImg, info, fatal);
-
-    if (!status)
-      return false;
-  }
-
-  matrix = arma::conv_to<arma::Mat<eT>>::from(tmpMatrix);
-  return true;
-}
-
-} // namespace data
-} // namespace mlpack
-
-#endif
+ * @author Mehul Kumar Nirala
+ *
+ * An image loading utility implementation.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+
+#ifndef MLPACK_CORE_DATA_LOAD_IMAGE_IMPL_HPP
+#define MLPACK_CORE_DATA_LOAD_IMAGE_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "load.hpp"
+
+namespace mlpack {
+namespace data {
+
+// Image loading API.
+template<typename eT>
+bool Load(const std::string& filename,
+          arma::Mat<eT>& matrix,
+          ImageInfo& info,
+          const bool fatal)
+{
+  Timer::Start("loading_image");
+
+  // STB loads into unsigned char matrices, so we may have to convert once
+  // loaded.
+  arma::Mat<unsigned char> tempMatrix;
+  const bool result = LoadImage(filename, tempMatrix, info, fatal);
+
+  // If fatal is true, then the program will have already thrown an exception.
+  if (!result)
+  {
+    Timer::Stop("loading_image");
+    return false;
+  }
+
+  matrix = arma::conv_to<arma::Mat<eT>>::from(tempMatrix);
+  Timer::Stop("loading_image");
+  return true;
+}
+
+namespace image {
+
+/**
+ * Store the interleaved pixels of the given image in out, resized (with
+ * bilinear interpolation) to outWidth x outHeight pixels, and multiplied by
+ * scale.
+ */
+template<typename eT>
+void ConvertImage(const unsigned char* in,
+                  const size_t width,
+                  const size_t height,
+                  const size_t channels,
+                  eT* out,
+                  const size_t outWidth,
+                  const size_t outHeight,
+                  const double scale)
+{
+  if (width == outWidth && height == outHeight)
+  {
+    for (size_t i = 0; i < width * height * channels; ++i)
+      out[i] = eT(scale * in[i]);
+    return;
+  }
+
+  // Map the centers of the output pixels to positions in the input image.
+  const double xRatio = double(width) / double(outWidth);
+  const double yRatio = double(height) / double(outHeight);
+  for (size_t y = 0; y < outHeight; ++y)
+  {
+    const double sy = std::min(std::max((y + 0.5) * yRatio - 0.5, 0.0),
+        double(height - 1));
+    const size_t y0 = (size_t) sy;
+    const size_t y1 = std::min(y0 + 1, height - 1);
+    const double dy = sy - y0;
+
+    for (size_t x = 0; x < outWidth; ++x)
+    {
+      const double sx = std::min(std::max((x + 0.5) * xRatio - 0.5, 0.0),
+          double(width - 1));
+      const size_t x0 = (size_t) sx;
+      const size_t x1 = std::min(x0 + 1, width - 1);
+      const double dx = sx - x0;
+
+      for (size_t c = 0; c < channels; ++c)
+      {
+        const double top = (1 - dx) * in[(y0 * width + x0) * channels + c] +
+            dx * in[(y0 * width + x1) * channels + c];
+        const double bottom = (1 - dx) * in[(y1 * width + x0) * channels + c] +
+            dx * in[(y1 * width + x1) * channels + c];
+        const double value = (1 - dy) * top + dy * bottom;
+
+        // Round, unless the values are scaled.
+        out[(y * outWidth + x) * channels + c] = (scale == 1.0) ?
+            eT(std::floor(value + 0.5)) : eT(scale * value);
+      }
+    }
+  }
+}
+
+} // namespace image
+
+// Image loading API for multiple files.
+template<typename eT>
+bool Load(const std::vector<std::string>& files,
+          arma::Mat<eT>& matrix,
+          ImageInfo& info,
+          const bool fatal,
+          const size_t resizeWidth,
+          const size_t resizeHeight,
+          const bool normalize)
+{
+  if (files.size() == 0)
+  {
+    std::ostringstream oss;
+    oss << "Load(): vector of image files is empty." << std::endl;
+
+    if (fatal)
+      Log::Fatal << oss.str();
+    else
+      Log::Warn << oss.str();
+
+    return false;
+  }
+
+  Timer::Start("loading_image");
+
+  // The first image gives the size of the other ones.
+  arma::Mat<unsigned char> img;
+  if (!LoadImage(files[0], img, info, fatal))
+  {
+    Timer::Stop("loading_image");
+    return false;
+  }
+
+  const size_t width = info.Width();
+  const size_t height = info.Height();
+  const size_t channels = info.Channels();
+  const size_t outWidth = (resizeWidth == 0) ? width : resizeWidth;
+  const size_t outHeight = (resizeHeight == 0) ? height : resizeHeight;
+  const bool resize = (resizeWidth != 0 || resizeHeight != 0);
+  const double scale = normalize ? 1.0 / 255.0 : 1.0;
+
+  matrix.set_size(outWidth * outHeight * channels, files.size());
+  image::ConvertImage(img.memptr(), width, height, channels, matrix.colptr(0),
+      outWidth, outHeight, scale);
+
+  // Each thread decodes its images into its own buffer, and then converts them
+  // into their columns.
+  std::vector<std::string> errors(files.size());
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t i = 1; i < (omp_size_t) files.size(); ++i)
+  {
+    arma::Mat<unsigned char> colImg;
+    ImageInfo colInfo(0, 0, channels);
+    if (!DecodeImage(files[i], colImg, colInfo, errors[i]))
+      continue;
+
+    // Without resizing, all images must have the same size.
+    if (!resize && (colInfo.Width() != width || colInfo.Height() != height))
+    {
+      std::ostringstream oss;
+      oss << "Load(): image '" << files[i] << "' has size " << colInfo.Width()
+          << "x" << colInfo.Height() << ", but image '" << files[0]
+          << "' has size " << width << "x" << height << "." << std::endl;
+      errors[i] = oss.str();
+      continue;
+    }
+
+    image::ConvertImage(colImg.memptr(), colInfo.Width(), colInfo.Height(),
+        channels, matrix.colptr(i), outWidth, outHeight, scale);
+  }
+
+  Timer::Stop("loading_image");
+
+  // Report the first error, if there was any.
+  for (size_t i = 1; i < files.size(); ++i)
+  {
+    if (!errors[i].empty())
+    {
+      if (fatal)
+        Log::Fatal << errors[i];
+      else
+        Log::Warn << errors[i];
+
+      return false;
+    }
+  }
+
+  info.Width() = outWidth;
+  info.Height() = outHeight;
+  return true;
+}
+
+} // namespace data
+} // namespace mlpack
+
+#endif
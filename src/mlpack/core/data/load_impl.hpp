@@ -19,6 +19,8 @@
 #include <mlpack/core/util/timers.hpp>
 
 #include "load_csv.hpp"
+#include "load_numeric_csv.hpp"
+#include "mapped_matrix.hpp"
 #include "load.hpp"
 #include "extension.hpp"
 #include "detect_file_type.hpp"
@@ -85,6 +87,50 @@ bool inline inplace_transpose(MatType& X, bool fatal)
   }
 }
 
+/**
+ * Copy the matrix stored in a file written by SaveMapped(), whose header has
+ * already been read, into the given matrix.
+ */
+template<typename eT>
+bool LoadMapped(const std::string& filename,
+                arma::Mat<eT>& matrix,
+                const mapped::Header& header,
+                const bool fatal)
+{
+  if (header.elemSize != sizeof(eT))
+  {
+    if (fatal)
+      Log::Fatal << "File '" << filename << "' holds elements of "
+          << header.elemSize << " bytes, but elements of " << sizeof(eT)
+          << " bytes were expected." << std::endl;
+    else
+      Log::Warn << "File '" << filename << "' holds elements of "
+          << header.elemSize << " bytes, but elements of " << sizeof(eT)
+          << " bytes were expected; load failed." << std::endl;
+
+    return false;
+  }
+
+  Log::Info << "Loading '" << filename << "' as mapped matrix.  " << std::flush;
+  try
+  {
+    MappedMatrix<eT> mapped(filename);
+    matrix = mapped.Matrix();
+  }
+  catch (std::exception& e)
+  {
+    if (fatal)
+      Log::Fatal << e.what() << std::endl;
+    else
+      Log::Warn << e.what() << std::endl;
+
+    return false;
+  }
+
+  Log::Info << "Size is " << matrix.n_rows << " x " << matrix.n_cols << ".\n";
+  return true;
+}
+
 template<typename eT>
 bool Load(const std::string& filename,
           arma::Mat<eT>& matrix,
@@ -113,6 +159,15 @@ bool Load(const std::string& filename,
     return false;
   }
 
+  // Files written by SaveMapped() are already in the layout mlpack uses, so
+  // they are never transposed.
+  mapped::Header header;
+  if (inputLoadType == arma::auto_detect && mapped::ReadHeader(stream, header))
+  {
+    Timer::Stop("loading_data");
+    return LoadMapped(filename, matrix, header, fatal);
+  }
+
   arma::file_type loadType = inputLoadType;
   std::string stringType;
   if (inputLoadType == arma::auto_detect)
@@ -162,9 +217,28 @@ bool Load(const std::string& filename,
     Log::Info << "Loading '" << filename << "' as " << stringType << ".  "
         << std::flush;
 
+  // Text files that hold only numbers are parsed in parallel, directly into
+  // the right layout; anything that parser can't handle is left to Armadillo.
+  bool parsed = false;
+  if (std::is_floating_point<eT>::value &&
+      (loadType == arma::csv_ascii || loadType == arma::raw_ascii))
+  {
+    try
+    {
+      parsed = LoadNumericCSV(filename, matrix, loadType == arma::csv_ascii,
+          transpose);
+    }
+    catch (std::exception& /* e */)
+    {
+      parsed = false;
+    }
+  }
+
   // We can't use the stream if the type is HDF5.
   bool success;
-  if (loadType != arma::hdf5_binary)
+  if (parsed)
+    success = true;
+  else if (loadType != arma::hdf5_binary)
     success = matrix.load(stream, loadType);
   else
     success = matrix.load(filename, loadType);
@@ -180,12 +254,15 @@ bool Load(const std::string& filename,
 
     return false;
   }
+  else if (parsed)
+    Log::Info << "Size is " << matrix.n_rows << " x " << matrix.n_cols << ".\n";
   else
     Log::Info << "Size is " << (transpose ? matrix.n_cols : matrix.n_rows)
         << " x " << (transpose ? matrix.n_rows : matrix.n_cols) << ".\n";
 
-  // Now transpose the matrix, if necessary.
-  if (transpose)
+  // Now transpose the matrix, if necessary.  (The parallel parser has already
+  // done that.)
+  if (transpose && !parsed)
   {
     success = inplace_transpose(matrix, fatal);
   }
@@ -226,6 +303,27 @@ bool Load(const std::string& filename,
     return false;
   }
 
+  // Files written by SaveMapped() may hold the DatasetInfo too.
+  mapped::Header header;
+  if (mapped::ReadHeader(stream, header))
+  {
+    Timer::Stop("loading_data");
+    if (!LoadMapped(filename, matrix, header, fatal))
+      return false;
+
+    if (header.metadataSize > 0)
+    {
+      arma::Row<size_t> labels;
+      MappedMatrix<eT>(filename).LoadMetadata(info, labels);
+    }
+    else
+    {
+      info.SetDimensionality(matrix.n_rows);
+    }
+
+    return true;
+  }
+
   if (extension == "csv" || extension == "tsv" || extension == "txt")
   {
     Log::Info << "Loading '" << filename << "' as CSV dataset.  " << std::flush;
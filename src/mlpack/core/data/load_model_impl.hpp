@@ -19,6 +19,7 @@
 #include <mlpack/core/util/timers.hpp>
 
 #include "extension.hpp"
+#include "portable_binary_archive.hpp"
 
 #include <boost/serialization/serialization.hpp>
 #include <boost/algorithm/string/trim.hpp>
@@ -47,6 +48,8 @@ bool Load(const std::string& filename,
       f = format::xml;
     else if (extension == "bin")
       f = format::binary;
+    else if (extension == "pbin")
+      f = format::portable_binary;
     else if (extension == "txt")
       f = format::text;
     else
@@ -63,15 +66,17 @@ bool Load(const std::string& filename,
   }
 
   // Now load the given format.
+  // Portable binary archives need binary mode on every platform, and binary
+  // archives need it on Windows.
   std::ifstream ifs;
-#ifdef _WIN32 // Open non-text in binary mode on Windows.
+  std::ios::openmode mode = std::ifstream::in;
+  if (f == format::portable_binary)
+    mode |= std::ifstream::binary;
+#ifdef _WIN32
   if (f == format::binary)
-    ifs.open(filename, std::ifstream::in | std::ifstream::binary);
-  else
-    ifs.open(filename, std::ifstream::in);
-#else
-  ifs.open(filename, std::ifstream::in);
+    mode |= std::ifstream::binary;
 #endif
+  ifs.open(filename, mode);
 
   if (!ifs.is_open())
   {
@@ -102,6 +107,11 @@ bool Load(const std::string& filename,
       boost::archive::binary_iarchive ar(ifs);
       ar >> boost::serialization::make_nvp(name.c_str(), t);
     }
+    else if (f == format::portable_binary)
+    {
+      PortableBinaryIArchive ar(ifs);
+      ar >> boost::serialization::make_nvp(name.c_str(), t);
+    }
 
     return true;
   }
@@ -0,0 +1,87 @@
+/**
+ * @file core/data/load_numeric_csv.cpp
+ *
+ * Implementation of MappedTextFile, which gives read-only access to the
+ * contents of a text file.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "load_numeric_csv.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+
+#ifndef _WIN32
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <unistd.h>
+#endif
+
+namespace mlpack {
+namespace data {
+
+MappedTextFile::MappedTextFile(const std::string& filename) :
+    data(""),
+    size(0),
+    mapping(NULL)
+{
+#ifndef _WIN32
+  const int fd = open(filename.c_str(), O_RDONLY);
+  if (fd < 0)
+    throw std::runtime_error("Cannot open file '" + filename + "'.");
+
+  struct stat fileInfo;
+  if (fstat(fd, &fileInfo) != 0)
+  {
+    close(fd);
+    throw std::runtime_error("Cannot open file '" + filename + "'.");
+  }
+
+  // Empty files can't be mapped, but there is nothing to map anyway.
+  size = (size_t) fileInfo.st_size;
+  if (size > 0)
+  {
+    mapping = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (mapping == MAP_FAILED)
+    {
+      mapping = NULL;
+      close(fd);
+      throw std::runtime_error("Cannot map file '" + filename + "': " +
+          std::strerror(errno) + ".");
+    }
+
+    data = (const char*) mapping;
+  }
+  close(fd);
+#else
+  std::ifstream stream(filename.c_str(), std::ios::binary);
+  if (!stream.is_open())
+    throw std::runtime_error("Cannot open file '" + filename + "'.");
+
+  stream.seekg(0, std::ios::end);
+  size = (size_t) stream.tellg();
+  stream.seekg(0, std::ios::beg);
+
+  buffer.resize(size);
+  if (size > 0 && !stream.read(&buffer[0], size))
+    throw std::runtime_error("Cannot read file '" + filename + "'.");
+
+  data = buffer.c_str();
+#endif
+}
+
+MappedTextFile::~MappedTextFile()
+{
+#ifndef _WIN32
+  if (mapping)
+    munmap(mapping, size);
+#endif
+}
+
+} // namespace data
+} // namespace mlpack
@@ -0,0 +1,93 @@
+/**
+ * @file core/data/load_numeric_csv.hpp
+ *
+ * A parallel loader for CSV and whitespace-separated text files that contain
+ * only numbers.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_LOAD_NUMERIC_CSV_HPP
+#define MLPACK_CORE_DATA_LOAD_NUMERIC_CSV_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace data {
+
+/**
+ * A read-only view of the contents of a text file.  Where mmap() is available
+ * the file is memory-mapped, so that no copy of it is made and several threads
+ * can read different parts of it at once; otherwise, the file is read into
+ * memory.
+ */
+class MappedTextFile
+{
+ public:
+  /**
+   * Open the given file.  A std::runtime_error is thrown if the file cannot be
+   * opened or mapped.
+   *
+   * @param filename Name of the file to open.
+   */
+  MappedTextFile(const std::string& filename);
+
+  //! Unmap the file.
+  ~MappedTextFile();
+
+  //! A MappedTextFile cannot be copied.
+  MappedTextFile(const MappedTextFile& other) = delete;
+  //! A MappedTextFile cannot be copied.
+  MappedTextFile& operator=(const MappedTextFile& other) = delete;
+
+  //! Get the contents of the file.
+  const char* Data() const { return data; }
+  //! Get the size of the file, in bytes.
+  size_t Size() const { return size; }
+
+ private:
+  //! The contents of the file.
+  const char* data;
+  //! The size of the file.
+  size_t size;
+  //! The mapping (or NULL if the file was read into memory or is empty).
+  void* mapping;
+  //! The contents of the file, if it was read into memory.
+  std::string buffer;
+};
+
+/**
+ * Load a text file that holds one point per line and contains only numbers
+ * into the given matrix, using all available OpenMP threads.  The file is
+ * memory-mapped and split into chunks at line boundaries; each line is then
+ * parsed independently, directly into the matrix.
+ *
+ * Only files with the same number of values on every line and no empty lines
+ * are handled; for anything else (i.e. tokens that are not numbers), false is
+ * returned, the contents of the matrix are unspecified, and the file should be
+ * loaded with the general loader instead.
+ *
+ * @param filename Name of the file to load.
+ * @param matrix Matrix to load into.
+ * @param commaSeparated If true, values are separated by commas (possibly
+ *     surrounded by spaces); otherwise, values are separated by any number of
+ *     spaces and tabs.
+ * @param transpose If true, each line is loaded as a column of the matrix;
+ *     otherwise, each line is loaded as a row.
+ * @return Whether the file could be loaded.
+ */
+template<typename eT>
+bool LoadNumericCSV(const std::string& filename,
+                    arma::Mat<eT>& matrix,
+                    const bool commaSeparated,
+                    const bool transpose);
+
+} // namespace data
+} // namespace mlpack
+
+// Include implementation.
+#include "load_numeric_csv_impl.hpp"
+
+#endif
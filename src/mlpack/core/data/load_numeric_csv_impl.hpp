@@ -0,0 +1,227 @@
+/**
+ * @file core/data/load_numeric_csv_impl.hpp
+ *
+ * Implementation of LoadNumericCSV().
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_LOAD_NUMERIC_CSV_IMPL_HPP
+#define MLPACK_CORE_DATA_LOAD_NUMERIC_CSV_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "load_numeric_csv.hpp"
+#include "first_touch.hpp"
+
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+
+namespace mlpack {
+namespace data {
+namespace numeric_csv {
+
+//! Returned by ParseLine() for lines that cannot be parsed.
+static const size_t invalidLine = size_t(-1);
+
+//! Return whether the character is a space or a tab.
+inline bool IsBlank(const char c)
+{
+  return (c == ' ' || c == '\t');
+}
+
+/**
+ * Parse the values on the line [begin, end), storing the i'th value in
+ * out[i * stride] (if out is not NULL).  The character at end must not be part
+ * of a number (i.e. it is a newline or a terminating zero), since std::strtod()
+ * may look at it.  At most maxValues values are stored.
+ *
+ * @return The number of values on the line, or invalidLine if the line is
+ *     empty, holds something other than numbers, or holds more than maxValues
+ *     values.
+ */
+template<typename eT>
+size_t ParseLine(const char* begin,
+                 const char* end,
+                 const bool commaSeparated,
+                 eT* out,
+                 const size_t stride,
+                 const size_t maxValues)
+{
+  const char* p = begin;
+  while (p < end && IsBlank(*p))
+    ++p;
+
+  size_t count = 0;
+  while (true)
+  {
+    // p is at the start of a token; empty tokens are not numbers.
+    if (p == end || *p == ',')
+      return invalidLine;
+
+    char* tokenEnd;
+    const double value = std::strtod(p, &tokenEnd);
+    if (tokenEnd == p || tokenEnd > end || count == maxValues)
+      return invalidLine;
+
+    if (out)
+      out[count * stride] = eT(value);
+    ++count;
+
+    // Find the start of the next token.
+    const char* q = tokenEnd;
+    while (q < end && IsBlank(*q))
+      ++q;
+    if (q == end)
+      return count;
+
+    if (commaSeparated)
+    {
+      if (*q != ',')
+        return invalidLine;
+
+      p = q + 1;
+      while (p < end && IsBlank(*p))
+        ++p;
+    }
+    else
+    {
+      // There must be at least one blank between two values.
+      if (q == tokenEnd)
+        return invalidLine;
+
+      p = q;
+    }
+  }
+}
+
+} // namespace numeric_csv
+
+template<typename eT>
+bool LoadNumericCSV(const std::string& filename,
+                    arma::Mat<eT>& matrix,
+                    const bool commaSeparated,
+                    const bool transpose)
+{
+  using namespace numeric_csv;
+
+  MappedTextFile file(filename);
+  const char* data = file.Data();
+  const size_t size = file.Size();
+  if (size == 0)
+    return false;
+
+  // Split the file into chunks; each chunk holds the lines that start in it.
+  size_t numChunks = 1;
+  #ifdef HAS_OPENMP
+  const size_t minChunkSize = (1 << 20);
+  numChunks = std::max(size_t(1), std::min(size / minChunkSize,
+      size_t(4 * omp_get_max_threads())));
+  #endif
+
+  // A line starts at the beginning of the file and after every newline that is
+  // not the last character of the file.  Given a chunk, this calls f(start) for
+  // every line that starts inside the chunk.
+  auto forEachLine = [&](const size_t c, const std::function<void(size_t)>& f)
+  {
+    const size_t chunkBegin = c * size / numChunks;
+    const size_t chunkEnd = (c + 1) * size / numChunks;
+    if (chunkBegin == 0)
+      f(0);
+
+    // Newlines in [chunkBegin - 1, chunkEnd - 1) start lines in this chunk.
+    const char* p = data + (chunkBegin == 0 ? 0 : chunkBegin - 1);
+    const char* last = data + chunkEnd - 1;
+    while (p < last)
+    {
+      p = (const char*) std::memchr(p, '\n', last - p);
+      if (p == NULL)
+        break;
+
+      f((p - data) + 1);
+      ++p;
+    }
+  };
+
+  // Count the lines in each chunk, so that every chunk knows the index of its
+  // first line.
+  std::vector<size_t> chunkLines(numChunks + 1, 0);
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t c = 0; c < (omp_size_t) numChunks; ++c)
+  {
+    size_t lines = 0;
+    forEachLine(c, [&lines](size_t) { ++lines; });
+    chunkLines[c + 1] = lines;
+  }
+  for (size_t c = 0; c < numChunks; ++c)
+    chunkLines[c + 1] += chunkLines[c];
+  const size_t numLines = chunkLines[numChunks];
+
+  // Parse the line that starts at the given position.
+  auto parse = [&](const size_t start, eT* out, const size_t stride,
+      const size_t maxValues)
+  {
+    const char* lineEnd = (const char*) std::memchr(data + start, '\n',
+        size - start);
+    if (lineEnd == NULL)
+    {
+      // This is the last line, and it has no newline; copy it, since
+      // std::strtod() could otherwise read past the end of the file.
+      std::string line(data + start, size - start);
+      size_t length = line.size();
+      if (length > 0 && line[length - 1] == '\r')
+        --length;
+      return ParseLine(line.c_str(), line.c_str() + length, commaSeparated,
+          out, stride, maxValues);
+    }
+
+    // The newline or carriage return that ends the line stops std::strtod().
+    const char* end = lineEnd;
+    if (end > data + start && *(end - 1) == '\r')
+      --end;
+    return ParseLine(data + start, end, commaSeparated, out, stride,
+        maxValues);
+  };
+
+  // The first line gives the number of values on every line.
+  const size_t numValues = parse(0, (eT*) NULL, 1, invalidLine);
+  if (numValues == invalidLine)
+    return false;
+
+  if (transpose)
+  {
+    matrix.set_size(numValues, numLines);
+    // Place each range of points on the NUMA node of the thread that will
+    // process it in the parallel loops over points.
+    FirstTouch(matrix);
+  }
+  else
+  {
+    matrix.set_size(numLines, numValues);
+  }
+
+  eT* memory = matrix.memptr();
+  size_t failures = 0;
+  #pragma omp parallel for schedule(dynamic) reduction(+:failures)
+  for (omp_size_t c = 0; c < (omp_size_t) numChunks; ++c)
+  {
+    size_t line = chunkLines[c];
+    forEachLine(c, [&](const size_t start)
+    {
+      eT* out = transpose ? (memory + line * numValues) : (memory + line);
+      const size_t stride = transpose ? 1 : numLines;
+      if (parse(start, out, stride, numValues) != numValues)
+        ++failures;
+      ++line;
+    });
+  }
+
+  return (failures == 0);
+}
+
+} // namespace data
+} // namespace mlpack
+
+#endif
@@ -15,6 +15,7 @@
 #include <mlpack/prereqs.hpp>
 #include <unordered_map>
 #include <mlpack/core/data/map_policies/datatype.hpp>
+#include <mlpack/core/data/string_pool.hpp>
 
 namespace mlpack {
 namespace data {
@@ -98,12 +99,8 @@ class IncrementPolicy
       // Check if this input needs to be mapped or if it can be read
       // directly as a number.  This will be true if nothing else in this
       // dimension has yet been mapped, but this can't be read as a number.
-      std::stringstream token;
-      token << input;
       T val;
-      token >> val;
-
-      if (!token.fail() && token.eof())
+      if (ReadNumber(input, val))
         return val;
 
       // Otherwise, we must map.
@@ -142,7 +139,49 @@ class IncrementPolicy
     }
   }
 
+  /**
+   * Map the given string like the other overload, with the mappings of each
+   * dimension stored in a StringPool; the value of a string is its index in
+   * the pool.  This is how DatasetMapper stores the mappings of strings.
+   *
+   * @param input Input to find/create mapping for.
+   * @param dimension Index of the dimension of the input.
+   * @param maps The pool of each categorical dimension.
+   * @param types Vector containing the type information about each dimensions.
+   */
+  template<typename T>
+  T MapString(const std::string& input,
+              const size_t dimension,
+              std::unordered_map<size_t, StringPool>& maps,
+              std::vector<Datatype>& types)
+  {
+    if (types[dimension] == Datatype::numeric && !forceAllMappings)
+    {
+      T val;
+      if (ReadNumber(input, val))
+        return val;
+    }
+
+    // The dimension becomes categorical with its first mapping.
+    StringPool& pool = maps[dimension];
+    if (pool.Size() == 0)
+      types[dimension] = Datatype::categorical;
+
+    return T(pool.Insert(input));
+  }
+
  private:
+  //! Read the input as a number, returning false if it is not one.
+  template<typename T, typename InputType>
+  static bool ReadNumber(const InputType& input, T& val)
+  {
+    std::stringstream token;
+    token << input;
+    token >> val;
+
+    return !token.fail() && token.eof();
+  }
+
   // Whether or not we should map all tokens.
   bool forceAllMappings;
 }; // class IncrementPolicy
@@ -0,0 +1,180 @@
+/**
+ * @file core/data/mapped_matrix.hpp
+ *
+ * Definition of MappedMatrix, which memory-maps a matrix stored in a simple
+ * binary layout so that it can be used without copying it into memory, and
+ * SaveMapped(), which writes a matrix in that layout.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_MAPPED_MATRIX_HPP
+#define MLPACK_CORE_DATA_MAPPED_MATRIX_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include <boost/archive/binary_iarchive.hpp>
+#include <boost/archive/binary_oarchive.hpp>
+
+#include "dataset_mapper.hpp"
+
+namespace mlpack {
+namespace data {
+
+/**
+ * A MappedMatrix memory-maps a file written by SaveMapped() and exposes its
+ * contents as an Armadillo matrix that uses the mapped pages directly as its
+ * (auxiliary) memory.  Opening a mapped matrix is therefore nearly free, no
+ * matter how big the matrix is, and several processes that map the same file
+ * share the same physical pages.
+ *
+ * The mapping is private: modifying the matrix only affects the pages that are
+ * written to, and never the file itself.  The size of the matrix cannot be
+ * changed.  The MappedMatrix must outlive any matrix that uses its memory
+ * (including those returned by Alias()).
+ *
+ * A typical use is to save the (already permuted) dataset of a tree together
+ * with its structure, and later load the tree without copying the dataset:
+ *
+ * @code
+ * // Save the tree.
+ * data::SaveMapped("dataset.bin", tree.Dataset(), true);
+ * std::ofstream ofs("tree.bin", std::ios::binary);
+ * boost::archive::binary_oarchive oa(ofs);
+ * tree.SaveStructure(oa);
+ *
+ * // Load the tree; the dataset is not copied.
+ * data::MappedMatrix<double> mapped("dataset.bin");
+ * std::ifstream ifs("tree.bin", std::ios::binary);
+ * boost::archive::binary_iarchive ia(ifs);
+ * KDTree<EuclideanDistance, NeighborSearchStat<NearestNeighborSort>, arma::mat>
+ *     tree(ia, mapped.Alias());
+ * @endcode
+ *
+ * A file can also hold the DatasetInfo of the matrix and its labels (see the
+ * corresponding SaveMapped() overload), so that a labeled dataset with
+ * categorical dimensions can be kept in a single file.  Since the points are
+ * the columns of the mapped matrix, a subset of the points (i.e. one side of
+ * a train/test split) can be taken with Matrix().cols() and only the pages
+ * of those points are read from disk.
+ *
+ * On platforms without mmap() support the file is read into memory instead.
+ *
+ * @tparam eT Element type of the matrix.
+ */
+template<typename eT>
+class MappedMatrix
+{
+ public:
+  /**
+   * Map the given file, which must have been written by SaveMapped() with the
+   * same element type.  A std::runtime_error is thrown if the file cannot be
+   * opened or is not a valid mapped matrix file.
+   *
+   * @param filename Name of the file to map.
+   */
+  MappedMatrix(const std::string& filename);
+
+  //! Unmap the file.
+  ~MappedMatrix();
+
+  //! A MappedMatrix cannot be copied.
+  MappedMatrix(const MappedMatrix& other) = delete;
+  //! A MappedMatrix cannot be copied.
+  MappedMatrix& operator=(const MappedMatrix& other) = delete;
+
+  //! Get the mapped matrix.
+  const arma::Mat<eT>& Matrix() const { return *matrix; }
+  //! Modify the mapped matrix.
+  arma::Mat<eT>& Matrix() { return *matrix; }
+
+  /**
+   * Return a new matrix that uses the mapped memory.  The caller owns the
+   * returned object (but not the memory it points to), so it can be handed to
+   * a class that takes ownership of its dataset, like a tree.
+   */
+  arma::Mat<eT>* Alias()
+  {
+    return new arma::Mat<eT>(matrix->memptr(), matrix->n_rows,
+        matrix->n_cols, false, true);
+  }
+
+  //! Return whether the file holds a DatasetInfo and labels.
+  bool HasMetadata() const { return metadataSize > 0; }
+
+  /**
+   * Load the DatasetInfo and labels that were saved with the matrix.  A
+   * std::runtime_error is thrown if the file does not hold them.
+   *
+   * @param info DatasetInfo to load into.
+   * @param labels Labels to load into (empty if none were saved).
+   */
+  template<typename PolicyType>
+  void LoadMetadata(DatasetMapper<PolicyType>& info,
+                    arma::Row<size_t>& labels) const;
+
+ private:
+  //! The name of the mapped file.
+  std::string filename;
+  //! The start of the mapping (or NULL if the file was read into memory).
+  void* mapping;
+  //! The size of the mapping, in bytes.
+  size_t mappingSize;
+  //! The matrix that uses the mapped memory.
+  arma::Mat<eT>* matrix;
+  //! The position of the metadata in the file.
+  size_t metadataOffset;
+  //! The size of the metadata (or 0 if the file holds none).
+  size_t metadataSize;
+};
+
+/**
+ * Save a matrix in the layout that MappedMatrix can map: a 64-byte header that
+ * holds the element size and the matrix dimensions, followed by the elements of
+ * the matrix in column-major order.  The matrix is not transposed.
+ *
+ * If the 'fatal' parameter is set to true, a std::runtime_error exception will
+ * be thrown upon failure.
+ *
+ * @param filename Name of file to save to.
+ * @param matrix Matrix to save into file.
+ * @param fatal If an error should be reported as fatal (default false).
+ * @return Boolean value indicating success or failure of save.
+ */
+template<typename eT>
+bool SaveMapped(const std::string& filename,
+                const arma::Mat<eT>& matrix,
+                const bool fatal = false);
+
+/**
+ * Save a matrix in the layout that MappedMatrix can map, together with the
+ * DatasetInfo of its dimensions and its labels, which can be loaded with
+ * MappedMatrix::LoadMetadata().  Either may be trivial (i.e. an all-numeric
+ * DatasetInfo, or empty labels).  data::Load() also recognizes these files.
+ *
+ * If the 'fatal' parameter is set to true, a std::runtime_error exception will
+ * be thrown upon failure.
+ *
+ * @param filename Name of file to save to.
+ * @param matrix Matrix to save into file.
+ * @param info DatasetInfo of the matrix; its dimensionality must match.
+ * @param labels Labels of the points in the matrix.
+ * @param fatal If an error should be reported as fatal (default false).
+ * @return Boolean value indicating success or failure of save.
+ */
+template<typename eT, typename PolicyType>
+bool SaveMapped(const std::string& filename,
+                const arma::Mat<eT>& matrix,
+                const DatasetMapper<PolicyType>& info,
+                const arma::Row<size_t>& labels,
+                const bool fatal = false);
+
+} // namespace data
+} // namespace mlpack
+
+// Include implementation.
+#include "mapped_matrix_impl.hpp"
+
+#endif
@@ -0,0 +1,354 @@
+/**
+ * @file core/data/mapped_matrix_impl.hpp
+ *
+ * Implementation of MappedMatrix and SaveMapped().
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_MAPPED_MATRIX_IMPL_HPP
+#define MLPACK_CORE_DATA_MAPPED_MATRIX_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "mapped_matrix.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <sstream>
+
+#ifndef _WIN32
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <unistd.h>
+#endif
+
+namespace mlpack {
+namespace data {
+
+namespace mapped {
+
+//! The magic string at the start of every mapped matrix file.
+static const char magic[8] = { 'M', 'L', 'P', 'K', 'M', 'A', 'T', '1' };
+
+/**
+ * The header of a mapped matrix file.  It is 64 bytes long, so that the
+ * elements that follow it are aligned to a cache line in the mapping.  If the
+ * file holds metadata (a DatasetInfo and labels), it is stored as a binary
+ * archive of metadataSize bytes at metadataOffset, after the elements.
+ */
+struct Header
+{
+  char magic[8];
+  uint64_t elemSize;
+  uint64_t nRows;
+  uint64_t nCols;
+  uint64_t metadataOffset;
+  uint64_t metadataSize;
+  uint64_t reserved[2];
+};
+
+/**
+ * Read the header at the current position of the stream, and restore the
+ * position afterwards.  Returns false if the stream does not hold a mapped
+ * matrix header.
+ */
+inline bool ReadHeader(std::istream& stream, Header& header)
+{
+  const std::streampos pos = stream.tellg();
+  stream.read((char*) &header, sizeof(header));
+  const bool success = stream.good() &&
+      (std::memcmp(header.magic, magic, sizeof(magic)) == 0);
+  stream.clear();
+  stream.seekg(pos);
+
+  return success;
+}
+
+//! Ensure that the header is valid for the given element type and file size.
+template<typename eT>
+inline void CheckHeader(const Header& header,
+                        const size_t fileSize,
+                        const std::string& filename)
+{
+  if (std::memcmp(header.magic, magic, sizeof(magic)) != 0)
+  {
+    Log::Fatal << "File '" << filename << "' is not a mapped matrix file."
+        << std::endl;
+  }
+
+  if (header.elemSize != sizeof(eT))
+  {
+    Log::Fatal << "File '" << filename << "' holds elements of "
+        << header.elemSize << " bytes, but elements of " << sizeof(eT)
+        << " bytes were expected." << std::endl;
+  }
+
+  // The sizes in the header are untrusted, so check them by division: the
+  // product nRows * nCols (and that times sizeof(eT)) may not fit in 64 bits.
+  const uint64_t maxElem = std::numeric_limits<arma::uword>::max();
+  if (header.nRows > maxElem || header.nCols > maxElem ||
+      (header.nRows > 0 && header.nCols > maxElem / header.nRows))
+  {
+    Log::Fatal << "File '" << filename << "' holds a " << header.nRows << "x"
+        << header.nCols << " matrix, which is too large to be addressed."
+        << std::endl;
+  }
+
+  const uint64_t capacity = (fileSize < sizeof(Header)) ? 0 :
+      (fileSize - sizeof(Header)) / sizeof(eT);
+  if (fileSize < sizeof(Header) ||
+      (header.nRows > 0 && header.nCols > capacity / header.nRows))
+  {
+    Log::Fatal << "File '" << filename << "' is too small to hold a "
+        << header.nRows << "x" << header.nCols << " matrix." << std::endl;
+  }
+
+  // Now nRows * nCols * sizeof(eT) is bounded by the file size, so the
+  // products below cannot overflow.
+
+  if (header.metadataSize > 0 &&
+      (header.metadataOffset < sizeof(Header) +
+          header.nRows * header.nCols * sizeof(eT) ||
+       header.metadataOffset > fileSize ||
+       header.metadataSize > fileSize - header.metadataOffset))
+  {
+    Log::Fatal << "File '" << filename << "' has invalid metadata."
+        << std::endl;
+  }
+}
+
+/**
+ * Write a mapped matrix (its header, elements and the given serialized
+ * metadata) to the current position of the stream.
+ */
+template<typename eT>
+void WriteStream(std::ostream& stream,
+                 const arma::Mat<eT>& matrix,
+                 const std::string& metadata)
+{
+  Header header;
+  std::memset(&header, 0, sizeof(header));
+  std::memcpy(header.magic, magic, sizeof(magic));
+  header.elemSize = sizeof(eT);
+  header.nRows = matrix.n_rows;
+  header.nCols = matrix.n_cols;
+  if (!metadata.empty())
+  {
+    header.metadataOffset = sizeof(header) + matrix.n_elem * sizeof(eT);
+    header.metadataSize = metadata.size();
+  }
+
+  stream.write((const char*) &header, sizeof(header));
+  stream.write((const char*) matrix.memptr(), matrix.n_elem * sizeof(eT));
+  stream.write(metadata.data(), metadata.size());
+}
+
+/**
+ * Write a mapped matrix file, with the given (serialized) metadata after the
+ * elements.
+ */
+template<typename eT>
+bool Write(const std::string& filename,
+           const arma::Mat<eT>& matrix,
+           const std::string& metadata,
+           const bool fatal)
+{
+  std::ofstream stream(filename.c_str(), std::ios::binary);
+  if (!stream.is_open())
+  {
+    if (fatal)
+      Log::Fatal << "Cannot open file '" << filename << "' for writing. "
+          << "Save failed." << std::endl;
+    else
+      Log::Warn << "Cannot open file '" << filename << "' for writing; save "
+          << "failed." << std::endl;
+
+    return false;
+  }
+
+  Log::Info << "Saving mapped matrix to '" << filename << "'." << std::endl;
+
+  WriteStream(stream, matrix, metadata);
+  if (!stream.good())
+  {
+    if (fatal)
+      Log::Fatal << "Save to '" << filename << "' failed." << std::endl;
+    else
+      Log::Warn << "Save to '" << filename << "' failed." << std::endl;
+
+    return false;
+  }
+
+  return true;
+}
+
+} // namespace mapped
+
+template<typename eT>
+MappedMatrix<eT>::MappedMatrix(const std::string& filename) :
+    filename(filename),
+    mapping(NULL),
+    mappingSize(0),
+    matrix(NULL),
+    metadataOffset(0),
+    metadataSize(0)
+{
+#ifndef _WIN32
+  const int fd = open(filename.c_str(), O_RDONLY);
+  if (fd < 0)
+  {
+    Log::Fatal << "Cannot open file '" << filename << "' for mapping."
+        << std::endl;
+  }
+
+  struct stat fileInfo;
+  if (fstat(fd, &fileInfo) != 0 ||
+      (size_t) fileInfo.st_size < sizeof(mapped::Header))
+  {
+    close(fd);
+    Log::Fatal << "File '" << filename << "' is not a mapped matrix file."
+        << std::endl;
+  }
+
+  // A private writable mapping lets the matrix be modified without touching
+  // the file; pages are only copied once they are written to.
+  mappingSize = (size_t) fileInfo.st_size;
+  mapping = mmap(NULL, mappingSize, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd,
+      0);
+  close(fd);
+  if (mapping == MAP_FAILED)
+  {
+    mapping = NULL;
+    Log::Fatal << "Cannot map file '" << filename << "': "
+        << std::strerror(errno) << "." << std::endl;
+  }
+
+  const mapped::Header& header = *((const mapped::Header*) mapping);
+  try
+  {
+    mapped::CheckHeader<eT>(header, mappingSize, filename);
+  }
+  catch (...)
+  {
+    munmap(mapping, mappingSize);
+    mapping = NULL;
+    throw;
+  }
+
+  eT* memory = (eT*) ((char*) mapping + sizeof(mapped::Header));
+  matrix = new arma::Mat<eT>(memory, header.nRows, header.nCols, false, true);
+  metadataOffset = header.metadataOffset;
+  metadataSize = header.metadataSize;
+#else
+  std::ifstream stream(filename.c_str(), std::ios::binary);
+  if (!stream.is_open())
+  {
+    Log::Fatal << "Cannot open file '" << filename << "' for mapping."
+        << std::endl;
+  }
+
+  stream.seekg(0, std::ios::end);
+  const size_t fileSize = (size_t) stream.tellg();
+  stream.seekg(0, std::ios::beg);
+
+  mapped::Header header;
+  if (!stream.read((char*) &header, sizeof(header)))
+  {
+    Log::Fatal << "File '" << filename << "' is not a mapped matrix file."
+        << std::endl;
+  }
+  mapped::CheckHeader<eT>(header, fileSize, filename);
+
+  matrix = new arma::Mat<eT>(header.nRows, header.nCols);
+  stream.read((char*) matrix->memptr(), matrix->n_elem * sizeof(eT));
+  metadataOffset = header.metadataOffset;
+  metadataSize = header.metadataSize;
+#endif
+}
+
+template<typename eT>
+template<typename PolicyType>
+void MappedMatrix<eT>::LoadMetadata(DatasetMapper<PolicyType>& info,
+                                    arma::Row<size_t>& labels) const
+{
+  if (!HasMetadata())
+  {
+    Log::Fatal << "File '" << filename << "' holds no dataset information or "
+        << "labels." << std::endl;
+  }
+
+  // The metadata is small, so it is simply read from the file.
+  std::ifstream stream(filename.c_str(), std::ios::binary);
+  std::string metadata(metadataSize, '\0');
+  stream.seekg(metadataOffset);
+  if (!stream.read(&metadata[0], metadataSize))
+  {
+    Log::Fatal << "Cannot read the metadata of file '" << filename << "'."
+        << std::endl;
+  }
+
+  std::istringstream iss(metadata);
+  boost::archive::binary_iarchive ar(iss);
+  ar >> BOOST_SERIALIZATION_NVP(info);
+  ar >> BOOST_SERIALIZATION_NVP(labels);
+}
+
+template<typename eT>
+MappedMatrix<eT>::~MappedMatrix()
+{
+  delete matrix;
+
+#ifndef _WIN32
+  if (mapping)
+    munmap(mapping, mappingSize);
+#endif
+}
+
+template<typename eT>
+bool SaveMapped(const std::string& filename,
+                const arma::Mat<eT>& matrix,
+                const bool fatal)
+{
+  return mapped::Write(filename, matrix, std::string(), fatal);
+}
+
+template<typename eT, typename PolicyType>
+bool SaveMapped(const std::string& filename,
+                const arma::Mat<eT>& matrix,
+                const DatasetMapper<PolicyType>& info,
+                const arma::Row<size_t>& labels,
+                const bool fatal)
+{
+  if (info.Dimensionality() != matrix.n_rows)
+  {
+    if (fatal)
+      Log::Fatal << "SaveMapped(): dimensionality of the DatasetInfo ("
+          << info.Dimensionality() << ") does not match the matrix ("
+          << matrix.n_rows << ")." << std::endl;
+    else
+      Log::Warn << "SaveMapped(): dimensionality of the DatasetInfo ("
+          << info.Dimensionality() << ") does not match the matrix ("
+          << matrix.n_rows << "); save failed." << std::endl;
+
+    return false;
+  }
+
+  std::ostringstream oss;
+  {
+    boost::archive::binary_oarchive ar(oss);
+    ar << BOOST_SERIALIZATION_NVP(info);
+    ar << BOOST_SERIALIZATION_NVP(labels);
+  }
+
+  return mapped::Write(filename, matrix, oss.str(), fatal);
+}
+
+} // namespace data
+} // namespace mlpack
+
+#endif
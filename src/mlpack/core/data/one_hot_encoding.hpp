@@ -33,6 +33,17 @@ template<typename RowType, typename MatType>
 void OneHotEncoding(const RowType& labelsIn,
                     MatType& output);
 
+/**
+ * Overload of the function above for sparse output, which builds the sparse
+ * matrix directly instead of inserting each element.
+ *
+ * @param labelsIn Input labels of arbitrary datatype.
+ * @param output Binary sparse matrix.
+ */
+template<typename RowType, typename eT>
+void OneHotEncoding(const RowType& labelsIn,
+                    arma::SpMat<eT>& output);
+
 /**
  * Overloaded function for the above function, which takes a matrix as input
  * and also a vector of indices to encode and outputs a matrix.
@@ -47,6 +58,21 @@ void OneHotEncoding(const arma::Mat<eT>& input,
                     const arma::Col<size_t>& indices,
                     arma::Mat<eT>& output);
 
+/**
+ * Overloaded function for the above function, which outputs a sparse matrix.
+ * Every encoded dimension with k categories becomes k output dimensions, of
+ * which only one is nonzero for each point, so sparse output should be used
+ * for dimensions with many categories.
+ *
+ * @param input Input dataset to be encoded.
+ * @param indices Index of rows to be encoded.
+ * @param output Encoded sparse matrix.
+ */
+template<typename eT>
+void OneHotEncoding(const arma::Mat<eT>& input,
+                    const arma::Col<size_t>& indices,
+                    arma::SpMat<eT>& output);
+
 /**
  * Overloaded function for the above function, which takes a matrix as input
  * and also a DatasetInfo object and outputs a matrix.
@@ -54,12 +80,12 @@ void OneHotEncoding(const arma::Mat<eT>& input,
  * in the data::DatasetInfo.
  *
  * @param input Input dataset to be encoded.
- * @param output Encoded matrix.
+ * @param output Encoded matrix (arma::Mat<eT> or arma::SpMat<eT>).
  * @param datasetInfo DatasetInfo object that has information about data.
  */
-template<typename eT>
+template<typename eT, typename OutputType>
 void OneHotEncoding(const arma::Mat<eT>& input,
-                    arma::Mat<eT>& output,
+                    OutputType& output,
                     const data::DatasetInfo& datasetInfo);
 
 } // namespace data
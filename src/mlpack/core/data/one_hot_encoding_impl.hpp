@@ -16,6 +16,8 @@
 // In case it hasn't been included yet.
 #include "one_hot_encoding.hpp"
 
+#include <unordered_map>
+
 namespace mlpack {
 namespace data {
 
@@ -65,6 +67,94 @@ void OneHotEncoding(const RowType& labelsIn,
   labelMap.clear();
 }
 
+/**
+ * Overload of the function above for sparse output.  The matrix is built
+ * directly from its compressed storage, since every column holds exactly one
+ * nonzero element.
+ *
+ * @param labelsIn Input labels of arbitrary datatype.
+ * @param output Binary sparse matrix.
+ */
+template<typename RowType, typename eT>
+void OneHotEncoding(const RowType& labelsIn,
+                    arma::SpMat<eT>& output)
+{
+  arma::uvec rowIndices(labelsIn.n_elem);
+
+  // Map each input label to a row, in order of appearance.
+  std::unordered_map<eT, size_t> labelMap;
+  for (size_t i = 0; i < labelsIn.n_elem; ++i)
+  {
+    typename std::unordered_map<eT, size_t>::const_iterator it =
+        labelMap.find(labelsIn[i]);
+    if (it != labelMap.end())
+    {
+      rowIndices[i] = it->second;
+    }
+    else
+    {
+      rowIndices[i] = labelMap.size();
+      labelMap[labelsIn[i]] = rowIndices[i];
+    }
+  }
+
+  const arma::uvec colPtrs = arma::regspace<arma::uvec>(0, labelsIn.n_elem);
+  output = arma::SpMat<eT>(rowIndices, colPtrs,
+      arma::Col<eT>(labelsIn.n_elem, arma::fill::ones), labelMap.size(),
+      labelsIn.n_elem);
+}
+
+namespace one_hot {
+
+/**
+ * Find the dimensions of the one-hot encoded matrix.  For each encoded
+ * dimension of the input, each value is mapped to a dimension of the output in
+ * order of appearance; offsets[d] holds the first output dimension of input
+ * dimension d (and offsets[input.n_rows] the number of output dimensions).
+ *
+ * @param input Input dataset to be encoded.
+ * @param indices Index of rows to be encoded.
+ * @param mappings Mappings from values to output dimensions; only the mappings
+ *     of encoded dimensions are used.
+ * @param encoded Set to whether each dimension is encoded.
+ * @param offsets Offsets of each dimension in the output.
+ */
+template<typename eT>
+void FindMappings(const arma::Mat<eT>& input,
+                  const arma::Col<size_t>& indices,
+                  std::vector<std::unordered_map<eT, size_t>>& mappings,
+                  std::vector<bool>& encoded,
+                  std::vector<size_t>& offsets)
+{
+  mappings.assign(input.n_rows, std::unordered_map<eT, size_t>());
+  encoded.assign(input.n_rows, false);
+  for (size_t i = 0; i < indices.n_elem; ++i)
+    encoded[indices[i]] = true;
+
+  for (size_t col = 0; col < input.n_cols; ++col)
+  {
+    for (size_t row = 0; row < input.n_rows; ++row)
+    {
+      // We have to one-hot encode this point.
+      if (encoded[row] && mappings[row].count(input(row, col)) == 0)
+      {
+        const size_t index = mappings[row].size();
+        mappings[row][input(row, col)] = index;
+      }
+    }
+  }
+
+  // Turn the dimension counts into offsets.
+  offsets.assign(input.n_rows + 1, 0);
+  for (size_t row = 0; row < input.n_rows; ++row)
+  {
+    offsets[row + 1] = offsets[row] +
+        (encoded[row] ? mappings[row].size() : 1);
+  }
+}
+
+} // namespace one_hot
+
 /**
  * Overloaded function for the above function, which takes a matrix as input
  * and also a vector of indices to encode and outputs a matrix.
@@ -87,60 +177,92 @@ void OneHotEncoding(const arma::Mat<eT>& input,
   }
 
   // First, we need to compute the size of the output matrix.
+  std::vector<std::unordered_map<eT, size_t>> mappings;
+  std::vector<bool> encoded;
+  std::vector<size_t> offsets;
+  one_hot::FindMappings(input, indices, mappings, encoded, offsets);
 
-  // This vector will eventually hold the offsets for each dimension in the
-  // one-hot encoded matrix, but first it will just hold the counts of
-  // dimensions for each dimension.
-  arma::Col<size_t> dimensionOffsets(input.n_rows, arma::fill::ones);
-  // This will hold the mappings from a value that should be one-hot encoded to
-  // the index of the dimension it should take.
-  std::unordered_map<size_t, std::unordered_map<eT, size_t>> mappings;
-  for (size_t i = 0; i < indices.n_elem; ++i)
-  {
-    dimensionOffsets[indices[i]] = 0;
-    mappings.insert(
-        std::make_pair(indices[i], std::unordered_map<eT, size_t>()));
-  }
+  // Now, initialize the output matrix to the right size.
+  output.zeros(offsets[input.n_rows], input.n_cols);
 
-  for (size_t col = 0; col < input.n_cols; ++col)
+  // Finally, one-hot encode the matrix.  The mappings are only read, so the
+  // columns can be encoded in parallel.
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t col = 0; col < (omp_size_t) input.n_cols; ++col)
   {
     for (size_t row = 0; row < input.n_rows; ++row)
     {
-      if (mappings.count(row) != 0)
+      if (encoded[row])
       {
-        // We have to one-hot encode this point.
-        if (mappings[row].count(input(row, col)) == 0)
-          mappings[row][input(row, col)] = dimensionOffsets[row]++;
+        output(offsets[row] + mappings[row].at(input(row, col)), col) = eT(1);
+      }
+      else
+      {
+        // No need for one-hot encoding.
+        output(offsets[row], col) = input(row, col);
       }
     }
   }
+}
 
-  // Turn the dimension counts into offsets.  Note that the last element is the
-  // total number of dimensions, and the first element is the offset for
-  // dimension *2* (not 1).
-  for (size_t i = 1; i < dimensionOffsets.n_elem; ++i)
-    dimensionOffsets[i] += dimensionOffsets[i - 1];
+/**
+ * Overloaded function for the above function, which outputs a sparse matrix.
+ * The matrix is built directly from its compressed storage, so for dimensions
+ * with many categories the output takes far less memory than a dense matrix.
+ *
+ * @param input Input dataset to be encoded.
+ * @param indices Index of rows to be encoded.
+ * @param output Encoded sparse matrix.
+ */
+template<typename eT>
+void OneHotEncoding(const arma::Mat<eT>& input,
+                    const arma::Col<size_t>& indices,
+                    arma::SpMat<eT>& output)
+{
+  std::vector<std::unordered_map<eT, size_t>> mappings;
+  std::vector<bool> encoded;
+  std::vector<size_t> offsets;
+  one_hot::FindMappings(input, indices, mappings, encoded, offsets);
 
-  // Now, initialize the output matrix to the right size.
-  output.zeros(dimensionOffsets[dimensionOffsets.n_elem - 1], input.n_cols);
+  // Count the nonzero elements of each column: one for each encoded
+  // dimension, and one for each nonzero value of the other dimensions.
+  arma::uvec colPtrs(input.n_cols + 1);
+  colPtrs[0] = 0;
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t col = 0; col < (omp_size_t) input.n_cols; ++col)
+  {
+    size_t nonzeros = 0;
+    for (size_t row = 0; row < input.n_rows; ++row)
+      nonzeros += (encoded[row] || input(row, col) != eT(0)) ? 1 : 0;
+    colPtrs[col + 1] = nonzeros;
+  }
+  colPtrs = arma::cumsum(colPtrs);
 
-  // Finally, one-hot encode the matrix.
-  for (size_t col = 0; col < input.n_cols; ++col)
+  // The output dimensions grow with the input dimensions, so the row indices
+  // of each column come out sorted.
+  arma::uvec rowIndices(colPtrs[input.n_cols]);
+  arma::Col<eT> values(colPtrs[input.n_cols]);
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t col = 0; col < (omp_size_t) input.n_cols; ++col)
   {
+    size_t k = colPtrs[col];
     for (size_t row = 0; row < input.n_rows; ++row)
     {
-      const size_t dimOffset = (row == 0) ? 0 : dimensionOffsets[row - 1];
-      if (mappings.count(row) != 0)
+      if (encoded[row])
       {
-        output(dimOffset + mappings[row][input(row, col)], col) = eT(1);
+        rowIndices[k] = offsets[row] + mappings[row].at(input(row, col));
+        values[k++] = eT(1);
       }
-      else
+      else if (input(row, col) != eT(0))
       {
-        // No need for one-hot encoding.
-        output(dimOffset, col) = input(row, col);
+        rowIndices[k] = offsets[row];
+        values[k++] = input(row, col);
       }
     }
   }
+
+  output = arma::SpMat<eT>(rowIndices, colPtrs, values, offsets[input.n_rows],
+      input.n_cols);
 }
 
 /**
@@ -150,12 +272,12 @@ void OneHotEncoding(const arma::Mat<eT>& input,
  * in the data::DatasetInfo.
  *
  * @param input Input dataset to be encoded.
- * @param output Encoded matrix.
+ * @param output Encoded matrix (arma::Mat<eT> or arma::SpMat<eT>).
  * @param datasetInfo DatasetInfo object that has information about data.
  */
-template<typename eT>
+template<typename eT, typename OutputType>
 void OneHotEncoding(const arma::Mat<eT>& input,
-                    arma::Mat<eT>& output,
+                    OutputType& output,
                     const data::DatasetInfo& datasetInfo)
 {
   std::vector<size_t> indices;
@@ -0,0 +1,33 @@
+/**
+ * @file core/data/portable_binary_archive.cpp
+ *
+ * Instantiation of the parts of boost::serialization that the portable binary
+ * archives need.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "portable_binary_archive.hpp"
+
+#include <boost/archive/impl/archive_serializer_map.ipp>
+#include <boost/archive/impl/basic_binary_iprimitive.ipp>
+#include <boost/archive/impl/basic_binary_oprimitive.ipp>
+
+namespace boost {
+namespace archive {
+
+template class basic_binary_oprimitive<mlpack::data::PortableBinaryOArchive,
+    std::ostream::char_type, std::ostream::traits_type>;
+template class basic_binary_iprimitive<mlpack::data::PortableBinaryIArchive,
+    std::istream::char_type, std::istream::traits_type>;
+
+namespace detail {
+
+template class archive_serializer_map<mlpack::data::PortableBinaryOArchive>;
+template class archive_serializer_map<mlpack::data::PortableBinaryIArchive>;
+
+} // namespace detail
+} // namespace archive
+} // namespace boost
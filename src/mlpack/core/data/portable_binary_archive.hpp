@@ -0,0 +1,490 @@
+/**
+ * @file core/data/portable_binary_archive.hpp
+ *
+ * Definition of PortableBinaryOArchive and PortableBinaryIArchive, compact
+ * boost::serialization archives with a fixed little-endian layout.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_PORTABLE_BINARY_ARCHIVE_HPP
+#define MLPACK_CORE_DATA_PORTABLE_BINARY_ARCHIVE_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include <boost/archive/archive_exception.hpp>
+#include <boost/archive/basic_binary_iprimitive.hpp>
+#include <boost/archive/basic_binary_oprimitive.hpp>
+#include <boost/archive/detail/common_iarchive.hpp>
+#include <boost/archive/detail/common_oarchive.hpp>
+#include <boost/archive/detail/register_archive.hpp>
+#include <boost/mpl/bool.hpp>
+#include <boost/predef/other/endian.h>
+#include <boost/serialization/item_version_type.hpp>
+#include <boost/serialization/string.hpp>
+
+#include <istream>
+#include <ostream>
+#include <type_traits>
+
+namespace mlpack {
+namespace data {
+namespace portable {
+
+//! The bytes every portable binary archive starts with.
+static const char magic[8] = { 'M', 'L', 'P', 'K', 'P', 'B', 'I', 'N' };
+
+//! The version of the layout of portable binary archives.
+static const unsigned char formatVersion = 1;
+
+//! Reverse the order of the bytes of each of the given elements.
+inline void SwapBytes(char* data, const size_t count, const size_t size)
+{
+  for (size_t i = 0; i < count; ++i)
+    std::reverse(data + i * size, data + (i + 1) * size);
+}
+
+//! Whether elements must be byte-swapped to or from little-endian order.
+#if BOOST_ENDIAN_BIG_BYTE
+static const bool swapBytes = true;
+#else
+static const bool swapBytes = false;
+#endif
+
+} // namespace portable
+
+/**
+ * An output archive that saves objects with boost::serialization in a compact
+ * binary layout that is the same on every platform:
+ *
+ *  - the archive starts with a signature and a format version, so that other
+ *    files are detected;
+ *  - integers (including sizes and the archive's own bookkeeping) are stored in
+ *    as few bytes as they need, in little-endian order, so that archives can be
+ *    read on platforms with other sizes of int, long or size_t;
+ *  - float and double are stored as little-endian IEEE 754 values;
+ *  - arrays of numbers, like the memory of Armadillo matrices, are stored as
+ *    one contiguous block (with no conversion at all on little-endian
+ *    platforms), which makes saving and loading large models much faster than
+ *    with text or XML archives.
+ *
+ * All existing serialize() methods can be used with it; data::Save() uses it
+ * for the format::portable_binary format (and the .pbin extension).  The
+ * stream must be opened in binary mode.
+ *
+ * @code
+ * std::ofstream ofs("model.pbin", std::ios::binary);
+ * data::PortableBinaryOArchive ar(ofs);
+ * ar << BOOST_SERIALIZATION_NVP(model);
+ * @endcode
+ */
+class PortableBinaryOArchive :
+    public boost::archive::basic_binary_oprimitive<PortableBinaryOArchive,
+        std::ostream::char_type, std::ostream::traits_type>,
+    public boost::archive::detail::common_oarchive<PortableBinaryOArchive>
+{
+  typedef boost::archive::basic_binary_oprimitive<PortableBinaryOArchive,
+      std::ostream::char_type, std::ostream::traits_type> PrimitiveBase;
+  typedef boost::archive::detail::common_oarchive<PortableBinaryOArchive>
+      ArchiveBase;
+
+  friend class boost::archive::detail::interface_oarchive<
+      PortableBinaryOArchive>;
+  friend class boost::archive::detail::common_oarchive<PortableBinaryOArchive>;
+  friend class boost::archive::basic_binary_oprimitive<PortableBinaryOArchive,
+      std::ostream::char_type, std::ostream::traits_type>;
+  friend class boost::archive::save_access;
+
+ public:
+  /**
+   * Create the archive, writing its header to the given stream.
+   *
+   * @param os Stream to write to (opened in binary mode).
+   * @param flags The boost::archive flags (e.g. no_tracking).
+   */
+  PortableBinaryOArchive(std::ostream& os, const unsigned int flags = 0) :
+      PrimitiveBase(*os.rdbuf(), true),
+      ArchiveBase(flags)
+  {
+    save_binary(portable::magic, sizeof(portable::magic));
+    save(portable::formatVersion);
+    save((unsigned int) boost::archive::BOOST_ARCHIVE_VERSION());
+  }
+
+  /**
+   * Save an array of numbers as one contiguous block, preceded by the size of
+   * each element.
+   */
+  template<typename ValueType>
+  void save_array(const boost::serialization::array_wrapper<ValueType>& a,
+                  const unsigned int /* version */)
+  {
+    save((unsigned char) sizeof(ValueType));
+    if (!portable::swapBytes || sizeof(ValueType) == 1)
+    {
+      save_binary(a.address(), a.count() * sizeof(ValueType));
+      return;
+    }
+
+    // Convert blocks of elements to little-endian order.
+    const size_t blockSize = 8192;
+    std::vector<typename std::remove_const<ValueType>::type> block(
+        std::min(blockSize, a.count()));
+    for (size_t i = 0; i < a.count(); i += blockSize)
+    {
+      const size_t count = std::min(blockSize, a.count() - i);
+      std::copy(a.address() + i, a.address() + i + count, block.begin());
+      portable::SwapBytes((char*) block.data(), count, sizeof(ValueType));
+      save_binary(block.data(), count * sizeof(ValueType));
+    }
+  }
+
+  //! Only arrays of numbers are saved as blocks.
+  struct use_array_optimization
+  {
+    template<typename T>
+    struct apply : public boost::mpl::bool_<std::is_arithmetic<T>::value> { };
+  };
+
+ protected:
+  //! Save an integer in as few bytes as it needs.
+  template<typename T>
+  typename std::enable_if<std::is_integral<T>::value>::type
+  save(const T& t)
+  {
+    if (sizeof(T) == 1)
+    {
+      save_binary(&t, 1);
+      return;
+    }
+
+    const bool negative = (t < T(0));
+    // Compute the magnitude without overflow for the most negative value.
+    uintmax_t magnitude = negative ? uintmax_t(-(t + T(1))) + 1 : uintmax_t(t);
+    char bytes[sizeof(uintmax_t) + 1];
+    signed char size = 0;
+    while (magnitude > 0)
+    {
+      bytes[++size] = char(magnitude & 0xFF);
+      magnitude >>= 8;
+    }
+    bytes[0] = char(negative ? -size : size);
+    save_binary(bytes, size + 1);
+  }
+
+  //! Save a float as a little-endian IEEE 754 value.
+  void save(const float& t) { SaveFloating(t); }
+  //! Save a double as a little-endian IEEE 754 value.
+  void save(const double& t) { SaveFloating(t); }
+  //! Save a long double as a double, since its size depends on the platform.
+  void save(const long double& t) { SaveFloating(double(t)); }
+
+  //! Save a string as its length and characters.
+  void save(const std::string& t) { PrimitiveBase::save(t); }
+  //! Save a C string as its length and characters.
+  void save(const char* t) { PrimitiveBase::save(t); }
+
+  // The types that the archive uses for its own bookkeeping.
+  void save(const boost::archive::version_type& t)
+  { save((unsigned int) t); }
+  void save(const boost::archive::class_id_type& t)
+  { save((int_least16_t) t); }
+  void save(const boost::archive::class_id_reference_type& t)
+  { save((int_least16_t) t); }
+  void save(const boost::archive::object_id_type& t)
+  { save((uint_least32_t) t); }
+  void save(const boost::archive::object_reference_type& t)
+  { save((uint_least32_t) t); }
+  void save(const boost::archive::tracking_type& t)
+  { save((bool) t); }
+  void save(const boost::serialization::collection_size_type& t)
+  { save((size_t) t); }
+  void save(const boost::serialization::item_version_type& t)
+  { save((unsigned int) t); }
+
+  //! Forward everything else to the serialization library.
+  template<typename T>
+  void save_override(const T& t) { ArchiveBase::save_override(t); }
+  //! Class names are saved as strings.
+  void save_override(const boost::archive::class_name_type& t)
+  {
+    const std::string s(t);
+    *this << s;
+  }
+  //! Optional class ids are not saved.
+  void save_override(const boost::archive::class_id_optional_type&) { }
+
+ private:
+  //! Save a floating-point value in little-endian order.
+  template<typename T>
+  void SaveFloating(const T t)
+  {
+    char bytes[sizeof(T)];
+    std::memcpy(bytes, &t, sizeof(T));
+    if (portable::swapBytes)
+      portable::SwapBytes(bytes, 1, sizeof(T));
+    save_binary(bytes, sizeof(T));
+  }
+};
+
+/**
+ * An input archive that loads objects saved with a PortableBinaryOArchive.
+ * A boost::archive::archive_exception is thrown if the stream doesn't hold a
+ * portable binary archive, if it was written by a newer version, if it ends
+ * early, or if a value does not fit in the type it is loaded into (e.g. a
+ * size_t above 2^32 on a 32-bit platform).
+ *
+ * @code
+ * std::ifstream ifs("model.pbin", std::ios::binary);
+ * data::PortableBinaryIArchive ar(ifs);
+ * ar >> BOOST_SERIALIZATION_NVP(model);
+ * @endcode
+ */
+class PortableBinaryIArchive :
+    public boost::archive::basic_binary_iprimitive<PortableBinaryIArchive,
+        std::istream::char_type, std::istream::traits_type>,
+    public boost::archive::detail::common_iarchive<PortableBinaryIArchive>
+{
+  typedef boost::archive::basic_binary_iprimitive<PortableBinaryIArchive,
+      std::istream::char_type, std::istream::traits_type> PrimitiveBase;
+  typedef boost::archive::detail::common_iarchive<PortableBinaryIArchive>
+      ArchiveBase;
+
+  friend class boost::archive::detail::interface_iarchive<
+      PortableBinaryIArchive>;
+  friend class boost::archive::detail::common_iarchive<PortableBinaryIArchive>;
+  friend class boost::archive::basic_binary_iprimitive<PortableBinaryIArchive,
+      std::istream::char_type, std::istream::traits_type>;
+  friend class boost::archive::load_access;
+
+ public:
+  /**
+   * Create the archive, reading its header from the given stream.
+   *
+   * @param is Stream to read from (opened in binary mode).
+   * @param flags The boost::archive flags.
+   */
+  PortableBinaryIArchive(std::istream& is, const unsigned int flags = 0) :
+      PrimitiveBase(*is.rdbuf(), true),
+      ArchiveBase(flags)
+  {
+    char signature[sizeof(portable::magic)];
+    load_binary(signature, sizeof(signature));
+    if (!std::equal(signature, signature + sizeof(signature),
+        portable::magic))
+    {
+      boost::serialization::throw_exception(boost::archive::archive_exception(
+          boost::archive::archive_exception::invalid_signature));
+    }
+
+    unsigned char version;
+    load(version);
+    unsigned int libraryVersion;
+    load(libraryVersion);
+    if (version > portable::formatVersion ||
+        libraryVersion > boost::archive::BOOST_ARCHIVE_VERSION())
+    {
+      boost::serialization::throw_exception(boost::archive::archive_exception(
+          boost::archive::archive_exception::unsupported_version));
+    }
+    set_library_version(
+        boost::serialization::library_version_type(libraryVersion));
+  }
+
+  /**
+   * Load an array of numbers saved as one contiguous block.  Arrays of
+   * integers saved with another element size (e.g. size_t on a 32-bit
+   * platform) are converted.
+   */
+  template<typename ValueType>
+  void load_array(boost::serialization::array_wrapper<ValueType>& a,
+                  const unsigned int /* version */)
+  {
+    unsigned char size;
+    load(size);
+    if (size == sizeof(ValueType))
+    {
+      load_binary(a.address(), a.count() * sizeof(ValueType));
+      if (portable::swapBytes && sizeof(ValueType) > 1)
+        portable::SwapBytes((char*) a.address(), a.count(), sizeof(ValueType));
+      return;
+    }
+
+    if (!std::is_integral<ValueType>::value || size == 0 || size > 8)
+      ThrowIncompatible("size of array elements");
+
+    // Convert the elements one at a time.
+    for (size_t i = 0; i < a.count(); ++i)
+    {
+      char bytes[8] = { 0 };
+      load_binary(bytes, size);
+      uintmax_t value = 0;
+      for (size_t b = size; b > 0; --b)
+        value = (value << 8) | (unsigned char) bytes[b - 1];
+
+      // Sign-extend values of signed types.
+      const bool negative = std::is_signed<ValueType>::value &&
+          (bytes[size - 1] & 0x80);
+      if (negative && size < 8)
+        value |= ~uintmax_t(0) << (8 * size);
+      a.address()[i] = ConvertInteger<ValueType>(negative,
+          negative ? ~value + 1 : value);
+    }
+  }
+
+  //! Only arrays of numbers are loaded as blocks.
+  struct use_array_optimization
+  {
+    template<typename T>
+    struct apply : public boost::mpl::bool_<std::is_arithmetic<T>::value> { };
+  };
+
+ protected:
+  //! Load an integer saved in as few bytes as it needs.
+  template<typename T>
+  typename std::enable_if<std::is_integral<T>::value>::type
+  load(T& t)
+  {
+    if (sizeof(T) == 1)
+    {
+      load_binary(&t, 1);
+      return;
+    }
+
+    signed char size;
+    load_binary(&size, 1);
+    const bool negative = (size < 0);
+    const size_t numBytes = negative ? size_t(-size) : size_t(size);
+    if (numBytes > sizeof(uintmax_t))
+      ThrowIncompatible("size of integer");
+
+    unsigned char bytes[sizeof(uintmax_t)];
+    load_binary(bytes, numBytes);
+    uintmax_t magnitude = 0;
+    for (size_t b = numBytes; b > 0; --b)
+      magnitude = (magnitude << 8) | bytes[b - 1];
+
+    t = ConvertInteger<T>(negative, magnitude);
+  }
+
+  //! Load a little-endian IEEE 754 float.
+  void load(float& t) { LoadFloating(t); }
+  //! Load a little-endian IEEE 754 double.
+  void load(double& t) { LoadFloating(t); }
+  //! Load a long double, which is saved as a double.
+  void load(long double& t)
+  {
+    double d;
+    LoadFloating(d);
+    t = d;
+  }
+
+  //! Load a string.
+  void load(std::string& t) { PrimitiveBase::load(t); }
+  //! Load a C string.
+  void load(char* t) { PrimitiveBase::load(t); }
+
+  // The types that the archive uses for its own bookkeeping.
+  void load(boost::archive::version_type& t)
+  { t = boost::archive::version_type(LoadAs<unsigned int>()); }
+  void load(boost::archive::class_id_type& t)
+  { t = boost::archive::class_id_type(int(LoadAs<int_least16_t>())); }
+  void load(boost::archive::class_id_reference_type& t)
+  {
+    t = boost::archive::class_id_reference_type(boost::archive::class_id_type(
+        int(LoadAs<int_least16_t>())));
+  }
+  void load(boost::archive::object_id_type& t)
+  { t = boost::archive::object_id_type(LoadAs<uint_least32_t>()); }
+  void load(boost::archive::object_reference_type& t)
+  {
+    t = boost::archive::object_reference_type(boost::archive::object_id_type(
+        LoadAs<uint_least32_t>()));
+  }
+  void load(boost::archive::tracking_type& t)
+  { t = boost::archive::tracking_type(LoadAs<bool>()); }
+  void load(boost::serialization::collection_size_type& t)
+  { t = boost::serialization::collection_size_type(LoadAs<size_t>()); }
+  void load(boost::serialization::item_version_type& t)
+  { t = boost::serialization::item_version_type(LoadAs<unsigned int>()); }
+
+  //! Forward everything else to the serialization library.
+  template<typename T>
+  void load_override(T& t) { ArchiveBase::load_override(t); }
+  //! Class names are saved as strings.
+  void load_override(boost::archive::class_name_type& t)
+  {
+    std::string s;
+    *this >> s;
+    if (s.size() > BOOST_SERIALIZATION_MAX_KEY_SIZE - 1)
+    {
+      boost::serialization::throw_exception(boost::archive::archive_exception(
+          boost::archive::archive_exception::invalid_class_name));
+    }
+    std::memcpy(t, s.data(), s.size());
+    t.t[s.size()] = '\0';
+  }
+  //! Optional class ids are not saved.
+  void load_override(boost::archive::class_id_optional_type&) { }
+
+ private:
+  //! Load a value of the given type.
+  template<typename T>
+  T LoadAs()
+  {
+    T t;
+    load(t);
+    return t;
+  }
+
+  //! Load a little-endian floating-point value.
+  template<typename T>
+  void LoadFloating(T& t)
+  {
+    char bytes[sizeof(T)];
+    load_binary(bytes, sizeof(T));
+    if (portable::swapBytes)
+      portable::SwapBytes(bytes, 1, sizeof(T));
+    std::memcpy(&t, bytes, sizeof(T));
+  }
+
+  //! Convert a sign and a magnitude to the given type, checking its range.
+  template<typename T>
+  static T ConvertInteger(const bool negative, const uintmax_t magnitude)
+  {
+    if (negative)
+    {
+      // The magnitude of the most negative value is one more than the largest
+      // positive value.
+      if (!std::is_signed<T>::value || magnitude == 0 ||
+          magnitude - 1 > uintmax_t(std::numeric_limits<T>::max()))
+        ThrowIncompatible("negative value");
+      return T(-T(magnitude - 1) - T(1));
+    }
+
+    if (magnitude > uintmax_t(std::numeric_limits<T>::max()))
+      ThrowIncompatible("integer too large");
+    return T(magnitude);
+  }
+
+  //! Throw the exception for values that can't be loaded on this platform.
+  static void ThrowIncompatible(const char* what)
+  {
+    boost::serialization::throw_exception(boost::archive::archive_exception(
+        boost::archive::archive_exception::incompatible_native_format, what));
+  }
+};
+
+} // namespace data
+} // namespace mlpack
+
+BOOST_SERIALIZATION_REGISTER_ARCHIVE(mlpack::data::PortableBinaryOArchive)
+BOOST_SERIALIZATION_USE_ARRAY_OPTIMIZATION(
+    mlpack::data::PortableBinaryOArchive)
+BOOST_SERIALIZATION_REGISTER_ARCHIVE(mlpack::data::PortableBinaryIArchive)
+BOOST_SERIALIZATION_USE_ARRAY_OPTIMIZATION(
+    mlpack::data::PortableBinaryIArchive)
+
+#endif
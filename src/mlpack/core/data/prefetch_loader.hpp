@@ -0,0 +1,293 @@
+/**
+ * @file core/data/prefetch_loader.hpp
+ *
+ * Definition of PrefetchLoader, which decodes the chunks of a dataset on a
+ * background thread while the previous chunks are used, and of the chunk
+ * sources it reads from.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_PREFETCH_LOADER_HPP
+#define MLPACK_CORE_DATA_PREFETCH_LOADER_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "load.hpp"
+#include "image_info.hpp"
+#include "mapped_matrix.hpp"
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace mlpack {
+namespace data {
+
+/**
+ * A chunk source whose chunks are pairs of files loaded with data::Load(): the
+ * predictors of chunk i are loaded from predictorFiles[i] and its responses
+ * from responseFiles[i], one point per column.
+ */
+class FileChunkSource
+{
+ public:
+  /**
+   * Create the source from the given files.
+   *
+   * @param predictorFiles The file of the predictors of each chunk.
+   * @param responseFiles The file of the responses of each chunk.
+   */
+  FileChunkSource(std::vector<std::string> predictorFiles,
+                  std::vector<std::string> responseFiles);
+
+  //! Get the number of chunks.
+  size_t NumChunks() const { return predictorFiles.size(); }
+
+  /**
+   * Load the given chunk.  A std::runtime_error is thrown if a file can't be
+   * loaded.
+   *
+   * @param chunk Index of the chunk.
+   * @param predictors Matrix to load the predictors into.
+   * @param responses Matrix to load the responses into.
+   */
+  void Load(const size_t chunk, arma::mat& predictors, arma::mat& responses);
+
+ private:
+  //! The file of the predictors of each chunk.
+  std::vector<std::string> predictorFiles;
+  //! The file of the responses of each chunk.
+  std::vector<std::string> responseFiles;
+};
+
+/**
+ * A chunk source that decodes groups of image files with data::Load(): chunk i
+ * holds the images chunkSize * i to chunkSize * (i + 1) - 1, one image per
+ * column, with the matching columns of the responses.  An optional
+ * augmentation function is applied to the decoded images of each chunk; like
+ * the decoding, it runs on the background thread of the loader.
+ */
+class ImageChunkSource
+{
+ public:
+  /**
+   * Create the source from the given images.
+   *
+   * @param files The image files.
+   * @param responses The responses of the images, one per column.
+   * @param info Information about the images (width, height and channels).
+   * @param chunkSize Number of images of each chunk.
+   * @param augmentation Function applied to the decoded images of each chunk,
+   *     or an empty function.
+   */
+  ImageChunkSource(std::vector<std::string> files,
+                   arma::mat responses,
+                   const ImageInfo& info,
+                   const size_t chunkSize,
+                   std::function<void(arma::mat&)> augmentation =
+                       std::function<void(arma::mat&)>());
+
+  //! Get the number of chunks.
+  size_t NumChunks() const
+  {
+    return (files.size() + chunkSize - 1) / chunkSize;
+  }
+
+  /**
+   * Decode and augment the images of the given chunk.  A std::runtime_error
+   * is thrown if an image can't be loaded.
+   *
+   * @param chunk Index of the chunk.
+   * @param predictors Matrix to decode the images into.
+   * @param responses Matrix to store the responses of the images into.
+   */
+  void Load(const size_t chunk, arma::mat& predictors, arma::mat& responses);
+
+ private:
+  //! The image files.
+  std::vector<std::string> files;
+  //! The responses of the images.
+  arma::mat responses;
+  //! Information about the images.
+  ImageInfo info;
+  //! The number of images of each chunk.
+  size_t chunkSize;
+  //! The augmentation applied to each chunk.
+  std::function<void(arma::mat&)> augmentation;
+};
+
+/**
+ * A chunk source that reads the columns of matrices stored with SaveMapped(),
+ * through a MappedMatrix: the data of each file is split into chunks of
+ * chunkSize consecutive columns (the last chunk of a file may be smaller), and
+ * the chunk is copied from the mapped pages when it is loaded.  The files are
+ * never read into memory as a whole, so the memory used by a PrefetchLoader
+ * over this source is bounded by its depth times the size of a chunk, no
+ * matter how big the files are.  The responses of the chunks are empty.
+ *
+ * A large dataset can be converted to this format shard by shard:
+ *
+ * @code
+ * arma::mat shard;
+ * data::Load("ratings-00001.csv", shard, true);
+ * data::SaveMapped("ratings-00001.bin", shard, true);
+ * @endcode
+ */
+class MappedChunkSource
+{
+ public:
+  /**
+   * Map the given files.  A std::runtime_error is thrown if a file can't be
+   * mapped, and a std::invalid_argument if the files don't have the same
+   * number of rows.
+   *
+   * @param files The files written by SaveMapped(), with double elements.
+   * @param chunkSize Number of columns of each chunk.
+   */
+  MappedChunkSource(const std::vector<std::string>& files,
+                    const size_t chunkSize);
+
+  //! Get the number of chunks.
+  size_t NumChunks() const { return chunks.size(); }
+
+  //! Get the total number of columns of the files.
+  size_t NumColumns() const { return numColumns; }
+
+  /**
+   * Copy the columns of the given chunk.
+   *
+   * @param chunk Index of the chunk.
+   * @param predictors Matrix to copy the columns into.
+   * @param responses Set to an empty matrix.
+   */
+  void Load(const size_t chunk, arma::mat& predictors, arma::mat& responses);
+
+ private:
+  //! The mapped files; they are shared by the copies of the source.
+  std::vector<std::shared_ptr<MappedMatrix<double>>> files;
+  //! The file and the first column of each chunk.
+  std::vector<std::pair<size_t, size_t>> chunks;
+  //! The number of columns of each chunk.
+  size_t chunkSize;
+  //! The total number of columns of the files.
+  size_t numColumns;
+};
+
+/**
+ * The PrefetchLoader reads the chunks of a dataset that doesn't fit in memory
+ * from a chunk source, on a background thread: while the chunk returned by
+ * Next() is used, the following chunks are loaded, decoded and augmented, and
+ * up to Depth() of them are kept ready.  With the default depth, the chunks
+ * are double-buffered.  FFN::Train() accepts a PrefetchLoader to train on each
+ * chunk in turn.
+ *
+ * @code
+ * data::FileChunkSource source(predictorFiles, responseFiles);
+ * data::PrefetchLoader<data::FileChunkSource> loader(source);
+ *
+ * arma::mat predictors, responses;
+ * while (loader.Next(predictors, responses))
+ * {
+ *   // ... use the chunk; the next ones are loaded meanwhile ...
+ * }
+ * @endcode
+ *
+ * An error thrown by the source on the background thread is thrown again by
+ * the call to Next() that would have returned the failed chunk.
+ *
+ * @tparam SourceType The chunk source; it must provide 'size_t NumChunks()
+ *     const' and 'void Load(const size_t chunk, arma::mat& predictors,
+ *     arma::mat& responses)', which is only called from the background thread.
+ */
+template<typename SourceType>
+class PrefetchLoader
+{
+ public:
+  /**
+   * Create the loader and start loading the first chunks.
+   *
+   * @param source The source of the chunks.
+   * @param depth Number of loaded chunks kept ready.
+   * @param shuffle Whether to visit the chunks in a new random order on each
+   *     pass.
+   */
+  PrefetchLoader(SourceType source,
+                 const size_t depth = 2,
+                 const bool shuffle = false);
+
+  // The background thread uses the loader.
+  PrefetchLoader(const PrefetchLoader& other) = delete;
+  PrefetchLoader& operator=(const PrefetchLoader& other) = delete;
+
+  //! Stop the background thread.
+  ~PrefetchLoader() { Stop(); }
+
+  /**
+   * Get the next chunk, waiting until it is loaded.  Returns false and leaves
+   * the matrices untouched once all the chunks of the pass were returned.
+   *
+   * @param predictors Matrix to store the predictors of the chunk into.
+   * @param responses Matrix to store the responses of the chunk into.
+   */
+  bool Next(arma::mat& predictors, arma::mat& responses);
+
+  //! Start a new pass over the chunks, discarding the chunks already loaded.
+  void Reset();
+
+  //! Get the number of chunks of each pass.
+  size_t NumChunks() const { return order.size(); }
+
+  //! Get the number of loaded chunks kept ready.
+  size_t Depth() const { return depth; }
+
+ private:
+  //! Start the background thread on a new pass.
+  void Start();
+
+  //! Stop the background thread and discard the loaded chunks.
+  void Stop();
+
+  //! Load the chunks of the pass; this runs on the background thread.
+  void Work();
+
+  //! The source of the chunks.
+  SourceType source;
+  //! The number of loaded chunks kept ready.
+  size_t depth;
+  //! Whether to shuffle the chunks on each pass.
+  bool shuffle;
+
+  //! The order of the chunks in the current pass.
+  std::vector<size_t> order;
+  //! The loaded chunks, in order.
+  std::deque<std::pair<arma::mat, arma::mat>> ready;
+  //! Whether the background thread has loaded all the chunks of the pass.
+  bool finished;
+  //! Whether the background thread must stop.
+  bool stop;
+  //! The error thrown by the source, if any.
+  std::exception_ptr error;
+
+  //! The lock of the loaded chunks and the flags.
+  std::mutex lock;
+  //! Signaled when a chunk is loaded or the pass is finished.
+  std::condition_variable readyCondition;
+  //! Signaled when a chunk is taken or the thread must stop.
+  std::condition_variable spaceCondition;
+  //! The background thread.
+  std::thread worker;
+};
+
+} // namespace data
+} // namespace mlpack
+
+// Include implementation.
+#include "prefetch_loader_impl.hpp"
+
+#endif
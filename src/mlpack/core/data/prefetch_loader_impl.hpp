@@ -0,0 +1,262 @@
+/**
+ * @file core/data/prefetch_loader_impl.hpp
+ *
+ * Implementation of PrefetchLoader and of the chunk sources.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_PREFETCH_LOADER_IMPL_HPP
+#define MLPACK_CORE_DATA_PREFETCH_LOADER_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "prefetch_loader.hpp"
+
+namespace mlpack {
+namespace data {
+
+inline FileChunkSource::FileChunkSource(
+    std::vector<std::string> predictorFiles,
+    std::vector<std::string> responseFiles) :
+    predictorFiles(std::move(predictorFiles)),
+    responseFiles(std::move(responseFiles))
+{
+  if (this->predictorFiles.size() != this->responseFiles.size())
+  {
+    throw std::invalid_argument("FileChunkSource::FileChunkSource(): there "
+        "must be one response file per predictor file!");
+  }
+}
+
+inline void FileChunkSource::Load(const size_t chunk,
+                                  arma::mat& predictors,
+                                  arma::mat& responses)
+{
+  data::Load(predictorFiles[chunk], predictors, true);
+  data::Load(responseFiles[chunk], responses, true);
+
+  if (predictors.n_cols != responses.n_cols)
+  {
+    throw std::runtime_error("FileChunkSource::Load(): '" +
+        predictorFiles[chunk] + "' and '" + responseFiles[chunk] + "' don't "
+        "have the same number of points!");
+  }
+}
+
+inline ImageChunkSource::ImageChunkSource(
+    std::vector<std::string> files,
+    arma::mat responses,
+    const ImageInfo& info,
+    const size_t chunkSize,
+    std::function<void(arma::mat&)> augmentation) :
+    files(std::move(files)),
+    responses(std::move(responses)),
+    info(info),
+    chunkSize(chunkSize),
+    augmentation(std::move(augmentation))
+{
+  if (chunkSize == 0)
+  {
+    throw std::invalid_argument("ImageChunkSource::ImageChunkSource(): the "
+        "chunk size must be positive!");
+  }
+
+  if (this->files.size() != this->responses.n_cols)
+  {
+    throw std::invalid_argument("ImageChunkSource::ImageChunkSource(): there "
+        "must be one response per image!");
+  }
+}
+
+inline void ImageChunkSource::Load(const size_t chunk,
+                                   arma::mat& predictors,
+                                   arma::mat& responses)
+{
+  const size_t first = chunk * chunkSize;
+  const size_t last = std::min(first + chunkSize, files.size()) - 1;
+
+  const std::vector<std::string> chunkFiles(files.begin() + first,
+      files.begin() + last + 1);
+  ImageInfo chunkInfo(info);
+  data::Load(chunkFiles, predictors, chunkInfo, true);
+  responses = this->responses.cols(first, last);
+
+  if (augmentation)
+    augmentation(predictors);
+}
+
+inline MappedChunkSource::MappedChunkSource(
+    const std::vector<std::string>& files,
+    const size_t chunkSize) :
+    chunkSize(chunkSize),
+    numColumns(0)
+{
+  if (chunkSize == 0)
+  {
+    throw std::invalid_argument("MappedChunkSource::MappedChunkSource(): the "
+        "chunk size must be positive!");
+  }
+
+  for (size_t f = 0; f < files.size(); ++f)
+  {
+    this->files.push_back(std::make_shared<MappedMatrix<double>>(files[f]));
+    const arma::mat& matrix = this->files.back()->Matrix();
+    if (matrix.n_rows != this->files.front()->Matrix().n_rows)
+    {
+      throw std::invalid_argument("MappedChunkSource::MappedChunkSource(): '" +
+          files[f] + "' doesn't have the same number of rows as '" + files[0] +
+          "'!");
+    }
+
+    for (size_t c = 0; c < matrix.n_cols; c += chunkSize)
+      chunks.push_back(std::make_pair(f, c));
+    numColumns += matrix.n_cols;
+  }
+}
+
+inline void MappedChunkSource::Load(const size_t chunk,
+                                    arma::mat& predictors,
+                                    arma::mat& responses)
+{
+  const arma::mat& matrix = files[chunks[chunk].first]->Matrix();
+  const size_t first = chunks[chunk].second;
+  const size_t last = std::min(first + chunkSize, (size_t) matrix.n_cols) - 1;
+
+  predictors = matrix.cols(first, last);
+  responses.reset();
+}
+
+template<typename SourceType>
+PrefetchLoader<SourceType>::PrefetchLoader(SourceType source,
+                                           const size_t depth,
+                                           const bool shuffle) :
+    source(std::move(source)),
+    depth(depth),
+    shuffle(shuffle),
+    finished(false),
+    stop(false)
+{
+  if (depth == 0)
+  {
+    throw std::invalid_argument("PrefetchLoader::PrefetchLoader(): the depth "
+        "must be positive!");
+  }
+
+  Start();
+}
+
+template<typename SourceType>
+bool PrefetchLoader<SourceType>::Next(arma::mat& predictors,
+                                      arma::mat& responses)
+{
+  std::unique_lock<std::mutex> guard(lock);
+  readyCondition.wait(guard, [this]() { return !ready.empty() || finished; });
+
+  if (ready.empty())
+  {
+    if (error)
+    {
+      std::exception_ptr sourceError = error;
+      error = nullptr;
+      std::rethrow_exception(sourceError);
+    }
+
+    return false;
+  }
+
+  predictors = std::move(ready.front().first);
+  responses = std::move(ready.front().second);
+  ready.pop_front();
+  spaceCondition.notify_one();
+  return true;
+}
+
+template<typename SourceType>
+void PrefetchLoader<SourceType>::Reset()
+{
+  Stop();
+  Start();
+}
+
+template<typename SourceType>
+void PrefetchLoader<SourceType>::Start()
+{
+  const size_t numChunks = source.NumChunks();
+  order.resize(numChunks);
+  if (shuffle)
+  {
+    arma::uvec permutation = arma::randperm(numChunks);
+    for (size_t i = 0; i < numChunks; ++i)
+      order[i] = permutation[i];
+  }
+  else
+  {
+    for (size_t i = 0; i < numChunks; ++i)
+      order[i] = i;
+  }
+
+  finished = false;
+  stop = false;
+  error = nullptr;
+  worker = std::thread(&PrefetchLoader::Work, this);
+}
+
+template<typename SourceType>
+void PrefetchLoader<SourceType>::Stop()
+{
+  {
+    std::lock_guard<std::mutex> guard(lock);
+    stop = true;
+  }
+  spaceCondition.notify_one();
+
+  if (worker.joinable())
+    worker.join();
+
+  ready.clear();
+}
+
+template<typename SourceType>
+void PrefetchLoader<SourceType>::Work()
+{
+  for (size_t i = 0; i < order.size(); ++i)
+  {
+    {
+      std::lock_guard<std::mutex> guard(lock);
+      if (stop)
+        return;
+    }
+
+    arma::mat predictors, responses;
+    try
+    {
+      source.Load(order[i], predictors, responses);
+    }
+    catch (...)
+    {
+      std::lock_guard<std::mutex> guard(lock);
+      error = std::current_exception();
+      break;
+    }
+
+    std::unique_lock<std::mutex> guard(lock);
+    spaceCondition.wait(guard, [this]() {
+        return stop || ready.size() < depth; });
+    if (stop)
+      return;
+
+    ready.emplace_back(std::move(predictors), std::move(responses));
+    readyCondition.notify_one();
+  }
+
+  std::lock_guard<std::mutex> guard(lock);
+  finished = true;
+  readyCondition.notify_one();
+}
+
+} // namespace data
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,137 @@
+/**
+ * @file core/data/preprocessing_pipeline.hpp
+ *
+ * Definition of PreprocessingPipeline, which chains imputation, scaling and
+ * one-hot encoding of a dataset.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_PREPROCESSING_PIPELINE_HPP
+#define MLPACK_CORE_DATA_PREPROCESSING_PIPELINE_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "one_hot_encoding.hpp"
+
+namespace mlpack {
+namespace data {
+
+/**
+ * A PreprocessingPipeline runs the usual preprocessing steps on a dataset in
+ * one call, without writing out the intermediate datasets:
+ *
+ *  1. the missing values of the given dimensions are imputed with an
+ *     imputation strategy (e.g. MeanImputation<double>);
+ *  2. the dimensions that are not one-hot encoded are fit and scaled with a
+ *     scaler (e.g. StandardScaler);
+ *  3. the given dimensions are one-hot encoded, into either a dense or a
+ *     sparse matrix.
+ *
+ * The categorical dimensions are not scaled, so their values still identify
+ * their categories when they are encoded.
+ *
+ * @code
+ * arma::mat dataset; // Missing values are NaN; dimension 3 is categorical.
+ * data::PreprocessingPipeline<data::MeanImputation<double>,
+ *     data::StandardScaler> pipeline(arma::Col<size_t>("0 1"),
+ *     arma::Col<size_t>("3"));
+ *
+ * arma::sp_mat output;
+ * pipeline.Apply(dataset, output);
+ * @endcode
+ *
+ * @tparam ImputationType Imputation strategy, with the interface of the
+ *     strategies in core/data/imputation_methods/.
+ * @tparam ScalerType Scaler, with the interface of the scalers in
+ *     core/data/scaler_methods/.
+ */
+template<typename ImputationType, typename ScalerType>
+class PreprocessingPipeline
+{
+ public:
+  /**
+   * Create the pipeline.
+   *
+   * @param imputeDimensions Dimensions in which missing values are imputed.
+   * @param encodeDimensions Dimensions to one-hot encode.
+   * @param missingValue Value that marks missing values (NaN is always
+   *     treated as missing).
+   * @param scale Whether to scale the dimensions that are not encoded.
+   * @param imputation Instantiated imputation strategy.
+   * @param scaler Instantiated scaler.
+   */
+  PreprocessingPipeline(
+      const arma::Col<size_t>& imputeDimensions = arma::Col<size_t>(),
+      const arma::Col<size_t>& encodeDimensions = arma::Col<size_t>(),
+      const double missingValue = std::numeric_limits<double>::quiet_NaN(),
+      const bool scale = true,
+      ImputationType imputation = ImputationType(),
+      ScalerType scaler = ScalerType());
+
+  /**
+   * Run the pipeline on the given dataset.  The imputation is done in place
+   * (so strategies like ListwiseDeletion may remove points of the dataset), the
+   * scaler is fit on the scaled dimensions, and the encoded result is stored in
+   * output.
+   *
+   * @param input Dataset to preprocess; it holds the imputed (but not scaled)
+   *     data afterwards.
+   * @param output Preprocessed dataset (arma::mat or arma::sp_mat).
+   */
+  template<typename OutputType>
+  void Apply(arma::mat& input, OutputType& output);
+
+  //! Get the dimensions in which missing values are imputed.
+  const arma::Col<size_t>& ImputeDimensions() const { return imputeDimensions; }
+  //! Modify the dimensions in which missing values are imputed.
+  arma::Col<size_t>& ImputeDimensions() { return imputeDimensions; }
+
+  //! Get the dimensions to one-hot encode.
+  const arma::Col<size_t>& EncodeDimensions() const { return encodeDimensions; }
+  //! Modify the dimensions to one-hot encode.
+  arma::Col<size_t>& EncodeDimensions() { return encodeDimensions; }
+
+  //! Get the value that marks missing values.
+  double MissingValue() const { return missingValue; }
+  //! Modify the value that marks missing values.
+  double& MissingValue() { return missingValue; }
+
+  //! Get whether the dimensions that are not encoded are scaled.
+  bool Scale() const { return scale; }
+  //! Modify whether the dimensions that are not encoded are scaled.
+  bool& Scale() { return scale; }
+
+  //! Get the imputation strategy.
+  const ImputationType& Imputation() const { return imputation; }
+  //! Modify the imputation strategy.
+  ImputationType& Imputation() { return imputation; }
+
+  //! Get the scaler (which is fit by Apply()).
+  const ScalerType& Scaler() const { return scaler; }
+  //! Modify the scaler.
+  ScalerType& Scaler() { return scaler; }
+
+ private:
+  //! The dimensions in which missing values are imputed.
+  arma::Col<size_t> imputeDimensions;
+  //! The dimensions to one-hot encode.
+  arma::Col<size_t> encodeDimensions;
+  //! The value that marks missing values.
+  double missingValue;
+  //! Whether the dimensions that are not encoded are scaled.
+  bool scale;
+  //! The imputation strategy.
+  ImputationType imputation;
+  //! The scaler.
+  ScalerType scaler;
+};
+
+} // namespace data
+} // namespace mlpack
+
+// Include implementation.
+#include "preprocessing_pipeline_impl.hpp"
+
+#endif
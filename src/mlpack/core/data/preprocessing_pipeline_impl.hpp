@@ -0,0 +1,117 @@
+/**
+ * @file core/data/preprocessing_pipeline_impl.hpp
+ *
+ * Implementation of PreprocessingPipeline.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_PREPROCESSING_PIPELINE_IMPL_HPP
+#define MLPACK_CORE_DATA_PREPROCESSING_PIPELINE_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "preprocessing_pipeline.hpp"
+
+namespace mlpack {
+namespace data {
+
+template<typename ImputationType, typename ScalerType>
+PreprocessingPipeline<ImputationType, ScalerType>::PreprocessingPipeline(
+    const arma::Col<size_t>& imputeDimensions,
+    const arma::Col<size_t>& encodeDimensions,
+    const double missingValue,
+    const bool scale,
+    ImputationType imputation,
+    ScalerType scaler) :
+    imputeDimensions(imputeDimensions),
+    encodeDimensions(encodeDimensions),
+    missingValue(missingValue),
+    scale(scale),
+    imputation(std::move(imputation)),
+    scaler(std::move(scaler))
+{
+  // Nothing to do.
+}
+
+template<typename ImputationType, typename ScalerType>
+template<typename OutputType>
+void PreprocessingPipeline<ImputationType, ScalerType>::Apply(
+    arma::mat& input,
+    OutputType& output)
+{
+  std::vector<size_t> dimensions(imputeDimensions.n_elem);
+  for (size_t i = 0; i < imputeDimensions.n_elem; ++i)
+  {
+    if (imputeDimensions[i] >= input.n_rows)
+    {
+      std::ostringstream oss;
+      oss << "PreprocessingPipeline::Apply(): cannot impute dimension "
+          << imputeDimensions[i] << " of a dataset with " << input.n_rows
+          << " dimensions!";
+      throw std::invalid_argument(oss.str());
+    }
+
+    dimensions[i] = imputeDimensions[i];
+  }
+
+  // Impute all the dimensions together; each may only be given once.
+  std::sort(dimensions.begin(), dimensions.end());
+  dimensions.erase(std::unique(dimensions.begin(), dimensions.end()),
+      dimensions.end());
+  if (!dimensions.empty())
+  {
+    const std::vector<double> missingValues(dimensions.size(), missingValue);
+    imputation.Impute(input, missingValues, dimensions);
+  }
+
+  // Find the dimensions that are not encoded.
+  std::vector<bool> encoded(input.n_rows, false);
+  for (size_t i = 0; i < encodeDimensions.n_elem; ++i)
+  {
+    if (encodeDimensions[i] >= input.n_rows)
+    {
+      std::ostringstream oss;
+      oss << "PreprocessingPipeline::Apply(): cannot encode dimension "
+          << encodeDimensions[i] << " of a dataset with " << input.n_rows
+          << " dimensions!";
+      throw std::invalid_argument(oss.str());
+    }
+
+    encoded[encodeDimensions[i]] = true;
+  }
+
+  std::vector<arma::uword> numericDimensions;
+  for (size_t d = 0; d < input.n_rows; ++d)
+    if (!encoded[d])
+      numericDimensions.push_back(d);
+
+  if (!scale || numericDimensions.empty())
+  {
+    OneHotEncoding(input, encodeDimensions, output);
+    return;
+  }
+
+  // Scale a copy of the numeric dimensions, so that input keeps the imputed
+  // data, and encode straight from it.
+  const arma::uvec numericRows(numericDimensions);
+  arma::mat scaled = input;
+  const arma::mat numeric = input.rows(numericRows);
+  arma::mat scaledNumeric;
+  scaler.Fit(numeric);
+  scaler.Transform(numeric, scaledNumeric);
+  if (scaledNumeric.n_rows != numeric.n_rows)
+  {
+    throw std::invalid_argument("PreprocessingPipeline::Apply(): the scaler "
+        "must not change the number of dimensions!");
+  }
+  scaled.rows(numericRows) = scaledNumeric;
+
+  OneHotEncoding(scaled, encodeDimensions, output);
+}
+
+} // namespace data
+} // namespace mlpack
+
+#endif
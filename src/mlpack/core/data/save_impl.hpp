@@ -16,6 +16,7 @@
 #include "save.hpp"
 #include "extension.hpp"
 #include "detect_file_type.hpp"
+#include "portable_binary_archive.hpp"
 
 #include <boost/serialization/serialization.hpp>
 #include <boost/archive/xml_oarchive.hpp>
@@ -276,16 +277,18 @@ bool Save(const std::string& filename,
       f = format::xml;
     else if (extension == "bin")
       f = format::binary;
+    else if (extension == "pbin")
+      f = format::portable_binary;
     else if (extension == "txt")
       f = format::text;
     else
     {
       if (fatal)
         Log::Fatal << "Unable to detect type of '" << filename << "'; incorrect"
-            << " extension? (allowed: xml/bin/txt)" << std::endl;
+            << " extension? (allowed: xml/bin/pbin/txt)" << std::endl;
       else
         Log::Warn << "Unable to detect type of '" << filename << "'; save "
-            << "failed.  Incorrect extension? (allowed: xml/bin/txt)"
+            << "failed.  Incorrect extension? (allowed: xml/bin/pbin/txt)"
             << std::endl;
 
       return false;
@@ -293,15 +296,17 @@ bool Save(const std::string& filename,
   }
 
   // Open the file to save to.
+  // Portable binary archives need binary mode on every platform, and binary
+  // archives need it on Windows.
   std::ofstream ofs;
+  std::ios::openmode mode = std::ofstream::out;
+  if (f == format::portable_binary)
+    mode |= std::ofstream::binary;
 #ifdef _WIN32
-  if (f == format::binary) // Open non-text types in binary mode on Windows.
-    ofs.open(filename, std::ofstream::out | std::ofstream::binary);
-  else
-    ofs.open(filename, std::ofstream::out);
-#else
-  ofs.open(filename, std::ofstream::out);
+  if (f == format::binary)
+    mode |= std::ofstream::binary;
 #endif
+  ofs.open(filename, mode);
 
   if (!ofs.is_open())
   {
@@ -332,6 +337,11 @@ bool Save(const std::string& filename,
       boost::archive::binary_oarchive ar(ofs);
       ar << boost::serialization::make_nvp(name.c_str(), t);
     }
+    else if (f == format::portable_binary)
+    {
+      PortableBinaryOArchive ar(ofs);
+      ar << boost::serialization::make_nvp(name.c_str(), t);
+    }
 
     return true;
   }
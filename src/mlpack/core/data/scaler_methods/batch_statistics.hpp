@@ -0,0 +1,240 @@
+/**
+ * @file core/data/scaler_methods/batch_statistics.hpp
+ *
+ * Helper functions for the scalers: per-dimension statistics that are computed
+ * in one parallel pass and can be updated one batch at a time, and a parallel
+ * element-wise transformation.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_SCALER_METHODS_BATCH_STATISTICS_HPP
+#define MLPACK_CORE_DATA_SCALER_METHODS_BATCH_STATISTICS_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace data {
+namespace scaler {
+
+/**
+ * Merge the count, mean and sum of squared deviations from the mean (M2) of
+ * one set of points with those of another set, giving the statistics of the
+ * union (Chan et al.'s pairwise update).  The merged statistics are stored in
+ * the first set.
+ */
+inline void MergeMoments(size_t& count,
+                         double& mean,
+                         double& m2,
+                         const size_t otherCount,
+                         const double otherMean,
+                         const double otherM2)
+{
+  if (otherCount == 0)
+    return;
+
+  const size_t total = count + otherCount;
+  const double delta = otherMean - mean;
+  mean += delta * otherCount / total;
+  m2 += otherM2 + delta * delta * ((double) count * otherCount / total);
+  count = total;
+}
+
+/**
+ * Update the statistics of each dimension with the points of the given batch:
+ * the number of points, the mean, the sum of squared deviations from the mean
+ * (so the variance is m2 / count), the minimum and the maximum.  If count is
+ * 0, the statistics are initialized from the batch.
+ *
+ * The batch is split into one block of points per thread; each thread computes
+ * the statistics of its block with Welford's algorithm in a single pass, and
+ * the blocks are then merged.  A std::invalid_argument is thrown if the batch
+ * has a different dimensionality than the points seen before.
+ *
+ * @param batch Points to add, one per column.
+ * @param count Number of points seen so far.
+ * @param mean Mean of each dimension.
+ * @param m2 Sum of squared deviations from the mean of each dimension.
+ * @param min Minimum of each dimension.
+ * @param max Maximum of each dimension.
+ */
+template<typename MatType>
+void UpdateStatistics(const MatType& batch,
+                      size_t& count,
+                      arma::vec& mean,
+                      arma::vec& m2,
+                      arma::vec& min,
+                      arma::vec& max)
+{
+  const size_t d = batch.n_rows;
+  const size_t n = batch.n_cols;
+  if (count > 0 && mean.n_elem != d)
+  {
+    std::ostringstream oss;
+    oss << "Cannot fit a batch with " << d << " dimensions after batches "
+        << "with " << mean.n_elem << " dimensions!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  if (n == 0)
+    return;
+
+  if (count == 0)
+  {
+    mean.zeros(d);
+    m2.zeros(d);
+    min.set_size(d);
+    min.fill(std::numeric_limits<double>::infinity());
+    max.set_size(d);
+    max.fill(-std::numeric_limits<double>::infinity());
+  }
+
+  size_t numBlocks = 1;
+  #ifdef HAS_OPENMP
+  numBlocks = std::max(size_t(1), std::min(n, size_t(omp_get_max_threads())));
+  #endif
+
+  arma::mat blockMean(d, numBlocks, arma::fill::zeros);
+  arma::mat blockM2(d, numBlocks, arma::fill::zeros);
+  arma::mat blockMin(d, numBlocks);
+  blockMin.fill(std::numeric_limits<double>::infinity());
+  arma::mat blockMax(d, numBlocks);
+  blockMax.fill(-std::numeric_limits<double>::infinity());
+
+  #pragma omp parallel for schedule(static, 1)
+  for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+  {
+    const size_t begin = b * n / numBlocks;
+    const size_t end = (b + 1) * n / numBlocks;
+    double* bMean = blockMean.colptr(b);
+    double* bM2 = blockM2.colptr(b);
+    double* bMin = blockMin.colptr(b);
+    double* bMax = blockMax.colptr(b);
+    for (size_t i = begin; i < end; ++i)
+    {
+      const double k = double(i - begin + 1);
+      for (size_t r = 0; r < d; ++r)
+      {
+        const double x = batch(r, i);
+        const double delta = x - bMean[r];
+        bMean[r] += delta / k;
+        bM2[r] += delta * (x - bMean[r]);
+        bMin[r] = std::min(bMin[r], x);
+        bMax[r] = std::max(bMax[r], x);
+      }
+    }
+  }
+
+  // Merge the blocks (in order) into the running statistics.
+  const size_t oldCount = count;
+  for (size_t r = 0; r < d; ++r)
+  {
+    size_t c = oldCount;
+    for (size_t b = 0; b < numBlocks; ++b)
+    {
+      const size_t blockCount = (b + 1) * n / numBlocks - b * n / numBlocks;
+      MergeMoments(c, mean[r], m2[r], blockCount, blockMean(r, b),
+          blockM2(r, b));
+      min[r] = std::min(min[r], blockMin(r, b));
+      max[r] = std::max(max[r], blockMax(r, b));
+    }
+  }
+  count = oldCount + n;
+}
+
+/**
+ * Update the minimum and maximum of each dimension with the points of the
+ * given batch, in one parallel pass.  If min and max are empty, they are
+ * initialized from the batch.  A std::invalid_argument is thrown if the batch
+ * has a different dimensionality than the points seen before.
+ *
+ * @param batch Points to add, one per column.
+ * @param min Minimum of each dimension.
+ * @param max Maximum of each dimension.
+ */
+template<typename MatType>
+void UpdateRange(const MatType& batch, arma::vec& min, arma::vec& max)
+{
+  const size_t d = batch.n_rows;
+  const size_t n = batch.n_cols;
+  if (!min.is_empty() && min.n_elem != d)
+  {
+    std::ostringstream oss;
+    oss << "Cannot fit a batch with " << d << " dimensions after batches "
+        << "with " << min.n_elem << " dimensions!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  if (n == 0)
+    return;
+
+  if (min.is_empty())
+  {
+    min.set_size(d);
+    min.fill(std::numeric_limits<double>::infinity());
+    max.set_size(d);
+    max.fill(-std::numeric_limits<double>::infinity());
+  }
+
+  size_t numBlocks = 1;
+  #ifdef HAS_OPENMP
+  numBlocks = std::max(size_t(1), std::min(n, size_t(omp_get_max_threads())));
+  #endif
+
+  arma::mat blockMin(d, numBlocks);
+  blockMin.fill(std::numeric_limits<double>::infinity());
+  arma::mat blockMax(d, numBlocks);
+  blockMax.fill(-std::numeric_limits<double>::infinity());
+
+  #pragma omp parallel for schedule(static, 1)
+  for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+  {
+    double* bMin = blockMin.colptr(b);
+    double* bMax = blockMax.colptr(b);
+    for (size_t i = b * n / numBlocks; i < (b + 1) * n / numBlocks; ++i)
+    {
+      for (size_t r = 0; r < d; ++r)
+      {
+        const double x = batch(r, i);
+        bMin[r] = std::min(bMin[r], x);
+        bMax[r] = std::max(bMax[r], x);
+      }
+    }
+  }
+
+  min = arma::min(min, arma::vec(arma::min(blockMin, 1)));
+  max = arma::max(max, arma::vec(arma::max(blockMax, 1)));
+}
+
+/**
+ * Set output(r, i) = f(input(r, i), r) for every element, with the columns
+ * split between threads.  The input and the output may be the same matrix, in
+ * which case no memory is allocated.
+ *
+ * @param input Matrix to transform.
+ * @param output Matrix to store the result in.
+ * @param f Function to apply to each element and its dimension.
+ */
+template<typename MatType, typename FunctionType>
+void TransformElements(const MatType& input,
+                       MatType& output,
+                       const FunctionType& f)
+{
+  if (&input != &output)
+    output.set_size(input.n_rows, input.n_cols);
+
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t i = 0; i < (omp_size_t) input.n_cols; ++i)
+  {
+    for (size_t r = 0; r < input.n_rows; ++r)
+      output(r, i) = f(input(r, i), r);
+  }
+}
+
+} // namespace scaler
+} // namespace data
+} // namespace mlpack
+
+#endif
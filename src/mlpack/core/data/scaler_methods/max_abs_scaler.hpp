@@ -13,6 +13,7 @@
 #define MLPACK_CORE_DATA_MAX_ABS_SCALE_HPP
 
 #include <mlpack/prereqs.hpp>
+#include "batch_statistics.hpp"
 
 namespace mlpack {
 namespace data {
@@ -42,6 +43,8 @@ namespace data {
  * // Retransform the input.
  * scale.InverseTransform(output, input);
  * @endcode
+ *
+ * The scaler can also be fit one batch at a time with PartialFit().
  */
 class MaxAbsScaler
 {
@@ -54,8 +57,25 @@ class MaxAbsScaler
   template<typename MatType>
   void Fit(const MatType& input)
   {
-    itemMin = arma::min(input, 1);
-    itemMax = arma::max(input, 1);
+    itemMin.clear();
+    itemMax.clear();
+    PartialFit(input);
+  }
+
+  /**
+   * Update the min, max and scale with another batch of points, in a single
+   * pass over the batch.  If the scaler hasn't been fit yet, this is the same
+   * as Fit().
+   *
+   * @param input Batch of points to fit.
+   */
+  template<typename MatType>
+  void PartialFit(const MatType& input)
+  {
+    scaler::UpdateRange(input, itemMin, itemMax);
+    if (itemMin.is_empty())
+      return;
+
     scale = arma::max(arma::abs(itemMin), arma::abs(itemMax));
     // Handling zeros in scale vector.
     scale.for_each([](arma::vec::elem_type& val) { val =
@@ -76,10 +96,19 @@ class MaxAbsScaler
       throw std::runtime_error("Call Fit() before Transform(), please"
         " refer to the documentation.");
     }
-    output.copy_size(input);
-    output = input.each_col() / scale;
+    scaler::TransformElements(input, output,
+        [this](const double x, const size_t r) { return x / scale[r]; });
   }
 
+  /**
+   * Function to scale features in place.
+   *
+   * @param input Dataset to scale features; it is overwritten with the scaled
+   *     features.
+   */
+  template<typename MatType>
+  void Transform(MatType& input) { Transform(input, input); }
+
   /**
    * Function to retrieve original dataset.
    *
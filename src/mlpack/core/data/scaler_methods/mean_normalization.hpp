@@ -13,6 +13,7 @@
 #define MLPACK_CORE_DATA_MEAN_NORMALIZATION_HPP
 
 #include <mlpack/prereqs.hpp>
+#include "batch_statistics.hpp"
 
 namespace mlpack {
 namespace data {
@@ -42,10 +43,15 @@ namespace data {
  * // Retransform the input.
  * scale.InverseTransform(output, input);
  * @endcode
+ *
+ * The scaler can also be fit one batch at a time with PartialFit().
  */
 class MeanNormalization
 {
  public:
+  //! Create the scaler; Fit() or PartialFit() must be called before use.
+  MeanNormalization() : count(0) { }
+
   /**
    * Function to fit features, to find out the min max and scale.
    *
@@ -54,9 +60,26 @@ class MeanNormalization
   template<typename MatType>
   void Fit(const MatType& input)
   {
-    itemMean = arma::mean(input, 1);
-    itemMin = arma::min(input, 1);
-    itemMax = arma::max(input, 1);
+    count = 0;
+    PartialFit(input);
+  }
+
+  /**
+   * Update the mean, min, max and scale with another batch of points, in a
+   * single pass over the batch.  If the scaler hasn't been fit yet, this is the
+   * same as Fit().
+   *
+   * @param input Batch of points to fit.
+   */
+  template<typename MatType>
+  void PartialFit(const MatType& input)
+  {
+    // The variance isn't needed.
+    arma::vec m2(itemMean.n_elem, arma::fill::zeros);
+    scaler::UpdateStatistics(input, count, itemMean, m2, itemMin, itemMax);
+    if (count == 0)
+      return;
+
     scale = itemMax - itemMin;
     // Handling zeros in scale vector.
     scale.for_each([](arma::vec::elem_type& val) { val =
@@ -77,10 +100,20 @@ class MeanNormalization
       throw std::runtime_error("Call Fit() before Transform(), please"
         " refer to the documentation.");
     }
-    output.copy_size(input);
-    output = (input.each_col() - itemMean).each_col() / scale;
+    scaler::TransformElements(input, output,
+        [this](const double x, const size_t r)
+        { return (x - itemMean[r]) / scale[r]; });
   }
 
+  /**
+   * Function to scale features in place.
+   *
+   * @param input Dataset to scale features; it is overwritten with the scaled
+   *     features.
+   */
+  template<typename MatType>
+  void Transform(MatType& input) { Transform(input, input); }
+
   /**
    * Function to retrieve original dataset.
    *
@@ -103,16 +136,25 @@ class MeanNormalization
   //! Get the Scale row vector.
   const arma::vec& Scale() const { return scale; }
 
+  //! Get the number of points the scaler has been fit on.
+  size_t Count() const { return count; }
+
   template<typename Archive>
-  void serialize(Archive& ar, const unsigned int /* version */)
+  void serialize(Archive& ar, const unsigned int version)
   {
     ar & BOOST_SERIALIZATION_NVP(itemMin);
     ar & BOOST_SERIALIZATION_NVP(itemMax);
     ar & BOOST_SERIALIZATION_NVP(scale);
     ar & BOOST_SERIALIZATION_NVP(itemMean);
+    if (version > 0)
+      ar & BOOST_SERIALIZATION_NVP(count);
+    else if (Archive::is_loading::value)
+      count = 0; // Older models can't be updated; PartialFit() starts again.
   }
 
  private:
+  // Number of points the scaler has been fit on.
+  size_t count;
   // Vector which holds mean of each feature.
   arma::vec itemMean;
   // Vector which holds minimum of each feature.
@@ -126,4 +168,6 @@ class MeanNormalization
 } // namespace data
 } // namespace mlpack
 
+BOOST_CLASS_VERSION(mlpack::data::MeanNormalization, 1);
+
 #endif
@@ -43,6 +43,10 @@ namespace data {
  * // Retransform the input.
  * scale.InverseTransform(output, input);
  * @endcode
+ *
+ * The scaler can also be fit one batch at a time with PartialFit(); the
+ * covariance is then the same as if Fit() had been called on all the batches
+ * at once.
  */
 class PCAWhitening
 {
@@ -52,7 +56,7 @@ class PCAWhitening
    *
    * @param eps Regularization parameter.
    */
-  PCAWhitening(double eps = 0.00005)
+  PCAWhitening(double eps = 0.00005) : count(0)
   {
     epsilon = eps;
     // Ensure scaleMin is smaller than scaleMax.
@@ -70,10 +74,54 @@ class PCAWhitening
   template<typename MatType>
   void Fit(const MatType& input)
   {
-    itemMean = arma::mean(input, 1);
+    count = 0;
+    PartialFit(input);
+  }
+
+  /**
+   * Update the mean and covariance with another batch of points, and
+   * recompute the eigendecomposition.  If the scaler hasn't been fit yet, this
+   * is the same as Fit().  A std::invalid_argument is thrown if the batch has a
+   * different dimensionality than the points seen before.
+   *
+   * @param input Batch of points to fit.
+   */
+  template<typename MatType>
+  void PartialFit(const MatType& input)
+  {
+    if (count > 0 && input.n_rows != itemMean.n_elem)
+    {
+      std::ostringstream oss;
+      oss << "Cannot fit a batch with " << input.n_rows << " dimensions after "
+          << "batches with " << itemMean.n_elem << " dimensions!";
+      throw std::invalid_argument(oss.str());
+    }
+
+    if (input.n_cols == 0)
+      return;
+
+    const arma::vec batchMean = arma::mean(input, 1);
+    const arma::mat centered = input.each_col() - batchMean;
+    const arma::mat batchComoment = centered * centered.t();
+    if (count == 0)
+    {
+      itemMean = batchMean;
+      comoment = batchComoment;
+    }
+    else
+    {
+      // Merge the co-moments of the two sets of points.
+      const size_t total = count + input.n_cols;
+      const arma::vec delta = batchMean - itemMean;
+      comoment += batchComoment + (delta * delta.t()) *
+          ((double) count * input.n_cols / total);
+      itemMean += delta * ((double) input.n_cols / total);
+    }
+    count += input.n_cols;
+
     // Get eigenvectors and eigenvalues of covariance of input matrix.
-    eig_sym(eigenValues, eigenVectors, mlpack::math::ColumnCovariance(
-        input.each_col() - itemMean));
+    eig_sym(eigenValues, eigenVectors, arma::mat(comoment /
+        ((count > 1) ? double(count - 1) : 1.0)));
     eigenValues += epsilon;
   }
 
@@ -97,6 +145,15 @@ class PCAWhitening
         * output;
   }
 
+  /**
+   * Function to scale features in place.
+   *
+   * @param input Dataset to scale features; it is overwritten with the scaled
+   *     features.
+   */
+  template<typename MatType>
+  void Transform(MatType& input) { Transform(input, input); }
+
   /**
    * Function to retrieve original dataset.
    *
@@ -120,16 +177,34 @@ class PCAWhitening
   //! Get the regularization parameter.
   const double& Epsilon() const { return epsilon; }
 
+  //! Get the number of points the scaler has been fit on.
+  size_t Count() const { return count; }
+
   template<typename Archive>
-  void serialize(Archive& ar, const unsigned int /* version */)
+  void serialize(Archive& ar, const unsigned int version)
   {
     ar & BOOST_SERIALIZATION_NVP(eigenValues);
     ar & BOOST_SERIALIZATION_NVP(eigenVectors);
     ar & BOOST_SERIALIZATION_NVP(itemMean);
     ar & BOOST_SERIALIZATION_NVP(epsilon);
+    if (version > 0)
+    {
+      ar & BOOST_SERIALIZATION_NVP(count);
+      ar & BOOST_SERIALIZATION_NVP(comoment);
+    }
+    else if (Archive::is_loading::value)
+    {
+      // Older models can't be updated; PartialFit() starts again.
+      count = 0;
+      comoment.clear();
+    }
   }
 
  private:
+  // Number of points the scaler has been fit on.
+  size_t count;
+  // Sum of the outer products of the centered points.
+  arma::mat comoment;
   // Vector which holds mean of each feature.
   arma::vec itemMean;
   // Mat which hold the eigenvectors.
@@ -143,4 +218,6 @@ class PCAWhitening
 } // namespace data
 } // namespace mlpack
 
+BOOST_CLASS_VERSION(mlpack::data::PCAWhitening, 1);
+
 #endif
@@ -13,6 +13,7 @@
 #define MLPACK_CORE_DATA_STANDARD_SCALE_HPP
 
 #include <mlpack/prereqs.hpp>
+#include "batch_statistics.hpp"
 
 namespace mlpack {
 namespace data {
@@ -43,20 +44,46 @@ namespace data {
  * // Retransform the input.
  * scale.InverseTransform(output, input);
  * @endcode
+ *
+ * The scaler can also be fit one batch at a time with PartialFit(), so the
+ * whole dataset does not need to be in memory; the mean and the standard
+ * deviation are then the same as if Fit() had been called on all the batches
+ * at once.
  */
 class StandardScaler
 {
  public:
+  //! Create the scaler; Fit() or PartialFit() must be called before use.
+  StandardScaler() : count(0) { }
+
   /**
-   * Function to fit features, to find out the min max and scale.
+   * Function to fit features, to find out the mean and standard deviation.
    *
    * @param input Dataset to fit.
    */
   template<typename MatType>
   void Fit(const MatType& input)
   {
-    itemMean = arma::mean(input, 1);
-    itemStdDev = arma::stddev(input, 1, 1);
+    count = 0;
+    PartialFit(input);
+  }
+
+  /**
+   * Update the mean and standard deviation with another batch of points, in a
+   * single pass over the batch.  If the scaler hasn't been fit yet, this is the
+   * same as Fit().
+   *
+   * @param input Batch of points to fit.
+   */
+  template<typename MatType>
+  void PartialFit(const MatType& input)
+  {
+    arma::vec itemMin, itemMax;
+    scaler::UpdateStatistics(input, count, itemMean, itemM2, itemMin, itemMax);
+    if (count == 0)
+      return;
+
+    itemStdDev = arma::sqrt(itemM2 / count);
     // Handle zeros in scale vector.
     itemStdDev.for_each([](arma::vec::elem_type& val) { val =
         (val == 0) ? 1 : val; });
@@ -76,10 +103,20 @@ class StandardScaler
       throw std::runtime_error("Call Fit() before Transform(), please"
         " refer to the documentation.");
     }
-    output.copy_size(input);
-    output = (input.each_col() - itemMean).each_col() / itemStdDev;
+    scaler::TransformElements(input, output,
+        [this](const double x, const size_t r)
+        { return (x - itemMean[r]) / itemStdDev[r]; });
   }
 
+  /**
+   * Function to scale features in place.
+   *
+   * @param input Dataset to scale features; it is overwritten with the scaled
+   *     features.
+   */
+  template<typename MatType>
+  void Transform(MatType& input) { Transform(input, input); }
+
   /**
    * Function to retrieve original dataset.
    *
@@ -98,14 +135,33 @@ class StandardScaler
   //! Get the standard deviation row vector.
   const arma::vec& ItemStdDev() const { return itemStdDev; }
 
+  //! Get the number of points the scaler has been fit on.
+  size_t Count() const { return count; }
+
   template<typename Archive>
-  void serialize(Archive& ar, const unsigned int /* version */)
+  void serialize(Archive& ar, const unsigned int version)
   {
     ar & BOOST_SERIALIZATION_NVP(itemMean);
     ar & BOOST_SERIALIZATION_NVP(itemStdDev);
+    if (version > 0)
+    {
+      ar & BOOST_SERIALIZATION_NVP(count);
+      ar & BOOST_SERIALIZATION_NVP(itemM2);
+    }
+    else if (Archive::is_loading::value)
+    {
+      // Older models can't be updated; PartialFit() starts again.
+      count = 0;
+      itemM2.clear();
+    }
   }
 
  private:
+  // Number of points the scaler has been fit on.
+  size_t count;
+  // Vector which holds the sum of squared deviations from the mean of each
+  // feature.
+  arma::vec itemM2;
   // Vector which holds mean of each feature.
   arma::vec itemMean;
   // Vector which holds standard devation of each feature.
@@ -115,4 +171,6 @@ class StandardScaler
 } // namespace data
 } // namespace mlpack
 
+BOOST_CLASS_VERSION(mlpack::data::StandardScaler, 1);
+
 #endif
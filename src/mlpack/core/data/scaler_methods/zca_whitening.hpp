@@ -65,6 +65,18 @@ class ZCAWhitening
     pca.Fit(input);
   }
 
+  /**
+   * Update the mean and covariance with another batch of points.  If the
+   * scaler hasn't been fit yet, this is the same as Fit().
+   *
+   * @param input Batch of points to fit.
+   */
+  template<typename MatType>
+  void PartialFit(const MatType& input)
+  {
+    pca.PartialFit(input);
+  }
+
   /**
    * Function for ZCA whitening.
    *
@@ -78,6 +90,15 @@ class ZCAWhitening
     output = pca.EigenVectors() * output;
   }
 
+  /**
+   * Function for ZCA whitening in place.
+   *
+   * @param input Dataset to scale features; it is overwritten with the
+   *     whitened features.
+   */
+  template<typename MatType>
+  void Transform(MatType& input) { Transform(input, input); }
+
   /**
    * Function to retrieve original dataset.
    *
@@ -14,6 +14,7 @@
 #define MLPACK_CORE_DATA_SPLIT_DATA_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/math/random.hpp>
 
 namespace mlpack {
 namespace data {
@@ -224,6 +225,239 @@ Split(const arma::Mat<T>& input,
                          std::move(testData));
 }
 
+/**
+ * Given the number of points in a dataset, split their indices into a training
+ * set and a test set, without touching the data.  The training set and the
+ * test set are the same ones that Split() would give for the same random seed,
+ * so input.cols(trainIndices) is the training data that Split() would return.
+ * This is useful when the dataset (or several matrices that describe the same
+ * points) should not be copied.
+ *
+ * @code
+ * arma::mat input = loadData();
+ * arma::uvec trainIndices, testIndices;
+ * SplitIndices(input.n_cols, trainIndices, testIndices, 0.3);
+ * @endcode
+ *
+ * @param numPoints Number of points in the dataset.
+ * @param trainIndices Vector to store the indices of the training points into.
+ * @param testIndices Vector to store the indices of the test points into.
+ * @param testRatio Percentage of dataset to use for test set (between 0 and 1).
+ * @param shuffleData If true, the sample order is shuffled; otherwise, each
+ *       sample is visited in linear order. (Default true).
+ */
+inline void SplitIndices(const size_t numPoints,
+                         arma::uvec& trainIndices,
+                         arma::uvec& testIndices,
+                         const double testRatio,
+                         const bool shuffleData = true)
+{
+  const size_t testSize = static_cast<size_t>(numPoints * testRatio);
+  const size_t trainSize = numPoints - testSize;
+
+  if (numPoints == 0)
+  {
+    trainIndices.clear();
+    testIndices.clear();
+    return;
+  }
+
+  arma::uvec order = arma::linspace<arma::uvec>(0, numPoints - 1, numPoints);
+  if (shuffleData)
+    order = arma::shuffle(order);
+
+  trainIndices = (trainSize > 0) ? arma::uvec(order.subvec(0, trainSize - 1)) :
+      arma::uvec();
+  testIndices = (trainSize < numPoints) ?
+      arma::uvec(order.subvec(trainSize, numPoints - 1)) : arma::uvec();
+}
+
+namespace split {
+
+/**
+ * Shuffle the points of the dataset (and the labels, if given) in place with
+ * the Fisher-Yates algorithm, so that no copy of the dataset is made.
+ */
+template<typename T, typename U>
+void ShuffleColumns(arma::Mat<T>& input, arma::Row<U>* inputLabel)
+{
+  for (size_t i = input.n_cols; i > 1; --i)
+  {
+    const size_t j = std::uniform_int_distribution<size_t>(0, i - 1)(
+        math::randGen);
+    if (j != i - 1)
+    {
+      input.swap_cols(i - 1, j);
+      if (inputLabel)
+        std::swap((*inputLabel)[i - 1], (*inputLabel)[j]);
+    }
+  }
+}
+
+} // namespace split
+
+/**
+ * Given an input dataset and labels, split them into a training set and a test
+ * set in place: the points (and their labels) are shuffled (if shuffleData is
+ * true), and then the first columns of the dataset are the training set and
+ * the last ones are the test set.  The number of training points is returned.
+ * Unlike Split(), no copy of the dataset is made, so it can be used on
+ * datasets that take up most of the available memory; the two sets can be
+ * used without copies with subviews or with aliases:
+ *
+ * @code
+ * arma::mat input = loadData();
+ * arma::Row<size_t> label = loadLabel();
+ * const size_t trainSize = SplitInPlace(input, label, 0.3);
+ *
+ * // Matrices that use the memory of the input.
+ * arma::mat trainData(input.memptr(), input.n_rows, trainSize, false, true);
+ * arma::mat testData(input.memptr() + trainSize * input.n_rows, input.n_rows,
+ *     input.n_cols - trainSize, false, true);
+ * @endcode
+ *
+ * @param input Input dataset to split; its columns are reordered.
+ * @param inputLabel Input labels to split; they are reordered like the points.
+ * @param testRatio Percentage of dataset to use for test set (between 0 and 1).
+ * @param shuffleData If true, the sample order is shuffled; otherwise, the
+ *       dataset is not modified and the last points are the test set.
+ *       (Default true).
+ * @return The number of points in the training set.
+ */
+template<typename T, typename U>
+size_t SplitInPlace(arma::Mat<T>& input,
+                    arma::Row<U>& inputLabel,
+                    const double testRatio,
+                    const bool shuffleData = true)
+{
+  if (inputLabel.n_elem != input.n_cols)
+  {
+    std::ostringstream oss;
+    oss << "SplitInPlace(): number of labels (" << inputLabel.n_elem << ") "
+        << "does not match number of points (" << input.n_cols << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  if (shuffleData)
+    split::ShuffleColumns(input, &inputLabel);
+
+  return input.n_cols - static_cast<size_t>(input.n_cols * testRatio);
+}
+
+/**
+ * Given an input dataset, split it into a training set and a test set in
+ * place: the points are shuffled (if shuffleData is true), and then the first
+ * columns of the dataset are the training set and the last ones are the test
+ * set.  The number of training points is returned.  See the overload with
+ * labels for how to use the two sets without copies.
+ *
+ * @param input Input dataset to split; its columns are reordered.
+ * @param testRatio Percentage of dataset to use for test set (between 0 and 1).
+ * @param shuffleData If true, the sample order is shuffled; otherwise, the
+ *       dataset is not modified and the last points are the test set.
+ *       (Default true).
+ * @return The number of points in the training set.
+ */
+template<typename T>
+size_t SplitInPlace(arma::Mat<T>& input,
+                    const double testRatio,
+                    const bool shuffleData = true)
+{
+  if (shuffleData)
+    split::ShuffleColumns(input, (arma::Row<size_t>*) NULL);
+
+  return input.n_cols - static_cast<size_t>(input.n_cols * testRatio);
+}
+
+/**
+ * Given an input dataset and labels, split them into a training set and a test
+ * set in place, so that each class is split with the given ratio: if a class
+ * has n points, (size_t) (n * testRatio) of them are in the test set.  As with
+ * SplitInPlace(), the points and the labels are reordered so that the first
+ * columns are the training set and the last ones are the test set, and the
+ * number of training points is returned.  The labels must be in [0, numClasses).
+ *
+ * The points are reordered by swapping columns, so (even if shuffleData is
+ * false) the order of the points in each set is not preserved.
+ *
+ * @code
+ * arma::mat input = loadData();
+ * arma::Row<size_t> label = loadLabel();
+ * const size_t trainSize = StratifiedSplitInPlace(input, label, 0.3);
+ * @endcode
+ *
+ * @param input Input dataset to split; its columns are reordered.
+ * @param inputLabel Input labels to split; they are reordered like the points.
+ * @param testRatio Percentage of each class to use for test set (between 0 and
+ *       1).
+ * @param shuffleData If true, the points of each class in the test set are
+ *       chosen at random; otherwise, the last points of each class are in the
+ *       test set. (Default true).
+ * @return The number of points in the training set.
+ */
+template<typename T, typename U>
+size_t StratifiedSplitInPlace(arma::Mat<T>& input,
+                              arma::Row<U>& inputLabel,
+                              const double testRatio,
+                              const bool shuffleData = true)
+{
+  if (inputLabel.n_elem != input.n_cols)
+  {
+    std::ostringstream oss;
+    oss << "StratifiedSplitInPlace(): number of labels (" << inputLabel.n_elem
+        << ") does not match number of points (" << input.n_cols << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  if (input.n_cols == 0)
+    return 0;
+
+  if (shuffleData)
+    split::ShuffleColumns(input, &inputLabel);
+
+  // Count the points of each class; the last points (in the current order) of
+  // each class go to the test set.
+  const size_t numClasses = size_t(arma::max(inputLabel)) + 1;
+  std::vector<size_t> remaining(numClasses, 0);
+  for (size_t i = 0; i < inputLabel.n_elem; ++i)
+    ++remaining[size_t(inputLabel[i])];
+  for (size_t c = 0; c < numClasses; ++c)
+    remaining[c] -= static_cast<size_t>(remaining[c] * testRatio);
+
+  std::vector<bool> isTest(input.n_cols);
+  size_t trainSize = 0;
+  for (size_t i = 0; i < inputLabel.n_elem; ++i)
+  {
+    size_t& classRemaining = remaining[size_t(inputLabel[i])];
+    isTest[i] = (classRemaining == 0);
+    if (classRemaining > 0)
+    {
+      --classRemaining;
+      ++trainSize;
+    }
+  }
+
+  // Move the training points to the front by swapping the test points at the
+  // front with the training points at the back.
+  size_t front = 0, back = input.n_cols;
+  while (true)
+  {
+    while (front < back && !isTest[front])
+      ++front;
+    while (front < back && isTest[back - 1])
+      --back;
+    if (front >= back)
+      break;
+
+    input.swap_cols(front, back - 1);
+    std::swap(inputLabel[front], inputLabel[back - 1]);
+    ++front;
+    --back;
+  }
+
+  return trainSize;
+}
+
 } // namespace data
 } // namespace mlpack
 
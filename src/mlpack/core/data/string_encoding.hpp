@@ -99,6 +99,10 @@ class StringEncoding
    * writes it in the column-major order. If the output type is 2D std::vector
    * then the function writes it in the row major order.
    *
+   * The input is tokenized and encoded in parallel (with OpenMP); new tokens
+   * are still labeled in the order they first appear in the input. Sparse
+   * output is written straight into its compressed storage.
+   *
    * @tparam OutputType Type of the output container. The function supports
    *                    the following types: arma::mat, arma::sp_mat,
    *                    std::vector<std::vector<>>.
@@ -146,6 +150,10 @@ class StringEncoding
    * writes it in the column-major order. If the output type is 2D std::vector
    * then the function writes it in the row major order.
    *
+   * The input is tokenized and encoded in parallel (with OpenMP); new tokens
+   * are still labeled in the order they first appear in the input. Sparse
+   * output is written straight into its compressed storage.
+   *
    * @tparam OutputType Type of the output container. The function supports
    *                    the following types: arma::mat, arma::sp_mat,
    *                    std::vector<std::vector<>>.
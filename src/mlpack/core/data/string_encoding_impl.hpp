@@ -16,6 +16,7 @@
 // In case it hasn't been included yet.
 #include "string_encoding.hpp"
 #include <type_traits>
+#include <unordered_map>
 
 namespace mlpack {
 namespace data {
@@ -97,6 +98,168 @@ void StringEncoding<EncodingPolicyType, DictionaryType>::Encode(
 }
 
 
+namespace string_encoding {
+
+/**
+ * A column of a sparse matrix that encoding policies can write to as if it were
+ * a dense matrix (with output(row, line)).  The written elements are kept in
+ * the order they were first written, so that they can be copied into a sparse
+ * matrix.
+ */
+template<typename eT>
+class SparseColumn
+{
+ public:
+  //! The type of the elements, as for Armadillo matrices.
+  typedef eT elem_type;
+
+  //! Create an empty column of a matrix of the given size.
+  SparseColumn(const size_t n_rows, const size_t n_cols) :
+      n_rows(n_rows),
+      n_cols(n_cols)
+  { }
+
+  //! Access the element in the given row; the column is ignored.
+  eT& operator()(const size_t row, const size_t /* col */)
+  {
+    std::unordered_map<size_t, size_t>::const_iterator it =
+        positions.find(row);
+    if (it != positions.end())
+      return elements[it->second].second;
+
+    positions[row] = elements.size();
+    elements.emplace_back(row, eT(0));
+    return elements.back().second;
+  }
+
+  //! Sort the elements by row and remove the zeros.
+  void Finish()
+  {
+    elements.erase(std::remove_if(elements.begin(), elements.end(),
+        [](const std::pair<size_t, eT>& e) { return e.second == eT(0); }),
+        elements.end());
+    std::sort(elements.begin(), elements.end(),
+        [](const std::pair<size_t, eT>& a, const std::pair<size_t, eT>& b)
+        { return a.first < b.first; });
+  }
+
+  //! Remove all elements, keeping the allocated memory.
+  void Clear()
+  {
+    positions.clear();
+    elements.clear();
+  }
+
+  //! Get the (row, value) pairs of the column.
+  const std::vector<std::pair<size_t, eT>>& Elements() const
+  {
+    return elements;
+  }
+
+  //! The number of rows of the matrix.
+  const size_t n_rows;
+  //! The number of columns of the matrix.
+  const size_t n_cols;
+
+ private:
+  //! The position of each row in elements.
+  std::unordered_map<size_t, size_t> positions;
+  //! The written elements.
+  std::vector<std::pair<size_t, eT>> elements;
+};
+
+/**
+ * Write the encoded lines to a dense output (a matrix or a 2D std::vector).
+ * Every line is written by one thread, and policies only write to the column
+ * (or row) of their line, so the lines are encoded in parallel.
+ */
+template<typename OutputType, typename PolicyType>
+void WriteEncoded(const std::vector<size_t>& values,
+                  const std::vector<size_t>& offsets,
+                  const size_t maxNumTokens,
+                  const size_t dictionarySize,
+                  OutputType& output,
+                  PolicyType& policy)
+{
+  const size_t numLines = offsets.size() - 1;
+  policy.InitMatrix(output, numLines, maxNumTokens, dictionarySize);
+
+  #pragma omp parallel for schedule(dynamic, 64)
+  for (omp_size_t i = 0; i < (omp_size_t) numLines; ++i)
+  {
+    for (size_t j = offsets[i]; j < offsets[i + 1]; ++j)
+      policy.Encode(output, values[j], i, j - offsets[i]);
+  }
+}
+
+/**
+ * Write the encoded lines to a sparse matrix.  Each line is encoded into a
+ * SparseColumn, and the columns are copied straight into the compressed sparse
+ * column storage of the output, so the output is never densified.
+ */
+template<typename eT, typename PolicyType>
+void WriteEncoded(const std::vector<size_t>& values,
+                  const std::vector<size_t>& offsets,
+                  const size_t maxNumTokens,
+                  const size_t dictionarySize,
+                  arma::SpMat<eT>& output,
+                  PolicyType& policy)
+{
+  const size_t numLines = offsets.size() - 1;
+
+  // This only sets the size, since the matrix is sparse.
+  policy.InitMatrix(output, numLines, maxNumTokens, dictionarySize);
+  const size_t nRows = output.n_rows;
+  const size_t nCols = output.n_cols;
+
+  // The first pass counts the nonzero elements of each column, and the second
+  // one fills them in.
+  arma::uvec colPtrs(numLines + 1);
+  colPtrs[0] = 0;
+  arma::uvec rowIndices;
+  arma::Col<eT> elements;
+  for (size_t pass = 0; pass < 2; ++pass)
+  {
+    #pragma omp parallel
+    {
+      SparseColumn<eT> column(nRows, nCols);
+
+      #pragma omp for schedule(dynamic, 64)
+      for (omp_size_t i = 0; i < (omp_size_t) numLines; ++i)
+      {
+        column.Clear();
+        for (size_t j = offsets[i]; j < offsets[i + 1]; ++j)
+          policy.Encode(column, values[j], i, j - offsets[i]);
+        column.Finish();
+
+        if (pass == 0)
+        {
+          colPtrs[i + 1] = column.Elements().size();
+          continue;
+        }
+
+        size_t k = colPtrs[i];
+        for (const std::pair<size_t, eT>& e : column.Elements())
+        {
+          rowIndices[k] = e.first;
+          elements[k++] = e.second;
+        }
+      }
+    }
+
+    if (pass == 0)
+    {
+      colPtrs = arma::cumsum(colPtrs);
+      rowIndices.set_size(colPtrs[numLines]);
+      elements.set_size(colPtrs[numLines]);
+    }
+  }
+
+  output = arma::SpMat<eT>(rowIndices, colPtrs, elements, nRows, nCols);
+}
+
+} // namespace string_encoding
+
 template<typename EncodingPolicyType, typename DictionaryType>
 template<typename MatType, typename TokenizerType, typename PolicyType>
 void StringEncoding<EncodingPolicyType, DictionaryType>::
@@ -105,55 +268,99 @@ EncodeHelper(const std::vector<std::string>& input,
              const TokenizerType& tokenizer,
              PolicyType& policy)
 {
-  size_t numColumns = 0;
+  typedef typename DictionaryType::TokenType TokenType;
 
   policy.Reset();
 
-  // The first pass adds the extracted tokens to the dictionary.
-  for (size_t i = 0; i < input.size(); ++i)
+  // The input is split into one contiguous range of lines per thread; each
+  // thread tokenizes its range and collects the tokens that are not in the
+  // dictionary into its own dictionary, in the order they appear.
+  size_t numRanges = 1;
+  #ifdef HAS_OPENMP
+  numRanges = std::max(size_t(1), std::min(input.size(),
+      size_t(omp_get_max_threads())));
+  #endif
+
+  std::vector<size_t> offsets(input.size() + 1, 0);
+  std::vector<std::vector<TokenType>> newTokens(numRanges);
+  #pragma omp parallel for schedule(static, 1)
+  for (omp_size_t r = 0; r < (omp_size_t) numRanges; ++r)
   {
-    boost::string_view strView(input[i]);
-    auto token = tokenizer(strView);
-
-    static_assert(
-        std::is_same<typename std::remove_reference<decltype(token)>::type,
-                     typename std::remove_reference<typename DictionaryType::
-                        TokenType>::type>::value,
-        "The dictionary token type doesn't match the return value type "
-        "of the tokenizer.");
-
-    size_t numTokens = 0;
+    DictionaryType rangeDictionary;
+    const size_t begin = r * input.size() / numRanges;
+    const size_t end = (r + 1) * input.size() / numRanges;
+    for (size_t i = begin; i < end; ++i)
+    {
+      boost::string_view strView(input[i]);
+      auto token = tokenizer(strView);
+
+      static_assert(
+          std::is_same<typename std::remove_reference<decltype(token)>::type,
+                       typename std::remove_reference<TokenType>::type>::value,
+          "The dictionary token type doesn't match the return value type "
+          "of the tokenizer.");
+
+      size_t numTokens = 0;
+      while (!tokenizer.IsTokenEmpty(token))
+      {
+        if (!dictionary.HasToken(token) && !rangeDictionary.HasToken(token))
+        {
+          rangeDictionary.AddToken(token);
+          newTokens[r].push_back(std::move(token));
+        }
+
+        token = tokenizer(strView);
+        numTokens++;
+      }
+
+      offsets[i + 1] = numTokens;
+    }
+  }
 
-    while (!tokenizer.IsTokenEmpty(token))
+  // Merging the ranges in order gives every token the same label as adding the
+  // tokens one at a time would.
+  for (size_t r = 0; r < numRanges; ++r)
+  {
+    for (TokenType& token : newTokens[r])
     {
       if (!dictionary.HasToken(token))
         dictionary.AddToken(std::move(token));
-
-      policy.PreprocessToken(i, numTokens, dictionary.Value(token));
-
-      token = tokenizer(strView);
-      numTokens++;
     }
-
-    numColumns = std::max(numColumns, numTokens);
   }
+  newTokens.clear();
 
-  policy.InitMatrix(output, input.size(), numColumns, dictionary.Size());
-
-  // The second pass writes the encoded values to the output.
+  size_t maxNumTokens = 0;
   for (size_t i = 0; i < input.size(); ++i)
+  {
+    maxNumTokens = std::max(maxNumTokens, offsets[i + 1]);
+    offsets[i + 1] += offsets[i];
+  }
+
+  // The second pass labels the tokens of every line; now the dictionary is
+  // only read.
+  std::vector<size_t> values(offsets[input.size()]);
+  #pragma omp parallel for schedule(dynamic, 64)
+  for (omp_size_t i = 0; i < (omp_size_t) input.size(); ++i)
   {
     boost::string_view strView(input[i]);
     auto token = tokenizer(strView);
-    size_t numTokens = 0;
+    size_t j = offsets[i];
 
     while (!tokenizer.IsTokenEmpty(token))
     {
-      policy.Encode(output, dictionary.Value(token), i, numTokens);
+      values[j++] = dictionary.Value(token);
       token = tokenizer(strView);
-      numTokens++;
     }
   }
+
+  // Policies may collect statistics over the whole dataset; that is done
+  // serially.
+  for (size_t i = 0; i < input.size(); ++i)
+    for (size_t j = offsets[i]; j < offsets[i + 1]; ++j)
+      policy.PreprocessToken(i, j - offsets[i], values[j]);
+
+  string_encoding::WriteEncoded(values, offsets, maxNumTokens,
+      dictionary.Size(), output, policy);
 }
 
 template<typename EncodingPolicyType, typename DictionaryType>
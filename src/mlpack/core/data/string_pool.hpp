@@ -0,0 +1,105 @@
+/**
+ * @file core/data/string_pool.hpp
+ *
+ * Definition of StringPool, a compact one-to-one mapping between strings and
+ * consecutive indices.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_STRING_POOL_HPP
+#define MLPACK_CORE_DATA_STRING_POOL_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include <boost/serialization/string.hpp>
+#include <boost/serialization/vector.hpp>
+
+namespace mlpack {
+namespace data {
+
+/**
+ * A StringPool maps distinct strings to the indices 0, 1, 2, ... in the order
+ * they are inserted, and back.  All the characters are stored one after the
+ * other in a single buffer, with the offset of each string in an array, and
+ * the strings are found through an open-addressing hash table of 32-bit
+ * indices.  Each string thus takes its length plus about 16 bytes, instead of
+ * the two copies and the hash map nodes of an std::unordered_map and its
+ * inverse; this is what DatasetMapper uses to store the categories of
+ * DatasetInfo.
+ *
+ * Only the characters and the offsets are serialized; the hash table is
+ * rebuilt when the pool is loaded.
+ */
+class StringPool
+{
+ public:
+  //! Create an empty pool.
+  StringPool() : offsets(1, 0), mask(0) { }
+
+  //! Get the number of strings in the pool.
+  size_t Size() const { return offsets.size() - 1; }
+
+  /**
+   * Find the index of the given string.  Returns false if the string is not in
+   * the pool.
+   *
+   * @param str String to find.
+   * @param index Set to the index of the string, if it is found.
+   */
+  bool Find(const std::string& str, size_t& index) const;
+
+  /**
+   * Insert the given string, if it is not in the pool yet, and return its
+   * index.  A std::length_error is thrown if the pool already holds 2^32 - 1
+   * strings.
+   *
+   * @param str String to insert.
+   */
+  size_t Insert(const std::string& str);
+
+  //! Get the string with the given index, which must be less than Size().
+  std::string String(const size_t index) const
+  {
+    return strings.substr(offsets[index], offsets[index + 1] - offsets[index]);
+  }
+
+  //! Remove all the strings.
+  void Clear();
+
+  //! Serialize the pool.
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */);
+
+ private:
+  //! Hash the given characters (with 64-bit FNV-1a).
+  static size_t Hash(const char* data, const size_t length);
+
+  /**
+   * Return the slot of the table that holds the given characters, or the empty
+   * slot where they would be inserted.  The table must not be empty.
+   */
+  size_t Slot(const char* data, const size_t length) const;
+
+  //! Rebuild the hash table with the given number of slots, a power of 2.
+  void Rehash(const size_t slots);
+
+  //! The characters of all the strings.
+  std::string strings;
+  //! The offset of each string in strings, followed by the total length.
+  std::vector<size_t> offsets;
+  //! The index plus one of the string in each slot, or 0 for an empty slot.
+  std::vector<uint32_t> table;
+  //! The number of slots of the table minus one.
+  size_t mask;
+};
+
+} // namespace data
+} // namespace mlpack
+
+// Include implementation.
+#include "string_pool_impl.hpp"
+
+#endif
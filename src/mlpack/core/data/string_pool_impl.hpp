@@ -0,0 +1,126 @@
+/**
+ * @file core/data/string_pool_impl.hpp
+ *
+ * Implementation of StringPool.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_STRING_POOL_IMPL_HPP
+#define MLPACK_CORE_DATA_STRING_POOL_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "string_pool.hpp"
+
+namespace mlpack {
+namespace data {
+
+inline bool StringPool::Find(const std::string& str, size_t& index) const
+{
+  if (table.empty())
+    return false;
+
+  const uint32_t entry = table[Slot(str.data(), str.size())];
+  if (entry == 0)
+    return false;
+
+  index = entry - 1;
+  return true;
+}
+
+inline size_t StringPool::Insert(const std::string& str)
+{
+  // Keep the table at most half full, so that the probe sequences are short.
+  if (2 * (Size() + 1) > table.size())
+    Rehash(std::max(table.size() * 2, (size_t) 16));
+
+  const size_t slot = Slot(str.data(), str.size());
+  if (table[slot] != 0)
+    return table[slot] - 1;
+
+  if (Size() >= (size_t) std::numeric_limits<uint32_t>::max() - 1)
+  {
+    throw std::length_error("StringPool::Insert(): the pool cannot hold more "
+        "than 2^32 - 1 strings!");
+  }
+
+  strings.append(str);
+  offsets.push_back(strings.size());
+  table[slot] = (uint32_t) Size();
+  return Size() - 1;
+}
+
+inline void StringPool::Clear()
+{
+  strings.clear();
+  offsets.assign(1, 0);
+  table.clear();
+  mask = 0;
+}
+
+template<typename Archive>
+void StringPool::serialize(Archive& ar, const unsigned int /* version */)
+{
+  ar & BOOST_SERIALIZATION_NVP(strings);
+  ar & BOOST_SERIALIZATION_NVP(offsets);
+
+  if (Archive::is_loading::value)
+  {
+    size_t slots = 16;
+    while (slots < 2 * Size())
+      slots *= 2;
+    Rehash(slots);
+  }
+}
+
+inline size_t StringPool::Hash(const char* data, const size_t length)
+{
+  uint64_t hash = 14695981039346656037ULL;
+  for (size_t i = 0; i < length; ++i)
+  {
+    hash ^= (unsigned char) data[i];
+    hash *= 1099511628211ULL;
+  }
+
+  return (size_t) (hash ^ (hash >> 32));
+}
+
+inline size_t StringPool::Slot(const char* data, const size_t length) const
+{
+  // Linear probing: the table is never full, so an empty slot is always found.
+  size_t slot = Hash(data, length) & mask;
+  while (table[slot] != 0)
+  {
+    const size_t index = table[slot] - 1;
+    const size_t offset = offsets[index];
+    if (offsets[index + 1] - offset == length &&
+        strings.compare(offset, length, data, length) == 0)
+      return slot;
+
+    slot = (slot + 1) & mask;
+  }
+
+  return slot;
+}
+
+inline void StringPool::Rehash(const size_t slots)
+{
+  table.assign(slots, 0);
+  mask = slots - 1;
+  for (size_t i = 0; i < Size(); ++i)
+  {
+    const size_t offset = offsets[i];
+    size_t slot = Hash(strings.data() + offset, offsets[i + 1] - offset) &
+        mask;
+    while (table[slot] != 0)
+      slot = (slot + 1) & mask;
+    table[slot] = (uint32_t) (i + 1);
+  }
+}
+
+} // namespace data
+} // namespace mlpack
+
+#endif
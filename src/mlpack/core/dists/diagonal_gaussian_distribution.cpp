@@ -51,16 +51,25 @@ void DiagonalGaussianDistribution::LogProbability(
     arma::vec& logProbabilities) const
 {
   const size_t k = observations.n_rows;
-
-  // Column i of 'diffs' is the difference between observations.col(i) and
-  // the mean.
-  arma::mat diffs = observations.each_col() - mean;
+  const double logNormalizer = -0.5 * k * log2pi - 0.5 * logDetCov;
+  const double* m = mean.memptr();
+  const double* ic = invCov.memptr();
 
   // Calculates log of exponent equation in multivariate Gaussian
-  // distribution. We use only diagonal part for faster computation.
-  arma::vec logExponents = -0.5 * arma::trans(diffs % diffs) * invCov;
+  // distribution. We use only diagonal part for faster computation, and each
+  // observation is handled separately (in parallel), so no temporary matrix
+  // of differences is needed.
+  logProbabilities.set_size(observations.n_cols);
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) observations.n_cols; ++i)
+  {
+    const double* x = observations.colptr(i);
+    double exponent = 0.0;
+    for (size_t d = 0; d < k; ++d)
+      exponent += (x[d] - m[d]) * (x[d] - m[d]) * ic[d];
 
-  logProbabilities = -0.5 * k * log2pi - 0.5 * logDetCov + logExponents;
+    logProbabilities[i] = logNormalizer - 0.5 * exponent;
+  }
 }
 
 arma::vec DiagonalGaussianDistribution::Random() const
@@ -50,6 +50,67 @@ arma::vec DiscreteDistribution::Random() const
   return result;
 }
 
+void DiscreteDistribution::Probability(const arma::mat& x,
+                                       arma::vec& probabilities) const
+{
+  CheckObservations(x);
+
+  probabilities.set_size(x.n_cols);
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) x.n_cols; ++i)
+  {
+    double probability = 1.0;
+    for (size_t d = 0; d < x.n_rows; ++d)
+      probability *= this->probabilities[d][size_t(x(d, i) + 0.5)];
+    probabilities[i] = probability;
+  }
+}
+
+void DiscreteDistribution::LogProbability(const arma::mat& x,
+                                          arma::vec& logProbabilities) const
+{
+  CheckObservations(x);
+
+  logProbabilities.set_size(x.n_cols);
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) x.n_cols; ++i)
+  {
+    double probability = 1.0;
+    for (size_t d = 0; d < x.n_rows; ++d)
+      probability *= probabilities[d][size_t(x(d, i) + 0.5)];
+    logProbabilities[i] = log(probability);
+  }
+}
+
+void DiscreteDistribution::CheckObservations(const arma::mat& x) const
+{
+  if (x.n_rows != probabilities.size())
+  {
+    Log::Fatal << "DiscreteDistribution::Probability(): observation has "
+        << "incorrect dimension " << x.n_rows << " but should have"
+        << " dimension " << probabilities.size() << "!" << std::endl;
+  }
+
+  if (x.n_cols == 0)
+    return;
+
+  for (size_t d = 0; d < x.n_rows; ++d)
+  {
+    // Values below -0.5 would wrap around when cast to size_t.
+    const double lo = arma::min(x.row(d));
+    const double hi = arma::max(x.row(d));
+    if (lo + 0.5 < 0.0 || size_t(hi + 0.5) >= probabilities[d].n_elem)
+    {
+      const size_t obs = (lo + 0.5 < 0.0) ? size_t(lo + 0.5) :
+          size_t(hi + 0.5);
+      Log::Fatal << "DiscreteDistribution::Probability(): received "
+          << "observation " << obs << "; observation must be in [0, "
+          << probabilities[d].n_elem << "] for this distribution."
+          << std::endl;
+    }
+  }
+}
+
 /**
  * Estimate the probability distribution directly from the given observations.
  */
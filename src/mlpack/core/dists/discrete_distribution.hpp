@@ -171,32 +171,24 @@ class DiscreteDistribution
 
   /**
    * Calculates the Discrete probability density function for each
-   * data point (column) in the given matrix.
+   * data point (column) in the given matrix.  The observations are checked
+   * once, and then evaluated in parallel.
    *
    * @param x List of observations.
    * @param probabilities Output probabilities for each input observation.
    */
-  void Probability(const arma::mat& x, arma::vec& probabilities) const
-  {
-    probabilities.set_size(x.n_cols);
-    for (size_t i = 0; i < x.n_cols; ++i)
-      probabilities(i) = Probability(x.unsafe_col(i));
-  }
+  void Probability(const arma::mat& x, arma::vec& probabilities) const;
 
   /**
    * Returns the Log probability of the given matrix. These values are stored
-   * in logProbabilities.
+   * in logProbabilities.  The observations are checked once, and then
+   * evaluated in parallel.
    *
    * @param x List of observations.
    * @param logProbabilities Output log-probabilities for each input
    *   observation.
    */
-  void LogProbability(const arma::mat& x, arma::vec& logProbabilities) const
-  {
-    logProbabilities.set_size(x.n_cols);
-    for (size_t i = 0; i < x.n_cols; ++i)
-      logProbabilities(i) = log(Probability(x.unsafe_col(i)));
-  }
+  void LogProbability(const arma::mat& x, arma::vec& logProbabilities) const;
 
   /**
    * Return a randomly generated observation (one-dimensional vector; one
@@ -244,6 +236,10 @@ class DiscreteDistribution
   }
 
  private:
+  //! Check that the given observations have the right dimension and are in
+  //! bounds, as Probability() does for one observation.
+  void CheckObservations(const arma::mat& x) const;
+
   //! The probabilities for each dimension; each arma::vec represents the
   //! probabilities for the observations in each dimension.
   std::vector<arma::vec> probabilities;
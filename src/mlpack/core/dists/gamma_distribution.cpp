@@ -74,21 +74,15 @@ void GammaDistribution::Train(const arma::mat& rdata,
   if (arma::size(rdata) == arma::size(arma::mat()))
     return;
 
-  arma::vec meanLogxVec(rdata.n_rows, arma::fill::zeros);
-  arma::vec meanxVec(rdata.n_rows, arma::fill::zeros);
-  arma::vec logMeanxVec(rdata.n_rows, arma::fill::zeros);
-
-  for (size_t i = 0; i < rdata.n_cols; ++i)
-  {
-    meanLogxVec += probabilities(i) * arma::log(rdata.col(i));
-    meanxVec += probabilities(i) * rdata.col(i);
-  }
+  // Weighted sums of log(x) and x for each dimension.
+  arma::vec meanLogxVec = arma::log(rdata) * probabilities;
+  arma::vec meanxVec = rdata * probabilities;
 
   double totProbability = arma::accu(probabilities);
 
   meanLogxVec /= totProbability;
   meanxVec /= totProbability;
-  logMeanxVec = arma::log(meanxVec);
+  const arma::vec logMeanxVec = arma::log(meanxVec);
 
   // Call the statistics-only GammaDistribution::Train() function to fit the
   // parameters. That function does all the work so we're done.
@@ -118,8 +112,11 @@ void GammaDistribution::Train(const arma::vec& logMeanxVec,
   alpha.set_size(ndim);
   beta.set_size(ndim);
 
-  // Treat each dimension (i.e. row) independently.
-  for (size_t row = 0; row < ndim; ++row)
+  // Treat each dimension (i.e. row) independently, in parallel.  Errors are
+  // recorded for each row and thrown afterwards, from the first failed row.
+  std::vector<int> errors(ndim, 0);
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t row = 0; row < (omp_size_t) ndim; ++row)
   {
     // Statistics for this row.
     const double meanLogx = meanLogxVec(row);
@@ -143,84 +140,84 @@ void GammaDistribution::Train(const arma::vec& logMeanxVec,
 
       // Protect against division by 0.
       if (denominator == 0)
-        throw std::logic_error("GammaDistribution::Train() attempted division"
-            " by 0.");
+      {
+        errors[row] = 1;
+        break;
+      }
 
       aEst = 1.0 / ((1.0 / aEst) + nominator / denominator);
 
       // Protect against nan values (aEst will be passed to logarithm).
       if (aEst <= 0)
-        throw std::logic_error("GammaDistribution::Train(): estimated invalid "
-            "negative value for parameter alpha!");
+      {
+        errors[row] = 2;
+        break;
+      }
     } while (!Converged(aEst, aOld, tol));
 
     alpha(row) = aEst;
     beta(row) = meanx / aEst;
   }
+
+  for (size_t row = 0; row < ndim; ++row)
+  {
+    if (errors[row] == 1)
+    {
+      throw std::logic_error("GammaDistribution::Train() attempted division"
+          " by 0.");
+    }
+    else if (errors[row] == 2)
+    {
+      throw std::logic_error("GammaDistribution::Train(): estimated invalid "
+          "negative value for parameter alpha!");
+    }
+  }
 }
 
 // Returns the probability of the provided observations.
 void GammaDistribution::Probability(const arma::mat& observations,
                                     arma::vec& probabilities) const
 {
-  size_t numObs = observations.n_cols;
-
-  // Set all equal to 1 (multiplication neutral).
-  probabilities.ones(numObs);
-
-  // Compute denominator only once for each dimension.
-  arma::vec denominators(alpha.n_elem);
-  for (size_t d = 0; d < alpha.n_elem; ++d)
-    denominators(d) = std::tgamma(alpha(d)) * std::pow(beta(d), alpha(d));
-
-  // Compute probability of each observation.
-  for (size_t i = 0; i < numObs; ++i)
-  {
-    for (size_t d = 0; d < observations.n_rows; ++d)
-    {
-      // Compute probability using Multiplication Law.
-      double factor = std::exp(-observations(d, i) / beta(d));
-      double numerator = std::pow(observations(d, i), alpha(d) - 1);
-
-      probabilities(i) *= factor * numerator / denominators(d);
-    }
-  }
+  LogProbability(observations, probabilities);
+  probabilities = arma::exp(probabilities);
 }
 
 // Returns the probability of one observation (x) for one of the Gamma's
 // dimensions.
 double GammaDistribution::Probability(double x, size_t dim) const
 {
-  return std::pow(x, alpha(dim) - 1) * std::exp(-x / beta(dim)) /
-      (std::tgamma(alpha(dim)) * std::pow(beta(dim), alpha(dim)));
+  return std::exp(LogProbability(x, dim));
 }
 
 // Returns the log probability of the provided observations.
 void GammaDistribution::LogProbability(const arma::mat& observations,
                                        arma::vec& logProbabilities) const
 {
-  size_t numObs = observations.n_cols;
+  const size_t numObs = observations.n_cols;
+  const size_t numDims = observations.n_rows;
 
-  // Set all equal to 0 (addition neutral).
-  logProbabilities.zeros(numObs);
-
-  // Compute denominator only once for each dimension.
-  arma::vec denominators(alpha.n_elem);
+  // The log of the denominator of each dimension, and the other coefficients
+  // of the log probability, are computed only once.
+  arma::vec logDenominators(alpha.n_elem);
   for (size_t d = 0; d < alpha.n_elem; ++d)
-    denominators(d) = std::tgamma(alpha(d)) * std::pow(beta(d), alpha(d));
-
-  // Compute probability of each observation.
-  for (size_t i = 0; i < numObs; ++i)
+    logDenominators[d] = std::lgamma(alpha[d]) + alpha[d] * std::log(beta[d]);
+  const arma::vec alphaMinusOne = alpha - 1;
+  const arma::vec invBeta = 1 / beta;
+
+  // Compute the log probability of each observation, as the sum of the log
+  // probabilities of each dimension (which are independent).
+  logProbabilities.set_size(numObs);
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) numObs; ++i)
   {
-    for (size_t d = 0; d < observations.n_rows; ++d)
+    const double* x = observations.colptr(i);
+    double logProbability = 0.0;
+    for (size_t d = 0; d < numDims; ++d)
     {
-      // Compute probability using Multiplication Law and Logarithm addition
-      // property.
-      double factor = std::exp(-observations(d, i) / beta(d));
-      double numerator = std::pow(observations(d, i), alpha(d) - 1);
-
-      logProbabilities(i) += std::log(numerator * factor / denominators(d));
+      logProbability += alphaMinusOne[d] * std::log(x[d]) - x[d] * invBeta[d] -
+          logDenominators[d];
     }
+    logProbabilities[i] = logProbability;
   }
 }
 
@@ -228,8 +225,8 @@ void GammaDistribution::LogProbability(const arma::mat& observations,
 // dimensions.
 double GammaDistribution::LogProbability(double x, size_t dim) const
 {
-  return std::log(std::pow(x, alpha(dim) - 1) * std::exp(-x / beta(dim)) /
-      (std::tgamma(alpha(dim)) * std::pow(beta(dim), alpha(dim))));
+  return (alpha(dim) - 1) * std::log(x) - x / beta(dim) -
+      std::lgamma(alpha(dim)) - alpha(dim) * std::log(beta(dim));
 }
 
 // Returns a gamma-random d-dimensional vector.
@@ -167,7 +167,9 @@ class GammaDistribution
    * \f]
    *
    * for one dimension. This implementation assumes each dimension is
-   * independent, so the product rule is used.
+   * independent, so the product rule is used.  The logarithm is expanded, so
+   * that the gamma function does not overflow for large alpha, and the
+   * observations are evaluated in parallel.
    *
    * @param observations Matrix of observations, one per column.
    * @param logProbabilities Column vector of log probabilities, one per
@@ -90,17 +90,19 @@ class GaussianDistribution
    */
   void Probability(const arma::mat& x, arma::vec& probabilities) const
   {
-    probabilities.set_size(x.n_cols);
-    for (size_t i = 0; i < x.n_cols; ++i)
-    {
-      probabilities(i) = Probability(x.unsafe_col(i));
-    }
+    LogProbability(x, probabilities);
+    probabilities = arma::exp(probabilities);
   }
 
   /**
    * Returns the Log probability of the given matrix. These values are stored
    * in logProbabilities.
    *
+   * All the observations are evaluated at once with the cached Cholesky factor
+   * L of the covariance: the Mahalanobis distance of an observation is the
+   * squared norm of the solution z of L z = (x - mean), and a single
+   * triangular solve gives z for every column of x.
+   *
    * @param x List of observations.
    * @param logProbabilities Output log probabilities for each input
    *     observation.
@@ -110,17 +112,10 @@ class GaussianDistribution
     // Column i of 'diffs' is the difference between x.col(i) and the mean.
     arma::mat diffs = x;
     diffs.each_col() -= mean;
-    // Now, we only want to calculate the diagonal elements of (diffs' * cov^-1
-    // * diffs).  We just don't need any of the other elements.  We can
-    // calculate the right hand part of the equation (instead of the left side)
-    // so that later we are referencing columns, not rows -- that is faster.
-    const arma::mat rhs = -0.5 * invCov * diffs;
-    arma::vec logExponents(diffs.n_cols); // We will now fill this.
-    for (size_t i = 0; i < diffs.n_cols; ++i)
-      logExponents(i) = accu(diffs.unsafe_col(i) % rhs.unsafe_col(i));
-
-    logProbabilities = -0.5 * x.n_rows * log2pi - 0.5 * logDetCov +
-      logExponents;
+
+    const arma::mat z = arma::solve(arma::trimatl(covLower), diffs);
+    logProbabilities = -0.5 * x.n_rows * log2pi - 0.5 * logDetCov -
+        0.5 * arma::sum(z % z, 0).t();
   }
 
   /**
@@ -36,10 +36,32 @@ double LaplaceDistribution::LogProbability(const arma::vec& observation) const
 void LaplaceDistribution::Probability(const arma::mat& x,
                                       arma::vec& probabilities) const
 {
-  probabilities.set_size(x.n_cols);
-  for (size_t i = 0; i < x.n_cols; ++i)
+  LogProbability(x, probabilities);
+  probabilities = arma::exp(probabilities);
+}
+
+/**
+ * Evaluate log probability density function of given observation.
+ *
+ * @param x List of observations.
+ * @param logProbabilities Output log probabilities for each input observation.
+ */
+void LaplaceDistribution::LogProbability(const arma::mat& x,
+                                         arma::vec& logProbabilities) const
+{
+  const double logNormalizer = -log(2. * scale);
+  const double* m = mean.memptr();
+
+  logProbabilities.set_size(x.n_cols);
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) x.n_cols; ++i)
   {
-    probabilities(i) = Probability(x.unsafe_col(i));
+    const double* point = x.colptr(i);
+    double distance = 0.0;
+    for (size_t d = 0; d < x.n_rows; ++d)
+      distance += (point[d] - m[d]) * (point[d] - m[d]);
+
+    logProbabilities[i] = logNormalizer - std::sqrt(distance) / scale;
   }
 }
 
@@ -105,19 +105,13 @@ class LaplaceDistribution
   double LogProbability(const arma::vec& observation) const;
 
   /**
-   * Evaluate log probability density function of given observation.
+   * Evaluate log probability density function of given observation.  The
+   * observations are evaluated in parallel.
    *
    * @param x List of observations.
    * @param logProbabilities Output probabilities for each input observation.
    */
-  void LogProbability(const arma::mat& x, arma::vec& logProbabilities) const
-  {
-    logProbabilities.set_size(x.n_cols);
-    for (size_t i = 0; i < x.n_cols; ++i)
-    {
-      logProbabilities(i) = LogProbability(x.unsafe_col(i));
-    }
-  }
+  void LogProbability(const arma::mat& x, arma::vec& logProbabilities) const;
 
   /**
    * Return a randomly generated observation according to the probability
@@ -73,6 +73,19 @@ class CVFunction
    */
   double Evaluate(const arma::mat& parameters);
 
+  /**
+   * Run cross-validation with the bound and passed parameters, training the
+   * models on only the given fraction of each training set (the CVType class
+   * must provide TrainingFraction()).  This is used by budget-aware optimizers
+   * like SuccessiveHalving; evaluations with a fraction less than 1 never
+   * replace the best model.
+   *
+   * @param parameters Arguments (rather than the bound arguments) that should
+   *     be passed into the Evaluate method of the CVType object.
+   * @param trainingFraction Fraction of the training data to train on.
+   */
+  double Evaluate(const arma::mat& parameters, const double trainingFraction);
+
   /**
    * Evaluate numerically the gradient of the CVFunction with the given
    * parameters.
@@ -125,6 +138,9 @@ class CVFunction
   //! Minimum absolute increase of arguments for calculation of gradient.
   double minDelta;
 
+  //! Whether better models should replace the best model.
+  bool updateBestModel;
+
   /**
    * Collect all arguments and run cross-validation.
    */
@@ -55,7 +55,8 @@ CVFunction<CVType, MLAlgorithm, TotalArgs, BoundArgs...>::CVFunction(
     boundArgs(args...),
     bestObjective(std::numeric_limits<double>::max()),
     relativeDelta(relativeDelta),
-    minDelta(minDelta)
+    minDelta(minDelta),
+    updateBestModel(true)
 { /* Nothing left to do. */ }
 
 template<typename CVType,
@@ -68,6 +69,27 @@ double CVFunction<CVType, MLAlgorithm, TotalArgs, BoundArgs...>::Evaluate(
   return Evaluate<0, 0>(parameters);
 }
 
+template<typename CVType,
+         typename MLAlgorithm,
+         size_t TotalArgs,
+         typename... BoundArgs>
+double CVFunction<CVType, MLAlgorithm, TotalArgs, BoundArgs...>::Evaluate(
+    const arma::mat& parameters,
+    const double trainingFraction)
+{
+  // Models trained on part of the data are only used to rank the parameters.
+  const double oldFraction = cv.TrainingFraction();
+  cv.TrainingFraction() = trainingFraction;
+  updateBestModel = (trainingFraction >= 1.0);
+
+  const double objective = Evaluate<0, 0>(parameters);
+
+  cv.TrainingFraction() = oldFraction;
+  updateBestModel = true;
+
+  return objective;
+}
+
 template<typename CVType,
          typename MLAlgorithm,
          size_t TotalArgs,
@@ -121,8 +143,8 @@ double CVFunction<CVType, MLAlgorithm, TotalArgs, BoundArgs...>::Evaluate(
 
   // Change the best model if we have got a better score, or if we probably
   // have not assigned any valid (trained) model yet.
-  if (bestObjective > objective ||
-      bestObjective == std::numeric_limits<double>::max())
+  if (updateBestModel && (bestObjective > objective ||
+      bestObjective == std::numeric_limits<double>::max()))
   {
     bestObjective = objective;
     bestModel = std::move(cv.Model());
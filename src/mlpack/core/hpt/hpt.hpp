@@ -14,6 +14,7 @@
 
 #include <mlpack/core/cv/meta_info_extractor.hpp>
 #include <mlpack/core/hpt/deduce_hp_types.hpp>
+#include <mlpack/core/hpt/successive_halving.hpp>
 #include <ensmallen.hpp>
 
 namespace mlpack {
@@ -71,8 +72,8 @@ namespace hpt {
  * @tparam Metric A metric to assess the quality of a trained model.
  * @tparam CV A cross-validation strategy used to assess a set of
  *     hyper-parameters.
- * @tparam OptimizerType An optimization strategy (GridSearch and
- *     GradientDescent are supported).
+ * @tparam OptimizerType An optimization strategy (GridSearch,
+ *     GradientDescent and SuccessiveHalving are supported).
  * @tparam MatType The type of data.
  * @tparam PredictionsType The type of predictions (should be passed when the
  *     predictions type is a template parameter in Train methods of the given
@@ -209,6 +210,13 @@ class HyperParameterTuner
   //! The cross-validation object for assessing sets of hyper-parameters.
   CVType cv;
 
+ public:
+  //! Access and modify the cross-validation object (i.e. to set the number of
+  //! threads KFoldCV trains the folds with).
+  CVType& CV() { return cv; }
+
+ private:
+
   //! The optimizer.
   OptimizerType optimizer;
 
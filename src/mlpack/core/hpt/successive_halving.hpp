@@ -0,0 +1,99 @@
+/**
+ * @file core/hpt/successive_halving.hpp
+ *
+ * A budget-aware optimizer for hyper-parameter tuning: successive halving.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_HPT_SUCCESSIVE_HALVING_HPP
+#define MLPACK_CORE_HPT_SUCCESSIVE_HALVING_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace hpt {
+
+/**
+ * SuccessiveHalving is an optimizer for HyperParameterTuner that can be used
+ * in place of ens::GridSearch.  Like GridSearch, it considers every
+ * combination of the given sets of hyper-parameter values, but instead of
+ * running the full cross-validation for each combination, it first trains the
+ * models of all combinations on a small fraction of the training data, keeps
+ * the best 1 / eta of the combinations, multiplies the fraction by eta, and
+ * repeats, until the remaining combinations are evaluated on all of the data.
+ * Bad combinations are thus discarded cheaply, and most of the budget is spent
+ * on the promising ones.
+ *
+ * The function to optimize must provide Evaluate(parameters, fraction), as
+ * CVFunction does when the cross-validation class provides
+ * TrainingFraction() (KFoldCV and SimpleCV do).  Since the models are trained
+ * on the first points of each training set, the data should be shuffled.
+ *
+ * @code
+ * HyperParameterTuner<LARS, MSE, KFoldCV, SuccessiveHalving> hpt(5, data,
+ *     responses);
+ * hpt.Optimizer().MinFraction() = 0.05;
+ *
+ * double bestLambda1, bestLambda2;
+ * std::tie(bestLambda1, bestLambda2) = hpt.Optimize(Fixed(true),
+ *     Fixed(false), lambda1Set, lambda2Set);
+ * @endcode
+ */
+class SuccessiveHalving
+{
+ public:
+  /**
+   * Create the optimizer.
+   *
+   * @param minFraction Fraction of the training data used in the first round.
+   * @param eta Factor by which the number of combinations is divided (and the
+   *     fraction of the data is multiplied) after each round.
+   */
+  SuccessiveHalving(const double minFraction = 0.1, const size_t eta = 3) :
+      minFraction(minFraction), eta(eta)
+  { }
+
+  /**
+   * Find the best combination of hyper-parameter values.  All dimensions must
+   * be categorical, and the best parameters are returned as category indices,
+   * as with ens::GridSearch.
+   *
+   * @param function Function to optimize.
+   * @param bestParameters Matrix to store the best parameters in.
+   * @param categoricalDimensions Whether each dimension is categorical.
+   * @param numCategories Number of categories of each dimension.
+   * @return The objective of the best parameters on all of the data.
+   */
+  template<typename FunctionType>
+  double Optimize(FunctionType& function,
+                  arma::mat& bestParameters,
+                  const std::vector<bool>& categoricalDimensions,
+                  const arma::Row<size_t>& numCategories);
+
+  //! Get the fraction of the training data used in the first round.
+  double MinFraction() const { return minFraction; }
+  //! Modify the fraction of the training data used in the first round.
+  double& MinFraction() { return minFraction; }
+
+  //! Get the reduction factor between rounds.
+  size_t Eta() const { return eta; }
+  //! Modify the reduction factor between rounds.
+  size_t& Eta() { return eta; }
+
+ private:
+  //! The fraction of the training data used in the first round.
+  double minFraction;
+  //! The reduction factor between rounds.
+  size_t eta;
+};
+
+} // namespace hpt
+} // namespace mlpack
+
+// Include implementation.
+#include "successive_halving_impl.hpp"
+
+#endif
@@ -0,0 +1,109 @@
+/**
+ * @file core/hpt/successive_halving_impl.hpp
+ *
+ * Implementation of the successive halving optimizer.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_HPT_SUCCESSIVE_HALVING_IMPL_HPP
+#define MLPACK_CORE_HPT_SUCCESSIVE_HALVING_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "successive_halving.hpp"
+
+namespace mlpack {
+namespace hpt {
+
+template<typename FunctionType>
+double SuccessiveHalving::Optimize(
+    FunctionType& function,
+    arma::mat& bestParameters,
+    const std::vector<bool>& categoricalDimensions,
+    const arma::Row<size_t>& numCategories)
+{
+  if (minFraction <= 0.0 || minFraction > 1.0)
+  {
+    throw std::invalid_argument("SuccessiveHalving::Optimize(): the minimum "
+        "fraction should be in (0, 1]");
+  }
+
+  if (eta < 2)
+  {
+    throw std::invalid_argument("SuccessiveHalving::Optimize(): eta should be "
+        "at least 2");
+  }
+
+  for (size_t d = 0; d < categoricalDimensions.size(); ++d)
+  {
+    if (!categoricalDimensions[d])
+    {
+      std::ostringstream oss;
+      oss << "SuccessiveHalving::Optimize(): dimension " << d << " is not "
+          << "categorical; only sets of values can be searched" << std::endl;
+      throw std::invalid_argument(oss.str());
+    }
+  }
+
+  // Enumerate every combination of categories, as grid search would.
+  const size_t numDimensions = numCategories.n_elem;
+  const size_t numCandidates = arma::prod(numCategories);
+  arma::mat candidates(numDimensions, numCandidates);
+  for (size_t c = 0; c < numCandidates; ++c)
+  {
+    size_t index = c;
+    for (size_t d = 0; d < numDimensions; ++d)
+    {
+      candidates(d, c) = index % numCategories[d];
+      index /= numCategories[d];
+    }
+  }
+
+  arma::uvec survivors = arma::regspace<arma::uvec>(0, numCandidates - 1);
+  double fraction = minFraction;
+  while (true)
+  {
+    // The last round evaluates the remaining combinations on all of the data.
+    // (The fraction is a product of floating-point numbers, so it may fall
+    // just short of 1 when it should be exactly 1.)
+    const bool lastRound = (survivors.n_elem == 1 ||
+        fraction >= 1.0 - 1e-10);
+    if (lastRound)
+      fraction = 1.0;
+
+    arma::vec objectives(survivors.n_elem);
+    for (size_t i = 0; i < survivors.n_elem; ++i)
+    {
+      objectives[i] = function.Evaluate(
+          arma::mat(candidates.col(survivors[i])), fraction);
+    }
+
+    // Combinations that could not be evaluated are the worst ones.
+    objectives.replace(arma::datum::nan, arma::datum::inf);
+
+    if (lastRound)
+    {
+      const size_t best = objectives.index_min();
+      bestParameters = candidates.col(survivors[best]);
+      return objectives[best];
+    }
+
+    const size_t numKept = std::max((size_t) 1,
+        (size_t) std::ceil((double) survivors.n_elem / eta));
+    const arma::uvec order = arma::stable_sort_index(objectives);
+    survivors = arma::uvec(survivors.elem(order.head(numKept)));
+
+    Log::Info << "SuccessiveHalving::Optimize(): kept " << numKept << " of "
+        << objectives.n_elem << " combinations after training on "
+        << (100.0 * fraction) << "% of the data." << std::endl;
+
+    fraction *= eta;
+  }
+}
+
+} // namespace hpt
+} // namespace mlpack
+
+#endif
@@ -68,6 +68,24 @@ class CauchyKernel
         std::pow(metric::EuclideanDistance::Evaluate(a, b) / bandwidth, 2)));
   }
 
+  /**
+   * Evaluate the Cauchy kernel given that the distance between the two input
+   * points is known.
+   *
+   * @param t The distance between the two points the kernel should be evaluated
+   *     on.
+   * @return K(t) using the bandwidth specified in the constructor.
+   */
+  double Evaluate(const double t) const
+  {
+    return 1 / (1 + std::pow(t / bandwidth, 2));
+  }
+
+  //! Get the bandwidth.
+  double Bandwidth() const { return bandwidth; }
+  //! Modify the bandwidth.
+  double& Bandwidth() { return bandwidth; }
+
   /**
    * Serialize the kernel.
    */
@@ -89,6 +107,8 @@ class KernelTraits<CauchyKernel>
  public:
   //! The Cauchy kernel is normalized: K(x, x) = 1 for all x.
   static const bool IsNormalized = true;
+  //! The Cauchy kernel only depends on the distance between the points.
+  static const bool IsShiftInvariant = true;
 };
 
 } // namespace kernel
@@ -0,0 +1,63 @@
+/**
+ * @file core/kernels/kernel_matrix.hpp
+ *
+ * Blocked, parallel construction of kernel (Gram) matrices.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_KERNELS_KERNEL_MATRIX_HPP
+#define MLPACK_CORE_KERNELS_KERNEL_MATRIX_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "kernel_traits.hpp"
+
+namespace mlpack {
+namespace kernel {
+
+/**
+ * Compute the kernel matrix between the points of a and the points of b:
+ * kernelMatrix(i, j) = K(a.col(i), b.col(j)).  The matrix is filled in blocks,
+ * which are computed in parallel with OpenMP.
+ *
+ * If the kernel is shift-invariant (KernelTraits<KernelType>::IsShiftInvariant,
+ * as for the Gaussian, Laplacian or Cauchy kernels), the squared distances of
+ * each block are computed with one matrix multiplication, and the kernel is
+ * then evaluated on the distances.  For any other kernel, each entry is one
+ * call to kernel.Evaluate().
+ *
+ * @param kernel Kernel to evaluate.
+ * @param a First set of points.
+ * @param b Second set of points.
+ * @param kernelMatrix Output matrix, of size a.n_cols x b.n_cols.
+ */
+template<typename KernelType>
+void KernelMatrix(KernelType& kernel,
+                  const arma::mat& a,
+                  const arma::mat& b,
+                  arma::mat& kernelMatrix);
+
+/**
+ * Compute the symmetric kernel matrix of the given points:
+ * kernelMatrix(i, j) = K(data.col(i), data.col(j)).  Only the blocks of the
+ * upper triangle are computed, then mirrored.  See the two-set overload for
+ * how the blocks are computed.
+ *
+ * @param kernel Kernel to evaluate.
+ * @param data Set of points.
+ * @param kernelMatrix Output matrix, of size data.n_cols x data.n_cols.
+ */
+template<typename KernelType>
+void KernelMatrix(KernelType& kernel,
+                  const arma::mat& data,
+                  arma::mat& kernelMatrix);
+
+} // namespace kernel
+} // namespace mlpack
+
+// Include implementation.
+#include "kernel_matrix_impl.hpp"
+
+#endif
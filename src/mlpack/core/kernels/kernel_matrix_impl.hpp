@@ -0,0 +1,186 @@
+/**
+ * @file core/kernels/kernel_matrix_impl.hpp
+ *
+ * Implementation of the blocked, parallel construction of kernel matrices.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_KERNELS_KERNEL_MATRIX_IMPL_HPP
+#define MLPACK_CORE_KERNELS_KERNEL_MATRIX_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "kernel_matrix.hpp"
+
+namespace mlpack {
+namespace kernel {
+
+//! The number of points along each side of a block of the kernel matrix.
+static const size_t kernelMatrixBlockSize = 256;
+
+/**
+ * Fill one block of the kernel matrix, with the points [aBegin, aEnd) of a and
+ * [bBegin, bEnd) of b, for a shift-invariant kernel.  If diagonal is true, the
+ * block is on the diagonal of a symmetric kernel matrix, and the distance of
+ * each point to itself is set to exactly 0.
+ */
+template<typename KernelType>
+void KernelMatrixBlock(
+    KernelType& kernel,
+    const arma::mat& a,
+    const arma::mat& b,
+    const arma::vec& aNorms,
+    const arma::vec& bNorms,
+    const size_t aBegin,
+    const size_t aEnd,
+    const size_t bBegin,
+    const size_t bEnd,
+    const bool diagonal,
+    arma::mat& kernelMatrix,
+    const typename std::enable_if<
+        KernelTraits<KernelType>::IsShiftInvariant>::type* = 0)
+{
+  // ||x - y||^2 = ||x||^2 + ||y||^2 - 2 x^T y.
+  arma::mat distances = -2.0 * (a.cols(aBegin, aEnd - 1).t() *
+      b.cols(bBegin, bEnd - 1));
+  distances.each_col() += aNorms.subvec(aBegin, aEnd - 1);
+  distances.each_row() += bNorms.subvec(bBegin, bEnd - 1).t();
+  if (diagonal)
+    distances.diag().zeros();
+
+  for (size_t j = 0; j < distances.n_cols; ++j)
+  {
+    for (size_t i = 0; i < distances.n_rows; ++i)
+    {
+      // Rounding may make the squared distance of close points negative.
+      kernelMatrix(aBegin + i, bBegin + j) = kernel.Evaluate(
+          std::sqrt(std::max(distances(i, j), 0.0)));
+    }
+  }
+}
+
+/**
+ * Fill one block of the kernel matrix, with the points [aBegin, aEnd) of a and
+ * [bBegin, bEnd) of b, with one kernel evaluation per entry.  If diagonal is
+ * true, the block is on the diagonal of a symmetric kernel matrix, and only
+ * its upper triangle is computed.
+ */
+template<typename KernelType>
+void KernelMatrixBlock(
+    KernelType& kernel,
+    const arma::mat& a,
+    const arma::mat& b,
+    const arma::vec& /* aNorms */,
+    const arma::vec& /* bNorms */,
+    const size_t aBegin,
+    const size_t aEnd,
+    const size_t bBegin,
+    const size_t bEnd,
+    const bool diagonal,
+    arma::mat& kernelMatrix,
+    const typename std::enable_if<
+        !KernelTraits<KernelType>::IsShiftInvariant>::type* = 0)
+{
+  for (size_t j = bBegin; j < bEnd; ++j)
+  {
+    const size_t iEnd = diagonal ? (aBegin + (j - bBegin) + 1) : aEnd;
+    for (size_t i = aBegin; i < iEnd; ++i)
+      kernelMatrix(i, j) = kernel.Evaluate(a.unsafe_col(i), b.unsafe_col(j));
+  }
+}
+
+//! Compute the squared norms of the points, if the kernel needs them.
+template<typename KernelType>
+void KernelMatrixNorms(const arma::mat& data, arma::vec& norms)
+{
+  if (KernelTraits<KernelType>::IsShiftInvariant)
+    norms = arma::sum(arma::square(data), 0).t();
+}
+
+template<typename KernelType>
+void KernelMatrix(KernelType& kernel,
+                  const arma::mat& a,
+                  const arma::mat& b,
+                  arma::mat& kernelMatrix)
+{
+  if (a.n_rows != b.n_rows)
+  {
+    std::ostringstream oss;
+    oss << "KernelMatrix(): dimensionalities of the two sets of points ("
+        << a.n_rows << " and " << b.n_rows << ") do not match!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  kernelMatrix.set_size(a.n_cols, b.n_cols);
+
+  arma::vec aNorms, bNorms;
+  KernelMatrixNorms<KernelType>(a, aNorms);
+  KernelMatrixNorms<KernelType>(b, bNorms);
+
+  const size_t aBlocks = (a.n_cols + kernelMatrixBlockSize - 1) /
+      kernelMatrixBlockSize;
+  const size_t bBlocks = (b.n_cols + kernelMatrixBlockSize - 1) /
+      kernelMatrixBlockSize;
+
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t block = 0; block < (omp_size_t) (aBlocks * bBlocks);
+      ++block)
+  {
+    const size_t aBegin = (block % aBlocks) * kernelMatrixBlockSize;
+    const size_t bBegin = (block / aBlocks) * kernelMatrixBlockSize;
+    const size_t aEnd = std::min(aBegin + kernelMatrixBlockSize,
+        (size_t) a.n_cols);
+    const size_t bEnd = std::min(bBegin + kernelMatrixBlockSize,
+        (size_t) b.n_cols);
+
+    KernelMatrixBlock(kernel, a, b, aNorms, bNorms, aBegin, aEnd, bBegin, bEnd,
+        false, kernelMatrix);
+  }
+}
+
+template<typename KernelType>
+void KernelMatrix(KernelType& kernel,
+                  const arma::mat& data,
+                  arma::mat& kernelMatrix)
+{
+  kernelMatrix.set_size(data.n_cols, data.n_cols);
+
+  arma::vec norms;
+  KernelMatrixNorms<KernelType>(data, norms);
+
+  // Only the blocks (i, j) with i <= j are computed.
+  const size_t blocks = (data.n_cols + kernelMatrixBlockSize - 1) /
+      kernelMatrixBlockSize;
+
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t block = 0; block < (omp_size_t) (blocks * blocks); ++block)
+  {
+    const size_t i = block % blocks;
+    const size_t j = block / blocks;
+    if (i > j)
+      continue;
+
+    const size_t aBegin = i * kernelMatrixBlockSize;
+    const size_t bBegin = j * kernelMatrixBlockSize;
+    const size_t aEnd = std::min(aBegin + kernelMatrixBlockSize,
+        (size_t) data.n_cols);
+    const size_t bEnd = std::min(bBegin + kernelMatrixBlockSize,
+        (size_t) data.n_cols);
+
+    KernelMatrixBlock(kernel, data, data, norms, norms, aBegin, aEnd, bBegin,
+        bEnd, (i == j), kernelMatrix);
+  }
+
+  // Copy the upper triangle to the lower triangle.
+  #pragma omp parallel for
+  for (omp_size_t j = 0; j < (omp_size_t) data.n_cols; ++j)
+    for (size_t i = j + 1; i < data.n_cols; ++i)
+      kernelMatrix(i, j) = kernelMatrix(j, i);
+}
+
+} // namespace kernel
+} // namespace mlpack
+
+#endif
@@ -36,6 +36,13 @@ class KernelTraits
    * If true, then the kernel include a squared distance, ||x - y||^2 .
    */
   static const bool UsesSquaredDistance = false;
+
+  /**
+   * If true, then the kernel is shift-invariant: K(x, y) only depends on
+   * ||x - y||, and the kernel has an Evaluate(distance) overload that gives
+   * K(x, y) from the Euclidean distance between x and y.
+   */
+  static const bool IsShiftInvariant = false;
 };
 
 } // namespace kernel
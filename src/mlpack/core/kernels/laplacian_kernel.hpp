@@ -117,6 +117,8 @@ class KernelTraits<LaplacianKernel>
   static const bool IsNormalized = true;
   //! The Laplacian kernel doesn't include a squared distance.
   static const bool UsesSquaredDistance = false;
+  //! The Laplacian kernel only depends on the distance between the points.
+  static const bool IsShiftInvariant = true;
 };
 
 } // namespace kernel
@@ -31,57 +31,201 @@ mlpack::kernel::PSpectrumStringKernel::PSpectrumStringKernel(
     const size_t p) :
     p(p)
 {
-  // We have to assemble the counts of substrings.  This is not a particularly
-  // fast operation, unfortunately, but it only needs to be done once.
-  Log::Info << "Assembling counts of substrings of length " << p << "."
+  Log::Info << "Assembling spectra of substrings of length " << p << "."
       << std::endl;
 
+  // Substrings of at most 12 characters are encoded exactly in base 36 (36^12
+  // < 2^64); longer ones are hashed with a polynomial rolling hash.
+  const bool exact = (p <= 12);
+  const uint64_t base = exact ? 36 : 1099511628211ULL;
+  // The weight of the character leaving the window, base^(p - 1).
+  uint64_t leading = 1;
+  for (size_t j = 1; j < p; ++j)
+    leading *= base;
+
   // Resize for number of datasets.
-  counts.resize(datasets.size());
+  spectra.resize(datasets.size());
 
   for (size_t dataset = 0; dataset < datasets.size(); ++dataset)
   {
     const std::vector<std::string>& set = datasets[dataset];
 
     // Resize for number of strings in dataset.
-    counts[dataset].resize(set.size());
+    spectra[dataset].resize(set.size());
 
-    // Inspect each string in the dataset.
-    for (size_t index = 0; index < set.size(); ++index)
+    // Each string is independent.
+    #pragma omp parallel for schedule(dynamic, 64)
+    for (omp_size_t index = 0; index < (omp_size_t) set.size(); ++index)
     {
       // Convenience references.
       const std::string& str = set[index];
-      std::map<std::string, int>& mapping = counts[dataset][index];
+      Spectrum& spectrum = spectra[dataset][index];
 
-      size_t start = 0;
-      while ((start + p) <= str.length())
+      if (p == 0)
       {
-        string sub = str.substr(start, p);
+        // Every position holds the empty substring.
+        spectrum.push_back(std::make_pair(uint64_t(0), str.length() + 1));
+        continue;
+      }
 
-        // Convert all characters to lowercase.
-        bool invalid = false;
-        for (size_t j = 0; j < p; ++j)
+      // Compute the code of every window of p alphanumeric characters.
+      std::vector<uint64_t> codes;
+      codes.reserve(str.length());
+      uint64_t code = 0;
+      size_t run = 0; // Number of consecutive alphanumerics so far.
+      for (size_t j = 0; j < str.length(); ++j)
+      {
+        const unsigned char c = (unsigned char) str[j];
+        if (!isalnum(c))
         {
-          if (!isalnum(sub[j]))
-          {
-            invalid = true;
-            break; // Only consider substrings with alphanumerics.
-          }
-
-          sub[j] = tolower(sub[j]);
+          // Only consider substrings with alphanumerics.
+          run = 0;
+          code = 0;
+          continue;
         }
 
-        // Increment position in string.
-        ++start;
+        const unsigned char lower = (unsigned char) tolower(c);
+        const uint64_t digit = exact ? (isdigit(lower) ? uint64_t(lower - '0') :
+            uint64_t(lower - 'a' + 10)) : uint64_t(lower);
 
-        if (!invalid)
+        // Remove the character leaving the window, then append the new one.
+        if (run >= p)
         {
-          // Add to the map.
-          ++mapping[sub];
+          const unsigned char out = (unsigned char) tolower(
+              (unsigned char) str[j - p]);
+          const uint64_t outDigit = exact ? (isdigit(out) ?
+              uint64_t(out - '0') : uint64_t(out - 'a' + 10)) : uint64_t(out);
+          code -= outDigit * leading;
         }
+        code = code * base + digit;
+        ++run;
+
+        if (run >= p)
+          codes.push_back(code);
+      }
+
+      // Sort the codes and count each distinct one.
+      std::sort(codes.begin(), codes.end());
+      for (size_t j = 0; j < codes.size(); ++j)
+      {
+        if (spectrum.empty() || spectrum.back().first != codes[j])
+          spectrum.push_back(std::make_pair(codes[j], size_t(1)));
+        else
+          ++spectrum.back().second;
       }
+      spectrum.shrink_to_fit();
     }
   }
 
   Log::Info << "Substring extraction complete." << std::endl;
 }
+
+void mlpack::kernel::PSpectrumStringKernel::Gram(const size_t datasetA,
+                                                  const size_t datasetB,
+                                                  arma::mat& gram) const
+{
+  if (datasetA >= spectra.size() || datasetB >= spectra.size())
+  {
+    std::ostringstream oss;
+    oss << "PSpectrumStringKernel::Gram(): invalid dataset index; there are "
+        << spectra.size() << " datasets!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  const std::vector<Spectrum>& setA = spectra[datasetA];
+  const std::vector<Spectrum>& setB = spectra[datasetB];
+  const bool symmetric = (datasetA == datasetB);
+
+  gram.set_size(setA.size(), setB.size());
+
+  // Each column is computed independently; for a symmetric Gram matrix, only
+  // the upper triangle is evaluated, then mirrored.
+  #pragma omp parallel for schedule(dynamic, 16)
+  for (omp_size_t j = 0; j < (omp_size_t) setB.size(); ++j)
+  {
+    const size_t end = symmetric ? (size_t) j + 1 : setA.size();
+    for (size_t i = 0; i < end; ++i)
+      gram(i, j) = SpectrumKernel(setA[i], setB[j]);
+  }
+
+  if (symmetric)
+    gram = arma::symmatu(gram);
+}
+
+double mlpack::kernel::PSpectrumStringKernel::SpectrumKernel(
+    const Spectrum& a,
+    const Spectrum& b)
+{
+  double eval = 0;
+
+  // Both spectra are sorted by code, so the common substrings are found with
+  // one merge.
+  Spectrum::const_iterator aIt = a.begin();
+  Spectrum::const_iterator bIt = b.begin();
+  while ((aIt != a.end()) && (bIt != b.end()))
+  {
+    if (aIt->first == bIt->first) // The same substring.
+    {
+      eval += double(aIt->second) * double(bIt->second);
+      ++aIt;
+      ++bIt;
+    }
+    else if (aIt->first > bIt->first)
+    {
+      ++bIt;
+    }
+    else
+    {
+      ++aIt;
+    }
+  }
+
+  return eval;
+}
+
+const std::vector<std::vector<std::map<std::string, int> > >&
+mlpack::kernel::PSpectrumStringKernel::Counts() const
+{
+  if (counts.size() == spectra.size())
+    return counts;
+
+  if (p > 12)
+  {
+    throw std::invalid_argument("PSpectrumStringKernel::Counts(): substrings "
+        "longer than 12 characters are hashed and cannot be recovered!");
+  }
+
+  const char symbols[] = "0123456789abcdefghijklmnopqrstuvwxyz";
+  counts.resize(spectra.size());
+  for (size_t dataset = 0; dataset < spectra.size(); ++dataset)
+  {
+    counts[dataset].resize(spectra[dataset].size());
+    for (size_t index = 0; index < spectra[dataset].size(); ++index)
+    {
+      const Spectrum& spectrum = spectra[dataset][index];
+      std::map<std::string, int>& mapping = counts[dataset][index];
+      for (size_t k = 0; k < spectrum.size(); ++k)
+      {
+        // Decode the base-36 digits, from the last character to the first.
+        std::string sub(p, '0');
+        uint64_t code = spectrum[k].first;
+        for (size_t j = p; j > 0; --j)
+        {
+          sub[j - 1] = symbols[code % 36];
+          code /= 36;
+        }
+        mapping[sub] = (int) spectrum[k].second;
+      }
+    }
+  }
+
+  return counts;
+}
+
+std::vector<std::vector<std::map<std::string, int> > >&
+mlpack::kernel::PSpectrumStringKernel::Counts()
+{
+  const PSpectrumStringKernel& self = *this;
+  self.Counts();
+  return counts;
+}
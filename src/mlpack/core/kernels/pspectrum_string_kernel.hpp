@@ -18,6 +18,7 @@
 
 #include <map>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include <mlpack/prereqs.hpp>
@@ -61,6 +62,14 @@ namespace kernel {
  * the data according to the fake data matrix -- resulting in a meaningless
  * tree.  This kernel was originally written for the FastMKS method; so, at the
  * very least, it will work with that.
+ *
+ * Each string is stored as its spectrum: the sorted list of the distinct
+ * substrings of length p that it contains (with their counts), where each
+ * substring is encoded as a 64-bit integer.  Evaluating the kernel is then a
+ * linear merge of two flat vectors of integers.  Since substrings are composed
+ * of the 36 lowercase alphanumeric characters, the encoding is exact for p <=
+ * 12; for longer substrings it is a 64-bit polynomial hash, and two different
+ * substrings collide with probability about 2^-64.
  */
 class PSpectrumStringKernel
 {
@@ -89,12 +98,36 @@ class PSpectrumStringKernel
   template<typename VecType>
   double Evaluate(const VecType& a, const VecType& b) const;
 
-  //! Access the lists of substrings.
-  const std::vector<std::vector<std::map<std::string, int> > >& Counts() const
-  { return counts; }
-  //! Modify the lists of substrings.
-  std::vector<std::vector<std::map<std::string, int> > >& Counts()
-  { return counts; }
+  /**
+   * Compute, in parallel, the kernel between every string of dataset
+   * datasetA and every string of dataset datasetB: gram(i, j) is the kernel
+   * between datasets[datasetA][i] and datasets[datasetB][j].  When both
+   * datasets are the same, each pair is evaluated once.
+   *
+   * @param datasetA Index of the dataset of the rows.
+   * @param datasetB Index of the dataset of the columns.
+   * @param gram Matrix to store the kernel values in.
+   */
+  void Gram(const size_t datasetA,
+            const size_t datasetB,
+            arma::mat& gram) const;
+
+  //! The spectrum of a string: its sorted substring codes, with their counts.
+  typedef std::vector<std::pair<uint64_t, size_t> > Spectrum;
+
+  //! Access the spectra of the strings.
+  const std::vector<std::vector<Spectrum> >& Spectra() const
+  { return spectra; }
+
+  /**
+   * Access the lists of substrings.  They are decoded from the spectra the
+   * first time they are accessed; this is only possible when p <= 12 (since
+   * longer substrings are hashed), and modifying them does not change the
+   * kernel.
+   */
+  const std::vector<std::vector<std::map<std::string, int> > >& Counts() const;
+  //! Modify the lists of substrings (this does not change the kernel).
+  std::vector<std::vector<std::map<std::string, int> > >& Counts();
 
   //! Access the value of p.
   size_t P() const { return p; }
@@ -102,9 +135,15 @@ class PSpectrumStringKernel
   size_t& P() { return p; }
 
  private:
-  //! Mappings of the datasets to counts of substrings.  Such a huge structure
-  //! is not wonderful...
-  std::vector<std::vector<std::map<std::string, int> > > counts;
+  //! Return the kernel between the two given spectra.
+  static double SpectrumKernel(const Spectrum& a, const Spectrum& b);
+
+  //! The spectrum of each string of each dataset.
+  std::vector<std::vector<Spectrum> > spectra;
+
+  //! Mappings of the datasets to counts of substrings, decoded from the spectra
+  //! when Counts() is first called.
+  mutable std::vector<std::vector<std::map<std::string, int> > > counts;
 
   //! The value of p to use in calculation.
   size_t p;
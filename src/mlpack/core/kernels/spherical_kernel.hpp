@@ -127,6 +127,8 @@ class KernelTraits<SphericalKernel>
   static const bool IsNormalized = true;
   //! The spherical kernel doesn't include a squared distance.
   static const bool UsesSquaredDistance = false;
+  //! The spherical kernel only depends on the distance between the points.
+  static const bool IsShiftInvariant = true;
 };
 
 } // namespace kernel
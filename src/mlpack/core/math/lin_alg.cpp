@@ -277,3 +277,62 @@ void mlpack::math::SymKronId(const arma::mat& A, arma::mat& op)
     }
   }
 }
+
+void mlpack::math::SparseTimes(const arma::sp_mat& a,
+                               const arma::mat& b,
+                               arma::mat& result)
+{
+  if (a.n_cols != b.n_rows)
+  {
+    throw std::invalid_argument("SparseTimes(): incompatible matrix "
+        "dimensions: " + std::to_string(a.n_rows) + "x" +
+        std::to_string(a.n_cols) + " and " + std::to_string(b.n_rows) + "x" +
+        std::to_string(b.n_cols) + "!");
+  }
+
+  a.sync();
+  result.zeros(a.n_rows, b.n_cols);
+
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t c = 0; c < (omp_size_t) b.n_cols; ++c)
+  {
+    for (size_t j = 0; j < a.n_cols; ++j)
+    {
+      const double factor = b(j, c);
+      if (factor == 0.0)
+        continue;
+
+      for (size_t k = a.col_ptrs[j]; k < a.col_ptrs[j + 1]; ++k)
+        result(a.row_indices[k], c) += a.values[k] * factor;
+    }
+  }
+}
+
+void mlpack::math::SparseTransTimes(const arma::sp_mat& a,
+                                    const arma::mat& b,
+                                    arma::mat& result)
+{
+  if (a.n_rows != b.n_rows)
+  {
+    throw std::invalid_argument("SparseTransTimes(): incompatible matrix "
+        "dimensions: " + std::to_string(a.n_cols) + "x" +
+        std::to_string(a.n_rows) + " and " + std::to_string(b.n_rows) + "x" +
+        std::to_string(b.n_cols) + "!");
+  }
+
+  a.sync();
+
+  // The rows of B and of the result are read and written as columns of their
+  // transposes, which are contiguous.
+  const arma::mat bt = b.t();
+  arma::mat resultT(b.n_cols, a.n_cols, arma::fill::zeros);
+
+  #pragma omp parallel for schedule(dynamic, 256)
+  for (omp_size_t j = 0; j < (omp_size_t) a.n_cols; ++j)
+  {
+    for (size_t k = a.col_ptrs[j]; k < a.col_ptrs[j + 1]; ++k)
+      resultT.col(j) += a.values[k] * bt.col(a.row_indices[k]);
+  }
+
+  result = resultT.t();
+}
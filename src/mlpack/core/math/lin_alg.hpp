@@ -117,6 +117,30 @@ inline size_t SvecIndex(size_t i, size_t j, size_t n);
  */
 void SymKronId(const arma::mat& A, arma::mat& op);
 
+/**
+ * Compute the product A * B of a sparse matrix and a dense matrix with OpenMP.
+ * Each thread computes a set of columns of the result, in one pass over the
+ * nonzeros of A for each column.
+ *
+ * @param a Sparse matrix.
+ * @param b Dense matrix.
+ * @param result Matrix to store A * B in.
+ */
+void SparseTimes(const arma::sp_mat& a, const arma::mat& b, arma::mat& result);
+
+/**
+ * Compute the product A^T * B of a sparse matrix and a dense matrix with
+ * OpenMP, without forming A^T.  Each row of the result only depends on one
+ * column of A, so the rows are computed in parallel.
+ *
+ * @param a Sparse matrix.
+ * @param b Dense matrix.
+ * @param result Matrix to store A^T * B in.
+ */
+void SparseTransTimes(const arma::sp_mat& a,
+                      const arma::mat& b,
+                      arma::mat& result);
+
 /**
  * Signum function.
  * Return 1 if x>0; return 0 if x=0; return -1 if x<0.
@@ -0,0 +1,126 @@
+/**
+ * @file core/math/moments.hpp
+ *
+ * Definition of the Moments class, which computes the mean, the central
+ * moments and the extremes of each dimension of a dataset in a single pass.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_MATH_MOMENTS_HPP
+#define MLPACK_CORE_MATH_MOMENTS_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace math {
+
+/**
+ * Moments accumulates, for each dimension of a dataset, the number of points,
+ * the mean, the sums of the second, third and fourth powers of the deviations
+ * from the mean, and the minimum and maximum, from which the variance, the
+ * skewness and the kurtosis are given.  The points are read once, with the
+ * numerically stable updates of Welford and Terriberry, so the dataset can be
+ * given in chunks (e.g. from a data::ChunkedReader):
+ *
+ * @code
+ * math::Moments moments;
+ * arma::mat chunk;
+ * while (reader.Next(chunk))
+ *   moments.Update(chunk);
+ * arma::vec skewness = moments.Skewness();
+ * @endcode
+ *
+ * Update() splits large chunks over the available threads; the partial
+ * moments are then combined with Merge(), which can also combine the moments
+ * of chunks accumulated separately (with the formulas of Pébay).
+ */
+class Moments
+{
+ public:
+  /**
+   * Create the accumulator, with no points.  If the dimensionality is 0, it
+   * is set by the first call to Update().
+   *
+   * @param dimensionality Dimensionality of the points.
+   */
+  Moments(const size_t dimensionality = 0);
+
+  /**
+   * Add the given points, one per column.  A std::invalid_argument is thrown
+   * if their dimensionality is not the dimensionality of the accumulator.
+   *
+   * @param data Points to add.
+   */
+  void Update(const arma::mat& data);
+
+  /**
+   * Add the points of the given accumulator.  A std::invalid_argument is
+   * thrown if the dimensionalities differ.
+   *
+   * @param other Moments of the points to add.
+   */
+  void Merge(const Moments& other);
+
+  //! Get the number of points.
+  size_t Count() const { return count; }
+  //! Get the dimensionality of the points.
+  size_t Dimensionality() const { return mean.n_elem; }
+
+  //! Get the mean of each dimension.
+  const arma::vec& Mean() const { return mean; }
+  //! Get the minimum of each dimension.
+  const arma::vec& Min() const { return minimum; }
+  //! Get the maximum of each dimension.
+  const arma::vec& Max() const { return maximum; }
+
+  /**
+   * Get the variance of each dimension, normalized by the number of points if
+   * population is true, and by the number of points minus one otherwise.
+   */
+  arma::vec Variance(const bool population = false) const;
+
+  //! Get the standard deviation of each dimension (see Variance()).
+  arma::vec Stddev(const bool population = false) const;
+
+  /**
+   * Get the skewness of each dimension; the sample skewness is adjusted for
+   * the bias of small samples.
+   */
+  arma::vec Skewness(const bool population = false) const;
+
+  /**
+   * Get the excess kurtosis of each dimension; the sample kurtosis is adjusted
+   * for the bias of small samples.
+   */
+  arma::vec Kurtosis(const bool population = false) const;
+
+ private:
+  //! Add the given columns of the points, one at a time.
+  void Accumulate(const arma::mat& data, const size_t begin, const size_t end);
+
+  //! The number of points.
+  size_t count;
+  //! The mean of each dimension.
+  arma::vec mean;
+  //! The sum of the squared deviations from the mean of each dimension.
+  arma::vec m2;
+  //! The sum of the cubed deviations from the mean of each dimension.
+  arma::vec m3;
+  //! The sum of the fourth powers of the deviations from the mean.
+  arma::vec m4;
+  //! The minimum of each dimension.
+  arma::vec minimum;
+  //! The maximum of each dimension.
+  arma::vec maximum;
+};
+
+} // namespace math
+} // namespace mlpack
+
+// Include implementation.
+#include "moments_impl.hpp"
+
+#endif
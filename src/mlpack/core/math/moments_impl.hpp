@@ -0,0 +1,169 @@
+/**
+ * @file core/math/moments_impl.hpp
+ *
+ * Implementation of the Moments class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_MATH_MOMENTS_IMPL_HPP
+#define MLPACK_CORE_MATH_MOMENTS_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "moments.hpp"
+
+namespace mlpack {
+namespace math {
+
+inline Moments::Moments(const size_t dimensionality) :
+    count(0),
+    mean(dimensionality, arma::fill::zeros),
+    m2(dimensionality, arma::fill::zeros),
+    m3(dimensionality, arma::fill::zeros),
+    m4(dimensionality, arma::fill::zeros),
+    minimum(dimensionality),
+    maximum(dimensionality)
+{
+  minimum.fill(std::numeric_limits<double>::infinity());
+  maximum.fill(-std::numeric_limits<double>::infinity());
+}
+
+inline void Moments::Update(const arma::mat& data)
+{
+  if (count == 0 && Dimensionality() == 0)
+    *this = Moments(data.n_rows);
+
+  if (data.n_rows != Dimensionality())
+  {
+    std::ostringstream oss;
+    oss << "Moments::Update(): the points have dimensionality " << data.n_rows
+        << ", but the accumulator has dimensionality " << Dimensionality();
+    throw std::invalid_argument(oss.str());
+  }
+
+  // Each thread takes a contiguous range of at least a few thousand points,
+  // and the ranges are merged in order.
+  const size_t blocks = std::max((size_t) 1, std::min(util::Threads(),
+      (size_t) data.n_cols / 4096));
+  if (blocks == 1)
+  {
+    Accumulate(data, 0, data.n_cols);
+    return;
+  }
+
+  std::vector<Moments> partial(blocks, Moments(data.n_rows));
+  #pragma omp parallel for schedule(static, 1)
+  for (omp_size_t b = 0; b < (omp_size_t) blocks; ++b)
+  {
+    partial[b].Accumulate(data, b * data.n_cols / blocks,
+        (b + 1) * data.n_cols / blocks);
+  }
+
+  for (size_t b = 0; b < blocks; ++b)
+    Merge(partial[b]);
+}
+
+inline void Moments::Merge(const Moments& other)
+{
+  if (other.count == 0)
+    return;
+
+  if (count == 0 && Dimensionality() == 0)
+    *this = Moments(other.Dimensionality());
+
+  if (other.Dimensionality() != Dimensionality())
+  {
+    std::ostringstream oss;
+    oss << "Moments::Merge(): the accumulators have dimensionalities "
+        << Dimensionality() << " and " << other.Dimensionality();
+    throw std::invalid_argument(oss.str());
+  }
+
+  const double na = count;
+  const double nb = other.count;
+  const double n = na + nb;
+  for (size_t i = 0; i < Dimensionality(); ++i)
+  {
+    const double delta = other.mean[i] - mean[i];
+    const double delta2 = delta * delta;
+
+    m4[i] += other.m4[i] + delta2 * delta2 * na * nb * (na * na - na * nb +
+        nb * nb) / (n * n * n) + 6 * delta2 * (na * na * other.m2[i] + nb * nb *
+        m2[i]) / (n * n) + 4 * delta * (na * other.m3[i] - nb * m3[i]) / n;
+    m3[i] += other.m3[i] + delta2 * delta * na * nb * (na - nb) / (n * n) +
+        3 * delta * (na * other.m2[i] - nb * m2[i]) / n;
+    m2[i] += other.m2[i] + delta2 * na * nb / n;
+    mean[i] += delta * nb / n;
+    minimum[i] = std::min(minimum[i], other.minimum[i]);
+    maximum[i] = std::max(maximum[i], other.maximum[i]);
+  }
+
+  count += other.count;
+}
+
+inline arma::vec Moments::Variance(const bool population) const
+{
+  return m2 / (population ? double(count) : double(count) - 1);
+}
+
+inline arma::vec Moments::Stddev(const bool population) const
+{
+  return arma::sqrt(Variance(population));
+}
+
+inline arma::vec Moments::Skewness(const bool population) const
+{
+  const double n = count;
+  const arma::vec s3 = arma::pow(Stddev(population), 3);
+  if (population)
+    return m3 / (n * s3);
+
+  return n * m3 / ((n - 1) * (n - 2) * s3);
+}
+
+inline arma::vec Moments::Kurtosis(const bool population) const
+{
+  const double n = count;
+  if (population)
+    return n * m4 / arma::square(m2) - 3;
+
+  const arma::vec s4 = arma::square(Variance(false));
+  const double norm3 = (3 * (n - 1) * (n - 1)) / ((n - 2) * (n - 3));
+  const double normC = (n * (n + 1)) / ((n - 1) * (n - 2) * (n - 3));
+  return normC * m4 / s4 - norm3;
+}
+
+inline void Moments::Accumulate(const arma::mat& data,
+                                const size_t begin,
+                                const size_t end)
+{
+  for (size_t c = begin; c < end; ++c)
+  {
+    const double n1 = count;
+    const double n = n1 + 1;
+    const double* point = data.colptr(c);
+    for (size_t i = 0; i < Dimensionality(); ++i)
+    {
+      const double delta = point[i] - mean[i];
+      const double deltaN = delta / n;
+      const double deltaN2 = deltaN * deltaN;
+      const double term = delta * deltaN * n1;
+
+      mean[i] += deltaN;
+      m4[i] += term * deltaN2 * (n * n - 3 * n + 3) + 6 * deltaN2 * m2[i] -
+          4 * deltaN * m3[i];
+      m3[i] += term * deltaN * (n - 2) - 3 * deltaN * m2[i];
+      m2[i] += term;
+      minimum[i] = std::min(minimum[i], point[i]);
+      maximum[i] = std::max(maximum[i], point[i]);
+    }
+    ++count;
+  }
+}
+
+} // namespace math
+} // namespace mlpack
+
+#endif
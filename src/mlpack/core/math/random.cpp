@@ -8,7 +8,11 @@
  * 3-clause BSD license along with mlpack.  If not, see
  * http://www.opensource.org/licenses/BSD-3-Clause for more information.
  */
+#include <atomic>
 #include <random>
+#include <thread>
+#include <cstdint>
+#include <cstddef>
 #include <mlpack/mlpack_export.hpp>
 
 namespace mlpack {
@@ -20,6 +24,16 @@ MLPACK_EXPORT std::mt19937 randGen;
 MLPACK_EXPORT std::uniform_real_distribution<> randUniformDist(0.0, 1.0);
 // Global normal distribution.
 MLPACK_EXPORT std::normal_distribution<> randNormalDist(0.0, 1.0);
+// The last seed given to RandomSeed(); this is the default seed of randGen.
+MLPACK_EXPORT uint64_t randSeed = std::mt19937::default_seed;
+// The number of times RandomSeed() has been called.
+MLPACK_EXPORT size_t randSeedGeneration = 0;
+// The thread that owns the global stream; until RandomSeed() is called, this is
+// the thread that loaded mlpack.
+MLPACK_EXPORT std::atomic<std::thread::id> randSeedThread(
+    std::this_thread::get_id());
+// The number of threads other than OpenMP workers that got their own stream.
+MLPACK_EXPORT std::atomic<size_t> randThreadStreams(0);
 
 } // namespace math
 } // namespace mlpack
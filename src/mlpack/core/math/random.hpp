@@ -13,7 +13,9 @@
 
 #include <mlpack/prereqs.hpp>
 #include <mlpack/mlpack_export.hpp>
+#include <atomic>
 #include <random>
+#include <thread>
 
 namespace mlpack {
 namespace math /** Miscellaneous math routines. */ {
@@ -29,6 +31,146 @@ extern MLPACK_EXPORT std::mt19937 randGen;
 extern MLPACK_EXPORT std::uniform_real_distribution<> randUniformDist;
 // Global normal distribution.
 extern MLPACK_EXPORT std::normal_distribution<> randNormalDist;
+// The last seed given to RandomSeed().
+extern MLPACK_EXPORT uint64_t randSeed;
+// The number of times RandomSeed() has been called.
+extern MLPACK_EXPORT size_t randSeedGeneration;
+// The thread that owns the global stream: the thread that last called
+// RandomSeed(), or the thread that loaded mlpack if it was never called.
+extern MLPACK_EXPORT std::atomic<std::thread::id> randSeedThread;
+// The number of threads other than OpenMP workers that got their own stream.
+extern MLPACK_EXPORT std::atomic<size_t> randThreadStreams;
+
+/**
+ * Generates a 64-bit random number with a counter-based generator: the number
+ * is a hash (the SplitMix64 finalizer) of the key of a stream and of the index
+ * of the number in the stream.  The numbers of a stream can thus be generated
+ * independently of each other, in any order and on any thread, and the same
+ * key and counter always give the same number.
+ *
+ * @param key The key of the stream.
+ * @param counter The index of the number in the stream.
+ */
+inline uint64_t RandCounter(const uint64_t key, const uint64_t counter)
+{
+  uint64_t z = key + 0x9E3779B97F4A7C15ULL;
+  for (size_t round = 0; round < 2; ++round)
+  {
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    z ^= (z >> 31);
+
+    // The counter is added to the mixed key, so that the streams of close keys
+    // don't overlap.
+    if (round == 0)
+      z += counter * 0x9E3779B97F4A7C15ULL;
+  }
+
+  return z;
+}
+
+/**
+ * Generates a uniform random number between 0 and 1 with the counter-based
+ * generator of RandCounter().
+ *
+ * @param key The key of the stream.
+ * @param counter The index of the number in the stream.
+ */
+inline double RandomCounter(const uint64_t key, const uint64_t counter)
+{
+  return (RandCounter(key, counter) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+/**
+ * The random number generator and distributions of one thread.  Every thread
+ * but the one that owns the global stream (see randSeedThread) has its own
+ * stream, so that the random functions below can be called inside OpenMP
+ * parallel regions, or from std::thread workers and threads of the host
+ * language of a binding, without racing on (or serializing on) the global
+ * generator.  The owning thread (outside of parallel regions, or as the master
+ * of one) always uses the global randGen, randUniformDist and randNormalDist,
+ * so serial code is not affected.
+ */
+struct RandomStream
+{
+  //! The random number generator of the thread.
+  std::mt19937 generator;
+  //! The uniform distribution of the thread.
+  std::uniform_real_distribution<> uniformDist;
+  //! The normal distribution of the thread.
+  std::normal_distribution<> normalDist;
+  //! The value of randSeedGeneration the stream was last seeded with, or
+  //! (size_t) -1 if the stream was never seeded.
+  size_t generation;
+  //! The index of the stream among the threads that are not OpenMP workers,
+  //! or (size_t) -1 if it was not given one yet.
+  size_t threadIndex;
+
+  RandomStream() : uniformDist(0.0, 1.0), normalDist(0.0, 1.0),
+      generation(size_t(-1)), threadIndex(size_t(-1)) { }
+};
+
+/**
+ * Get the random stream of the calling thread, or NULL if the calling thread
+ * should use the global stream (this is the case for the thread that last
+ * called RandomSeed(), outside of parallel regions or as the master thread of
+ * one).  The stream of any other thread is (re)seeded from the last seed
+ * given to RandomSeed() the first time it is used after each call to
+ * RandomSeed().  OpenMP worker threads are keyed by their thread number, so
+ * for a given seed and a given number of threads, each of them always draws
+ * the same numbers.  Other threads (std::thread workers, or threads of the
+ * host language of a binding) are keyed by the order in which they first drew
+ * a number, so they draw distinct numbers, but which thread gets which stream
+ * depends on the schedule.
+ *
+ * The work given to each thread by a dynamic schedule is not deterministic, so
+ * code that must give the same results for any schedule should use the
+ * counter-based RandCounter() (or RandomFill()) instead.
+ */
+inline RandomStream* WorkerRandomStream()
+{
+  #ifdef HAS_OPENMP
+    const size_t thread = (size_t) omp_get_thread_num();
+  #else
+    const size_t thread = 0;
+  #endif
+
+  if (thread == 0 && std::this_thread::get_id() ==
+      randSeedThread.load(std::memory_order_relaxed))
+    return NULL;
+
+  static thread_local RandomStream stream;
+  if (stream.generation != randSeedGeneration)
+  {
+    // The keys of threads that are not OpenMP workers are above any thread
+    // number, so that their streams never overlap those of the workers.
+    uint64_t key = thread;
+    if (thread == 0)
+    {
+      if (stream.threadIndex == size_t(-1))
+        stream.threadIndex = randThreadStreams++;
+      key = (uint64_t(1) << 32) + stream.threadIndex;
+    }
+
+    stream.generator.seed((uint32_t) RandCounter(randSeed, key));
+    stream.uniformDist.reset();
+    stream.normalDist.reset();
+    stream.generation = randSeedGeneration;
+  }
+
+  return &stream;
+}
+
+/**
+ * Get the random number generator of the calling thread; this is randGen
+ * unless the caller is a worker thread of a parallel region.  Use this instead
+ * of randGen for code that may run in parallel (i.e. with std::shuffle()).
+ */
+inline std::mt19937& RandGen()
+{
+  RandomStream* stream = WorkerRandomStream();
+  return (stream == NULL) ? randGen : stream->generator;
+}
 
 /**
  * Set the random seed used by the random functions (Random() and RandInt()).
@@ -41,6 +183,9 @@ inline void RandomSeed(const size_t seed)
 {
   #if (!defined(BINDING_TYPE) || BINDING_TYPE != BINDING_TYPE_TEST)
     randGen.seed((uint32_t) seed);
+    randSeed = seed;
+    randSeedThread = std::this_thread::get_id();
+    ++randSeedGeneration;
     #if (BINDING_TYPE == BINDING_TYPE_R)
       // To suppress Found ‘srand’, possibly from ‘srand’ (C).
       (void) seed;
@@ -65,6 +210,9 @@ inline void FixedRandomSeed()
 {
   const static size_t seed = rand();
   randGen.seed((uint32_t) seed);
+  randSeed = seed;
+  randSeedThread = std::this_thread::get_id();
+  ++randSeedGeneration;
   srand((unsigned int) seed);
   arma::arma_rng::set_seed(seed);
 }
@@ -72,17 +220,25 @@ inline void FixedRandomSeed()
 inline void CustomRandomSeed(const size_t seed)
 {
   randGen.seed((uint32_t) seed);
+  randSeed = seed;
+  randSeedThread = std::this_thread::get_id();
+  ++randSeedGeneration;
   srand((unsigned int) seed);
   arma::arma_rng::set_seed(seed);
 }
 #endif
 
 /**
- * Generates a uniform random number between 0 and 1.
+ * Generates a uniform random number between 0 and 1.  This (and all the other
+ * random functions) can be called from inside OpenMP parallel regions; each
+ * thread draws from its own stream (see WorkerRandomStream()).
  */
 inline double Random()
 {
-  return randUniformDist(randGen);
+  RandomStream* stream = WorkerRandomStream();
+  if (stream == NULL)
+    return randUniformDist(randGen);
+  return stream->uniformDist(stream->generator);
 }
 
 /**
@@ -90,7 +246,7 @@ inline double Random()
  */
 inline double Random(const double lo, const double hi)
 {
-  return lo + (hi - lo) * randUniformDist(randGen);
+  return lo + (hi - lo) * Random();
 }
 
 /**
@@ -109,7 +265,7 @@ inline double RandBernoulli(const double input)
  */
 inline int RandInt(const int hiExclusive)
 {
-  return (int) std::floor((double) hiExclusive * randUniformDist(randGen));
+  return (int) std::floor((double) hiExclusive * Random());
 }
 
 /**
@@ -117,8 +273,7 @@ inline int RandInt(const int hiExclusive)
  */
 inline int RandInt(const int lo, const int hiExclusive)
 {
-  return lo + (int) std::floor((double) (hiExclusive - lo)
-                               * randUniformDist(randGen));
+  return lo + (int) std::floor((double) (hiExclusive - lo) * Random());
 }
 
 /**
@@ -126,7 +281,10 @@ inline int RandInt(const int lo, const int hiExclusive)
  */
 inline double RandNormal()
 {
-  return randNormalDist(randGen);
+  RandomStream* stream = WorkerRandomStream();
+  if (stream == NULL)
+    return randNormalDist(randGen);
+  return stream->normalDist(stream->generator);
 }
 
 /**
@@ -138,7 +296,69 @@ inline double RandNormal()
  */
 inline double RandNormal(const double mean, const double variance)
 {
-  return variance * randNormalDist(randGen) + mean;
+  return variance * RandNormal() + mean;
+}
+
+/**
+ * Fill a matrix (or vector, or cube) with uniform random numbers in [lo, hi).
+ * The numbers are drawn in parallel with the counter-based generator of
+ * RandCounter(), keyed by a number drawn from the stream of the calling
+ * thread, so the result only depends on the seed and not on the number of
+ * threads.
+ *
+ * @param x Matrix to fill; its size is not changed.
+ * @param lo Lower bound of the numbers (inclusive).
+ * @param hi Upper bound of the numbers (exclusive).
+ */
+template<typename MatType>
+inline void RandomFill(MatType& x, const double lo = 0.0, const double hi = 1.0)
+{
+  typedef typename MatType::elem_type ElemType;
+
+  std::mt19937& generator = RandGen();
+  const uint64_t key = (uint64_t(generator()) << 32) | generator();
+
+  ElemType* mem = x.memptr();
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) x.n_elem; ++i)
+    mem[i] = ElemType(lo + (hi - lo) * RandomCounter(key, i));
+}
+
+/**
+ * Fill a matrix (or vector, or cube) with normally distributed random numbers,
+ * using the Box-Muller transform on the counter-based generator of
+ * RandCounter().  As with RandomFill(), the result only depends on the seed and
+ * not on the number of threads.
+ *
+ * @param x Matrix to fill; its size is not changed.
+ * @param mean Mean of the distribution.
+ * @param stddev Standard deviation of the distribution.
+ */
+template<typename MatType>
+inline void RandNormalFill(MatType& x,
+                           const double mean = 0.0,
+                           const double stddev = 1.0)
+{
+  typedef typename MatType::elem_type ElemType;
+
+  std::mt19937& generator = RandGen();
+  const uint64_t key = (uint64_t(generator()) << 32) | generator();
+
+  // Each pair of uniform numbers gives a pair of normal numbers.
+  ElemType* mem = x.memptr();
+  const size_t numPairs = (x.n_elem + 1) / 2;
+  #pragma omp parallel for
+  for (omp_size_t j = 0; j < (omp_size_t) numPairs; ++j)
+  {
+    // 1 - u is in (0, 1], so the logarithm is finite.
+    const double radius = std::sqrt(-2.0 * std::log(1.0 -
+        RandomCounter(key, 2 * j)));
+    const double angle = 2.0 * M_PI * RandomCounter(key, 2 * j + 1);
+
+    mem[2 * j] = ElemType(mean + stddev * radius * std::cos(angle));
+    if (2 * j + 1 < x.n_elem)
+      mem[2 * j + 1] = ElemType(mean + stddev * radius * std::sin(angle));
+  }
 }
 
 /**
@@ -159,17 +379,19 @@ inline void ObtainDistinctSamples(const size_t loInclusive,
 
   if (samplesRangeSize > maxNumSamples)
   {
-    arma::Col<size_t> samples;
-
-    samples.zeros(samplesRangeSize);
-
+    // Sorting the samples costs O(maxNumSamples log maxNumSamples) instead of
+    // the O(samplesRangeSize) of marking them in an array of the whole range,
+    // which matters because the range is often much larger.
+    std::vector<size_t> samples(maxNumSamples);
     for (size_t i = 0; i < maxNumSamples; ++i)
-      samples [ (size_t) math::RandInt(samplesRangeSize) ]++;
+      samples[i] = (size_t) math::RandInt(samplesRangeSize);
 
-    distinctSamples = arma::find(samples > 0);
+    std::sort(samples.begin(), samples.end());
+    samples.erase(std::unique(samples.begin(), samples.end()), samples.end());
 
-    if (loInclusive > 0)
-      distinctSamples += loInclusive;
+    distinctSamples.set_size(samples.size());
+    for (size_t i = 0; i < samples.size(); ++i)
+      distinctSamples[i] = loInclusive + samples[i];
   }
   else
   {
@@ -13,6 +13,7 @@
 #define MLPACK_CORE_METRICS_BLEU_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <unordered_map>
 
 namespace mlpack {
 namespace metric {
@@ -135,7 +136,40 @@ class BLEU
    * @param segment Tokenized sequence represented in form of vector.
    */
   template <typename WordVector>
-  std::map<WordVector, size_t> GetNGrams(const WordVector& segment);
+  std::map<WordVector, size_t> GetNGrams(const WordVector& segment) const;
+
+  //! The distinct n-grams of one order of a segment, encoded as integers and
+  //! sorted, with their counts.
+  typedef std::vector<std::pair<uint64_t, size_t>> NGramCounts;
+
+  /**
+   * Encode the n-grams of the given order of a segment whose tokens were
+   * replaced by ids (0 for a token that cannot be matched, in which case the
+   * n-grams containing it are skipped).
+   *
+   * @param ids Ids of the tokens of the segment.
+   * @param order Length of the n-grams.
+   * @param base Base of the encoding (larger than every id).
+   * @param counts The sorted codes of the n-grams, with their counts.
+   */
+  static void GetNGramCodes(const std::vector<uint64_t>& ids,
+                            const size_t order,
+                            const uint64_t base,
+                            NGramCounts& counts);
+
+  /**
+   * Add the clipped counts of the n-grams of the translation that appear in
+   * the references to matchesByOrder.  The tokens are numbered with a hash
+   * map, and the n-grams are counted in sorted flat vectors of integer codes.
+   *
+   * @param references References of the translation.
+   * @param translation Tokens of the translation.
+   * @param matchesByOrder Number of matches of each order.
+   */
+  template <typename ReferenceSetType, typename WordVector>
+  void CountMatches(const ReferenceSetType& references,
+                    const WordVector& translation,
+                    std::vector<size_t>& matchesByOrder) const;
 
   //! Locally-stored value of maximum length of tokens in n-grams.
   size_t maxOrder;
@@ -30,7 +30,7 @@ BLEU<ElemType, PrecisionType>::BLEU(const size_t maxOrder) :
 template <typename ElemType, typename PrecisionType>
 template <typename WordVector>
 std::map<WordVector, size_t> BLEU<ElemType, PrecisionType>::GetNGrams(
-    const WordVector& segment)
+    const WordVector& segment) const
 {
   std::map<WordVector, size_t> ngramsCount;
   for (size_t order = 1; order < maxOrder + 1; ++order)
@@ -46,56 +46,89 @@ std::map<WordVector, size_t> BLEU<ElemType, PrecisionType>::GetNGrams(
 }
 
 template <typename ElemType, typename PrecisionType>
-template <typename ReferenceCorpusType, typename TranslationCorpusType>
-ElemType BLEU<ElemType, PrecisionType>::Evaluate(
-    const ReferenceCorpusType& referenceCorpus,
-    const TranslationCorpusType& translationCorpus,
-    const bool smooth)
+void BLEU<ElemType, PrecisionType>::GetNGramCodes(
+    const std::vector<uint64_t>& ids,
+    const size_t order,
+    const uint64_t base,
+    NGramCounts& counts)
 {
-  // WordVector is a string container type.
-  // Also, TranslationCorpusType is an array of such containers.
-  typedef typename TranslationCorpusType::value_type WordVector;
-
-  // matchesByOrder: It catches how many times sequence of a particular order
-  // is encountered in both reference corpus and translation corpus.
-  std::vector<size_t> matchesByOrder(maxOrder, 0);
-
-  // possibleMatchesByOrder: It tracks how many possible matches can be in the
-  // translation corpus.
-  std::vector<size_t> possibleMatchesByOrder(maxOrder, 0);
+  counts.clear();
+  if (ids.size() < order)
+    return;
 
-  // referenceLength: It is the sum of minimum length of the paragraph from
-  // various documents.
-  // translationLength: It is the sum of length of each paragraphs.
-  referenceLength = 0, translationLength = 0;
-
-  auto refIt = referenceCorpus.cbegin();
-  auto trIt = translationCorpus.cbegin();
-  for (; refIt != referenceCorpus.cend() && trIt != translationCorpus.cend();
-      ++refIt, ++trIt)
+  std::vector<uint64_t> codes;
+  codes.reserve(ids.size() - order + 1);
+  for (size_t i = 0; i + order <= ids.size(); ++i)
   {
-    size_t min = std::numeric_limits<size_t>::max();
-    for (const auto& t : *refIt)
+    uint64_t code = 0;
+    bool known = true;
+    for (size_t j = i; j < i + order; ++j)
     {
-      if (min > t.size())
+      // A token that is not in the translation can never be matched.
+      if (ids[j] == 0)
       {
-        min = t.size();
+        known = false;
+        break;
       }
+      code = code * base + ids[j];
     }
 
-    if (min == std::numeric_limits<size_t>::max())
-      min = 0;
+    if (known)
+      codes.push_back(code);
+  }
+
+  // Sort the codes and count each distinct one.
+  std::sort(codes.begin(), codes.end());
+  for (size_t i = 0; i < codes.size(); ++i)
+  {
+    if (counts.empty() || counts.back().first != codes[i])
+      counts.push_back(std::make_pair(codes[i], size_t(1)));
+    else
+      ++counts.back().second;
+  }
+}
+
+template <typename ElemType, typename PrecisionType>
+template <typename ReferenceSetType, typename WordVector>
+void BLEU<ElemType, PrecisionType>::CountMatches(
+    const ReferenceSetType& references,
+    const WordVector& translation,
+    std::vector<size_t>& matchesByOrder) const
+{
+  typedef typename WordVector::value_type TokenType;
+
+  // Number the distinct tokens of the translation from 1; other tokens get 0.
+  std::unordered_map<TokenType, uint64_t> vocabulary;
+  std::vector<uint64_t> translationIds;
+  translationIds.reserve(translation.size());
+  for (const auto& token : translation)
+  {
+    const uint64_t id = vocabulary.size() + 1;
+    translationIds.push_back(vocabulary.emplace(token, id).first->second);
+  }
 
-    referenceLength += min;
-    translationLength += trIt->size();
+  // An n-gram is encoded exactly as a number in base (vocabulary size + 1), so
+  // base^maxOrder must fit in 64 bits.  Otherwise, fall back to ordered maps
+  // of n-grams.
+  const uint64_t base = vocabulary.size() + 1;
+  bool fits = true;
+  uint64_t power = 1;
+  for (size_t order = 0; order < maxOrder && fits; ++order)
+  {
+    if (power > std::numeric_limits<uint64_t>::max() / base)
+      fits = false;
+    else
+      power *= base;
+  }
 
+  if (!fits)
+  {
     // mergedRefNGramCounts: It accumulates all the similar n-grams from
     // various references or documents, so that there is no repetition of
     // any key (sequence of order n).
     std::map<WordVector, size_t> mergedRefNGramCounts;
-    for (const auto& t : *refIt)
+    for (const auto& t : references)
     {
-      // ngram: It holds the n-grams of each document/reference.
       const std::map<WordVector, size_t> ngrams = GetNGrams(t);
       for (auto it = ngrams.cbegin(); it != ngrams.cend(); ++it)
       {
@@ -103,14 +136,9 @@ ElemType BLEU<ElemType, PrecisionType>::Evaluate(
             mergedRefNGramCounts[it->first]);
       }
     }
-    // translationNGramCounts: It extracts the n-grams of the generated text
-    // sequence.
-    const std::map<WordVector, size_t> translationNGramCounts
-        = GetNGrams(*trIt);
 
-    // overlap: It holds those keys (sequence of order n) which are common to
-    // reference corpus and translation corpus.
-    std::map<WordVector, size_t> overlap;
+    const std::map<WordVector, size_t> translationNGramCounts
+        = GetNGrams(translation);
     for (auto it = translationNGramCounts.cbegin();
          it != translationNGramCounts.cend();
          ++it)
@@ -118,25 +146,175 @@ ElemType BLEU<ElemType, PrecisionType>::Evaluate(
       auto mergedIt = mergedRefNGramCounts.find(it->first);
       if (mergedIt != mergedRefNGramCounts.end())
       {
-        // If the key (sequence of order n) is present in both translation
-        // corpus as well as reference corpus, then the minimum number of
-        // counts it has occurred in any is considered.
-        overlap[it->first] = std::min(mergedIt->second, it->second);
+        matchesByOrder[it->first.size() - 1] += std::min(mergedIt->second,
+            it->second);
       }
     }
+    return;
+  }
 
-    for (auto it = overlap.cbegin(); it != overlap.cend(); ++it)
+  std::vector<std::vector<uint64_t>> referenceIds;
+  for (const auto& t : references)
+  {
+    referenceIds.push_back(std::vector<uint64_t>());
+    referenceIds.back().reserve(t.size());
+    for (const auto& token : t)
     {
-      matchesByOrder[it->first.size() - 1] += it->second;
+      auto it = vocabulary.find(token);
+      referenceIds.back().push_back((it == vocabulary.end()) ? 0 : it->second);
     }
+  }
+
+  NGramCounts translationCounts, referenceCounts, mergedCounts, merged;
+  for (size_t order = 1; order < maxOrder + 1; ++order)
+  {
+    GetNGramCodes(translationIds, order, base, translationCounts);
+    if (translationCounts.empty())
+      break;
 
-    for (size_t order = 1; order < maxOrder + 1; ++order)
+    // Take, for each n-gram, its maximum count over the references, by merging
+    // the sorted counts of each reference.
+    mergedCounts.clear();
+    for (size_t r = 0; r < referenceIds.size(); ++r)
     {
-      if (order < trIt->size() + 1)
-        possibleMatchesByOrder[order - 1] += trIt->size() - order + 1;
+      GetNGramCodes(referenceIds[r], order, base, referenceCounts);
+
+      merged.clear();
+      size_t i = 0, j = 0;
+      while (i < mergedCounts.size() || j < referenceCounts.size())
+      {
+        if (j == referenceCounts.size() || (i < mergedCounts.size() &&
+            mergedCounts[i].first < referenceCounts[j].first))
+        {
+          merged.push_back(mergedCounts[i++]);
+        }
+        else if (i == mergedCounts.size() ||
+            referenceCounts[j].first < mergedCounts[i].first)
+        {
+          merged.push_back(referenceCounts[j++]);
+        }
+        else
+        {
+          merged.push_back(std::make_pair(mergedCounts[i].first,
+              std::max(mergedCounts[i].second, referenceCounts[j].second)));
+          ++i;
+          ++j;
+        }
+      }
+      mergedCounts.swap(merged);
     }
+
+    // The matches of the translation are clipped by the reference counts.
+    size_t i = 0, j = 0;
+    while (i < translationCounts.size() && j < mergedCounts.size())
+    {
+      if (translationCounts[i].first < mergedCounts[j].first)
+      {
+        ++i;
+      }
+      else if (mergedCounts[j].first < translationCounts[i].first)
+      {
+        ++j;
+      }
+      else
+      {
+        matchesByOrder[order - 1] += std::min(translationCounts[i].second,
+            mergedCounts[j].second);
+        ++i;
+        ++j;
+      }
+    }
+  }
+}
+
+template <typename ElemType, typename PrecisionType>
+template <typename ReferenceCorpusType, typename TranslationCorpusType>
+ElemType BLEU<ElemType, PrecisionType>::Evaluate(
+    const ReferenceCorpusType& referenceCorpus,
+    const TranslationCorpusType& translationCorpus,
+    const bool smooth)
+{
+  // WordVector is a string container type.
+  // Also, TranslationCorpusType is an array of such containers.
+  typedef typename TranslationCorpusType::value_type WordVector;
+  typedef typename ReferenceCorpusType::value_type ReferenceSetType;
+
+  // Collect the pairs of references and translations, so that they can be
+  // processed in parallel whatever the type of the corpora.
+  std::vector<const ReferenceSetType*> references;
+  std::vector<const WordVector*> translations;
+  auto refIt = referenceCorpus.cbegin();
+  auto trIt = translationCorpus.cbegin();
+  for (; refIt != referenceCorpus.cend() && trIt != translationCorpus.cend();
+      ++refIt, ++trIt)
+  {
+    references.push_back(&(*refIt));
+    translations.push_back(&(*trIt));
   }
 
+  // matchesByOrder: It catches how many times sequence of a particular order
+  // is encountered in both reference corpus and translation corpus.
+  std::vector<size_t> matchesByOrder(maxOrder, 0);
+
+  // possibleMatchesByOrder: It tracks how many possible matches can be in the
+  // translation corpus.
+  std::vector<size_t> possibleMatchesByOrder(maxOrder, 0);
+
+  // referenceLength: It is the sum of minimum length of the paragraph from
+  // various documents.
+  // translationLength: It is the sum of length of each paragraphs.
+  size_t totalReferenceLength = 0, totalTranslationLength = 0;
+
+  #pragma omp parallel
+  {
+    // The counts are accumulated by each thread, then reduced.
+    std::vector<size_t> localMatches(maxOrder, 0);
+    std::vector<size_t> localPossibleMatches(maxOrder, 0);
+
+    #pragma omp for schedule(dynamic, 64) \
+        reduction(+:totalReferenceLength, totalTranslationLength)
+    for (omp_size_t s = 0; s < (omp_size_t) translations.size(); ++s)
+    {
+      const ReferenceSetType& referenceSet = *references[s];
+      const WordVector& translation = *translations[s];
+
+      size_t min = std::numeric_limits<size_t>::max();
+      for (const auto& t : referenceSet)
+      {
+        if (min > t.size())
+        {
+          min = t.size();
+        }
+      }
+
+      if (min == std::numeric_limits<size_t>::max())
+        min = 0;
+
+      totalReferenceLength += min;
+      totalTranslationLength += translation.size();
+
+      CountMatches(referenceSet, translation, localMatches);
+
+      for (size_t order = 1; order < maxOrder + 1; ++order)
+      {
+        if (order < translation.size() + 1)
+          localPossibleMatches[order - 1] += translation.size() - order + 1;
+      }
+    }
+
+    #pragma omp critical
+    {
+      for (size_t i = 0; i < maxOrder; ++i)
+      {
+        matchesByOrder[i] += localMatches[i];
+        possibleMatchesByOrder[i] += localPossibleMatches[i];
+      }
+    }
+  }
+
+  referenceLength = totalReferenceLength;
+  translationLength = totalTranslationLength;
+
   precisions = PrecisionType(maxOrder, 0.0);
 
   if (smooth)
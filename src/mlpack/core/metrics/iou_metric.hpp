@@ -59,11 +59,38 @@ class IoU
   static typename VecTypeA::elem_type Evaluate(const VecTypeA& a,
                                                const VecTypeB& b);
 
+  /**
+   * Computes the Intersection over Union metric between every bounding box of
+   * a and every bounding box of b (one per column), so that iou(i, j) is the
+   * IoU of a.col(i) and b.col(j).  The columns of iou are computed in
+   * parallel.
+   *
+   * @tparam MatTypeA Type of first matrix.
+   * @tparam MatTypeB Type of second matrix.
+   * @param a First set of bounding boxes.
+   * @param b Second set of bounding boxes.
+   * @param iou Matrix to store the IoU of each pair of bounding boxes in.
+   */
+  template<typename MatTypeA, typename MatTypeB>
+  static void Evaluate(const MatTypeA& a,
+                       const MatTypeB& b,
+                       arma::Mat<typename MatTypeA::elem_type>& iou);
+
   static const bool useCoordinates = UseCoordinates;
 
   //! Serialize the metric.
   template<typename Archive>
   void serialize(Archive& ar, const unsigned int /* version */);
+
+ private:
+  /**
+   * Check the bounding boxes and convert them to one row per box, holding
+   * {x0, y0, x1, y1, area}, so that each coordinate of all the boxes is
+   * contiguous.
+   */
+  template<typename MatType>
+  static void Corners(const MatType& boxes,
+                      arma::Mat<typename MatType::elem_type>& corners);
 }; // class IoU
 
 } // namespace metric
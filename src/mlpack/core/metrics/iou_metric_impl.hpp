@@ -64,6 +64,89 @@ typename VecTypeA::elem_type IoU<UseCoordinates>::Evaluate(
   return interSectionArea / (1.0 * ((a(2) + 1) * (a(3) + 1) + (b(2) + 1) *
       (b(3) + 1) - interSectionArea));
 }
+
+template<bool UseCoordinates>
+template<typename MatTypeA, typename MatTypeB>
+void IoU<UseCoordinates>::Evaluate(
+    const MatTypeA& a,
+    const MatTypeB& b,
+    arma::Mat<typename MatTypeA::elem_type>& iou)
+{
+  typedef typename MatTypeA::elem_type ElemType;
+
+  arma::Mat<ElemType> cornersA, cornersB;
+  Corners(a, cornersA);
+  Corners(b, cornersB);
+
+  const ElemType* x0 = cornersA.colptr(0);
+  const ElemType* y0 = cornersA.colptr(1);
+  const ElemType* x1 = cornersA.colptr(2);
+  const ElemType* y1 = cornersA.colptr(3);
+  const ElemType* area = cornersA.colptr(4);
+
+  iou.set_size(a.n_cols, b.n_cols);
+  #pragma omp parallel for
+  for (omp_size_t j = 0; j < (omp_size_t) b.n_cols; ++j)
+  {
+    const ElemType bx0 = cornersB(j, 0);
+    const ElemType by0 = cornersB(j, 1);
+    const ElemType bx1 = cornersB(j, 2);
+    const ElemType by1 = cornersB(j, 3);
+    const ElemType bArea = cornersB(j, 4);
+
+    ElemType* out = iou.colptr(j);
+    for (size_t i = 0; i < a.n_cols; ++i)
+    {
+      const ElemType width = std::max(ElemType(0), std::min(x1[i], bx1) -
+          std::max(x0[i], bx0) + 1);
+      const ElemType height = std::max(ElemType(0), std::min(y1[i], by1) -
+          std::max(y0[i], by0) + 1);
+      const ElemType intersectionArea = width * height;
+      out[i] = intersectionArea / (area[i] + bArea - intersectionArea);
+    }
+  }
+}
+
+template<bool UseCoordinates>
+template<typename MatType>
+void IoU<UseCoordinates>::Corners(
+    const MatType& boxes,
+    arma::Mat<typename MatType::elem_type>& corners)
+{
+  typedef typename MatType::elem_type ElemType;
+
+  Log::Assert(boxes.n_rows == 4, "Incorrect shape for bounding boxes. They "
+      "must contain 4 elements either be {x0, y0, x1, y1} or {x0, y0, h, w}. "
+      "Refer to the documentation for more information.");
+
+  corners.set_size(boxes.n_cols, 5);
+  corners.cols(0, 3) = arma::trans(boxes);
+  if (UseCoordinates)
+  {
+    // Check the correctness of bounding boxes.
+    if (arma::any(corners.col(0) >= corners.col(2)) ||
+        arma::any(corners.col(1) >= corners.col(3)))
+    {
+      Log::Fatal << "Check the correctness of bounding boxes i.e. " <<
+          "{x0, y0} must represent lower left coordinates and " <<
+          "{x1, y1} must represent upper right coordinates of bounding" <<
+          "box." << std::endl;
+    }
+  }
+  else
+  {
+    Log::Assert(arma::all(corners.col(2) > 0) && arma::all(corners.col(3) > 0),
+        "Height and width of bounding boxes must be greater than zero.");
+
+    // Change height - width representation to coordinate represention.
+    corners.col(2) += corners.col(0);
+    corners.col(3) += corners.col(1);
+  }
+
+  corners.col(4) = (corners.col(2) - corners.col(0) + ElemType(1)) %
+      (corners.col(3) - corners.col(1) + ElemType(1));
+}
+
 template<bool UseCoordinates>
 template<typename Archive>
 void IoU<UseCoordinates>::serialize(
@@ -13,6 +13,8 @@
 #ifndef MLPACK_METHODS_FASTMKS_IP_METRIC_HPP
 #define MLPACK_METHODS_FASTMKS_IP_METRIC_HPP
 
+#include <mlpack/prereqs.hpp>
+
 namespace mlpack {
 namespace metric {
 
@@ -25,6 +27,13 @@ namespace metric {
  * d(x, y) = \sqrt{ K(x, x) + K(y, y) - 2K(x, y) }.
  * @f]
  *
+ * Computing the distance takes three kernel evaluations.  When the distances
+ * are taken between points of one dataset (as when a tree is built, or when a
+ * tree is searched), the self-kernels K(x, x) of the points can be cached once
+ * with CacheSelfKernels(), and then each distance takes only one evaluation.
+ * The cache is used for the columns of the cached dataset (that is, when
+ * Evaluate() is given dataset.col(i)); other points are evaluated as usual.
+ *
  * @tparam KernelType Type of Kernel to use.  This must be a Mercer kernel
  *     (positive definite), otherwise the metric may not be valid.
  */
@@ -59,6 +68,43 @@ class IPMetric
   template<typename VecTypeA, typename VecTypeB>
   typename VecTypeA::elem_type Evaluate(const VecTypeA& a, const VecTypeB& b);
 
+  /**
+   * Compute and cache the self-kernel K(x, x) of each point of the given
+   * dataset, replacing any previous cache.  The dataset must not be modified or
+   * destroyed while the cache is set; call ClearSelfKernels() before that.
+   *
+   * @param dataset Dataset whose self-kernels are cached.
+   */
+  template<typename MatType>
+  void CacheSelfKernels(const MatType& dataset);
+
+  //! Clear the cached self-kernels.
+  void ClearSelfKernels();
+
+  /**
+   * Return whether the self-kernels of the given dataset are cached.
+   *
+   * @param dataset Dataset to check.
+   */
+  template<typename MatType>
+  bool SelfKernelsCached(const MatType& dataset) const
+  {
+    return (cachedDataset == (const void*) &dataset) &&
+        (selfKernels.n_elem == dataset.n_cols);
+  }
+
+  /**
+   * Return the self-kernel K(x, x) of the given point, from the cache if the
+   * point is a column of the cached dataset.
+   *
+   * @param point Point to evaluate.
+   */
+  template<typename VecType>
+  double SelfKernel(const VecType& point) const;
+
+  //! Get the cached self-kernels (empty if there is no cache).
+  const arma::vec& SelfKernels() const { return selfKernels; }
+
   //! Get the kernel.
   const KernelType& Kernel() const { return *kernel; }
   //! Modify the kernel.
@@ -73,6 +119,21 @@ class IPMetric
   KernelType* kernel;
   //! If true, we are responsible for deleting the kernel.
   bool kernelOwner;
+  //! The cached self-kernels (empty if there is no cache).
+  arma::vec selfKernels;
+  //! The dataset whose self-kernels are cached.
+  const void* cachedDataset;
+
+  //! Return the cached self-kernel of a column of the cached dataset, or NULL.
+  template<typename eT>
+  const double* CachedSelfKernel(const arma::subview_col<eT>& point) const;
+
+  //! Other points are not cached.
+  template<typename VecType>
+  const double* CachedSelfKernel(const VecType& /* point */) const
+  {
+    return NULL;
+  }
 };
 
 } // namespace metric
@@ -25,7 +25,8 @@ namespace metric {
 template<typename KernelType>
 IPMetric<KernelType>::IPMetric() :
     kernel(new KernelType()),
-    kernelOwner(true)
+    kernelOwner(true),
+    cachedDataset(NULL)
 {
   // Nothing to do.
 }
@@ -34,7 +35,8 @@ IPMetric<KernelType>::IPMetric() :
 template<typename KernelType>
 IPMetric<KernelType>::IPMetric(KernelType& kernel) :
     kernel(&kernel),
-    kernelOwner(false)
+    kernelOwner(false),
+    cachedDataset(NULL)
 {
   // Nothing to do.
 }
@@ -50,7 +52,9 @@ IPMetric<KernelType>::~IPMetric()
 template<typename KernelType>
 IPMetric<KernelType>::IPMetric(const IPMetric& other) :
   kernel(new KernelType(*other.kernel)),
-  kernelOwner(true)
+  kernelOwner(true),
+  selfKernels(other.selfKernels),
+  cachedDataset(other.cachedDataset)
 {
   // Nothing to do.
 }
@@ -66,6 +70,8 @@ IPMetric<KernelType>& IPMetric<KernelType>::operator=(const IPMetric& other)
 
   kernel = new KernelType(*other.kernel);
   kernelOwner = true;
+  selfKernels = other.selfKernels;
+  cachedDataset = other.cachedDataset;
   return *this;
 }
 
@@ -75,10 +81,54 @@ inline typename Vec1Type::elem_type IPMetric<KernelType>::Evaluate(
     const Vec1Type& a,
     const Vec2Type& b)
 {
-  // This is the metric induced by the kernel function.
-  // Maybe we can do better by caching some of this?
-  return sqrt(kernel->Evaluate(a, a) + kernel->Evaluate(b, b) -
-      2 * kernel->Evaluate(a, b));
+  // This is the metric induced by the kernel function.  The self-kernels may
+  // be cached.
+  return sqrt(SelfKernel(a) + SelfKernel(b) - 2 * kernel->Evaluate(a, b));
+}
+
+template<typename KernelType>
+template<typename MatType>
+void IPMetric<KernelType>::CacheSelfKernels(const MatType& dataset)
+{
+  // Clear the old cache first, so that it is not used while computing the new
+  // one.
+  ClearSelfKernels();
+
+  arma::vec kernels(dataset.n_cols);
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+    kernels[i] = kernel->Evaluate(dataset.col(i), dataset.col(i));
+
+  selfKernels = std::move(kernels);
+  cachedDataset = &dataset;
+}
+
+template<typename KernelType>
+void IPMetric<KernelType>::ClearSelfKernels()
+{
+  selfKernels.reset();
+  cachedDataset = NULL;
+}
+
+template<typename KernelType>
+template<typename VecType>
+inline double IPMetric<KernelType>::SelfKernel(const VecType& point) const
+{
+  const double* cached = CachedSelfKernel(point);
+  return (cached != NULL) ? *cached : kernel->Evaluate(point, point);
+}
+
+template<typename KernelType>
+template<typename eT>
+inline const double* IPMetric<KernelType>::CachedSelfKernel(
+    const arma::subview_col<eT>& point) const
+{
+  // Only whole columns of the cached dataset are cached.
+  if (cachedDataset != (const void*) &point.m ||
+      point.n_rows != point.m.n_rows ||
+      point.aux_col1 >= selfKernels.n_elem)
+    return NULL;
+
+  return &selfKernels[point.aux_col1];
 }
 
 // Serialize the kernel.
@@ -94,6 +144,9 @@ void IPMetric<KernelType>::serialize(Archive& ar,
     if (kernelOwner)
       delete kernel;
     kernelOwner = true;
+
+    // The cache refers to a dataset, and is not serialized.
+    ClearSelfKernels();
   }
 
   ar & BOOST_SERIALIZATION_NVP(kernel);
@@ -83,6 +83,27 @@ class LMetric
   static typename VecTypeA::elem_type Evaluate(const VecTypeA& a,
                                                const VecTypeB& b);
 
+  /**
+   * Computes the distances between one point and every column of a block of
+   * points, such as the points held in a leaf of a tree.  For the L1, L2 and
+   * L-infinity metrics the inner loops are written so that the compiler can
+   * vectorize them (with OpenMP SIMD directives when OpenMP is available);
+   * other powers evaluate each column with Evaluate().
+   *
+   * Both the point and the block must be dense and stored contiguously by
+   * column (e.g. arma::vec/arma::mat, or subviews of columns).
+   *
+   * @tparam VecType Type of the point (generally arma::vec).
+   * @tparam MatType Type of the block (generally arma::mat).
+   * @param a Point to compute distances from.
+   * @param block Block of points; each column is one point.
+   * @param distances Vector to store the block.n_cols distances in.
+   */
+  template<typename VecType, typename MatType>
+  static void Evaluate(const VecType& a,
+                       const MatType& block,
+                       arma::Col<typename MatType::elem_type>& distances);
+
   //! Serialize the metric (nothing to do).
   template<typename Archive>
   void serialize(Archive& /* ar */, const unsigned int /* version */) { }
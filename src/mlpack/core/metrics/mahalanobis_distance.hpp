@@ -37,10 +37,11 @@ namespace metric {
  *
  * If you wish to use the KNN class or other tree-based algorithms with this
  * distance, it is recommended to instead stretch the dataset first, by
- * decomposing Q = L^T L (perhaps via a Cholesky decomposition), and then
- * multiply the data by L.  If you still wish to use the KNN class with a custom
- * distance anyway, you will need to use a different tree type than the default
- * KDTree, which only works with the LMetric class.
+ * decomposing Q = L^T L (see Transformation()), and then multiply the data by
+ * L; MahalanobisSearch does this for NeighborSearch and RangeSearch.  If you
+ * still wish to use the KNN class with a custom distance anyway, you will need
+ * to use a different tree type than the default KDTree, which only works with
+ * the LMetric class.
  *
  * Similar to the LMetric class, this offers a template parameter TakeRoot
  * which, when set to false, will instead evaluate the distance
@@ -110,6 +111,15 @@ class MahalanobisDistance
    */
   arma::mat& Covariance() { return covariance; }
 
+  /**
+   * Compute a matrix L such that Q = L^T L, so that the (rooted) distance
+   * between x and y is the Euclidean distance between L x and L y.  L is the
+   * Cholesky factor of Q; if Q is only positive semidefinite, L is computed
+   * from the eigendecomposition of Q instead.  If the covariance has not been
+   * set, an empty matrix (meaning the identity) is returned.
+   */
+  arma::mat Transformation() const;
+
   //! Serialize the Mahalanobis distance.
   template<typename Archive>
   void serialize(Archive& ar, const unsigned int version);
@@ -47,6 +47,33 @@ double MahalanobisDistance<true>::Evaluate(const VecTypeA& a,
   return sqrt(out[0]);
 }
 
+template<bool TakeRoot>
+arma::mat MahalanobisDistance<TakeRoot>::Transformation() const
+{
+  if (covariance.n_elem == 0)
+    return arma::mat();
+
+  // The Cholesky factor is upper triangular, with Q = L^T L.
+  arma::mat transformation;
+  if (arma::chol(transformation, covariance))
+    return transformation;
+
+  // Q = V diag(lambda) V^T, so L = diag(sqrt(lambda)) V^T; the negative
+  // eigenvalues left by rounding errors are set to zero.
+  arma::vec eigenvalues;
+  arma::mat eigenvectors;
+  if (!arma::eig_sym(eigenvalues, eigenvectors, covariance))
+  {
+    throw std::invalid_argument("MahalanobisDistance::Transformation(): "
+        "eigendecomposition of the covariance failed!");
+  }
+
+  transformation = eigenvectors.t();
+  transformation.each_col() %= arma::sqrt(arma::clamp(eigenvalues, 0.0,
+      arma::datum::inf));
+  return transformation;
+}
+
 // Serialize the Mahalanobis distance.
 template<bool TakeRoot>
 template<typename Archive>
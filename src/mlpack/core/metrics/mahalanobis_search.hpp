@@ -0,0 +1,171 @@
+/**
+ * @file core/metrics/mahalanobis_search.hpp
+ *
+ * Definition of MahalanobisSearch, which runs a Euclidean search (such as
+ * NeighborSearch or RangeSearch) on data transformed so that its Euclidean
+ * distances are the distances of a MahalanobisDistance.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_METRICS_MAHALANOBIS_SEARCH_HPP
+#define MLPACK_CORE_METRICS_MAHALANOBIS_SEARCH_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "mahalanobis_distance.hpp"
+
+namespace mlpack {
+namespace metric {
+
+/**
+ * MahalanobisSearch wraps a search that uses the Euclidean distance, such as
+ * NeighborSearch or RangeSearch with metric::EuclideanDistance, so that it
+ * searches with a MahalanobisDistance instead.  The covariance Q of the
+ * distance is decomposed once as Q = L^T L, and the reference set and every
+ * query set are multiplied by L; then
+ *
+ *   d(x, y) = sqrt((x - y)^T Q (x - y)) = || L x - L y ||,
+ *
+ * so the wrapped search can use its trees (whose bounds need an LMetric), and
+ * each distance costs O(d) instead of O(d^2).  The distances (and ranges) are
+ * those of MahalanobisDistance<true>, and the indices of the results are
+ * indices of the original reference set.  For example:
+ *
+ * @code
+ * // A metric learned by LMNN or given as a covariance.
+ * MahalanobisDistance<> distance(covariance);
+ * MahalanobisSearch<KNN> knn(referenceSet, distance);
+ * knn.Search(querySet, 5, neighbors, distances);
+ *
+ * MahalanobisSearch<RangeSearch<>> rs(referenceSet, distance);
+ * rs.Search(querySet, math::Range(0.0, 2.0), rangeNeighbors, rangeDistances);
+ * @endcode
+ *
+ * Every overload of Search() of the wrapped search is available: the query set
+ * (when there is one) is transformed, and the other arguments are passed
+ * unchanged.
+ *
+ * @tparam SearchType Type of the Euclidean search.
+ * @tparam MatType Type of the datasets.
+ */
+template<typename SearchType, typename MatType = arma::mat>
+class MahalanobisSearch
+{
+ public:
+  /**
+   * Build the search on the given reference set, with the given distance.  The
+   * other arguments are passed to the constructor of the wrapped search, after
+   * the transformed reference set.
+   *
+   * @param referenceSet Set of reference points.
+   * @param distance Mahalanobis distance to search with.
+   * @param args Other arguments of the constructor of the search.
+   */
+  template<typename... Args>
+  MahalanobisSearch(const MatType& referenceSet,
+                    const MahalanobisDistance<true>& distance,
+                    Args&&... args) :
+      distance(distance),
+      transformation(distance.Transformation()),
+      search(Transform(referenceSet), std::forward<Args>(args)...)
+  { }
+
+  /**
+   * Create the search without a reference set; call Train() before searching.
+   *
+   * @param distance Mahalanobis distance to search with.
+   */
+  MahalanobisSearch(const MahalanobisDistance<true>& distance) :
+      distance(distance),
+      transformation(distance.Transformation())
+  { }
+
+  /**
+   * Set the reference set of the search.
+   *
+   * @param referenceSet Set of reference points.
+   */
+  void Train(const MatType& referenceSet)
+  {
+    search.Train(Transform(referenceSet));
+  }
+
+  /**
+   * Search for the given query points, which are transformed first.  The other
+   * arguments (for instance the number of neighbors or the range, and the
+   * results) are those of the wrapped search.
+   *
+   * @param querySet Set of query points.
+   * @param args The other arguments of Search() of the search.
+   */
+  template<typename... Args>
+  void Search(const MatType& querySet, Args&&... args)
+  {
+    search.Search(Transform(querySet), std::forward<Args>(args)...);
+  }
+
+  /**
+   * Search with every point of the reference set (or with any other overload
+   * of Search() whose first argument is not a query set); the arguments are
+   * passed unchanged.
+   *
+   * @param first First argument of Search() of the search.
+   * @param args The other arguments of Search() of the search.
+   */
+  template<typename FirstType, typename... Args>
+  typename std::enable_if<!std::is_same<typename std::decay<FirstType>::type,
+      MatType>::value>::type
+  Search(FirstType&& first, Args&&... args)
+  {
+    search.Search(std::forward<FirstType>(first),
+        std::forward<Args>(args)...);
+  }
+
+  /**
+   * Return the given points, transformed so that the Euclidean distances
+   * between them are their Mahalanobis distances.
+   *
+   * @param points Points to transform.
+   */
+  MatType Transform(const MatType& points) const
+  {
+    if (transformation.n_elem == 0)
+      return points;
+
+    if (points.n_rows != transformation.n_cols)
+    {
+      std::ostringstream oss;
+      oss << "MahalanobisSearch::Transform(): the points have "
+          << points.n_rows << " dimensions but the covariance has "
+          << transformation.n_cols << "!";
+      throw std::invalid_argument(oss.str());
+    }
+
+    return transformation * points;
+  }
+
+  //! Get the Mahalanobis distance.
+  const MahalanobisDistance<true>& Distance() const { return distance; }
+  //! Get the transformation L (empty for the identity).
+  const arma::mat& Transformation() const { return transformation; }
+
+  //! Get the wrapped search.
+  const SearchType& Searcher() const { return search; }
+  //! Modify the wrapped search.
+  SearchType& Searcher() { return search; }
+
+ private:
+  //! The Mahalanobis distance.
+  MahalanobisDistance<true> distance;
+  //! The transformation L, with Q = L^T L (empty for the identity).
+  arma::mat transformation;
+  //! The Euclidean search on the transformed points.
+  SearchType search;
+};
+
+} // namespace metric
+} // namespace mlpack
+
+#endif
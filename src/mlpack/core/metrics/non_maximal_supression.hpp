@@ -44,7 +44,11 @@ class NMS
   NMS() { /* Nothing to do here. */ }
 
   /**
-   * Performs non-maximal suppression.
+   * Performs non-maximal suppression.  The IoU of each pair of bounding boxes
+   * is computed once, in parallel, into a bitmask of the pairs that overlap
+   * by more than the threshold; the greedy suppression then only combines
+   * words of the bitmask.  The bitmask takes n^2 / 8 bytes for n bounding
+   * boxes.
    *
    * @param boundingBoxes Column major representation of bounding boxes
    *                      i.e. Each column corresponds to a different bounding
@@ -35,93 +35,79 @@ void NMS<UseCoordinates>::Evaluate(
       box either in {x1, y1, x2, y2} or {x1, y1, h, w} format.\
       Refer to the documentation for more information.");
 
-  Log::Assert(confidenceScores.n_cols != boundingBoxes.n_cols, "Each \
+  Log::Assert(confidenceScores.n_elem == boundingBoxes.n_cols, "Each \
       bounding box must correspond to atleast and only 1 bounding box. \
-      Found " + std::to_string(confidenceScores.n_cols) + " confidence \
+      Found " + std::to_string(confidenceScores.n_elem) + " confidence \
       scores for " + std::to_string(boundingBoxes.n_cols) + " bounding boxes.");
 
-  // Clear selected bounding boxes.
-  selectedIndices.clear();
+  typedef typename BoundingBoxesType::elem_type ElemType;
+  const size_t n = boundingBoxes.n_cols;
 
-  // Obtain Sorted indices for bounding boxes according to
-  // their confidence scores.
-  arma::ucolvec sortedIndices = arma::sort_index(confidenceScores);
+  // Obtain sorted indices for bounding boxes in descending order of their
+  // confidence scores.
+  const arma::uvec sortedIndices = arma::stable_sort_index(confidenceScores,
+      "descend");
 
-  // Pre-Compute area of each bounding box.
-  arma::mat area;
-  if (UseCoordinates)
+  // Get the coordinates of the sorted bounding boxes, and their areas.
+  arma::Mat<ElemType> boxes = boundingBoxes.cols(sortedIndices);
+  if (!UseCoordinates)
   {
-    area = (boundingBoxes.row(2) - boundingBoxes.row(0)) %
-        (boundingBoxes.row(3) - boundingBoxes.row(1));
+    // Change height - width representation to coordinate represention.
+    boxes.row(2) += boxes.row(0);
+    boxes.row(3) += boxes.row(1);
   }
-  else
+  const arma::Row<ElemType> area = (boxes.row(2) - boxes.row(0)) %
+      (boxes.row(3) - boxes.row(1));
+
+  // Bit j % 64 of word j / 64 of row i of the mask is set if bounding box j
+  // has an IoU greater than the threshold with bounding box i (for j > i, in
+  // sorted order).  The rows are independent, so they are computed in
+  // parallel.
+  const size_t words = (n + 63) / 64;
+  std::vector<uint64_t> mask(n * words, 0);
+  #pragma omp parallel for schedule(dynamic, 16)
+  for (omp_size_t i = 0; i < (omp_size_t) n; ++i)
   {
-    area = boundingBoxes.row(2) % boundingBoxes.row(3);
-  }
-
-  while (sortedIndices.n_elem > 0)
-  {
-    size_t selectedIndex = sortedIndices(sortedIndices.n_elem - 1);
+    const ElemType x1 = boxes(0, i);
+    const ElemType y1 = boxes(1, i);
+    const ElemType x2 = boxes(2, i);
+    const ElemType y2 = boxes(3, i);
 
-    // Choose the box with the largest probability.
-    selectedIndices.insert_rows(0, arma::uvec(1).fill(selectedIndex));
-
-    // Check if there are other bounding boxes to compare with.
-    if (sortedIndices.n_elem == 1)
+    for (size_t w = (i + 1) / 64; w < words; ++w)
     {
-      break;
+      uint64_t bits = 0;
+      const size_t begin = std::max(w * 64, (size_t) i + 1);
+      const size_t end = std::min((w + 1) * 64, n);
+      for (size_t j = begin; j < end; ++j)
+      {
+        const ElemType width = std::max(ElemType(0), std::min(x2,
+            boxes(2, j)) - std::max(x1, boxes(0, j)));
+        const ElemType height = std::max(ElemType(0), std::min(y2,
+            boxes(3, j)) - std::max(y1, boxes(1, j)));
+        const ElemType intersectionArea = width * height;
+        const double iou = intersectionArea / (area[i] + area[j] -
+            intersectionArea);
+        bits |= uint64_t(iou > threshold) << (j - w * 64);
+      }
+      mask[i * words + w] = bits;
     }
+  }
 
-    // Remove the last index.
-    sortedIndices = sortedIndices(arma::span(0, sortedIndices.n_rows - 2),
-        arma::span());
-
-    // Get x and y coordinates for remaining bounding boxes.
-    BoundingBoxesType x2 = boundingBoxes.submat(arma::uvec(1).fill(2),
-        sortedIndices);
-
-    BoundingBoxesType x1 = boundingBoxes.submat(arma::uvec(1).fill(0),
-        sortedIndices);;
-
-    BoundingBoxesType y2 = boundingBoxes.submat(arma::uvec(1).fill(3),
-        sortedIndices);
-
-    BoundingBoxesType y1 = boundingBoxes.submat(arma::uvec(1).fill(1),
-        sortedIndices);
-
-    size_t selectedX2 = boundingBoxes(2, selectedIndex);
-    size_t selectedY2 = boundingBoxes(3, selectedIndex);
-    size_t selectedX1 = boundingBoxes(0, selectedIndex);
-    size_t selectedY1 = boundingBoxes(1, selectedIndex);
-
-    if (!UseCoordinates)
-    {
-      // Change height - width representation to coordinate represention.
-      x2 = x2 + x1;
-      y2 = y2 + y1;
-      selectedX2 = selectedX2 + selectedX1;
-      selectedY2 = selectedY2 + selectedY1;
-    }
-
-    // Calculate points of intersection between the bounding box with
-    // highest confidence score and remaining bounding boxes.
-    x2 = arma::clamp(x2, DBL_MIN, selectedX2);
-    y2 = arma::clamp(y2, DBL_MIN, selectedY2);
-    x1 = arma::clamp(x1, selectedX1, DBL_MAX);
-    y1 = arma::clamp(y1, selectedY1, DBL_MAX);
-
-    BoundingBoxesType intersectionArea = arma::clamp(x2 - x1, 0.0, DBL_MAX) %
-          arma::clamp(y2 - y1, 0.0, DBL_MAX);
-
-    // Calculate IoU of remaining boxes with the last bounding box with
-    // the highest confidence score.
-    BoundingBoxesType calculateIoU = intersectionArea /
-        (area(sortedIndices).t() - intersectionArea + area(selectedIndex));
+  // Greedily choose the box with the largest confidence score that has not
+  // been suppressed yet, and suppress the boxes that overlap it.
+  std::vector<uint64_t> suppressed(words, 0);
+  std::vector<arma::uword> selected;
+  for (size_t i = 0; i < n; ++i)
+  {
+    if ((suppressed[i / 64] >> (i % 64)) & 1)
+      continue;
 
-    sortedIndices = sortedIndices(arma::find(calculateIoU <= threshold));
+    selected.push_back(sortedIndices[i]);
+    for (size_t w = i / 64; w < words; ++w)
+      suppressed[w] |= mask[i * words + w];
   }
 
-  selectedIndices = arma::flipud(selectedIndices);
+  selectedIndices = arma::conv_to<OutputType>::from(selected);
 }
 
 template<bool UseCoordinates>
@@ -127,16 +127,26 @@ void PointToAddress(AddressType& address, const VecType& point)
   address.zeros(point.n_elem);
 
   // Interleave the bits of the new representation across all the elements
-  // in the address vector.
+  // in the address vector.  Bit i of element j is bit (i * n_elem + j) of the
+  // address; the bits are written in that order, so each element of the
+  // address is filled in a register and stored once.
+  size_t row = 0;
+  size_t bit = 0;
+  AddressElemType word = 0;
   for (size_t i = 0; i < order; ++i)
+  {
+    const size_t shift = order - 1 - i;
     for (size_t j = 0; j < point.n_elem; ++j)
     {
-      size_t bit = (i * point.n_elem + j) % order;
-      size_t row = (i * point.n_elem + j) / order;
-
-      address(row) |= (((result(j) >> (order - 1 - i)) & 1) <<
-          (order - 1 - bit));
+      word = (word << 1) | ((result(j) >> shift) & 1);
+      if (++bit == order)
+      {
+        address(row++) = word;
+        word = 0;
+        bit = 0;
+      }
     }
+  }
 }
 
 /**
@@ -176,15 +186,24 @@ void AddressToPoint(VecType& point, const AddressType& address)
   // Calculate the number of bits for the mantissa.
   const int numMantBits = order - numExpBits - 1;
 
+  // Undo the interleaving, reading the bits of the address in order.
+  size_t row = 0;
+  size_t bit = 0;
+  AddressElemType word = address(0);
   for (size_t i = 0; i < order; ++i)
+  {
+    const size_t shift = order - 1 - i;
     for (size_t j = 0; j < address.n_elem; ++j)
     {
-      size_t bit = (i * address.n_elem + j) % order;
-      size_t row = (i * address.n_elem + j) / order;
-
-      rearrangedAddress(j) |= (((address(row) >> (order - 1 - bit)) & 1) <<
-          (order - 1 - i));
+      rearrangedAddress(j) |= ((word >> (order - 1)) & 1) << shift;
+      word <<= 1;
+      if (++bit == order && ++row < address.n_elem)
+      {
+        word = address(row);
+        bit = 0;
+      }
     }
+  }
 
   for (size_t i = 0; i < rearrangedAddress.n_elem; ++i)
   {
@@ -137,6 +137,16 @@ class BallBound
    */
   ElemType MinDistance(const BallBound& other) const;
 
+  /**
+   * Calculates the minimum distance to each of the given bounds at once (for
+   * instance, to the bounds of all of the children of a node).
+   *
+   * @param others Bounds to which the minimum distances are requested.
+   * @param distances The minimum distance to each bound.
+   */
+  void MinDistance(const std::vector<const BallBound*>& others,
+                   arma::Col<ElemType>& distances) const;
+
   /**
    * Computes maximum distance.
    *
@@ -175,6 +185,19 @@ class BallBound
    */
   math::RangeType<ElemType> RangeDistance(const BallBound& other) const;
 
+  /**
+   * Calculates the minimum and maximum distances to each of the given bounds
+   * at once (for instance, to the bounds of all of the children of a node).
+   * The distance between the centers is computed once for each bound.
+   *
+   * @param others Bounds to which the distances are requested.
+   * @param minDistances The minimum distance to each bound.
+   * @param maxDistances The maximum distance to each bound.
+   */
+  void RangeDistance(const std::vector<const BallBound*>& others,
+                     arma::Col<ElemType>& minDistances,
+                     arma::Col<ElemType>& maxDistances) const;
+
   /**
    * Expand the bound to include the given node.
    */
@@ -157,6 +157,19 @@ BallBound<MetricType, VecType>::MinDistance(const BallBound& other)
   }
 }
 
+/**
+ * Calculates the minimum distance to each of the given bounds.
+ */
+template<typename MetricType, typename VecType>
+void BallBound<MetricType, VecType>::MinDistance(
+    const std::vector<const BallBound*>& others,
+    arma::Col<ElemType>& distances) const
+{
+  distances.set_size(others.size());
+  for (size_t j = 0; j < others.size(); ++j)
+    distances[j] = MinDistance(*others[j]);
+}
+
 /**
  * Computes maximum distance.
  */
@@ -227,6 +240,25 @@ BallBound<MetricType, VecType>::RangeDistance(
   }
 }
 
+/**
+ * Calculates the minimum and maximum distances to each of the given bounds.
+ */
+template<typename MetricType, typename VecType>
+void BallBound<MetricType, VecType>::RangeDistance(
+    const std::vector<const BallBound*>& others,
+    arma::Col<ElemType>& minDistances,
+    arma::Col<ElemType>& maxDistances) const
+{
+  minDistances.set_size(others.size());
+  maxDistances.set_size(others.size());
+  for (size_t j = 0; j < others.size(); ++j)
+  {
+    const math::RangeType<ElemType> range = RangeDistance(*others[j]);
+    minDistances[j] = range.Lo();
+    maxDistances[j] = range.Hi();
+  }
+}
+
 /**
  * Expand the bound to include the given bound.
  *
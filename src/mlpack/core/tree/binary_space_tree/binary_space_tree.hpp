@@ -15,6 +15,9 @@
 
 #include "../statistic.hpp"
 #include "midpoint_split.hpp"
+#include "split_traits.hpp"
+#include "heap_node_allocator.hpp"
+#include "contiguous_node_allocator.hpp"
 
 namespace mlpack {
 namespace tree /** Trees and tree-building procedures. */ {
@@ -43,6 +46,10 @@ namespace tree /** Trees and tree-building procedures. */ {
  * @tparam SplitType The class that partitions the dataset/points at a
  *     particular node into two parts. Its definition decides the way this split
  *     is done.
+ * @tparam NodeAllocatorType The policy that owns the memory of the nodes.
+ *     HeapNodeAllocator, the default, allocates each node separately;
+ *     ContiguousNodeAllocator packs the built tree into one block, in
+ *     depth-first order.
  */
 template<typename MetricType,
          typename StatisticType = EmptyStatistic,
@@ -50,8 +57,9 @@ template<typename MetricType,
          template<typename BoundMetricType, typename...> class BoundType =
             bound::HRectBound,
          template<typename SplitBoundType, typename SplitMatType>
-            class SplitType = MidpointSplit>
-class BinarySpaceTree
+            class SplitType = MidpointSplit,
+         typename NodeAllocatorType = HeapNodeAllocator>
+class BinarySpaceTree : private NodeAllocatorType
 {
  public:
   //! So other classes can use TreeType::Mat.
@@ -102,6 +110,11 @@ class BinarySpaceTree
   template<typename RuleType>
   class BreadthFirstDualTreeTraverser;
 
+  //! A level-synchronous parallel breadth-first dual-tree traverser; see
+  //! parallel_breadth_first_dual_tree_traverser.hpp.
+  template<typename RuleType>
+  class ParallelBreadthFirstDualTreeTraverser;
+
   /**
    * Construct this as the root node of a binary space tree using the given
    * dataset.  This will copy the input matrix; if you don't want this, consider
@@ -308,6 +321,23 @@ class BinarySpaceTree
       Archive& ar,
       const typename std::enable_if_t<Archive::is_loading::value>* = 0);
 
+  /**
+   * Initialize the tree from a boost::serialization archive that was written
+   * with SaveStructure(), using the given matrix as the dataset.  The dataset
+   * is not copied: the tree takes ownership of the matrix object, but if the
+   * matrix uses auxiliary memory (e.g. from data::MappedMatrix::Alias()), that
+   * memory is never copied or freed by the tree.  The dataset must be the
+   * (rearranged) dataset of the tree that was saved.
+   *
+   * @param ar Archive to load tree from.  Must be an iarchive, not an oarchive.
+   * @param data Dataset of the tree; the tree takes ownership of this object.
+   */
+  template<typename Archive>
+  BinarySpaceTree(
+      Archive& ar,
+      MatType* data,
+      const typename std::enable_if_t<Archive::is_loading::value>* = 0);
+
   /**
    * Deletes this node, deallocating the memory for the children and calling
    * their destructors in turn.  This will invalidate any pointers or references
@@ -343,6 +373,11 @@ class BinarySpaceTree
   //! Modify the parent of this node.
   BinarySpaceTree*& Parent() { return parent; }
 
+  //! Get the node allocator of this node.
+  const NodeAllocatorType& NodeAllocator() const { return *this; }
+  //! Modify the node allocator of this node.  Be careful!
+  NodeAllocatorType& NodeAllocator() { return *this; }
+
   //! Get the dataset which the tree is built on.
   const MatType& Dataset() const { return *dataset; }
   //! Modify the dataset which the tree is built on.  Be careful!
@@ -507,6 +542,28 @@ class BinarySpaceTree
   //! Store the center of the bounding region in the given vector.
   void Center(arma::vec& center) const { bound.Center(center); }
 
+  /**
+   * Recompute the bounds of this node and all of its descendants after the
+   * points of the dataset were modified in place.  Every node keeps the points
+   * it holds, so this is much cheaper than building a new tree, and searches
+   * stay exact; but they get slower if the points have moved far from where
+   * the tree was built.  The statistics of the nodes are reinitialized.
+   */
+  void RefitBounds();
+
+  /**
+   * Get or modify the minimum number of points a node must hold for its two
+   * children to be built as separate OpenMP tasks.  Smaller nodes are built
+   * serially.  This only has an effect for splits whose SplitTraits mark them
+   * as ParallelSafe (MidpointSplit and MeanSplit); the resulting tree is the
+   * same either way.  The setting is shared by all trees of this type.
+   */
+  static size_t& ParallelBuildThreshold()
+  {
+    static size_t threshold = 10000;
+    return threshold;
+  }
+
  private:
   /**
    * Splits the current node, assigning its left and right children recursively.
@@ -529,6 +586,22 @@ class BinarySpaceTree
                  const size_t maxLeafSize,
                  SplitType<BoundType<MetricType>, MatType>& splitter);
 
+  /**
+   * Build the left and right children of the current node, which has already
+   * been partitioned at splitCol.  Large nodes build the two children as
+   * separate OpenMP tasks; see ParallelBuildThreshold().
+   *
+   * @param splitCol The first column that belongs to the right child.
+   * @param oldFromNew Vector holding permuted indices, or NULL if no mapping is
+   *     being kept.
+   * @param maxLeafSize Maximum number of points held in a leaf.
+   * @param splitter Instantiated SplitType object.
+   */
+  void BuildChildren(const size_t splitCol,
+                     std::vector<size_t>* oldFromNew,
+                     const size_t maxLeafSize,
+                     SplitType<BoundType<MetricType>, MatType>& splitter);
+
   /**
    * Update the bound of the current node. This method does not take into
    * account bound-specific properties.
@@ -564,6 +637,25 @@ class BinarySpaceTree
    */
   template<typename Archive>
   void serialize(Archive& ar, const unsigned int version);
+
+  /**
+   * Save the structure of the tree (bounds, statistics, and the points held by
+   * each node) but not its dataset.  The dataset should be saved separately
+   * (e.g. with data::SaveMapped()) and passed back when the tree is loaded
+   * with the corresponding constructor.
+   *
+   * @param ar Archive to save tree to.  Must be an oarchive.
+   */
+  template<typename Archive>
+  void SaveStructure(Archive& ar) const;
+
+ private:
+  /**
+   * Save or load the structure of this node and its descendants, without the
+   * dataset.  When loading, the given dataset is used for all nodes.
+   */
+  template<typename Archive>
+  void SerializeStructure(Archive& ar, MatType* data);
 };
 
 } // namespace tree
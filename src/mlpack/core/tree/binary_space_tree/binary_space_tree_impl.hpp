@@ -27,8 +27,10 @@ template<typename MetricType,
          typename MatType,
          template<typename BoundMetricType, typename...> class BoundType,
          template<typename SplitBoundType, typename SplitMatType>
-             class SplitType>
-BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+             class SplitType,
+         typename NodeAllocatorType>
+BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType,
+                NodeAllocatorType>::
 BinarySpaceTree(
     const MatType& data,
     const size_t maxLeafSize) :
@@ -47,6 +49,9 @@ BinarySpaceTree(
 
   // Create the statistic depending on if we are a leaf or not.
   stat = StatisticType(*this);
+
+  // The tree is built; let the allocator lay out the nodes.
+  NodeAllocatorType::Pack(this);
 }
 
 template<typename MetricType,
@@ -54,8 +59,10 @@ template<typename MetricType,
          typename MatType,
          template<typename BoundMetricType, typename...> class BoundType,
          template<typename SplitBoundType, typename SplitMatType>
-             class SplitType>
-BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+             class SplitType,
+         typename NodeAllocatorType>
+BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType,
+                NodeAllocatorType>::
 BinarySpaceTree(
     const MatType& data,
     std::vector<size_t>& oldFromNew,
@@ -80,6 +87,9 @@ BinarySpaceTree(
 
   // Create the statistic depending on if we are a leaf or not.
   stat = StatisticType(*this);
+
+  // The tree is built; let the allocator lay out the nodes.
+  NodeAllocatorType::Pack(this);
 }
 
 template<typename MetricType,
@@ -87,8 +97,10 @@ template<typename MetricType,
          typename MatType,
          template<typename BoundMetricType, typename...> class BoundType,
          template<typename SplitBoundType, typename SplitMatType>
-             class SplitType>
-BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+             class SplitType,
+         typename NodeAllocatorType>
+BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType,
+                NodeAllocatorType>::
 BinarySpaceTree(
     const MatType& data,
     std::vector<size_t>& oldFromNew,
@@ -119,6 +131,9 @@ BinarySpaceTree(
   newFromOld.resize(data.n_cols);
   for (size_t i = 0; i < data.n_cols; ++i)
     newFromOld[oldFromNew[i]] = i;
+
+  // The tree is built; let the allocator lay out the nodes.
+  NodeAllocatorType::Pack(this);
 }
 
 template<typename MetricType,
@@ -126,8 +141,10 @@ template<typename MetricType,
          typename MatType,
          template<typename BoundMetricType, typename...> class BoundType,
          template<typename SplitBoundType, typename SplitMatType>
-             class SplitType>
-BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+             class SplitType,
+         typename NodeAllocatorType>
+BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType,
+                NodeAllocatorType>::
 BinarySpaceTree(MatType&& data, const size_t maxLeafSize) :
     left(NULL),
     right(NULL),
@@ -144,6 +161,9 @@ BinarySpaceTree(MatType&& data, const size_t maxLeafSize) :
 
   // Create the statistic depending on if we are a leaf or not.
   stat = StatisticType(*this);
+
+  // The tree is built; let the allocator lay out the nodes.
+  NodeAllocatorType::Pack(this);
 }
 
 template<typename MetricType,
@@ -151,8 +171,10 @@ template<typename MetricType,
          typename MatType,
          template<typename BoundMetricType, typename...> class BoundType,
          template<typename SplitBoundType, typename SplitMatType>
-             class SplitType>
-BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+             class SplitType,
+         typename NodeAllocatorType>
+BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType,
+                NodeAllocatorType>::
 BinarySpaceTree(
     MatType&& data,
     std::vector<size_t>& oldFromNew,
@@ -177,6 +199,9 @@ BinarySpaceTree(
 
   // Create the statistic depending on if we are a leaf or not.
   stat = StatisticType(*this);
+
+  // The tree is built; let the allocator lay out the nodes.
+  NodeAllocatorType::Pack(this);
 }
 
 template<typename MetricType,
@@ -184,8 +209,10 @@ template<typename MetricType,
          typename MatType,
          template<typename BoundMetricType, typename...> class BoundType,
          template<typename SplitBoundType, typename SplitMatType>
-             class SplitType>
-BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+             class SplitType,
+         typename NodeAllocatorType>
+BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType,
+                NodeAllocatorType>::
 BinarySpaceTree(
     MatType&& data,
     std::vector<size_t>& oldFromNew,
@@ -216,6 +243,9 @@ BinarySpaceTree(
   newFromOld.resize(dataset->n_cols);
   for (size_t i = 0; i < dataset->n_cols; ++i)
     newFromOld[oldFromNew[i]] = i;
+
+  // The tree is built; let the allocator lay out the nodes.
+  NodeAllocatorType::Pack(this);
 }
 
 template<typename MetricType,
@@ -223,8 +253,10 @@ template<typename MetricType,
          typename MatType,
          template<typename BoundMetricType, typename...> class BoundType,
          template<typename SplitBoundType, typename SplitMatType>
-             class SplitType>
-BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+             class SplitType,
+         typename NodeAllocatorType>
+BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType,
+                NodeAllocatorType>::
 BinarySpaceTree(
     BinarySpaceTree* parent,
     const size_t begin,
@@ -251,8 +283,10 @@ template<typename MetricType,
          typename MatType,
          template<typename BoundMetricType, typename...> class BoundType,
          template<typename SplitBoundType, typename SplitMatType>
-             class SplitType>
-BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+             class SplitType,
+         typename NodeAllocatorType>
+BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType,
+                NodeAllocatorType>::
 BinarySpaceTree(
     BinarySpaceTree* parent,
     const size_t begin,
@@ -284,8 +318,10 @@ template<typename MetricType,
          typename MatType,
          template<typename BoundMetricType, typename...> class BoundType,
          template<typename SplitBoundType, typename SplitMatType>
-             class SplitType>
-BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+             class SplitType,
+         typename NodeAllocatorType>
+BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType,
+                NodeAllocatorType>::
 BinarySpaceTree(
     BinarySpaceTree* parent,
     const size_t begin,
@@ -327,8 +363,10 @@ template<typename MetricType,
          typename MatType,
          template<typename BoundMetricType, typename...> class BoundType,
          template<typename SplitBoundType, typename SplitMatType>
-             class SplitType>
-BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+             class SplitType,
+         typename NodeAllocatorType>
+BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType,
+                NodeAllocatorType>::
 BinarySpaceTree(
     const BinarySpaceTree& other) :
     left(NULL),
@@ -376,6 +414,8 @@ BinarySpaceTree(
       if (node->right)
         queue.push(node->right);
     }
+
+    NodeAllocatorType::Pack(this);
   }
 }
 
@@ -387,9 +427,12 @@ template<typename MetricType,
          typename MatType,
          template<typename BoundMetricType, typename...> class BoundType,
          template<typename SplitBoundType, typename SplitMatType>
-             class SplitType>
-BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>&
-BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+             class SplitType,
+         typename NodeAllocatorType>
+BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType,
+                NodeAllocatorType>&
+BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType,
+                NodeAllocatorType>::
 operator=(const BinarySpaceTree& other)
 {
   // Return if it's the same tree.
@@ -398,11 +441,8 @@ operator=(const BinarySpaceTree& other)
 
   // Freeing memory that will not be used anymore.
   delete dataset;
-  delete left;
-  delete right;
+  NodeAllocatorType::DeleteChildren(this);
 
-  left = NULL;
-  right = NULL;
   parent = other.Parent();
   begin = other.Begin();
   count = other.Count();
@@ -446,6 +486,8 @@ operator=(const BinarySpaceTree& other)
       if (node->right)
         queue.push(node->right);
     }
+
+    NodeAllocatorType::Pack(this);
   }
 
   return *this;
@@ -459,9 +501,12 @@ template<typename MetricType,
          typename MatType,
          template<typename BoundMetricType, typename...> class BoundType,
          template<typename SplitBoundType, typename SplitMatType>
-             class SplitType>
-BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>&
-BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+             class SplitType,
+         typename NodeAllocatorType>
+BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType,
+                NodeAllocatorType>&
+BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType,
+                NodeAllocatorType>::
 operator=(BinarySpaceTree&& other)
 {
   // Return if it's the same tree.
@@ -470,8 +515,8 @@ operator=(BinarySpaceTree&& other)
 
   // Freeing memory that will not be used anymore.
   delete dataset;
-  delete left;
-  delete right;
+  NodeAllocatorType::DeleteChildren(this);
+  NodeAllocatorType::operator=(std::move(other.NodeAllocator()));
 
   parent = other.Parent();
   left = other.Left();
@@ -507,9 +552,12 @@ template<typename MetricType,
          typename MatType,
          template<typename BoundMetricType, typename...> class BoundType,
          template<typename SplitBoundType, typename SplitMatType>
-             class SplitType>
-BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+             class SplitType,
+         typename NodeAllocatorType>
+BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType,
+                NodeAllocatorType>::
 BinarySpaceTree(BinarySpaceTree&& other) :
+    NodeAllocatorType(std::move(other.NodeAllocator())),
     left(other.left),
     right(other.right),
     parent(other.parent),
@@ -549,9 +597,11 @@ template<typename MetricType,
          typename MatType,
          template<typename BoundMetricType, typename...> class BoundType,
          template<typename SplitBoundType, typename SplitMatType>
-             class SplitType>
+             class SplitType,
+         typename NodeAllocatorType>
 template<typename Archive>
-BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType,
+                NodeAllocatorType>::
 BinarySpaceTree(
     Archive& ar,
     const typename std::enable_if_t<Archive::is_loading::value>*) :
@@ -562,6 +612,38 @@ BinarySpaceTree(
   ar >> BOOST_SERIALIZATION_NVP(*this);
 }
 
+/**
+ * Initialize the tree structure from an archive, using an external dataset.
+ */
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType,
+         typename NodeAllocatorType>
+template<typename Archive>
+BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType,
+                NodeAllocatorType>::
+BinarySpaceTree(
+    Archive& ar,
+    MatType* data,
+    const typename std::enable_if_t<Archive::is_loading::value>*) :
+    BinarySpaceTree() // Create an empty BinarySpaceTree.
+{
+  SerializeStructure(ar, data);
+  NodeAllocatorType::Pack(this);
+
+  if (begin + count > data->n_cols)
+  {
+    std::ostringstream oss;
+    oss << "BinarySpaceTree::BinarySpaceTree(): tree holds " << count
+        << " points, but the given dataset only has " << data->n_cols
+        << " columns!";
+    throw std::invalid_argument(oss.str());
+  }
+}
+
 /**
  * Deletes this node, deallocating the memory for the children and calling their
  * destructors in turn.  This will invalidate any pointers or references to any
@@ -572,12 +654,13 @@ template<typename MetricType,
          typename MatType,
          template<typename BoundMetricType, typename...> class BoundType,
          template<typename SplitBoundType, typename SplitMatType>
-             class SplitType>
-BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+             class SplitType,
+         typename NodeAllocatorType>
+BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType,
+                NodeAllocatorType>::
     ~BinarySpaceTree()
 {
-  delete left;
-  delete right;
+  NodeAllocatorType::DeleteChildren(this);
 
   // If we're the root, delete the matrix.
   if (!parent)
@@ -589,9 +672,10 @@ template<typename MetricType,
          typename MatType,
          template<typename BoundMetricType, typename...> class BoundType,
          template<typename SplitBoundType, typename SplitMatType>
-             class SplitType>
+             class SplitType,
+         typename NodeAllocatorType>
 inline bool BinarySpaceTree<MetricType, StatisticType, MatType, BoundType,
-                            SplitType>::IsLeaf() const
+                            SplitType, NodeAllocatorType>::IsLeaf() const
 {
   return !left;
 }
@@ -604,9 +688,10 @@ template<typename MetricType,
          typename MatType,
          template<typename BoundMetricType, typename...> class BoundType,
          template<typename SplitBoundType, typename SplitMatType>
-             class SplitType>
+             class SplitType,
+         typename NodeAllocatorType>
 inline size_t BinarySpaceTree<MetricType, StatisticType, MatType, BoundType,
-                              SplitType>::NumChildren() const
+                              SplitType, NodeAllocatorType>::NumChildren() const
 {
   if (left && right)
     return 2;
@@ -625,10 +710,11 @@ template<typename MetricType,
          typename MatType,
          template<typename BoundMetricType, typename...> class BoundType,
          template<typename SplitBoundType, typename SplitMatType>
-             class SplitType>
+             class SplitType,
+         typename NodeAllocatorType>
 template<typename VecType>
 size_t BinarySpaceTree<MetricType, StatisticType, MatType, BoundType,
-    SplitType>::GetNearestChild(
+    SplitType, NodeAllocatorType>::GetNearestChild(
     const VecType& point,
     typename std::enable_if_t<IsVector<VecType>::value>*)
 {
@@ -649,10 +735,11 @@ template<typename MetricType,
          typename MatType,
          template<typename BoundMetricType, typename...> class BoundType,
          template<typename SplitBoundType, typename SplitMatType>
-             class SplitType>
+             class SplitType,
+         typename NodeAllocatorType>
 template<typename VecType>
 size_t BinarySpaceTree<MetricType, StatisticType, MatType, BoundType,
-    SplitType>::GetFurthestChild(
+    SplitType, NodeAllocatorType>::GetFurthestChild(
     const VecType& point,
     typename std::enable_if_t<IsVector<VecType>::value>*)
 {
@@ -673,9 +760,11 @@ template<typename MetricType,
          typename MatType,
          template<typename BoundMetricType, typename...> class BoundType,
          template<typename SplitBoundType, typename SplitMatType>
-             class SplitType>
+             class SplitType,
+         typename NodeAllocatorType>
 size_t BinarySpaceTree<MetricType, StatisticType, MatType, BoundType,
-    SplitType>::GetNearestChild(const BinarySpaceTree& queryNode)
+    SplitType, NodeAllocatorType>::GetNearestChild(
+    const BinarySpaceTree& queryNode)
 {
   if (IsLeaf() || !left || !right)
     return 0;
@@ -698,9 +787,11 @@ template<typename MetricType,
          typename MatType,
          template<typename BoundMetricType, typename...> class BoundType,
          template<typename SplitBoundType, typename SplitMatType>
-             class SplitType>
+             class SplitType,
+         typename NodeAllocatorType>
 size_t BinarySpaceTree<MetricType, StatisticType, MatType, BoundType,
-    SplitType>::GetFurthestChild(const BinarySpaceTree& queryNode)
+    SplitType, NodeAllocatorType>::GetFurthestChild(
+    const BinarySpaceTree& queryNode)
 {
   if (IsLeaf() || !left || !right)
     return 0;
@@ -723,12 +814,13 @@ template<typename MetricType,
          typename MatType,
          template<typename BoundMetricType, typename...> class BoundType,
          template<typename SplitBoundType, typename SplitMatType>
-             class SplitType>
+             class SplitType,
+         typename NodeAllocatorType>
 inline
 typename BinarySpaceTree<MetricType, StatisticType, MatType, BoundType,
-    SplitType>::ElemType
+    SplitType, NodeAllocatorType>::ElemType
 BinarySpaceTree<MetricType, StatisticType, MatType, BoundType,
-    SplitType>::FurthestPointDistance() const
+    SplitType, NodeAllocatorType>::FurthestPointDistance() const
 {
   if (!IsLeaf())
     return 0.0;
@@ -749,12 +841,13 @@ template<typename MetricType,
          typename MatType,
          template<typename BoundMetricType, typename...> class BoundType,
          template<typename SplitBoundType, typename SplitMatType>
-             class SplitType>
+             class SplitType,
+         typename NodeAllocatorType>
 inline
 typename BinarySpaceTree<MetricType, StatisticType, MatType, BoundType,
-    SplitType>::ElemType
+    SplitType, NodeAllocatorType>::ElemType
 BinarySpaceTree<MetricType, StatisticType, MatType, BoundType,
-    SplitType>::FurthestDescendantDistance() const
+    SplitType, NodeAllocatorType>::FurthestDescendantDistance() const
 {
   return furthestDescendantDistance;
 }
@@ -765,12 +858,13 @@ template<typename MetricType,
          typename MatType,
          template<typename BoundMetricType, typename...> class BoundType,
          template<typename SplitBoundType, typename SplitMatType>
-             class SplitType>
+             class SplitType,
+         typename NodeAllocatorType>
 inline
 typename BinarySpaceTree<MetricType, StatisticType, MatType, BoundType,
-    SplitType>::ElemType
+    SplitType, NodeAllocatorType>::ElemType
 BinarySpaceTree<MetricType, StatisticType, MatType, BoundType,
-    SplitType>::MinimumBoundDistance() const
+    SplitType, NodeAllocatorType>::MinimumBoundDistance() const
 {
   return bound.MinWidth() / 2.0;
 }
@@ -783,11 +877,13 @@ template<typename MetricType,
          typename MatType,
          template<typename BoundMetricType, typename...> class BoundType,
          template<typename SplitBoundType, typename SplitMatType>
-             class SplitType>
+             class SplitType,
+         typename NodeAllocatorType>
 inline BinarySpaceTree<MetricType, StatisticType, MatType, BoundType,
-                       SplitType>&
+                       SplitType, NodeAllocatorType>&
     BinarySpaceTree<MetricType, StatisticType, MatType, BoundType,
-                    SplitType>::Child(const size_t child) const
+                    SplitType,
+                    NodeAllocatorType>::Child(const size_t child) const
 {
   if (child == 0)
     return *left;
@@ -803,9 +899,10 @@ template<typename MetricType,
          typename MatType,
          template<typename BoundMetricType, typename...> class BoundType,
          template<typename SplitBoundType, typename SplitMatType>
-             class SplitType>
+             class SplitType,
+         typename NodeAllocatorType>
 inline size_t BinarySpaceTree<MetricType, StatisticType, MatType, BoundType,
-                              SplitType>::NumPoints() const
+                              SplitType, NodeAllocatorType>::NumPoints() const
 {
   if (left)
     return 0;
@@ -821,9 +918,11 @@ template<typename MetricType,
          typename MatType,
          template<typename BoundMetricType, typename...> class BoundType,
          template<typename SplitBoundType, typename SplitMatType>
-             class SplitType>
+             class SplitType,
+         typename NodeAllocatorType>
 inline size_t BinarySpaceTree<MetricType, StatisticType, MatType, BoundType,
-                              SplitType>::NumDescendants() const
+                              SplitType,
+                              NodeAllocatorType>::NumDescendants() const
 {
   return count;
 }
@@ -836,9 +935,11 @@ template<typename MetricType,
          typename MatType,
          template<typename BoundMetricType, typename...> class BoundType,
          template<typename SplitBoundType, typename SplitMatType>
-             class SplitType>
+             class SplitType,
+         typename NodeAllocatorType>
 inline size_t BinarySpaceTree<MetricType, StatisticType, MatType, BoundType,
-                              SplitType>::Descendant(const size_t index) const
+                              SplitType, NodeAllocatorType>::Descendant(
+    const size_t index) const
 {
   return (begin + index);
 }
@@ -851,9 +952,11 @@ template<typename MetricType,
          typename MatType,
          template<typename BoundMetricType, typename...> class BoundType,
          template<typename SplitBoundType, typename SplitMatType>
-             class SplitType>
+             class SplitType,
+         typename NodeAllocatorType>
 inline size_t BinarySpaceTree<MetricType, StatisticType, MatType, BoundType,
-                              SplitType>::Point(const size_t index) const
+                              SplitType, NodeAllocatorType>::Point(
+    const size_t index) const
 {
   return (begin + index);
 }
@@ -863,8 +966,10 @@ template<typename MetricType,
          typename MatType,
          template<typename BoundMetricType, typename...> class BoundType,
          template<typename SplitBoundType, typename SplitMatType>
-             class SplitType>
-void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+             class SplitType,
+         typename NodeAllocatorType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType,
+                     NodeAllocatorType>::
     SplitNode(const size_t maxLeafSize,
               SplitType<BoundType<MetricType>, MatType>& splitter)
 {
@@ -904,10 +1009,7 @@ void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
 
   // Now that we know the split column, we will recursively split the children
   // by calling their constructors (which perform this splitting process).
-  left = new BinarySpaceTree(this, begin, splitCol - begin, splitter,
-      maxLeafSize);
-  right = new BinarySpaceTree(this, splitCol, begin + count - splitCol,
-      splitter, maxLeafSize);
+  BuildChildren(splitCol, NULL, maxLeafSize, splitter);
 
   // Calculate parent distances for those two nodes.
   arma::vec center, leftCenter, rightCenter;
@@ -929,8 +1031,10 @@ template<typename MetricType,
          typename MatType,
          template<typename BoundMetricType, typename...> class BoundType,
          template<typename SplitBoundType, typename SplitMatType>
-             class SplitType>
-void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+             class SplitType,
+         typename NodeAllocatorType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType,
+                     NodeAllocatorType>::
 SplitNode(std::vector<size_t>& oldFromNew,
           const size_t maxLeafSize,
           SplitType<BoundType<MetricType>, MatType>& splitter)
@@ -972,10 +1076,7 @@ SplitNode(std::vector<size_t>& oldFromNew,
 
   // Now that we know the split column, we will recursively split the children
   // by calling their constructors (which perform this splitting process).
-  left = new BinarySpaceTree(this, begin, splitCol - begin, oldFromNew,
-      splitter, maxLeafSize);
-  right = new BinarySpaceTree(this, splitCol, begin + count - splitCol,
-      oldFromNew, splitter, maxLeafSize);
+  BuildChildren(splitCol, &oldFromNew, maxLeafSize, splitter);
 
   // Calculate parent distances for those two nodes.
   arma::vec center, leftCenter, rightCenter;
@@ -997,9 +1098,105 @@ template<typename MetricType,
          typename MatType,
          template<typename BoundMetricType, typename...> class BoundType,
          template<typename SplitBoundType, typename SplitMatType>
-             class SplitType>
+             class SplitType,
+         typename NodeAllocatorType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType,
+                     NodeAllocatorType>::
+BuildChildren(const size_t splitCol,
+              std::vector<size_t>* oldFromNew,
+              const size_t maxLeafSize,
+              SplitType<BoundType<MetricType>, MatType>& splitter)
+{
+  // The two children work on disjoint column ranges of the dataset (and of
+  // oldFromNew), so if the split does not depend on anything but the node
+  // being split, they can be built at the same time and the tree will be
+  // exactly the same as if it were built serially.
+  const bool parallel =
+      SplitTraits<SplitType<BoundType<MetricType>, MatType>>::ParallelSafe &&
+      count >= ParallelBuildThreshold();
+
+  #ifdef HAS_OPENMP
+  // The first large node opens the parallel region (unless the tree is being
+  // built inside one already); the tasks for all of its descendants are then
+  // run by the threads of that region.
+  if (parallel && omp_get_level() == 0 && omp_get_max_threads() > 1)
+  {
+    #pragma omp parallel
+    {
+      #pragma omp single
+      BuildChildren(splitCol, oldFromNew, maxLeafSize, splitter);
+    }
+    return;
+  }
+  #endif
+
+  // The left child is built as a task while this thread builds the right child.
+  #pragma omp task if (parallel) default(shared)
+  {
+    if (oldFromNew)
+      left = new BinarySpaceTree(this, begin, splitCol - begin, *oldFromNew,
+          splitter, maxLeafSize);
+    else
+      left = new BinarySpaceTree(this, begin, splitCol - begin, splitter,
+          maxLeafSize);
+  }
+
+  if (oldFromNew)
+    right = new BinarySpaceTree(this, splitCol, begin + count - splitCol,
+        *oldFromNew, splitter, maxLeafSize);
+  else
+    right = new BinarySpaceTree(this, splitCol, begin + count - splitCol,
+        splitter, maxLeafSize);
+
+  #pragma omp taskwait
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType,
+         typename NodeAllocatorType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType,
+                     NodeAllocatorType>::
+    RefitBounds()
+{
+  // The bound of this node is recomputed first, in the same order as during
+  // construction, since some bounds depend on the bound of the parent.
+  bound = BoundType<MetricType>(dataset->n_rows);
+  UpdateBound(bound);
+  furthestDescendantDistance = 0.5 * bound.Diameter();
+
+  if (left)
+  {
+    left->RefitBounds();
+    right->RefitBounds();
+
+    // Calculate parent distances for those two nodes.
+    arma::vec center, leftCenter, rightCenter;
+    Center(center);
+    left->Center(leftCenter);
+    right->Center(rightCenter);
+
+    left->ParentDistance() = bound.Metric().Evaluate(center, leftCenter);
+    right->ParentDistance() = bound.Metric().Evaluate(center, rightCenter);
+  }
+
+  // The statistic may depend on the children, so it is built last.
+  stat = StatisticType(*this);
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType,
+         typename NodeAllocatorType>
 template<typename BoundType2>
-void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType,
+                     NodeAllocatorType>::
 UpdateBound(BoundType2& boundToUpdate)
 {
   if (count > 0)
@@ -1011,8 +1208,10 @@ template<typename MetricType,
          typename MatType,
          template<typename BoundMetricType, typename...> class BoundType,
          template<typename SplitBoundType, typename SplitMatType>
-             class SplitType>
-void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+             class SplitType,
+         typename NodeAllocatorType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType,
+                     NodeAllocatorType>::
 UpdateBound(bound::HollowBallBound<MetricType>& boundToUpdate)
 {
   if (!parent)
@@ -1038,8 +1237,10 @@ template<typename MetricType,
          typename MatType,
          template<typename BoundMetricType, typename...> class BoundType,
          template<typename SplitBoundType, typename SplitMatType>
-             class SplitType>
-BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+             class SplitType,
+         typename NodeAllocatorType>
+BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType,
+                NodeAllocatorType>::
     BinarySpaceTree() :
     left(NULL),
     right(NULL),
@@ -1062,24 +1263,21 @@ template<typename MetricType,
          typename MatType,
          template<typename BoundMetricType, typename...> class BoundType,
          template<typename SplitBoundType, typename SplitMatType>
-             class SplitType>
+             class SplitType,
+         typename NodeAllocatorType>
 template<typename Archive>
-void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType,
+                     NodeAllocatorType>::
     serialize(Archive& ar, const unsigned int /* version */)
 {
   // If we're loading, and we have children, they need to be deleted.
   if (Archive::is_loading::value)
   {
-    if (left)
-      delete left;
-    if (right)
-      delete right;
+    NodeAllocatorType::DeleteChildren(this);
     if (!parent)
       delete dataset;
 
     parent = NULL;
-    left = NULL;
-    right = NULL;
   }
 
   ar & BOOST_SERIALIZATION_NVP(begin);
@@ -1108,7 +1306,84 @@ void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
       left->parent = this;
     if (right)
       right->parent = this;
+
+    // Every node is loaded as a root, so the children may already have been
+    // laid out; the allocator lays out the nodes again for this subtree.
+    NodeAllocatorType::Pack(this);
+  }
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType,
+         typename NodeAllocatorType>
+template<typename Archive>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType,
+                     NodeAllocatorType>::
+    SaveStructure(Archive& ar) const
+{
+  // Saving does not modify the tree.
+  const_cast<BinarySpaceTree*>(this)->SerializeStructure(ar, dataset);
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType,
+         typename NodeAllocatorType>
+template<typename Archive>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType,
+                     NodeAllocatorType>::
+    SerializeStructure(Archive& ar, MatType* data)
+{
+  // This is the same as serialize(), except that the dataset is not stored and
+  // the children are not tracked by boost::serialization.
+  if (Archive::is_loading::value)
+  {
+    NodeAllocatorType::DeleteChildren(this);
+    if (!parent && dataset != data)
+      delete dataset;
+
+    dataset = data;
+  }
+
+  ar & BOOST_SERIALIZATION_NVP(begin);
+  ar & BOOST_SERIALIZATION_NVP(count);
+  ar & BOOST_SERIALIZATION_NVP(bound);
+  ar & BOOST_SERIALIZATION_NVP(stat);
+
+  ar & BOOST_SERIALIZATION_NVP(parentDistance);
+  ar & BOOST_SERIALIZATION_NVP(furthestDescendantDistance);
+
+  bool hasLeft = (left != NULL);
+  bool hasRight = (right != NULL);
+
+  ar & BOOST_SERIALIZATION_NVP(hasLeft);
+  ar & BOOST_SERIALIZATION_NVP(hasRight);
+
+  if (Archive::is_loading::value)
+  {
+    if (hasLeft)
+    {
+      left = new BinarySpaceTree();
+      left->parent = this;
+    }
+    if (hasRight)
+    {
+      right = new BinarySpaceTree();
+      right->parent = this;
+    }
   }
+
+  if (hasLeft)
+    left->SerializeStructure(ar, data);
+  if (hasRight)
+    right->SerializeStructure(ar, data);
 }
 
 } // namespace tree
@@ -19,6 +19,7 @@
 #include <queue>
 
 #include "../binary_space_tree.hpp"
+#include "../traversal_statistics.hpp"
 
 namespace mlpack {
 namespace tree {
@@ -38,10 +39,12 @@ template<typename MetricType,
          typename MatType,
          template<typename BoundMetricType, typename...> class BoundType,
          template<typename SplitBoundType, typename SplitMatType>
-             class SplitType>
+             class SplitType,
+         typename NodeAllocatorType>
 template<typename RuleType>
 class BinarySpaceTree<MetricType, StatisticType, MatType, BoundType,
-                      SplitType>::BreadthFirstDualTreeTraverser
+                      SplitType,
+                      NodeAllocatorType>::BreadthFirstDualTreeTraverser
 {
  public:
   /**
@@ -83,6 +86,9 @@ class BinarySpaceTree<MetricType, StatisticType, MatType, BoundType,
   //! Modify the number of times a base case was calculated.
   size_t& NumBaseCases() { return numBaseCases; }
 
+  //! Get the timings and the maximum recursion depth of the traversals.
+  const TraversalStatistics& Statistics() const { return statistics; }
+
  private:
   //! Reference to the rules with which the trees will be traversed.
   RuleType& rule;
@@ -99,6 +105,9 @@ class BinarySpaceTree<MetricType, StatisticType, MatType, BoundType,
   //! The number of times a base case was calculated.
   size_t numBaseCases;
 
+  //! The timings and the recursion depth of the traversals.
+  TraversalStatistics statistics;
+
   //! Traversal information, held in the class so that it isn't continually
   //! being reallocated.
   typename RuleType::TraversalInfoType traversalInfo;
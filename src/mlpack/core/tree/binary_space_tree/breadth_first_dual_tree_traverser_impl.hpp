@@ -25,9 +25,11 @@ template<typename MetricType,
          typename MatType,
          template<typename BoundMetricType, typename...> class BoundType,
          template<typename SplitBoundType, typename SplitMatType>
-             class SplitType>
+             class SplitType,
+         typename NodeAllocatorType>
 template<typename RuleType>
-BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType,
+                NodeAllocatorType>::
 BreadthFirstDualTreeTraverser<RuleType>::BreadthFirstDualTreeTraverser(
     RuleType& rule) :
     rule(rule),
@@ -53,13 +55,17 @@ template<typename MetricType,
          typename MatType,
          template<typename BoundMetricType, typename...> class BoundType,
          template<typename SplitBoundType, typename SplitMatType>
-             class SplitType>
+             class SplitType,
+         typename NodeAllocatorType>
 template<typename RuleType>
-void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType,
+                     NodeAllocatorType>::
 BreadthFirstDualTreeTraverser<RuleType>::Traverse(
-    BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>&
+    BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType,
+                    NodeAllocatorType>&
         queryRoot,
-    BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>&
+    BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType,
+                    NodeAllocatorType>&
         referenceRoot)
 {
   // Increment the visit counter.
@@ -69,7 +75,10 @@ BreadthFirstDualTreeTraverser<RuleType>::Traverse(
   traversalInfo = rule.TraversalInfo();
 
   // Must score the root combination.
+  const TraversalStatistics::Clock::time_point start =
+      TraversalStatistics::Now();
   const double rootScore = rule.Score(queryRoot, referenceRoot);
+  statistics.AddScoreTime(start);
   if (rootScore == DBL_MAX)
     return; // This probably means something is wrong.
 
@@ -93,14 +102,19 @@ template<typename MetricType,
          typename MatType,
          template<typename BoundMetricType, typename...> class BoundType,
          template<typename SplitBoundType, typename SplitMatType>
-             class SplitType>
+             class SplitType,
+         typename NodeAllocatorType>
 template<typename RuleType>
-void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType,
+                     NodeAllocatorType>::
 BreadthFirstDualTreeTraverser<RuleType>::Traverse(
-    BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>&
+    BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType,
+                    NodeAllocatorType>&
         queryNode,
     std::priority_queue<QueueFrameType>& referenceQueue)
 {
+  TraversalStatistics::Level level(statistics);
+
   // Store queues for the children.  We will recurse into the children once our
   // queue is empty.
   std::priority_queue<QueueFrameType> leftChildQueue;
@@ -117,7 +131,10 @@ BreadthFirstDualTreeTraverser<RuleType>::Traverse(
     rule.TraversalInfo() = ti;
     const size_t queryDepth = currentFrame.queryDepth;
 
+    const TraversalStatistics::Clock::time_point scoreStart =
+        TraversalStatistics::Now();
     double score = rule.Score(queryNode, referenceNode);
+    statistics.AddScoreTime(scoreStart);
     ++numScores;
 
     if (score == DBL_MAX)
@@ -130,6 +147,8 @@ BreadthFirstDualTreeTraverser<RuleType>::Traverse(
     if (queryNode.IsLeaf() && referenceNode.IsLeaf())
     {
       // Loop through each of the points in each node.
+      const TraversalStatistics::Clock::time_point baseCaseStart =
+          TraversalStatistics::Now();
       const size_t queryEnd = queryNode.Begin() + queryNode.Count();
       const size_t refEnd = referenceNode.Begin() + referenceNode.Count();
       for (size_t query = queryNode.Begin(); query < queryEnd; ++query)
@@ -147,6 +166,7 @@ BreadthFirstDualTreeTraverser<RuleType>::Traverse(
 
         numBaseCases += referenceNode.Count();
       }
+      statistics.AddBaseCaseTime(baseCaseStart);
     }
     else if ((!queryNode.IsLeaf()) && referenceNode.IsLeaf())
     {
@@ -0,0 +1,141 @@
+/**
+ * @file core/tree/binary_space_tree/contiguous_node_allocator_impl.hpp
+ *
+ * Implementation of ContiguousNodeAllocator.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_BINARY_SPACE_TREE_CONTIGUOUS_NODE_ALLOCATOR_IMPL_HPP
+#define MLPACK_CORE_TREE_BINARY_SPACE_TREE_CONTIGUOUS_NODE_ALLOCATOR_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "contiguous_node_allocator.hpp"
+
+namespace mlpack {
+namespace tree {
+
+template<typename TreeType>
+void ContiguousNodeAllocator::Pack(TreeType* root)
+{
+  // Collect the descendants in depth-first order.
+  std::vector<TreeType*> oldNodes;
+  std::vector<TreeType*> stack;
+  if (root->Right())
+    stack.push_back(root->Right());
+  if (root->Left())
+    stack.push_back(root->Left());
+  while (!stack.empty())
+  {
+    TreeType* node = stack.back();
+    stack.pop_back();
+    oldNodes.push_back(node);
+
+    if (node->Right())
+      stack.push_back(node->Right());
+    if (node->Left())
+      stack.push_back(node->Left());
+  }
+
+  // Take the blocks that currently hold nodes; they are freed once the nodes
+  // have been moved out.
+  std::vector<std::pair<TreeType*, size_t>> oldBlocks;
+  if (nodes)
+    oldBlocks.push_back(std::make_pair((TreeType*) nodes, numNodes));
+  nodes = NULL;
+  numNodes = 0;
+
+  if (oldNodes.empty())
+  {
+    for (size_t i = 0; i < oldBlocks.size(); ++i)
+      ::operator delete(oldBlocks[i].first);
+    return;
+  }
+
+  TreeType* block = static_cast<TreeType*>(::operator new(oldNodes.size() *
+      sizeof(TreeType)));
+  for (size_t i = 0; i < oldNodes.size(); ++i)
+  {
+    // The parent was moved first, and its move constructor pointed this node
+    // back at it; the move constructor of this node does the same for its
+    // children.
+    TreeType* node = new (block + i) TreeType(std::move(*oldNodes[i]));
+    if (node->Parent()->Left() == oldNodes[i])
+      node->Parent()->Left() = node;
+    else
+      node->Parent()->Right() = node;
+
+    ContiguousNodeAllocator& allocator = node->NodeAllocator();
+    if (allocator.nodes)
+    {
+      oldBlocks.push_back(std::make_pair((TreeType*) allocator.nodes,
+          allocator.numNodes));
+      allocator.nodes = NULL;
+      allocator.numNodes = 0;
+    }
+  }
+
+  // The old nodes are now empty: they have no children and (since they aren't
+  // roots) don't own a dataset.
+  for (size_t i = 0; i < oldNodes.size(); ++i)
+  {
+    bool inBlock = false;
+    for (size_t j = 0; j < oldBlocks.size(); ++j)
+    {
+      if (oldNodes[i] >= oldBlocks[j].first &&
+          oldNodes[i] < oldBlocks[j].first + oldBlocks[j].second)
+      {
+        inBlock = true;
+        break;
+      }
+    }
+
+    if (inBlock)
+      oldNodes[i]->~TreeType();
+    else
+      delete oldNodes[i];
+  }
+
+  for (size_t i = 0; i < oldBlocks.size(); ++i)
+    ::operator delete(oldBlocks[i].first);
+
+  nodes = block;
+  numNodes = oldNodes.size();
+}
+
+template<typename TreeType>
+void ContiguousNodeAllocator::DeleteChildren(TreeType* node)
+{
+  if (nodes)
+  {
+    // The nodes in the block don't own their children, and none of them owns a
+    // block.
+    TreeType* block = static_cast<TreeType*>(nodes);
+    for (size_t i = 0; i < numNodes; ++i)
+    {
+      block[i].Left() = NULL;
+      block[i].Right() = NULL;
+    }
+    for (size_t i = 0; i < numNodes; ++i)
+      block[i].~TreeType();
+
+    ::operator delete(nodes);
+    nodes = NULL;
+    numNodes = 0;
+  }
+  else
+  {
+    delete node->Left();
+    delete node->Right();
+  }
+
+  node->Left() = NULL;
+  node->Right() = NULL;
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
@@ -16,7 +16,9 @@
 #define MLPACK_CORE_TREE_BINARY_SPACE_TREE_DUAL_TREE_TRAVERSER_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/util/sfinae_utility.hpp>
 
+#include "../traversal_statistics.hpp"
 #include "binary_space_tree.hpp"
 
 namespace mlpack {
@@ -27,10 +29,11 @@ template<typename MetricType,
          typename MatType,
          template<typename BoundMetricType, typename...> class BoundType,
          template<typename SplitBoundType, typename SplitMatType>
-             class SplitType>
+             class SplitType,
+         typename NodeAllocatorType>
 template<typename RuleType>
 class BinarySpaceTree<MetricType, StatisticType, MatType, BoundType,
-                      SplitType>::DualTreeTraverser
+                      SplitType, NodeAllocatorType>::DualTreeTraverser
 {
  public:
   /**
@@ -67,7 +70,43 @@ class BinarySpaceTree<MetricType, StatisticType, MatType, BoundType,
   //! Modify the number of times a base case was calculated.
   size_t& NumBaseCases() { return numBaseCases; }
 
+  //! Get the timings and the maximum recursion depth of the traversals.
+  const TraversalStatistics& Statistics() const { return statistics; }
+
  private:
+  // SFINAE check if the rules can evaluate two leaves at once.
+  HAS_MEM_FUNC(LeafBaseCases, HasLeafBaseCases);
+
+  /**
+   * Evaluate all the base cases between two leaves at once, if the rules
+   * support it and ask for it.  Returns false if the base cases must be
+   * evaluated one pair at a time instead.
+   */
+  template<typename RuleT = RuleType>
+  bool LeafBaseCases(
+      BinarySpaceTree& queryNode,
+      BinarySpaceTree& referenceNode,
+      const typename std::enable_if_t<HasLeafBaseCases<RuleT,
+          size_t(RuleT::*)(BinarySpaceTree&, BinarySpaceTree&)>::value>* = 0)
+  {
+    if (!rule.BlockBaseCases())
+      return false;
+
+    numBaseCases += rule.LeafBaseCases(queryNode, referenceNode);
+    return true;
+  }
+
+  //! The rules can't evaluate two leaves at once.
+  template<typename RuleT = RuleType>
+  bool LeafBaseCases(
+      BinarySpaceTree& /* queryNode */,
+      BinarySpaceTree& /* referenceNode */,
+      const typename std::enable_if_t<!HasLeafBaseCases<RuleT,
+          size_t(RuleT::*)(BinarySpaceTree&, BinarySpaceTree&)>::value>* = 0)
+  {
+    return false;
+  }
+
   //! Reference to the rules with which the trees will be traversed.
   RuleType& rule;
 
@@ -83,6 +122,9 @@ class BinarySpaceTree<MetricType, StatisticType, MatType, BoundType,
   //! The number of times a base case was calculated.
   size_t numBaseCases;
 
+  //! The timings and the recursion depth of the traversals.
+  TraversalStatistics statistics;
+
   //! Traversal information, held in the class so that it isn't continually
   //! being reallocated.
   typename RuleType::TraversalInfoType traversalInfo;
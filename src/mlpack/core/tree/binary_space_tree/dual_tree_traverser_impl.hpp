@@ -25,9 +25,11 @@ template<typename MetricType,
          typename MatType,
          template<typename BoundMetricType, typename...> class BoundType,
          template<typename SplitBoundType, typename SplitMatType>
-             class SplitType>
+             class SplitType,
+         typename NodeAllocatorType>
 template<typename RuleType>
-BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType,
+                NodeAllocatorType>::
 DualTreeTraverser<RuleType>::DualTreeTraverser(RuleType& rule) :
     rule(rule),
     numPrunes(0),
@@ -41,15 +43,21 @@ template<typename MetricType,
          typename MatType,
          template<typename BoundMetricType, typename...> class BoundType,
          template<typename SplitBoundType, typename SplitMatType>
-             class SplitType>
+             class SplitType,
+         typename NodeAllocatorType>
 template<typename RuleType>
-void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType,
+                     NodeAllocatorType>::
 DualTreeTraverser<RuleType>::Traverse(
-    BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>&
+    BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType,
+                    NodeAllocatorType>&
         queryNode,
-    BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>&
+    BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType,
+                    NodeAllocatorType>&
         referenceNode)
 {
+  TraversalStatistics::Level level(statistics);
+
   // Increment the visit counter.
   ++numVisited;
 
@@ -59,7 +67,10 @@ DualTreeTraverser<RuleType>::Traverse(
   // If both nodes are root nodes, just score them.
   if (queryNode.Parent() == NULL && referenceNode.Parent() == NULL)
   {
+    const TraversalStatistics::Clock::time_point start =
+        TraversalStatistics::Now();
     const double rootScore = rule.Score(queryNode, referenceNode);
+    statistics.AddScoreTime(start);
     // If root score is DBL_MAX, don't recurse.
     if (rootScore == DBL_MAX)
     {
@@ -68,9 +79,18 @@ DualTreeTraverser<RuleType>::Traverse(
     }
   }
 
-  // If both are leaves, we must evaluate the base case.
+  // If both are leaves, we must evaluate the base case.  Rules that support it
+  // may evaluate all the pairs of points at once.
   if (queryNode.IsLeaf() && referenceNode.IsLeaf())
   {
+    const TraversalStatistics::Clock::time_point start =
+        TraversalStatistics::Now();
+    if (LeafBaseCases(queryNode, referenceNode))
+    {
+      statistics.AddBaseCaseTime(start);
+      return;
+    }
+
     // Loop through each of the points in each node.
     const size_t queryEnd = queryNode.Begin() + queryNode.Count();
     const size_t refEnd = referenceNode.Begin() + referenceNode.Count();
@@ -90,6 +110,9 @@ DualTreeTraverser<RuleType>::Traverse(
 
       numBaseCases += referenceNode.Count();
     }
+
+    // The scores of the query points are counted as base case time.
+    statistics.AddBaseCaseTime(start);
   }
   else if (((!queryNode.IsLeaf()) && referenceNode.IsLeaf()) ||
            (queryNode.NumDescendants() > 3 * referenceNode.NumDescendants() &&
@@ -97,7 +120,9 @@ DualTreeTraverser<RuleType>::Traverse(
   {
     // We have to recurse down the query node.  In this case the recursion order
     // does not matter.
+    TraversalStatistics::Clock::time_point start = TraversalStatistics::Now();
     const double leftScore = rule.Score(*queryNode.Left(), referenceNode);
+    statistics.AddScoreTime(start);
     ++numScores;
 
     if (leftScore != DBL_MAX)
@@ -107,7 +132,9 @@ DualTreeTraverser<RuleType>::Traverse(
 
     // Before recursing, we have to set the traversal information correctly.
     rule.TraversalInfo() = traversalInfo;
+    start = TraversalStatistics::Now();
     const double rightScore = rule.Score(*queryNode.Right(), referenceNode);
+    statistics.AddScoreTime(start);
     ++numScores;
 
     if (rightScore != DBL_MAX)
@@ -120,10 +147,13 @@ DualTreeTraverser<RuleType>::Traverse(
     // We have to recurse down the reference node.  In this case the recursion
     // order does matter.  Before recursing, though, we have to set the
     // traversal information correctly.
+    const TraversalStatistics::Clock::time_point start =
+        TraversalStatistics::Now();
     double leftScore = rule.Score(queryNode, *referenceNode.Left());
     typename RuleType::TraversalInfoType leftInfo = rule.TraversalInfo();
     rule.TraversalInfo() = traversalInfo;
     double rightScore = rule.Score(queryNode, *referenceNode.Right());
+    statistics.AddScoreTime(start);
     numScores += 2;
 
     if (leftScore < rightScore)
@@ -197,10 +227,12 @@ DualTreeTraverser<RuleType>::Traverse(
     // query descent order does not matter, we will go to the left query child
     // first.  Before recursing, we have to set the traversal information
     // correctly.
+    TraversalStatistics::Clock::time_point start = TraversalStatistics::Now();
     double leftScore = rule.Score(*queryNode.Left(), *referenceNode.Left());
     typename RuleType::TraversalInfoType leftInfo = rule.TraversalInfo();
     rule.TraversalInfo() = traversalInfo;
     double rightScore = rule.Score(*queryNode.Left(), *referenceNode.Right());
+    statistics.AddScoreTime(start);
     typename RuleType::TraversalInfoType rightInfo;
     numScores += 2;
 
@@ -276,10 +308,12 @@ DualTreeTraverser<RuleType>::Traverse(
     rule.TraversalInfo() = traversalInfo;
 
     // Now recurse down the right query node.
+    start = TraversalStatistics::Now();
     leftScore = rule.Score(*queryNode.Right(), *referenceNode.Left());
     leftInfo = rule.TraversalInfo();
     rule.TraversalInfo() = traversalInfo;
     rightScore = rule.Score(*queryNode.Right(), *referenceNode.Right());
+    statistics.AddScoreTime(start);
     numScores += 2;
 
     if (leftScore < rightScore)
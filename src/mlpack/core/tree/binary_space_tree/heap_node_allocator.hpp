@@ -0,0 +1,59 @@
+/**
+ * @file core/tree/binary_space_tree/heap_node_allocator.hpp
+ *
+ * Definition of HeapNodeAllocator, the default node allocation policy of the
+ * BinarySpaceTree, which allocates each node separately.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_BINARY_SPACE_TREE_HEAP_NODE_ALLOCATOR_HPP
+#define MLPACK_CORE_TREE_BINARY_SPACE_TREE_HEAP_NODE_ALLOCATOR_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace tree /** Trees and tree-building procedures. */ {
+
+/**
+ * The HeapNodeAllocator allocates each node of a BinarySpaceTree with new, and
+ * each node owns its children.  It holds no state, so it takes no space in the
+ * nodes.
+ *
+ * A node allocation policy must implement the following two functions:
+ *
+ * @code
+ * // Called once the tree rooted at the given node is built (or copied, or
+ * // loaded).
+ * template<typename TreeType>
+ * void Pack(TreeType* root);
+ *
+ * // Free the children of the given node, and set them to NULL.
+ * template<typename TreeType>
+ * void DeleteChildren(TreeType* node);
+ * @endcode
+ */
+class HeapNodeAllocator
+{
+ public:
+  //! The nodes are left where they were built.
+  template<typename TreeType>
+  void Pack(TreeType* /* root */) { }
+
+  //! Delete the children of the given node.
+  template<typename TreeType>
+  void DeleteChildren(TreeType* node)
+  {
+    delete node->Left();
+    delete node->Right();
+    node->Left() = NULL;
+    node->Right() = NULL;
+  }
+};
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
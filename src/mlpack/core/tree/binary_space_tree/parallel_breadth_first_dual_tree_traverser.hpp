@@ -0,0 +1,148 @@
+/**
+ * @file core/tree/binary_space_tree/parallel_breadth_first_dual_tree_traverser.hpp
+ *
+ * Defines the ParallelBreadthFirstDualTreeTraverser for the BinarySpaceTree
+ * tree type.  This is a nested class of BinarySpaceTree which traverses two
+ * trees breadth-first over the query tree, processing all the query nodes of
+ * one level at the same time with OpenMP.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_BINARY_SPACE_TREE_PARALLEL_BF_DUAL_TREE_TRAVERSER_HPP
+#define MLPACK_CORE_TREE_BINARY_SPACE_TREE_PARALLEL_BF_DUAL_TREE_TRAVERSER_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <queue>
+
+#include "../binary_space_tree.hpp"
+#include "../traversal_statistics.hpp"
+#include "breadth_first_dual_tree_traverser.hpp"
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * A level-synchronous parallel version of the BreadthFirstDualTreeTraverser.
+ * The traversal keeps a frontier of query nodes, each with the priority queue
+ * of the reference nodes still to visit with it.  Every query node of the
+ * frontier is processed independently (in parallel) exactly as the
+ * BreadthFirstDualTreeTraverser processes it, and the queues of their children
+ * are then merged into the frontier of the next level.
+ *
+ * Each thread uses its own rules object from the given list, so the number of
+ * threads is the number of rules.  Since the query nodes of a level are
+ * disjoint, a rules object is only required to be safe to use at the same time
+ * as the others on a different query node: for instance, when the rules only
+ * write to the statistics of the query node they are given and to the results
+ * of its points.  The base cases of a query point are all computed with the
+ * same rules object (the one that processes its leaf), but different levels of
+ * a query subtree may be processed by different rules; the caller combines the
+ * results of all the rules objects.
+ *
+ * @code
+ * std::vector<RuleType> rules(threads, RuleType(referenceSet, querySet, k,
+ *     metric));
+ * KDTree<...>::ParallelBreadthFirstDualTreeTraverser<RuleType> traverser(
+ *     rules);
+ * traverser.Traverse(queryTree, referenceTree);
+ * @endcode
+ */
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType,
+         typename NodeAllocatorType>
+template<typename RuleType>
+class BinarySpaceTree<MetricType, StatisticType, MatType, BoundType,
+                      SplitType,
+                      NodeAllocatorType>::ParallelBreadthFirstDualTreeTraverser
+{
+ public:
+  /**
+   * Instantiate the traverser with the given rules objects, one per thread.
+   * The list must not be empty.
+   */
+  ParallelBreadthFirstDualTreeTraverser(std::vector<RuleType>& rules);
+
+  typedef QueueFrame<BinarySpaceTree, typename RuleType::TraversalInfoType>
+      QueueFrameType;
+
+  /**
+   * Traverse the two trees.  This does not reset the number of prunes.
+   *
+   * @param queryNode The query node to be traversed.
+   * @param referenceNode The reference node to be traversed.
+   */
+  void Traverse(BinarySpaceTree& queryNode,
+                BinarySpaceTree& referenceNode);
+
+  //! Get the number of prunes.
+  size_t NumPrunes() const { return numPrunes; }
+  //! Modify the number of prunes.
+  size_t& NumPrunes() { return numPrunes; }
+
+  //! Get the number of visited combinations.
+  size_t NumVisited() const { return numVisited; }
+  //! Modify the number of visited combinations.
+  size_t& NumVisited() { return numVisited; }
+
+  //! Get the number of times a node combination was scored.
+  size_t NumScores() const { return numScores; }
+  //! Modify the number of times a node combination was scored.
+  size_t& NumScores() { return numScores; }
+
+  //! Get the number of times a base case was calculated.
+  size_t NumBaseCases() const { return numBaseCases; }
+  //! Modify the number of times a base case was calculated.
+  size_t& NumBaseCases() { return numBaseCases; }
+
+  //! Get the timings and the number of levels of the traversals.  The timings
+  //! are summed over all threads.
+  const TraversalStatistics& Statistics() const { return statistics; }
+
+ private:
+  /**
+   * Visit all the combinations in the queue of one query node, with the given
+   * rules.  The combinations of its children are added to the two child
+   * queues, and the timings to the given statistics.
+   */
+  void ProcessQueue(RuleType& rule,
+                    std::priority_queue<QueueFrameType>& referenceQueue,
+                    std::priority_queue<QueueFrameType>& leftChildQueue,
+                    std::priority_queue<QueueFrameType>& rightChildQueue,
+                    size_t& prunes,
+                    size_t& scores,
+                    size_t& baseCases,
+                    TraversalStatistics& threadStatistics);
+
+  //! The rules of each thread.
+  std::vector<RuleType>& rules;
+
+  //! The number of prunes.
+  size_t numPrunes;
+
+  //! The number of node combinations that have been visited during traversal.
+  size_t numVisited;
+
+  //! The number of times a node combination was scored.
+  size_t numScores;
+
+  //! The number of times a base case was calculated.
+  size_t numBaseCases;
+
+  //! The timings and the number of levels of the traversals.
+  TraversalStatistics statistics;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+// Include implementation.
+#include "parallel_breadth_first_dual_tree_traverser_impl.hpp"
+
+#endif
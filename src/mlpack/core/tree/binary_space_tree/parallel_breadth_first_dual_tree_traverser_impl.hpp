@@ -0,0 +1,245 @@
+/**
+ * @file core/tree/binary_space_tree/parallel_breadth_first_dual_tree_traverser_impl.hpp
+ *
+ * Implementation of the ParallelBreadthFirstDualTreeTraverser for
+ * BinarySpaceTree.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_BINARY_SPACE_TREE_PARALLEL_BF_DUAL_TREE_TRAVERSER_IMPL_HPP
+#define MLPACK_CORE_TREE_BINARY_SPACE_TREE_PARALLEL_BF_DUAL_TREE_TRAVERSER_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "parallel_breadth_first_dual_tree_traverser.hpp"
+
+namespace mlpack {
+namespace tree {
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType,
+         typename NodeAllocatorType>
+template<typename RuleType>
+BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType,
+                NodeAllocatorType>::
+ParallelBreadthFirstDualTreeTraverser<RuleType>::
+ParallelBreadthFirstDualTreeTraverser(std::vector<RuleType>& rules) :
+    rules(rules),
+    numPrunes(0),
+    numVisited(0),
+    numScores(0),
+    numBaseCases(0)
+{
+  if (rules.empty())
+  {
+    throw std::invalid_argument("ParallelBreadthFirstDualTreeTraverser: at "
+        "least one rules object must be given!");
+  }
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType,
+         typename NodeAllocatorType>
+template<typename RuleType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType,
+                     NodeAllocatorType>::
+ParallelBreadthFirstDualTreeTraverser<RuleType>::Traverse(
+    BinarySpaceTree& queryRoot,
+    BinarySpaceTree& referenceRoot)
+{
+  // Increment the visit counter.
+  ++numVisited;
+
+  // Must score the root combination.
+  const TraversalStatistics::Clock::time_point start =
+      TraversalStatistics::Now();
+  const double rootScore = rules[0].Score(queryRoot, referenceRoot);
+  statistics.AddScoreTime(start);
+  if (rootScore == DBL_MAX)
+    return; // This probably means something is wrong.
+
+  QueueFrameType rootFrame;
+  rootFrame.queryNode = &queryRoot;
+  rootFrame.referenceNode = &referenceRoot;
+  rootFrame.queryDepth = 0;
+  rootFrame.score = 0.0;
+  rootFrame.traversalInfo = rules[0].TraversalInfo();
+
+  // The frontier holds the query nodes of one level, each with its queue.
+  std::vector<BinarySpaceTree*> frontier(1, &queryRoot);
+  std::vector<std::priority_queue<QueueFrameType>> queues(1);
+  queues[0].push(rootFrame);
+
+  size_t level = 0;
+  while (!frontier.empty())
+  {
+    statistics.ReachDepth(++level);
+
+    // The queues of the children of query node i are 2i and 2i + 1.
+    std::vector<std::priority_queue<QueueFrameType>> childQueues(2 *
+        frontier.size());
+    size_t prunes = 0, scores = 0, baseCases = 0;
+    std::vector<TraversalStatistics> threadStatistics(rules.size());
+
+    #pragma omp parallel for num_threads(rules.size()) schedule(dynamic) \
+        reduction(+:prunes, scores, baseCases)
+    for (omp_size_t i = 0; i < (omp_size_t) frontier.size(); ++i)
+    {
+      #ifdef HAS_OPENMP
+      const size_t thread = omp_get_thread_num();
+      #else
+      const size_t thread = 0;
+      #endif
+
+      ProcessQueue(rules[thread], queues[i], childQueues[2 * i],
+          childQueues[2 * i + 1], prunes, scores, baseCases,
+          threadStatistics[thread]);
+    }
+
+    numPrunes += prunes;
+    numScores += scores;
+    numBaseCases += baseCases;
+    for (size_t t = 0; t < threadStatistics.size(); ++t)
+      statistics += threadStatistics[t];
+
+    // Merge the queues of the next level, keeping only the children that have
+    // anything left to visit.
+    std::vector<BinarySpaceTree*> nextFrontier;
+    std::vector<std::priority_queue<QueueFrameType>> nextQueues;
+    for (size_t i = 0; i < frontier.size(); ++i)
+    {
+      if (!childQueues[2 * i].empty())
+      {
+        nextFrontier.push_back(frontier[i]->Left());
+        nextQueues.push_back(std::move(childQueues[2 * i]));
+      }
+      if (!childQueues[2 * i + 1].empty())
+      {
+        nextFrontier.push_back(frontier[i]->Right());
+        nextQueues.push_back(std::move(childQueues[2 * i + 1]));
+      }
+    }
+
+    frontier.swap(nextFrontier);
+    queues.swap(nextQueues);
+  }
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType,
+         typename NodeAllocatorType>
+template<typename RuleType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType,
+                     NodeAllocatorType>::
+ParallelBreadthFirstDualTreeTraverser<RuleType>::ProcessQueue(
+    RuleType& rule,
+    std::priority_queue<QueueFrameType>& referenceQueue,
+    std::priority_queue<QueueFrameType>& leftChildQueue,
+    std::priority_queue<QueueFrameType>& rightChildQueue,
+    size_t& prunes,
+    size_t& scores,
+    size_t& baseCases,
+    TraversalStatistics& threadStatistics)
+{
+  // This is the same as the inner loop of BreadthFirstDualTreeTraverser.
+  while (!referenceQueue.empty())
+  {
+    QueueFrameType currentFrame = referenceQueue.top();
+    referenceQueue.pop();
+
+    BinarySpaceTree& queryNode = *currentFrame.queryNode;
+    BinarySpaceTree& referenceNode = *currentFrame.referenceNode;
+    typename RuleType::TraversalInfoType ti = currentFrame.traversalInfo;
+    rule.TraversalInfo() = ti;
+    const size_t queryDepth = currentFrame.queryDepth;
+
+    const TraversalStatistics::Clock::time_point scoreStart =
+        TraversalStatistics::Now();
+    double score = rule.Score(queryNode, referenceNode);
+    threadStatistics.AddScoreTime(scoreStart);
+    ++scores;
+
+    if (score == DBL_MAX)
+    {
+      ++prunes;
+      continue;
+    }
+
+    // If both are leaves, we must evaluate the base case.
+    if (queryNode.IsLeaf() && referenceNode.IsLeaf())
+    {
+      const TraversalStatistics::Clock::time_point baseCaseStart =
+          TraversalStatistics::Now();
+      const size_t queryEnd = queryNode.Begin() + queryNode.Count();
+      const size_t refEnd = referenceNode.Begin() + referenceNode.Count();
+      for (size_t query = queryNode.Begin(); query < queryEnd; ++query)
+      {
+        for (size_t ref = referenceNode.Begin(); ref < refEnd; ++ref)
+          rule.BaseCase(query, ref);
+
+        baseCases += referenceNode.Count();
+      }
+      threadStatistics.AddBaseCaseTime(baseCaseStart);
+    }
+    else if ((!queryNode.IsLeaf()) && referenceNode.IsLeaf())
+    {
+      // We have to recurse down the query node.
+      QueueFrameType fl = { queryNode.Left(), &referenceNode, queryDepth + 1,
+          score, rule.TraversalInfo() };
+      leftChildQueue.push(fl);
+
+      QueueFrameType fr = { queryNode.Right(), &referenceNode, queryDepth + 1,
+          score, ti };
+      rightChildQueue.push(fr);
+    }
+    else if (queryNode.IsLeaf() && (!referenceNode.IsLeaf()))
+    {
+      // We have to recurse down the reference node, in the same queue.
+      QueueFrameType fl = { &queryNode, referenceNode.Left(), queryDepth,
+          score, rule.TraversalInfo() };
+      referenceQueue.push(fl);
+
+      QueueFrameType fr = { &queryNode, referenceNode.Right(), queryDepth,
+          score, ti };
+      referenceQueue.push(fr);
+    }
+    else
+    {
+      // We have to recurse down both query and reference nodes.
+      QueueFrameType fll = { queryNode.Left(), referenceNode.Left(),
+          queryDepth + 1, score, rule.TraversalInfo() };
+      leftChildQueue.push(fll);
+
+      QueueFrameType flr = { queryNode.Left(), referenceNode.Right(),
+          queryDepth + 1, score, rule.TraversalInfo() };
+      leftChildQueue.push(flr);
+
+      QueueFrameType frl = { queryNode.Right(), referenceNode.Left(),
+          queryDepth + 1, score, rule.TraversalInfo() };
+      rightChildQueue.push(frl);
+
+      QueueFrameType frr = { queryNode.Right(), referenceNode.Right(),
+          queryDepth + 1, score, rule.TraversalInfo() };
+      rightChildQueue.push(frr);
+    }
+  }
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
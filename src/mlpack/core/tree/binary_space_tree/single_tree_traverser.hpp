@@ -16,6 +16,7 @@
 
 #include <mlpack/prereqs.hpp>
 
+#include "../traversal_statistics.hpp"
 #include "binary_space_tree.hpp"
 
 namespace mlpack {
@@ -26,10 +27,11 @@ template<typename MetricType,
          typename MatType,
          template<typename BoundMetricType, typename...> class BoundType,
          template<typename SplitBoundType, typename SplitMatType>
-             class SplitType>
+             class SplitType,
+         typename NodeAllocatorType>
 template<typename RuleType>
 class BinarySpaceTree<MetricType, StatisticType, MatType, BoundType,
-                      SplitType>::SingleTreeTraverser
+                      SplitType, NodeAllocatorType>::SingleTreeTraverser
 {
  public:
   /**
@@ -51,12 +53,18 @@ class BinarySpaceTree<MetricType, StatisticType, MatType, BoundType,
   //! Modify the number of prunes.
   size_t& NumPrunes() { return numPrunes; }
 
+  //! Get the timings and the maximum recursion depth of the traversals.
+  const TraversalStatistics& Statistics() const { return statistics; }
+
  private:
   //! Reference to the rules with which the tree will be traversed.
   RuleType& rule;
 
   //! The number of nodes which have been pruned during traversal.
   size_t numPrunes;
+
+  //! The timings and the recursion depth of the traversals.
+  TraversalStatistics statistics;
 };
 
 } // namespace tree
@@ -27,9 +27,11 @@ template<typename MetricType,
          typename MatType,
          template<typename BoundMetricType, typename...> class BoundType,
          template<typename SplitBoundType, typename SplitMatType>
-             class SplitType>
+             class SplitType,
+         typename NodeAllocatorType>
 template<typename RuleType>
-BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType,
+                NodeAllocatorType>::
 SingleTreeTraverser<RuleType>::SingleTreeTraverser(RuleType& rule) :
     rule(rule),
     numPrunes(0)
@@ -40,27 +42,38 @@ template<typename MetricType,
          typename MatType,
          template<typename BoundMetricType, typename...> class BoundType,
          template<typename SplitBoundType, typename SplitMatType>
-             class SplitType>
+             class SplitType,
+         typename NodeAllocatorType>
 template<typename RuleType>
-void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType,
+                     NodeAllocatorType>::
 SingleTreeTraverser<RuleType>::Traverse(
     const size_t queryIndex,
-    BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>&
+    BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType,
+                    NodeAllocatorType>&
         referenceNode)
 {
+  TraversalStatistics::Level level(statistics);
+
   // If we are a leaf, run the base case as necessary.
   if (referenceNode.IsLeaf())
   {
+    const TraversalStatistics::Clock::time_point start =
+        TraversalStatistics::Now();
     const size_t refEnd = referenceNode.Begin() + referenceNode.Count();
     for (size_t i = referenceNode.Begin(); i < refEnd; ++i)
       rule.BaseCase(queryIndex, i);
+    statistics.AddBaseCaseTime(start);
   }
   else
   {
     // If it's the root node, just score it.
     if (referenceNode.Parent() == NULL)
     {
+      const TraversalStatistics::Clock::time_point start =
+          TraversalStatistics::Now();
       const double rootScore = rule.Score(queryIndex, referenceNode);
+      statistics.AddScoreTime(start);
       // If root score is DBL_MAX, don't recurse into that node.
       if (rootScore == DBL_MAX)
       {
@@ -70,8 +83,11 @@ SingleTreeTraverser<RuleType>::Traverse(
     }
 
     // If either score is DBL_MAX, we do not recurse into that node.
+    const TraversalStatistics::Clock::time_point start =
+        TraversalStatistics::Now();
     double leftScore = rule.Score(queryIndex, *referenceNode.Left());
     double rightScore = rule.Score(queryIndex, *referenceNode.Right());
+    statistics.AddScoreTime(start);
 
     if (leftScore < rightScore)
     {
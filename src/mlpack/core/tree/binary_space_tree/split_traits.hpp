@@ -0,0 +1,64 @@
+/**
+ * @file core/tree/binary_space_tree/split_traits.hpp
+ *
+ * Definition of the SplitTraits class, which describes properties of the split
+ * policies used by the BinarySpaceTree.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_BINARY_SPACE_TREE_SPLIT_TRAITS_HPP
+#define MLPACK_CORE_TREE_BINARY_SPACE_TREE_SPLIT_TRAITS_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "midpoint_split.hpp"
+#include "mean_split.hpp"
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * The SplitTraits class describes properties of a split policy that the
+ * BinarySpaceTree may use while it is being built.  By default nothing is
+ * assumed about the split, so the tree is built serially.
+ */
+template<typename SplitType>
+class SplitTraits
+{
+ public:
+  /**
+   * This is true if the split is deterministic and keeps no state between
+   * nodes, so that the children of a node can be split at the same time
+   * without changing the resulting tree.  Splits that draw random numbers or
+   * that store information about the root (like UBTreeSplit) must leave this
+   * false.
+   */
+  static const bool ParallelSafe = false;
+};
+
+/**
+ * The midpoint split only depends on the bound of the node being split.
+ */
+template<typename BoundType, typename MatType>
+class SplitTraits<MidpointSplit<BoundType, MatType>>
+{
+ public:
+  static const bool ParallelSafe = true;
+};
+
+/**
+ * The mean split only depends on the points held in the node being split.
+ */
+template<typename BoundType, typename MatType>
+class SplitTraits<MeanSplit<BoundType, MatType>>
+{
+ public:
+  static const bool ParallelSafe = true;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
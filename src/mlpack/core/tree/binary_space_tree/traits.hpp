@@ -29,9 +29,10 @@ template<typename MetricType,
          typename MatType,
          template<typename BoundMetricType, typename...> class BoundType,
          template<typename SplitBoundType, typename SplitMatType>
-             class SplitType>
+             class SplitType,
+         typename NodeAllocatorType>
 class TreeTraits<BinarySpaceTree<MetricType, StatisticType, MatType, BoundType,
-                                 SplitType>>
+                                 SplitType, NodeAllocatorType>>
 {
  public:
   /**
@@ -81,9 +82,10 @@ class TreeTraits<BinarySpaceTree<MetricType, StatisticType, MatType, BoundType,
 template<typename MetricType,
          typename StatisticType,
          typename MatType,
-         template<typename BoundMetricType, typename...> class BoundType>
+         template<typename BoundMetricType, typename...> class BoundType,
+         typename NodeAllocatorType>
 class TreeTraits<BinarySpaceTree<MetricType, StatisticType, MatType, BoundType,
-                                 RPTreeMaxSplit>>
+                                 RPTreeMaxSplit, NodeAllocatorType>>
 {
  public:
   /**
@@ -131,9 +133,10 @@ class TreeTraits<BinarySpaceTree<MetricType, StatisticType, MatType, BoundType,
 template<typename MetricType,
          typename StatisticType,
          typename MatType,
-         template<typename BoundMetricType, typename...> class BoundType>
+         template<typename BoundMetricType, typename...> class BoundType,
+         typename NodeAllocatorType>
 class TreeTraits<BinarySpaceTree<MetricType, StatisticType, MatType, BoundType,
-                                 RPTreeMeanSplit>>
+                                 RPTreeMeanSplit, NodeAllocatorType>>
 {
  public:
   /**
@@ -183,9 +186,10 @@ template<typename MetricType,
          typename StatisticType,
          typename MatType,
          template<typename SplitBoundType, typename SplitMatType>
-             class SplitType>
+             class SplitType,
+         typename NodeAllocatorType>
 class TreeTraits<BinarySpaceTree<MetricType, StatisticType, MatType,
-    bound::BallBound, SplitType>>
+    bound::BallBound, SplitType, NodeAllocatorType>>
 {
  public:
   static const bool HasOverlappingChildren = true;
@@ -207,9 +211,10 @@ template<typename MetricType,
          typename StatisticType,
          typename MatType,
          template<typename SplitBoundType, typename SplitMatType>
-             class SplitType>
+             class SplitType,
+         typename NodeAllocatorType>
 class TreeTraits<BinarySpaceTree<MetricType, StatisticType, MatType,
-    bound::HollowBallBound, SplitType>>
+    bound::HollowBallBound, SplitType, NodeAllocatorType>>
 {
  public:
   static const bool HasOverlappingChildren = true;
@@ -231,9 +236,10 @@ template<typename MetricType,
          typename StatisticType,
          typename MatType,
          template<typename SplitBoundType, typename SplitMatType>
-             class SplitType>
+             class SplitType,
+         typename NodeAllocatorType>
 class TreeTraits<BinarySpaceTree<MetricType, StatisticType, MatType,
-    bound::CellBound, SplitType>>
+    bound::CellBound, SplitType, NodeAllocatorType>>
 {
  public:
   static const bool HasOverlappingChildren = true;
@@ -30,7 +30,8 @@ CosineTree::CosineTree(const arma::mat& dataset) :
   l2NormsSquared.zeros(numColumns);
 
   // Set indices and calculate squared norms of the columns.
-  for (size_t i = 0; i < numColumns; ++i)
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) numColumns; ++i)
   {
     indices[i] = i;
     double l2Norm = arma::norm(dataset.col(i), 2);
@@ -372,28 +373,42 @@ void CosineTree::ModifiedGramSchmidt(CosineNodeQueue& treeQueue,
                                      arma::vec& newBasisVector,
                                      arma::vec* addBasisVector)
 {
-  // Set new basis vector to centroid.
-  newBasisVector = centroid;
-
-  // Variables for iterating throught the priority queue.
-  CosineTree *currentNode;
+  // Collect the current basis.
+  std::vector<const arma::vec*> basisVectors;
+  basisVectors.reserve(treeQueue.size() + 1);
   CosineNodeQueue::const_iterator i = treeQueue.begin();
-
-  // For every vector in the current basis, remove its projection from the
-  // centroid.
   for ( ; i != treeQueue.end(); ++i)
-  {
-    currentNode = *i;
-
-    double projection = arma::dot(currentNode->BasisVector(), centroid);
-    newBasisVector -= projection * currentNode->BasisVector();
-  }
+    basisVectors.push_back(&(*i)->BasisVector());
 
   // If additional basis vector is passed, take it into account.
   if (addBasisVector)
+    basisVectors.push_back(addBasisVector);
+
+  // The projections of the centroid onto every vector in the current basis are
+  // independent, so they are computed in parallel.
+  const size_t numBasis = basisVectors.size();
+  arma::vec projections(numBasis);
+  #pragma omp parallel for
+  for (omp_size_t k = 0; k < (omp_size_t) numBasis; ++k)
+    projections[k] = arma::dot(*basisVectors[k], centroid);
+
+  // Remove the projections from the centroid, in parallel over blocks of
+  // rows (so that the result does not depend on the number of threads).
+  newBasisVector = centroid;
+  const size_t blockSize = 256;
+  const size_t numBlocks = (centroid.n_elem + blockSize - 1) / blockSize;
+  #pragma omp parallel for
+  for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
   {
-    double projection = arma::dot(*addBasisVector, centroid);
-    newBasisVector -= *addBasisVector * projection;
+    const size_t begin = b * blockSize;
+    const size_t end = std::min(begin + blockSize, (size_t) centroid.n_elem);
+    double* out = newBasisVector.memptr();
+    for (size_t k = 0; k < numBasis; ++k)
+    {
+      const double* basis = basisVectors[k]->memptr();
+      for (size_t r = begin; r < end; ++r)
+        out[r] -= projections[k] * basis[r];
+    }
   }
 
   // Normalize the modified centroid vector.
@@ -421,47 +436,40 @@ double CosineTree::MonteCarloError(CosineTree* node,
   arma::vec weightedMagnitudes;
   weightedMagnitudes.zeros(numSamples);
 
-  // Set size of projection vector, depending on whether additional basis
-  // vectors are passed.
-  size_t projectionSize;
+  // Collect the current basis, and the additional basis vectors if they are
+  // passed.
+  std::vector<const arma::vec*> basisVectors;
+  basisVectors.reserve(treeQueue.size() + 2);
+  CosineNodeQueue::const_iterator j = treeQueue.begin();
+  for ( ; j != treeQueue.end(); ++j)
+    basisVectors.push_back(&(*j)->BasisVector());
   if (addBasisVector1 && addBasisVector2)
-    projectionSize = treeQueue.size() + 2;
-  else
-    projectionSize = treeQueue.size();
-
-  // For each sample, calculate the weighted projection onto the current basis.
-  for (size_t i = 0; i < numSamples; ++i)
   {
-    // Initialize projection as a vector of zeros.
-    arma::vec projection;
-    projection.zeros(projectionSize);
-
-    CosineTree *currentNode;
-    CosineNodeQueue::const_iterator j = treeQueue.begin();
-
-    size_t k = 0;
-    // Compute the projection of the sampled vector onto the existing subspace.
-    for ( ; j != treeQueue.end(); ++j, ++k)
-    {
-      currentNode = *j;
+    basisVectors.push_back(addBasisVector1);
+    basisVectors.push_back(addBasisVector2);
+  }
 
-      projection(k) = arma::dot(dataset.col(sampledIndices[i]),
-                                currentNode->BasisVector());
-    }
-    // If two additional vectors are passed, take their projections.
-    if (addBasisVector1 && addBasisVector2)
+  // Compute the projections of every sampled vector onto the existing
+  // subspace, in parallel over the basis vectors (there are only O(log m)
+  // samples, but many basis vectors).
+  const size_t numBasis = basisVectors.size();
+  arma::mat projections(numSamples, numBasis);
+  #pragma omp parallel for
+  for (omp_size_t k = 0; k < (omp_size_t) numBasis; ++k)
+  {
+    for (size_t i = 0; i < numSamples; ++i)
     {
-      projection(k++) = arma::dot(dataset.col(sampledIndices[i]),
-                                  *addBasisVector1);
-      projection(k) = arma::dot(dataset.col(sampledIndices[i]),
-                                *addBasisVector2);
+      projections(i, k) = arma::dot(dataset.col(sampledIndices[i]),
+                                    *basisVectors[k]);
     }
+  }
 
-    // Calculate the Frobenius norm squared of the projected vector.
-    double frobProjection = arma::norm(projection, "frob");
-    double frobProjectionSquared = frobProjection * frobProjection;
-
-    // Calculate the weighted projection magnitude.
+  // Calculate the weighted projection magnitude of each sample, from the
+  // Frobenius norm squared of its projection.
+  for (size_t i = 0; i < numSamples; ++i)
+  {
+    const double frobProjectionSquared = arma::accu(arma::square(
+        projections.row(i)));
     weightedMagnitudes(i) = frobProjectionSquared / probabilities(i);
   }
 
@@ -633,7 +641,8 @@ void CosineTree::CalculateCosines(arma::vec& cosines)
   // Initialize cosine vector as a vector of zeros.
   cosines.zeros(numColumns);
 
-  for (size_t i = 0; i < numColumns; ++i)
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) numColumns; ++i)
   {
     // If norm is zero, store cosine value as zero. Else, calculate cosine value
     // between two vectors.
@@ -652,14 +661,28 @@ void CosineTree::CalculateCosines(arma::vec& cosines)
 
 void CosineTree::CalculateCentroid()
 {
-  // Initialize centroid as vector of zeros.
-  centroid.zeros(dataset->n_rows);
-
-  // Calculate centroid of columns in the node.
-  for (size_t i = 0; i < numColumns; ++i)
+  // Sum the columns of the node in fixed chunks, in parallel, and then sum the
+  // chunks; the chunks do not depend on the number of threads, so neither does
+  // the result.
+  const size_t chunkSize = 1024;
+  const size_t numChunks = (numColumns + chunkSize - 1) / chunkSize;
+  arma::mat partialSums(dataset->n_rows, numChunks);
+  #pragma omp parallel for
+  for (omp_size_t c = 0; c < (omp_size_t) numChunks; ++c)
   {
-    centroid += dataset->col(indices[i]);
+    const size_t end = std::min((c + 1) * chunkSize, numColumns);
+    double* sum = partialSums.colptr(c);
+    std::fill(sum, sum + dataset->n_rows, 0.0);
+    for (size_t i = c * chunkSize; i < end; ++i)
+    {
+      const double* column = dataset->colptr(indices[i]);
+      for (size_t r = 0; r < dataset->n_rows; ++r)
+        sum[r] += column[r];
+    }
   }
+
+  // Calculate centroid of columns in the node.
+  centroid = arma::sum(partialSums, 1);
   centroid /= numColumns;
 }
 
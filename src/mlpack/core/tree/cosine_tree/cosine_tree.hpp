@@ -104,7 +104,8 @@ class CosineTree
 
   /**
    * Calculates the orthonormalization of the passed centroid, with respect to
-   * the current vector subspace.
+   * the current vector subspace.  The projections onto the basis vectors are
+   * computed in parallel.
    *
    * @param treeQueue Priority queue of cosine nodes.
    * @param centroid Centroid of the node being added to the basis.
@@ -122,6 +123,8 @@ class CosineTree
    * weighted norms of projections of samples drawn from the input node's matrix
    * columns. The error is calculated as the difference between the Frobenius
    * norm of the input node's matrix and lower bound of the normal distribution.
+   * The projections of the samples are computed in parallel over the basis
+   * vectors.
    *
    * @param node Node for which Monte Carlo estimate is calculated.
    * @param treeQueue Priority queue of cosine nodes.
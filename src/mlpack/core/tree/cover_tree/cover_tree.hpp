@@ -281,6 +281,8 @@ class CoverTree
 
   //! Get a reference to the dataset.
   const MatType& Dataset() const { return *dataset; }
+  //! Modify the dataset which the tree is built on.  Be careful!
+  MatType& Dataset() { return const_cast<MatType&>(*dataset); }
 
   //! Get the index of the point which this node represents.
   size_t Point() const { return point; }
@@ -311,6 +313,33 @@ class CoverTree
   //! Get the index of a particular descendant point.
   size_t Descendant(const size_t index) const;
 
+  /**
+   * Insert a point into the tree.  The point must already be a column of the
+   * dataset (see Dataset()), and this must be called on the root.  The new
+   * point becomes a leaf under the deepest node that covers it, so the cost is
+   * one distance evaluation per child of each node on the path down; the
+   * scale of the root is raised if the point is outside it.  The statistics of
+   * the nodes are not updated.
+   *
+   * @param point The index of a point in the dataset.
+   */
+  void InsertPoint(const size_t point);
+
+  /**
+   * Remove a point from the tree; the point is kept in the dataset, so the
+   * indices of the other points do not change.  This must be called on the
+   * root.  Every other point below the topmost node holding the removed point
+   * is reinserted with InsertPoint(), so removing a point near the top of the
+   * tree can cost much more than removing a leaf, and removing the root point
+   * reinserts every other point.  The statistics of the nodes are not
+   * updated.
+   *
+   * @param point The index of a point in the dataset.
+   * @return false if the point is not in the tree, or if it is the only point
+   *     in the tree (a cover tree can't be empty); true otherwise.
+   */
+  bool DeletePoint(const size_t point);
+
   //! Get the scale of this node.
   int Scale() const { return scale; }
   //! Modify the scale of this node.  Be careful...
@@ -433,6 +462,19 @@ class CoverTree
   //! Get the instantiated metric.
   MetricType& Metric() const { return *metric; }
 
+  /**
+   * Get or modify the minimum number of points whose distances to a new node
+   * are computed in parallel (with OpenMP) while the tree is built.  Smaller
+   * point sets are handled serially.  The metric must then be safe to evaluate
+   * from several threads at once; the resulting tree is the same either way.
+   * The setting is shared by all trees of this type.
+   */
+  static size_t& ParallelBuildThreshold()
+  {
+    static size_t threshold = 10000;
+    return threshold;
+  }
+
  private:
   //! Reference to the matrix which this tree is built on.
   const MatType* dataset;
@@ -549,6 +591,12 @@ class CoverTree
    */
   void RemoveNewImplicitNodes();
 
+  /**
+   * Find the topmost node holding the given point, or NULL if it is not below
+   * this node.  The furthest descendant distances are used to skip subtrees.
+   */
+  CoverTree* FindPoint(const size_t pointIndex);
+
  protected:
   /**
    * A default constructor.  This is meant to only be used with
@@ -15,6 +15,7 @@
 // In case it hasn't already been included.
 #include "cover_tree.hpp"
 
+#include <algorithm>
 #include <queue>
 #include <string>
 
@@ -801,6 +802,180 @@ CoverTree<MetricType, StatisticType, MatType, RootPointPolicy>::Descendant(
   return (size_t() - 1);
 }
 
+// Insert a point into the tree.
+template<
+    typename MetricType,
+    typename StatisticType,
+    typename MatType,
+    typename RootPointPolicy
+>
+void CoverTree<MetricType, StatisticType, MatType, RootPointPolicy>::
+    InsertPoint(const size_t pointIndex)
+{
+  const ElemType rootDistance = metric->Evaluate(dataset->col(point),
+      dataset->col(pointIndex));
+
+  // A tree holding a single point is a leaf; it needs a self-child before the
+  // new point can be added next to it.
+  if (children.empty())
+  {
+    scale = (rootDistance == 0.0) ? INT_MIN + 1 :
+        (int) ceil(log(rootDistance) / log(base));
+    children.push_back(new CoverTree(*dataset, base, point, INT_MIN, this, 0,
+        0, metric));
+    children[0]->numDescendants = 1;
+    children[0]->Stat() = StatisticType(*children[0]);
+  }
+  else if (rootDistance > furthestDescendantDistance)
+  {
+    // Grow the root the same way the constructor sets its scale.
+    scale = std::max(scale, (int) ceil(log(rootDistance) / log(base)));
+  }
+
+  // Walk down to the deepest node that covers the point, remembering the
+  // distance from each node on the path.  The first child is the self-child,
+  // so its distance is already known.
+  std::vector<std::pair<CoverTree*, ElemType>> path;
+  path.push_back(std::make_pair(this, rootDistance));
+  while (true)
+  {
+    CoverTree* node = path.back().first;
+    CoverTree* next = NULL;
+    ElemType nextDistance = 0;
+    for (size_t i = 0; i < node->NumChildren(); ++i)
+    {
+      CoverTree* child = node->children[i];
+      if (child->IsLeaf())
+        continue;
+
+      const ElemType distance = (i == 0) ? path.back().second :
+          metric->Evaluate(dataset->col(child->Point()),
+          dataset->col(pointIndex));
+      if (distance <= pow(base, child->Scale()) &&
+          (next == NULL || distance < nextDistance))
+      {
+        next = child;
+        nextDistance = distance;
+      }
+    }
+
+    if (next == NULL)
+      break;
+    path.push_back(std::make_pair(next, nextDistance));
+  }
+
+  // The point becomes a leaf of that node.
+  CoverTree* node = path.back().first;
+  CoverTree* leaf = new CoverTree(*dataset, base, pointIndex, INT_MIN, node,
+      path.back().second, 0, metric);
+  leaf->numDescendants = 1;
+  leaf->Stat() = StatisticType(*leaf);
+  node->children.push_back(leaf);
+
+  for (size_t i = 0; i < path.size(); ++i)
+  {
+    ++path[i].first->numDescendants;
+    path[i].first->furthestDescendantDistance = std::max(
+        path[i].first->furthestDescendantDistance, path[i].second);
+  }
+}
+
+// Remove a point from the tree.
+template<
+    typename MetricType,
+    typename StatisticType,
+    typename MatType,
+    typename RootPointPolicy
+>
+bool CoverTree<MetricType, StatisticType, MatType, RootPointPolicy>::
+    DeletePoint(const size_t pointIndex)
+{
+  CoverTree* node = FindPoint(pointIndex);
+  if (node == NULL || numDescendants == 1)
+    return false;
+
+  // Every other point below the node is reinserted once the node is gone.
+  std::vector<size_t> points;
+  points.reserve(node->NumDescendants() - 1);
+  for (size_t i = 1; i < node->NumDescendants(); ++i)
+    points.push_back(node->Descendant(i));
+
+  if (node == this)
+  {
+    // Start again from a single leaf holding one of the remaining points.
+    for (size_t i = 0; i < children.size(); ++i)
+      delete children[i];
+    children.clear();
+
+    point = points.back();
+    points.pop_back();
+    scale = INT_MIN;
+    numDescendants = 1;
+    furthestDescendantDistance = 0;
+  }
+  else
+  {
+    // The node can't be a self-child, because its parent holds another point.
+    // The furthest descendant distances above it are still valid bounds.
+    CoverTree* parentNode = node->Parent();
+    parentNode->children.erase(std::find(parentNode->children.begin(),
+        parentNode->children.end(), node));
+    for (CoverTree* p = parentNode; p != NULL; p = p->Parent())
+      p->numDescendants -= node->NumDescendants();
+    delete node;
+
+    // If only the self-child is left, the parent is now an implicit node, so
+    // it takes the place of its self-child.
+    if (parentNode->NumChildren() == 1)
+    {
+      CoverTree* old = parentNode->children[0];
+      parentNode->children = std::move(old->children);
+      old->children.clear();
+      for (size_t i = 0; i < parentNode->NumChildren(); ++i)
+        parentNode->children[i]->Parent() = parentNode;
+
+      parentNode->scale = old->Scale();
+      parentNode->furthestDescendantDistance =
+          old->FurthestDescendantDistance();
+      delete old;
+    }
+  }
+
+  for (size_t i = 0; i < points.size(); ++i)
+    InsertPoint(points[i]);
+
+  return true;
+}
+
+// Find the topmost node holding a point.
+template<
+    typename MetricType,
+    typename StatisticType,
+    typename MatType,
+    typename RootPointPolicy
+>
+CoverTree<MetricType, StatisticType, MatType, RootPointPolicy>*
+CoverTree<MetricType, StatisticType, MatType, RootPointPolicy>::FindPoint(
+    const size_t pointIndex)
+{
+  if (point == pointIndex)
+    return this;
+
+  // No descendant is further away than the furthest descendant distance.
+  if (metric->Evaluate(dataset->col(point), dataset->col(pointIndex)) >
+      furthestDescendantDistance)
+    return NULL;
+
+  for (size_t i = 0; i < children.size(); ++i)
+  {
+    CoverTree* node = children[i]->FindPoint(pointIndex);
+    if (node != NULL)
+      return node;
+  }
+
+  return NULL;
+}
+
 /**
  * Return the index of the nearest child node to the given query point.  If
  * this is a leaf node, it will return NumChildren() (invalid index).
@@ -1394,7 +1569,11 @@ void CoverTree<MetricType, StatisticType, MatType, RootPointPolicy>::
   // For each point, rebuild the distances.  The indices do not need to be
   // modified.
   distanceComps += pointSetSize;
-  for (size_t i = 0; i < pointSetSize; ++i)
+
+  // The large point sets near the top of the tree dominate the build time, and
+  // their distances are independent of each other.
+  #pragma omp parallel for if (pointSetSize >= ParallelBuildThreshold())
+  for (omp_size_t i = 0; i < (omp_size_t) pointSetSize; ++i)
   {
     distances[i] = metric->Evaluate(dataset->col(pointIndex),
         dataset->col(indices[i]));
@@ -15,6 +15,8 @@
 #include <mlpack/prereqs.hpp>
 #include <queue>
 
+#include "../traversal_statistics.hpp"
+
 namespace mlpack {
 namespace tree {
 
@@ -53,6 +55,9 @@ class CoverTree<MetricType, StatisticType, MatType, RootPointPolicy>::
   size_t NumScores() const { return 0; }
   size_t NumBaseCases() const { return 0; }
 
+  //! Get the timings and the maximum recursion depth of the traversals.
+  const TraversalStatistics& Statistics() const { return statistics; }
+
  private:
   //! The instantiated rule set for pruning branches.
   RuleType& rule;
@@ -60,6 +65,9 @@ class CoverTree<MetricType, StatisticType, MatType, RootPointPolicy>::
   //! The number of pruned nodes.
   size_t numPrunes;
 
+  //! The timings and the recursion depth of the traversals.
+  TraversalStatistics statistics;
+
   //! Struct used for traversal.
   struct DualCoverTreeMapEntry
   {
@@ -50,9 +50,13 @@ DualTreeTraverser<RuleType>::Traverse(CoverTree& queryNode,
   rootRefEntry.referenceNode = &referenceNode;
 
   // Perform the evaluation between the roots of either tree.
+  TraversalStatistics::Clock::time_point start = TraversalStatistics::Now();
   rootRefEntry.score = rule.Score(queryNode, referenceNode);
+  statistics.AddScoreTime(start);
+  start = TraversalStatistics::Now();
   rootRefEntry.baseCase = rule.BaseCase(queryNode.Point(),
       referenceNode.Point());
+  statistics.AddBaseCaseTime(start);
   rootRefEntry.traversalInfo = rule.TraversalInfo();
 
   refMap[referenceNode.Scale()].push_back(rootRefEntry);
@@ -72,6 +76,8 @@ DualTreeTraverser<RuleType>::Traverse(
     CoverTree& queryNode,
     std::map<int, std::vector<DualCoverTreeMapEntry> >& referenceMap)
 {
+  TraversalStatistics::Level level(statistics);
+
   if (referenceMap.size() == 0)
     return; // Nothing to do!
 
@@ -133,7 +139,9 @@ DualTreeTraverser<RuleType>::Traverse(
     // Score the node, to see if we can prune it, after restoring the traversal
     // info.
     rule.TraversalInfo() = frame.traversalInfo;
+    TraversalStatistics::Clock::time_point start = TraversalStatistics::Now();
     double score = rule.Score(queryNode, *refNode);
+    statistics.AddScoreTime(start);
 
     if (score == DBL_MAX)
     {
@@ -142,7 +150,9 @@ DualTreeTraverser<RuleType>::Traverse(
     }
 
     // If not, compute the base case.
+    start = TraversalStatistics::Now();
     rule.BaseCase(queryNode.Point(), pointVector[i].referenceNode->Point());
+    statistics.AddBaseCaseTime(start);
   }
 }
 
@@ -186,7 +196,10 @@ DualTreeTraverser<RuleType>::PruneMap(
 
       // Perform the actual scoring, after restoring the traversal info.
       rule.TraversalInfo() = frame.traversalInfo;
+      TraversalStatistics::Clock::time_point start =
+          TraversalStatistics::Now();
       double score = rule.Score(queryNode, *refNode);
+      statistics.AddScoreTime(start);
 
       if (score == DBL_MAX)
       {
@@ -196,8 +209,10 @@ DualTreeTraverser<RuleType>::PruneMap(
       }
 
       // If it isn't pruned, we must evaluate the base case.
+      start = TraversalStatistics::Now();
       const double baseCase = rule.BaseCase(queryNode.Point(),
           refNode->Point());
+      statistics.AddBaseCaseTime(start);
 
       // Add to child map.
       newScaleVector.push_back(frame);
@@ -239,7 +254,10 @@ DualTreeTraverser<RuleType>::PruneMap(
 
       // Perform the actual scoring, after restoring the traversal info.
       rule.TraversalInfo() = frame.traversalInfo;
+      TraversalStatistics::Clock::time_point start =
+          TraversalStatistics::Now();
       double score = rule.Score(queryNode, *refNode);
+      statistics.AddScoreTime(start);
 
       if (score == DBL_MAX)
       {
@@ -249,8 +267,10 @@ DualTreeTraverser<RuleType>::PruneMap(
       }
 
       // If it isn't pruned, we must evaluate the base case.
+      start = TraversalStatistics::Now();
       const double baseCase = rule.BaseCase(queryNode.Point(),
           refNode->Point());
+      statistics.AddBaseCaseTime(start);
 
       // Add to child map.
       newScaleVector.push_back(frame);
@@ -328,7 +348,10 @@ DualTreeTraverser<RuleType>::ReferenceRecursion(
       for (size_t j = 0; j < refNode->NumChildren(); ++j)
       {
         rule.TraversalInfo() = frame.traversalInfo;
+        TraversalStatistics::Clock::time_point start =
+            TraversalStatistics::Now();
         double childScore = rule.Score(queryNode, refNode->Child(j));
+        statistics.AddScoreTime(start);
         if (childScore == DBL_MAX)
         {
           ++numPrunes;
@@ -336,8 +359,10 @@ DualTreeTraverser<RuleType>::ReferenceRecursion(
         }
 
         // It wasn't pruned; evaluate the base case.
+        start = TraversalStatistics::Now();
         const double baseCase = rule.BaseCase(queryNode.Point(),
             refNode->Child(j).Point());
+        statistics.AddBaseCaseTime(start);
 
         DualCoverTreeMapEntry newFrame;
         newFrame.referenceNode = &refNode->Child(j);
@@ -16,6 +16,7 @@
 
 #include <mlpack/prereqs.hpp>
 
+#include "../traversal_statistics.hpp"
 #include "cover_tree.hpp"
 
 namespace mlpack {
@@ -51,12 +52,18 @@ class CoverTree<MetricType, StatisticType, MatType, RootPointPolicy>::
   //! Set the number of prunes (good for a reset to 0).
   size_t& NumPrunes() { return numPrunes; }
 
+  //! Get the timings and the maximum depth of the traversals, in scales.
+  const TraversalStatistics& Statistics() const { return statistics; }
+
  private:
   //! Reference to the rules with which the tree will be traversed.
   RuleType& rule;
 
   //! The number of nodes which have been pruned during traversal.
   size_t numPrunes;
+
+  //! The timings and the depth of the traversals.
+  TraversalStatistics statistics;
 };
 
 } // namespace tree
@@ -84,8 +84,15 @@ SingleTreeTraverser<RuleType>::Traverse(
   // largest scale.
   std::map<int, std::vector<MapEntryType> > mapQueue;
 
+  // The traversal is not recursive, so its depth is the number of scales
+  // visited.
+  size_t depth = 1;
+  statistics.ReachDepth(depth);
+
   // Create the score for the children.
+  TraversalStatistics::Clock::time_point start = TraversalStatistics::Now();
   double rootChildScore = rule.Score(queryIndex, referenceNode);
+  statistics.AddScoreTime(start);
 
   if (rootChildScore == DBL_MAX)
   {
@@ -97,7 +104,9 @@ SingleTreeTraverser<RuleType>::Traverse(
     // Often, a ruleset will return without doing any computation on cover trees
     // using TreeTraits::FirstPointIsCentroid; this is an optimization that
     // (theoretically) the compiler should get right.
+    start = TraversalStatistics::Now();
     double rootBaseCase = rule.BaseCase(queryIndex, referenceNode.Point());
+    statistics.AddBaseCaseTime(start);
 
     // Don't add the self-leaf.
     size_t i = 0;
@@ -131,6 +140,7 @@ SingleTreeTraverser<RuleType>::Traverse(
   {
     // Get a reference to the current scale.
     std::vector<MapEntryType>& scaleVector = (*rit).second;
+    statistics.ReachDepth(++depth);
 
     // Before traversing all the points in this scale, sort by score.
     std::sort(scaleVector.begin(), scaleVector.end());
@@ -155,7 +165,9 @@ SingleTreeTraverser<RuleType>::Traverse(
       }
 
       // Create the score for the children.
+      start = TraversalStatistics::Now();
       const double childScore = rule.Score(queryIndex, *node);
+      statistics.AddScoreTime(start);
 
       // Now if this childScore is DBL_MAX we can prune all children.  In this
       // recursion setup pruning is all or nothing for children.
@@ -170,7 +182,11 @@ SingleTreeTraverser<RuleType>::Traverse(
       // trees using TreeTraits::FirstPointIsCentroid; this is an optimization
       // that (theoretically) the compiler should get right.
       if (point != parent)
+      {
+        start = TraversalStatistics::Now();
         baseCase = rule.BaseCase(queryIndex, point);
+        statistics.AddBaseCaseTime(start);
+      }
 
       // Don't add the self-leaf.
       size_t j = 0;
@@ -197,6 +213,8 @@ SingleTreeTraverser<RuleType>::Traverse(
   }
 
   // Now deal with the leaves.
+  if (!mapQueue[INT_MIN].empty())
+    statistics.ReachDepth(depth + 1);
   for (size_t i = 0; i < mapQueue[INT_MIN].size(); ++i)
   {
     const MapEntryType& frame = mapQueue[INT_MIN].at(i);
@@ -217,7 +235,9 @@ SingleTreeTraverser<RuleType>::Traverse(
     // For this to be a valid dual-tree algorithm, we *must* evaluate the
     // combination, even if pruning it will make no difference.  It's the
     // definition.
+    start = TraversalStatistics::Now();
     const double actualScore = rule.Score(queryIndex, *node);
+    statistics.AddScoreTime(start);
 
     if (actualScore == DBL_MAX)
     {
@@ -230,7 +250,9 @@ SingleTreeTraverser<RuleType>::Traverse(
       // Often, a ruleset will return without doing any computation on cover
       // trees using TreeTraits::FirstPointIsCentroid; this is an optimization
       // that (theoretically) the compiler should get right.
+      start = TraversalStatistics::Now();
       rule.BaseCase(queryIndex, point);
+      statistics.AddBaseCaseTime(start);
     }
   }
 }
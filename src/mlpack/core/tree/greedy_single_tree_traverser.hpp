@@ -16,6 +16,8 @@
 
 #include <mlpack/prereqs.hpp>
 
+#include "traversal_statistics.hpp"
+
 namespace mlpack {
 namespace tree {
 
@@ -40,12 +42,18 @@ class GreedySingleTreeTraverser
   //! Get the number of prunes.
   size_t NumPrunes() const { return numPrunes; }
 
+  //! Get the timings and the maximum recursion depth of the traversals.
+  const TraversalStatistics& Statistics() const { return statistics; }
+
  private:
   //! Reference to the rules with which the tree will be traversed.
   RuleType& rule;
 
   //! The number of nodes which have been pruned during traversal.
   size_t numPrunes;
+
+  //! The timings and the recursion depth of the traversals.
+  TraversalStatistics statistics;
 };
 
 } // namespace tree
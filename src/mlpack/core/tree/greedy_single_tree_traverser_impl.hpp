@@ -32,11 +32,17 @@ void GreedySingleTreeTraverser<TreeType, RuleType>::Traverse(
     const size_t queryIndex,
     TreeType& referenceNode)
 {
+  TraversalStatistics::Level level(statistics);
+
   // Run the base case as necessary for all the points in the reference node.
+  TraversalStatistics::Clock::time_point start = TraversalStatistics::Now();
   for (size_t i = 0; i < referenceNode.NumPoints(); ++i)
     rule.BaseCase(queryIndex, referenceNode.Point(i));
+  statistics.AddBaseCaseTime(start);
 
+  start = TraversalStatistics::Now();
   size_t bestChild = rule.GetBestChild(queryIndex, referenceNode);
+  statistics.AddScoreTime(start);
   size_t numDescendants;
 
   // Check that referencenode is not a leaf node while calculating number of
@@ -62,8 +68,10 @@ void GreedySingleTreeTraverser<TreeType, RuleType>::Traverse(
     else
     {
       // Run the base case over first minBaseCases number of descendants.
+      start = TraversalStatistics::Now();
       for (size_t i = 0; i <= rule.MinimumBaseCases(); ++i)
         rule.BaseCase(queryIndex, referenceNode.Descendant(i));
+      statistics.AddBaseCaseTime(start);
     }
   }
 }
@@ -139,6 +139,16 @@ class HRectBound
    */
   ElemType MinDistance(const HRectBound& other) const;
 
+  /**
+   * Calculates the minimum distance to each of the given bounds at once (for
+   * instance, to the bounds of all of the children of a node).
+   *
+   * @param others Bounds to which the minimum distances are requested.
+   * @param distances The minimum distance to each bound.
+   */
+  void MinDistance(const std::vector<const HRectBound*>& others,
+                   arma::Col<ElemType>& distances) const;
+
   /**
    * Calculates maximum bound-to-point squared distance.
    *
@@ -164,6 +174,18 @@ class HRectBound
    */
   math::RangeType<ElemType> RangeDistance(const HRectBound& other) const;
 
+  /**
+   * Calculates the minimum and maximum distances to each of the given bounds
+   * at once (for instance, to the bounds of all of the children of a node).
+   *
+   * @param others Bounds to which the distances are requested.
+   * @param minDistances The minimum distance to each bound.
+   * @param maxDistances The maximum distance to each bound.
+   */
+  void RangeDistance(const std::vector<const HRectBound*>& others,
+                     arma::Col<ElemType>& minDistances,
+                     arma::Col<ElemType>& maxDistances) const;
+
   /**
    * Calculates minimum and maximum bound-to-point distance.
    *
@@ -240,6 +262,12 @@ class HRectBound
   ElemType minWidth;
   //! Instantiated metric (likely has size 0).
   MetricType metric;
+
+  //! Raise a nonnegative distance along one dimension to the power of the
+  //! metric.
+  static ElemType Pow(const ElemType v);
+  //! Take the root of a sum of powers, if the metric takes the root.
+  static ElemType Root(const ElemType sum);
 };
 
 // A specialization of BoundTraits for this class.
@@ -161,6 +161,36 @@ inline ElemType HRectBound<MetricType, ElemType>::Volume() const
   return volume;
 }
 
+/**
+ * Raise a nonnegative value to the power of the metric.
+ */
+template<typename MetricType, typename ElemType>
+inline ElemType HRectBound<MetricType, ElemType>::Pow(const ElemType v)
+{
+  // The compiler should optimize out this if statement entirely.
+  if (MetricType::Power == 1)
+    return v;
+  else if (MetricType::Power == 2)
+    return v * v;
+  else
+    return std::pow(v, (ElemType) MetricType::Power);
+}
+
+/**
+ * Take the root of a sum of powers, if the metric takes the root.
+ */
+template<typename MetricType, typename ElemType>
+inline ElemType HRectBound<MetricType, ElemType>::Root(const ElemType sum)
+{
+  // The compiler should optimize out this if statement entirely.
+  if (!MetricType::TakeRoot || MetricType::Power == 1)
+    return sum;
+  else if (MetricType::Power == 2)
+    return (ElemType) std::sqrt(sum);
+  else
+    return (ElemType) pow((double) sum, 1.0 / (double) MetricType::Power);
+}
+
 /**
  * Calculates minimum bound-to-point squared distance.
  */
@@ -172,52 +202,21 @@ inline ElemType HRectBound<MetricType, ElemType>::MinDistance(
 {
   Log::Assert(point.n_elem == dim);
 
+  // Since at most one of (lo - x) and (x - hi) is positive, the distance along
+  // each dimension is max(0, lo - x, x - hi); this is branch-free and can be
+  // vectorized.  (The SIMD directives need OpenMP 4.0.)
   ElemType sum = 0;
-
-  ElemType lower, higher;
+  #if defined(_OPENMP) && (_OPENMP >= 201307)
+  #pragma omp simd reduction(+:sum)
+  #endif
   for (size_t d = 0; d < dim; d++)
   {
-    lower = bounds[d].Lo() - point[d];
-    higher = point[d] - bounds[d].Hi();
-
-    // Since only one of 'lower' or 'higher' is negative, if we add each's
-    // absolute value to itself and then sum those two, our result is the
-    // nonnegative half of the equation times two; then we raise to power Power.
-    if (MetricType::Power == 1)
-      sum += (lower + std::fabs(lower)) + (higher + std::fabs(higher));
-    else if (MetricType::Power == 2)
-    {
-      ElemType dist = (lower + std::fabs(lower)) + (higher + std::fabs(higher));
-      sum += dist * dist;
-    }
-    else
-    {
-      sum += pow((lower + fabs(lower)) + (higher + fabs(higher)),
-          (ElemType) MetricType::Power);
-    }
+    const ElemType v = std::max(std::max(bounds[d].Lo() - point[d],
+        point[d] - bounds[d].Hi()), (ElemType) 0);
+    sum += Pow(v);
   }
 
-  // Now take the Power'th root (but make sure our result is squared if it needs
-  // to be); then cancel out the constant of 2 (which may have been squared now)
-  // that was introduced earlier.  The compiler should optimize out the if
-  // statement entirely.
-  if (MetricType::Power == 1)
-    return sum * 0.5;
-  else if (MetricType::Power == 2)
-  {
-    if (MetricType::TakeRoot)
-      return (ElemType) std::sqrt(sum) * 0.5;
-    else
-      return sum * 0.25;
-  }
-  else
-  {
-    if (MetricType::TakeRoot)
-      return (ElemType) pow((double) sum,
-          1.0 / (double) MetricType::Power) / 2.0;
-    else
-      return sum / pow(2.0, MetricType::Power);
-  }
+  return Root(sum);
 }
 
 /**
@@ -229,56 +228,50 @@ ElemType HRectBound<MetricType, ElemType>::MinDistance(const HRectBound& other)
 {
   Log::Assert(dim == other.dim);
 
+  // The distance along each dimension is max(0, olo - hi, lo - ohi).
   ElemType sum = 0;
   const math::RangeType<ElemType>* mbound = bounds;
   const math::RangeType<ElemType>* obound = other.bounds;
+  #if defined(_OPENMP) && (_OPENMP >= 201307)
+  #pragma omp simd reduction(+:sum)
+  #endif
+  for (size_t d = 0; d < dim; d++)
+  {
+    const ElemType v = std::max(std::max(obound[d].Lo() - mbound[d].Hi(),
+        mbound[d].Lo() - obound[d].Hi()), (ElemType) 0);
+    sum += Pow(v);
+  }
+
+  return Root(sum);
+}
 
-  ElemType lower, higher;
+/**
+ * Calculates the minimum distance to each of the given bounds.
+ */
+template<typename MetricType, typename ElemType>
+void HRectBound<MetricType, ElemType>::MinDistance(
+    const std::vector<const HRectBound*>& others,
+    arma::Col<ElemType>& distances) const
+{
+  distances.zeros(others.size());
+
+  // Each dimension of this bound is loaded once for all of the other bounds.
   for (size_t d = 0; d < dim; d++)
   {
-    lower = obound->Lo() - mbound->Hi();
-    higher = mbound->Lo() - obound->Hi();
-    // We invoke the following:
-    //   x + fabs(x) = max(x * 2, 0)
-    //   (x * 2)^2 / 4 = x^2
-
-    // The compiler should optimize out this if statement entirely.
-    if (MetricType::Power == 1)
-      sum += (lower + std::fabs(lower)) + (higher + std::fabs(higher));
-    else if (MetricType::Power == 2)
+    const ElemType lo = bounds[d].Lo();
+    const ElemType hi = bounds[d].Hi();
+    for (size_t j = 0; j < others.size(); ++j)
     {
-      ElemType dist = (lower + std::fabs(lower)) + (higher + std::fabs(higher));
-      sum += dist * dist;
+      Log::Assert(dim == others[j]->dim);
+      const math::RangeType<ElemType>& obound = others[j]->bounds[d];
+      const ElemType v = std::max(std::max(obound.Lo() - hi,
+          lo - obound.Hi()), (ElemType) 0);
+      distances[j] += Pow(v);
     }
-    else
-    {
-      sum += pow((lower + fabs(lower)) + (higher + fabs(higher)),
-          (ElemType) MetricType::Power);
-    }
-
-    // Move bound pointers.
-    mbound++;
-    obound++;
   }
 
-  // The compiler should optimize out this if statement entirely.
-  if (MetricType::Power == 1)
-    return sum * 0.5;
-  else if (MetricType::Power == 2)
-  {
-    if (MetricType::TakeRoot)
-      return (ElemType) std::sqrt(sum) * 0.5;
-    else
-      return sum * 0.25;
-  }
-  else
-  {
-    if (MetricType::TakeRoot)
-      return (ElemType) pow((double) sum,
-          1.0 / (double) MetricType::Power) / 2.0;
-    else
-      return sum / pow(2.0, MetricType::Power);
-  }
+  for (size_t j = 0; j < others.size(); ++j)
+    distances[j] = Root(distances[j]);
 }
 
 /**
@@ -290,36 +283,20 @@ inline ElemType HRectBound<MetricType, ElemType>::MaxDistance(
     const VecType& point,
     typename std::enable_if_t<IsVector<VecType>::value>* /* junk */) const
 {
-  ElemType sum = 0;
-
   Log::Assert(point.n_elem == dim);
 
+  ElemType sum = 0;
+  #if defined(_OPENMP) && (_OPENMP >= 201307)
+  #pragma omp simd reduction(+:sum)
+  #endif
   for (size_t d = 0; d < dim; d++)
   {
-    ElemType v = std::max(fabs(point[d] - bounds[d].Lo()),
-        fabs(bounds[d].Hi() - point[d]));
-
-    // The compiler should optimize out this if statement entirely.
-    if (MetricType::Power == 1)
-      sum += v; // v is non-negative.
-    else if (MetricType::Power == 2)
-      sum += v * v;
-    else
-      sum += std::pow(v, (ElemType) MetricType::Power);
+    const ElemType v = std::max(std::fabs(point[d] - bounds[d].Lo()),
+        std::fabs(bounds[d].Hi() - point[d]));
+    sum += Pow(v);
   }
 
-  // The compiler should optimize out this if statement entirely.
-  if (MetricType::TakeRoot)
-  {
-    if (MetricType::Power == 1)
-      return sum;
-    else if (MetricType::Power == 2)
-      return (ElemType) std::sqrt(sum);
-    else
-      return (ElemType) pow((double) sum, 1.0 / (double) MetricType::Power);
-  }
-  else
-    return sum;
+  return Root(sum);
 }
 
 /**
@@ -330,37 +307,20 @@ inline ElemType HRectBound<MetricType, ElemType>::MaxDistance(
     const HRectBound& other)
     const
 {
-  ElemType sum = 0;
-
   Log::Assert(dim == other.dim);
 
-  ElemType v;
+  ElemType sum = 0;
+  #if defined(_OPENMP) && (_OPENMP >= 201307)
+  #pragma omp simd reduction(+:sum)
+  #endif
   for (size_t d = 0; d < dim; d++)
   {
-    v = std::max(fabs(other.bounds[d].Hi() - bounds[d].Lo()),
-        fabs(bounds[d].Hi() - other.bounds[d].Lo()));
-
-    // The compiler should optimize out this if statement entirely.
-    if (MetricType::Power == 1)
-      sum += v; // v is non-negative.
-    else if (MetricType::Power == 2)
-      sum += v * v;
-    else
-      sum += std::pow(v, (ElemType) MetricType::Power);
+    const ElemType v = std::max(std::fabs(other.bounds[d].Hi() -
+        bounds[d].Lo()), std::fabs(bounds[d].Hi() - other.bounds[d].Lo()));
+    sum += Pow(v);
   }
 
-  // The compiler should optimize out this if statement entirely.
-  if (MetricType::TakeRoot)
-  {
-    if (MetricType::Power == 1)
-      return sum;
-    else if (MetricType::Power == 2)
-      return (ElemType) std::sqrt(sum);
-    else
-      return (ElemType) pow((double) sum, 1.0 / (double) MetricType::Power);
-  }
-  else
-    return sum;
+  return Root(sum);
 }
 
 /**
@@ -371,62 +331,60 @@ inline math::RangeType<ElemType>
 HRectBound<MetricType, ElemType>::RangeDistance(
     const HRectBound& other) const
 {
+  Log::Assert(dim == other.dim);
+
+  // With v1 = olo - hi and v2 = lo - ohi (at least one of which is negative),
+  // the minimum distance along each dimension is max(0, v1, v2) and the maximum
+  // distance is -min(v1, v2).
   ElemType loSum = 0;
   ElemType hiSum = 0;
+  #if defined(_OPENMP) && (_OPENMP >= 201307)
+  #pragma omp simd reduction(+:loSum, hiSum)
+  #endif
+  for (size_t d = 0; d < dim; d++)
+  {
+    const ElemType v1 = other.bounds[d].Lo() - bounds[d].Hi();
+    const ElemType v2 = bounds[d].Lo() - other.bounds[d].Hi();
+    loSum += Pow(std::max(std::max(v1, v2), (ElemType) 0));
+    hiSum += Pow(-std::min(v1, v2));
+  }
 
-  Log::Assert(dim == other.dim);
+  return math::RangeType<ElemType>(Root(loSum), Root(hiSum));
+}
 
-  ElemType v1, v2, vLo, vHi;
+/**
+ * Calculates the minimum and maximum distances to each of the given bounds.
+ */
+template<typename MetricType, typename ElemType>
+void HRectBound<MetricType, ElemType>::RangeDistance(
+    const std::vector<const HRectBound*>& others,
+    arma::Col<ElemType>& minDistances,
+    arma::Col<ElemType>& maxDistances) const
+{
+  minDistances.zeros(others.size());
+  maxDistances.zeros(others.size());
+
+  // Each dimension of this bound is loaded once for all of the other bounds.
   for (size_t d = 0; d < dim; d++)
   {
-    v1 = other.bounds[d].Lo() - bounds[d].Hi();
-    v2 = bounds[d].Lo() - other.bounds[d].Hi();
-    // One of v1 or v2 is negative.
-    if (v1 >= v2)
-    {
-      vHi = -v2; // Make it nonnegative.
-      vLo = (v1 > 0) ? v1 : 0; // Force to be 0 if negative.
-    }
-    else
+    const ElemType lo = bounds[d].Lo();
+    const ElemType hi = bounds[d].Hi();
+    for (size_t j = 0; j < others.size(); ++j)
     {
-      vHi = -v1; // Make it nonnegative.
-      vLo = (v2 > 0) ? v2 : 0; // Force to be 0 if negative.
-    }
-
-    // The compiler should optimize out this if statement entirely.
-    if (MetricType::Power == 1)
-    {
-      loSum += vLo; // vLo is non-negative.
-      hiSum += vHi; // vHi is non-negative.
-    }
-    else if (MetricType::Power == 2)
-    {
-      loSum += vLo * vLo;
-      hiSum += vHi * vHi;
-    }
-    else
-    {
-      loSum += std::pow(vLo, (ElemType) MetricType::Power);
-      hiSum += std::pow(vHi, (ElemType) MetricType::Power);
+      Log::Assert(dim == others[j]->dim);
+      const math::RangeType<ElemType>& obound = others[j]->bounds[d];
+      const ElemType v1 = obound.Lo() - hi;
+      const ElemType v2 = lo - obound.Hi();
+      minDistances[j] += Pow(std::max(std::max(v1, v2), (ElemType) 0));
+      maxDistances[j] += Pow(-std::min(v1, v2));
     }
   }
 
-  if (MetricType::TakeRoot)
+  for (size_t j = 0; j < others.size(); ++j)
   {
-    if (MetricType::Power == 1)
-      return math::RangeType<ElemType>(loSum, hiSum);
-    else if (MetricType::Power == 2)
-      return math::RangeType<ElemType>((ElemType) std::sqrt(loSum),
-                                       (ElemType) std::sqrt(hiSum));
-    else
-    {
-      return math::RangeType<ElemType>(
-          (ElemType) pow((double) loSum, 1.0 / (double) MetricType::Power),
-          (ElemType) pow((double) hiSum, 1.0 / (double) MetricType::Power));
-    }
+    minDistances[j] = Root(minDistances[j]);
+    maxDistances[j] = Root(maxDistances[j]);
   }
-  else
-    return math::RangeType<ElemType>(loSum, hiSum);
 }
 
 /**
@@ -439,70 +397,25 @@ HRectBound<MetricType, ElemType>::RangeDistance(
     const VecType& point,
     typename std::enable_if_t<IsVector<VecType>::value>* /* junk */) const
 {
-  ElemType loSum = 0;
-  ElemType hiSum = 0;
-
   Log::Assert(point.n_elem == dim);
 
-  ElemType v1, v2, vLo, vHi;
+  // With v1 = lo - x and v2 = x - hi (at least one of which is negative), the
+  // minimum distance along each dimension is max(0, v1, v2) and the maximum
+  // distance is -min(v1, v2).
+  ElemType loSum = 0;
+  ElemType hiSum = 0;
+  #if defined(_OPENMP) && (_OPENMP >= 201307)
+  #pragma omp simd reduction(+:loSum, hiSum)
+  #endif
   for (size_t d = 0; d < dim; d++)
   {
-    v1 = bounds[d].Lo() - point[d]; // Negative if point[d] > lo.
-    v2 = point[d] - bounds[d].Hi(); // Negative if point[d] < hi.
-    // One of v1 or v2 (or both) is negative.
-    if (v1 >= 0) // point[d] <= bounds_[d].Lo().
-    {
-      vHi = -v2; // v2 will be larger but must be negated.
-      vLo = v1;
-    }
-    else // point[d] is between lo and hi, or greater than hi.
-    {
-      if (v2 >= 0)
-      {
-        vHi = -v1; // v1 will be larger, but must be negated.
-        vLo = v2;
-      }
-      else
-      {
-        vHi = -std::min(v1, v2); // Both are negative, but we need the larger.
-        vLo = 0;
-      }
-    }
-
-    // The compiler should optimize out this if statement entirely.
-    if (MetricType::Power == 1)
-    {
-      loSum += vLo; // vLo is non-negative.
-      hiSum += vHi; // vHi is non-negative.
-    }
-    else if (MetricType::Power == 2)
-    {
-      loSum += vLo * vLo;
-      hiSum += vHi * vHi;
-    }
-    else
-    {
-      loSum += std::pow(vLo, (ElemType) MetricType::Power);
-      hiSum += std::pow(vHi, (ElemType) MetricType::Power);
-    }
+    const ElemType v1 = bounds[d].Lo() - point[d];
+    const ElemType v2 = point[d] - bounds[d].Hi();
+    loSum += Pow(std::max(std::max(v1, v2), (ElemType) 0));
+    hiSum += Pow(-std::min(v1, v2));
   }
 
-  if (MetricType::TakeRoot)
-  {
-    if (MetricType::Power == 1)
-      return math::RangeType<ElemType>(loSum, hiSum);
-    else if (MetricType::Power == 2)
-      return math::RangeType<ElemType>((ElemType) std::sqrt(loSum),
-                                       (ElemType) std::sqrt(hiSum));
-    else
-    {
-      return math::RangeType<ElemType>(
-          (ElemType) pow((double) loSum, 1.0 / (double) MetricType::Power),
-          (ElemType) pow((double) hiSum, 1.0 / (double) MetricType::Power));
-    }
-  }
-  else
-    return math::RangeType<ElemType>(loSum, hiSum);
+  return math::RangeType<ElemType>(Root(loSum), Root(hiSum));
 }
 
 /**
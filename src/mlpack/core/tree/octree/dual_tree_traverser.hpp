@@ -13,6 +13,7 @@
 #define MLPACK_CORE_TREE_OCTREE_DUAL_TREE_TRAVERSER_HPP
 
 #include <mlpack/prereqs.hpp>
+#include "../traversal_statistics.hpp"
 #include "octree.hpp"
 
 namespace mlpack {
@@ -56,6 +57,9 @@ class Octree<MetricType, StatisticType, MatType>::DualTreeTraverser
   //! Modify the number of times a base case was computed.
   size_t& NumBaseCases() { return numBaseCases; }
 
+  //! Get the timings and the maximum recursion depth of the traversals.
+  const TraversalStatistics& Statistics() const { return statistics; }
+
  private:
   //! The rule type to use.
   RuleType& rule;
@@ -68,6 +72,8 @@ class Octree<MetricType, StatisticType, MatType>::DualTreeTraverser
   size_t numScores;
   //! The number of times a base case was calculated.
   size_t numBaseCases;
+  //! The timings and the recursion depth of the traversals.
+  TraversalStatistics statistics;
 
   //! Traversal information, held in the class so that it isn't continually
   //! being reallocated.
@@ -36,6 +36,8 @@ template<typename RuleType>
 void Octree<MetricType, StatisticType, MatType>::DualTreeTraverser<RuleType>::
     Traverse(Octree& queryNode, Octree& referenceNode)
 {
+  TraversalStatistics::Level level(statistics);
+
   // Increment the visit counter.
   ++numVisited;
 
@@ -45,7 +47,10 @@ void Octree<MetricType, StatisticType, MatType>::DualTreeTraverser<RuleType>::
   // If both nodes are root nodes, just score them.
   if (queryNode.Parent() == NULL && referenceNode.Parent() == NULL)
   {
+    const TraversalStatistics::Clock::time_point start =
+        TraversalStatistics::Now();
     const double rootScore = rule.Score(queryNode, referenceNode);
+    statistics.AddScoreTime(start);
     // If root score is DBL_MAX, don't recurse.
     if (rootScore == DBL_MAX)
     {
@@ -56,6 +61,9 @@ void Octree<MetricType, StatisticType, MatType>::DualTreeTraverser<RuleType>::
 
   if (queryNode.IsLeaf() && referenceNode.IsLeaf())
   {
+    // The scores of the query points are counted as base case time.
+    const TraversalStatistics::Clock::time_point start =
+        TraversalStatistics::Now();
     const size_t begin = queryNode.Point(0);
     const size_t end = begin + queryNode.NumPoints();
     for (size_t q = begin; q < end; ++q)
@@ -76,6 +84,7 @@ void Octree<MetricType, StatisticType, MatType>::DualTreeTraverser<RuleType>::
 
       numBaseCases += referenceNode.NumPoints();
     }
+    statistics.AddBaseCaseTime(start);
   }
   else if (!queryNode.IsLeaf() && referenceNode.IsLeaf())
   {
@@ -83,7 +92,10 @@ void Octree<MetricType, StatisticType, MatType>::DualTreeTraverser<RuleType>::
     for (size_t i = 0; i < queryNode.NumChildren(); ++i)
     {
       rule.TraversalInfo() = traversalInfo;
+      const TraversalStatistics::Clock::time_point start =
+          TraversalStatistics::Now();
       const double score = rule.Score(queryNode.Child(i), referenceNode);
+      statistics.AddScoreTime(start);
       if (score == DBL_MAX)
       {
         ++numPrunes;
@@ -100,12 +112,15 @@ void Octree<MetricType, StatisticType, MatType>::DualTreeTraverser<RuleType>::
     arma::vec scores(referenceNode.NumChildren());
     std::vector<typename RuleType::TraversalInfoType>
         tis(referenceNode.NumChildren());
+    const TraversalStatistics::Clock::time_point start =
+        TraversalStatistics::Now();
     for (size_t i = 0; i < referenceNode.NumChildren(); ++i)
     {
       rule.TraversalInfo() = traversalInfo;
       scores[i] = rule.Score(queryNode, referenceNode.Child(i));
       tis[i] = rule.TraversalInfo();
     }
+    statistics.AddScoreTime(start);
 
     // Sort the scores.
     arma::uvec scoreOrder = arma::sort_index(scores);
@@ -134,12 +149,15 @@ void Octree<MetricType, StatisticType, MatType>::DualTreeTraverser<RuleType>::
     {
       // Now we have to recurse down the reference node, which we will do in a
       // prioritized manner.
+      const TraversalStatistics::Clock::time_point start =
+          TraversalStatistics::Now();
       for (size_t i = 0; i < referenceNode.NumChildren(); ++i)
       {
         rule.TraversalInfo() = traversalInfo;
         scores[i] = rule.Score(queryNode.Child(j), referenceNode.Child(i));
         tis[i] = rule.TraversalInfo();
       }
+      statistics.AddScoreTime(start);
 
       // Sort the scores.
       arma::uvec scoreOrder = arma::sort_index(scores);
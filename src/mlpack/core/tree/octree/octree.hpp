@@ -400,6 +400,18 @@ class Octree
   template<typename Archive>
   void serialize(Archive& ar, const unsigned int /* version */);
 
+  /**
+   * Get or modify the minimum number of points a node must hold for its
+   * children to be built as separate OpenMP tasks.  Smaller nodes are built
+   * serially; the resulting tree is the same either way.  The setting is shared
+   * by all trees of this type.
+   */
+  static size_t& ParallelBuildThreshold()
+  {
+    static size_t threshold = 10000;
+    return threshold;
+  }
+
  protected:
   /**
    * A default constructor.  This is meant to only be used with
@@ -439,6 +451,26 @@ class Octree
                  std::vector<size_t>& oldFromNew,
                  const size_t maxLeafSize);
 
+  /**
+   * Build the children of the current node, whose points have already been
+   * reordered so that child i holds the points [childBegins[i],
+   * childBegins[i + 1]).  Empty children are not created.  Large nodes build
+   * their children as separate OpenMP tasks; see ParallelBuildThreshold().
+   *
+   * @param childBegins Index of the first point of each child, and the end of
+   *     the node.
+   * @param center Center of the node.
+   * @param width Width of the current node.
+   * @param oldFromNew Mappings from old to new, or NULL if no mapping is being
+   *     kept.
+   * @param maxLeafSize Maximum number of points allowed in a leaf.
+   */
+  void BuildChildren(const arma::Col<size_t>& childBegins,
+                     const arma::vec& center,
+                     const double width,
+                     std::vector<size_t>* oldFromNew,
+                     const size_t maxLeafSize);
+
   /**
    * This is used for sorting points while splitting.
    */
@@ -820,28 +820,7 @@ void Octree<MetricType, StatisticType, MatType>::SplitNode(
   }
 
   // Now that the dataset is reordered, we can create the children.
-  arma::vec childCenter(center.n_elem);
-  const double childWidth = width / 2.0;
-  for (size_t i = 0; i < childBegins.n_elem - 1; ++i)
-  {
-    // If the child has no points, don't create it.
-    if (childBegins[i + 1] - childBegins[i] == 0)
-      continue;
-
-    // Create the correct center.
-    for (size_t d = 0; d < center.n_elem; ++d)
-    {
-      // Is the dimension "right" (1) or "left" (0)?
-      if (((i >> d) & 1) == 0)
-        childCenter[d] = center[d] - childWidth;
-      else
-        childCenter[d] = center[d] + childWidth;
-    }
-
-    children.push_back(new Octree(this, childBegins[i],
-        childBegins[i + 1] - childBegins[i], childCenter, childWidth,
-        maxLeafSize));
-  }
+  BuildChildren(childBegins, center, width, NULL, maxLeafSize);
 }
 
 //! Split the node, and store mappings.
@@ -922,28 +901,73 @@ void Octree<MetricType, StatisticType, MatType>::SplitNode(
   }
 
   // Now that the dataset is reordered, we can create the children.
-  arma::vec childCenter(center.n_elem);
-  const double childWidth = width / 2.0;
-  for (size_t i = 0; i < childBegins.n_elem - 1; ++i)
+  BuildChildren(childBegins, center, width, &oldFromNew, maxLeafSize);
+}
+
+//! Build the children of the node.
+template<typename MetricType, typename StatisticType, typename MatType>
+void Octree<MetricType, StatisticType, MatType>::BuildChildren(
+    const arma::Col<size_t>& childBegins,
+    const arma::vec& center,
+    const double width,
+    std::vector<size_t>* oldFromNew,
+    const size_t maxLeafSize)
+{
+  // The children work on disjoint column ranges of the dataset (and of
+  // oldFromNew), so they can be built at the same time and the tree will be
+  // exactly the same as if it were built serially.
+  const bool parallel = (count >= ParallelBuildThreshold());
+
+  #ifdef HAS_OPENMP
+  // The first large node opens the parallel region (unless the tree is being
+  // built inside one already); the tasks for all of its descendants are then
+  // run by the threads of that region.
+  if (parallel && omp_get_level() == 0 && omp_get_max_threads() > 1)
   {
-    // If the child has no points, don't create it.
-    if (childBegins[i + 1] - childBegins[i] == 0)
-      continue;
+    #pragma omp parallel
+    {
+      #pragma omp single
+      BuildChildren(childBegins, center, width, oldFromNew, maxLeafSize);
+    }
+    return;
+  }
+  #endif
+
+  // If a child has no points, don't create it.
+  std::vector<size_t> nonEmpty;
+  for (size_t i = 0; i < childBegins.n_elem - 1; ++i)
+    if (childBegins[i + 1] - childBegins[i] > 0)
+      nonEmpty.push_back(i);
+  children.resize(nonEmpty.size(), NULL);
 
-    // Create the correct center.
-    for (size_t d = 0; d < center.n_elem; ++d)
+  const double childWidth = width / 2.0;
+  for (size_t c = 0; c < nonEmpty.size(); ++c)
+  {
+    #pragma omp task if (parallel) default(shared) firstprivate(c)
     {
-      // Is the dimension "right" (1) or "left" (0)?
-      if (((i >> d) & 1) == 0)
-        childCenter[d] = center[d] - childWidth;
+      const size_t i = nonEmpty[c];
+
+      // Create the correct center.
+      arma::vec childCenter(center.n_elem);
+      for (size_t d = 0; d < center.n_elem; ++d)
+      {
+        // Is the dimension "right" (1) or "left" (0)?
+        if (((i >> d) & 1) == 0)
+          childCenter[d] = center[d] - childWidth;
+        else
+          childCenter[d] = center[d] + childWidth;
+      }
+
+      if (oldFromNew)
+        children[c] = new Octree(this, childBegins[i], childBegins[i + 1] -
+            childBegins[i], *oldFromNew, childCenter, childWidth, maxLeafSize);
       else
-        childCenter[d] = center[d] + childWidth;
+        children[c] = new Octree(this, childBegins[i], childBegins[i + 1] -
+            childBegins[i], childCenter, childWidth, maxLeafSize);
     }
-
-    children.push_back(new Octree(this, childBegins[i],
-        childBegins[i + 1] - childBegins[i], oldFromNew, childCenter,
-        childWidth, maxLeafSize));
   }
+
+  #pragma omp taskwait
 }
 
 } // namespace tree
@@ -13,6 +13,7 @@
 #define MLPACK_CORE_TREE_OCTREE_SINGLE_TREE_TRAVERSER_HPP
 
 #include <mlpack/prereqs.hpp>
+#include "../traversal_statistics.hpp"
 #include "octree.hpp"
 
 namespace mlpack {
@@ -42,11 +43,16 @@ class Octree<MetricType, StatisticType, MatType>::SingleTreeTraverser
   //! Modify the number of pruned nodes.
   size_t& NumPrunes() { return numPrunes; }
 
+  //! Get the timings and the maximum recursion depth of the traversals.
+  const TraversalStatistics& Statistics() const { return statistics; }
+
  private:
   //! The instantiated rule.
   RuleType& rule;
   //! The number of reference nodes that have been pruned.
   size_t numPrunes;
+  //! The timings and the recursion depth of the traversals.
+  TraversalStatistics statistics;
 };
 
 } // namespace tree
@@ -33,20 +33,28 @@ template<typename RuleType>
 void Octree<MetricType, StatisticType, MatType>::SingleTreeTraverser<RuleType>::
     Traverse(const size_t queryIndex, Octree& referenceNode)
 {
+  TraversalStatistics::Level level(statistics);
+
   // If we are a leaf, run the base cases.
   if (referenceNode.NumChildren() == 0)
   {
+    const TraversalStatistics::Clock::time_point start =
+        TraversalStatistics::Now();
     const size_t refBegin = referenceNode.Point(0);
     const size_t refEnd = refBegin + referenceNode.NumPoints();
     for (size_t r = refBegin; r < refEnd; ++r)
       rule.BaseCase(queryIndex, r);
+    statistics.AddBaseCaseTime(start);
   }
   else
   {
     // If it's the root node, just score it.
     if (referenceNode.Parent() == NULL)
     {
+      const TraversalStatistics::Clock::time_point start =
+          TraversalStatistics::Now();
       const double rootScore = rule.Score(queryIndex, referenceNode);
+      statistics.AddScoreTime(start);
       // If root score is DBL_MAX, don't recurse into that node.
       if (rootScore == DBL_MAX)
       {
@@ -57,9 +65,12 @@ void Octree<MetricType, StatisticType, MatType>::SingleTreeTraverser<RuleType>::
 
     // Do a prioritized recursion, by scoring all candidates and then sorting
     // them.
+    const TraversalStatistics::Clock::time_point start =
+        TraversalStatistics::Now();
     arma::vec scores(referenceNode.NumChildren());
     for (size_t i = 0; i < scores.n_elem; ++i)
       scores[i] = rule.Score(queryIndex, referenceNode.Child(i));
+    statistics.AddScoreTime(start);
 
     // Sort the scores.
     arma::uvec sortedIndices = arma::sort_index(scores);
@@ -0,0 +1,70 @@
+/**
+ * @file core/tree/parallel_dual_tree_traversal.hpp
+ *
+ * A generic driver that runs a dual-tree traversal on several threads, with
+ * one shard of splittable rules per thread.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_PARALLEL_DUAL_TREE_TRAVERSAL_HPP
+#define MLPACK_CORE_TREE_PARALLEL_DUAL_TREE_TRAVERSAL_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "rule_traits.hpp"
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * Split the query tree into a frontier of disjoint subtrees that cover all of
+ * its points, by repeatedly replacing the largest node of the frontier with
+ * its children, until the frontier holds at least the given number of subtrees
+ * (or only leaves are left).
+ *
+ * @param queryRoot Root of the query tree.
+ * @param subtrees Number of subtrees to split the tree into.
+ * @param frontier Set to the subtrees.
+ */
+template<typename TreeType>
+void SplitQueryTree(TreeType& queryRoot,
+                    const size_t subtrees,
+                    std::vector<TreeType*>& frontier);
+
+/**
+ * Run the dual-tree traversal of the given query and reference trees with the
+ * given rules on the given number of threads.  The query tree is split into
+ * disjoint subtrees with SplitQueryTree(); each thread traverses the subtrees
+ * it takes with its own shard of the rules (see RuleTraits), and the shards
+ * are then merged back into the rules, in order.  After the call, the rules
+ * hold the same results as after a single-threaded traversal.
+ *
+ * The traverser is given as a template, for instance:
+ *
+ * @code
+ * ParallelDualTreeTraversal<TreeType::template DualTreeTraverser>(queryTree,
+ *     referenceTree, rules, 4);
+ * @endcode
+ *
+ * @param queryRoot Root of the query tree.
+ * @param referenceRoot Root of the reference tree.
+ * @param rules Rules of the traversal; they must be splittable.
+ * @param threads Number of threads to use.
+ */
+template<template<typename> class TraverserType,
+         typename RuleType,
+         typename TreeType>
+void ParallelDualTreeTraversal(TreeType& queryRoot,
+                               TreeType& referenceRoot,
+                               RuleType& rules,
+                               const size_t threads);
+
+} // namespace tree
+} // namespace mlpack
+
+// Include implementation.
+#include "parallel_dual_tree_traversal_impl.hpp"
+
+#endif
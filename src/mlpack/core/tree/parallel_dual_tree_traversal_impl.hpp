@@ -0,0 +1,105 @@
+/**
+ * @file core/tree/parallel_dual_tree_traversal_impl.hpp
+ *
+ * Implementation of the generic parallel dual-tree traversal.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_PARALLEL_DUAL_TREE_TRAVERSAL_IMPL_HPP
+#define MLPACK_CORE_TREE_PARALLEL_DUAL_TREE_TRAVERSAL_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "parallel_dual_tree_traversal.hpp"
+
+namespace mlpack {
+namespace tree {
+
+template<typename TreeType>
+void SplitQueryTree(TreeType& queryRoot,
+                    const size_t subtrees,
+                    std::vector<TreeType*>& frontier)
+{
+  frontier.assign(1, &queryRoot);
+  while (frontier.size() < subtrees)
+  {
+    size_t largest = frontier.size();
+    for (size_t i = 0; i < frontier.size(); ++i)
+    {
+      if (frontier[i]->NumChildren() == 0)
+        continue;
+
+      if (largest == frontier.size() || frontier[i]->NumDescendants() >
+          frontier[largest]->NumDescendants())
+        largest = i;
+    }
+
+    if (largest == frontier.size())
+      break; // Only leaves are left; we can't split any further.
+
+    TreeType* node = frontier[largest];
+    frontier[largest] = &node->Child(0);
+    for (size_t i = 1; i < node->NumChildren(); ++i)
+      frontier.push_back(&node->Child(i));
+  }
+}
+
+template<template<typename> class TraverserType,
+         typename RuleType,
+         typename TreeType>
+void ParallelDualTreeTraversal(TreeType& queryRoot,
+                               TreeType& referenceRoot,
+                               RuleType& rules,
+                               const size_t threads)
+{
+  static_assert(RuleTraits<RuleType>::IsSplittable, "ParallelDualTreeTraversal"
+      "(): the rules must be splittable (see RuleTraits).");
+
+  // Using a few more subtrees than threads helps to balance the load.
+  std::vector<TreeType*> frontier;
+  if (threads > 1)
+    SplitQueryTree(queryRoot, 4 * threads, frontier);
+
+  if (frontier.size() <= 1)
+  {
+    // There is nothing to split, so just run the traversal on one thread.
+    TraverserType<RuleType> traverser(rules);
+    traverser.Traverse(queryRoot, referenceRoot);
+    return;
+  }
+
+  std::vector<RuleType> shards;
+  shards.reserve(threads);
+  for (size_t i = 0; i < threads; ++i)
+    shards.push_back(rules.Split());
+
+  #pragma omp parallel num_threads(threads)
+  {
+    #ifdef HAS_OPENMP
+    RuleType& shard = shards[omp_get_thread_num()];
+    #else
+    RuleType& shard = shards[0];
+    #endif
+    TraverserType<RuleType> traverser(shard);
+
+    #pragma omp for schedule(dynamic)
+    for (omp_size_t i = 0; i < (omp_size_t) frontier.size(); ++i)
+    {
+      // The traverser expects the combination it is given to already have
+      // been scored (unless both nodes are roots).
+      if (shard.Score(*frontier[i], referenceRoot) != DBL_MAX)
+        traverser.Traverse(*frontier[i], referenceRoot);
+    }
+  }
+
+  // Merging in order keeps the results deterministic.
+  for (size_t i = 0; i < threads; ++i)
+    rules.Merge(shards[i]);
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,155 @@
+/**
+ * @file core/tree/rectangle_tree/bulk_load_ordering.hpp
+ *
+ * Definition of the BulkLoadOrdering class, which orders points (or nodes) so
+ * that a RectangleTree can be packed bottom-up.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_RECTANGLE_TREE_BULK_LOAD_ORDERING_HPP
+#define MLPACK_CORE_TREE_RECTANGLE_TREE_BULK_LOAD_ORDERING_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace tree /** Trees and tree-building procedures. */ {
+
+/**
+ * Pass a BulkLoadTag to a RectangleTree constructor to pack the tree bottom-up
+ * instead of inserting the points one at a time.
+ */
+struct BulkLoadTag { };
+
+// Forward declaration, for the ordering of Hilbert R trees.
+template<typename TreeType,
+         template<typename> class HilbertValueType>
+class HilbertRTreeAuxiliaryInformation;
+
+/**
+ * The BulkLoadOrdering class orders the items of one level of a bulk-loaded
+ * RectangleTree (the points of the dataset, or the nodes of the level below)
+ * so that each run of consecutive items forms one node.  The items are
+ * split into numGroups runs; run i is [GroupBegin(i), GroupBegin(i + 1)).
+ *
+ * Hilbert R trees are ordered by the Hilbert values of the items, and every
+ * other tree is ordered with the Sort-Tile-Recursive (STR) algorithm:
+ *
+ * @code
+ * @inproceedings{leutenegger1997str,
+ *   title={STR: A simple and efficient algorithm for R-tree packing},
+ *   author={Leutenegger, Scott T. and Lopez, Mario A. and Edgington, Jeffrey},
+ *   booktitle={Proceedings of the 13th International Conference on Data
+ *       Engineering},
+ *   pages={497--506},
+ *   year={1997}
+ * }
+ * @endcode
+ */
+class BulkLoadOrdering
+{
+ public:
+  /**
+   * Order the points of the dataset with STR: the points are sorted along the
+   * first dimension and cut into about numGroups^(1 / d) slabs of whole runs,
+   * each slab is tiled along the second dimension in the same way, and so on.
+   *
+   * @param auxiliaryInfo The auxiliary information of the tree (only used to
+   *     select the ordering).
+   * @param dataset The points to order.
+   * @param numGroups The number of runs.
+   * @param order The ordering of the points (of size dataset.n_cols).
+   */
+  template<typename AuxiliaryInformationType, typename MatType>
+  static void OrderPoints(const AuxiliaryInformationType& auxiliaryInfo,
+                          const MatType& dataset,
+                          const size_t numGroups,
+                          std::vector<size_t>& order);
+
+  /**
+   * Order the points of the dataset of a Hilbert R tree by their Hilbert
+   * values.
+   *
+   * @param auxiliaryInfo The auxiliary information of the tree (only used to
+   *     select the ordering).
+   * @param dataset The points to order.
+   * @param numGroups The number of runs (not used).
+   * @param order The ordering of the points (of size dataset.n_cols).
+   */
+  template<typename TreeType,
+           template<typename> class HilbertValueType,
+           typename MatType>
+  static void OrderPoints(
+      const HilbertRTreeAuxiliaryInformation<TreeType, HilbertValueType>&
+          auxiliaryInfo,
+      const MatType& dataset,
+      const size_t numGroups,
+      std::vector<size_t>& order);
+
+  /**
+   * Order the nodes of a level with STR, by the centers of their bounds.
+   *
+   * @param auxiliaryInfo The auxiliary information of the tree (only used to
+   *     select the ordering).
+   * @param centers The centers of the nodes, one per column.
+   * @param numGroups The number of runs.
+   * @param order The ordering of the nodes (of size centers.n_cols).
+   */
+  template<typename AuxiliaryInformationType, typename ElemType>
+  static void OrderNodes(const AuxiliaryInformationType& auxiliaryInfo,
+                         const arma::Mat<ElemType>& centers,
+                         const size_t numGroups,
+                         std::vector<size_t>& order);
+
+  /**
+   * Order the nodes of a level of a Hilbert R tree.  Since the points were
+   * ordered by their Hilbert values, the nodes already are, and are kept in
+   * the same order.
+   *
+   * @param auxiliaryInfo The auxiliary information of the tree (only used to
+   *     select the ordering).
+   * @param centers The centers of the nodes, one per column.
+   * @param numGroups The number of runs (not used).
+   * @param order The ordering of the nodes (of size centers.n_cols).
+   */
+  template<typename TreeType,
+           template<typename> class HilbertValueType,
+           typename ElemType>
+  static void OrderNodes(
+      const HilbertRTreeAuxiliaryInformation<TreeType, HilbertValueType>&
+          auxiliaryInfo,
+      const arma::Mat<ElemType>& centers,
+      const size_t numGroups,
+      std::vector<size_t>& order);
+
+  //! Return the index of the first item of the given run.
+  static size_t GroupBegin(const size_t group,
+                           const size_t numItems,
+                           const size_t numGroups)
+  {
+    return (numItems * group) / numGroups;
+  }
+
+ private:
+  /**
+   * Tile the runs [firstGroup, lastGroup) of the ordering along the given
+   * dimension and the following ones.
+   */
+  template<typename MatType>
+  static void Tile(const MatType& centers,
+                   const size_t numGroups,
+                   const size_t firstGroup,
+                   const size_t lastGroup,
+                   const size_t dim,
+                   std::vector<size_t>& order);
+};
+
+} // namespace tree
+} // namespace mlpack
+
+// Include implementation.
+#include "bulk_load_ordering_impl.hpp"
+
+#endif
@@ -0,0 +1,134 @@
+/**
+ * @file core/tree/rectangle_tree/bulk_load_ordering_impl.hpp
+ *
+ * Implementation of the BulkLoadOrdering class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_RECTANGLE_TREE_BULK_LOAD_ORDERING_IMPL_HPP
+#define MLPACK_CORE_TREE_RECTANGLE_TREE_BULK_LOAD_ORDERING_IMPL_HPP
+
+#include "bulk_load_ordering.hpp"
+
+namespace mlpack {
+namespace tree {
+
+template<typename AuxiliaryInformationType, typename MatType>
+void BulkLoadOrdering::OrderPoints(
+    const AuxiliaryInformationType& /* auxiliaryInfo */,
+    const MatType& dataset,
+    const size_t numGroups,
+    std::vector<size_t>& order)
+{
+  order.resize(dataset.n_cols);
+  for (size_t i = 0; i < order.size(); ++i)
+    order[i] = i;
+
+  Tile(dataset, numGroups, 0, numGroups, 0, order);
+}
+
+template<typename TreeType,
+         template<typename> class HilbertValueType,
+         typename MatType>
+void BulkLoadOrdering::OrderPoints(
+    const HilbertRTreeAuxiliaryInformation<TreeType, HilbertValueType>&
+        /* auxiliaryInfo */,
+    const MatType& dataset,
+    const size_t /* numGroups */,
+    std::vector<size_t>& order)
+{
+  typedef HilbertValueType<typename TreeType::ElemType> HilbertValue;
+  typedef typename HilbertValue::HilbertElemType HilbertElemType;
+
+  // Calculate each value once, instead of at each comparison.
+  std::vector<arma::Col<HilbertElemType>> values(dataset.n_cols);
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+    values[i] = HilbertValue::CalculateValue(dataset.col(i));
+
+  order.resize(dataset.n_cols);
+  for (size_t i = 0; i < order.size(); ++i)
+    order[i] = i;
+
+  std::sort(order.begin(), order.end(),
+      [&values](const size_t a, const size_t b)
+      {
+        const int comparison = HilbertValue::CompareValues(values[a],
+            values[b]);
+        return (comparison < 0) || (comparison == 0 && a < b);
+      });
+}
+
+template<typename AuxiliaryInformationType, typename ElemType>
+void BulkLoadOrdering::OrderNodes(
+    const AuxiliaryInformationType& /* auxiliaryInfo */,
+    const arma::Mat<ElemType>& centers,
+    const size_t numGroups,
+    std::vector<size_t>& order)
+{
+  order.resize(centers.n_cols);
+  for (size_t i = 0; i < order.size(); ++i)
+    order[i] = i;
+
+  Tile(centers, numGroups, 0, numGroups, 0, order);
+}
+
+template<typename TreeType,
+         template<typename> class HilbertValueType,
+         typename ElemType>
+void BulkLoadOrdering::OrderNodes(
+    const HilbertRTreeAuxiliaryInformation<TreeType, HilbertValueType>&
+        /* auxiliaryInfo */,
+    const arma::Mat<ElemType>& centers,
+    const size_t /* numGroups */,
+    std::vector<size_t>& order)
+{
+  order.resize(centers.n_cols);
+  for (size_t i = 0; i < order.size(); ++i)
+    order[i] = i;
+}
+
+template<typename MatType>
+void BulkLoadOrdering::Tile(const MatType& centers,
+                            const size_t numGroups,
+                            const size_t firstGroup,
+                            const size_t lastGroup,
+                            const size_t dim,
+                            std::vector<size_t>& order)
+{
+  const size_t begin = GroupBegin(firstGroup, order.size(), numGroups);
+  const size_t end = GroupBegin(lastGroup, order.size(), numGroups);
+
+  // Ties are broken by index, so that the ordering is deterministic.
+  std::sort(order.begin() + begin, order.begin() + end,
+      [&centers, dim](const size_t a, const size_t b)
+      {
+        return (centers(dim, a) < centers(dim, b)) ||
+            (centers(dim, a) == centers(dim, b) && a < b);
+      });
+
+  // On the last dimension, the sorted items are cut directly into runs.
+  const size_t groups = lastGroup - firstGroup;
+  if (groups <= 1 || dim + 1 >= centers.n_rows)
+    return;
+
+  // Split the runs evenly into slabs, so that each of the remaining dimensions
+  // is cut into about the same number of slabs.
+  const size_t remainingDims = centers.n_rows - dim;
+  const size_t slabs = std::min(groups, (size_t) std::ceil(
+      std::pow((double) groups, 1.0 / remainingDims) - 1e-9));
+  for (size_t s = 0; s < slabs; ++s)
+  {
+    const size_t first = firstGroup + (groups * s) / slabs;
+    const size_t last = firstGroup + (groups * (s + 1)) / slabs;
+    if (last > first)
+      Tile(centers, numGroups, first, last, dim + 1, order);
+  }
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
@@ -197,6 +197,17 @@ class DiscreteHilbertValue
   template<typename TreeType>
   void UpdateLargestValue(TreeType* node);
 
+  /**
+   * Calculate the local Hilbert values of a leaf of a bulk-loaded tree, or
+   * update the largest Hilbert value of an intermediate node.  The points (or
+   * children) of the node should be arranged according to their Hilbert
+   * values, and the children should already be set up.
+   *
+   * @param node The node that has been bulk loaded.
+   */
+  template<typename TreeType>
+  void BulkLoad(TreeType* node);
+
   /**
    * This method updates the largest Hilbert value of a leaf node and
    * redistributes the Hilbert values of points according to their new position
@@ -50,10 +50,11 @@ DiscreteHilbertValue<TreeElemType>::DiscreteHilbertValue(const TreeType* tree) :
   // Calculate the Hilbert value for all points.
   if (!tree->Parent()) // This is the root node.
     ownsLocalHilbertValues = true;
-  else if (tree->Parent()->Child(0).IsLeaf())
+  else if (tree->Parent()->NumChildren() == 0 ||
+           tree->Parent()->Child(0).IsLeaf())
   {
-    // This is a leaf node.
-    assert(tree->Parent()->NumChildren() > 0);
+    // This is a leaf node.  (A node whose parent has no children yet, as during
+    // bulk loading, is a new leaf too.)
     ownsLocalHilbertValues = true;
   }
 
@@ -470,6 +471,31 @@ void DiscreteHilbertValue<TreeElemType>::UpdateLargestValue(TreeType* node)
   }
 }
 
+template<typename TreeElemType>
+template<typename TreeType>
+void DiscreteHilbertValue<TreeElemType>::BulkLoad(TreeType* node)
+{
+  if (node->IsLeaf())
+  {
+    for (size_t i = 0; i < node->NumPoints(); ++i)
+    {
+      localHilbertValues->col(i) =
+          CalculateValue(node->Dataset().col(node->Point(i)));
+    }
+    numValues = node->NumPoints();
+  }
+  else
+  {
+    // Only leaves own their Hilbert values; the nodes of a bulk-loaded tree
+    // are all created as leaves.
+    if (ownsLocalHilbertValues)
+      delete localHilbertValues;
+    ownsLocalHilbertValues = false;
+
+    UpdateLargestValue(node);
+  }
+}
+
 template<typename TreeElemType>
 template<typename TreeType>
 void DiscreteHilbertValue<TreeElemType>::RedistributeHilbertValues(
@@ -16,6 +16,7 @@
 
 #include <mlpack/prereqs.hpp>
 
+#include "../traversal_statistics.hpp"
 #include "rectangle_tree.hpp"
 
 namespace mlpack {
@@ -65,6 +66,9 @@ class RectangleTree<MetricType, StatisticType, MatType, SplitType,
   //! Modify the number of times a base case was calculated.
   size_t& NumBaseCases() { return numBaseCases; }
 
+  //! Get the timings and the maximum recursion depth of the traversals.
+  const TraversalStatistics& Statistics() const { return statistics; }
+
  private:
   // We use this struct and this function to make the sorting and scoring easy
   // and efficient:
@@ -96,6 +100,9 @@ class RectangleTree<MetricType, StatisticType, MatType, SplitType,
   //! The number of times a base case was calculated.
   size_t numBaseCases;
 
+  //! The timings and the recursion depth of the traversals.
+  TraversalStatistics statistics;
+
   //! Traversal information, held in the class so that it isn't continually
   //! being reallocated.
   typename RuleType::TraversalInfoType traversalInfo;
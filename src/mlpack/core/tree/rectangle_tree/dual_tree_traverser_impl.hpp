@@ -51,6 +51,8 @@ void RectangleTree<MetricType, StatisticType, MatType, SplitType, DescentType,
 DualTreeTraverser<RuleType>::Traverse(RectangleTree& queryNode,
                                       RectangleTree& referenceNode)
 {
+  TraversalStatistics::Level level(statistics);
+
   // Increment the visit counter.
   ++numVisited;
 
@@ -67,7 +69,10 @@ DualTreeTraverser<RuleType>::Traverse(RectangleTree& queryNode,
   if (queryNode.IsLeaf() && referenceNode.IsLeaf())
   {
     // Evaluate the base case.  Do the query points on the outside so we can
-    // possibly prune the reference node for that particular point.
+    // possibly prune the reference node for that particular point.  The scores
+    // of the query points are counted as base case time.
+    const TraversalStatistics::Clock::time_point start =
+        TraversalStatistics::Now();
     for (size_t query = 0; query < queryNode.Count(); ++query)
     {
       // Restore the traversal information.
@@ -83,6 +88,7 @@ DualTreeTraverser<RuleType>::Traverse(RectangleTree& queryNode,
 
       numBaseCases += referenceNode.Count();
     }
+    statistics.AddBaseCaseTime(start);
   }
   else if (!queryNode.IsLeaf() && referenceNode.IsLeaf())
   {
@@ -92,7 +98,11 @@ DualTreeTraverser<RuleType>::Traverse(RectangleTree& queryNode,
       // Before recursing, we have to set the traversal information correctly.
       rule.TraversalInfo() = traversalInfo;
       ++numScores;
-      if (rule.Score(queryNode.Child(i), referenceNode) < DBL_MAX)
+      const TraversalStatistics::Clock::time_point start =
+          TraversalStatistics::Now();
+      const double score = rule.Score(queryNode.Child(i), referenceNode);
+      statistics.AddScoreTime(start);
+      if (score < DBL_MAX)
         Traverse(queryNode.Child(i), referenceNode);
       else
         numPrunes++;
@@ -105,6 +115,8 @@ DualTreeTraverser<RuleType>::Traverse(RectangleTree& queryNode,
 
     // We sort the children of the reference node by their scores.
     std::vector<NodeAndScore> nodesAndScores(referenceNode.NumChildren());
+    const TraversalStatistics::Clock::time_point start =
+        TraversalStatistics::Now();
     for (size_t i = 0; i < referenceNode.NumChildren(); ++i)
     {
       rule.TraversalInfo() = traversalInfo;
@@ -113,6 +125,7 @@ DualTreeTraverser<RuleType>::Traverse(RectangleTree& queryNode,
           *(nodesAndScores[i].node));
       nodesAndScores[i].travInfo = rule.TraversalInfo();
     }
+    statistics.AddScoreTime(start);
     std::sort(nodesAndScores.begin(), nodesAndScores.end(), nodeComparator);
     numScores += nodesAndScores.size();
 
@@ -140,6 +153,8 @@ DualTreeTraverser<RuleType>::Traverse(RectangleTree& queryNode,
     {
       // We sort the children of the reference node by their scores.
       std::vector<NodeAndScore> nodesAndScores(referenceNode.NumChildren());
+      const TraversalStatistics::Clock::time_point start =
+          TraversalStatistics::Now();
       for (size_t i = 0; i < referenceNode.NumChildren(); ++i)
       {
         rule.TraversalInfo() = traversalInfo;
@@ -148,6 +163,7 @@ DualTreeTraverser<RuleType>::Traverse(RectangleTree& queryNode,
             *nodesAndScores[i].node);
         nodesAndScores[i].travInfo = rule.TraversalInfo();
       }
+      statistics.AddScoreTime(start);
       std::sort(nodesAndScores.begin(), nodesAndScores.end(), nodeComparator);
       numScores += nodesAndScores.size();
 
@@ -117,6 +117,15 @@ class HilbertRTreeAuxiliaryInformation
    */
   bool UpdateAuxiliaryInfo(TreeType* node);
 
+  /**
+   * Calculate the Hilbert values of a node of a bulk-loaded tree, whose points
+   * (or children) are arranged according to their Hilbert values.  This should
+   * be called on the children of the node first.
+   *
+   * @param node The node that has been bulk loaded.
+   */
+  void HandleBulkLoad(TreeType* node);
+
   //! Clear memory.
   void NullifyData();
 
@@ -167,6 +167,14 @@ UpdateAuxiliaryInfo(TreeType* node)
   return false;
 }
 
+template<typename TreeType,
+         template<typename> class HilbertValueType>
+void HilbertRTreeAuxiliaryInformation<TreeType, HilbertValueType>::
+HandleBulkLoad(TreeType* node)
+{
+  hilbertValue.BulkLoad(node);
+}
+
 template<typename TreeType,
          template<typename> class HilbertValueType>
 void HilbertRTreeAuxiliaryInformation<TreeType, HilbertValueType>::
@@ -123,6 +123,15 @@ class RPlusPlusTreeAuxiliaryInformation
    */
   bool UpdateAuxiliaryInfo(TreeType* /* node */);
 
+  /**
+   * Some tree types require to set up some properties of the nodes of a
+   * bulk-loaded tree.  This is called on each node once its points or children
+   * are set, from the leaves up to the root.
+   *
+   * @param * (node) The node that has been bulk loaded.
+   */
+  void HandleBulkLoad(TreeType* /* node */);
+
   /**
    * The R++ tree requires to split the maximum bounding rectangle of a node
    * that is being split. This method is intended for that.
@@ -96,6 +96,11 @@ bool RPlusPlusTreeAuxiliaryInformation<TreeType>::UpdateAuxiliaryInfo(
   return false;
 }
 
+template<typename TreeType>
+void RPlusPlusTreeAuxiliaryInformation<TreeType>::HandleBulkLoad(
+    TreeType* /* node */)
+{ /* Nothing to do */ }
+
 template<typename TreeType>
 void RPlusPlusTreeAuxiliaryInformation<TreeType>::SplitAuxiliaryInfo(
     TreeType* treeOne,
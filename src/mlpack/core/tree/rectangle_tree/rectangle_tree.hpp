@@ -20,6 +20,7 @@
 #include "r_tree_split.hpp"
 #include "r_tree_descent_heuristic.hpp"
 #include "no_auxiliary_information.hpp"
+#include "bulk_load_ordering.hpp"
 
 namespace mlpack {
 namespace tree /** Trees and tree-building procedures. */ {
@@ -156,6 +157,55 @@ class RectangleTree
                 const size_t minNumChildren = 2,
                 const size_t firstDataIndex = 0);
 
+  /**
+   * Construct this as the root node of a rectangle type tree using the given
+   * dataset, packing the tree bottom-up instead of inserting the points one at
+   * a time.  The points are grouped into leaves of about maxLeafSize points,
+   * and the nodes of each level into parents of about maxNumChildren nodes,
+   * using the ordering of BulkLoadOrdering (the Hilbert values of the points
+   * for Hilbert R trees, and Sort-Tile-Recursive otherwise).  Every leaf is at
+   * the same depth, and every node is at least half full.  This is much faster
+   * than the other constructors, and the nodes overlap less; points can still
+   * be inserted and deleted afterwards.
+   *
+   * Trees whose children may not overlap (R+ and R++ trees) can't be bulk
+   * loaded.
+   *
+   * @param data Dataset from which to create the tree.
+   * @param maxLeafSize Maximum size of each leaf in the tree.
+   * @param minLeafSize Minimum size of each leaf in the tree.
+   * @param maxNumChildren The maximum number of child nodes a non-leaf node may
+   *      have.
+   * @param minNumChildren The minimum number of child nodes a non-leaf node may
+   *      have.
+   */
+  RectangleTree(const MatType& data,
+                const BulkLoadTag& /* tag */,
+                const size_t maxLeafSize = 20,
+                const size_t minLeafSize = 8,
+                const size_t maxNumChildren = 5,
+                const size_t minNumChildren = 2);
+
+  /**
+   * Construct this as the root node of a rectangle type tree using the given
+   * dataset, taking ownership of the given dataset, and packing the tree
+   * bottom-up as in the constructor above.
+   *
+   * @param data Dataset from which to create the tree.
+   * @param maxLeafSize Maximum size of each leaf in the tree.
+   * @param minLeafSize Minimum size of each leaf in the tree.
+   * @param maxNumChildren The maximum number of child nodes a non-leaf node may
+   *      have.
+   * @param minNumChildren The minimum number of child nodes a non-leaf node may
+   *      have.
+   */
+  RectangleTree(MatType&& data,
+                const BulkLoadTag& /* tag */,
+                const size_t maxLeafSize = 20,
+                const size_t minLeafSize = 8,
+                const size_t maxNumChildren = 5,
+                const size_t minNumChildren = 2);
+
   /**
    * Construct this as an empty node with the specified parent.  Copying the
    * parameters (maxLeafSize, minLeafSize, maxNumChildren, minNumChildren,
@@ -564,6 +614,21 @@ class RectangleTree
    */
   void BuildStatistics(RectangleTree* node);
 
+  /**
+   * Pack all the points of the dataset into this (empty) root node, bottom-up.
+   */
+  void BulkLoad();
+
+  /**
+   * Add the given point to this leaf during bulk loading.
+   */
+  void BulkLoadPoint(const size_t point);
+
+  /**
+   * Add the given node as a child of this node during bulk loading.
+   */
+  void BulkLoadNode(RectangleTree* node);
+
  protected:
   /**
    * A default constructor.  This is meant to only be used with
@@ -15,6 +15,7 @@
 // In case it wasn't included already for some reason.
 #include "rectangle_tree.hpp"
 
+#include <mlpack/core/tree/tree_traits.hpp>
 #include <mlpack/core/util/log.hpp>
 
 namespace mlpack {
@@ -39,6 +40,116 @@ BuildStatistics(RectangleTree* node)
   node->Stat() = StatisticType(*node);
 }
 
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         typename SplitType,
+         typename DescentType,
+         template<typename> class AuxiliaryInformationType>
+void RectangleTree<MetricType, StatisticType, MatType, SplitType, DescentType,
+              AuxiliaryInformationType>::BulkLoad()
+{
+  // Packing the nodes may make siblings overlap.
+  static_assert(TreeTraits<RectangleTree>::HasOverlappingChildren,
+      "RectangleTree: trees without overlapping children can't be bulk "
+      "loaded.");
+
+  const size_t numPoints = dataset->n_cols;
+  std::vector<size_t> order;
+  if (numPoints <= maxLeafSize)
+  {
+    // The root is the only leaf.
+    BulkLoadOrdering::OrderPoints(auxiliaryInfo, *dataset, 1, order);
+    for (size_t i = 0; i < numPoints; ++i)
+      BulkLoadPoint(order[i]);
+    auxiliaryInfo.HandleBulkLoad(this);
+    return;
+  }
+
+  // Pack the points into leaves.  The new nodes are children of the root until
+  // their parent is known.
+  size_t numGroups = (numPoints + maxLeafSize - 1) / maxLeafSize;
+  BulkLoadOrdering::OrderPoints(auxiliaryInfo, *dataset, numGroups, order);
+
+  std::vector<RectangleTree*> level(numGroups);
+  for (size_t i = 0; i < numGroups; ++i)
+  {
+    level[i] = new RectangleTree(this);
+    const size_t end = BulkLoadOrdering::GroupBegin(i + 1, numPoints,
+        numGroups);
+    for (size_t j = BulkLoadOrdering::GroupBegin(i, numPoints, numGroups);
+         j < end; ++j)
+      level[i]->BulkLoadPoint(order[j]);
+    level[i]->AuxiliaryInfo().HandleBulkLoad(level[i]);
+  }
+
+  // Pack each level into its parents until the nodes fit in the root.
+  while (level.size() > maxNumChildren)
+  {
+    arma::Mat<ElemType> centers(dataset->n_rows, level.size());
+    for (size_t i = 0; i < level.size(); ++i)
+    {
+      arma::Col<ElemType> center(centers.colptr(i), dataset->n_rows, false,
+          true);
+      level[i]->bound.Center(center);
+    }
+
+    numGroups = (level.size() + maxNumChildren - 1) / maxNumChildren;
+    BulkLoadOrdering::OrderNodes(auxiliaryInfo, centers, numGroups, order);
+
+    std::vector<RectangleTree*> parents(numGroups);
+    for (size_t i = 0; i < numGroups; ++i)
+    {
+      parents[i] = new RectangleTree(this);
+      const size_t end = BulkLoadOrdering::GroupBegin(i + 1, level.size(),
+          numGroups);
+      for (size_t j = BulkLoadOrdering::GroupBegin(i, level.size(), numGroups);
+           j < end; ++j)
+        parents[i]->BulkLoadNode(level[order[j]]);
+      parents[i]->AuxiliaryInfo().HandleBulkLoad(parents[i]);
+    }
+
+    level.swap(parents);
+  }
+
+  for (size_t i = 0; i < level.size(); ++i)
+    BulkLoadNode(level[i]);
+  auxiliaryInfo.HandleBulkLoad(this);
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         typename SplitType,
+         typename DescentType,
+         template<typename> class AuxiliaryInformationType>
+void RectangleTree<MetricType, StatisticType, MatType, SplitType, DescentType,
+              AuxiliaryInformationType>::BulkLoadPoint(const size_t point)
+{
+  // The auxiliary information is set up by HandleBulkLoad() once the leaf is
+  // full.
+  bound |= dataset->col(point);
+  numDescendants++;
+  points[count++] = point;
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         typename SplitType,
+         typename DescentType,
+         template<typename> class AuxiliaryInformationType>
+void RectangleTree<MetricType, StatisticType, MatType, SplitType, DescentType,
+              AuxiliaryInformationType>::BulkLoadNode(RectangleTree* node)
+{
+  // The auxiliary information is set up by HandleBulkLoad() once the node is
+  // full.
+  bound |= node->bound;
+  numDescendants += node->numDescendants;
+  children[numChildren++] = node;
+  node->Parent() = this;
+}
+
 template<typename MetricType,
          typename StatisticType,
          typename MatType,
@@ -121,6 +232,80 @@ RectangleTree(MatType&& data,
   BuildStatistics(this);
 }
 
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         typename SplitType,
+         typename DescentType,
+         template<typename> class AuxiliaryInformationType>
+RectangleTree<MetricType, StatisticType, MatType, SplitType, DescentType,
+              AuxiliaryInformationType>::
+RectangleTree(const MatType& data,
+              const BulkLoadTag& /* tag */,
+              const size_t maxLeafSize,
+              const size_t minLeafSize,
+              const size_t maxNumChildren,
+              const size_t minNumChildren) :
+    maxNumChildren(maxNumChildren),
+    minNumChildren(minNumChildren),
+    numChildren(0),
+    children(maxNumChildren + 1), // Add one to make splitting the node simpler.
+    parent(NULL),
+    begin(0),
+    count(0),
+    numDescendants(0),
+    maxLeafSize(maxLeafSize),
+    minLeafSize(minLeafSize),
+    bound(data.n_rows),
+    parentDistance(0),
+    dataset(new MatType(data)),
+    ownsDataset(true),
+    points(maxLeafSize + 1), // Add one to make splitting the node simpler.
+    auxiliaryInfo(this)
+{
+  BulkLoad();
+
+  // Initialize statistic recursively after tree construction is complete.
+  BuildStatistics(this);
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         typename SplitType,
+         typename DescentType,
+         template<typename> class AuxiliaryInformationType>
+RectangleTree<MetricType, StatisticType, MatType, SplitType, DescentType,
+              AuxiliaryInformationType>::
+RectangleTree(MatType&& data,
+              const BulkLoadTag& /* tag */,
+              const size_t maxLeafSize,
+              const size_t minLeafSize,
+              const size_t maxNumChildren,
+              const size_t minNumChildren) :
+    maxNumChildren(maxNumChildren),
+    minNumChildren(minNumChildren),
+    numChildren(0),
+    children(maxNumChildren + 1), // Add one to make splitting the node simpler.
+    parent(NULL),
+    begin(0),
+    count(0),
+    numDescendants(0),
+    maxLeafSize(maxLeafSize),
+    minLeafSize(minLeafSize),
+    bound(data.n_rows),
+    parentDistance(0),
+    dataset(new MatType(std::move(data))),
+    ownsDataset(true),
+    points(maxLeafSize + 1), // Add one to make splitting the node simpler.
+    auxiliaryInfo(this)
+{
+  BulkLoad();
+
+  // Initialize statistic recursively after tree construction is complete.
+  BuildStatistics(this);
+}
+
 template<typename MetricType,
          typename StatisticType,
          typename MatType,
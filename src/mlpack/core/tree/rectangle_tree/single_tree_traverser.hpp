@@ -16,6 +16,7 @@
 
 #include <mlpack/prereqs.hpp>
 
+#include "../traversal_statistics.hpp"
 #include "rectangle_tree.hpp"
 
 namespace mlpack {
@@ -51,6 +52,9 @@ class RectangleTree<MetricType, StatisticType, MatType, SplitType,
   //! Modify the number of prunes.
   size_t& NumPrunes() { return numPrunes; }
 
+  //! Get the timings and the maximum recursion depth of the traversals.
+  const TraversalStatistics& Statistics() const { return statistics; }
+
  private:
   // We use this class and this function to make the sorting and scoring easy
   // and efficient:
@@ -70,6 +74,9 @@ class RectangleTree<MetricType, StatisticType, MatType, SplitType,
 
   //! The number of nodes which have been prenud during traversal.
   size_t numPrunes;
+
+  //! The timings and the recursion depth of the traversals.
+  TraversalStatistics statistics;
 };
 
 } // namespace tree
@@ -49,11 +49,16 @@ SingleTreeTraverser<RuleType>::Traverse(
     const size_t queryIndex,
     const RectangleTree& referenceNode)
 {
+  TraversalStatistics::Level level(statistics);
+
   // If we reach a leaf node, we need to run the base case.
   if (referenceNode.IsLeaf())
   {
+    const TraversalStatistics::Clock::time_point start =
+        TraversalStatistics::Now();
     for (size_t i = 0; i < referenceNode.Count(); ++i)
       rule.BaseCase(queryIndex, referenceNode.Point(i));
+    statistics.AddBaseCaseTime(start);
 
     return;
   }
@@ -61,11 +66,14 @@ SingleTreeTraverser<RuleType>::Traverse(
   // This is not a leaf node so we sort the children of this node by their
   // scores.
   std::vector<NodeAndScore> nodesAndScores(referenceNode.NumChildren());
+  const TraversalStatistics::Clock::time_point start =
+      TraversalStatistics::Now();
   for (size_t i = 0; i < referenceNode.NumChildren(); ++i)
   {
     nodesAndScores[i].node = &(referenceNode.Child(i));
     nodesAndScores[i].score = rule.Score(queryIndex, *nodesAndScores[i].node);
   }
+  statistics.AddScoreTime(start);
 
   std::sort(nodesAndScores.begin(), nodesAndScores.end(), NodeComparator);
 
@@ -156,6 +156,15 @@ class XTreeAuxiliaryInformation
     return false;
   }
 
+  /**
+   * Some tree types require to set up some properties of the nodes of a
+   * bulk-loaded tree.  This is called on each node once its points or children
+   * are set, from the leaves up to the root.
+   * @param * (node) The node that has been bulk loaded.
+   */
+  void HandleBulkLoad(TreeType* /* node */)
+  { }
+
   /**
    * Nullify the auxiliary information in order to prevent an invalid free.
    */
@@ -0,0 +1,59 @@
+/**
+ * @file core/tree/rule_traits.hpp
+ *
+ * This file implements the basic, unspecialized RuleTraits class, which
+ * provides information about the rules of dual-tree algorithms.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_RULE_TRAITS_HPP
+#define MLPACK_CORE_TREE_RULE_TRAITS_HPP
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * The RuleTraits class provides compile-time information on the
+ * characteristics of a given rules class, the same way TreeTraits does for
+ * trees.  If you create a rules class that can be used by several threads at
+ * once, you should specialize this class.
+ *
+ * A rules class is splittable when IsSplittable is true.  It must then provide
+ * the two following methods:
+ *
+ * @code
+ * // Return a new rules object for the same problem without any results, to
+ * // be used by one thread.
+ * RuleType Split() const;
+ *
+ * // Add the results and the counters of the given rules object (returned by
+ * // Split()) to this one.
+ * void Merge(const RuleType& shard);
+ * @endcode
+ *
+ * Each shard is only used on query subtrees that no other shard visits, so
+ * the results of a query point are all in one shard, and the statistics of a
+ * query node are only modified by one thread.  The reference tree, the
+ * datasets and the metric are shared, and must only be read.
+ *
+ * ParallelDualTreeTraversal() uses this to run any dual-tree algorithm with
+ * splittable rules on several threads.
+ */
+template<typename RuleType>
+class RuleTraits
+{
+ public:
+  /**
+   * If true, the rules class provides Split() and Merge(), and can be used by
+   * ParallelDualTreeTraversal().
+   */
+  static const bool IsSplittable = false;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
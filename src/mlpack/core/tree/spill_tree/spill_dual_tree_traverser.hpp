@@ -20,6 +20,7 @@
 
 #include <mlpack/prereqs.hpp>
 
+#include "../traversal_statistics.hpp"
 #include "spill_tree.hpp"
 
 namespace mlpack {
@@ -73,6 +74,9 @@ class SpillTree<MetricType, StatisticType, MatType, HyperplaneType, SplitType>::
   //! Modify the number of times a base case was calculated.
   size_t& NumBaseCases() { return numBaseCases; }
 
+  //! Get the timings and the maximum recursion depth of the traversals.
+  const TraversalStatistics& Statistics() const { return statistics; }
+
  private:
   //! Reference to the rules with which the trees will be traversed.
   RuleType& rule;
@@ -89,6 +93,9 @@ class SpillTree<MetricType, StatisticType, MatType, HyperplaneType, SplitType>::
   //! The number of times a base case was calculated.
   size_t numBaseCases;
 
+  //! The timings and the recursion depth of the traversals.
+  TraversalStatistics statistics;
+
   //! Traversal information, held in the class so that it isn't continually
   //! being reallocated.
   typename RuleType::TraversalInfoType traversalInfo;
@@ -53,6 +53,8 @@ SpillDualTreeTraverser<RuleType, Defeatist>::Traverse(
         referenceNode,
     const bool bruteForce)
 {
+  TraversalStatistics::Level level(statistics);
+
   // Increment the visit counter.
   ++numVisited;
 
@@ -77,7 +79,10 @@ SpillDualTreeTraverser<RuleType, Defeatist>::Traverse(
     // If both are leaves or if we explicitly need to do brute-force search, we
     // must evaluate the base cases.
 
-    // Loop through each of the points in each node.
+    // Loop through each of the points in each node.  The scores of the query
+    // points are counted as base case time.
+    const TraversalStatistics::Clock::time_point start =
+        TraversalStatistics::Now();
     const size_t queryEnd = queryNode.NumDescendants();
     const size_t refEnd = referenceNode.NumDescendants();
     for (size_t query = 0; query < queryEnd; ++query)
@@ -96,6 +101,7 @@ SpillDualTreeTraverser<RuleType, Defeatist>::Traverse(
 
       numBaseCases += refEnd;
     }
+    statistics.AddBaseCaseTime(start);
   }
   else if (((!queryNode.IsLeaf()) && referenceNode.IsLeaf()) ||
            (queryNode.NumDescendants() > 3 * referenceNode.NumDescendants() &&
@@ -103,7 +109,9 @@ SpillDualTreeTraverser<RuleType, Defeatist>::Traverse(
   {
     // We have to recurse down the query node.  In this case the recursion order
     // does not matter.
+    TraversalStatistics::Clock::time_point start = TraversalStatistics::Now();
     const double leftScore = rule.Score(*queryNode.Left(), referenceNode);
+    statistics.AddScoreTime(start);
     ++numScores;
 
     if (leftScore != DBL_MAX)
@@ -113,7 +121,9 @@ SpillDualTreeTraverser<RuleType, Defeatist>::Traverse(
 
     // Before recursing, we have to set the traversal information correctly.
     rule.TraversalInfo() = traversalInfo;
+    start = TraversalStatistics::Now();
     const double rightScore = rule.Score(*queryNode.Right(), referenceNode);
+    statistics.AddScoreTime(start);
     ++numScores;
 
     if (rightScore != DBL_MAX)
@@ -126,7 +136,10 @@ SpillDualTreeTraverser<RuleType, Defeatist>::Traverse(
     if (Defeatist && referenceNode.Overlap())
     {
       // If referenceNode is a overlapping node let's do defeatist search.
+      TraversalStatistics::Clock::time_point start =
+          TraversalStatistics::Now();
       size_t bestChild = rule.GetBestChild(queryNode, referenceNode);
+      statistics.AddScoreTime(start);
       if (bestChild < referenceNode.NumChildren())
       {
         Traverse(queryNode, referenceNode.Child(bestChild));
@@ -145,13 +158,19 @@ SpillDualTreeTraverser<RuleType, Defeatist>::Traverse(
         {
           const size_t queryIndex = queryNode.Point(query);
           // See if we need to investigate this point.
+          start = TraversalStatistics::Now();
           const double childScore = rule.Score(queryIndex, referenceNode);
+          statistics.AddScoreTime(start);
 
           if (childScore == DBL_MAX)
             continue; // We can't improve this particular point.
 
           st.Traverse(queryIndex, referenceNode);
         }
+
+        // Add the timings of the single-tree traversals.  Their depth is
+        // counted from the reference node.
+        statistics += st.Statistics();
       }
     }
     else
@@ -159,10 +178,13 @@ SpillDualTreeTraverser<RuleType, Defeatist>::Traverse(
       // We have to recurse down the reference node.  In this case the recursion
       // order does matter.  Before recursing, though, we have to set the
       // traversal information correctly.
+      const TraversalStatistics::Clock::time_point start =
+          TraversalStatistics::Now();
       double leftScore = rule.Score(queryNode, *referenceNode.Left());
       typename RuleType::TraversalInfoType leftInfo = rule.TraversalInfo();
       rule.TraversalInfo() = traversalInfo;
       double rightScore = rule.Score(queryNode, *referenceNode.Right());
+      statistics.AddScoreTime(start);
       numScores += 2;
 
       if (leftScore < rightScore)
@@ -237,7 +259,10 @@ SpillDualTreeTraverser<RuleType, Defeatist>::Traverse(
     if (Defeatist && referenceNode.Overlap())
     {
       // If referenceNode is a overlapping node let's do defeatist search.
+      TraversalStatistics::Clock::time_point start =
+          TraversalStatistics::Now();
       size_t bestChild = rule.GetBestChild(*queryNode.Left(), referenceNode);
+      statistics.AddScoreTime(start);
       if (bestChild < referenceNode.NumChildren())
       {
         Traverse(*queryNode.Left(), referenceNode.Child(bestChild));
@@ -251,7 +276,9 @@ SpillDualTreeTraverser<RuleType, Defeatist>::Traverse(
         Traverse(*queryNode.Left(), referenceNode);
       }
 
+      start = TraversalStatistics::Now();
       bestChild = rule.GetBestChild(*queryNode.Right(), referenceNode);
+      statistics.AddScoreTime(start);
       if (bestChild < referenceNode.NumChildren())
       {
         Traverse(*queryNode.Right(), referenceNode.Child(bestChild));
@@ -271,10 +298,13 @@ SpillDualTreeTraverser<RuleType, Defeatist>::Traverse(
       // query descent order does not matter, we will go to the left query child
       // first.  Before recursing, we have to set the traversal information
       // correctly.
+      TraversalStatistics::Clock::time_point start =
+          TraversalStatistics::Now();
       double leftScore = rule.Score(*queryNode.Left(), *referenceNode.Left());
       typename RuleType::TraversalInfoType leftInfo = rule.TraversalInfo();
       rule.TraversalInfo() = traversalInfo;
       double rightScore = rule.Score(*queryNode.Left(), *referenceNode.Right());
+      statistics.AddScoreTime(start);
       typename RuleType::TraversalInfoType rightInfo;
       numScores += 2;
 
@@ -350,10 +380,12 @@ SpillDualTreeTraverser<RuleType, Defeatist>::Traverse(
       rule.TraversalInfo() = traversalInfo;
 
       // Now recurse down the right query node.
+      start = TraversalStatistics::Now();
       leftScore = rule.Score(*queryNode.Right(), *referenceNode.Left());
       leftInfo = rule.TraversalInfo();
       rule.TraversalInfo() = traversalInfo;
       rightScore = rule.Score(*queryNode.Right(), *referenceNode.Right());
+      statistics.AddScoreTime(start);
       numScores += 2;
 
       if (leftScore < rightScore)
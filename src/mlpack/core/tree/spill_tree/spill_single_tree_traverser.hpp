@@ -19,6 +19,7 @@
 
 #include <mlpack/prereqs.hpp>
 
+#include "../traversal_statistics.hpp"
 #include "spill_tree.hpp"
 
 namespace mlpack {
@@ -58,12 +59,18 @@ class SpillTree<MetricType, StatisticType, MatType, HyperplaneType, SplitType>::
   //! Modify the number of prunes.
   size_t& NumPrunes() { return numPrunes; }
 
+  //! Get the timings and the maximum recursion depth of the traversals.
+  const TraversalStatistics& Statistics() const { return statistics; }
+
  private:
   //! Reference to the rules with which the tree will be traversed.
   RuleType& rule;
 
   //! The number of nodes which have been pruned during traversal.
   size_t numPrunes;
+
+  //! The timings and the recursion depth of the traversals.
+  TraversalStatistics statistics;
 };
 
 } // namespace tree
@@ -49,6 +49,8 @@ SpillSingleTreeTraverser<RuleType, Defeatist>::Traverse(
         referenceNode,
     const bool bruteForce)
 {
+  TraversalStatistics::Level level(statistics);
+
   // If we have too few points, then we need to backtrack up one level and
   // brute-force search.
   if (!bruteForce && Defeatist &&
@@ -60,23 +62,32 @@ SpillSingleTreeTraverser<RuleType, Defeatist>::Traverse(
   }
   else if (referenceNode.IsLeaf() || bruteForce)
   {
+    const TraversalStatistics::Clock::time_point start =
+        TraversalStatistics::Now();
     for (size_t i = 0; i < referenceNode.NumDescendants(); ++i)
       rule.BaseCase(queryIndex, referenceNode.Descendant(i));
+    statistics.AddBaseCaseTime(start);
   }
   else
   {
     if (Defeatist && referenceNode.Overlap())
     {
       // If referenceNode is a overlapping node we do defeatist search.
+      const TraversalStatistics::Clock::time_point start =
+          TraversalStatistics::Now();
       size_t bestChild = rule.GetBestChild(queryIndex, referenceNode);
+      statistics.AddScoreTime(start);
       Traverse(queryIndex, referenceNode.Child(bestChild));
       ++numPrunes;
     }
     else
     {
       // If either score is DBL_MAX, we do not recurse into that node.
+      const TraversalStatistics::Clock::time_point start =
+          TraversalStatistics::Now();
       double leftScore = rule.Score(queryIndex, *referenceNode.Left());
       double rightScore = rule.Score(queryIndex, *referenceNode.Right());
+      statistics.AddScoreTime(start);
 
       if (leftScore < rightScore)
       {
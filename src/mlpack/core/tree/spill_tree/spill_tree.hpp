@@ -437,6 +437,18 @@ class SpillTree
   //! Store the center of the bounding region in the given vector.
   void Center(arma::vec& center) { bound.Center(center); }
 
+  /**
+   * Get or modify the minimum number of points a node must hold for its two
+   * children to be built as separate OpenMP tasks.  Smaller nodes are built
+   * serially; the resulting tree is the same either way.  The setting is shared
+   * by all trees of this type.
+   */
+  static size_t& ParallelBuildThreshold()
+  {
+    static size_t threshold = 10000;
+    return threshold;
+  }
+
  private:
   /**
    * Splits the current node, assigning its left and right children recursively.
@@ -451,6 +463,23 @@ class SpillTree
                  const double tau,
                  const double rho);
 
+  /**
+   * Build the left and right children of the current node from the given
+   * lists of points.  Large nodes build the two children as separate OpenMP
+   * tasks; see ParallelBuildThreshold().
+   *
+   * @param leftPoints Indexes of points to be included in left child.
+   * @param rightPoints Indexes of points to be included in right child.
+   * @param maxLeafSize Maximum number of points held in a leaf.
+   * @param tau Overlapping size.
+   * @param rho Balance threshold.
+   */
+  void BuildChildren(arma::Col<size_t>& leftPoints,
+                     arma::Col<size_t>& rightPoints,
+                     const size_t maxLeafSize,
+                     const double tau,
+                     const double rho);
+
   /**
    * Split the list of points.
    *
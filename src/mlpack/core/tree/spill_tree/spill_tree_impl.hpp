@@ -767,8 +767,7 @@ void SpillTree<MetricType, StatisticType, MatType, HyperplaneType, SplitType>::
 
   // Now we will recursively split the children by calling their constructors
   // (which perform this splitting process).
-  left = new SpillTree(this, leftPoints, tau, maxLeafSize, rho);
-  right = new SpillTree(this, rightPoints, tau, maxLeafSize, rho);
+  BuildChildren(leftPoints, rightPoints, maxLeafSize, tau, rho);
 
   // Calculate parent distances for those two nodes.
   arma::vec center, leftCenter, rightCenter;
@@ -784,6 +783,49 @@ void SpillTree<MetricType, StatisticType, MatType, HyperplaneType, SplitType>::
   right->ParentDistance() = rightParentDistance;
 }
 
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename HyperplaneMetricType> class HyperplaneType,
+         template<typename SplitMetricType, typename SplitMatType>
+             class SplitType>
+void SpillTree<MetricType, StatisticType, MatType, HyperplaneType, SplitType>::
+    BuildChildren(arma::Col<size_t>& leftPoints,
+                  arma::Col<size_t>& rightPoints,
+                  const size_t maxLeafSize,
+                  const double tau,
+                  const double rho)
+{
+  // Each child takes its own list of points, and the splits don't depend on
+  // anything but the node being split, so the two children can be built at
+  // the same time and the tree will be exactly the same as if it were built
+  // serially.
+  const bool parallel = (count >= ParallelBuildThreshold());
+
+  #ifdef HAS_OPENMP
+  // The first large node opens the parallel region (unless the tree is being
+  // built inside one already); the tasks for all of its descendants are then
+  // run by the threads of that region.
+  if (parallel && omp_get_level() == 0 && omp_get_max_threads() > 1)
+  {
+    #pragma omp parallel
+    {
+      #pragma omp single
+      BuildChildren(leftPoints, rightPoints, maxLeafSize, tau, rho);
+    }
+    return;
+  }
+  #endif
+
+  // The left child is built as a task while this thread builds the right child.
+  #pragma omp task if (parallel) default(shared)
+  left = new SpillTree(this, leftPoints, tau, maxLeafSize, rho);
+
+  right = new SpillTree(this, rightPoints, tau, maxLeafSize, rho);
+
+  #pragma omp taskwait
+}
+
 template<typename MetricType,
          typename StatisticType,
          typename MatType,
@@ -0,0 +1,136 @@
+/**
+ * @file core/tree/traversal_statistics.hpp
+ *
+ * Definition of TraversalStatistics, which a tree traverser uses to measure the
+ * time spent in base cases and in scoring, and the depth of its recursion.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_TRAVERSAL_STATISTICS_HPP
+#define MLPACK_CORE_TREE_TRAVERSAL_STATISTICS_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <chrono>
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * The TraversalStatistics class holds the timings and the maximum recursion
+ * depth of a tree traversal.  A traverser holds one as a member, creates a
+ * Level object at the start of each recursive call of Traverse(), and brackets
+ * each batch of BaseCase() calls (the points of a leaf) and each batch of
+ * Score() calls (the children of a node) with Now() and AddBaseCaseTime() or
+ * AddScoreTime().  A traverser that processes the levels of the tree in a loop
+ * calls ReachDepth() instead of creating Level objects.  The interface to it
+ * should be through a Statistics() method of the traverser.
+ *
+ * The times are measured with std::chrono::steady_clock.  Reading it is cheap
+ * but not free, so recursive traversers time batches and not single calls; the
+ * cover tree traversers, whose nodes hold a single point, time each call.
+ */
+class TraversalStatistics
+{
+ public:
+  //! The clock used for the timings.
+  typedef std::chrono::steady_clock Clock;
+
+  /**
+   * One level of the recursion of a traverser.  Creating the object increases
+   * the current depth (and the maximum depth, if it is reached), and destroying
+   * it decreases the current depth again.
+   */
+  class Level
+  {
+   public:
+    //! Enter a new level of the recursion.
+    Level(TraversalStatistics& statistics) : statistics(statistics)
+    {
+      if (++statistics.depth > statistics.maxDepth)
+        statistics.maxDepth = statistics.depth;
+    }
+
+    //! Leave the level of the recursion.
+    ~Level() { --statistics.depth; }
+
+   private:
+    //! The statistics of the traverser.
+    TraversalStatistics& statistics;
+  };
+
+  //! Create the object with all timings and depths set to 0.
+  TraversalStatistics() :
+      depth(0),
+      maxDepth(0),
+      baseCaseTime(Clock::duration::zero()),
+      scoreTime(Clock::duration::zero())
+  { /* Nothing to do. */ }
+
+  //! Get the current time, at the start of a batch of calls.
+  static Clock::time_point Now() { return Clock::now(); }
+
+  //! Add the time elapsed since the given start to the base case time.
+  void AddBaseCaseTime(const Clock::time_point start)
+  {
+    baseCaseTime += Clock::now() - start;
+  }
+
+  //! Add the time elapsed since the given start to the score time.
+  void AddScoreTime(const Clock::time_point start)
+  {
+    scoreTime += Clock::now() - start;
+  }
+
+  //! Note that a traverser without recursion (one that processes the levels of
+  //! a tree in a loop) reached the given depth.
+  void ReachDepth(const size_t levelDepth)
+  {
+    if (levelDepth > maxDepth)
+      maxDepth = levelDepth;
+  }
+
+  /**
+   * Add the timings of another object (for instance, one used by another
+   * thread) to this one, and keep the larger of the two maximum depths.
+   */
+  TraversalStatistics& operator+=(const TraversalStatistics& other)
+  {
+    baseCaseTime += other.baseCaseTime;
+    scoreTime += other.scoreTime;
+    ReachDepth(other.maxDepth);
+    return *this;
+  }
+
+  //! Get the maximum depth of the recursion reached so far.
+  size_t MaxDepth() const { return maxDepth; }
+
+  //! Get the time spent in base cases, in seconds.
+  double BaseCaseTime() const
+  {
+    return std::chrono::duration<double>(baseCaseTime).count();
+  }
+
+  //! Get the time spent scoring nodes, in seconds.
+  double ScoreTime() const
+  {
+    return std::chrono::duration<double>(scoreTime).count();
+  }
+
+ private:
+  //! The current depth of the recursion.
+  size_t depth;
+  //! The maximum depth of the recursion.
+  size_t maxDepth;
+  //! The time spent in base cases.
+  Clock::duration baseCaseTime;
+  //! The time spent scoring nodes.
+  Clock::duration scoreTime;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
@@ -143,13 +143,53 @@ void IO::MakeInPlaceCopy(const std::string& outputParamName,
   }
 }
 
-// Returns the sole instance of this class.
+namespace {
+
+// The instance of the IO::Context bound on the calling thread, if any.
+thread_local IO* boundInstance = NULL;
+
+} // anonymous namespace
+
+// Returns the instance of the bound context, or the process-wide instance.
 IO& IO::GetSingleton()
 {
+  if (boundInstance != NULL)
+    return *boundInstance;
+
   static IO singleton;
   return singleton;
 }
 
+IO::Context::Context() :
+    instance(new IO()),
+    previous(boundInstance)
+{
+  // Keep the details of the enclosing binding, for help and error messages.
+  instance->doc = GetSingleton().doc;
+  instance->programName = GetSingleton().programName;
+  boundInstance = instance;
+}
+
+IO::Context::~Context()
+{
+  boundInstance = previous;
+  delete instance;
+}
+
+// Returns the settings stored by all instances.
+IO::StorageMapType& IO::StorageMap()
+{
+  static StorageMapType storageMap;
+  return storageMap;
+}
+
+// Returns the mutex guarding the stored settings.
+std::mutex& IO::StorageMutex()
+{
+  static std::mutex storageMutex;
+  return storageMutex;
+}
+
 // Get the parameters that the IO object knows about.
 std::map<std::string, ParamData>& IO::Parameters()
 {
@@ -186,9 +226,13 @@ void IO::StoreSettings(const std::string& name)
 {
   // Take all of the parameters and put them in the map.  Clear anything old
   // first.
-  std::get<0>(GetSingleton().storageMap[name]) = GetSingleton().parameters;
-  std::get<1>(GetSingleton().storageMap[name]) = GetSingleton().aliases;
-  std::get<2>(GetSingleton().storageMap[name]) = GetSingleton().functionMap;
+  {
+    std::lock_guard<std::mutex> lock(StorageMutex());
+    StorageMapType& storageMap = StorageMap();
+    std::get<0>(storageMap[name]) = GetSingleton().parameters;
+    std::get<1>(storageMap[name]) = GetSingleton().aliases;
+    std::get<2>(storageMap[name]) = GetSingleton().functionMap;
+  }
 
   ClearSettings();
 }
@@ -196,21 +240,24 @@ void IO::StoreSettings(const std::string& name)
 // Restore settings.
 void IO::RestoreSettings(const std::string& name, const bool fatal)
 {
-  if (GetSingleton().storageMap.count(name) == 0 && fatal)
+  std::unique_lock<std::mutex> lock(StorageMutex());
+  StorageMapType& storageMap = StorageMap();
+  if (storageMap.count(name) == 0 && fatal)
   {
     throw std::invalid_argument("no settings stored under the name '" + name
         + "'");
   }
-  else if (GetSingleton().storageMap.count(name) == 0 && !fatal)
+  else if (storageMap.count(name) == 0 && !fatal)
   {
     // Nothing to do, just clear what's there.
+    lock.unlock();
     ClearSettings();
   }
   else
   {
-    GetSingleton().parameters = std::get<0>(GetSingleton().storageMap[name]);
-    GetSingleton().aliases = std::get<1>(GetSingleton().storageMap[name]);
-    GetSingleton().functionMap = std::get<2>(GetSingleton().storageMap[name]);
+    GetSingleton().parameters = std::get<0>(storageMap[name]);
+    GetSingleton().aliases = std::get<1>(storageMap[name]);
+    GetSingleton().functionMap = std::get<2>(storageMap[name]);
   }
 }
 
@@ -19,6 +19,7 @@
 #include <string>
 
 #include <boost/any.hpp>
+#include <mutex>
 
 #include <mlpack/prereqs.hpp>
 
@@ -240,10 +241,56 @@ class IO
    * as there is no point in defining static methods only to have users call
    * private instance methods.
    *
+   * If an IO::Context is bound on the calling thread, the instance of that
+   * context is returned; otherwise, this is the process-wide instance.
+   * Settings saved with StoreSettings() are shared by all instances.
+   *
    * @return The singleton instance for use in the static methods.
    */
   static IO& GetSingleton();
 
+  /**
+   * The parameter context of one call to a binding.  While a Context is alive,
+   * the static methods of IO called on the thread that created it use the
+   * parameters, aliases, function map and timers of that context instead of
+   * the process-wide ones, so that several bindings can be called at the same
+   * time (for instance from different Python threads) without sharing
+   * parameters.  Contexts nest: destroying one binds again whatever was bound
+   * before it was created.  A new context starts with no parameters (use
+   * RestoreSettings()) and the binding details of the enclosing one.
+   *
+   * Only the creating thread sees the context, so IO should not be used from
+   * worker threads started by the call.  A Context must be destroyed on the
+   * thread that created it, in the reverse order of creation.
+   *
+   * @code
+   * {
+   *   IO::Context context;
+   *   IO::RestoreSettings("program");
+   *   // ... set parameters and call the program ...
+   * } // The parameters of the call are released here.
+   * @endcode
+   */
+  class Context
+  {
+   public:
+    //! Create a new context and bind it on the calling thread.
+    Context();
+    //! Unbind the context and release its parameters.
+    ~Context();
+
+   private:
+    //! The instance of IO holding the state of the call.
+    IO* instance;
+    //! The instance that was bound when this context was created, if any.
+    IO* previous;
+
+    //! Contexts can't be copied.
+    Context(const Context& other);
+    //! Contexts can't be copied.
+    Context& operator=(const Context& other);
+  };
+
   //! Return a modifiable list of parameters that IO knows about.
   static std::map<std::string, util::ParamData>& Parameters();
   //! Return a modifiable list of aliases that IO knows about.
@@ -299,9 +346,15 @@ class IO
   FunctionMapType functionMap;
 
  private:
-  //! Storage map for parameters.
-  std::map<std::string, std::tuple<std::map<std::string, util::ParamData>,
-      std::map<char, std::string>, FunctionMapType>> storageMap;
+  //! Type of the storage map for parameters.
+  typedef std::map<std::string, std::tuple<std::map<std::string,
+      util::ParamData>, std::map<char, std::string>, FunctionMapType>>
+      StorageMapType;
+
+  //! Storage map for parameters; this is shared by all instances.
+  static StorageMapType& StorageMap();
+  //! Mutex guarding the storage map.
+  static std::mutex& StorageMutex();
 
  public:
   //! True, if IO was used to parse command line options.
@@ -91,6 +91,7 @@ static const std::string testName = "";
 #include <mlpack/core/util/param.hpp>
 #include <mlpack/bindings/cli/parse_command_line.hpp>
 #include <mlpack/bindings/cli/end_program.hpp>
+#include <mlpack/bindings/cli/serve.hpp>
 
 static void mlpackMain(); // This is typically defined after this include.
 
@@ -104,7 +105,17 @@ int main(int argc, char** argv)
   // A "total_time" timer is run by default for each mlpack program.
   mlpack::Timer::Start("total_time");
 
-  mlpackMain();
+  {
+    // Run with at most the number of threads given with --threads.
+    const int threads = mlpack::IO::GetParam<int>("threads");
+    mlpack::util::ThreadLimit threadLimit(threads > 0 ? (size_t) threads : 0);
+
+    // With --serve, run once for each batch of queries.
+    if (mlpack::IO::HasParam("serve"))
+      mlpack::bindings::cli::Serve(mlpackMain);
+    else
+      mlpackMain();
+  }
 
   // Print output options, print verbose information, save model parameters,
   // clean up, and so forth.
@@ -153,6 +164,10 @@ using Option = mlpack::bindings::tests::TestOption<T>;
 // testName symbol should be defined in each binding test file
 #include <mlpack/core/util/param.hpp>
 
+// The bindings that run in parallel read the common number of threads.
+PARAM_INT_IN("threads", "Maximum number of threads to use; 0 uses the OpenMP "
+    "default.", "", 0);
+
 #elif(BINDING_TYPE == BINDING_TYPE_PYX) // This is a Python binding.
 
 // Matrices are transposed on load/save.
@@ -226,12 +241,26 @@ static const std::string testName = "";
 
 PARAM_FLAG("verbose", "Display informational messages and the full list of "
     "parameters and timers at the end of execution.", "v");
+PARAM_INT_IN("threads", "Maximum number of threads to use; 0 uses the OpenMP "
+    "default (the OMP_NUM_THREADS environment variable, or the number of "
+    "cores).", "", 0);
 PARAM_FLAG("copy_all_inputs", "If specified, all input parameters will be deep"
     " copied before the method is run.  This is useful for debugging problems "
     "where the input parameters are being modified by the algorithm, but can "
     "slow down the code.", "");
 
-// Nothing else needs to be defined---the binding will use mlpackMain() as-is.
+static void mlpackMain(); // This is typically defined after this include.
+
+/**
+ * Run mlpackMain() with at most the number of threads given by the "threads"
+ * parameter; this is what the generated Python binding calls.
+ */
+static void mlpackMainWithThreads()
+{
+  const int threads = mlpack::IO::GetParam<int>("threads");
+  mlpack::util::ThreadLimit threadLimit(threads > 0 ? (size_t) threads : 0);
+  mlpackMain();
+}
 
 #elif(BINDING_TYPE == BINDING_TYPE_JL) // This is a Julia binding.
 
@@ -274,6 +303,9 @@ static const std::string testName = "";
 
 PARAM_FLAG("verbose", "Display informational messages and the full list of "
     "parameters and timers at the end of execution.", "v");
+PARAM_INT_IN("threads", "Maximum number of threads to use; 0 uses the OpenMP "
+    "default (the OMP_NUM_THREADS environment variable, or the number of "
+    "cores).", "", 0);
 
 // Nothing else needs to be defined---the binding will use mlpackMain() as-is.
 
@@ -318,6 +350,9 @@ static const std::string testName = "";
 
 PARAM_FLAG("verbose", "Display informational messages and the full list of "
     "parameters and timers at the end of execution.", "v");
+PARAM_INT_IN("threads", "Maximum number of threads to use; 0 uses the OpenMP "
+    "default (the OMP_NUM_THREADS environment variable, or the number of "
+    "cores).", "", 0);
 
 // Nothing else needs to be defined---the binding will use mlpackMain() as-is.
 
@@ -350,6 +385,9 @@ static const std::string testName = "";
 
 PARAM_FLAG("verbose", "Display informational messages and the full list of "
     "parameters and timers at the end of execution.", "v");
+PARAM_INT_IN("threads", "Maximum number of threads to use; 0 uses the OpenMP "
+    "default (the OMP_NUM_THREADS environment variable, or the number of "
+    "cores).", "", 0);
 
 // Nothing else needs to be defined---the binding will use mlpackMain() as-is.
 
@@ -474,11 +512,28 @@ using Option = mlpack::bindings::markdown::MDOption<T>;
 
 PARAM_FLAG("verbose", "Display informational messages and the full list of "
     "parameters and timers at the end of execution.", "v");
+PARAM_INT_IN("threads", "Maximum number of threads to use; 0 uses the OpenMP "
+    "default (the OMP_NUM_THREADS environment variable, or the number of "
+    "cores).", "", 0);
 
 // CLI-specific parameters.
 PARAM_FLAG("help", "Default help info.", "h");
 PARAM_STRING_IN("info", "Print help on a specific option.", "", "");
 PARAM_FLAG("version", "Display the version of mlpack.", "V");
+PARAM_STRING_IN("timing", "If specified, the program timers and the profile of "
+    "the instrumented code are written to this file as JSON.", "", "");
+PARAM_STRING_IN("serve", "If specified, run as a server: the matrix input "
+    "parameter with this name is set to each batch of points read from the "
+    "standard input (or from --serve_socket), and the --serve_output "
+    "parameters are written back after each batch.  Models are loaded once.",
+    "", "");
+PARAM_VECTOR_IN(std::string, "serve_output", "Matrix output parameters "
+    "written back after each batch in --serve mode.", "");
+PARAM_STRING_IN("serve_socket", "If specified with --serve, the Unix socket "
+    "to serve on instead of the standard input and output.", "", "");
+PARAM_FLAG("serve_binary", "If specified with --serve, batches are framed in "
+    "binary (the numbers of points and of values as 64-bit integers, then the "
+    "values as doubles) instead of CSV.", "");
 
 // Python-specific parameters.
 PARAM_FLAG("copy_all_inputs", "If specified, all input parameters will be deep"
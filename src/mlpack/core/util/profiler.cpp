@@ -0,0 +1,188 @@
+/**
+ * @file core/util/profiler.cpp
+ *
+ * Implementation of the Profiler.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "profiler.hpp"
+
+#include <map>
+#include <memory>
+#include <sstream>
+
+using namespace mlpack;
+using namespace mlpack::profiler;
+
+const size_t Profiler::NoNode;
+
+namespace {
+
+//! The names of the scopes (indexed by id) and the profiles of the threads.
+struct Registry
+{
+  std::mutex mutex;
+  std::map<std::string, size_t> ids;
+  std::vector<std::string> names;
+  std::vector<std::unique_ptr<ThreadProfile>> threads;
+};
+
+Registry& GetRegistry()
+{
+  static Registry registry;
+  return registry;
+}
+
+//! Add the given node of a thread profile, and its children, to the merged
+//! node.
+void Merge(const ThreadProfile& profile,
+           const ProfileNode& node,
+           const std::vector<std::string>& names,
+           Profiler::Node& merged)
+{
+  const uint64_t calls = node.calls.load(std::memory_order_relaxed);
+  merged.calls += calls;
+  merged.time += std::chrono::nanoseconds(
+      node.nanoseconds.load(std::memory_order_relaxed));
+  if (calls > 0)
+    ++merged.threads;
+
+  for (size_t i = 0; i < node.children.size(); ++i)
+  {
+    const ProfileNode& child = profile.nodes[node.children[i]];
+
+    Profiler::Node* mergedChild = NULL;
+    for (size_t j = 0; j < merged.children.size(); ++j)
+    {
+      if (merged.children[j].name == names[child.id])
+      {
+        mergedChild = &merged.children[j];
+        break;
+      }
+    }
+
+    if (!mergedChild)
+    {
+      merged.children.push_back(Profiler::Node());
+      mergedChild = &merged.children.back();
+      mergedChild->name = names[child.id];
+      mergedChild->calls = 0;
+      mergedChild->time = std::chrono::nanoseconds(0);
+      mergedChild->threads = 0;
+    }
+
+    Merge(profile, child, names, *mergedChild);
+  }
+}
+
+//! Write the given string as a JSON string.
+void WriteString(std::ostringstream& oss, const std::string& str)
+{
+  oss << '"';
+  for (const char c : str)
+  {
+    if (c == '"' || c == '\\')
+      oss << '\\' << c;
+    else if ((unsigned char) c < 0x20)
+      oss << ' ';
+    else
+      oss << c;
+  }
+  oss << '"';
+}
+
+//! Write the given scopes as a JSON array.
+void WriteNodes(std::ostringstream& oss,
+                const std::vector<Profiler::Node>& nodes)
+{
+  oss << '[';
+  for (size_t i = 0; i < nodes.size(); ++i)
+  {
+    if (i > 0)
+      oss << ", ";
+
+    oss << "{\"name\": ";
+    WriteString(oss, nodes[i].name);
+    oss << ", \"calls\": " << nodes[i].calls << ", \"time_us\": "
+        << (nodes[i].time.count() / 1000) << ", \"threads\": "
+        << nodes[i].threads << ", \"children\": ";
+    WriteNodes(oss, nodes[i].children);
+    oss << '}';
+  }
+  oss << ']';
+}
+
+} // anonymous namespace
+
+size_t Profiler::Register(const std::string& name)
+{
+  Registry& registry = GetRegistry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+
+  std::map<std::string, size_t>::const_iterator it = registry.ids.find(name);
+  if (it != registry.ids.end())
+    return it->second;
+
+  const size_t id = registry.names.size();
+  registry.ids[name] = id;
+  registry.names.push_back(name);
+  return id;
+}
+
+std::atomic<bool>& Profiler::EnabledFlag()
+{
+  static std::atomic<bool> enabled(false);
+  return enabled;
+}
+
+ThreadProfile* Profiler::AddThread()
+{
+  Registry& registry = GetRegistry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  registry.threads.emplace_back(new ThreadProfile());
+  return registry.threads.back().get();
+}
+
+void Profiler::Reset()
+{
+  Registry& registry = GetRegistry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  for (std::unique_ptr<ThreadProfile>& profile : registry.threads)
+  {
+    // Nodes can't be removed, since threads may be inside them.
+    std::lock_guard<std::mutex> threadLock(profile->mutex);
+    for (ProfileNode& node : profile->nodes)
+    {
+      node.calls = 0;
+      node.nanoseconds = 0;
+    }
+  }
+}
+
+Profiler::Node Profiler::Report()
+{
+  Node root;
+  root.calls = 0;
+  root.time = std::chrono::nanoseconds(0);
+  root.threads = 0;
+
+  Registry& registry = GetRegistry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  for (std::unique_ptr<ThreadProfile>& profile : registry.threads)
+  {
+    std::lock_guard<std::mutex> threadLock(profile->mutex);
+    Merge(*profile, profile->nodes[0], registry.names, root);
+  }
+
+  return root;
+}
+
+std::string Profiler::ToJSON()
+{
+  std::ostringstream oss;
+  WriteNodes(oss, Report().children);
+  return oss.str();
+}
@@ -0,0 +1,277 @@
+/**
+ * @file core/util/profiler.hpp
+ *
+ * A low-overhead hierarchical profiler for hot code paths.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_UTIL_PROFILER_HPP
+#define MLPACK_CORE_UTIL_PROFILER_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace mlpack {
+namespace profiler {
+
+//! A node of the profile of one thread: one scope, reached through the scopes
+//! of its ancestors.
+struct ProfileNode
+{
+  ProfileNode(const size_t id, const size_t parent) :
+      id(id), parent(parent), calls(0), nanoseconds(0) { }
+
+  //! The id of the scope.
+  size_t id;
+  //! The index of the parent node.
+  size_t parent;
+  //! The indices of the child nodes.
+  std::vector<size_t> children;
+  //! The number of times the scope was entered.  Only the owning thread
+  //! writes this, so it doesn't need atomic increments.
+  std::atomic<uint64_t> calls;
+  //! The total time spent in the scope.
+  std::atomic<uint64_t> nanoseconds;
+};
+
+//! The profile of one thread.
+struct ThreadProfile
+{
+  ThreadProfile() : current(0) { nodes.emplace_back(size_t(-1), size_t(-1)); }
+
+  //! Held while nodes are added, and while the profile is read by another
+  //! thread.
+  std::mutex mutex;
+  //! All the nodes; the first one is the root.
+  std::deque<ProfileNode> nodes;
+  //! The index of the scope the thread is in.
+  size_t current;
+};
+
+} // namespace profiler
+
+/**
+ * The Profiler collects a hierarchical profile of the scopes instrumented with
+ * MLPACK_PROFILE_SCOPE(), with the number of calls and the time spent in each
+ * scope, reached through each path of enclosing scopes.  It is meant for hot
+ * paths (such as tree traversals or layer forwards), where Timer is too slow:
+ *
+ *  - Each scope name is registered once, the first time the scope is reached,
+ *    and is then referred to by an integer id.
+ *  - Every thread accumulates its own profile without locking; the profiles
+ *    are merged when Report() or ToJSON() is called.  The time of a scope is
+ *    the total over all threads that entered it.
+ *  - When profiling is disabled (the default), a scope costs one relaxed
+ *    atomic load.  If MLPACK_NO_PROFILING is defined, scopes are not compiled
+ *    at all.
+ *
+ * A scope that directly encloses itself (i.e. a recursive function) is counted
+ * as one more call of the outer scope, so that recursion does not deepen the
+ * profile or count time twice.
+ *
+ * @code
+ * void Traverse(Node& node)
+ * {
+ *   MLPACK_PROFILE_SCOPE("traverse");
+ *   // ...
+ * }
+ *
+ * Profiler::Enable();
+ * Traverse(root);
+ * std::cout << Profiler::ToJSON() << std::endl;
+ * @endcode
+ *
+ * Command-line programs given --timing write the profile (with the Timer
+ * values) to a JSON file.
+ */
+class Profiler
+{
+ public:
+  //! A scope of the merged profile.
+  struct Node
+  {
+    //! The name of the scope.
+    std::string name;
+    //! The number of times the scope was entered, over all threads.
+    uint64_t calls;
+    //! The total time spent in the scope, over all threads.
+    std::chrono::nanoseconds time;
+    //! The number of threads that entered the scope.
+    size_t threads;
+    //! The scopes entered from this scope.
+    std::vector<Node> children;
+  };
+
+  //! Returned by Enter() when no time should be recorded.
+  static const size_t NoNode = size_t(-1);
+
+  /**
+   * Get the id of the scope with the given name, registering it if needed.
+   * This takes a lock, so it should only be called once per scope (as
+   * MLPACK_PROFILE_SCOPE() does).
+   *
+   * @param name Name of the scope.
+   */
+  static size_t Register(const std::string& name);
+
+  //! Start collecting the profile.
+  static void Enable() { EnabledFlag() = true; }
+  //! Stop collecting the profile.
+  static void Disable() { EnabledFlag() = false; }
+  //! Return whether the profile is being collected.
+  static bool Enabled()
+  {
+    return EnabledFlag().load(std::memory_order_relaxed);
+  }
+
+  /**
+   * Set the number of calls and the time of every scope to zero.  The scopes
+   * that have been reached are still reported (with no calls).  This should
+   * not be called while other threads are in profiled scopes.
+   */
+  static void Reset();
+
+  //! Merge the profiles of all threads.  The returned node is the root and has
+  //! an empty name.
+  static Node Report();
+
+  /**
+   * Return the merged profile as a JSON array of the top-level scopes.  Each
+   * scope is an object with the keys "name", "calls", "time_us", "threads" and
+   * "children".
+   */
+  static std::string ToJSON();
+
+  //! Enter the scope with the given id on this thread, and return the node to
+  //! pass to Exit() (or NoNode).  Use MLPACK_PROFILE_SCOPE() instead.
+  static size_t Enter(const size_t id)
+  {
+    profiler::ThreadProfile& profile = LocalProfile();
+    profiler::ProfileNode& current = profile.nodes[profile.current];
+    if (current.id == id)
+    {
+      Increment(current.calls, 1);
+      return NoNode;
+    }
+
+    size_t child = NoNode;
+    for (size_t i = 0; i < current.children.size(); ++i)
+    {
+      if (profile.nodes[current.children[i]].id == id)
+      {
+        child = current.children[i];
+        break;
+      }
+    }
+
+    if (child == NoNode)
+    {
+      std::lock_guard<std::mutex> lock(profile.mutex);
+      child = profile.nodes.size();
+      profile.nodes.emplace_back(id, profile.current);
+      current.children.push_back(child);
+    }
+
+    profile.current = child;
+    return child;
+  }
+
+  //! Leave the given node on this thread, adding the given time.
+  static void Exit(const size_t node, const std::chrono::nanoseconds time)
+  {
+    profiler::ThreadProfile& profile = LocalProfile();
+    profiler::ProfileNode& n = profile.nodes[node];
+    Increment(n.calls, 1);
+    Increment(n.nanoseconds, (uint64_t) time.count());
+    profile.current = n.parent;
+  }
+
+ private:
+  //! Get whether profiling is enabled.
+  static std::atomic<bool>& EnabledFlag();
+
+  //! Get the profile of this thread.
+  static profiler::ThreadProfile& LocalProfile()
+  {
+    thread_local profiler::ThreadProfile* profile = AddThread();
+    return *profile;
+  }
+
+  //! Create and register the profile of a new thread.  The profile is owned by
+  //! the Profiler, so it outlives the thread.
+  static profiler::ThreadProfile* AddThread();
+
+  //! Add to a counter that only the calling thread writes.
+  static void Increment(std::atomic<uint64_t>& counter, const uint64_t value)
+  {
+    counter.store(counter.load(std::memory_order_relaxed) + value,
+        std::memory_order_relaxed);
+  }
+};
+
+/**
+ * A ProfileScope records the time from its construction to its destruction in
+ * the Profiler, under the given scope id.  Use MLPACK_PROFILE_SCOPE() instead
+ * of creating one directly.
+ */
+class ProfileScope
+{
+ public:
+  //! Enter the scope, if profiling is enabled.
+  ProfileScope(const size_t id) : node(Profiler::NoNode)
+  {
+    if (Profiler::Enabled())
+    {
+      node = Profiler::Enter(id);
+      if (node != Profiler::NoNode)
+        start = std::chrono::steady_clock::now();
+    }
+  }
+
+  //! Leave the scope.
+  ~ProfileScope()
+  {
+    if (node != Profiler::NoNode)
+      Profiler::Exit(node, std::chrono::steady_clock::now() - start);
+  }
+
+  //! A ProfileScope cannot be copied.
+  ProfileScope(const ProfileScope& other) = delete;
+  //! A ProfileScope cannot be copied.
+  ProfileScope& operator=(const ProfileScope& other) = delete;
+
+ private:
+  //! The node of the thread profile, or Profiler::NoNode.
+  size_t node;
+  //! When the scope was entered.
+  std::chrono::steady_clock::time_point start;
+};
+
+} // namespace mlpack
+
+#define MLPACK_PROFILE_CONCAT_INNER(A, B) A ## B
+#define MLPACK_PROFILE_CONCAT(A, B) MLPACK_PROFILE_CONCAT_INNER(A, B)
+
+/**
+ * Profile the rest of the enclosing block under the given name (a string).  The
+ * name is registered the first time the block is reached.
+ */
+#ifndef MLPACK_NO_PROFILING
+  #define MLPACK_PROFILE_SCOPE(NAME) \
+      static const size_t MLPACK_PROFILE_CONCAT(mlpackProfileId, __LINE__) = \
+          ::mlpack::Profiler::Register(NAME); \
+      ::mlpack::ProfileScope MLPACK_PROFILE_CONCAT(mlpackProfileScope, \
+          __LINE__)(MLPACK_PROFILE_CONCAT(mlpackProfileId, __LINE__))
+#else
+  #define MLPACK_PROFILE_SCOPE(NAME) static_cast<void>(0)
+#endif
+
+#endif
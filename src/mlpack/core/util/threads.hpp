@@ -0,0 +1,102 @@
+/**
+ * @file core/util/threads.hpp
+ *
+ * Control of the number of threads used by the parallel code of mlpack, which
+ * is written with OpenMP.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_UTIL_THREADS_HPP
+#define MLPACK_CORE_UTIL_THREADS_HPP
+
+#include <cstddef>
+
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
+namespace mlpack {
+namespace util {
+
+/**
+ * Return the number of threads that a parallel region should use for the given
+ * request: the request itself, or if it is 0, the current limit of the calling
+ * thread (the OpenMP default, or the limit of the innermost ThreadLimit).  This
+ * is always 1 if mlpack was compiled without OpenMP.
+ *
+ * @param threads Number of threads requested (0 for the current limit).
+ */
+inline size_t Threads(const size_t threads = 0)
+{
+#ifdef HAS_OPENMP
+  return (threads == 0) ? (size_t) omp_get_max_threads() : threads;
+#else
+  (void) threads;
+  return 1;
+#endif
+}
+
+/**
+ * ThreadLimit limits the parallel regions started by the calling thread to the
+ * given number of threads, for as long as the object lives; the previous limit
+ * is restored when it is destroyed.  Every mlpack algorithm that does not take
+ * its own number of threads uses this limit, so a call can be limited with
+ *
+ * @code
+ * {
+ *   util::ThreadLimit limit(4);
+ *   forest.Train(dataset, labels, numClasses);
+ * }
+ * @endcode
+ *
+ * The limit only applies to the calling thread, so several threads may call
+ * mlpack with different limits at once.  Nested parallel regions (for instance,
+ * a parallel algorithm called from the folds of a parallel cross-validation)
+ * run their inner regions with a single thread, unless nesting is enabled in
+ * OpenMP; and BLAS libraries that use OpenMP (such as the OpenMP build of
+ * OpenBLAS) also respect the limit, and run single-threaded inside the parallel
+ * regions of mlpack, so that the machine is not oversubscribed.
+ */
+class ThreadLimit
+{
+ public:
+  /**
+   * Limit the parallel regions of the calling thread to the given number of
+   * threads.
+   *
+   * @param threads Maximum number of threads (0 leaves the limit unchanged).
+   */
+  explicit ThreadLimit(const size_t threads) : previous(Threads())
+  {
+#ifdef HAS_OPENMP
+    if (threads != 0)
+      omp_set_num_threads((int) threads);
+#else
+    (void) threads;
+#endif
+  }
+
+  //! Restore the previous limit.
+  ~ThreadLimit()
+  {
+#ifdef HAS_OPENMP
+    omp_set_num_threads((int) previous);
+#endif
+  }
+
+  // A limit cannot be copied, since it would be restored twice.
+  ThreadLimit(const ThreadLimit&) = delete;
+  ThreadLimit& operator=(const ThreadLimit&) = delete;
+
+ private:
+  //! The limit before this one.
+  size_t previous;
+};
+
+} // namespace util
+} // namespace mlpack
+
+#endif
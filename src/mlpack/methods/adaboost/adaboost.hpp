@@ -31,6 +31,8 @@
 #include <mlpack/prereqs.hpp>
 #include <mlpack/methods/perceptron/perceptron.hpp>
 #include <mlpack/methods/decision_tree/decision_tree.hpp>
+#include <mlpack/methods/decision_stump/decision_stump.hpp>
+#include <mlpack/methods/decision_tree/quickscorer.hpp>
 
 namespace mlpack {
 namespace adaboost {
@@ -151,7 +153,9 @@ class AdaBoost
                const double tolerance = 1e-6);
 
   /**
-   * Classify the given test points.
+   * Classify the given test points.  The points are classified in blocks of
+   * BlockSize points, in parallel: the weighted votes of every weak learner
+   * for a block are accumulated in place before moving to the next block.
    *
    * @param test Testing data.
    * @param predictedLabels Vector in which the predicted labels of the test
@@ -173,6 +177,19 @@ class AdaBoost
   void Classify(const MatType& test,
                 arma::Row<size_t>& predictedLabels);
 
+  //! The number of points classified together by Classify().
+  static const size_t BlockSize = 256;
+
+  /**
+   * Replace the trees of the given scorer with the weak learners, weighted by
+   * their alpha, so that the scorer gives the same predictions as Classify().
+   * This is only available when the weak learners are decision trees with
+   * binary numeric splits, like ID3DecisionStump (see QuickScorer).
+   *
+   * @param scorer Scorer to store the model in.
+   */
+  void Compile(tree::QuickScorer& scorer) const;
+
   /**
    * Serialize the AdaBoost model.
    */
@@ -189,6 +206,56 @@ class AdaBoost
   std::vector<WeakLearnerType> wl;
   //! The weights corresponding to each weak learner.
   std::vector<double> alpha;
+
+  /**
+   * Accumulate the weighted votes of every weak learner for the given block of
+   * points, then normalize them into probabilities and store the prediction
+   * for each point.
+   *
+   * @param block Points to classify.
+   * @param learnerLabels Buffer for the predictions of one weak learner.
+   * @param votes Matrix of size numClasses x block.n_cols to accumulate the
+   *      votes in; it holds the class probabilities on return.
+   * @param predictions Vector of size block.n_cols to store the predictions
+   *      in.
+   */
+  void ClassifyBlock(const MatType& block,
+                     arma::Row<size_t>& learnerLabels,
+                     arma::mat& votes,
+                     arma::Row<size_t>& predictions);
+
+  /**
+   * Train the weak learner of one boosting round with the given weights.  The
+   * generic overload trains a copy of the given weak learner from scratch.
+   *
+   * @param other Weak learner to copy the parameters of.
+   * @param data Dataset to train on.
+   * @param sortedIndices Unused.
+   * @param labels Labels of the dataset.
+   * @param numClasses Number of classes.
+   * @param weights Weights of the points for this round.
+   */
+  template<typename LearnerType>
+  static LearnerType TrainWeakLearner(const LearnerType& other,
+                                      const MatType& data,
+                                      arma::umat& /* sortedIndices */,
+                                      const arma::Row<size_t>& labels,
+                                      const size_t numClasses,
+                                      const arma::rowvec& weights);
+
+  /**
+   * Train the decision stump of one boosting round with the given weights.
+   * The data doesn't change between rounds, so each dimension is sorted in
+   * the first round (when sortedIndices is empty) and the sort is reused in
+   * the later rounds.
+   */
+  static decision_stump::DecisionStump<MatType> TrainWeakLearner(
+      const decision_stump::DecisionStump<MatType>& other,
+      const MatType& data,
+      arma::umat& sortedIndices,
+      const arma::Row<size_t>& labels,
+      const size_t numClasses,
+      const arma::rowvec& weights);
 }; // class AdaBoost
 
 } // namespace adaboost
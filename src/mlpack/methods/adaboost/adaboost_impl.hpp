@@ -105,6 +105,10 @@ double AdaBoost<WeakLearnerType, MatType>::Train(
   // This is the final hypothesis.
   arma::Row<size_t> finalH(predictedLabels.n_cols);
 
+  // Weak learners that can reuse the sort of each dimension of the data over
+  // the boosting rounds keep it here.
+  arma::umat sortedIndices;
+
   // Now, start the boosting rounds.
   for (size_t i = 0; i < iterations; ++i)
   {
@@ -120,7 +124,8 @@ double AdaBoost<WeakLearnerType, MatType>::Train(
     weights = arma::sum(D);
 
     // Use the existing weak learner to train a new one with new weights.
-    WeakLearnerType w(other, tempData, labels, numClasses, weights);
+    WeakLearnerType w = TrainWeakLearner(other, tempData, sortedIndices,
+        labels, numClasses, weights);
     w.Classify(tempData, predictedLabels);
 
     // Now from predictedLabels, build ht, the weak hypothesis
@@ -202,6 +207,9 @@ double AdaBoost<WeakLearnerType, MatType>::Train(
   return ztProduct;
 }
 
+template<typename WeakLearnerType, typename MatType>
+const size_t AdaBoost<WeakLearnerType, MatType>::BlockSize;
+
 /**
  * Classify the given test points.
  */
@@ -210,10 +218,29 @@ void AdaBoost<WeakLearnerType, MatType>::Classify(
     const MatType& test,
     arma::Row<size_t>& predictedLabels)
 {
-  arma::Row<size_t> tempPredictedLabels(test.n_cols);
-  arma::mat probabilities;
+  predictedLabels.set_size(test.n_cols);
 
-  Classify(test, predictedLabels, probabilities);
+  // Only the votes of the block being classified are kept.
+  const omp_size_t numBlocks = (test.n_cols + BlockSize - 1) / BlockSize;
+  #pragma omp parallel
+  {
+    arma::Row<size_t> learnerLabels;
+    arma::mat votes;
+
+    #pragma omp for
+    for (omp_size_t b = 0; b < numBlocks; ++b)
+    {
+      const size_t begin = b * BlockSize;
+      const size_t count = std::min(BlockSize, (size_t) test.n_cols - begin);
+
+      const MatType block(const_cast<typename MatType::elem_type*>(
+          test.colptr(begin)), test.n_rows, count, false, true);
+      arma::Row<size_t> predictions(predictedLabels.memptr() + begin, count,
+          false, true);
+      votes.set_size(numClasses, count);
+      ClassifyBlock(block, learnerLabels, votes, predictions);
+    }
+  }
 }
 
 /**
@@ -225,31 +252,112 @@ void AdaBoost<WeakLearnerType, MatType>::Classify(
     arma::Row<size_t>& predictedLabels,
     arma::mat& probabilities)
 {
-  arma::Row<size_t> tempPredictedLabels(test.n_cols);
-
-  probabilities.zeros(numClasses, test.n_cols);
+  probabilities.set_size(numClasses, test.n_cols);
   predictedLabels.set_size(test.n_cols);
 
+  // The votes of each block are accumulated directly in the probabilities.
+  const omp_size_t numBlocks = (test.n_cols + BlockSize - 1) / BlockSize;
+  #pragma omp parallel
+  {
+    arma::Row<size_t> learnerLabels;
+
+    #pragma omp for
+    for (omp_size_t b = 0; b < numBlocks; ++b)
+    {
+      const size_t begin = b * BlockSize;
+      const size_t count = std::min(BlockSize, (size_t) test.n_cols - begin);
+
+      const MatType block(const_cast<typename MatType::elem_type*>(
+          test.colptr(begin)), test.n_rows, count, false, true);
+      arma::mat votes(probabilities.colptr(begin), numClasses, count, false,
+          true);
+      arma::Row<size_t> predictions(predictedLabels.memptr() + begin, count,
+          false, true);
+      ClassifyBlock(block, learnerLabels, votes, predictions);
+    }
+  }
+}
+
+/**
+ * Store the weak learners in a QuickScorer; each leaf votes for its majority
+ * class with the weight of its learner.
+ */
+template<typename WeakLearnerType, typename MatType>
+void AdaBoost<WeakLearnerType, MatType>::Compile(tree::QuickScorer& scorer)
+    const
+{
+  scorer.Clear();
+  for (size_t i = 0; i < wl.size(); ++i)
+    scorer.AddTree(wl[i], alpha[i], true);
+}
+
+/**
+ * Accumulate the weighted votes of the weak learners for a block of points.
+ */
+template<typename WeakLearnerType, typename MatType>
+void AdaBoost<WeakLearnerType, MatType>::ClassifyBlock(
+    const MatType& block,
+    arma::Row<size_t>& learnerLabels,
+    arma::mat& votes,
+    arma::Row<size_t>& predictions)
+{
+  // Not every weak learner sets the size of its predictions.
+  learnerLabels.set_size(block.n_cols);
+  votes.zeros();
+
   for (size_t i = 0; i < wl.size(); ++i)
   {
-    wl[i].Classify(test, tempPredictedLabels);
+    wl[i].Classify(block, learnerLabels);
 
-    for (size_t j = 0; j < tempPredictedLabels.n_cols; ++j)
-      probabilities(tempPredictedLabels(j), j) += alpha[i];
+    for (size_t j = 0; j < block.n_cols; ++j)
+      votes(learnerLabels(j), j) += alpha[i];
   }
 
-  arma::colvec pRow;
   arma::uword maxIndex = 0;
-
-  for (size_t i = 0; i < predictedLabels.n_cols; ++i)
+  for (size_t j = 0; j < block.n_cols; ++j)
   {
-    probabilities.col(i) /= arma::accu(probabilities.col(i));
-    pRow = probabilities.unsafe_col(i);
-    pRow.max(maxIndex);
-    predictedLabels(i) = maxIndex;
+    votes.col(j) /= arma::accu(votes.col(j));
+    votes.col(j).max(maxIndex);
+    predictions(j) = maxIndex;
   }
 }
 
+/**
+ * Train a copy of the given weak learner from scratch.
+ */
+template<typename WeakLearnerType, typename MatType>
+template<typename LearnerType>
+LearnerType AdaBoost<WeakLearnerType, MatType>::TrainWeakLearner(
+    const LearnerType& other,
+    const MatType& data,
+    arma::umat& /* sortedIndices */,
+    const arma::Row<size_t>& labels,
+    const size_t numClasses,
+    const arma::rowvec& weights)
+{
+  return LearnerType(other, data, labels, numClasses, weights);
+}
+
+/**
+ * Train a decision stump, sorting the data only in the first round.
+ */
+template<typename WeakLearnerType, typename MatType>
+decision_stump::DecisionStump<MatType>
+AdaBoost<WeakLearnerType, MatType>::TrainWeakLearner(
+    const decision_stump::DecisionStump<MatType>& other,
+    const MatType& data,
+    arma::umat& sortedIndices,
+    const arma::Row<size_t>& labels,
+    const size_t numClasses,
+    const arma::rowvec& weights)
+{
+  if (sortedIndices.is_empty())
+    decision_stump::DecisionStump<MatType>::SortDimensions(data, sortedIndices);
+
+  return decision_stump::DecisionStump<MatType>(other, data, sortedIndices,
+      labels, numClasses, weights);
+}
+
 /**
  * Serialize the AdaBoost model.
  */
@@ -0,0 +1,142 @@
+/**
+ * @file methods/amf/sgd_schedule.hpp
+ *
+ * Definition of the SGDSchedule class, which runs the epochs of a parallel
+ * stochastic gradient descent over the ratings of a matrix factorization
+ * without locks or atomic updates.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_AMF_SGD_SCHEDULE_HPP
+#define MLPACK_METHODS_AMF_SGD_SCHEDULE_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace amf {
+
+/**
+ * The SGDSchedule decides which thread visits which rating during an epoch of
+ * parallel SGD for a matrix factorization, so that the updates need no atomic
+ * operations.  It is used by the parallel SGD of RegularizedSVDFunction,
+ * BiasSVDFunction and SVDPlusPlusFunction, and by the AMF update rule
+ * SVDParallelIncrementalLearning.  Two schedules are available.
+ *
+ *  - STRATIFIED: the users and the items are split into B strata each, and
+ *    the ratings into the B x B blocks they define.  An epoch has B
+ *    sub-epochs; in each of them, B blocks which share no user and no item
+ *    are visited in parallel, so an update which only changes the parameters
+ *    of its user and its item never races with another one.  This is DSGD:
+ *
+ * @code
+ * @inproceedings{gemulla2011large,
+ *   title={Large-scale matrix factorization with distributed stochastic
+ *       gradient descent},
+ *   author={Gemulla, Rainer and Nijkamp, Erik and Haas, Peter J. and
+ *       Sismanis, Yannis},
+ *   booktitle={Proceedings of the 17th ACM SIGKDD International Conference on
+ *       Knowledge Discovery and Data Mining},
+ *   pages={69--77},
+ *   year={2011}
+ * }
+ * @endcode
+ *
+ *  - HOGWILD: the ratings are visited in parallel in any order, and the
+ *    updates are applied without synchronization, as in Hogwild! (Niu et al.,
+ *    2011).  It is meant for updates that also change parameters shared
+ *    between users, like the implicit item factors of SVD++, where the rare
+ *    conflicts are tolerated.
+ *
+ * In both schedules, the ratings are stored grouped by block (or in chunks of
+ * consecutive ratings, sorted by user), and each epoch shuffles the order of
+ * the blocks and the order of the ratings inside each block, so that the
+ * parameters a thread touches stay close together in memory.
+ *
+ * @code
+ * SGDSchedule schedule(SGDSchedule::STRATIFIED);
+ * schedule.Reset(data, numUsers, numItems);
+ * schedule.Epoch([&](const size_t i)
+ * {
+ *   // Update the parameters with rating i, i.e. data.col(i).
+ * });
+ * @endcode
+ */
+class SGDSchedule
+{
+ public:
+  //! The schedules of the ratings.
+  enum Mode
+  {
+    STRATIFIED,
+    HOGWILD
+  };
+
+  /**
+   * Create the schedule.
+   *
+   * @param mode How the ratings are split between threads.
+   * @param numBlocks Number of strata of the users and the items (STRATIFIED)
+   *     or number of ratings in each chunk (HOGWILD); if 0, the number of
+   *     OpenMP threads, or 1024 ratings, is used.
+   */
+  SGDSchedule(const Mode mode = STRATIFIED, const size_t numBlocks = 0);
+
+  /**
+   * Group the given ratings into blocks.
+   *
+   * @param data Ratings, one per column, with the user in the first row and
+   *     the item in the second row.
+   * @param numUsers Number of users.
+   * @param numItems Number of items.
+   */
+  void Reset(const arma::mat& data,
+             const size_t numUsers,
+             const size_t numItems);
+
+  /**
+   * Run an epoch: call the given function once with the index of each rating,
+   * from several threads.
+   *
+   * @param update Function called with the index of each rating.
+   * @param shuffle Whether to shuffle the order of the ratings.
+   */
+  template<typename UpdateFunctionType>
+  void Epoch(UpdateFunctionType&& update, const bool shuffle = true);
+
+  //! Get the schedule of the ratings.
+  Mode ScheduleMode() const { return mode; }
+
+  //! Get the number of strata (STRATIFIED) or chunks (HOGWILD).
+  size_t NumBlocks() const { return numBlocks; }
+
+ private:
+  //! Shuffle the ratings of the given block with the given seed, and visit
+  //! them.
+  template<typename UpdateFunctionType>
+  void VisitBlock(const size_t block,
+                  const size_t seed,
+                  const bool shuffle,
+                  UpdateFunctionType& update);
+
+  //! How the ratings are split between threads.
+  Mode mode;
+  //! The number of blocks requested by the user (0 for the default).
+  size_t requestedBlocks;
+  //! The number of strata or chunks.
+  size_t numBlocks;
+  //! The indices of the ratings, grouped by block.
+  std::vector<size_t> order;
+  //! The start of each block in order; block b is [starts[b], starts[b + 1]).
+  std::vector<size_t> starts;
+};
+
+} // namespace amf
+} // namespace mlpack
+
+// Include implementation.
+#include "sgd_schedule_impl.hpp"
+
+#endif
@@ -0,0 +1,170 @@
+/**
+ * @file methods/amf/sgd_schedule_impl.hpp
+ *
+ * Implementation of the SGDSchedule class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_AMF_SGD_SCHEDULE_IMPL_HPP
+#define MLPACK_METHODS_AMF_SGD_SCHEDULE_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "sgd_schedule.hpp"
+
+#include <random>
+
+namespace mlpack {
+namespace amf {
+
+inline SGDSchedule::SGDSchedule(const Mode mode, const size_t numBlocks) :
+    mode(mode),
+    requestedBlocks(numBlocks),
+    numBlocks(0)
+{
+  // Nothing to do.
+}
+
+inline void SGDSchedule::Reset(const arma::mat& data,
+                               const size_t numUsers,
+                               const size_t numItems)
+{
+  const size_t n = data.n_cols;
+  std::vector<size_t> cells(n);
+
+  if (mode == STRATIFIED)
+  {
+    #ifdef HAS_OPENMP
+    const size_t threads = (size_t) omp_get_max_threads();
+    #else
+    const size_t threads = 1;
+    #endif
+
+    numBlocks = (requestedBlocks == 0) ? threads : requestedBlocks;
+    numBlocks = std::max<size_t>(1, std::min(numBlocks,
+        std::min(numUsers, numItems)));
+
+    // Block (s, t) holds the ratings of the users of stratum s and the items
+    // of stratum t.
+    for (size_t i = 0; i < n; ++i)
+    {
+      const size_t userStratum = (size_t) data(0, i) * numBlocks / numUsers;
+      const size_t itemStratum = (size_t) data(1, i) * numBlocks / numItems;
+      cells[i] = userStratum * numBlocks + itemStratum;
+    }
+  }
+  else
+  {
+    // The ratings are sorted by user and cut into chunks of consecutive
+    // ratings.  The number of the chunk is only known once they are sorted.
+    for (size_t i = 0; i < n; ++i)
+      cells[i] = (size_t) data(0, i);
+  }
+
+  // Group the ratings with a counting sort, which keeps the ratings of each
+  // block in the order of the dataset.
+  const size_t numCells = (mode == STRATIFIED) ? numBlocks * numBlocks :
+      numUsers;
+  std::vector<size_t> counts(numCells + 1, 0);
+  for (size_t i = 0; i < n; ++i)
+    ++counts[cells[i] + 1];
+  for (size_t c = 0; c < numCells; ++c)
+    counts[c + 1] += counts[c];
+
+  order.resize(n);
+  for (size_t i = 0; i < n; ++i)
+    order[counts[cells[i]]++] = i;
+
+  if (mode == STRATIFIED)
+  {
+    // After the sort, counts[c] is the end of cell c.
+    starts.assign(numCells + 1, 0);
+    for (size_t c = 0; c < numCells; ++c)
+      starts[c + 1] = counts[c];
+  }
+  else
+  {
+    const size_t chunkSize = (requestedBlocks == 0) ? 1024 : requestedBlocks;
+    numBlocks = (n + chunkSize - 1) / chunkSize;
+    starts.resize(numBlocks + 1);
+    for (size_t b = 0; b <= numBlocks; ++b)
+      starts[b] = std::min(n, b * chunkSize);
+  }
+}
+
+template<typename UpdateFunctionType>
+void SGDSchedule::Epoch(UpdateFunctionType&& update, const bool shuffle)
+{
+  if (numBlocks == 0)
+    return;
+
+  if (mode == STRATIFIED)
+  {
+    // The item stratum visited with each user stratum in each sub-epoch is
+    // given by a random permutation, so the pairing changes between epochs.
+    std::vector<size_t> itemStrata(numBlocks);
+    for (size_t t = 0; t < numBlocks; ++t)
+      itemStrata[t] = t;
+    if (shuffle)
+      std::shuffle(itemStrata.begin(), itemStrata.end(), math::randGen);
+
+    std::vector<size_t> seeds(numBlocks);
+    for (size_t s = 0; s < numBlocks; ++s)
+    {
+      for (size_t t = 0; t < numBlocks; ++t)
+        seeds[t] = math::randGen();
+
+      // The blocks of one sub-epoch share no user and no item.
+      #pragma omp parallel for schedule(dynamic, 1)
+      for (omp_size_t t = 0; t < (omp_size_t) numBlocks; ++t)
+      {
+        const size_t block = t * numBlocks +
+            itemStrata[(t + s) % numBlocks];
+        VisitBlock(block, seeds[t], shuffle, update);
+      }
+    }
+  }
+  else
+  {
+    std::vector<size_t> chunks(numBlocks);
+    std::vector<size_t> seeds(numBlocks);
+    for (size_t b = 0; b < numBlocks; ++b)
+    {
+      chunks[b] = b;
+      seeds[b] = math::randGen();
+    }
+    if (shuffle)
+      std::shuffle(chunks.begin(), chunks.end(), math::randGen);
+
+    #pragma omp parallel for schedule(dynamic, 1)
+    for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+      VisitBlock(chunks[b], seeds[b], shuffle, update);
+  }
+}
+
+template<typename UpdateFunctionType>
+void SGDSchedule::VisitBlock(const size_t block,
+                             const size_t seed,
+                             const bool shuffle,
+                             UpdateFunctionType& update)
+{
+  const std::vector<size_t>::iterator begin = order.begin() + starts[block];
+  const std::vector<size_t>::iterator end = order.begin() +
+      starts[block + 1];
+
+  if (shuffle)
+  {
+    std::mt19937 generator(seed);
+    std::shuffle(begin, end, generator);
+  }
+
+  for (std::vector<size_t>::iterator it = begin; it != end; ++it)
+    update(*it);
+}
+
+} // namespace amf
+} // namespace mlpack
+
+#endif
@@ -71,7 +71,9 @@ class NMFMultiplicativeDistanceUpdate
                              arma::mat& W,
                              const arma::mat& H)
   {
-    W = (W % (V * H.t())) / (W * H * H.t());
+    // W H H^T is computed through the (small) Gram matrix of H, so W H is
+    // never formed; V H^T only visits the nonzeros of a sparse V.
+    W = (W % (V * H.t())) / (W * (H * H.t()));
   }
 
   /**
@@ -93,7 +95,7 @@ class NMFMultiplicativeDistanceUpdate
                              const arma::mat& W,
                              arma::mat& H)
   {
-    H = (H % (W.t() * V)) / (W.t() * W * H);
+    H = (H % (W.t() * V)) / ((W.t() * W) * H);
   }
 
   //! Serialize the object (in this case, there is nothing to serialize).
@@ -41,9 +41,14 @@ namespace amf {
  * is non-increasing between subsequent iterations. Both of the update rules
  * for W and H are defined in this file.
  *
- * This set of update rules is not meant to work with sparse matrices.  Using
- * sparse matrices often causes NaNs in the output, so other choices of update
- * rules are better in that situation.
+ * The ratios V / (W H) are only needed where V is nonzero, as the other
+ * entries contribute nothing to the updates.  For a sparse V, they are
+ * computed at the nonzero positions of V only, in parallel (a sampled dense
+ * matrix product), so W H is never formed and an update costs O(nnz(V) r).
+ * For a dense V, the ratios are computed for blocks of columns at a time, so
+ * only a slice of W H is held in memory.  An entry of W H that vanishes where
+ * V is nonzero still gives infinite ratios, so W and H should be initialized
+ * with positive values.
  */
 class NMFMultiplicativeDivergenceUpdate
 {
@@ -81,28 +86,37 @@ class NMFMultiplicativeDivergenceUpdate
                              arma::mat& W,
                              const arma::mat& H)
   {
-    // Simple implementation left in the header file.
-    arma::mat t1;
-    arma::rowvec t2;
-
-    t1 = W * H;
-    for (size_t i = 0; i < W.n_rows; ++i)
+    // Accumulate (V / (W H)) H^T over blocks of columns.
+    const size_t blockSize = BlockSize(V.n_rows);
+    arma::mat numerator(W.n_rows, W.n_cols, arma::fill::zeros);
+    for (size_t begin = 0; begin < V.n_cols; begin += blockSize)
     {
-      for (size_t j = 0; j < W.n_cols; ++j)
-      {
-        // Writing this as a single expression does not work as of Armadillo
-        // 3.920.  This should be fixed in a future release, and then the code
-        // below can be fixed.
-        // t2 = H.row(j) % V.row(i) / t1.row(i);
-        t2.set_size(H.n_cols);
-        for (size_t k = 0; k < t2.n_elem; ++k)
-        {
-          t2(k) = H(j, k) * V(i, k) / t1(i, k);
-        }
-
-        W(i, j) = W(i, j) * sum(t2) / sum(H.row(j));
-      }
+      const size_t end = std::min(begin + blockSize, (size_t) V.n_cols) - 1;
+      numerator += (V.cols(begin, end) / (W * H.cols(begin, end))) *
+          H.cols(begin, end).t();
     }
+
+    W %= numerator;
+    W.each_row() /= arma::sum(H, 1).t();
+  }
+
+  /**
+   * The update rule for the basis matrix W, for a sparse V.  The ratios
+   * V / (W H) are only computed at the nonzero positions of V.
+   *
+   * @param V Input matrix to be factorized.
+   * @param W Basis matrix to be updated.
+   * @param H Encoding matrix.
+   */
+  inline static void WUpdate(const arma::sp_mat& V,
+                             arma::mat& W,
+                             const arma::mat& H)
+  {
+    arma::sp_mat ratios;
+    Ratios(V, W, H, ratios);
+
+    W %= ratios * H.t();
+    W.each_row() /= arma::sum(H, 1).t();
   }
 
   /**
@@ -110,7 +124,7 @@ class NMFMultiplicativeDivergenceUpdate
    *
    * \f[
    * H_{a\mu} \leftarrow H_{a\mu} \frac{\sum_{i} W_{ia} V_{i\mu}/(WH)_{i\mu}}
-   * {\sum_{k} H_{ka}}
+   * {\sum_{k} W_{ka}}
    * \f]
    *
    * The function takes in all the matrices and only changes the value of the H
@@ -122,36 +136,78 @@ class NMFMultiplicativeDivergenceUpdate
    */
   template<typename MatType>
   inline static void HUpdate(const MatType& V,
+                             const arma::mat& W,
+                             arma::mat& H)
+  {
+    // Each block of columns of H only needs the same block of W H.
+    const size_t blockSize = BlockSize(V.n_rows);
+    for (size_t begin = 0; begin < V.n_cols; begin += blockSize)
+    {
+      const size_t end = std::min(begin + blockSize, (size_t) V.n_cols) - 1;
+      H.cols(begin, end) %= W.t() * (V.cols(begin, end) /
+          (W * H.cols(begin, end)));
+    }
+
+    H.each_col() /= arma::sum(W, 0).t();
+  }
+
+  /**
+   * The update rule for the encoding matrix H, for a sparse V.  The ratios
+   * V / (W H) are only computed at the nonzero positions of V.
+   *
+   * @param V Input matrix to be factorized.
+   * @param W Basis matrix.
+   * @param H Encoding matrix to updated.
+   */
+  inline static void HUpdate(const arma::sp_mat& V,
+                             const arma::mat& W,
+                             arma::mat& H)
+  {
+    arma::sp_mat ratios;
+    Ratios(V, W, H, ratios);
+
+    H %= W.t() * ratios;
+    H.each_col() /= arma::sum(W, 0).t();
+  }
+
+  //! Serialize the object (in this case, there is nothing to serialize).
+  template<typename Archive>
+  void serialize(Archive& /* ar */, const unsigned int /* version */) { }
+
+ private:
+  /**
+   * Compute V / (W H) at the nonzero positions of V.  The result has the same
+   * sparsity pattern as V.
+   */
+  inline static void Ratios(const arma::sp_mat& V,
                             const arma::mat& W,
-                            arma::mat& H)
+                            const arma::mat& H,
+                            arma::sp_mat& ratios)
   {
-    // Simple implementation left in the header file.
-    arma::mat t1;
-    arma::colvec t2;
+    V.sync();
+    const arma::mat wt = W.t();
+    arma::vec values(V.n_nonzero);
 
-    t1 = W * H;
-    for (size_t i = 0; i < H.n_rows; ++i)
+    #pragma omp parallel for schedule(dynamic, 64)
+    for (omp_size_t j = 0; j < (omp_size_t) V.n_cols; ++j)
     {
-      for (size_t j = 0; j < H.n_cols; ++j)
+      for (size_t k = V.col_ptrs[j]; k < V.col_ptrs[j + 1]; ++k)
       {
-        // Writing this as a single expression does not work as of Armadillo
-        // 3.920.  This should be fixed in a future release, and then the code
-        // below can be fixed.
-        // t2 = W.col(i) % V.col(j) / t1.col(j);
-        t2.set_size(W.n_rows);
-        for (size_t k = 0; k < t2.n_elem; ++k)
-        {
-          t2(k) = W(k, i) * V(k, j) / t1(k, j);
-        }
-
-        H(i, j) = H(i, j) * sum(t2) / sum(W.col(i));
+        values[k] = V.values[k] / arma::dot(wt.col(V.row_indices[k]),
+            H.col(j));
       }
     }
+
+    ratios = arma::sp_mat(arma::uvec(V.row_indices, V.n_nonzero),
+        arma::uvec(V.col_ptrs, V.n_cols + 1), values, V.n_rows, V.n_cols);
   }
 
-  //! Serialize the object (in this case, there is nothing to serialize).
-  template<typename Archive>
-  void serialize(Archive& /* ar */, const unsigned int /* version */) { }
+  //! The number of columns of W H computed at once for a dense V, so that a
+  //! block holds about a million elements.
+  inline static size_t BlockSize(const size_t rows)
+  {
+    return std::max<size_t>(1, (1 << 20) / std::max<size_t>(1, rows));
+  }
 };
 
 } // namespace amf
@@ -39,7 +39,11 @@ namespace amf
  * This approach differs from incomplete incremental learning where feature
  * vectors are updated after seeing columns of elements in the input matrix.
  *
- * @see SVDIncompleteIncrementalLearning
+ * Each call updates a single rating, so this rule runs serially;
+ * SVDParallelIncrementalLearning runs the same updates in parallel, one epoch
+ * per call.
+ *
+ * @see SVDIncompleteIncrementalLearning, SVDParallelIncrementalLearning
  */
 template <class MatType>
 class SVDCompleteIncrementalLearning
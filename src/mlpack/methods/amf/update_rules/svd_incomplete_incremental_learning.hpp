@@ -38,7 +38,10 @@ namespace amf
  * is also different: in incomplete incremental learning, regularization takes
  * into account the number of elements in a given column of V.
  *
- * @see SVDBatchLearning
+ * Each call updates a single user, so this rule runs serially; for a parallel
+ * factorization, see SVDParallelIncrementalLearning.
+ *
+ * @see SVDBatchLearning, SVDParallelIncrementalLearning
  */
 class SVDIncompleteIncrementalLearning
 {
@@ -166,19 +169,19 @@ template<>
 inline void SVDIncompleteIncrementalLearning::WUpdate<arma::sp_mat>(
     const arma::sp_mat& V, arma::mat& W, const arma::mat& H)
 {
-  arma::mat deltaW(V.n_rows, W.n_cols);
-  deltaW.zeros();
+  // The update of each row only depends on that row, so the rows of the rated
+  // items are updated in place, without a dense delta for all the items.
   for (arma::sp_mat::const_iterator it = V.begin_col(currentUserIndex);
       it != V.end_col(currentUserIndex); ++it)
   {
     double val = *it;
     size_t i = it.row();
-    deltaW.row(i) += (val - arma::dot(W.row(i), H.col(currentUserIndex))) *
-        arma::trans(H.col(currentUserIndex));
-    if (kw != 0) deltaW.row(i) -= kw * W.row(i);
-  }
+    arma::rowvec deltaW = (val - arma::dot(W.row(i),
+        H.col(currentUserIndex))) * arma::trans(H.col(currentUserIndex));
+    if (kw != 0) deltaW -= kw * W.row(i);
 
-  W += u*deltaW;
+    W.row(i) += u * deltaW;
+  }
 }
 
 template<>
@@ -193,11 +196,8 @@ inline void SVDIncompleteIncrementalLearning::HUpdate<arma::sp_mat>(
   {
     double val = *it;
     size_t i = it.row();
-    if ((val = V(i, currentUserIndex)) != 0)
-    {
-      deltaH += (val - arma::dot(W.row(i), H.col(currentUserIndex))) *
-          arma::trans(W.row(i));
-    }
+    deltaH += (val - arma::dot(W.row(i), H.col(currentUserIndex))) *
+        arma::trans(W.row(i));
   }
   if (kh != 0) deltaH -= kh * H.col(currentUserIndex);
 
@@ -0,0 +1,176 @@
+/**
+ * @file methods/amf/update_rules/svd_parallel_incremental_learning.hpp
+ *
+ * Parallel SVD factorizer used in AMF (Alternating Matrix Factorization).
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_AMF_SVD_PARALLEL_INCREMENTAL_LEARNING_HPP
+#define MLPACK_METHODS_AMF_SVD_PARALLEL_INCREMENTAL_LEARNING_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/methods/amf/sgd_schedule.hpp>
+
+namespace mlpack
+{
+namespace amf
+{
+
+/**
+ * This class computes SVD with the per-rating updates of incremental learning
+ * (see SVDCompleteIncrementalLearning), run in parallel by an SGDSchedule
+ * without locks or atomic updates.
+ *
+ * Each call to WUpdate() is one epoch over all the non-zero ratings of V that
+ * updates the item features in W, and each call to HUpdate() is one epoch that
+ * updates the user features in H.  The ratings of an epoch are visited in an
+ * order shuffled block by block, and with the default STRATIFIED schedule the
+ * blocks visited at the same time share no user and no item, so two threads
+ * never update the same row of W or the same column of H.
+ *
+ * Because one WUpdate()/HUpdate() pair covers every rating, the termination
+ * policies count epochs, so this rule is used with SimpleResidueTermination,
+ * MaxIterationTermination or ValidationRMSETermination directly, not through
+ * IncompleteIncrementalTermination or CompleteIncrementalTermination.
+ *
+ * @code
+ * AMF<SimpleResidueTermination, RandomInitialization,
+ *     SVDParallelIncrementalLearning> amf;
+ * amf.Apply(V, rank, W, H);
+ * @endcode
+ *
+ * @see SVDCompleteIncrementalLearning, SVDIncompleteIncrementalLearning
+ */
+class SVDParallelIncrementalLearning
+{
+ public:
+  /**
+   * Initialize the parameters of SVDParallelIncrementalLearning.
+   *
+   * @param u Step value used in incremental learning.
+   * @param kw Regularization constant for W matrix.
+   * @param kh Regularization constant for H matrix.
+   * @param mode How the ratings are split between threads.
+   * @param numBlocks Number of strata or chunks of the schedule; 0 for the
+   *     default (see SGDSchedule).
+   */
+  SVDParallelIncrementalLearning(
+      const double u = 0.001,
+      const double kw = 0,
+      const double kh = 0,
+      const SGDSchedule::Mode mode = SGDSchedule::STRATIFIED,
+      const size_t numBlocks = 0) :
+      u(u), kw(kw), kh(kh), schedule(mode, numBlocks)
+  {
+    // Nothing to do.
+  }
+
+  /**
+   * Initialize parameters before factorization.  This function must be called
+   * before a new factorization.  It collects the non-zero ratings of the input
+   * matrix and groups them into the blocks of the schedule.
+   *
+   * @param dataset Input matrix to be factorized.
+   * @param * (rank) Rank of factorization.
+   */
+  template<typename MatType>
+  void Initialize(const MatType& dataset, const size_t /* rank */)
+  {
+    Initialize(arma::sp_mat(dataset), 0);
+  }
+
+  /**
+   * Initialize parameters before factorizing the given sparse matrix.
+   *
+   * @param dataset Input matrix to be factorized.
+   * @param * (rank) Rank of factorization.
+   */
+  void Initialize(const arma::sp_mat& dataset, const size_t /* rank */)
+  {
+    // Each column holds the user, the item and the rating, as SGDSchedule
+    // expects.  Items are the rows of V, and users are the columns.
+    ratings.set_size(3, dataset.n_nonzero);
+    size_t i = 0;
+    for (arma::sp_mat::const_iterator it = dataset.begin();
+        it != dataset.end(); ++it, ++i)
+    {
+      ratings(0, i) = it.col();
+      ratings(1, i) = it.row();
+      ratings(2, i) = *it;
+    }
+
+    schedule.Reset(ratings, dataset.n_cols, dataset.n_rows);
+  }
+
+  /**
+   * The update rule for the basis matrix W: one epoch of SGD updates of the
+   * item features over all the ratings.
+   *
+   * @param * (V) Input matrix to be factorized.
+   * @param W Basis matrix to be updated.
+   * @param H Encoding matrix.
+   */
+  template<typename MatType>
+  inline void WUpdate(const MatType& /* V */,
+                      arma::mat& W,
+                      const arma::mat& H)
+  {
+    schedule.Epoch([&](const size_t r)
+    {
+      const size_t user = (size_t) ratings(0, r);
+      const size_t item = (size_t) ratings(1, r);
+      const double error = ratings(2, r) - arma::dot(W.row(item),
+          H.col(user));
+
+      W.row(item) += u * (error * H.col(user).t() - kw * W.row(item));
+    });
+  }
+
+  /**
+   * The update rule for the encoding matrix H: one epoch of SGD updates of the
+   * user features over all the ratings.
+   *
+   * @param * (V) Input matrix to be factorized.
+   * @param W Basis matrix.
+   * @param H Encoding matrix to be updated.
+   */
+  template<typename MatType>
+  inline void HUpdate(const MatType& /* V */,
+                      const arma::mat& W,
+                      arma::mat& H)
+  {
+    schedule.Epoch([&](const size_t r)
+    {
+      const size_t user = (size_t) ratings(0, r);
+      const size_t item = (size_t) ratings(1, r);
+      const double error = ratings(2, r) - arma::dot(W.row(item),
+          H.col(user));
+
+      H.col(user) += u * (error * W.row(item).t() - kh * H.col(user));
+    });
+  }
+
+  //! Get the schedule of the ratings.
+  const SGDSchedule& Schedule() const { return schedule; }
+
+ private:
+  //! Step size of incremental learning.
+  double u;
+  //! Regularization parameter for W matrix.
+  double kw;
+  //! Regularization parameter for H matrix.
+  double kh;
+
+  //! The non-zero ratings: user, item and rating in each column.
+  arma::mat ratings;
+  //! The schedule of the ratings between threads.
+  SGDSchedule schedule;
+};
+
+} // namespace amf
+} // namespace mlpack
+
+#endif
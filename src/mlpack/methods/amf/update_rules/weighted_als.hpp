@@ -0,0 +1,298 @@
+/**
+ * @file methods/amf/update_rules/weighted_als.hpp
+ *
+ * Weighted alternating least squares update rules for sparse rating matrices.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_AMF_UPDATE_RULES_WEIGHTED_ALS_HPP
+#define MLPACK_METHODS_AMF_UPDATE_RULES_WEIGHTED_ALS_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace amf {
+
+/**
+ * This class implements weighted alternating least squares for a sparse
+ * (item, user) rating matrix V.  Each column of H (and each row of W) is the
+ * solution of a rank x rank regularized least squares problem which only
+ * involves the nonzero ratings of that user (or item), so an update costs
+ * O(nnz(V) r^2 + (m + n) r^3) instead of the dense products of NMFALSUpdate.
+ * The problems are independent, and are solved in parallel with OpenMP.
+ *
+ * In the explicit mode, only the observed ratings are fitted, with the
+ * weighted-lambda regularization of ALS-WR:
+ *
+ * \f[
+ * \min_h \sum_{i \in R(u)} (V_{iu} - w_i^T h)^2 + \lambda |R(u)| \|h\|^2
+ * \f]
+ *
+ * In the implicit mode, V holds counts of interactions: every entry is fitted
+ * with a preference p = 1 if V_{iu} > 0 and p = 0 otherwise, and a confidence
+ * c = 1 + \alpha V_{iu}.  The sum over all the items is computed from the Gram
+ * matrix of the fixed factors, so only the nonzeros are visited:
+ *
+ * \f[
+ * h = (W^T W + \sum_{i \in R(u)} \alpha V_{iu} w_i w_i^T + \lambda I)^{-1}
+ *     \sum_{i \in R(u)} (1 + \alpha V_{iu}) w_i
+ * \f]
+ *
+ * @code
+ * @inproceedings{zhou2008large,
+ *   title={Large-scale parallel collaborative filtering for the Netflix
+ *       prize},
+ *   author={Zhou, Yunhong and Wilkinson, Dennis and Schreiber, Robert and
+ *       Pan, Rong},
+ *   booktitle={International Conference on Algorithmic Applications in
+ *       Management},
+ *   pages={337--348},
+ *   year={2008}
+ * }
+ *
+ * @inproceedings{hu2008collaborative,
+ *   title={Collaborative filtering for implicit feedback datasets},
+ *   author={Hu, Yifan and Koren, Yehuda and Volinsky, Chris},
+ *   booktitle={Eighth IEEE International Conference on Data Mining},
+ *   pages={263--272},
+ *   year={2008}
+ * }
+ * @endcode
+ *
+ * If cgIterations is positive, each problem is solved approximately with that
+ * many steps of the conjugate gradient method, started from the current value
+ * of the factor, instead of exactly with a dense solve.  The matrix of the
+ * problem is then never formed, and the cost per factor is
+ * O(cgIterations * (|R(u)| r + r^2)).  A few steps are enough, as described in
+ * the following paper:
+ *
+ * @code
+ * @inproceedings{takacs2011applications,
+ *   title={Applications of the conjugate gradient method for implicit
+ *       feedback collaborative filtering},
+ *   author={Tak{\'a}cs, G{\'a}bor and Pil{\'a}szy, Istv{\'a}n and Tikk,
+ *       Domonkos},
+ *   booktitle={Proceedings of the Fifth ACM Conference on Recommender
+ *       Systems},
+ *   pages={297--300},
+ *   year={2011}
+ * }
+ * @endcode
+ *
+ * The rows of W need the ratings of each item, so Initialize() stores the
+ * transpose of V.  The factors are not constrained to be non-negative.  With
+ * large matrices, MaxIterationTermination should be preferred to the
+ * termination policies that compute the residue W * H.
+ */
+class WeightedALSUpdate
+{
+ public:
+  /**
+   * Create the update rule with the given parameters.
+   *
+   * @param lambda Regularization constant.
+   * @param implicit Whether V holds implicit feedback.
+   * @param alpha Confidence scale of the implicit feedback.
+   * @param cgIterations Number of conjugate gradient steps for each factor; if
+   *     0, the problems are solved exactly.
+   */
+  WeightedALSUpdate(const double lambda = 0.1,
+                    const bool implicit = false,
+                    const double alpha = 40.0,
+                    const size_t cgIterations = 0) :
+      lambda(lambda),
+      implicit(implicit),
+      alpha(alpha),
+      cgIterations(cgIterations)
+  {
+    if (lambda < 0.0 || alpha < 0.0)
+    {
+      throw std::invalid_argument("WeightedALSUpdate::WeightedALSUpdate(): "
+          "lambda and alpha must be non-negative!");
+    }
+  }
+
+  /**
+   * Set initial values for the factorization.  The transpose of the dataset
+   * is stored, so that the ratings of each item can be read as a column.
+   *
+   * @param dataset Input matrix to be factorized.
+   * @param * (rank) Rank of factorization.
+   */
+  void Initialize(const arma::sp_mat& dataset, const size_t /* rank */)
+  {
+    transposed = dataset.t();
+  }
+
+  /**
+   * The update rule for the basis matrix W: each row of W is solved for from
+   * the ratings of its item, with H fixed.
+   *
+   * @param * (V) Input matrix to be factorized.
+   * @param W Basis matrix to be updated.
+   * @param H Encoding matrix.
+   */
+  void WUpdate(const arma::sp_mat& /* V */,
+               arma::mat& W,
+               const arma::mat& H)
+  {
+    arma::mat factors = W.t();
+    Solve(transposed, H, factors);
+    W = factors.t();
+  }
+
+  /**
+   * The update rule for the encoding matrix H: each column of H is solved for
+   * from the ratings of its user, with W fixed.
+   *
+   * @param V Input matrix to be factorized.
+   * @param W Basis matrix.
+   * @param H Encoding matrix to be updated.
+   */
+  void HUpdate(const arma::sp_mat& V,
+               const arma::mat& W,
+               arma::mat& H)
+  {
+    const arma::mat fixed = W.t();
+    Solve(V, fixed, H);
+  }
+
+  //! Get the regularization constant.
+  double Lambda() const { return lambda; }
+  //! Modify the regularization constant.
+  double& Lambda() { return lambda; }
+
+  //! Get whether the ratings are implicit feedback.
+  bool Implicit() const { return implicit; }
+  //! Modify whether the ratings are implicit feedback.
+  bool& Implicit() { return implicit; }
+
+  //! Get the confidence scale of the implicit feedback.
+  double Alpha() const { return alpha; }
+  //! Modify the confidence scale of the implicit feedback.
+  double& Alpha() { return alpha; }
+
+  //! Get the number of conjugate gradient steps (0 for exact solves).
+  size_t CGIterations() const { return cgIterations; }
+  //! Modify the number of conjugate gradient steps (0 for exact solves).
+  size_t& CGIterations() { return cgIterations; }
+
+  //! Serialize the parameters of the update rule.
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */)
+  {
+    ar & BOOST_SERIALIZATION_NVP(lambda);
+    ar & BOOST_SERIALIZATION_NVP(implicit);
+    ar & BOOST_SERIALIZATION_NVP(alpha);
+    ar & BOOST_SERIALIZATION_NVP(cgIterations);
+  }
+
+ private:
+  /**
+   * Solve the least squares problem of each column of factors, with the given
+   * fixed factors.  Row i of ratings corresponds to column i of fixed.
+   *
+   * @param ratings Sparse ratings; column j holds the ratings of factor j.
+   * @param fixed The fixed factors, one per column.
+   * @param factors The factors to update, one per column.
+   */
+  void Solve(const arma::sp_mat& ratings,
+             const arma::mat& fixed,
+             arma::mat& factors) const
+  {
+    const size_t rank = fixed.n_rows;
+    const arma::mat gram = implicit ? arma::mat(fixed * fixed.t()) :
+        arma::mat(rank, rank, arma::fill::zeros);
+
+    #pragma omp parallel for schedule(dynamic, 64)
+    for (omp_size_t j = 0; j < (omp_size_t) ratings.n_cols; ++j)
+    {
+      const size_t support = ratings.col(j).n_nonzero;
+      if (support == 0 && !implicit)
+      {
+        // Nothing is known about this factor; the regularization makes it 0.
+        factors.col(j).zeros();
+        continue;
+      }
+
+      // The regularization of the problem.
+      const double reg = implicit ? lambda : lambda * support;
+
+      // The right-hand side of the problem.
+      arma::vec b(rank, arma::fill::zeros);
+      arma::sp_mat::const_iterator it = ratings.begin_col(j);
+      for (; it != ratings.end_col(j); ++it)
+      {
+        const double weight = implicit ? 1.0 + alpha * (*it) : (*it);
+        b += weight * fixed.col(it.row());
+      }
+
+      if (cgIterations == 0)
+      {
+        arma::mat a = gram;
+        a.diag() += reg;
+        for (it = ratings.begin_col(j); it != ratings.end_col(j); ++it)
+        {
+          const double weight = implicit ? alpha * (*it) : 1.0;
+          a += weight * fixed.col(it.row()) * fixed.col(it.row()).t();
+        }
+
+        factors.col(j) = arma::solve(a, b);
+        continue;
+      }
+
+      // Conjugate gradient, started from the current factor; A * p is
+      // computed from the nonzeros without forming A.
+      arma::vec x = factors.col(j);
+      arma::vec ap(rank);
+      auto multiply = [&](const arma::vec& p)
+      {
+        ap = gram * p + reg * p;
+        arma::sp_mat::const_iterator i = ratings.begin_col(j);
+        for (; i != ratings.end_col(j); ++i)
+        {
+          const double weight = implicit ? alpha * (*i) : 1.0;
+          ap += (weight * arma::dot(fixed.col(i.row()), p)) *
+              fixed.col(i.row());
+        }
+      };
+
+      multiply(x);
+      arma::vec r = b - ap;
+      arma::vec p = r;
+      double rs = arma::dot(r, r);
+      for (size_t k = 0; k < cgIterations && rs > 1e-20; ++k)
+      {
+        multiply(p);
+        const double step = rs / arma::dot(p, ap);
+        x += step * p;
+        r -= step * ap;
+
+        const double newRs = arma::dot(r, r);
+        p = r + (newRs / rs) * p;
+        rs = newRs;
+      }
+
+      factors.col(j) = x;
+    }
+  }
+
+  //! Regularization constant.
+  double lambda;
+  //! Whether the ratings are implicit feedback.
+  bool implicit;
+  //! Confidence scale of the implicit feedback.
+  double alpha;
+  //! Number of conjugate gradient steps for each factor.
+  size_t cgIterations;
+  //! The transpose of the dataset, whose columns are the ratings of the items.
+  arma::sp_mat transposed;
+}; // class WeightedALSUpdate
+
+} // namespace amf
+} // namespace mlpack
+
+#endif
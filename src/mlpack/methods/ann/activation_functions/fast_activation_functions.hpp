@@ -0,0 +1,355 @@
+/**
+ * @file methods/ann/activation_functions/fast_activation_functions.hpp
+ *
+ * Definition and implementation of the fast logistic, tanh, swish, GELU and
+ * Mish functions, which are computed with a precision policy in loops that can
+ * be vectorized.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_ACTIVATION_FUNCTIONS_FAST_ACTIVATION_FUNCTIONS_HPP
+#define MLPACK_METHODS_ANN_ACTIVATION_FUNCTIONS_FAST_ACTIVATION_FUNCTIONS_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "precision_policies.hpp"
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * Apply the given scalar function to each element of a dense matrix or cube,
+ * in a single pass over its memory.  The input and the output may be the same
+ * object.
+ *
+ * @param x Input data.
+ * @param y The resulting values.
+ * @param f The scalar function.
+ */
+template<typename InputVecType, typename OutputVecType, typename FunctionType>
+inline void ApplyElementwise(const InputVecType& x,
+                             OutputVecType& y,
+                             const FunctionType& f)
+{
+  typedef typename OutputVecType::elem_type eT;
+
+  y.set_size(arma::size(x));
+  const typename InputVecType::elem_type* in = x.memptr();
+  eT* out = y.memptr();
+  const size_t n = x.n_elem;
+
+  #if defined(_OPENMP) && (_OPENMP >= 201307)
+  #pragma omp simd
+  #endif
+  for (size_t i = 0; i < n; ++i)
+    out[i] = eT(f(in[i]));
+}
+
+/**
+ * The fast version of the logistic function, f(x) = 1 / (1 + e^{-x}), whose
+ * derivative is computed from the output, f'(x) = f(x) * (1 - f(x)).
+ *
+ * @tparam PrecisionPolicy The policy giving the exponential (FastPrecision or
+ *     AccuratePrecision).
+ */
+template<typename PrecisionPolicy = FastPrecision>
+class FastLogisticFunction
+{
+ public:
+  /**
+   * Computes the logistic function.
+   *
+   * @param x Input data.
+   * @return f(x).
+   */
+  static double Fn(const double x)
+  {
+    return 1.0 / (1.0 + PrecisionPolicy::Exp(-x));
+  }
+
+  /**
+   * Computes the logistic function.
+   *
+   * @param x Input data.
+   * @param y The resulting output activation.
+   */
+  template<typename InputVecType, typename OutputVecType>
+  static void Fn(const InputVecType& x, OutputVecType& y)
+  {
+    ApplyElementwise(x, y, [](const double v) { return Fn(v); });
+  }
+
+  /**
+   * Computes the first derivative of the logistic function.
+   *
+   * @param y Output of the logistic function.
+   * @return f'(x)
+   */
+  static double Deriv(const double y)
+  {
+    return y * (1.0 - y);
+  }
+
+  /**
+   * Computes the first derivatives of the logistic function.
+   *
+   * @param y Outputs of the logistic function.
+   * @param x The resulting derivatives.
+   */
+  template<typename InputVecType, typename OutputVecType>
+  static void Deriv(const InputVecType& y, OutputVecType& x)
+  {
+    ApplyElementwise(y, x, [](const double v) { return Deriv(v); });
+  }
+}; // class FastLogisticFunction
+
+/**
+ * The fast version of the tanh function, whose derivative is computed from the
+ * output, f'(x) = 1 - f(x)^2.
+ *
+ * @tparam PrecisionPolicy The policy giving the hyperbolic tangent
+ *     (FastPrecision or AccuratePrecision).
+ */
+template<typename PrecisionPolicy = FastPrecision>
+class FastTanhFunction
+{
+ public:
+  /**
+   * Computes the tanh function.
+   *
+   * @param x Input data.
+   * @return f(x).
+   */
+  static double Fn(const double x)
+  {
+    return PrecisionPolicy::Tanh(x);
+  }
+
+  /**
+   * Computes the tanh function.
+   *
+   * @param x Input data.
+   * @param y The resulting output activation.
+   */
+  template<typename InputVecType, typename OutputVecType>
+  static void Fn(const InputVecType& x, OutputVecType& y)
+  {
+    ApplyElementwise(x, y, [](const double v) { return Fn(v); });
+  }
+
+  /**
+   * Computes the first derivative of the tanh function.
+   *
+   * @param y Output of the tanh function.
+   * @return f'(x)
+   */
+  static double Deriv(const double y)
+  {
+    return 1.0 - y * y;
+  }
+
+  /**
+   * Computes the first derivatives of the tanh function.
+   *
+   * @param y Outputs of the tanh function.
+   * @param x The resulting derivatives.
+   */
+  template<typename InputVecType, typename OutputVecType>
+  static void Deriv(const InputVecType& y, OutputVecType& x)
+  {
+    ApplyElementwise(y, x, [](const double v) { return Deriv(v); });
+  }
+}; // class FastTanhFunction
+
+/**
+ * The fast version of the swish function, f(x) = x / (1 + e^{-x}).  Like
+ * SwishFunction, the derivative is evaluated at the given values.
+ *
+ * @tparam PrecisionPolicy The policy giving the exponential (FastPrecision or
+ *     AccuratePrecision).
+ */
+template<typename PrecisionPolicy = FastPrecision>
+class FastSwishFunction
+{
+ public:
+  /**
+   * Computes the swish function.
+   *
+   * @param x Input data.
+   * @return f(x).
+   */
+  static double Fn(const double x)
+  {
+    return x / (1.0 + PrecisionPolicy::Exp(-x));
+  }
+
+  /**
+   * Computes the swish function.
+   *
+   * @param x Input data.
+   * @param y The resulting output activation.
+   */
+  template<typename InputVecType, typename OutputVecType>
+  static void Fn(const InputVecType& x, OutputVecType& y)
+  {
+    ApplyElementwise(x, y, [](const double v) { return Fn(v); });
+  }
+
+  /**
+   * Computes the first derivative of the swish function.
+   *
+   * @param y Input data.
+   * @return f'(x)
+   */
+  static double Deriv(const double y)
+  {
+    const double s = 1.0 / (1.0 + PrecisionPolicy::Exp(-y));
+    return y * s + (1.0 - y * s) * s;
+  }
+
+  /**
+   * Computes the first derivatives of the swish function.
+   *
+   * @param y Input data.
+   * @param x The resulting derivatives.
+   */
+  template<typename InputVecType, typename OutputVecType>
+  static void Deriv(const InputVecType& y, OutputVecType& x)
+  {
+    ApplyElementwise(y, x, [](const double v) { return Deriv(v); });
+  }
+}; // class FastSwishFunction
+
+/**
+ * The fast version of the GELU function,
+ * f(x) = 0.5 * x * {1 + tanh[(2/pi)^(1/2) * (x + 0.044715 * x^3)]}.  Like
+ * GELUFunction, the derivative is evaluated at the given values.
+ *
+ * @tparam PrecisionPolicy The policy giving the hyperbolic tangent
+ *     (FastPrecision or AccuratePrecision).
+ */
+template<typename PrecisionPolicy = FastPrecision>
+class FastGELUFunction
+{
+ public:
+  /**
+   * Computes the GELU function.
+   *
+   * @param x Input data.
+   * @return f(x).
+   */
+  static double Fn(const double x)
+  {
+    return 0.5 * x * (1.0 + PrecisionPolicy::Tanh(0.7978845608028654 *
+        (x + 0.044715 * x * x * x)));
+  }
+
+  /**
+   * Computes the GELU function.
+   *
+   * @param x Input data.
+   * @param y The resulting output activation.
+   */
+  template<typename InputVecType, typename OutputVecType>
+  static void Fn(const InputVecType& x, OutputVecType& y)
+  {
+    ApplyElementwise(x, y, [](const double v) { return Fn(v); });
+  }
+
+  /**
+   * Computes the first derivative of the GELU function.
+   *
+   * @param y Input data.
+   * @return f'(x)
+   */
+  static double Deriv(const double y)
+  {
+    const double y3 = y * y * y;
+    const double t = PrecisionPolicy::Tanh(0.0356774 * y3 + 0.797885 * y);
+    return 0.5 * t + (0.0535161 * y3 + 0.398942 * y) * (1.0 - t * t) + 0.5;
+  }
+
+  /**
+   * Computes the first derivatives of the GELU function.
+   *
+   * @param y Input data.
+   * @param x The resulting derivatives.
+   */
+  template<typename InputVecType, typename OutputVecType>
+  static void Deriv(const InputVecType& y, OutputVecType& x)
+  {
+    ApplyElementwise(y, x, [](const double v) { return Deriv(v); });
+  }
+}; // class FastGELUFunction
+
+/**
+ * The fast version of the Mish function, f(x) = x * tanh(ln(1 + e^x)).  Like
+ * MishFunction, the derivative is evaluated at the given values.  Beyond
+ * x = 20, tanh(ln(1 + e^x)) is 1 in double precision, so the exponential is
+ * clamped there and never overflows.
+ *
+ * @tparam PrecisionPolicy The policy giving the exponential (FastPrecision or
+ *     AccuratePrecision).
+ */
+template<typename PrecisionPolicy = FastPrecision>
+class FastMishFunction
+{
+ public:
+  /**
+   * Computes the Mish function.
+   *
+   * @param x Input data.
+   * @return f(x).
+   */
+  static double Fn(const double x)
+  {
+    const double e = PrecisionPolicy::Exp(std::min(x, 20.0));
+    const double n = e * (e + 2.0);
+    return x * n / (n + 2.0);
+  }
+
+  /**
+   * Computes the Mish function.
+   *
+   * @param x Input data.
+   * @param y The resulting output activation.
+   */
+  template<typename InputVecType, typename OutputVecType>
+  static void Fn(const InputVecType& x, OutputVecType& y)
+  {
+    ApplyElementwise(x, y, [](const double v) { return Fn(v); });
+  }
+
+  /**
+   * Computes the first derivative of the Mish function.
+   *
+   * @param y Input data.
+   * @return f'(x)
+   */
+  static double Deriv(const double y)
+  {
+    const double e = PrecisionPolicy::Exp(std::min(y, 20.0));
+    const double d = e * (e + 2.0) + 2.0;
+    return e * (4.0 * (y + 1.0) + e * (4.0 * y + 6.0) + e * e * (4.0 + e)) /
+        (d * d);
+  }
+
+  /**
+   * Computes the first derivatives of the Mish function.
+   *
+   * @param y Input data.
+   * @param x The resulting derivatives.
+   */
+  template<typename InputVecType, typename OutputVecType>
+  static void Deriv(const InputVecType& y, OutputVecType& x)
+  {
+    ApplyElementwise(y, x, [](const double v) { return Deriv(v); });
+  }
+}; // class FastMishFunction
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
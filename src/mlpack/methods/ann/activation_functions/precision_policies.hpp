@@ -0,0 +1,84 @@
+/**
+ * @file methods/ann/activation_functions/precision_policies.hpp
+ *
+ * Definition of the precision policies of the fast activation functions, which
+ * provide the exponential and the hyperbolic tangent they are computed with.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_ACTIVATION_FUNCTIONS_PRECISION_POLICIES_HPP
+#define MLPACK_METHODS_ANN_ACTIVATION_FUNCTIONS_PRECISION_POLICIES_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <cstring>
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * The AccuratePrecision policy computes the exponential and the hyperbolic
+ * tangent with the functions of the standard library.
+ */
+class AccuratePrecision
+{
+ public:
+  //! Compute e^x.
+  static double Exp(const double x) { return std::exp(x); }
+
+  //! Compute tanh(x).
+  static double Tanh(const double x) { return std::tanh(x); }
+};
+
+/**
+ * The FastPrecision policy computes the exponential and the hyperbolic tangent
+ * with branch-free polynomial approximations, so that the loops of the fast
+ * activation functions can be vectorized by the compiler.  The relative error
+ * of both functions is below 1e-7.
+ *
+ * The argument of the exponential is reduced to x = n ln(2) + r, with
+ * |r| <= ln(2) / 2, and e^x = 2^n e^r, where e^r is given by its Taylor series
+ * of degree 7 and 2^n is built from the exponent bits.  Arguments beyond
+ * +/- 708 are clamped, so the result is always a normal number.
+ */
+class FastPrecision
+{
+ public:
+  //! Compute an approximation of e^x.
+  static double Exp(const double x)
+  {
+    const double v = std::min(std::max(x, -708.0), 708.0);
+    const double n = std::floor(v * 1.4426950408889634 + 0.5);
+
+    // ln(2) is split in two parts, so that n * ln2Hi is exact.
+    const double r = (v - n * 0.693145751953125) -
+        n * 1.42860682030941723212e-6;
+    const double p = 1.0 + r * (1.0 + r * (1.0 / 2 + r * (1.0 / 6 +
+        r * (1.0 / 24 + r * (1.0 / 120 + r * (1.0 / 720 + r / 5040))))));
+
+    const int64_t bits = (int64_t(n) + 1023) << 52;
+    double scale;
+    std::memcpy(&scale, &bits, sizeof(double));
+    return p * scale;
+  }
+
+  //! Compute an approximation of tanh(x).
+  static double Tanh(const double x)
+  {
+    // Near zero, 1 - e^{-2|x|} cancels, and the Taylor series of degree 9 is
+    // used instead.
+    const double a = std::abs(x);
+    const double a2 = a * a;
+    const double e = Exp(-2.0 * a);
+    const double t = (a < 0.1) ? a * (1.0 + a2 * (-1.0 / 3 + a2 * (2.0 / 15 +
+        a2 * (-17.0 / 315 + a2 * (62.0 / 2835))))) : (1.0 - e) / (1.0 + e);
+    return (x < 0) ? -t : t;
+  }
+};
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
@@ -57,7 +57,8 @@ class RectifierFunction
   }
 
   /**
-   * Computes the rectifier function using a dense matrix as input.
+   * Computes the rectifier function using a dense matrix as input.  The
+   * output may use the memory of the input.
    *
    * @param x Input data.
    * @param y The resulting output activation.
@@ -65,8 +66,7 @@ class RectifierFunction
   template<typename eT>
   static void Fn(const arma::Mat<eT>& x, arma::Mat<eT>& y)
   {
-    y.zeros(x.n_rows, x.n_cols);
-    y = arma::max(y, x);
+    y = arma::clamp(x, eT(0), arma::Datum<eT>::inf);
   }
 
   /**
@@ -55,6 +55,11 @@ class BRNN
                            InitializationRuleType,
                            CustomLayers...>;
 
+  //! Convenience typedef for the RNN of each direction.
+  using RNNType = RNN<OutputLayerType,
+                      InitializationRuleType,
+                      CustomLayers...>;
+
   /**
    * Create the BRNN object.
    *
@@ -405,14 +410,11 @@ class BRNN
   //! The current gradient for the gradient pass for backward RNN.
   arma::mat backwardGradient;
 
-  //! The total gradient from each gradient pass.
-  arma::mat totalGradient;
-
   //! Forward RNN
-  RNN<OutputLayerType, InitializationRuleType, CustomLayers...> forwardRNN;
+  RNNType forwardRNN;
 
   //! Backward RNN
-  RNN<OutputLayerType, InitializationRuleType, CustomLayers...> backwardRNN;
+  RNNType backwardRNN;
 }; // class BRNN
 
 } // namespace ann
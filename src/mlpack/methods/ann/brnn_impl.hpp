@@ -223,19 +223,22 @@ void BRNN<OutputLayerType, MergeLayerType, MergeOutputType,
   {
     const size_t effectiveBatchSize = std::min(batchSize,
         size_t(predictors.n_cols - begin));
-    for (size_t seqNum = 0; seqNum < rho; ++seqNum)
+    // The two directions are independent until the merge layer.
+    #pragma omp parallel for
+    for (omp_size_t direction = 0; direction < 2; ++direction)
     {
-      forwardRNN.Forward(arma::mat(
-          predictors.slice(seqNum).colptr(begin),
-          predictors.n_rows, effectiveBatchSize, false, true));
-      backwardRNN.Forward(std::move(arma::mat(
-          predictors.slice(rho - seqNum - 1).colptr(begin),
-          predictors.n_rows, effectiveBatchSize, false, true)));
-
-      boost::apply_visitor(SaveOutputParameterVisitor(results1),
-          forwardRNN.network.back());
-      boost::apply_visitor(SaveOutputParameterVisitor(results2),
-          backwardRNN.network.back());
+      RNNType& rnn = (direction == 0) ? forwardRNN : backwardRNN;
+      std::vector<arma::mat>& rnnResults = (direction == 0) ? results1 :
+          results2;
+      for (size_t seqNum = 0; seqNum < rho; ++seqNum)
+      {
+        const size_t step = (direction == 0) ? seqNum : rho - seqNum - 1;
+        rnn.Forward(arma::mat(predictors.slice(step).colptr(begin),
+            predictors.n_rows, effectiveBatchSize, false, true));
+
+        boost::apply_visitor(SaveOutputParameterVisitor(rnnResults),
+            rnn.network.back());
+      }
     }
     reverse(results1.begin(), results1.end());
 
@@ -300,19 +303,23 @@ double BRNN<OutputLayerType, MergeLayerType, MergeOutputType,
   size_t responseSeq = 0;
 
   std::vector<arma::mat> results1, results2;
-  for (size_t seqNum = 0; seqNum < rho; ++seqNum)
+
+  // The two directions are independent until the merge layer.
+  #pragma omp parallel for
+  for (omp_size_t direction = 0; direction < 2; ++direction)
   {
-    forwardRNN.Forward(arma::mat(
-        predictors.slice(seqNum).colptr(begin),
-        predictors.n_rows, batchSize, false, true));
-    backwardRNN.Forward(arma::mat(
-        predictors.slice(rho - seqNum - 1).colptr(begin),
-        predictors.n_rows, batchSize, false, true));
-
-    boost::apply_visitor(SaveOutputParameterVisitor(results1),
-        forwardRNN.network.back());
-    boost::apply_visitor(SaveOutputParameterVisitor(results2),
-        backwardRNN.network.back());
+    RNNType& rnn = (direction == 0) ? forwardRNN : backwardRNN;
+    std::vector<arma::mat>& rnnResults = (direction == 0) ? results1 :
+        results2;
+    for (size_t seqNum = 0; seqNum < rho; ++seqNum)
+    {
+      const size_t step = (direction == 0) ? seqNum : rho - seqNum - 1;
+      rnn.Forward(arma::mat(predictors.slice(step).colptr(begin),
+          predictors.n_rows, batchSize, false, true));
+
+      boost::apply_visitor(SaveOutputParameterVisitor(rnnResults),
+          rnn.network.back());
+    }
   }
   if (outputSize == 0)
   {
@@ -418,26 +425,28 @@ EvaluateWithGradient(const arma::mat& /* parameters */,
 
   // Forward propogation from both directions.
   std::vector<arma::mat> results1, results2;
-  for (size_t seqNum = 0; seqNum < rho; ++seqNum)
+  #pragma omp parallel for
+  for (omp_size_t direction = 0; direction < 2; ++direction)
   {
-    forwardRNN.Forward(arma::mat(
-        predictors.slice(seqNum).colptr(begin),
-        predictors.n_rows, batchSize, false, true));
-    backwardRNN.Forward(arma::mat(
-        predictors.slice(rho - seqNum - 1).colptr(begin),
-        predictors.n_rows, batchSize, false, true));
-
-    for (size_t l = 0; l < networkSize; ++l)
+    RNNType& rnn = (direction == 0) ? forwardRNN : backwardRNN;
+    std::vector<arma::mat>& rnnOutputParameter = (direction == 0) ?
+        forwardRNNOutputParameter : backwardRNNOutputParameter;
+    std::vector<arma::mat>& rnnResults = (direction == 0) ? results1 :
+        results2;
+    for (size_t seqNum = 0; seqNum < rho; ++seqNum)
     {
-      boost::apply_visitor(SaveOutputParameterVisitor(
-          forwardRNNOutputParameter), forwardRNN.network[l]);
-      boost::apply_visitor(SaveOutputParameterVisitor(
-          backwardRNNOutputParameter), backwardRNN.network[l]);
+      const size_t step = (direction == 0) ? seqNum : rho - seqNum - 1;
+      rnn.Forward(arma::mat(predictors.slice(step).colptr(begin),
+          predictors.n_rows, batchSize, false, true));
+
+      for (size_t l = 0; l < networkSize; ++l)
+      {
+        boost::apply_visitor(SaveOutputParameterVisitor(rnnOutputParameter),
+            rnn.network[l]);
+      }
+      boost::apply_visitor(SaveOutputParameterVisitor(rnnResults),
+          rnn.network.back());
     }
-    boost::apply_visitor(SaveOutputParameterVisitor(results1),
-        forwardRNN.network.back());
-    boost::apply_visitor(SaveOutputParameterVisitor(results2),
-        backwardRNN.network.back());
   }
   if (outputSize == 0)
   {
@@ -508,89 +517,61 @@ EvaluateWithGradient(const arma::mat& /* parameters */,
 
     boost::apply_visitor(BackwardVisitor(results.slice(seqNum), error, delta),
         mergeOutput);
-    allDelta.push_back(arma::mat(delta));
+    allDelta.push_back(std::move(delta));
   }
 
-  // BPTT ForwardRNN from t = T to 1.
-  totalGradient = arma::mat(gradient.memptr(),
-      parameter.n_elem / 2, 1, false, false);
-
   forwardGradient.zeros();
   forwardRNN.ResetGradients(forwardGradient);
   backwardGradient.zeros();
   backwardRNN.ResetGradients(backwardGradient);
 
-  for (size_t seqNum = 0; seqNum < rho; ++seqNum)
+  // BPTT of the forward RNN from t = T to 1, and of the backward RNN from
+  // t = 1 to T.  The directions only share the merge layer, whose index
+  // selects the direction.
+  #pragma omp parallel for
+  for (omp_size_t direction = 0; direction < 2; ++direction)
   {
-    forwardGradient.zeros();
-    for (size_t l = 0; l < networkSize; ++l)
-    {
-      boost::apply_visitor(LoadOutputParameterVisitor(
-          forwardRNNOutputParameter),
-          forwardRNN.network[networkSize - 1 - l]);
-    }
-    boost::apply_visitor(BackwardVisitor(boost::apply_visitor(
-        outputParameterVisitor, forwardRNN.network.back()),
-        allDelta[rho - seqNum - 1], delta, 0),
-        mergeLayer);
+    RNNType& rnn = (direction == 0) ? forwardRNN : backwardRNN;
+    std::vector<arma::mat>& rnnOutputParameter = (direction == 0) ?
+        forwardRNNOutputParameter : backwardRNNOutputParameter;
+    arma::mat& rnnGradient = (direction == 0) ? forwardGradient :
+        backwardGradient;
+    arma::mat totalGradient(gradient.memptr() + direction *
+        (parameter.n_elem / 2), parameter.n_elem / 2, 1, false, false);
+    arma::mat rnnDelta;
 
-    for (size_t i = 2; i < networkSize; ++i)
+    for (size_t seqNum = 0; seqNum < rho; ++seqNum)
     {
-      boost::apply_visitor(BackwardVisitor(
+      const size_t step = (direction == 0) ? rho - seqNum - 1 : seqNum;
+      rnnGradient.zeros();
+      for (size_t l = 0; l < networkSize; ++l)
+      {
+        boost::apply_visitor(LoadOutputParameterVisitor(rnnOutputParameter),
+            rnn.network[networkSize - 1 - l]);
+      }
+      boost::apply_visitor(BackwardVisitor(boost::apply_visitor(
+          outputParameterVisitor, rnn.network.back()), allDelta[step],
+          rnnDelta, direction), mergeLayer);
+
+      for (size_t i = 2; i < networkSize; ++i)
+      {
+        boost::apply_visitor(BackwardVisitor(
+            boost::apply_visitor(outputParameterVisitor,
+            rnn.network[networkSize - i]),
+            boost::apply_visitor(deltaVisitor,
+            rnn.network[networkSize - i + 1]),
+            boost::apply_visitor(deltaVisitor,
+            rnn.network[networkSize - i])),
+            rnn.network[networkSize - i]);
+      }
+      rnn.Gradient(arma::mat(predictors.slice(step).colptr(begin),
+          predictors.n_rows, batchSize, false, true));
+      boost::apply_visitor(GradientVisitor(
           boost::apply_visitor(outputParameterVisitor,
-          forwardRNN.network[networkSize - i]),
-          boost::apply_visitor(deltaVisitor,
-          forwardRNN.network[networkSize - i + 1]),
-          boost::apply_visitor(deltaVisitor,
-          forwardRNN.network[networkSize - i])),
-          forwardRNN.network[networkSize - i]);
-    }
-    forwardRNN.Gradient(
-        arma::mat(predictors.slice(rho - seqNum - 1).colptr(begin),
-        predictors.n_rows, batchSize, false, true));
-    boost::apply_visitor(GradientVisitor(
-        boost::apply_visitor(outputParameterVisitor,
-        forwardRNN.network[networkSize - 2]),
-        allDelta[rho - seqNum - 1], 0), mergeLayer);
-    totalGradient += forwardGradient;
-  }
-
-  // BPTT BackwardRNN from t = 1 to T.
-  totalGradient = arma::mat(gradient.memptr() + parameter.n_elem/2,
-      parameter.n_elem/2, 1, false, false);
-
-  for (size_t seqNum = 0; seqNum < rho; ++seqNum)
-  {
-    backwardGradient.zeros();
-    for (size_t l = 0; l < networkSize; ++l)
-    {
-      boost::apply_visitor(LoadOutputParameterVisitor(
-          backwardRNNOutputParameter),
-          backwardRNN.network[networkSize - 1 - l]);
-    }
-    boost::apply_visitor(BackwardVisitor(
-        boost::apply_visitor(outputParameterVisitor,
-        backwardRNN.network.back()),
-        allDelta[seqNum], delta, 1), mergeLayer);
-    for (size_t i = 2; i < networkSize; ++i)
-    {
-      boost::apply_visitor(BackwardVisitor(
-        boost::apply_visitor(outputParameterVisitor,
-        backwardRNN.network[networkSize - i]), boost::apply_visitor(
-        deltaVisitor, backwardRNN.network[networkSize - i + 1]),
-        boost::apply_visitor(deltaVisitor,
-        backwardRNN.network[networkSize - i])),
-        backwardRNN.network[networkSize - i]);
+          rnn.network[networkSize - 2]), allDelta[step], direction),
+          mergeLayer);
+      totalGradient += rnnGradient;
     }
-
-    backwardRNN.Gradient(
-        arma::mat(predictors.slice(seqNum).colptr(begin),
-        predictors.n_rows, batchSize, false, true));
-    boost::apply_visitor(GradientVisitor(
-        std::move(boost::apply_visitor(outputParameterVisitor,
-        backwardRNN.network[networkSize - 2])),
-        allDelta[seqNum], 1), mergeLayer);
-    totalGradient += backwardGradient;
   }
   return performance;
 }
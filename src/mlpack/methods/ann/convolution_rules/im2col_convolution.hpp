@@ -0,0 +1,370 @@
+/**
+ * @file methods/ann/convolution_rules/im2col_convolution.hpp
+ *
+ * Implementation of the convolution through the lowering of the input into a
+ * matrix (im2col) and a matrix product.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_CONVOLUTION_RULES_IM2COL_CONVOLUTION_HPP
+#define MLPACK_METHODS_ANN_CONVOLUTION_RULES_IM2COL_CONVOLUTION_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "border_modes.hpp"
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * Computes the two-dimensional convolution by copying every patch of the input
+ * that the filter is applied to into a column of a matrix (im2col), so that the
+ * convolution becomes a matrix product.  This class allows specification of
+ * the type of the border type. The convolution can be computed with the valid
+ * border type or the full border type (default).
+ *
+ * FullConvolution: returns the full two-dimensional convolution.
+ * ValidConvolution: returns only those parts of the convolution that are
+ * computed without the zero-padded edges.
+ *
+ * For a single pair of matrices the matrix product is a matrix-vector product,
+ * so this is mainly useful through Im2Col() and Col2Im(), which lower all the
+ * input maps of a whole batch at once: when all three rules of the Convolution
+ * layer are Im2ColConvolution, its forward pass, backward pass and gradient
+ * each become a single matrix-matrix product over the whole batch.
+ *
+ * @tparam BorderMode Type of the border mode (FullConvolution or
+ * ValidConvolution).
+ */
+template<typename BorderMode = FullConvolution>
+class Im2ColConvolution
+{
+ public:
+  /*
+   * Perform a convolution (valid mode).
+   *
+   * @param input Input used to perform the convolution.
+   * @param filter Filter used to perform the convolution.
+   * @param output Output data that contains the results of the convolution.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   * @param dilationW The dilation factor in x direction.
+   * @param dilationH The dilation factor in y direction.
+   */
+  template<typename eT, typename Border = BorderMode>
+  static typename std::enable_if<
+      std::is_same<Border, ValidConvolution>::value, void>::type
+  Convolution(const arma::Mat<eT>& input,
+              const arma::Mat<eT>& filter,
+              arma::Mat<eT>& output,
+              const size_t dW = 1,
+              const size_t dH = 1,
+              const size_t dilationW = 1,
+              const size_t dilationH = 1)
+  {
+    const arma::Cube<eT> inputCube(const_cast<eT*>(input.memptr()),
+        input.n_rows, input.n_cols, 1, false, true);
+
+    arma::Mat<eT> columns;
+    Im2Col(inputCube, 1, filter.n_rows, filter.n_cols, columns, dW, dH,
+        dilationW, dilationH);
+
+    output.set_size(OutSize(input.n_rows, filter.n_rows, dW, dilationW),
+        OutSize(input.n_cols, filter.n_cols, dH, dilationH));
+    arma::Col<eT> outputVector(output.memptr(), output.n_elem, false, true);
+    outputVector = columns.t() * arma::vectorise(filter);
+  }
+
+  /*
+   * Perform a convolution (full mode).
+   *
+   * @param input Input used to perform the convolution.
+   * @param filter Filter used to perform the convolution.
+   * @param output Output data that contains the results of the convolution.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   * @param dilationW The dilation factor in x direction.
+   * @param dilationH The dilation factor in y direction.
+   */
+  template<typename eT, typename Border = BorderMode>
+  static typename std::enable_if<
+      std::is_same<Border, FullConvolution>::value, void>::type
+  Convolution(const arma::Mat<eT>& input,
+              const arma::Mat<eT>& filter,
+              arma::Mat<eT>& output,
+              const size_t dW = 1,
+              const size_t dH = 1,
+              const size_t dilationW = 1,
+              const size_t dilationH = 1)
+  {
+    // Pad the input so that the filter is applied wherever it overlaps it.
+    const size_t padW = (filter.n_rows - 1) * dilationW;
+    const size_t padH = (filter.n_cols - 1) * dilationH;
+    arma::Mat<eT> inputPadded = arma::zeros<arma::Mat<eT> >(
+        input.n_rows + 2 * padW, input.n_cols + 2 * padH);
+    inputPadded.submat(padW, padH, padW + input.n_rows - 1,
+        padH + input.n_cols - 1) = input;
+
+    Im2ColConvolution<ValidConvolution>::Convolution(inputPadded, filter,
+        output, dW, dH, dilationW, dilationH);
+  }
+
+  /*
+   * Perform a convolution using 3rd order tensors.
+   *
+   * @param input Input used to perform the convolution.
+   * @param filter Filter used to perform the convolution.
+   * @param output Output data that contains the results of the convolution.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   * @param dilationW The dilation factor in x direction.
+   * @param dilationH The dilation factor in y direction.
+   */
+  template<typename eT>
+  static void Convolution(const arma::Cube<eT>& input,
+                          const arma::Cube<eT>& filter,
+                          arma::Cube<eT>& output,
+                          const size_t dW = 1,
+                          const size_t dH = 1,
+                          const size_t dilationW = 1,
+                          const size_t dilationH = 1)
+  {
+    arma::Mat<eT> convOutput;
+    Im2ColConvolution<BorderMode>::Convolution(input.slice(0),
+        filter.slice(0), convOutput, dW, dH, dilationW, dilationH);
+
+    output = arma::Cube<eT>(convOutput.n_rows, convOutput.n_cols,
+        input.n_slices);
+    output.slice(0) = convOutput;
+
+    for (size_t i = 1; i < input.n_slices; ++i)
+    {
+      Im2ColConvolution<BorderMode>::Convolution(input.slice(i),
+          filter.slice(i), convOutput, dW, dH, dilationW, dilationH);
+      output.slice(i) = convOutput;
+    }
+  }
+
+  /*
+   * Perform a convolution using dense matrix as input and a 3rd order tensors
+   * as filter and output.
+   *
+   * @param input Input used to perform the convolution.
+   * @param filter Filter used to perform the convolution.
+   * @param output Output data that contains the results of the convolution.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   * @param dilationW The dilation factor in x direction.
+   * @param dilationH The dilation factor in y direction.
+   */
+  template<typename eT>
+  static void Convolution(const arma::Mat<eT>& input,
+                          const arma::Cube<eT>& filter,
+                          arma::Cube<eT>& output,
+                          const size_t dW = 1,
+                          const size_t dH = 1,
+                          const size_t dilationW = 1,
+                          const size_t dilationH = 1)
+  {
+    arma::Mat<eT> convOutput;
+    Im2ColConvolution<BorderMode>::Convolution(input, filter.slice(0),
+        convOutput, dW, dH, dilationW, dilationH);
+
+    output = arma::Cube<eT>(convOutput.n_rows, convOutput.n_cols,
+        filter.n_slices);
+    output.slice(0) = convOutput;
+
+    for (size_t i = 1; i < filter.n_slices; ++i)
+    {
+      Im2ColConvolution<BorderMode>::Convolution(input, filter.slice(i),
+          convOutput, dW, dH, dilationW, dilationH);
+      output.slice(i) = convOutput;
+    }
+  }
+
+  /*
+   * Perform a convolution using a 3rd order tensors as input and output and a
+   * dense matrix as filter.
+   *
+   * @param input Input used to perform the convolution.
+   * @param filter Filter used to perform the convolution.
+   * @param output Output data that contains the results of the convolution.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   * @param dilationW The dilation factor in x direction.
+   * @param dilationH The dilation factor in y direction.
+   */
+  template<typename eT>
+  static void Convolution(const arma::Cube<eT>& input,
+                          const arma::Mat<eT>& filter,
+                          arma::Cube<eT>& output,
+                          const size_t dW = 1,
+                          const size_t dH = 1,
+                          const size_t dilationW = 1,
+                          const size_t dilationH = 1)
+  {
+    arma::Mat<eT> convOutput;
+    Im2ColConvolution<BorderMode>::Convolution(input.slice(0), filter,
+        convOutput, dW, dH, dilationW, dilationH);
+
+    output = arma::Cube<eT>(convOutput.n_rows, convOutput.n_cols,
+        input.n_slices);
+    output.slice(0) = convOutput;
+
+    for (size_t i = 1; i < input.n_slices; ++i)
+    {
+      Im2ColConvolution<BorderMode>::Convolution(input.slice(i), filter,
+          convOutput, dW, dH, dilationW, dilationH);
+      output.slice(i) = convOutput;
+    }
+  }
+
+  /*
+   * Lower the given input into a matrix with one column per application of the
+   * filter (valid mode).  The slices of the input are the maps of one or more
+   * points, with the given number of maps per point.  Column i + outRows *
+   * (j + outCols * p) holds the patch of every map of point p that output
+   * element (i, j) is computed from, with element (ki, kj) of map m in row
+   * ki + kernelWidth * (kj + kernelHeight * m), so that the filters of the
+   * Convolution layer are the columns of its weights.
+   *
+   * @param input Input maps of every point.
+   * @param maps Number of maps of each point.
+   * @param kernelWidth Width of the filter.
+   * @param kernelHeight Height of the filter.
+   * @param columns Matrix to store the lowered input in.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   * @param dilationW The dilation factor in x direction.
+   * @param dilationH The dilation factor in y direction.
+   */
+  template<typename eT>
+  static void Im2Col(const arma::Cube<eT>& input,
+                     const size_t maps,
+                     const size_t kernelWidth,
+                     const size_t kernelHeight,
+                     arma::Mat<eT>& columns,
+                     const size_t dW = 1,
+                     const size_t dH = 1,
+                     const size_t dilationW = 1,
+                     const size_t dilationH = 1)
+  {
+    const size_t outRows = OutSize(input.n_rows, kernelWidth, dW, dilationW);
+    const size_t outCols = OutSize(input.n_cols, kernelHeight, dH, dilationH);
+    const size_t points = input.n_slices / maps;
+    columns.set_size(kernelWidth * kernelHeight * maps,
+        outRows * outCols * points);
+
+    #pragma omp parallel for
+    for (omp_size_t p = 0; p < (omp_size_t) points; ++p)
+    {
+      for (size_t j = 0; j < outCols; ++j)
+      {
+        for (size_t i = 0; i < outRows; ++i)
+        {
+          eT* columnPtr = columns.colptr(i + outRows * (j + outCols * p));
+          for (size_t m = 0; m < maps; ++m)
+          {
+            const eT* mapPtr = input.slice_memptr(p * maps + m);
+            for (size_t kj = 0; kj < kernelHeight; ++kj)
+            {
+              const eT* inputPtr = mapPtr + (j * dH + kj * dilationH) *
+                  input.n_rows + i * dW;
+              for (size_t ki = 0; ki < kernelWidth; ++ki, ++columnPtr)
+                *columnPtr = inputPtr[ki * dilationW];
+            }
+          }
+        }
+      }
+    }
+  }
+
+  /*
+   * Add each column of the given lowered matrix back to the patch of the maps
+   * it was taken from; this is the transpose of Im2Col().  The output must
+   * already have the size of the input of Im2Col(), and isn't cleared.
+   *
+   * @param columns Lowered matrix (see Im2Col()).
+   * @param maps Number of maps of each point.
+   * @param kernelWidth Width of the filter.
+   * @param kernelHeight Height of the filter.
+   * @param output Maps of every point to add the columns to.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   * @param dilationW The dilation factor in x direction.
+   * @param dilationH The dilation factor in y direction.
+   */
+  template<typename eT>
+  static void Col2Im(const arma::Mat<eT>& columns,
+                     const size_t maps,
+                     const size_t kernelWidth,
+                     const size_t kernelHeight,
+                     arma::Cube<eT>& output,
+                     const size_t dW = 1,
+                     const size_t dH = 1,
+                     const size_t dilationW = 1,
+                     const size_t dilationH = 1)
+  {
+    const size_t outRows = OutSize(output.n_rows, kernelWidth, dW, dilationW);
+    const size_t outCols = OutSize(output.n_cols, kernelHeight, dH, dilationH);
+    const size_t points = output.n_slices / maps;
+
+    // The patches of different points don't overlap.
+    #pragma omp parallel for
+    for (omp_size_t p = 0; p < (omp_size_t) points; ++p)
+    {
+      for (size_t j = 0; j < outCols; ++j)
+      {
+        for (size_t i = 0; i < outRows; ++i)
+        {
+          const eT* columnPtr = columns.colptr(i + outRows *
+              (j + outCols * p));
+          for (size_t m = 0; m < maps; ++m)
+          {
+            eT* mapPtr = output.slice_memptr(p * maps + m);
+            for (size_t kj = 0; kj < kernelHeight; ++kj)
+            {
+              eT* outputPtr = mapPtr + (j * dH + kj * dilationH) *
+                  output.n_rows + i * dW;
+              for (size_t ki = 0; ki < kernelWidth; ++ki, ++columnPtr)
+                outputPtr[ki * dilationW] += *columnPtr;
+            }
+          }
+        }
+      }
+    }
+  }
+
+ private:
+  //! Return the number of applications of the filter along one dimension.
+  static size_t OutSize(const size_t size,
+                        const size_t k,
+                        const size_t s,
+                        const size_t dilation)
+  {
+    return (size - (k - 1) * dilation - 1) / s + 1;
+  }
+};  // class Im2ColConvolution
+
+/**
+ * Whether the given convolution rule is an Im2ColConvolution, whose lowering
+ * can be used for a whole batch.
+ */
+template<typename ConvolutionRule>
+struct IsIm2ColConvolution
+{
+  static const bool value = false;
+};
+
+template<typename BorderMode>
+struct IsIm2ColConvolution<Im2ColConvolution<BorderMode>>
+{
+  static const bool value = true;
+};
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
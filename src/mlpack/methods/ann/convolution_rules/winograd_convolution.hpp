@@ -0,0 +1,396 @@
+/**
+ * @file methods/ann/convolution_rules/winograd_convolution.hpp
+ *
+ * Implementation of the 3x3 convolution through Winograd's minimal filtering
+ * algorithm F(2x2, 3x3).
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_CONVOLUTION_RULES_WINOGRAD_CONVOLUTION_HPP
+#define MLPACK_METHODS_ANN_CONVOLUTION_RULES_WINOGRAD_CONVOLUTION_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "border_modes.hpp"
+#include "naive_convolution.hpp"
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * Computes the two-dimensional convolution with a 3x3 filter and unit strides
+ * through the minimal filtering algorithm F(2x2, 3x3), which computes each 2x2
+ * tile of the output from a 4x4 tile of the input with 16 multiplications
+ * instead of 36:
+ *
+ * @code
+ * @inproceedings{lavin2016fast,
+ *   title={Fast Algorithms for Convolutional Neural Networks},
+ *   author={Lavin, Andrew and Gray, Scott},
+ *   booktitle={Proceedings of the IEEE Conference on Computer Vision and
+ *       Pattern Recognition (CVPR)},
+ *   pages={4013--4021},
+ *   year={2016}
+ * }
+ * @endcode
+ *
+ * Other filter sizes, strides and dilations are passed to NaiveConvolution.
+ * This class allows specification of the type of the border type. The
+ * convolution can be computed with the valid border type or the full border
+ * type (default).
+ *
+ * FullConvolution: returns the full two-dimensional convolution.
+ * ValidConvolution: returns only those parts of the convolution that are
+ * computed without the zero-padded edges.
+ *
+ * @tparam BorderMode Type of the border mode (FullConvolution or
+ * ValidConvolution).
+ */
+template<typename BorderMode = FullConvolution>
+class WinogradConvolution
+{
+ public:
+  /*
+   * Perform a convolution (valid mode).
+   *
+   * @param input Input used to perform the convolution.
+   * @param filter Filter used to perform the convolution.
+   * @param output Output data that contains the results of the convolution.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   * @param dilationW The dilation factor in x direction.
+   * @param dilationH The dilation factor in y direction.
+   */
+  template<typename eT, typename Border = BorderMode>
+  static typename std::enable_if<
+      std::is_same<Border, ValidConvolution>::value, void>::type
+  Convolution(const arma::Mat<eT>& input,
+              const arma::Mat<eT>& filter,
+              arma::Mat<eT>& output,
+              const size_t dW = 1,
+              const size_t dH = 1,
+              const size_t dilationW = 1,
+              const size_t dilationH = 1)
+  {
+    if (!Applies(filter, dW, dH, dilationW, dilationH) || input.n_rows < 3 ||
+        input.n_cols < 3)
+    {
+      NaiveConvolution<ValidConvolution>::Convolution(input, filter, output,
+          dW, dH, dilationW, dilationH);
+      return;
+    }
+
+    arma::Mat<eT> transformedFilter;
+    TransformFilter(filter, transformedFilter);
+    output.zeros(input.n_rows - 2, input.n_cols - 2);
+    AddConvolution(input, transformedFilter, output);
+  }
+
+  /*
+   * Perform a convolution (full mode).
+   *
+   * @param input Input used to perform the convolution.
+   * @param filter Filter used to perform the convolution.
+   * @param output Output data that contains the results of the convolution.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   * @param dilationW The dilation factor in x direction.
+   * @param dilationH The dilation factor in y direction.
+   */
+  template<typename eT, typename Border = BorderMode>
+  static typename std::enable_if<
+      std::is_same<Border, FullConvolution>::value, void>::type
+  Convolution(const arma::Mat<eT>& input,
+              const arma::Mat<eT>& filter,
+              arma::Mat<eT>& output,
+              const size_t dW = 1,
+              const size_t dH = 1,
+              const size_t dilationW = 1,
+              const size_t dilationH = 1)
+  {
+    if (!Applies(filter, dW, dH, dilationW, dilationH))
+    {
+      NaiveConvolution<FullConvolution>::Convolution(input, filter, output,
+          dW, dH, dilationW, dilationH);
+      return;
+    }
+
+    // Pad the input so that the filter is applied wherever it overlaps it.
+    arma::Mat<eT> inputPadded = arma::zeros<arma::Mat<eT> >(input.n_rows + 4,
+        input.n_cols + 4);
+    inputPadded.submat(2, 2, input.n_rows + 1, input.n_cols + 1) = input;
+
+    WinogradConvolution<ValidConvolution>::Convolution(inputPadded, filter,
+        output);
+  }
+
+  /*
+   * Perform a convolution using 3rd order tensors.
+   *
+   * @param input Input used to perform the convolution.
+   * @param filter Filter used to perform the convolution.
+   * @param output Output data that contains the results of the convolution.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   * @param dilationW The dilation factor in x direction.
+   * @param dilationH The dilation factor in y direction.
+   */
+  template<typename eT>
+  static void Convolution(const arma::Cube<eT>& input,
+                          const arma::Cube<eT>& filter,
+                          arma::Cube<eT>& output,
+                          const size_t dW = 1,
+                          const size_t dH = 1,
+                          const size_t dilationW = 1,
+                          const size_t dilationH = 1)
+  {
+    arma::Mat<eT> convOutput;
+    WinogradConvolution<BorderMode>::Convolution(input.slice(0),
+        filter.slice(0), convOutput, dW, dH, dilationW, dilationH);
+
+    output = arma::Cube<eT>(convOutput.n_rows, convOutput.n_cols,
+        input.n_slices);
+    output.slice(0) = convOutput;
+
+    for (size_t i = 1; i < input.n_slices; ++i)
+    {
+      WinogradConvolution<BorderMode>::Convolution(input.slice(i),
+          filter.slice(i), convOutput, dW, dH, dilationW, dilationH);
+      output.slice(i) = convOutput;
+    }
+  }
+
+  /*
+   * Perform a convolution using dense matrix as input and a 3rd order tensors
+   * as filter and output.
+   *
+   * @param input Input used to perform the convolution.
+   * @param filter Filter used to perform the convolution.
+   * @param output Output data that contains the results of the convolution.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   * @param dilationW The dilation factor in x direction.
+   * @param dilationH The dilation factor in y direction.
+   */
+  template<typename eT>
+  static void Convolution(const arma::Mat<eT>& input,
+                          const arma::Cube<eT>& filter,
+                          arma::Cube<eT>& output,
+                          const size_t dW = 1,
+                          const size_t dH = 1,
+                          const size_t dilationW = 1,
+                          const size_t dilationH = 1)
+  {
+    arma::Mat<eT> convOutput;
+    WinogradConvolution<BorderMode>::Convolution(input, filter.slice(0),
+        convOutput, dW, dH, dilationW, dilationH);
+
+    output = arma::Cube<eT>(convOutput.n_rows, convOutput.n_cols,
+        filter.n_slices);
+    output.slice(0) = convOutput;
+
+    for (size_t i = 1; i < filter.n_slices; ++i)
+    {
+      WinogradConvolution<BorderMode>::Convolution(input, filter.slice(i),
+          convOutput, dW, dH, dilationW, dilationH);
+      output.slice(i) = convOutput;
+    }
+  }
+
+  /*
+   * Perform a convolution using a 3rd order tensors as input and output and a
+   * dense matrix as filter.
+   *
+   * @param input Input used to perform the convolution.
+   * @param filter Filter used to perform the convolution.
+   * @param output Output data that contains the results of the convolution.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   * @param dilationW The dilation factor in x direction.
+   * @param dilationH The dilation factor in y direction.
+   */
+  template<typename eT>
+  static void Convolution(const arma::Cube<eT>& input,
+                          const arma::Mat<eT>& filter,
+                          arma::Cube<eT>& output,
+                          const size_t dW = 1,
+                          const size_t dH = 1,
+                          const size_t dilationW = 1,
+                          const size_t dilationH = 1)
+  {
+    arma::Mat<eT> convOutput;
+    WinogradConvolution<BorderMode>::Convolution(input.slice(0), filter,
+        convOutput, dW, dH, dilationW, dilationH);
+
+    output = arma::Cube<eT>(convOutput.n_rows, convOutput.n_cols,
+        input.n_slices);
+    output.slice(0) = convOutput;
+
+    for (size_t i = 1; i < input.n_slices; ++i)
+    {
+      WinogradConvolution<BorderMode>::Convolution(input.slice(i), filter,
+          convOutput, dW, dH, dilationW, dilationH);
+      output.slice(i) = convOutput;
+    }
+  }
+
+  /*
+   * Compute the 4x4 transform G g G^T of the given 3x3 filter g.
+   *
+   * @param filter Filter to transform.
+   * @param transformed Matrix to store the transformed filter in.
+   */
+  template<typename eT>
+  static void TransformFilter(const arma::Mat<eT>& filter,
+                              arma::Mat<eT>& transformed)
+  {
+    // First G g, one column of the filter at a time.
+    eT temp[4][3];
+    for (size_t j = 0; j < 3; ++j)
+    {
+      temp[0][j] = filter(0, j);
+      temp[1][j] = (filter(0, j) + filter(1, j) + filter(2, j)) / 2;
+      temp[2][j] = (filter(0, j) - filter(1, j) + filter(2, j)) / 2;
+      temp[3][j] = filter(2, j);
+    }
+
+    // Then (G g) G^T, one row at a time.
+    transformed.set_size(4, 4);
+    for (size_t i = 0; i < 4; ++i)
+    {
+      transformed(i, 0) = temp[i][0];
+      transformed(i, 1) = (temp[i][0] + temp[i][1] + temp[i][2]) / 2;
+      transformed(i, 2) = (temp[i][0] - temp[i][1] + temp[i][2]) / 2;
+      transformed(i, 3) = temp[i][2];
+    }
+  }
+
+  /*
+   * Add the valid convolution of the given input with the filter whose
+   * transform is given (see TransformFilter()) to the given output, which must
+   * have n_rows - 2 rows and n_cols - 2 columns.
+   *
+   * @param input Input used to perform the convolution.
+   * @param transformed Transform of the filter.
+   * @param output Output to add the results of the convolution to.
+   */
+  template<typename eT>
+  static void AddConvolution(const arma::Mat<eT>& input,
+                             const arma::Mat<eT>& transformed,
+                             arma::Mat<eT>& output)
+  {
+    const eT* u = transformed.memptr();
+
+    // Each tile of the output is 2x2; the input tiles on the last row or
+    // column of tiles may extend past the input, and are padded with zeros.
+    for (size_t c = 0; c < output.n_cols; c += 2)
+    {
+      for (size_t r = 0; r < output.n_rows; r += 2)
+      {
+        // d is the 4x4 input tile, column-major.
+        eT d[16];
+        for (size_t j = 0; j < 4; ++j)
+        {
+          for (size_t i = 0; i < 4; ++i)
+          {
+            d[i + 4 * j] = (r + i < input.n_rows && c + j < input.n_cols) ?
+                input(r + i, c + j) : eT(0);
+          }
+        }
+
+        // B^T d, one column at a time.
+        eT w[16];
+        for (size_t j = 0; j < 4; ++j)
+        {
+          const eT* dj = d + 4 * j;
+          w[0 + 4 * j] = dj[0] - dj[2];
+          w[1 + 4 * j] = dj[1] + dj[2];
+          w[2 + 4 * j] = dj[2] - dj[1];
+          w[3 + 4 * j] = dj[1] - dj[3];
+        }
+
+        // m = U .* ((B^T d) B), where (B^T d) B is computed one row at a time.
+        eT m[16];
+        for (size_t i = 0; i < 4; ++i)
+        {
+          m[i + 0] = u[i + 0] * (w[i + 0] - w[i + 8]);
+          m[i + 4] = u[i + 4] * (w[i + 4] + w[i + 8]);
+          m[i + 8] = u[i + 8] * (w[i + 8] - w[i + 4]);
+          m[i + 12] = u[i + 12] * (w[i + 4] - w[i + 12]);
+        }
+
+        // A^T m, one column at a time; then (A^T m) A.
+        eT n[2][4];
+        for (size_t j = 0; j < 4; ++j)
+        {
+          const eT* mj = m + 4 * j;
+          n[0][j] = mj[0] + mj[1] + mj[2];
+          n[1][j] = mj[1] - mj[2] - mj[3];
+        }
+
+        const size_t rows = std::min((size_t) 2, (size_t) output.n_rows - r);
+        const size_t cols = std::min((size_t) 2, (size_t) output.n_cols - c);
+        for (size_t i = 0; i < rows; ++i)
+        {
+          output(r + i, c) += n[i][0] + n[i][1] + n[i][2];
+          if (cols == 2)
+            output(r + i, c + 1) += n[i][1] - n[i][2] - n[i][3];
+        }
+      }
+    }
+  }
+
+  /*
+   * Return whether the convolution with the given filter size, strides and
+   * dilations is computed through F(2x2, 3x3).
+   */
+  static bool Applies(const size_t filterRows,
+                      const size_t filterCols,
+                      const size_t dW = 1,
+                      const size_t dH = 1,
+                      const size_t dilationW = 1,
+                      const size_t dilationH = 1)
+  {
+    return filterRows == 3 && filterCols == 3 && dW == 1 && dH == 1 &&
+        dilationW == 1 && dilationH == 1;
+  }
+
+ private:
+  //! Return whether the convolution with the given filter is computed through
+  //! F(2x2, 3x3).
+  template<typename eT>
+  static bool Applies(const arma::Mat<eT>& filter,
+                      const size_t dW,
+                      const size_t dH,
+                      const size_t dilationW,
+                      const size_t dilationH)
+  {
+    return Applies(filter.n_rows, filter.n_cols, dW, dH, dilationW,
+        dilationH);
+  }
+};  // class WinogradConvolution
+
+/**
+ * The convolution rule that the Convolution layer uses for the given rule: the
+ * naive rule is replaced by WinogradConvolution, which computes the 3x3
+ * convolutions with unit strides through F(2x2, 3x3) and passes the other
+ * convolutions back to the naive rule.
+ */
+template<typename ConvolutionRule>
+struct WinogradRule
+{
+  typedef ConvolutionRule type;
+};
+
+template<typename BorderMode>
+struct WinogradRule<NaiveConvolution<BorderMode>>
+{
+  typedef WinogradConvolution<BorderMode> type;
+};
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
@@ -14,6 +14,7 @@
 #define MLPACK_METHODS_ANN_FFN_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/data/prefetch_loader.hpp>
 
 #include "visitor/delete_visitor.hpp"
 #include "visitor/delta_visitor.hpp"
@@ -26,6 +27,8 @@
 #include "visitor/loss_visitor.hpp"
 
 #include "init_rules/network_init.hpp"
+#include "inference_context.hpp"
+#include "layer_profiler.hpp"
 
 #include <mlpack/methods/ann/layer/layer_types.hpp>
 #include <mlpack/methods/ann/layer/layer.hpp>
@@ -163,6 +166,61 @@ class FFN
                arma::mat responses,
                CallbackTypes&&... callbacks);
 
+  /**
+   * Train the feedforward network on the given sparse input data, using the
+   * given optimizer.  The first layer of the network must be a Linear<> layer:
+   * its forward pass is a dense-sparse product, and only the columns of its
+   * weights that belong to non-zero inputs get a gradient, so the predictors
+   * are never densified.
+   *
+   * This will use the existing model parameters as a starting point for the
+   * optimization.
+   *
+   * @tparam OptimizerType Type of optimizer to use to train the model.
+   * @tparam CallbackTypes Types of Callback Functions.
+   * @param predictors Sparse input training variables.
+   * @param responses Outputs results from input training variables.
+   * @param optimizer Instantiated optimizer used to train the model.
+   * @param callbacks Callback function for ensmallen optimizer `OptimizerType`.
+   *      See https://www.ensmallen.org/docs.html#callback-documentation.
+   * @return The final objective of the trained model (NaN or Inf on error).
+   */
+  template<typename OptimizerType, typename... CallbackTypes>
+  double Train(arma::sp_mat predictors,
+               arma::mat responses,
+               OptimizerType& optimizer,
+               CallbackTypes&&... callbacks);
+
+  /**
+   * Train the feedforward network on a dataset that is read in chunks by the
+   * given loader, using the given optimizer.  Each pass runs the optimizer
+   * on each chunk in turn, while the loader decodes the next chunks on its
+   * background thread; the maximum number of iterations of the optimizer
+   * therefore applies to each chunk.  Only the current chunk and the chunks
+   * kept ready by the loader are held in memory.
+   *
+   * This will use the existing model parameters as a starting point for the
+   * optimization.
+   *
+   * @tparam SourceType Type of the chunk source of the loader.
+   * @tparam OptimizerType Type of optimizer to use to train the model.
+   * @tparam CallbackTypes Types of Callback Functions.
+   * @param loader Loader of the chunks of the training data.
+   * @param optimizer Instantiated optimizer used to train the model.
+   * @param passes Number of passes over the chunks.
+   * @param callbacks Callback function for ensmallen optimizer `OptimizerType`.
+   *      See https://www.ensmallen.org/docs.html#callback-documentation.
+   * @return The final objective of the model on the last chunk (NaN or Inf on
+   *      error).
+   */
+  template<typename SourceType,
+           typename OptimizerType,
+           typename... CallbackTypes>
+  double Train(data::PrefetchLoader<SourceType>& loader,
+               OptimizerType& optimizer,
+               const size_t passes,
+               CallbackTypes&&... callbacks);
+
   /**
    * Predict the responses to a given set of predictors. The responses will
    * reflect the output of the given output layer as returned by the
@@ -176,6 +234,31 @@ class FFN
    */
   void Predict(arma::mat predictors, arma::mat& results);
 
+  /**
+   * Predict the responses to a given set of sparse predictors.  The first
+   * layer of the network must be a Linear<> layer.
+   *
+   * @param predictors Sparse input predictors.
+   * @param results Matrix to put output predictions of responses into.
+   */
+  void Predict(const arma::sp_mat& predictors, arma::mat& results);
+
+  /**
+   * Predict the responses to a given set of predictors without modifying the
+   * network.  The layers that hold the outputs of the prediction are in the
+   * given context (built by the first prediction, and reused afterwards),
+   * and their weights point into the parameters of this network.  So several
+   * threads can predict with one network at once, each with its own context.
+   * The network must have been trained (or its parameters set).
+   *
+   * @param predictors Input predictors.
+   * @param results Matrix to put output predictions of responses into.
+   * @param context Context of the calling thread.
+   */
+  void Predict(const arma::mat& predictors,
+               arma::mat& results,
+               InferenceContext<FFN>& context) const;
+
   /**
    * Evaluate the feedforward network with the given predictors and responses.
    * This functions is usually used to monitor progress while training.
@@ -309,6 +392,40 @@ class FFN
   //! Return the number of separable functions (the number of predictor points).
   size_t NumFunctions() const { return numFunctions; }
 
+  //! Get the number of parts each training batch is split into.
+  size_t Replicas() const { return replicas; }
+  //! Modify the number of parts each training batch is split into.  With more
+  //! than one part, each part of a batch is passed forward and backward by its
+  //! own copy of the layers, in parallel with OpenMP; the copies share the
+  //! parameters of the network, the loss and the error of the output layer
+  //! are computed on the whole batch, and the gradients of the parts are
+  //! summed.  Layers that use statistics of the batch (like BatchNorm) see
+  //! only their part, and the gradient of a weight regularizer is added once
+  //! per part.
+  size_t& Replicas() { return replicas; }
+
+  //! Get the number of layers between two layers whose outputs are kept
+  //! during training.
+  size_t CheckpointInterval() const { return checkpointInterval; }
+  //! Modify the number of layers between two layers whose outputs are kept
+  //! during training (0 or 1 keeps every output, the default).  With a larger
+  //! interval, the outputs of the layers in between share the memory of one
+  //! run of layers, and are recomputed from the last kept output during the
+  //! backward pass.  Only the outputs of layers that are cheap to recompute
+  //! and don't change state in their forward pass (like Linear, Convolution,
+  //! pooling and activation layers) are recomputed; the outputs of the other
+  //! layers, like Dropout and BatchNorm, and of the last layer are always
+  //! kept.  The memory is saved from the second batch on, once the sizes of
+  //! the outputs are known.
+  size_t& CheckpointInterval() { return checkpointInterval; }
+
+  //! Get the profiler that records the time and memory of each layer (NULL
+  //! if none).
+  LayerProfiler* Profiler() const { return profiler; }
+  //! Modify the profiler that records the time and memory of each layer.  It
+  //! is usually set by passing a LayerProfiler to Train().
+  LayerProfiler*& Profiler() { return profiler; }
+
   //! Return the initial point for the optimization.
   const arma::mat& Parameters() const { return parameter; }
   //! Modify the initial point for the optimization.
@@ -329,6 +446,22 @@ class FFN
    */
   void ResetParameters();
 
+  /**
+   * Simplify the trained network for prediction.  Each BatchNorm layer that
+   * follows a Linear or Convolution layer is folded into the weights and the
+   * bias of that layer, using the running mean and variance of the BatchNorm
+   * layer, and is removed.  Dropout, AlphaDropout, SpatialDropout and
+   * IdentityLayer layers are removed, since they are the identity in
+   * deterministic mode.  The sigmoid, tanh, softplus and ReLU layers then
+   * compute their output in place, in the output of the layer before them,
+   * instead of making another copy of the batch.  The predictions don't
+   * change (up to rounding).
+   *
+   * The folded network can still be trained, but the BatchNorm layers it
+   * folded are gone; training turns off the in-place activations.
+   */
+  void OptimizeForInference();
+
   //! Serialize the model.
   template<typename Archive>
   void serialize(Archive& ar, const unsigned int /* version */);
@@ -402,6 +535,32 @@ class FFN
    */
   void ResetData(arma::mat predictors, arma::mat responses);
 
+  /**
+   * Prepare the network for the given sparse data.
+   *
+   * @param predictors Sparse input data variables.
+   * @param responses Outputs results from input data variables.
+   */
+  void ResetData(arma::sp_mat predictors, arma::mat responses);
+
+  //! Get the first layer of the network, which must be a Linear<> layer for
+  //! sparse input; throws std::invalid_argument if it isn't.
+  Linear<>& SparseInputLayer();
+
+  //! Run the first layer on the given (dense) input.
+  template<typename InputType>
+  void ForwardFirst(const InputType& input);
+
+  //! Run the first layer on the given sparse input.
+  void ForwardFirst(const arma::sp_mat& input);
+
+  //! Compute the gradient of the first layer for the given (dense) input.
+  template<typename InputType>
+  void GradientFirst(const InputType& input, const arma::mat& layerError);
+
+  //! Compute the gradient of the first layer for the given sparse input.
+  void GradientFirst(const arma::sp_mat& input, const arma::mat& layerError);
+
   /**
    * The Backward algorithm (part of the Forward-Backward algorithm). Computes
    * backward pass for module.
@@ -426,6 +585,94 @@ class FFN
    */
   void ResetGradients(arma::mat& gradient);
 
+  /**
+   * Record the number of rows of the output of each layer after a forward pass
+   * over a batch of the given size.  Only the outputs with one column per point
+   * of the batch are held by the arena.
+   *
+   * @param batchSize Number of points of the last forward pass.
+   */
+  void ResetArena(const size_t batchSize);
+
+  /**
+   * Allocate the arena for batches of up to the given size.  Any output or
+   * delta that still points into the previous arena is copied out of it.
+   *
+   * @param batchSize Largest number of points the arena has to hold.
+   */
+  void AllocateArena(const size_t batchSize);
+
+  /**
+   * Point the outputs and the deltas of the layers into the arena, for a batch
+   * of the given size, so that the layers write their results in place instead
+   * of allocating new matrices.
+   *
+   * @param batchSize Number of points of the next forward pass.
+   */
+  void AliasArena(const size_t batchSize);
+
+  //! Get whether the given layer computes its output in place, in the arena
+  //! memory of the output of the previous layer.
+  bool ArenaInPlace(const size_t i) const;
+
+  /**
+   * Choose the layers whose outputs are recomputed during the backward pass,
+   * for the current checkpoint interval.  The arena is allocated again by the
+   * next forward pass.
+   */
+  void PlanCheckpoints();
+
+  //! Get whether the output of the given layer is held by the memory shared by
+  //! its run of layers, and recomputed during the backward pass.
+  bool ArenaRecomputed(const size_t i) const;
+
+  //! Get whether the forward pass of the given layer can be repeated to
+  //! recompute its output.
+  bool Recomputable(const size_t i) const;
+
+  /**
+   * Compute the deltas and the gradients of the layers after a forward pass,
+   * from the error of the output layer.  When outputs were dropped by
+   * checkpointing, each run of layers is passed forward again from the last
+   * kept output before its layers are passed backward.
+   *
+   * @param input The input of the forward pass.
+   */
+  template<typename InputType>
+  void BackwardGradient(const InputType& input);
+
+  //! Record the memory of the output and the delta of each layer in the
+  //! profiler.
+  void ProfileMemory();
+
+  /**
+   * Evaluate the objective and the gradient of a batch whose parts are passed
+   * through the replicas of the network in parallel.
+   *
+   * @param begin Index of the first point of the batch.
+   * @param gradient Zeroed gradient, with the size of the parameters.
+   * @param batchSize Number of points of the batch.
+   */
+  template<typename GradType>
+  double ParallelEvaluateWithGradient(const size_t begin,
+                                      GradType& gradient,
+                                      const size_t batchSize);
+
+  /**
+   * Build the copies of the layers that process all but the first part of a
+   * training batch, with their weights pointing into the parameters.
+   *
+   * @param parts Number of parts of each batch.
+   */
+  void ResetReplicas(const size_t parts);
+
+  //! Delete the replicas of the network.
+  void ClearReplicas();
+
+  //! Create a copy of the layers of the network, with their weights pointing
+  //! into the parameters of the network.
+  FFN* Replicate() const;
+
   /**
    * Swap the content of this network with given network.
    *
@@ -455,6 +702,10 @@ class FFN
   //! The matrix of data points (predictors).
   arma::mat predictors;
 
+  //! The sparse matrix of data points, when the network is trained on sparse
+  //! predictors (predictors is then empty).
+  arma::sp_mat sparsePredictors;
+
   //! The matrix of responses to the input data points.
   arma::mat responses;
 
@@ -506,9 +757,60 @@ class FFN
   //! Locally-stored gradient parameter.
   arma::mat gradient;
 
+  //! Memory that holds the outputs and the deltas of the layers, so that they
+  //! aren't reallocated whenever the batch size changes.
+  std::vector<double> arena;
+
+  //! The number of rows of the output of each layer held by the arena (0 if
+  //! the output isn't held by the arena).
+  std::vector<size_t> arenaRows;
+
+  //! The largest batch size the arena can hold.
+  size_t arenaBatchSize;
+
+  //! Whether each layer computes its output in the arena memory of the output
+  //! of the previous layer (empty if none does).
+  std::vector<bool> arenaInPlace;
+
+  //! The number of layers between two layers whose outputs are kept during
+  //! training.
+  size_t checkpointInterval;
+
+  //! The checkpoint interval the arena was planned for.
+  size_t arenaCheckpointInterval;
+
+  //! Whether the output of each layer is recomputed during the backward pass
+  //! (empty if none is).
+  std::vector<bool> arenaRecomputed;
+
+  //! The number of rows of the arena shared by the runs of recomputed layers.
+  size_t arenaSharedRows;
+
   //! Locally-stored copy visitor
   CopyVisitor<CustomLayers...> copyVisitor;
 
+  //! The number of parts each training batch is split into.
+  size_t replicas;
+
+  //! Copies of the network that process all but the first part of a training
+  //! batch; their weights point into the parameters.
+  std::vector<FFN*> replicaNetworks;
+
+  //! The memory of the parameters the replicas point into.
+  const double* replicaParameter;
+
+  //! The gradients of the parts of a batch processed by the replicas.
+  std::vector<arma::mat> replicaGradients;
+
+  //! Locally-stored output of the whole batch, gathered from the replicas.
+  arma::mat replicaOutput;
+
+  //! Locally-stored error of the whole batch, scattered to the replicas.
+  arma::mat replicaError;
+
+  //! The profiler of the layers, if any; it isn't owned by the network.
+  LayerProfiler* profiler;
+
   // The GAN class should have access to internal members.
   template<
     typename Model,
@@ -39,7 +39,14 @@ FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::FFN(
     height(0),
     reset(false),
     numFunctions(0),
-    deterministic(false)
+    deterministic(false),
+    arenaBatchSize(0),
+    checkpointInterval(0),
+    arenaCheckpointInterval(0),
+    arenaSharedRows(0),
+    replicas(1),
+    replicaParameter(NULL),
+    profiler(NULL)
 {
   /* Nothing to do here. */
 }
@@ -48,6 +55,7 @@ template<typename OutputLayerType, typename InitializationRuleType,
          typename... CustomLayers>
 FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::~FFN()
 {
+  ClearReplicas();
   std::for_each(network.begin(), network.end(),
       boost::apply_visitor(deleteVisitor));
 }
@@ -59,6 +67,26 @@ void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::ResetData(
 {
   numFunctions = responses.n_cols;
   this->predictors = std::move(predictors);
+  this->sparsePredictors.reset();
+  this->responses = std::move(responses);
+  this->deterministic = false;
+  ResetDeterministic();
+
+  if (!reset)
+    ResetParameters();
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::ResetData(
+    arma::sp_mat predictors, arma::mat responses)
+{
+  // Check the first layer before any (possibly parallel) pass uses it.
+  SparseInputLayer();
+
+  numFunctions = responses.n_cols;
+  this->predictors.reset();
+  this->sparsePredictors = std::move(predictors);
   this->responses = std::move(responses);
   this->deterministic = false;
   ResetDeterministic();
@@ -149,6 +177,62 @@ double FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Train(
   return out;
 }
 
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+template<typename OptimizerType, typename... CallbackTypes>
+double FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Train(
+    arma::sp_mat predictors,
+    arma::mat responses,
+    OptimizerType& optimizer,
+    CallbackTypes&&... callbacks)
+{
+  ResetData(std::move(predictors), std::move(responses));
+
+  WarnMessageMaxIterations<OptimizerType>(optimizer,
+      this->sparsePredictors.n_cols);
+
+  // Train the model.
+  Timer::Start("ffn_optimization");
+  const double out = optimizer.Optimize(*this, parameter, callbacks...);
+  Timer::Stop("ffn_optimization");
+
+  Log::Info << "FFN::FFN(): final objective of trained model is " << out
+      << "." << std::endl;
+  return out;
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+template<typename SourceType, typename OptimizerType, typename... CallbackTypes>
+double FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Train(
+    data::PrefetchLoader<SourceType>& loader,
+    OptimizerType& optimizer,
+    const size_t passes,
+    CallbackTypes&&... callbacks)
+{
+  double out = 0;
+  arma::mat chunkPredictors, chunkResponses;
+
+  Timer::Start("ffn_optimization");
+  for (size_t pass = 0; pass < passes; ++pass)
+  {
+    // The loader starts its first pass on construction.
+    if (pass > 0)
+      loader.Reset();
+
+    while (loader.Next(chunkPredictors, chunkResponses))
+    {
+      ResetData(std::move(chunkPredictors), std::move(chunkResponses));
+      out = optimizer.Optimize(*this, parameter, callbacks...);
+    }
+  }
+  Timer::Stop("ffn_optimization");
+
+  Log::Info << "FFN::FFN(): final objective of trained model is " << out
+      << "." << std::endl;
+  return out;
+}
+
 template<typename OutputLayerType, typename InitializationRuleType,
          typename... CustomLayers>
 template<typename PredictorsType, typename ResponsesType>
@@ -207,9 +291,8 @@ double FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Backward(
 
   gradients = arma::zeros<arma::mat>(parameter.n_rows, parameter.n_cols);
 
-  Backward();
   ResetGradients(gradients);
-  Gradient(inputs);
+  BackwardGradient(inputs);
 
   return res;
 }
@@ -246,6 +329,68 @@ void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Predict(
   }
 }
 
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Predict(
+    const arma::sp_mat& predictors, arma::mat& results)
+{
+  SparseInputLayer();
+
+  if (parameter.is_empty())
+    ResetParameters();
+
+  if (!deterministic)
+  {
+    deterministic = true;
+    ResetDeterministic();
+  }
+
+  for (size_t i = 0; i < predictors.n_cols; ++i)
+  {
+    Forward(arma::sp_mat(predictors.col(i)));
+
+    const arma::mat& output = boost::apply_visitor(outputParameterVisitor,
+        network.back());
+    if (i == 0)
+      results.set_size(output.n_elem, predictors.n_cols);
+    results.col(i) = output.col(0);
+  }
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Predict(
+    const arma::mat& predictors,
+    arma::mat& results,
+    InferenceContext<FFN>& context) const
+{
+  if (parameter.is_empty())
+  {
+    throw std::invalid_argument("FFN::Predict(): the network has no "
+        "parameters; train it or call ResetParameters() first");
+  }
+
+  if (!context.Ready(parameter))
+  {
+    context.Clear();
+
+    // The layers of the context are a copy of the layers of this network, and
+    // the parameters of the context are an alias of the parameters of this
+    // network, so that the context never initializes them.
+    FFN* replica = Replicate();
+    replica->parameter = arma::mat(const_cast<double*>(parameter.memptr()),
+        parameter.n_rows, parameter.n_cols, false, true);
+    replica->arenaInPlace = arenaInPlace;
+    replica->deterministic = true;
+    replica->ResetDeterministic();
+
+    context.network = replica;
+    context.parameter = parameter.memptr();
+  }
+
+  context.network->Predict(predictors, results);
+}
+
 template<typename OutputLayerType, typename InitializationRuleType,
          typename... CustomLayers>
 template<typename PredictorsType, typename ResponsesType>
@@ -280,7 +425,7 @@ double FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Evaluate(
     const arma::mat& parameters)
 {
   double res = 0;
-  for (size_t i = 0; i < predictors.n_cols; ++i)
+  for (size_t i = 0; i < numFunctions; ++i)
     res += Evaluate(parameters, i, 1, true);
 
   return res;
@@ -303,7 +448,11 @@ double FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Evaluate(
     ResetDeterministic();
   }
 
-  Forward(predictors.cols(begin, begin + batchSize - 1));
+  if (sparsePredictors.is_empty())
+    Forward(predictors.cols(begin, begin + batchSize - 1));
+  else
+    Forward(arma::sp_mat(sparsePredictors.cols(begin, begin + batchSize - 1)));
+
   double res = outputLayer.Forward(
       boost::apply_visitor(outputParameterVisitor, network.back()),
       responses.cols(begin, begin + batchSize - 1));
@@ -331,7 +480,7 @@ double FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::
 EvaluateWithGradient(const arma::mat& parameters, GradType& gradient)
 {
   double res = 0;
-  for (size_t i = 0; i < predictors.n_cols; ++i)
+  for (size_t i = 0; i < numFunctions; ++i)
     res += EvaluateWithGradient(parameters, i, gradient, 1);
 
   return res;
@@ -364,7 +513,23 @@ EvaluateWithGradient(const arma::mat& /* parameters */,
     ResetDeterministic();
   }
 
-  Forward(predictors.cols(begin, begin + batchSize - 1));
+  // The backward pass needs the input of each activation.
+  if (!arenaInPlace.empty())
+  {
+    arenaInPlace.clear();
+    arenaRows.clear();
+  }
+
+  // The replicas are copies of the layers after the first pass, which sets the
+  // sizes of their inputs.
+  if (replicas > 1 && batchSize > 1 && reset)
+    return ParallelEvaluateWithGradient(begin, gradient, batchSize);
+
+  if (sparsePredictors.is_empty())
+    Forward(predictors.cols(begin, begin + batchSize - 1));
+  else
+    Forward(arma::sp_mat(sparsePredictors.cols(begin, begin + batchSize - 1)));
+
   double res = outputLayer.Forward(
       boost::apply_visitor(outputParameterVisitor, network.back()),
       responses.cols(begin, begin + batchSize - 1));
@@ -379,9 +544,16 @@ EvaluateWithGradient(const arma::mat& /* parameters */,
       responses.cols(begin, begin + batchSize - 1),
       error);
 
-  Backward();
   ResetGradients(gradient);
-  Gradient(predictors.cols(begin, begin + batchSize - 1));
+  if (sparsePredictors.is_empty())
+  {
+    BackwardGradient(predictors.cols(begin, begin + batchSize - 1));
+  }
+  else
+  {
+    BackwardGradient(arma::sp_mat(sparsePredictors.cols(begin,
+        begin + batchSize - 1)));
+  }
 
   return res;
 }
@@ -397,11 +569,174 @@ void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Gradient(
   this->EvaluateWithGradient(parameters, begin, gradient, batchSize);
 }
 
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+template<typename GradType>
+double FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::
+ParallelEvaluateWithGradient(const size_t begin,
+                             GradType& gradient,
+                             const size_t batchSize)
+{
+  const size_t parts = std::min(replicas, batchSize);
+  if (replicaNetworks.size() != parts - 1 ||
+      replicaParameter != parameter.memptr() ||
+      replicaNetworks[0]->network.size() != network.size())
+  {
+    ResetReplicas(parts);
+  }
+
+  // Part p holds the points first[p] to first[p + 1] - 1 of the batch.
+  std::vector<size_t> first(parts + 1);
+  for (size_t p = 0; p <= parts; ++p)
+    first[p] = p * batchSize / parts;
+
+  #pragma omp parallel for
+  for (omp_size_t p = 0; p < (omp_size_t) parts; ++p)
+  {
+    FFN& replica = (p == 0) ? *this : *replicaNetworks[p - 1];
+    if (sparsePredictors.is_empty())
+    {
+      replica.Forward(predictors.cols(begin + first[p],
+          begin + first[p + 1] - 1));
+    }
+    else
+    {
+      replica.Forward(arma::sp_mat(sparsePredictors.cols(begin + first[p],
+          begin + first[p + 1] - 1)));
+    }
+  }
+
+  // The output layer sees the whole batch, so that losses normalized by the
+  // batch size give the same result as without replicas.
+  double res = 0;
+  for (size_t p = 0; p < parts; ++p)
+  {
+    FFN& replica = (p == 0) ? *this : *replicaNetworks[p - 1];
+    const arma::mat& output = boost::apply_visitor(outputParameterVisitor,
+        replica.network.back());
+    if (p == 0)
+      replicaOutput.set_size(output.n_rows, batchSize);
+
+    replicaOutput.cols(first[p], first[p + 1] - 1) = output;
+
+    for (size_t i = 0; i < network.size(); ++i)
+      res += boost::apply_visitor(lossVisitor, replica.network[i]);
+  }
+
+  res += outputLayer.Forward(replicaOutput,
+      responses.cols(begin, begin + batchSize - 1));
+  outputLayer.Backward(replicaOutput,
+      responses.cols(begin, begin + batchSize - 1), replicaError);
+
+  for (size_t p = 1; p < parts; ++p)
+    replicaGradients[p - 1].zeros(parameter.n_rows, parameter.n_cols);
+
+  #pragma omp parallel for
+  for (omp_size_t p = 0; p < (omp_size_t) parts; ++p)
+  {
+    FFN& replica = (p == 0) ? *this : *replicaNetworks[p - 1];
+    arma::mat& replicaGradient = (p == 0) ? gradient : replicaGradients[p - 1];
+
+    replica.error = replicaError.cols(first[p], first[p + 1] - 1);
+    replica.ResetGradients(replicaGradient);
+    if (sparsePredictors.is_empty())
+    {
+      replica.BackwardGradient(predictors.cols(begin + first[p],
+          begin + first[p + 1] - 1));
+    }
+    else
+    {
+      replica.BackwardGradient(arma::sp_mat(sparsePredictors.cols(
+          begin + first[p], begin + first[p + 1] - 1)));
+    }
+  }
+
+  for (size_t p = 1; p < parts; ++p)
+    gradient += replicaGradients[p - 1];
+
+  return res;
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void FFN<OutputLayerType, InitializationRuleType,
+         CustomLayers...>::ResetReplicas(const size_t parts)
+{
+  ClearReplicas();
+
+  for (size_t p = 1; p < parts; ++p)
+  {
+    FFN* replica = Replicate();
+    replica->checkpointInterval = checkpointInterval;
+    replica->ResetDeterministic();
+    replicaNetworks.push_back(replica);
+  }
+
+  replicaGradients.resize(parts - 1);
+  replicaParameter = parameter.memptr();
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+FFN<OutputLayerType, InitializationRuleType, CustomLayers...>*
+FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Replicate() const
+{
+  FFN* replica = new FFN(outputLayer, initializeRule);
+  replica->width = width;
+  replica->height = height;
+  replica->reset = reset;
+
+  // The weights are only read through the replica, so they can point into the
+  // parameters of this network.
+  arma::mat& sharedParameter = const_cast<arma::mat&>(parameter);
+  size_t offset = 0;
+  for (size_t i = 0; i < network.size(); ++i)
+  {
+    replica->network.push_back(boost::apply_visitor(copyVisitor, network[i]));
+    offset += boost::apply_visitor(WeightSetVisitor(sharedParameter, offset),
+        replica->network.back());
+    boost::apply_visitor(resetVisitor, replica->network.back());
+  }
+
+  return replica;
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void FFN<OutputLayerType, InitializationRuleType,
+         CustomLayers...>::ClearReplicas()
+{
+  for (size_t i = 0; i < replicaNetworks.size(); ++i)
+    delete replicaNetworks[i];
+
+  replicaNetworks.clear();
+  replicaGradients.clear();
+  replicaParameter = NULL;
+}
+
 template<typename OutputLayerType, typename InitializationRuleType,
          typename... CustomLayers>
 void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Shuffle()
 {
-  math::ShuffleData(predictors, responses, predictors, responses);
+  if (sparsePredictors.is_empty())
+  {
+    math::ShuffleData(predictors, responses, predictors, responses);
+    return;
+  }
+
+  // Permute the columns of the sparse predictors with a product, which keeps
+  // them sparse.
+  const arma::uvec ordering = arma::shuffle(arma::linspace<arma::uvec>(0,
+      responses.n_cols - 1, responses.n_cols));
+  arma::umat locations(2, ordering.n_elem);
+  locations.row(0) = ordering.t();
+  locations.row(1) = arma::linspace<arma::urowvec>(0, ordering.n_elem - 1,
+      ordering.n_elem);
+  const arma::sp_mat permutation(locations, arma::ones<arma::vec>(
+      ordering.n_elem), ordering.n_elem, ordering.n_elem);
+
+  sparsePredictors = sparsePredictors * permutation;
+  responses = arma::mat(responses.cols(ordering));
 }
 
 template<typename OutputLayerType, typename InitializationRuleType,
@@ -409,6 +744,7 @@ template<typename OutputLayerType, typename InitializationRuleType,
 void FFN<OutputLayerType, InitializationRuleType,
          CustomLayers...>::ResetParameters()
 {
+  ClearReplicas();
   ResetDeterministic();
 
   // Reset the network parameter with the given initialization rule.
@@ -417,6 +753,124 @@ void FFN<OutputLayerType, InitializationRuleType,
   networkInit.Initialize(network, parameter);
 }
 
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void FFN<OutputLayerType, InitializationRuleType,
+         CustomLayers...>::OptimizeForInference()
+{
+  if (network.empty() || parameter.is_empty())
+  {
+    throw std::invalid_argument("FFN::OptimizeForInference(): the network "
+        "must have layers and trained or initialized parameters!");
+  }
+
+  std::vector<LayerTypes<CustomLayers...> > layers;
+  std::vector<size_t> offsets, sizes;
+  size_t keptWeights = 0;
+  for (size_t i = 0, offset = 0; i < network.size(); ++i)
+  {
+    const size_t weights = boost::apply_visitor(weightSizeVisitor,
+        network[i]);
+    offset += weights;
+
+    // These layers are the identity in deterministic mode.
+    if (boost::get<Dropout<>*>(&network[i]) ||
+        boost::get<AlphaDropout<>*>(&network[i]) ||
+        boost::get<SpatialDropout<>*>(&network[i]) ||
+        boost::get<IdentityLayer<>*>(&network[i]))
+    {
+      boost::apply_visitor(deleteVisitor, network[i]);
+      continue;
+    }
+
+    // The weights of the previous layer still point into the parameters, so
+    // the BatchNorm layer is folded into them in place.
+    BatchNorm<>** batchNorm = boost::get<BatchNorm<>*>(&network[i]);
+    if (batchNorm && !layers.empty())
+    {
+      const arma::vec scale = (*batchNorm)->Parameters().rows(0,
+          (*batchNorm)->InputSize() - 1) / arma::sqrt(
+          (*batchNorm)->TrainingVariance() + (*batchNorm)->Epsilon());
+      const arma::vec shift = (*batchNorm)->Parameters().rows(
+          (*batchNorm)->InputSize(), 2 * (*batchNorm)->InputSize() - 1) -
+          scale % (*batchNorm)->TrainingMean();
+
+      Linear<>** linear = boost::get<Linear<>*>(&layers.back());
+      Convolution<>** convolution = boost::get<Convolution<>*>(
+          &layers.back());
+      if (linear && (*linear)->OutputSize() == scale.n_elem)
+      {
+        (*linear)->Weight().each_col() %= scale;
+        (*linear)->Bias() = (*linear)->Bias() % scale + shift;
+        boost::apply_visitor(deleteVisitor, network[i]);
+        continue;
+      }
+      else if (convolution && (*convolution)->OutputSize() == scale.n_elem)
+      {
+        const size_t inSize = (*convolution)->InputSize();
+        for (size_t j = 0; j < scale.n_elem; ++j)
+        {
+          (*convolution)->Weight().slices(j * inSize, (j + 1) * inSize - 1) *=
+              scale[j];
+          (*convolution)->Bias()(j) = (*convolution)->Bias()(j) * scale[j] +
+              shift[j];
+        }
+
+        boost::apply_visitor(deleteVisitor, network[i]);
+        continue;
+      }
+    }
+
+    layers.push_back(network[i]);
+    offsets.push_back(offset - weights);
+    sizes.push_back(weights);
+    keptWeights += weights;
+  }
+
+  // Only the weights of the remaining layers are kept.
+  arma::mat compactParameter(keptWeights, 1);
+  for (size_t i = 0, start = 0; i < offsets.size(); start += sizes[i++])
+  {
+    if (sizes[i] != 0)
+    {
+      compactParameter.rows(start, start + sizes[i] - 1) =
+          parameter.rows(offsets[i], offsets[i] + sizes[i] - 1);
+    }
+  }
+
+  // Resetting a layer may initialize its weights (as BatchNorm does), so the
+  // kept weights are restored afterwards.
+  network = std::move(layers);
+  parameter = compactParameter;
+  for (size_t i = 0, offset = 0; i < network.size(); ++i)
+  {
+    offset += boost::apply_visitor(WeightSetVisitor(parameter, offset),
+        network[i]);
+    boost::apply_visitor(resetVisitor, network[i]);
+  }
+  parameter = compactParameter;
+
+  deterministic = true;
+  ResetDeterministic();
+  ClearReplicas();
+
+  // The elementwise activations can overwrite their input.
+  arenaInPlace.assign(network.size(), false);
+  for (size_t i = 1; i < network.size(); ++i)
+  {
+    const MoreTypes* more = boost::get<MoreTypes>(&network[i]);
+    arenaInPlace[i] = boost::get<SigmoidLayer<>*>(&network[i]) ||
+        boost::get<TanHLayer<>*>(&network[i]) ||
+        boost::get<SoftPlusLayer<>*>(&network[i]) ||
+        boost::get<ReLULayer<>*>(&network[i]) ||
+        (more && (boost::get<FastSigmoidLayer<>*>(more) ||
+        boost::get<FastTanHLayer<>*>(more)));
+  }
+
+  // The arena is planned again for the new layers.
+  arenaRows.clear();
+}
+
 template<typename OutputLayerType, typename InitializationRuleType,
          typename... CustomLayers>
 void FFN<OutputLayerType, InitializationRuleType,
@@ -446,9 +900,26 @@ template<typename InputType>
 void FFN<OutputLayerType, InitializationRuleType,
          CustomLayers...>::Forward(const InputType& input)
 {
-  boost::apply_visitor(ForwardVisitor(input,
-      boost::apply_visitor(outputParameterVisitor, network.front())),
-      network.front());
+  // Once the sizes of the outputs are known from an earlier pass, the layers
+  // write into the arena.
+  if (arenaRows.size() == network.size())
+  {
+    if (arenaCheckpointInterval != checkpointInterval)
+      PlanCheckpoints();
+
+    if (input.n_cols > arenaBatchSize)
+      AllocateArena(input.n_cols);
+
+    AliasArena(input.n_cols);
+  }
+
+  if (profiler)
+    profiler->Start();
+
+  ForwardFirst(input);
+
+  if (profiler)
+    profiler->Stop(0, LayerProfiler::FORWARD);
 
   if (!reset)
   {
@@ -474,10 +945,16 @@ void FFN<OutputLayerType, InitializationRuleType,
       boost::apply_visitor(SetInputHeightVisitor(height), network[i]);
     }
 
+    if (profiler)
+      profiler->Start();
+
     boost::apply_visitor(ForwardVisitor(boost::apply_visitor(
         outputParameterVisitor, network[i - 1]),
         boost::apply_visitor(outputParameterVisitor, network[i])), network[i]);
 
+    if (profiler)
+      profiler->Stop(i, LayerProfiler::FORWARD);
+
     if (!reset)
     {
       // Get the output width.
@@ -496,23 +973,41 @@ void FFN<OutputLayerType, InitializationRuleType,
 
   if (!reset)
     reset = true;
+
+  if (arenaRows.size() != network.size())
+    ResetArena(input.n_cols);
+
+  if (profiler)
+    ProfileMemory();
 }
 
 template<typename OutputLayerType, typename InitializationRuleType,
          typename... CustomLayers>
 void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Backward()
 {
+  if (profiler)
+    profiler->Start();
+
   boost::apply_visitor(BackwardVisitor(boost::apply_visitor(
       outputParameterVisitor, network.back()), error,
       boost::apply_visitor(deltaVisitor, network.back())), network.back());
 
+  if (profiler)
+    profiler->Stop(network.size() - 1, LayerProfiler::BACKWARD);
+
   for (size_t i = 2; i < network.size(); ++i)
   {
+    if (profiler)
+      profiler->Start();
+
     boost::apply_visitor(BackwardVisitor(boost::apply_visitor(
         outputParameterVisitor, network[network.size() - i]),
         boost::apply_visitor(deltaVisitor, network[network.size() - i + 1]),
         boost::apply_visitor(deltaVisitor, network[network.size() - i])),
         network[network.size() - i]);
+
+    if (profiler)
+      profiler->Stop(network.size() - i, LayerProfiler::BACKWARD);
   }
 }
 
@@ -522,19 +1017,39 @@ template<typename InputType>
 void FFN<OutputLayerType, InitializationRuleType,
          CustomLayers...>::Gradient(const InputType& input)
 {
-  boost::apply_visitor(GradientVisitor(input,
-      boost::apply_visitor(deltaVisitor, network[1])), network.front());
+  if (profiler)
+    profiler->Start();
+
+  GradientFirst(input, boost::apply_visitor(deltaVisitor, network[1]));
+
+  if (profiler)
+    profiler->Stop(0, LayerProfiler::GRADIENT);
 
   for (size_t i = 1; i < network.size() - 1; ++i)
   {
+    if (profiler)
+      profiler->Start();
+
     boost::apply_visitor(GradientVisitor(boost::apply_visitor(
         outputParameterVisitor, network[i - 1]),
         boost::apply_visitor(deltaVisitor, network[i + 1])), network[i]);
+
+    if (profiler)
+      profiler->Stop(i, LayerProfiler::GRADIENT);
   }
 
+  if (profiler)
+    profiler->Start();
+
   boost::apply_visitor(GradientVisitor(boost::apply_visitor(
       outputParameterVisitor, network[network.size() - 2]), error),
       network[network.size() - 1]);
+
+  if (profiler)
+  {
+    profiler->Stop(network.size() - 1, LayerProfiler::GRADIENT);
+    ProfileMemory();
+  }
 }
 
 template<typename OutputLayerType, typename InitializationRuleType,
@@ -590,6 +1105,364 @@ void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::serialize(
 
     deterministic = true;
     ResetDeterministic();
+
+    // The loaded layers hold their own outputs.
+    arenaRows.clear();
+    arenaInPlace.clear();
+    arenaRecomputed.clear();
+    ClearReplicas();
+  }
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void FFN<OutputLayerType, InitializationRuleType,
+         CustomLayers...>::ResetArena(const size_t batchSize)
+{
+  arenaRows.assign(network.size(), 0);
+  for (size_t i = 0; i < network.size(); ++i)
+  {
+    const arma::mat& output = boost::apply_visitor(outputParameterVisitor,
+        network[i]);
+    if (output.n_cols == batchSize)
+      arenaRows[i] = output.n_rows;
+  }
+
+  // The arena is allocated for the new sizes by the next forward pass.
+  PlanCheckpoints();
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void FFN<OutputLayerType, InitializationRuleType,
+         CustomLayers...>::AllocateArena(const size_t batchSize)
+{
+  // Each layer needs its output and its delta, which has the size of the
+  // output of the previous layer.  The delta of the first layer is never
+  // computed.  The recomputed outputs of each run of layers share the memory
+  // of the largest run.
+  size_t rows = 0, runRows = 0;
+  arenaSharedRows = 0;
+  for (size_t i = 0; i < network.size(); ++i)
+  {
+    if (ArenaRecomputed(i))
+    {
+      runRows += arenaRows[i];
+      arenaSharedRows = std::max(arenaSharedRows, runRows);
+    }
+    else
+    {
+      runRows = 0;
+      rows += ArenaInPlace(i) ? 0 : arenaRows[i];
+    }
+
+    rows += (i > 0) ? arenaRows[i - 1] : 0;
+  }
+  rows += arenaSharedRows;
+
+  // Keep the previous arena until no layer points into it anymore.
+  std::vector<double> oldArena(rows * batchSize);
+  arena.swap(oldArena);
+  arenaBatchSize = batchSize;
+
+  const double* begin = oldArena.data();
+  const double* end = oldArena.data() + oldArena.size();
+  for (size_t i = 0; i < network.size(); ++i)
+  {
+    arma::mat* matrices[2] = {
+        &boost::apply_visitor(outputParameterVisitor, network[i]),
+        &boost::apply_visitor(deltaVisitor, network[i]) };
+    for (size_t j = 0; j < 2; ++j)
+    {
+      if (matrices[j]->memptr() >= begin && matrices[j]->memptr() < end)
+      {
+        arma::mat matrix(*matrices[j]);
+        matrices[j]->reset();
+        *matrices[j] = std::move(matrix);
+      }
+    }
+  }
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void FFN<OutputLayerType, InitializationRuleType,
+         CustomLayers...>::AliasArena(const size_t batchSize)
+{
+  // The memory shared by the runs of recomputed layers comes first.
+  double* shared = arena.data();
+  double* memory = arena.data() + arenaSharedRows * arenaBatchSize;
+  for (size_t i = 0; i < network.size(); ++i)
+  {
+    const size_t outputRows = arenaRows[i];
+    const size_t deltaRows = (i > 0) ? arenaRows[i - 1] : 0;
+
+    arma::mat& output = boost::apply_visitor(outputParameterVisitor,
+        network[i]);
+    double* outputMemory;
+    if (ArenaRecomputed(i))
+    {
+      outputMemory = shared;
+      shared += outputRows * arenaBatchSize;
+    }
+    else
+    {
+      outputMemory = ArenaInPlace(i) ? boost::apply_visitor(
+          outputParameterVisitor, network[i - 1]).memptr() : memory;
+      shared = arena.data();
+      if (!ArenaInPlace(i))
+        memory += outputRows * arenaBatchSize;
+    }
+
+    if (outputRows != 0 && (output.memptr() != outputMemory ||
+        output.n_rows != outputRows || output.n_cols != batchSize))
+    {
+      output = arma::mat(outputMemory, outputRows, batchSize, false, false);
+    }
+
+    arma::mat& delta = boost::apply_visitor(deltaVisitor, network[i]);
+    if (deltaRows != 0 && (delta.memptr() != memory ||
+        delta.n_rows != deltaRows || delta.n_cols != batchSize))
+    {
+      delta = arma::mat(memory, deltaRows, batchSize, false, false);
+    }
+    memory += deltaRows * arenaBatchSize;
+  }
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+bool FFN<OutputLayerType, InitializationRuleType,
+         CustomLayers...>::ArenaInPlace(const size_t i) const
+{
+  return i > 0 && i < arenaInPlace.size() && arenaInPlace[i] &&
+      arenaRows[i] != 0 && arenaRows[i] == arenaRows[i - 1] &&
+      !ArenaRecomputed(i) && !ArenaRecomputed(i - 1);
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void FFN<OutputLayerType, InitializationRuleType,
+         CustomLayers...>::PlanCheckpoints()
+{
+  arenaCheckpointInterval = checkpointInterval;
+  arenaRecomputed.clear();
+  arenaBatchSize = 0;
+
+  if (checkpointInterval <= 1)
+    return;
+
+  // The output of the last layer is needed by the output layer.
+  arenaRecomputed.assign(network.size(), false);
+  for (size_t i = 0; i + 1 < network.size(); ++i)
+  {
+    arenaRecomputed[i] = ((i + 1) % checkpointInterval != 0) &&
+        arenaRows[i] != 0 && Recomputable(i);
+  }
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+bool FFN<OutputLayerType, InitializationRuleType,
+         CustomLayers...>::ArenaRecomputed(const size_t i) const
+{
+  return i < arenaRecomputed.size() && arenaRecomputed[i];
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+bool FFN<OutputLayerType, InitializationRuleType,
+         CustomLayers...>::Recomputable(const size_t i) const
+{
+  const MoreTypes* more = boost::get<MoreTypes>(&network[i]);
+  return boost::get<Linear<>*>(&network[i]) ||
+      boost::get<LinearNoBias<>*>(&network[i]) ||
+      boost::get<Convolution<>*>(&network[i]) ||
+      boost::get<MaxPooling<>*>(&network[i]) ||
+      boost::get<MeanPooling<>*>(&network[i]) ||
+      boost::get<Padding<>*>(&network[i]) ||
+      boost::get<IdentityLayer<>*>(&network[i]) ||
+      boost::get<SigmoidLayer<>*>(&network[i]) ||
+      boost::get<TanHLayer<>*>(&network[i]) ||
+      boost::get<SoftPlusLayer<>*>(&network[i]) ||
+      boost::get<ReLULayer<>*>(&network[i]) ||
+      boost::get<LeakyReLU<>*>(&network[i]) ||
+      boost::get<ELU<>*>(&network[i]) ||
+      boost::get<HardTanH<>*>(&network[i]) ||
+      boost::get<PReLU<>*>(&network[i]) ||
+      boost::get<LogSoftMax<>*>(&network[i]) ||
+      boost::get<Softmax<>*>(&network[i]) ||
+      (more && (boost::get<FastSigmoidLayer<>*>(more) ||
+      boost::get<FastTanHLayer<>*>(more)));
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+template<typename InputType>
+void FFN<OutputLayerType, InitializationRuleType,
+         CustomLayers...>::BackwardGradient(const InputType& input)
+{
+  // The outputs are all kept until the arena is planned and allocated.
+  if (arenaRecomputed.empty() || arenaBatchSize == 0)
+  {
+    Backward();
+    Gradient(input);
+    return;
+  }
+
+  // The outputs of the last run of recomputed layers are still in the shared
+  // memory after the forward pass.
+  size_t validRun = network.size();
+  for (size_t i = network.size(); i-- > 0; )
+  {
+    if (ArenaRecomputed(i))
+      validRun = i;
+    else if (validRun != network.size())
+      break;
+  }
+
+  const size_t last = network.size() - 1;
+  for (size_t i = last + 1; i-- > 0; )
+  {
+    // The backward pass of a layer needs its output, and its gradient needs
+    // its input.
+    for (size_t j = (i > 0) ? i - 1 : i; j <= i; ++j)
+    {
+      if (!ArenaRecomputed(j))
+        continue;
+
+      size_t first = j;
+      while (first > 0 && ArenaRecomputed(first - 1))
+        --first;
+
+      if (first == validRun)
+        continue;
+
+      for (size_t l = first; ArenaRecomputed(l); ++l)
+      {
+        if (profiler)
+          profiler->Start();
+
+        if (l == 0)
+        {
+          ForwardFirst(input);
+        }
+        else
+        {
+          boost::apply_visitor(ForwardVisitor(boost::apply_visitor(
+              outputParameterVisitor, network[l - 1]),
+              boost::apply_visitor(outputParameterVisitor, network[l])),
+              network[l]);
+        }
+
+        if (profiler)
+          profiler->Stop(l, LayerProfiler::FORWARD);
+      }
+      validRun = first;
+    }
+
+    const arma::mat& layerError = (i == last) ? error :
+        boost::apply_visitor(deltaVisitor, network[i + 1]);
+    if (i > 0)
+    {
+      if (profiler)
+        profiler->Start();
+
+      boost::apply_visitor(BackwardVisitor(boost::apply_visitor(
+          outputParameterVisitor, network[i]), layerError,
+          boost::apply_visitor(deltaVisitor, network[i])), network[i]);
+
+      if (profiler)
+      {
+        profiler->Stop(i, LayerProfiler::BACKWARD);
+        profiler->Start();
+      }
+
+      boost::apply_visitor(GradientVisitor(boost::apply_visitor(
+          outputParameterVisitor, network[i - 1]), layerError), network[i]);
+    }
+    else
+    {
+      if (profiler)
+        profiler->Start();
+
+      GradientFirst(input, layerError);
+    }
+
+    if (profiler)
+      profiler->Stop(i, LayerProfiler::GRADIENT);
+  }
+
+  if (profiler)
+    ProfileMemory();
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+Linear<>& FFN<OutputLayerType, InitializationRuleType,
+              CustomLayers...>::SparseInputLayer()
+{
+  Linear<>** layer = network.empty() ? NULL :
+      boost::get<Linear<>*>(&network.front());
+  if (layer == NULL)
+  {
+    throw std::invalid_argument("FFN: the first layer must be a Linear<> "
+        "layer to use sparse predictors");
+  }
+
+  return **layer;
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+template<typename InputType>
+void FFN<OutputLayerType, InitializationRuleType,
+         CustomLayers...>::ForwardFirst(const InputType& input)
+{
+  boost::apply_visitor(ForwardVisitor(input,
+      boost::apply_visitor(outputParameterVisitor, network.front())),
+      network.front());
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void FFN<OutputLayerType, InitializationRuleType,
+         CustomLayers...>::ForwardFirst(const arma::sp_mat& input)
+{
+  Linear<>& layer = SparseInputLayer();
+  layer.Forward(input, layer.OutputParameter());
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+template<typename InputType>
+void FFN<OutputLayerType, InitializationRuleType,
+         CustomLayers...>::GradientFirst(const InputType& input,
+                                         const arma::mat& layerError)
+{
+  boost::apply_visitor(GradientVisitor(input, layerError), network.front());
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void FFN<OutputLayerType, InitializationRuleType,
+         CustomLayers...>::GradientFirst(const arma::sp_mat& input,
+                                         const arma::mat& layerError)
+{
+  Linear<>& layer = SparseInputLayer();
+  layer.Gradient(input, layerError, layer.Gradient());
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void FFN<OutputLayerType, InitializationRuleType,
+         CustomLayers...>::ProfileMemory()
+{
+  for (size_t i = 0; i < network.size(); ++i)
+  {
+    profiler->Memory(i, boost::apply_visitor(outputParameterVisitor,
+        network[i]).n_elem * sizeof(double), boost::apply_visitor(
+        deltaVisitor, network[i]).n_elem * sizeof(double));
   }
 }
 
@@ -614,6 +1487,19 @@ void FFN<OutputLayerType, InitializationRuleType,
   std::swap(inputParameter, network.inputParameter);
   std::swap(outputParameter, network.outputParameter);
   std::swap(gradient, network.gradient);
+  std::swap(arena, network.arena);
+  std::swap(arenaRows, network.arenaRows);
+  std::swap(arenaBatchSize, network.arenaBatchSize);
+  std::swap(arenaInPlace, network.arenaInPlace);
+  std::swap(checkpointInterval, network.checkpointInterval);
+  std::swap(arenaCheckpointInterval, network.arenaCheckpointInterval);
+  std::swap(arenaRecomputed, network.arenaRecomputed);
+  std::swap(arenaSharedRows, network.arenaSharedRows);
+  std::swap(replicas, network.replicas);
+  std::swap(replicaNetworks, network.replicaNetworks);
+  std::swap(replicaParameter, network.replicaParameter);
+  std::swap(replicaGradients, network.replicaGradients);
+  std::swap(profiler, network.profiler);
 };
 
 template<typename OutputLayerType, typename InitializationRuleType,
@@ -634,8 +1520,18 @@ FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::FFN(
     delta(network.delta),
     inputParameter(network.inputParameter),
     outputParameter(network.outputParameter),
-    gradient(network.gradient)
+    gradient(network.gradient),
+    arenaBatchSize(0),
+    arenaInPlace(network.arenaInPlace),
+    checkpointInterval(network.checkpointInterval),
+    arenaCheckpointInterval(0),
+    arenaSharedRows(0),
+    replicas(network.replicas),
+    replicaParameter(NULL),
+    profiler(NULL)
 {
+  // The copied layers hold their own outputs, so the arena of the new network
+  // is planned again on its first forward pass.
   // Build new layers according to source network
   for (size_t i = 0; i < network.network.size(); ++i)
   {
@@ -663,9 +1559,23 @@ FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::FFN(
     delta(std::move(network.delta)),
     inputParameter(std::move(network.inputParameter)),
     outputParameter(std::move(network.outputParameter)),
-    gradient(std::move(network.gradient))
+    gradient(std::move(network.gradient)),
+    arena(std::move(network.arena)),
+    arenaRows(std::move(network.arenaRows)),
+    arenaBatchSize(network.arenaBatchSize),
+    arenaInPlace(std::move(network.arenaInPlace)),
+    checkpointInterval(network.checkpointInterval),
+    arenaCheckpointInterval(network.arenaCheckpointInterval),
+    arenaRecomputed(std::move(network.arenaRecomputed)),
+    arenaSharedRows(network.arenaSharedRows),
+    replicas(network.replicas),
+    replicaNetworks(std::move(network.replicaNetworks)),
+    replicaParameter(network.replicaParameter),
+    replicaGradients(std::move(network.replicaGradients)),
+    profiler(network.profiler)
 {
   this->network = std::move(network.network);
+  network.replicaNetworks.clear();
 };
 
 template<typename OutputLayerType, typename InitializationRuleType,
@@ -49,6 +49,15 @@ namespace ann /** Artificial Neural Network. **/ {
  * }
  * @endcode
  *
+ * During training, the real points of a batch and the points generated from
+ * the noise go through the discriminator together, in a single pass over a
+ * batch of 2 * batchSize points (except for WGANGP, whose gradient penalty
+ * needs separate passes).  The noise is sampled in place into a buffer that is
+ * allocated once, in ResetData().  Since both halves are seen together, layers
+ * such as BatchNorm normalize over the merged batch, and an output layer that
+ * averages over its input (e.g. MeanSquaredError) averages over the merged
+ * batch.
+ *
  * @tparam Model The class type of Generator and Discriminator.
  * @tparam InitializationRuleType Type of Initializer.
  * @tparam Noise The noise function to use.
@@ -337,6 +346,25 @@ class GAN
   */
   void ResetDeterministic();
 
+  /**
+   * Prepare the batch of the discriminator in the 2 * batchSize columns of the
+   * predictors after the training data: the real points of the batch starting
+   * at the given point are followed by as many points generated from new
+   * noise.  The responses of the real points are 1 and the responses of the
+   * generated points are the given label.
+   *
+   * @param i Index of the first real point of the batch.
+   * @param fakeLabel Response of the generated points.
+   */
+  void GenerateBatch(const size_t i, const double fakeLabel);
+
+  /**
+   * Compute the gradient of the generator from the last pass of the
+   * discriminator over the batch of GenerateBatch(), with the generated points
+   * labeled as real ones.  The gradient is stored in gradientGenerator.
+   */
+  void UpdateGenerator();
+
   //! Locally stored parameter for training data + noise data.
   arma::mat predictors;
   //! Locally stored parameters of the network.
@@ -391,8 +419,6 @@ class GAN
   arma::mat noiseGradientDiscriminator;
   //! Locally stored norm of the gradient of Discriminator.
   arma::mat normGradientDiscriminator;
-  //! Locally stored noise using the noise function.
-  arma::mat noise;
   //! Locally stored gradient for Generator.
   arma::mat gradientGenerator;
   //! The current evaluation mode (training or testing).
@@ -90,7 +90,6 @@ GAN<Model, InitializationRuleType, Noise, PolicyType>::GAN(
     currentBatch(network.currentBatch),
     parameter(network.parameter),
     numFunctions(network.numFunctions),
-    noise(network.noise),
     deterministic(network.deterministic),
     genWeights(network.genWeights),
     discWeights(network.discWeights)
@@ -123,7 +122,6 @@ GAN<Model, InitializationRuleType, Noise, PolicyType>::GAN(
     currentBatch(network.currentBatch),
     parameter(std::move(network.parameter)),
     numFunctions(network.numFunctions),
-    noise(std::move(network.noise)),
     deterministic(network.deterministic),
     genWeights(network.genWeights),
     discWeights(network.discWeights)
@@ -143,27 +141,26 @@ void GAN<Model, InitializationRuleType, Noise, PolicyType>::ResetData(
   currentBatch = 0;
 
   numFunctions = trainData.n_cols;
-  noise.set_size(noiseDim, batchSize);
 
   deterministic = true;
   ResetDeterministic();
 
   /**
    * These predictors are shared by the discriminator network. The additional
-   * batch size predictors are taken from the generator network while training.
-   * For more details please look in EvaluateWithGradient() function.
+   * 2 * batchSize predictors hold the batches of the discriminator, which are
+   * made of real points and of points taken from the generator network while
+   * training.  For more details please look in GenerateBatch().
    */
-  this->predictors.set_size(trainData.n_rows, numFunctions + batchSize);
+  this->predictors.set_size(trainData.n_rows, numFunctions + 2 * batchSize);
   this->predictors.cols(0, numFunctions - 1) = std::move(trainData);
   this->discriminator.predictors = arma::mat(this->predictors.memptr(),
       this->predictors.n_rows, this->predictors.n_cols, false, false);
 
-  responses.ones(1, numFunctions + batchSize);
-  responses.cols(numFunctions, numFunctions + batchSize - 1) =
-      arma::zeros(1, batchSize);
+  responses.ones(1, numFunctions + 2 * batchSize);
   this->discriminator.responses = arma::mat(this->responses.memptr(),
       this->responses.n_rows, this->responses.n_cols, false, false);
 
+  // The noise of each batch is sampled into the predictors of the generator.
   this->generator.predictors.set_size(noiseDim, batchSize);
   this->generator.responses.set_size(predictors.n_rows, batchSize);
 
@@ -253,34 +250,16 @@ GAN<Model, InitializationRuleType, Noise, PolicyType>::Evaluate(
     ResetDeterministic();
   }
 
-  currentInput = arma::mat(predictors.memptr() + (i * predictors.n_rows),
-      predictors.n_rows, batchSize, false, false);
-  currentTarget = arma::mat(responses.memptr() + i, 1, batchSize, false,
-      false);
-
-  discriminator.Forward(currentInput);
-  double res = discriminator.outputLayer.Forward(
-      boost::apply_visitor(
-      outputParameterVisitor,
-      discriminator.network.back()), currentTarget);
-
-  noise.imbue( [&]() { return noiseFunction();} );
-  generator.Forward(noise);
-
-  predictors.cols(numFunctions, numFunctions + batchSize - 1) =
-      boost::apply_visitor(outputParameterVisitor, generator.network.back());
+  // The real and the generated points pass through the discriminator
+  // together.
+  GenerateBatch(i, 0.0);
   discriminator.Forward(predictors.cols(numFunctions,
-      numFunctions + batchSize - 1));
-  responses.cols(numFunctions, numFunctions + batchSize - 1) =
-      arma::zeros(1, batchSize);
+      numFunctions + 2 * batchSize - 1));
 
-  currentTarget = arma::mat(responses.memptr() + numFunctions,
-      1, batchSize, false, false);
-  res += discriminator.outputLayer.Forward(
+  return discriminator.outputLayer.Forward(
       boost::apply_visitor(outputParameterVisitor,
-      discriminator.network.back()), currentTarget);
-
-  return res;
+      discriminator.network.back()), responses.cols(numFunctions,
+      numFunctions + 2 * batchSize - 1));
 }
 
 template<
@@ -318,16 +297,6 @@ EvaluateWithGradient(const arma::mat& /* parameters */,
     ResetDeterministic();
   }
 
-  if (noiseGradientDiscriminator.is_empty())
-  {
-    noiseGradientDiscriminator = arma::zeros<arma::mat>(
-        gradientDiscriminator.n_elem, 1);
-  }
-  else
-  {
-    noiseGradientDiscriminator.zeros();
-  }
-
   gradientGenerator = arma::mat(gradient.memptr(),
       generator.Parameters().n_elem, 1, false, false);
 
@@ -335,49 +304,20 @@ EvaluateWithGradient(const arma::mat& /* parameters */,
       gradientGenerator.n_elem,
       discriminator.Parameters().n_elem, 1, false, false);
 
-  // Get the gradients of the Discriminator.
+  // Get the gradients of the Discriminator on the real and the generated
+  // points at once.
+  GenerateBatch(i, 0.0);
   double res = discriminator.EvaluateWithGradient(discriminator.parameter,
-      i, gradientDiscriminator, batchSize);
-
-  noise.imbue( [&]() { return noiseFunction();} );
-  generator.Forward(noise);
-  predictors.cols(numFunctions, numFunctions + batchSize - 1) =
-      boost::apply_visitor(outputParameterVisitor, generator.network.back());
-  responses.cols(numFunctions, numFunctions + batchSize - 1) =
-      arma::zeros(1, batchSize);
-
-  // Get the gradients of the Generator.
-  res += discriminator.EvaluateWithGradient(discriminator.parameter,
-      numFunctions, noiseGradientDiscriminator, batchSize);
-  gradientDiscriminator += noiseGradientDiscriminator;
+      numFunctions, gradientDiscriminator, 2 * batchSize);
 
   if (currentBatch % generatorUpdateStep == 0 && preTrainSize == 0)
   {
     // Minimize -log(D(G(noise))).
-    // Pass the error from Discriminator to Generator.
-    responses.cols(numFunctions, numFunctions + batchSize - 1) =
-        arma::ones(1, batchSize);
-
-    discriminator.outputLayer.Backward(
-        boost::apply_visitor(outputParameterVisitor,
-        discriminator.network.back()), discriminator.responses.cols(
-        numFunctions, numFunctions + batchSize - 1), discriminator.error);
-    discriminator.Backward();
-
-    generator.error = boost::apply_visitor(deltaVisitor,
-        discriminator.network[1]);
-
-    generator.Predictors() = noise;
-    generator.Backward();
-    generator.ResetGradients(gradientGenerator);
-    generator.Gradient(generator.Predictors().cols(0, batchSize - 1));
-
-    gradientGenerator *= multiplier;
+    UpdateGenerator();
   }
 
   currentBatch++;
 
-
   if (preTrainSize > 0)
   {
     preTrainSize--;
@@ -479,6 +419,61 @@ ResetDeterministic()
   this->generator.ResetDeterministic();
 }
 
+template<
+  typename Model,
+  typename InitializationRuleType,
+  typename Noise,
+  typename PolicyType
+>
+void GAN<Model, InitializationRuleType, Noise, PolicyType>::GenerateBatch(
+    const size_t i, const double fakeLabel)
+{
+  const size_t real = numFunctions;
+  const size_t fake = numFunctions + batchSize;
+
+  predictors.cols(real, fake - 1) = predictors.cols(i, i + batchSize - 1);
+
+  // The noise is sampled in place, in the predictors of the generator.
+  generator.predictors.imbue( [&]() { return noiseFunction();} );
+  generator.Forward(generator.predictors);
+  predictors.cols(fake, fake + batchSize - 1) =
+      boost::apply_visitor(outputParameterVisitor, generator.network.back());
+
+  responses.cols(real, fake - 1).ones();
+  responses.cols(fake, fake + batchSize - 1).fill(fakeLabel);
+}
+
+template<
+  typename Model,
+  typename InitializationRuleType,
+  typename Noise,
+  typename PolicyType
+>
+void GAN<Model, InitializationRuleType, Noise, PolicyType>::UpdateGenerator()
+{
+  const size_t fake = numFunctions + batchSize;
+
+  // The generator is trained to have its points taken as real ones.
+  responses.cols(fake, fake + batchSize - 1).ones();
+  discriminator.outputLayer.Backward(
+      boost::apply_visitor(outputParameterVisitor,
+      discriminator.network.back()), responses.cols(numFunctions,
+      fake + batchSize - 1), discriminator.error);
+
+  // Only the generated points pass their error to the generator.
+  discriminator.error.cols(0, batchSize - 1).zeros();
+  discriminator.Backward();
+
+  generator.error = boost::apply_visitor(deltaVisitor,
+      discriminator.network[1]).cols(batchSize, 2 * batchSize - 1);
+
+  generator.Backward();
+  generator.ResetGradients(gradientGenerator);
+  generator.Gradient(generator.predictors);
+
+  gradientGenerator *= multiplier;
+}
+
 template<
   typename Model,
   typename InitializationRuleType,
@@ -57,8 +57,8 @@ GAN<Model, InitializationRuleType, Noise, PolicyType>::Evaluate(
       outputParameterVisitor,
       discriminator.network.back())), std::move(currentTarget));
 
-  noise.imbue( [&]() { return noiseFunction();} );
-  generator.Forward(std::move(noise));
+  generator.predictors.imbue( [&]() { return noiseFunction();} );
+  generator.Forward(generator.predictors);
 
   arma::mat generatedData = boost::apply_visitor(outputParameterVisitor,
       generator.network.back());
@@ -66,8 +66,7 @@ GAN<Model, InitializationRuleType, Noise, PolicyType>::Evaluate(
       generatedData;
   discriminator.Forward(std::move(predictors.cols(numFunctions,
       numFunctions + batchSize - 1)));
-  responses.cols(numFunctions, numFunctions + batchSize - 1) =
-      -arma::ones(1, batchSize);
+  responses.cols(numFunctions, numFunctions + batchSize - 1).fill(-1.0);
 
   currentTarget = arma::mat(responses.memptr() + numFunctions,
       1, batchSize, false, false);
@@ -80,8 +79,7 @@ GAN<Model, InitializationRuleType, Noise, PolicyType>::Evaluate(
   double epsilon = math::Random();
   predictors.cols(numFunctions, numFunctions + batchSize - 1) =
       (epsilon * currentInput) + ((1.0 - epsilon) * generatedData);
-  responses.cols(numFunctions, numFunctions + batchSize - 1) =
-      -arma::ones(1, batchSize);
+  responses.cols(numFunctions, numFunctions + batchSize - 1).fill(-1.0);
   discriminator.Gradient(discriminator.parameter, numFunctions,
       normGradientDiscriminator, batchSize);
   res += lambda * std::pow(arma::norm(normGradientDiscriminator, 2) - 1, 2);
@@ -148,8 +146,8 @@ EvaluateWithGradient(const arma::mat& /* parameters */,
   double res = discriminator.EvaluateWithGradient(discriminator.parameter,
       i, gradientDiscriminator, batchSize);
 
-  noise.imbue( [&]() { return noiseFunction();} );
-  generator.Forward(std::move(noise));
+  generator.predictors.imbue( [&]() { return noiseFunction();} );
+  generator.Forward(generator.predictors);
   arma::mat generatedData = boost::apply_visitor(outputParameterVisitor,
       generator.network.back());
 
@@ -157,8 +155,7 @@ EvaluateWithGradient(const arma::mat& /* parameters */,
   double epsilon = math::Random();
   predictors.cols(numFunctions, numFunctions + batchSize - 1) =
       (epsilon * currentInput) + ((1.0 - epsilon) * generatedData);
-  responses.cols(numFunctions, numFunctions + batchSize - 1) =
-      -arma::ones(1, batchSize);
+  responses.cols(numFunctions, numFunctions + batchSize - 1).fill(-1.0);
   discriminator.Gradient(discriminator.parameter, numFunctions,
       normGradientDiscriminator, batchSize);
   res += lambda * std::pow(arma::norm(normGradientDiscriminator, 2) - 1, 2);
@@ -173,8 +170,7 @@ EvaluateWithGradient(const arma::mat& /* parameters */,
   {
     // Minimize -D(G(noise)).
     // Pass the error from Discriminator to Generator.
-    responses.cols(numFunctions, numFunctions + batchSize - 1) =
-        arma::ones(1, batchSize);
+    responses.cols(numFunctions, numFunctions + batchSize - 1).ones();
 
     discriminator.outputLayer.Backward(
         boost::apply_visitor(outputParameterVisitor,
@@ -185,7 +181,6 @@ EvaluateWithGradient(const arma::mat& /* parameters */,
     generator.error = boost::apply_visitor(deltaVisitor,
         discriminator.network[1]);
 
-    generator.Predictors() = noise;
     generator.Backward();
     generator.ResetGradients(gradientGenerator);
     generator.Gradient(generator.Predictors().cols(0, batchSize - 1));
@@ -0,0 +1,100 @@
+/**
+ * @file methods/ann/inference_context.hpp
+ *
+ * Definition of the InferenceContext class, which holds the activations of one
+ * caller of the const Predict() of an FFN or RNN.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_INFERENCE_CONTEXT_HPP
+#define MLPACK_METHODS_ANN_INFERENCE_CONTEXT_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * An InferenceContext holds everything that a prediction with a trained
+ * network modifies: a copy of the layers of the network, whose weights point
+ * into the parameters of the network instead of being copied, and so the
+ * outputs of the layers.  Passed to the const Predict() of an FFN or RNN, it
+ * lets several threads predict with one network at once, each with its own
+ * context, while the parameters are stored only once.
+ *
+ * The context is built by the first prediction it is used for, and is reused
+ * afterwards.  It is built again if the parameters of the network were
+ * reallocated; if the layers of the network were changed in another way, call
+ * Clear().  The network must outlive the context's use, and must not be
+ * trained while it is used for predictions.
+ *
+ * @code
+ * // Each thread has its own context.
+ * #pragma omp parallel
+ * {
+ *   InferenceContext<FFN<>> context;
+ *
+ *   #pragma omp for
+ *   for (omp_size_t i = 0; i < (omp_size_t) requests.size(); ++i)
+ *     model.Predict(requests[i], results[i], context);
+ * }
+ * @endcode
+ *
+ * @tparam NetworkType The type of the network (FFN or RNN).
+ */
+template<typename NetworkType>
+class InferenceContext
+{
+ public:
+  //! Create an empty context.
+  InferenceContext() : network(NULL), parameter(NULL) { }
+
+  //! A context can't be copied, since it holds its own layers.
+  InferenceContext(const InferenceContext& other) = delete;
+  //! A context can't be copied, since it holds its own layers.
+  InferenceContext& operator=(const InferenceContext& other) = delete;
+
+  //! Take the layers of the given context.
+  InferenceContext(InferenceContext&& other) :
+      network(other.network), parameter(other.parameter)
+  {
+    other.network = NULL;
+    other.parameter = NULL;
+  }
+
+  //! Delete the layers of the context.
+  ~InferenceContext() { Clear(); }
+
+  //! Delete the layers of the context; they are built again by the next
+  //! prediction.
+  void Clear()
+  {
+    delete network;
+    network = NULL;
+    parameter = NULL;
+  }
+
+  //! Return whether the context was built for the given parameters.
+  bool Ready(const arma::mat& networkParameter) const
+  {
+    return network != NULL && parameter == networkParameter.memptr();
+  }
+
+ private:
+  //! The copy of the network, whose parameters point into the parameters of
+  //! the original network.
+  NetworkType* network;
+  //! The parameters that the copy was built for.
+  const double* parameter;
+
+  //! The network builds and uses the context.
+  friend NetworkType;
+};
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
@@ -27,6 +27,7 @@
 #include <mlpack/methods/ann/activation_functions/elliot_function.hpp>
 #include <mlpack/methods/ann/activation_functions/elish_function.hpp>
 #include <mlpack/methods/ann/activation_functions/gaussian_function.hpp>
+#include <mlpack/methods/ann/activation_functions/fast_activation_functions.hpp>
 
 namespace mlpack {
 namespace ann /** Artificial Neural Network. */ {
@@ -50,6 +51,11 @@ namespace ann /** Artificial Neural Network. */ {
  *  - ELiSHLayer
  *  - ElliotLayer
  *  - GaussianLayer
+ *  - FastSigmoidLayer
+ *  - FastTanHLayer
+ *  - FastSwishLayer
+ *  - FastGELULayer
+ *  - FastMishLayer
  *
  * @tparam ActivationFunction Activation function used for the embedding layer.
  * @tparam InputDataType Type of the input data (arma::colvec, arma::mat,
@@ -277,6 +283,61 @@ template <
 using GaussianFunctionLayer = BaseLayer<
     ActivationFunction, InputDataType, OutputDataType>;
 
+/**
+ * Sigmoid-Layer using the fast logistic activation function.
+ */
+template <
+    class ActivationFunction = FastLogisticFunction<>,
+    typename InputDataType = arma::mat,
+    typename OutputDataType = arma::mat
+>
+using FastSigmoidLayer = BaseLayer<
+    ActivationFunction, InputDataType, OutputDataType>;
+
+/**
+ * TanH-Layer using the fast tanh activation function.
+ */
+template <
+    class ActivationFunction = FastTanhFunction<>,
+    typename InputDataType = arma::mat,
+    typename OutputDataType = arma::mat
+>
+using FastTanHLayer = BaseLayer<
+    ActivationFunction, InputDataType, OutputDataType>;
+
+/**
+ * Swish-Layer using the fast swish activation function.
+ */
+template <
+    class ActivationFunction = FastSwishFunction<>,
+    typename InputDataType = arma::mat,
+    typename OutputDataType = arma::mat
+>
+using FastSwishLayer = BaseLayer<
+    ActivationFunction, InputDataType, OutputDataType>;
+
+/**
+ * GELU-Layer using the fast GELU activation function.
+ */
+template <
+    class ActivationFunction = FastGELUFunction<>,
+    typename InputDataType = arma::mat,
+    typename OutputDataType = arma::mat
+>
+using FastGELULayer = BaseLayer<
+    ActivationFunction, InputDataType, OutputDataType>;
+
+/**
+ * Mish-Layer using the fast Mish activation function.
+ */
+template <
+    class ActivationFunction = FastMishFunction<>,
+    typename InputDataType = arma::mat,
+    typename OutputDataType = arma::mat
+>
+using FastMishLayer = BaseLayer<
+    ActivationFunction, InputDataType, OutputDataType>;
+
 } // namespace ann
 } // namespace mlpack
 
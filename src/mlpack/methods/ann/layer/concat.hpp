@@ -203,6 +203,19 @@ class Concat
   void serialize(Archive& /* ar */, const unsigned int /* version */);
 
  private:
+  /**
+   * Find the rows of the concatenated output that hold the output of the given
+   * module.  The sizes cached by the last Forward() call are used when
+   * available, so that the other modules' outputs aren't read; this allows
+   * BRNN to run the indexed Backward() and Gradient() calls of its two
+   * directions at the same time.
+   *
+   * @param index Index of the module.
+   * @param rowCount The first row of the output of the module.
+   * @param rows The number of rows of the output of the module.
+   */
+  void OutputRows(const size_t index, size_t& rowCount, size_t& rows);
+
   //! Parameter which indicates the input size of modules.
   arma::Row<size_t> inputSize;
 
@@ -225,6 +238,9 @@ class Concat
   //! Locally-stored network modules.
   std::vector<LayerTypes<CustomLayers...> > network;
 
+  //! The number of output rows of each module in the last forward pass.
+  std::vector<size_t> outputRows;
+
   //! Locally-stored model parameters.
   arma::mat parameters;
 
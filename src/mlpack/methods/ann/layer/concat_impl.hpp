@@ -20,6 +20,8 @@
 #include "../visitor/backward_visitor.hpp"
 #include "../visitor/gradient_visitor.hpp"
 
+#include <numeric>
+
 namespace mlpack {
 namespace ann /** Artificial Neural Network. */ {
 
@@ -114,6 +116,13 @@ void Concat<InputDataType, OutputDataType, CustomLayers...>::Forward(
     }
   }
 
+  outputRows.resize(network.size());
+  for (size_t i = 0; i < network.size(); ++i)
+  {
+    outputRows[i] = boost::apply_visitor(outputParameterVisitor,
+        network[i]).n_rows;
+  }
+
   output = boost::apply_visitor(outputParameterVisitor, network.front());
 
   // Reshape output to incorporate the channels.
@@ -183,14 +192,8 @@ void Concat<InputDataType, OutputDataType, CustomLayers...>::Backward(
     arma::Mat<eT>& g,
     const size_t index)
 {
-  size_t rowCount = 0, rows = 0;
-
-  for (size_t i = 0; i < index; ++i)
-  {
-    rowCount += boost::apply_visitor(
-        outputParameterVisitor, network[i]).n_rows;
-  }
-  rows = boost::apply_visitor(outputParameterVisitor, network[index]).n_rows;
+  size_t rowCount, rows;
+  OutputRows(index, rowCount, rows);
 
   // Reshape gy to extract the i-th layer gy.
   arma::Mat<eT> gyTmp(((arma::Mat<eT>&) gy).memptr(), gy.n_rows / channels,
@@ -246,14 +249,8 @@ void Concat<InputDataType, OutputDataType, CustomLayers...>::Gradient(
     arma::Mat<eT>& /* gradient */,
     const size_t index)
 {
-  size_t rowCount = 0;
-  for (size_t i = 0; i < index; ++i)
-  {
-    rowCount += boost::apply_visitor(outputParameterVisitor,
-        network[i]).n_rows;
-  }
-  size_t rows = boost::apply_visitor(
-      outputParameterVisitor, network[index]).n_rows;
+  size_t rowCount, rows;
+  OutputRows(index, rowCount, rows);
 
   arma::Mat<eT> errorTmp(((arma::Mat<eT>&) error).memptr(),
       error.n_rows / channels, error.n_cols * channels, false, false);
@@ -264,6 +261,28 @@ void Concat<InputDataType, OutputDataType, CustomLayers...>::Gradient(
   boost::apply_visitor(GradientVisitor(input, err), network[index]);
 }
 
+template<typename InputDataType, typename OutputDataType,
+         typename... CustomLayers>
+void Concat<InputDataType, OutputDataType, CustomLayers...>::OutputRows(
+    const size_t index, size_t& rowCount, size_t& rows)
+{
+  if (outputRows.size() == network.size())
+  {
+    rowCount = std::accumulate(outputRows.begin(), outputRows.begin() + index,
+        size_t(0));
+    rows = outputRows[index];
+    return;
+  }
+
+  rowCount = 0;
+  for (size_t i = 0; i < index; ++i)
+  {
+    rowCount += boost::apply_visitor(outputParameterVisitor,
+        network[i]).n_rows;
+  }
+  rows = boost::apply_visitor(outputParameterVisitor, network[index]).n_rows;
+}
+
 template<typename InputDataType, typename OutputDataType,
          typename... CustomLayers>
 template<typename Archive>
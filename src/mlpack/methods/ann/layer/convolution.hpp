@@ -18,6 +18,8 @@
 #include <mlpack/methods/ann/convolution_rules/naive_convolution.hpp>
 #include <mlpack/methods/ann/convolution_rules/fft_convolution.hpp>
 #include <mlpack/methods/ann/convolution_rules/svd_convolution.hpp>
+#include <mlpack/methods/ann/convolution_rules/im2col_convolution.hpp>
+#include <mlpack/methods/ann/convolution_rules/winograd_convolution.hpp>
 #include <mlpack/core/util/to_lower.hpp>
 
 #include "layer_types.hpp"
@@ -30,6 +32,22 @@ namespace ann /** Artificial Neural Network. */ {
  * Implementation of the Convolution class. The Convolution class represents a
  * single layer of a neural network.
  *
+ * When a convolution rule is an Im2ColConvolution, the corresponding pass
+ * lowers the maps of the whole batch into one matrix (see
+ * Im2ColConvolution::Im2Col()) and computes the pass with a single
+ * matrix-matrix product, instead of convolving each pair of maps of each point
+ * separately:
+ *
+ * @code
+ * Convolution<Im2ColConvolution<ValidConvolution>,
+ *     Im2ColConvolution<FullConvolution>,
+ *     Im2ColConvolution<ValidConvolution>> layer(3, 16, 3, 3);
+ * @endcode
+ *
+ * When the forward or backward rule is NaiveConvolution, the layer uses
+ * WinogradConvolution instead, which computes the 3x3 convolutions with unit
+ * strides through F(2x2, 3x3) and passes the others back to NaiveConvolution.
+ *
  * @tparam ForwardConvolutionRule Convolution to perform forward process.
  * @tparam BackwardConvolutionRule Convolution to perform backward process.
  * @tparam GradientConvolutionRule Convolution to calculate gradient.
@@ -284,6 +302,17 @@ class Convolution
    */
   void InitializeSamePadding();
 
+  /*
+   * Rearrange the given error (or output) of the layer, which holds the output
+   * maps of each point one after the other, into a matrix with one row per
+   * output element of every point and one column per output map.
+   *
+   * @param error The error of the layer, one column per point.
+   * @param loweredError The rearranged error.
+   */
+  template<typename eT>
+  void LowerError(const arma::Mat<eT>& error, arma::Mat<eT>& loweredError);
+
   /*
    * Rotates a 3rd-order tensor counterclockwise by 180 degrees.
    *
@@ -379,6 +408,9 @@ class Convolution
   //! Locally-stored transformed gradient parameter.
   arma::cube gradientTemp;
 
+  //! Locally-stored lowered input, if the forward rule is Im2ColConvolution.
+  arma::mat inputColumns;
+
   //! Locally-stored padding layer.
   ann::Padding<> padding;
 
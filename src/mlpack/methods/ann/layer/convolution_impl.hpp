@@ -197,6 +197,41 @@ void Convolution<
       padHBottom);
 
   output.set_size(wConv * hConv * outSize, batchSize);
+
+  if (IsIm2ColConvolution<ForwardConvolutionRule>::value)
+  {
+    // The filters are the columns of the weights, so the outputs of every
+    // point are the product of the lowered input and the weights.
+    const bool padded = (padWLeft != 0 || padWRight != 0 || padHTop != 0 ||
+        padHBottom != 0);
+    Im2ColConvolution<ValidConvolution>::Im2Col(padded ? inputPaddedTemp :
+        inputTemp, inSize, kernelWidth, kernelHeight, inputColumns,
+        strideWidth, strideHeight);
+
+    const arma::Mat<eT> weightMatrix(weights.memptr(), kernelWidth *
+        kernelHeight * inSize, outSize, false, true);
+    const arma::Mat<eT> loweredOutput = inputColumns.t() * weightMatrix;
+
+    const size_t mapSize = wConv * hConv;
+    for (size_t i = 0; i < batchSize; ++i)
+    {
+      for (size_t outMap = 0; outMap < outSize; ++outMap)
+      {
+        output.submat(outMap * mapSize, i, (outMap + 1) * mapSize - 1, i) =
+            loweredOutput.submat(i * mapSize, outMap, (i + 1) * mapSize - 1,
+            outMap) + bias(outMap);
+      }
+    }
+
+    outputWidth = wConv;
+    outputHeight = hConv;
+    return;
+  }
+
+  // The naive rule is replaced by the Winograd rule, which computes the 3x3
+  // convolutions with unit strides with fewer multiplications.
+  typedef typename WinogradRule<ForwardConvolutionRule>::type ForwardRule;
+
   outputTemp = arma::Cube<eT>(output.memptr(), wConv, hConv,
       outSize * batchSize, false, false);
   outputTemp.zeros();
@@ -216,13 +251,13 @@ void Convolution<
 
       if (padWLeft != 0 || padWRight != 0 || padHTop != 0 || padHBottom != 0)
       {
-        ForwardConvolutionRule::Convolution(inputPaddedTemp.slice(inMap +
+        ForwardRule::Convolution(inputPaddedTemp.slice(inMap +
             batchCount * inSize), weight.slice(outMapIdx), convOutput,
             strideWidth, strideHeight);
       }
       else
       {
-        ForwardConvolutionRule::Convolution(inputTemp.slice(inMap +
+        ForwardRule::Convolution(inputTemp.slice(inMap +
             batchCount * inSize), weight.slice(outMapIdx), convOutput,
             strideWidth, strideHeight);
       }
@@ -260,6 +295,41 @@ void Convolution<
   g.set_size(inputWidth * inputHeight * inSize, batchSize);
   gTemp = arma::Cube<eT>(g.memptr(), inputWidth, inputHeight,
       inSize * batchSize, false, false);
+
+  if (IsIm2ColConvolution<BackwardConvolutionRule>::value)
+  {
+    // The error of the lowered input is the product of the weights and the
+    // error, and is added back to the (padded) input maps it was taken from.
+    arma::Mat<eT> loweredError;
+    LowerError(gy, loweredError);
+    const arma::Mat<eT> weightMatrix(weights.memptr(), kernelWidth *
+        kernelHeight * inSize, outSize, false, true);
+    const arma::Mat<eT> columnsError = weightMatrix * loweredError.t();
+
+    if (padWLeft != 0 || padWRight != 0 || padHTop != 0 || padHBottom != 0)
+    {
+      arma::Cube<eT> paddedError(inputWidth + padWLeft + padWRight,
+          inputHeight + padHTop + padHBottom, inSize * batchSize,
+          arma::fill::zeros);
+      Im2ColConvolution<ValidConvolution>::Col2Im(columnsError, inSize,
+          kernelWidth, kernelHeight, paddedError, strideWidth, strideHeight);
+      for (size_t i = 0; i < gTemp.n_slices; ++i)
+      {
+        gTemp.slice(i) = paddedError.slice(i).submat(padWLeft, padHTop,
+            padWLeft + gTemp.n_rows - 1, padHTop + gTemp.n_cols - 1);
+      }
+    }
+    else
+    {
+      gTemp.zeros();
+      Im2ColConvolution<ValidConvolution>::Col2Im(columnsError, inSize,
+          kernelWidth, kernelHeight, gTemp, strideWidth, strideHeight);
+    }
+
+    return;
+  }
+
+  typedef typename WinogradRule<BackwardConvolutionRule>::type BackwardRule;
   gTemp.zeros();
 
   for (size_t outMap = 0, outMapIdx = 0, batchCount = 0; outMap <
@@ -276,7 +346,7 @@ void Convolution<
       arma::Mat<eT> output, rotatedFilter;
       Rotate180(weight.slice(outMapIdx), rotatedFilter);
 
-      BackwardConvolutionRule::Convolution(mappedError.slice(outMap),
+      BackwardRule::Convolution(mappedError.slice(outMap),
           rotatedFilter, output, strideWidth, strideHeight);
 
       if (padWLeft != 0 || padWRight != 0 || padHTop != 0 || padHBottom != 0)
@@ -317,6 +387,31 @@ void Convolution<
       inputHeight, inSize * batchSize, false, false);
 
   gradient.set_size(weights.n_elem, 1);
+
+  if (IsIm2ColConvolution<GradientConvolutionRule>::value)
+  {
+    // The lowered input is kept from the forward pass, if it was lowered.
+    if (!IsIm2ColConvolution<ForwardConvolutionRule>::value)
+    {
+      const bool padded = (padWLeft != 0 || padWRight != 0 || padHTop != 0 ||
+          padHBottom != 0);
+      Im2ColConvolution<ValidConvolution>::Im2Col(padded ? inputPaddedTemp :
+          inputTemp, inSize, kernelWidth, kernelHeight, inputColumns,
+          strideWidth, strideHeight);
+    }
+
+    // The gradient of each filter sums the products of the error and the
+    // patches over every point of the batch.
+    arma::Mat<eT> loweredError;
+    LowerError(error, loweredError);
+    arma::Mat<eT> weightGradient(gradient.memptr(), kernelWidth *
+        kernelHeight * inSize, outSize, false, true);
+    weightGradient = inputColumns * loweredError;
+    gradient.rows(weight.n_elem, weight.n_elem + outSize - 1) =
+        arma::sum(loweredError, 0).t();
+    return;
+  }
+
   gradientTemp = arma::Cube<eT>(gradient.memptr(), weight.n_rows,
       weight.n_cols, weight.n_slices, false, false);
   gradientTemp.zeros();
@@ -371,6 +466,35 @@ void Convolution<
   }
 }
 
+template<
+    typename ForwardConvolutionRule,
+    typename BackwardConvolutionRule,
+    typename GradientConvolutionRule,
+    typename InputDataType,
+    typename OutputDataType
+>
+template<typename eT>
+void Convolution<
+    ForwardConvolutionRule,
+    BackwardConvolutionRule,
+    GradientConvolutionRule,
+    InputDataType,
+    OutputDataType
+>::LowerError(const arma::Mat<eT>& error, arma::Mat<eT>& loweredError)
+{
+  const size_t mapSize = outputWidth * outputHeight;
+  loweredError.set_size(mapSize * error.n_cols, outSize);
+  for (size_t i = 0; i < error.n_cols; ++i)
+  {
+    for (size_t outMap = 0; outMap < outSize; ++outMap)
+    {
+      loweredError.submat(i * mapSize, outMap, (i + 1) * mapSize - 1,
+          outMap) = error.submat(outMap * mapSize, i,
+          (outMap + 1) * mapSize - 1, i);
+    }
+  }
+}
+
 template<
     typename ForwardConvolutionRule,
     typename BackwardConvolutionRule,
@@ -121,6 +121,22 @@ class FastLSTM
    */
   void ResetCell(const size_t size);
 
+  /**
+   * Get the state of the cell after the last forward pass (the output, with
+   * the cell state below it), one column per sequence.
+   *
+   * @param state Matrix to store the state into.
+   */
+  void SaveState(arma::mat& state) const;
+
+  /**
+   * Continue from the given state (as returned by SaveState()) at the next
+   * forward pass.  Call ResetCell() (with a size of at least 2) first.
+   *
+   * @param state The state to continue from.
+   */
+  void LoadState(const arma::mat& state);
+
   /*
    * Calculate the gradient using the output delta and the input activation.
    *
@@ -109,6 +109,38 @@ void FastLSTM<InputDataType, OutputDataType>::ResetCell(const size_t size)
   }
 }
 
+template<typename InputDataType, typename OutputDataType>
+void FastLSTM<InputDataType, OutputDataType>::SaveState(arma::mat& state) const
+{
+  // The last step is the one before the current one, or the last step through
+  // time if the forward pass just wrapped around.
+  const size_t step = ((forwardStep == 0) ? bpttSteps :
+      (forwardStep / batchSize)) - 1;
+
+  state.set_size(2 * outSize, batchSize);
+  state.rows(0, outSize - 1) = outParameter.cols((step + 1) * batchSize,
+      (step + 2) * batchSize - 1);
+  state.rows(outSize, 2 * outSize - 1) = cell.cols(step * batchSize,
+      (step + 1) * batchSize - 1);
+}
+
+template<typename InputDataType, typename OutputDataType>
+void FastLSTM<InputDataType, OutputDataType>::LoadState(const arma::mat& state)
+{
+  if (state.n_cols != batchSize)
+  {
+    batchSize = state.n_cols;
+    batchStep = batchSize - 1;
+    ResetCell(rhoSize);
+  }
+
+  // Pretend that the state was computed by the first step, so that the next
+  // forward pass is the second one.
+  outParameter.cols(batchSize, 2 * batchSize - 1) = state.rows(0, outSize - 1);
+  cell.cols(0, batchStep) = state.rows(outSize, 2 * outSize - 1);
+  forwardStep = batchSize;
+}
+
 template<typename InputDataType, typename OutputDataType>
 template<typename InputType, typename OutputType>
 void FastLSTM<InputDataType, OutputDataType>::Forward(
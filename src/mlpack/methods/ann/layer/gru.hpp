@@ -116,6 +116,22 @@ class GRU
    */
   void ResetCell(const size_t size);
 
+  /**
+   * Get the state of the cell after the last forward pass (the output), one
+   * column per sequence.
+   *
+   * @param state Matrix to store the state into.
+   */
+  void SaveState(arma::mat& state) const;
+
+  /**
+   * Continue from the given state (as returned by SaveState()) at the next
+   * forward pass.  Call ResetCell() first.
+   *
+   * @param state The state to continue from.
+   */
+  void LoadState(const arma::mat& state);
+
   //! The value of the deterministic parameter.
   bool Deterministic() const { return deterministic; }
   //! Modify the value of the deterministic parameter.
@@ -377,6 +377,34 @@ void GRU<InputDataType, OutputDataType>::ResetCell(const size_t /* size */)
   backwardStep = 0;
 }
 
+template<typename InputDataType, typename OutputDataType>
+void GRU<InputDataType, OutputDataType>::SaveState(arma::mat& state) const
+{
+  // The output of the last step is dropped from outParameter when the step
+  // ends a pass through time, but it is still the output of the layer.
+  state = outputParameter;
+}
+
+template<typename InputDataType, typename OutputDataType>
+void GRU<InputDataType, OutputDataType>::LoadState(const arma::mat& state)
+{
+  if (state.n_cols != batchSize)
+  {
+    batchSize = state.n_cols;
+    prevError.resize(3 * outSize, batchSize);
+    allZeros.zeros(outSize, batchSize);
+  }
+
+  outParameter.clear();
+  outParameter.push_back(state);
+
+  prevOutput = outParameter.begin();
+  backIterator = outParameter.end();
+  gradIterator = outParameter.end();
+
+  forwardStep = 0;
+}
+
 template<typename InputDataType, typename OutputDataType>
 template<typename Archive>
 void GRU<InputDataType, OutputDataType>::serialize(
@@ -104,6 +104,16 @@ HAS_MEM_FUNC(InputHeight, HasInputHeight);
 // can use with SFINAE to catch when a type has a Rho() function.
 HAS_MEM_FUNC(Rho, HasRho);
 
+// This gives us a HasSaveStateCheck<T, U> type (where U is a function
+// pointer) we can use with SFINAE to catch when a type has a SaveState()
+// function.
+HAS_MEM_FUNC(SaveState, HasSaveStateCheck);
+
+// This gives us a HasLoadStateCheck<T, U> type (where U is a function
+// pointer) we can use with SFINAE to catch when a type has a LoadState()
+// function.
+HAS_MEM_FUNC(LoadState, HasLoadStateCheck);
+
 // This gives us a HasLoss<T, U> type (where U is a function pointer) we
 // can use with SFINAE to catch when a type has a Loss() function.
 HAS_MEM_FUNC(Loss, HasLoss);
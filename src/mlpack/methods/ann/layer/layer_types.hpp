@@ -234,7 +234,9 @@ using MoreTypes = boost::variant<
         VirtualBatchNorm<arma::mat, arma::mat>*,
         RBF<arma::mat, arma::mat, GaussianFunction>*,
         BaseLayer<GaussianFunction, arma::mat, arma::mat>*,
-        PositionalEncoding<arma::mat, arma::mat>*
+        PositionalEncoding<arma::mat, arma::mat>*,
+        BaseLayer<FastLogisticFunction<>, arma::mat, arma::mat>*,
+        BaseLayer<FastTanhFunction<>, arma::mat, arma::mat>*
 >;
 
 template <typename... CustomLayers>
@@ -79,6 +79,16 @@ class Linear
   template<typename eT>
   void Forward(const arma::Mat<eT>& input, arma::Mat<eT>& output);
 
+  /**
+   * Feed forward pass of a sparse input (for instance one-hot encoded
+   * features), computed as a dense-sparse product.
+   *
+   * @param input Sparse input data used for evaluating the specified function.
+   * @param output Resulting output activation.
+   */
+  template<typename eT>
+  void Forward(const arma::SpMat<eT>& input, arma::Mat<eT>& output);
+
   /**
    * Ordinary feed backward pass of a neural network, calculating the function
    * f(x) by propagating x backwards trough f. Using the results from the feed
@@ -105,6 +115,20 @@ class Linear
                 const arma::Mat<eT>& error,
                 arma::Mat<eT>& gradient);
 
+  /*
+   * Calculate the gradient for a sparse input.  Only the columns of the
+   * weights that belong to non-zero inputs are written, so the gradient of the
+   * weights must be zero on entry (as the networks leave it).
+   *
+   * @param input The sparse input parameter used for calculating the gradient.
+   * @param error The calculated error.
+   * @param gradient The calculated gradient.
+   */
+  template<typename eT>
+  void Gradient(const arma::SpMat<eT>& input,
+                const arma::Mat<eT>& error,
+                arma::Mat<eT>& gradient);
+
   //! Get the parameters.
   OutputDataType const& Parameters() const { return weights; }
   //! Modify the parameters.
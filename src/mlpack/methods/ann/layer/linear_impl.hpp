@@ -101,8 +101,8 @@ template<typename InputDataType, typename OutputDataType,
     typename RegularizerType>
 void Linear<InputDataType, OutputDataType, RegularizerType>::Reset()
 {
-  weight = arma::mat(weights.memptr(), outSize, inSize, false, false);
-  bias = arma::mat(weights.memptr() + weight.n_elem,
+  weight = OutputDataType(weights.memptr(), outSize, inSize, false, false);
+  bias = OutputDataType(weights.memptr() + weight.n_elem,
       outSize, 1, false, false);
 }
 
@@ -116,6 +116,16 @@ void Linear<InputDataType, OutputDataType, RegularizerType>::Forward(
   output.each_col() += bias;
 }
 
+template<typename InputDataType, typename OutputDataType,
+    typename RegularizerType>
+template<typename eT>
+void Linear<InputDataType, OutputDataType, RegularizerType>::Forward(
+    const arma::SpMat<eT>& input, arma::Mat<eT>& output)
+{
+  output = weight * input;
+  output.each_col() += bias;
+}
+
 template<typename InputDataType, typename OutputDataType,
     typename RegularizerType>
 template<typename eT>
@@ -140,6 +150,29 @@ void Linear<InputDataType, OutputDataType, RegularizerType>::Gradient(
   regularizer.Evaluate(weights, gradient);
 }
 
+template<typename InputDataType, typename OutputDataType,
+    typename RegularizerType>
+template<typename eT>
+void Linear<InputDataType, OutputDataType, RegularizerType>::Gradient(
+    const arma::SpMat<eT>& input,
+    const arma::Mat<eT>& error,
+    arma::Mat<eT>& gradient)
+{
+  // Each non-zero input adds the error of its point to the column of the
+  // weights of its feature.
+  arma::Mat<eT> weightGradient(gradient.memptr(), outSize, inSize, false,
+      true);
+  for (typename arma::SpMat<eT>::const_iterator it = input.begin();
+       it != input.end(); ++it)
+  {
+    weightGradient.col(it.row()) += (*it) * error.col(it.col());
+  }
+
+  gradient.submat(weight.n_elem, 0, gradient.n_elem - 1, 0) =
+      arma::sum(error, 1);
+  regularizer.Evaluate(weights, gradient);
+}
+
 template<typename InputDataType, typename OutputDataType,
     typename RegularizerType>
 template<typename Archive>
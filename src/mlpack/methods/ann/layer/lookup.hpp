@@ -19,6 +19,21 @@
 namespace mlpack {
 namespace ann /* Artificial Neural Network. */ {
 
+/**
+ * The rules a sparse Lookup layer can use to update the embeddings of the
+ * tokens of each batch.
+ */
+enum class LookupUpdate
+{
+  //! Plain gradient descent.
+  SGD,
+  //! Adagrad, with one accumulator per weight.
+  ADAGRAD,
+  //! Lazy Adam: the moments and the step count of an embedding are only
+  //! updated when its token is in the batch.
+  ADAM
+};
+
 /**
  * The Lookup class stores word embeddings and retrieves them using tokens. The
  * Lookup layer is always the first layer of the network. The input to the
@@ -29,6 +44,16 @@ namespace ann /* Artificial Neural Network. */ {
  * The input shape : (sequenceLength, batchSize).
  * The output shape : (embeddingSize, sequenceLength, batchSize).
  *
+ * A dense Lookup layer holds its table in its parameters, so the gradient of
+ * each batch has the size of the whole table.  A sparse Lookup layer instead
+ * keeps the table out of the parameters of the network and updates only the
+ * embeddings of the tokens of each batch, itself, during Gradient(), with the
+ * given update rule; this is what makes large vocabularies trainable, since
+ * neither the gradient nor the optimizer step of the network grows with the
+ * vocabulary.  The embeddings of a sparse layer are updated once per call to
+ * Gradient(), so one network must not be shared by several optimizers, and
+ * the replicas of FFN::Replicas() would each update their own table.
+ *
  * @tparam InputDataType Type of the input data (arma::colvec, arma::mat,
  *         arma::sp_mat or arma::cube).
  * @tparam OutputDataType Type of the output data (arma::colvec, arma::mat,
@@ -49,6 +74,27 @@ class Lookup
    */
   Lookup(const size_t vocabSize = 0, const size_t embeddingSize = 0);
 
+  /**
+   * Create a sparse Lookup object, whose embeddings are initialized uniformly
+   * in [-1, 1] and updated lazily with the given rule.
+   *
+   * @param vocabSize The size of the vocabulary.
+   * @param embeddingSize The length of each embedding vector.
+   * @param update The rule used to update the embeddings.
+   * @param stepSize The step size of the updates.
+   * @param beta1 Exponential decay rate of the first moment (Adam only).
+   * @param beta2 Exponential decay rate of the second moment (Adam only).
+   * @param epsilon Value used to initialise the mean squared gradient
+   *     parameter, for numerical stability (Adagrad and Adam).
+   */
+  Lookup(const size_t vocabSize,
+         const size_t embeddingSize,
+         const LookupUpdate update,
+         const double stepSize = 0.01,
+         const double beta1 = 0.9,
+         const double beta2 = 0.999,
+         const double epsilon = 1e-8);
+
   /**
    * Ordinary feed forward pass of a neural network, evaluating the function
    * f(x) by propagating the activity forward through f.
@@ -75,6 +121,9 @@ class Lookup
 
   /**
    * Calculate the gradient using the output delta and the input activation.
+   * A sparse layer instead computes the gradient of the embeddings of the
+   * tokens of the input, applies its update to them, and leaves the given
+   * gradient untouched.
    *
    * @param input The input parameter used for calculating the gradient.
    * @param error The calculated error.
@@ -85,11 +134,30 @@ class Lookup
                 const arma::Mat<eT>& error,
                 arma::Mat<eT>& gradient);
 
-  //! Get the parameters.
+  //! Get the parameters (empty for a sparse layer).
   OutputDataType const& Parameters() const { return weights; }
-  //! Modify the parameters.
+  //! Modify the parameters (empty for a sparse layer).
   OutputDataType& Parameters() { return weights; }
 
+  //! Get the table of embeddings, one per column.
+  OutputDataType const& Embeddings() const
+  {
+    return sparse ? embeddings : weights;
+  }
+  //! Modify the table of embeddings, one per column.
+  OutputDataType& Embeddings() { return sparse ? embeddings : weights; }
+
+  //! Get whether the embeddings are updated by the layer itself.
+  bool Sparse() const { return sparse; }
+
+  //! Get the columns of the embeddings touched by the last call to Gradient()
+  //! of a sparse layer, in increasing order.
+  arma::uvec const& TouchedTokens() const { return touched; }
+
+  //! Get the gradient of the embeddings touched by the last call to Gradient()
+  //! of a sparse layer, one column per touched token.
+  OutputDataType const& SparseGradient() const { return sparseGradient; }
+
   //! Get the output parameter.
   OutputDataType const& OutputParameter() const { return outputParameter; }
   //! Modify the output parameter.
@@ -115,9 +183,12 @@ class Lookup
    * Serialize the layer
    */
   template<typename Archive>
-  void serialize(Archive& ar, const unsigned int /* version */);
+  void serialize(Archive& ar, const unsigned int version);
 
  private:
+  //! Apply the update rule to the touched embeddings of a sparse layer.
+  void UpdateEmbeddings();
+
   //! Locally-stored size of the vocabulary.
   size_t vocabSize;
 
@@ -135,6 +206,43 @@ class Lookup
 
   //! Locally-stored output parameter object.
   OutputDataType outputParameter;
+
+  //! Whether the embeddings are updated by the layer itself.
+  bool sparse;
+
+  //! The rule used to update the embeddings of a sparse layer.
+  LookupUpdate update;
+
+  //! The step size of the updates.
+  double stepSize;
+
+  //! Exponential decay rate of the first moment.
+  double beta1;
+
+  //! Exponential decay rate of the second moment.
+  double beta2;
+
+  //! Value used for numerical stability.
+  double epsilon;
+
+  //! The embeddings of a sparse layer.
+  OutputDataType embeddings;
+
+  //! The first moment of the embeddings (Adam).
+  OutputDataType firstMoment;
+
+  //! The second moment (Adam) or the accumulated squared gradients (Adagrad)
+  //! of the embeddings.
+  OutputDataType secondMoment;
+
+  //! The number of updates of each embedding (Adam).
+  arma::uvec steps;
+
+  //! The tokens touched by the last call to Gradient().
+  arma::uvec touched;
+
+  //! The gradient of the touched embeddings.
+  OutputDataType sparseGradient;
 }; // class Lookup
 
 // Alias for using as embedding layer.
@@ -144,6 +252,19 @@ using Embedding = Lookup<MatType, MatType>;
 } // namespace ann
 } // namespace mlpack
 
+//! Set the serialization version of the Lookup class.
+namespace boost {
+namespace serialization {
+
+template<typename InputDataType, typename OutputDataType>
+struct version<mlpack::ann::Lookup<InputDataType, OutputDataType> >
+{
+  BOOST_STATIC_CONSTANT(int, value = 1);
+};
+
+} // namespace serialization
+} // namespace boost
+
 // Include implementation.
 #include "lookup_impl.hpp"
 
@@ -16,6 +16,8 @@
 // In case it hasn't yet been included.
 #include "lookup.hpp"
 
+#include <mlpack/methods/ann/init_rules/random_init.hpp>
+
 namespace mlpack {
 namespace ann /** Artificial Neural Network. */ {
 
@@ -24,11 +26,47 @@ Lookup<InputDataType, OutputDataType>::Lookup(
     const size_t vocabSize,
     const size_t embeddingSize) :
     vocabSize(vocabSize),
-    embeddingSize(embeddingSize)
+    embeddingSize(embeddingSize),
+    sparse(false),
+    update(LookupUpdate::SGD),
+    stepSize(0),
+    beta1(0),
+    beta2(0),
+    epsilon(0)
 {
   weights.set_size(embeddingSize, vocabSize);
 }
 
+template <typename InputDataType, typename OutputDataType>
+Lookup<InputDataType, OutputDataType>::Lookup(
+    const size_t vocabSize,
+    const size_t embeddingSize,
+    const LookupUpdate update,
+    const double stepSize,
+    const double beta1,
+    const double beta2,
+    const double epsilon) :
+    vocabSize(vocabSize),
+    embeddingSize(embeddingSize),
+    sparse(true),
+    update(update),
+    stepSize(stepSize),
+    beta1(beta1),
+    beta2(beta2),
+    epsilon(epsilon)
+{
+  RandomInitialization().Initialize(embeddings, embeddingSize, vocabSize);
+
+  if (update != LookupUpdate::SGD)
+    secondMoment.zeros(embeddingSize, vocabSize);
+
+  if (update == LookupUpdate::ADAM)
+  {
+    firstMoment.zeros(embeddingSize, vocabSize);
+    steps.zeros(vocabSize);
+  }
+}
+
 template<typename InputDataType, typename OutputDataType>
 template<typename eT>
 void Lookup<InputDataType, OutputDataType>::Forward(
@@ -44,7 +82,7 @@ void Lookup<InputDataType, OutputDataType>::Forward(
     // ith column of output is a vectorized form of a matrix of shape
     // (embeddingSize, seqLength) selected as a combination of columns from the
     // weights.
-    output.col(i) = arma::vectorise(weights.cols(
+    output.col(i) = arma::vectorise(Embeddings().cols(
         arma::conv_to<arma::uvec>::from(input.col(i)) - 1));
   }
 }
@@ -66,6 +104,28 @@ void Lookup<InputDataType, OutputDataType>::Gradient(
     const arma::Mat<eT>& error,
     arma::Mat<eT>& gradient)
 {
+  if (sparse)
+  {
+    // The error of the token in row j of column i is column (i * seqLength +
+    // j) of the error, which is also the order of the vectorised input.
+    const arma::uvec tokens = arma::conv_to<arma::uvec>::from(
+        arma::vectorise(input)) - 1;
+    const arma::Mat<eT> errorTemp(const_cast<arma::Mat<eT>&>(error).memptr(),
+        embeddingSize, tokens.n_elem, false, false);
+
+    touched = arma::unique(tokens);
+    sparseGradient.zeros(embeddingSize, touched.n_elem);
+    for (size_t i = 0; i < tokens.n_elem; ++i)
+    {
+      const size_t position = std::lower_bound(touched.begin(), touched.end(),
+          tokens[i]) - touched.begin();
+      sparseGradient.col(position) += errorTemp.col(i);
+    }
+
+    UpdateEmbeddings();
+    return;
+  }
+
   const size_t seqLength = input.n_rows;
   const size_t batchSize = input.n_cols;
 
@@ -82,18 +142,82 @@ void Lookup<InputDataType, OutputDataType>::Gradient(
   }
 }
 
+template<typename InputDataType, typename OutputDataType>
+void Lookup<InputDataType, OutputDataType>::UpdateEmbeddings()
+{
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) touched.n_elem; ++i)
+  {
+    const size_t token = touched[i];
+    if (update == LookupUpdate::SGD)
+    {
+      embeddings.col(token) -= stepSize * sparseGradient.col(i);
+    }
+    else if (update == LookupUpdate::ADAGRAD)
+    {
+      secondMoment.col(token) += arma::square(sparseGradient.col(i));
+      embeddings.col(token) -= stepSize * sparseGradient.col(i) /
+          (arma::sqrt(secondMoment.col(token)) + epsilon);
+    }
+    else
+    {
+      ++steps[token];
+      firstMoment.col(token) = beta1 * firstMoment.col(token) +
+          (1 - beta1) * sparseGradient.col(i);
+      secondMoment.col(token) = beta2 * secondMoment.col(token) +
+          (1 - beta2) * arma::square(sparseGradient.col(i));
+
+      const double biasCorrection1 = 1.0 - std::pow(beta1, steps[token]);
+      const double biasCorrection2 = 1.0 - std::pow(beta2, steps[token]);
+      embeddings.col(token) -= stepSize * std::sqrt(biasCorrection2) /
+          biasCorrection1 * firstMoment.col(token) /
+          (arma::sqrt(secondMoment.col(token)) + epsilon);
+    }
+  }
+}
+
 template<typename InputDataType, typename OutputDataType>
 template<typename Archive>
 void Lookup<InputDataType, OutputDataType>::serialize(
-    Archive& ar, const unsigned int /* version */)
+    Archive& ar, const unsigned int version)
 {
   ar & BOOST_SERIALIZATION_NVP(vocabSize);
   ar & BOOST_SERIALIZATION_NVP(embeddingSize);
 
+  // The embeddings of a sparse layer aren't part of the parameters of the
+  // network, so the layer holds them and the state of its update rule.
+  if (Archive::is_loading::value)
+    sparse = false;
+
+  if (version > 0)
+  {
+    ar & BOOST_SERIALIZATION_NVP(sparse);
+    if (sparse)
+    {
+      size_t rule = (size_t) update;
+      ar & BOOST_SERIALIZATION_NVP(rule);
+      update = (LookupUpdate) rule;
+
+      ar & BOOST_SERIALIZATION_NVP(stepSize);
+      ar & BOOST_SERIALIZATION_NVP(beta1);
+      ar & BOOST_SERIALIZATION_NVP(beta2);
+      ar & BOOST_SERIALIZATION_NVP(epsilon);
+      ar & BOOST_SERIALIZATION_NVP(embeddings);
+      ar & BOOST_SERIALIZATION_NVP(firstMoment);
+      ar & BOOST_SERIALIZATION_NVP(secondMoment);
+      ar & BOOST_SERIALIZATION_NVP(steps);
+    }
+  }
+
   // This is inefficient, but we have to allocate this memory so that
   // WeightSetVisitor gets the right size.
   if (Archive::is_loading::value)
-    weights.set_size(embeddingSize, vocabSize);
+  {
+    if (sparse)
+      weights.reset();
+    else
+      weights.set_size(embeddingSize, vocabSize);
+  }
 }
 
 } // namespace ann
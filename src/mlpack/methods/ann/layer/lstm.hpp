@@ -128,6 +128,22 @@ class LSTM
    */
   void ResetCell(const size_t size);
 
+  /**
+   * Get the state of the cell after the last forward pass (the output, with
+   * the cell state below it), one column per sequence.
+   *
+   * @param state Matrix to store the state into.
+   */
+  void SaveState(arma::mat& state) const;
+
+  /**
+   * Continue from the given state (as returned by SaveState()) at the next
+   * forward pass.  Call ResetCell() (with a size of at least 2) first.
+   *
+   * @param state The state to continue from.
+   */
+  void LoadState(const arma::mat& state);
+
   /*
    * Calculate the gradient using the output delta and the input activation.
    *
@@ -178,6 +194,14 @@ class LSTM
   void serialize(Archive& ar, const unsigned int /* version */);
 
  private:
+  /**
+   * Copy the weights of the gates into the stacked matrices, so that each step
+   * computes all the gates with one product for the input and one for the
+   * previous output.  The rows of the stacked matrices are ordered like the
+   * parameters: output gate, forget gate, input gate and hidden layer.
+   */
+  void StackWeights();
+
   //! Locally-stored number of input units.
   size_t inSize;
 
@@ -320,6 +344,21 @@ class LSTM
   //! Locally-stored hidden layer error.
   OutputDataType hiddenError;
 
+  //! Locally-stored input weights of all the gates.
+  OutputDataType input2GatesWeight;
+
+  //! Locally-stored biases of all the gates.
+  OutputDataType input2GatesBias;
+
+  //! Locally-stored previous output weights of all the gates.
+  OutputDataType output2GatesWeight;
+
+  //! Locally-stored gates of the current step, before the cell connections.
+  OutputDataType gates;
+
+  //! Locally-stored errors of all the gates of the current step.
+  OutputDataType gatesError;
+
   //! Locally-stored current rho size.
   size_t rhoSize;
 
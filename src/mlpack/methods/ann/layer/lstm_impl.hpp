@@ -93,6 +93,64 @@ void LSTM<InputDataType, OutputDataType>::ResetCell(const size_t size)
   }
 }
 
+template<typename InputDataType, typename OutputDataType>
+void LSTM<InputDataType, OutputDataType>::SaveState(arma::mat& state) const
+{
+  // The last step is the one before the current one, or the last step through
+  // time if the forward pass just wrapped around.
+  const size_t step = ((forwardStep == 0) ? bpttSteps :
+      (forwardStep / batchSize)) - 1;
+
+  state.set_size(2 * outSize, batchSize);
+  state.rows(0, outSize - 1) = outParameter.cols((step + 1) * batchSize,
+      (step + 2) * batchSize - 1);
+  state.rows(outSize, 2 * outSize - 1) = cell.cols(step * batchSize,
+      (step + 1) * batchSize - 1);
+}
+
+template<typename InputDataType, typename OutputDataType>
+void LSTM<InputDataType, OutputDataType>::LoadState(const arma::mat& state)
+{
+  if (state.n_cols != batchSize)
+  {
+    batchSize = state.n_cols;
+    batchStep = batchSize - 1;
+    ResetCell(rhoSize);
+  }
+
+  // The weights are usually stacked at the first step, which is skipped here.
+  StackWeights();
+
+  // Pretend that the state was computed by the first step, so that the next
+  // forward pass is the second one.
+  outParameter.cols(batchSize, 2 * batchSize - 1) = state.rows(0, outSize - 1);
+  cell.cols(0, batchStep) = state.rows(outSize, 2 * outSize - 1);
+  forwardStep = batchSize;
+}
+
+template<typename InputDataType, typename OutputDataType>
+void LSTM<InputDataType, OutputDataType>::StackWeights()
+{
+  input2GatesWeight.set_size(4 * outSize, inSize);
+  input2GatesWeight.rows(0, outSize - 1) = input2GateOutputWeight;
+  input2GatesWeight.rows(outSize, 2 * outSize - 1) = input2GateForgetWeight;
+  input2GatesWeight.rows(2 * outSize, 3 * outSize - 1) = input2GateInputWeight;
+  input2GatesWeight.rows(3 * outSize, 4 * outSize - 1) = input2HiddenWeight;
+
+  input2GatesBias.set_size(4 * outSize, 1);
+  input2GatesBias.rows(0, outSize - 1) = input2GateOutputBias;
+  input2GatesBias.rows(outSize, 2 * outSize - 1) = input2GateForgetBias;
+  input2GatesBias.rows(2 * outSize, 3 * outSize - 1) = input2GateInputBias;
+  input2GatesBias.rows(3 * outSize, 4 * outSize - 1) = input2HiddenBias;
+
+  output2GatesWeight.set_size(4 * outSize, outSize);
+  output2GatesWeight.rows(0, outSize - 1) = output2GateOutputWeight;
+  output2GatesWeight.rows(outSize, 2 * outSize - 1) = output2GateForgetWeight;
+  output2GatesWeight.rows(2 * outSize, 3 * outSize - 1) =
+      output2GateInputWeight;
+  output2GatesWeight.rows(3 * outSize, 4 * outSize - 1) = output2HiddenWeight;
+}
+
 template<typename InputDataType, typename OutputDataType>
 void LSTM<InputDataType, OutputDataType>::Reset()
 {
@@ -187,17 +245,25 @@ void LSTM<InputDataType, OutputDataType>::Forward(const InputType& input,
     ResetCell(rhoSize);
   }
 
-  inputGate.cols(forwardStep, forwardStep + batchStep) = input2GateInputWeight *
-      input + output2GateInputWeight * outParameter.cols(forwardStep,
-      forwardStep + batchStep);
-  inputGate.cols(forwardStep, forwardStep + batchStep).each_col() +=
-      input2GateInputBias;
+  // The weights are stacked again at the beginning of every sequence, since
+  // they may have been changed by the optimizer in between.
+  if (forwardStep == 0 || input2GatesWeight.is_empty())
+    StackWeights();
 
-  forgetGate.cols(forwardStep, forwardStep + batchStep) = input2GateForgetWeight
-      * input + output2GateForgetWeight * outParameter.cols(
+  // Compute the input and the previous output contributions of all the gates
+  // with one matrix product each.
+  gates = input2GatesWeight * input + output2GatesWeight * outParameter.cols(
       forwardStep, forwardStep + batchStep);
-  forgetGate.cols(forwardStep, forwardStep + batchStep).each_col() +=
-      input2GateForgetBias;
+  gates.each_col() += input2GatesBias;
+
+  outputGate.cols(forwardStep, forwardStep + batchStep) =
+      gates.rows(0, outSize - 1);
+  forgetGate.cols(forwardStep, forwardStep + batchStep) =
+      gates.rows(outSize, 2 * outSize - 1);
+  inputGate.cols(forwardStep, forwardStep + batchStep) =
+      gates.rows(2 * outSize, 3 * outSize - 1);
+  hiddenLayer.cols(forwardStep, forwardStep + batchStep) =
+      gates.rows(3 * outSize, 4 * outSize - 1);
 
   if (forwardStep > 0)
   {
@@ -213,13 +279,13 @@ void LSTM<InputDataType, OutputDataType>::Forward(const InputType& input,
         throw std::runtime_error("Cell parameter is empty.");
       }
     }
-    inputGate.cols(forwardStep, forwardStep + batchStep) +=
-        arma::repmat(cell2GateInputWeight, 1, batchSize) %
-        cell.cols(forwardStep - batchSize, forwardStep - batchSize + batchStep);
+    inputGate.cols(forwardStep, forwardStep + batchStep) += cell.cols(
+        forwardStep - batchSize, forwardStep - batchSize + batchStep)
+        .each_col() % cell2GateInputWeight;
 
-    forgetGate.cols(forwardStep, forwardStep + batchStep) +=
-        arma::repmat(cell2GateForgetWeight, 1, batchSize) %
-        cell.cols(forwardStep - batchSize, forwardStep - batchSize + batchStep);
+    forgetGate.cols(forwardStep, forwardStep + batchStep) += cell.cols(
+        forwardStep - batchSize, forwardStep - batchSize + batchStep)
+        .each_col() % cell2GateForgetWeight;
   }
 
   inputGateActivation.cols(forwardStep, forwardStep + batchStep) = 1.0 /
@@ -228,13 +294,6 @@ void LSTM<InputDataType, OutputDataType>::Forward(const InputType& input,
   forgetGateActivation.cols(forwardStep, forwardStep + batchStep) = 1.0 /
       (1 + arma::exp(-forgetGate.cols(forwardStep, forwardStep + batchStep)));
 
-  hiddenLayer.cols(forwardStep, forwardStep + batchStep) = input2HiddenWeight *
-      input + output2HiddenWeight * outParameter.cols(
-      forwardStep, forwardStep + batchStep);
-
-  hiddenLayer.cols(forwardStep, forwardStep + batchStep).each_col() +=
-      input2HiddenBias;
-
   hiddenLayerActivation.cols(forwardStep, forwardStep + batchStep) =
       arma::tanh(hiddenLayer.cols(forwardStep, forwardStep + batchStep));
 
@@ -253,13 +312,8 @@ void LSTM<InputDataType, OutputDataType>::Forward(const InputType& input,
         hiddenLayerActivation.cols(forwardStep, forwardStep + batchStep);
   }
 
-  outputGate.cols(forwardStep, forwardStep + batchStep) = input2GateOutputWeight
-      * input + output2GateOutputWeight * outParameter.cols(
-      forwardStep, forwardStep + batchStep) + cell.cols(forwardStep,
-      forwardStep + batchStep).each_col() % cell2GateOutputWeight;
-
-  outputGate.cols(forwardStep, forwardStep + batchStep).each_col() +=
-      input2GateOutputBias;
+  outputGate.cols(forwardStep, forwardStep + batchStep) += cell.cols(
+      forwardStep, forwardStep + batchStep).each_col() % cell2GateOutputWeight;
 
   outputGateActivation.cols(forwardStep, forwardStep + batchStep) = 1.0 /
       (1 + arma::exp(-outputGate.cols(forwardStep, forwardStep + batchStep)));
@@ -328,7 +382,7 @@ void LSTM<InputDataType, OutputDataType>::Backward(
   }
   else
   {
-    forgetGateError.zeros();
+    forgetGateError.zeros(outSize, batchSize);
   }
 
   inputGateError = hiddenLayerActivation.cols(backwardStep - batchStep,
@@ -344,15 +398,16 @@ void LSTM<InputDataType, OutputDataType>::Backward(
       backwardStep) % cellError + forgetGateError.each_col() %
       cell2GateForgetWeight + inputGateError.each_col() % cell2GateInputWeight;
 
-  g = input2GateInputWeight.t() * inputGateError +
-      input2HiddenWeight.t() * hiddenError +
-      input2GateForgetWeight.t() * forgetGateError +
-      input2GateOutputWeight.t() * outputGateError;
+  // Stack the errors of the gates like the weights, so that the errors of the
+  // input and of the previous output take one matrix product each.
+  gatesError.set_size(4 * outSize, batchSize);
+  gatesError.rows(0, outSize - 1) = outputGateError;
+  gatesError.rows(outSize, 2 * outSize - 1) = forgetGateError;
+  gatesError.rows(2 * outSize, 3 * outSize - 1) = inputGateError;
+  gatesError.rows(3 * outSize, 4 * outSize - 1) = hiddenError;
 
-  prevError = output2GateOutputWeight.t() * outputGateError +
-      output2GateForgetWeight.t() * forgetGateError +
-      output2GateInputWeight.t() * inputGateError +
-      output2HiddenWeight.t() * hiddenError;
+  g = input2GatesWeight.t() * gatesError;
+  prevError = output2GatesWeight.t() * gatesError;
 
   backwardStep -= batchSize;
   gradientStepIdx++;
@@ -370,61 +425,35 @@ void LSTM<InputDataType, OutputDataType>::Gradient(
     const ErrorType& /* error */,
     GradientType& gradient)
 {
-  // Input2GateOutputWeight and input2GateOutputBias gradients.
-  gradient.submat(0, 0, input2GateOutputWeight.n_elem - 1, 0) =
-      arma::vectorise(outputGateError * input.t());
-  gradient.submat(input2GateOutputWeight.n_elem, 0,
-      input2GateOutputWeight.n_elem + input2GateOutputBias.n_elem - 1, 0) =
-      arma::sum(outputGateError, 1);
-  size_t offset = input2GateOutputWeight.n_elem + input2GateOutputBias.n_elem;
-
-  // Input2GateForgetWeight and input2GateForgetBias gradients.
-  gradient.submat(offset, 0, offset + input2GateForgetWeight.n_elem - 1, 0) =
-      arma::vectorise(forgetGateError * input.t());
-  gradient.submat(offset + input2GateForgetWeight.n_elem, 0,
-      offset + input2GateForgetWeight.n_elem +
-      input2GateForgetBias.n_elem - 1, 0) = arma::sum(forgetGateError, 1);
-  offset += input2GateForgetWeight.n_elem + input2GateForgetBias.n_elem;
-
-  // Input2GateInputWeight and input2GateInputBias gradients.
-  gradient.submat(offset, 0, offset + input2GateInputWeight.n_elem - 1, 0) =
-      arma::vectorise(inputGateError * input.t());
-  gradient.submat(offset + input2GateInputWeight.n_elem, 0,
-      offset + input2GateInputWeight.n_elem +
-      input2GateInputBias.n_elem - 1, 0) = arma::sum(inputGateError, 1);
-  offset += input2GateInputWeight.n_elem + input2GateInputBias.n_elem;
-
-  // Input2HiddenWeight and input2HiddenBias gradients.
-  gradient.submat(offset, 0, offset + input2HiddenWeight.n_elem - 1, 0) =
-      arma::vectorise(hiddenError * input.t());
-  gradient.submat(offset + input2HiddenWeight.n_elem, 0,
-      offset + input2HiddenWeight.n_elem + input2HiddenBias.n_elem - 1, 0) =
-      arma::sum(hiddenError, 1);
-  offset += input2HiddenWeight.n_elem + input2HiddenBias.n_elem;
-
-  // Output2GateOutputWeight gradients.
-  gradient.submat(offset, 0, offset + output2GateOutputWeight.n_elem - 1, 0) =
-      arma::vectorise(outputGateError *
-      outParameter.cols(gradientStep - batchStep, gradientStep).t());
-  offset += output2GateOutputWeight.n_elem;
-
-  // Output2GateForgetWeight gradients.
-  gradient.submat(offset, 0, offset + output2GateForgetWeight.n_elem - 1, 0) =
-      arma::vectorise(forgetGateError *
-      outParameter.cols(gradientStep - batchStep, gradientStep).t());
-  offset += output2GateForgetWeight.n_elem;
+  // The gradients of the input and the previous output weights of all the
+  // gates, with one matrix product each.
+  const OutputDataType inputGradient = gatesError * input.t();
+  const OutputDataType outputGradient = gatesError *
+      outParameter.cols(gradientStep - batchStep, gradientStep).t();
+  const OutputDataType biasGradient = arma::sum(gatesError, 1);
+
+  // Input2Gate weight and bias gradients, in the order of the parameters:
+  // output gate, forget gate, input gate and hidden layer.
+  size_t offset = 0;
+  for (size_t i = 0; i < 4; ++i)
+  {
+    gradient.submat(offset, 0, offset + outSize * inSize - 1, 0) =
+        arma::vectorise(inputGradient.rows(i * outSize, (i + 1) * outSize - 1));
+    offset += outSize * inSize;
 
-  // Output2GateInputWeight gradients.
-  gradient.submat(offset, 0, offset + output2GateInputWeight.n_elem - 1, 0) =
-      arma::vectorise(inputGateError *
-      outParameter.cols(gradientStep - batchStep, gradientStep).t());
-  offset += output2GateInputWeight.n_elem;
+    gradient.submat(offset, 0, offset + outSize - 1, 0) =
+        biasGradient.rows(i * outSize, (i + 1) * outSize - 1);
+    offset += outSize;
+  }
 
-  // Output2HiddenWeight gradients.
-  gradient.submat(offset, 0, offset + output2HiddenWeight.n_elem - 1, 0) =
-      arma::vectorise(hiddenError *
-      outParameter.cols(gradientStep - batchStep, gradientStep).t());
-  offset += output2HiddenWeight.n_elem;
+  // Output2Gate weight gradients, in the same order.
+  for (size_t i = 0; i < 4; ++i)
+  {
+    gradient.submat(offset, 0, offset + outSize * outSize - 1, 0) =
+        arma::vectorise(outputGradient.rows(i * outSize,
+        (i + 1) * outSize - 1));
+    offset += outSize * outSize;
+  }
 
   // Cell2GateOutputWeight gradients.
   gradient.submat(offset, 0, offset + cell2GateOutputWeight.n_elem - 1, 0) =
@@ -168,57 +168,47 @@ class MaxPooling
 
  private:
  /**
-   * Apply pooling to the input and store the results.
+   * Apply pooling to one channel of one input and store the results.  The
+   * windows are read directly from the input, in the order of the elements of
+   * the output.
    *
-   * @param input The input to be apply the pooling rule.
-   * @param output The pooled result.
-   * @param poolingIndices The pooled indices.
+   * @param input The channel of the input, of size inputWidth x inputHeight.
+   * @param output The pooled result, of size outputWidth x outputHeight.
+   * @param poolingIndices The position in the channel of the maximum of each
+   *     window, or NULL if the positions are not needed.
    */
   template<typename eT>
-  void PoolingOperation(const arma::Mat<eT>& input,
-                        arma::Mat<eT>& output,
-                        arma::Mat<eT>& poolingIndices)
+  void PoolingOperation(const eT* input,
+                        eT* output,
+                        size_t* poolingIndices) const
   {
-    for (size_t j = 0, colidx = 0; j < output.n_cols;
+    for (size_t j = 0, colidx = 0; j < outputHeight;
         ++j, colidx += strideHeight)
     {
-      for (size_t i = 0, rowidx = 0; i < output.n_rows;
+      const size_t colEnd = std::min(colidx + kernelHeight - offset,
+          inputHeight);
+      for (size_t i = 0, rowidx = 0; i < outputWidth;
           ++i, rowidx += strideWidth)
       {
-        arma::mat subInput = input(
-            arma::span(rowidx, rowidx + kernelWidth - 1 - offset),
-            arma::span(colidx, colidx + kernelHeight - 1 - offset));
+        const size_t rowEnd = std::min(rowidx + kernelWidth - offset,
+            inputWidth);
 
-        const size_t idx = pooling.Pooling(subInput);
-        output(i, j) = subInput(idx);
-
-        if (!deterministic)
+        // Like MaxPoolingRule, take the first maximum in column-major order.
+        size_t best = rowidx + colidx * inputWidth;
+        for (size_t c = colidx; c < colEnd; ++c)
         {
-          arma::Mat<size_t> subIndices = indices(arma::span(rowidx,
-              rowidx + kernelWidth - 1 - offset),
-              arma::span(colidx, colidx + kernelHeight - 1 - offset));
-
-          poolingIndices(i, j) = subIndices(idx);
+          const eT* column = input + c * inputWidth;
+          for (size_t r = rowidx; r < rowEnd; ++r)
+          {
+            if (column[r] > input[best])
+              best = r + c * inputWidth;
+          }
         }
-      }
-    }
-  }
 
-  /**
-   * Apply unpooling to the input and store the results.
-   *
-   * @param error The backward error.
-   * @param output The pooled result.
-   * @param poolingIndices The pooled indices.
-   */
-  template<typename eT>
-  void Unpooling(const arma::Mat<eT>& error,
-                 arma::Mat<eT>& output,
-                 arma::Mat<eT>& poolingIndices)
-  {
-    for (size_t i = 0; i < poolingIndices.n_elem; ++i)
-    {
-      output(poolingIndices(i)) += error(i);
+        output[i + j * outputWidth] = input[best];
+        if (poolingIndices)
+          poolingIndices[i + j * outputWidth] = best;
+      }
     }
   }
 
@@ -243,9 +233,6 @@ class MaxPooling
   //! Locally-stored number of output channels.
   size_t outSize;
 
-  //! Locally-stored reset parameter used to initialize the module once.
-  bool reset;
-
   //! Locally-stored input width.
   size_t inputWidth;
 
@@ -276,9 +263,6 @@ class MaxPooling
   //! Locally-stored transformed output parameter.
   arma::cube gTemp;
 
-  //! Locally-stored pooling strategy.
-  MaxPoolingRule pooling;
-
   //! Locally-stored delta object.
   OutputDataType delta;
 
@@ -288,14 +272,9 @@ class MaxPooling
   //! Locally-stored output parameter object.
   OutputDataType outputParameter;
 
-  //! Locally-stored indices matrix parameter.
-  arma::Mat<size_t> indices;
-
-  //! Locally-stored indices column parameter.
-  arma::Col<size_t> indicesCol;
-
-  //! Locally-stored pooling indicies.
-  std::vector<arma::cube> poolingIndices;
+  //! Locally-stored positions of the maxima of each forward pass, for the
+  //! backward passes.
+  std::vector<arma::Cube<size_t>> poolingIndices;
 }; // class MaxPooling
 
 } // namespace ann
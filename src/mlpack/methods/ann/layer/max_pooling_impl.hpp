@@ -39,7 +39,6 @@ MaxPooling<InputDataType, OutputDataType>::MaxPooling(
     floor(floor),
     inSize(0),
     outSize(0),
-    reset(false),
     inputWidth(0),
     inputHeight(0),
     outputWidth(0),
@@ -78,37 +77,27 @@ void MaxPooling<InputDataType, OutputDataType>::Forward(
     offset = 1;
   }
 
-  outputTemp = arma::zeros<arma::Cube<eT> >(outputWidth, outputHeight,
-      batchSize * inSize);
+  outputTemp.set_size(outputWidth, outputHeight, batchSize * inSize);
 
+  // The positions of the maxima are kept for Backward(), which then only has
+  // to scatter the error.
+  size_t* indicesMemory = NULL;
   if (!deterministic)
   {
-    poolingIndices.push_back(outputTemp);
+    poolingIndices.push_back(arma::Cube<size_t>(outputWidth, outputHeight,
+        batchSize * inSize));
+    indicesMemory = poolingIndices.back().memptr();
   }
 
-  if (!reset)
+  // The channels of all the inputs of the batch are pooled independently.
+  const size_t inputElements = inputWidth * inputHeight;
+  const size_t outputElements = outputWidth * outputHeight;
+  #pragma omp parallel for
+  for (omp_size_t s = 0; s < (omp_size_t) inputTemp.n_slices; ++s)
   {
-    size_t elements = inputWidth * inputHeight;
-    indicesCol = arma::linspace<arma::Col<size_t> >(0, (elements - 1),
-        elements);
-
-    indices = arma::Mat<size_t>(indicesCol.memptr(), inputWidth, inputHeight);
-
-    reset = true;
-  }
-
-  for (size_t s = 0; s < inputTemp.n_slices; s++)
-  {
-    if (!deterministic)
-    {
-      PoolingOperation(inputTemp.slice(s), outputTemp.slice(s),
-        poolingIndices.back().slice(s));
-    }
-    else
-    {
-      PoolingOperation(inputTemp.slice(s), outputTemp.slice(s),
-          inputTemp.slice(s));
-    }
+    PoolingOperation(input.memptr() + s * inputElements,
+        outputTemp.memptr() + s * outputElements,
+        indicesMemory ? indicesMemory + s * outputElements : NULL);
   }
 
   output = arma::Mat<eT>(outputTemp.memptr(), outputTemp.n_elem / batchSize,
@@ -130,10 +119,16 @@ void MaxPooling<InputDataType, OutputDataType>::Backward(
   gTemp = arma::zeros<arma::cube>(inputTemp.n_rows,
       inputTemp.n_cols, inputTemp.n_slices);
 
-  for (size_t s = 0; s < mappedError.n_slices; s++)
+  // Scatter the error of each output to the position of its maximum.
+  const arma::Cube<size_t>& maxima = poolingIndices.back();
+  #pragma omp parallel for
+  for (omp_size_t s = 0; s < (omp_size_t) mappedError.n_slices; ++s)
   {
-    Unpooling(mappedError.slice(s), gTemp.slice(s),
-        poolingIndices.back().slice(s));
+    const double* error = mappedError.slice_memptr(s);
+    const size_t* positions = maxima.slice_memptr(s);
+    double* slice = gTemp.slice_memptr(s);
+    for (size_t i = 0; i < mappedError.n_elem_slice; ++i)
+      slice[positions[i]] += error[i];
   }
 
   poolingIndices.pop_back();
@@ -149,56 +149,70 @@ class MeanPooling
 
  private:
   /**
-   * Apply pooling to the input and store the results.
+   * Apply pooling to one channel of one input and store the results.  The
+   * windows are read directly from the input; the mean of a window is the mean
+   * of the means of its columns.
    *
-   * @param input The input to be apply the pooling rule.
-   * @param output The pooled result.
+   * @param input The channel of the input, of size inputWidth x inputHeight.
+   * @param output The pooled result, of size outputWidth x outputHeight.
    */
   template<typename eT>
-  void Pooling(const arma::Mat<eT>& input, arma::Mat<eT>& output)
+  void Pooling(const eT* input, eT* output) const
   {
-    for (size_t j = 0, colidx = 0; j < output.n_cols;
+    for (size_t j = 0, colidx = 0; j < outputHeight;
          ++j, colidx += strideHeight)
     {
-      for (size_t i = 0, rowidx = 0; i < output.n_rows;
+      const size_t colEnd = std::min(colidx + kernelHeight - offset,
+          inputHeight);
+      for (size_t i = 0, rowidx = 0; i < outputWidth;
            ++i, rowidx += strideWidth)
       {
-        arma::mat subInput = input(
-            arma::span(rowidx, rowidx + kernelWidth - 1 - offset),
-            arma::span(colidx, colidx + kernelHeight - 1 - offset));
-
-        output(i, j) = arma::mean(arma::mean(subInput));
+        const size_t rowEnd = std::min(rowidx + kernelWidth - offset,
+            inputWidth);
+
+        eT sum = 0;
+        for (size_t c = colidx; c < colEnd; ++c)
+        {
+          const eT* column = input + c * inputWidth;
+          eT columnSum = 0;
+          for (size_t r = rowidx; r < rowEnd; ++r)
+            columnSum += column[r];
+          sum += columnSum / (rowEnd - rowidx);
+        }
+
+        output[i + j * outputWidth] = sum / (colEnd - colidx);
       }
     }
   }
 
   /**
-   * Apply unpooling to the input and store the results.
+   * Apply unpooling to one channel of the error and store the results: the
+   * error of each block of rStep x cStep elements of the input (the ratio of
+   * the input size to the output size, minus the rounding offset) is spread
+   * evenly over the block.
    *
-   * @param input The input to be apply the unpooling rule.
-   * @param output The pooled result.
+   * @param error The channel of the backward error, of size outputWidth x
+   *     outputHeight.
+   * @param output The unpooled result, of size inputWidth x inputHeight.
    */
   template<typename eT>
-  void Unpooling(const arma::Mat<eT>& input,
-                 const arma::Mat<eT>& error,
-                 arma::Mat<eT>& output)
+  void Unpooling(const eT* error, eT* output) const
   {
-    const size_t rStep = input.n_rows / error.n_rows - offset;
-    const size_t cStep = input.n_cols / error.n_cols - offset;
+    const size_t rStep = inputWidth / outputWidth - offset;
+    const size_t cStep = inputHeight / outputHeight - offset;
 
-    arma::Mat<eT> unpooledError;
-    for (size_t j = 0; j < input.n_cols - cStep; j += cStep)
+    for (size_t j = 0; j < inputHeight - cStep; j += cStep)
     {
-      for (size_t i = 0; i < input.n_rows - rStep; i += rStep)
+      for (size_t i = 0; i < inputWidth - rStep; i += rStep)
       {
-        const arma::Mat<eT>& inputArea = input(arma::span(i, i + rStep - 1),
-            arma::span(j, j + cStep - 1));
-
-        unpooledError = arma::Mat<eT>(inputArea.n_rows, inputArea.n_cols);
-        unpooledError.fill(error(i / rStep, j / cStep) / inputArea.n_elem);
-
-        output(arma::span(i, i + rStep - 1 - offset),
-            arma::span(j, j + cStep - 1 - offset)) += unpooledError;
+        const eT value = error[i / rStep + (j / cStep) * outputWidth] /
+            (rStep * cStep);
+        for (size_t c = j; c < j + cStep - offset; ++c)
+        {
+          eT* column = output + c * inputWidth;
+          for (size_t r = i; r < i + rStep - offset; ++r)
+            column[r] += value;
+        }
       }
     }
   }
@@ -80,11 +80,17 @@ void MeanPooling<InputDataType, OutputDataType>::Forward(
     offset = 1;
   }
 
-  outputTemp = arma::zeros<arma::Cube<eT> >(outputWidth, outputHeight,
-      batchSize * inSize);
+  outputTemp.set_size(outputWidth, outputHeight, batchSize * inSize);
 
-  for (size_t s = 0; s < inputTemp.n_slices; s++)
-    Pooling(inputTemp.slice(s), outputTemp.slice(s));
+  // The channels of all the inputs of the batch are pooled independently.
+  const size_t inputElements = inputWidth * inputHeight;
+  const size_t outputElements = outputWidth * outputHeight;
+  #pragma omp parallel for
+  for (omp_size_t s = 0; s < (omp_size_t) inputTemp.n_slices; ++s)
+  {
+    Pooling(input.memptr() + s * inputElements,
+        outputTemp.memptr() + s * outputElements);
+  }
 
   output = arma::Mat<eT>(outputTemp.memptr(), outputTemp.n_elem / batchSize,
       batchSize);
@@ -107,10 +113,9 @@ void MeanPooling<InputDataType, OutputDataType>::Backward(
   gTemp = arma::zeros<arma::cube>(inputTemp.n_rows,
       inputTemp.n_cols, inputTemp.n_slices);
 
-  for (size_t s = 0; s < mappedError.n_slices; s++)
-  {
-    Unpooling(inputTemp.slice(s), mappedError.slice(s), gTemp.slice(s));
-  }
+  #pragma omp parallel for
+  for (omp_size_t s = 0; s < (omp_size_t) mappedError.n_slices; ++s)
+    Unpooling(mappedError.slice_memptr(s), gTemp.slice_memptr(s));
 
   g = arma::mat(gTemp.memptr(), gTemp.n_elem / batchSize, batchSize);
 }
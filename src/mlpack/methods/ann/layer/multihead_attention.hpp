@@ -180,6 +180,25 @@ class MultiheadAttention
   //! Element Type of the input.
   typedef typename OutputDataType::elem_type ElemType;
 
+  /**
+   * Project every position of a batch of sequences with one matrix product,
+   * and store the transposed projection of each sequence as a slice of the
+   * given cube.
+   *
+   * @param weight Weight matrix of the projection.
+   * @param bias Bias of the projection.
+   * @param input The sequences, one position per column.
+   * @param batchSize Number of sequences of the input.
+   * @param projection Cube to store the projections into; the shape of each
+   *     slice is (sequence length, embedDim).
+   */
+  template<typename eT>
+  void Project(const OutputDataType& weight,
+               const OutputDataType& bias,
+               const arma::Mat<eT>& input,
+               const size_t batchSize,
+               arma::Cube<eT>& projection);
+
   //! Target sequence length.
   size_t tgtSeqLen;
 
@@ -88,8 +88,6 @@ template <typename eT>
 void MultiheadAttention<InputDataType, OutputDataType, RegularizerType>::
 Forward(const arma::Mat<eT>& input, arma::Mat<eT>& output)
 {
-  typedef typename arma::Cube<eT> CubeType;
-
   if (input.n_rows != embedDim * (tgtSeqLen + 2 * srcSeqLen))
   {
     Log::Fatal << "Incorrect input dimensions!" << std::endl;
@@ -100,34 +98,26 @@ Forward(const arma::Mat<eT>& input, arma::Mat<eT>& output)
   // shape of output : (embedDim * tgtSeqLen, batchSize).
   output.set_size(embedDim * tgtSeqLen, batchSize);
 
-  // Reshape the input, the query, and the key into a cube from a matrix.
-  // The shape of q : (embedDim, tgtSeqLen, batchSize).
-  // The shape of k : (embedDim, srcSeqLen, batchSize).
-  // The shape of v : (embedDim, srcSeqLen, batchSize).
-  const CubeType q(const_cast<arma::Mat<eT>&>(input).memptr(),
-      embedDim, tgtSeqLen, batchSize, false, false);
-  const CubeType k(const_cast<arma::Mat<eT>&>(input).memptr() +
+  // Reshape the input, the query, and the key into matrices with one position
+  // of a sequence per column.
+  // The shape of q : (embedDim, tgtSeqLen * batchSize).
+  // The shape of k : (embedDim, srcSeqLen * batchSize).
+  // The shape of v : (embedDim, srcSeqLen * batchSize).
+  const arma::Mat<eT> q(const_cast<arma::Mat<eT>&>(input).memptr(),
+      embedDim, tgtSeqLen * batchSize, false, false);
+  const arma::Mat<eT> k(const_cast<arma::Mat<eT>&>(input).memptr() +
       embedDim * tgtSeqLen * batchSize,
-      embedDim, srcSeqLen, batchSize, false, false);
-  const CubeType v(const_cast<arma::Mat<eT>&>(input).memptr() +
+      embedDim, srcSeqLen * batchSize, false, false);
+  const arma::Mat<eT> v(const_cast<arma::Mat<eT>&>(input).memptr() +
       embedDim * (tgtSeqLen + srcSeqLen) * batchSize,
-      embedDim, srcSeqLen, batchSize, false, false);
+      embedDim, srcSeqLen * batchSize, false, false);
 
   // qProj, kProj, and vProj are the linearly projected query, key and value
-  // respectively.
-  qProj.set_size(tgtSeqLen, embedDim, batchSize);
-  kProj.set_size(srcSeqLen, embedDim, batchSize);
-  vProj.set_size(srcSeqLen, embedDim, batchSize);
-
-  for (size_t i = 0; i < batchSize; ++i)
-  {
-    qProj.slice(i) = arma::trans(
-        queryWt * q.slice(i) + arma::repmat(qBias, 1, tgtSeqLen));
-    kProj.slice(i) = arma::trans(
-        keyWt * k.slice(i) + arma::repmat(kBias, 1, srcSeqLen));
-    vProj.slice(i) = arma::trans(
-        valueWt * v.slice(i) + arma::repmat(vBias, 1, srcSeqLen));
-  }
+  // respectively.  Each one is computed with a single matrix product over all
+  // the positions of the batch.
+  Project(queryWt, qBias, q, batchSize, qProj);
+  Project(keyWt, kBias, k, batchSize, kProj);
+  Project(valueWt, vBias, v, batchSize, vProj);
 
   // The scaling factor sqrt(headDim) is used to prevent exploding values
   // after dot product i.e. when qProj is multiplied with kProj.
@@ -139,52 +129,101 @@ Forward(const arma::Mat<eT>& input, arma::Mat<eT>& output)
   kProj.reshape(srcSeqLen, headDim, numHeads * batchSize);
   vProj.reshape(srcSeqLen, headDim, numHeads * batchSize);
 
-  // Calculate the scores i.e. perform the matrix multiplication operation
-  // on qProj and kProj. Here score = qProj . kProj'
-  scores = math::MultiplyCube2Cube(qProj, kProj, false, true);
-
-  // Apply the attention mask if provided. The attention mask is used to black-
-  // out future sequences and generally used in Encoder-Decoder attention.
-  // The attention mask has elements 0 or -infinity.
+  // The attention mask is used to black-out future sequences and generally
+  // used in Encoder-Decoder attention, and the key padding mask blacks-out any
+  // particular word in the sequence.  Both have elements 0 or -infinity, and
+  // they are the same for each head, so they are combined only once.
   // The shape of the attention mask : (tgtSeqLen, srcSeqLen).
+  // The shape of keyPaddingMask : (1, srcSeqLen).
+  arma::Mat<eT> mask;
   if (!attnMask.is_empty())
   {
     if (attnMask.n_rows != tgtSeqLen || attnMask.n_cols != srcSeqLen)
       Log::Fatal << "The size of the 'attn_mask' is not correct.\n";
-    scores.each_slice() += attnMask;
+    mask = attnMask;
   }
 
-  // Apply the key padding mask when provided. It blacks-out any particular
-  // word in the sequence.
-  // The key padding mask has elements 0 or -infinity.
-  // The shape of keyPaddingMask : (1, srcSeqLen).
   if (!keyPaddingMask.is_empty())
   {
     if (keyPaddingMask.n_rows != 1 || keyPaddingMask.n_cols != srcSeqLen)
         Log::Fatal << "The size of the 'keyPaddingMask' is not correct.\n";
-    scores.each_slice() += arma::repmat(keyPaddingMask, tgtSeqLen, 1);
+
+    if (mask.is_empty())
+      mask = arma::repmat(keyPaddingMask, tgtSeqLen, 1);
+    else
+      mask.each_row() += keyPaddingMask;
   }
 
-  for (size_t i = 0; i < numHeads * batchSize; ++i)
+  // For each head, calculate the scores i.e. score = qProj . kProj', apply the
+  // masks and the softmax in place, and multiply the result with vProj.  The
+  // slice of the scores is still in cache for the last product.
+  // The shape of scores : (tgtSeqLen, srcSeqLen, numHeads * batchSize).
+  // The shape of attnOut : (tgtSeqLen, headDim, numHeads * batchSize).
+  scores.set_size(tgtSeqLen, srcSeqLen, numHeads * batchSize);
+  attnOut.set_size(tgtSeqLen, headDim, numHeads * batchSize);
+
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) (numHeads * batchSize); ++i)
   {
-    softmax.Forward(scores.slice(i), softmax.OutputParameter());
-    scores.slice(i) = softmax.OutputParameter();
+    const arma::Mat<eT> qHead(qProj.slice_memptr(i), tgtSeqLen, headDim,
+        false, true);
+    const arma::Mat<eT> kHead(kProj.slice_memptr(i), srcSeqLen, headDim,
+        false, true);
+    const arma::Mat<eT> vHead(vProj.slice_memptr(i), srcSeqLen, headDim,
+        false, true);
+    arma::Mat<eT> score(scores.slice_memptr(i), tgtSeqLen, srcSeqLen, false,
+        true);
+    arma::Mat<eT> attn(attnOut.slice_memptr(i), tgtSeqLen, headDim, false,
+        true);
+
+    score = qHead * kHead.t();
+    if (!mask.is_empty())
+      score += mask;
+
+    // This is the Softmax layer, applied to each column of the scores.
+    score.each_row() -= arma::max(score, 0);
+    score = arma::exp(score);
+    score.each_row() /= arma::sum(score, 0);
+
+    attn = score * vHead;
   }
 
-  // Calculate the attention output i.e. matrix multiplication of softmax
-  // output and vProj.
-  // The shape of attnOutput : (tgtSeqLen, headDim, numHeads * batchSize).
-  attnOut = math::MultiplyCube2Cube(scores, vProj, false, false);
-
   // Now we will concatenate output of all the heads i.e. we will reshape
   // attnOut to (tgtSeqLen, embedDim, batchSize).
   attnOut.reshape(tgtSeqLen, embedDim, batchSize);
 
   // The final output is the linear projection of attention output.
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) batchSize; ++i)
+  {
+    const arma::Mat<eT> attn(attnOut.slice_memptr(i), tgtSeqLen, embedDim,
+        false, true);
+    arma::Mat<eT> out(output.colptr(i), embedDim, tgtSeqLen, false, true);
+    out = outWt.t() * attn.t();
+    out.each_col() += outBias.t();
+  }
+}
+
+template <typename InputDataType, typename OutputDataType,
+          typename RegularizerType>
+template <typename eT>
+void MultiheadAttention<InputDataType, OutputDataType, RegularizerType>::
+Project(const OutputDataType& weight,
+        const OutputDataType& bias,
+        const arma::Mat<eT>& input,
+        const size_t batchSize,
+        arma::Cube<eT>& projection)
+{
+  const size_t seqLen = input.n_cols / batchSize;
+
+  arma::Mat<eT> projected = weight * input;
+  projected.each_col() += bias;
+
+  projection.set_size(seqLen, embedDim, batchSize);
   for (size_t i = 0; i < batchSize; ++i)
   {
-    output.col(i) = arma::vectorise(arma::trans(attnOut.slice(i) * outWt
-        + arma::repmat(outBias, tgtSeqLen, 1)));
+    projection.slice(i) = arma::trans(projected.cols(i * seqLen,
+        (i + 1) * seqLen - 1));
   }
 }
 
@@ -243,10 +282,15 @@ Backward(const arma::Mat<eT>& /* input */,
   // So the new shape of gyTemp : (tgtSeqLen, srcSeqLen, numHeads * batchSize).
   gyTemp = math::MultiplyCube2Cube(gyTemp, vProj, false, true);
 
-  for (size_t i = 0; i < numHeads * batchSize; ++i)
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) (numHeads * batchSize); ++i)
   {
     // We will perform backpropagation of softmax over each slice of gyTemp.
-    softmax.Backward(scores.slice(i), gyTemp.slice(i), gyTemp.slice(i));
+    const arma::Mat<eT> score(scores.slice_memptr(i), tgtSeqLen, srcSeqLen,
+        false, true);
+    arma::Mat<eT> error(gyTemp.slice_memptr(i), tgtSeqLen, srcSeqLen, false,
+        true);
+    softmax.Backward(score, error, error);
   }
 
   // Obtain backpropagated error of key.
@@ -372,12 +416,17 @@ Gradient(const arma::Mat<eT>& input,
   // The new shape of errorTemp : (tgtSeqLen, srcSeqLen, numHeads * batchSize).
   errorTemp = math::MultiplyCube2Cube(gyTemp, vProj, false, true);
 
-  for (size_t i = 0; i < numHeads * batchSize; ++i)
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) (numHeads * batchSize); ++i)
   {
     // The shape of scores : (tgtSeqLen, srcSeqLen, numHeads * batchSize).
     // The shape of errorTemp : (tgtSeqLen, srcSeqLen, numHeads * batchSize).
     // The new shape of errorTemp remain same.
-    softmax.Backward(scores.slice(i), errorTemp.slice(i), errorTemp.slice(i));
+    const arma::Mat<eT> score(scores.slice_memptr(i), tgtSeqLen, srcSeqLen,
+        false, true);
+    arma::Mat<eT> errorSlice(errorTemp.slice_memptr(i), tgtSeqLen, srcSeqLen,
+        false, true);
+    softmax.Backward(score, errorSlice, errorSlice);
   }
 
   // The shape of qProj : (tgtSeqLen, headDim, numHeads * batchSize).
@@ -9,6 +9,8 @@
  * 3-clause BSD license along with mlpack.  If not, see
  * http://www.opensource.org/licenses/BSD-3-Clause for more information.
  */
+#ifndef MLPACK_METHODS_ANN_LAYER_NAMES_HPP
+#define MLPACK_METHODS_ANN_LAYER_NAMES_HPP
 
 #include <mlpack/core.hpp>
 #include <mlpack/methods/ann/layer/layer.hpp>
@@ -16,7 +18,8 @@
 #include <boost/variant/static_visitor.hpp>
 #include <string>
 
-using namespace mlpack::ann;
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
 
 /**
  * Implementation of a class that returns the string representation of the
@@ -430,3 +433,8 @@ class LayerNameVisitor : public boost::static_visitor<std::string>
     return LayerString(layer);
   }
 };
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,186 @@
+/**
+ * @file methods/ann/layer_profiler.hpp
+ *
+ * Definition of the LayerProfiler class, which records the time and the
+ * activation memory of each layer of an FFN or RNN during training.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LAYER_PROFILER_HPP
+#define MLPACK_METHODS_ANN_LAYER_PROFILER_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include <chrono>
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * The LayerProfiler records, for each layer of a network, the time spent in
+ * its forward pass, backward pass and gradient computation, and the memory of
+ * its output and its delta.  It is an ensmallen callback: passed to
+ * FFN::Train() or RNN::Train(), it is attached to the network when the
+ * optimization begins and detached when it ends, and the statistics of the
+ * training can be read or printed afterwards.
+ *
+ * @code
+ * FFN<NegativeLogLikelihood<>> model;
+ * // ... add the layers ...
+ * LayerProfiler profiler;
+ * model.Train(trainData, trainLabels, optimizer, profiler);
+ * profiler.Print(std::cout);
+ * @endcode
+ *
+ * The times are measured with the clock of mlpack's Timer.  A profiler can
+ * also be attached to a network by hand with Attach(), e.g. to profile
+ * Predict().  The forward passes repeated by FFN checkpointing count as forward
+ * passes.  When the layers run on several threads (FFN replicas, BRNN), only
+ * the layers of the network itself are profiled.
+ */
+class LayerProfiler
+{
+ public:
+  //! The stages of the computation of a layer.
+  enum Stage
+  {
+    FORWARD = 0,
+    BACKWARD = 1,
+    GRADIENT = 2
+  };
+
+  //! Create the profiler, with no statistics.
+  LayerProfiler() { }
+
+  /**
+   * Clear the statistics and start profiling the given network, whose
+   * Profiler() is set to this profiler.  The names of the layers are given by
+   * LayerNameVisitor.
+   *
+   * @param network The FFN or RNN to profile.
+   */
+  template<typename NetworkType>
+  void Attach(NetworkType& network);
+
+  /**
+   * Stop profiling the given network.  The statistics are kept.
+   *
+   * @param network The profiled network.
+   */
+  template<typename NetworkType>
+  void Detach(NetworkType& network);
+
+  //! Clear the statistics of all the layers.
+  void Reset();
+
+  //! Start timing a stage of a layer.
+  void Start() { start = std::chrono::high_resolution_clock::now(); }
+
+  /**
+   * Stop timing a stage of a layer, and add the time since Start() to its
+   * statistics.
+   *
+   * @param layer Index of the layer.
+   * @param stage The timed stage.
+   */
+  void Stop(const size_t layer, const Stage stage);
+
+  /**
+   * Record the memory of the output and the delta of a layer; the largest
+   * values seen are kept.
+   *
+   * @param layer Index of the layer.
+   * @param outputBytes Memory of the outputs stored by the layer, in bytes.
+   * @param deltaBytes Memory of the delta of the layer, in bytes.
+   */
+  void Memory(const size_t layer,
+              const size_t outputBytes,
+              const size_t deltaBytes);
+
+  //! Get the number of profiled layers.
+  size_t NumLayers() const { return names.size(); }
+
+  //! Get the name of the given layer.
+  const std::string& Name(const size_t layer) const { return names[layer]; }
+
+  //! Get the total time of the given stage of the given layer, in seconds.
+  double Time(const size_t layer, const Stage stage) const
+  {
+    return times[stage][layer];
+  }
+
+  //! Get the number of times the given stage of the given layer ran.
+  size_t Calls(const size_t layer, const Stage stage) const
+  {
+    return calls[stage][layer];
+  }
+
+  //! Get the memory of the outputs of the given layer, in bytes.
+  size_t OutputMemory(const size_t layer) const { return outputBytes[layer]; }
+
+  //! Get the memory of the delta of the given layer, in bytes.
+  size_t DeltaMemory(const size_t layer) const { return deltaBytes[layer]; }
+
+  /**
+   * Print the statistics as a table, with one row per layer.  The times are
+   * in milliseconds and the memory in kilobytes.
+   *
+   * @param stream The stream to print to.
+   */
+  void Print(std::ostream& stream) const;
+
+  /**
+   * Print the statistics as a JSON array, with one object per layer.  The
+   * times are in seconds and the memory in bytes.
+   *
+   * @param stream The stream to print to.
+   */
+  void PrintJSON(std::ostream& stream) const;
+
+  //! Attach the profiler to the trained network.
+  template<typename OptimizerType, typename FunctionType, typename MatType>
+  void BeginOptimization(OptimizerType& /* optimizer */,
+                         FunctionType& function,
+                         MatType& /* coordinates */)
+  {
+    Attach(function);
+  }
+
+  //! Detach the profiler from the trained network.
+  template<typename OptimizerType, typename FunctionType, typename MatType>
+  void EndOptimization(OptimizerType& /* optimizer */,
+                       FunctionType& function,
+                       MatType& /* coordinates */)
+  {
+    Detach(function);
+  }
+
+ private:
+  //! Make room for the statistics of the given number of layers.
+  void Resize(const size_t layers);
+
+  //! The names of the layers.
+  std::vector<std::string> names;
+  //! The total time of each stage of each layer, in seconds.
+  std::vector<double> times[3];
+  //! The number of calls of each stage of each layer.
+  std::vector<size_t> calls[3];
+  //! The largest memory of the outputs of each layer.
+  std::vector<size_t> outputBytes;
+  //! The largest memory of the delta of each layer.
+  std::vector<size_t> deltaBytes;
+
+  //! The time the current stage started.
+  std::chrono::high_resolution_clock::time_point start;
+}; // class LayerProfiler
+
+} // namespace ann
+} // namespace mlpack
+
+// Include implementation.
+#include "layer_profiler_impl.hpp"
+
+#endif
@@ -0,0 +1,140 @@
+/**
+ * @file methods/ann/layer_profiler_impl.hpp
+ *
+ * Implementation of the LayerProfiler class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LAYER_PROFILER_IMPL_HPP
+#define MLPACK_METHODS_ANN_LAYER_PROFILER_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "layer_profiler.hpp"
+#include "layer_names.hpp"
+
+#include <iomanip>
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+template<typename NetworkType>
+void LayerProfiler::Attach(NetworkType& network)
+{
+  names.clear();
+  Resize(network.Model().size());
+
+  LayerNameVisitor layerNameVisitor;
+  for (size_t i = 0; i < network.Model().size(); ++i)
+    names[i] = boost::apply_visitor(layerNameVisitor, network.Model()[i]);
+
+  Reset();
+  network.Profiler() = this;
+}
+
+template<typename NetworkType>
+void LayerProfiler::Detach(NetworkType& network)
+{
+  if (network.Profiler() == this)
+    network.Profiler() = NULL;
+}
+
+inline void LayerProfiler::Reset()
+{
+  for (size_t s = 0; s < 3; ++s)
+  {
+    std::fill(times[s].begin(), times[s].end(), 0.0);
+    std::fill(calls[s].begin(), calls[s].end(), 0);
+  }
+
+  std::fill(outputBytes.begin(), outputBytes.end(), 0);
+  std::fill(deltaBytes.begin(), deltaBytes.end(), 0);
+}
+
+inline void LayerProfiler::Resize(const size_t layers)
+{
+  if (layers <= names.size())
+    return;
+
+  names.resize(layers);
+  for (size_t s = 0; s < 3; ++s)
+  {
+    times[s].resize(layers, 0.0);
+    calls[s].resize(layers, 0);
+  }
+
+  outputBytes.resize(layers, 0);
+  deltaBytes.resize(layers, 0);
+}
+
+inline void LayerProfiler::Stop(const size_t layer, const Stage stage)
+{
+  const std::chrono::duration<double> elapsed =
+      std::chrono::high_resolution_clock::now() - start;
+
+  Resize(layer + 1);
+  times[stage][layer] += elapsed.count();
+  ++calls[stage][layer];
+}
+
+inline void LayerProfiler::Memory(const size_t layer,
+                                  const size_t outputBytes,
+                                  const size_t deltaBytes)
+{
+  Resize(layer + 1);
+  this->outputBytes[layer] = std::max(this->outputBytes[layer], outputBytes);
+  this->deltaBytes[layer] = std::max(this->deltaBytes[layer], deltaBytes);
+}
+
+inline void LayerProfiler::Print(std::ostream& stream) const
+{
+  const std::ios::fmtflags flags = stream.flags();
+  const std::streamsize precision = stream.precision();
+
+  stream << std::left << std::setw(6) << "layer" << std::setw(22) << "name"
+      << std::right << std::setw(8) << "calls" << std::setw(14)
+      << "forward (ms)" << std::setw(15) << "backward (ms)" << std::setw(15)
+      << "gradient (ms)" << std::setw(14) << "output (kB)" << std::setw(13)
+      << "delta (kB)" << std::endl;
+
+  stream << std::fixed << std::setprecision(3);
+  for (size_t i = 0; i < names.size(); ++i)
+  {
+    stream << std::left << std::setw(6) << i << std::setw(22) << names[i]
+        << std::right << std::setw(8) << calls[FORWARD][i] << std::setw(14)
+        << 1000 * times[FORWARD][i] << std::setw(15)
+        << 1000 * times[BACKWARD][i] << std::setw(15)
+        << 1000 * times[GRADIENT][i] << std::setw(14)
+        << outputBytes[i] / 1024.0 << std::setw(13) << deltaBytes[i] / 1024.0
+        << std::endl;
+  }
+
+  stream.flags(flags);
+  stream.precision(precision);
+}
+
+inline void LayerProfiler::PrintJSON(std::ostream& stream) const
+{
+  const std::streamsize precision = stream.precision(9);
+
+  stream << "[";
+  for (size_t i = 0; i < names.size(); ++i)
+  {
+    stream << ((i == 0) ? "\n" : ",\n") << "  { \"layer\": " << i
+        << ", \"name\": \"" << names[i] << "\", \"calls\": "
+        << calls[FORWARD][i] << ", \"forward\": " << times[FORWARD][i]
+        << ", \"backward\": " << times[BACKWARD][i] << ", \"gradient\": "
+        << times[GRADIENT][i] << ", \"outputBytes\": " << outputBytes[i]
+        << ", \"deltaBytes\": " << deltaBytes[i] << " }";
+  }
+  stream << "\n]" << std::endl;
+
+  stream.precision(precision);
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
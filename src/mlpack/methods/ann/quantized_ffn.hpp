@@ -0,0 +1,155 @@
+/**
+ * @file methods/ann/quantized_ffn.hpp
+ *
+ * Definition of the QuantizedFFN class, an inference-only version of a trained
+ * feed forward network whose dense and convolution layers use int8 weights.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_QUANTIZED_FFN_HPP
+#define MLPACK_METHODS_ANN_QUANTIZED_FFN_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include "ffn.hpp"
+#include "quantized_layer.hpp"
+
+#include "visitor/copy_visitor.hpp"
+#include "visitor/delete_visitor.hpp"
+#include "visitor/deterministic_set_visitor.hpp"
+#include "visitor/forward_visitor.hpp"
+#include "visitor/output_height_visitor.hpp"
+#include "visitor/output_parameter_visitor.hpp"
+#include "visitor/output_width_visitor.hpp"
+#include "visitor/quantize_visitor.hpp"
+#include "visitor/reset_visitor.hpp"
+#include "visitor/set_input_height_visitor.hpp"
+#include "visitor/set_input_width_visitor.hpp"
+#include "visitor/weight_set_visitor.hpp"
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * Post-training int8 quantization of a feed forward network, for inference.
+ * The Linear, Linear3D and Convolution layers of a trained FFN are replaced by
+ * QuantizedLayer objects, which hold int8 weights with one scale per output
+ * channel and an input scale calibrated on the given data, and compute their
+ * products with 32-bit integer accumulation.  The other layers are copied and
+ * run in double precision.  Only the parameters of the layers that aren't
+ * quantized are kept in double precision, so the weights of the quantized
+ * layers take an eighth of their former memory.
+ *
+ * @code
+ * FFN<NegativeLogLikelihood<>> model;
+ * // ... add the layers and train the model ...
+ * QuantizedFFN<> quantizedModel(model, calibrationData);
+ * quantizedModel.Predict(points, results);
+ * @endcode
+ *
+ * The calibration data should be a representative sample of the inputs of the
+ * network: inputs of a quantized layer with larger absolute values than seen
+ * during calibration are clipped.
+ *
+ * @tparam CustomLayers Any set of custom layers that could be a part of the
+ *         feed forward network.
+ */
+template<typename... CustomLayers>
+class QuantizedFFN
+{
+ public:
+  //! Create an empty QuantizedFFN, to be loaded.
+  QuantizedFFN();
+
+  /**
+   * Quantize the given trained network.  The network isn't modified, and its
+   * layers are run in deterministic mode on the calibration data to find the
+   * range of the input of each quantized layer.
+   *
+   * @param network The trained network to quantize.
+   * @param calibrationData Representative inputs of the network, one per
+   *     column.
+   */
+  template<typename OutputLayerType, typename InitializationRuleType>
+  QuantizedFFN(
+      FFN<OutputLayerType, InitializationRuleType, CustomLayers...>& network,
+      const arma::mat& calibrationData);
+
+  //! Copy constructor.
+  QuantizedFFN(const QuantizedFFN& other);
+
+  //! Move constructor.
+  QuantizedFFN(QuantizedFFN&& other);
+
+  //! Copy/move assignment operator.
+  QuantizedFFN& operator=(QuantizedFFN other);
+
+  //! Destructor to release allocated memory.
+  ~QuantizedFFN();
+
+  /**
+   * Predict the responses to a given set of predictors.  The predictors are
+   * passed through the network in batches of the given size.
+   *
+   * @param predictors Input predictors.
+   * @param results Matrix to put output predictions of responses into.
+   * @param batchSize The number of predictors passed through the network at
+   *     once.
+   */
+  void Predict(const arma::mat& predictors,
+               arma::mat& results,
+               const size_t batchSize = 256);
+
+  //! Get the number of layers of the network.
+  size_t NumLayers() const { return quantizedStage.size(); }
+
+  //! Get the number of quantized layers.
+  size_t NumQuantizedLayers() const { return quantized.size(); }
+
+  //! Get the quantized layers, in order.
+  const std::vector<QuantizedLayer>& QuantizedLayers() const
+  {
+    return quantized;
+  }
+
+  //! Get the parameters of the layers that aren't quantized.
+  const arma::mat& Parameters() const { return parameter; }
+
+  //! Serialize the model.
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */);
+
+ private:
+  //! Swap the content of this network with the given network.
+  void Swap(QuantizedFFN& other);
+
+  //! Point the weights of the layers that aren't quantized into the parameter
+  //! matrix, and put them in deterministic mode.
+  void ResetWeights();
+
+  //! The layers that aren't quantized, in order.
+  std::vector<LayerTypes<CustomLayers...> > network;
+
+  //! The quantized layers, in order.
+  std::vector<QuantizedLayer> quantized;
+
+  //! Whether each layer of the original network is quantized.
+  std::vector<bool> quantizedStage;
+
+  //! The parameters of the layers that aren't quantized.
+  arma::mat parameter;
+
+  //! Locally-stored outputs of the quantized layers.
+  arma::mat output[2];
+}; // class QuantizedFFN
+
+} // namespace ann
+} // namespace mlpack
+
+// Include implementation.
+#include "quantized_ffn_impl.hpp"
+
+#endif
@@ -0,0 +1,255 @@
+/**
+ * @file methods/ann/quantized_ffn_impl.hpp
+ *
+ * Implementation of the QuantizedFFN class, an inference-only version of a
+ * trained feed forward network whose dense and convolution layers use int8
+ * weights.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_QUANTIZED_FFN_IMPL_HPP
+#define MLPACK_METHODS_ANN_QUANTIZED_FFN_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "quantized_ffn.hpp"
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+template<typename... CustomLayers>
+QuantizedFFN<CustomLayers...>::QuantizedFFN()
+{
+  // Nothing to do here.
+}
+
+template<typename... CustomLayers>
+template<typename OutputLayerType, typename InitializationRuleType>
+QuantizedFFN<CustomLayers...>::QuantizedFFN(
+    FFN<OutputLayerType, InitializationRuleType, CustomLayers...>& model,
+    const arma::mat& calibrationData)
+{
+  if (model.Model().empty() || model.Parameters().is_empty())
+  {
+    throw std::invalid_argument("QuantizedFFN::QuantizedFFN(): the network "
+        "must have layers and trained or initialized parameters!");
+  }
+
+  // The copies of the layers use a copy of the parameters of the network
+  // during calibration.
+  arma::mat calibrationParameters = model.Parameters();
+  std::vector<size_t> offsets, sizes;
+  size_t keptWeights = 0;
+
+  CopyVisitor<CustomLayers...> copyVisitor;
+  DeleteVisitor deleteVisitor;
+  ResetVisitor resetVisitor;
+
+  arma::mat input = calibrationData, layerOutput;
+  size_t width = 0, height = 0, offset = 0;
+  for (size_t i = 0; i < model.Model().size(); ++i)
+  {
+    LayerTypes<CustomLayers...> layer = boost::apply_visitor(copyVisitor,
+        model.Model()[i]);
+    const size_t weights = boost::apply_visitor(WeightSetVisitor(
+        calibrationParameters, offset), layer);
+    boost::apply_visitor(resetVisitor, layer);
+    boost::apply_visitor(DeterministicSetVisitor(true), layer);
+
+    // Propagate the sizes of the maps as FFN does on its first pass.
+    if (i > 0)
+    {
+      boost::apply_visitor(SetInputWidthVisitor(width), layer);
+      boost::apply_visitor(SetInputHeightVisitor(height), layer);
+    }
+
+    QuantizedLayer quantizedLayer;
+    const bool quantize = boost::apply_visitor(QuantizeVisitor(input,
+        quantizedLayer), layer);
+
+    // The calibration inputs of the next layers are computed in double
+    // precision.
+    boost::apply_visitor(ForwardVisitor(input, layerOutput), layer);
+
+    if (boost::apply_visitor(OutputWidthVisitor(), layer) != 0)
+      width = boost::apply_visitor(OutputWidthVisitor(), layer);
+    if (boost::apply_visitor(OutputHeightVisitor(), layer) != 0)
+      height = boost::apply_visitor(OutputHeightVisitor(), layer);
+
+    if (quantize)
+    {
+      quantized.push_back(std::move(quantizedLayer));
+      boost::apply_visitor(deleteVisitor, layer);
+    }
+    else
+    {
+      network.push_back(layer);
+      offsets.push_back(offset);
+      sizes.push_back(weights);
+      keptWeights += weights;
+    }
+
+    quantizedStage.push_back(quantize);
+    offset += weights;
+    input.swap(layerOutput);
+  }
+
+  // Only the parameters of the layers that aren't quantized are kept.
+  parameter.set_size(keptWeights, 1);
+  for (size_t i = 0, start = 0; i < offsets.size(); start += sizes[i++])
+  {
+    if (sizes[i] != 0)
+    {
+      parameter.rows(start, start + sizes[i] - 1) =
+          calibrationParameters.rows(offsets[i], offsets[i] + sizes[i] - 1);
+    }
+  }
+
+  ResetWeights();
+}
+
+template<typename... CustomLayers>
+QuantizedFFN<CustomLayers...>::QuantizedFFN(const QuantizedFFN& other) :
+    quantized(other.quantized),
+    quantizedStage(other.quantizedStage),
+    parameter(other.parameter)
+{
+  CopyVisitor<CustomLayers...> copyVisitor;
+  for (size_t i = 0; i < other.network.size(); ++i)
+    network.push_back(boost::apply_visitor(copyVisitor, other.network[i]));
+
+  ResetWeights();
+}
+
+template<typename... CustomLayers>
+QuantizedFFN<CustomLayers...>::QuantizedFFN(QuantizedFFN&& other) :
+    network(std::move(other.network)),
+    quantized(std::move(other.quantized)),
+    quantizedStage(std::move(other.quantizedStage)),
+    parameter(std::move(other.parameter))
+{
+  other.network.clear();
+
+  // Small parameter matrices are copied and not moved.
+  ResetWeights();
+}
+
+template<typename... CustomLayers>
+QuantizedFFN<CustomLayers...>&
+QuantizedFFN<CustomLayers...>::operator=(QuantizedFFN other)
+{
+  Swap(other);
+  ResetWeights();
+  return *this;
+}
+
+template<typename... CustomLayers>
+QuantizedFFN<CustomLayers...>::~QuantizedFFN()
+{
+  DeleteVisitor deleteVisitor;
+  std::for_each(network.begin(), network.end(),
+      boost::apply_visitor(deleteVisitor));
+}
+
+template<typename... CustomLayers>
+void QuantizedFFN<CustomLayers...>::Swap(QuantizedFFN& other)
+{
+  std::swap(network, other.network);
+  std::swap(quantized, other.quantized);
+  std::swap(quantizedStage, other.quantizedStage);
+  std::swap(parameter, other.parameter);
+}
+
+template<typename... CustomLayers>
+void QuantizedFFN<CustomLayers...>::ResetWeights()
+{
+  ResetVisitor resetVisitor;
+  size_t offset = 0;
+  for (size_t i = 0; i < network.size(); ++i)
+  {
+    offset += boost::apply_visitor(WeightSetVisitor(parameter, offset),
+        network[i]);
+    boost::apply_visitor(resetVisitor, network[i]);
+    boost::apply_visitor(DeterministicSetVisitor(true), network[i]);
+  }
+}
+
+template<typename... CustomLayers>
+void QuantizedFFN<CustomLayers...>::Predict(const arma::mat& predictors,
+                                            arma::mat& results,
+                                            const size_t batchSize)
+{
+  if (quantizedStage.empty())
+  {
+    throw std::invalid_argument("QuantizedFFN::Predict(): the model has no "
+        "layers!");
+  }
+
+  OutputParameterVisitor outputParameterVisitor;
+  for (size_t begin = 0; begin < predictors.n_cols; begin += batchSize)
+  {
+    const size_t effectiveBatchSize = std::min(batchSize,
+        size_t(predictors.n_cols) - begin);
+    const arma::mat batch(const_cast<double*>(predictors.colptr(begin)),
+        predictors.n_rows, effectiveBatchSize, false, true);
+
+    // The quantized layers alternate between two output matrices, and the
+    // other layers write into their own output.
+    const arma::mat* input = &batch;
+    for (size_t i = 0, l = 0, q = 0; i < quantizedStage.size(); ++i)
+    {
+      arma::mat* layerOutput;
+      if (quantizedStage[i])
+      {
+        layerOutput = &output[i % 2];
+        quantized[q++].Forward(*input, *layerOutput);
+      }
+      else
+      {
+        layerOutput = &boost::apply_visitor(outputParameterVisitor,
+            network[l]);
+        boost::apply_visitor(ForwardVisitor(*input, *layerOutput),
+            network[l++]);
+      }
+
+      input = layerOutput;
+    }
+
+    if (begin == 0)
+      results.set_size(input->n_rows, predictors.n_cols);
+
+    results.cols(begin, begin + effectiveBatchSize - 1) = *input;
+  }
+}
+
+template<typename... CustomLayers>
+template<typename Archive>
+void QuantizedFFN<CustomLayers...>::serialize(
+    Archive& ar, const unsigned int /* version */)
+{
+  ar & BOOST_SERIALIZATION_NVP(parameter);
+
+  // Be sure to clear other layers before loading.
+  if (Archive::is_loading::value)
+  {
+    DeleteVisitor deleteVisitor;
+    std::for_each(network.begin(), network.end(),
+        boost::apply_visitor(deleteVisitor));
+    network.clear();
+  }
+
+  ar & BOOST_SERIALIZATION_NVP(network);
+  ar & BOOST_SERIALIZATION_NVP(quantized);
+  ar & BOOST_SERIALIZATION_NVP(quantizedStage);
+
+  // If we are loading, we need to initialize the weights.
+  if (Archive::is_loading::value)
+    ResetWeights();
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
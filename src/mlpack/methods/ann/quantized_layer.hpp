@@ -0,0 +1,205 @@
+/**
+ * @file methods/ann/quantized_layer.hpp
+ *
+ * Definition of the QuantizedLayer class, the int8 version of the affine map of
+ * a Linear, Linear3D or Convolution layer used by QuantizedFFN.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_QUANTIZED_LAYER_HPP
+#define MLPACK_METHODS_ANN_QUANTIZED_LAYER_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * The int8 version of the affine map y = W x + b of a layer, for inference
+ * only.  The weights are quantized symmetrically with one scale per output
+ * channel (the largest absolute weight of the channel maps to 127), and the
+ * input is quantized with one scale that is fixed from calibration data (the
+ * largest absolute input seen during calibration maps to 127; larger inputs
+ * are clipped).  The products are accumulated in 32-bit integers and the
+ * result is scaled back to double precision before the bias is added.
+ *
+ * Without a kernel size, the map is applied to every block of InputSize()
+ * consecutive rows of each input column: this is a Linear layer when the
+ * input has InputSize() rows, and a Linear3D layer otherwise.  With a kernel
+ * size, the map is applied to every patch of the input maps, as a
+ * Convolution layer does.
+ *
+ * The inner loop is a dot product of two contiguous int8 vectors with a 32-bit
+ * accumulator, which compilers turn into the 8-bit dot product instructions
+ * of the target (for instance VNNI on recent x86 processors).
+ */
+class QuantizedLayer
+{
+ public:
+  //! Create an empty QuantizedLayer, to be loaded.
+  QuantizedLayer();
+
+  /**
+   * Quantize the weights of a fully connected map.
+   *
+   * @param filters The weights, with the weights of output channel i in column
+   *     i (the transpose of the weight of a Linear layer).
+   * @param bias The bias of each output channel.
+   * @param inputRange The largest absolute value of the input in the
+   *     calibration data.
+   */
+  QuantizedLayer(const arma::mat& filters,
+                 const arma::vec& bias,
+                 const double inputRange);
+
+  /**
+   * Quantize the weights of a convolution.  The rows of each filter are
+   * ordered as the rows of Im2ColConvolution::Im2Col(), which is the order of
+   * the weights of the Convolution layer.
+   *
+   * @param filters The filters, with the filter of output map i in column i.
+   * @param bias The bias of each output map.
+   * @param inputRange The largest absolute value of the input in the
+   *     calibration data.
+   * @param inputWidth Width of the input maps.
+   * @param inputHeight Height of the input maps.
+   * @param maps Number of input maps.
+   * @param kernelWidth Width of the filters.
+   * @param kernelHeight Height of the filters.
+   * @param strideWidth Stride of filter application in the x direction.
+   * @param strideHeight Stride of filter application in the y direction.
+   * @param padWLeft Padding width of the left side.
+   * @param padWRight Padding width of the right side.
+   * @param padHTop Padding height of the top side.
+   * @param padHBottom Padding height of the bottom side.
+   */
+  QuantizedLayer(const arma::mat& filters,
+                 const arma::vec& bias,
+                 const double inputRange,
+                 const size_t inputWidth,
+                 const size_t inputHeight,
+                 const size_t maps,
+                 const size_t kernelWidth,
+                 const size_t kernelHeight,
+                 const size_t strideWidth,
+                 const size_t strideHeight,
+                 const size_t padWLeft,
+                 const size_t padWRight,
+                 const size_t padHTop,
+                 const size_t padHBottom);
+
+  /**
+   * Compute the output of the map for every column of the given input.
+   *
+   * @param input Input data used for evaluating the map.
+   * @param output Resulting output.
+   */
+  void Forward(const arma::mat& input, arma::mat& output);
+
+  //! Get the number of inputs of each application of the map.
+  size_t InputSize() const { return inSize; }
+  //! Get the number of output channels.
+  size_t OutputSize() const { return outSize; }
+  //! Get whether the map is a convolution.
+  bool IsConvolution() const { return kernelWidth != 0; }
+
+  //! Get the quantized weights, with the weights of each channel contiguous.
+  const std::vector<int8_t>& Weights() const { return weights; }
+  //! Get the scale of the weights of each output channel.
+  const arma::vec& WeightScales() const { return weightScales; }
+  //! Get the scale of the input.
+  double InputScale() const { return inputScale; }
+  //! Get the bias.
+  const arma::vec& Bias() const { return bias; }
+
+  /**
+   * Serialize the layer.
+   */
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */);
+
+ private:
+  //! Quantize the given filters and set the input scale.
+  void Quantize(const arma::mat& filters, const double inputRange);
+
+  //! Quantize the given input into quantizedInput.
+  void QuantizeInput(const double* input, const size_t n);
+
+  //! Compute the output of every column of quantizedInput into the given
+  //! memory, with the outputs of each column contiguous.
+  void Multiply(const size_t columns, double* output) const;
+
+  //! Number of inputs of each application of the map.
+  size_t inSize;
+
+  //! Number of output channels.
+  size_t outSize;
+
+  //! Width of the input maps (convolution only).
+  size_t inputWidth;
+
+  //! Height of the input maps (convolution only).
+  size_t inputHeight;
+
+  //! Number of input maps (convolution only).
+  size_t maps;
+
+  //! Width of the filters, or 0 for a fully connected map.
+  size_t kernelWidth;
+
+  //! Height of the filters.
+  size_t kernelHeight;
+
+  //! Stride in the x direction.
+  size_t strideWidth;
+
+  //! Stride in the y direction.
+  size_t strideHeight;
+
+  //! Padding width of the left side.
+  size_t padWLeft;
+
+  //! Padding width of the right side.
+  size_t padWRight;
+
+  //! Padding height of the top side.
+  size_t padHTop;
+
+  //! Padding height of the bottom side.
+  size_t padHBottom;
+
+  //! The quantized weights, channel after channel.
+  std::vector<int8_t> weights;
+
+  //! The scale of the weights of each output channel.
+  arma::vec weightScales;
+
+  //! The scale of the input.
+  double inputScale;
+
+  //! The bias of each output channel.
+  arma::vec bias;
+
+  //! Locally-stored quantized input.
+  std::vector<int8_t> quantizedInput;
+
+  //! Locally-stored padded input maps.
+  arma::cube paddedInput;
+
+  //! Locally-stored lowered input maps.
+  arma::mat columns;
+
+  //! Locally-stored output of the lowered product.
+  arma::mat product;
+}; // class QuantizedLayer
+
+} // namespace ann
+} // namespace mlpack
+
+// Include implementation.
+#include "quantized_layer_impl.hpp"
+
+#endif
@@ -0,0 +1,243 @@
+/**
+ * @file methods/ann/quantized_layer_impl.hpp
+ *
+ * Implementation of the QuantizedLayer class, the int8 version of the affine
+ * map of a Linear, Linear3D or Convolution layer used by QuantizedFFN.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_QUANTIZED_LAYER_IMPL_HPP
+#define MLPACK_METHODS_ANN_QUANTIZED_LAYER_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "quantized_layer.hpp"
+
+#include <mlpack/methods/ann/convolution_rules/border_modes.hpp>
+#include <mlpack/methods/ann/convolution_rules/im2col_convolution.hpp>
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+inline QuantizedLayer::QuantizedLayer() :
+    inSize(0),
+    outSize(0),
+    inputWidth(0),
+    inputHeight(0),
+    maps(0),
+    kernelWidth(0),
+    kernelHeight(0),
+    strideWidth(1),
+    strideHeight(1),
+    padWLeft(0),
+    padWRight(0),
+    padHTop(0),
+    padHBottom(0),
+    inputScale(1.0)
+{
+  // Nothing to do here.
+}
+
+inline QuantizedLayer::QuantizedLayer(const arma::mat& filters,
+                                      const arma::vec& bias,
+                                      const double inputRange) :
+    inputWidth(0),
+    inputHeight(0),
+    maps(0),
+    kernelWidth(0),
+    kernelHeight(0),
+    strideWidth(1),
+    strideHeight(1),
+    padWLeft(0),
+    padWRight(0),
+    padHTop(0),
+    padHBottom(0),
+    bias(bias)
+{
+  Quantize(filters, inputRange);
+}
+
+inline QuantizedLayer::QuantizedLayer(const arma::mat& filters,
+                                      const arma::vec& bias,
+                                      const double inputRange,
+                                      const size_t inputWidth,
+                                      const size_t inputHeight,
+                                      const size_t maps,
+                                      const size_t kernelWidth,
+                                      const size_t kernelHeight,
+                                      const size_t strideWidth,
+                                      const size_t strideHeight,
+                                      const size_t padWLeft,
+                                      const size_t padWRight,
+                                      const size_t padHTop,
+                                      const size_t padHBottom) :
+    inputWidth(inputWidth),
+    inputHeight(inputHeight),
+    maps(maps),
+    kernelWidth(kernelWidth),
+    kernelHeight(kernelHeight),
+    strideWidth(strideWidth),
+    strideHeight(strideHeight),
+    padWLeft(padWLeft),
+    padWRight(padWRight),
+    padHTop(padHTop),
+    padHBottom(padHBottom),
+    bias(bias)
+{
+  if (filters.n_rows != kernelWidth * kernelHeight * maps)
+  {
+    throw std::invalid_argument("QuantizedLayer::QuantizedLayer(): the "
+        "filters must have kernelWidth * kernelHeight * maps rows!");
+  }
+
+  Quantize(filters, inputRange);
+}
+
+inline void QuantizedLayer::Quantize(const arma::mat& filters,
+                                     const double inputRange)
+{
+  if (bias.n_elem != filters.n_cols)
+  {
+    throw std::invalid_argument("QuantizedLayer::QuantizedLayer(): the bias "
+        "must have one element per filter!");
+  }
+
+  inSize = filters.n_rows;
+  outSize = filters.n_cols;
+
+  // The filters are stored column by column, which is the order of the
+  // quantized weights.
+  weights.resize(filters.n_elem);
+  weightScales.set_size(outSize);
+  for (size_t i = 0; i < outSize; ++i)
+  {
+    const double range = arma::abs(filters.col(i)).max();
+    weightScales[i] = (range > 0.0) ? range / 127.0 : 1.0;
+
+    const double* filter = filters.colptr(i);
+    int8_t* weight = weights.data() + i * inSize;
+    for (size_t k = 0; k < inSize; ++k)
+      weight[k] = (int8_t) std::round(filter[k] / weightScales[i]);
+  }
+
+  inputScale = (inputRange > 0.0) ? inputRange / 127.0 : 1.0;
+}
+
+inline void QuantizedLayer::QuantizeInput(const double* input, const size_t n)
+{
+  quantizedInput.resize(n);
+
+  const double inverseScale = 1.0 / inputScale;
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) n; ++i)
+  {
+    const double value = std::round(input[i] * inverseScale);
+    quantizedInput[i] = (int8_t) std::min(127.0, std::max(-127.0, value));
+  }
+}
+
+inline void QuantizedLayer::Multiply(const size_t columns, double* output)
+    const
+{
+  #pragma omp parallel for
+  for (omp_size_t j = 0; j < (omp_size_t) columns; ++j)
+  {
+    const int8_t* x = quantizedInput.data() + j * inSize;
+    double* y = output + j * outSize;
+    for (size_t i = 0; i < outSize; ++i)
+    {
+      const int8_t* w = weights.data() + i * inSize;
+      int32_t sum = 0;
+      for (size_t k = 0; k < inSize; ++k)
+        sum += int32_t(w[k]) * int32_t(x[k]);
+
+      y[i] = sum * (weightScales[i] * inputScale) + bias[i];
+    }
+  }
+}
+
+inline void QuantizedLayer::Forward(const arma::mat& input, arma::mat& output)
+{
+  if (!IsConvolution())
+  {
+    if (input.n_rows % inSize != 0)
+    {
+      throw std::invalid_argument("QuantizedLayer::Forward(): the number of "
+          "rows of the input must be divisible by InputSize()!");
+    }
+
+    // Each block of inSize rows is one application of the map, and the
+    // outputs of the blocks of a column are contiguous.
+    QuantizeInput(input.memptr(), input.n_elem);
+    output.set_size(outSize * (input.n_rows / inSize), input.n_cols);
+    Multiply(input.n_elem / inSize, output.memptr());
+    return;
+  }
+
+  if (input.n_rows != inputWidth * inputHeight * maps)
+  {
+    throw std::invalid_argument("QuantizedLayer::Forward(): the number of "
+        "rows of the input must be inputWidth * inputHeight * maps!");
+  }
+
+  const size_t batchSize = input.n_cols;
+  const arma::cube inputTemp(const_cast<double*>(input.memptr()), inputWidth,
+      inputHeight, maps * batchSize, false, false);
+
+  const bool padded = (padWLeft != 0 || padWRight != 0 || padHTop != 0 ||
+      padHBottom != 0);
+  if (padded)
+  {
+    paddedInput.zeros(inputWidth + padWLeft + padWRight,
+        inputHeight + padHTop + padHBottom, inputTemp.n_slices);
+    paddedInput.subcube(padWLeft, padHTop, 0, padWLeft + inputWidth - 1,
+        padHTop + inputHeight - 1, inputTemp.n_slices - 1) = inputTemp;
+  }
+
+  Im2ColConvolution<ValidConvolution>::Im2Col(padded ? paddedInput :
+      inputTemp, maps, kernelWidth, kernelHeight, columns, strideWidth,
+      strideHeight);
+
+  QuantizeInput(columns.memptr(), columns.n_elem);
+  product.set_size(outSize, columns.n_cols);
+  Multiply(columns.n_cols, product.memptr());
+
+  // The product holds the output maps of each position, and the output holds
+  // each map of each point contiguously.
+  const size_t mapSize = columns.n_cols / batchSize;
+  output.set_size(mapSize * outSize, batchSize);
+  for (size_t i = 0; i < batchSize; ++i)
+  {
+    arma::mat outputMaps(output.colptr(i), mapSize, outSize, false, true);
+    outputMaps = product.cols(i * mapSize, (i + 1) * mapSize - 1).t();
+  }
+}
+
+template<typename Archive>
+void QuantizedLayer::serialize(Archive& ar, const unsigned int /* version */)
+{
+  ar & BOOST_SERIALIZATION_NVP(inSize);
+  ar & BOOST_SERIALIZATION_NVP(outSize);
+  ar & BOOST_SERIALIZATION_NVP(inputWidth);
+  ar & BOOST_SERIALIZATION_NVP(inputHeight);
+  ar & BOOST_SERIALIZATION_NVP(maps);
+  ar & BOOST_SERIALIZATION_NVP(kernelWidth);
+  ar & BOOST_SERIALIZATION_NVP(kernelHeight);
+  ar & BOOST_SERIALIZATION_NVP(strideWidth);
+  ar & BOOST_SERIALIZATION_NVP(strideHeight);
+  ar & BOOST_SERIALIZATION_NVP(padWLeft);
+  ar & BOOST_SERIALIZATION_NVP(padWRight);
+  ar & BOOST_SERIALIZATION_NVP(padHTop);
+  ar & BOOST_SERIALIZATION_NVP(padHBottom);
+  ar & BOOST_SERIALIZATION_NVP(weights);
+  ar & BOOST_SERIALIZATION_NVP(weightScales);
+  ar & BOOST_SERIALIZATION_NVP(inputScale);
+  ar & BOOST_SERIALIZATION_NVP(bias);
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
@@ -51,7 +51,9 @@ class RBM
    * @param hiddenSize Number of hidden neurons.
    * @param batchSize Batch size to be used for training.
    * @param numSteps Number of Gibbs Sampling steps.
-   * @param negSteps Number of negative samples to average negative gradient.
+   * @param negSteps Number of negative samples to average negative gradient;
+   *        for a binary RBM, the chains of the negative samples are sampled
+   *        together, and with persistence, each of them is kept.
    * @param poolSize Number of hidden neurons to pool together.
    * @param slabPenalty Regulariser of slab variables.
    * @param radius Feasible regions for visible layer samples.
@@ -380,6 +382,15 @@ class RBM
   void serialize(Archive& ar, const unsigned int /* version */);
 
  private:
+  /**
+   * Replace each given probability by a sample of the Bernoulli distribution
+   * with that probability.  The samples are generated in parallel with the
+   * counter-based generator of math::RandomCounter().
+   *
+   * @param probabilities The probabilities, overwritten by the samples.
+   */
+  void SampleBernoulli(arma::Mat<ElemType>& probabilities);
+
   //! Locally stored parameters of the network.
   arma::Mat<ElemType> parameter;
   //! The matrix of data points (predictors).
@@ -446,6 +457,10 @@ class RBM
   bool persistence;
   //! Locally-stored reset variable.
   bool reset;
+  //! The key of the stream of random numbers used for sampling.
+  uint64_t samplingKey;
+  //! The index of the next random number of the stream used for sampling.
+  uint64_t samplingCounter;
 };
 
 } // namespace ann
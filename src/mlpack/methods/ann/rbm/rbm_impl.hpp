@@ -48,7 +48,9 @@ RBM<InitializationRuleType, DataType, PolicyType>::RBM(
     slabPenalty(slabPenalty),
     radius(2 * radius),
     persistence(persistence),
-    reset(false)
+    reset(false),
+    samplingKey((uint64_t(math::randGen()) << 32) | math::randGen()),
+    samplingCounter(0)
 {
   numFunctions = this->predictors.n_cols;
 }
@@ -136,8 +138,10 @@ RBM<InitializationRuleType, DataType, PolicyType>::Phase(
   DataType hiddenBiasGrad = DataType(gradient.memptr() + weightGrad.n_elem,
       hiddenSize, 1, false, false);
 
-  HiddenMean(input, hiddenBiasGrad);
-  weightGrad.slice(0) = hiddenBiasGrad * input.t();
+  // The gradients are summed over the columns of the input.
+  HiddenMean(input, preActivation);
+  weightGrad.slice(0) = preActivation * input.t();
+  hiddenBiasGrad = arma::sum(preActivation, 1);
 }
 
 template<
@@ -152,8 +156,11 @@ double RBM<InitializationRuleType, DataType, PolicyType>::Evaluate(
 {
   Gibbs(predictors.cols(i, i + batchSize - 1),
       negativeSamples);
+
+  // Persistent chains may hold more samples than the batch.
   return std::fabs(FreeEnergy(predictors.cols(i,
-      i + batchSize - 1)) - FreeEnergy(negativeSamples));
+      i + batchSize - 1)) - FreeEnergy(negativeSamples) * batchSize /
+      negativeSamples.n_cols);
 }
 
 template<
@@ -168,11 +175,7 @@ RBM<InitializationRuleType, DataType, PolicyType>::SampleHidden(
     arma::Mat<ElemType>& output)
 {
   HiddenMean(input, output);
-
-  for (size_t i = 0; i < output.n_elem; ++i)
-  {
-    output(i) = math::RandBernoulli(output(i));
-  }
+  SampleBernoulli(output);
 }
 
 template<
@@ -187,11 +190,7 @@ RBM<InitializationRuleType, DataType, PolicyType>::SampleVisible(
     arma::Mat<ElemType>& output)
 {
   VisibleMean(input, output);
-
-  for (size_t i = 0; i < output.n_elem; ++i)
-  {
-    output(i) = math::RandBernoulli(output(i));
-  }
+  SampleBernoulli(output);
 }
 
 template<
@@ -277,18 +276,49 @@ void RBM<InitializationRuleType, DataType, PolicyType>::Gradient(
   Phase(predictors.cols(i, i + batchSize - 1),
       positiveGradient);
 
-  for (size_t i = 0; i < negSteps; ++i)
+  if (std::is_same<PolicyType, BinaryRBM>::value)
   {
-    Gibbs(predictors.cols(i, i + batchSize - 1),
+    // The chains of all the negative samples are the columns of one matrix,
+    // so that they are sampled together; Phase() sums their gradients.
+    Gibbs(arma::repmat(predictors.cols(i, i + batchSize - 1), 1, negSteps),
         negativeSamples);
-    Phase(negativeSamples, tempNegativeGradient);
-
-    negativeGradient += tempNegativeGradient;
+    Phase(negativeSamples, negativeGradient);
+  }
+  else
+  {
+    for (size_t j = 0; j < negSteps; ++j)
+    {
+      Gibbs(predictors.cols(i, i + batchSize - 1),
+          negativeSamples);
+      Phase(negativeSamples, tempNegativeGradient);
+
+      negativeGradient += tempNegativeGradient;
+    }
   }
 
   gradient = ((negativeGradient / negSteps) - positiveGradient);
 }
 
+template<
+  typename InitializationRuleType,
+  typename DataType,
+  typename PolicyType
+>
+void RBM<InitializationRuleType, DataType, PolicyType>::SampleBernoulli(
+    arma::Mat<ElemType>& probabilities)
+{
+  const uint64_t first = samplingCounter;
+  samplingCounter += probabilities.n_elem;
+
+  ElemType* samples = probabilities.memptr();
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) probabilities.n_elem; ++i)
+  {
+    samples[i] = (math::RandomCounter(samplingKey, first + i) < samples[i]) ?
+        1 : 0;
+  }
+}
+
 template<
   typename InitializationRuleType,
   typename DataType,
@@ -256,10 +256,8 @@ RBM<InitializationRuleType, DataType, PolicyType>::SampleSpike(
     InputType& spikeMean,
     DataType& spike)
 {
-  for (size_t i = 0; i < hiddenSize; ++i)
-  {
-    spike(i) = math::RandBernoulli(spikeMean(i));
-  }
+  spike = spikeMean;
+  SampleBernoulli(spike);
 }
 
 template<
@@ -14,12 +14,15 @@
 
 #include <mlpack/prereqs.hpp>
 
+#include "visitor/copy_visitor.hpp"
 #include "visitor/delete_visitor.hpp"
 #include "visitor/delta_visitor.hpp"
 #include "visitor/output_parameter_visitor.hpp"
 #include "visitor/reset_visitor.hpp"
 
 #include "init_rules/network_init.hpp"
+#include "inference_context.hpp"
+#include "layer_profiler.hpp"
 
 #include <mlpack/methods/ann/layer/layer_types.hpp>
 #include <mlpack/methods/ann/layer/layer.hpp>
@@ -190,6 +193,42 @@ class RNN
                arma::cube& results,
                const size_t batchSize = 256);
 
+  /**
+   * Predict the responses to a given set of predictors without modifying the
+   * network.  The layers that hold the outputs (and the cell states) of the
+   * prediction are in the given context (built by the first prediction, and
+   * reused afterwards), and their weights point into the parameters of this
+   * network.  So several threads can predict with one network at once, each
+   * with its own context.  The network must have been trained (or its
+   * parameters set).
+   *
+   * @param predictors Input predictors.
+   * @param results Matrix to put output predictions of responses into.
+   * @param context Context of the calling thread.
+   * @param batchSize Number of points to predict at once.
+   */
+  void Predict(const arma::cube& predictors,
+               arma::cube& results,
+               InferenceContext<RNN>& context,
+               const size_t batchSize = 256) const;
+
+  /**
+   * Predict the responses to the next time step of one or more sequences (one
+   * per column of the input), continuing from the state left by the previous
+   * call.  Each call costs one forward pass of one time step, so sequences of
+   * any length can be streamed.  The state of the recurrent cells (LSTM,
+   * FastLSTM and GRU layers of the network) is kept in StepState(); call
+   * ResetStepState() to start new sequences, or save and restore
+   * StepState() to interleave several streams.
+   *
+   * @param input Input of the time step (one column per sequence).
+   * @param output Matrix to put the output of the time step into.
+   */
+  void Step(const arma::mat& input, arma::mat& output);
+
+  //! Start new sequences at the next call to Step().
+  void ResetStepState() { stepState.clear(); }
+
   /**
    * Evaluate the recurrent neural network with the given parameters. This
    * function is usually called by the optimizer to train the model.
@@ -281,11 +320,34 @@ class RNN
   //! Return the number of separable functions (the number of predictor points).
   size_t NumFunctions() const { return numFunctions; }
 
+  //! Get the network model.
+  const std::vector<LayerTypes<CustomLayers...> >& Model() const
+  {
+    return network;
+  }
+  //! Modify the network model.  Be careful!  If you change the structure of
+  //! the network or parameters for layers, its state may become invalid, so be
+  //! sure to call ResetParameters() afterwards.
+  std::vector<LayerTypes<CustomLayers...> >& Model() { return network; }
+
+  //! Get the profiler that records the time and memory of each layer (NULL
+  //! if none).
+  LayerProfiler* Profiler() const { return profiler; }
+  //! Modify the profiler that records the time and memory of each layer.  It
+  //! is usually set by passing a LayerProfiler to Train().
+  LayerProfiler*& Profiler() { return profiler; }
+
   //! Return the initial point for the optimization.
   const arma::mat& Parameters() const { return parameter; }
   //! Modify the initial point for the optimization.
   arma::mat& Parameters() { return parameter; }
 
+  //! Get the state of the recurrent cells after the last call to Step() (one
+  //! matrix per layer; empty at the start of the sequences).
+  const std::vector<arma::mat>& StepState() const { return stepState; }
+  //! Modify the state of the recurrent cells used by the next call to Step().
+  std::vector<arma::mat>& StepState() { return stepState; }
+
   //! Return the maximum length of backpropagation through time.
   const size_t& Rho() const { return rho; }
   //! Modify the maximum length of backpropagation through time.
@@ -357,6 +419,10 @@ class RNN
    */
   void ResetGradients(arma::mat& gradient);
 
+  //! Create a copy of the layers of the network, with their weights pointing
+  //! into the parameters of the network.
+  RNN* Replicate() const;
+
   //! Number of steps to backpropagate through time (BPTT).
   size_t rho;
 
@@ -418,12 +484,21 @@ class RNN
   //! Locally-stored delete visitor.
   DeleteVisitor deleteVisitor;
 
+  //! Locally-stored copy visitor.
+  CopyVisitor<CustomLayers...> copyVisitor;
+
   //! The current evaluation mode (training or testing).
   bool deterministic;
 
   //! The current gradient for the gradient pass.
   arma::mat currentGradient;
 
+  //! The state of each layer between two calls to Step().
+  std::vector<arma::mat> stepState;
+
+  //! The profiler of the layers, if any; it isn't owned by the network.
+  LayerProfiler* profiler;
+
   // The BRN class should have access to internal members.
   template<
     typename OutputLayerType1,
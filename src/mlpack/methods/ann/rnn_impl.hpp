@@ -20,6 +20,8 @@
 #include "visitor/forward_visitor.hpp"
 #include "visitor/backward_visitor.hpp"
 #include "visitor/reset_cell_visitor.hpp"
+#include "visitor/load_state_visitor.hpp"
+#include "visitor/save_state_visitor.hpp"
 #include "visitor/deterministic_set_visitor.hpp"
 #include "visitor/gradient_set_visitor.hpp"
 #include "visitor/gradient_visitor.hpp"
@@ -46,7 +48,8 @@ RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::RNN(
     reset(false),
     single(single),
     numFunctions(0),
-    deterministic(true)
+    deterministic(true),
+    profiler(NULL)
 {
   /* Nothing to do here */
 }
@@ -130,6 +133,32 @@ double RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::Train(
   return out;
 }
 
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+RNN<OutputLayerType, InitializationRuleType, CustomLayers...>*
+RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::Replicate() const
+{
+  RNN* replica = new RNN(rho, single, outputLayer, initializeRule);
+  replica->inputSize = inputSize;
+  replica->outputSize = outputSize;
+  replica->targetSize = targetSize;
+  replica->reset = reset;
+
+  // The weights are only read through the replica, so they can point into the
+  // parameters of this network.
+  arma::mat& sharedParameter = const_cast<arma::mat&>(parameter);
+  size_t offset = 0;
+  for (size_t i = 0; i < network.size(); ++i)
+  {
+    replica->network.push_back(boost::apply_visitor(copyVisitor, network[i]));
+    offset += boost::apply_visitor(WeightSetVisitor(sharedParameter, offset),
+        replica->network.back());
+    boost::apply_visitor(resetVisitor, replica->network.back());
+  }
+
+  return replica;
+}
+
 template<typename OutputLayerType, typename InitializationRuleType,
          typename... CustomLayers>
 void RNN<OutputLayerType, InitializationRuleType,
@@ -224,6 +253,84 @@ void RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::Predict(
   }
 }
 
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::Predict(
+    const arma::cube& predictors,
+    arma::cube& results,
+    InferenceContext<RNN>& context,
+    const size_t batchSize) const
+{
+  if (parameter.is_empty())
+  {
+    throw std::invalid_argument("RNN::Predict(): the network has no "
+        "parameters; train it or call ResetParameters() first");
+  }
+
+  if (!context.Ready(parameter))
+  {
+    context.Clear();
+
+    // The layers of the context are a copy of the layers of this network, and
+    // the parameters of the context are an alias of the parameters of this
+    // network, so that the context never initializes them.
+    RNN* replica = Replicate();
+    replica->parameter = arma::mat(const_cast<double*>(parameter.memptr()),
+        parameter.n_rows, parameter.n_cols, false, true);
+    replica->deterministic = true;
+    replica->ResetDeterministic();
+
+    context.network = replica;
+    context.parameter = parameter.memptr();
+  }
+
+  context.network->Predict(predictors, results, batchSize);
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::Step(
+    const arma::mat& input, arma::mat& output)
+{
+  if (parameter.is_empty())
+  {
+    ResetParameters();
+  }
+
+  if (!deterministic)
+  {
+    deterministic = true;
+    ResetDeterministic();
+  }
+
+  if (stepState.empty())
+  {
+    stepState.resize(network.size());
+  }
+  else if (stepState.size() != network.size())
+  {
+    throw std::invalid_argument("RNN::Step(): the state has "
+        + std::to_string(stepState.size()) + " layers, but the network has "
+        + std::to_string(network.size()) + "!");
+  }
+
+  // Two steps through time are enough for the cells: the loaded state takes
+  // the place of the first one.
+  for (size_t i = 0; i < network.size(); ++i)
+  {
+    boost::apply_visitor(ResetCellVisitor(2), network[i]);
+    if (!stepState[i].is_empty())
+      boost::apply_visitor(LoadStateVisitor(stepState[i]), network[i]);
+  }
+
+  Forward(input);
+
+  for (size_t i = 0; i < network.size(); ++i)
+    boost::apply_visitor(SaveStateVisitor(stepState[i]), network[i]);
+
+  output = boost::apply_visitor(outputParameterVisitor, network.back());
+}
+
 template<typename OutputLayerType, typename InitializationRuleType,
          typename... CustomLayers>
 double RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::Evaluate(
@@ -413,6 +520,17 @@ EvaluateWithGradient(const arma::mat& /* parameters */,
     gradient += currentGradient;
   }
 
+  // The outputs of every step are stored for BPTT.
+  if (profiler)
+  {
+    for (size_t l = 0; l < network.size(); ++l)
+    {
+      profiler->Memory(l, effectiveRho * sizeof(double) * boost::apply_visitor(
+          outputParameterVisitor, network[l]).n_elem, sizeof(double) *
+          boost::apply_visitor(deltaVisitor, network[l]).n_elem);
+    }
+  }
+
   return performance;
 }
 
@@ -492,16 +610,28 @@ template<typename InputType>
 void RNN<OutputLayerType, InitializationRuleType,
          CustomLayers...>::Forward(const InputType& input)
 {
+  if (profiler)
+    profiler->Start();
+
   boost::apply_visitor(ForwardVisitor(input,
       boost::apply_visitor(outputParameterVisitor, network.front())),
       network.front());
 
+  if (profiler)
+    profiler->Stop(0, LayerProfiler::FORWARD);
+
   for (size_t i = 1; i < network.size(); ++i)
   {
+    if (profiler)
+      profiler->Start();
+
     boost::apply_visitor(ForwardVisitor(
         boost::apply_visitor(outputParameterVisitor, network[i - 1]),
         boost::apply_visitor(outputParameterVisitor, network[i])),
         network[i]);
+
+    if (profiler)
+      profiler->Stop(i, LayerProfiler::FORWARD);
   }
 }
 
@@ -509,19 +639,31 @@ template<typename OutputLayerType, typename InitializationRuleType,
          typename... CustomLayers>
 void RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::Backward()
 {
+  if (profiler)
+    profiler->Start();
+
   boost::apply_visitor(BackwardVisitor(
         boost::apply_visitor(outputParameterVisitor, network.back()),
         error, boost::apply_visitor(deltaVisitor,
         network.back())), network.back());
 
+  if (profiler)
+    profiler->Stop(network.size() - 1, LayerProfiler::BACKWARD);
+
   for (size_t i = 2; i < network.size(); ++i)
   {
+    if (profiler)
+      profiler->Start();
+
     boost::apply_visitor(BackwardVisitor(
         boost::apply_visitor(outputParameterVisitor,
         network[network.size() - i]), boost::apply_visitor(
         deltaVisitor, network[network.size() - i + 1]),
         boost::apply_visitor(deltaVisitor, network[network.size() - i])),
         network[network.size() - i]);
+
+    if (profiler)
+      profiler->Stop(network.size() - i, LayerProfiler::BACKWARD);
   }
 }
 
@@ -531,15 +673,27 @@ template<typename InputType>
 void RNN<OutputLayerType, InitializationRuleType,
          CustomLayers...>::Gradient(const InputType& input)
 {
+  if (profiler)
+    profiler->Start();
+
   boost::apply_visitor(GradientVisitor(input,
       boost::apply_visitor(deltaVisitor, network[1])), network.front());
 
+  if (profiler)
+    profiler->Stop(0, LayerProfiler::GRADIENT);
+
   for (size_t i = 1; i < network.size() - 1; ++i)
   {
+    if (profiler)
+      profiler->Start();
+
     boost::apply_visitor(GradientVisitor(
         boost::apply_visitor(outputParameterVisitor, network[i - 1]),
         boost::apply_visitor(deltaVisitor, network[i + 1])),
         network[i]);
+
+    if (profiler)
+      profiler->Stop(i, LayerProfiler::GRADIENT);
   }
 }
 
@@ -0,0 +1,589 @@
+/**
+ * @file methods/ann/static_ffn.hpp
+ *
+ * Definition of the StaticFFN class, a feed forward neural network whose layers
+ * are fixed at compile time.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_STATIC_FFN_HPP
+#define MLPACK_METHODS_ANN_STATIC_FFN_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include "visitor/deterministic_set_visitor.hpp"
+#include "visitor/gradient_set_visitor.hpp"
+#include "visitor/loss_visitor.hpp"
+#include "visitor/output_height_visitor.hpp"
+#include "visitor/output_width_visitor.hpp"
+#include "visitor/reset_visitor.hpp"
+#include "visitor/set_input_height_visitor.hpp"
+#include "visitor/set_input_width_visitor.hpp"
+#include "visitor/weight_set_visitor.hpp"
+#include "visitor/weight_size_visitor.hpp"
+
+#include "init_rules/init_rules_traits.hpp"
+
+#include <mlpack/methods/ann/layer/layer.hpp>
+#include <mlpack/methods/ann/init_rules/random_init.hpp>
+#include <mlpack/methods/ann/layer/layer_traits.hpp>
+#include <ensmallen.hpp>
+
+#include <tuple>
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * Implementation of a feed forward network whose sequence of layers is part of
+ * its type.  The layers are held by value in a std::tuple, and the forward
+ * pass, the backward pass and the gradient are unrolled at compile time: each
+ * step calls the layer directly instead of going through boost::apply_visitor()
+ * over the LayerTypes variant, so the calls can be inlined.  This matters most
+ * for small batches, where the dispatch of FFN is a large part of the cost of
+ * a step.  The interface (Train(), Predict(), Evaluate() and the functions
+ * called by the optimizers) is the same as the interface of FFN, but layers
+ * can't be added after construction.
+ *
+ * The matrix type of the network (for the data, the parameters and the
+ * gradient) is the type of the output of its layers, so a network whose layers
+ * are instantiated with arma::fmat is trained and evaluated entirely in single
+ * precision, and the optimizer works on arma::fmat coordinates.  Layers that
+ * hold other layers (those with a Model() function) only work in double
+ * precision.
+ *
+ * @code
+ * StaticFFN<MeanSquaredError<>, RandomInitialization, Linear<>, ReLULayer<>,
+ *     Linear<>> model(Linear<>(10, 20), ReLULayer<>(), Linear<>(20, 1));
+ * model.Train(predictors, responses);
+ * model.Predict(points, results);
+ *
+ * StaticFFN<MeanSquaredError<arma::fmat, arma::fmat>, RandomInitialization,
+ *     Linear<arma::fmat, arma::fmat>, ReLULayer<arma::fmat, arma::fmat>,
+ *     Linear<arma::fmat, arma::fmat>> floatModel(
+ *     Linear<arma::fmat, arma::fmat>(10, 20),
+ *     ReLULayer<arma::fmat, arma::fmat>(),
+ *     Linear<arma::fmat, arma::fmat>(20, 1));
+ * floatModel.Train(arma::conv_to<arma::fmat>::from(predictors),
+ *     arma::conv_to<arma::fmat>::from(responses));
+ * @endcode
+ *
+ * @tparam OutputLayerType The output layer type used to evaluate the network.
+ * @tparam InitializationRuleType Rule used to initialize the weight matrix.
+ * @tparam Layers The types of the layers of the network, in order.
+ */
+template<
+  typename OutputLayerType,
+  typename InitializationRuleType,
+  typename... Layers
+>
+class StaticFFN
+{
+  static_assert(sizeof...(Layers) > 0, "StaticFFN must have at least one "
+      "layer.");
+
+ public:
+  //! The number of layers of the network.
+  static const size_t NumLayers = sizeof...(Layers);
+
+  //! The type of the layer with the given index.
+  template<size_t I>
+  using LayerType = typename std::tuple_element<I,
+      std::tuple<Layers...>>::type;
+
+  //! The matrix type of the data, the parameters and the gradient, which is
+  //! the type of the output of the layers.
+  typedef typename std::decay<decltype(
+      std::declval<LayerType<0>&>().OutputParameter())>::type MatType;
+
+  //! The element type of the data and the parameters.
+  typedef typename MatType::elem_type ElemType;
+
+  /**
+   * Create the StaticFFN object from the given layers, using a default output
+   * layer and initialization rule.
+   *
+   * @param layers The layers of the network, in order.
+   */
+  StaticFFN(Layers... layers);
+
+  /**
+   * Create the StaticFFN object from the given layers, output layer and
+   * initialization rule.
+   *
+   * @param outputLayer Output layer used to evaluate the network.
+   * @param initializeRule Instantiated InitializationRule object for
+   *        initializing the network parameter.
+   * @param layers The layers of the network, in order.
+   */
+  StaticFFN(OutputLayerType outputLayer,
+            InitializationRuleType initializeRule,
+            Layers... layers);
+
+  //! Copy constructor.
+  StaticFFN(const StaticFFN& other);
+
+  //! Move constructor.
+  StaticFFN(StaticFFN&& other);
+
+  //! Copy/move assignment operator.
+  StaticFFN& operator=(StaticFFN other);
+
+  /**
+   * Train the feedforward network on the given input data using the given
+   * optimizer.
+   *
+   * @tparam OptimizerType Type of optimizer to use to train the model.
+   * @tparam CallbackTypes Types of Callback Functions.
+   * @param predictors Input training variables.
+   * @param responses Outputs results from input training variables.
+   * @param optimizer Instantiated optimizer used to train the model.
+   * @param callbacks Callback function for ensmallen optimizer `OptimizerType`.
+   *      See https://www.ensmallen.org/docs.html#callback-documentation.
+   * @return The final objective of the trained model (NaN or Inf on error).
+   */
+  template<typename OptimizerType, typename... CallbackTypes>
+  double Train(MatType predictors,
+               MatType responses,
+               OptimizerType& optimizer,
+               CallbackTypes&&... callbacks);
+
+  /**
+   * Train the feedforward network on the given input data with a default
+   * constructed optimizer.
+   *
+   * @tparam OptimizerType Type of optimizer to use to train the model.
+   * @tparam CallbackTypes Types of Callback Functions.
+   * @param predictors Input training variables.
+   * @param responses Outputs results from input training variables.
+   * @param callbacks Callback function for ensmallen optimizer `OptimizerType`.
+   *      See https://www.ensmallen.org/docs.html#callback-documentation.
+   * @return The final objective of the trained model (NaN or Inf on error).
+   */
+  template<typename OptimizerType = ens::RMSProp, typename... CallbackTypes>
+  double Train(MatType predictors,
+               MatType responses,
+               CallbackTypes&&... callbacks);
+
+  /**
+   * Predict the responses to a given set of predictors.  Unlike FFN, all the
+   * predictors are passed through the network as one batch.
+   *
+   * @param predictors Input predictors.
+   * @param results Matrix to put output predictions of responses into.
+   */
+  void Predict(MatType predictors, MatType& results);
+
+  /**
+   * Evaluate the feedforward network with the given predictors and responses.
+   * This functions is usually used to monitor progress while training.
+   *
+   * @param predictors Input variables.
+   * @param responses Target outputs for input variables.
+   */
+  template<typename PredictorsType, typename ResponsesType>
+  double Evaluate(const PredictorsType& predictors,
+                  const ResponsesType& responses);
+
+  /**
+   * Evaluate the feedforward network with the given parameters. This function
+   * is usually called by the optimizer to train the model.
+   *
+   * @param parameters Matrix model parameters.
+   */
+  ElemType Evaluate(const MatType& parameters);
+
+  /**
+   * Evaluate the feedforward network with the given parameters, but using only
+   * a number of data points.
+   *
+   * @param parameters Matrix model parameters.
+   * @param begin Index of the starting point to use for objective function
+   *        evaluation.
+   * @param batchSize Number of points to be passed at a time to use for
+   *        objective function evaluation.
+   * @param deterministic Whether or not to train or test the model. Note some
+   *        layer act differently in training or testing mode.
+   */
+  ElemType Evaluate(const MatType& parameters,
+                    const size_t begin,
+                    const size_t batchSize,
+                    const bool deterministic);
+
+  /**
+   * Evaluate the feedforward network with the given parameters, but using only
+   * a number of data points.  This just calls the overload of Evaluate() with
+   * deterministic = true.
+   *
+   * @param parameters Matrix model parameters.
+   * @param begin Index of the starting point to use for objective function
+   *        evaluation.
+   * @param batchSize Number of points to be passed at a time to use for
+   *        objective function evaluation.
+   */
+  ElemType Evaluate(const MatType& parameters,
+                    const size_t begin,
+                    const size_t batchSize);
+
+  /**
+   * Evaluate the feedforward network with the given parameters, and compute
+   * the gradient.  This just calls the overload of EvaluateWithGradient() with
+   * batchSize = 1 for each point.
+   *
+   * @param parameters Matrix model parameters.
+   * @param gradient Matrix to output gradient into.
+   */
+  template<typename GradType>
+  ElemType EvaluateWithGradient(const MatType& parameters,
+                                GradType& gradient);
+
+  /**
+   * Evaluate the feedforward network with the given parameters, but using only
+   * a number of data points, and compute the gradient.
+   *
+   * @param parameters Matrix model parameters.
+   * @param begin Index of the starting point to use for objective function
+   *        evaluation.
+   * @param gradient Matrix to output gradient into.
+   * @param batchSize Number of points to be passed at a time to use for
+   *        objective function evaluation.
+   */
+  template<typename GradType>
+  ElemType EvaluateWithGradient(const MatType& parameters,
+                                const size_t begin,
+                                GradType& gradient,
+                                const size_t batchSize);
+
+  /**
+   * Evaluate the gradient of the feedforward network with the given parameters,
+   * and with respect to only a number of points in the dataset.
+   *
+   * @param parameters Matrix of the model parameters to be optimized.
+   * @param begin Index of the starting point to use for objective function
+   *        gradient evaluation.
+   * @param gradient Matrix to output gradient into.
+   * @param batchSize Number of points to be processed as a batch for objective
+   *        function gradient evaluation.
+   */
+  void Gradient(const MatType& parameters,
+                const size_t begin,
+                MatType& gradient,
+                const size_t batchSize);
+
+  /**
+   * Shuffle the order of function visitation. This may be called by the
+   * optimizer.
+   */
+  void Shuffle();
+
+  //! Get the layer with the given index.
+  template<size_t I>
+  const LayerType<I>& Layer() const { return std::get<I>(network); }
+  //! Modify the layer with the given index.
+  template<size_t I>
+  LayerType<I>& Layer() { return std::get<I>(network); }
+
+  //! Return the number of separable functions (the number of predictor points).
+  size_t NumFunctions() const { return numFunctions; }
+
+  //! Return the initial point for the optimization.
+  const MatType& Parameters() const { return parameter; }
+  //! Modify the initial point for the optimization.
+  MatType& Parameters() { return parameter; }
+
+  //! Get the matrix of responses to the input data points.
+  const MatType& Responses() const { return responses; }
+  //! Modify the matrix of responses to the input data points.
+  MatType& Responses() { return responses; }
+
+  //! Get the matrix of data points (predictors).
+  const MatType& Predictors() const { return predictors; }
+  //! Modify the matrix of data points (predictors).
+  MatType& Predictors() { return predictors; }
+
+  /**
+   * Reset the module infomration (weights/parameters).
+   */
+  void ResetParameters();
+
+  //! Serialize the model.
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */);
+
+  /**
+   * Perform the forward pass of the data in real batch mode.
+   *
+   * @param inputs The input data.
+   * @param results The predicted results.
+   */
+  template<typename PredictorsType, typename ResponsesType>
+  void Forward(const PredictorsType& inputs, ResponsesType& results);
+
+  /**
+   * Perform the backward pass of the data in real batch mode.  Forward() must
+   * have been called with the same inputs before.
+   *
+   * @param inputs Inputs of current pass.
+   * @param targets The training target.
+   * @param gradients Computed gradients.
+   * @return Training error of the current pass.
+   */
+  template<typename PredictorsType,
+           typename TargetsType,
+           typename GradientsType>
+  double Backward(const PredictorsType& inputs,
+                  const TargetsType& targets,
+                  GradientsType& gradients);
+
+ private:
+  //! Prepare the network for the given predictors and responses.
+  void ResetData(MatType predictors, MatType responses);
+
+  //! Warn if the optimizer will not pass over the entire dataset.
+  template<typename OptimizerType>
+  typename std::enable_if<
+      HasMaxIterations<OptimizerType, size_t&(OptimizerType::*)()>
+      ::value, void>::type
+  WarnMessageMaxIterations(OptimizerType& optimizer, size_t samples) const;
+
+  //! The optimizer has no MaxIterations() parameter, so there's nothing to
+  //! check.
+  template<typename OptimizerType>
+  typename std::enable_if<
+      !HasMaxIterations<OptimizerType, size_t&(OptimizerType::*)()>
+      ::value, void>::type
+  WarnMessageMaxIterations(OptimizerType& optimizer, size_t samples) const;
+
+  //! Point the weights of every layer into the parameter matrix.
+  void ResetWeights();
+
+  //! Compute the output of the network for the given input.
+  void Forward(const MatType& input);
+
+  //! Compute the loss of the output layer and of every layer.
+  template<typename ResponsesType>
+  double Loss(const ResponsesType& responses);
+
+  //! Compute the error of the output layer and the deltas of the layers.
+  template<typename ResponsesType>
+  void Backward(const ResponsesType& responses);
+
+  //! Set the deterministic mode of every layer.
+  void ResetDeterministic();
+
+  //! Point the gradients of every layer into the given matrix.
+  void ResetGradients(MatType& gradient);
+
+  // The steps of the passes, one instantiation per layer.  The last overload
+  // of each step ends the recursion.
+
+  template<size_t I>
+  typename std::enable_if<(I < sizeof...(Layers)), void>::type
+  ForwardLayer(const MatType& input);
+  template<size_t I>
+  typename std::enable_if<(I == sizeof...(Layers)), void>::type
+  ForwardLayer(const MatType& /* input */) { }
+
+  template<size_t I>
+  typename std::enable_if<(I > 0), void>::type
+  BackwardLayer(const MatType& gy);
+  template<size_t I>
+  typename std::enable_if<(I == 0), void>::type
+  BackwardLayer(const MatType& gy);
+
+  template<size_t I>
+  typename std::enable_if<(I < sizeof...(Layers)), void>::type
+  GradientLayer(const MatType& input);
+  template<size_t I>
+  typename std::enable_if<(I == sizeof...(Layers)), void>::type
+  GradientLayer(const MatType& /* input */) { }
+
+  //! The error of the output of the given layer: the delta of the next layer,
+  //! or the error of the output layer for the last layer.
+  template<size_t I>
+  typename std::enable_if<(I + 1 < sizeof...(Layers)), MatType&>::type
+  OutputError() { return std::get<I + 1>(network).Delta(); }
+  template<size_t I>
+  typename std::enable_if<(I + 1 == sizeof...(Layers)), MatType&>::type
+  OutputError() { return error; }
+
+  template<size_t I>
+  typename std::enable_if<(I < sizeof...(Layers)), double>::type
+  LayerLoss();
+  template<size_t I>
+  typename std::enable_if<(I == sizeof...(Layers)), double>::type
+  LayerLoss()
+  {
+    return 0.0;
+  }
+
+  template<size_t I>
+  typename std::enable_if<(I < sizeof...(Layers)), size_t>::type
+  WeightSize();
+  template<size_t I>
+  typename std::enable_if<(I == sizeof...(Layers)), size_t>::type
+  WeightSize()
+  {
+    return 0;
+  }
+
+  template<size_t I>
+  typename std::enable_if<(I < sizeof...(Layers)), void>::type
+  InitializeLayers(const size_t offset);
+  template<size_t I>
+  typename std::enable_if<(I == sizeof...(Layers)), void>::type
+  InitializeLayers(const size_t /* offset */) { }
+
+  template<size_t I>
+  typename std::enable_if<(I < sizeof...(Layers)), void>::type
+  SetWeights(const size_t offset);
+  template<size_t I>
+  typename std::enable_if<(I == sizeof...(Layers)), void>::type
+  SetWeights(const size_t /* offset */) { }
+
+  template<size_t I>
+  typename std::enable_if<(I < sizeof...(Layers)), void>::type
+  SetGradients(MatType& gradient, const size_t offset);
+  template<size_t I>
+  typename std::enable_if<(I == sizeof...(Layers)), void>::type
+  SetGradients(MatType& /* gradient */, const size_t /* offset */) { }
+
+  template<size_t I>
+  typename std::enable_if<(I < sizeof...(Layers)), void>::type
+  SetDeterministic();
+  template<size_t I>
+  typename std::enable_if<(I == sizeof...(Layers)), void>::type
+  SetDeterministic() { }
+
+  template<size_t I, typename Archive>
+  typename std::enable_if<(I < sizeof...(Layers)), void>::type
+  SerializeLayers(Archive& ar);
+  template<size_t I, typename Archive>
+  typename std::enable_if<(I == sizeof...(Layers)), void>::type
+  SerializeLayers(Archive& /* ar */) { }
+
+  //! Compute the gradient of a layer with parameters.
+  template<typename T>
+  typename std::enable_if<
+      HasGradientCheck<T, MatType&(T::*)()>::value, void>::type
+  LayerGradient(T* layer, const MatType& input, const MatType& error)
+  {
+    layer->Gradient(input, error, layer->Gradient());
+  }
+
+  //! The layer has no parameters, so there's no gradient to compute.
+  template<typename T>
+  typename std::enable_if<
+      !HasGradientCheck<T, MatType&(T::*)()>::value, void>::type
+  LayerGradient(T* /* layer */,
+                const MatType& /* input */,
+                const MatType& /* error */) { }
+
+  //! Point the parameters of a layer that holds other layers into the
+  //! parameter matrix.
+  template<typename T>
+  typename std::enable_if<HasModelCheck<T>::value, size_t>::type
+  LayerWeights(T* layer, const size_t offset)
+  {
+    return WeightSetVisitor(parameter, offset)(layer);
+  }
+
+  //! Point the parameters of a layer into the parameter matrix.
+  template<typename T>
+  typename std::enable_if<!HasModelCheck<T>::value &&
+      HasParametersCheck<T, MatType&(T::*)()>::value, size_t>::type
+  LayerWeights(T* layer, const size_t offset)
+  {
+    layer->Parameters() = MatType(parameter.memptr() + offset,
+        layer->Parameters().n_rows, layer->Parameters().n_cols, false, false);
+    return layer->Parameters().n_elem;
+  }
+
+  //! The layer has no parameters.
+  template<typename T>
+  typename std::enable_if<!HasModelCheck<T>::value &&
+      !HasParametersCheck<T, MatType&(T::*)()>::value, size_t>::type
+  LayerWeights(T* /* layer */, const size_t /* offset */) { return 0; }
+
+  //! Point the gradient of a layer that holds other layers into the given
+  //! matrix.
+  template<typename T>
+  typename std::enable_if<HasModelCheck<T>::value, size_t>::type
+  LayerGradients(T* layer, MatType& gradient, const size_t offset)
+  {
+    return GradientSetVisitor(gradient, offset)(layer);
+  }
+
+  //! Point the gradient of a layer into the given matrix.
+  template<typename T>
+  typename std::enable_if<!HasModelCheck<T>::value &&
+      HasGradientCheck<T, MatType&(T::*)()>::value, size_t>::type
+  LayerGradients(T* layer, MatType& gradient, const size_t offset)
+  {
+    layer->Gradient() = MatType(gradient.memptr() + offset,
+        layer->Parameters().n_rows, layer->Parameters().n_cols, false, false);
+    return layer->Parameters().n_elem;
+  }
+
+  //! The layer has no gradient.
+  template<typename T>
+  typename std::enable_if<!HasModelCheck<T>::value &&
+      !HasGradientCheck<T, MatType&(T::*)()>::value, size_t>::type
+  LayerGradients(T* /* layer */,
+                 MatType& /* gradient */,
+                 const size_t /* offset */) { return 0; }
+
+  //! Get the output of the last layer.
+  MatType& NetworkOutput()
+  {
+    return std::get<NumLayers - 1>(network).OutputParameter();
+  }
+
+  //! Instantiated outputlayer used to evaluate the network.
+  OutputLayerType outputLayer;
+
+  //! Instantiated InitializationRule object for initializing the network
+  //! parameter.
+  InitializationRuleType initializeRule;
+
+  //! The layers of the network.
+  std::tuple<Layers...> network;
+
+  //! The input width.
+  size_t width;
+
+  //! The input height.
+  size_t height;
+
+  //! Indicator if we already trained the model.
+  bool reset;
+
+  //! The matrix of data points (predictors).
+  MatType predictors;
+
+  //! The matrix of responses to the input data points.
+  MatType responses;
+
+  //! Matrix of (trained) parameters.
+  MatType parameter;
+
+  //! The number of separable functions (the number of predictor points).
+  size_t numFunctions;
+
+  //! The current error for the backward pass.
+  MatType error;
+
+  //! The current evaluation mode (training or testing).
+  bool deterministic;
+}; // class StaticFFN
+
+} // namespace ann
+} // namespace mlpack
+
+// Include implementation.
+#include "static_ffn_impl.hpp"
+
+#endif
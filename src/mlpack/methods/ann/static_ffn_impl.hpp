@@ -0,0 +1,658 @@
+/**
+ * @file methods/ann/static_ffn_impl.hpp
+ *
+ * Implementation of the StaticFFN class, a feed forward neural network whose
+ * layers are fixed at compile time.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_STATIC_FFN_IMPL_HPP
+#define MLPACK_METHODS_ANN_STATIC_FFN_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "static_ffn.hpp"
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::StaticFFN(
+    Layers... layers) :
+    network(std::move(layers)...),
+    width(0),
+    height(0),
+    reset(false),
+    numFunctions(0),
+    deterministic(false)
+{
+  /* Nothing to do here. */
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::StaticFFN(
+    OutputLayerType outputLayer,
+    InitializationRuleType initializeRule,
+    Layers... layers) :
+    outputLayer(std::move(outputLayer)),
+    initializeRule(std::move(initializeRule)),
+    network(std::move(layers)...),
+    width(0),
+    height(0),
+    reset(false),
+    numFunctions(0),
+    deterministic(false)
+{
+  /* Nothing to do here. */
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::StaticFFN(
+    const StaticFFN& other) :
+    outputLayer(other.outputLayer),
+    initializeRule(other.initializeRule),
+    network(other.network),
+    width(other.width),
+    height(other.height),
+    reset(other.reset),
+    predictors(other.predictors),
+    responses(other.responses),
+    parameter(other.parameter),
+    numFunctions(other.numFunctions),
+    error(other.error),
+    deterministic(other.deterministic)
+{
+  // The weights of the copied layers still point into the parameters of the
+  // other network.
+  ResetWeights();
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::StaticFFN(
+    StaticFFN&& other) :
+    outputLayer(std::move(other.outputLayer)),
+    initializeRule(std::move(other.initializeRule)),
+    network(std::move(other.network)),
+    width(other.width),
+    height(other.height),
+    reset(other.reset),
+    predictors(std::move(other.predictors)),
+    responses(std::move(other.responses)),
+    parameter(std::move(other.parameter)),
+    numFunctions(other.numFunctions),
+    error(std::move(other.error)),
+    deterministic(other.deterministic)
+{
+  // Small matrices are copied and not moved, so the weights have to be set
+  // again.
+  ResetWeights();
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+StaticFFN<OutputLayerType, InitializationRuleType, Layers...>&
+StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::operator=(
+    StaticFFN other)
+{
+  outputLayer = std::move(other.outputLayer);
+  initializeRule = std::move(other.initializeRule);
+  network = std::move(other.network);
+  width = other.width;
+  height = other.height;
+  reset = other.reset;
+  predictors = std::move(other.predictors);
+  responses = std::move(other.responses);
+  parameter = std::move(other.parameter);
+  numFunctions = other.numFunctions;
+  error = std::move(other.error);
+  deterministic = other.deterministic;
+
+  ResetWeights();
+  return *this;
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+void StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::
+ResetData(MatType predictors, MatType responses)
+{
+  numFunctions = responses.n_cols;
+  this->predictors = std::move(predictors);
+  this->responses = std::move(responses);
+  this->deterministic = false;
+  ResetDeterministic();
+
+  if (!reset)
+    ResetParameters();
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+template<typename OptimizerType>
+typename std::enable_if<
+      HasMaxIterations<OptimizerType, size_t&(OptimizerType::*)()>
+      ::value, void>::type
+StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::
+WarnMessageMaxIterations(OptimizerType& optimizer, size_t samples) const
+{
+  if (optimizer.MaxIterations() < samples &&
+      optimizer.MaxIterations() != 0)
+  {
+    Log::Warn << "The optimizer's maximum number of iterations "
+              << "is less than the size of the dataset; the "
+              << "optimizer will not pass over the entire "
+              << "dataset. To fix this, modify the maximum "
+              << "number of iterations to be at least equal "
+              << "to the number of points of your dataset "
+              << "(" << samples << ")." << std::endl;
+  }
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+template<typename OptimizerType>
+typename std::enable_if<
+      !HasMaxIterations<OptimizerType, size_t&(OptimizerType::*)()>
+      ::value, void>::type
+StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::
+WarnMessageMaxIterations(OptimizerType& /* optimizer */, size_t /* samples */)
+    const
+{
+  return;
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+template<typename OptimizerType, typename... CallbackTypes>
+double StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::
+Train(MatType predictors,
+      MatType responses,
+      OptimizerType& optimizer,
+      CallbackTypes&&... callbacks)
+{
+  ResetData(std::move(predictors), std::move(responses));
+
+  WarnMessageMaxIterations<OptimizerType>(optimizer, this->predictors.n_cols);
+
+  // Train the model.
+  Timer::Start("ffn_optimization");
+  const double out = optimizer.Optimize(*this, parameter, callbacks...);
+  Timer::Stop("ffn_optimization");
+
+  Log::Info << "StaticFFN::StaticFFN(): final objective of trained model is "
+      << out << "." << std::endl;
+  return out;
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+template<typename OptimizerType, typename... CallbackTypes>
+double StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::
+Train(MatType predictors,
+      MatType responses,
+      CallbackTypes&&... callbacks)
+{
+  ResetData(std::move(predictors), std::move(responses));
+
+  OptimizerType optimizer;
+
+  WarnMessageMaxIterations<OptimizerType>(optimizer, this->predictors.n_cols);
+
+  // Train the model.
+  Timer::Start("ffn_optimization");
+  const double out = optimizer.Optimize(*this, parameter, callbacks...);
+  Timer::Stop("ffn_optimization");
+
+  Log::Info << "StaticFFN::StaticFFN(): final objective of trained model is "
+      << out << "." << std::endl;
+  return out;
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+template<typename PredictorsType, typename ResponsesType>
+void StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::
+Forward(const PredictorsType& inputs, ResponsesType& results)
+{
+  if (parameter.is_empty())
+    ResetParameters();
+
+  Forward(inputs);
+  results = NetworkOutput();
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+template<typename PredictorsType, typename TargetsType, typename GradientsType>
+double StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::
+Backward(const PredictorsType& inputs,
+         const TargetsType& targets,
+         GradientsType& gradients)
+{
+  const double res = Loss(targets);
+
+  gradients = arma::zeros<MatType>(parameter.n_rows, parameter.n_cols);
+
+  Backward(targets);
+  ResetGradients(gradients);
+  GradientLayer<0>(inputs);
+
+  return res;
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+void StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::
+Predict(MatType predictors, MatType& results)
+{
+  if (parameter.is_empty())
+    ResetParameters();
+
+  if (!deterministic)
+  {
+    deterministic = true;
+    ResetDeterministic();
+  }
+
+  Forward(predictors);
+  results = NetworkOutput();
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+template<typename PredictorsType, typename ResponsesType>
+double StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::
+Evaluate(const PredictorsType& predictors, const ResponsesType& responses)
+{
+  if (parameter.is_empty())
+    ResetParameters();
+
+  if (!deterministic)
+  {
+    deterministic = true;
+    ResetDeterministic();
+  }
+
+  Forward(predictors);
+  return Loss(responses);
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+typename StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::ElemType
+StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::
+Evaluate(const MatType& parameters)
+{
+  ElemType res = 0;
+  for (size_t i = 0; i < predictors.n_cols; ++i)
+    res += Evaluate(parameters, i, 1, true);
+
+  return res;
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+typename StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::ElemType
+StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::
+Evaluate(const MatType& /* parameters */,
+         const size_t begin,
+         const size_t batchSize,
+         const bool deterministic)
+{
+  if (parameter.is_empty())
+    ResetParameters();
+
+  if (deterministic != this->deterministic)
+  {
+    this->deterministic = deterministic;
+    ResetDeterministic();
+  }
+
+  Forward(predictors.cols(begin, begin + batchSize - 1));
+  return Loss(responses.cols(begin, begin + batchSize - 1));
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+typename StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::ElemType
+StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::
+Evaluate(const MatType& parameters,
+         const size_t begin,
+         const size_t batchSize)
+{
+  return Evaluate(parameters, begin, batchSize, true);
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+template<typename GradType>
+typename StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::ElemType
+StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::
+EvaluateWithGradient(const MatType& parameters, GradType& gradient)
+{
+  ElemType res = 0;
+  for (size_t i = 0; i < predictors.n_cols; ++i)
+    res += EvaluateWithGradient(parameters, i, gradient, 1);
+
+  return res;
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+template<typename GradType>
+typename StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::ElemType
+StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::
+EvaluateWithGradient(const MatType& /* parameters */,
+                     const size_t begin,
+                     GradType& gradient,
+                     const size_t batchSize)
+{
+  if (gradient.is_empty())
+  {
+    if (parameter.is_empty())
+      ResetParameters();
+
+    gradient = arma::zeros<MatType>(parameter.n_rows, parameter.n_cols);
+  }
+  else
+  {
+    gradient.zeros();
+  }
+
+  if (this->deterministic)
+  {
+    this->deterministic = false;
+    ResetDeterministic();
+  }
+
+  // The input is needed by both passes, so extract the batch only once.
+  const MatType input = predictors.cols(begin, begin + batchSize - 1);
+  const MatType target = responses.cols(begin, begin + batchSize - 1);
+
+  Forward(input);
+  const double res = Loss(target);
+
+  Backward(target);
+  ResetGradients(gradient);
+  GradientLayer<0>(input);
+
+  return res;
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+void StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::
+Gradient(const MatType& parameters,
+         const size_t begin,
+         MatType& gradient,
+         const size_t batchSize)
+{
+  this->EvaluateWithGradient(parameters, begin, gradient, batchSize);
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+void StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::
+Shuffle()
+{
+  math::ShuffleData(predictors, responses, predictors, responses);
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+void StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::
+ResetParameters()
+{
+  ResetDeterministic();
+
+  // Reset the network parameter with the given initialization rule, layer by
+  // layer or for the complete network.
+  parameter.set_size(WeightSize<0>(), 1);
+  if (ann::InitTraits<InitializationRuleType>::UseLayer)
+    InitializeLayers<0>(0);
+  else
+    initializeRule.Initialize(parameter, parameter.n_elem, 1);
+
+  SetWeights<0>(0);
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+void StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::
+ResetWeights()
+{
+  if (!parameter.is_empty())
+    SetWeights<0>(0);
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+void StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::
+ResetDeterministic()
+{
+  SetDeterministic<0>();
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+void StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::
+ResetGradients(MatType& gradient)
+{
+  SetGradients<0>(gradient, 0);
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+void StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::
+Forward(const MatType& input)
+{
+  ForwardLayer<0>(input);
+
+  if (!reset)
+    reset = true;
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+template<typename ResponsesType>
+double StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::
+Loss(const ResponsesType& responses)
+{
+  return outputLayer.Forward(NetworkOutput(), responses) + LayerLoss<0>();
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+template<typename ResponsesType>
+void StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::
+Backward(const ResponsesType& responses)
+{
+  outputLayer.Backward(NetworkOutput(), responses, error);
+  BackwardLayer<NumLayers - 1>(error);
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+template<size_t I>
+typename std::enable_if<(I < sizeof...(Layers)), void>::type
+StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::
+ForwardLayer(const MatType& input)
+{
+  LayerType<I>* layer = &std::get<I>(network);
+  MatType& output = layer->OutputParameter();
+
+  if (!reset && I > 0)
+  {
+    SetInputWidthVisitor(width)(layer);
+    SetInputHeightVisitor(height)(layer);
+  }
+
+  layer->Forward(input, output);
+
+  if (!reset)
+  {
+    if (OutputWidthVisitor()(layer) != 0)
+      width = OutputWidthVisitor()(layer);
+
+    if (OutputHeightVisitor()(layer) != 0)
+      height = OutputHeightVisitor()(layer);
+  }
+
+  ForwardLayer<I + 1>(output);
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+template<size_t I>
+typename std::enable_if<(I > 0), void>::type
+StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::
+BackwardLayer(const MatType& gy)
+{
+  LayerType<I>* layer = &std::get<I>(network);
+  MatType& delta = layer->Delta();
+  layer->Backward(layer->OutputParameter(), gy, delta);
+
+  BackwardLayer<I - 1>(delta);
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+template<size_t I>
+typename std::enable_if<(I == 0), void>::type
+StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::
+BackwardLayer(const MatType& /* gy */)
+{
+  // The error with respect to the input of the network isn't needed.
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+template<size_t I>
+typename std::enable_if<(I < sizeof...(Layers)), void>::type
+StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::
+GradientLayer(const MatType& input)
+{
+  LayerType<I>* layer = &std::get<I>(network);
+  LayerGradient(layer, input, OutputError<I>());
+
+  GradientLayer<I + 1>(layer->OutputParameter());
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+template<size_t I>
+typename std::enable_if<(I < sizeof...(Layers)), double>::type
+StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::
+LayerLoss()
+{
+  return LossVisitor()(&std::get<I>(network)) + LayerLoss<I + 1>();
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+template<size_t I>
+typename std::enable_if<(I < sizeof...(Layers)), size_t>::type
+StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::
+WeightSize()
+{
+  return WeightSizeVisitor()(&std::get<I>(network)) + WeightSize<I + 1>();
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+template<size_t I>
+typename std::enable_if<(I < sizeof...(Layers)), void>::type
+StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::
+InitializeLayers(const size_t offset)
+{
+  const size_t weights = WeightSizeVisitor()(&std::get<I>(network));
+  MatType tmp(parameter.memptr() + offset, weights, 1, false, false);
+  initializeRule.Initialize(tmp, tmp.n_elem, 1);
+
+  InitializeLayers<I + 1>(offset + weights);
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+template<size_t I>
+typename std::enable_if<(I < sizeof...(Layers)), void>::type
+StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::
+SetWeights(const size_t offset)
+{
+  LayerType<I>* layer = &std::get<I>(network);
+  const size_t weights = LayerWeights(layer, offset);
+  ResetVisitor()(layer);
+
+  SetWeights<I + 1>(offset + weights);
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+template<size_t I>
+typename std::enable_if<(I < sizeof...(Layers)), void>::type
+StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::
+SetGradients(MatType& gradient, const size_t offset)
+{
+  const size_t weights = LayerGradients(&std::get<I>(network), gradient,
+      offset);
+
+  SetGradients<I + 1>(gradient, offset + weights);
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+template<size_t I>
+typename std::enable_if<(I < sizeof...(Layers)), void>::type
+StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::
+SetDeterministic()
+{
+  DeterministicSetVisitor(deterministic)(&std::get<I>(network));
+
+  SetDeterministic<I + 1>();
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+template<size_t I, typename Archive>
+typename std::enable_if<(I < sizeof...(Layers)), void>::type
+StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::
+SerializeLayers(Archive& ar)
+{
+  ar & boost::serialization::make_nvp("layer", std::get<I>(network));
+
+  SerializeLayers<I + 1>(ar);
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+template<typename Archive>
+void StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::
+serialize(Archive& ar, const unsigned int /* version */)
+{
+  ar & BOOST_SERIALIZATION_NVP(parameter);
+  ar & BOOST_SERIALIZATION_NVP(width);
+  ar & BOOST_SERIALIZATION_NVP(height);
+  ar & BOOST_SERIALIZATION_NVP(reset);
+
+  SerializeLayers<0>(ar);
+
+  // If we are loading, we need to initialize the weights.
+  if (Archive::is_loading::value)
+  {
+    ResetWeights();
+
+    deterministic = true;
+    ResetDeterministic();
+  }
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
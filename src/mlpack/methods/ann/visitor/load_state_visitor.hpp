@@ -0,0 +1,62 @@
+/**
+ * @file methods/ann/visitor/load_state_visitor.hpp
+ *
+ * Boost static visitor abstraction for calling the LoadState() function of
+ * recurrent cells.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_VISITOR_LOAD_STATE_VISITOR_HPP
+#define MLPACK_METHODS_ANN_VISITOR_LOAD_STATE_VISITOR_HPP
+
+#include <mlpack/methods/ann/layer/layer_traits.hpp>
+#include <mlpack/methods/ann/layer/layer_types.hpp>
+
+#include <boost/variant.hpp>
+
+namespace mlpack {
+namespace ann {
+
+/**
+ * LoadStateVisitor executes the LoadState() function; layers that don't
+ * implement it are not changed.
+ */
+class LoadStateVisitor : public boost::static_visitor<void>
+{
+ public:
+  //! Load the given state into the layer.
+  LoadStateVisitor(const arma::mat& state);
+
+  //! Execute the LoadState() function.
+  template<typename LayerType>
+  void operator()(LayerType* layer) const;
+
+  void operator()(MoreTypes layer) const;
+
+ private:
+  //! The state of the layer.
+  const arma::mat& state;
+
+  //! Execute the LoadState() function for a module which implements it.
+  template<typename T>
+  typename std::enable_if<
+      HasLoadStateCheck<T, void(T::*)(const arma::mat&)>::value, void>::type
+  LoadState(T* layer) const;
+
+  //! Do nothing for a module which has no state.
+  template<typename T>
+  typename std::enable_if<
+      !HasLoadStateCheck<T, void(T::*)(const arma::mat&)>::value, void>::type
+  LoadState(T* layer) const;
+};
+
+} // namespace ann
+} // namespace mlpack
+
+// Include implementation.
+#include "load_state_visitor_impl.hpp"
+
+#endif
@@ -0,0 +1,56 @@
+/**
+ * @file methods/ann/visitor/load_state_visitor_impl.hpp
+ *
+ * Implementation of the LoadState() function layer abstraction.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_VISITOR_LOAD_STATE_VISITOR_IMPL_HPP
+#define MLPACK_METHODS_ANN_VISITOR_LOAD_STATE_VISITOR_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "load_state_visitor.hpp"
+
+namespace mlpack {
+namespace ann {
+
+//! LoadStateVisitor visitor class.
+inline LoadStateVisitor::LoadStateVisitor(const arma::mat& state) : state(state)
+{
+  /* Nothing to do here. */
+}
+
+template<typename LayerType>
+inline void LoadStateVisitor::operator()(LayerType* layer) const
+{
+  LoadState(layer);
+}
+
+inline void LoadStateVisitor::operator()(MoreTypes layer) const
+{
+  layer.apply_visitor(*this);
+}
+
+template<typename T>
+inline typename std::enable_if<
+    HasLoadStateCheck<T, void(T::*)(const arma::mat&)>::value, void>::type
+LoadStateVisitor::LoadState(T* layer) const
+{
+  layer->LoadState(state);
+}
+
+template<typename T>
+inline typename std::enable_if<
+    !HasLoadStateCheck<T, void(T::*)(const arma::mat&)>::value, void>::type
+LoadStateVisitor::LoadState(T* /* layer */) const
+{
+  /* Nothing to do here. */
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,71 @@
+/**
+ * @file methods/ann/visitor/quantize_visitor.hpp
+ *
+ * This file provides an abstraction for the int8 quantization of the layers
+ * that QuantizedFFN can run with integer products.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_VISITOR_QUANTIZE_VISITOR_HPP
+#define MLPACK_METHODS_ANN_VISITOR_QUANTIZE_VISITOR_HPP
+
+#include <mlpack/methods/ann/layer/layer_types.hpp>
+#include <mlpack/methods/ann/quantized_layer.hpp>
+
+#include <boost/variant.hpp>
+
+namespace mlpack {
+namespace ann {
+
+/**
+ * QuantizeVisitor builds the int8 version of a Linear, Linear3D or
+ * Convolution layer, given the input of the layer on the calibration data.
+ * The visitor returns whether the layer was quantized; other layers are left
+ * alone.
+ */
+class QuantizeVisitor : public boost::static_visitor<bool>
+{
+ public:
+  //! Quantize a layer given its calibration input and the layer to fill.
+  QuantizeVisitor(const arma::mat& input, QuantizedLayer& quantizedLayer);
+
+  //! Quantize a Linear layer.
+  template<typename RegularizerType>
+  bool operator()(Linear<arma::mat, arma::mat, RegularizerType>* layer) const;
+
+  //! Quantize a Linear3D layer.
+  template<typename RegularizerType>
+  bool operator()(Linear3D<arma::mat, arma::mat, RegularizerType>* layer)
+      const;
+
+  //! Quantize a Convolution layer.
+  template<typename ForwardConvolutionRule,
+           typename BackwardConvolutionRule,
+           typename GradientConvolutionRule>
+  bool operator()(Convolution<ForwardConvolutionRule, BackwardConvolutionRule,
+      GradientConvolutionRule, arma::mat, arma::mat>* layer) const;
+
+  //! Any other layer isn't quantized.
+  template<typename LayerType>
+  bool operator()(LayerType* layer) const;
+
+  bool operator()(MoreTypes layer) const;
+
+ private:
+  //! The input of the layer on the calibration data.
+  const arma::mat& input;
+
+  //! The quantized layer to fill.
+  QuantizedLayer& quantizedLayer;
+};
+
+} // namespace ann
+} // namespace mlpack
+
+// Include implementation.
+#include "quantize_visitor_impl.hpp"
+
+#endif
@@ -0,0 +1,85 @@
+/**
+ * @file methods/ann/visitor/quantize_visitor_impl.hpp
+ *
+ * Implementation of the int8 quantization of the layers that QuantizedFFN can
+ * run with integer products.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_VISITOR_QUANTIZE_VISITOR_IMPL_HPP
+#define MLPACK_METHODS_ANN_VISITOR_QUANTIZE_VISITOR_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "quantize_visitor.hpp"
+
+namespace mlpack {
+namespace ann {
+
+//! QuantizeVisitor visitor class.
+inline QuantizeVisitor::QuantizeVisitor(const arma::mat& input,
+                                        QuantizedLayer& quantizedLayer) :
+    input(input),
+    quantizedLayer(quantizedLayer)
+{
+  /* Nothing to do here. */
+}
+
+template<typename RegularizerType>
+inline bool QuantizeVisitor::operator()(
+    Linear<arma::mat, arma::mat, RegularizerType>* layer) const
+{
+  quantizedLayer = QuantizedLayer(layer->Weight().t(),
+      arma::vec(layer->Bias().memptr(), layer->Bias().n_elem),
+      arma::abs(input).max());
+  return true;
+}
+
+template<typename RegularizerType>
+inline bool QuantizeVisitor::operator()(
+    Linear3D<arma::mat, arma::mat, RegularizerType>* layer) const
+{
+  quantizedLayer = QuantizedLayer(layer->Weight().t(),
+      arma::vec(layer->Bias().memptr(), layer->Bias().n_elem),
+      arma::abs(input).max());
+  return true;
+}
+
+template<typename ForwardConvolutionRule,
+         typename BackwardConvolutionRule,
+         typename GradientConvolutionRule>
+inline bool QuantizeVisitor::operator()(
+    Convolution<ForwardConvolutionRule, BackwardConvolutionRule,
+    GradientConvolutionRule, arma::mat, arma::mat>* layer) const
+{
+  // The filter of each output map is contiguous in the weights, ordered as the
+  // rows of Im2ColConvolution::Im2Col().
+  const arma::mat filters(layer->Weight().memptr(), layer->KernelWidth() *
+      layer->KernelHeight() * layer->InputSize(), layer->OutputSize());
+
+  quantizedLayer = QuantizedLayer(filters,
+      arma::vec(layer->Bias().memptr(), layer->Bias().n_elem),
+      arma::abs(input).max(), layer->InputWidth(), layer->InputHeight(),
+      layer->InputSize(), layer->KernelWidth(), layer->KernelHeight(),
+      layer->StrideWidth(), layer->StrideHeight(), layer->PadWLeft(),
+      layer->PadWRight(), layer->PadHTop(), layer->PadHBottom());
+  return true;
+}
+
+template<typename LayerType>
+inline bool QuantizeVisitor::operator()(LayerType* /* layer */) const
+{
+  return false;
+}
+
+inline bool QuantizeVisitor::operator()(MoreTypes layer) const
+{
+  return layer.apply_visitor(*this);
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
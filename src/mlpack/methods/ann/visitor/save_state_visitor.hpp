@@ -0,0 +1,62 @@
+/**
+ * @file methods/ann/visitor/save_state_visitor.hpp
+ *
+ * Boost static visitor abstraction for calling the SaveState() function of
+ * recurrent cells.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_VISITOR_SAVE_STATE_VISITOR_HPP
+#define MLPACK_METHODS_ANN_VISITOR_SAVE_STATE_VISITOR_HPP
+
+#include <mlpack/methods/ann/layer/layer_traits.hpp>
+#include <mlpack/methods/ann/layer/layer_types.hpp>
+
+#include <boost/variant.hpp>
+
+namespace mlpack {
+namespace ann {
+
+/**
+ * SaveStateVisitor executes the SaveState() function; layers that don't
+ * implement it have an empty state.
+ */
+class SaveStateVisitor : public boost::static_visitor<void>
+{
+ public:
+  //! Save the state of the layer into the given matrix.
+  SaveStateVisitor(arma::mat& state);
+
+  //! Execute the SaveState() function.
+  template<typename LayerType>
+  void operator()(LayerType* layer) const;
+
+  void operator()(MoreTypes layer) const;
+
+ private:
+  //! The state of the layer.
+  arma::mat& state;
+
+  //! Execute the SaveState() function for a module which implements it.
+  template<typename T>
+  typename std::enable_if<
+      HasSaveStateCheck<T, void(T::*)(arma::mat&) const>::value, void>::type
+  SaveState(T* layer) const;
+
+  //! Clear the state of a module which has no state.
+  template<typename T>
+  typename std::enable_if<
+      !HasSaveStateCheck<T, void(T::*)(arma::mat&) const>::value, void>::type
+  SaveState(T* layer) const;
+};
+
+} // namespace ann
+} // namespace mlpack
+
+// Include implementation.
+#include "save_state_visitor_impl.hpp"
+
+#endif
@@ -81,7 +81,8 @@ class DrusillaSelect
    * NeighborSearch and LSHSearch classes.  That is, each column in the
    * neighbors and distances matrices will refer to a single query point, and
    * the k'th row in that column will refer to the k'th candidate neighbor or
-   * distance for that query point.
+   * distance for that query point.  Blocks of query points are searched in
+   * parallel with OpenMP.
    *
    * @param querySet Set of query points to search.
    * @param k Number of furthest neighbors to search for.
@@ -34,6 +34,9 @@ template<typename MatType = arma::mat>
 class QDAFN
 {
  public:
+  //! The type of the elements of the data.
+  typedef typename MatType::elem_type ElemType;
+
   /**
    * Construct the QDAFN object but do not train it.  Be sure to call Train()
    * before calling Search().
@@ -73,6 +76,10 @@ class QDAFN
    * can contain just one point, that is okay.)  The results will be stored in
    * the given neighbors and distances matrices, in the same format as the
    * mlpack NeighborSearch and LSHSearch classes.
+   *
+   * The queries are projected onto the lines in batches, with one matrix
+   * multiplication per batch, and the queries of each batch are searched in
+   * parallel with OpenMP.
    */
   void Search(const MatType& querySet,
               const size_t k,
@@ -97,14 +104,14 @@ class QDAFN
   //! The number of elements to store for each projection.
   size_t m;
   //! The random lines we are projecting onto.  Has l columns.
-  arma::mat lines;
+  arma::Mat<ElemType> lines;
   //! Projections of each point onto each random line.
-  arma::mat projections;
+  arma::Mat<ElemType> projections;
 
   //! Indices of the points for each S.
   arma::Mat<size_t> sIndices;
   //! Values of a_i * x for each point in S.
-  arma::mat sValues;
+  arma::Mat<ElemType> sValues;
 
   // Candidate sets; one element in the vector for each table.
   std::vector<MatType> candidateSet;
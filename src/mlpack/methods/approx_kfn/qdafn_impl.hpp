@@ -64,7 +64,7 @@ void QDAFN<MatType>::Train(const MatType& referenceSet,
   mlpack::distribution::GaussianDistribution gd(referenceSet.n_rows);
   lines.set_size(referenceSet.n_rows, l);
   for (size_t i = 0; i < l; ++i)
-    lines.col(i) = gd.Random();
+    lines.col(i) = arma::conv_to<arma::Col<ElemType>>::from(gd.Random());
 
   // Now, project each of the reference points onto each line, and collect the
   // top m elements.
@@ -104,76 +104,90 @@ void QDAFN<MatType>::Search(const MatType& querySet,
   neighbors.fill(size_t() - 1);
   distances.zeros(k, querySet.n_cols);
 
-  // Search for each point.
-  for (size_t q = 0; q < querySet.n_cols; ++q)
+  // The queries are projected onto the lines one batch at a time, so that the
+  // projections of a very large query set are never all held in memory.
+  const size_t batchSize = 4096;
+  for (size_t begin = 0; begin < querySet.n_cols; begin += batchSize)
   {
-    // Initialize a priority queue.
-    // The size_t represents the index of the table, and the double represents
-    // the value of l_i * S_i - l_i * query (see line 6 of Algorithm 1).
-    std::priority_queue<std::pair<double, size_t>> queue;
-    for (size_t i = 0; i < l; ++i)
-    {
-      const double val = sValues(0, i) - arma::dot(querySet.col(q),
-          lines.col(i));
-      queue.push(std::make_pair(val, i));
-    }
-
-    // To track where we are in each S table, we keep the next index to look at
-    // in each table (they start at 0).
-    arma::Col<size_t> tableLocations = arma::zeros<arma::Col<size_t>>(l);
+    const size_t end = std::min(begin + batchSize, (size_t) querySet.n_cols);
+    const arma::Mat<ElemType> queryProjections = lines.t() *
+        querySet.cols(begin, end - 1);
 
-    // Now that the queue is initialized, iterate over m elements.
-    std::vector<std::pair<double, size_t>> v(k, std::make_pair(-1.0,
-        size_t(-1)));
-    std::priority_queue<std::pair<double, size_t>>
-        resultsQueue(std::less<std::pair<double, size_t>>(), std::move(v));
-    for (size_t i = 0; i < m; ++i)
+    // Search for each point of the batch.
+    #pragma omp parallel for schedule(dynamic, 16)
+    for (omp_size_t b = 0; b < (omp_size_t) (end - begin); ++b)
     {
-      std::pair<size_t, double> p = queue.top();
-      queue.pop();
-
-      // Get index of reference point to look at.
-      const size_t tableIndex = tableLocations[p.second];
-
-      // Calculate distance from query point.
-      const double dist = mlpack::metric::EuclideanDistance::Evaluate(
-          querySet.col(q), candidateSet[p.second].col(tableIndex));
-
-      resultsQueue.push(std::make_pair(dist, sIndices(tableIndex, p.second)));
+      const size_t q = begin + b;
 
-      // Now (line 14) get the next element and insert into the queue.  Do this
-      // by adjusting the previous value.  Don't insert anything if we are at
-      // the end of the search, though.
-      if (i < m - 1)
+      // Initialize a priority queue.
+      // The size_t represents the index of the table, and the double represents
+      // the value of l_i * S_i - l_i * query (see line 6 of Algorithm 1).
+      std::priority_queue<std::pair<double, size_t>> queue;
+      for (size_t i = 0; i < l; ++i)
       {
-        tableLocations[p.second]++;
-        const double val = p.first - sValues(tableIndex, p.second) +
-            sValues(tableIndex + 1, p.second);
-
-        queue.push(std::make_pair(val, p.second));
+        const double val = (double) sValues(0, i) -
+            (double) queryProjections(i, b);
+        queue.push(std::make_pair(val, i));
       }
-    }
 
-    // Extract the results and deduplicate them.
-    size_t extracted = 1;
-    neighbors(0, q) = resultsQueue.top().second;
-    distances(0, q) = resultsQueue.top().first;
-    resultsQueue.pop();
+      // To track where we are in each S table, we keep the next index to look
+      // at in each table (they start at 0).
+      arma::Col<size_t> tableLocations = arma::zeros<arma::Col<size_t>>(l);
 
-    while (!resultsQueue.empty())
-    {
-      if (extracted == k)
-        break;
+      // Now that the queue is initialized, iterate over m elements.
+      std::vector<std::pair<double, size_t>> v(k, std::make_pair(-1.0,
+          size_t(-1)));
+      std::priority_queue<std::pair<double, size_t>>
+          resultsQueue(std::less<std::pair<double, size_t>>(), std::move(v));
+      for (size_t i = 0; i < m; ++i)
+      {
+        std::pair<double, size_t> p = queue.top();
+        queue.pop();
+
+        // Get index of reference point to look at.
+        const size_t tableIndex = tableLocations[p.second];
+
+        // Calculate distance from query point.
+        const double dist = mlpack::metric::EuclideanDistance::Evaluate(
+            querySet.col(q), candidateSet[p.second].col(tableIndex));
+
+        resultsQueue.push(std::make_pair(dist,
+            sIndices(tableIndex, p.second)));
+
+        // Now (line 14) get the next element and insert into the queue.  Do
+        // this by adjusting the previous value.  Don't insert anything if we
+        // are at the end of the search, though.
+        if (i < m - 1)
+        {
+          tableLocations[p.second]++;
+          const double val = p.first - (double) sValues(tableIndex, p.second) +
+              (double) sValues(tableIndex + 1, p.second);
+
+          queue.push(std::make_pair(val, p.second));
+        }
+      }
 
-      std::pair<double, size_t> result = resultsQueue.top();
+      // Extract the results and deduplicate them.
+      size_t extracted = 1;
+      neighbors(0, q) = resultsQueue.top().second;
+      distances(0, q) = resultsQueue.top().first;
       resultsQueue.pop();
 
-      // Avoid inserting any duplicates.
-      if (neighbors(extracted - 1, q) != result.second)
+      while (!resultsQueue.empty())
       {
-        neighbors(extracted, q) = resultsQueue.top().second;
-        distances(extracted, q) = resultsQueue.top().first;
-        ++extracted;
+        if (extracted == k)
+          break;
+
+        std::pair<double, size_t> result = resultsQueue.top();
+        resultsQueue.pop();
+
+        // Avoid inserting any duplicates.
+        if (neighbors(extracted - 1, q) != result.second)
+        {
+          neighbors(extracted, q) = result.second;
+          distances(extracted, q) = result.first;
+          ++extracted;
+        }
       }
     }
   }
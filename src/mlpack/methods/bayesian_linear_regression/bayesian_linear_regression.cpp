@@ -27,7 +27,8 @@ BayesianLinearRegression::BayesianLinearRegression(const bool centerData,
   responsesOffset(0.0),
   alpha(0.0),
   beta(0.0),
-  gamma(0.0)
+  gamma(0.0),
+  numAccumulated(0)
 {/* Nothing to do */}
 
 double BayesianLinearRegression::Train(const arma::mat& data,
@@ -37,57 +38,114 @@ double BayesianLinearRegression::Train(const arma::mat& data,
 
   arma::mat phi;
   arma::rowvec t;
-  arma::colvec eigVal;
-  arma::mat eigVec;
 
   // Preprocess the data. Center and scale.
   responsesOffset = CenterScaleData(data, responses, phi, t);
 
-  if (!arma::eig_sym(eigVal, eigVec, arma::symmatu(phi * phi.t())))
+  Optimize(phi * phi.t(), phi * t.t(), data.n_cols, arma::var(t, 1),
+      [&phi, &t](const arma::colvec& omega)
+      {
+        const arma::rowvec temp = t - omega.t() * phi;
+        return dot(temp, temp);
+      });
+
+  Timer::Stop("bayesian_linear_regression");
+
+  return RMSE(data, responses);
+}
+
+void BayesianLinearRegression::Accumulate(const arma::mat& data,
+                                          const arma::rowvec& responses)
+{
+  MergeStatistics(data, responses, false);
+}
+
+void BayesianLinearRegression::Forget(const arma::mat& data,
+                                      const arma::rowvec& responses)
+{
+  MergeStatistics(data, responses, true);
+}
+
+void BayesianLinearRegression::Refit()
+{
+  if (numAccumulated < (scaleData ? 2 : 1))
   {
-    Log::Fatal << "BayesianLinearRegression::Train(): Eigendecomposition "
-               << "of covariance failed!" << std::endl;
+    throw std::invalid_argument("BayesianLinearRegression::Refit(): not "
+        "enough points have been accumulated");
   }
 
-  // Compute this quantities once and for all.
-  const arma::mat eigVecInv = inv(eigVec);
-  const arma::colvec eigVecInvPhitT = eigVecInv * phi * t.t();
+  Timer::Start("bayesian_linear_regression");
 
-  // Initialize the hyperparameters and begin with an infinitely broad prior.
-  alpha = 1e-6;
-  beta =  1 / (var(t, 1) * 0.1);
+  const size_t d = accumulatedMean.n_elem - 1;
+  const double n = (double) numAccumulated;
 
-  unsigned short i = 0;
-  double deltaAlpha = 1.0, deltaBeta = 1.0, crit = 1.0;
+  // The statistics of the processed points: the scatter matrix is that of
+  // the centered points, so it has to be uncentered if the data is not.
+  arma::mat scatter = accumulatedScatter;
+  if (centerData)
+  {
+    dataOffset = accumulatedMean.head(d);
+    responsesOffset = accumulatedMean[d];
+  }
+  else
+  {
+    scatter += n * accumulatedMean * accumulatedMean.t();
+    responsesOffset = 0.0;
+  }
 
-  while ((crit > tol) && (i < nIterMax))
+  if (scaleData)
   {
-    deltaAlpha = -alpha;
-    deltaBeta = -beta;
+    const arma::colvec sumSquares = accumulatedScatter.diag();
+    dataScale = sqrt(sumSquares.head(d) / (n - 1));
+    scatter.head_rows(d).each_col() /= dataScale;
+    scatter.head_cols(d).each_row() /= dataScale.t();
+  }
 
-    // Update the solution.
-    omega = eigVec * diagmat(1 / (eigVal + (alpha / beta))) * eigVecInvPhitT;
+  const arma::mat gram = scatter.submat(0, 0, d - 1, d - 1);
+  const arma::colvec phiT = scatter.submat(0, d, d - 1, d);
+  const double tT = scatter(d, d);
 
-    // Update alpha.
-    gamma = sum(eigVal / (alpha / beta + eigVal));
-    alpha = gamma / dot(omega, omega);
+  // The residual is expanded over the statistics; it cannot be negative, but
+  // rounding could make it so for a perfect fit.
+  Optimize(gram, phiT, numAccumulated, accumulatedScatter(d, d) / n,
+      [&gram, &phiT, tT](const arma::colvec& omega)
+      {
+        return std::max(tT - 2 * dot(omega, phiT) +
+            arma::as_scalar(omega.t() * gram * omega), DBL_MIN);
+      });
 
-    // Update beta.
-    const arma::rowvec temp = t - omega.t() * phi;
-    beta = (data.n_cols - gamma) / dot(temp, temp);
+  Timer::Stop("bayesian_linear_regression");
+}
 
-    // Compute the stopping criterion.
-    deltaAlpha += alpha;
-    deltaBeta += beta;
-    crit = std::abs(deltaAlpha / alpha + deltaBeta / beta);
-    i++;
+void BayesianLinearRegression::Update(const arma::colvec& point,
+                                      const double response)
+{
+  if (omega.is_empty())
+  {
+    throw std::invalid_argument("BayesianLinearRegression::Update(): the "
+        "model must be trained before it can be updated");
   }
-  // Compute the covariance matrix for the uncertainties later.
-  matCovariance = eigVec * diagmat(1 / (beta * eigVal + alpha)) * eigVecInv;
 
-  Timer::Stop("bayesian_linear_regression");
+  if (point.n_elem != omega.n_elem)
+  {
+    std::ostringstream oss;
+    oss << "BayesianLinearRegression::Update(): the point has dimensionality "
+        << point.n_elem << ", but the model has dimensionality "
+        << omega.n_elem;
+    throw std::invalid_argument(oss.str());
+  }
 
-  return RMSE(data, responses);
+  arma::mat x;
+  CenterScaleDataPred(point, x);
+
+  // With S the covariance of the solution, the new covariance is
+  // (S^-1 + beta x x^T)^-1, which the Sherman-Morrison formula gives as a
+  // rank-one update of S.
+  const arma::colvec sx = matCovariance * x;
+  const double denominator = 1.0 / beta + arma::as_scalar(x.t() * sx);
+  omega += sx * ((response - responsesOffset - arma::as_scalar(x.t() * omega))
+      / denominator);
+  matCovariance -= sx * sx.t() / denominator;
 }
 
 void BayesianLinearRegression::Predict(const arma::mat& points,
@@ -161,6 +219,136 @@ double BayesianLinearRegression::CenterScaleData(const arma::mat& data,
   return responsesOffset;
 }
 
+void BayesianLinearRegression::Optimize(
+    const arma::mat& gram,
+    const arma::colvec& phiT,
+    const size_t numPoints,
+    const double responsesVariance,
+    const std::function<double(const arma::colvec&)>& residual)
+{
+  arma::colvec eigVal;
+  arma::mat eigVec;
+  if (!arma::eig_sym(eigVal, eigVec, arma::symmatu(gram)))
+  {
+    Log::Fatal << "BayesianLinearRegression: Eigendecomposition of "
+               << "covariance failed!" << std::endl;
+  }
+
+  // Compute this quantities once and for all.
+  const arma::mat eigVecInv = inv(eigVec);
+  const arma::colvec eigVecInvPhitT = eigVecInv * phiT;
+
+  // Initialize the hyperparameters and begin with an infinitely broad prior.
+  alpha = 1e-6;
+  beta =  1 / (responsesVariance * 0.1);
+
+  unsigned short i = 0;
+  double deltaAlpha = 1.0, deltaBeta = 1.0, crit = 1.0;
+
+  while ((crit > tol) && (i < nIterMax))
+  {
+    deltaAlpha = -alpha;
+    deltaBeta = -beta;
+
+    // Update the solution.
+    omega = eigVec * diagmat(1 / (eigVal + (alpha / beta))) * eigVecInvPhitT;
+
+    // Update alpha.
+    gamma = sum(eigVal / (alpha / beta + eigVal));
+    alpha = gamma / dot(omega, omega);
+
+    // Update beta.
+    beta = (numPoints - gamma) / residual(omega);
+
+    // Compute the stopping criterion.
+    deltaAlpha += alpha;
+    deltaBeta += beta;
+    crit = std::abs(deltaAlpha / alpha + deltaBeta / beta);
+    i++;
+  }
+  // Compute the covariance matrix for the uncertainties later.
+  matCovariance = eigVec * diagmat(1 / (beta * eigVal + alpha)) * eigVecInv;
+}
+
+void BayesianLinearRegression::MergeStatistics(const arma::mat& data,
+                                               const arma::rowvec& responses,
+                                               const bool remove)
+{
+  if (data.n_cols != responses.n_elem)
+  {
+    std::ostringstream oss;
+    oss << "BayesianLinearRegression: the number of points (" << data.n_cols
+        << ") does not match the number of responses (" << responses.n_elem
+        << ")";
+    throw std::invalid_argument(oss.str());
+  }
+
+  if (numAccumulated > 0 && data.n_rows + 1 != accumulatedMean.n_elem)
+  {
+    std::ostringstream oss;
+    oss << "BayesianLinearRegression: the points have dimensionality "
+        << data.n_rows << ", but the accumulated points have dimensionality "
+        << accumulatedMean.n_elem - 1;
+    throw std::invalid_argument(oss.str());
+  }
+
+  if (remove && data.n_cols > numAccumulated)
+  {
+    throw std::invalid_argument("BayesianLinearRegression::Forget(): more "
+        "points would be removed than were accumulated");
+  }
+
+  if (data.n_cols == 0)
+    return;
+
+  // The statistics of the block, with the responses as the last dimension.
+  const arma::mat block = arma::join_cols(data, responses);
+  const arma::colvec blockMean = arma::mean(block, 1);
+  const arma::mat centered = block.each_col() - blockMean;
+  const arma::mat blockScatter = centered * centered.t();
+  const double nBlock = (double) block.n_cols;
+
+  if (!remove && numAccumulated == 0)
+  {
+    numAccumulated = block.n_cols;
+    accumulatedMean = blockMean;
+    accumulatedScatter = blockScatter;
+    return;
+  }
+
+  if (remove && numAccumulated == block.n_cols)
+  {
+    numAccumulated = 0;
+    accumulatedMean.clear();
+    accumulatedScatter.clear();
+    return;
+  }
+
+  // Combine the statistics of two sets of points (Chan et al.), or remove one
+  // set from their combination.
+  const double n = (double) numAccumulated;
+  if (!remove)
+  {
+    const arma::colvec delta = blockMean - accumulatedMean;
+    const double total = n + nBlock;
+    accumulatedMean += delta * (nBlock / total);
+    accumulatedScatter += blockScatter + delta * delta.t() * (n * nBlock /
+        total);
+    numAccumulated += block.n_cols;
+  }
+  else
+  {
+    const double rest = n - nBlock;
+    const arma::colvec restMean = (n * accumulatedMean - nBlock * blockMean) /
+        rest;
+    const arma::colvec delta = blockMean - restMean;
+    accumulatedScatter -= blockScatter + delta * delta.t() * (rest * nBlock /
+        n);
+    accumulatedMean = restMean;
+    numAccumulated -= block.n_cols;
+  }
+}
+
 void BayesianLinearRegression::CenterScaleDataPred(
     const arma::mat& data,
     arma::mat& dataProc) const
@@ -17,6 +17,8 @@
 
 #include <mlpack/prereqs.hpp>
 
+#include <functional>
+
 namespace mlpack {
 namespace regression {
 
@@ -127,6 +129,50 @@ class BayesianLinearRegression
   double Train(const arma::mat& data,
                const arma::rowvec& responses);
 
+  /**
+   * Add the given points to the statistics of the points accumulated so far
+   * (their number, mean and scatter matrix, responses included), without
+   * changing the model; Refit() then trains the model on all the accumulated
+   * points.  This allows training in blocks, on more points than fit in
+   * memory, or on a sliding window of a stream (together with Forget()).  The
+   * points given to Train() are not accumulated.
+   *
+   * @param data Column-major input data, dim(P, N).
+   * @param responses A vector of targets, dim(N).
+   */
+  void Accumulate(const arma::mat& data, const arma::rowvec& responses);
+
+  /**
+   * Remove the given points, which must have been accumulated before, from the
+   * accumulated statistics; for instance, the oldest block of a sliding window.
+   *
+   * @param data Column-major input data, dim(P, N).
+   * @param responses A vector of targets, dim(N).
+   */
+  void Forget(const arma::mat& data, const arma::rowvec& responses);
+
+  /**
+   * Train the model on the accumulated points.  This is equivalent to Train()
+   * on all of these points, but only works on the P x P statistics, so it does
+   * not depend on the number of points.
+   */
+  void Refit();
+
+  /**
+   * Update the posterior of the solution with one new observation, keeping
+   * alpha, beta and the centering and scaling of the data; this is a rank-one
+   * update that takes O(P^2) time.  The observation is not accumulated; call
+   * Accumulate() too if a later Refit() should use it.  The model must have
+   * been trained before.
+   *
+   * @param point New observation, dim(P).
+   * @param response Target of the observation.
+   */
+  void Update(const arma::colvec& point, const double response);
+
+  //! Get the number of accumulated points.
+  size_t NumAccumulated() const { return numAccumulated; }
+
   /**
    * Predict \f$y_{i}\f$ for each data point in the given data matrix using the
    * currently-trained Bayesian Ridge model.
@@ -257,6 +303,46 @@ class BayesianLinearRegression
   //! Covariance matrix of the solution vector omega.
   arma::mat matCovariance;
 
+  //! Number of accumulated points.
+  size_t numAccumulated;
+
+  //! Mean of the accumulated points, with the mean response as last element.
+  arma::colvec accumulatedMean;
+
+  //! Sum of the outer products of the centered accumulated points (with their
+  //! centered responses as last element).
+  arma::mat accumulatedScatter;
+
+  /**
+   * Find the alpha and beta that maximize the evidence, and the solution and
+   * its covariance with them.
+   *
+   * @param gram Product of the processed design matrix with its transpose.
+   * @param phiT Product of the processed design matrix with the processed
+   *    responses.
+   * @param numPoints Number of training points.
+   * @param responsesVariance Variance of the responses.
+   * @param residual Function that returns the squared norm of the residual of
+   *    the given solution on the training points.
+   */
+  void Optimize(const arma::mat& gram,
+                const arma::colvec& phiT,
+                const size_t numPoints,
+                const double responsesVariance,
+                const std::function<double(const arma::colvec&)>& residual);
+
+  /**
+   * Add the statistics of the given points to the accumulated statistics, or
+   * remove them.
+   *
+   * @param data Column-major input data, dim(P, N).
+   * @param responses A vector of targets, dim(N).
+   * @param remove Whether to remove the points instead of adding them.
+   */
+  void MergeStatistics(const arma::mat& data,
+                       const arma::rowvec& responses,
+                       const bool remove);
+
   /**
    * Center and scale the data accordind to centerData and scaleData.
    * Allows future modifications of new points.
@@ -284,6 +370,9 @@ class BayesianLinearRegression
 } // namespace regression
 } // namespace mlpack
 
+//! Set the serialization version of the BayesianLinearRegression class.
+BOOST_CLASS_VERSION(mlpack::regression::BayesianLinearRegression, 1);
+
 // Include implementation of serialize.
 #include "bayesian_linear_regression_impl.hpp"
 
@@ -22,7 +22,7 @@ namespace regression {
  */
 template<typename Archive>
 void BayesianLinearRegression::serialize(Archive& ar,
-                                         const unsigned int /* version */)
+                                         const unsigned int version)
 {
   ar & BOOST_SERIALIZATION_NVP(centerData);
   ar & BOOST_SERIALIZATION_NVP(scaleData);
@@ -36,6 +36,20 @@ void BayesianLinearRegression::serialize(Archive& ar,
   ar & BOOST_SERIALIZATION_NVP(gamma);
   ar & BOOST_SERIALIZATION_NVP(omega);
   ar & BOOST_SERIALIZATION_NVP(matCovariance);
+
+  // Older versions did not accumulate statistics.
+  if (version > 0)
+  {
+    ar & BOOST_SERIALIZATION_NVP(numAccumulated);
+    ar & BOOST_SERIALIZATION_NVP(accumulatedMean);
+    ar & BOOST_SERIALIZATION_NVP(accumulatedScatter);
+  }
+  else if (Archive::is_loading::value)
+  {
+    numAccumulated = 0;
+    accumulatedMean.clear();
+    accumulatedScatter.clear();
+  }
 }
 
 } // namespace regression
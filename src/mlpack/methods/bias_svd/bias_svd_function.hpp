@@ -149,7 +149,9 @@ namespace ens {
    * Template specialization for the SGD and parallel SGD optimizer. Used
    * because the gradient affects only a small number of parameters per example,
    * and thus the normal abstraction does not work as fast as we might like it
-   * to.
+   * to.  The parallel SGD visits the ratings in blocks that share no user and
+   * no item (see amf::SGDSchedule), so it needs no atomic updates; the thread
+   * share size of the optimizer is not used.
    */
   template <>
   template <>
@@ -14,6 +14,7 @@
 #define MLPACK_METHODS_BLOCK_KRYLOV_SVD_RANDOMIZED_BLOCK_KRYLOV_SVD_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/math/lin_alg.hpp>
 
 namespace mlpack {
 namespace svd {
@@ -54,6 +55,9 @@ namespace svd {
  * // Use the Apply() method to get a factorization.
  * bSVD.Apply(data, u, s, v, rank);
  * @endcode
+ *
+ * Sparse matrices are factorized without being densified, and their products
+ * with the blocks of the Krylov subspace are computed in parallel with OpenMP.
  */
 class RandomizedBlockKrylovSVD
 {
@@ -104,6 +108,44 @@ class RandomizedBlockKrylovSVD
              arma::mat& v,
              const size_t rank);
 
+  /**
+   * Apply the randomized block krylov SVD to the provided sparse data set,
+   * without densifying it.
+   *
+   * @param data Sparse data matrix.
+   * @param u First unitary matrix.
+   * @param v Second unitary matrix.
+   * @param s Diagonal matrix of singular values.
+   * @param rank Rank of the approximation.
+   */
+  void Apply(const arma::sp_mat& data,
+             arma::mat& u,
+             arma::vec& s,
+             arma::mat& v,
+             const size_t rank);
+
+  /**
+   * Apply the randomized block krylov SVD to the provided data set with the
+   * given mean subtracted from each column.  The centered matrix is never
+   * formed: the mean is subtracted from the products with the blocks, so
+   * sparse data stays sparse.  If the mean is empty, the data is not
+   * centered.
+   *
+   * @param data Data matrix.
+   * @param u First unitary matrix.
+   * @param v Second unitary matrix.
+   * @param s Diagonal matrix of singular values.
+   * @param rank Rank of the approximation.
+   * @param rowMean Mean of the columns of the data (or an empty vector).
+   */
+  template<typename MatType>
+  void Apply(const MatType& data,
+             arma::mat& u,
+             arma::vec& s,
+             arma::mat& v,
+             const size_t rank,
+             const arma::vec& rowMean);
+
   //! Get the number of iterations for the power method.
   size_t MaxIterations() const { return maxIterations; }
   //! Modify the number of iterations for the power method.
@@ -115,6 +157,38 @@ class RandomizedBlockKrylovSVD
   size_t& BlockSize() { return blockSize; }
 
  private:
+  //! Compute data * x.
+  static void Times(const arma::mat& data,
+                    const arma::mat& x,
+                    arma::mat& result)
+  {
+    result = data * x;
+  }
+
+  //! Compute data * x in parallel, without densifying data.
+  static void Times(const arma::sp_mat& data,
+                    const arma::mat& x,
+                    arma::mat& result)
+  {
+    math::SparseTimes(data, x, result);
+  }
+
+  //! Compute data^T * x.
+  static void TransTimes(const arma::mat& data,
+                         const arma::mat& x,
+                         arma::mat& result)
+  {
+    result = data.t() * x;
+  }
+
+  //! Compute data^T * x in parallel, without densifying data.
+  static void TransTimes(const arma::sp_mat& data,
+                         const arma::mat& x,
+                         arma::mat& result)
+  {
+    math::SparseTransTimes(data, x, result);
+  }
+
   //! Locally stored number of iterations for the power method.
   size_t maxIterations;
 
@@ -125,4 +199,7 @@ class RandomizedBlockKrylovSVD
 } // namespace svd
 } // namespace mlpack
 
+// Include implementation.
+#include "randomized_block_krylov_svd_impl.hpp"
+
 #endif
@@ -0,0 +1,94 @@
+/**
+ * @file methods/block_krylov_svd/randomized_block_krylov_svd_impl.hpp
+ *
+ * Implementation of the randomized block krylov SVD method for dense and
+ * sparse, implicitly centered matrices.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_BLOCK_KRYLOV_SVD_RANDOMIZED_BLOCK_KRYLOV_SVD_IMPL_HPP
+#define MLPACK_METHODS_BLOCK_KRYLOV_SVD_RANDOMIZED_BLOCK_KRYLOV_SVD_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "randomized_block_krylov_svd.hpp"
+
+namespace mlpack {
+namespace svd {
+
+template<typename MatType>
+void RandomizedBlockKrylovSVD::Apply(const MatType& data,
+                                     arma::mat& u,
+                                     arma::vec& s,
+                                     arma::mat& v,
+                                     const size_t rank,
+                                     const arma::vec& rowMean)
+{
+  arma::mat Q, R, block, blockIteration, product, transProduct;
+  const bool center = !rowMean.is_empty();
+
+  if (blockSize == 0)
+  {
+    blockSize = rank + 10;
+  }
+
+  // Random block initialization.
+  arma::mat G = arma::randn(data.n_cols, blockSize);
+
+  // Construct and orthonormalize Krylov subspace.
+  arma::mat K(data.n_rows, blockSize * (maxIterations + 1));
+
+  // Create a working matrix using data from writable auxiliary memory
+  // (K matrix). Doing so avoids an uncessary copy in upcoming step.
+  block = arma::mat(K.memptr(), data.n_rows, blockSize, false, false);
+
+  // (X - mu 1^T) G = X G - mu (1^T G).
+  Times(data, G, product);
+  if (center)
+    product -= rowMean * arma::sum(G, 0);
+  arma::qr_econ(block, R, product);
+
+  for (size_t blockOffset = block.n_elem; blockOffset < K.n_elem;
+      blockOffset += block.n_elem)
+  {
+    // Temporary working matrix to store the result in the correct place.
+    blockIteration = arma::mat(K.memptr() + blockOffset, block.n_rows,
+        block.n_cols, false, false);
+
+    // (X - mu 1^T)^T B = X^T B - 1 (mu^T B).
+    TransTimes(data, block, transProduct);
+    if (center)
+      transProduct.each_row() -= rowMean.t() * block;
+
+    Times(data, transProduct, product);
+    if (center)
+      product -= rowMean * arma::sum(transProduct, 0);
+    arma::qr_econ(blockIteration, R, product);
+
+    // Update working matrix for the next iteration.
+    block = arma::mat(K.memptr() + blockOffset, block.n_rows, block.n_cols,
+        false, false);
+  }
+
+  arma::qr_econ(Q, R, K);
+
+  // Approximate eigenvalues and eigenvectors using Rayleigh–Ritz method; the
+  // projection Q^T (X - mu 1^T) is computed as the transpose of a product with
+  // X^T.
+  TransTimes(data, Q, transProduct);
+  if (center)
+    transProduct.each_row() -= rowMean.t() * Q;
+  arma::svd_econ(u, s, v, arma::mat(transProduct.t()));
+
+  // Do economical singular value decomposition and compute only the
+  // approximations of the left singular vectors by using the centered data
+  // applied to Q.
+  u = Q * u;
+}
+
+} // namespace svd
+} // namespace mlpack
+
+#endif
@@ -23,6 +23,9 @@
 #include <mlpack/methods/amf/termination_policies/simple_residue_termination.hpp>
 #include <mlpack/methods/cf/normalization/no_normalization.hpp>
 #include <mlpack/methods/cf/decomposition_policies/nmf_method.hpp>
+#include <mlpack/methods/cf/decomposition_policies/decomposition_traits.hpp>
+#include <mlpack/methods/fastmks/fastmks.hpp>
+#include <mlpack/core/kernels/linear_kernel.hpp>
 #include <mlpack/methods/cf/neighbor_search_policies/lmetric_search.hpp>
 #include <mlpack/methods/cf/interpolation_policies/average_interpolation.hpp>
 #include <set>
@@ -216,6 +219,81 @@ class CFType
                           arma::Mat<size_t>& recommendations,
                           const arma::Col<size_t>& users);
 
+  /**
+   * Generates the given number of recommendations for all users, with a
+   * maximum inner product search over the item factors instead of a scan of
+   * the full rating vector of each user.  See the other overload.
+   *
+   * @param numRecs Number of Recommendations.
+   * @param recommendations Matrix to save recommendations into.
+   */
+  template<typename NeighborSearchPolicy = EuclideanSearch,
+           typename InterpolationPolicy = AverageInterpolation>
+  void GetMIPSRecommendations(const size_t numRecs,
+                              arma::Mat<size_t>& recommendations);
+
+  /**
+   * Generates the given number of recommendations for the specified users, with
+   * a maximum inner product search over the item factors.  The interpolated
+   * ratings of a user are W * q, where q is the weighted sum of the factors of
+   * its neighborhood, so its best items are the items whose factors have the
+   * largest inner products with q.  They are found with FastMKS and the linear
+   * kernel on a tree built once over all the items, instead of computing the
+   * ratings of every item for every user.  The items the user has already
+   * rated, and those marked in the optional exclusion mask, are skipped.
+   *
+   * The results are the same as those of GetRecommendations(), up to ties.
+   * This needs a decomposition whose ratings are W() * H().col(user) (see
+   * DecompositionTraits), and a normalization whose Denormalize() is affine in
+   * the rating, with a positive per-user scale and a per-item offset, as all
+   * the normalizations in mlpack are; the offset becomes an extra dimension of
+   * the item factors.
+   *
+   * @tparam NeighborSearchPolicy The policy used to search neighbors of
+   *     query set in referece set.
+   * @tparam InterpolationPolicy The policy used to calculate interpolation
+   *     weights.
+   *
+   * @param numRecs Number of Recommendations.
+   * @param recommendations Matrix to save recommendations.
+   * @param users Users for which recommendations are to be generated.
+   * @param exclude Optional (item, user) matrix; the items whose entry is
+   *     nonzero are not recommended to the user.
+   */
+  template<typename NeighborSearchPolicy = EuclideanSearch,
+           typename InterpolationPolicy = AverageInterpolation>
+  void GetMIPSRecommendations(const size_t numRecs,
+                              arma::Mat<size_t>& recommendations,
+                              const arma::Col<size_t>& users,
+                              const arma::sp_mat& exclude = arma::sp_mat());
+
+  /**
+   * Add new users and new items to the trained model without retraining it.
+   * The given ratings are a (user, item, rating) coordinate list, in which
+   * each rating involves a user or an item beyond those of the model.  The
+   * factors of each new item are the solution of a regularized least squares
+   * problem against the fixed factors of the users who rated it:
+   *
+   * \f[
+   * \min_w \sum_{u \in R(i)} (r_{iu} - w^T h_u)^2 + \lambda \|w\|^2
+   * \f]
+   *
+   * and the factors of each new user are found in the same way against the
+   * factors of the items it rated, including the new ones.  The ratings are
+   * normalized with the statistics of the model, and the statistics of the new
+   * users and items (like their mean) are computed from their ratings.  The
+   * factors of the existing users and items are not changed.  The new ratings
+   * are stored with the others, so the new users can be queried like the
+   * others, and are serialized with the model.
+   *
+   * This needs a decomposition whose ratings are W() * H().col(user) (see
+   * DecompositionTraits).
+   *
+   * @param data New ratings, in the form of a (user, item, rating) table.
+   * @param lambda Regularization constant of the least squares problems.
+   */
+  void FoldIn(const arma::mat& data, const double lambda = 0.01);
+
   //! Converts the User, Item, Value Matrix to User-Item Table.
   static void CleanData(const arma::mat& data, arma::sp_mat& cleanedData);
 
@@ -277,6 +355,17 @@ class CFType
   //! Candidate represents a possible recommendation (value, item).
   typedef std::pair<double, size_t> Candidate;
 
+  /**
+   * Solve the regularized least squares problem of one new factor, from the
+   * given column of ratings and the fixed factors; only the ratings of the
+   * first numFixed factors are used.
+   */
+  static arma::vec FoldInFactor(const arma::sp_mat& ratings,
+                                const size_t column,
+                                const arma::mat& fixed,
+                                const size_t numFixed,
+                                const double lambda);
+
   //! Compare two candidates based on the value.
   struct CandidateCmp {
     bool operator()(const Candidate& c1, const Candidate& c2)
@@ -205,27 +205,26 @@ GetRecommendations(const size_t numRecs,
   recommendations.fill(SIZE_MAX);
   values.fill(DBL_MAX);
 
-  // Initialization of an InterpolationPolicy object should be put ahead of the
-  // following loop, because the initialization may takes a relatively long
-  // time and we don't want to repeat the initialization process in each loop.
+  // Calculate the interpolation weights of all the users at once, so that the
+  // policy can share its work between users.
   InterpolationPolicy interpolation(cleanedData);
+  arma::mat weights;
+  interpolation.GetWeights(weights, decomposition, users, neighborhood,
+      similarities, cleanedData);
 
-  for (size_t i = 0; i < users.n_elem; ++i)
+  // The users are independent, so they are handled in parallel.
+  #pragma omp parallel for schedule(dynamic, 16)
+  for (omp_size_t i = 0; i < (omp_size_t) users.n_elem; ++i)
   {
     // First, calculate the weighted sum of neighborhood values.
     arma::vec ratings;
     ratings.zeros(cleanedData.n_rows);
 
-    // Calculate interpolation weights.
-    arma::vec weights(numUsersForSimilarity);
-    interpolation.GetWeights(weights, decomposition, users(i),
-        neighborhood.col(i), similarities.col(i), cleanedData);
-
+    arma::vec neighborRatings;
     for (size_t j = 0; j < neighborhood.n_rows; ++j)
     {
-      arma::vec neighborRatings;
       decomposition.GetRatingOfUser(neighborhood(j, i), neighborRatings);
-      ratings += weights(j) * neighborRatings;
+      ratings += weights(j, i) * neighborRatings;
     }
 
     // Let's build the list of candidate recomendations for the given user.
@@ -267,9 +266,151 @@ GetRecommendations(const size_t numRecs,
     // If we were not able to come up with enough recommendations, issue a
     // warning.
     if (recommendations(numRecs - 1, i) == def.second)
+    {
+      #pragma omp critical
       Log::Warn << "Could not provide " << numRecs << " recommendations "
           << "for user " << users(i) << " (not enough un-rated items)!"
           << std::endl;
+    }
+  }
+}
+
+template<typename DecompositionPolicy,
+         typename NormalizationType>
+template<typename NeighborSearchPolicy,
+         typename InterpolationPolicy>
+void CFType<DecompositionPolicy,
+            NormalizationType>::
+GetMIPSRecommendations(const size_t numRecs,
+                       arma::Mat<size_t>& recommendations)
+{
+  // Generate list of users.
+  arma::Col<size_t> users = arma::linspace<arma::Col<size_t> >(0,
+      cleanedData.n_cols - 1, cleanedData.n_cols);
+
+  // Call the main overload for recommendations.
+  GetMIPSRecommendations<NeighborSearchPolicy,
+                         InterpolationPolicy>(numRecs, recommendations, users);
+}
+
+template<typename DecompositionPolicy,
+         typename NormalizationType>
+template<typename NeighborSearchPolicy,
+         typename InterpolationPolicy>
+void CFType<DecompositionPolicy,
+            NormalizationType>::
+GetMIPSRecommendations(const size_t numRecs,
+                       arma::Mat<size_t>& recommendations,
+                       const arma::Col<size_t>& users,
+                       const arma::sp_mat& exclude)
+{
+  static_assert(DecompositionTraits<DecompositionPolicy>::LinearRatings,
+      "GetMIPSRecommendations() needs a decomposition whose ratings are "
+      "W() * H().col(user); use GetRecommendations() instead.");
+
+  if (!exclude.is_empty() && (exclude.n_rows != cleanedData.n_rows ||
+      exclude.n_cols != cleanedData.n_cols))
+  {
+    throw std::invalid_argument("CFType::GetMIPSRecommendations(): the "
+        "exclusion mask must have one row per item and one column per user!");
+  }
+
+  const arma::mat& w = decomposition.W();
+  const arma::mat& h = decomposition.H();
+  const size_t numItems = cleanedData.n_rows;
+  const size_t rank = w.n_cols;
+
+  // Calculate the neighborhood of the queried users, as GetRecommendations()
+  // does.
+  arma::Mat<size_t> neighborhood;
+  arma::mat similarities;
+  decomposition.template GetNeighborhood<NeighborSearchPolicy>(
+      users, numUsersForSimilarity, neighborhood, similarities);
+
+  // The weighted sum of the factors of the neighborhood of each user, so that
+  // the normalized ratings of user i are w * factors.col(i).
+  InterpolationPolicy interpolation(cleanedData);
+  arma::mat weights;
+  interpolation.GetWeights(weights, decomposition, users, neighborhood,
+      similarities, cleanedData);
+
+  arma::mat factors(rank, users.n_elem);
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) users.n_elem; ++i)
+    factors.col(i) = h.cols(neighborhood.col(i)) * weights.col(i);
+
+  // Denormalize(user, item, r) is a(user) * r + b(item) + c(user), so the
+  // order of the items for a user is the order of the inner products of
+  // [w.row(item), b(item)] with [a(user) * factors.col(user), 1].  c(user) does
+  // not change the order.
+  arma::mat items(rank + 1, numItems);
+  items.rows(0, rank - 1) = w.t();
+  const double offset = normalization.Denormalize(0, 0, 0.0);
+  for (size_t j = 0; j < numItems; ++j)
+    items(rank, j) = normalization.Denormalize(0, j, 0.0) - offset;
+
+  arma::mat queries(rank + 1, users.n_elem);
+  size_t maxSkipped = 0;
+  for (size_t i = 0; i < users.n_elem; ++i)
+  {
+    const double scale = normalization.Denormalize(users(i), 0, 1.0) -
+        normalization.Denormalize(users(i), 0, 0.0);
+    queries.submat(0, i, rank - 1, i) = scale * factors.col(i);
+    queries(rank, i) = 1.0;
+
+    // The items that can't be recommended to the user are among the best
+    // ones at worst, so searching for this many more is enough.
+    size_t skipped = cleanedData.col(users(i)).n_nonzero;
+    if (!exclude.is_empty())
+      skipped += exclude.col(users(i)).n_nonzero;
+    maxSkipped = std::max(maxSkipped, skipped);
+  }
+
+  // Build the tree on the items once, and search it for all the users.
+  const size_t k = std::min(numItems, numRecs + maxSkipped);
+  fastmks::FastMKS<kernel::LinearKernel> mips(std::move(items));
+  arma::Mat<size_t> indices;
+  arma::mat products;
+  mips.Search(queries, k, indices, products);
+
+  recommendations.set_size(numRecs, users.n_elem);
+  recommendations.fill(numItems);
+  #pragma omp parallel for schedule(dynamic, 16)
+  for (omp_size_t i = 0; i < (omp_size_t) users.n_elem; ++i)
+  {
+    std::vector<Candidate> candidates;
+    candidates.reserve(numRecs);
+    for (size_t p = 0; p < k && candidates.size() < numRecs; ++p)
+    {
+      const size_t j = indices(p, i);
+      if (cleanedData(j, users(i)) != 0.0)
+        continue; // The user already rated the item.
+      if (!exclude.is_empty() && exclude(j, users(i)) != 0.0)
+        continue; // The item is excluded for the user.
+
+      // Compute the rating exactly as GetRecommendations() does.
+      const double realRating = normalization.Denormalize(users(i), j,
+          arma::dot(w.row(j), factors.col(i)));
+      candidates.push_back(std::make_pair(realRating, j));
+    }
+
+    std::sort(candidates.begin(), candidates.end(),
+        [](const Candidate& a, const Candidate& b)
+        {
+          return a.first > b.first;
+        });
+    for (size_t p = 0; p < candidates.size(); ++p)
+      recommendations(p, i) = candidates[p].second;
+
+    // If we were not able to come up with enough recommendations, issue a
+    // warning.
+    if (candidates.size() < numRecs)
+    {
+      #pragma omp critical
+      Log::Warn << "Could not provide " << numRecs << " recommendations "
+          << "for user " << users(i) << " (not enough un-rated items)!"
+          << std::endl;
+    }
   }
 }
 
@@ -351,43 +492,165 @@ Predict(const arma::Mat<size_t>& combinations,
   decomposition.template GetNeighborhood<NeighborSearchPolicy>(
       users, numUsersForSimilarity, neighborhood, similarities);
 
-  arma::mat weights(numUsersForSimilarity, users.n_elem);
-
   // Calculate interpolation weights.
+  arma::mat weights;
   InterpolationPolicy interpolation(cleanedData);
-  for (size_t i = 0; i < users.n_elem; ++i)
-  {
-    interpolation.GetWeights(weights.col(i), decomposition, users[i],
-        neighborhood.col(i), similarities.col(i), cleanedData);
-  }
+  interpolation.GetWeights(weights, decomposition, users, neighborhood,
+      similarities, cleanedData);
 
   // Now that we have the neighborhoods we need, calculate the predictions.
-  predictions.set_size(combinations.n_cols);
-
+  // The combinations of each user are contiguous once sorted; find where the
+  // combinations of each user start.
+  std::vector<size_t> starts(users.n_elem + 1, sortedCombinations.n_cols);
   size_t user = 0; // Cumulative user count, because we are doing it in order.
   for (size_t i = 0; i < sortedCombinations.n_cols; ++i)
   {
-    // Could this be made faster by calculating dot products for multiple items
-    // at once?
-    double rating = 0.0;
-
     // Map the combination's user to the user ID used for kNN.
     while (users[user] < sortedCombinations(0, i))
-      ++user;
+      starts[++user] = i;
+  }
+  starts[0] = 0;
+
+  // The ratings of each neighbor for all the items of a user are computed at
+  // once, so its factors (and its implicit factor, for SVD++) are computed
+  // once per user instead of once per combination.
+  predictions.set_size(combinations.n_cols);
+  #pragma omp parallel for schedule(dynamic, 16)
+  for (omp_size_t u = 0; u < (omp_size_t) users.n_elem; ++u)
+  {
+    const size_t begin = starts[u];
+    const size_t count = starts[u + 1] - begin;
+    if (count == 0)
+      continue;
 
+    arma::uvec items(count);
+    for (size_t i = 0; i < count; ++i)
+      items[i] = sortedCombinations(1, begin + i);
+
+    arma::vec ratings(count, arma::fill::zeros);
+    arma::vec neighborRatings;
     for (size_t j = 0; j < neighborhood.n_rows; ++j)
     {
-      rating += weights(j, user) * decomposition.GetRating(
-          neighborhood(j, user), sortedCombinations(1, i));
+      decomposition.GetRatingOfUser(neighborhood(j, u), items,
+          neighborRatings);
+      ratings += weights(j, u) * neighborRatings;
     }
 
-    predictions(ordering[i]) = rating;
+    for (size_t i = 0; i < count; ++i)
+      predictions(ordering[begin + i]) = ratings[i];
   }
 
   // Denormalize ratings.
   normalization.Denormalize(combinations, predictions);
 }
 
+template<typename DecompositionPolicy,
+         typename NormalizationType>
+void CFType<DecompositionPolicy,
+            NormalizationType>::
+FoldIn(const arma::mat& data, const double lambda)
+{
+  static_assert(DecompositionTraits<DecompositionPolicy>::LinearRatings,
+      "CFType::FoldIn() needs a decomposition whose ratings are "
+      "W() * H().col(user)!");
+
+  if (data.n_rows != 3)
+  {
+    throw std::invalid_argument("CFType::FoldIn(): the ratings must be a "
+        "(user, item, rating) table!");
+  }
+  if (lambda < 0.0)
+  {
+    throw std::invalid_argument("CFType::FoldIn(): lambda must be "
+        "non-negative!");
+  }
+  if (data.n_cols == 0)
+    return;
+
+  const size_t oldItems = cleanedData.n_rows;
+  const size_t oldUsers = cleanedData.n_cols;
+  const size_t numItems = std::max(oldItems,
+      (size_t) arma::max(data.row(1)) + 1);
+  const size_t numUsers = std::max(oldUsers,
+      (size_t) arma::max(data.row(0)) + 1);
+
+  arma::umat locations(2, data.n_cols);
+  arma::vec values(data.n_cols);
+  for (size_t i = 0; i < data.n_cols; ++i)
+  {
+    locations(0, i) = (arma::uword) data(1, i);
+    locations(1, i) = (arma::uword) data(0, i);
+    values(i) = data(2, i);
+
+    if (locations(0, i) < oldItems && locations(1, i) < oldUsers)
+    {
+      throw std::invalid_argument("CFType::FoldIn(): the rating of user " +
+          std::to_string(locations(1, i)) + " for item " +
+          std::to_string(locations(0, i)) + " involves no new user or item!");
+    }
+  }
+
+  arma::sp_mat ratings(locations, values, numItems, numUsers);
+  normalization.FoldIn(ratings);
+
+  cleanedData.resize(numItems, numUsers);
+  cleanedData += ratings;
+
+  arma::mat& w = decomposition.W();
+  arma::mat& h = decomposition.H();
+
+  // The new items only know the factors of the existing users.
+  const arma::sp_mat itemRatings = ratings.t();
+  w.resize(numItems, w.n_cols);
+  #pragma omp parallel for schedule(dynamic, 16)
+  for (omp_size_t i = (omp_size_t) oldItems; i < (omp_size_t) numItems; ++i)
+    w.row(i) = FoldInFactor(itemRatings, i, h, oldUsers, lambda).t();
+
+  // The new users know the factors of all the items.
+  const arma::mat itemFactors = w.t();
+  h.resize(h.n_rows, numUsers);
+  #pragma omp parallel for schedule(dynamic, 16)
+  for (omp_size_t j = (omp_size_t) oldUsers; j < (omp_size_t) numUsers; ++j)
+    h.col(j) = FoldInFactor(ratings, j, itemFactors, numItems, lambda);
+
+  Log::Info << "Folded " << (numUsers - oldUsers) << " users and "
+      << (numItems - oldItems) << " items into the model." << std::endl;
+}
+
+template<typename DecompositionPolicy,
+         typename NormalizationType>
+arma::vec CFType<DecompositionPolicy,
+                 NormalizationType>::
+FoldInFactor(const arma::sp_mat& ratings,
+             const size_t column,
+             const arma::mat& fixed,
+             const size_t numFixed,
+             const double lambda)
+{
+  const size_t rank = fixed.n_rows;
+  arma::mat a(rank, rank, arma::fill::zeros);
+  arma::vec b(rank, arma::fill::zeros);
+  size_t support = 0;
+
+  arma::sp_mat::const_iterator it = ratings.begin_col(column);
+  for (; it != ratings.end_col(column); ++it)
+  {
+    if (it.row() >= numFixed)
+      continue;
+
+    a += fixed.col(it.row()) * fixed.col(it.row()).t();
+    b += (*it) * fixed.col(it.row());
+    ++support;
+  }
+
+  // Nothing is known about this factor; the regularization makes it 0.
+  if (support == 0)
+    return b;
+
+  a.diag() += lambda;
+  return arma::solve(a, b);
+}
+
 template<typename DecompositionPolicy,
          typename NormalizationType>
 void CFType<DecompositionPolicy,
@@ -114,6 +114,15 @@ BINDING_LONG_DESC(
     " - 'user_mean'  -- User Mean Normalization\n"
     " - 'z_score'  -- Z-Score Normalization\n"
     "\n"
+    "New users and items can be added to a trained model, without retraining "
+    "it, with the " + PRINT_PARAM_STRING("fold_in") + " parameter: it is a "
+    "3-dimensional matrix of ratings like the training set, in which each "
+    "rating involves a user or an item beyond those of the model.  The "
+    "factors of the new users and items are found with a least squares fit to "
+    "the factors of the model, regularized with " +
+    PRINT_PARAM_STRING("fold_in_lambda") + ".  This is not supported by the "
+    "'BiasSVD' and 'SVDPP' algorithms."
+    "\n\n"
     "A trained model may be saved to with the " +
     PRINT_PARAM_STRING("output_model") + " output parameter.");
 
@@ -162,6 +171,12 @@ PARAM_INT_IN("rank", "Rank of decomposed matrices (if 0, a heuristic is used to"
     " estimate the rank).", "R", 0);
 PARAM_MATRIX_IN("test", "Test set to calculate RMSE on.", "T");
 
+// Parameters for folding new users and items into a model.
+PARAM_MATRIX_IN("fold_in", "Ratings of new users and items to fold into the "
+    "model.", "F");
+PARAM_DOUBLE_IN("fold_in_lambda", "Regularization of the least squares fit of "
+    "the new users and items.", "L", 0.01);
+
 // Offer the user the option to set the maximum number of iterations, and
 // terminate only based on the number of iterations.
 PARAM_INT_IN("max_iterations", "Maximum number of iterations. If set to zero, "
@@ -365,6 +380,14 @@ void ComputeRMSE(CFModel* cf)
 
 void PerformAction(CFModel* c)
 {
+  if (IO::HasParam("fold_in"))
+  {
+    arma::mat foldIn = std::move(IO::GetParam<arma::mat>("fold_in"));
+    Log::Info << "Folding " << foldIn.n_cols << " new ratings into the model."
+        << endl;
+    c->FoldIn(foldIn, IO::GetParam<double>("fold_in_lambda"));
+  }
+
   if (IO::HasParam("query") || IO::HasParam("all_user_recommendations"))
   {
     // Get parameters for generating recommendations.
@@ -494,6 +517,9 @@ static void mlpackMain()
 
   RequireParamValue<int>("recommendations", [](int x) { return x > 0; }, true,
         "recommendations must be positive");
+  RequireParamValue<double>("fold_in_lambda", [](double x) { return x >= 0; },
+      true, "fold_in_lambda must be non-negative");
+  ReportIgnoredParam({{ "fold_in", false }}, "fold_in_lambda");
 
   // Either load from a model, or train a model.
   if (IO::HasParam("training"))
@@ -535,7 +561,7 @@ static void mlpackMain()
   {
     // Load from a model after validating parameters.
     RequireAtLeastOnePassed({ "query", "all_user_recommendations",
-        "test" }, true);
+        "test", "fold_in" }, true);
 
     // Load an input model.
     CFModel* c = std::move(IO::GetParam<CFModel*>("input_model"));
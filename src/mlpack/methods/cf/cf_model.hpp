@@ -115,6 +115,38 @@ class RecommendationVisitor : public boost::static_visitor<void>
   void operator()(CFType<DecompositionPolicy, NormalizationType>* c) const;
 };
 
+/**
+ * FoldInVisitor adds new users and items to the CFType object, with
+ * CFType::FoldIn().  The decompositions whose ratings are not W * H can't fold
+ * in new users or items; a std::invalid_argument is thrown for them.
+ */
+class FoldInVisitor : public boost::static_visitor<void>
+{
+ private:
+  //! The ratings of the new users and items.
+  const arma::mat& data;
+  //! Regularization constant.
+  const double lambda;
+
+ public:
+  //! Visitor constructor.
+  FoldInVisitor(const arma::mat& data, const double lambda);
+
+  //! Fold the new users and items into the model.
+  template <typename DecompositionPolicy,
+            typename NormalizationType = NoNormalization>
+  typename std::enable_if<
+      DecompositionTraits<DecompositionPolicy>::LinearRatings>::type
+  operator()(CFType<DecompositionPolicy, NormalizationType>* c) const;
+
+  //! Throw an exception: this model can't fold in new users or items.
+  template <typename DecompositionPolicy,
+            typename NormalizationType = NoNormalization>
+  typename std::enable_if<
+      !DecompositionTraits<DecompositionPolicy>::LinearRatings>::type
+  operator()(CFType<DecompositionPolicy, NormalizationType>* c) const;
+};
+
 /**
  * The model to save to disk.
  */
@@ -214,6 +246,9 @@ class CFModel
   void GetRecommendations(const size_t numRecs,
                           arma::Mat<size_t>& recommendations);
 
+  //! Add new users and items to the model without retraining it.
+  void FoldIn(const arma::mat& data, const double lambda = 0.01);
+
   //! Serialize the model.
   template<typename Archive>
   void serialize(Archive& ar, const unsigned int /* version */);
@@ -105,6 +105,36 @@ void RecommendationVisitor<NeighborSearchPolicy, InterpolationPolicy>
         (numRecs, recommendations);
 }
 
+FoldInVisitor::FoldInVisitor(const arma::mat& data, const double lambda) :
+    data(data),
+    lambda(lambda)
+{ }
+
+template <typename DecompositionPolicy,
+          typename NormalizationType>
+typename std::enable_if<
+    DecompositionTraits<DecompositionPolicy>::LinearRatings>::type
+FoldInVisitor::operator()(
+    CFType<DecompositionPolicy, NormalizationType>* c) const
+{
+  if (!c)
+    throw std::runtime_error("no cf model initialized");
+
+  c->FoldIn(data, lambda);
+}
+
+template <typename DecompositionPolicy,
+          typename NormalizationType>
+typename std::enable_if<
+    !DecompositionTraits<DecompositionPolicy>::LinearRatings>::type
+FoldInVisitor::operator()(
+    CFType<DecompositionPolicy, NormalizationType>* /* c */) const
+{
+  throw std::invalid_argument("new users and items can't be folded into a "
+      "model whose ratings are not W * H; BiasSVD and SVDPP must be "
+      "retrained");
+}
+
 CFModel::~CFModel()
 {
   boost::apply_visitor(DeleteVisitor(), cf);
@@ -198,6 +228,13 @@ void CFModel::GetRecommendations(const size_t numRecs,
   boost::apply_visitor(recommendation, cf);
 }
 
+//! Add new users and items to the model.
+void CFModel::FoldIn(const arma::mat& data, const double lambda)
+{
+  FoldInVisitor foldIn(data, lambda);
+  boost::apply_visitor(foldIn, cf);
+}
+
 template <typename DecompositionPolicy,
           typename NormalizationType>
 const CFType<DecompositionPolicy, NormalizationType>* CFModel::CFPtr() const
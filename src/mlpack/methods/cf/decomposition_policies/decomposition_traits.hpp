@@ -0,0 +1,38 @@
+/**
+ * @file methods/cf/decomposition_policies/decomposition_traits.hpp
+ *
+ * This provides the DecompositionTraits class, a template class to get
+ * information about the decomposition policies of CFType.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_CF_DECOMPOSITION_POLICIES_DECOMPOSITION_TRAITS_HPP
+#define MLPACK_METHODS_CF_DECOMPOSITION_POLICIES_DECOMPOSITION_TRAITS_HPP
+
+namespace mlpack {
+namespace cf {
+
+/**
+ * This is a template class that can provide information about the
+ * decomposition policies.  By default, a policy is assumed to compute the
+ * ratings of a user as W() * H().col(user); a policy that doesn't should
+ * specialize this class.
+ */
+template<typename DecompositionPolicy>
+class DecompositionTraits
+{
+ public:
+  /**
+   * If true, GetRatingOfUser() gives W() * H().col(user), so the ratings are
+   * inner products of the item factors and the user factors.
+   */
+  static const bool LinearRatings = true;
+};
+
+} // namespace cf
+} // namespace mlpack
+
+#endif
@@ -113,6 +113,21 @@ class RandomizedSVDPolicy
     rating = w * h.col(user);
   }
 
+  /**
+   * Get predicted ratings of a user for the given items.  This is faster than
+   * GetRating() for each item, as the factors of the user are read once.
+   *
+   * @param user User ID.
+   * @param items Item IDs.
+   * @param rating Resulting rating vector; rating(i) is the rating of items(i).
+   */
+  void GetRatingOfUser(const size_t user,
+                       const arma::uvec& items,
+                       arma::vec& rating) const
+  {
+    rating = w.rows(items) * h.col(user);
+  }
+
   /**
    * Get the neighborhood and corresponding similarities for a set of users.
    *
@@ -154,8 +169,12 @@ class RandomizedSVDPolicy
 
   //! Get the Item Matrix.
   const arma::mat& W() const { return w; }
+  //! Modify the Item Matrix.
+  arma::mat& W() { return w; }
   //! Get the User Matrix.
   const arma::mat& H() const { return h; }
+  //! Modify the User Matrix.
+  arma::mat& H() { return h; }
 
   //! Get the size of the normalized power iterations.
   size_t IteratedPower() const { return iteratedPower; }
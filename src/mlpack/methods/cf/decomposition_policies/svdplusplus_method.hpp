@@ -15,6 +15,7 @@
 #define MLPACK_METHODS_CF_DECOMPOSITION_POLICIES_SVDPLUSPLUS_METHOD_HPP
 
 #include <mlpack/prereqs.hpp>
+#include "decomposition_traits.hpp"
 #include <mlpack/methods/svdplusplus/svdplusplus.hpp>
 
 namespace mlpack {
@@ -95,20 +96,8 @@ class SVDPlusPlusPolicy
    */
   double GetRating(const size_t user, const size_t item) const
   {
-    // Iterate through each item which the user interacted with to calculate
-    // user vector.
-    arma::vec userVec(h.n_rows, arma::fill::zeros);
-    arma::sp_mat::const_iterator it = implicitData.begin_col(user);
-    arma::sp_mat::const_iterator it_end = implicitData.end_col(user);
-    size_t implicitCount = 0;
-    for (; it != it_end; ++it)
-    {
-      userVec += y.col(it.row());
-      implicitCount += 1;
-    }
-    if (implicitCount != 0)
-      userVec /= std::sqrt(implicitCount);
-    userVec += h.col(user);
+    arma::vec userVec;
+    GetUserVector(user, userVec);
 
     double rating =
         arma::as_scalar(w.row(item) * userVec) + p(item) + q(user);
@@ -123,24 +112,31 @@ class SVDPlusPlusPolicy
    */
   void GetRatingOfUser(const size_t user, arma::vec& rating) const
   {
-    // Iterate through each item which the user interacted with to calculate
-    // user vector.
-    arma::vec userVec(h.n_rows, arma::fill::zeros);
-    arma::sp_mat::const_iterator it = implicitData.begin_col(user);
-    arma::sp_mat::const_iterator it_end = implicitData.end_col(user);
-    size_t implicitCount = 0;
-    for (; it != it_end; ++it)
-    {
-      userVec += y.col(it.row());
-      implicitCount += 1;
-    }
-    if (implicitCount != 0)
-      userVec /= std::sqrt(implicitCount);
-    userVec += h.col(user);
+    arma::vec userVec;
+    GetUserVector(user, userVec);
 
     rating = w * userVec + p + q(user);
   }
 
+  /**
+   * Get predicted ratings of a user for the given items.  This is faster than
+   * GetRating() for each item, as the implicit factor of the user is computed
+   * once.
+   *
+   * @param user User ID.
+   * @param items Item IDs.
+   * @param rating Resulting rating vector; rating(i) is the rating of items(i).
+   */
+  void GetRatingOfUser(const size_t user,
+                       const arma::uvec& items,
+                       arma::vec& rating) const
+  {
+    arma::vec userVec;
+    GetUserVector(user, userVec);
+
+    rating = w.rows(items) * userVec + p.elem(items) + q(user);
+  }
+
   /**
    * Get the neighborhood and corresponding similarities for a set of users.
    *
@@ -173,8 +169,12 @@ class SVDPlusPlusPolicy
 
   //! Get the Item Matrix.
   const arma::mat& W() const { return w; }
+  //! Modify the Item Matrix.
+  arma::mat& W() { return w; }
   //! Get the User Matrix.
   const arma::mat& H() const { return h; }
+  //! Modify the User Matrix.
+  arma::mat& H() { return h; }
   //! Get the User Bias Vector.
   const arma::vec& Q() const { return q; }
   //! Get the Item Bias Vector.
@@ -217,6 +217,28 @@ class SVDPlusPlusPolicy
   }
 
  private:
+  /**
+   * Compute the vector of a user: its factor in H, plus the normalized sum of
+   * the implicit factors of the items it interacted with.
+   */
+  void GetUserVector(const size_t user, arma::vec& userVec) const
+  {
+    // Iterate through each item which the user interacted with to calculate
+    // user vector.
+    userVec.zeros(h.n_rows);
+    arma::sp_mat::const_iterator it = implicitData.begin_col(user);
+    arma::sp_mat::const_iterator it_end = implicitData.end_col(user);
+    size_t implicitCount = 0;
+    for (; it != it_end; ++it)
+    {
+      userVec += y.col(it.row());
+      implicitCount += 1;
+    }
+    if (implicitCount != 0)
+      userVec /= std::sqrt(implicitCount);
+    userVec += h.col(user);
+  }
+
   //! Locally stored number of iterations.
   size_t maxIterations;
   //! Learning rate for optimization.
@@ -237,6 +259,14 @@ class SVDPlusPlusPolicy
   arma::sp_mat implicitData;
 };
 
+//! The ratings also hold the biases and the implicit feedback.
+template<>
+class DecompositionTraits<SVDPlusPlusPolicy>
+{
+ public:
+  static const bool LinearRatings = false;
+};
+
 } // namespace cf
 } // namespace mlpack
 
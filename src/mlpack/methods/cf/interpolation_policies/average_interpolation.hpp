@@ -67,7 +67,7 @@ class AverageInterpolation
                   const size_t /* queryUser */,
                   const arma::Col<size_t>& neighbors,
                   const arma::vec& /* similarities */,
-                  const arma::sp_mat& /* cleanedData */)
+                  const arma::sp_mat& /* cleanedData */) const
   {
     if (neighbors.n_elem == 0)
     {
@@ -84,6 +84,36 @@ class AverageInterpolation
 
     weights.fill(1.0 / neighbors.n_elem);
   }
+
+  /**
+   * Calculate the interpolation weights of a batch of users: each neighbor of
+   * each user gets the same weight.
+   *
+   * @param weights Resulting interpolation weights, one column per user.
+   * @param * (decomposition) Decomposition object.
+   * @param users Queried users.
+   * @param neighborhood Neighbors of each queried user, one column per user.
+   * @param * (similarities) Similarities between the users and their
+   *     neighbors.
+   * @param * (cleanedData) Sparse rating matrix.
+   */
+  template <typename DecompositionPolicy>
+  void GetWeights(arma::mat& weights,
+                  const DecompositionPolicy& /* decomposition */,
+                  const arma::Col<size_t>& users,
+                  const arma::Mat<size_t>& neighborhood,
+                  const arma::mat& /* similarities */,
+                  const arma::sp_mat& /* cleanedData */) const
+  {
+    if (neighborhood.n_rows == 0)
+    {
+      Log::Fatal << "Require: neighborhood.n_rows > 0. There should be at "
+          << "least one neighbor!" << std::endl;
+    }
+
+    weights.set_size(neighborhood.n_rows, users.n_elem);
+    weights.fill(1.0 / neighborhood.n_rows);
+  }
 };
 
 } // namespace cf
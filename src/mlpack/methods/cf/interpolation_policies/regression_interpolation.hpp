@@ -62,16 +62,12 @@ class RegressionInterpolation
   RegressionInterpolation() { }
 
   /**
-   * Use cleanedData to perform necessary preprocessing.
+   * Use cleanedData to perform necessary preprocessing.  Nothing needs to be
+   * cached, so that GetWeights() can be called from several threads.
    *
-   * @param cleanedData Sparse rating matrix.
+   * @param * (cleanedData) Sparse rating matrix.
    */
-  RegressionInterpolation(const arma::sp_mat& cleanedData)
-  {
-    const size_t userNum = cleanedData.n_cols;
-    a.set_size(userNum, userNum);
-    b.set_size(userNum, userNum);
-  }
+  RegressionInterpolation(const arma::sp_mat& /* cleanedData */) { }
 
   /**
    * The regression-based interpolation problem can be solved by a linear
@@ -97,7 +93,7 @@ class RegressionInterpolation
                   const size_t queryUser,
                   const arma::Col<size_t>& neighbors,
                   const arma::vec& /* similarities*/,
-                  const arma::sp_mat& cleanedData)
+                  const arma::sp_mat& cleanedData) const
   {
     if (weights.n_elem != neighbors.n_elem)
     {
@@ -106,18 +102,7 @@ class RegressionInterpolation
           << std::endl;
     }
 
-    const arma::mat& w = decomposition.W();
-    const arma::mat& h = decomposition.H();
-    const size_t itemNum = cleanedData.n_rows;
-    const size_t neighborNum = neighbors.size();
-
-    // Coeffcients of the linear equations used to compute weights.
-    arma::mat coeff(neighborNum, neighborNum);
-    // Constant terms of the linear equations used to compute weights.
-    arma::vec constant(neighborNum);
-
-    arma::vec userRating(cleanedData.col(queryUser));
-    const size_t support = arma::accu(userRating != 0);
+    const size_t support = cleanedData.col(queryUser).n_nonzero;
 
     // If user has no rating at all, average interpolation is used.
     if (support == 0)
@@ -126,60 +111,70 @@ class RegressionInterpolation
       return;
     }
 
-    for (size_t i = 0; i < neighborNum; ++i)
+    // The predicted ratings of the neighbors.
+    const arma::mat predictions = decomposition.W() *
+        decomposition.H().cols(neighbors);
+    const arma::vec userRating(cleanedData.col(queryUser));
+
+    // Coeffcients and constant terms of the linear equations used to compute
+    // weights.
+    const arma::mat coeff = predictions.t() * predictions / cleanedData.n_rows;
+    const arma::vec constant = predictions.t() * userRating / support;
+    weights = arma::solve(coeff, constant);
+  }
+
+  /**
+   * Calculate the interpolation weights of a batch of users, in parallel.  The
+   * coefficients of the equations are inner products of predicted ratings,
+   * which are computed in the space of the user factors with the Gram matrix
+   * W^T W, instead of from the ratings of every item.
+   *
+   * @param weights Resulting interpolation weights, one column per user.
+   * @param decomposition Decomposition object.
+   * @param users Queried users.
+   * @param neighborhood Neighbors of each queried user, one column per user.
+   * @param * (similarities) Similarities between the users and their
+   *     neighbors.
+   * @param cleanedData Sparse rating matrix.
+   */
+  template <typename DecompositionPolicy>
+  void GetWeights(arma::mat& weights,
+                  const DecompositionPolicy& decomposition,
+                  const arma::Col<size_t>& users,
+                  const arma::Mat<size_t>& neighborhood,
+                  const arma::mat& /* similarities */,
+                  const arma::sp_mat& cleanedData) const
+  {
+    const arma::mat& w = decomposition.W();
+    const arma::mat& h = decomposition.H();
+    const arma::mat gram = w.t() * w / cleanedData.n_rows;
+
+    weights.set_size(neighborhood.n_rows, users.n_elem);
+
+    #pragma omp parallel for schedule(dynamic, 64)
+    for (omp_size_t i = 0; i < (omp_size_t) users.n_elem; ++i)
     {
-      // Calculate coefficient.
-      arma::vec iPrediction;
-      for (size_t j = i; j < neighborNum; ++j)
-      {
-        if (a(neighbors(i), neighbors(j)) != 0)
-        {
-          // The coefficient has already been cached.
-          coeff(i, j) = a(neighbors(i), neighbors(j));
-          coeff(j, i) = coeff(i, j);
-        }
-        else
-        {
-          // Calculate the coefficient.
-          if (iPrediction.size() == 0)
-            // Avoid recalculation of iPrediction.
-            iPrediction = w * h.col(neighbors(i));
-          arma::vec jPrediction = w * h.col(neighbors(j));
-          coeff(i, j) = arma::dot(iPrediction, jPrediction) / itemNum;
-          if (coeff(i, j) == 0)
-            coeff(i, j) = std::numeric_limits<double>::min();
-          coeff(j, i) = coeff(i, j);
-          // Cache calcualted coefficient.
-          a(neighbors(i), neighbors(j)) = coeff(i, j);
-          a(neighbors(j), neighbors(i)) = coeff(i, j);
-        }
-      }
+      const size_t support = cleanedData.col(users(i)).n_nonzero;
 
-      // Calculate constant terms.
-      if (b(neighbors(i), queryUser) != 0)
-        // The constant term has already been cached.
-        constant(i) = b(neighbors(i), queryUser);
-      else
+      // If user has no rating at all, average interpolation is used.
+      if (support == 0)
       {
-        // Calcuate the constant term.
-        if (iPrediction.size() == 0)
-            // Avoid recalculation of iPrediction.
-            iPrediction = w * h.col(neighbors(i));
-        constant(i) = arma::dot(iPrediction, userRating) / support;
-        if (constant(i) == 0)
-          constant(i) = std::numeric_limits<double>::min();
-        // Cache calculated constant term.
-        b(neighbors(i), queryUser) = constant(i);
+        weights.col(i).fill(1.0 / neighborhood.n_rows);
+        continue;
       }
+
+      // W^T times the ratings of the user, from its nonzero ratings only.
+      arma::vec userFactors(w.n_cols, arma::fill::zeros);
+      arma::sp_mat::const_iterator it = cleanedData.begin_col(users(i));
+      for (; it != cleanedData.end_col(users(i)); ++it)
+        userFactors += (*it) * w.row(it.row()).t();
+
+      const arma::mat neighborFactors = h.cols(neighborhood.col(i));
+      const arma::mat coeff = neighborFactors.t() * gram * neighborFactors;
+      const arma::vec constant = neighborFactors.t() * userFactors / support;
+      weights.col(i) = arma::solve(coeff, constant);
     }
-    weights = arma::solve(coeff, constant);
   }
-
- private:
-  //! Cached coefficients used in linear equations to compute weights.
-  arma::sp_mat a;
-  //! Cached constant terms used in linear equations to compute weights.
-  arma::sp_mat b;
 };
 
 } // namespace cf
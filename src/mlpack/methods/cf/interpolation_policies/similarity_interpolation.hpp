@@ -69,7 +69,7 @@ class SimilarityInterpolation
                   const size_t /* queryUser */,
                   const arma::Col<size_t>& neighbors,
                   const arma::vec& similarities,
-                  const arma::sp_mat& /* cleanedData */)
+                  const arma::sp_mat& /* cleanedData */) const
   {
     if (similarities.n_elem == 0)
     {
@@ -94,6 +94,41 @@ class SimilarityInterpolation
       weights = similarities / similaritiesSum;
     }
   }
+
+  /**
+   * Calculate the interpolation weights of a batch of users, by normalizing
+   * each column of similarities.
+   *
+   * @param weights Resulting interpolation weights, one column per user.
+   * @param decomposition Decomposition object.
+   * @param users Queried users.
+   * @param neighborhood Neighbors of each queried user, one column per user.
+   * @param similarities Similarities between the users and their neighbors.
+   * @param cleanedData Sparse rating matrix.
+   */
+  template <typename DecompositionPolicy>
+  void GetWeights(arma::mat& weights,
+                  const DecompositionPolicy& decomposition,
+                  const arma::Col<size_t>& users,
+                  const arma::Mat<size_t>& neighborhood,
+                  const arma::mat& similarities,
+                  const arma::sp_mat& cleanedData) const
+  {
+    if (similarities.n_rows == 0)
+    {
+      Log::Fatal << "Require: similarities.n_rows > 0. There should be at "
+          << "least one neighbor!" << std::endl;
+    }
+
+    weights.set_size(neighborhood.n_rows, users.n_elem);
+
+    #pragma omp parallel for
+    for (omp_size_t i = 0; i < (omp_size_t) users.n_elem; ++i)
+    {
+      GetWeights(weights.col(i), decomposition, users(i),
+          neighborhood.col(i), similarities.col(i), cleanedData);
+    }
+  }
 };
 
 } // namespace cf
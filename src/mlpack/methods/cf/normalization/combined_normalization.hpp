@@ -60,6 +60,17 @@ class CombinedNormalization
     SequenceNormalize<0>(data);
   }
 
+  /**
+   * Normalize the ratings which are folded into a trained model by calling
+   * FoldIn() in each normalization object.
+   *
+   * @param ratings The new ratings, as a sparse matrix.
+   */
+  void FoldIn(arma::sp_mat& ratings)
+  {
+    SequenceFoldIn<0>(ratings);
+  }
+
   /**
    * Denormalize rating by calling Denormalize() in each normalization object.
    * Note that the order of objects calling Denormalize() should be the
@@ -130,6 +141,23 @@ class CombinedNormalization
       typename = void>
   void SequenceNormalize(MatType& /* data */) { }
 
+  //! Unpack normalizations tuple to normalize folded-in ratings.
+  template<
+      int I, /* Which normalization in tuple to use */
+      typename = std::enable_if_t<(I < std::tuple_size<TupleType>::value)>>
+  void SequenceFoldIn(arma::sp_mat& ratings)
+  {
+    std::get<I>(normalizations).FoldIn(ratings);
+    SequenceFoldIn<I + 1>(ratings);
+  }
+
+  //! End of tuple unpacking.
+  template<
+      int I, /* Which normalization in tuple to use */
+      typename = std::enable_if_t<(I >= std::tuple_size<TupleType>::value)>,
+      typename = void>
+  void SequenceFoldIn(arma::sp_mat& /* ratings */) { }
+
   //! Unpack normalizations tuple to denormalize.
   template<
       int I, /* Which normalization in tuple to use */
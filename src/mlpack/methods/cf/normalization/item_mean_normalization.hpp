@@ -120,6 +120,45 @@ class ItemMeanNormalization
     }
   }
 
+  /**
+   * Normalize the ratings which are folded into a trained model.  The mean of
+   * each new item (whose index is beyond the items seen by Normalize()) is
+   * computed from these ratings; the ratings of the other items are
+   * normalized with their stored mean.
+   *
+   * @param ratings The new ratings, as a sparse matrix of the size of the
+   *     extended dataset.
+   */
+  void FoldIn(arma::sp_mat& ratings)
+  {
+    const size_t oldItems = itemMean.n_elem;
+    itemMean.resize(ratings.n_rows);
+    arma::Col<size_t> ratingNum(ratings.n_rows, arma::fill::zeros);
+    arma::sp_mat::iterator it = ratings.begin();
+    for (; it != ratings.end(); ++it)
+    {
+      if (it.row() >= oldItems)
+      {
+        itemMean(it.row()) += *it;
+        ratingNum(it.row()) += 1;
+      }
+    }
+    for (size_t i = oldItems; i < itemMean.n_elem; ++i)
+    {
+      if (ratingNum(i) != 0)
+        itemMean(i) /= ratingNum(i);
+    }
+
+    for (it = ratings.begin(); it != ratings.end(); ++it)
+    {
+      double tmp = *it - itemMean(it.row());
+      if (tmp == 0)
+        tmp = std::numeric_limits<float>::min();
+
+      *it = tmp;
+    }
+  }
+
   /**
    * Denormalize computed rating by adding item mean.
    *
@@ -36,6 +36,13 @@ class NoNormalization
   template<typename MatType>
   inline void Normalize(const MatType& /* data */) const { }
 
+  /**
+   * Do nothing.
+   *
+   * @param * (ratings) Ratings folded into a trained model.
+   */
+  inline void FoldIn(const arma::sp_mat& /* ratings */) const { }
+
   /**
    * Do nothing.
    *
@@ -93,6 +93,25 @@ class OverallMeanNormalization
     }
   }
 
+  /**
+   * Normalize the ratings which are folded into a trained model, by
+   * subtracting the stored mean.
+   *
+   * @param ratings The new ratings, as a sparse matrix.
+   */
+  void FoldIn(arma::sp_mat& ratings) const
+  {
+    arma::sp_mat::iterator it = ratings.begin();
+    for (; it != ratings.end(); ++it)
+    {
+      double tmp = *it - mean;
+      if (tmp == 0)
+        tmp = std::numeric_limits<float>::min();
+
+      *it = tmp;
+    }
+  }
+
   /**
    * Denormalize computed rating by adding mean.
    *
@@ -120,6 +120,45 @@ class UserMeanNormalization
     }
   }
 
+  /**
+   * Normalize the ratings which are folded into a trained model.  The mean of
+   * each new user (whose index is beyond the users seen by Normalize()) is
+   * computed from these ratings; the ratings of the other users are
+   * normalized with their stored mean.
+   *
+   * @param ratings The new ratings, as a sparse matrix of the size of the
+   *     extended dataset.
+   */
+  void FoldIn(arma::sp_mat& ratings)
+  {
+    const size_t oldUsers = userMean.n_elem;
+    userMean.resize(ratings.n_cols);
+    arma::Col<size_t> ratingNum(ratings.n_cols, arma::fill::zeros);
+    arma::sp_mat::iterator it = ratings.begin();
+    for (; it != ratings.end(); ++it)
+    {
+      if (it.col() >= oldUsers)
+      {
+        userMean(it.col()) += *it;
+        ratingNum(it.col()) += 1;
+      }
+    }
+    for (size_t i = oldUsers; i < userMean.n_elem; ++i)
+    {
+      if (ratingNum(i) != 0)
+        userMean(i) /= ratingNum(i);
+    }
+
+    for (it = ratings.begin(); it != ratings.end(); ++it)
+    {
+      double tmp = *it - userMean(it.col());
+      if (tmp == 0)
+        tmp = std::numeric_limits<float>::min();
+
+      *it = tmp;
+    }
+  }
+
   /**
    * Denormalize computed rating by adding user mean.
    *
@@ -105,6 +105,25 @@ class ZScoreNormalization
     }
   }
 
+  /**
+   * Normalize the ratings which are folded into a trained model, with the
+   * stored mean and standard deviation.
+   *
+   * @param ratings The new ratings, as a sparse matrix.
+   */
+  void FoldIn(arma::sp_mat& ratings) const
+  {
+    arma::sp_mat::iterator it = ratings.begin();
+    for (; it != ratings.end(); ++it)
+    {
+      double tmp = (*it - mean) / stddev;
+      if (tmp == 0)
+        tmp = std::numeric_limits<float>::min();
+
+      *it = tmp;
+    }
+  }
+
   /**
    * Denormalize computed rating by adding mean and multiplying stddev.
    *
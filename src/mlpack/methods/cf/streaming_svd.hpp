@@ -0,0 +1,148 @@
+/**
+ * @file methods/cf/streaming_svd.hpp
+ *
+ * Definition of the StreamingSVD class, which factorizes a rating dataset that
+ * doesn't fit in memory with SGD epochs over its chunks.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_CF_STREAMING_SVD_HPP
+#define MLPACK_METHODS_CF_STREAMING_SVD_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/data/prefetch_loader.hpp>
+#include <mlpack/methods/amf/sgd_schedule.hpp>
+
+namespace mlpack {
+namespace cf {
+
+/**
+ * StreamingSVD learns the regularized SVD of a rating dataset, like
+ * RegularizedSVD, but reads the (user, item, rating) triples chunk by chunk
+ * from a data::PrefetchLoader instead of holding them in memory.  Each epoch
+ * is a pass over the chunks; the ratings of each chunk are visited in
+ * parallel, with the stratified schedule of amf::SGDSchedule, while the next
+ * chunks are loaded on the background thread of the loader.  Only the factors
+ * and the loaded chunks are kept in memory.
+ *
+ * With a data::MappedChunkSource, the chunks are read from memory-mapped
+ * shards:
+ *
+ * @code
+ * data::MappedChunkSource source(shardFiles, 1000000);
+ * data::PrefetchLoader<data::MappedChunkSource> loader(source, 2, true);
+ *
+ * StreamingSVD svd(32, 10);
+ * svd.Train(loader);
+ * const double rating = svd.Predict(user, item);
+ * @endcode
+ *
+ * The predicted rating of user u for item i is
+ * dot(ItemFactors().col(i), UserFactors().col(u)), so ItemFactors().t() and
+ * UserFactors() are the W and H matrices of CF.
+ */
+class StreamingSVD
+{
+ public:
+  /**
+   * Create the model with the given parameters.
+   *
+   * @param rank Rank of the factorization.
+   * @param epochs Number of passes over the chunks.
+   * @param stepSize Step size of SGD.
+   * @param lambda Regularization constant.
+   */
+  StreamingSVD(const size_t rank = 10,
+               const size_t epochs = 10,
+               const double stepSize = 0.01,
+               const double lambda = 0.02);
+
+  /**
+   * Train the model on the chunks of the given loader; each chunk holds one
+   * rating per column, with the user in the first row, the item in the second
+   * row and the rating in the third row.  If the number of users or items is
+   * 0, it is found with an extra pass over the chunks.  The factors are
+   * initialized randomly, unless they already have the right size, so
+   * training can be continued on new data.
+   *
+   * @param loader The loader of the chunks.
+   * @param numUsers Number of users (0 to find it).
+   * @param numItems Number of items (0 to find it).
+   * @return The root mean squared error of the ratings during the last epoch,
+   *     measured before each update.
+   */
+  template<typename SourceType>
+  double Train(data::PrefetchLoader<SourceType>& loader,
+               size_t numUsers = 0,
+               size_t numItems = 0);
+
+  /**
+   * Predict the rating of the given user for the given item.
+   *
+   * @param user The user.
+   * @param item The item.
+   */
+  double Predict(const size_t user, const size_t item) const
+  {
+    return arma::dot(itemFactors.col(item), userFactors.col(user));
+  }
+
+  //! Get the factors of the users, one per column.
+  const arma::mat& UserFactors() const { return userFactors; }
+  //! Modify the factors of the users, one per column.
+  arma::mat& UserFactors() { return userFactors; }
+
+  //! Get the factors of the items, one per column.
+  const arma::mat& ItemFactors() const { return itemFactors; }
+  //! Modify the factors of the items, one per column.
+  arma::mat& ItemFactors() { return itemFactors; }
+
+  //! Get the rank of the factorization.
+  size_t Rank() const { return rank; }
+  //! Modify the rank of the factorization.
+  size_t& Rank() { return rank; }
+
+  //! Get the number of passes over the chunks.
+  size_t Epochs() const { return epochs; }
+  //! Modify the number of passes over the chunks.
+  size_t& Epochs() { return epochs; }
+
+  //! Get the step size of SGD.
+  double StepSize() const { return stepSize; }
+  //! Modify the step size of SGD.
+  double& StepSize() { return stepSize; }
+
+  //! Get the regularization constant.
+  double Lambda() const { return lambda; }
+  //! Modify the regularization constant.
+  double& Lambda() { return lambda; }
+
+  //! Serialize the model.
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */);
+
+ private:
+  //! Rank of the factorization.
+  size_t rank;
+  //! Number of passes over the chunks.
+  size_t epochs;
+  //! Step size of SGD.
+  double stepSize;
+  //! Regularization constant.
+  double lambda;
+  //! The factors of the users.
+  arma::mat userFactors;
+  //! The factors of the items.
+  arma::mat itemFactors;
+};
+
+} // namespace cf
+} // namespace mlpack
+
+// Include implementation.
+#include "streaming_svd_impl.hpp"
+
+#endif
@@ -0,0 +1,134 @@
+/**
+ * @file methods/cf/streaming_svd_impl.hpp
+ *
+ * Implementation of the StreamingSVD class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_CF_STREAMING_SVD_IMPL_HPP
+#define MLPACK_METHODS_CF_STREAMING_SVD_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "streaming_svd.hpp"
+
+namespace mlpack {
+namespace cf {
+
+inline StreamingSVD::StreamingSVD(const size_t rank,
+                                  const size_t epochs,
+                                  const double stepSize,
+                                  const double lambda) :
+    rank(rank),
+    epochs(epochs),
+    stepSize(stepSize),
+    lambda(lambda)
+{
+  if (rank == 0)
+  {
+    throw std::invalid_argument("StreamingSVD::StreamingSVD(): the rank must "
+        "be positive!");
+  }
+}
+
+template<typename SourceType>
+double StreamingSVD::Train(data::PrefetchLoader<SourceType>& loader,
+                           size_t numUsers,
+                           size_t numItems)
+{
+  arma::mat chunk, responses;
+  arma::vec errors;
+
+  if (numUsers == 0 || numItems == 0)
+  {
+    // Find the largest user and item with a first pass.
+    size_t maxUser = 0, maxItem = 0;
+    loader.Reset();
+    while (loader.Next(chunk, responses))
+    {
+      if (chunk.n_cols == 0)
+        continue;
+
+      maxUser = std::max(maxUser, (size_t) arma::max(chunk.row(0)));
+      maxItem = std::max(maxItem, (size_t) arma::max(chunk.row(1)));
+    }
+
+    if (numUsers == 0)
+      numUsers = maxUser + 1;
+    if (numItems == 0)
+      numItems = maxItem + 1;
+  }
+
+  if (userFactors.n_rows != rank || userFactors.n_cols != numUsers ||
+      itemFactors.n_rows != rank || itemFactors.n_cols != numItems)
+  {
+    userFactors.randu(rank, numUsers);
+    itemFactors.randu(rank, numItems);
+  }
+
+  double rmse = 0.0;
+  amf::SGDSchedule schedule(amf::SGDSchedule::STRATIFIED);
+  for (size_t epoch = 0; epoch < epochs; ++epoch)
+  {
+    double squaredError = 0.0;
+    size_t numRatings = 0;
+
+    loader.Reset();
+    while (loader.Next(chunk, responses))
+    {
+      if (chunk.n_rows < 3)
+      {
+        throw std::invalid_argument("StreamingSVD::Train(): the chunks must "
+            "have a user, an item and a rating in each column!");
+      }
+
+      // The ratings of the chunk are visited in blocks that share no user and
+      // no item, so the factors are updated without atomics.  Each rating is
+      // visited once, so its error is stored without a race.
+      schedule.Reset(chunk, numUsers, numItems);
+      errors.set_size(chunk.n_cols);
+      schedule.Epoch([&](const size_t j)
+      {
+        const size_t user = (size_t) chunk(0, j);
+        const size_t item = (size_t) chunk(1, j);
+        const double error = chunk(2, j) - arma::dot(userFactors.col(user),
+            itemFactors.col(item));
+
+        const arma::vec userUpdate = stepSize * (error *
+            itemFactors.col(item) - lambda * userFactors.col(user));
+        itemFactors.col(item) += stepSize * (error * userFactors.col(user) -
+            lambda * itemFactors.col(item));
+        userFactors.col(user) += userUpdate;
+
+        errors[j] = error * error;
+      });
+
+      squaredError += arma::accu(errors);
+      numRatings += chunk.n_cols;
+    }
+
+    rmse = (numRatings == 0) ? 0.0 : std::sqrt(squaredError / numRatings);
+    Log::Info << "StreamingSVD: epoch " << (epoch + 1) << ", RMSE " << rmse
+        << " over " << numRatings << " ratings." << std::endl;
+  }
+
+  return rmse;
+}
+
+template<typename Archive>
+void StreamingSVD::serialize(Archive& ar, const unsigned int /* version */)
+{
+  ar & BOOST_SERIALIZATION_NVP(rank);
+  ar & BOOST_SERIALIZATION_NVP(epochs);
+  ar & BOOST_SERIALIZATION_NVP(stepSize);
+  ar & BOOST_SERIALIZATION_NVP(lambda);
+  ar & BOOST_SERIALIZATION_NVP(userFactors);
+  ar & BOOST_SERIALIZATION_NVP(itemFactors);
+}
+
+} // namespace cf
+} // namespace mlpack
+
+#endif
@@ -16,6 +16,7 @@
 #include <mlpack/core.hpp>
 #include <mlpack/methods/range_search/range_search.hpp>
 #include <mlpack/methods/emst/union_find.hpp>
+#include <mlpack/methods/emst/concurrent_union_find.hpp>
 #include "random_point_selection.hpp"
 #include "ordered_point_selection.hpp"
 #include <boost/dynamic_bitset.hpp>
@@ -63,14 +64,27 @@ class DBSCAN
    * @param epsilon Size of range query.
    * @param minPoints Minimum number of points for each cluster.
    * @param batchMode If true, all points are searched in batch.
+   * When fusedMode is true (and batchMode is true), the components are merged
+   * while the range search runs, so the neighborhoods of the points are never
+   * stored; this needs a RangeSearchType that provides the callback overload
+   * of Search(), like RangeSearch.  The memory used is then linear in the
+   * number of points, no matter how large epsilon is.  The point selection
+   * policy has no effect in this mode, since the points are merged in the order
+   * the traversal finds them.
+   *
+   * @param epsilon Size of range query.
+   * @param minPoints Minimum number of points for each cluster.
+   * @param batchMode If true, all points are searched in batch.
    * @param rangeSearch Optional instantiated RangeSearch object.
    * @param pointSelector OptionL instantiated PointSelectionPolicy object.
+   * @param fusedMode If true, merge components during the batch range search.
    */
   DBSCAN(const double epsilon,
          const size_t minPoints,
          const bool batchMode = true,
          RangeSearchType rangeSearch = RangeSearchType(),
-         PointSelectionPolicy pointSelector = PointSelectionPolicy());
+         PointSelectionPolicy pointSelector = PointSelectionPolicy(),
+         const bool fusedMode = false);
 
   /**
    * Performs DBSCAN clustering on the data, returning number of clusters
@@ -112,6 +126,17 @@ class DBSCAN
                  arma::Row<size_t>& assignments,
                  arma::mat& centroids);
 
+  //! Get the number of threads used for clustering (0 means that OpenMP
+  //! decides).
+  size_t NumThreads() const { return numThreads; }
+  //! Modify the number of threads used for clustering (0 means that OpenMP
+  //! decides).  With any value other than 1, the range search is split across
+  //! threads and the components are merged during the search with a lock-free
+  //! union-find (as in fused mode, whatever the batch mode is); this needs a
+  //! RangeSearchType with a NumThreads() setting, like RangeSearch.  The
+  //! default is 1.
+  size_t& NumThreads() { return numThreads; }
+
  private:
   //! Maximum distance between two points to be part of same cluster.
   double epsilon;
@@ -123,6 +148,12 @@ class DBSCAN
   //! Whether or not to perform the search in batch mode.  If false, single
   bool batchMode;
 
+  //! Whether or not to merge components during the batch range search.
+  bool fusedMode;
+
+  //! The number of threads used for clustering.
+  size_t numThreads;
+
   //! Instantiated range search policy.
   RangeSearchType rangeSearch;
 
@@ -155,6 +186,31 @@ class DBSCAN
   template<typename MatType>
   void BatchCluster(const MatType& data,
                     emst::UnionFind& uf);
+
+  /**
+   * Performs DBSCAN clustering on the data by merging the components of each
+   * pair of points as soon as the range search finds it, instead of storing
+   * the neighborhoods of all points first.  This has the speed of a batch
+   * dual-tree search and uses memory linear in the number of points.
+   *
+   * @param data Dataset to cluster.
+   * @param uf UnionFind structure that will be modified.
+   */
+  template<typename MatType>
+  void FusedCluster(const MatType& data,
+                    emst::UnionFind& uf);
+
+  /**
+   * Performs DBSCAN clustering on the data with several threads.  The range
+   * search is split across threads, and each pair of points is merged as soon
+   * as it is found with a lock-free union-find, so no neighborhood is stored.
+   *
+   * @param data Dataset to cluster.
+   * @param uf ConcurrentUnionFind structure that will be modified.
+   */
+  template<typename MatType>
+  void ParallelCluster(const MatType& data,
+                       emst::ConcurrentUnionFind& uf);
 };
 
 } // namespace dbscan
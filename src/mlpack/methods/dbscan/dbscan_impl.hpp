@@ -26,10 +26,13 @@ DBSCAN<RangeSearchType, PointSelectionPolicy>::DBSCAN(
     const size_t minPoints,
     const bool batchMode,
     RangeSearchType rangeSearch,
-    PointSelectionPolicy pointSelector) :
+    PointSelectionPolicy pointSelector,
+    const bool fusedMode) :
     epsilon(epsilon),
     minPoints(minPoints),
     batchMode(batchMode),
+    fusedMode(fusedMode),
+    numThreads(1),
     rangeSearch(rangeSearch),
     pointSelector(pointSelector)
 {
@@ -100,19 +103,34 @@ size_t DBSCAN<RangeSearchType, PointSelectionPolicy>::Cluster(
     const MatType& data,
     arma::Row<size_t>& assignments)
 {
-  // Initialize the UnionFind object.
-  emst::UnionFind uf(data.n_cols);
   rangeSearch.Train(data);
+  assignments.set_size(data.n_cols);
+
+  if (numThreads != 1)
+  {
+    emst::ConcurrentUnionFind uf(data.n_cols);
+    ParallelCluster(data, uf);
 
-  if (batchMode)
-    BatchCluster(data, uf);
+    // Now set assignments.
+    for (size_t i = 0; i < data.n_cols; ++i)
+      assignments[i] = uf.Find(i);
+  }
   else
-    PointwiseCluster(data, uf);
+  {
+    // Initialize the UnionFind object.
+    emst::UnionFind uf(data.n_cols);
 
-  // Now set assignments.
-  assignments.set_size(data.n_cols);
-  for (size_t i = 0; i < data.n_cols; ++i)
-    assignments[i] = uf.Find(i);
+    if (batchMode && fusedMode)
+      FusedCluster(data, uf);
+    else if (batchMode)
+      BatchCluster(data, uf);
+    else
+      PointwiseCluster(data, uf);
+
+    // Now set assignments.
+    for (size_t i = 0; i < data.n_cols; ++i)
+      assignments[i] = uf.Find(i);
+  }
 
   // Get a count of all clusters.
   const size_t numClusters = arma::max(assignments) + 1;
@@ -199,6 +217,55 @@ void DBSCAN<RangeSearchType, PointSelectionPolicy>::BatchCluster(
   }
 }
 
+/**
+ * Performs DBSCAN clustering on the data by merging components while the range
+ * search runs, so that no neighborhood is ever stored.
+ */
+template<typename RangeSearchType, typename PointSelectionPolicy>
+template<typename MatType>
+void DBSCAN<RangeSearchType, PointSelectionPolicy>::FusedCluster(
+    const MatType& /* data */,
+    emst::UnionFind& uf)
+{
+  // The reference set was already given to the range search object by
+  // Cluster(), so we can search it directly.
+  Log::Info << "Performing range search and merging components." << std::endl;
+  rangeSearch.Search(math::Range(0.0, epsilon), [&uf](const size_t queryIndex,
+      const size_t referenceIndex, const double /* distance */)
+  {
+    // Each pair of points is found twice, once from each point, but it only
+    // needs to be merged once.  Union() itself returns early when the two
+    // points are already in the same component.
+    if (queryIndex < referenceIndex)
+      uf.Union(queryIndex, referenceIndex);
+  });
+  Log::Info << "Range search complete." << std::endl;
+}
+
+/**
+ * Performs DBSCAN clustering on the data with several threads, merging
+ * components with a lock-free union-find while the range search runs.
+ */
+template<typename RangeSearchType, typename PointSelectionPolicy>
+template<typename MatType>
+void DBSCAN<RangeSearchType, PointSelectionPolicy>::ParallelCluster(
+    const MatType& /* data */,
+    emst::ConcurrentUnionFind& uf)
+{
+  Log::Info << "Performing parallel range search and merging components."
+      << std::endl;
+  rangeSearch.NumThreads() = numThreads;
+  rangeSearch.Search(math::Range(0.0, epsilon), [&uf](const size_t queryIndex,
+      const size_t referenceIndex, const double /* distance */)
+  {
+    // This is called from many threads at once, which the concurrent
+    // union-find allows.  Each pair is found twice, so merge it only once.
+    if (queryIndex < referenceIndex)
+      uf.Union(queryIndex, referenceIndex);
+  });
+  Log::Info << "Range search complete." << std::endl;
+}
+
 } // namespace dbscan
 } // namespace mlpack
 
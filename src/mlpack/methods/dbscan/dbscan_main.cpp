@@ -63,7 +63,12 @@ BINDING_LONG_DESC(
     " 'hilbert-r', 'r-plus', 'r-plus-plus', 'cover', 'ball'. The " +
     PRINT_PARAM_STRING("single_mode") + " parameter will force single-tree "
     "search (as opposed to the default dual-tree search), and '" +
-    PRINT_PARAM_STRING("naive") + " will force brute-force range search.");
+    PRINT_PARAM_STRING("naive") + " will force brute-force range search."
+    "\n\n"
+    "The clustering can be run on several threads with the " +
+    PRINT_PARAM_STRING("threads") + " parameter (0 uses the OpenMP default); "
+    "with more than one thread, the neighborhoods of the points are merged "
+    "while the range search runs and are never stored.");
 
 // Example.
 BINDING_EXAMPLE(
@@ -115,6 +120,7 @@ void RunDBSCAN(RangeSearchType rs,
 
   DBSCAN<RangeSearchType, PointSelectionPolicy> d(epsilon, minSize,
       !IO::HasParam("single_mode"), rs, pointSelector);
+  d.NumThreads() = (size_t) IO::GetParam<int>("threads");
 
   // If possible, avoid the overhead of calculating centroids.
   if (IO::HasParam("centroids"))
@@ -165,6 +171,9 @@ static void mlpackMain()
   RequireParamValue<int>("min_size", [](int y) { return y > 0; },
       true, "invalid value of min_size specified");
 
+  RequireParamValue<int>("threads", [](int x) { return x >= 0; }, true,
+      "number of threads must be nonnegative");
+
   // Fire off naive search if needed.
   if (IO::HasParam("naive"))
   {
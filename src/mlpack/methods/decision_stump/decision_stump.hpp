@@ -71,6 +71,29 @@ class DecisionStump
                                   const size_t numClasses,
                                   const arma::rowvec& weights);
 
+  /**
+   * Alternate constructor which copies the parameters bucketSize and classes
+   * from an already initiated decision stump, other, and uses the given sort of
+   * each dimension of the data instead of sorting the data again.  When the
+   * same data is used to train many stumps with different weights, as in
+   * boosting, the data only needs to be sorted once with SortDimensions().
+   *
+   * @param other The other initiated Decision Stump object from
+   *      which we copy the values.
+   * @param data The data on which to train this object on.
+   * @param sortedIndices The sort of each dimension of data, as computed by
+   *      SortDimensions().
+   * @param labels The labels of data.
+   * @param numClasses The number of classes.
+   * @param weights Weight vector to use while training. For boosting purposes.
+   */
+  mlpack_deprecated DecisionStump(const DecisionStump<>& other,
+                                  const MatType& data,
+                                  const arma::umat& sortedIndices,
+                                  const arma::Row<size_t>& labels,
+                                  const size_t numClasses,
+                                  const arma::rowvec& weights);
+
   /**
    * Create a decision stump without training.  This stump will not be useful
    * and will always return a class of 0 for anything that is to be classified,
@@ -123,6 +146,16 @@ class DecisionStump
   mlpack_deprecated void Classify(const MatType& test,
                                   arma::Row<size_t>& predictedLabels);
 
+  /**
+   * Compute the stable sort of each dimension of the given data: column i of
+   * sortedIndices holds the indices of the points in increasing order of their
+   * value in dimension i.  The dimensions are sorted in parallel.
+   *
+   * @param data Dataset to sort.
+   * @param sortedIndices Matrix to store the sorted indices in.
+   */
+  static void SortDimensions(const MatType& data, arma::umat& sortedIndices);
+
   //! Access the splitting dimension.
   size_t SplitDimension() const { return splitDimension; }
   //! Modify the splitting dimension (be careful!).
@@ -159,12 +192,11 @@ class DecisionStump
    * Sets up dimension as if it were splitting on it and finds entropy when
    * splitting on dimension.
    *
-   * @param dimension A row from the training data, which might be a
-   *     candidate for the splitting dimension.
+   * @param sortedIndex The sort of the candidate dimension.
    * @tparam UseWeights Whether we need to run a weighted Decision Stump.
    */
-  template<bool UseWeights, typename VecType>
-  double SetupSplitDimension(const VecType& dimension,
+  template<bool UseWeights>
+  double SetupSplitDimension(const arma::uvec& sortedIndex,
                              const arma::Row<size_t>& labels,
                              const arma::rowvec& weightD);
 
@@ -174,9 +206,11 @@ class DecisionStump
    *
    * @tparam dimension dimension is the dimension decided by the constructor
    *      on which we now train the decision stump.
+   * @param sortedIndex The sort of the dimension.
    */
   template<typename VecType>
   void TrainOnDim(const VecType& dimension,
+                  const arma::uvec& sortedIndex,
                   const arma::Row<size_t>& labels);
 
   /**
@@ -194,14 +228,6 @@ class DecisionStump
   template<typename VecType>
   double CountMostFreq(const VecType& subCols);
 
-  /**
-   * Returns 1 if all the values of featureRow are not same.
-   *
-   * @param featureRow The dimension which is checked for identical values.
-   */
-  template<typename VecType>
-  int IsDistinct(const VecType& featureRow);
-
   /**
    * Calculate the entropy of the given dimension.
    *
@@ -229,6 +255,24 @@ class DecisionStump
   double Train(const MatType& data,
                const arma::Row<size_t>& labels,
                const arma::rowvec& weights);
+
+  /**
+   * Train the decision stump on the given data and labels, using the given
+   * sort of each dimension of the data.
+   *
+   * @param data Dataset to train on.
+   * @param sortedIndices The sort of each dimension of data.
+   * @param labels Labels for dataset.
+   * @param weights Weights for this set of labels.
+   * @tparam UseWeights If true, the weights in the weight vector will be used
+   *      (otherwise they are ignored).
+   * @return The final entropy after splitting.
+   */
+  template<bool UseWeights>
+  double Train(const MatType& data,
+               const arma::umat& sortedIndices,
+               const arma::Row<size_t>& labels,
+               const arma::rowvec& weights);
 };
 
 } // namespace decision_stump
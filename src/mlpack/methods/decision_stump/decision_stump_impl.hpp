@@ -101,42 +101,99 @@ template<bool UseWeights>
 double DecisionStump<MatType>::Train(const MatType& data,
                                      const arma::Row<size_t>& labels,
                                      const arma::rowvec& weights)
+{
+  arma::umat sortedIndices;
+  SortDimensions(data, sortedIndices);
+
+  return Train<UseWeights>(data, sortedIndices, labels, weights);
+}
+
+/**
+ * Train the decision stump on the given data and labels, using the given sort
+ * of each dimension.
+ *
+ * @param data Dataset to train on.
+ * @param sortedIndices The sort of each dimension of data.
+ * @param labels Labels for dataset.
+ * @param UseWeights Whether we need to run a weighted Decision Stump.
+ */
+template<typename MatType>
+template<bool UseWeights>
+double DecisionStump<MatType>::Train(const MatType& data,
+                                     const arma::umat& sortedIndices,
+                                     const arma::Row<size_t>& labels,
+                                     const arma::rowvec& weights)
 {
   // If classLabels are not all identical, proceed with training.
   size_t bestDim = 0;
-  double entropy;
   const double rootEntropy = CalculateEntropy<UseWeights>(labels, weights);
 
+  // Calculate the entropy of the split on each dimension in parallel.  A
+  // dimension whose values are all identical can't be split; since its values
+  // are sorted, only the first and the last one need to be compared.
+  arma::vec entropies(data.n_rows);
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) data.n_rows; ++i)
+  {
+    const arma::uvec sortedIndex(const_cast<arma::uword*>(
+        sortedIndices.colptr(i)), sortedIndices.n_rows, false, true);
+    if (data(i, sortedIndex[0]) != data(i, sortedIndex[data.n_cols - 1]))
+    {
+      entropies[i] = SetupSplitDimension<UseWeights>(sortedIndex, labels,
+          weights);
+    }
+    else
+    {
+      entropies[i] = DBL_MAX;
+    }
+  }
+
   double gain, bestGain = 0.0;
   for (size_t i = 0; i < data.n_rows; ++i)
   {
-    // Go through each dimension of the data.
-    if (IsDistinct(data.row(i)))
+    // Go through each dimension of the data, skipping the ones with identical
+    // values.
+    if (entropies[i] == DBL_MAX)
+      continue;
+
+    gain = rootEntropy - entropies[i];
+    // Find the dimension with the best entropy so that the gain is
+    // maximized.
+
+    // We are maximizing gain, which is what is returned from
+    // SetupSplitDimension().
+    if (gain < bestGain)
     {
-      // For each dimension with non-identical values, treat it as a potential
-      // splitting dimension and calculate entropy if split on it.
-      entropy = SetupSplitDimension<UseWeights>(data.row(i), labels, weights);
-
-      gain = rootEntropy - entropy;
-      // Find the dimension with the best entropy so that the gain is
-      // maximized.
-
-      // We are maximizing gain, which is what is returned from
-      // SetupSplitDimension().
-      if (gain < bestGain)
-      {
-        bestDim = i;
-        bestGain = gain;
-      }
+      bestDim = i;
+      bestGain = gain;
     }
   }
   splitDimension = bestDim;
 
   // Once the splitting column/dimension has been decided, train on it.
-  TrainOnDim(data.row(splitDimension), labels);
+  TrainOnDim(data.row(splitDimension), sortedIndices.col(splitDimension),
+      labels);
   return -bestGain;
 }
 
+/**
+ * Compute the stable sort of each dimension of the given data.
+ */
+template<typename MatType>
+void DecisionStump<MatType>::SortDimensions(const MatType& data,
+                                            arma::umat& sortedIndices)
+{
+  sortedIndices.set_size(data.n_cols, data.n_rows);
+
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) data.n_rows; ++i)
+  {
+    // This sort is stable.
+    sortedIndices.col(i) = arma::stable_sort_index(
+        typename MatType::row_type(data.row(i)).t());
+  }
+}
+
 /**
  * Classification function. After training, classify test, and put the predicted
  * classes in predictedLabels.
@@ -194,6 +251,24 @@ DecisionStump<MatType>::DecisionStump(const DecisionStump<>& other,
   Train<true>(data, labels, weights);
 }
 
+/**
+ * Alternate constructor which copies parameters bucketSize and numClasses
+ * from an already initiated decision stump, other, and trains with the given
+ * sort of each dimension of the data.
+ */
+template<typename MatType>
+DecisionStump<MatType>::DecisionStump(const DecisionStump<>& other,
+                                      const MatType& data,
+                                      const arma::umat& sortedIndices,
+                                      const arma::Row<size_t>& labels,
+                                      const size_t numClasses,
+                                      const arma::rowvec& weights) :
+    numClasses(numClasses),
+    bucketSize(other.bucketSize)
+{
+  Train<true>(data, sortedIndices, labels, weights);
+}
+
 /**
  * Serialize the decision stump.
  */
@@ -215,28 +290,26 @@ void DecisionStump<MatType>::serialize(Archive& ar,
  * Sets up dimension as if it were splitting on it and finds entropy when
  * splitting on dimension.
  *
- * @param dimension A row from the training data, which might be a candidate for
- *      the splitting dimension.
+ * @param sortedIndexDim The stable sort of a row from the training data, which
+ *      might be a candidate for the splitting dimension.
  * @param UseWeights Whether we need to run a weighted Decision Stump.
  */
 template<typename MatType>
-template<bool UseWeights, typename VecType>
+template<bool UseWeights>
 double DecisionStump<MatType>::SetupSplitDimension(
-    const VecType& dimension,
+    const arma::uvec& sortedIndexDim,
     const arma::Row<size_t>& labels,
     const arma::rowvec& weights)
 {
   size_t i, count, begin, end;
   double entropy = 0.0;
 
-  // Store the indices of the sorted dimension to build a vector of sorted
-  // labels.  This sort is stable.
-  arma::uvec sortedIndexDim = arma::stable_sort_index(dimension.t());
-
-  arma::Row<size_t> sortedLabels(dimension.n_elem);
-  arma::rowvec sortedWeights(dimension.n_elem);
+  // Use the indices of the sorted dimension to build a vector of sorted
+  // labels.
+  arma::Row<size_t> sortedLabels(sortedIndexDim.n_elem);
+  arma::rowvec sortedWeights(sortedIndexDim.n_elem);
 
-  for (i = 0; i < dimension.n_elem; ++i)
+  for (i = 0; i < sortedIndexDim.n_elem; ++i)
   {
     sortedLabels(i) = labels(sortedIndexDim(i));
 
@@ -308,21 +381,25 @@ double DecisionStump<MatType>::SetupSplitDimension(
  *
  * @param dimension Dimension is the dimension decided by the constructor on
  *      which we now train the decision stump.
+ * @param sortedSplitIndexDim The stable sort of the dimension.
  */
 template<typename MatType>
 template<typename VecType>
 void DecisionStump<MatType>::TrainOnDim(const VecType& dimension,
+                                        const arma::uvec& sortedSplitIndexDim,
                                         const arma::Row<size_t>& labels)
 {
   size_t i, count, begin, end;
 
-  typename MatType::row_type sortedSplitDim = arma::sort(dimension);
-  arma::uvec sortedSplitIndexDim = arma::stable_sort_index(dimension.t());
+  typename MatType::row_type sortedSplitDim(dimension.n_elem);
   arma::Row<size_t> sortedLabels(dimension.n_elem);
   sortedLabels.fill(0);
 
   for (i = 0; i < dimension.n_elem; ++i)
+  {
+    sortedSplitDim(i) = dimension(sortedSplitIndexDim(i));
     sortedLabels(i) = labels(sortedSplitIndexDim(i));
+  }
 
   arma::rowvec subCols;
   double mostFreq;
@@ -437,22 +514,6 @@ double DecisionStump<MatType>::CountMostFreq(const VecType& subCols)
   return mostFreq;
 }
 
-/**
- * Returns 1 if all the values of featureRow are not the same.
- *
- * @param featureRow The dimension which is checked for identical values.
- */
-template<typename MatType>
-template<typename VecType>
-int DecisionStump<MatType>::IsDistinct(const VecType& featureRow)
-{
-  typename VecType::elem_type val = featureRow(0);
-  for (size_t i = 1; i < featureRow.n_elem; ++i)
-    if (val != featureRow(i))
-      return 1;
-  return 0;
-}
-
 /**
  * Calculate entropy of dimension.
  *
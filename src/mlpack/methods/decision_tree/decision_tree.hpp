@@ -17,13 +17,20 @@
 #include "gini_gain.hpp"
 #include "information_gain.hpp"
 #include "best_binary_numeric_split.hpp"
+#include "histogram_numeric_split.hpp"
+#include "histogram_bins.hpp"
+#include "numeric_split_traits.hpp"
 #include "all_categorical_split.hpp"
 #include "all_dimension_select.hpp"
+#include "dimension_selection_traits.hpp"
 #include <type_traits>
 
 namespace mlpack {
 namespace tree {
 
+// Forward declaration for the friend declaration of DecisionTree.
+class QuickScorer;
+
 /**
  * This class implements a generic decision tree learner.  Its behavior can be
  * controlled via its template arguments.
@@ -398,6 +405,190 @@ class DecisionTree :
                const std::enable_if_t<arma::is_arma_type<typename
                    std::remove_reference<WeightsType>::type>::value>* = 0);
 
+  /**
+   * Train the decision tree on the points of the given data selected by the
+   * given indices, without copying the data.  An index may appear several
+   * times (as in a bootstrap sample), in which case the point is used that many
+   * times.  This will overwrite the existing model.  The data may have numeric
+   * and categorical types, specified by the datasetInfo parameter.
+   *
+   * @param data Dataset to take the training points from.
+   * @param indices Indices of the training points in the dataset.
+   * @param datasetInfo Type information for each dimension.
+   * @param labels Labels for each point of the dataset.
+   * @param numClasses Number of classes in the dataset.
+   * @param minimumLeafSize Minimum number of points in each leaf node.
+   * @param minimumGainSplit Minimum gain for the node to split.
+   * @param maximumDepth Maximum depth for the tree.
+   * @param dimensionSelector Instantiated dimension selection policy.
+   * @return The final entropy of decision tree.
+   */
+  template<typename MatType>
+  double Train(const MatType& data,
+               const arma::uvec& indices,
+               const data::DatasetInfo& datasetInfo,
+               const arma::Row<size_t>& labels,
+               const size_t numClasses,
+               const size_t minimumLeafSize = 10,
+               const double minimumGainSplit = 1e-7,
+               const size_t maximumDepth = 0,
+               DimensionSelectionType dimensionSelector =
+                   DimensionSelectionType());
+
+  /**
+   * Train the decision tree on the points of the given data selected by the
+   * given indices, without copying the data, assuming that all dimensions are
+   * numeric.  An index may appear several times (as in a bootstrap sample), in
+   * which case the point is used that many times.  This will overwrite the
+   * existing model.
+   *
+   * @param data Dataset to take the training points from.
+   * @param indices Indices of the training points in the dataset.
+   * @param labels Labels for each point of the dataset.
+   * @param numClasses Number of classes in the dataset.
+   * @param minimumLeafSize Minimum number of points in each leaf node.
+   * @param minimumGainSplit Minimum gain for the node to split.
+   * @param maximumDepth Maximum depth for the tree.
+   * @param dimensionSelector Instantiated dimension selection policy.
+   * @return The final entropy of decision tree.
+   */
+  template<typename MatType>
+  double Train(const MatType& data,
+               const arma::uvec& indices,
+               const arma::Row<size_t>& labels,
+               const size_t numClasses,
+               const size_t minimumLeafSize = 10,
+               const double minimumGainSplit = 1e-7,
+               const size_t maximumDepth = 0,
+               DimensionSelectionType dimensionSelector =
+                   DimensionSelectionType());
+
+  /**
+   * Train the decision tree on the weighted points of the given data selected
+   * by the given indices, without copying the data.  An index may appear
+   * several times (as in a bootstrap sample), in which case the point is used
+   * that many times.  This will overwrite the existing model.  The data may
+   * have numeric and categorical types, specified by the datasetInfo
+   * parameter.
+   *
+   * @param data Dataset to take the training points from.
+   * @param indices Indices of the training points in the dataset.
+   * @param datasetInfo Type information for each dimension.
+   * @param labels Labels for each point of the dataset.
+   * @param numClasses Number of classes in the dataset.
+   * @param weights Weights of each point of the dataset.
+   * @param minimumLeafSize Minimum number of points in each leaf node.
+   * @param minimumGainSplit Minimum gain for the node to split.
+   * @param maximumDepth Maximum depth for the tree.
+   * @param dimensionSelector Instantiated dimension selection policy.
+   * @return The final entropy of decision tree.
+   */
+  template<typename MatType>
+  double Train(const MatType& data,
+               const arma::uvec& indices,
+               const data::DatasetInfo& datasetInfo,
+               const arma::Row<size_t>& labels,
+               const size_t numClasses,
+               const arma::rowvec& weights,
+               const size_t minimumLeafSize = 10,
+               const double minimumGainSplit = 1e-7,
+               const size_t maximumDepth = 0,
+               DimensionSelectionType dimensionSelector =
+                   DimensionSelectionType());
+
+  /**
+   * Train the decision tree on the weighted points of the given data selected
+   * by the given indices, without copying the data, assuming that all
+   * dimensions are numeric.  An index may appear several times (as in a
+   * bootstrap sample), in which case the point is used that many times.  This
+   * will overwrite the existing model.
+   *
+   * @param data Dataset to take the training points from.
+   * @param indices Indices of the training points in the dataset.
+   * @param labels Labels for each point of the dataset.
+   * @param numClasses Number of classes in the dataset.
+   * @param weights Weights of each point of the dataset.
+   * @param minimumLeafSize Minimum number of points in each leaf node.
+   * @param minimumGainSplit Minimum gain for the node to split.
+   * @param maximumDepth Maximum depth for the tree.
+   * @param dimensionSelector Instantiated dimension selection policy.
+   * @return The final entropy of decision tree.
+   */
+  template<typename MatType>
+  double Train(const MatType& data,
+               const arma::uvec& indices,
+               const arma::Row<size_t>& labels,
+               const size_t numClasses,
+               const arma::rowvec& weights,
+               const size_t minimumLeafSize = 10,
+               const double minimumGainSplit = 1e-7,
+               const size_t maximumDepth = 0,
+               DimensionSelectionType dimensionSelector =
+                   DimensionSelectionType());
+
+  /**
+   * Train the decision tree on the points of the given data selected by the
+   * given indices, assuming that all dimensions are numeric, and reusing the
+   * given bins of the data instead of binning it again.  This is how a
+   * RandomForest bins its dataset once for all of its trees.  The bins are
+   * only used if the numeric split type uses bins (see NumericSplitTraits).
+   * This will overwrite the existing model.
+   *
+   * @param data Dataset to take the training points from.
+   * @param indices Indices of the training points in the dataset.
+   * @param bins Bins of every point of the dataset.
+   * @param labels Labels for each point of the dataset.
+   * @param numClasses Number of classes in the dataset.
+   * @param minimumLeafSize Minimum number of points in each leaf node.
+   * @param minimumGainSplit Minimum gain for the node to split.
+   * @param maximumDepth Maximum depth for the tree.
+   * @param dimensionSelector Instantiated dimension selection policy.
+   * @return The final entropy of decision tree.
+   */
+  template<typename MatType>
+  double Train(const MatType& data,
+               const arma::uvec& indices,
+               const HistogramBins<ElemType>& bins,
+               const arma::Row<size_t>& labels,
+               const size_t numClasses,
+               const size_t minimumLeafSize = 10,
+               const double minimumGainSplit = 1e-7,
+               const size_t maximumDepth = 0,
+               DimensionSelectionType dimensionSelector =
+                   DimensionSelectionType());
+
+  /**
+   * Train the decision tree on the weighted points of the given data selected
+   * by the given indices, assuming that all dimensions are numeric, and reusing
+   * the given bins of the data instead of binning it again.  The bins are only
+   * used if the numeric split type uses bins (see NumericSplitTraits).  This
+   * will overwrite the existing model.
+   *
+   * @param data Dataset to take the training points from.
+   * @param indices Indices of the training points in the dataset.
+   * @param bins Bins of every point of the dataset.
+   * @param labels Labels for each point of the dataset.
+   * @param numClasses Number of classes in the dataset.
+   * @param weights Weights of each point of the dataset.
+   * @param minimumLeafSize Minimum number of points in each leaf node.
+   * @param minimumGainSplit Minimum gain for the node to split.
+   * @param maximumDepth Maximum depth for the tree.
+   * @param dimensionSelector Instantiated dimension selection policy.
+   * @return The final entropy of decision tree.
+   */
+  template<typename MatType>
+  double Train(const MatType& data,
+               const arma::uvec& indices,
+               const HistogramBins<ElemType>& bins,
+               const arma::Row<size_t>& labels,
+               const size_t numClasses,
+               const arma::rowvec& weights,
+               const size_t minimumLeafSize = 10,
+               const double minimumGainSplit = 1e-7,
+               const size_t maximumDepth = 0,
+               DimensionSelectionType dimensionSelector =
+                   DimensionSelectionType());
+
   /**
    * Classify the given point, using the entire tree.  The predicted label is
    * returned.
@@ -480,7 +671,28 @@ class DecisionTree :
    */
   size_t NumClasses() const;
 
+  /**
+   * Get or modify the minimum number of points a node must hold to be trained
+   * in parallel with OpenMP tasks: the candidate dimensions of the node are
+   * then evaluated as separate tasks, and if DimensionSelectionTraits marks the
+   * dimension selection policy as ParallelSafe, the children of the node are
+   * trained as separate tasks too.  Smaller nodes are trained serially.  The
+   * resulting tree is the same either way (up to floating-point rounding of the
+   * gains compared).  The setting is shared by all trees of this type.
+   */
+  static size_t& ParallelTrainThreshold()
+  {
+    static size_t threshold = 10000;
+    return threshold;
+  }
+
  private:
+  //! FlatDecisionTree copies the nodes of the tree.
+  template<typename TreeType>
+  friend class FlatDecisionTree;
+  //! QuickScorer copies the splits and the leaves of the tree.
+  friend class QuickScorer;
+
   //! The vector of children.
   std::vector<DecisionTree*> children;
   //! The dimension this node splits on.
@@ -504,6 +716,9 @@ class DecisionTree :
       NumericAuxiliarySplitInfo;
   typedef typename CategoricalSplit::template AuxiliarySplitInfo<ElemType>
       CategoricalAuxiliarySplitInfo;
+  //! Whether the numeric split type searches histograms of bins.
+  typedef std::integral_constant<bool,
+      NumericSplitTraits<NumericSplit>::UsesBins> UsesBinsType;
 
   /**
    * Calculate the class probabilities of the given labels.
@@ -516,10 +731,13 @@ class DecisionTree :
   /**
    * Corresponding to the public Train() method, this method is designed for
    * avoiding unnecessary copies during training.  This function is called to
-   * train children.
+   * train children.  The data is never modified: the indices of the training
+   * points, their labels and their weights are reordered instead, so that the
+   * points of each node are contiguous in them.
    *
    * @param data Dataset to train on.
-   * @param begin Index of the starting point in the dataset that belongs to
+   * @param indices Indices of the training points in the dataset.
+   * @param begin Index of the starting point in the indices that belongs to
    *      this node.
    * @param count Number of points in this node.
    * @param datasetInfo Type information for each dimension.
@@ -531,7 +749,8 @@ class DecisionTree :
    * @return The final entropy of decision tree.
    */
   template<bool UseWeights, typename MatType>
-  double Train(MatType& data,
+  double Train(const MatType& data,
+               arma::uvec& indices,
                const size_t begin,
                const size_t count,
                const data::DatasetInfo& datasetInfo,
@@ -546,10 +765,12 @@ class DecisionTree :
   /**
    * Corresponding to the public Train() method, this method is designed for
    * avoiding unnecessary copies during training.  This method is called for
-   * training children.
+   * training children.  The data is never modified: the indices of the
+   * training points, their labels and their weights are reordered instead.
    *
    * @param data Dataset to train on.
-   * @param begin Index of the starting point in the dataset that belongs to
+   * @param indices Indices of the training points in the dataset.
+   * @param begin Index of the starting point in the indices that belongs to
    *      this node.
    * @param count Number of points in this node.
    * @param labels Labels for each training point.
@@ -560,7 +781,8 @@ class DecisionTree :
    * @return The final entropy of decision tree.
    */
   template<bool UseWeights, typename MatType>
-  double Train(MatType& data,
+  double Train(const MatType& data,
+               arma::uvec& indices,
                const size_t begin,
                const size_t count,
                arma::Row<size_t>& labels,
@@ -570,6 +792,115 @@ class DecisionTree :
                const double minimumGainSplit,
                const size_t maximumDepth,
                DimensionSelectionType& dimensionSelector);
+
+  /**
+   * Train on the given bins of the data, assuming all dimensions are numeric:
+   * build the histogram of the points of the node, then grow the tree from
+   * it.  This is used if the numeric split type uses bins.
+   *
+   * @param data Dataset to train on.
+   * @param bins Bins of every point of the dataset.
+   * @param indices Indices of the training points in the dataset.
+   * @param begin Index of the starting point in the indices that belongs to
+   *      this node.
+   * @param count Number of points in this node.
+   * @param labels Labels for each training point.
+   * @param numClasses Number of classes in the dataset.
+   * @param minimumLeafSize Minimum number of points in each leaf node.
+   * @param minimumGainSplit Minimum gain for the node to split.
+   * @param maximumDepth Maximum depth for the tree.
+   * @return The final entropy of decision tree.
+   */
+  template<bool UseWeights, typename MatType>
+  double TrainBinned(const MatType& data,
+                     const HistogramBins<ElemType>& bins,
+                     arma::uvec& indices,
+                     const size_t begin,
+                     const size_t count,
+                     arma::Row<size_t>& labels,
+                     const size_t numClasses,
+                     arma::rowvec& weights,
+                     const size_t minimumLeafSize,
+                     const double minimumGainSplit,
+                     const size_t maximumDepth,
+                     DimensionSelectionType& dimensionSelector,
+                     const std::true_type& /* usesBins */);
+
+  /**
+   * If the numeric split type does not use bins, the bins are ignored and the
+   * tree is trained on the values of the data.
+   */
+  template<bool UseWeights, typename MatType>
+  double TrainBinned(const MatType& data,
+                     const HistogramBins<ElemType>& bins,
+                     arma::uvec& indices,
+                     const size_t begin,
+                     const size_t count,
+                     arma::Row<size_t>& labels,
+                     const size_t numClasses,
+                     arma::rowvec& weights,
+                     const size_t minimumLeafSize,
+                     const double minimumGainSplit,
+                     const size_t maximumDepth,
+                     DimensionSelectionType& dimensionSelector,
+                     const std::false_type& /* usesBins */);
+
+  /**
+   * Train the node on the given histogram of its points, and train its
+   * children recursively.  The histogram of each child is computed from the
+   * histogram of the node: only the histogram of the smaller child is built
+   * from its points, and the histogram of the larger child is the histogram of
+   * the node minus that one.  The histogram of the node is reused for the
+   * larger child, so it is modified.
+   *
+   * @param data Dataset to train on.
+   * @param bins Bins of every point of the dataset.
+   * @param binCounts Number of points of each class (rows) in each bin
+   *      (columns) of every dimension.
+   * @param binWeights Total weight of the points of each class in each bin of
+   *      every dimension; only used if UseWeights is true.
+   * @param indices Indices of the training points in the dataset.
+   * @param begin Index of the starting point in the indices that belongs to
+   *      this node.
+   * @param count Number of points in this node.
+   * @param labels Labels for each training point.
+   * @param numClasses Number of classes in the dataset.
+   * @param minimumLeafSize Minimum number of points in each leaf node.
+   * @param minimumGainSplit Minimum gain for the node to split.
+   * @param maximumDepth Maximum depth for the tree.
+   * @return The final entropy of decision tree.
+   */
+  template<bool UseWeights, typename MatType>
+  double TrainBinned(const MatType& data,
+                     const HistogramBins<ElemType>& bins,
+                     arma::Mat<size_t>& binCounts,
+                     arma::mat& binWeights,
+                     arma::uvec& indices,
+                     const size_t begin,
+                     const size_t count,
+                     arma::Row<size_t>& labels,
+                     const size_t numClasses,
+                     arma::rowvec& weights,
+                     const size_t minimumLeafSize,
+                     const double minimumGainSplit,
+                     const size_t maximumDepth,
+                     DimensionSelectionType& dimensionSelector);
+
+  /**
+   * Build the histogram of the given points in every dimension: the number of
+   * points of each class in each bin, and their total weight if UseWeights is
+   * true.
+   */
+  template<bool UseWeights>
+  static void BuildHistogram(const HistogramBins<ElemType>& bins,
+                             const arma::uvec& indices,
+                             const size_t begin,
+                             const size_t count,
+                             const arma::Row<size_t>& labels,
+                             const size_t numClasses,
+                             const arma::rowvec& weights,
+                             arma::Mat<size_t>& binCounts,
+                             arma::mat& binWeights);
 };
 
 /**
@@ -50,10 +50,14 @@ DecisionTree<FitnessFunction,
   // Set the correct dimensionality for the dimension selector.
   dimensionSelector.Dimensions() = tmpData.n_rows;
 
+  // The data is not modified; the points are reordered through their
+  // indices.
+  arma::uvec indices = arma::regspace<arma::uvec>(0, tmpData.n_cols - 1);
+
   // Pass off work to the Train() method.
   arma::rowvec weights; // Fake weights, not used.
-  Train<false>(tmpData, 0, tmpData.n_cols, datasetInfo, tmpLabels, numClasses,
-      weights, minimumLeafSize, minimumGainSplit, maximumDepth,
+  Train<false>(tmpData, indices, 0, tmpData.n_cols, datasetInfo, tmpLabels,
+      numClasses, weights, minimumLeafSize, minimumGainSplit, maximumDepth,
       dimensionSelector);
 }
 
@@ -89,10 +93,15 @@ DecisionTree<FitnessFunction,
   // Set the correct dimensionality for the dimension selector.
   dimensionSelector.Dimensions() = tmpData.n_rows;
 
+  // The data is not modified; the points are reordered through their
+  // indices.
+  arma::uvec indices = arma::regspace<arma::uvec>(0, tmpData.n_cols - 1);
+
   // Pass off work to the Train() method.
   arma::rowvec weights; // Fake weights, not used.
-  Train<false>(tmpData, 0, tmpData.n_cols, tmpLabels, numClasses, weights,
-      minimumLeafSize, minimumGainSplit, maximumDepth, dimensionSelector);
+  Train<false>(tmpData, indices, 0, tmpData.n_cols, tmpLabels, numClasses,
+      weights, minimumLeafSize, minimumGainSplit, maximumDepth,
+      dimensionSelector);
 }
 
 //! Construct and train with weights.
@@ -133,9 +142,13 @@ DecisionTree<FitnessFunction,
   // Set the correct dimensionality for the dimension selector.
   dimensionSelector.Dimensions() = tmpData.n_rows;
 
+  // The data is not modified; the points are reordered through their
+  // indices.
+  arma::uvec indices = arma::regspace<arma::uvec>(0, tmpData.n_cols - 1);
+
   // Pass off work to the weighted Train() method.
-  Train<true>(tmpData, 0, tmpData.n_cols, datasetInfo, tmpLabels, numClasses,
-      tmpWeights, minimumLeafSize, minimumGainSplit, maximumDepth,
+  Train<true>(tmpData, indices, 0, tmpData.n_cols, datasetInfo, tmpLabels,
+      numClasses, tmpWeights, minimumLeafSize, minimumGainSplit, maximumDepth,
       dimensionSelector);
 }
 
@@ -175,9 +188,13 @@ DecisionTree<FitnessFunction,
   TrueLabelsType tmpLabels(std::move(labels));
   TrueWeightsType tmpWeights(std::move(weights));
 
+  // The data is not modified; the points are reordered through their
+  // indices.
+  arma::uvec indices = arma::regspace<arma::uvec>(0, tmpData.n_cols - 1);
+
   // Pass off work to the weighted Train() method.
-  Train<true>(tmpData, 0, tmpData.n_cols, datasetInfo, tmpLabels, numClasses,
-              tmpWeights, minimumLeafSize, minimumGainSplit);
+  Train<true>(tmpData, indices, 0, tmpData.n_cols, datasetInfo, tmpLabels,
+              numClasses, tmpWeights, minimumLeafSize, minimumGainSplit);
 }
 
 //! Construct and train with weights.
@@ -219,9 +236,14 @@ DecisionTree<FitnessFunction,
   // Set the correct dimensionality for the dimension selector.
   dimensionSelector.Dimensions() = tmpData.n_rows;
 
+  // The data is not modified; the points are reordered through their
+  // indices.
+  arma::uvec indices = arma::regspace<arma::uvec>(0, tmpData.n_cols - 1);
+
   // Pass off work to the weighted Train() method.
-  Train<true>(tmpData, 0, tmpData.n_cols, tmpLabels, numClasses, tmpWeights,
-      minimumLeafSize, minimumGainSplit, maximumDepth, dimensionSelector);
+  Train<true>(tmpData, indices, 0, tmpData.n_cols, tmpLabels, numClasses,
+      tmpWeights, minimumLeafSize, minimumGainSplit, maximumDepth,
+      dimensionSelector);
 }
 
 //! Construct and train with weights.
@@ -265,9 +287,14 @@ DecisionTree<FitnessFunction,
   // Set the correct dimensionality for the dimension selector.
   dimensionSelector.Dimensions() = tmpData.n_rows;
 
+  // The data is not modified; the points are reordered through their
+  // indices.
+  arma::uvec indices = arma::regspace<arma::uvec>(0, tmpData.n_cols - 1);
+
   // Pass off work to the weighted Train() method.
-  Train<true>(tmpData, 0, tmpData.n_cols, tmpLabels, numClasses, tmpWeights,
-      minimumLeafSize, minimumGainSplit, maximumDepth, dimensionSelector);
+  Train<true>(tmpData, indices, 0, tmpData.n_cols, tmpLabels, numClasses,
+      tmpWeights, minimumLeafSize, minimumGainSplit, maximumDepth,
+      dimensionSelector);
 }
 
 //! Construct, don't train.
@@ -488,11 +515,15 @@ double DecisionTree<FitnessFunction,
   // Set the correct dimensionality for the dimension selector.
   dimensionSelector.Dimensions() = tmpData.n_rows;
 
+  // The data is not modified; the points are reordered through their
+  // indices.
+  arma::uvec indices = arma::regspace<arma::uvec>(0, tmpData.n_cols - 1);
+
   // Pass off work to the Train() method.
   arma::rowvec weights; // Fake weights, not used.
-  return Train<false>(tmpData, 0, tmpData.n_cols, datasetInfo, tmpLabels,
-      numClasses, weights, minimumLeafSize, minimumGainSplit, maximumDepth,
-      dimensionSelector);
+  return Train<false>(tmpData, indices, 0, tmpData.n_cols, datasetInfo,
+      tmpLabels, numClasses, weights, minimumLeafSize, minimumGainSplit,
+      maximumDepth, dimensionSelector);
 }
 
 //! Train on the given data, assuming all dimensions are numeric.
@@ -537,10 +568,14 @@ double DecisionTree<FitnessFunction,
   // Set the correct dimensionality for the dimension selector.
   dimensionSelector.Dimensions() = tmpData.n_rows;
 
+  // The data is not modified; the points are reordered through their
+  // indices.
+  arma::uvec indices = arma::regspace<arma::uvec>(0, tmpData.n_cols - 1);
+
   // Pass off work to the Train() method.
   arma::rowvec weights; // Fake weights, not used.
-  return Train<false>(tmpData, 0, tmpData.n_cols, tmpLabels, numClasses,
-      weights, minimumLeafSize, minimumGainSplit, maximumDepth,
+  return Train<false>(tmpData, indices, 0, tmpData.n_cols, tmpLabels,
+      numClasses, weights, minimumLeafSize, minimumGainSplit, maximumDepth,
       dimensionSelector);
 }
 
@@ -594,10 +629,14 @@ double DecisionTree<FitnessFunction,
   // Set the correct dimensionality for the dimension selector.
   dimensionSelector.Dimensions() = tmpData.n_rows;
 
+  // The data is not modified; the points are reordered through their
+  // indices.
+  arma::uvec indices = arma::regspace<arma::uvec>(0, tmpData.n_cols - 1);
+
   // Pass off work to the Train() method.
-  return Train<true>(tmpData, 0, tmpData.n_cols, datasetInfo, tmpLabels,
-      numClasses, tmpWeights, minimumLeafSize, minimumGainSplit, maximumDepth,
-      dimensionSelector);
+  return Train<true>(tmpData, indices, 0, tmpData.n_cols, datasetInfo,
+      tmpLabels, numClasses, tmpWeights, minimumLeafSize, minimumGainSplit,
+      maximumDepth, dimensionSelector);
 }
 
 //! Train on the given weighted data.
@@ -649,250 +688,901 @@ double DecisionTree<FitnessFunction,
   // Set the correct dimensionality for the dimension selector.
   dimensionSelector.Dimensions() = tmpData.n_rows;
 
+  // The data is not modified; the points are reordered through their
+  // indices.
+  arma::uvec indices = arma::regspace<arma::uvec>(0, tmpData.n_cols - 1);
+
   // Pass off work to the Train() method.
-  return Train<true>(tmpData, 0, tmpData.n_cols, tmpLabels, numClasses,
-      tmpWeights, minimumLeafSize, minimumGainSplit, maximumDepth,
+  return Train<true>(tmpData, indices, 0, tmpData.n_cols, tmpLabels,
+      numClasses, tmpWeights, minimumLeafSize, minimumGainSplit, maximumDepth,
       dimensionSelector);
 }
 
-//! Train on the given data, assuming all dimensions are numeric.
+//! Train on the points of the given data selected by the given indices.
 template<typename FitnessFunction,
          template<typename> class NumericSplitType,
          template<typename> class CategoricalSplitType,
          typename DimensionSelectionType,
          typename ElemType,
          bool NoRecursion>
-template<bool UseWeights, typename MatType>
+template<typename MatType>
 double DecisionTree<FitnessFunction,
                     NumericSplitType,
                     CategoricalSplitType,
                     DimensionSelectionType,
                     ElemType,
                     NoRecursion>::Train(
-    MatType& data,
-    const size_t begin,
-    const size_t count,
+    const MatType& data,
+    const arma::uvec& indices,
     const data::DatasetInfo& datasetInfo,
-    arma::Row<size_t>& labels,
+    const arma::Row<size_t>& labels,
     const size_t numClasses,
-    arma::rowvec& weights,
     const size_t minimumLeafSize,
     const double minimumGainSplit,
     const size_t maximumDepth,
-    DimensionSelectionType& dimensionSelector)
+    DimensionSelectionType dimensionSelector)
 {
-  // Clear children if needed.
-  for (size_t i = 0; i < children.size(); ++i)
-    delete children[i];
-  children.clear();
-
-  // Look through the list of dimensions and obtain the gain of the best split.
-  // We'll cache the best numeric and categorical split auxiliary information in
-  // numericAux and categoricalAux (and clear them later if we make no split),
-  // and use classProbabilities as auxiliary information.  Later we'll overwrite
-  // classProbabilities to the empirical class probabilities if we do not split.
-  double bestGain = FitnessFunction::template Evaluate<UseWeights>(
-      labels.subvec(begin, begin + count - 1),
-      numClasses,
-      UseWeights ? weights.subvec(begin, begin + count - 1) : weights);
-  size_t bestDim = datasetInfo.Dimensionality(); // This means "no split".
-  const size_t end = dimensionSelector.End();
-
-  if (maximumDepth != 1)
+  // Sanity check on data.
+  if (data.n_cols != labels.n_elem)
   {
-    for (size_t i = dimensionSelector.Begin(); i != end;
-         i = dimensionSelector.Next())
-    {
-      double dimGain = -DBL_MAX;
-      if (datasetInfo.Type(i) == data::Datatype::categorical)
-      {
-        dimGain = CategoricalSplit::template SplitIfBetter<UseWeights>(bestGain,
-            data.cols(begin, begin + count - 1).row(i),
-            datasetInfo.NumMappings(i),
-            labels.subvec(begin, begin + count - 1),
-            numClasses,
-            UseWeights ? weights.subvec(begin, begin + count - 1) : weights,
-            minimumLeafSize,
-            minimumGainSplit,
-            classProbabilities,
-            *this);
-      }
-      else if (datasetInfo.Type(i) == data::Datatype::numeric)
-      {
-        dimGain = NumericSplit::template SplitIfBetter<UseWeights>(bestGain,
-            data.cols(begin, begin + count - 1).row(i),
-            labels.subvec(begin, begin + count - 1),
-            numClasses,
-            UseWeights ? weights.subvec(begin, begin + count - 1) : weights,
-            minimumLeafSize,
-            minimumGainSplit,
-            classProbabilities,
-            *this);
-      }
-
-      // If the splitter reported that it did not split, move to the next
-      // dimension.
-      if (dimGain == DBL_MAX)
-        continue;
-
-      // Was there an improvement?  If so mark that it's the new best dimension.
-      bestDim = i;
-      bestGain = dimGain;
-
-      // If the gain is the best possible, no need to keep looking.
-      if (bestGain >= 0.0)
-        break;
-    }
+    std::ostringstream oss;
+    oss << "DecisionTree::Train(): number of points (" << data.n_cols << ") "
+        << "does not match number of labels (" << labels.n_elem << ")!"
+        << std::endl;
+    throw std::invalid_argument(oss.str());
   }
 
-  // Did we split or not?  If so, then split the data and create the children.
-  if (bestDim != datasetInfo.Dimensionality())
+  if (indices.n_elem > 0 && indices.max() >= data.n_cols)
   {
-    dimensionTypeOrMajorityClass = (size_t) datasetInfo.Type(bestDim);
-    splitDimension = bestDim;
-
-    // Get the number of children we will have.
-    size_t numChildren = 0;
-    if (datasetInfo.Type(bestDim) == data::Datatype::categorical)
-      numChildren = CategoricalSplit::NumChildren(classProbabilities, *this);
-    else
-      numChildren = NumericSplit::NumChildren(classProbabilities, *this);
-
-    // Calculate all child assignments.
-    arma::Row<size_t> childAssignments(count);
-    if (datasetInfo.Type(bestDim) == data::Datatype::categorical)
-    {
-      for (size_t j = begin; j < begin + count; ++j)
-        childAssignments[j - begin] = CategoricalSplit::CalculateDirection(
-            data(bestDim, j), classProbabilities, *this);
-    }
-    else
-    {
-      for (size_t j = begin; j < begin + count; ++j)
-      {
-        childAssignments[j - begin] = NumericSplit::CalculateDirection(
-            data(bestDim, j), classProbabilities, *this);
-      }
-    }
+    std::ostringstream oss;
+    oss << "DecisionTree::Train(): index " << indices.max() << " is out of "
+        << "bounds for a dataset of " << data.n_cols << " points!" << std::endl;
+    throw std::invalid_argument(oss.str());
+  }
 
-    // Figure out counts of children.
-    arma::Row<size_t> childCounts(numChildren, arma::fill::zeros);
-    for (size_t i = begin; i < begin + count; ++i)
-      childCounts[childAssignments[i - begin]]++;
+  // Only the indices of the training points and their labels (and weights)
+  // are copied.
+  arma::uvec tmpIndices(indices);
+  arma::Row<size_t> tmpLabels(indices.n_elem);
+  for (size_t i = 0; i < indices.n_elem; ++i)
+    tmpLabels[i] = labels[indices[i]];
 
-    // Initialize bestGain if recursive split is allowed.
-    if (!NoRecursion)
-    {
-      bestGain = 0.0;
-    }
+  // Set the correct dimensionality for the dimension selector.
+  dimensionSelector.Dimensions() = data.n_rows;
 
-    // Split into children.
-    size_t currentCol = begin;
-    for (size_t i = 0; i < numChildren; ++i)
-    {
-      size_t currentChildBegin = currentCol;
-      for (size_t j = currentChildBegin; j < begin + count; ++j)
-      {
-        if (childAssignments[j - begin] == i)
-        {
-          childAssignments.swap_cols(currentCol - begin, j - begin);
-          data.swap_cols(currentCol, j);
-          labels.swap_cols(currentCol, j);
-          if (UseWeights)
-            weights.swap_cols(currentCol, j);
-          ++currentCol;
-        }
-      }
+  // Pass off work to the Train() method.
+  arma::rowvec weights; // Fake weights, not used.
+  return Train<false>(data, tmpIndices, 0, tmpIndices.n_elem, datasetInfo,
+      tmpLabels, numClasses, weights, minimumLeafSize, minimumGainSplit,
+      maximumDepth, dimensionSelector);
+}
 
-      // Now build the child recursively.
-      DecisionTree* child = new DecisionTree();
-      if (NoRecursion)
-      {
-        child->Train<UseWeights>(data, currentChildBegin,
-            currentCol - currentChildBegin, datasetInfo, labels, numClasses,
-            weights, currentCol - currentChildBegin, minimumGainSplit,
-            maximumDepth - 1, dimensionSelector);
-      }
-      else
-      {
-        // During recursion entropy of child node may change.
-        double childGain = child->Train<UseWeights>(data, currentChildBegin,
-            currentCol - currentChildBegin, datasetInfo, labels, numClasses,
-            weights, minimumLeafSize, minimumGainSplit, maximumDepth - 1,
-            dimensionSelector);
-        bestGain += double(childCounts[i]) / double(count) * (-childGain);
-      }
-      children.push_back(child);
-    }
-  }
-  else
+//! Train on the points of the given data selected by the given indices,
+//! assuming all dimensions are numeric.
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DimensionSelectionType,
+         typename ElemType,
+         bool NoRecursion>
+template<typename MatType>
+double DecisionTree<FitnessFunction,
+                    NumericSplitType,
+                    CategoricalSplitType,
+                    DimensionSelectionType,
+                    ElemType,
+                    NoRecursion>::Train(
+    const MatType& data,
+    const arma::uvec& indices,
+    const arma::Row<size_t>& labels,
+    const size_t numClasses,
+    const size_t minimumLeafSize,
+    const double minimumGainSplit,
+    const size_t maximumDepth,
+    DimensionSelectionType dimensionSelector)
+{
+  // Sanity check on data.
+  if (data.n_cols != labels.n_elem)
   {
-    // Clear auxiliary info objects.
-    NumericAuxiliarySplitInfo::operator=(NumericAuxiliarySplitInfo());
-    CategoricalAuxiliarySplitInfo::operator=(CategoricalAuxiliarySplitInfo());
+    std::ostringstream oss;
+    oss << "DecisionTree::Train(): number of points (" << data.n_cols << ") "
+        << "does not match number of labels (" << labels.n_elem << ")!"
+        << std::endl;
+    throw std::invalid_argument(oss.str());
+  }
 
-    // Calculate class probabilities because we are a leaf.
-    CalculateClassProbabilities<UseWeights>(
-        labels.subvec(begin, begin + count - 1),
-        numClasses,
-        UseWeights ? weights.subvec(begin, begin + count - 1) : weights);
+  if (indices.n_elem > 0 && indices.max() >= data.n_cols)
+  {
+    std::ostringstream oss;
+    oss << "DecisionTree::Train(): index " << indices.max() << " is out of "
+        << "bounds for a dataset of " << data.n_cols << " points!" << std::endl;
+    throw std::invalid_argument(oss.str());
   }
 
-  return -bestGain;
+  // Only the indices of the training points and their labels (and weights)
+  // are copied.
+  arma::uvec tmpIndices(indices);
+  arma::Row<size_t> tmpLabels(indices.n_elem);
+  for (size_t i = 0; i < indices.n_elem; ++i)
+    tmpLabels[i] = labels[indices[i]];
+
+  // Set the correct dimensionality for the dimension selector.
+  dimensionSelector.Dimensions() = data.n_rows;
+
+  // Pass off work to the Train() method.
+  arma::rowvec weights; // Fake weights, not used.
+  return Train<false>(data, tmpIndices, 0, tmpIndices.n_elem, tmpLabels,
+      numClasses, weights, minimumLeafSize, minimumGainSplit, maximumDepth,
+      dimensionSelector);
 }
 
-//! Train on the given data, assuming all dimensions are numeric.
+//! Train on the weighted points of the given data selected by the given
+//! indices.
 template<typename FitnessFunction,
          template<typename> class NumericSplitType,
          template<typename> class CategoricalSplitType,
          typename DimensionSelectionType,
          typename ElemType,
          bool NoRecursion>
-template<bool UseWeights, typename MatType>
+template<typename MatType>
 double DecisionTree<FitnessFunction,
                     NumericSplitType,
                     CategoricalSplitType,
                     DimensionSelectionType,
                     ElemType,
                     NoRecursion>::Train(
-    MatType& data,
-    const size_t begin,
-    const size_t count,
-    arma::Row<size_t>& labels,
+    const MatType& data,
+    const arma::uvec& indices,
+    const data::DatasetInfo& datasetInfo,
+    const arma::Row<size_t>& labels,
     const size_t numClasses,
-    arma::rowvec& weights,
+    const arma::rowvec& weights,
     const size_t minimumLeafSize,
     const double minimumGainSplit,
     const size_t maximumDepth,
-    DimensionSelectionType& dimensionSelector)
+    DimensionSelectionType dimensionSelector)
 {
-  // Clear children if needed.
-  for (size_t i = 0; i < children.size(); ++i)
-    delete children[i];
-  children.clear();
-
-  // We won't be using these members, so reset them.
-  CategoricalAuxiliarySplitInfo::operator=(CategoricalAuxiliarySplitInfo());
+  // Sanity check on data.
+  if (data.n_cols != labels.n_elem)
+  {
+    std::ostringstream oss;
+    oss << "DecisionTree::Train(): number of points (" << data.n_cols << ") "
+        << "does not match number of labels (" << labels.n_elem << ")!"
+        << std::endl;
+    throw std::invalid_argument(oss.str());
+  }
 
-  // Look through the list of dimensions and obtain the best split.  We'll cache
-  // the best numeric split auxiliary information in numericAux (and clear it
-  // later if we don't make a split), and use classProbabilities as auxiliary
-  // information.  Later we'll overwrite classProbabilities to the empirical
-  // class probabilities if we do not split.
-  double bestGain = FitnessFunction::template Evaluate<UseWeights>(
-      labels.subvec(begin, begin + count - 1),
-      numClasses,
-      UseWeights ? weights.subvec(begin, begin + count - 1) : weights);
-  size_t bestDim = data.n_rows; // This means "no split".
+  if (data.n_cols != weights.n_elem)
+  {
+    std::ostringstream oss;
+    oss << "DecisionTree::Train(): number of points (" << data.n_cols << ") "
+        << "does not match number of weights (" << weights.n_elem << ")!"
+        << std::endl;
+    throw std::invalid_argument(oss.str());
+  }
 
-  if (maximumDepth != 1)
+  if (indices.n_elem > 0 && indices.max() >= data.n_cols)
+  {
+    std::ostringstream oss;
+    oss << "DecisionTree::Train(): index " << indices.max() << " is out of "
+        << "bounds for a dataset of " << data.n_cols << " points!" << std::endl;
+    throw std::invalid_argument(oss.str());
+  }
+
+  // Only the indices of the training points and their labels (and weights)
+  // are copied.
+  arma::uvec tmpIndices(indices);
+  arma::Row<size_t> tmpLabels(indices.n_elem);
+  for (size_t i = 0; i < indices.n_elem; ++i)
+    tmpLabels[i] = labels[indices[i]];
+  arma::rowvec tmpWeights(indices.n_elem);
+  for (size_t i = 0; i < indices.n_elem; ++i)
+    tmpWeights[i] = weights[indices[i]];
+
+  // Set the correct dimensionality for the dimension selector.
+  dimensionSelector.Dimensions() = data.n_rows;
+
+  // Pass off work to the weighted Train() method.
+  return Train<true>(data, tmpIndices, 0, tmpIndices.n_elem, datasetInfo,
+      tmpLabels, numClasses, tmpWeights, minimumLeafSize, minimumGainSplit,
+      maximumDepth, dimensionSelector);
+}
+
+//! Train on the weighted points of the given data selected by the given
+//! indices, assuming all dimensions are numeric.
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DimensionSelectionType,
+         typename ElemType,
+         bool NoRecursion>
+template<typename MatType>
+double DecisionTree<FitnessFunction,
+                    NumericSplitType,
+                    CategoricalSplitType,
+                    DimensionSelectionType,
+                    ElemType,
+                    NoRecursion>::Train(
+    const MatType& data,
+    const arma::uvec& indices,
+    const arma::Row<size_t>& labels,
+    const size_t numClasses,
+    const arma::rowvec& weights,
+    const size_t minimumLeafSize,
+    const double minimumGainSplit,
+    const size_t maximumDepth,
+    DimensionSelectionType dimensionSelector)
+{
+  // Sanity check on data.
+  if (data.n_cols != labels.n_elem)
+  {
+    std::ostringstream oss;
+    oss << "DecisionTree::Train(): number of points (" << data.n_cols << ") "
+        << "does not match number of labels (" << labels.n_elem << ")!"
+        << std::endl;
+    throw std::invalid_argument(oss.str());
+  }
+
+  if (data.n_cols != weights.n_elem)
+  {
+    std::ostringstream oss;
+    oss << "DecisionTree::Train(): number of points (" << data.n_cols << ") "
+        << "does not match number of weights (" << weights.n_elem << ")!"
+        << std::endl;
+    throw std::invalid_argument(oss.str());
+  }
+
+  if (indices.n_elem > 0 && indices.max() >= data.n_cols)
+  {
+    std::ostringstream oss;
+    oss << "DecisionTree::Train(): index " << indices.max() << " is out of "
+        << "bounds for a dataset of " << data.n_cols << " points!" << std::endl;
+    throw std::invalid_argument(oss.str());
+  }
+
+  // Only the indices of the training points and their labels (and weights)
+  // are copied.
+  arma::uvec tmpIndices(indices);
+  arma::Row<size_t> tmpLabels(indices.n_elem);
+  for (size_t i = 0; i < indices.n_elem; ++i)
+    tmpLabels[i] = labels[indices[i]];
+  arma::rowvec tmpWeights(indices.n_elem);
+  for (size_t i = 0; i < indices.n_elem; ++i)
+    tmpWeights[i] = weights[indices[i]];
+
+  // Set the correct dimensionality for the dimension selector.
+  dimensionSelector.Dimensions() = data.n_rows;
+
+  // Pass off work to the weighted Train() method.
+  return Train<true>(data, tmpIndices, 0, tmpIndices.n_elem, tmpLabels,
+      numClasses, tmpWeights, minimumLeafSize, minimumGainSplit, maximumDepth,
+      dimensionSelector);
+}
+
+//! Train on the points of the given data selected by the given indices,
+//! assuming all dimensions are numeric, with the given bins of the data.
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DimensionSelectionType,
+         typename ElemType,
+         bool NoRecursion>
+template<typename MatType>
+double DecisionTree<FitnessFunction,
+                    NumericSplitType,
+                    CategoricalSplitType,
+                    DimensionSelectionType,
+                    ElemType,
+                    NoRecursion>::Train(
+    const MatType& data,
+    const arma::uvec& indices,
+    const HistogramBins<ElemType>& bins,
+    const arma::Row<size_t>& labels,
+    const size_t numClasses,
+    const size_t minimumLeafSize,
+    const double minimumGainSplit,
+    const size_t maximumDepth,
+    DimensionSelectionType dimensionSelector)
+{
+  // Sanity check on data.
+  if (data.n_cols != labels.n_elem)
+  {
+    std::ostringstream oss;
+    oss << "DecisionTree::Train(): number of points (" << data.n_cols << ") "
+        << "does not match number of labels (" << labels.n_elem << ")!"
+        << std::endl;
+    throw std::invalid_argument(oss.str());
+  }
+
+  if (bins.NumPoints() != data.n_cols || bins.Dimensionality() != data.n_rows)
+  {
+    std::ostringstream oss;
+    oss << "DecisionTree::Train(): the bins of " << bins.NumPoints()
+        << " points in " << bins.Dimensionality() << " dimensions do not "
+        << "match the dataset of " << data.n_cols << " points in "
+        << data.n_rows << " dimensions!" << std::endl;
+    throw std::invalid_argument(oss.str());
+  }
+
+  if (indices.n_elem > 0 && indices.max() >= data.n_cols)
+  {
+    std::ostringstream oss;
+    oss << "DecisionTree::Train(): index " << indices.max() << " is out of "
+        << "bounds for a dataset of " << data.n_cols << " points!" << std::endl;
+    throw std::invalid_argument(oss.str());
+  }
+
+  // Only the indices of the training points and their labels (and weights)
+  // are copied.
+  arma::uvec tmpIndices(indices);
+  arma::Row<size_t> tmpLabels(indices.n_elem);
+  for (size_t i = 0; i < indices.n_elem; ++i)
+    tmpLabels[i] = labels[indices[i]];
+
+  // Set the correct dimensionality for the dimension selector.
+  dimensionSelector.Dimensions() = data.n_rows;
+
+  // Pass off work to the Train() method.
+  arma::rowvec weights; // Fake weights, not used.
+  return TrainBinned<false>(data, bins, tmpIndices, 0, tmpIndices.n_elem,
+      tmpLabels, numClasses, weights, minimumLeafSize, minimumGainSplit,
+      maximumDepth, dimensionSelector, UsesBinsType());
+}
+
+//! Train on the weighted points of the given data selected by the given
+//! indices, assuming all dimensions are numeric, with the given bins of the
+//! data.
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DimensionSelectionType,
+         typename ElemType,
+         bool NoRecursion>
+template<typename MatType>
+double DecisionTree<FitnessFunction,
+                    NumericSplitType,
+                    CategoricalSplitType,
+                    DimensionSelectionType,
+                    ElemType,
+                    NoRecursion>::Train(
+    const MatType& data,
+    const arma::uvec& indices,
+    const HistogramBins<ElemType>& bins,
+    const arma::Row<size_t>& labels,
+    const size_t numClasses,
+    const arma::rowvec& weights,
+    const size_t minimumLeafSize,
+    const double minimumGainSplit,
+    const size_t maximumDepth,
+    DimensionSelectionType dimensionSelector)
+{
+  // Sanity check on data.
+  if (data.n_cols != labels.n_elem)
+  {
+    std::ostringstream oss;
+    oss << "DecisionTree::Train(): number of points (" << data.n_cols << ") "
+        << "does not match number of labels (" << labels.n_elem << ")!"
+        << std::endl;
+    throw std::invalid_argument(oss.str());
+  }
+
+  if (data.n_cols != weights.n_elem)
+  {
+    std::ostringstream oss;
+    oss << "DecisionTree::Train(): number of points (" << data.n_cols << ") "
+        << "does not match number of weights (" << weights.n_elem << ")!"
+        << std::endl;
+    throw std::invalid_argument(oss.str());
+  }
+
+  if (bins.NumPoints() != data.n_cols || bins.Dimensionality() != data.n_rows)
+  {
+    std::ostringstream oss;
+    oss << "DecisionTree::Train(): the bins of " << bins.NumPoints()
+        << " points in " << bins.Dimensionality() << " dimensions do not "
+        << "match the dataset of " << data.n_cols << " points in "
+        << data.n_rows << " dimensions!" << std::endl;
+    throw std::invalid_argument(oss.str());
+  }
+
+  if (indices.n_elem > 0 && indices.max() >= data.n_cols)
+  {
+    std::ostringstream oss;
+    oss << "DecisionTree::Train(): index " << indices.max() << " is out of "
+        << "bounds for a dataset of " << data.n_cols << " points!" << std::endl;
+    throw std::invalid_argument(oss.str());
+  }
+
+  // Only the indices of the training points and their labels (and weights)
+  // are copied.
+  arma::uvec tmpIndices(indices);
+  arma::Row<size_t> tmpLabels(indices.n_elem);
+  for (size_t i = 0; i < indices.n_elem; ++i)
+    tmpLabels[i] = labels[indices[i]];
+  arma::rowvec tmpWeights(indices.n_elem);
+  for (size_t i = 0; i < indices.n_elem; ++i)
+    tmpWeights[i] = weights[indices[i]];
+
+  // Set the correct dimensionality for the dimension selector.
+  dimensionSelector.Dimensions() = data.n_rows;
+
+  // Pass off work to the weighted Train() method.
+  return TrainBinned<true>(data, bins, tmpIndices, 0, tmpIndices.n_elem,
+      tmpLabels, numClasses, tmpWeights, minimumLeafSize, minimumGainSplit,
+      maximumDepth, dimensionSelector, UsesBinsType());
+}
+
+//! Train on the given data, assuming all dimensions are numeric.
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DimensionSelectionType,
+         typename ElemType,
+         bool NoRecursion>
+template<bool UseWeights, typename MatType>
+double DecisionTree<FitnessFunction,
+                    NumericSplitType,
+                    CategoricalSplitType,
+                    DimensionSelectionType,
+                    ElemType,
+                    NoRecursion>::Train(
+    const MatType& data,
+    arma::uvec& indices,
+    const size_t begin,
+    const size_t count,
+    const data::DatasetInfo& datasetInfo,
+    arma::Row<size_t>& labels,
+    const size_t numClasses,
+    arma::rowvec& weights,
+    const size_t minimumLeafSize,
+    const double minimumGainSplit,
+    const size_t maximumDepth,
+    DimensionSelectionType& dimensionSelector)
+{
+  #ifdef HAS_OPENMP
+  // The first large node opens the parallel region (unless the tree is being
+  // trained inside one already); the tasks of all of its descendants are then
+  // run by the threads of that region.
+  if (count >= ParallelTrainThreshold() && omp_get_level() == 0 &&
+      omp_get_max_threads() > 1)
+  {
+    double gain = 0.0;
+    #pragma omp parallel
+    {
+      #pragma omp single
+      gain = Train<UseWeights>(data, indices, begin, count, datasetInfo,
+          labels, numClasses, weights, minimumLeafSize, minimumGainSplit,
+          maximumDepth, dimensionSelector);
+    }
+    return gain;
+  }
+  #endif
+
+  // Clear children if needed.
+  for (size_t i = 0; i < children.size(); ++i)
+    delete children[i];
+  children.clear();
+
+  // Look through the list of dimensions and obtain the gain of the best split.
+  // We'll cache the best numeric and categorical split auxiliary information in
+  // numericAux and categoricalAux (and clear them later if we make no split),
+  // and use classProbabilities as auxiliary information.  Later we'll overwrite
+  // classProbabilities to the empirical class probabilities if we do not split.
+  double bestGain = FitnessFunction::template Evaluate<UseWeights>(
+      labels.subvec(begin, begin + count - 1),
+      numClasses,
+      UseWeights ? weights.subvec(begin, begin + count - 1) : weights);
+  size_t bestDim = datasetInfo.Dimensionality(); // This means "no split".
+  const size_t end = dimensionSelector.End();
+
+  if (maximumDepth != 1 && count >= ParallelTrainThreshold())
+  {
+    // Evaluate each candidate dimension as a separate task against the gain of
+    // the node, then go through the results in the order the dimensions were
+    // selected and keep a split only if it beats the best split so far, like
+    // the serial search below does.
+    std::vector<size_t> dimensions;
+    for (size_t i = dimensionSelector.Begin(); i != end;
+         i = dimensionSelector.Next())
+      dimensions.push_back(i);
+
+    const double nodeGain = bestGain;
+    std::vector<double> gains(dimensions.size(), DBL_MAX);
+    std::vector<arma::vec> splitInfo(dimensions.size());
+    std::vector<NumericAuxiliarySplitInfo> numericAux(dimensions.size());
+    std::vector<CategoricalAuxiliarySplitInfo> categoricalAux(
+        dimensions.size());
+    for (size_t k = 0; k < dimensions.size(); ++k)
+    {
+      #pragma omp task default(shared) firstprivate(k)
+      {
+        const size_t i = dimensions[k];
+        // Collect the values of the points of the node in this dimension.
+        arma::Row<typename MatType::elem_type> values(count);
+        for (size_t j = 0; j < count; ++j)
+          values[j] = data(i, indices[begin + j]);
+
+        if (datasetInfo.Type(i) == data::Datatype::categorical)
+        {
+          gains[k] = CategoricalSplit::template SplitIfBetter<UseWeights>(
+              nodeGain,
+              values,
+              datasetInfo.NumMappings(i),
+              labels.subvec(begin, begin + count - 1),
+              numClasses,
+              UseWeights ? weights.subvec(begin, begin + count - 1) : weights,
+              minimumLeafSize,
+              minimumGainSplit,
+              splitInfo[k],
+              categoricalAux[k]);
+        }
+        else if (datasetInfo.Type(i) == data::Datatype::numeric)
+        {
+          gains[k] = NumericSplit::template SplitIfBetter<UseWeights>(
+              nodeGain,
+              values,
+              labels.subvec(begin, begin + count - 1),
+              numClasses,
+              UseWeights ? weights.subvec(begin, begin + count - 1) : weights,
+              minimumLeafSize,
+              minimumGainSplit,
+              splitInfo[k],
+              numericAux[k]);
+        }
+      }
+    }
+    #pragma omp taskwait
+
+    size_t best = dimensions.size();
+    for (size_t k = 0; k < dimensions.size(); ++k)
+    {
+      // The splitter only reports splits better than the given gain by at
+      // least minimumGainSplit (or with the best possible gain).
+      if (gains[k] == DBL_MAX || !(gains[k] >= 0.0 ||
+          gains[k] > std::min(bestGain + minimumGainSplit, 0.0)))
+        continue;
+
+      best = k;
+      bestDim = dimensions[k];
+      bestGain = gains[k];
+
+      // If the gain is the best possible, no need to keep looking.
+      if (bestGain >= 0.0)
+        break;
+    }
+
+    if (best != dimensions.size())
+    {
+      classProbabilities = std::move(splitInfo[best]);
+      if (datasetInfo.Type(bestDim) == data::Datatype::categorical)
+        CategoricalAuxiliarySplitInfo::operator=(categoricalAux[best]);
+      else
+        NumericAuxiliarySplitInfo::operator=(numericAux[best]);
+    }
+  }
+  else if (maximumDepth != 1)
+  {
+    for (size_t i = dimensionSelector.Begin(); i != end;
+         i = dimensionSelector.Next())
+    {
+      // Collect the values of the points of the node in this dimension.
+      arma::Row<typename MatType::elem_type> values(count);
+      for (size_t j = 0; j < count; ++j)
+        values[j] = data(i, indices[begin + j]);
+
+      double dimGain = -DBL_MAX;
+      if (datasetInfo.Type(i) == data::Datatype::categorical)
+      {
+        dimGain = CategoricalSplit::template SplitIfBetter<UseWeights>(bestGain,
+            values,
+            datasetInfo.NumMappings(i),
+            labels.subvec(begin, begin + count - 1),
+            numClasses,
+            UseWeights ? weights.subvec(begin, begin + count - 1) : weights,
+            minimumLeafSize,
+            minimumGainSplit,
+            classProbabilities,
+            *this);
+      }
+      else if (datasetInfo.Type(i) == data::Datatype::numeric)
+      {
+        dimGain = NumericSplit::template SplitIfBetter<UseWeights>(bestGain,
+            values,
+            labels.subvec(begin, begin + count - 1),
+            numClasses,
+            UseWeights ? weights.subvec(begin, begin + count - 1) : weights,
+            minimumLeafSize,
+            minimumGainSplit,
+            classProbabilities,
+            *this);
+      }
+
+      // If the splitter reported that it did not split, move to the next
+      // dimension.
+      if (dimGain == DBL_MAX)
+        continue;
+
+      // Was there an improvement?  If so mark that it's the new best dimension.
+      bestDim = i;
+      bestGain = dimGain;
+
+      // If the gain is the best possible, no need to keep looking.
+      if (bestGain >= 0.0)
+        break;
+    }
+  }
+
+  // Did we split or not?  If so, then split the data and create the children.
+  if (bestDim != datasetInfo.Dimensionality())
+  {
+    dimensionTypeOrMajorityClass = (size_t) datasetInfo.Type(bestDim);
+    splitDimension = bestDim;
+
+    // Get the number of children we will have.
+    size_t numChildren = 0;
+    if (datasetInfo.Type(bestDim) == data::Datatype::categorical)
+      numChildren = CategoricalSplit::NumChildren(classProbabilities, *this);
+    else
+      numChildren = NumericSplit::NumChildren(classProbabilities, *this);
+
+    // Calculate all child assignments.
+    arma::Row<size_t> childAssignments(count);
+    if (datasetInfo.Type(bestDim) == data::Datatype::categorical)
+    {
+      for (size_t j = begin; j < begin + count; ++j)
+        childAssignments[j - begin] = CategoricalSplit::CalculateDirection(
+            data(bestDim, indices[j]), classProbabilities, *this);
+    }
+    else
+    {
+      for (size_t j = begin; j < begin + count; ++j)
+      {
+        childAssignments[j - begin] = NumericSplit::CalculateDirection(
+            data(bestDim, indices[j]), classProbabilities, *this);
+      }
+    }
+
+    // Figure out counts of children.
+    arma::Row<size_t> childCounts(numChildren, arma::fill::zeros);
+    for (size_t i = begin; i < begin + count; ++i)
+      childCounts[childAssignments[i - begin]]++;
+
+    // Initialize bestGain if recursive split is allowed.
+    if (!NoRecursion)
+    {
+      bestGain = 0.0;
+    }
+
+    // Split into children.
+    std::vector<size_t> childBegins(numChildren + 1);
+    size_t currentCol = begin;
+    for (size_t i = 0; i < numChildren; ++i)
+    {
+      childBegins[i] = currentCol;
+      for (size_t j = currentCol; j < begin + count; ++j)
+      {
+        if (childAssignments[j - begin] == i)
+        {
+          childAssignments.swap_cols(currentCol - begin, j - begin);
+          indices.swap_rows(currentCol, j);
+          labels.swap_cols(currentCol, j);
+          if (UseWeights)
+            weights.swap_cols(currentCol, j);
+          ++currentCol;
+        }
+      }
+    }
+    childBegins[numChildren] = currentCol;
+
+    // Now build the children recursively.  They work on disjoint column ranges
+    // of the data, so the children of a large node are trained as separate
+    // tasks if the dimension selection policy allows it, each with its own
+    // copy of the policy.
+    const bool parallel =
+        DimensionSelectionTraits<DimensionSelectionType>::ParallelSafe &&
+        count >= ParallelTrainThreshold();
+    children.resize(numChildren);
+    std::vector<double> childGains(numChildren, 0.0);
+    for (size_t i = 0; i < numChildren; ++i)
+    {
+      #pragma omp task if (parallel) default(shared) firstprivate(i)
+      {
+        const size_t childBegin = childBegins[i];
+        const size_t childCount = childBegins[i + 1] - childBegins[i];
+        DimensionSelectionType childSelector(dimensionSelector);
+        DimensionSelectionType& selector = parallel ? childSelector :
+            dimensionSelector;
+
+        children[i] = new DecisionTree();
+        if (NoRecursion)
+        {
+          children[i]->Train<UseWeights>(data, indices, childBegin,
+              childCount, datasetInfo, labels, numClasses, weights, childCount,
+              minimumGainSplit, maximumDepth - 1, selector);
+        }
+        else
+        {
+          // During recursion entropy of child node may change.
+          childGains[i] = children[i]->Train<UseWeights>(data, indices,
+              childBegin, childCount, datasetInfo, labels, numClasses, weights,
+              minimumLeafSize, minimumGainSplit, maximumDepth - 1, selector);
+        }
+      }
+    }
+    #pragma omp taskwait
+
+    if (!NoRecursion)
+    {
+      for (size_t i = 0; i < numChildren; ++i)
+        bestGain += double(childCounts[i]) / double(count) * (-childGains[i]);
+    }
+  }
+  else
+  {
+    // Clear auxiliary info objects.
+    NumericAuxiliarySplitInfo::operator=(NumericAuxiliarySplitInfo());
+    CategoricalAuxiliarySplitInfo::operator=(CategoricalAuxiliarySplitInfo());
+
+    // Calculate class probabilities because we are a leaf.
+    CalculateClassProbabilities<UseWeights>(
+        labels.subvec(begin, begin + count - 1),
+        numClasses,
+        UseWeights ? weights.subvec(begin, begin + count - 1) : weights);
+  }
+
+  return -bestGain;
+}
+
+//! Train on the given data, assuming all dimensions are numeric.
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DimensionSelectionType,
+         typename ElemType,
+         bool NoRecursion>
+template<bool UseWeights, typename MatType>
+double DecisionTree<FitnessFunction,
+                    NumericSplitType,
+                    CategoricalSplitType,
+                    DimensionSelectionType,
+                    ElemType,
+                    NoRecursion>::Train(
+    const MatType& data,
+    arma::uvec& indices,
+    const size_t begin,
+    const size_t count,
+    arma::Row<size_t>& labels,
+    const size_t numClasses,
+    arma::rowvec& weights,
+    const size_t minimumLeafSize,
+    const double minimumGainSplit,
+    const size_t maximumDepth,
+    DimensionSelectionType& dimensionSelector)
+{
+  // If the numeric split type searches histograms, bin every dimension once
+  // and train the whole tree on the bins.
+  if (UsesBinsType::value)
+  {
+    const HistogramBins<ElemType> bins(data,
+        indices.subvec(begin, begin + count - 1));
+    return TrainBinned<UseWeights>(data, bins, indices, begin, count, labels,
+        numClasses, weights, minimumLeafSize, minimumGainSplit, maximumDepth,
+        dimensionSelector, UsesBinsType());
+  }
+
+  #ifdef HAS_OPENMP
+  // The first large node opens the parallel region (unless the tree is being
+  // trained inside one already); the tasks of all of its descendants are then
+  // run by the threads of that region.
+  if (count >= ParallelTrainThreshold() && omp_get_level() == 0 &&
+      omp_get_max_threads() > 1)
+  {
+    double gain = 0.0;
+    #pragma omp parallel
+    {
+      #pragma omp single
+      gain = Train<UseWeights>(data, indices, begin, count, labels,
+          numClasses, weights, minimumLeafSize, minimumGainSplit, maximumDepth,
+          dimensionSelector);
+    }
+    return gain;
+  }
+  #endif
+
+  // Clear children if needed.
+  for (size_t i = 0; i < children.size(); ++i)
+    delete children[i];
+  children.clear();
+
+  // We won't be using these members, so reset them.
+  CategoricalAuxiliarySplitInfo::operator=(CategoricalAuxiliarySplitInfo());
+
+  // Look through the list of dimensions and obtain the best split.  We'll cache
+  // the best numeric split auxiliary information in numericAux (and clear it
+  // later if we don't make a split), and use classProbabilities as auxiliary
+  // information.  Later we'll overwrite classProbabilities to the empirical
+  // class probabilities if we do not split.
+  double bestGain = FitnessFunction::template Evaluate<UseWeights>(
+      labels.subvec(begin, begin + count - 1),
+      numClasses,
+      UseWeights ? weights.subvec(begin, begin + count - 1) : weights);
+  size_t bestDim = data.n_rows; // This means "no split".
+
+  if (maximumDepth != 1 && count >= ParallelTrainThreshold())
+  {
+    // Evaluate each candidate dimension as a separate task against the gain of
+    // the node, then go through the results in the order the dimensions were
+    // selected and keep a split only if it beats the best split so far, like
+    // the serial search below does.
+    std::vector<size_t> dimensions;
+    for (size_t i = dimensionSelector.Begin(); i != dimensionSelector.End();
+         i = dimensionSelector.Next())
+      dimensions.push_back(i);
+
+    const double nodeGain = bestGain;
+    std::vector<double> gains(dimensions.size(), DBL_MAX);
+    std::vector<arma::vec> splitInfo(dimensions.size());
+    std::vector<NumericAuxiliarySplitInfo> numericAux(dimensions.size());
+    for (size_t k = 0; k < dimensions.size(); ++k)
+    {
+      #pragma omp task default(shared) firstprivate(k)
+      {
+        const size_t i = dimensions[k];
+        // Collect the values of the points of the node in this dimension.
+        arma::Row<typename MatType::elem_type> values(count);
+        for (size_t j = 0; j < count; ++j)
+          values[j] = data(i, indices[begin + j]);
+
+        gains[k] = NumericSplit::template SplitIfBetter<UseWeights>(nodeGain,
+            values,
+            labels.cols(begin, begin + count - 1),
+            numClasses,
+            UseWeights ? weights.cols(begin, begin + count - 1) : weights,
+            minimumLeafSize,
+            minimumGainSplit,
+            splitInfo[k],
+            numericAux[k]);
+      }
+    }
+    #pragma omp taskwait
+
+    size_t best = dimensions.size();
+    for (size_t k = 0; k < dimensions.size(); ++k)
+    {
+      // The splitter only reports splits better than the given gain by at
+      // least minimumGainSplit (or with the best possible gain).
+      if (gains[k] == DBL_MAX || !(gains[k] >= 0.0 ||
+          gains[k] > std::min(bestGain + minimumGainSplit, 0.0)))
+        continue;
+
+      best = k;
+      bestDim = dimensions[k];
+      bestGain = gains[k];
+
+      // If the gain is the best possible, no need to keep looking.
+      if (bestGain >= 0.0)
+        break;
+    }
+
+    if (best != dimensions.size())
+    {
+      classProbabilities = std::move(splitInfo[best]);
+      NumericAuxiliarySplitInfo::operator=(numericAux[best]);
+    }
+  }
+  else if (maximumDepth != 1)
   {
     for (size_t i = dimensionSelector.Begin(); i != dimensionSelector.End();
          i = dimensionSelector.Next())
     {
+      // Collect the values of the points of the node in this dimension.
+      arma::Row<typename MatType::elem_type> values(count);
+      for (size_t j = 0; j < count; ++j)
+        values[j] = data(i, indices[begin + j]);
+
       const double dimGain = NumericSplitType<FitnessFunction>::template
           SplitIfBetter<UseWeights>(bestGain,
-                                    data.cols(begin, begin + count - 1).row(i),
+                                    values,
                                     labels.cols(begin, begin + count - 1),
                                     numClasses,
                                     UseWeights ?
@@ -931,7 +1621,7 @@ double DecisionTree<FitnessFunction,
     for (size_t j = begin; j < begin + count; ++j)
     {
       childAssignments[j - begin] = NumericSplit::CalculateDirection(
-          data(bestDim, j), classProbabilities, *this);
+          data(bestDim, indices[j]), classProbabilities, *this);
     }
 
     // Calculate counts of children in each node.
@@ -946,42 +1636,344 @@ double DecisionTree<FitnessFunction,
       bestGain = 0.0;
     }
 
+    std::vector<size_t> childBegins(numChildren + 1);
     size_t currentCol = begin;
     for (size_t i = 0; i < numChildren; ++i)
     {
-      size_t currentChildBegin = currentCol;
-      for (size_t j = currentChildBegin; j < begin + count; ++j)
+      childBegins[i] = currentCol;
+      for (size_t j = currentCol; j < begin + count; ++j)
       {
         if (childAssignments[j - begin] == i)
         {
           childAssignments.swap_cols(currentCol - begin, j - begin);
-          data.swap_cols(currentCol, j);
+          indices.swap_rows(currentCol, j);
           labels.swap_cols(currentCol, j);
           if (UseWeights)
             weights.swap_cols(currentCol, j);
           ++currentCol;
         }
       }
+    }
+    childBegins[numChildren] = currentCol;
+
+    // Now build the children recursively.  They work on disjoint column ranges
+    // of the data, so the children of a large node are trained as separate
+    // tasks if the dimension selection policy allows it, each with its own
+    // copy of the policy.
+    const bool parallel =
+        DimensionSelectionTraits<DimensionSelectionType>::ParallelSafe &&
+        count >= ParallelTrainThreshold();
+    children.resize(numChildren);
+    std::vector<double> childGains(numChildren, 0.0);
+    for (size_t i = 0; i < numChildren; ++i)
+    {
+      #pragma omp task if (parallel) default(shared) firstprivate(i)
+      {
+        const size_t childBegin = childBegins[i];
+        const size_t childCount = childBegins[i + 1] - childBegins[i];
+        DimensionSelectionType childSelector(dimensionSelector);
+        DimensionSelectionType& selector = parallel ? childSelector :
+            dimensionSelector;
+
+        children[i] = new DecisionTree();
+        if (NoRecursion)
+        {
+          children[i]->Train<UseWeights>(data, indices, childBegin,
+              childCount, labels, numClasses, weights, childCount,
+              minimumGainSplit, maximumDepth - 1, selector);
+        }
+        else
+        {
+          // During recursion entropy of child node may change.
+          childGains[i] = children[i]->Train<UseWeights>(data, indices,
+              childBegin, childCount, labels, numClasses, weights,
+              minimumLeafSize, minimumGainSplit, maximumDepth - 1, selector);
+        }
+      }
+    }
+    #pragma omp taskwait
+
+    if (!NoRecursion)
+    {
+      for (size_t i = 0; i < numChildren; ++i)
+        bestGain += double(childCounts[i]) / double(count) * (-childGains[i]);
+    }
+  }
+  else
+  {
+    // We won't be needing these members, so reset them.
+    NumericAuxiliarySplitInfo::operator=(NumericAuxiliarySplitInfo());
+
+    // Calculate class probabilities because we are a leaf.
+    CalculateClassProbabilities<UseWeights>(
+        labels.subvec(begin, begin + count - 1),
+        numClasses,
+        UseWeights ? weights.subvec(begin, begin + count - 1) : weights);
+  }
+
+  return -bestGain;
+}
+
+//! Train on the given bins of the data, assuming all dimensions are numeric.
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DimensionSelectionType,
+         typename ElemType,
+         bool NoRecursion>
+template<bool UseWeights, typename MatType>
+double DecisionTree<FitnessFunction,
+                    NumericSplitType,
+                    CategoricalSplitType,
+                    DimensionSelectionType,
+                    ElemType,
+                    NoRecursion>::TrainBinned(
+    const MatType& data,
+    const HistogramBins<ElemType>& bins,
+    arma::uvec& indices,
+    const size_t begin,
+    const size_t count,
+    arma::Row<size_t>& labels,
+    const size_t numClasses,
+    arma::rowvec& weights,
+    const size_t minimumLeafSize,
+    const double minimumGainSplit,
+    const size_t maximumDepth,
+    DimensionSelectionType& dimensionSelector,
+    const std::true_type& /* usesBins */)
+{
+  #ifdef HAS_OPENMP
+  // As in Train(), the first large node opens the parallel region.
+  if (count >= ParallelTrainThreshold() && omp_get_level() == 0 &&
+      omp_get_max_threads() > 1)
+  {
+    double gain = 0.0;
+    #pragma omp parallel
+    {
+      #pragma omp single
+      gain = TrainBinned<UseWeights>(data, bins, indices, begin, count, labels,
+          numClasses, weights, minimumLeafSize, minimumGainSplit, maximumDepth,
+          dimensionSelector, std::true_type());
+    }
+    return gain;
+  }
+  #endif
+
+  arma::Mat<size_t> binCounts;
+  arma::mat binWeights;
+  BuildHistogram<UseWeights>(bins, indices, begin, count, labels, numClasses,
+      weights, binCounts, binWeights);
+
+  return TrainBinned<UseWeights>(data, bins, binCounts, binWeights, indices,
+      begin, count, labels, numClasses, weights, minimumLeafSize,
+      minimumGainSplit, maximumDepth, dimensionSelector);
+}
+
+//! Ignore the bins of the data, since the numeric split type does not use
+//! them.
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DimensionSelectionType,
+         typename ElemType,
+         bool NoRecursion>
+template<bool UseWeights, typename MatType>
+double DecisionTree<FitnessFunction,
+                    NumericSplitType,
+                    CategoricalSplitType,
+                    DimensionSelectionType,
+                    ElemType,
+                    NoRecursion>::TrainBinned(
+    const MatType& data,
+    const HistogramBins<ElemType>& /* bins */,
+    arma::uvec& indices,
+    const size_t begin,
+    const size_t count,
+    arma::Row<size_t>& labels,
+    const size_t numClasses,
+    arma::rowvec& weights,
+    const size_t minimumLeafSize,
+    const double minimumGainSplit,
+    const size_t maximumDepth,
+    DimensionSelectionType& dimensionSelector,
+    const std::false_type& /* usesBins */)
+{
+  return Train<UseWeights>(data, indices, begin, count, labels, numClasses,
+      weights, minimumLeafSize, minimumGainSplit, maximumDepth,
+      dimensionSelector);
+}
+
+//! Train the node on the given histogram of its points.
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DimensionSelectionType,
+         typename ElemType,
+         bool NoRecursion>
+template<bool UseWeights, typename MatType>
+double DecisionTree<FitnessFunction,
+                    NumericSplitType,
+                    CategoricalSplitType,
+                    DimensionSelectionType,
+                    ElemType,
+                    NoRecursion>::TrainBinned(
+    const MatType& data,
+    const HistogramBins<ElemType>& bins,
+    arma::Mat<size_t>& binCounts,
+    arma::mat& binWeights,
+    arma::uvec& indices,
+    const size_t begin,
+    const size_t count,
+    arma::Row<size_t>& labels,
+    const size_t numClasses,
+    arma::rowvec& weights,
+    const size_t minimumLeafSize,
+    const double minimumGainSplit,
+    const size_t maximumDepth,
+    DimensionSelectionType& dimensionSelector)
+{
+  // Clear children if needed.
+  for (size_t i = 0; i < children.size(); ++i)
+    delete children[i];
+  children.clear();
+
+  // We won't be using these members, so reset them.
+  CategoricalAuxiliarySplitInfo::operator=(CategoricalAuxiliarySplitInfo());
+
+  // Look through the list of dimensions and obtain the best split, from the
+  // histogram of the node in each dimension.  The histogram of a dimension is
+  // a block of columns of the histogram of the node, so it is not copied.
+  double bestGain = FitnessFunction::template Evaluate<UseWeights>(
+      labels.subvec(begin, begin + count - 1),
+      numClasses,
+      UseWeights ? weights.subvec(begin, begin + count - 1) : weights);
+  size_t bestDim = data.n_rows; // This means "no split".
+
+  if (maximumDepth != 1)
+  {
+    for (size_t i = dimensionSelector.Begin(); i != dimensionSelector.End();
+         i = dimensionSelector.Next())
+    {
+      const size_t numBins = bins.Offset(i + 1) - bins.Offset(i);
+      const arma::Mat<size_t> dimCounts(binCounts.colptr(bins.Offset(i)),
+          numClasses, numBins, false, true);
+      const arma::mat dimWeights = UseWeights ?
+          arma::mat(binWeights.colptr(bins.Offset(i)), numClasses, numBins,
+          false, true) : arma::mat();
+
+      const double dimGain = NumericSplit::template SplitIfBetter<UseWeights>(
+          bestGain, dimCounts, dimWeights, bins.Boundaries(i),
+          minimumLeafSize, minimumGainSplit, classProbabilities, *this);
+
+      // If the splitter did not report that it improved, then move to the next
+      // dimension.
+      if (dimGain == DBL_MAX)
+        continue;
+
+      bestDim = i;
+      bestGain = dimGain;
+
+      // If the gain is the best possible, no need to keep looking.
+      if (bestGain >= 0.0)
+        break;
+    }
+  }
+
+  // Did we split or not?  If so, then split the data and create the children.
+  if (bestDim != data.n_rows)
+  {
+    // We know that the split is numeric and binary.
+    splitDimension = bestDim;
+    dimensionTypeOrMajorityClass = (size_t) data::Datatype::numeric;
+
+    // Move the points of the left child to the front.  The split is at a bin
+    // boundary, so this is the same as comparing the bins of the points.
+    size_t mid = begin;
+    for (size_t j = begin; j < begin + count; ++j)
+    {
+      if (NumericSplit::CalculateDirection(data(bestDim, indices[j]),
+          classProbabilities, *this) == 0)
+      {
+        indices.swap_rows(mid, j);
+        labels.swap_cols(mid, j);
+        if (UseWeights)
+          weights.swap_cols(mid, j);
+        ++mid;
+      }
+    }
+
+    // Initialize bestGain if recursive split is allowed.
+    if (!NoRecursion)
+    {
+      bestGain = 0.0;
+    }
 
-      // Now build the child recursively.
-      DecisionTree* child = new DecisionTree();
-      if (NoRecursion)
+    // Only build the histogram of the smaller child; the histogram of the
+    // larger child is the difference with the histogram of the node.
+    const size_t childBegins[3] = { begin, mid, begin + count };
+    const size_t smaller = (mid - begin <= begin + count - mid) ? 0 : 1;
+    const size_t larger = 1 - smaller;
+    std::vector<arma::Mat<size_t>> childCounts(2);
+    std::vector<arma::mat> childWeights(2);
+    BuildHistogram<UseWeights>(bins, indices, childBegins[smaller],
+        childBegins[smaller + 1] - childBegins[smaller], labels, numClasses,
+        weights, childCounts[smaller], childWeights[smaller]);
+    childCounts[larger] = std::move(binCounts);
+    childCounts[larger] -= childCounts[smaller];
+    if (UseWeights)
+    {
+      childWeights[larger] = std::move(binWeights);
+      childWeights[larger] -= childWeights[smaller];
+    }
+
+    // Now build the children recursively, as separate tasks if the dimension
+    // selection policy allows it (see Train()).
+    const bool parallel =
+        DimensionSelectionTraits<DimensionSelectionType>::ParallelSafe &&
+        count >= ParallelTrainThreshold();
+    children.resize(2);
+    std::vector<double> childGains(2, 0.0);
+    for (size_t i = 0; i < 2; ++i)
+    {
+      #pragma omp task if (parallel) default(shared) firstprivate(i)
       {
-        child->Train<UseWeights>(data, currentChildBegin,
-            currentCol - currentChildBegin, labels, numClasses, weights,
-            currentCol - currentChildBegin, minimumGainSplit, maximumDepth - 1,
-            dimensionSelector);
+        const size_t childBegin = childBegins[i];
+        const size_t childCount = childBegins[i + 1] - childBegins[i];
+        DimensionSelectionType childSelector(dimensionSelector);
+        DimensionSelectionType& selector = parallel ? childSelector :
+            dimensionSelector;
+
+        children[i] = new DecisionTree();
+        if (NoRecursion)
+        {
+          children[i]->TrainBinned<UseWeights>(data, bins, childCounts[i],
+              childWeights[i], indices, childBegin, childCount, labels,
+              numClasses, weights, childCount, minimumGainSplit,
+              maximumDepth - 1, selector);
+        }
+        else
+        {
+          // During recursion entropy of child node may change.
+          childGains[i] = children[i]->TrainBinned<UseWeights>(data, bins,
+              childCounts[i], childWeights[i], indices, childBegin, childCount,
+              labels, numClasses, weights, minimumLeafSize, minimumGainSplit,
+              maximumDepth - 1, selector);
+        }
+
+        // The histogram of the child is not needed anymore.
+        childCounts[i].reset();
+        childWeights[i].reset();
       }
-      else
+    }
+    #pragma omp taskwait
+
+    if (!NoRecursion)
+    {
+      for (size_t i = 0; i < 2; ++i)
       {
-        // During recursion entropy of child node may change.
-        double childGain = child->Train<UseWeights>(data, currentChildBegin,
-            currentCol - currentChildBegin, labels, numClasses, weights,
-            minimumLeafSize, minimumGainSplit, maximumDepth - 1,
-            dimensionSelector);
-        bestGain += double(childCounts[i]) / double(count) * (-childGain);
+        bestGain += double(childBegins[i + 1] - childBegins[i]) /
+            double(count) * (-childGains[i]);
       }
-      children.push_back(child);
     }
   }
   else
@@ -999,6 +1991,56 @@ double DecisionTree<FitnessFunction,
   return -bestGain;
 }
 
+//! Build the histogram of the given points in every dimension.
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DimensionSelectionType,
+         typename ElemType,
+         bool NoRecursion>
+template<bool UseWeights>
+void DecisionTree<FitnessFunction,
+                    NumericSplitType,
+                    CategoricalSplitType,
+                    DimensionSelectionType,
+                    ElemType,
+                    NoRecursion>::BuildHistogram(
+    const HistogramBins<ElemType>& bins,
+    const arma::uvec& indices,
+    const size_t begin,
+    const size_t count,
+    const arma::Row<size_t>& labels,
+    const size_t numClasses,
+    const arma::rowvec& weights,
+    arma::Mat<size_t>& binCounts,
+    arma::mat& binWeights)
+{
+  binCounts.zeros(numClasses, bins.NumBins());
+  if (UseWeights)
+    binWeights.zeros(numClasses, bins.NumBins());
+
+  // The dimensions of a large node are binned as separate tasks.
+  const bool parallel = (count >= ParallelTrainThreshold());
+  for (size_t d = 0; d < bins.Dimensionality(); ++d)
+  {
+    #pragma omp task if (parallel) default(shared) firstprivate(d)
+    {
+      const unsigned char* codes = bins.Codes(d);
+      size_t* counts = binCounts.colptr(bins.Offset(d));
+      double* weightSums = UseWeights ?
+          binWeights.colptr(bins.Offset(d)) : NULL;
+      for (size_t j = begin; j < begin + count; ++j)
+      {
+        const size_t entry = numClasses * codes[indices[j]] + labels[j];
+        ++counts[entry];
+        if (UseWeights)
+          weightSums[entry] += weights[j];
+      }
+    }
+  }
+  #pragma omp taskwait
+}
+
 //! Return the class.
 template<typename FitnessFunction,
          template<typename> class NumericSplitType,
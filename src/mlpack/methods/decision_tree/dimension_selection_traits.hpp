@@ -0,0 +1,53 @@
+/**
+ * @file methods/decision_tree/dimension_selection_traits.hpp
+ *
+ * Definition of the DimensionSelectionTraits class, which describes properties
+ * of the dimension selection policies used by the DecisionTree.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_DECISION_TREE_DIMENSION_SELECTION_TRAITS_HPP
+#define MLPACK_METHODS_DECISION_TREE_DIMENSION_SELECTION_TRAITS_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "all_dimension_select.hpp"
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * The DimensionSelectionTraits class describes properties of a dimension
+ * selection policy that the DecisionTree may use while it is being trained.
+ * By default nothing is assumed about the policy, so the children of a node
+ * are trained one after the other.
+ */
+template<typename DimensionSelectionType>
+class DimensionSelectionTraits
+{
+ public:
+  /**
+   * This is true if the policy is deterministic and keeps no state between
+   * nodes, so that the children of a node can be trained at the same time
+   * (each with its own copy of the policy) without changing the resulting
+   * tree.  Policies that draw random numbers must leave this false.
+   */
+  static const bool ParallelSafe = false;
+};
+
+/**
+ * The AllDimensionSelect policy always selects every dimension.
+ */
+template<>
+class DimensionSelectionTraits<AllDimensionSelect>
+{
+ public:
+  static const bool ParallelSafe = true;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,190 @@
+/**
+ * @file methods/decision_tree/flat_decision_tree.hpp
+ *
+ * Definition of FlatDecisionTree, a copy of a trained DecisionTree laid out in
+ * contiguous arrays for fast classification.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_DECISION_TREE_FLAT_DECISION_TREE_HPP
+#define MLPACK_METHODS_DECISION_TREE_FLAT_DECISION_TREE_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "decision_tree.hpp"
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * A FlatDecisionTree holds the same model as a trained DecisionTree, but
+ * instead of one heap-allocated object per node it stores the nodes in
+ * contiguous arrays, in breadth-first order, so that the children of a node are
+ * next to each other: the split dimension, the number of children and the
+ * index of the first child of each node, the split information of all the
+ * internal nodes in one vector, and the class probabilities of all the leaves
+ * in one matrix.  Classifying a point follows indices in these arrays instead
+ * of pointers, and the batch Classify() overloads move a block of points down
+ * the tree one level at a time, so that the memory accesses of the points of a
+ * block overlap.
+ *
+ * The flat tree is a snapshot: it doesn't change when the DecisionTree it was
+ * built from is changed or retrained, and it can't be trained itself.
+ *
+ * @code
+ * extern DecisionTree<> tree;
+ * extern arma::mat points;
+ *
+ * FlatDecisionTree<DecisionTree<>> flatTree(tree);
+ * arma::Row<size_t> predictions;
+ * flatTree.Classify(points, predictions);
+ * @endcode
+ *
+ * @tparam TreeType Type of the DecisionTree to flatten.
+ */
+template<typename TreeType>
+class FlatDecisionTree
+{
+ public:
+  //! Create an empty flat tree; Compile() must be called before classifying.
+  FlatDecisionTree() { }
+
+  //! Create the flat copy of the given tree.
+  FlatDecisionTree(const TreeType& tree) { Compile(tree); }
+
+  /**
+   * Replace the model with a flat copy of the given tree.
+   *
+   * @param tree Trained tree to copy.
+   */
+  void Compile(const TreeType& tree);
+
+  /**
+   * Find the leaf the given point falls in.
+   *
+   * @param point Point to find the leaf of.
+   * @return Index of the leaf (a column of LeafProbabilities()).
+   */
+  template<typename VecType>
+  size_t Leaf(const VecType& point) const;
+
+  /**
+   * Find the leaf each of the given points falls in.
+   *
+   * @param data Points to find the leaves of.
+   * @param leaves Vector to store the index of the leaf of each point in.
+   */
+  template<typename MatType>
+  void Leaves(const MatType& data, arma::Row<size_t>& leaves) const;
+
+  /**
+   * Classify the given point.  The predicted label is returned.
+   *
+   * @param point Point to classify.
+   */
+  template<typename VecType>
+  size_t Classify(const VecType& point) const;
+
+  /**
+   * Classify the given point and also return estimates of the probability for
+   * each class in the given vector.
+   *
+   * @param point Point to classify.
+   * @param prediction This will be set to the predicted class of the point.
+   * @param probabilities This will be filled with class probabilities for the
+   *      point.
+   */
+  template<typename VecType>
+  void Classify(const VecType& point,
+                size_t& prediction,
+                arma::vec& probabilities) const;
+
+  /**
+   * Classify the given points.  The predicted labels for each point are stored
+   * in the given vector.
+   *
+   * @param data Set of points to classify.
+   * @param predictions This will be filled with predictions for each point.
+   */
+  template<typename MatType>
+  void Classify(const MatType& data,
+                arma::Row<size_t>& predictions) const;
+
+  /**
+   * Classify the given points and also return estimates of the probabilities
+   * for each class in the given matrix.
+   *
+   * @param data Set of points to classify.
+   * @param predictions This will be filled with predictions for each point.
+   * @param probabilities This will be filled with class probabilities for each
+   *      point.
+   */
+  template<typename MatType>
+  void Classify(const MatType& data,
+                arma::Row<size_t>& predictions,
+                arma::mat& probabilities) const;
+
+  //! Get the number of nodes.
+  size_t NumNodes() const { return numChildren.size(); }
+  //! Get the number of leaves.
+  size_t NumLeaves() const { return leafClasses.n_elem; }
+  //! Get the number of classes.
+  size_t NumClasses() const { return leafProbabilities.n_rows; }
+
+  //! Get the class probabilities of each leaf (one column per leaf).
+  const arma::mat& LeafProbabilities() const { return leafProbabilities; }
+  //! Get the majority class of each leaf.
+  const arma::Row<size_t>& LeafClasses() const { return leafClasses; }
+
+  //! The number of points moved down the tree together by the batch
+  //! Classify() overloads.
+  static const size_t BlockSize = 64;
+
+ private:
+  typedef typename TreeType::NumericSplit NumericSplit;
+  typedef typename TreeType::CategoricalSplit CategoricalSplit;
+  typedef typename TreeType::NumericAuxiliarySplitInfo
+      NumericAuxiliarySplitInfo;
+  typedef typename TreeType::CategoricalAuxiliarySplitInfo
+      CategoricalAuxiliarySplitInfo;
+
+  /**
+   * Compute the index of the child of the given internal node that a point
+   * with the given value in the split dimension goes to.
+   */
+  template<typename ElemType>
+  size_t Direction(const size_t node, const ElemType& value) const;
+
+  //! The split dimension of each node.
+  std::vector<size_t> splitDimensions;
+  //! Whether each node splits on a categorical dimension.
+  std::vector<char> categorical;
+  //! The number of children of each node (0 for leaves).
+  std::vector<size_t> numChildren;
+  //! The index of the first child of each internal node, or the index of the
+  //! leaf for leaves.
+  std::vector<size_t> firstChild;
+  //! The split information of node i is splitInfo[infoOffsets[i]] to
+  //! splitInfo[infoOffsets[i + 1] - 1].
+  std::vector<size_t> infoOffsets;
+  //! The split information of all the internal nodes.
+  arma::vec splitInfo;
+  //! The auxiliary numeric split information of each node.
+  std::vector<NumericAuxiliarySplitInfo> numericAux;
+  //! The auxiliary categorical split information of each node.
+  std::vector<CategoricalAuxiliarySplitInfo> categoricalAux;
+  //! The class probabilities of each leaf.
+  arma::mat leafProbabilities;
+  //! The majority class of each leaf.
+  arma::Row<size_t> leafClasses;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+// Include implementation.
+#include "flat_decision_tree_impl.hpp"
+
+#endif
@@ -0,0 +1,204 @@
+/**
+ * @file methods/decision_tree/flat_decision_tree_impl.hpp
+ *
+ * Implementation of FlatDecisionTree.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_DECISION_TREE_FLAT_DECISION_TREE_IMPL_HPP
+#define MLPACK_METHODS_DECISION_TREE_FLAT_DECISION_TREE_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "flat_decision_tree.hpp"
+
+namespace mlpack {
+namespace tree {
+
+template<typename TreeType>
+const size_t FlatDecisionTree<TreeType>::BlockSize;
+
+template<typename TreeType>
+void FlatDecisionTree<TreeType>::Compile(const TreeType& tree)
+{
+  splitDimensions.clear();
+  categorical.clear();
+  numChildren.clear();
+  firstChild.clear();
+  infoOffsets.clear();
+  numericAux.clear();
+  categoricalAux.clear();
+
+  // Visit the nodes in breadth-first order, so that the children of each node
+  // get consecutive indices.
+  std::vector<const TreeType*> nodes(1, &tree);
+  std::vector<double> info;
+  std::vector<double> probabilities;
+  std::vector<size_t> classes;
+  for (size_t i = 0; i < nodes.size(); ++i)
+  {
+    const TreeType& node = *nodes[i];
+    infoOffsets.push_back(info.size());
+    numericAux.push_back(
+        static_cast<const NumericAuxiliarySplitInfo&>(node));
+    categoricalAux.push_back(
+        static_cast<const CategoricalAuxiliarySplitInfo&>(node));
+
+    if (node.children.size() == 0)
+    {
+      // For a leaf, the class probabilities are stored with the other leaves.
+      splitDimensions.push_back(0);
+      categorical.push_back(0);
+      numChildren.push_back(0);
+      firstChild.push_back(classes.size());
+      classes.push_back(node.dimensionTypeOrMajorityClass);
+      probabilities.insert(probabilities.end(),
+          node.classProbabilities.begin(), node.classProbabilities.end());
+    }
+    else
+    {
+      splitDimensions.push_back(node.splitDimension);
+      categorical.push_back((data::Datatype) node.dimensionTypeOrMajorityClass
+          == data::Datatype::categorical);
+      numChildren.push_back(node.children.size());
+      firstChild.push_back(nodes.size());
+      info.insert(info.end(), node.classProbabilities.begin(),
+          node.classProbabilities.end());
+      for (size_t c = 0; c < node.children.size(); ++c)
+        nodes.push_back(node.children[c]);
+    }
+  }
+  infoOffsets.push_back(info.size());
+
+  splitInfo = arma::conv_to<arma::vec>::from(info);
+  leafClasses = arma::conv_to<arma::Row<size_t>>::from(classes);
+  const size_t numClasses = probabilities.size() / classes.size();
+  leafProbabilities = arma::mat(probabilities.data(), numClasses,
+      classes.size());
+}
+
+template<typename TreeType>
+template<typename VecType>
+size_t FlatDecisionTree<TreeType>::Leaf(const VecType& point) const
+{
+  size_t node = 0;
+  while (numChildren[node] != 0)
+  {
+    node = firstChild[node] + Direction(node,
+        point[splitDimensions[node]]);
+  }
+
+  return firstChild[node];
+}
+
+template<typename TreeType>
+template<typename MatType>
+void FlatDecisionTree<TreeType>::Leaves(const MatType& data,
+                                        arma::Row<size_t>& leaves) const
+{
+  leaves.set_size(data.n_cols);
+
+  // Move each block of points down the tree one level at a time, until every
+  // point of the block has reached a leaf.
+  size_t nodes[BlockSize];
+  for (size_t begin = 0; begin < data.n_cols; begin += BlockSize)
+  {
+    const size_t count = std::min((size_t) BlockSize,
+        (size_t) data.n_cols - begin);
+    std::fill(nodes, nodes + count, 0);
+
+    bool moved = true;
+    while (moved)
+    {
+      moved = false;
+      for (size_t i = 0; i < count; ++i)
+      {
+        const size_t node = nodes[i];
+        if (numChildren[node] != 0)
+        {
+          nodes[i] = firstChild[node] + Direction(node,
+              data(splitDimensions[node], begin + i));
+          moved = true;
+        }
+      }
+    }
+
+    for (size_t i = 0; i < count; ++i)
+      leaves[begin + i] = firstChild[nodes[i]];
+  }
+}
+
+template<typename TreeType>
+template<typename VecType>
+size_t FlatDecisionTree<TreeType>::Classify(const VecType& point) const
+{
+  return leafClasses[Leaf(point)];
+}
+
+template<typename TreeType>
+template<typename VecType>
+void FlatDecisionTree<TreeType>::Classify(const VecType& point,
+                                          size_t& prediction,
+                                          arma::vec& probabilities) const
+{
+  const size_t leaf = Leaf(point);
+  prediction = leafClasses[leaf];
+  probabilities = leafProbabilities.col(leaf);
+}
+
+template<typename TreeType>
+template<typename MatType>
+void FlatDecisionTree<TreeType>::Classify(const MatType& data,
+                                          arma::Row<size_t>& predictions)
+    const
+{
+  arma::Row<size_t> leaves;
+  Leaves(data, leaves);
+
+  predictions.set_size(leaves.n_elem);
+  for (size_t i = 0; i < leaves.n_elem; ++i)
+    predictions[i] = leafClasses[leaves[i]];
+}
+
+template<typename TreeType>
+template<typename MatType>
+void FlatDecisionTree<TreeType>::Classify(const MatType& data,
+                                          arma::Row<size_t>& predictions,
+                                          arma::mat& probabilities) const
+{
+  arma::Row<size_t> leaves;
+  Leaves(data, leaves);
+
+  predictions.set_size(leaves.n_elem);
+  probabilities.set_size(leafProbabilities.n_rows, leaves.n_elem);
+  for (size_t i = 0; i < leaves.n_elem; ++i)
+  {
+    predictions[i] = leafClasses[leaves[i]];
+    probabilities.col(i) = leafProbabilities.col(leaves[i]);
+  }
+}
+
+template<typename TreeType>
+template<typename ElemType>
+size_t FlatDecisionTree<TreeType>::Direction(const size_t node,
+                                             const ElemType& value) const
+{
+  // The split information of the node is used in place.
+  const arma::vec nodeInfo(const_cast<double*>(splitInfo.memptr()) +
+      infoOffsets[node], infoOffsets[node + 1] - infoOffsets[node], false,
+      true);
+
+  if (categorical[node])
+    return CategoricalSplit::CalculateDirection(value, nodeInfo,
+        categoricalAux[node]);
+  else
+    return NumericSplit::CalculateDirection(value, nodeInfo,
+        numericAux[node]);
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,120 @@
+/**
+ * @file methods/decision_tree/histogram_bins.hpp
+ *
+ * The bins of every dimension of a dataset, used to train decision trees with
+ * histogram-based numeric splits.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_DECISION_TREE_HISTOGRAM_BINS_HPP
+#define MLPACK_METHODS_DECISION_TREE_HISTOGRAM_BINS_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "gini_gain.hpp"
+#include "histogram_numeric_split.hpp"
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * HistogramBins holds the bin of every value of a dataset: each dimension is
+ * split into at most HistogramNumericSplit::MaxBins bins, whose boundaries are
+ * given by HistogramNumericSplit::BinBoundaries(), and every value is replaced
+ * by the one-byte index of its bin.  A DecisionTree with a
+ * HistogramNumericSplit bins the dataset once in Train(); a RandomForest bins
+ * it once for all of its trees.
+ *
+ * The bins of all dimensions are numbered one after the other, so that the
+ * histogram of a node can be stored as one matrix with a column per bin; the
+ * bins of dimension d are the columns Offset(d) to Offset(d + 1) - 1.
+ *
+ * @tparam ElemType Type of the values of the dataset.
+ */
+template<typename ElemType = double>
+class HistogramBins
+{
+ public:
+  //! Create an empty object.
+  HistogramBins() { }
+
+  /**
+   * Bin every point of the given dataset.  The boundaries of the bins are
+   * computed from the values of the points selected by the given indices only.
+   *
+   * @param data Dataset to bin.
+   * @param indices Indices of the points to take the boundaries from.
+   */
+  template<typename MatType>
+  HistogramBins(const MatType& data, const arma::uvec& indices) :
+      boundaries(data.n_rows),
+      offsets(data.n_rows + 1),
+      codes(data.n_cols, data.n_rows)
+  {
+    #pragma omp parallel for
+    for (omp_size_t j = 0; j < (omp_size_t) data.n_rows; ++j)
+    {
+      if (indices.n_elem == 0)
+      {
+        boundaries[j].zeros(1);
+      }
+      else
+      {
+        arma::Col<ElemType> values(indices.n_elem);
+        for (size_t i = 0; i < indices.n_elem; ++i)
+          values[i] = (ElemType) data(j, indices[i]);
+        HistogramNumericSplit<GiniGain>::BinBoundaries(values, values.min(),
+            values.max(), boundaries[j]);
+      }
+
+      // A value falls in the first bin whose boundary it does not exceed.
+      const ElemType* first = boundaries[j].memptr();
+      const ElemType* last = first + boundaries[j].n_elem;
+      for (size_t i = 0; i < data.n_cols; ++i)
+        codes(i, j) = (unsigned char) (std::lower_bound(first, last,
+            (ElemType) data(j, i)) - first);
+    }
+
+    offsets[0] = 0;
+    for (size_t j = 0; j < data.n_rows; ++j)
+      offsets[j + 1] = offsets[j] + boundaries[j].n_elem + 1;
+  }
+
+  //! Get the number of dimensions.
+  size_t Dimensionality() const { return boundaries.size(); }
+  //! Get the number of points.
+  size_t NumPoints() const { return codes.n_rows; }
+  //! Get the total number of bins of all dimensions.
+  size_t NumBins() const { return offsets.empty() ? 0 : offsets.back(); }
+
+  //! Get the upper boundaries of all the bins but the last one of the given
+  //! dimension.
+  const arma::Col<ElemType>& Boundaries(const size_t dimension) const
+  {
+    return boundaries[dimension];
+  }
+
+  //! Get the number of the first bin of the given dimension.
+  size_t Offset(const size_t dimension) const { return offsets[dimension]; }
+
+  //! Get the bins of the given dimension, with one entry per point.
+  const unsigned char* Codes(const size_t dimension) const
+  {
+    return codes.colptr(dimension);
+  }
+
+ private:
+  //! The bin boundaries of each dimension.
+  std::vector<arma::Col<ElemType>> boundaries;
+  //! The number of the first bin of each dimension, then the number of bins.
+  std::vector<size_t> offsets;
+  //! The bin of each point (rows) in each dimension (columns).
+  arma::Mat<unsigned char> codes;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,181 @@
+/**
+ * @file methods/decision_tree/histogram_numeric_split.hpp
+ *
+ * A tree splitter that finds the best binary numeric split between the bins of
+ * a histogram of the values.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_DECISION_TREE_HISTOGRAM_NUMERIC_SPLIT_HPP
+#define MLPACK_METHODS_DECISION_TREE_HISTOGRAM_NUMERIC_SPLIT_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * The HistogramNumericSplit is a splitting function for decision trees that
+ * searches a numeric dimension for the best binary split, like
+ * BestBinaryNumericSplit, but only considers splits between the bins of a
+ * histogram of the values instead of between every pair of successive values.
+ *
+ * The bin boundaries are approximate quantiles of the values, taken from a
+ * sample of at most 16 * MaxBins of them; if the sample holds at most MaxBins
+ * distinct values, every distinct value gets its own bin.  Each value is then
+ * put in its bin with a binary search, the class counts (or weights) of each
+ * bin are accumulated, and the splits are evaluated with one scan over the
+ * bins; the statistics of the right child are those of the node minus those of
+ * the left child.  This avoids sorting the values of the node, so finding a
+ * split costs O(n log(MaxBins)) instead of O(n log n).  The split is halfway
+ * between the largest value of the last bin on the left and the smallest value
+ * of the first bin on the right, so when every value has its own bin the split
+ * is the same as the one found by BestBinaryNumericSplit.
+ *
+ * When all dimensions are numeric, the DecisionTree does not call that
+ * overload of SplitIfBetter() though (see NumericSplitTraits): it bins every
+ * dimension once for the whole tree (see HistogramBins), keeps the histogram
+ * of each node, and calls the overload that takes the histogram of a
+ * dimension.  Only the histogram of the smaller
+ * child of a split is built from its points; the histogram of the other child
+ * is the histogram of the node minus that one.  The split is then at the upper
+ * boundary of the last bin on the left.
+ *
+ * @tparam FitnessFunction Fitness function to use to calculate gain.
+ */
+template<typename FitnessFunction>
+class HistogramNumericSplit
+{
+ public:
+  //! The maximum number of bins of the histogram.
+  static const size_t MaxBins = 256;
+
+  // No extra info needed for split.
+  template<typename ElemType>
+  class AuxiliarySplitInfo { };
+
+  /**
+   * Check if we can split a node.  If we can split a node in a way that
+   * improves on 'bestGain', then we return the improved gain.  Otherwise we
+   * return the value 'bestGain'.  If a split is made, then classProbabilities
+   * and aux may be modified.
+   *
+   * @param bestGain Best gain seen so far (we'll only split if we find gain
+   *      better than this).
+   * @param data The dimension of data points to check for a split in.
+   * @param labels Labels for each point.
+   * @param numClasses Number of classes in the dataset.
+   * @param weights Weights associated with labels.
+   * @param minimumLeafSize Minimum number of points in a leaf node for
+   *      splitting.
+   * @param minimumGainSplit Minimum gain split.
+   * @param classProbabilities Class probabilities vector, which may be filled
+   *      with split information a successful split.
+   * @param aux Auxiliary split information, which may be modified on a
+   *      successful split.
+   */
+  template<bool UseWeights, typename VecType, typename WeightVecType>
+  static double SplitIfBetter(
+      const double bestGain,
+      const VecType& data,
+      const arma::Row<size_t>& labels,
+      const size_t numClasses,
+      const WeightVecType& weights,
+      const size_t minimumLeafSize,
+      const double minimumGainSplit,
+      arma::Col<typename VecType::elem_type>& classProbabilities,
+      AuxiliarySplitInfo<typename VecType::elem_type>& aux);
+
+  /**
+   * Check if we can split a node, given the histogram of the points of the
+   * node in one dimension.  If we can split a node in a way that improves on
+   * 'bestGain', then we return the improved gain.  Otherwise we return the
+   * value 'bestGain'.  If a split is made, then classProbabilities and aux may
+   * be modified.
+   *
+   * @param bestGain Best gain seen so far (we'll only split if we find gain
+   *      better than this).
+   * @param binCounts Number of points of each class (rows) in each bin
+   *      (columns).
+   * @param binWeights Total weight of the points of each class in each bin;
+   *      only used if UseWeights is true.
+   * @param boundaries Upper boundaries of all the bins but the last one.
+   * @param minimumLeafSize Minimum number of points in a leaf node for
+   *      splitting.
+   * @param minimumGainSplit Minimum gain split.
+   * @param classProbabilities Class probabilities vector, which may be filled
+   *      with split information a successful split.
+   * @param aux Auxiliary split information, which may be modified on a
+   *      successful split.
+   */
+  template<bool UseWeights, typename ElemType>
+  static double SplitIfBetter(
+      const double bestGain,
+      const arma::Mat<size_t>& binCounts,
+      const arma::mat& binWeights,
+      const arma::Col<ElemType>& boundaries,
+      const size_t minimumLeafSize,
+      const double minimumGainSplit,
+      arma::Col<ElemType>& classProbabilities,
+      AuxiliarySplitInfo<ElemType>& aux);
+
+  /**
+   * Returns 2, since the binary split always has two children.
+   */
+  template<typename ElemType>
+  static size_t NumChildren(const arma::Col<ElemType>& /* classProbabilities */,
+                            const AuxiliarySplitInfo<ElemType>& /* aux */)
+  {
+    return 2;
+  }
+
+  /**
+   * Given a point, calculate which child it should go to (left or right).
+   *
+   * @param point Point to calculate direction of.
+   * @param classProbabilities Auxiliary information for the split.
+   * @param * (aux) Auxiliary information for the split (Unused).
+   */
+  template<typename ElemType>
+  static size_t CalculateDirection(
+      const ElemType& point,
+      const arma::Col<ElemType>& classProbabilities,
+      const AuxiliarySplitInfo<ElemType>& /* aux */);
+
+  /**
+   * Compute the upper boundaries of all the bins but the last one for the
+   * given values, whose smallest and largest values are given.  Each boundary
+   * is smaller than the largest value.  A value falls in the first bin whose
+   * boundary it does not exceed, or in the last bin.
+   */
+  template<typename VecType>
+  static void BinBoundaries(const VecType& data,
+                            const typename VecType::elem_type minValue,
+                            const typename VecType::elem_type maxValue,
+                            arma::Col<typename VecType::elem_type>& boundaries);
+
+ private:
+  /**
+   * Find the best split between the bins of the given histogram.  Return the
+   * gain of the split (or DBL_MAX if no split improves on 'bestGain') and set
+   * bestBin to the last bin on the left of the split.
+   */
+  template<bool UseWeights>
+  static double BestBin(const double bestGain,
+                        const arma::Mat<size_t>& binCounts,
+                        const arma::mat& binWeights,
+                        const size_t minimumLeafSize,
+                        const double minimumGainSplit,
+                        size_t& bestBin);
+};
+
+} // namespace tree
+} // namespace mlpack
+
+// Include implementation.
+#include "histogram_numeric_split_impl.hpp"
+
+#endif
@@ -0,0 +1,302 @@
+/**
+ * @file methods/decision_tree/histogram_numeric_split_impl.hpp
+ *
+ * Implementation of the histogram-based numeric split.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_DECISION_TREE_HISTOGRAM_NUMERIC_SPLIT_IMPL_HPP
+#define MLPACK_METHODS_DECISION_TREE_HISTOGRAM_NUMERIC_SPLIT_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "histogram_numeric_split.hpp"
+
+namespace mlpack {
+namespace tree {
+
+template<typename FitnessFunction>
+const size_t HistogramNumericSplit<FitnessFunction>::MaxBins;
+
+template<typename FitnessFunction>
+template<bool UseWeights, typename VecType, typename WeightVecType>
+double HistogramNumericSplit<FitnessFunction>::SplitIfBetter(
+    const double bestGain,
+    const VecType& data,
+    const arma::Row<size_t>& labels,
+    const size_t numClasses,
+    const WeightVecType& weights,
+    const size_t minimumLeafSize,
+    const double minimumGainSplit,
+    arma::Col<typename VecType::elem_type>& classProbabilities,
+    AuxiliarySplitInfo<typename VecType::elem_type>& /* aux */)
+{
+  typedef typename VecType::elem_type ElemType;
+
+  // First sanity check: if we don't have enough points, we can't split.
+  if (data.n_elem < (minimumLeafSize * 2))
+    return DBL_MAX;
+  if (bestGain == 0.0)
+    return DBL_MAX; // It can't be outperformed.
+
+  // Sanity check: if all the values are the same, we can't split in this
+  // dimension.
+  const ElemType minValue = data.min();
+  const ElemType maxValue = data.max();
+  if (minValue == maxValue)
+    return DBL_MAX;
+
+  arma::Col<ElemType> boundaries;
+  BinBoundaries(data, minValue, maxValue, boundaries);
+  const size_t numBins = boundaries.n_elem + 1;
+
+  // Build the histogram: the class counts (or weights) of each bin, and the
+  // extent of the values in each bin.  The point goes to the first bin whose
+  // upper boundary is not smaller than the value.
+  arma::Mat<size_t> binCounts(numClasses, numBins, arma::fill::zeros);
+  arma::mat binWeights;
+  if (UseWeights)
+    binWeights.zeros(numClasses, numBins);
+  arma::Col<ElemType> binMin(numBins);
+  binMin.fill(maxValue);
+  arma::Col<ElemType> binMax(numBins);
+  binMax.fill(minValue);
+  for (size_t i = 0; i < data.n_elem; ++i)
+  {
+    const ElemType value = data[i];
+    const size_t bin = std::lower_bound(boundaries.begin(), boundaries.end(),
+        value) - boundaries.begin();
+
+    ++binCounts(labels[i], bin);
+    if (UseWeights)
+      binWeights(labels[i], bin) += weights[i];
+    binMin[bin] = std::min(binMin[bin], value);
+    binMax[bin] = std::max(binMax[bin], value);
+  }
+
+  size_t bestBin;
+  const double gain = BestBin<UseWeights>(bestGain, binCounts, binWeights,
+      minimumLeafSize, minimumGainSplit, bestBin);
+  if (gain == DBL_MAX)
+    return DBL_MAX;
+
+  // The split is halfway between the last value on the left and the first
+  // value on the right.  There is a nonempty bin on the right, since the right
+  // child holds at least one point.
+  size_t nextBin = bestBin + 1;
+  while (binMin[nextBin] > binMax[nextBin])
+    ++nextBin;
+  classProbabilities.set_size(1);
+  classProbabilities[0] = (binMax[bestBin] + binMin[nextBin]) / 2.0;
+
+  return gain;
+}
+
+template<typename FitnessFunction>
+template<bool UseWeights, typename ElemType>
+double HistogramNumericSplit<FitnessFunction>::SplitIfBetter(
+    const double bestGain,
+    const arma::Mat<size_t>& binCounts,
+    const arma::mat& binWeights,
+    const arma::Col<ElemType>& boundaries,
+    const size_t minimumLeafSize,
+    const double minimumGainSplit,
+    arma::Col<ElemType>& classProbabilities,
+    AuxiliarySplitInfo<ElemType>& /* aux */)
+{
+  // First sanity check: if we don't have enough points, we can't split.
+  if (arma::accu(binCounts) < (minimumLeafSize * 2))
+    return DBL_MAX;
+  if (bestGain == 0.0)
+    return DBL_MAX; // It can't be outperformed.
+
+  size_t bestBin;
+  const double gain = BestBin<UseWeights>(bestGain, binCounts, binWeights,
+      minimumLeafSize, minimumGainSplit, bestBin);
+  if (gain == DBL_MAX)
+    return DBL_MAX;
+
+  // The values of the points are not known, so the split is at the boundary of
+  // the last bin on the left: a point goes left exactly when it is binned to
+  // the left of the split.
+  classProbabilities.set_size(1);
+  classProbabilities[0] = boundaries[bestBin];
+
+  return gain;
+}
+
+template<typename FitnessFunction>
+template<typename ElemType>
+size_t HistogramNumericSplit<FitnessFunction>::CalculateDirection(
+    const ElemType& point,
+    const arma::Col<ElemType>& classProbabilities,
+    const AuxiliarySplitInfo<ElemType>& /* aux */)
+{
+  if (point <= classProbabilities[0])
+    return 0; // Go left.
+  else
+    return 1; // Go right.
+}
+
+template<typename FitnessFunction>
+template<typename VecType>
+void HistogramNumericSplit<FitnessFunction>::BinBoundaries(
+    const VecType& data,
+    const typename VecType::elem_type minValue,
+    const typename VecType::elem_type maxValue,
+    arma::Col<typename VecType::elem_type>& boundaries)
+{
+  typedef typename VecType::elem_type ElemType;
+
+  // Take evenly spaced values as the sample.
+  const size_t sampleSize = std::min((size_t) data.n_elem,
+      (size_t) (16 * MaxBins));
+  arma::Col<ElemType> sample(sampleSize);
+  for (size_t i = 0; i < sampleSize; ++i)
+    sample[i] = data[(i * data.n_elem) / sampleSize];
+  sample = arma::sort(sample);
+
+  // If there are few distinct values, each of them gets a bin; otherwise the
+  // boundaries are the quantiles of the sample.
+  arma::Col<ElemType> candidates = arma::unique(sample);
+  if (candidates.n_elem >= MaxBins)
+  {
+    candidates.set_size(MaxBins - 1);
+    for (size_t b = 0; b < MaxBins - 1; ++b)
+      candidates[b] = sample[((b + 1) * sampleSize) / MaxBins - 1];
+    candidates = arma::unique(candidates);
+  }
+
+  // The last bin holds the largest value, so no boundary may reach it.
+  boundaries = candidates.elem(arma::find(candidates < maxValue));
+  if (boundaries.n_elem == 0)
+  {
+    boundaries.set_size(1);
+    boundaries[0] = minValue;
+  }
+}
+
+template<typename FitnessFunction>
+template<bool UseWeights>
+double HistogramNumericSplit<FitnessFunction>::BestBin(
+    const double bestGain,
+    const arma::Mat<size_t>& binCounts,
+    const arma::mat& binWeights,
+    const size_t minimumLeafSize,
+    const double minimumGainSplit,
+    size_t& bestBin)
+{
+  const size_t numClasses = binCounts.n_rows;
+  const size_t numBins = binCounts.n_cols;
+  const arma::Row<size_t> binSizes = arma::sum(binCounts, 0);
+  const size_t n = arma::accu(binSizes);
+
+  // Loop through the splits between bins, choosing the best one.  Also, force
+  // a minimum leaf size of 1 (empty children don't make sense).
+  double bestFoundGain = std::min(bestGain + minimumGainSplit, 0.0);
+  bestBin = numBins;
+  const size_t minimum = std::max(minimumLeafSize, (size_t) 1);
+
+  // Every point starts on the right; the right statistics are always the
+  // totals minus the left statistics.
+  arma::Mat<size_t> classCounts(numClasses, 2, arma::fill::zeros);
+  classCounts.col(1) = arma::sum(binCounts, 1);
+  arma::mat classWeightSums;
+  double totalWeight = 0.0;
+  double totalLeftWeight = 0.0;
+  double totalRightWeight = 0.0;
+  if (UseWeights)
+  {
+    classWeightSums.zeros(numClasses, 2);
+    classWeightSums.col(1) = arma::sum(binWeights, 1);
+    totalWeight = arma::accu(classWeightSums.col(1));
+    totalRightWeight = totalWeight;
+    bestFoundGain *= totalWeight;
+  }
+  else
+  {
+    bestFoundGain *= n;
+  }
+
+  size_t leftSize = 0;
+  for (size_t bin = 0; bin < numBins - 1; ++bin)
+  {
+    // An empty bin gives the same split as the previous bin.
+    if (binSizes[bin] == 0)
+      continue;
+
+    // Move the bin to the left child.
+    classCounts.col(0) += binCounts.col(bin);
+    classCounts.col(1) -= binCounts.col(bin);
+    if (UseWeights)
+    {
+      const double binWeight = arma::accu(binWeights.col(bin));
+      classWeightSums.col(0) += binWeights.col(bin);
+      classWeightSums.col(1) -= binWeights.col(bin);
+      totalLeftWeight += binWeight;
+      totalRightWeight -= binWeight;
+    }
+    leftSize += binSizes[bin];
+
+    if (leftSize < minimum)
+      continue;
+    if (n - leftSize < minimum)
+      break;
+
+    // Calculate the gain for the left and right child.  Only use weights if
+    // needed.
+    const double leftGain = UseWeights ?
+        FitnessFunction::template EvaluatePtr<true>(classWeightSums.colptr(0),
+            numClasses, totalLeftWeight) :
+        FitnessFunction::template EvaluatePtr<false>(classCounts.colptr(0),
+            numClasses, leftSize);
+    const double rightGain = UseWeights ?
+        FitnessFunction::template EvaluatePtr<true>(classWeightSums.colptr(1),
+            numClasses, totalRightWeight) :
+        FitnessFunction::template EvaluatePtr<false>(classCounts.colptr(1),
+            numClasses, size_t(n - leftSize));
+
+    double gain;
+    if (UseWeights)
+    {
+      gain = totalLeftWeight * leftGain + totalRightWeight * rightGain;
+    }
+    else
+    {
+      // Calculate the gain at this split point.
+      gain = double(leftSize) * leftGain + double(n - leftSize) * rightGain;
+    }
+
+    if (gain > bestFoundGain || gain >= 0.0)
+    {
+      bestFoundGain = gain;
+      bestBin = bin;
+
+      // Corner case: no split will be better than this, so just take this one.
+      if (gain >= 0.0)
+        break;
+    }
+  }
+
+  // If we didn't improve, return the original gain exactly as we got it
+  // (without introducing floating point errors).
+  if (bestBin == numBins)
+    return DBL_MAX;
+
+  if (bestFoundGain >= 0.0)
+    return bestFoundGain;
+
+  if (UseWeights)
+    bestFoundGain /= totalWeight;
+  else
+    bestFoundGain /= n;
+
+  return bestFoundGain;
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,52 @@
+/**
+ * @file methods/decision_tree/numeric_split_traits.hpp
+ *
+ * Definition of the NumericSplitTraits class, which describes properties of
+ * the numeric split policies used by the DecisionTree.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_DECISION_TREE_NUMERIC_SPLIT_TRAITS_HPP
+#define MLPACK_METHODS_DECISION_TREE_NUMERIC_SPLIT_TRAITS_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "histogram_numeric_split.hpp"
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * The NumericSplitTraits class describes properties of a numeric split policy
+ * that the DecisionTree may use while it is being trained.  By default the
+ * policy is given the values of the points of each node.
+ */
+template<typename NumericSplitType>
+class NumericSplitTraits
+{
+ public:
+  /**
+   * This is true if the policy searches histograms of binned values.  The
+   * DecisionTree then bins every dimension once before training (see
+   * HistogramBins) and keeps the histogram of each node, so that the policy
+   * is given the histogram of the node instead of its values.
+   */
+  static const bool UsesBins = false;
+};
+
+/**
+ * The HistogramNumericSplit searches histograms of binned values.
+ */
+template<typename FitnessFunction>
+class NumericSplitTraits<HistogramNumericSplit<FitnessFunction>>
+{
+ public:
+  static const bool UsesBins = true;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
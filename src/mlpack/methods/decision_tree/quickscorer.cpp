@@ -0,0 +1,67 @@
+/**
+ * @file methods/decision_tree/quickscorer.cpp
+ *
+ * Implementation of the non-templated methods of QuickScorer.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "quickscorer.hpp"
+
+using namespace mlpack;
+using namespace mlpack::tree;
+
+void QuickScorer::Clear()
+{
+  numClasses = 0;
+  numWords = 0;
+  nodes.clear();
+  masks.clear();
+  nodeOffsets.clear();
+  thresholds.clear();
+  nodeTrees.clear();
+  maskOffsets.clear();
+  wordOffsets.clear();
+  treeWords.clear();
+  leafOffsets.clear();
+  leafOutputs.clear();
+}
+
+void QuickScorer::BuildIndex()
+{
+  // Sort the nodes by split dimension and then by threshold.  The sort is
+  // stable, so that nodes with the same threshold keep the order of their
+  // trees.
+  std::vector<size_t> order(nodes.size());
+  for (size_t i = 0; i < order.size(); ++i)
+    order[i] = i;
+  std::stable_sort(order.begin(), order.end(),
+      [this](const size_t a, const size_t b)
+      {
+        if (nodes[a].dimension != nodes[b].dimension)
+          return nodes[a].dimension < nodes[b].dimension;
+        return nodes[a].threshold < nodes[b].threshold;
+      });
+
+  size_t numDimensions = 0;
+  for (size_t i = 0; i < nodes.size(); ++i)
+    numDimensions = std::max(numDimensions, nodes[i].dimension + 1);
+
+  nodeOffsets.assign(numDimensions + 1, 0);
+  thresholds.resize(nodes.size());
+  nodeTrees.resize(nodes.size());
+  maskOffsets.resize(nodes.size());
+  for (size_t k = 0; k < order.size(); ++k)
+  {
+    const Node& node = nodes[order[k]];
+    thresholds[k] = node.threshold;
+    nodeTrees[k] = node.tree;
+    maskOffsets[k] = node.maskOffset;
+    ++nodeOffsets[node.dimension + 1];
+  }
+
+  for (size_t d = 0; d < numDimensions; ++d)
+    nodeOffsets[d + 1] += nodeOffsets[d];
+}
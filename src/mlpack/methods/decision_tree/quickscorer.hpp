@@ -0,0 +1,260 @@
+/**
+ * @file methods/decision_tree/quickscorer.hpp
+ *
+ * Definition of QuickScorer, a bitvector representation of an ensemble of
+ * decision trees with binary numeric splits.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_DECISION_TREE_QUICKSCORER_HPP
+#define MLPACK_METHODS_DECISION_TREE_QUICKSCORER_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/data/map_policies/datatype.hpp>
+#include <cstdint>
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * The QuickScorer holds an ensemble of decision trees whose splits are all
+ * binary numeric splits, in the representation of the QuickScorer algorithm:
+ *
+ * @code
+ * @inproceedings{lucchese2015quickscorer,
+ *   title={{QuickScorer}: A Fast Algorithm to Rank Documents with Additive
+ *       Ensembles of Regression Trees},
+ *   author={Lucchese, Claudio and Nardini, Franco Maria and Orlando, Salvatore
+ *       and Perego, Raffaele and Tonellotto, Nicola and Venturini, Rossano},
+ *   booktitle={Proceedings of the 38th International ACM SIGIR Conference on
+ *       Research and Development in Information Retrieval},
+ *   pages={73--82},
+ *   year={2015}
+ * }
+ * @endcode
+ *
+ * The leaves of each tree are numbered from left to right, and each internal
+ * node is stored as its split dimension, its threshold, and a bitvector over
+ * the leaves of its tree in which the leaves of its left subtree are cleared.
+ * The nodes are sorted by split dimension and then by threshold.  To classify
+ * a point, every tree starts with all of its leaves set, and for each
+ * dimension the nodes whose threshold is smaller than the value of the point
+ * (the nodes that send the point right) are visited in order, clearing the
+ * leaves of their left subtrees; the visit of a dimension stops at the first
+ * threshold that is not smaller than the value.  The leaf of each tree that the
+ * point falls in is then the leftmost leaf that is still set.  This replaces
+ * the pointer chasing and the unpredictable branches of the traversal of each
+ * tree with linear scans of contiguous arrays and bitwise operations.
+ *
+ * The output of a leaf is either its class probabilities or a vote for its
+ * majority class, times the weight of its tree; the outputs of the trees are
+ * summed and normalized, so that a random forest and a boosted ensemble of
+ * decision stumps give the same predictions as their own Classify().  Trees are
+ * added with AddTree(); RandomForest::Compile() and AdaBoost::Compile() add all
+ * of their trees.
+ *
+ * The numeric split of the trees must send the values that are not larger than
+ * the first element of its split information to the first child, like
+ * BestBinaryNumericSplit and HistogramNumericSplit do; trees with categorical
+ * splits can't be added.
+ *
+ * @code
+ * extern DecisionTree<> tree;
+ * extern arma::mat points;
+ *
+ * QuickScorer scorer(tree);
+ * arma::Row<size_t> predictions;
+ * scorer.Classify(points, predictions);
+ * @endcode
+ */
+class QuickScorer
+{
+ public:
+  //! Create an empty scorer; AddTree() must be called before classifying.
+  QuickScorer() : numClasses(0), numWords(0) { }
+
+  /**
+   * Create a scorer holding only the given tree, whose leaves output their
+   * class probabilities.
+   *
+   * @param tree Trained tree to add.
+   */
+  template<typename TreeType>
+  QuickScorer(const TreeType& tree);
+
+  /**
+   * Add the given tree to the ensemble.  An std::invalid_argument exception is
+   * thrown if the tree has a categorical split, or if its number of classes is
+   * not the number of classes of the trees already added.
+   *
+   * @param tree Trained tree to add.
+   * @param weight Weight of the output of the tree.
+   * @param vote If true, each leaf votes for its majority class; otherwise,
+   *     each leaf outputs its class probabilities.
+   */
+  template<typename TreeType>
+  void AddTree(const TreeType& tree,
+               const double weight = 1.0,
+               const bool vote = false);
+
+  //! Remove all the trees.
+  void Clear();
+
+  /**
+   * Compute the sum of the weighted outputs of the leaves the given point
+   * falls in.
+   *
+   * @param point Point to score.
+   * @param scores Vector to store the score of each class in.
+   */
+  template<typename VecType>
+  void Scores(const VecType& point, arma::vec& scores) const;
+
+  /**
+   * Classify the given point.  The predicted label is returned.
+   *
+   * @param point Point to classify.
+   */
+  template<typename VecType>
+  size_t Classify(const VecType& point) const;
+
+  /**
+   * Classify the given point and also return estimates of the probability for
+   * each class in the given vector.
+   *
+   * @param point Point to classify.
+   * @param prediction This will be set to the predicted class of the point.
+   * @param probabilities This will be filled with class probabilities for the
+   *      point.
+   */
+  template<typename VecType>
+  void Classify(const VecType& point,
+                size_t& prediction,
+                arma::vec& probabilities) const;
+
+  /**
+   * Classify the given points, in parallel.  The predicted labels for each
+   * point are stored in the given vector.
+   *
+   * @param data Set of points to classify.
+   * @param predictions This will be filled with predictions for each point.
+   */
+  template<typename MatType>
+  void Classify(const MatType& data,
+                arma::Row<size_t>& predictions) const;
+
+  /**
+   * Classify the given points, in parallel, and also return estimates of the
+   * probabilities for each class in the given matrix.
+   *
+   * @param data Set of points to classify.
+   * @param predictions This will be filled with predictions for each point.
+   * @param probabilities This will be filled with class probabilities for each
+   *      point.
+   */
+  template<typename MatType>
+  void Classify(const MatType& data,
+                arma::Row<size_t>& predictions,
+                arma::mat& probabilities) const;
+
+  //! Get the number of trees.
+  size_t NumTrees() const { return wordOffsets.size(); }
+  //! Get the number of internal nodes of all the trees.
+  size_t NumNodes() const { return thresholds.size(); }
+  //! Get the number of leaves of all the trees.
+  size_t NumLeaves() const { return leafOutputs.n_cols; }
+  //! Get the number of classes.
+  size_t NumClasses() const { return numClasses; }
+
+ private:
+  //! An internal node, before the nodes of all the trees are sorted.
+  struct Node
+  {
+    size_t dimension;
+    double threshold;
+    size_t tree;
+    size_t maskOffset;
+  };
+
+  /**
+   * Number the leaves of the subtree of the given node from left to right,
+   * starting at the given leaf, and store the internal nodes and their masks.
+   * Returns the number of leaves of the subtree.
+   */
+  template<typename TreeType>
+  size_t AddNode(const TreeType& node,
+                 const size_t tree,
+                 const size_t firstLeaf,
+                 const double weight,
+                 const bool vote,
+                 std::vector<std::pair<size_t, size_t>>& leftLeaves,
+                 std::vector<double>& outputs);
+
+  //! Sort the internal nodes of all the trees into the search arrays.
+  void BuildIndex();
+
+  /**
+   * Find the leaf that the given point falls in in each tree, using the given
+   * buffer for the bitvectors, and add their outputs to the scores.
+   */
+  template<typename VecType>
+  void Scores(const VecType& point,
+              std::vector<uint64_t>& leaves,
+              double* scores) const;
+
+  //! Compute the index of the lowest set bit of the given nonzero word.
+  static size_t LowestSetBit(uint64_t word)
+  {
+    #if defined(__GNUC__)
+    return __builtin_ctzll(word);
+    #else
+    size_t bit = 0;
+    while ((word & 1) == 0)
+    {
+      word >>= 1;
+      ++bit;
+    }
+    return bit;
+    #endif
+  }
+
+  //! The number of classes.
+  size_t numClasses;
+  //! The total number of bitvector words of all the trees.
+  size_t numWords;
+
+  //! The internal nodes of all the trees, in insertion order.
+  std::vector<Node> nodes;
+  //! The cleared bits of every node (numWords of its tree per node).
+  std::vector<uint64_t> masks;
+
+  //! The nodes splitting on dimension d are nodeOffsets[d] to
+  //! nodeOffsets[d + 1] - 1 in the sorted arrays below.
+  std::vector<size_t> nodeOffsets;
+  //! The threshold of each sorted node.
+  std::vector<double> thresholds;
+  //! The tree of each sorted node.
+  std::vector<size_t> nodeTrees;
+  //! The offset of the mask of each sorted node in masks.
+  std::vector<size_t> maskOffsets;
+
+  //! The offset of the first bitvector word of each tree.
+  std::vector<size_t> wordOffsets;
+  //! The number of bitvector words of each tree.
+  std::vector<size_t> treeWords;
+  //! The index of the first leaf of each tree in leafOutputs.
+  std::vector<size_t> leafOffsets;
+  //! The weighted output of each leaf.
+  arma::mat leafOutputs;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+// Include implementation.
+#include "quickscorer_impl.hpp"
+
+#endif
@@ -0,0 +1,266 @@
+/**
+ * @file methods/decision_tree/quickscorer_impl.hpp
+ *
+ * Implementation of the templated methods of QuickScorer.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_DECISION_TREE_QUICKSCORER_IMPL_HPP
+#define MLPACK_METHODS_DECISION_TREE_QUICKSCORER_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "quickscorer.hpp"
+
+namespace mlpack {
+namespace tree {
+
+template<typename TreeType>
+QuickScorer::QuickScorer(const TreeType& tree) :
+    numClasses(0),
+    numWords(0)
+{
+  AddTree(tree);
+}
+
+template<typename TreeType>
+void QuickScorer::AddTree(const TreeType& tree,
+                          const double weight,
+                          const bool vote)
+{
+  if (NumTrees() > 0 && tree.NumClasses() != numClasses)
+  {
+    std::ostringstream oss;
+    oss << "QuickScorer::AddTree(): the tree has " << tree.NumClasses()
+        << " classes, but the trees of the scorer have " << numClasses
+        << " classes!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  // Collect the nodes of the tree; if the tree can't be added, the scorer is
+  // left unchanged.
+  const size_t treeIndex = NumTrees();
+  const size_t firstNode = nodes.size();
+  std::vector<std::pair<size_t, size_t>> leftLeaves;
+  std::vector<double> outputs;
+  size_t numLeaves;
+  try
+  {
+    numLeaves = AddNode(tree, treeIndex, 0, weight, vote, leftLeaves,
+        outputs);
+  }
+  catch (std::invalid_argument&)
+  {
+    nodes.resize(firstNode);
+    throw;
+  }
+
+  numClasses = tree.NumClasses();
+  const size_t words = (numLeaves + 63) / 64;
+  for (size_t i = 0; i < leftLeaves.size(); ++i)
+  {
+    Node& node = nodes[firstNode + i];
+    node.maskOffset = masks.size();
+    masks.resize(masks.size() + words, ~uint64_t(0));
+    for (size_t leaf = leftLeaves[i].first; leaf < leftLeaves[i].second;
+        ++leaf)
+    {
+      masks[node.maskOffset + leaf / 64] &= ~(uint64_t(1) << (leaf % 64));
+    }
+  }
+
+  wordOffsets.push_back(numWords);
+  treeWords.push_back(words);
+  numWords += words;
+
+  leafOffsets.push_back(leafOutputs.n_cols);
+  const arma::mat treeOutputs(outputs.data(), numClasses, numLeaves);
+  if (leafOutputs.n_cols == 0)
+    leafOutputs = treeOutputs;
+  else
+    leafOutputs = arma::join_rows(leafOutputs, treeOutputs);
+
+  BuildIndex();
+}
+
+template<typename TreeType>
+size_t QuickScorer::AddNode(const TreeType& node,
+                            const size_t tree,
+                            const size_t firstLeaf,
+                            const double weight,
+                            const bool vote,
+                            std::vector<std::pair<size_t, size_t>>& leftLeaves,
+                            std::vector<double>& outputs)
+{
+  if (node.children.size() == 0)
+  {
+    for (size_t c = 0; c < node.classProbabilities.n_elem; ++c)
+    {
+      if (vote)
+        outputs.push_back((c == node.dimensionTypeOrMajorityClass) ? weight :
+            0.0);
+      else
+        outputs.push_back(weight * node.classProbabilities[c]);
+    }
+
+    return 1;
+  }
+
+  if (node.children.size() != 2 || (data::Datatype)
+      node.dimensionTypeOrMajorityClass == data::Datatype::categorical)
+  {
+    throw std::invalid_argument("QuickScorer::AddTree(): only trees with "
+        "binary numeric splits can be added!");
+  }
+
+  // The mask of the node clears the leaves of its left subtree.
+  const size_t index = leftLeaves.size();
+  Node split;
+  split.dimension = node.splitDimension;
+  split.threshold = node.classProbabilities[0];
+  split.tree = tree;
+  split.maskOffset = 0;
+  nodes.push_back(split);
+  leftLeaves.push_back(std::make_pair(firstLeaf, firstLeaf));
+
+  const size_t leftCount = AddNode(*node.children[0], tree, firstLeaf, weight,
+      vote, leftLeaves, outputs);
+  leftLeaves[index].second = firstLeaf + leftCount;
+  const size_t rightCount = AddNode(*node.children[1], tree,
+      firstLeaf + leftCount, weight, vote, leftLeaves, outputs);
+
+  return leftCount + rightCount;
+}
+
+template<typename VecType>
+void QuickScorer::Scores(const VecType& point, arma::vec& scores) const
+{
+  if (NumTrees() == 0)
+  {
+    throw std::invalid_argument("QuickScorer::Scores(): no trees have been "
+        "added!");
+  }
+
+  std::vector<uint64_t> leaves;
+  scores.zeros(numClasses);
+  Scores(point, leaves, scores.memptr());
+}
+
+template<typename VecType>
+size_t QuickScorer::Classify(const VecType& point) const
+{
+  arma::vec scores;
+  Scores(point, scores);
+  return scores.index_max();
+}
+
+template<typename VecType>
+void QuickScorer::Classify(const VecType& point,
+                           size_t& prediction,
+                           arma::vec& probabilities) const
+{
+  Scores(point, probabilities);
+  probabilities /= arma::accu(probabilities);
+  prediction = probabilities.index_max();
+}
+
+template<typename MatType>
+void QuickScorer::Classify(const MatType& data,
+                           arma::Row<size_t>& predictions) const
+{
+  if (NumTrees() == 0)
+  {
+    throw std::invalid_argument("QuickScorer::Classify(): no trees have been "
+        "added!");
+  }
+
+  predictions.set_size(data.n_cols);
+
+  #pragma omp parallel
+  {
+    std::vector<uint64_t> leaves;
+    arma::vec scores(numClasses);
+
+    #pragma omp for
+    for (omp_size_t i = 0; i < (omp_size_t) data.n_cols; ++i)
+    {
+      scores.zeros();
+      Scores(data.col(i), leaves, scores.memptr());
+      predictions[i] = scores.index_max();
+    }
+  }
+}
+
+template<typename MatType>
+void QuickScorer::Classify(const MatType& data,
+                           arma::Row<size_t>& predictions,
+                           arma::mat& probabilities) const
+{
+  if (NumTrees() == 0)
+  {
+    throw std::invalid_argument("QuickScorer::Classify(): no trees have been "
+        "added!");
+  }
+
+  predictions.set_size(data.n_cols);
+  probabilities.zeros(numClasses, data.n_cols);
+
+  #pragma omp parallel
+  {
+    std::vector<uint64_t> leaves;
+
+    #pragma omp for
+    for (omp_size_t i = 0; i < (omp_size_t) data.n_cols; ++i)
+    {
+      Scores(data.col(i), leaves, probabilities.colptr(i));
+      probabilities.col(i) /= arma::accu(probabilities.col(i));
+      predictions[i] = probabilities.col(i).index_max();
+    }
+  }
+}
+
+template<typename VecType>
+void QuickScorer::Scores(const VecType& point,
+                         std::vector<uint64_t>& leaves,
+                         double* scores) const
+{
+  leaves.assign(numWords, ~uint64_t(0));
+
+  // Visit the nodes that send the point right, clearing the leaves of their
+  // left subtrees.  The thresholds of each dimension are sorted, so the visit
+  // of a dimension stops at the first node that sends the point left.
+  for (size_t d = 0; d + 1 < nodeOffsets.size(); ++d)
+  {
+    const double value = point[d];
+    for (size_t k = nodeOffsets[d]; k < nodeOffsets[d + 1] &&
+        thresholds[k] < value; ++k)
+    {
+      const size_t tree = nodeTrees[k];
+      const uint64_t* mask = masks.data() + maskOffsets[k];
+      uint64_t* words = leaves.data() + wordOffsets[tree];
+      for (size_t w = 0; w < treeWords[tree]; ++w)
+        words[w] &= mask[w];
+    }
+  }
+
+  // The exit leaf of each tree is its leftmost remaining leaf.
+  for (size_t t = 0; t < wordOffsets.size(); ++t)
+  {
+    const uint64_t* words = leaves.data() + wordOffsets[t];
+    size_t w = 0;
+    while (words[w] == 0)
+      ++w;
+
+    const size_t leaf = 64 * w + LowestSetBit(words[w]);
+    const double* output = leafOutputs.colptr(leafOffsets[t] + leaf);
+    for (size_t c = 0; c < numClasses; ++c)
+      scores[c] += output[c];
+  }
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
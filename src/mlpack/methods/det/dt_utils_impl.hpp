@@ -173,7 +173,9 @@ DTree<MatType, TagType>* Trainer(MatType& dataset,
   Log::Info << prunedSequence.size() << " trees in the sequence; maximum alpha:"
       << " " << oldAlpha << "." << std::endl;
 
-  const MatType cvData(dataset);
+  // The folds are grown on the dataset itself: each fold tree only reorders
+  // its own vector of indices of the training points.
+  const MatType& cvData = dataset;
   const size_t testSize = dataset.n_cols / folds;
 
   arma::vec regularizationConstants(prunedSequence.size());
@@ -192,33 +194,18 @@ DTree<MatType, TagType>* Trainer(MatType& dataset,
     const size_t end = std::min((size_t) (fold + 1)
                                 * testSize, (size_t) cvData.n_cols);
 
-    MatType test = cvData.cols(start, end - 1);
-    MatType train(cvData.n_rows, cvData.n_cols - test.n_cols);
-
-    if (start == 0 && end < cvData.n_cols)
-    {
-      train.cols(0, train.n_cols - 1) = cvData.cols(end, cvData.n_cols - 1);
-    }
-    else if (start > 0 && end == cvData.n_cols)
-    {
-      train.cols(0, train.n_cols - 1) = cvData.cols(0, start - 1);
-    }
-    else
-    {
-      train.cols(0, start - 1) = cvData.cols(0, start - 1);
-      train.cols(start, train.n_cols - 1) = cvData.cols(end, cvData.n_cols - 1);
-    }
+    // The training points are all the points outside of [start, end).
+    arma::Col<size_t> trainIndices(cvData.n_cols - (end - start));
+    for (size_t i = 0; i < start; ++i)
+      trainIndices[i] = i;
+    for (size_t i = end; i < cvData.n_cols; ++i)
+      trainIndices[i - (end - start)] = i;
 
     // Initialize the tree.
-    DTree<MatType, TagType> cvDTree(train);
-
-    // Getting ready to grow the tree...
-    arma::Col<size_t> cvOldFromNew(train.n_cols);
-    for (size_t i = 0; i < cvOldFromNew.n_elem; ++i)
-      cvOldFromNew[i] = i;
+    DTree<MatType, TagType> cvDTree(cvData, trainIndices);
 
     // Grow the tree.
-    cvDTree.Grow(train, cvOldFromNew, useVolumeReg, maxLeafSize,
+    cvDTree.Grow(cvData, trainIndices, useVolumeReg, maxLeafSize,
         minLeafSize);
 
     // Sequentially prune with all the values of available alphas and adding
@@ -231,9 +218,9 @@ DTree<MatType, TagType>* Trainer(MatType& dataset,
     {
       // Compute test values for this state of the tree.
       double cvVal = 0.0;
-      for (size_t j = 0; j < test.n_cols; ++j)
+      for (size_t j = start; j < end; ++j)
       {
-        arma::vec testPoint = test.unsafe_col(j);
+        const typename MatType::vec_type testPoint = cvData.unsafe_col(j);
         cvVal += cvDTree.ComputeValue(testPoint);
       }
 
@@ -243,14 +230,14 @@ DTree<MatType, TagType>* Trainer(MatType& dataset,
       // Determine the new alpha value and prune accordingly.
       double cvOldAlpha = 0.5 * (prunedSequence[i + 1].first
                                  + prunedSequence[i + 2].first);
-      cvDTree.PruneAndUpdate(cvOldAlpha, train.n_cols, useVolumeReg);
+      cvDTree.PruneAndUpdate(cvOldAlpha, trainIndices.n_elem, useVolumeReg);
     }
 
     // Compute test values for this state of the tree.
     double cvVal = 0.0;
-    for (size_t i = 0; i < test.n_cols; ++i)
+    for (size_t i = start; i < end; ++i)
     {
-      typename MatType::vec_type testPoint = test.unsafe_col(i);
+      const typename MatType::vec_type testPoint = cvData.unsafe_col(i);
       cvVal += cvDTree.ComputeValue(testPoint);
     }
 
@@ -108,6 +108,16 @@ class DTree
    */
   DTree(MatType& data);
 
+  /**
+   * Create a density estimation tree on the points of the given data with the
+   * given indices.  The data is not modified; use the Grow() overload that
+   * takes a const dataset, with the same indices, to grow the tree.
+   *
+   * @param data Dataset to build tree on.
+   * @param indices Indices of the points of data the tree is built on.
+   */
+  DTree(const MatType& data, const arma::Col<size_t>& indices);
+
   /**
    * Create a child node of a density estimation tree given the bounding box
    * specified by maxVals and minVals, using the size given in start and end and
@@ -163,6 +173,38 @@ class DTree
               const size_t maxLeafSize = 10,
               const size_t minLeafSize = 5);
 
+  /**
+   * Greedily expand the tree on the points of the given data with the given
+   * indices, without modifying the data: instead of the points, the indices
+   * are reordered during tree growth, so that after growth the points of a
+   * node are the points whose indices are in [Start(), End()) of indices.  The
+   * tree is the same as the one the other overload builds on a copy of those
+   * points.
+   *
+   * @param data Dataset to build tree on.
+   * @param indices Indices of the points of the tree; they are reordered.
+   * @param useVolReg If true, volume regularization is used.
+   * @param maxLeafSize Maximum size of a leaf.
+   * @param minLeafSize Minimum size of a leaf.
+   */
+  double Grow(const MatType& data,
+              arma::Col<size_t>& indices,
+              const bool useVolReg = false,
+              const size_t maxLeafSize = 10,
+              const size_t minLeafSize = 5);
+
+  /**
+   * Get or modify the minimum number of points a node must hold for its two
+   * children to be grown as separate OpenMP tasks.  Smaller nodes grow their
+   * children serially; the resulting tree is the same either way.  The setting
+   * is shared by all trees of this type.
+   */
+  static size_t& ParallelGrowThreshold()
+  {
+    static size_t threshold = 10000;
+    return threshold;
+  }
+
   /**
    * Perform alpha pruning on a tree.  Returns the new value of alpha.
    *
@@ -343,7 +385,8 @@ class DTree
                  ElemType& splitValue,
                  double& leftError,
                  double& rightError,
-                 const size_t minLeafSize = 5) const;
+                 const size_t minLeafSize = 5,
+                 const arma::Col<size_t>* indices = NULL) const;
 
   /**
    * Split the data, returning the number of points left of the split.
@@ -353,6 +396,40 @@ class DTree
                    const ElemType splitValue,
                    arma::Col<size_t>& oldFromNew) const;
 
+  /**
+   * Split the indices of the points of the node without modifying the data,
+   * returning the number of points left of the split.
+   */
+  size_t SplitData(const MatType& data,
+                   const size_t splitDim,
+                   const ElemType splitValue,
+                   arma::Col<size_t>& indices) const;
+
+  /**
+   * Grow the subtree of this node.  If DataType is const, the data is not
+   * modified and oldFromNew holds the indices of the points of each node.
+   */
+  template<typename DataType>
+  double GrowNode(DataType& data,
+                  arma::Col<size_t>& oldFromNew,
+                  const bool useVolReg,
+                  const size_t maxLeafSize,
+                  const size_t minLeafSize);
+
+  /**
+   * Grow the two children of this node, which has already been split.  Large
+   * nodes grow the two children as separate OpenMP tasks; see
+   * ParallelGrowThreshold().
+   */
+  template<typename DataType>
+  void GrowChildren(DataType& data,
+                    arma::Col<size_t>& oldFromNew,
+                    const bool useVolReg,
+                    const size_t maxLeafSize,
+                    const size_t minLeafSize,
+                    double& leftG,
+                    double& rightG);
+
   void  FillMinMax(const StatType& mins,
                    const StatType& maxs);
 };
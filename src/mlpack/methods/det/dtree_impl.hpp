@@ -147,6 +147,34 @@ void ExtractSplits(std::vector<std::pair<ElemType, size_t>>& splitVec,
   }
 }
 
+// The implementation for points given by their indices in the dataset, which
+// isn't reordered.  It works for both dense and sparse matrices.
+template<typename ElemType, typename MatType>
+void ExtractSplits(std::vector<std::pair<ElemType, size_t>>& splitVec,
+                   const MatType& data,
+                   size_t dim,
+                   const arma::Col<size_t>& indices,
+                   const size_t start,
+                   const size_t end,
+                   const size_t minLeafSize)
+{
+  typedef std::pair<ElemType, size_t> SplitItem;
+  std::vector<ElemType> dimVec(end - start);
+  for (size_t i = start; i < end; ++i)
+    dimVec[i - start] = data(dim, indices[i]);
+
+  std::sort(dimVec.begin(), dimVec.end());
+
+  for (size_t i = minLeafSize - 1; i < dimVec.size() - minLeafSize; ++i)
+  {
+    // See the general implementation above.
+    const ElemType split = (dimVec[i] + dimVec[i + 1]) / 2.0;
+
+    if (split != dimVec[i])
+      splitVec.push_back(SplitItem(split, i + 1));
+  }
+}
+
 } // namespace details
 
 template<typename MatType, typename TagType>
@@ -354,6 +382,41 @@ DTree<MatType, TagType>::DTree(MatType & data) :
   logNegError = LogNegativeError(data.n_cols);
 }
 
+template<typename MatType, typename TagType>
+DTree<MatType, TagType>::DTree(const MatType& data,
+                               const arma::Col<size_t>& indices) :
+    start(0),
+    end(indices.n_elem),
+    maxVals(data.n_rows),
+    minVals(data.n_rows),
+    splitDim(size_t(-1)),
+    splitValue(std::numeric_limits<ElemType>::max()),
+    subtreeLeavesLogNegError(-DBL_MAX),
+    subtreeLeaves(0),
+    root(true),
+    ratio(1.0),
+    logVolume(-DBL_MAX),
+    bucketTag(-1),
+    alphaUpper(0.0),
+    left(NULL),
+    right(NULL)
+{
+  // The bounds only cover the given points.
+  maxVals.fill(std::numeric_limits<ElemType>::lowest());
+  minVals.fill(std::numeric_limits<ElemType>::max());
+  for (size_t i = 0; i < indices.n_elem; ++i)
+  {
+    for (size_t d = 0; d < data.n_rows; ++d)
+    {
+      const ElemType value = data(d, indices[i]);
+      maxVals[d] = std::max(maxVals[d], value);
+      minVals[d] = std::min(minVals[d], value);
+    }
+  }
+
+  logNegError = LogNegativeError(indices.n_elem);
+}
+
 // Non-root node initializers.
 template<typename MatType, typename TagType>
 DTree<MatType, TagType>::DTree(const StatType& maxVals,
@@ -439,7 +502,8 @@ bool DTree<MatType, TagType>::FindSplit(const MatType& data,
                                         ElemType& splitValue,
                                         double& leftError,
                                         double& rightError,
-                                        const size_t minLeafSize) const
+                                        const size_t minLeafSize,
+                                        const arma::Col<size_t>* indices) const
 {
   typedef std::pair<ElemType, size_t> SplitItem;
 
@@ -449,6 +513,7 @@ bool DTree<MatType, TagType>::FindSplit(const MatType& data,
   Log::Assert(data.n_rows == minVals.n_elem);
 
   const size_t points = end - start;
+  const size_t totalPoints = indices ? indices->n_elem : data.n_cols;
 
   double minError = logNegError;
   bool splitFound = false;
@@ -488,8 +553,16 @@ bool DTree<MatType, TagType>::FindSplit(const MatType& data,
     // sparse matrices.
 
     std::vector<SplitItem> splitVec;
-    details::ExtractSplits<ElemType>(splitVec, data, dim, start, end,
-        minLeafSize);
+    if (indices)
+    {
+      details::ExtractSplits<ElemType>(splitVec, data, dim, *indices, start,
+          end, minLeafSize);
+    }
+    else
+    {
+      details::ExtractSplits<ElemType>(splitVec, data, dim, start, end,
+          minLeafSize);
+    }
 
     // Iterate on all the splits for this dimension
     for (typename std::vector<SplitItem>::iterator i = splitVec.begin();
@@ -529,7 +602,7 @@ bool DTree<MatType, TagType>::FindSplit(const MatType& data,
     }
 
     const double actualMinDimError = std::log(minDimError)
-      - 2 * std::log((double) data.n_cols)
+      - 2 * std::log((double) totalPoints)
       - volumeWithoutDim;
 
 #pragma omp critical(DTreeFindUpdate)
@@ -540,9 +613,9 @@ bool DTree<MatType, TagType>::FindSplit(const MatType& data,
       minError = actualMinDimError;
       splitDim = dim;
       splitValue = dimSplitValue;
-      leftError = std::log(dimLeftError) - 2 * std::log((double) data.n_cols)
+      leftError = std::log(dimLeftError) - 2 * std::log((double) totalPoints)
         - volumeWithoutDim;
-      rightError = std::log(dimRightError) - 2 * std::log((double) data.n_cols)
+      rightError = std::log(dimRightError) - 2 * std::log((double) totalPoints)
         - volumeWithoutDim;
       splitFound = true;
     } // end if better split found in this dimension.
@@ -585,6 +658,33 @@ size_t DTree<MatType, TagType>::SplitData(MatType& data,
   return left;
 }
 
+template<typename MatType, typename TagType>
+size_t DTree<MatType, TagType>::SplitData(const MatType& data,
+                                          const size_t splitDim,
+                                          const ElemType splitValue,
+                                          arma::Col<size_t>& indices) const
+{
+  // The same partition as above, but only the indices are swapped.
+  size_t left = start;
+  size_t right = end - 1;
+  for (;;)
+  {
+    while (data(splitDim, indices[left]) <= splitValue)
+      ++left;
+    while (data(splitDim, indices[right]) > splitValue)
+      --right;
+
+    if (left > right)
+      break;
+
+    const size_t tmp = indices[left];
+    indices[left] = indices[right];
+    indices[right] = tmp;
+  }
+
+  return left;
+}
+
 // Greedily expand the tree.
 template<typename MatType, typename TagType>
 double DTree<MatType, TagType>::Grow(MatType& data,
@@ -592,10 +692,38 @@ double DTree<MatType, TagType>::Grow(MatType& data,
                                      const bool useVolReg,
                                      const size_t maxLeafSize,
                                      const size_t minLeafSize)
+{
+  return GrowNode(data, oldFromNew, useVolReg, maxLeafSize, minLeafSize);
+}
+
+// Greedily expand the tree, reordering only the indices of the points.
+template<typename MatType, typename TagType>
+double DTree<MatType, TagType>::Grow(const MatType& data,
+                                     arma::Col<size_t>& indices,
+                                     const bool useVolReg,
+                                     const size_t maxLeafSize,
+                                     const size_t minLeafSize)
+{
+  return GrowNode(data, indices, useVolReg, maxLeafSize, minLeafSize);
+}
+
+template<typename MatType, typename TagType>
+template<typename DataType>
+double DTree<MatType, TagType>::GrowNode(DataType& data,
+                                         arma::Col<size_t>& oldFromNew,
+                                         const bool useVolReg,
+                                         const size_t maxLeafSize,
+                                         const size_t minLeafSize)
 {
   Log::Assert(data.n_rows == maxVals.n_elem);
   Log::Assert(data.n_rows == minVals.n_elem);
 
+  // If the dataset can't be reordered, oldFromNew holds the indices of the
+  // points of each node.
+  const arma::Col<size_t>* indices =
+      std::is_const<DataType>::value ? &oldFromNew : NULL;
+  const size_t totalPoints = oldFromNew.n_elem;
+
   double leftG, rightG;
 
   // Compute points ratio.
@@ -614,7 +742,8 @@ double DTree<MatType, TagType>::Grow(MatType& data,
     size_t dim;
     double splitValueTmp;
     double leftError, rightError;
-    if (FindSplit(data, dim, splitValueTmp, leftError, rightError, minLeafSize))
+    if (FindSplit(data, dim, splitValueTmp, leftError, rightError, minLeafSize,
+        indices))
     {
       // Move the data around for the children to have points in a node lie
       // contiguously (to increase efficiency during the training).
@@ -637,10 +766,8 @@ double DTree<MatType, TagType>::Grow(MatType& data,
       left = new DTree(maxValsL, minValsL, start, splitIndex, leftError);
       right = new DTree(maxValsR, minValsR, splitIndex, end, rightError);
 
-      leftG = left->Grow(data, oldFromNew, useVolReg, maxLeafSize,
-                         minLeafSize);
-      rightG = right->Grow(data, oldFromNew, useVolReg, maxLeafSize,
-                           minLeafSize);
+      GrowChildren(data, oldFromNew, useVolReg, maxLeafSize, minLeafSize,
+          leftG, rightG);
 
       // Store values of R(T~) and |T~|.
       subtreeLeaves = left->SubtreeLeaves() + right->SubtreeLeaves();
@@ -695,7 +822,7 @@ double DTree<MatType, TagType>::Grow(MatType& data,
 
     if (left->SubtreeLeaves() > 1)
     {
-      const double exponent = 2 * std::log((double) data.n_cols) + logVolume +
+      const double exponent = 2 * std::log((double) totalPoints) + logVolume +
           left->AlphaUpper();
 
       // Whether or not this will overflow is highly dependent on the depth of
@@ -705,14 +832,14 @@ double DTree<MatType, TagType>::Grow(MatType& data,
 
     if (right->SubtreeLeaves() > 1)
     {
-      const double exponent = 2 * std::log((double) data.n_cols)
+      const double exponent = 2 * std::log((double) totalPoints)
         + logVolume
         + right->AlphaUpper();
 
       tmpAlphaSum += std::exp(exponent);
     }
 
-    alphaUpper = std::log(tmpAlphaSum) - 2 * std::log((double) data.n_cols)
+    alphaUpper = std::log(tmpAlphaSum) - 2 * std::log((double) totalPoints)
       - logVolume;
 
     double gT;
@@ -735,6 +862,48 @@ double DTree<MatType, TagType>::Grow(MatType& data,
 }
 
 
+template<typename MatType, typename TagType>
+template<typename DataType>
+void DTree<MatType, TagType>::GrowChildren(DataType& data,
+                                           arma::Col<size_t>& oldFromNew,
+                                           const bool useVolReg,
+                                           const size_t maxLeafSize,
+                                           const size_t minLeafSize,
+                                           double& leftG,
+                                           double& rightG)
+{
+  // The two children work on disjoint ranges of the points (and of
+  // oldFromNew), so they can be grown at the same time and the tree will be
+  // exactly the same as if it were grown serially.
+  const bool parallel = (end - start) >= ParallelGrowThreshold();
+
+  #ifdef HAS_OPENMP
+  // The first large node opens the parallel region (unless the tree is being
+  // grown inside one already); the tasks for all of its descendants are then
+  // run by the threads of that region.
+  if (parallel && omp_get_level() == 0 && omp_get_max_threads() > 1)
+  {
+    #pragma omp parallel
+    {
+      #pragma omp single
+      GrowChildren(data, oldFromNew, useVolReg, maxLeafSize, minLeafSize,
+          leftG, rightG);
+    }
+    return;
+  }
+  #endif
+
+  // The left child is grown as a task while this thread grows the right child.
+  #pragma omp task if (parallel) default(shared)
+  leftG = left->GrowNode(data, oldFromNew, useVolReg, maxLeafSize,
+      minLeafSize);
+
+  rightG = right->GrowNode(data, oldFromNew, useVolReg, maxLeafSize,
+      minLeafSize);
+
+  #pragma omp taskwait
+}
+
 template<typename MatType, typename TagType>
 double DTree<MatType, TagType>::PruneAndUpdate(const double oldAlpha,
                                                const size_t points,
@@ -0,0 +1,111 @@
+/**
+ * @file methods/emst/concurrent_union_find.hpp
+ *
+ * Implements a lock-free union-find data structure, which can be used by many
+ * threads at once.  Like UnionFind, it tracks the components of a graph: each
+ * point is initially in its own component, Union(x, y) unites the components
+ * of x and y, and Find(x) returns the index of the component containing x.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_EMST_CONCURRENT_UNION_FIND_HPP
+#define MLPACK_METHODS_EMST_CONCURRENT_UNION_FIND_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <atomic>
+
+namespace mlpack {
+namespace emst {
+
+/**
+ * A union-find data structure that is safe to use from several threads at
+ * once without locks.  Each parent pointer is an atomic, and all updates are
+ * made with compare-and-swap operations:
+ *
+ *  - Union() always links the root with the larger index below the root with
+ *    the smaller index, so the parent of a point never has a larger index than
+ *    the point itself, and no cycle can ever be formed by concurrent unions.
+ *    If another thread changes the root in the meantime, the compare-and-swap
+ *    fails and the roots are looked up again.
+ *
+ *  - Find() uses path halving: every point on the path to the root is made to
+ *    point to its grandparent.  A failed compare-and-swap only means that
+ *    another thread already shortened the path.
+ *
+ * While unions are running concurrently, Find() only returns the root at some
+ * point during the call; once all threads are done, Find() gives the final
+ * components.
+ */
+class ConcurrentUnionFind
+{
+ public:
+  //! Construct the object with the given size.
+  ConcurrentUnionFind(const size_t size) : parent(size)
+  {
+    for (size_t i = 0; i < size; ++i)
+      parent[i].store(i);
+  }
+
+  /**
+   * Returns the component containing an element.
+   *
+   * @param x the component to be found
+   * @return The index of the component containing x
+   */
+  size_t Find(size_t x)
+  {
+    while (true)
+    {
+      size_t xParent = parent[x].load();
+      if (xParent == x)
+        return x;
+
+      // Make x point to its grandparent, if it isn't a root.
+      const size_t xGrandparent = parent[xParent].load();
+      if (xGrandparent != xParent)
+        parent[x].compare_exchange_weak(xParent, xGrandparent);
+
+      x = xGrandparent;
+    }
+  }
+
+  /**
+   * Union the components containing x and y.
+   *
+   * @param x one component
+   * @param y the other component
+   */
+  void Union(const size_t x, const size_t y)
+  {
+    while (true)
+    {
+      size_t xRoot = Find(x);
+      size_t yRoot = Find(y);
+      if (xRoot == yRoot)
+        return;
+
+      // Link the root with the larger index below the other root.
+      if (xRoot < yRoot)
+        std::swap(xRoot, yRoot);
+
+      size_t expected = xRoot;
+      if (parent[xRoot].compare_exchange_strong(expected, yRoot))
+        return;
+    }
+  }
+
+  //! Get the number of elements.
+  size_t Size() const { return parent.size(); }
+
+ private:
+  //! The parent of each element.
+  std::vector<std::atomic<size_t>> parent;
+}; // class ConcurrentUnionFind
+
+} // namespace emst
+} // namespace mlpack
+
+#endif // MLPACK_METHODS_EMST_CONCURRENT_UNION_FIND_HPP
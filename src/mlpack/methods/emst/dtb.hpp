@@ -27,6 +27,7 @@
 
 #include "dtb_stat.hpp"
 #include "edge_pair.hpp"
+#include "concurrent_union_find.hpp"
 
 #include <mlpack/prereqs.hpp>
 #include <mlpack/core/metrics/lmetric.hpp>
@@ -68,6 +69,12 @@ namespace emst /** Euclidean Minimum Spanning Trees. */ {
  * More advanced usage of the class can use different types of trees, pass in an
  * already-built tree, or compute the MST using the O(n^2) naive algorithm.
  *
+ * Each Boruvka iteration can be run on several threads (see NumThreads()).
+ * The tree is split into disjoint subtrees that are traversed in parallel, and
+ * each thread keeps its own candidate edge for every component; the candidates
+ * are merged once the traversals are done.  This needs three extra values per
+ * point for every thread.
+ *
  * @tparam MetricType The metric to use.
  * @tparam MatType The type of data matrix to use.
  * @tparam TreeType Type of tree to use.  This should follow the TreeType policy
@@ -102,8 +109,9 @@ class DualTreeBoruvka
   //! Edges.
   std::vector<EdgePair> edges; // We must use vector with non-numerical types.
 
-  //! Connections.
-  UnionFind connections;
+  //! Connections.  The components are looked up by all the threads at once
+  //! during an iteration, so the union-find must be thread-safe.
+  ConcurrentUnionFind connections;
 
   //! List of edge nodes.
   arma::Col<size_t> neighborsInComponent;
@@ -118,6 +126,9 @@ class DualTreeBoruvka
   //! The instantiated metric.
   MetricType metric;
 
+  //! The number of threads to use.
+  size_t numThreads;
+
   //! For sorting the edge list after the computation.
   struct SortEdgesHelper
   {
@@ -175,7 +186,25 @@ class DualTreeBoruvka
    */
   void ComputeMST(arma::mat& results);
 
+  //! Get the number of threads used for the computation (0 means that OpenMP
+  //! decides).
+  size_t NumThreads() const { return numThreads; }
+  //! Modify the number of threads used for the computation (0 means that
+  //! OpenMP decides).
+  size_t& NumThreads() { return numThreads; }
+
  private:
+  //! Get the number of threads to compute with.
+  size_t ComputationThreads() const;
+
+  /**
+   * Find the nearest neighbor of each component on several threads, and store
+   * it in neighborsDistances, neighborsInComponent, and neighborsOutComponent.
+   * The counters of the given rules are increased by the work of the threads.
+   */
+  template<typename RuleType>
+  void ParallelIteration(const size_t threads, RuleType& rules);
+
   /**
    * Adds a single edge to the edge list
    */
@@ -59,7 +59,8 @@ DualTreeBoruvka<MetricType, MatType, TreeType>::DualTreeBoruvka(
     naive(naive),
     connections(dataset.n_cols),
     totalDist(0.0),
-    metric(metric)
+    metric(metric),
+    numThreads(1)
 {
   edges.reserve(data.n_cols - 1); // Set size.
 
@@ -84,7 +85,8 @@ DualTreeBoruvka<MetricType, MatType, TreeType>::DualTreeBoruvka(
     naive(false),
     connections(data.n_cols),
     totalDist(0.0),
-    metric(metric)
+    metric(metric),
+    numThreads(1)
 {
   edges.reserve(data.n_cols - 1); // Fill with EdgePairs.
 
@@ -126,9 +128,14 @@ void DualTreeBoruvka<MetricType, MatType, TreeType>::ComputeMST(
   typedef DTBRules<MetricType, Tree> RuleType;
   RuleType rules(data, connections, neighborsDistances, neighborsInComponent,
                  neighborsOutComponent, metric);
+  const size_t threads = ComputationThreads();
   while (edges.size() < (data.n_cols - 1))
   {
-    if (naive)
+    if (threads > 1)
+    {
+      ParallelIteration(threads, rules);
+    }
+    else if (naive)
     {
       // Full O(N^2) traversal.
       for (size_t i = 0; i < data.n_cols; ++i)
@@ -161,6 +168,137 @@ void DualTreeBoruvka<MetricType, MatType, TreeType>::ComputeMST(
   Log::Info << "Total spanning tree length: " << totalDist << std::endl;
 }
 
+template<
+    typename MetricType,
+    typename MatType,
+    template<typename TreeMetricType,
+             typename TreeStatType,
+             typename TreeMatType> class TreeType>
+size_t DualTreeBoruvka<MetricType, MatType, TreeType>::ComputationThreads()
+    const
+{
+  return util::Threads(numThreads);
+}
+
+/**
+ * Find the nearest neighbor of each component with several threads.
+ */
+template<
+    typename MetricType,
+    typename MatType,
+    template<typename TreeMetricType,
+             typename TreeStatType,
+             typename TreeMatType> class TreeType>
+template<typename RuleType>
+void DualTreeBoruvka<MetricType, MatType, TreeType>::ParallelIteration(
+    const size_t threads,
+    RuleType& rules)
+{
+  // Split the tree into a frontier of disjoint subtrees.  We repeatedly
+  // replace the largest node in the frontier with its children, until there
+  // are enough subtrees to keep every thread busy.
+  std::vector<Tree*> frontier;
+  if (!naive)
+  {
+    frontier.push_back(tree);
+    while (frontier.size() < 4 * threads)
+    {
+      size_t largest = frontier.size();
+      for (size_t i = 0; i < frontier.size(); ++i)
+      {
+        if (frontier[i]->NumChildren() == 0)
+          continue;
+
+        if (largest == frontier.size() || frontier[i]->NumDescendants() >
+            frontier[largest]->NumDescendants())
+          largest = i;
+      }
+
+      if (largest == frontier.size())
+        break; // Only leaves are left; we can't split any further.
+
+      Tree* node = frontier[largest];
+      frontier[largest] = &node->Child(0);
+      for (size_t i = 1; i < node->NumChildren(); ++i)
+        frontier.push_back(&node->Child(i));
+    }
+  }
+
+  // The points of a component can be spread over the subtrees of several
+  // threads, so every thread has its own candidate edges.  The statistics of
+  // the query nodes are only modified by the thread that owns their subtree,
+  // and the union-find is only read.
+  std::vector<arma::vec> threadDistances(threads);
+  std::vector<arma::Col<size_t>> threadInComponent(threads);
+  std::vector<arma::Col<size_t>> threadOutComponent(threads);
+  size_t totalScores = 0;
+  size_t totalBaseCases = 0;
+
+  #pragma omp parallel num_threads(threads) \
+      reduction(+:totalScores, totalBaseCases)
+  {
+    #ifdef HAS_OPENMP
+    const size_t threadId = (size_t) omp_get_thread_num();
+    #else
+    const size_t threadId = 0;
+    #endif
+
+    arma::vec& distances = threadDistances[threadId];
+    distances.set_size(data.n_cols);
+    distances.fill(DBL_MAX);
+    threadInComponent[threadId].set_size(data.n_cols);
+    threadOutComponent[threadId].set_size(data.n_cols);
+
+    MetricType threadMetric(metric);
+    RuleType threadRules(data, connections, distances,
+        threadInComponent[threadId], threadOutComponent[threadId],
+        threadMetric);
+
+    if (naive)
+    {
+      #pragma omp for schedule(dynamic, 16)
+      for (omp_size_t i = 0; i < (omp_size_t) data.n_cols; ++i)
+        for (size_t j = 0; j < data.n_cols; ++j)
+          threadRules.BaseCase((size_t) i, j);
+    }
+    else
+    {
+      typename Tree::template DualTreeTraverser<RuleType>
+          traverser(threadRules);
+
+      #pragma omp for schedule(dynamic)
+      for (omp_size_t i = 0; i < (omp_size_t) frontier.size(); ++i)
+      {
+        // The traverser expects the combination it is given to already have
+        // been scored (unless both nodes are roots).
+        if (threadRules.Score(*frontier[i], *tree) != DBL_MAX)
+          traverser.Traverse(*frontier[i], *tree);
+      }
+    }
+
+    totalScores += threadRules.Scores();
+    totalBaseCases += threadRules.BaseCases();
+  }
+
+  rules.Scores() += totalScores;
+  rules.BaseCases() += totalBaseCases;
+
+  // Keep the best candidate of each component.
+  #pragma omp parallel for num_threads(threads)
+  for (omp_size_t c = 0; c < (omp_size_t) data.n_cols; ++c)
+  {
+    for (size_t t = 0; t < threads; ++t)
+    {
+      if (threadDistances[t][c] < neighborsDistances[c])
+      {
+        neighborsDistances[c] = threadDistances[t][c];
+        neighborsInComponent[c] = threadInComponent[t][c];
+        neighborsOutComponent[c] = threadOutComponent[t][c];
+      }
+    }
+  }
+}
+
 /**
  * Adds a single edge to the edge list
  */
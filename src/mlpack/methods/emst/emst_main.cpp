@@ -52,7 +52,10 @@ BINDING_LONG_DESC(
     "and if the " + PRINT_PARAM_STRING("naive") + " option is given, then "
     "brute-force search is used (this is typically much slower in low "
     "dimensions).  The leaf size does not affect the results, but it may have "
-    "some effect on the runtime of the algorithm.");
+    "some effect on the runtime of the algorithm."
+    "\n\n"
+    "Each iteration of the algorithm can be run on several threads with the " +
+    PRINT_PARAM_STRING("threads") + " parameter (0 uses the OpenMP default).");
 
 // Example.
 BINDING_EXAMPLE(
@@ -96,6 +99,10 @@ static void mlpackMain()
 {
   RequireAtLeastOnePassed({ "output" }, false, "no output will be saved");
 
+  RequireParamValue<int>("threads", [](int x) { return x >= 0; }, true,
+      "number of threads must be nonnegative");
+  const size_t threads = (size_t) IO::GetParam<int>("threads");
+
   arma::mat dataPoints = std::move(IO::GetParam<arma::mat>("input"));
 
   // Do naive computation if necessary.
@@ -104,6 +111,7 @@ static void mlpackMain()
     Log::Info << "Running naive algorithm." << endl;
 
     DualTreeBoruvka<> naive(dataPoints, true);
+    naive.NumThreads() = threads;
 
     arma::mat naiveResults;
     naive.ComputeMST(naiveResults);
@@ -131,6 +139,7 @@ static void mlpackMain()
     Timer::Stop("tree_building");
 
     DualTreeBoruvka<> dtb(&tree, metric);
+    dtb.NumThreads() = threads;
 
     // Run the DTB algorithm.
     Log::Info << "Calculating minimum spanning tree." << endl;
@@ -0,0 +1,69 @@
+/**
+ * @file methods/fastmks/block_kernel.hpp
+ *
+ * BlockKernel() evaluates a kernel between every point of a block of reference
+ * points and every point of a block of query points.  Kernels that are
+ * functions of the inner product are evaluated with one matrix multiplication.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_FASTMKS_BLOCK_KERNEL_HPP
+#define MLPACK_METHODS_FASTMKS_BLOCK_KERNEL_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/kernels/linear_kernel.hpp>
+#include <mlpack/core/kernels/polynomial_kernel.hpp>
+
+namespace mlpack {
+namespace fastmks {
+
+/**
+ * Evaluate the kernel between each reference point and each query point, so
+ * that kernels(i, j) is K(references.col(i), queries.col(j)).  This generic
+ * version evaluates the kernel pair by pair.
+ *
+ * @param kernel Kernel to evaluate.
+ * @param references Block of reference points.
+ * @param queries Block of query points.
+ * @param kernels Matrix to store the kernel values in.
+ */
+template<typename KernelType, typename RefMatType, typename QueryMatType>
+void BlockKernel(KernelType& kernel,
+                 const RefMatType& references,
+                 const QueryMatType& queries,
+                 arma::mat& kernels)
+{
+  kernels.set_size(references.n_cols, queries.n_cols);
+  for (size_t j = 0; j < queries.n_cols; ++j)
+    for (size_t i = 0; i < references.n_cols; ++i)
+      kernels(i, j) = kernel.Evaluate(queries.col(j), references.col(i));
+}
+
+//! Evaluate the linear kernel with one matrix multiplication.
+template<typename RefMatType, typename QueryMatType>
+void BlockKernel(kernel::LinearKernel& /* kernel */,
+                 const RefMatType& references,
+                 const QueryMatType& queries,
+                 arma::mat& kernels)
+{
+  kernels = arma::mat(references.t() * queries);
+}
+
+//! Evaluate the polynomial kernel with one matrix multiplication.
+template<typename RefMatType, typename QueryMatType>
+void BlockKernel(kernel::PolynomialKernel& kernel,
+                 const RefMatType& references,
+                 const QueryMatType& queries,
+                 arma::mat& kernels)
+{
+  kernels = arma::pow(arma::mat(references.t() * queries) + kernel.Offset(),
+      kernel.Degree());
+}
+
+} // namespace fastmks
+} // namespace mlpack
+
+#endif
@@ -48,6 +48,12 @@ namespace fastmks /** Fast max-kernel search. */ {
  * on points in the dataset (and not centroids of regions or anything like
  * that).
  *
+ * Searches can be run on several threads (see NumThreads()).  Single-tree and
+ * brute-force search split the query points between the threads, and dual-tree
+ * search splits the query tree into disjoint subtrees.  Brute-force search
+ * evaluates the kernel between blocks of points, so for the linear and
+ * polynomial kernels it uses matrix multiplications.
+ *
  * @tparam KernelType Type of kernel to run FastMKS with.
  * @tparam MatType Type of data matrix (usually arma::mat).
  * @tparam TreeType Type of tree to run FastMKS with; it must satisfy the
@@ -287,6 +293,9 @@ class FastMKS
   //! Modify the inner-product metric induced by the given kernel.
   metric::IPMetric<KernelType>& Metric() { return metric; }
 
+  //! Get the reference tree (NULL for naive search).
+  const Tree* ReferenceTree() const { return referenceTree; }
+
   //! Get whether or not single-tree search is used.
   bool SingleMode() const { return singleMode; }
   //! Modify whether or not single-tree search is used.
@@ -297,6 +306,12 @@ class FastMKS
   //! Modify whether or not brute-force (naive) search is used.
   bool& Naive() { return naive; }
 
+  //! Get the number of threads used for search (0 means the OpenMP default).
+  size_t NumThreads() const { return numThreads; }
+  //! Modify the number of threads used for search (0 means the OpenMP
+  //! default).  This has no effect if mlpack is compiled without OpenMP.
+  size_t& NumThreads() { return numThreads; }
+
   //! Serialize the model.
   template<typename Archive>
   void serialize(Archive& ar, const unsigned int /* version */);
@@ -316,10 +331,22 @@ class FastMKS
   bool singleMode;
   //! If true, naive (brute-force) search is used.
   bool naive;
+  //! The number of threads to search with (0 means the OpenMP default).
+  size_t numThreads;
 
   //! The instantiated inner-product metric induced by the given kernel.
   metric::IPMetric<KernelType> metric;
 
+  //! Build the reference tree on the given dataset, and cache the self-kernels
+  //! of its points in the metric of the tree.
+  void BuildTree(const MatType& referenceSet);
+  //! Build the reference tree on the given dataset, taking ownership of it, and
+  //! cache the self-kernels of its points in the metric of the tree.
+  void BuildTree(MatType&& referenceSet);
+  //! Cache the self-kernels of the reference points in the metric of the
+  //! reference tree, if they are not cached yet.
+  void CacheTreeSelfKernels();
+
   //! Candidate represents a possible candidate point (value, index).
   typedef std::pair<double, size_t> Candidate;
 
@@ -334,6 +361,43 @@ class FastMKS
   //! Use a priority queue to represent the list of candidate points.
   typedef std::priority_queue<Candidate, std::vector<Candidate>,
       CandidateCmp> CandidateList;
+
+  //! Get the number of threads searches will actually use.
+  size_t SearchThreads() const;
+
+  /**
+   * Run brute-force search for the given query points.  The kernel is
+   * evaluated between blocks of query and reference points, and the blocks of
+   * query points are split between the threads.
+   *
+   * @param querySet Set of query points.
+   * @param k The number of maximum kernels to find.
+   * @param indices Matrix to store resulting indices of max-kernel search in.
+   * @param kernels Matrix to store resulting max-kernel values in.
+   * @param sameSet If true, the query set is the reference set, and a point is
+   *     never returned as its own candidate.
+   */
+  void NaiveSearch(const MatType& querySet,
+                   const size_t k,
+                   arma::Mat<size_t>& indices,
+                   arma::mat& kernels,
+                   const bool sameSet);
+
+  //! Run single-tree search for the given query points, splitting the query
+  //! points between the given number of threads.
+  void ParallelSingleTreeSearch(const MatType& querySet,
+                                const size_t k,
+                                arma::Mat<size_t>& indices,
+                                arma::mat& kernels,
+                                const size_t threads);
+
+  //! Run dual-tree search for the given query tree, splitting the query tree
+  //! into disjoint subtrees between the given number of threads.
+  void ParallelDualTreeSearch(Tree* queryTree,
+                              const size_t k,
+                              arma::Mat<size_t>& indices,
+                              arma::mat& kernels,
+                              const size_t threads);
 };
 
 } // namespace fastmks
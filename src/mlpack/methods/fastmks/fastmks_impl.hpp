@@ -16,6 +16,7 @@
 #include "fastmks.hpp"
 
 #include "fastmks_rules.hpp"
+#include "block_kernel.hpp"
 
 #include <mlpack/core/kernels/gaussian_kernel.hpp>
 
@@ -35,11 +36,12 @@ FastMKS<KernelType, MatType, TreeType>::FastMKS(const bool singleMode,
     treeOwner(true),
     setOwner(true),
     singleMode(singleMode),
-    naive(naive)
+    naive(naive),
+    numThreads(1)
 {
   Timer::Start("tree_building");
   if (!naive)
-    referenceTree = new Tree(*referenceSet);
+    BuildTree(*referenceSet);
   Timer::Stop("tree_building");
 }
 
@@ -58,11 +60,12 @@ FastMKS<KernelType, MatType, TreeType>::FastMKS(
     treeOwner(true),
     setOwner(false),
     singleMode(singleMode),
-    naive(naive)
+    naive(naive),
+    numThreads(1)
 {
   Timer::Start("tree_building");
   if (!naive)
-    referenceTree = new Tree(referenceSet);
+    BuildTree(referenceSet);
   Timer::Stop("tree_building");
 }
 
@@ -82,13 +85,14 @@ FastMKS<KernelType, MatType, TreeType>::FastMKS(const MatType& referenceSet,
     setOwner(false),
     singleMode(singleMode),
     naive(naive),
+    numThreads(1),
     metric(kernel)
 {
   Timer::Start("tree_building");
 
   // If necessary, the reference tree should be built.  There is no query tree.
   if (!naive)
-    referenceTree = new Tree(referenceSet, metric);
+    BuildTree(referenceSet);
 
   Timer::Stop("tree_building");
 }
@@ -108,13 +112,14 @@ FastMKS<KernelType, MatType, TreeType>::FastMKS(
     treeOwner(true),
     setOwner(naive),
     singleMode(singleMode),
-    naive(naive)
+    naive(naive),
+    numThreads(1)
 {
   Timer::Start("tree_building");
   if (!naive)
   {
-    referenceTree = new Tree(std::move(referenceSet));
-    referenceSet = &referenceTree->Dataset();
+    BuildTree(std::move(referenceSet));
+    this->referenceSet = &referenceTree->Dataset();
   }
   Timer::Stop("tree_building");
 }
@@ -135,6 +140,7 @@ FastMKS<KernelType, MatType, TreeType>::FastMKS(MatType&& referenceSet,
     setOwner(naive),
     singleMode(singleMode),
     naive(naive),
+    numThreads(1),
     metric(kernel)
 {
   Timer::Start("tree_building");
@@ -142,8 +148,8 @@ FastMKS<KernelType, MatType, TreeType>::FastMKS(MatType&& referenceSet,
   // If necessary, the reference tree should be built.  There is no query tree.
   if (!naive)
   {
-    referenceTree = new Tree(referenceSet, metric);
-    referenceSet = &referenceTree->Dataset();
+    BuildTree(std::move(referenceSet));
+    this->referenceSet = &referenceTree->Dataset();
   }
 
   Timer::Stop("tree_building");
@@ -163,6 +169,7 @@ FastMKS<KernelType, MatType, TreeType>::FastMKS(Tree* referenceTree,
     setOwner(false),
     singleMode(singleMode),
     naive(false),
+    numThreads(1),
     metric(referenceTree->Metric())
 {
   // Nothing to do.
@@ -180,11 +187,16 @@ FastMKS<KernelType, MatType, TreeType>::FastMKS(const FastMKS& other) :
     setOwner(other.referenceTree == NULL),
     singleMode(other.singleMode),
     naive(other.naive),
+    numThreads(other.numThreads),
     metric(other.metric)
 {
-  // Set reference set correctly.
+  // Set reference set correctly.  The copied tree may have its own copy of the
+  // dataset, whose self-kernels are not cached yet.
   if (referenceTree)
+  {
     referenceSet = &referenceTree->Dataset();
+    CacheTreeSelfKernels();
+  }
   else
     referenceSet = new MatType(*other.referenceSet);
 }
@@ -201,6 +213,7 @@ FastMKS<KernelType, MatType, TreeType>::FastMKS(FastMKS&& other) :
     setOwner(other.setOwner),
     singleMode(other.singleMode),
     naive(other.naive),
+    numThreads(other.numThreads),
     metric(std::move(other.metric))
 {
   // Clear information from the other.
@@ -210,6 +223,7 @@ FastMKS<KernelType, MatType, TreeType>::FastMKS(FastMKS&& other) :
   other.setOwner = false;
   other.singleMode = false;
   other.naive = false;
+  other.numThreads = 1;
 }
 
 template<typename KernelType,
@@ -238,6 +252,7 @@ FastMKS<KernelType, MatType, TreeType>::operator=(const FastMKS& other)
     referenceSet = &referenceTree->Dataset();
     treeOwner = true;
     setOwner = false;
+    CacheTreeSelfKernels();
   }
   else
   {
@@ -248,6 +263,9 @@ FastMKS<KernelType, MatType, TreeType>::operator=(const FastMKS& other)
 
   singleMode = other.singleMode;
   naive = other.naive;
+  numThreads = other.numThreads;
+
+  return *this;
 }
 
 template<typename KernelType,
@@ -281,7 +299,7 @@ void FastMKS<KernelType, MatType, TreeType>::Train(const MatType& referenceSet)
   {
     if (treeOwner && referenceTree)
       delete referenceTree;
-    referenceTree = new Tree(referenceSet, metric);
+    BuildTree(referenceSet);
     treeOwner = true;
   }
 }
@@ -305,7 +323,7 @@ void FastMKS<KernelType, MatType, TreeType>::Train(const MatType& referenceSet,
   {
     if (treeOwner && referenceTree)
       delete referenceTree;
-    referenceTree = new Tree(referenceSet, metric);
+    BuildTree(referenceSet);
     treeOwner = true;
   }
 }
@@ -324,8 +342,8 @@ void FastMKS<KernelType, MatType, TreeType>::Train(MatType&& referenceSet)
   {
     if (treeOwner && referenceTree)
       delete referenceTree;
-    referenceTree = new Tree(std::move(referenceSet), metric);
-    referenceSet = referenceTree->Dataset();
+    BuildTree(std::move(referenceSet));
+    this->referenceSet = &referenceTree->Dataset();
     treeOwner = true;
     setOwner = false;
   }
@@ -353,7 +371,8 @@ void FastMKS<KernelType, MatType, TreeType>::Train(MatType&& referenceSet,
   {
     if (treeOwner && referenceTree)
       delete referenceTree;
-    referenceTree = new Tree(std::move(referenceSet), metric);
+    BuildTree(std::move(referenceSet));
+    this->referenceSet = &referenceTree->Dataset();
     treeOwner = true;
     setOwner = false;
   }
@@ -387,6 +406,7 @@ void FastMKS<KernelType, MatType, TreeType>::Train(Tree* tree)
 
   this->referenceTree = tree;
   this->treeOwner = true;
+  CacheTreeSelfKernels();
 }
 
 template<typename KernelType,
@@ -426,33 +446,7 @@ void FastMKS<KernelType, MatType, TreeType>::Search(
   // Naive implementation.
   if (naive)
   {
-    // Simple double loop.  Stupid, slow, but a good benchmark.
-    for (size_t q = 0; q < querySet.n_cols; ++q)
-    {
-      const Candidate def = std::make_pair(-DBL_MAX, size_t() - 1);
-      std::vector<Candidate> cList(k, def);
-      CandidateList pqueue(CandidateCmp(), std::move(cList));
-
-      for (size_t r = 0; r < referenceSet->n_cols; ++r)
-      {
-        const double eval = metric.Kernel().Evaluate(querySet.col(q),
-                                                     referenceSet->col(r));
-
-        if (eval > pqueue.top().first)
-        {
-          Candidate c = std::make_pair(eval, r);
-          pqueue.pop();
-          pqueue.push(c);
-        }
-      }
-
-      for (size_t j = 1; j <= k; ++j)
-      {
-        indices(k - j, q) = pqueue.top().second;
-        kernels(k - j, q) = pqueue.top().first;
-        pqueue.pop();
-      }
-    }
+    NaiveSearch(querySet, k, indices, kernels, false);
 
     Timer::Stop("computing_products");
 
@@ -460,12 +454,21 @@ void FastMKS<KernelType, MatType, TreeType>::Search(
   }
 
   // Single-tree implementation.
-  if (singleMode)
+  const size_t threads = SearchThreads();
+  if (singleMode && threads > 1)
+  {
+    ParallelSingleTreeSearch(querySet, k, indices, kernels, threads);
+
+    Timer::Stop("computing_products");
+    return;
+  }
+  else if (singleMode)
   {
     // Create rules object (this will store the results).  This constructor
     // precalculates each self-kernel value.
     typedef FastMKSRules<KernelType, Tree> RuleType;
-    RuleType rules(*referenceSet, querySet, k, metric.Kernel());
+    RuleType rules(*referenceSet, querySet, k, metric.Kernel(),
+        referenceTree->Metric().SelfKernels());
 
     typename Tree::template SingleTreeTraverser<RuleType> traverser(rules);
 
@@ -530,8 +533,18 @@ void FastMKS<KernelType, MatType, TreeType>::Search(
   kernels.set_size(k, queryTree->Dataset().n_cols);
 
   Timer::Start("computing_products");
+  const size_t threads = SearchThreads();
+  if (threads > 1)
+  {
+    ParallelDualTreeSearch(queryTree, k, indices, kernels, threads);
+
+    Timer::Stop("computing_products");
+    return;
+  }
+
   typedef FastMKSRules<KernelType, Tree> RuleType;
-  RuleType rules(*referenceSet, queryTree->Dataset(), k, metric.Kernel());
+  RuleType rules(*referenceSet, queryTree->Dataset(), k, metric.Kernel(),
+      referenceTree->Metric().SelfKernels());
 
   typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
 
@@ -563,36 +576,7 @@ void FastMKS<KernelType, MatType, TreeType>::Search(
   // Naive implementation.
   if (naive)
   {
-    // Simple double loop.  Stupid, slow, but a good benchmark.
-    for (size_t q = 0; q < referenceSet->n_cols; ++q)
-    {
-      const Candidate def = std::make_pair(-DBL_MAX, size_t() - 1);
-      std::vector<Candidate> cList(k, def);
-      CandidateList pqueue(CandidateCmp(), std::move(cList));
-
-      for (size_t r = 0; r < referenceSet->n_cols; ++r)
-      {
-        if (q == r)
-          continue; // Don't return the point as its own candidate.
-
-        const double eval = metric.Kernel().Evaluate(referenceSet->col(q),
-                                                     referenceSet->col(r));
-
-        if (eval > pqueue.top().first)
-        {
-          Candidate c = std::make_pair(eval, r);
-          pqueue.pop();
-          pqueue.push(c);
-        }
-      }
-
-      for (size_t j = 1; j <= k; ++j)
-      {
-        indices(k - j, q) = pqueue.top().second;
-        kernels(k - j, q) = pqueue.top().first;
-        pqueue.pop();
-      }
-    }
+    NaiveSearch(*referenceSet, k, indices, kernels, true);
 
     Timer::Stop("computing_products");
 
@@ -600,12 +584,21 @@ void FastMKS<KernelType, MatType, TreeType>::Search(
   }
 
   // Single-tree implementation.
-  if (singleMode)
+  const size_t threads = SearchThreads();
+  if (singleMode && threads > 1)
+  {
+    ParallelSingleTreeSearch(*referenceSet, k, indices, kernels, threads);
+
+    Timer::Stop("computing_products");
+    return;
+  }
+  else if (singleMode)
   {
     // Create rules object (this will store the results).  This constructor
     // precalculates each self-kernel value.
     typedef FastMKSRules<KernelType, Tree> RuleType;
-    RuleType rules(*referenceSet, *referenceSet, k, metric.Kernel());
+    RuleType rules(*referenceSet, *referenceSet, k, metric.Kernel(),
+        referenceTree->Metric().SelfKernels());
 
     typename Tree::template SingleTreeTraverser<RuleType> traverser(rules);
 
@@ -632,7 +625,265 @@ void FastMKS<KernelType, MatType, TreeType>::Search(
   Search(referenceTree, k, indices, kernels);
 }
 
+template<typename KernelType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+size_t FastMKS<KernelType, MatType, TreeType>::SearchThreads() const
+{
+  return util::Threads(numThreads);
+}
+
+template<typename KernelType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void FastMKS<KernelType, MatType, TreeType>::NaiveSearch(
+    const MatType& querySet,
+    const size_t k,
+    arma::Mat<size_t>& indices,
+    arma::mat& kernels,
+    const bool sameSet)
+{
+  // The kernel values between a block of query points and a block of reference
+  // points are computed at once; the blocks are small enough for the kernel
+  // matrix to fit in cache.
+  const size_t queryBlockSize = 128;
+  const size_t referenceBlockSize = 1024;
+  const size_t numBlocks = (querySet.n_cols + queryBlockSize - 1) /
+      queryBlockSize;
+
+  #pragma omp parallel num_threads(SearchThreads())
+  {
+    // Some kernels cache values when they are evaluated, so each thread needs
+    // its own.
+    KernelType kernel(metric.Kernel());
+    arma::mat blockKernels;
+    std::vector<CandidateList> pqueues;
+
+    #pragma omp for schedule(dynamic)
+    for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+    {
+      const size_t queryBegin = (size_t) b * queryBlockSize;
+      const size_t queryEnd = std::min(queryBegin + queryBlockSize,
+          (size_t) querySet.n_cols);
+
+      pqueues.clear();
+      for (size_t q = queryBegin; q < queryEnd; ++q)
+      {
+        const Candidate def = std::make_pair(-DBL_MAX, size_t() - 1);
+        std::vector<Candidate> cList(k, def);
+        pqueues.push_back(CandidateList(CandidateCmp(), std::move(cList)));
+      }
+
+      for (size_t refBegin = 0; refBegin < referenceSet->n_cols;
+          refBegin += referenceBlockSize)
+      {
+        const size_t refEnd = std::min(refBegin + referenceBlockSize,
+            (size_t) referenceSet->n_cols);
+        BlockKernel(kernel, referenceSet->cols(refBegin, refEnd - 1),
+            querySet.cols(queryBegin, queryEnd - 1), blockKernels);
+
+        for (size_t q = queryBegin; q < queryEnd; ++q)
+        {
+          CandidateList& pqueue = pqueues[q - queryBegin];
+          for (size_t r = refBegin; r < refEnd; ++r)
+          {
+            if (sameSet && q == r)
+              continue; // Don't return the point as its own candidate.
+
+            const double eval = blockKernels(r - refBegin, q - queryBegin);
+            if (eval > pqueue.top().first)
+            {
+              Candidate c = std::make_pair(eval, r);
+              pqueue.pop();
+              pqueue.push(c);
+            }
+          }
+        }
+      }
+
+      for (size_t q = queryBegin; q < queryEnd; ++q)
+      {
+        CandidateList& pqueue = pqueues[q - queryBegin];
+        for (size_t j = 1; j <= k; ++j)
+        {
+          indices(k - j, q) = pqueue.top().second;
+          kernels(k - j, q) = pqueue.top().first;
+          pqueue.pop();
+        }
+      }
+    }
+  }
+}
+
+template<typename KernelType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void FastMKS<KernelType, MatType, TreeType>::ParallelSingleTreeSearch(
+    const MatType& querySet,
+    const size_t k,
+    arma::Mat<size_t>& indices,
+    arma::mat& kernels,
+    const size_t threads)
+{
+  // The self-kernels are computed once, and copied by the rules of each
+  // thread.
+  typedef FastMKSRules<KernelType, Tree> RuleType;
+  RuleType rules(*referenceSet, querySet, k, metric.Kernel(),
+        referenceTree->Metric().SelfKernels());
+
+  size_t baseCases = 0;
+  size_t scores = 0;
+  size_t numPrunes = 0;
+
+  #pragma omp parallel num_threads(threads) \
+      reduction(+:baseCases, scores, numPrunes)
+  {
+    KernelType kernel(metric.Kernel());
+    RuleType threadRules(rules, kernel);
+    typename Tree::template SingleTreeTraverser<RuleType>
+        traverser(threadRules);
+
+    #pragma omp for schedule(dynamic, 16)
+    for (omp_size_t i = 0; i < (omp_size_t) querySet.n_cols; ++i)
+    {
+      traverser.Traverse((size_t) i, *referenceTree);
+      threadRules.GetResults((size_t) i, indices, kernels);
+    }
+
+    baseCases += threadRules.BaseCases();
+    scores += threadRules.Scores();
+    numPrunes += traverser.NumPrunes();
+  }
+
+  Log::Info << "Pruned " << numPrunes << " nodes." << std::endl;
+  Log::Info << baseCases << " base cases." << std::endl;
+  Log::Info << scores << " scores." << std::endl;
+}
+
+template<typename KernelType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void FastMKS<KernelType, MatType, TreeType>::ParallelDualTreeSearch(
+    Tree* queryTree,
+    const size_t k,
+    arma::Mat<size_t>& indices,
+    arma::mat& kernels,
+    const size_t threads)
+{
+  // Split the query tree into a frontier of disjoint subtrees.  We repeatedly
+  // replace the largest node in the frontier with its children, until there
+  // are enough subtrees to keep every thread busy.  The nodes that are replaced
+  // are never visited, so their bounds must not prune anything.
+  std::vector<Tree*> frontier;
+  frontier.push_back(queryTree);
+  while (frontier.size() < 4 * threads)
+  {
+    size_t largest = frontier.size();
+    for (size_t i = 0; i < frontier.size(); ++i)
+    {
+      if (frontier[i]->NumChildren() == 0)
+        continue;
+
+      if (largest == frontier.size() || frontier[i]->NumDescendants() >
+          frontier[largest]->NumDescendants())
+        largest = i;
+    }
+
+    if (largest == frontier.size())
+      break; // Only leaves are left; we can't split any further.
+
+    Tree* node = frontier[largest];
+    node->Stat().Bound() = -DBL_MAX;
+    frontier[largest] = &node->Child(0);
+    for (size_t i = 1; i < node->NumChildren(); ++i)
+      frontier.push_back(&node->Child(i));
+  }
+
+  typedef FastMKSRules<KernelType, Tree> RuleType;
+  RuleType rules(*referenceSet, queryTree->Dataset(), k, metric.Kernel(),
+      referenceTree->Metric().SelfKernels());
+
+  // Each thread only modifies the statistics of the query nodes in its own
+  // subtrees; the statistics of the reference tree are only read.
+  size_t baseCases = 0;
+  size_t scores = 0;
+
+  #pragma omp parallel num_threads(threads) reduction(+:baseCases, scores)
+  {
+    KernelType kernel(metric.Kernel());
+    RuleType threadRules(rules, kernel);
+    typename Tree::template DualTreeTraverser<RuleType> traverser(threadRules);
+
+    #pragma omp for schedule(dynamic)
+    for (omp_size_t i = 0; i < (omp_size_t) frontier.size(); ++i)
+    {
+      // The cover tree traverser scores the combination it is given itself.
+      traverser.Traverse(*frontier[i], *referenceTree);
+      for (size_t j = 0; j < frontier[i]->NumDescendants(); ++j)
+      {
+        threadRules.GetResults(frontier[i]->Descendant(j), indices,
+            kernels);
+      }
+    }
+
+    baseCases += threadRules.BaseCases();
+    scores += threadRules.Scores();
+  }
+
+  Log::Info << baseCases << " base cases." << std::endl;
+  Log::Info << scores << " scores." << std::endl;
+}
+
 //! Serialize the model.
+template<typename KernelType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void FastMKS<KernelType, MatType, TreeType>::BuildTree(
+    const MatType& referenceSet)
+{
+  // The tree copies the metric along with its cache, so the self-kernels are
+  // used while the tree is built and then while it is searched.
+  metric.CacheSelfKernels(referenceSet);
+  referenceTree = new Tree(referenceSet, metric);
+  metric.ClearSelfKernels();
+  CacheTreeSelfKernels();
+}
+
+template<typename KernelType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void FastMKS<KernelType, MatType, TreeType>::BuildTree(MatType&& referenceSet)
+{
+  // The dataset is only known once it has been moved into the tree.
+  referenceTree = new Tree(std::move(referenceSet), metric);
+  CacheTreeSelfKernels();
+}
+
+template<typename KernelType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void FastMKS<KernelType, MatType, TreeType>::CacheTreeSelfKernels()
+{
+  // Some trees return a copy of their metric; then there is nothing to cache.
+  auto&& treeMetric = referenceTree->Metric();
+  if (!treeMetric.SelfKernelsCached(referenceTree->Dataset()))
+    treeMetric.CacheSelfKernels(referenceTree->Dataset());
+}
+
 template<typename KernelType,
          typename MatType,
          template<typename TreeMetricType,
@@ -683,6 +934,7 @@ void FastMKS<KernelType, MatType, TreeType>::serialize(
       referenceSet = &referenceTree->Dataset();
       metric = metric::IPMetric<KernelType>(referenceTree->Metric().Kernel());
       setOwner = false;
+      CacheTreeSelfKernels();
     }
   }
 }
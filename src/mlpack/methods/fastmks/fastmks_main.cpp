@@ -64,7 +64,10 @@ BINDING_EXAMPLE(
     "\n\n"
     "This program performs FastMKS using a cover tree.  The base used to build "
     "the cover tree can be specified with the " + PRINT_PARAM_STRING("base") +
-    " parameter.");
+    " parameter."
+    "\n\n"
+    "The search can be run on several threads with the " +
+    PRINT_PARAM_STRING("threads") + " parameter (0 uses the OpenMP default).");
 
 // See also...
 BINDING_SEE_ALSO("Fast max-kernel search tutorial (fastmks)",
@@ -146,6 +149,9 @@ static void mlpackMain()
   // Naive mode overrides single mode.
   ReportIgnoredParam({{ "naive", true }}, "single");
 
+  RequireParamValue<int>("threads", [](int x) { return x >= 0; }, true,
+      "number of threads must be nonnegative");
+
   FastMKSModel* model;
   arma::mat referenceData;
   if (IO::HasParam("reference"))
@@ -222,6 +228,7 @@ static void mlpackMain()
   // Set search preferences.
   model->Naive() = IO::HasParam("naive");
   model->SingleMode() = IO::HasParam("single");
+  model->NumThreads() = (size_t) IO::GetParam<int>("threads");
 
   // Should we do search?
   if (IO::HasParam("k"))
@@ -219,6 +219,52 @@ bool& FastMKSModel::SingleMode()
   throw std::runtime_error("invalid model type");
 }
 
+size_t FastMKSModel::NumThreads() const
+{
+  switch (kernelType)
+  {
+    case LINEAR_KERNEL:
+      return linear->NumThreads();
+    case POLYNOMIAL_KERNEL:
+      return polynomial->NumThreads();
+    case COSINE_DISTANCE:
+      return cosine->NumThreads();
+    case GAUSSIAN_KERNEL:
+      return gaussian->NumThreads();
+    case EPANECHNIKOV_KERNEL:
+      return epan->NumThreads();
+    case TRIANGULAR_KERNEL:
+      return triangular->NumThreads();
+    case HYPTAN_KERNEL:
+      return hyptan->NumThreads();
+  }
+
+  throw std::runtime_error("invalid model type");
+}
+
+size_t& FastMKSModel::NumThreads()
+{
+  switch (kernelType)
+  {
+    case LINEAR_KERNEL:
+      return linear->NumThreads();
+    case POLYNOMIAL_KERNEL:
+      return polynomial->NumThreads();
+    case COSINE_DISTANCE:
+      return cosine->NumThreads();
+    case GAUSSIAN_KERNEL:
+      return gaussian->NumThreads();
+    case EPANECHNIKOV_KERNEL:
+      return epan->NumThreads();
+    case TRIANGULAR_KERNEL:
+      return triangular->NumThreads();
+    case HYPTAN_KERNEL:
+      return hyptan->NumThreads();
+  }
+
+  throw std::runtime_error("invalid model type");
+}
+
 void FastMKSModel::Search(const arma::mat& querySet,
                           const size_t k,
                           arma::Mat<size_t>& indices,
@@ -86,6 +86,11 @@ class FastMKSModel
   //! Set whether or not single-tree search is used.
   bool& SingleMode();
 
+  //! Get the number of threads used for search (0 means the OpenMP default).
+  size_t NumThreads() const;
+  //! Set the number of threads used for search (0 means the OpenMP default).
+  size_t& NumThreads();
+
   //! Get the kernel type.
   int KernelType() const { return kernelType; }
   //! Modify the kernel type.
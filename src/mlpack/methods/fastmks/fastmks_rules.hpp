@@ -17,6 +17,7 @@
 #include <mlpack/core/tree/cover_tree/cover_tree.hpp>
 #include <mlpack/core/tree/traversal_info.hpp>
 #include <boost/heap/priority_queue.hpp>
+#include <unordered_map>
 
 namespace mlpack {
 namespace fastmks {
@@ -42,11 +43,29 @@ class FastMKSRules
    * @param querySet Set of query data.
    * @param k Number of candidates to search for.
    * @param kernel Kernel to run FastMKS with.
+   * @param referenceSelfKernels Self-kernels K(x, x) of the reference points,
+   *     if they are already known (for instance, cached by the metric of the
+   *     reference tree); if empty, they are computed.  They are also used for
+   *     the query points when the query set is the reference set.
    */
   FastMKSRules(const typename TreeType::Mat& referenceSet,
                const typename TreeType::Mat& querySet,
                const size_t k,
-               KernelType& kernel);
+               KernelType& kernel,
+               const arma::vec& referenceSelfKernels = arma::vec());
+
+  /**
+   * Construct a FastMKSRules object for another thread, with the same datasets
+   * and number of candidates as the given object but with fresh candidate
+   * lists.  The precomputed self-kernels are copied.  The object doesn't
+   * modify the statistics of the reference tree, so several such objects can
+   * search the same reference tree at the same time (each with its own query
+   * points or query nodes).
+   *
+   * @param other Rules object to take the datasets from.
+   * @param kernel Kernel to run FastMKS with (it should belong to this thread).
+   */
+  FastMKSRules(const FastMKSRules& other, KernelType& kernel);
 
   /**
    * Store the list of candidates for each query point in the given matrices.
@@ -56,6 +75,18 @@ class FastMKSRules
    */
   void GetResults(arma::Mat<size_t>& indices, arma::mat& products);
 
+  /**
+   * Store the list of candidates for the given query point in its column of the
+   * given matrices, which must already have the right size.
+   *
+   * @param queryIndex Index of the query point.
+   * @param indices Matrix storing lists of candidate for each query point.
+   * @param products Matrix storing kernel value for each candidate.
+   */
+  void GetResults(const size_t queryIndex,
+                  arma::Mat<size_t>& indices,
+                  arma::mat& products);
+
   //! Compute the base case (kernel value) between two points.
   double BaseCase(const size_t queryIndex, const size_t referenceIndex);
 
@@ -173,6 +204,18 @@ class FastMKSRules
   //! The last kernel evaluation resulting from BaseCase().
   double lastKernel;
 
+  //! If true, the reference tree is shared with other threads, so the last
+  //! kernel values of single-tree search are held in lastKernels instead of
+  //! the statistics of the reference nodes.
+  bool sharedReferenceTree;
+  //! The last kernel value of each reference node, for the current query point,
+  //! when the reference tree is shared.
+  std::unordered_map<const TreeType*, double> lastKernels;
+
+  //! Get the last kernel value between the current query point and the given
+  //! reference node.
+  double& LastKernel(TreeType& referenceNode);
+
   //! Calculate the bound for a given query node.
   double CalculateBound(TreeType& queryNode) const;
 
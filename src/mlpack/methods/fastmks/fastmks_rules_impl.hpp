@@ -23,7 +23,8 @@ FastMKSRules<KernelType, TreeType>::FastMKSRules(
     const typename TreeType::Mat& referenceSet,
     const typename TreeType::Mat& querySet,
     const size_t k,
-    KernelType& kernel) :
+    KernelType& kernel,
+    const arma::vec& referenceSelfKernels) :
     referenceSet(referenceSet),
     querySet(querySet),
     k(k),
@@ -31,19 +32,34 @@ FastMKSRules<KernelType, TreeType>::FastMKSRules(
     lastQueryIndex(-1),
     lastReferenceIndex(-1),
     lastKernel(0.0),
+    sharedReferenceTree(false),
     baseCases(0),
     scores(0)
 {
-  // Precompute each self-kernel.
-  queryKernels.set_size(querySet.n_cols);
-  for (size_t i = 0; i < querySet.n_cols; ++i)
-    queryKernels[i] = sqrt(kernel.Evaluate(querySet.col(i),
-                                           querySet.col(i)));
+  // Precompute each self-kernel, unless they are given.
+  if (referenceSelfKernels.n_elem == referenceSet.n_cols)
+  {
+    referenceKernels = sqrt(referenceSelfKernels);
+  }
+  else
+  {
+    referenceKernels.set_size(referenceSet.n_cols);
+    for (size_t i = 0; i < referenceSet.n_cols; ++i)
+      referenceKernels[i] = sqrt(kernel.Evaluate(referenceSet.col(i),
+                                                 referenceSet.col(i)));
+  }
 
-  referenceKernels.set_size(referenceSet.n_cols);
-  for (size_t i = 0; i < referenceSet.n_cols; ++i)
-    referenceKernels[i] = sqrt(kernel.Evaluate(referenceSet.col(i),
-                                               referenceSet.col(i)));
+  if (&querySet == &referenceSet)
+  {
+    queryKernels = referenceKernels;
+  }
+  else
+  {
+    queryKernels.set_size(querySet.n_cols);
+    for (size_t i = 0; i < querySet.n_cols; ++i)
+      queryKernels[i] = sqrt(kernel.Evaluate(querySet.col(i),
+                                             querySet.col(i)));
+  }
 
   // Set to invalid memory, so that the first node combination does not try to
   // dereference null pointers.
@@ -64,6 +80,35 @@ FastMKSRules<KernelType, TreeType>::FastMKSRules(
   candidates.swap(tmp);
 }
 
+template<typename KernelType, typename TreeType>
+FastMKSRules<KernelType, TreeType>::FastMKSRules(const FastMKSRules& other,
+                                                 KernelType& kernel) :
+    referenceSet(other.referenceSet),
+    querySet(other.querySet),
+    k(other.k),
+    queryKernels(other.queryKernels),
+    referenceKernels(other.referenceKernels),
+    kernel(kernel),
+    lastQueryIndex(-1),
+    lastReferenceIndex(-1),
+    lastKernel(0.0),
+    sharedReferenceTree(true),
+    baseCases(0),
+    scores(0)
+{
+  traversalInfo.LastQueryNode() = (TreeType*) this;
+  traversalInfo.LastReferenceNode() = (TreeType*) this;
+
+  const Candidate def = std::make_pair(-DBL_MAX, size_t() - 1);
+
+  CandidateList pqueue;
+  pqueue.reserve(k);
+  for (size_t i = 0; i < k; ++i)
+    pqueue.push(def);
+  std::vector<CandidateList> tmp(querySet.n_cols, pqueue);
+  candidates.swap(tmp);
+}
+
 template<typename KernelType, typename TreeType>
 void FastMKSRules<KernelType, TreeType>::GetResults(
     arma::Mat<size_t>& indices,
@@ -73,14 +118,21 @@ void FastMKSRules<KernelType, TreeType>::GetResults(
   products.set_size(k, querySet.n_cols);
 
   for (size_t i = 0; i < querySet.n_cols; ++i)
+    GetResults(i, indices, products);
+}
+
+template<typename KernelType, typename TreeType>
+void FastMKSRules<KernelType, TreeType>::GetResults(
+    const size_t queryIndex,
+    arma::Mat<size_t>& indices,
+    arma::mat& products)
+{
+  CandidateList& pqueue = candidates[queryIndex];
+  for (size_t j = 1; j <= k; ++j)
   {
-    CandidateList& pqueue = candidates[i];
-    for (size_t j = 1; j <= k; ++j)
-    {
-      indices(k - j, i) = pqueue.top().second;
-      products(k - j, i) = pqueue.top().first;
-      pqueue.pop();
-    }
+    indices(k - j, queryIndex) = pqueue.top().second;
+    products(k - j, queryIndex) = pqueue.top().first;
+    pqueue.pop();
   }
 }
 
@@ -131,6 +183,11 @@ double FastMKSRules<KernelType, TreeType>::Score(const size_t queryIndex,
   // Compare with the current best.
   const double bestKernel = candidates[queryIndex].top().first;
 
+  // A new traversal for this query point starts at the root, so the last
+  // kernel values of the previous query point are stale.
+  if (sharedReferenceTree && referenceNode.Parent() == NULL)
+    lastKernels.clear();
+
   // See if we can perform a parent-child prune.
   const double furthestDist = referenceNode.FurthestDescendantDistance();
   if (referenceNode.Parent() != NULL)
@@ -138,7 +195,7 @@ double FastMKSRules<KernelType, TreeType>::Score(const size_t queryIndex,
     double maxKernelBound;
     const double parentDist = referenceNode.ParentDistance();
     const double combinedDistBound = parentDist + furthestDist;
-    const double lastKernel = referenceNode.Parent()->Stat().LastKernel();
+    const double lastKernel = LastKernel(*referenceNode.Parent());
     if (kernel::KernelTraits<KernelType>::IsNormalized)
     {
       const double squaredDist = std::pow(combinedDistBound, 2.0);
@@ -175,7 +232,7 @@ double FastMKSRules<KernelType, TreeType>::Score(const size_t queryIndex,
         referenceNode.Parent() != NULL &&
         referenceNode.Point(0) == referenceNode.Parent()->Point(0))
     {
-      kernelEval = referenceNode.Parent()->Stat().LastKernel();
+      kernelEval = LastKernel(*referenceNode.Parent());
     }
     else
     {
@@ -190,7 +247,7 @@ double FastMKSRules<KernelType, TreeType>::Score(const size_t queryIndex,
     kernelEval = kernel.Evaluate(querySet.col(queryIndex), refCenter);
   }
 
-  referenceNode.Stat().LastKernel() = kernelEval;
+  LastKernel(referenceNode) = kernelEval;
 
   double maxKernel;
   if (kernel::KernelTraits<KernelType>::IsNormalized)
@@ -428,6 +485,16 @@ double FastMKSRules<KernelType, TreeType>::Rescore(TreeType& queryNode,
   return ((1.0 / oldScore) >= bestKernel) ? oldScore : DBL_MAX;
 }
 
+template<typename KernelType, typename TreeType>
+inline double& FastMKSRules<KernelType, TreeType>::LastKernel(
+    TreeType& referenceNode)
+{
+  if (sharedReferenceTree)
+    return lastKernels[&referenceNode];
+
+  return referenceNode.Stat().LastKernel();
+}
+
 /**
  * Calculate the bound for the given query node.  This bound represents the
  * minimum value which a node combination must achieve to guarantee an
@@ -37,8 +37,8 @@ class FastMKSStat
 
   /**
    * Initialize this statistic for the given tree node.  The TreeType's metric
-   * better be IPMetric with some kernel type (that is, Metric().Kernel() must
-   * exist).
+   * better be IPMetric with some kernel type (that is, Metric().Kernel() and
+   * Metric().SelfKernel() must exist).
    *
    * @param node Node that this statistic is built for.
    */
@@ -62,8 +62,8 @@ class FastMKSStat
       }
       else
       {
-        selfKernel = sqrt(node.Metric().Kernel().Evaluate(
-            node.Dataset().col(node.Point(0)),
+        // The self-kernel may be cached by the metric.
+        selfKernel = sqrt(node.Metric().SelfKernel(
             node.Dataset().col(node.Point(0))));
       }
     }
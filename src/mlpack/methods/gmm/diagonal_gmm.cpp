@@ -98,6 +98,37 @@ double DiagonalGMM::Probability(const arma::vec& observation,
   return exp(LogProbability(observation, component));
 }
 
+/**
+ * Return the probability of each of the given observations being from this
+ * DiagonalGMM.
+ */
+void DiagonalGMM::Probability(const arma::mat& observations,
+                         arma::vec& probabilities) const
+{
+  LogProbability(observations, probabilities);
+  probabilities = arma::exp(probabilities);
+}
+
+/**
+ * Return the log probability of each of the given observations being from this
+ * DiagonalGMM.
+ */
+void DiagonalGMM::LogProbability(const arma::mat& observations,
+                                 arma::vec& logProbabilities) const
+{
+  ScoreBlocks(observations, &logProbabilities, NULL);
+}
+
+/**
+ * Return the log probability of each of the given single-precision
+ * observations being from this DiagonalGMM.
+ */
+void DiagonalGMM::LogProbability(const arma::fmat& observations,
+                                 arma::fvec& logProbabilities) const
+{
+  ScoreBlocks(observations, &logProbabilities, NULL);
+}
+
 /**
  * Return a randomly generated observation according to the probability
  * distribution defined by this object.
@@ -130,24 +161,33 @@ arma::vec DiagonalGMM::Random() const
 void DiagonalGMM::Classify(const arma::mat& observations,
                            arma::Row<size_t>& labels) const
 {
-  // This is not the best way to do this!
+  // The label of each observation is the component with maximum probability.
+  ScoreBlocks(observations, (arma::vec*) NULL, &labels);
+}
+
+/**
+ * Classify the given single-precision observations as being from an individual
+ * component in this DiagonalGMM.
+ */
+void DiagonalGMM::Classify(const arma::fmat& observations,
+                           arma::Row<size_t>& labels) const
+{
+  ScoreBlocks(observations, (arma::fvec*) NULL, &labels);
+}
 
-  // We should not have to fill this with values, because each one should be
-  // overwritten.
-  labels.set_size(observations.n_cols);
-  for (size_t i = 0; i < observations.n_cols; ++i)
+/**
+ * Compute the log of the weighted probability of each observation under each
+ * component.
+ */
+void DiagonalGMM::ComponentLogProbabilities(const arma::mat& observations,
+                                       arma::mat& logProbabilities) const
+{
+  logProbabilities.set_size(gaussians, observations.n_cols);
+  arma::vec logPhis;
+  for (size_t i = 0; i < gaussians; ++i)
   {
-    // Find maximum probability component.
-    double probability = 0;
-    for (size_t j = 0; j < gaussians; ++j)
-    {
-      double newProb = Probability(observations.unsafe_col(i), j);
-      if (newProb >= probability)
-      {
-        probability = newProb;
-        labels[i] = j;
-      }
-    }
+    dists[i].LogProbability(observations, logPhis);
+    logProbabilities.row(i) = log(weights[i]) + logPhis.t();
   }
 }
 
@@ -19,6 +19,7 @@
 
 // This is the default fitting method class.
 #include "em_fit.hpp"
+#include "online_em_fit.hpp"
 
 // This is the default covariance matrix constraint.
 #include "diagonal_constraint.hpp"
@@ -193,6 +194,40 @@ class DiagonalGMM
    */
   double LogProbability(const arma::vec& observation,
                         const size_t component) const;
+
+  /**
+   * Compute the probability that each observation (column) of the given matrix
+   * came from this distribution.  All the observations are evaluated at once
+   * by each component.
+   *
+   * @param observations Observations to evaluate the probabilities of.
+   * @param probabilities Output probabilities for each observation.
+   */
+  void Probability(const arma::mat& observations,
+                   arma::vec& probabilities) const;
+
+  /**
+   * Compute the log probability that each observation (column) of the given
+   * matrix came from this distribution.  All the observations are evaluated at
+   * once by each component.
+   *
+   * @param observations Observations to evaluate the probabilities of.
+   * @param logProbabilities Output log probabilities for each observation.
+   */
+  void LogProbability(const arma::mat& observations,
+                      arma::vec& logProbabilities) const;
+
+  /**
+   * Compute the log probability that each observation (column) of the given
+   * single-precision matrix came from this distribution.  The observations are
+   * converted to double precision in blocks, so the whole matrix is never
+   * copied.
+   *
+   * @param observations Observations to evaluate the probabilities of.
+   * @param logProbabilities Output log probabilities for each observation.
+   */
+  void LogProbability(const arma::fmat& observations,
+                      arma::fvec& logProbabilities) const;
   /**
    * Return a randomly generated observation according to the probability
    * distribution defined by this object.
@@ -263,6 +298,40 @@ class DiagonalGMM
                const bool useExistingModel = false,
                FittingType fitter = FittingType());
 
+  /**
+   * Train the model on a stream of mini-batches of observations, with a
+   * fitter that is updated one mini-batch at a time, like
+   * OnlineEMFit<kmeans::KMeans<>, DiagonalConstraint,
+   * distribution::DiagonalGaussianDistribution>.  The batch source must
+   * provide the method
+   *
+   * @code
+   * bool NextBatch(arma::mat& batch);
+   * @endcode
+   *
+   * which stores the next mini-batch in the given matrix, and returns false
+   * when there are no mini-batches left.  The fitter must provide the methods
+   * Initialize() and Update() of OnlineEMFit.
+   *
+   * If useExistingModel is false, the initial model is created from the first
+   * mini-batch.  Otherwise the existing model is refreshed with the new
+   * mini-batches; if the fitter has already seen mini-batches, its running
+   * statistics are kept, so the same fitter can be given successive parts of
+   * a stream.
+   *
+   * @param source Source of the mini-batches.
+   * @param fitter The fitter to use.
+   * @param useExistingModel If true, the existing model is used as an initial
+   *     model for the estimation.
+   * @return The number of mini-batches used.
+   */
+  template<typename BatchSourceType, typename FittingType>
+  size_t Train(BatchSourceType& source,
+               FittingType& fitter,
+               const bool useExistingModel = false,
+               const typename std::enable_if_t<
+                   !arma::is_arma_type<BatchSourceType>::value>* = 0);
+
   /**
    * Classify the given observations as being from an individual component in
    * this DiagonalGMM. The resultant classifications are stored in the 'labels'
@@ -283,6 +352,17 @@ class DiagonalGMM
   void Classify(const arma::mat& observations,
                 arma::Row<size_t>& labels) const;
 
+  /**
+   * Classify the given single-precision observations as being from an
+   * individual component in this DiagonalGMM.  The observations are converted
+   * to double precision in blocks, so the whole matrix is never copied.
+   *
+   * @param observations List of observations to classify.
+   * @param labels Object which will be filled with labels.
+   */
+  void Classify(const arma::fmat& observations,
+                arma::Row<size_t>& labels) const;
+
   /**
    * Serialize the DiagonalGMM.
    */
@@ -290,6 +370,32 @@ class DiagonalGMM
   void serialize(Archive& ar, const unsigned int /* version */);
 
  private:
+  /**
+   * Compute the log of the weighted probability of each observation under each
+   * component; element (i, j) of the result corresponds to component i and
+   * observation j.
+   *
+   * @param observations Observations to evaluate the probabilities of.
+   * @param logProbabilities Matrix to store the log probabilities in.
+   */
+  void ComponentLogProbabilities(const arma::mat& observations,
+                                 arma::mat& logProbabilities) const;
+
+  /**
+   * Compute the log probability of each observation and the component it most
+   * likely came from.  The observations are processed in parallel, in blocks
+   * of columns, and each thread reuses its buffers for all of its blocks.
+   *
+   * @param observations Observations to evaluate.
+   * @param logProbabilities If not NULL, filled with the log probability of
+   *     each observation.
+   * @param labels If not NULL, filled with the label of each observation.
+   */
+  template<typename eT>
+  void ScoreBlocks(const arma::Mat<eT>& observations,
+                   arma::Col<eT>* logProbabilities,
+                   arma::Row<size_t>* labels) const;
+
   /**
    * This function computes the log-likelihood of the given model and is used
    * by DiagonalGMM::Train().
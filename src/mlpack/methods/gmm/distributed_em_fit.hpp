@@ -0,0 +1,212 @@
+/**
+ * @file methods/gmm/distributed_em_fit.hpp
+ *
+ * Definition of DistributedEMFit, which fits a GMM with the EM algorithm to a
+ * dataset whose points are sharded across processes.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_GMM_DISTRIBUTED_EM_FIT_HPP
+#define MLPACK_METHODS_GMM_DISTRIBUTED_EM_FIT_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/dists/gaussian_distribution.hpp>
+#include <mlpack/core/dists/diagonal_gaussian_distribution.hpp>
+
+// Default clustering mechanism.
+#include <mlpack/methods/kmeans/distributed_kmeans.hpp>
+// Default covariance matrix constraint.
+#include "positive_definite_constraint.hpp"
+
+namespace mlpack {
+namespace gmm {
+
+/**
+ * DistributedEMFit fits a GMM with the EM algorithm, like EMFit, when every
+ * process holds one shard of the observations: each process calls Estimate()
+ * (for instance through GMM::Train()) with its own shard, and all of them
+ * obtain the same model.  Each iteration computes the responsibilities of the
+ * Gaussians for the points of the shard, and then sums the sufficient
+ * statistics of all shards with the reduction (see kmeans::LocalReduction):
+ * first the sum of the responsibilities, of the weighted points and the
+ * log-likelihood ((d + 1) k + 2 values), and then the weighted scatter around
+ * the new means (d^2 k values, or d k for diagonal covariances).  So only the
+ * points of the shard are ever read by a process.
+ *
+ * The initial clustering must also give consistent results on every process;
+ * by default it is kmeans::DistributedKMeans with the same reduction type, and
+ * the reduction of the fitter is then given to the clusterer before it runs,
+ * so both reduce over the same processes.  Train with a single trial, since
+ * GMM::Train() compares trials with the log-likelihood of the shard (which is
+ * also what it returns).
+ *
+ * @tparam ReductionType Reduction over the processes.
+ * @tparam InitialClusteringType Distributed clustering of the shards.
+ * @tparam CovarianceConstraintPolicy Constraint on the covariances.
+ * @tparam Distribution Type of the Gaussians (GaussianDistribution or
+ *     DiagonalGaussianDistribution).
+ */
+template<typename ReductionType = kmeans::LocalReduction,
+         typename InitialClusteringType =
+             kmeans::DistributedKMeans<ReductionType>,
+         typename CovarianceConstraintPolicy = PositiveDefiniteConstraint,
+         typename Distribution = distribution::GaussianDistribution>
+class DistributedEMFit
+{
+ public:
+  /**
+   * Construct the DistributedEMFit object.  Setting the maximum number of
+   * iterations to 0 means that the EM algorithm will iterate until
+   * convergence (with the given tolerance).
+   *
+   * @param maxIterations Maximum number of iterations for EM.
+   * @param tolerance Log-likelihood tolerance required for convergence.
+   * @param clusterer Object which will perform the initial clustering.
+   * @param constraint Constraint policy of covariance.
+   * @param reduction Reduction over the processes.
+   */
+  DistributedEMFit(
+      const size_t maxIterations = 300,
+      const double tolerance = 1e-10,
+      InitialClusteringType clusterer = InitialClusteringType(),
+      CovarianceConstraintPolicy constraint = CovarianceConstraintPolicy(),
+      ReductionType reduction = ReductionType());
+
+  /**
+   * Fit the observations of all shards to a GMM.  The size of the vectors
+   * (indicating the number of components) must already be set, and be the
+   * same on every process; if useInitialModel is true, the given model (which
+   * must be the same on every process) is used instead of the initial
+   * clustering.
+   *
+   * @param observations Shard of the observations held by this process.
+   * @param dists Distributions to store model in.
+   * @param weights Vector to store a priori weights in.
+   * @param useInitialModel If true, the given model is used for the initial
+   *      clustering.
+   */
+  void Estimate(const arma::mat& observations,
+                std::vector<Distribution>& dists,
+                arma::vec& weights,
+                const bool useInitialModel = false);
+
+  /**
+   * Fit the observations of all shards to a GMM, taking into account the
+   * probability of each point being from this mixture.
+   *
+   * @param observations Shard of the observations held by this process.
+   * @param probabilities Probability of each point of the shard being from
+   *      this model.
+   * @param dists Distributions to store model in.
+   * @param weights Vector to store a priori weights in.
+   * @param useInitialModel If true, the given model is used for the initial
+   *      clustering.
+   */
+  void Estimate(const arma::mat& observations,
+                const arma::vec& probabilities,
+                std::vector<Distribution>& dists,
+                arma::vec& weights,
+                const bool useInitialModel = false);
+
+  //! Get the clusterer.
+  const InitialClusteringType& Clusterer() const { return clusterer; }
+  //! Modify the clusterer.
+  InitialClusteringType& Clusterer() { return clusterer; }
+
+  //! Get the covariance constraint policy class.
+  const CovarianceConstraintPolicy& Constraint() const { return constraint; }
+  //! Modify the covariance constraint policy class.
+  CovarianceConstraintPolicy& Constraint() { return constraint; }
+
+  //! Get the reduction over the processes.
+  const ReductionType& Reduction() const { return reduction; }
+  //! Modify the reduction over the processes.
+  ReductionType& Reduction() { return reduction; }
+
+  //! Get the maximum number of iterations of the EM algorithm.
+  size_t MaxIterations() const { return maxIterations; }
+  //! Modify the maximum number of iterations of the EM algorithm.
+  size_t& MaxIterations() { return maxIterations; }
+
+  //! Get the tolerance for the convergence of the EM algorithm.
+  double Tolerance() const { return tolerance; }
+  //! Modify the tolerance for the convergence of the EM algorithm.
+  double& Tolerance() { return tolerance; }
+
+  //! Serialize the fitter.
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int version);
+
+ private:
+  //! Run the EM algorithm; probabilities may be NULL.
+  void Fit(const arma::mat& observations,
+           const arma::vec* probabilities,
+           std::vector<Distribution>& dists,
+           arma::vec& weights,
+           const bool useInitialModel);
+
+  //! Run the clusterer, and turn the cluster assignments of all shards into
+  //! Gaussians.
+  void InitialClustering(const arma::mat& observations,
+                         std::vector<Distribution>& dists,
+                         arma::vec& weights);
+
+  /**
+   * Compute the responsibility of each Gaussian for each observation of the
+   * shard (the E-step), times the probability of the observation if
+   * probabilities is not NULL, and return the log-likelihood of the shard.
+   */
+  static double Responsibilities(const arma::mat& observations,
+                                 const arma::vec* probabilities,
+                                 const std::vector<Distribution>& dists,
+                                 const arma::vec& weights,
+                                 arma::mat& responsibilities);
+
+  /**
+   * Sum, over all shards, the responsibilities of each Gaussian (in the last
+   * row of moments), the observations weighted by them (in the other rows),
+   * the weight of the observations and the given log-likelihoods, which is
+   * returned.
+   */
+  double SumMoments(const arma::mat& observations,
+                    const arma::mat& responsibilities,
+                    double& weight,
+                    const double logLikelihood,
+                    arma::mat& moments) const;
+
+  /**
+   * Update the model from the moments of all shards, after summing the
+   * scatter of the observations around the new means (the M-step).
+   */
+  void UpdateModel(const arma::mat& observations,
+                   const arma::mat& responsibilities,
+                   const arma::mat& moments,
+                   const double weight,
+                   std::vector<Distribution>& dists,
+                   arma::vec& weights);
+
+  //! The number of observations handled at once by a thread.
+  static const size_t BlockSize = 1024;
+
+  //! Maximum iterations of EM algorithm.
+  size_t maxIterations;
+  //! Tolerance for convergence of EM.
+  double tolerance;
+  //! Object which will perform the clustering.
+  InitialClusteringType clusterer;
+  //! Object which applies constraints to the covariance matrix.
+  CovarianceConstraintPolicy constraint;
+  //! The reduction over the processes.
+  ReductionType reduction;
+};
+
+} // namespace gmm
+} // namespace mlpack
+
+// Include implementation.
+#include "distributed_em_fit_impl.hpp"
+
+#endif
@@ -0,0 +1,385 @@
+/**
+ * @file methods/gmm/distributed_em_fit_impl.hpp
+ *
+ * Implementation of DistributedEMFit.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_GMM_DISTRIBUTED_EM_FIT_IMPL_HPP
+#define MLPACK_METHODS_GMM_DISTRIBUTED_EM_FIT_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "distributed_em_fit.hpp"
+
+#include <mlpack/core/math/log_add.hpp>
+
+namespace mlpack {
+namespace gmm {
+
+template<typename ReductionType,
+         typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+const size_t DistributedEMFit<ReductionType, InitialClusteringType,
+    CovarianceConstraintPolicy, Distribution>::BlockSize;
+
+//! Constructor.
+//! Give the reduction of the fitter to the initial clusterer; only a
+//! DistributedKMeans clusterer with the same reduction type (below) takes it.
+template<typename ReductionType, typename InitialClusteringType>
+void ShareReduction(const ReductionType& /* reduction */,
+                    InitialClusteringType& /* clusterer */)
+{
+  // Nothing to do.
+}
+
+//! Give the reduction of the fitter to the initialization of a
+//! DistributedKMeans clusterer, which then passes it on to every iteration.
+template<typename ReductionType,
+         typename MetricType,
+         typename InitialPartitionPolicy,
+         typename EmptyClusterPolicy,
+         template<class, class> class LloydStepType,
+         typename MatType>
+void ShareReduction(
+    const ReductionType& reduction,
+    kmeans::KMeans<MetricType,
+        kmeans::DistributedInitialization<InitialPartitionPolicy,
+            ReductionType>,
+        EmptyClusterPolicy,
+        LloydStepType,
+        MatType>& clusterer)
+{
+  clusterer.Partitioner().Reduction() = reduction;
+}
+
+template<typename ReductionType,
+         typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+DistributedEMFit<ReductionType, InitialClusteringType,
+    CovarianceConstraintPolicy, Distribution>::DistributedEMFit(
+    const size_t maxIterations,
+    const double tolerance,
+    InitialClusteringType clusterer,
+    CovarianceConstraintPolicy constraint,
+    ReductionType reduction) :
+    maxIterations(maxIterations),
+    tolerance(tolerance),
+    clusterer(clusterer),
+    constraint(constraint),
+    reduction(reduction)
+{ /* Nothing to do. */ }
+
+template<typename ReductionType,
+         typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+void DistributedEMFit<ReductionType, InitialClusteringType,
+    CovarianceConstraintPolicy, Distribution>::Estimate(
+    const arma::mat& observations,
+    std::vector<Distribution>& dists,
+    arma::vec& weights,
+    const bool useInitialModel)
+{
+  Fit(observations, NULL, dists, weights, useInitialModel);
+}
+
+template<typename ReductionType,
+         typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+void DistributedEMFit<ReductionType, InitialClusteringType,
+    CovarianceConstraintPolicy, Distribution>::Estimate(
+    const arma::mat& observations,
+    const arma::vec& probabilities,
+    std::vector<Distribution>& dists,
+    arma::vec& weights,
+    const bool useInitialModel)
+{
+  if (probabilities.n_elem != observations.n_cols)
+  {
+    std::ostringstream oss;
+    oss << "DistributedEMFit::Estimate(): " << probabilities.n_elem
+        << " probabilities given for " << observations.n_cols
+        << " observations!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  Fit(observations, &probabilities, dists, weights, useInitialModel);
+}
+
+template<typename ReductionType,
+         typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+void DistributedEMFit<ReductionType, InitialClusteringType,
+    CovarianceConstraintPolicy, Distribution>::Fit(
+    const arma::mat& observations,
+    const arma::vec* probabilities,
+    std::vector<Distribution>& dists,
+    arma::vec& weights,
+    const bool useInitialModel)
+{
+  if (!useInitialModel)
+    InitialClustering(observations, dists, weights);
+
+  arma::mat responsibilities;
+  arma::mat moments;
+  double lOld = -DBL_MAX;
+
+  // Iterate to update the model until no more improvement is found.  The
+  // log-likelihood of the current model is summed along with the moments of
+  // the next one, so the last moments are discarded.
+  for (size_t iteration = 1; ; ++iteration)
+  {
+    const double localLogLikelihood = Responsibilities(observations,
+        probabilities, dists, weights, responsibilities);
+    double weight = (probabilities == NULL) ? observations.n_cols :
+        arma::accu(*probabilities);
+    const double l = SumMoments(observations, responsibilities, weight,
+        localLogLikelihood, moments);
+
+    if (std::abs(l - lOld) <= tolerance || iteration == maxIterations)
+      break;
+
+    Log::Info << "DistributedEMFit::Estimate(): iteration " << iteration
+        << ", log-likelihood " << l << "." << std::endl;
+
+    UpdateModel(observations, responsibilities, moments, weight, dists,
+        weights);
+    lOld = l;
+  }
+}
+
+template<typename ReductionType,
+         typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+void DistributedEMFit<ReductionType, InitialClusteringType,
+    CovarianceConstraintPolicy, Distribution>::InitialClustering(
+    const arma::mat& observations,
+    std::vector<Distribution>& dists,
+    arma::vec& weights)
+{
+  // The clusterer must reduce over the same processes as the fitter.
+  ShareReduction(reduction, clusterer);
+  arma::Row<size_t> assignments;
+  clusterer.Cluster(observations, dists.size(), assignments);
+
+  // Each point is only the responsibility of its cluster.
+  arma::mat responsibilities(dists.size(), observations.n_cols,
+      arma::fill::zeros);
+  for (size_t i = 0; i < observations.n_cols; ++i)
+    responsibilities(assignments[i], i) = 1.0;
+
+  double weight = observations.n_cols;
+  arma::mat moments;
+  SumMoments(observations, responsibilities, weight, 0.0, moments);
+  UpdateModel(observations, responsibilities, moments, weight, dists,
+      weights);
+}
+
+template<typename ReductionType,
+         typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+double DistributedEMFit<ReductionType, InitialClusteringType,
+    CovarianceConstraintPolicy, Distribution>::Responsibilities(
+    const arma::mat& observations,
+    const arma::vec* probabilities,
+    const std::vector<Distribution>& dists,
+    const arma::vec& weights,
+    arma::mat& responsibilities)
+{
+  responsibilities.set_size(dists.size(), observations.n_cols);
+
+  // Each block of observations is handled by one thread.
+  double logLikelihood = 0.0;
+  const size_t numBlocks = (observations.n_cols + BlockSize - 1) / BlockSize;
+  #pragma omp parallel for reduction(+:logLikelihood)
+  for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+  {
+    const size_t begin = b * BlockSize;
+    const size_t count = std::min(BlockSize, observations.n_cols - begin);
+
+    // Make an alias of the block, to avoid copying it.
+    const arma::mat block(const_cast<double*>(observations.colptr(begin)),
+        observations.n_rows, count, false, true);
+
+    arma::vec logPhis;
+    for (size_t i = 0; i < dists.size(); ++i)
+    {
+      dists[i].LogProbability(block, logPhis);
+      responsibilities.submat(i, begin, i, begin + count - 1) =
+          log(weights[i]) + logPhis.t();
+    }
+
+    // Normalize each column; if the probability of a point is 0 under every
+    // Gaussian, it is the responsibility of none.
+    for (size_t j = begin; j < begin + count; ++j)
+    {
+      const double logSum = mlpack::math::AccuLog(responsibilities.col(j));
+      logLikelihood += logSum;
+      if (logSum == -std::numeric_limits<double>::infinity())
+      {
+        responsibilities.col(j).zeros();
+        continue;
+      }
+
+      responsibilities.col(j) = arma::exp(responsibilities.col(j) - logSum);
+      if (probabilities != NULL)
+        responsibilities.col(j) *= (*probabilities)[j];
+    }
+  }
+
+  return logLikelihood;
+}
+
+template<typename ReductionType,
+         typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+double DistributedEMFit<ReductionType, InitialClusteringType,
+    CovarianceConstraintPolicy, Distribution>::SumMoments(
+    const arma::mat& observations,
+    const arma::mat& responsibilities,
+    double& weight,
+    const double logLikelihood,
+    arma::mat& moments) const
+{
+  // The moments are followed by the weight and the log-likelihood, so that
+  // they are all summed with one reduction.
+  const size_t dimensionality = observations.n_rows;
+  arma::vec statistics((dimensionality + 1) * responsibilities.n_rows + 2);
+  arma::mat localMoments(statistics.memptr(), dimensionality + 1,
+      responsibilities.n_rows, false, true);
+  localMoments.head_rows(dimensionality) =
+      observations * responsibilities.t();
+  localMoments.row(dimensionality) = arma::sum(responsibilities, 1).t();
+  statistics[statistics.n_elem - 2] = weight;
+  statistics[statistics.n_elem - 1] = logLikelihood;
+
+  reduction.Sum(statistics.memptr(), statistics.n_elem);
+
+  moments = localMoments;
+  weight = statistics[statistics.n_elem - 2];
+  return statistics[statistics.n_elem - 1];
+}
+
+template<typename ReductionType,
+         typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+void DistributedEMFit<ReductionType, InitialClusteringType,
+    CovarianceConstraintPolicy, Distribution>::UpdateModel(
+    const arma::mat& observations,
+    const arma::mat& responsibilities,
+    const arma::mat& moments,
+    const double weight,
+    std::vector<Distribution>& dists,
+    arma::vec& weights)
+{
+  // If the distribution is DiagonalGaussianDistribution, calculate the
+  // covariance only with diagonal components.
+  const bool isDiagGaussDist = std::is_same<Distribution,
+      distribution::DiagonalGaussianDistribution>::value;
+  typedef typename std::conditional<isDiagGaussDist, arma::vec,
+      arma::mat>::type CovarianceType;
+
+  const size_t dimensionality = observations.n_rows;
+  const arma::rowvec counts = moments.row(dimensionality);
+  arma::mat means = moments.head_rows(dimensionality);
+  for (size_t i = 0; i < dists.size(); ++i)
+    if (counts[i] > 0.0)
+      means.col(i) /= counts[i];
+
+  // Accumulate the weighted scatter of the observations of the shard around
+  // the new means, in parallel over blocks of observations as in EMFit.
+  const size_t covarianceSize = isDiagGaussDist ? dimensionality :
+      dimensionality * dimensionality;
+  arma::vec scatter(covarianceSize * dists.size(), arma::fill::zeros);
+  const size_t numBlocks = (observations.n_cols + BlockSize - 1) / BlockSize;
+  #pragma omp parallel
+  {
+    arma::vec localScatter(scatter.n_elem, arma::fill::zeros);
+
+    #pragma omp for
+    for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+    {
+      const size_t begin = b * BlockSize;
+      const size_t end = std::min(begin + BlockSize, observations.n_cols) - 1;
+
+      for (size_t i = 0; i < dists.size(); ++i)
+      {
+        if (counts[i] == 0.0)
+          continue;
+
+        arma::mat diffs = observations.cols(begin, end);
+        diffs.each_col() -= means.col(i);
+
+        arma::mat covariance(localScatter.memptr() + i * covarianceSize,
+            dimensionality, isDiagGaussDist ? 1 : dimensionality, false, true);
+        if (isDiagGaussDist)
+        {
+          covariance += (diffs % diffs) *
+              responsibilities.submat(i, begin, i, end).t();
+        }
+        else
+        {
+          diffs.each_row() %=
+              arma::sqrt(responsibilities.submat(i, begin, i, end));
+          covariance += diffs * diffs.t();
+        }
+      }
+    }
+
+    #pragma omp critical
+    scatter += localScatter;
+  }
+
+  // Sum the scatter of all shards.
+  reduction.Sum(scatter.memptr(), scatter.n_elem);
+
+  for (size_t i = 0; i < dists.size(); ++i)
+  {
+    // Don't update if there's no probability of the Gaussian having points.
+    if (counts[i] == 0.0)
+      continue;
+
+    CovarianceType covariance = arma::mat(scatter.memptr() +
+        i * covarianceSize, dimensionality,
+        isDiagGaussDist ? 1 : dimensionality, false, true) / counts[i];
+
+    // Apply covariance constraint.
+    constraint.ApplyConstraint(covariance);
+    dists[i].Mean() = means.col(i);
+    dists[i].Covariance(std::move(covariance));
+  }
+
+  weights = counts.t() / weight;
+}
+
+template<typename ReductionType,
+         typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+template<typename Archive>
+void DistributedEMFit<ReductionType, InitialClusteringType,
+    CovarianceConstraintPolicy, Distribution>::serialize(
+    Archive& ar,
+    const unsigned int /* version */)
+{
+  ar & BOOST_SERIALIZATION_NVP(maxIterations);
+  ar & BOOST_SERIALIZATION_NVP(tolerance);
+  ar & BOOST_SERIALIZATION_NVP(clusterer);
+  ar & BOOST_SERIALIZATION_NVP(constraint);
+}
+
+} // namespace gmm
+} // namespace mlpack
+
+#endif
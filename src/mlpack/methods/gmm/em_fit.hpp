@@ -131,10 +131,9 @@ class EMFit
   template<typename Archive>
   void serialize(Archive& ar, const unsigned int version);
 
- private:
   /**
    * Run the clusterer, and then turn the cluster assignments into Gaussians.
-   * This is a helper function for both overloads of Estimate().  The vectors
+   * This is used by both overloads of Estimate(), and by OnlineEMFit.  The vectors
    * must be already set to the number of clusters.
    *
    * @param observations List of observations.
@@ -147,6 +146,7 @@ class EMFit
       std::vector<Distribution>& dists,
       arma::vec& weights);
 
+ private:
   /**
    * Calculate the log-likelihood of a model.  Yes, this is reimplemented in the
    * GMM code.  Intuition suggests that the log-likelihood is not the best way
@@ -178,6 +178,58 @@ class EMFit
       arma::vec& weights,
       const bool useInitialModel);
 
+  //! The number of observations handled at once by a thread.
+  static const size_t BlockSize = 1024;
+
+  /**
+   * Compute the log of the weighted probability of each observation under each
+   * Gaussian; element (i, j) of the result corresponds to Gaussian i and
+   * observation j.  Blocks of observations are handled in parallel.
+   *
+   * @param observations List of observations.
+   * @param dists Distributions of the model.
+   * @param weights A priori weights of the model.
+   * @param logProbabilities Matrix to store the log probabilities in.
+   */
+  static void ComponentLogProbabilities(
+      const arma::mat& observations,
+      const std::vector<Distribution>& dists,
+      const arma::vec& weights,
+      arma::mat& logProbabilities);
+
+  /**
+   * Compute the log of the conditional probability of each Gaussian given each
+   * observation (the E-step); each column of the result corresponds to an
+   * observation and is normalized with a log-sum-exp.
+   *
+   * @param observations List of observations.
+   * @param dists Distributions of the model.
+   * @param weights A priori weights of the model.
+   * @param condLogProb Matrix to store the conditional log probabilities in.
+   */
+  static void ConditionalLogProbabilities(
+      const arma::mat& observations,
+      const std::vector<Distribution>& dists,
+      const arma::vec& weights,
+      arma::mat& condLogProb);
+
+  /**
+   * Update the means and covariances of the Gaussians from the conditional
+   * log probabilities (the M-step).  The weighted scatter matrices are
+   * accumulated in parallel over blocks of observations.
+   *
+   * @param observations List of observations.
+   * @param condLogProb Conditional log probabilities, one row per Gaussian;
+   *     this is overwritten with the normalized weights of the observations.
+   * @param probRowSums Log of the sum of each row of condLogProb.
+   * @param dists Distributions to update.
+   */
+  void UpdateDistributions(
+      const arma::mat& observations,
+      arma::mat& condLogProb,
+      const arma::vec& probRowSums,
+      std::vector<Distribution>& dists);
+
   //! Maximum iterations of EM algorithm.
   size_t maxIterations;
   //! Tolerance for convergence of EM.
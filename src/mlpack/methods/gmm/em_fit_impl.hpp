@@ -3,7 +3,8 @@
  * @author Ryan Curtin
  * @author Michael Fox
  *
- * Implementation of EM algorithm for fitting GMMs.
+ * Implementation of EM algorithm for fitting GMMs.  The E-step and the M-step
+ * are run on several threads when OpenMP is available.
  *
  * mlpack is free software; you may redistribute it and/or modify it under the
  * terms of the 3-clause BSD license.  You should have received a copy of the
@@ -21,6 +22,12 @@
 namespace mlpack {
 namespace gmm {
 
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+const size_t EMFit<InitialClusteringType, CovarianceConstraintPolicy,
+    Distribution>::BlockSize;
+
 //! Constructor.
 template<typename InitialClusteringType,
          typename CovarianceConstraintPolicy,
@@ -77,7 +84,7 @@ Estimate(const arma::mat& observations,
       << l << std::endl;
 
   double lOld = -DBL_MAX;
-  arma::mat condLogProb(observations.n_cols, dists.size());
+  arma::mat condLogProb;
 
   // Iterate to update the model until no more improvement is found.
   size_t iteration = 1;
@@ -88,71 +95,16 @@ Estimate(const arma::mat& observations,
 
     // Calculate the conditional probabilities of choosing a particular
     // Gaussian given the observations and the present theta value.
-    for (size_t i = 0; i < dists.size(); ++i)
-    {
-      // Store conditional log probabilities into condLogProb vector for each
-      // Gaussian.  First we make an alias of the condLogProb vector.
-      arma::vec condLogProbAlias = condLogProb.unsafe_col(i);
-      dists[i].LogProbability(observations, condLogProbAlias);
-      condLogProbAlias += log(weights[i]);
-    }
-
-    // Normalize row-wise.
-    for (size_t i = 0; i < condLogProb.n_rows; ++i)
-    {
-      // Avoid dividing by zero; if the probability for everything is 0, we
-      // don't want to make it NaN.
-      const double probSum = mlpack::math::AccuLog(condLogProb.row(i));
-      if (probSum != -std::numeric_limits<double>::infinity())
-        condLogProb.row(i) -= probSum;
-    }
+    ConditionalLogProbabilities(observations, dists, weights, condLogProb);
 
     // Store the sum of the probability of each state over all the observations.
     arma::vec probRowSums(dists.size());
     for (size_t i = 0; i < dists.size(); ++i)
-    {
-      probRowSums(i) = mlpack::math::AccuLog(condLogProb.col(i));
-    }
-
-    // Calculate the new value of the means using the updated conditional
-    // probabilities.
-    for (size_t i = 0; i < dists.size(); ++i)
-    {
-      // Don't update if there's no probability of the Gaussian having points.
-      if (probRowSums[i] != -std::numeric_limits<double>::infinity())
-        dists[i].Mean() = observations * arma::exp(condLogProb.col(i) -
-                                                   probRowSums[i]);
-      else
-        continue;
-
-      // Calculate the new value of the covariances using the updated
-      // conditional probabilities and the updated means.
-      arma::mat tmp = observations.each_col() - dists[i].Mean();
-
-      // If the distribution is DiagonalGaussianDistribution, calculate the
-      // covariance only with diagonal components.
-      if (std::is_same<Distribution,
-          distribution::DiagonalGaussianDistribution>::value)
-      {
-        arma::vec covariance = arma::sum((tmp % tmp) %
-            (arma::ones<arma::vec>(observations.n_rows) *
-            trans(arma::exp(condLogProb.col(i) - probRowSums[i]))), 1);
+      probRowSums(i) = mlpack::math::AccuLog(condLogProb.row(i));
 
-        // Apply covariance constraint.
-        constraint.ApplyConstraint(covariance);
-        dists[i].Covariance(std::move(covariance));
-      }
-      else
-      {
-        arma::mat tmpB = tmp.each_row() % trans(arma::exp(condLogProb.col(i) -
-                                                          probRowSums[i]));
-        arma::mat covariance = tmp * trans(tmpB);
-
-        // Apply covariance constraint.
-        constraint.ApplyConstraint(covariance);
-        dists[i].Covariance(std::move(covariance));
-      }
-    }
+    // Calculate the new values of the means and covariances using the updated
+    // conditional probabilities.
+    UpdateDistributions(observations, condLogProb, probRowSums, dists);
 
     // Calculate the new values for omega using the updated conditional
     // probabilities.
@@ -185,7 +137,7 @@ Estimate(const arma::mat& observations,
       << l << std::endl;
 
   double lOld = -DBL_MAX;
-  arma::mat condLogProb(observations.n_cols, dists.size());
+  arma::mat condLogProb;
 
   // Iterate to update the model until no more improvement is found.
   size_t iteration = 1;
@@ -193,79 +145,20 @@ Estimate(const arma::mat& observations,
   {
     // Calculate the conditional probabilities of choosing a particular
     // Gaussian given the observations and the present theta value.
-    for (size_t i = 0; i < dists.size(); ++i)
-    {
-      // Store conditional log probabilities into condLogProb vector for each
-      // Gaussian.  First we make an alias of the condLogProb vector.
-      arma::vec condLogProbAlias = condLogProb.unsafe_col(i);
-      dists[i].LogProbability(observations, condLogProbAlias);
-      condLogProbAlias += log(weights[i]);
-    }
-
-    // Normalize row-wise.
-    for (size_t i = 0; i < condLogProb.n_rows; ++i)
-    {
-      // Avoid dividing by zero; if the probability for everything is 0, we
-      // don't want to make it NaN.
-      const double probSum = mlpack::math::AccuLog(condLogProb.row(i));
-      if (probSum != -std::numeric_limits<double>::infinity())
-        condLogProb.row(i) -= probSum;
-    }
+    ConditionalLogProbabilities(observations, dists, weights, condLogProb);
 
-    // This will store the sum of probabilities of each state over all the
-    // observations.
+    // Multiply the conditional probability of each point being from each
+    // Gaussian by the probability of the point being from this mixture model,
+    // and sum the result over all the observations.
+    const arma::vec logProbabilities = arma::log(probabilities);
+    condLogProb.each_row() += logProbabilities.t();
     arma::vec probRowSums(dists.size());
-
-    // Calculate the new value of the means using the updated conditional
-    // probabilities.
-    arma::vec logProbabilities = arma::log(probabilities);
     for (size_t i = 0; i < dists.size(); ++i)
-    {
-      // Calculate the sum of probabilities of points, which is the
-      // conditional probability of each point being from Gaussian i
-      // multiplied by the probability of the point being from this mixture
-      // model.
-      arma::vec tmpProb = condLogProb.col(i) + logProbabilities;
-      probRowSums[i] = mlpack::math::AccuLog(tmpProb);
-
-      // Don't update if there's no probability of the Gaussian having points.
-      if (probRowSums[i] != -std::numeric_limits<double>::infinity())
-      {
-        dists[i].Mean() = observations *
-              arma::exp(condLogProb.col(i) + logProbabilities - probRowSums[i]);
-      }
-      else
-        continue;
-
-      // Calculate the new value of the covariances using the updated
-      // conditional probabilities and the updated means.
-      arma::mat tmp = observations.each_col() - dists[i].Mean();
-
-      // If the distribution is DiagonalGaussianDistribution, calculate the
-      // covariance only with diagonal components.
-      if (std::is_same<Distribution,
-          distribution::DiagonalGaussianDistribution>::value)
-      {
-        arma::vec cov = arma::sum((tmp % tmp) %
-            (arma::ones<arma::vec>(observations.n_rows) *
-            trans(arma::exp(condLogProb.col(i) +
-                            logProbabilities - probRowSums[i]))), 1);
-
-        // Apply covariance constraint.
-        constraint.ApplyConstraint(cov);
-        dists[i].Covariance(std::move(cov));
-      }
-      else
-      {
-        arma::mat tmpB = tmp.each_row() % trans(arma::exp(condLogProb.col(i) +
-            logProbabilities - probRowSums[i]));
-        arma::mat cov = (tmp * trans(tmpB));
+      probRowSums(i) = mlpack::math::AccuLog(condLogProb.row(i));
 
-        // Apply covariance constraint.
-        constraint.ApplyConstraint(cov);
-        dists[i].Covariance(std::move(cov));
-      }
-    }
+    // Calculate the new values of the means and covariances using the updated
+    // conditional probabilities.
+    UpdateDistributions(observations, condLogProb, probRowSums, dists);
 
     // Calculate the new values for omega using the updated conditional
     // probabilities.
@@ -383,30 +276,179 @@ LogLikelihood(const arma::mat& observations,
 {
   double logLikelihood = 0;
 
-  arma::vec logPhis;
-  arma::mat logLikelihoods(dists.size(), observations.n_cols);
-
   // It has to be LogProbability() otherwise Probability() would overflow easily
-  for (size_t i = 0; i < dists.size(); ++i)
-  {
-    dists[i].LogProbability(observations, logPhis);
-    logLikelihoods.row(i) = log(weights(i)) + trans(logPhis);
-  }
+  arma::mat logLikelihoods;
+  ComponentLogProbabilities(observations, dists, weights, logLikelihoods);
+
   // Now sum over every point.
-  for (size_t j = 0; j < observations.n_cols; ++j)
+  #pragma omp parallel for reduction(+:logLikelihood)
+  for (omp_size_t j = 0; j < (omp_size_t) observations.n_cols; ++j)
   {
-    if (mlpack::math::AccuLog(logLikelihoods.col(j)) ==
-        -std::numeric_limits<double>::infinity())
+    const double pointLogLikelihood =
+        mlpack::math::AccuLog(logLikelihoods.col(j));
+    if (pointLogLikelihood == -std::numeric_limits<double>::infinity())
     {
+      #pragma omp critical
       Log::Info << "Likelihood of point " << j << " is 0!  It is probably an "
           << "outlier." << std::endl;
     }
-    logLikelihood += mlpack::math::AccuLog(logLikelihoods.col(j));
+    logLikelihood += pointLogLikelihood;
   }
 
   return logLikelihood;
 }
 
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+void EMFit<InitialClusteringType, CovarianceConstraintPolicy, Distribution>::
+ComponentLogProbabilities(const arma::mat& observations,
+                          const std::vector<Distribution>& dists,
+                          const arma::vec& weights,
+                          arma::mat& logProbabilities)
+{
+  logProbabilities.set_size(dists.size(), observations.n_cols);
+
+  // Each block of observations is handled by one thread.
+  const size_t numBlocks = (observations.n_cols + BlockSize - 1) / BlockSize;
+  #pragma omp parallel for
+  for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+  {
+    const size_t begin = b * BlockSize;
+    const size_t count = std::min(BlockSize, observations.n_cols - begin);
+
+    // Make an alias of the block, to avoid copying it.
+    const arma::mat block(const_cast<double*>(observations.colptr(begin)),
+        observations.n_rows, count, false, true);
+
+    arma::vec logPhis;
+    for (size_t i = 0; i < dists.size(); ++i)
+    {
+      dists[i].LogProbability(block, logPhis);
+      logProbabilities.submat(i, begin, i, begin + count - 1) =
+          log(weights[i]) + logPhis.t();
+    }
+  }
+}
+
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+void EMFit<InitialClusteringType, CovarianceConstraintPolicy, Distribution>::
+ConditionalLogProbabilities(const arma::mat& observations,
+                            const std::vector<Distribution>& dists,
+                            const arma::vec& weights,
+                            arma::mat& condLogProb)
+{
+  ComponentLogProbabilities(observations, dists, weights, condLogProb);
+
+  // Normalize column-wise.
+  #pragma omp parallel for
+  for (omp_size_t j = 0; j < (omp_size_t) condLogProb.n_cols; ++j)
+  {
+    // Avoid dividing by zero; if the probability for everything is 0, we
+    // don't want to make it NaN.
+    const double probSum = mlpack::math::AccuLog(condLogProb.col(j));
+    if (probSum != -std::numeric_limits<double>::infinity())
+      condLogProb.col(j) -= probSum;
+  }
+}
+
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+void EMFit<InitialClusteringType, CovarianceConstraintPolicy, Distribution>::
+UpdateDistributions(const arma::mat& observations,
+                    arma::mat& condLogProb,
+                    const arma::vec& probRowSums,
+                    std::vector<Distribution>& dists)
+{
+  // If the distribution is DiagonalGaussianDistribution, calculate the
+  // covariance only with diagonal components.
+  const bool isDiagGaussDist = std::is_same<Distribution,
+      distribution::DiagonalGaussianDistribution>::value;
+  typedef typename std::conditional<isDiagGaussDist, arma::vec,
+      arma::mat>::type CovarianceType;
+
+  // Turn the conditional log probabilities into weights that sum to 1 for each
+  // Gaussian.  Gaussians with no probability of having points are not
+  // updated.
+  for (size_t i = 0; i < dists.size(); ++i)
+  {
+    if (probRowSums[i] != -std::numeric_limits<double>::infinity())
+      condLogProb.row(i) = arma::exp(condLogProb.row(i) - probRowSums[i]);
+    else
+      condLogProb.row(i).zeros();
+  }
+
+  // Calculate the new value of the means with one matrix multiplication.
+  const arma::mat means = observations * condLogProb.t();
+
+  // Now accumulate the weighted scatter of the observations around the new
+  // means.  Each thread accumulates the scatter of its blocks of observations
+  // separately; for full covariances, the scatter of a block is a product of
+  // the scaled differences with their own transpose, which Armadillo computes
+  // with a rank-k update (SYRK).
+  std::vector<CovarianceType> covariances(dists.size());
+  for (size_t i = 0; i < dists.size(); ++i)
+  {
+    if (isDiagGaussDist)
+      covariances[i].zeros(observations.n_rows);
+    else
+      covariances[i].zeros(observations.n_rows, observations.n_rows);
+  }
+
+  const size_t numBlocks = (observations.n_cols + BlockSize - 1) / BlockSize;
+  #pragma omp parallel
+  {
+    std::vector<CovarianceType> localCovariances(covariances);
+
+    #pragma omp for
+    for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+    {
+      const size_t begin = b * BlockSize;
+      const size_t end = std::min(begin + BlockSize, observations.n_cols) - 1;
+
+      for (size_t i = 0; i < dists.size(); ++i)
+      {
+        if (probRowSums[i] == -std::numeric_limits<double>::infinity())
+          continue;
+
+        arma::mat diffs = observations.cols(begin, end);
+        diffs.each_col() -= means.col(i);
+
+        if (isDiagGaussDist)
+        {
+          localCovariances[i] += (diffs % diffs) *
+              condLogProb.submat(i, begin, i, end).t();
+        }
+        else
+        {
+          diffs.each_row() %= arma::sqrt(condLogProb.submat(i, begin, i, end));
+          localCovariances[i] += diffs * diffs.t();
+        }
+      }
+    }
+
+    #pragma omp critical
+    for (size_t i = 0; i < dists.size(); ++i)
+      covariances[i] += localCovariances[i];
+  }
+
+  for (size_t i = 0; i < dists.size(); ++i)
+  {
+    // Don't update if there's no probability of the Gaussian having points.
+    if (probRowSums[i] == -std::numeric_limits<double>::infinity())
+      continue;
+
+    dists[i].Mean() = means.col(i);
+
+    // Apply covariance constraint.
+    constraint.ApplyConstraint(covariances[i]);
+    dists[i].Covariance(std::move(covariances[i]));
+  }
+}
+
 template<typename InitialClusteringType,
          typename CovarianceConstraintPolicy,
          typename Distribution>
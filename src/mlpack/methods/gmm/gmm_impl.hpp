@@ -187,6 +187,32 @@ double GMM::Train(const arma::mat& observations,
   return bestLikelihood;
 }
 
+/**
+ * Fit the GMM to a stream of mini-batches of observations.
+ */
+template<typename BatchSourceType, typename FittingType>
+size_t GMM::Train(BatchSourceType& source,
+                  FittingType& fitter,
+                  const bool useExistingModel,
+                  const typename std::enable_if_t<
+                      !arma::is_arma_type<BatchSourceType>::value>*)
+{
+  size_t batches = 0;
+  arma::mat batch;
+  while (source.NextBatch(batch))
+  {
+    if (batches == 0 && !useExistingModel)
+      fitter.Initialize(batch, dists, weights);
+
+    fitter.Update(batch, dists, weights);
+    ++batches;
+  }
+
+  Log::Info << "GMM::Train(): trained on " << batches << " mini-batches."
+      << std::endl;
+  return batches;
+}
+
 /**
  * Serialize the object.
  */
@@ -207,6 +233,55 @@ void GMM::serialize(Archive& ar, const unsigned int /* version */)
   ar & BOOST_SERIALIZATION_NVP(weights);
 }
 
+/**
+ * Compute the log probability of each observation and the component it most
+ * likely came from, in parallel over blocks of columns.
+ */
+template<typename eT>
+void GMM::ScoreBlocks(const arma::Mat<eT>& observations,
+                      arma::Col<eT>* logProbabilities,
+                      arma::Row<size_t>* labels) const
+{
+  const size_t blockSize = 1024;
+  const size_t blocks = (observations.n_cols + blockSize - 1) / blockSize;
+  if (logProbabilities)
+    logProbabilities->set_size(observations.n_cols);
+  if (labels)
+    labels->set_size(observations.n_cols);
+
+  #pragma omp parallel
+  {
+    // The buffers of each thread are only reallocated for the last block.
+    arma::mat block;
+    arma::mat componentLogProbabilities;
+
+    #pragma omp for schedule(static)
+    for (omp_size_t b = 0; b < (omp_size_t) blocks; ++b)
+    {
+      const size_t begin = (size_t) b * blockSize;
+      const size_t end = std::min(begin + blockSize,
+          (size_t) observations.n_cols);
+
+      // This also converts single-precision observations.
+      block.set_size(observations.n_rows, end - begin);
+      std::copy(observations.colptr(begin),
+          observations.colptr(begin) + block.n_elem, block.memptr());
+      ComponentLogProbabilities(block, componentLogProbabilities);
+
+      for (size_t i = 0; i < block.n_cols; ++i)
+      {
+        if (logProbabilities)
+        {
+          (*logProbabilities)[begin + i] =
+              (eT) math::AccuLog(componentLogProbabilities.col(i));
+        }
+        if (labels)
+          (*labels)[begin + i] = componentLogProbabilities.col(i).index_max();
+      }
+    }
+  }
+}
+
 } // namespace gmm
 } // namespace mlpack
 
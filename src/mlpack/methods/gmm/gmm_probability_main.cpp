@@ -70,11 +70,10 @@ static void mlpackMain()
 
   arma::mat dataset = std::move(IO::GetParam<arma::mat>("input"));
 
-  // Now calculate the probabilities.
-  arma::rowvec probabilities(dataset.n_cols);
-  for (size_t i = 0; i < dataset.n_cols; ++i)
-    probabilities[i] = gmm->Probability(dataset.unsafe_col(i));
+  // Now calculate the probabilities of all the points at once.
+  arma::vec probabilities;
+  gmm->Probability(dataset, probabilities);
 
   // And save the result.
-  IO::GetParam<arma::mat>("output") = std::move(probabilities);
+  IO::GetParam<arma::mat>("output") = probabilities.t();
 }
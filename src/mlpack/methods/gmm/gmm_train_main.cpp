@@ -19,6 +19,7 @@
 #include "diagonal_constraint.hpp"
 
 #include <mlpack/methods/kmeans/refined_start.hpp>
+#include <mlpack/methods/kmeans/kmeans_parallel_initialization.hpp>
 
 using namespace mlpack;
 using namespace mlpack::gmm;
@@ -63,7 +64,11 @@ BINDING_LONG_DESC(
     PRINT_PARAM_STRING("percentage") + " parameters.  If " +
     PRINT_PARAM_STRING("refined_start") + " is specified, then the "
     "Bradley-Fayyad refined start initialization will be used.  This can often "
-    "lead to better clustering results."
+    "lead to better clustering results.  Alternately, if " +
+    PRINT_PARAM_STRING("kmeans_parallel") + " is specified, then the k-means||"
+    " initialization (\"Scalable k-means++\", 2012) will be used; it can be "
+    "controlled with the " + PRINT_PARAM_STRING("kmeans_parallel_rounds") +
+    " and " + PRINT_PARAM_STRING("oversampling") + " parameters."
     "\n\n"
     "The 'diagonal_covariance' flag will cause the learned covariances to be "
     "diagonal matrices.  This significantly simplifies the model itself and "
@@ -139,12 +144,85 @@ PARAM_INT_IN("samplings", "If using --refined_start, specify the number of "
 PARAM_DOUBLE_IN("percentage", "If using --refined_start, specify the percentage"
     " of the dataset used for each sampling (should be between 0.0 and 1.0).",
     "p", 0.02);
+PARAM_FLAG("kmeans_parallel", "During the initialization, use the k-means|| "
+    "initialization (Bahmani et al., 2012) for k-means clustering.", "");
+PARAM_INT_IN("kmeans_parallel_rounds", "If using --kmeans_parallel, specify "
+    "the number of sampling rounds.", "", 5);
+PARAM_DOUBLE_IN("oversampling", "If using --kmeans_parallel, specify the "
+    "oversampling factor (the expected number of candidates chosen in each "
+    "round is this times the number of Gaussians).", "", 2.0);
 
 // Parameters for model saving/loading.
 PARAM_MODEL_IN(GMM, "input_model", "Initial input GMM model to start training "
     "with.", "m");
 PARAM_MODEL_OUT(GMM, "output_model", "Output for trained GMM model.", "M");
 
+// Train the GMM with EM, using the given k-means object for the
+// initialization.  Depending on the value of forcePositive and
+// diagonalCovariance, we have to use different types.
+template<typename KMeansType>
+static double TrainGMM(GMM& gmm,
+                       const arma::mat& dataPoints,
+                       const KMeansType& k,
+                       const size_t maxIterations,
+                       const double tolerance,
+                       const bool forcePositive,
+                       const bool diagonalCovariance)
+{
+  double likelihood;
+  if (diagonalCovariance)
+  {
+    // Convert GMMs into DiagonalGMMs.
+    DiagonalGMM dgmm(gmm.Gaussians(), gmm.Dimensionality());
+    for (size_t i = 0; i < gmm.Gaussians(); ++i)
+    {
+      dgmm.Component(i).Mean() = gmm.Component(i).Mean();
+      dgmm.Component(i).Covariance(
+          std::move(arma::diagvec(gmm.Component(i).Covariance())));
+    }
+    dgmm.Weights() = gmm.Weights();
+
+    // Compute the parameters of the model using the EM algorithm.
+    Timer::Start("em");
+    EMFit<KMeansType, PositiveDefiniteConstraint,
+        distribution::DiagonalGaussianDistribution> em(maxIterations,
+        tolerance, k);
+
+    likelihood = dgmm.Train(dataPoints, IO::GetParam<int>("trials"), false,
+        em);
+    Timer::Stop("em");
+
+    // Convert DiagonalGMMs into GMMs.
+    for (size_t i = 0; i < gmm.Gaussians(); ++i)
+    {
+      gmm.Component(i).Mean() = dgmm.Component(i).Mean();
+      gmm.Component(i).Covariance(
+          arma::diagmat(dgmm.Component(i).Covariance()));
+    }
+    gmm.Weights() = dgmm.Weights();
+  }
+  else if (forcePositive)
+  {
+    // Compute the parameters of the model using the EM algorithm.
+    Timer::Start("em");
+    EMFit<KMeansType> em(maxIterations, tolerance, k);
+    likelihood = gmm.Train(dataPoints, IO::GetParam<int>("trials"), false,
+        em);
+    Timer::Stop("em");
+  }
+  else
+  {
+    // Compute the parameters of the model using the EM algorithm.
+    Timer::Start("em");
+    EMFit<KMeansType, NoConstraint> em(maxIterations, tolerance, k);
+    likelihood = gmm.Train(dataPoints, IO::GetParam<int>("trials"), false,
+        em);
+    Timer::Stop("em");
+  }
+
+  return likelihood;
+}
+
 static void mlpackMain()
 {
   // Check parameters and load data.
@@ -161,6 +239,7 @@ static void mlpackMain()
       "trials must be greater than 0");
 
   ReportIgnoredParam({{ "diagonal_covariance", true }}, "no_force_positive");
+  ReportIgnoredParam({{ "refined_start", true }}, "kmeans_parallel");
   RequireAtLeastOnePassed({ "output_model" }, false, "no model will be saved");
 
   RequireParamValue<double>("noise", [](double x) { return x >= 0.0; }, true,
@@ -206,8 +285,8 @@ static void mlpackMain()
   const size_t kmeansMaxIterations =
       (size_t) IO::GetParam<int>("kmeans_max_iterations");
 
-  // This gets a bit weird because we need different types depending on whether
-  // --refined_start is specified.
+  // The k-means type used for the initialization depends on whether
+  // --refined_start or --kmeans_parallel is specified.
   double likelihood;
   if (IO::HasParam("refined_start"))
   {
@@ -230,57 +309,31 @@ static void mlpackMain()
     KMeansType k(kmeansMaxIterations, metric::SquaredEuclideanDistance(),
         RefinedStart(samplings, percentage));
 
-    // Depending on the value of forcePositive and diagonalCovariance, we have
-    // to use different types.
-    if (diagonalCovariance)
-    {
-      // Convert GMMs into DiagonalGMMs.
-      DiagonalGMM dgmm(gmm->Gaussians(), gmm->Dimensionality());
-      for (size_t i = 0; i < size_t(gaussians); ++i)
-      {
-        dgmm.Component(i).Mean() = gmm->Component(i).Mean();
-        dgmm.Component(i).Covariance(
-            std::move(arma::diagvec(gmm->Component(i).Covariance())));
-      }
-      dgmm.Weights() = gmm->Weights();
-
-      // Compute the parameters of the model using the EM algorithm.
-      Timer::Start("em");
-      EMFit<KMeansType, PositiveDefiniteConstraint,
-          distribution::DiagonalGaussianDistribution> em(maxIterations,
-          tolerance, k);
-
-      likelihood = dgmm.Train(dataPoints, IO::GetParam<int>("trials"), false,
-          em);
-      Timer::Stop("em");
-
-      // Convert DiagonalGMMs into GMMs.
-      for (size_t i = 0; i < size_t(gaussians); ++i)
-      {
-        gmm->Component(i).Mean() = dgmm.Component(i).Mean();
-        gmm->Component(i).Covariance(
-            arma::diagmat(dgmm.Component(i).Covariance()));
-      }
-      gmm->Weights() = dgmm.Weights();
-    }
-    else if (forcePositive)
-    {
-      // Compute the parameters of the model using the EM algorithm.
-      Timer::Start("em");
-      EMFit<KMeansType> em(maxIterations, tolerance, k);
-      likelihood = gmm->Train(dataPoints, IO::GetParam<int>("trials"), false,
-          em);
-      Timer::Stop("em");
-    }
-    else
-    {
-      // Compute the parameters of the model using the EM algorithm.
-      Timer::Start("em");
-      EMFit<KMeansType, NoConstraint> em(maxIterations, tolerance, k);
-      likelihood = gmm->Train(dataPoints, IO::GetParam<int>("trials"), false,
-          em);
-      Timer::Stop("em");
-    }
+    likelihood = TrainGMM(*gmm, dataPoints, k, maxIterations, tolerance,
+        forcePositive, diagonalCovariance);
+  }
+  else if (IO::HasParam("kmeans_parallel"))
+  {
+    RequireParamValue<int>("kmeans_parallel_rounds", [](int x) {
+        return x > 0; }, true, "number of rounds must be positive");
+    RequireParamValue<double>("oversampling", [](double x) {
+        return x > 0.0; }, true, "oversampling factor must be positive");
+
+    // Initialize the GMM if needed.
+    if (!IO::HasParam("input_model"))
+      gmm = new GMM(size_t(gaussians), dataPoints.n_rows);
+
+    const int rounds = IO::GetParam<int>("kmeans_parallel_rounds");
+    const double oversampling = IO::GetParam<double>("oversampling");
+
+    typedef KMeans<metric::SquaredEuclideanDistance,
+        KMeansParallelInitialization> KMeansType;
+
+    KMeansType k(kmeansMaxIterations, metric::SquaredEuclideanDistance(),
+        KMeansParallelInitialization(rounds, oversampling));
+
+    likelihood = TrainGMM(*gmm, dataPoints, k, maxIterations, tolerance,
+        forcePositive, diagonalCovariance);
   }
   else
   {
@@ -288,58 +341,8 @@ static void mlpackMain()
     if (!IO::HasParam("input_model"))
       gmm = new GMM(size_t(gaussians), dataPoints.n_rows);
 
-    // Depending on the value of forcePositive and diagonalCovariance, we have
-    // to use different types.
-    if (diagonalCovariance)
-    {
-      // Convert GMMs into DiagonalGMMs.
-      DiagonalGMM dgmm(gmm->Gaussians(), gmm->Dimensionality());
-      for (size_t i = 0; i < size_t(gaussians); ++i)
-      {
-        dgmm.Component(i).Mean() = gmm->Component(i).Mean();
-        dgmm.Component(i).Covariance(
-            std::move(arma::diagvec(gmm->Component(i).Covariance())));
-      }
-      dgmm.Weights() = gmm->Weights();
-
-      // Compute the parameters of the model using the EM algorithm.
-      Timer::Start("em");
-      EMFit<KMeans<>, PositiveDefiniteConstraint,
-          distribution::DiagonalGaussianDistribution> em(maxIterations,
-          tolerance, KMeans<>(kmeansMaxIterations));
-
-      likelihood = dgmm.Train(dataPoints, IO::GetParam<int>("trials"), false,
-          em);
-      Timer::Stop("em");
-
-      // Convert DiagonalGMMs into GMMs.
-      for (size_t i = 0; i < size_t(gaussians); ++i)
-      {
-        gmm->Component(i).Mean() = dgmm.Component(i).Mean();
-        gmm->Component(i).Covariance(
-            arma::diagmat(dgmm.Component(i).Covariance()));
-      }
-      gmm->Weights() = dgmm.Weights();
-    }
-    else if (forcePositive)
-    {
-      // Compute the parameters of the model using the EM algorithm.
-      Timer::Start("em");
-      EMFit<> em(maxIterations, tolerance, KMeans<>(kmeansMaxIterations));
-      likelihood = gmm->Train(dataPoints, IO::GetParam<int>("trials"), false,
-          em);
-      Timer::Stop("em");
-    }
-    else
-    {
-      // Compute the parameters of the model using the EM algorithm.
-      Timer::Start("em");
-      KMeans<> k(kmeansMaxIterations);
-      EMFit<KMeans<>, NoConstraint> em(maxIterations, tolerance, k);
-      likelihood = gmm->Train(dataPoints, IO::GetParam<int>("trials"), false,
-          em);
-      Timer::Stop("em");
-    }
+    likelihood = TrainGMM(*gmm, dataPoints, KMeans<>(kmeansMaxIterations),
+        maxIterations, tolerance, forcePositive, diagonalCovariance);
   }
 
   Log::Info << "Log-likelihood of estimate: " << likelihood << "." << endl;
@@ -0,0 +1,253 @@
+/**
+ * @file methods/gmm/online_em_fit.hpp
+ *
+ * Utility class to fit a GMM with stepwise (online) EM, which processes the
+ * observations in mini-batches.  Used by GMM::Train() and DiagonalGMM::Train().
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_GMM_ONLINE_EM_FIT_HPP
+#define MLPACK_METHODS_GMM_ONLINE_EM_FIT_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "em_fit.hpp"
+
+namespace mlpack {
+namespace gmm {
+
+/**
+ * This class fits a GMM to observations with the stepwise EM algorithm of
+ * Cappé and Moulines.  Instead of running full passes of EM over all the
+ * observations, it keeps running averages of the sufficient statistics of the
+ * model (the weight, the weighted sum and the weighted sum of squares of the
+ * observations for each Gaussian).  For each mini-batch, the conditional
+ * probabilities of the Gaussians given the observations are computed with the
+ * current model (the E-step), the statistics are moved towards the statistics
+ * of the mini-batch with a step size of (t + 1)^(-stepExponent) for the t'th
+ * mini-batch, and the model is recomputed from the statistics (the M-step).
+ *
+ * @code
+ * @article{cappe2009online,
+ *   title={On-line expectation-maximization algorithm for latent data models},
+ *   author={Capp{\'e}, Olivier and Moulines, Eric},
+ *   journal={Journal of the Royal Statistical Society: Series B (Statistical
+ *       Methodology)},
+ *   volume={71},
+ *   number={3},
+ *   pages={593--613},
+ *   year={2009}
+ * }
+ * @endcode
+ *
+ * The class can be used as the FittingType of GMM::Train() and
+ * DiagonalGMM::Train() with a dataset held in memory; Estimate() then makes
+ * the given number of passes over the shuffled observations.  It can also be
+ * given mini-batches one at a time with Update(), for instance through the
+ * overloads of GMM::Train() and DiagonalGMM::Train() that take a batch
+ * source.  The statistics are kept between the calls to Update(), so the
+ * model can be refreshed from a stream of observations; they are initialized
+ * from the current model on the first call, so training can be warm-started
+ * from an existing model.
+ *
+ * @tparam InitialClusteringType Clustering used to create the initial model.
+ * @tparam CovarianceConstraintPolicy Constraint applied to the covariances.
+ * @tparam Distribution Type of the components of the mixture.
+ */
+template<typename InitialClusteringType = kmeans::KMeans<>,
+         typename CovarianceConstraintPolicy = PositiveDefiniteConstraint,
+         typename Distribution = distribution::GaussianDistribution>
+class OnlineEMFit
+{
+ public:
+  /**
+   * Construct the OnlineEMFit object.  The step exponent must be in
+   * (0.5, 1.0] for the algorithm to converge; smaller values forget old
+   * mini-batches faster.
+   *
+   * @param batchSize Number of observations in each mini-batch of Estimate().
+   * @param passes Number of passes over the observations made by Estimate().
+   * @param stepExponent Exponent of the decay of the step size.
+   * @param clusterer Object which will perform the initial clustering.
+   * @param constraint Constraint policy of covariance.
+   */
+  OnlineEMFit(const size_t batchSize = 1000,
+              const size_t passes = 1,
+              const double stepExponent = 0.6,
+              InitialClusteringType clusterer = InitialClusteringType(),
+              CovarianceConstraintPolicy constraint =
+                  CovarianceConstraintPolicy());
+
+  /**
+   * Fit the observations to a Gaussian mixture model with stepwise EM over
+   * mini-batches of the observations.  The size of the vectors (indicating the
+   * number of components) must already be set.  If useInitialModel is false,
+   * the initial model is obtained by clustering the observations; otherwise,
+   * the given model is used.  In both cases the statistics are reset first.
+   *
+   * @param observations List of observations to train on.
+   * @param dists Distributions to store model in.
+   * @param weights Vector to store a priori weights in.
+   * @param useInitialModel If true, the given model is used as the initial
+   *     model.
+   */
+  void Estimate(const arma::mat& observations,
+                std::vector<Distribution>& dists,
+                arma::vec& weights,
+                const bool useInitialModel = false);
+
+  /**
+   * Fit the observations to a Gaussian mixture model with stepwise EM over
+   * mini-batches of the observations, taking into account the probabilities
+   * of each point being from this mixture.
+   *
+   * @param observations List of observations to train on.
+   * @param probabilities Probability of each point being from this model.
+   * @param dists Distributions to store model in.
+   * @param weights Vector to store a priori weights in.
+   * @param useInitialModel If true, the given model is used as the initial
+   *     model.
+   */
+  void Estimate(const arma::mat& observations,
+                const arma::vec& probabilities,
+                std::vector<Distribution>& dists,
+                arma::vec& weights,
+                const bool useInitialModel = false);
+
+  /**
+   * Create an initial model by clustering the given observations, and reset
+   * the statistics.
+   *
+   * @param observations Observations to cluster.
+   * @param dists Distributions to store model in.
+   * @param weights Vector to store a priori weights in.
+   */
+  void Initialize(const arma::mat& observations,
+                  std::vector<Distribution>& dists,
+                  arma::vec& weights);
+
+  /**
+   * Update the model with one mini-batch of observations.  If no mini-batch
+   * has been seen since the statistics were reset, they are first initialized
+   * from the given model.
+   *
+   * @param batch Mini-batch of observations.
+   * @param dists Distributions of the model to update.
+   * @param weights A priori weights of the model to update.
+   */
+  void Update(const arma::mat& batch,
+              std::vector<Distribution>& dists,
+              arma::vec& weights);
+
+  /**
+   * Update the model with one mini-batch of observations, taking into account
+   * the probability of each observation being from this mixture.
+   *
+   * @param batch Mini-batch of observations.
+   * @param probabilities Probability of each observation being from this
+   *     model.
+   * @param dists Distributions of the model to update.
+   * @param weights A priori weights of the model to update.
+   */
+  void Update(const arma::mat& batch,
+              const arma::vec& probabilities,
+              std::vector<Distribution>& dists,
+              arma::vec& weights);
+
+  //! Reset the statistics, so that the next update starts from the model it is
+  //! given.
+  void Reset() { steps = 0; }
+
+  //! Get the number of mini-batches seen since the statistics were reset.
+  size_t Steps() const { return steps; }
+
+  //! Get the number of observations in each mini-batch of Estimate().
+  size_t BatchSize() const { return batchSize; }
+  //! Modify the number of observations in each mini-batch of Estimate().
+  size_t& BatchSize() { return batchSize; }
+
+  //! Get the number of passes over the observations made by Estimate().
+  size_t Passes() const { return passes; }
+  //! Modify the number of passes over the observations made by Estimate().
+  size_t& Passes() { return passes; }
+
+  //! Get the exponent of the decay of the step size.
+  double StepExponent() const { return stepExponent; }
+  //! Modify the exponent of the decay of the step size.
+  double& StepExponent() { return stepExponent; }
+
+  //! Get the clusterer.
+  const InitialClusteringType& Clusterer() const { return clusterer; }
+  //! Modify the clusterer.
+  InitialClusteringType& Clusterer() { return clusterer; }
+
+  //! Get the covariance constraint policy class.
+  const CovarianceConstraintPolicy& Constraint() const { return constraint; }
+  //! Modify the covariance constraint policy class.
+  CovarianceConstraintPolicy& Constraint() { return constraint; }
+
+  //! Serialize the fitter.
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int version);
+
+ private:
+  //! DiagonalGaussianDistribution only has the diagonal of its covariance.
+  static const bool isDiagGaussDist = std::is_same<Distribution,
+      distribution::DiagonalGaussianDistribution>::value;
+
+  //! The type of the covariances and of the sums of squares.
+  typedef typename std::conditional<isDiagGaussDist, arma::vec,
+      arma::mat>::type CovarianceType;
+
+  //! Initialize the statistics from the given model.
+  void StatisticsFromModel(const std::vector<Distribution>& dists,
+                           const arma::vec& weights);
+
+  /**
+   * Run one step of stepwise EM on the given mini-batch; each observation is
+   * weighted by the corresponding element of observationWeights.
+   */
+  void Step(const arma::mat& batch,
+            const arma::vec& observationWeights,
+            std::vector<Distribution>& dists,
+            arma::vec& weights);
+
+  //! Run Estimate() on mini-batches given by a random order of the
+  //! observations.
+  void EstimatePasses(const arma::mat& observations,
+                      const arma::vec& probabilities,
+                      std::vector<Distribution>& dists,
+                      arma::vec& weights,
+                      const bool useInitialModel);
+
+  //! The number of observations in each mini-batch of Estimate().
+  size_t batchSize;
+  //! The number of passes over the observations made by Estimate().
+  size_t passes;
+  //! The exponent of the decay of the step size.
+  double stepExponent;
+  //! Object which will perform the clustering.
+  InitialClusteringType clusterer;
+  //! Object which applies constraints to the covariance matrix.
+  CovarianceConstraintPolicy constraint;
+
+  //! The number of mini-batches seen since the statistics were reset.
+  size_t steps;
+  //! Average weight of each Gaussian.
+  arma::vec weightSums;
+  //! Average weighted sum of the observations, one column per Gaussian.
+  arma::mat sums;
+  //! Average weighted sum of the squares (or outer products) of the
+  //! observations, for each Gaussian.
+  std::vector<CovarianceType> squareSums;
+};
+
+} // namespace gmm
+} // namespace mlpack
+
+// Include implementation.
+#include "online_em_fit_impl.hpp"
+
+#endif
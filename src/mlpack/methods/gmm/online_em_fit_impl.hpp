@@ -0,0 +1,275 @@
+/**
+ * @file methods/gmm/online_em_fit_impl.hpp
+ *
+ * Implementation of the stepwise EM algorithm for fitting GMMs.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_GMM_ONLINE_EM_FIT_IMPL_HPP
+#define MLPACK_METHODS_GMM_ONLINE_EM_FIT_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "online_em_fit.hpp"
+#include <mlpack/core/math/log_add.hpp>
+
+namespace mlpack {
+namespace gmm {
+
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+OnlineEMFit<InitialClusteringType, CovarianceConstraintPolicy, Distribution>::
+OnlineEMFit(const size_t batchSize,
+            const size_t passes,
+            const double stepExponent,
+            InitialClusteringType clusterer,
+            CovarianceConstraintPolicy constraint) :
+    batchSize(batchSize),
+    passes(passes),
+    stepExponent(stepExponent),
+    clusterer(clusterer),
+    constraint(constraint),
+    steps(0)
+{
+  if (batchSize == 0)
+  {
+    throw std::invalid_argument("OnlineEMFit::OnlineEMFit(): batch size must "
+        "be positive");
+  }
+
+  if (stepExponent <= 0.5 || stepExponent > 1.0)
+  {
+    throw std::invalid_argument("OnlineEMFit::OnlineEMFit(): step exponent "
+        "must be greater than 0.5 and at most 1.0");
+  }
+}
+
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+void OnlineEMFit<InitialClusteringType, CovarianceConstraintPolicy,
+    Distribution>::Estimate(const arma::mat& observations,
+                            std::vector<Distribution>& dists,
+                            arma::vec& weights,
+                            const bool useInitialModel)
+{
+  EstimatePasses(observations, arma::ones<arma::vec>(observations.n_cols),
+      dists, weights, useInitialModel);
+}
+
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+void OnlineEMFit<InitialClusteringType, CovarianceConstraintPolicy,
+    Distribution>::Estimate(const arma::mat& observations,
+                            const arma::vec& probabilities,
+                            std::vector<Distribution>& dists,
+                            arma::vec& weights,
+                            const bool useInitialModel)
+{
+  EstimatePasses(observations, probabilities, dists, weights,
+      useInitialModel);
+}
+
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+void OnlineEMFit<InitialClusteringType, CovarianceConstraintPolicy,
+    Distribution>::Initialize(const arma::mat& observations,
+                              std::vector<Distribution>& dists,
+                              arma::vec& weights)
+{
+  // The initial model is created exactly as EMFit creates it.
+  EMFit<InitialClusteringType, CovarianceConstraintPolicy, Distribution>
+      fitter(1, 1e-10, clusterer, constraint);
+  fitter.InitialClustering(observations, dists, weights);
+
+  Reset();
+}
+
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+void OnlineEMFit<InitialClusteringType, CovarianceConstraintPolicy,
+    Distribution>::Update(const arma::mat& batch,
+                          std::vector<Distribution>& dists,
+                          arma::vec& weights)
+{
+  Step(batch, arma::ones<arma::vec>(batch.n_cols), dists, weights);
+}
+
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+void OnlineEMFit<InitialClusteringType, CovarianceConstraintPolicy,
+    Distribution>::Update(const arma::mat& batch,
+                          const arma::vec& probabilities,
+                          std::vector<Distribution>& dists,
+                          arma::vec& weights)
+{
+  Step(batch, probabilities, dists, weights);
+}
+
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+template<typename Archive>
+void OnlineEMFit<InitialClusteringType, CovarianceConstraintPolicy,
+    Distribution>::serialize(Archive& ar, const unsigned int /* version */)
+{
+  ar & BOOST_SERIALIZATION_NVP(batchSize);
+  ar & BOOST_SERIALIZATION_NVP(passes);
+  ar & BOOST_SERIALIZATION_NVP(stepExponent);
+  ar & BOOST_SERIALIZATION_NVP(clusterer);
+  ar & BOOST_SERIALIZATION_NVP(constraint);
+
+  // The statistics are not saved; they will be initialized from the model
+  // given to the next update.
+  if (Archive::is_loading::value)
+    steps = 0;
+}
+
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+void OnlineEMFit<InitialClusteringType, CovarianceConstraintPolicy,
+    Distribution>::StatisticsFromModel(const std::vector<Distribution>& dists,
+                                       const arma::vec& weights)
+{
+  weightSums = weights;
+  sums.set_size(dists[0].Mean().n_elem, dists.size());
+  squareSums.resize(dists.size());
+  for (size_t i = 0; i < dists.size(); ++i)
+  {
+    const arma::vec& mean = dists[i].Mean();
+    sums.col(i) = weights[i] * mean;
+    if (isDiagGaussDist)
+      squareSums[i] = weights[i] * (dists[i].Covariance() + mean % mean);
+    else
+      squareSums[i] = weights[i] * (dists[i].Covariance() + mean * mean.t());
+  }
+}
+
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+void OnlineEMFit<InitialClusteringType, CovarianceConstraintPolicy,
+    Distribution>::Step(const arma::mat& batch,
+                        const arma::vec& observationWeights,
+                        std::vector<Distribution>& dists,
+                        arma::vec& weights)
+{
+  if (steps == 0)
+    StatisticsFromModel(dists, weights);
+
+  // There is nothing to learn from an empty (or weightless) mini-batch.
+  const double totalWeight = arma::accu(observationWeights);
+  if (batch.n_cols == 0 || totalWeight <= 0.0)
+    return;
+
+  ++steps;
+  const double stepSize = std::pow(steps + 1.0, -stepExponent);
+
+  // Calculate the conditional probabilities of choosing a particular Gaussian
+  // given the observations and the present model.
+  arma::mat condLogProb(dists.size(), batch.n_cols);
+  arma::vec logPhis;
+  for (size_t i = 0; i < dists.size(); ++i)
+  {
+    dists[i].LogProbability(batch, logPhis);
+    condLogProb.row(i) = log(weights[i]) + logPhis.t();
+  }
+
+  for (size_t j = 0; j < batch.n_cols; ++j)
+  {
+    // An observation with no probability under any Gaussian is ignored.
+    const double probSum = mlpack::math::AccuLog(condLogProb.col(j));
+    if (probSum != -std::numeric_limits<double>::infinity())
+      condLogProb.col(j) -= probSum;
+  }
+
+  arma::mat responsibilities = arma::exp(condLogProb);
+  responsibilities.each_row() %= observationWeights.t() / totalWeight;
+
+  // Move the statistics towards the statistics of the mini-batch.
+  weightSums = (1.0 - stepSize) * weightSums +
+      stepSize * arma::sum(responsibilities, 1);
+  sums = (1.0 - stepSize) * sums + stepSize * (batch * responsibilities.t());
+  for (size_t i = 0; i < dists.size(); ++i)
+  {
+    squareSums[i] *= (1.0 - stepSize);
+    if (isDiagGaussDist)
+    {
+      squareSums[i] += stepSize * ((batch % batch) *
+          responsibilities.row(i).t());
+    }
+    else
+    {
+      arma::mat scaled = batch.each_row() %
+          arma::sqrt(responsibilities.row(i));
+      squareSums[i] += stepSize * (scaled * scaled.t());
+    }
+  }
+
+  // Now recompute the model from the statistics.
+  weights = weightSums / arma::accu(weightSums);
+  for (size_t i = 0; i < dists.size(); ++i)
+  {
+    // Don't update if there's no probability of the Gaussian having points.
+    if (weightSums[i] <= 0.0)
+      continue;
+
+    arma::vec mean = sums.col(i) / weightSums[i];
+    CovarianceType covariance = squareSums[i] / weightSums[i];
+    if (isDiagGaussDist)
+      covariance -= mean % mean;
+    else
+      covariance -= mean * mean.t();
+
+    // Apply covariance constraint.
+    constraint.ApplyConstraint(covariance);
+    dists[i].Mean() = std::move(mean);
+    dists[i].Covariance(std::move(covariance));
+  }
+}
+
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+void OnlineEMFit<InitialClusteringType, CovarianceConstraintPolicy,
+    Distribution>::EstimatePasses(const arma::mat& observations,
+                                  const arma::vec& probabilities,
+                                  std::vector<Distribution>& dists,
+                                  arma::vec& weights,
+                                  const bool useInitialModel)
+{
+  if (!useInitialModel)
+    Initialize(observations, dists, weights);
+  else
+    Reset();
+
+  for (size_t pass = 0; pass < passes; ++pass)
+  {
+    // Visit the mini-batches in a different random order in each pass.
+    const arma::uvec order = arma::randperm(observations.n_cols);
+    for (size_t begin = 0; begin < observations.n_cols; begin += batchSize)
+    {
+      const size_t end = std::min(begin + batchSize, (size_t)
+          observations.n_cols) - 1;
+      const arma::uvec indices = order.subvec(begin, end);
+      Step(observations.cols(indices), probabilities.elem(indices), dists,
+          weights);
+    }
+
+    Log::Info << "OnlineEMFit::Estimate(): pass " << pass << " done after "
+        << steps << " mini-batches." << std::endl;
+  }
+}
+
+} // namespace gmm
+} // namespace mlpack
+
+#endif
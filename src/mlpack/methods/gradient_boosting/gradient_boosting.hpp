@@ -0,0 +1,274 @@
+/**
+ * @file methods/gradient_boosting/gradient_boosting.hpp
+ *
+ * Definition of the GradientBoosting class, a classifier made of
+ * gradient-boosted regression trees.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_GRADIENT_BOOSTING_GRADIENT_BOOSTING_HPP
+#define MLPACK_METHODS_GRADIENT_BOOSTING_GRADIENT_BOOSTING_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/methods/decision_tree/all_dimension_select.hpp>
+#include <mlpack/methods/decision_tree/gini_gain.hpp>
+#include <mlpack/methods/decision_tree/histogram_numeric_split.hpp>
+#include "gradient_boosting_tree.hpp"
+
+namespace mlpack {
+namespace tree /** Trees and tree-building procedures. */ {
+
+/**
+ * GradientBoosting is a classifier made of regression trees that are fit, one
+ * boosting iteration after the other, to the gradient of the log-loss of the
+ * current model, with second-order (Newton) steps:
+ *
+ *  - The scores of a point are the initial scores (the log-odds of the class
+ *    priors) plus the values of the leaves it falls into.  Two-class problems
+ *    use one score (and one tree per iteration) through the logistic function;
+ *    other problems use one score per class through the softmax function.
+ *  - Each iteration computes the gradients and the hessians of the loss of
+ *    every point, stored in contiguous arrays, and grows one tree per score
+ *    leaf by leaf: the leaf whose best split has the largest gain
+ *    G_L^2 / (H_L + lambda) + G_R^2 / (H_R + lambda) - G^2 / (H + lambda) is
+ *    split next, until the tree has the maximum number of leaves or no split
+ *    has a positive gain.  The value of a leaf is -G / (H + lambda), times
+ *    the learning rate.
+ *  - As with HistogramNumericSplit (whose bins are used), the dimensions are
+ *    binned once before training, and splits are only searched between bins.
+ *    The histogram of the gradients and hessians of a node is built for its
+ *    smaller child only, and derived for the other child by subtraction.  The
+ *    histograms are built and searched in parallel over the dimensions.
+ *  - The dimensions searched at each split are chosen by the
+ *    DimensionSelectionType policy, as for DecisionTree and RandomForest (for
+ *    instance, MultipleRandomDimensionSelect subsamples the dimensions).
+ *
+ * For more information, see the following papers:
+ *
+ * @code
+ * @article{friedman2001greedy,
+ *   title={Greedy function approximation: a gradient boosting machine},
+ *   author={Friedman, Jerome H.},
+ *   journal={Annals of Statistics},
+ *   pages={1189--1232},
+ *   year={2001}
+ * }
+ *
+ * @inproceedings{ke2017lightgbm,
+ *   title={LightGBM: A highly efficient gradient boosting decision tree},
+ *   author={Ke, Guolin and Meng, Qi and Finley, Thomas and Wang, Taifeng and
+ *       Chen, Wei and Ma, Weidong and Ye, Qiwei and Liu, Tie-Yan},
+ *   booktitle={Advances in Neural Information Processing Systems},
+ *   pages={3146--3154},
+ *   year={2017}
+ * }
+ * @endcode
+ *
+ * @tparam DimensionSelectionType Policy choosing the dimensions to split on.
+ * @tparam ElemType Type of the values of the points.
+ */
+template<typename DimensionSelectionType = AllDimensionSelect,
+         typename ElemType = double>
+class GradientBoosting
+{
+ public:
+  //! The type of the trees.
+  typedef GradientBoostingTree<ElemType> TreeType;
+
+  /**
+   * Construct the model without training it.  Classify() will throw an
+   * exception until Train() is called.
+   */
+  GradientBoosting() : numClasses(0) { }
+
+  /**
+   * Train the model on the given labeled data.
+   *
+   * @param data Dataset to train on.
+   * @param labels Labels of the points (in [0, numClasses)).
+   * @param numClasses Number of classes (at least 2).
+   * @param numIterations Number of boosting iterations.
+   * @param learningRate Factor applied to the values of the leaves.
+   * @param maximumLeaves Maximum number of leaves of each tree.
+   * @param minimumLeafSize Minimum number of points in each leaf.
+   * @param lambda L2 regularization of the values of the leaves.
+   * @param dimensionSelector Instantiated dimension selection policy.
+   */
+  template<typename MatType>
+  GradientBoosting(const MatType& data,
+                   const arma::Row<size_t>& labels,
+                   const size_t numClasses,
+                   const size_t numIterations = 100,
+                   const double learningRate = 0.1,
+                   const size_t maximumLeaves = 31,
+                   const size_t minimumLeafSize = 20,
+                   const double lambda = 1.0,
+                   DimensionSelectionType dimensionSelector =
+                       DimensionSelectionType());
+
+  /**
+   * Train the model on the given labeled data, replacing any previous model,
+   * and return the mean log-loss of the trained model on the data.
+   *
+   * @param data Dataset to train on.
+   * @param labels Labels of the points (in [0, numClasses)).
+   * @param numClasses Number of classes (at least 2).
+   * @param numIterations Number of boosting iterations.
+   * @param learningRate Factor applied to the values of the leaves.
+   * @param maximumLeaves Maximum number of leaves of each tree.
+   * @param minimumLeafSize Minimum number of points in each leaf.
+   * @param lambda L2 regularization of the values of the leaves.
+   * @param dimensionSelector Instantiated dimension selection policy.
+   */
+  template<typename MatType>
+  double Train(const MatType& data,
+               const arma::Row<size_t>& labels,
+               const size_t numClasses,
+               const size_t numIterations = 100,
+               const double learningRate = 0.1,
+               const size_t maximumLeaves = 31,
+               const size_t minimumLeafSize = 20,
+               const double lambda = 1.0,
+               DimensionSelectionType dimensionSelector =
+                   DimensionSelectionType());
+
+  /**
+   * Predict the class of the given point.
+   *
+   * @param point Point to classify.
+   */
+  template<typename VecType>
+  size_t Classify(const VecType& point) const;
+
+  /**
+   * Predict the class of the given point and the probabilities of each class.
+   *
+   * @param point Point to classify.
+   * @param prediction Predicted class of the point.
+   * @param probabilities Probabilities of each class.
+   */
+  template<typename VecType>
+  void Classify(const VecType& point,
+                size_t& prediction,
+                arma::vec& probabilities) const;
+
+  /**
+   * Predict the classes of the given points.
+   *
+   * @param data Points to classify.
+   * @param predictions Predicted class of each point.
+   */
+  template<typename MatType>
+  void Classify(const MatType& data,
+                arma::Row<size_t>& predictions) const;
+
+  /**
+   * Predict the classes of the given points and the probabilities of each
+   * class.
+   *
+   * @param data Points to classify.
+   * @param predictions Predicted class of each point.
+   * @param probabilities Probabilities of each class (one column per point).
+   */
+  template<typename MatType>
+  void Classify(const MatType& data,
+                arma::Row<size_t>& predictions,
+                arma::mat& probabilities) const;
+
+  //! Get the number of classes.
+  size_t NumClasses() const { return numClasses; }
+  //! Get the number of trees (per iteration, one for two classes and one per
+  //! class otherwise).
+  size_t NumTrees() const { return trees.size(); }
+  //! Get a tree.
+  const TreeType& Tree(const size_t i) const { return trees[i]; }
+  //! Get the initial scores.
+  const arma::vec& InitialScores() const { return initialScores; }
+
+  //! Serialize the model.
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */);
+
+ private:
+  //! The histogram, sums and best split of a leaf being grown.
+  struct GrowingLeaf
+  {
+    //! The node of the tree.
+    size_t node;
+    //! The points of the leaf are order[begin, end).
+    size_t begin;
+    size_t end;
+    //! The sum of the gradients and of the hessians of the points.
+    double gradientSum;
+    double hessianSum;
+    //! The gradient sum, hessian sum and count of each bin of each dimension.
+    arma::mat histogram;
+    //! The gain of the best split (0 if there is none).
+    double gain;
+    //! The dimension and the last bin on the left of the best split.
+    size_t dimension;
+    size_t bin;
+  };
+
+  //! Return the number of scores of a point.
+  size_t NumScores() const { return (numClasses == 2) ? 1 : numClasses; }
+
+  //! Compute the scores of the given point.
+  template<typename VecType>
+  void Scores(const VecType& point, arma::vec& scores) const;
+
+  //! Turn the scores of a point into class probabilities.
+  void Probabilities(const arma::vec& scores, arma::vec& probabilities) const;
+
+  /**
+   * Grow the given tree on the given gradients and hessians, and add its
+   * values to the given scores (the score of point i is scores[i * stride]).
+   */
+  void GrowTree(TreeType& tree,
+                const arma::Mat<unsigned char>& bins,
+                const std::vector<arma::Col<ElemType>>& boundaries,
+                const arma::uvec& binOffsets,
+                const double* gradients,
+                const double* hessians,
+                const double learningRate,
+                const size_t maximumLeaves,
+                const size_t minimumLeafSize,
+                const double lambda,
+                DimensionSelectionType& dimensionSelector,
+                double* scores,
+                const size_t stride,
+                std::vector<size_t>& order) const;
+
+  //! Build the histogram of the given leaf.
+  void BuildHistogram(const arma::Mat<unsigned char>& bins,
+                      const arma::uvec& binOffsets,
+                      const double* gradients,
+                      const double* hessians,
+                      const std::vector<size_t>& order,
+                      GrowingLeaf& leaf) const;
+
+  //! Find the best split of the given leaf.
+  void FindSplit(const arma::uvec& binOffsets,
+                 const size_t minimumLeafSize,
+                 const double lambda,
+                 DimensionSelectionType& dimensionSelector,
+                 GrowingLeaf& leaf) const;
+
+  //! The number of classes.
+  size_t numClasses;
+  //! The initial scores.
+  arma::vec initialScores;
+  //! The trees, iteration by iteration: tree i adds to score i % NumScores().
+  std::vector<TreeType> trees;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+// Include implementation.
+#include "gradient_boosting_impl.hpp"
+
+#endif
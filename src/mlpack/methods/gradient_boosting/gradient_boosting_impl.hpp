@@ -0,0 +1,473 @@
+/**
+ * @file methods/gradient_boosting/gradient_boosting_impl.hpp
+ *
+ * Implementation of the GradientBoosting class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_GRADIENT_BOOSTING_GRADIENT_BOOSTING_IMPL_HPP
+#define MLPACK_METHODS_GRADIENT_BOOSTING_GRADIENT_BOOSTING_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "gradient_boosting.hpp"
+
+namespace mlpack {
+namespace tree {
+
+template<typename DimensionSelectionType, typename ElemType>
+template<typename MatType>
+GradientBoosting<DimensionSelectionType, ElemType>::GradientBoosting(
+    const MatType& data,
+    const arma::Row<size_t>& labels,
+    const size_t numClasses,
+    const size_t numIterations,
+    const double learningRate,
+    const size_t maximumLeaves,
+    const size_t minimumLeafSize,
+    const double lambda,
+    DimensionSelectionType dimensionSelector) :
+    numClasses(0)
+{
+  Train(data, labels, numClasses, numIterations, learningRate, maximumLeaves,
+      minimumLeafSize, lambda, dimensionSelector);
+}
+
+template<typename DimensionSelectionType, typename ElemType>
+template<typename MatType>
+double GradientBoosting<DimensionSelectionType, ElemType>::Train(
+    const MatType& data,
+    const arma::Row<size_t>& labels,
+    const size_t numClasses,
+    const size_t numIterations,
+    const double learningRate,
+    const size_t maximumLeaves,
+    const size_t minimumLeafSize,
+    const double lambda,
+    DimensionSelectionType dimensionSelector)
+{
+  if (data.n_cols == 0 || data.n_cols != labels.n_elem)
+  {
+    throw std::invalid_argument("GradientBoosting::Train(): the dataset must "
+        "be non-empty and have one label per point!");
+  }
+  if (numClasses < 2)
+  {
+    throw std::invalid_argument("GradientBoosting::Train(): there must be at "
+        "least two classes!");
+  }
+  if (arma::max(labels) >= numClasses)
+  {
+    throw std::invalid_argument("GradientBoosting::Train(): labels must be "
+        "less than the number of classes!");
+  }
+  if (maximumLeaves == 0 || lambda < 0.0)
+  {
+    throw std::invalid_argument("GradientBoosting::Train(): maximumLeaves "
+        "must be positive and lambda must not be negative!");
+  }
+
+  const size_t n = data.n_cols;
+  const size_t d = data.n_rows;
+  this->numClasses = numClasses;
+  const size_t numScores = NumScores();
+  trees.clear();
+
+  // Start from the (smoothed) log-odds or log-priors of the classes.
+  arma::vec priors(numClasses, arma::fill::ones);
+  for (size_t i = 0; i < n; ++i)
+    ++priors[labels[i]];
+  priors /= (n + numClasses);
+  if (numClasses == 2)
+    initialScores = arma::vec(1).fill(std::log(priors[1] / priors[0]));
+  else
+    initialScores = arma::log(priors);
+
+  // Bin every dimension once.  The bins of a dimension are contiguous, and a
+  // value falls in the first bin whose boundary it does not exceed.
+  std::vector<arma::Col<ElemType>> boundaries(d);
+  arma::Mat<unsigned char> bins(n, d);
+  #pragma omp parallel for
+  for (omp_size_t j = 0; j < (omp_size_t) d; ++j)
+  {
+    const arma::Col<ElemType> values = arma::trans(data.row(j));
+    HistogramNumericSplit<GiniGain>::BinBoundaries(values, values.min(),
+        values.max(), boundaries[j]);
+
+    const ElemType* first = boundaries[j].memptr();
+    const ElemType* last = first + boundaries[j].n_elem;
+    for (size_t i = 0; i < n; ++i)
+      bins(i, j) = (unsigned char) (std::lower_bound(first, last, values[i]) -
+          first);
+  }
+
+  // The histogram of dimension j starts at column binOffsets[j].
+  arma::uvec binOffsets(d + 1);
+  binOffsets[0] = 0;
+  for (size_t j = 0; j < d; ++j)
+    binOffsets[j + 1] = binOffsets[j] + boundaries[j].n_elem + 1;
+
+  dimensionSelector.Dimensions() = d;
+
+  arma::mat scores = arma::repmat(initialScores, 1, n);
+  arma::mat gradients(n, numScores);
+  arma::mat hessians(n, numScores);
+  std::vector<size_t> order(n);
+  for (size_t t = 0; t < numIterations; ++t)
+  {
+    // Compute the gradients and hessians of the log-loss.
+    #pragma omp parallel for
+    for (omp_size_t i = 0; i < (omp_size_t) n; ++i)
+    {
+      const arma::vec pointScores = scores.col(i);
+      arma::vec probabilities;
+      Probabilities(pointScores, probabilities);
+      for (size_t k = 0; k < numScores; ++k)
+      {
+        // With one score, it is the score of the second class.
+        const size_t c = (numScores == 1) ? 1 : k;
+        const double p = probabilities[c];
+        gradients(i, k) = p - ((labels[i] == c) ? 1.0 : 0.0);
+        hessians(i, k) = std::max(p * (1.0 - p), 1e-16);
+      }
+    }
+
+    for (size_t k = 0; k < numScores; ++k)
+    {
+      trees.push_back(TreeType());
+      GrowTree(trees.back(), bins, boundaries, binOffsets,
+          gradients.colptr(k), hessians.colptr(k), learningRate, maximumLeaves,
+          minimumLeafSize, lambda, dimensionSelector, scores.memptr() + k,
+          numScores, order);
+    }
+  }
+
+  // Compute the log-loss of the trained model.
+  double loss = 0.0;
+  #pragma omp parallel for reduction( + : loss)
+  for (omp_size_t i = 0; i < (omp_size_t) n; ++i)
+  {
+    const arma::vec pointScores = scores.col(i);
+    arma::vec probabilities;
+    Probabilities(pointScores, probabilities);
+    loss -= std::log(std::max(probabilities[labels[i]], 1e-16));
+  }
+
+  return loss / n;
+}
+
+template<typename DimensionSelectionType, typename ElemType>
+template<typename VecType>
+size_t GradientBoosting<DimensionSelectionType, ElemType>::Classify(
+    const VecType& point) const
+{
+  // Pass off to another Classify() overload.
+  size_t prediction;
+  arma::vec probabilities;
+  Classify(point, prediction, probabilities);
+
+  return prediction;
+}
+
+template<typename DimensionSelectionType, typename ElemType>
+template<typename VecType>
+void GradientBoosting<DimensionSelectionType, ElemType>::Classify(
+    const VecType& point,
+    size_t& prediction,
+    arma::vec& probabilities) const
+{
+  if (numClasses == 0)
+  {
+    throw std::invalid_argument("GradientBoosting::Classify(): no model "
+        "trained!");
+  }
+
+  arma::vec scores;
+  Scores(point, scores);
+  Probabilities(scores, probabilities);
+  prediction = probabilities.index_max();
+}
+
+template<typename DimensionSelectionType, typename ElemType>
+template<typename MatType>
+void GradientBoosting<DimensionSelectionType, ElemType>::Classify(
+    const MatType& data,
+    arma::Row<size_t>& predictions) const
+{
+  if (numClasses == 0)
+  {
+    throw std::invalid_argument("GradientBoosting::Classify(): no model "
+        "trained!");
+  }
+
+  predictions.set_size(data.n_cols);
+
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) data.n_cols; ++i)
+    predictions[i] = Classify(data.col(i));
+}
+
+template<typename DimensionSelectionType, typename ElemType>
+template<typename MatType>
+void GradientBoosting<DimensionSelectionType, ElemType>::Classify(
+    const MatType& data,
+    arma::Row<size_t>& predictions,
+    arma::mat& probabilities) const
+{
+  if (numClasses == 0)
+  {
+    throw std::invalid_argument("GradientBoosting::Classify(): no model "
+        "trained!");
+  }
+
+  predictions.set_size(data.n_cols);
+  probabilities.set_size(numClasses, data.n_cols);
+
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) data.n_cols; ++i)
+  {
+    arma::vec probs;
+    Classify(data.col(i), predictions[i], probs);
+    probabilities.col(i) = probs;
+  }
+}
+
+template<typename DimensionSelectionType, typename ElemType>
+template<typename Archive>
+void GradientBoosting<DimensionSelectionType, ElemType>::serialize(
+    Archive& ar,
+    const unsigned int /* version */)
+{
+  ar & BOOST_SERIALIZATION_NVP(numClasses);
+  ar & BOOST_SERIALIZATION_NVP(initialScores);
+  ar & BOOST_SERIALIZATION_NVP(trees);
+}
+
+template<typename DimensionSelectionType, typename ElemType>
+template<typename VecType>
+void GradientBoosting<DimensionSelectionType, ElemType>::Scores(
+    const VecType& point,
+    arma::vec& scores) const
+{
+  const size_t numScores = NumScores();
+  scores = initialScores;
+  for (size_t t = 0; t < trees.size(); ++t)
+    scores[t % numScores] += trees[t].Predict(point);
+}
+
+template<typename DimensionSelectionType, typename ElemType>
+void GradientBoosting<DimensionSelectionType, ElemType>::Probabilities(
+    const arma::vec& scores,
+    arma::vec& probabilities) const
+{
+  if (numClasses == 2)
+  {
+    probabilities.set_size(2);
+    probabilities[1] = 1.0 / (1.0 + std::exp(-scores[0]));
+    probabilities[0] = 1.0 - probabilities[1];
+  }
+  else
+  {
+    // Shift the scores for numerical stability.
+    probabilities = arma::exp(scores - scores.max());
+    probabilities /= arma::accu(probabilities);
+  }
+}
+
+template<typename DimensionSelectionType, typename ElemType>
+void GradientBoosting<DimensionSelectionType, ElemType>::GrowTree(
+    TreeType& tree,
+    const arma::Mat<unsigned char>& bins,
+    const std::vector<arma::Col<ElemType>>& boundaries,
+    const arma::uvec& binOffsets,
+    const double* gradients,
+    const double* hessians,
+    const double learningRate,
+    const size_t maximumLeaves,
+    const size_t minimumLeafSize,
+    const double lambda,
+    DimensionSelectionType& dimensionSelector,
+    double* scores,
+    const size_t stride,
+    std::vector<size_t>& order) const
+{
+  for (size_t i = 0; i < order.size(); ++i)
+    order[i] = i;
+
+  std::vector<GrowingLeaf> leaves(1);
+  leaves[0].node = 0;
+  leaves[0].begin = 0;
+  leaves[0].end = order.size();
+  BuildHistogram(bins, binOffsets, gradients, hessians, order, leaves[0]);
+  FindSplit(binOffsets, minimumLeafSize, lambda, dimensionSelector, leaves[0]);
+
+  // Split the leaf with the largest gain until there are enough leaves.
+  while (leaves.size() < maximumLeaves)
+  {
+    size_t best = 0;
+    for (size_t l = 1; l < leaves.size(); ++l)
+      if (leaves[l].gain > leaves[best].gain)
+        best = l;
+    if (leaves[best].gain <= 0.0)
+      break;
+
+    GrowingLeaf& parent = leaves[best];
+    const size_t dimension = parent.dimension;
+    const size_t bin = parent.bin;
+    const size_t left = tree.Split(parent.node, dimension,
+        boundaries[dimension][bin]);
+
+    const size_t mid = std::stable_partition(order.begin() + parent.begin,
+        order.begin() + parent.end,
+        [&bins, dimension, bin](const size_t i)
+        {
+          return bins(i, dimension) <= bin;
+        }) - order.begin();
+
+    GrowingLeaf leftLeaf, rightLeaf;
+    leftLeaf.node = left;
+    leftLeaf.begin = parent.begin;
+    leftLeaf.end = mid;
+    rightLeaf.node = left + 1;
+    rightLeaf.begin = mid;
+    rightLeaf.end = parent.end;
+
+    // Only build the histogram of the smaller child; the other one is the
+    // difference with the histogram of the parent.
+    const bool leftSmaller = (mid - parent.begin) <= (parent.end - mid);
+    GrowingLeaf& smaller = leftSmaller ? leftLeaf : rightLeaf;
+    GrowingLeaf& larger = leftSmaller ? rightLeaf : leftLeaf;
+    BuildHistogram(bins, binOffsets, gradients, hessians, order, smaller);
+    larger.histogram = std::move(parent.histogram);
+    larger.histogram -= smaller.histogram;
+    larger.gradientSum = parent.gradientSum - smaller.gradientSum;
+    larger.hessianSum = parent.hessianSum - smaller.hessianSum;
+
+    FindSplit(binOffsets, minimumLeafSize, lambda, dimensionSelector,
+        leftLeaf);
+    FindSplit(binOffsets, minimumLeafSize, lambda, dimensionSelector,
+        rightLeaf);
+
+    leaves[best] = std::move(leftLeaf);
+    leaves.push_back(std::move(rightLeaf));
+  }
+
+  // Set the value of each leaf, and add it to the scores of its points.
+  for (size_t l = 0; l < leaves.size(); ++l)
+  {
+    const double value = -learningRate * leaves[l].gradientSum /
+        (leaves[l].hessianSum + lambda);
+    tree.Value(leaves[l].node) = value;
+    for (size_t i = leaves[l].begin; i < leaves[l].end; ++i)
+      scores[order[i] * stride] += value;
+  }
+}
+
+template<typename DimensionSelectionType, typename ElemType>
+void GradientBoosting<DimensionSelectionType, ElemType>::BuildHistogram(
+    const arma::Mat<unsigned char>& bins,
+    const arma::uvec& binOffsets,
+    const double* gradients,
+    const double* hessians,
+    const std::vector<size_t>& order,
+    GrowingLeaf& leaf) const
+{
+  const size_t d = binOffsets.n_elem - 1;
+  leaf.histogram.zeros(3, binOffsets[d]);
+
+  #pragma omp parallel for
+  for (omp_size_t j = 0; j < (omp_size_t) d; ++j)
+  {
+    double* histogram = leaf.histogram.colptr(binOffsets[j]);
+    const unsigned char* dimensionBins = bins.colptr(j);
+    for (size_t i = leaf.begin; i < leaf.end; ++i)
+    {
+      const size_t point = order[i];
+      double* entry = histogram + 3 * dimensionBins[point];
+      entry[0] += gradients[point];
+      entry[1] += hessians[point];
+      entry[2] += 1.0;
+    }
+  }
+
+  // Every dimension holds all the points, so the first one gives the sums.
+  leaf.gradientSum = 0.0;
+  leaf.hessianSum = 0.0;
+  for (size_t b = binOffsets[0]; b < binOffsets[1]; ++b)
+  {
+    leaf.gradientSum += leaf.histogram(0, b);
+    leaf.hessianSum += leaf.histogram(1, b);
+  }
+}
+
+template<typename DimensionSelectionType, typename ElemType>
+void GradientBoosting<DimensionSelectionType, ElemType>::FindSplit(
+    const arma::uvec& binOffsets,
+    const size_t minimumLeafSize,
+    const double lambda,
+    DimensionSelectionType& dimensionSelector,
+    GrowingLeaf& leaf) const
+{
+  leaf.gain = 0.0;
+  const double count = leaf.end - leaf.begin;
+  const double minimumCount = std::max(minimumLeafSize, (size_t) 1);
+  if (count < 2 * minimumCount)
+    return;
+
+  // The selector may be random, so draw the dimensions before the search.
+  std::vector<size_t> dimensions;
+  for (size_t j = dimensionSelector.Begin(); j != dimensionSelector.End();
+       j = dimensionSelector.Next())
+    dimensions.push_back(j);
+
+  const double parentScore = leaf.gradientSum * leaf.gradientSum /
+      (leaf.hessianSum + lambda);
+  std::vector<double> gains(dimensions.size(), 0.0);
+  std::vector<size_t> splitBins(dimensions.size(), 0);
+
+  #pragma omp parallel for
+  for (omp_size_t t = 0; t < (omp_size_t) dimensions.size(); ++t)
+  {
+    const size_t j = dimensions[t];
+    double leftGradient = 0.0, leftHessian = 0.0, leftCount = 0.0;
+    for (size_t b = binOffsets[j]; b + 1 < binOffsets[j + 1]; ++b)
+    {
+      leftGradient += leaf.histogram(0, b);
+      leftHessian += leaf.histogram(1, b);
+      leftCount += leaf.histogram(2, b);
+      if (leftCount < minimumCount)
+        continue;
+      if (count - leftCount < minimumCount)
+        break;
+
+      const double rightGradient = leaf.gradientSum - leftGradient;
+      const double rightHessian = leaf.hessianSum - leftHessian;
+      const double gain = leftGradient * leftGradient /
+          (leftHessian + lambda) + rightGradient * rightGradient /
+          (rightHessian + lambda) - parentScore;
+      if (gain > gains[t])
+      {
+        gains[t] = gain;
+        splitBins[t] = b - binOffsets[j];
+      }
+    }
+  }
+
+  // Ties go to the first dimension given by the selector.
+  for (size_t t = 0; t < dimensions.size(); ++t)
+  {
+    if (gains[t] > leaf.gain)
+    {
+      leaf.gain = gains[t];
+      leaf.dimension = dimensions[t];
+      leaf.bin = splitBins[t];
+    }
+  }
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,125 @@
+/**
+ * @file methods/gradient_boosting/gradient_boosting_tree.hpp
+ *
+ * Definition of GradientBoostingTree, the regression tree of one boosting
+ * iteration.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_GRADIENT_BOOSTING_GRADIENT_BOOSTING_TREE_HPP
+#define MLPACK_METHODS_GRADIENT_BOOSTING_GRADIENT_BOOSTING_TREE_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * A GradientBoostingTree is a binary regression tree stored in contiguous
+ * arrays: each internal node holds a split dimension, a threshold and the index
+ * of its left child (the right child follows it), and each leaf holds a value.
+ * A point goes to the left child when its value in the split dimension is not
+ * greater than the threshold.
+ *
+ * @tparam ElemType Type of the values of the points.
+ */
+template<typename ElemType = double>
+class GradientBoostingTree
+{
+ public:
+  //! Create a tree with a single leaf of value 0.
+  GradientBoostingTree() :
+      dimensions(1, 0), thresholds(1, ElemType(0)), children(1, 0),
+      values(1, 0.0)
+  { }
+
+  /**
+   * Split the given leaf, and return the index of its left child (the right
+   * child is the next one).  The children are leaves of value 0.
+   *
+   * @param node Leaf to split.
+   * @param dimension Dimension to split on.
+   * @param threshold Largest value of the points that go left.
+   */
+  size_t Split(const size_t node,
+               const size_t dimension,
+               const ElemType threshold)
+  {
+    dimensions[node] = dimension;
+    thresholds[node] = threshold;
+    children[node] = dimensions.size();
+
+    dimensions.resize(dimensions.size() + 2, 0);
+    thresholds.resize(thresholds.size() + 2, ElemType(0));
+    children.resize(children.size() + 2, 0);
+    values.resize(values.size() + 2, 0.0);
+
+    return children[node];
+  }
+
+  //! Return the leaf the given point falls into.
+  template<typename VecType>
+  size_t Leaf(const VecType& point) const
+  {
+    // The root is never a child, so a child index of 0 marks a leaf.
+    size_t node = 0;
+    while (children[node] != 0)
+    {
+      node = children[node] +
+          ((point[dimensions[node]] <= thresholds[node]) ? 0 : 1);
+    }
+
+    return node;
+  }
+
+  //! Return the value of the leaf the given point falls into.
+  template<typename VecType>
+  double Predict(const VecType& point) const { return values[Leaf(point)]; }
+
+  //! Get the number of nodes.
+  size_t NumNodes() const { return dimensions.size(); }
+  //! Get the number of leaves.
+  size_t NumLeaves() const { return (dimensions.size() + 1) / 2; }
+  //! Return whether the given node is a leaf.
+  bool IsLeaf(const size_t node) const { return children[node] == 0; }
+
+  //! Get the split dimension of the given internal node.
+  size_t SplitDimension(const size_t node) const { return dimensions[node]; }
+  //! Get the threshold of the given internal node.
+  ElemType Threshold(const size_t node) const { return thresholds[node]; }
+  //! Get the left child of the given internal node.
+  size_t LeftChild(const size_t node) const { return children[node]; }
+
+  //! Get the value of the given leaf.
+  double Value(const size_t node) const { return values[node]; }
+  //! Modify the value of the given leaf.
+  double& Value(const size_t node) { return values[node]; }
+
+  //! Serialize the tree.
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */)
+  {
+    ar & BOOST_SERIALIZATION_NVP(dimensions);
+    ar & BOOST_SERIALIZATION_NVP(thresholds);
+    ar & BOOST_SERIALIZATION_NVP(children);
+    ar & BOOST_SERIALIZATION_NVP(values);
+  }
+
+ private:
+  //! The split dimension of each node.
+  std::vector<size_t> dimensions;
+  //! The threshold of each node.
+  std::vector<ElemType> thresholds;
+  //! The left child of each node (0 for leaves).
+  std::vector<size_t> children;
+  //! The value of each node (only used for leaves).
+  std::vector<double> values;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
@@ -81,6 +81,10 @@ namespace hmm /** Hidden Markov Models. */ {
  *
  * @tparam Distribution Type of emission distribution for this HMM.
  */
+// Forward declaration, for the beam-pruned Predict().
+template<typename Distribution>
+class OnlineViterbi;
+
 template<typename Distribution = distribution::DiscreteDistribution>
 class HMM
 {
@@ -158,6 +162,11 @@ class HMM
    * log-likelihood of the model between iterations is less than the tolerance,
    * the Baum-Welch algorithm terminates.
    *
+   * If OpenMP is enabled, the E-step of each iteration processes the sequences
+   * on several threads (see NumThreads()); each thread accumulates the
+   * statistics of its own sequences, and they are merged at the end of the
+   * E-step.
+   *
    * @note
    * Train() can be called multiple times with different sequences; each time it
    * is called, it uses the current parameters of the HMM as a starting point
@@ -282,6 +291,25 @@ class HMM
   double Predict(const arma::mat& dataSeq,
                  arma::Row<size_t>& stateSeq) const;
 
+  /**
+   * Compute an approximation of the most probable hidden state sequence for
+   * the given data sequence, using the Viterbi algorithm with beam pruning: at
+   * each time step, only the states whose log-probability is within beamWidth
+   * of the best state are considered as previous states.  This is faster when
+   * there are many states and few of them are likely.  See OnlineViterbi to
+   * decode sequences that are too long to be held in memory.
+   *
+   * @param dataSeq Sequence of observations.
+   * @param stateSeq Vector in which the most probable state sequence will be
+   *    stored.
+   * @param beamWidth Log-probability difference with the best state beyond
+   *    which states are pruned.
+   * @return Log-likelihood of the state sequence found.
+   */
+  double Predict(const arma::mat& dataSeq,
+                 arma::Row<size_t>& stateSeq,
+                 const double beamWidth) const;
+
   /**
    * Compute the log-likelihood of the given data sequence.
    *
@@ -290,6 +318,21 @@ class HMM
    */
   double LogLikelihood(const arma::mat& dataSeq) const;
 
+  /**
+   * Compute the log-likelihood of each of the given data sequences.  The
+   * sequences are evaluated in parallel, and each thread reuses its buffers for
+   * all of its sequences.  Single-precision sequences (std::vector<arma::fmat>)
+   * are converted to double precision one at a time, so a large batch can be
+   * held in half the memory.
+   *
+   * @param dataSeq Data sequences to evaluate the likelihood of.
+   * @param logLikelihoods Vector in which the log-likelihood of each sequence
+   *     will be stored.
+   */
+  template<typename eT>
+  void LogLikelihood(const std::vector<arma::Mat<eT>>& dataSeq,
+                     arma::vec& logLikelihoods) const;
+
   /**
    * HMM filtering. Computes the k-step-ahead expected emission at each time
    * conditioned only on prior observations. That is
@@ -353,6 +396,13 @@ class HMM
   //! Modify the tolerance of the Baum-Welch algorithm.
   double& Tolerance() { return tolerance; }
 
+  //! Get the number of threads used by Baum-Welch training (0 means that
+  //! OpenMP picks the number of threads).
+  size_t NumThreads() const { return numThreads; }
+  //! Modify the number of threads used by Baum-Welch training (0 means that
+  //! OpenMP picks the number of threads).
+  size_t& NumThreads() { return numThreads; }
+
   /**
    * Load the object.
    */
@@ -399,6 +449,47 @@ class HMM
                 const arma::vec& logScales,
                 arma::mat& backwardLogProb) const;
 
+  /**
+   * Compute the log probability of each observation in the given data sequence
+   * under the emission distribution of each state.  The returned matrix has
+   * rows equal to the number of hidden states and columns equal to the number
+   * of observations.  Each emission distribution evaluates the whole sequence
+   * at once.
+   *
+   * @param dataSeq Data sequence to compute probabilities for.
+   * @param emissionLogProb Matrix in which the log probabilities will be saved.
+   */
+  void EmissionLogProbabilities(const arma::mat& dataSeq,
+                                arma::mat& emissionLogProb) const;
+
+  /**
+   * The Forward algorithm, using the given emission log probabilities
+   * (computed by EmissionLogProbabilities()).
+   *
+   * @param dataSeq Data sequence to compute probabilities for.
+   * @param logScales Vector in which scaling factors will be saved.
+   * @param forwardLogProb Matrix in which forward probabilities will be saved.
+   * @param emissionLogProb Emission log probabilities of the data sequence.
+   */
+  void Forward(const arma::mat& dataSeq,
+               arma::vec& logScales,
+               arma::mat& forwardLogProb,
+               const arma::mat& emissionLogProb) const;
+
+  /**
+   * The Backward algorithm, using the given emission log probabilities
+   * (computed by EmissionLogProbabilities()).
+   *
+   * @param dataSeq Data sequence to compute probabilities for.
+   * @param logScales Vector of scaling factors.
+   * @param backwardLogProb Matrix to save the backward probabilities in.
+   * @param emissionLogProb Emission log probabilities of the data sequence.
+   */
+  void Backward(const arma::mat& dataSeq,
+                const arma::vec& logScales,
+                arma::mat& backwardLogProb,
+                const arma::mat& emissionLogProb) const;
+
   //! Set of emission probability distributions; one for each state.
   std::vector<Distribution> emission;
 
@@ -419,6 +510,9 @@ class HMM
    */
   void ConvertToLogSpace() const;
 
+  //! Get the number of threads to train with.
+  size_t ComputationThreads() const;
+
   /**
    * A proxy vriable in linear space for logInitial.
    * Should be removed in mlpack 4.0.
@@ -434,6 +528,9 @@ class HMM
   //! Tolerance of Baum-Welch algorithm.
   double tolerance;
 
+  //! The number of threads to train with; this is not serialized.
+  size_t numThreads;
+
   /**
    * Whether or not we need to update the logInitial from initialProxy.
    * Should be removed in mlpack 4.0.
@@ -453,4 +550,7 @@ class HMM
 // Include implementation.
 #include "hmm_impl.hpp"
 
+// The beam-pruned Predict() uses OnlineViterbi.
+#include "online_viterbi.hpp"
+
 #endif
@@ -34,6 +34,7 @@ HMM<Distribution>::HMM(const size_t states,
     initialProxy(arma::randu<arma::vec>(states) / (double) states),
     dimensionality(emissions.Dimensionality()),
     tolerance(tolerance),
+    numThreads(0),
     recalculateInitial(false),
     recalculateTransition(false)
 {
@@ -61,6 +62,7 @@ HMM<Distribution>::HMM(const arma::vec& initial,
     initialProxy(initial),
     logInitial(log(initial)),
     tolerance(tolerance),
+    numThreads(0),
     recalculateInitial(false),
     recalculateTransition(false)
 {
@@ -100,6 +102,7 @@ double HMM<Distribution>::Train(const std::vector<arma::mat>& dataSeq)
 
   // Maximum iterations?
   size_t iterations = 1000;
+  const size_t threads = ComputationThreads();
 
   // Find length of all sequences and ensure they are the correct size.
   size_t totalLength = 0;
@@ -114,10 +117,22 @@ double HMM<Distribution>::Train(const std::vector<arma::mat>& dataSeq)
   }
 
   // These are used later for training of each distribution.  We initialize it
-  // all now so we don't have to do any allocation later on.
+  // all now so we don't have to do any allocation later on.  The observations
+  // don't change between iterations, so the list of emissions is filled only
+  // once; each sequence starts at its own offset, so that the sequences can be
+  // processed in parallel.
   std::vector<arma::vec> emissionProb(logTransition.n_cols,
       arma::vec(totalLength));
   arma::mat emissionList(dimensionality, totalLength);
+  std::vector<size_t> offsets(dataSeq.size());
+  size_t sumTime = 0;
+  for (size_t seq = 0; seq < dataSeq.size(); seq++)
+  {
+    offsets[seq] = sumTime;
+    emissionList.cols(sumTime, sumTime + dataSeq[seq].n_cols - 1) =
+        dataSeq[seq];
+    sumTime += dataSeq[seq].n_cols;
+  }
 
   // This should be the Baum-Welch algorithm (EM for HMM estimation). This
   // follows the procedure outlined in Elliot, Aggoun, and Moore's book "Hidden
@@ -133,53 +148,86 @@ double HMM<Distribution>::Train(const std::vector<arma::mat>& dataSeq)
     // Reset log likelihood.
     loglik = 0;
 
-    // Sum over time.
-    size_t sumTime = 0;
+    // Forward() and Backward() may need to update the log-space parameters;
+    // do that before the sequences are processed in parallel.
+    ConvertToLogSpace();
 
-    // Loop over each sequence.
-    for (size_t seq = 0; seq < dataSeq.size(); seq++)
+    // Loop over each sequence.  Each thread accumulates the initial and
+    // transition estimates of its sequences separately.
+    #pragma omp parallel num_threads(threads) reduction(+:loglik)
     {
-      arma::mat stateLogProb;
-      arma::mat forwardLog;
-      arma::mat backwardLog;
-      arma::vec logScales;
-
-      // Add the log-likelihood of this sequence.  This is the E-step.
-      loglik += LogEstimate(dataSeq[seq], stateLogProb, forwardLog,
-          backwardLog, logScales);
-
-      // Add to estimate of initial probability for state j.
-      for (size_t j = 0; j < logTransition.n_cols; ++j)
-        newLogInitial[j] = math::LogAdd(newLogInitial[j], stateLogProb(j, 0));
-
-      // Now re-estimate the parameters.  This is the M-step.
-      //   pi_i = sum_d ((1 / P(seq[d])) sum_t (f(i, 0) b(i, 0))
-      //   T_ij = sum_d ((1 / P(seq[d])) sum_t (f(i, t) T_ij E_i(seq[d][t]) b(i,
-      //           t + 1)))
-      //   E_ij = sum_d ((1 / P(seq[d])) sum_{t | seq[d][t] = j} f(i, t) b(i, t)
-      // We store the new estimates in a different matrix.
-      for (size_t t = 0; t < dataSeq[seq].n_cols; ++t)
+      arma::vec threadLogInitial(logTransition.n_rows);
+      threadLogInitial.fill(-std::numeric_limits<double>::infinity());
+      arma::mat threadLogTransition(logTransition.n_rows, logTransition.n_cols);
+      threadLogTransition.fill(-std::numeric_limits<double>::infinity());
+
+      #pragma omp for schedule(dynamic, 16)
+      for (omp_size_t seq = 0; seq < (omp_size_t) dataSeq.size(); seq++)
       {
+        arma::mat stateLogProb;
+        arma::mat forwardLog;
+        arma::mat backwardLog;
+        arma::vec logScales;
+        arma::mat emissionLogProb;
+
+        // Add the log-likelihood of this sequence.  This is the E-step.  The
+        // emission probabilities are computed once for the whole sequence.
+        EmissionLogProbabilities(dataSeq[seq], emissionLogProb);
+        Forward(dataSeq[seq], logScales, forwardLog, emissionLogProb);
+        Backward(dataSeq[seq], logScales, backwardLog, emissionLogProb);
+        stateLogProb = forwardLog + backwardLog;
+        loglik += accu(logScales);
+
+        // Now re-estimate the parameters.  This is the M-step.
+        //   pi_i = sum_d ((1 / P(seq[d])) sum_t (f(i, 0) b(i, 0))
+        //   T_ij = sum_d ((1 / P(seq[d])) sum_t (f(i, t) T_ij E_i(seq[d][t])
+        //           b(i, t + 1)))
+        //   E_ij = sum_d ((1 / P(seq[d])) sum_{t | seq[d][t] = j} f(i, t)
+        //           b(i, t)
+        // We store the new estimates in a different matrix.
         for (size_t j = 0; j < logTransition.n_cols; ++j)
         {
-          if (t < dataSeq[seq].n_cols - 1)
+          threadLogInitial[j] = math::LogAdd(threadLogInitial[j],
+              stateLogProb(j, 0));
+        }
+
+        for (size_t t = 0; t < dataSeq[seq].n_cols; ++t)
+        {
+          for (size_t j = 0; j < logTransition.n_cols; ++j)
           {
-            // Estimate of T_ij (probability of transition from state j to state
-            // i).  We postpone multiplication of the old T_ij until later.
-            for (size_t i = 0; i < logTransition.n_rows; ++i)
+            if (t < dataSeq[seq].n_cols - 1)
             {
-              newLogTransition(i, j) = math::LogAdd(newLogTransition(i, j),
-                  forwardLog(j, t) + backwardLog(i, t + 1) +
-                  emission[i].LogProbability(dataSeq[seq].unsafe_col(t + 1)) -
-                  logScales[t + 1]);
+              // Estimate of T_ij (probability of transition from state j to
+              // state i).  We postpone multiplication of the old T_ij until
+              // later.
+              for (size_t i = 0; i < logTransition.n_rows; ++i)
+              {
+                threadLogTransition(i, j) = math::LogAdd(
+                    threadLogTransition(i, j),
+                    forwardLog(j, t) + backwardLog(i, t + 1) +
+                    emissionLogProb(i, t + 1) - logScales[t + 1]);
+              }
             }
+
+            // Store the weight of the observation, for Distribution::Train().
+            emissionProb[j][offsets[seq] + t] = exp(stateLogProb(j, t));
           }
+        }
+      }
 
-          // Add to list of emission observations, for Distribution::Train().
-          emissionList.col(sumTime) = dataSeq[seq].col(t);
-          emissionProb[j][sumTime] = exp(stateLogProb(j, t));
+      // Add the estimates of this thread to the totals.
+      #pragma omp critical
+      {
+        for (size_t j = 0; j < logTransition.n_cols; ++j)
+        {
+          newLogInitial[j] = math::LogAdd(newLogInitial[j],
+              threadLogInitial[j]);
+          for (size_t i = 0; i < logTransition.n_rows; ++i)
+          {
+            newLogTransition(i, j) = math::LogAdd(newLogTransition(i, j),
+                threadLogTransition(i, j));
+          }
         }
-        sumTime++;
       }
     }
 
@@ -338,8 +386,10 @@ double HMM<Distribution>::LogEstimate(const arma::mat& dataSeq,
                                       arma::vec& logScales) const
 {
   // First run the forward-backward algorithm.
-  Forward(dataSeq, logScales, forwardLogProb);
-  Backward(dataSeq, logScales, backwardLogProb);
+  arma::mat emissionLogProb;
+  EmissionLogProbabilities(dataSeq, emissionLogProb);
+  Forward(dataSeq, logScales, forwardLogProb, emissionLogProb);
+  Backward(dataSeq, logScales, backwardLogProb, emissionLogProb);
 
   // Now assemble the state probability matrix based on the forward and backward
   // probabilities.
@@ -468,14 +518,16 @@ double HMM<Distribution>::Predict(const arma::mat& dataSeq,
 
   ConvertToLogSpace();
 
+  arma::mat emissionLogProb;
+  EmissionLogProbabilities(dataSeq, emissionLogProb);
+
   // The calculation of the first state is slightly different; the probability
   // of the first state being state j is the maximum probability that the state
   // came to be j from another state.
   logStateProb.col(0).zeros();
   for (size_t state = 0; state < logTransition.n_rows; state++)
   {
-    logStateProb(state, 0) = logInitial[state] +
-        emission[state].LogProbability(dataSeq.unsafe_col(0));
+    logStateProb(state, 0) = logInitial[state] + emissionLogProb(state, 0);
     stateSeqBack(state, 0) = state;
   }
 
@@ -489,8 +541,7 @@ double HMM<Distribution>::Predict(const arma::mat& dataSeq,
     for (size_t j = 0; j < logTransition.n_rows; ++j)
     {
       arma::vec prob = logStateProb.col(t - 1) + logTransition.row(j).t();
-      logStateProb(j, t) = prob.max(index) +
-          emission[j].LogProbability(dataSeq.unsafe_col(t));
+      logStateProb(j, t) = prob.max(index) + emissionLogProb(j, t);
       stateSeqBack(j, t) = index;
     }
   }
@@ -507,6 +558,23 @@ double HMM<Distribution>::Predict(const arma::mat& dataSeq,
   return logStateProb(stateSeq(dataSeq.n_cols - 1), dataSeq.n_cols - 1);
 }
 
+/**
+ * Compute the most probable hidden state sequence with beam pruning.
+ */
+template<typename Distribution>
+double HMM<Distribution>::Predict(const arma::mat& dataSeq,
+                                  arma::Row<size_t>& stateSeq,
+                                  const double beamWidth) const
+{
+  // With no lag, the decoder decides every state at the end.
+  OnlineViterbi<Distribution> decoder(*this, 0, beamWidth);
+  decoder.Push(dataSeq, stateSeq);
+  const double logLikelihood = decoder.LogLikelihood();
+  decoder.Flush(stateSeq);
+
+  return logLikelihood;
+}
+
 /**
  * Compute the log-likelihood of the given data sequence.
  */
@@ -522,6 +590,53 @@ double HMM<Distribution>::LogLikelihood(const arma::mat& dataSeq) const
   return accu(logScales);
 }
 
+/**
+ * Compute the log-likelihood of each of the given data sequences.
+ */
+template<typename Distribution>
+template<typename eT>
+void HMM<Distribution>::LogLikelihood(
+    const std::vector<arma::Mat<eT>>& dataSeq,
+    arma::vec& logLikelihoods) const
+{
+  for (size_t seq = 0; seq < dataSeq.size(); seq++)
+  {
+    if (dataSeq[seq].n_rows != dimensionality)
+      Log::Fatal << "HMM::LogLikelihood(): data sequence " << seq << " has "
+          << "dimensionality " << dataSeq[seq].n_rows << " (expected "
+          << dimensionality << " dimensions)." << std::endl;
+  }
+
+  // The log-space parameters are cached the first time they are needed; that
+  // is done here, so that the threads only read them.
+  ConvertToLogSpace();
+
+  logLikelihoods.set_size(dataSeq.size());
+  const size_t threads = ComputationThreads();
+
+  #pragma omp parallel num_threads(threads)
+  {
+    arma::mat sequence;
+    arma::mat emissionLogProb;
+    arma::mat forwardLog;
+    arma::vec logScales;
+
+    #pragma omp for schedule(dynamic, 16)
+    for (omp_size_t seq = 0; seq < (omp_size_t) dataSeq.size(); seq++)
+    {
+      // This also converts single-precision sequences.
+      const arma::Mat<eT>& data = dataSeq[seq];
+      sequence.set_size(data.n_rows, data.n_cols);
+      std::copy(data.memptr(), data.memptr() + data.n_elem,
+          sequence.memptr());
+
+      EmissionLogProbabilities(sequence, emissionLogProb);
+      Forward(sequence, logScales, forwardLog, emissionLogProb);
+      logLikelihoods[seq] = accu(logScales);
+    }
+  }
+}
+
 /**
  * HMM filtering.
  */
@@ -577,6 +692,17 @@ template<typename Distribution>
 void HMM<Distribution>::Forward(const arma::mat& dataSeq,
                                 arma::vec& logScales,
                                 arma::mat& forwardLogProb) const
+{
+  arma::mat emissionLogProb;
+  EmissionLogProbabilities(dataSeq, emissionLogProb);
+  Forward(dataSeq, logScales, forwardLogProb, emissionLogProb);
+}
+
+template<typename Distribution>
+void HMM<Distribution>::Forward(const arma::mat& dataSeq,
+                                arma::vec& logScales,
+                                arma::mat& forwardLogProb,
+                                const arma::mat& emissionLogProb) const
 {
   // Our goal is to calculate the forward probabilities:
   //  P(X_k | o_{1:k}) for all possible states X_k, for each time point k.
@@ -594,8 +720,7 @@ void HMM<Distribution>::Forward(const arma::mat& dataSeq,
   // sequence and that should produce results in line with MATLAB.
   for (size_t state = 0; state < logTransition.n_rows; state++)
   {
-    forwardLogProb(state, 0) = logInitial(state) +
-        emission[state].LogProbability(dataSeq.unsafe_col(0));
+    forwardLogProb(state, 0) = logInitial(state) + emissionLogProb(state, 0);
   }
 
   // Then normalize the column.
@@ -603,18 +728,16 @@ void HMM<Distribution>::Forward(const arma::mat& dataSeq,
   if (std::isfinite(logScales[0]))
     forwardLogProb.col(0) -= logScales[0];
 
-  // Now compute the probabilities for each successive observation.
+  // Now compute the probabilities for each successive observation.  The
+  // forward probability of state j at time t is the sum over all states of the
+  // probability of the previous state transitioning to the current state and
+  // emitting the given observation.  The previous column is normalized (its
+  // largest element is at most 0), so it can be taken out of log space safely
+  // and the sum over all states is one matrix-vector product.
   for (size_t t = 1; t < dataSeq.n_cols; t++)
   {
-    for (size_t j = 0; j < logTransition.n_rows; ++j)
-    {
-      // The forward probability of state j at time t is the sum over all states
-      // of the probability of the previous state transitioning to the current
-      // state and emitting the given observation.
-      arma::vec tmp = forwardLogProb.col(t - 1) + logTransition.row(j).t();
-      forwardLogProb(j, t) = math::AccuLog(tmp) +
-          emission[j].LogProbability(dataSeq.unsafe_col(t));
-    }
+    forwardLogProb.col(t) = arma::log(transitionProxy *
+        arma::exp(forwardLogProb.col(t - 1))) + emissionLogProb.col(t);
 
     // Normalize probability.
     logScales[t] = math::AccuLog(forwardLogProb.col(t));
@@ -627,6 +750,17 @@ template<typename Distribution>
 void HMM<Distribution>::Backward(const arma::mat& dataSeq,
                                  const arma::vec& logScales,
                                  arma::mat& backwardLogProb) const
+{
+  arma::mat emissionLogProb;
+  EmissionLogProbabilities(dataSeq, emissionLogProb);
+  Backward(dataSeq, logScales, backwardLogProb, emissionLogProb);
+}
+
+template<typename Distribution>
+void HMM<Distribution>::Backward(const arma::mat& dataSeq,
+                                 const arma::vec& logScales,
+                                 arma::mat& backwardLogProb,
+                                 const arma::mat& emissionLogProb) const
 {
   // Our goal is to calculate the backward probabilities:
   //  P(X_k | o_{k + 1:T}) for all possible states X_k, for each time point k.
@@ -636,29 +770,56 @@ void HMM<Distribution>::Backward(const arma::mat& dataSeq,
   // The last element probability is 1.
   backwardLogProb.col(dataSeq.n_cols - 1).fill(0);
 
-  // Now step backwards through all other observations.
+  // Now step backwards through all other observations.  The backward
+  // probability of state j at time t is the sum over all states of the
+  // probability of the next state having been a transition from the current
+  // state multiplied by the probability of each of those states emitting the
+  // given observation.  The sum is one matrix-vector product with the
+  // transposed transition matrix, after the largest term is factored out so
+  // that nothing overflows.
+  arma::vec next;
   for (size_t t = dataSeq.n_cols - 2; t + 1 > 0; t--)
   {
-    for (size_t j = 0; j < logTransition.n_rows; ++j)
-    {
-      // The backward probability of state j at time t is the sum over all state
-      // of the probability of the next state having been a transition from the
-      // current state multiplied by the probability of each of those states
-      // emitting the given observation.
-      for (size_t state = 0; state < logTransition.n_rows; state++)
-      {
-        backwardLogProb(j, t) = math::LogAdd(backwardLogProb(j, t),
-            logTransition(state, j) + backwardLogProb(state, t + 1)
-            + emission[state].LogProbability(dataSeq.unsafe_col(t + 1)));
-      }
+    next = backwardLogProb.col(t + 1) + emissionLogProb.col(t + 1);
+    const double maxLogProb = next.max();
+    if (!std::isfinite(maxLogProb))
+      continue;
 
-      // Normalize by the weights from the forward algorithm.
-      if (std::isfinite(logScales[t + 1]))
-        backwardLogProb(j, t) -= logScales[t + 1];
-    }
+    backwardLogProb.col(t) = arma::log(transitionProxy.t() *
+        arma::exp(next - maxLogProb)) + maxLogProb;
+
+    // Normalize by the weights from the forward algorithm.
+    if (std::isfinite(logScales[t + 1]))
+      backwardLogProb.col(t) -= logScales[t + 1];
+  }
+}
+
+/**
+ * Compute the emission log probabilities of each observation for each state.
+ */
+template<typename Distribution>
+void HMM<Distribution>::EmissionLogProbabilities(
+    const arma::mat& dataSeq,
+    arma::mat& emissionLogProb) const
+{
+  emissionLogProb.set_size(emission.size(), dataSeq.n_cols);
+  arma::vec logProbabilities;
+  for (size_t i = 0; i < emission.size(); ++i)
+  {
+    emission[i].LogProbability(dataSeq, logProbabilities);
+    emissionLogProb.row(i) = logProbabilities.t();
   }
 }
 
+/**
+ * Get the number of threads to train with.
+ */
+template<typename Distribution>
+size_t HMM<Distribution>::ComputationThreads() const
+{
+  return util::Threads(numThreads);
+}
+
 /**
  * Make sure the variables in log space are in sync with the linear counter parts
  */
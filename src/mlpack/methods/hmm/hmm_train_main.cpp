@@ -58,7 +58,10 @@ BINDING_LONG_DESC(
     "provided.  The tolerance of the Baum-Welch algorithm can be set with the "
     + PRINT_PARAM_STRING("tolerance") + "option.  By default, the transition "
     "matrix is randomly initialized and the emission distributions are "
-    "initialized to fit the extent of the data."
+    "initialized to fit the extent of the data.  Each iteration of the "
+    "Baum-Welch algorithm processes the sequences on several threads; the "
+    "number of threads can be set with " + PRINT_PARAM_STRING("threads") +
+    " (0 uses the OpenMP default)."
     "\n\n"
     "Optionally, a pre-created HMM model can be used as a guess for the "
     "transition matrix and emission probabilities; this is specifiable with " +
@@ -309,6 +312,8 @@ struct Train
     if (IO::HasParam("tolerance"))
       hmm.Tolerance() = tolerance;
 
+    hmm.NumThreads() = (size_t) IO::GetParam<int>("threads");
+
     const string labelsFile = IO::GetParam<string>("labels_file");
 
     // Verify that the dimensionality of our observations is the same as the
@@ -462,6 +467,8 @@ static void mlpackMain()
 
   RequireParamValue<double>("tolerance", [](double x) { return x >= 0; }, true,
       "tolerance must be non-negative");
+  RequireParamValue<int>("threads", [](int x) { return x >= 0; }, true,
+      "number of threads must be nonnegative");
 
   // Load the input data.
   vector<mat> trainSeq;
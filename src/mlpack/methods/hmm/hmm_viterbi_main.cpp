@@ -16,6 +16,7 @@
 
 #include "hmm.hpp"
 #include "hmm_model.hpp"
+#include "online_viterbi.hpp"
 
 #include <mlpack/methods/gmm/gmm.hpp>
 #include <mlpack/methods/gmm/diagonal_gmm.hpp>
@@ -45,7 +46,17 @@ BINDING_LONG_DESC(
     "hidden state sequence of a given sequence of observations (specified as "
     "'" + PRINT_PARAM_STRING("input") + ", using the Viterbi algorithm.  The "
     "computed state sequence may be saved using the " +
-    PRINT_PARAM_STRING("output") + " output parameter.");
+    PRINT_PARAM_STRING("output") + " output parameter."
+    "\n\n"
+    "For long sequences or HMMs with many states, the search can be "
+    "approximated.  If " + PRINT_PARAM_STRING("beam_width") + " is positive, "
+    "at each time step only the states whose log-probability is within the "
+    "beam width of the best state are kept.  If " + PRINT_PARAM_STRING("lag") +
+    " is positive, the observations are decoded a block at a time and the "
+    "state at each time step is decided once the observations " +
+    PRINT_PARAM_STRING("lag") + " steps later have been seen, so that only "
+    "the last " + PRINT_PARAM_STRING("lag") + " steps of the search are kept "
+    "in memory.");
 
 // Example.
 BINDING_EXAMPLE(
@@ -69,6 +80,10 @@ BINDING_SEE_ALSO("mlpack::hmm::HMM class documentation",
 PARAM_MATRIX_IN_REQ("input", "Matrix containing observations,", "i");
 PARAM_MODEL_IN_REQ(HMMModel, "input_model", "Trained HMM to use.", "m");
 PARAM_UMATRIX_OUT("output", "File to save predicted state sequence to.", "o");
+PARAM_DOUBLE_IN("beam_width", "Log-probability beam width for pruning states "
+    "(0 means no pruning).", "b", 0.0);
+PARAM_INT_IN("lag", "Number of time steps after which a state is decided (0 "
+    "means that the whole sequence is decoded at once).", "l", 0);
 
 // Because we don't know what the type of our HMM is, we need to write a
 // function that can take arbitrary HMM types.
@@ -97,16 +112,57 @@ struct Viterbi
     }
 
     arma::Row<size_t> sequence;
-    hmm.Predict(dataSeq, sequence);
+    const double beamWidth = IO::GetParam<double>("beam_width");
+    const size_t lag = (size_t) IO::GetParam<int>("lag");
+    if (beamWidth == 0.0 && lag == 0)
+      hmm.Predict(dataSeq, sequence);
+    else
+      Decode(hmm, dataSeq, beamWidth, lag, sequence);
 
     // Save output.
     IO::GetParam<arma::Mat<size_t>>("output") = std::move(sequence);
   }
+
+  //! Decode the sequence with OnlineViterbi, one block of observations at a
+  //! time.
+  template<typename Distribution>
+  static void Decode(const HMM<Distribution>& hmm,
+                     const arma::mat& dataSeq,
+                     const double beamWidth,
+                     const size_t lag,
+                     arma::Row<size_t>& sequence)
+  {
+    const size_t blockSize = 1024;
+    OnlineViterbi<Distribution> decoder(hmm, lag, (beamWidth == 0.0) ?
+        std::numeric_limits<double>::infinity() : beamWidth);
+
+    sequence.set_size(dataSeq.n_cols);
+    size_t decided = 0;
+    arma::Row<size_t> states;
+    for (size_t begin = 0; begin < dataSeq.n_cols; begin += blockSize)
+    {
+      const size_t end = std::min(begin + blockSize,
+          (size_t) dataSeq.n_cols) - 1;
+      decoder.Push(dataSeq.cols(begin, end), states);
+      if (states.n_elem > 0)
+        sequence.cols(decided, decided + states.n_elem - 1) = states;
+      decided += states.n_elem;
+    }
+
+    // Decide the remaining states.
+    decoder.Flush(states);
+    if (states.n_elem > 0)
+      sequence.cols(decided, decided + states.n_elem - 1) = states;
+  }
 };
 
 static void mlpackMain()
 {
   RequireAtLeastOnePassed({ "output" }, false, "no results will be saved");
+  RequireParamValue<double>("beam_width", [](double x) { return x >= 0.0; },
+      true, "beam width must be nonnegative");
+  RequireParamValue<int>("lag", [](int x) { return x >= 0; }, true,
+      "lag must be nonnegative");
 
   IO::GetParam<HMMModel*>("input_model")->PerformAction<Viterbi>((void*) NULL);
 }
@@ -0,0 +1,152 @@
+/**
+ * @file methods/hmm/online_viterbi.hpp
+ *
+ * Definition of OnlineViterbi, a Viterbi decoder for HMMs that takes the
+ * observations a few at a time and can prune unlikely states.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_HMM_ONLINE_VITERBI_HPP
+#define MLPACK_METHODS_HMM_ONLINE_VITERBI_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "hmm.hpp"
+
+#include <deque>
+
+namespace mlpack {
+namespace hmm {
+
+/**
+ * OnlineViterbi finds the most probable hidden state sequence of a sequence of
+ * observations that is given a few observations at a time, with Push().  Two
+ * approximations of the Viterbi algorithm keep the cost bounded:
+ *
+ *  - Beam pruning: at each time step, only the states whose log-probability is
+ *    within the beam width of the best state are considered as the previous
+ *    state of the next step.  With an infinite beam width (the default) the
+ *    search is exact.
+ *
+ *  - Fixed-lag traceback: when the lag is nonzero, the state at time t is
+ *    decided as soon as the observation at time t + lag is pushed, by tracing
+ *    back from the best state at that time.  Only the backpointers of the last
+ *    lag time steps are kept, so the memory used doesn't grow with the length
+ *    of the sequence.  Decided states are never revised, so they may differ
+ *    from the exact Viterbi path if the lag is too short.  With a lag of 0 (the
+ *    default), no state is decided before Flush() is called, and the result is
+ *    the same as HMM::Predict().
+ *
+ * The log-probabilities of the states are renormalized at every step, so
+ * sequences of any length can be decoded.
+ *
+ * @code
+ * extern HMM<GaussianDistribution> hmm;
+ * OnlineViterbi<GaussianDistribution> decoder(hmm, 100);
+ * arma::mat observations;
+ * arma::Row<size_t> states;
+ * while (ReadObservations(observations))
+ * {
+ *   decoder.Push(observations, states);
+ *   // states holds the decided states, if any.
+ * }
+ * decoder.Flush(states);
+ * @endcode
+ *
+ * @tparam Distribution Type of emission distribution of the HMM.
+ */
+template<typename Distribution>
+class OnlineViterbi
+{
+ public:
+  /**
+   * Create the decoder for the given HMM.  The HMM must outlive the decoder,
+   * and its parameters must not change while a sequence is decoded.
+   *
+   * @param hmm HMM to decode with.
+   * @param lag Number of time steps after which a state is decided (0 means
+   *     that states are only decided by Flush()).
+   * @param beamWidth Log-probability difference with the best state beyond
+   *     which states are pruned.
+   */
+  OnlineViterbi(const HMM<Distribution>& hmm,
+                const size_t lag = 0,
+                const double beamWidth =
+                    std::numeric_limits<double>::infinity());
+
+  /**
+   * Add observations to the sequence being decoded.  The states that are
+   * decided, if any, are stored in the given vector (which is overwritten), in
+   * order; they follow the states returned by the previous calls.
+   *
+   * @param observations New observations; each column is an observation.
+   * @param stateSeq Vector to store the newly decided states in.
+   */
+  void Push(const arma::mat& observations, arma::Row<size_t>& stateSeq);
+
+  /**
+   * Decide every state that is not decided yet, by tracing back from the best
+   * state at the last time step, and start a new sequence.
+   *
+   * @param stateSeq Vector to store the remaining states in.
+   */
+  void Flush(arma::Row<size_t>& stateSeq);
+
+  //! Forget the sequence being decoded.
+  void Reset();
+
+  //! Get the log-likelihood of the most probable state sequence so far.
+  double LogLikelihood() const;
+
+  //! Get the number of observations pushed for the current sequence.
+  size_t Steps() const { return steps; }
+  //! Get the number of states of the current sequence decided so far.
+  size_t Decided() const { return decided; }
+
+  //! Get the lag (0 means that states are only decided by Flush()).
+  size_t Lag() const { return lag; }
+  //! Get the beam width.
+  double BeamWidth() const { return beamWidth; }
+
+ private:
+  //! Process one observation, given its log-probability under each state.
+  void Step(const arma::vec& emissionLogProb);
+
+  //! Trace back from the best state at the last time step through the given
+  //! number of stored backpointers, and return the state reached.
+  size_t TraceBack(const size_t count) const;
+
+  //! The HMM.
+  const HMM<Distribution>& hmm;
+  //! The log of the transition matrix of the HMM.
+  arma::mat logTransition;
+  //! The log of the initial state probabilities of the HMM.
+  arma::vec logInitial;
+
+  //! The lag.
+  size_t lag;
+  //! The beam width.
+  double beamWidth;
+
+  //! The log-probability of the best path ending in each state, minus
+  //! logOffset.
+  arma::vec logStateProb;
+  //! The log-probability removed from logStateProb by renormalization.
+  double logOffset;
+  //! The backpointers of the last time steps, oldest first.
+  std::deque<arma::Col<size_t>> backpointers;
+  //! The number of observations pushed.
+  size_t steps;
+  //! The number of states decided.
+  size_t decided;
+};
+
+} // namespace hmm
+} // namespace mlpack
+
+// Include implementation.
+#include "online_viterbi_impl.hpp"
+
+#endif
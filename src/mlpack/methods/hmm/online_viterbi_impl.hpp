@@ -0,0 +1,186 @@
+/**
+ * @file methods/hmm/online_viterbi_impl.hpp
+ *
+ * Implementation of OnlineViterbi.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_HMM_ONLINE_VITERBI_IMPL_HPP
+#define MLPACK_METHODS_HMM_ONLINE_VITERBI_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "online_viterbi.hpp"
+
+namespace mlpack {
+namespace hmm {
+
+template<typename Distribution>
+OnlineViterbi<Distribution>::OnlineViterbi(const HMM<Distribution>& hmm,
+                                           const size_t lag,
+                                           const double beamWidth) :
+    hmm(hmm),
+    logTransition(arma::log(hmm.Transition())),
+    logInitial(arma::log(hmm.Initial())),
+    lag(lag),
+    beamWidth(beamWidth),
+    logOffset(0.0),
+    steps(0),
+    decided(0)
+{
+  if (!(beamWidth >= 0.0))
+  {
+    throw std::invalid_argument("OnlineViterbi::OnlineViterbi(): the beam "
+        "width must be nonnegative");
+  }
+}
+
+template<typename Distribution>
+void OnlineViterbi<Distribution>::Push(const arma::mat& observations,
+                                       arma::Row<size_t>& stateSeq)
+{
+  // Compute the emission log-probabilities of all the new observations at
+  // once.
+  arma::mat emissionLogProb(logTransition.n_rows, observations.n_cols);
+  arma::vec logProbabilities;
+  for (size_t i = 0; i < logTransition.n_rows; ++i)
+  {
+    hmm.Emission()[i].LogProbability(observations, logProbabilities);
+    emissionLogProb.row(i) = logProbabilities.t();
+  }
+
+  stateSeq.set_size(observations.n_cols);
+  size_t count = 0;
+  for (size_t t = 0; t < observations.n_cols; ++t)
+  {
+    Step(emissionLogProb.col(t));
+
+    // The state lag steps ago can now be decided.
+    if (lag > 0 && steps > lag)
+    {
+      stateSeq[count++] = TraceBack(lag);
+      ++decided;
+    }
+  }
+
+  stateSeq.resize(count);
+}
+
+template<typename Distribution>
+void OnlineViterbi<Distribution>::Flush(arma::Row<size_t>& stateSeq)
+{
+  const size_t remaining = steps - decided;
+  stateSeq.set_size(remaining);
+  if (remaining > 0)
+  {
+    arma::uword state;
+    logStateProb.max(state);
+    stateSeq[remaining - 1] = state;
+    for (size_t k = 1; k < remaining; ++k)
+    {
+      stateSeq[remaining - 1 - k] =
+          backpointers[backpointers.size() - k][stateSeq[remaining - k]];
+    }
+  }
+
+  Reset();
+}
+
+template<typename Distribution>
+void OnlineViterbi<Distribution>::Reset()
+{
+  logStateProb.reset();
+  logOffset = 0.0;
+  backpointers.clear();
+  steps = 0;
+  decided = 0;
+}
+
+template<typename Distribution>
+double OnlineViterbi<Distribution>::LogLikelihood() const
+{
+  // The empty sequence is certain.
+  if (steps == 0)
+    return 0.0;
+
+  return logOffset + logStateProb.max();
+}
+
+template<typename Distribution>
+void OnlineViterbi<Distribution>::Step(const arma::vec& emissionLogProb)
+{
+  const size_t states = logTransition.n_rows;
+  arma::Col<size_t> backpointer(states);
+  if (steps == 0)
+  {
+    // The first state has no previous state.
+    logStateProb = logInitial + emissionLogProb;
+    backpointer.zeros();
+  }
+  else
+  {
+    // Only the states within the beam can be previous states.  The best state
+    // has a log-probability of 0, since the column is renormalized.
+    std::vector<size_t> active;
+    active.reserve(states);
+    for (size_t i = 0; i < states; ++i)
+      if (logStateProb[i] >= -beamWidth)
+        active.push_back(i);
+
+    arma::vec nextLogStateProb(states);
+    for (size_t j = 0; j < states; ++j)
+    {
+      double bestLogProb = -std::numeric_limits<double>::infinity();
+      size_t best = active.empty() ? 0 : active[0];
+      for (size_t k = 0; k < active.size(); ++k)
+      {
+        const size_t i = active[k];
+        const double logProb = logStateProb[i] + logTransition(j, i);
+        if (logProb > bestLogProb)
+        {
+          bestLogProb = logProb;
+          best = i;
+        }
+      }
+
+      nextLogStateProb[j] = bestLogProb + emissionLogProb[j];
+      backpointer[j] = best;
+    }
+
+    logStateProb = std::move(nextLogStateProb);
+  }
+
+  // Renormalize, so that the log-probabilities don't underflow on long
+  // sequences.
+  const double maxLogProb = logStateProb.max();
+  if (std::isfinite(maxLogProb))
+  {
+    logStateProb -= maxLogProb;
+    logOffset += maxLogProb;
+  }
+
+  // Only the backpointers of the last lag steps are needed to decide states.
+  backpointers.push_back(std::move(backpointer));
+  if (lag > 0 && backpointers.size() > lag)
+    backpointers.pop_front();
+  ++steps;
+}
+
+template<typename Distribution>
+size_t OnlineViterbi<Distribution>::TraceBack(const size_t count) const
+{
+  arma::uword index;
+  logStateProb.max(index);
+  size_t state = index;
+  for (size_t k = 1; k <= count; ++k)
+    state = backpointers[backpointers.size() - k][state];
+
+  return state;
+}
+
+} // namespace hmm
+} // namespace mlpack
+
+#endif
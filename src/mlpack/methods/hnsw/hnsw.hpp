@@ -0,0 +1,276 @@
+/**
+ * @file methods/hnsw/hnsw.hpp
+ *
+ * Definition of the HNSW class, an approximate nearest neighbor index built on
+ * a hierarchical navigable small world graph, as described in the following
+ * paper:
+ *
+ * @code
+ * @article{malkov2018efficient,
+ *   title={Efficient and robust approximate nearest neighbor search using
+ *       hierarchical navigable small world graphs},
+ *   author={Malkov, Y.A. and Yashunin, D.A.},
+ *   journal={IEEE Transactions on Pattern Analysis and Machine Intelligence},
+ *   volume={42},
+ *   number={4},
+ *   pages={824--836},
+ *   year={2018}
+ * }
+ * @endcode
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_HNSW_HNSW_HPP
+#define MLPACK_METHODS_HNSW_HNSW_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/metrics/lmetric.hpp>
+#include <mutex>
+
+namespace mlpack {
+namespace neighbor {
+
+/**
+ * HNSW is an approximate nearest neighbor index that stores the reference
+ * points in a hierarchy of proximity graphs.  Every point is in the bottom
+ * layer, and each layer above holds a random, exponentially smaller subset of
+ * the points of the layer below.  A search starts at the top layer and walks
+ * greedily towards the query; the closest point found is the starting point
+ * for the next layer, and the bottom layer is searched with a beam of ef
+ * candidates.  A larger ef gives better recall and slower searches.
+ *
+ * The graph is built by inserting the points one at a time, and the insertions
+ * run in parallel when OpenMP is available.  Each point has its own lock that
+ * protects its list of links, so insertions only wait for each other when they
+ * touch the same point.
+ *
+ * Any metric may be used (for instance metric::LMetric or metric::IPMetric);
+ * it only needs an Evaluate() function.  The graph works best for metrics that
+ * satisfy the triangle inequality.
+ *
+ * @tparam MetricType Metric to use for the search.
+ * @tparam MatType Type of the data.
+ */
+template<typename MetricType = metric::EuclideanDistance,
+         typename MatType = arma::mat>
+class HNSW
+{
+ public:
+  /**
+   * Create the HNSW object without a reference set.  Be sure to call Train()
+   * before calling Search().
+   *
+   * @param maxLinks Maximum number of links of a point in each layer above the
+   *     bottom one; points in the bottom layer may have twice as many.
+   * @param efConstruction Size of the beam used to find the neighbors of a
+   *     point when it is inserted.
+   * @param ef Size of the beam used for searches (it is raised to k when it is
+   *     smaller).
+   * @param metric Instantiated metric.
+   */
+  HNSW(const size_t maxLinks = 16,
+       const size_t efConstruction = 200,
+       const size_t ef = 50,
+       const MetricType metric = MetricType());
+
+  /**
+   * Create the HNSW object and build the graph on the given reference set.
+   *
+   * @param referenceSet Set of reference points.
+   * @param maxLinks Maximum number of links of a point in each layer above the
+   *     bottom one; points in the bottom layer may have twice as many.
+   * @param efConstruction Size of the beam used to find the neighbors of a
+   *     point when it is inserted.
+   * @param ef Size of the beam used for searches (it is raised to k when it is
+   *     smaller).
+   * @param metric Instantiated metric.
+   */
+  HNSW(MatType referenceSet,
+       const size_t maxLinks = 16,
+       const size_t efConstruction = 200,
+       const size_t ef = 50,
+       const MetricType metric = MetricType());
+
+  /**
+   * Build the graph on the given reference set.  Any previous graph is
+   * discarded.  Pass an rvalue reference to avoid copying the reference set.
+   *
+   * @param referenceSet Set of reference points.
+   */
+  void Train(MatType referenceSet);
+
+  /**
+   * Search for the approximate k nearest neighbors of each point in the query
+   * set.  The queries are searched in parallel when OpenMP is available.
+   *
+   * @param querySet Set of query points.
+   * @param k Number of neighbors to search for.
+   * @param neighbors Matrix to store the indices of the neighbors in; column i
+   *     holds the neighbors of query i, from the closest.
+   * @param distances Matrix to store the distances in.
+   */
+  void Search(const MatType& querySet,
+              const size_t k,
+              arma::Mat<size_t>& neighbors,
+              arma::mat& distances);
+
+  //! Get the reference set.
+  const MatType& ReferenceSet() const { return referenceSet; }
+
+  //! Get the maximum number of links of a point in the upper layers.
+  size_t MaxLinks() const { return maxLinks; }
+  //! Modify the maximum number of links of a point in the upper layers (this
+  //! takes effect on Train()).
+  size_t& MaxLinks() { return maxLinks; }
+
+  //! Get the size of the beam used when inserting points.
+  size_t EfConstruction() const { return efConstruction; }
+  //! Modify the size of the beam used when inserting points (this takes
+  //! effect on Train()).
+  size_t& EfConstruction() { return efConstruction; }
+
+  //! Get the size of the beam used for searches.
+  size_t Ef() const { return ef; }
+  //! Modify the size of the beam used for searches.
+  size_t& Ef() { return ef; }
+
+  //! Get the number of threads used (0 means that OpenMP decides).
+  size_t NumThreads() const { return numThreads; }
+  //! Modify the number of threads used (0 means that OpenMP decides).
+  size_t& NumThreads() { return numThreads; }
+
+  //! Get the number of layers above the bottom one.
+  size_t MaxLevel() const { return maxLevel; }
+  //! Get the point that searches start from.
+  size_t EntryPoint() const { return entryPoint; }
+  //! Get the highest layer of the given point.
+  size_t Level(const size_t point) const { return links[point].size() - 1; }
+  //! Get the links of the given point in the given layer.
+  const std::vector<size_t>& Links(const size_t point, const size_t level) const
+  { return links[point][level]; }
+
+  //! Get the metric.
+  const MetricType& Metric() const { return metric; }
+  //! Modify the metric.
+  MetricType& Metric() { return metric; }
+
+  //! Serialize the model.
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */);
+
+ private:
+  //! A point and its distance to the point being searched for.
+  typedef std::pair<double, size_t> Candidate;
+
+  /**
+   * Visited marks the points seen by a layer search.  Starting a new search
+   * only increments a counter, so the marks don't need to be cleared.
+   */
+  class Visited
+  {
+   public:
+    Visited(const size_t n) : marks(n, 0), current(0) { }
+
+    //! Start a new search.
+    void Reset() { ++current; }
+    //! Mark the given point, and return whether it was already marked.
+    bool Visit(const size_t point)
+    {
+      if (marks[point] == current)
+        return true;
+      marks[point] = current;
+      return false;
+    }
+
+   private:
+    std::vector<size_t> marks;
+    size_t current;
+  };
+
+  /**
+   * Insert the given point in the graph, in every layer up to its own.
+   *
+   * @param point Index of the point.
+   * @param locks Locks of the links of each point.
+   * @param entryLock Lock of the entry point and the highest level.
+   * @param visited Marks to use for the layer searches.
+   */
+  void Insert(const size_t point,
+              std::vector<std::mutex>& locks,
+              std::mutex& entryLock,
+              Visited& visited);
+
+  /**
+   * Search the given layer with a beam of ef candidates, starting from the
+   * given points.  locks may be NULL if the graph isn't being modified.
+   *
+   * @param query Point to search for.
+   * @param entryPoints Points to start from; they are replaced by the ef
+   *     closest points found, sorted from the closest.
+   * @param ef Size of the beam.
+   * @param level Layer to search.
+   * @param visited Marks to use for the search.
+   * @param locks Locks of the links of each point, or NULL.
+   */
+  template<typename VecType>
+  void SearchLayer(const VecType& query,
+                   std::vector<Candidate>& entryPoints,
+                   const size_t ef,
+                   const size_t level,
+                   Visited& visited,
+                   std::vector<std::mutex>* locks);
+
+  /**
+   * Keep at most the given number of the candidates (sorted from the closest),
+   * preferring candidates that are closer to the point than to the candidates
+   * already kept, so that the links go in diverse directions.
+   */
+  void SelectNeighbors(std::vector<Candidate>& candidates,
+                       const size_t maxCount);
+
+  //! Compute the distance between two reference points.
+  double Distance(const size_t a, const size_t b)
+  {
+    return metric.Evaluate(referenceSet.col(a), referenceSet.col(b));
+  }
+
+  //! Get the maximum number of links of a point in the given layer.
+  size_t MaxLinks(const size_t level) const
+  {
+    return (level == 0) ? 2 * maxLinks : maxLinks;
+  }
+
+  //! Get the number of threads to use.
+  size_t Threads() const;
+
+  //! The reference set.
+  MatType referenceSet;
+  //! The maximum number of links in the upper layers.
+  size_t maxLinks;
+  //! The size of the beam used when inserting points.
+  size_t efConstruction;
+  //! The size of the beam used for searches.
+  size_t ef;
+  //! The number of threads.
+  size_t numThreads;
+  //! The instantiated metric.
+  MetricType metric;
+
+  //! The links of each point in each of its layers.
+  std::vector<std::vector<std::vector<size_t>>> links;
+  //! The point that searches start from.
+  size_t entryPoint;
+  //! The highest layer of the graph.
+  size_t maxLevel;
+};
+
+} // namespace neighbor
+} // namespace mlpack
+
+// Include implementation.
+#include "hnsw_impl.hpp"
+
+#endif
@@ -0,0 +1,365 @@
+/**
+ * @file methods/hnsw/hnsw_impl.hpp
+ *
+ * Implementation of the HNSW class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_HNSW_HNSW_IMPL_HPP
+#define MLPACK_METHODS_HNSW_HNSW_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "hnsw.hpp"
+
+#include <queue>
+
+namespace mlpack {
+namespace neighbor {
+
+template<typename MetricType, typename MatType>
+HNSW<MetricType, MatType>::HNSW(const size_t maxLinks,
+                                const size_t efConstruction,
+                                const size_t ef,
+                                const MetricType metric) :
+    maxLinks(maxLinks),
+    efConstruction(efConstruction),
+    ef(ef),
+    numThreads(0),
+    metric(metric),
+    entryPoint(0),
+    maxLevel(0)
+{
+  // Nothing to do.
+}
+
+template<typename MetricType, typename MatType>
+HNSW<MetricType, MatType>::HNSW(MatType referenceSet,
+                                const size_t maxLinks,
+                                const size_t efConstruction,
+                                const size_t ef,
+                                const MetricType metric) :
+    maxLinks(maxLinks),
+    efConstruction(efConstruction),
+    ef(ef),
+    numThreads(0),
+    metric(metric),
+    entryPoint(0),
+    maxLevel(0)
+{
+  Train(std::move(referenceSet));
+}
+
+template<typename MetricType, typename MatType>
+void HNSW<MetricType, MatType>::Train(MatType referenceSet)
+{
+  if (maxLinks < 2)
+    throw std::invalid_argument("HNSW::Train(): the maximum number of links "
+        "must be at least 2");
+  if (efConstruction == 0)
+    throw std::invalid_argument("HNSW::Train(): efConstruction must be "
+        "positive");
+
+  this->referenceSet = std::move(referenceSet);
+  const size_t n = this->referenceSet.n_cols;
+
+  links.clear();
+  entryPoint = 0;
+  maxLevel = 0;
+  if (n == 0)
+    return;
+
+  // Draw the level of every point in advance, so that the graph doesn't depend
+  // on the order the threads insert the points in.  The number of points in
+  // each layer decreases by a factor of maxLinks.
+  const double levelScale = 1.0 / std::log((double) maxLinks);
+  links.resize(n);
+  for (size_t i = 0; i < n; ++i)
+  {
+    const size_t level = (size_t) std::floor(-std::log(1.0 - math::Random()) *
+        levelScale);
+    links[i].resize(level + 1);
+  }
+
+  // The first point is the entry point of the empty graph.
+  maxLevel = Level(0);
+
+  std::vector<std::mutex> locks(n);
+  std::mutex entryLock;
+
+  #pragma omp parallel num_threads(Threads())
+  {
+    Visited visited(n);
+
+    #pragma omp for schedule(dynamic)
+    for (omp_size_t i = 1; i < (omp_size_t) n; ++i)
+      Insert((size_t) i, locks, entryLock, visited);
+  }
+}
+
+template<typename MetricType, typename MatType>
+void HNSW<MetricType, MatType>::Search(const MatType& querySet,
+                                       const size_t k,
+                                       arma::Mat<size_t>& neighbors,
+                                       arma::mat& distances)
+{
+  const size_t n = referenceSet.n_cols;
+  if (k > n)
+    Log::Fatal << "HNSW::Search(): requested " << k << " neighbors, but the "
+        << "reference set only has " << n << " points!" << std::endl;
+  if (querySet.n_rows != referenceSet.n_rows)
+    Log::Fatal << "HNSW::Search(): dimensionality of query set ("
+        << querySet.n_rows << ") is not equal to the dimensionality of the "
+        << "reference set (" << referenceSet.n_rows << ")!" << std::endl;
+
+  neighbors.set_size(k, querySet.n_cols);
+  distances.set_size(k, querySet.n_cols);
+  if (k == 0)
+    return;
+
+  const size_t searchEf = std::max(ef, k);
+
+  #pragma omp parallel num_threads(Threads())
+  {
+    Visited visited(n);
+    std::vector<Candidate> closest;
+
+    #pragma omp for schedule(dynamic)
+    for (omp_size_t i = 0; i < (omp_size_t) querySet.n_cols; ++i)
+    {
+      // Walk down the upper layers greedily, then search the bottom one with
+      // the full beam.
+      closest.assign(1, Candidate(metric.Evaluate(querySet.col(i),
+          referenceSet.col(entryPoint)), entryPoint));
+      for (size_t level = maxLevel; level > 0; --level)
+        SearchLayer(querySet.col(i), closest, 1, level, visited, NULL);
+      SearchLayer(querySet.col(i), closest, searchEf, 0, visited, NULL);
+
+      // If the graph is disconnected fewer than k points may be found; the
+      // remaining neighbors are marked as invalid.
+      for (size_t j = 0; j < k; ++j)
+      {
+        if (j < closest.size())
+        {
+          neighbors(j, i) = closest[j].second;
+          distances(j, i) = closest[j].first;
+        }
+        else
+        {
+          neighbors(j, i) = n;
+          distances(j, i) = DBL_MAX;
+        }
+      }
+    }
+  }
+}
+
+template<typename MetricType, typename MatType>
+template<typename Archive>
+void HNSW<MetricType, MatType>::serialize(Archive& ar,
+                                          const unsigned int /* version */)
+{
+  ar & BOOST_SERIALIZATION_NVP(referenceSet);
+  ar & BOOST_SERIALIZATION_NVP(maxLinks);
+  ar & BOOST_SERIALIZATION_NVP(efConstruction);
+  ar & BOOST_SERIALIZATION_NVP(ef);
+  ar & BOOST_SERIALIZATION_NVP(metric);
+  ar & BOOST_SERIALIZATION_NVP(links);
+  ar & BOOST_SERIALIZATION_NVP(entryPoint);
+  ar & BOOST_SERIALIZATION_NVP(maxLevel);
+}
+
+template<typename MetricType, typename MatType>
+void HNSW<MetricType, MatType>::Insert(const size_t point,
+                                       std::vector<std::mutex>& locks,
+                                       std::mutex& entryLock,
+                                       Visited& visited)
+{
+  const size_t level = Level(point);
+
+  size_t currentEntry, currentMaxLevel;
+  {
+    std::lock_guard<std::mutex> lock(entryLock);
+    currentEntry = entryPoint;
+    currentMaxLevel = maxLevel;
+  }
+
+  // Walk down the layers above the level of the point greedily.
+  std::vector<Candidate> closest(1, Candidate(Distance(point, currentEntry),
+      currentEntry));
+  for (size_t l = currentMaxLevel; l > level; --l)
+    SearchLayer(referenceSet.col(point), closest, 1, l, visited, &locks);
+
+  // Link the point in each of its layers that already exist.
+  std::vector<Candidate> selected;
+  for (size_t l = std::min(level, currentMaxLevel) + 1; l-- > 0; )
+  {
+    SearchLayer(referenceSet.col(point), closest, efConstruction, l, visited,
+        &locks);
+
+    selected = closest;
+    SelectNeighbors(selected, maxLinks);
+    {
+      std::lock_guard<std::mutex> lock(locks[point]);
+      links[point][l].resize(selected.size());
+      for (size_t j = 0; j < selected.size(); ++j)
+        links[point][l][j] = selected[j].second;
+    }
+
+    // Add the reverse links, and prune the links of the neighbors that have
+    // too many.
+    for (size_t j = 0; j < selected.size(); ++j)
+    {
+      const size_t neighbor = selected[j].second;
+      std::lock_guard<std::mutex> lock(locks[neighbor]);
+      std::vector<size_t>& neighborLinks = links[neighbor][l];
+      neighborLinks.push_back(point);
+      if (neighborLinks.size() <= MaxLinks(l))
+        continue;
+
+      std::vector<Candidate> candidates(neighborLinks.size());
+      for (size_t c = 0; c < neighborLinks.size(); ++c)
+      {
+        candidates[c] = Candidate(Distance(neighbor, neighborLinks[c]),
+            neighborLinks[c]);
+      }
+      std::sort(candidates.begin(), candidates.end());
+      SelectNeighbors(candidates, MaxLinks(l));
+
+      neighborLinks.resize(candidates.size());
+      for (size_t c = 0; c < candidates.size(); ++c)
+        neighborLinks[c] = candidates[c].second;
+    }
+  }
+
+  // A point above the top layer becomes the new entry point.
+  if (level > currentMaxLevel)
+  {
+    std::lock_guard<std::mutex> lock(entryLock);
+    if (level > maxLevel)
+    {
+      maxLevel = level;
+      entryPoint = point;
+    }
+  }
+}
+
+template<typename MetricType, typename MatType>
+template<typename VecType>
+void HNSW<MetricType, MatType>::SearchLayer(
+    const VecType& query,
+    std::vector<Candidate>& entryPoints,
+    const size_t ef,
+    const size_t level,
+    Visited& visited,
+    std::vector<std::mutex>* locks)
+{
+  // The closest candidate left to expand is on top of the first heap, and the
+  // furthest of the ef closest points found on top of the second.
+  std::priority_queue<Candidate, std::vector<Candidate>,
+      std::greater<Candidate>> candidates;
+  std::priority_queue<Candidate> results;
+
+  visited.Reset();
+  for (size_t i = 0; i < entryPoints.size(); ++i)
+  {
+    visited.Visit(entryPoints[i].second);
+    candidates.push(entryPoints[i]);
+    results.push(entryPoints[i]);
+    if (results.size() > ef)
+      results.pop();
+  }
+
+  std::vector<size_t> linksCopy;
+  while (!candidates.empty())
+  {
+    const Candidate current = candidates.top();
+    if (current.first > results.top().first)
+      break;
+    candidates.pop();
+
+    // While the graph is being built, the links may change under us.
+    const std::vector<size_t>* currentLinks = &links[current.second][level];
+    if (locks)
+    {
+      std::lock_guard<std::mutex> lock((*locks)[current.second]);
+      linksCopy = *currentLinks;
+      currentLinks = &linksCopy;
+    }
+
+    for (size_t i = 0; i < currentLinks->size(); ++i)
+    {
+      const size_t point = (*currentLinks)[i];
+      if (visited.Visit(point))
+        continue;
+
+      const double distance = metric.Evaluate(query, referenceSet.col(point));
+      if (results.size() < ef || distance < results.top().first)
+      {
+        candidates.push(Candidate(distance, point));
+        results.push(Candidate(distance, point));
+        if (results.size() > ef)
+          results.pop();
+      }
+    }
+  }
+
+  entryPoints.resize(results.size());
+  for (size_t i = results.size(); i > 0; --i)
+  {
+    entryPoints[i - 1] = results.top();
+    results.pop();
+  }
+}
+
+template<typename MetricType, typename MatType>
+void HNSW<MetricType, MatType>::SelectNeighbors(
+    std::vector<Candidate>& candidates,
+    const size_t maxCount)
+{
+  if (candidates.size() <= maxCount)
+    return;
+
+  // A candidate is kept if it is closer to the point than to every candidate
+  // kept before it; the others only fill the remaining slots, so that no point
+  // loses all its links.
+  std::vector<Candidate> selected, pruned;
+  selected.reserve(maxCount);
+  for (size_t i = 0; i < candidates.size() && selected.size() < maxCount; ++i)
+  {
+    bool keep = true;
+    for (size_t j = 0; j < selected.size(); ++j)
+    {
+      if (Distance(candidates[i].second, selected[j].second) <
+          candidates[i].first)
+      {
+        keep = false;
+        break;
+      }
+    }
+
+    if (keep)
+      selected.push_back(candidates[i]);
+    else
+      pruned.push_back(candidates[i]);
+  }
+
+  for (size_t i = 0; i < pruned.size() && selected.size() < maxCount; ++i)
+    selected.push_back(pruned[i]);
+  std::sort(selected.begin(), selected.end());
+
+  candidates.swap(selected);
+}
+
+template<typename MetricType, typename MatType>
+size_t HNSW<MetricType, MatType>::Threads() const
+{
+  return util::Threads(numThreads);
+}
+
+} // namespace neighbor
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,107 @@
+/**
+ * @file methods/hoeffding_trees/atomic_prediction.hpp
+ *
+ * Definition of the AtomicPrediction class, which holds the prediction of a
+ * HoeffdingTree leaf so that it can be read while the leaf is trained.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_HOEFFDING_TREES_ATOMIC_PREDICTION_HPP
+#define MLPACK_METHODS_HOEFFDING_TREES_ATOMIC_PREDICTION_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include <atomic>
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * AtomicPrediction holds a predicted class and its probability, which one
+ * thread may update while any number of threads read them.  The pair is
+ * protected by a sequence lock: readers never wait for a lock and never see
+ * the class of one update with the probability of another, but they retry if
+ * an update happens while they read.
+ */
+class AtomicPrediction
+{
+ public:
+  //! Create the prediction with the given class and probability.
+  AtomicPrediction(const size_t prediction = 0,
+                   const double probability = 0.0) :
+      version(0),
+      prediction(prediction),
+      probability(probability)
+  { /* Nothing to do. */ }
+
+  //! Copy the given prediction.
+  AtomicPrediction(const AtomicPrediction& other) : version(0)
+  {
+    size_t otherPrediction;
+    double otherProbability;
+    other.Load(otherPrediction, otherProbability);
+    prediction.store(otherPrediction, std::memory_order_relaxed);
+    probability.store(otherProbability, std::memory_order_relaxed);
+  }
+
+  //! Copy the given prediction.
+  AtomicPrediction& operator=(const AtomicPrediction& other)
+  {
+    size_t otherPrediction;
+    double otherProbability;
+    other.Load(otherPrediction, otherProbability);
+    Store(otherPrediction, otherProbability);
+    return *this;
+  }
+
+  /**
+   * Set the class and probability.  Only one thread may call Store() at a
+   * time.
+   */
+  void Store(const size_t prediction, const double probability)
+  {
+    const size_t oldVersion = version.load(std::memory_order_relaxed);
+    version.store(oldVersion + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    this->prediction.store(prediction, std::memory_order_relaxed);
+    this->probability.store(probability, std::memory_order_relaxed);
+    version.store(oldVersion + 2, std::memory_order_release);
+  }
+
+  //! Get the class and probability of the same update.
+  void Load(size_t& prediction, double& probability) const
+  {
+    size_t before, after;
+    do
+    {
+      before = version.load(std::memory_order_acquire);
+      prediction = this->prediction.load(std::memory_order_relaxed);
+      probability = this->probability.load(std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_acquire);
+      after = version.load(std::memory_order_relaxed);
+    } while ((before % 2 == 1) || (before != after));
+  }
+
+  //! Get the class.
+  size_t Prediction() const
+  {
+    return prediction.load(std::memory_order_acquire);
+  }
+
+ private:
+  //! Incremented before and after each update, so it is odd while an update
+  //! is in progress.
+  std::atomic<size_t> version;
+  //! The predicted class.
+  std::atomic<size_t> prediction;
+  //! The probability of the predicted class.
+  std::atomic<double> probability;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,138 @@
+/**
+ * @file methods/hoeffding_trees/concurrent_hoeffding_trainer.hpp
+ *
+ * Definition of the ConcurrentHoeffdingTrainer class, which lets several
+ * threads feed training points to one HoeffdingTree.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_HOEFFDING_TREES_CONCURRENT_HOEFFDING_TRAINER_HPP
+#define MLPACK_METHODS_HOEFFDING_TREES_CONCURRENT_HOEFFDING_TRAINER_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "hoeffding_tree.hpp"
+
+#include <mutex>
+#include <thread>
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * The ConcurrentHoeffdingTrainer lets any number of producer threads train one
+ * HoeffdingTree in streaming mode at the same time.  The points given to
+ * Train() are appended to one of several buffers (shards), chosen from the
+ * calling thread, each protected by its own lock, so producers on different
+ * shards never wait for each other.  When a shard holds BatchSize() points, the
+ * producer that filled it takes the whole batch and trains the tree on it with
+ * HoeffdingTree::Train(data, labels, false), which updates the leaves in
+ * parallel; only these batch updates are serialized.
+ *
+ * Points given by one thread reach the tree in the order they were given, but
+ * the points of different threads may be interleaved in any way.  Points that
+ * are still buffered are not seen by the tree until their shard is full or
+ * Flush() is called.  While producers are training the tree, other threads may
+ * call its Classify() functions (see HoeffdingTree), but must not otherwise use
+ * it.
+ *
+ * @code
+ * extern HoeffdingTree<> tree;
+ * ConcurrentHoeffdingTrainer<HoeffdingTree<>> trainer(tree);
+ *
+ * // From any number of threads:
+ * extern arma::vec point;
+ * extern size_t label;
+ * trainer.Train(point, label);
+ *
+ * // Once all producers are done:
+ * trainer.Flush();
+ * @endcode
+ *
+ * @tparam TreeType Type of HoeffdingTree to train.
+ */
+template<typename TreeType>
+class ConcurrentHoeffdingTrainer
+{
+ public:
+  /**
+   * Create a trainer for the given tree.  The tree must outlive the trainer.
+   *
+   * @param tree Tree to train.
+   * @param batchSize Number of points a shard collects before they are given
+   *      to the tree.
+   * @param numShards Number of shards; 0 means one per hardware thread.
+   */
+  ConcurrentHoeffdingTrainer(TreeType& tree,
+                             const size_t batchSize = 1024,
+                             const size_t numShards = 0);
+
+  //! Give the remaining buffered points to the tree.
+  ~ConcurrentHoeffdingTrainer() { Flush(); }
+
+  /**
+   * Train on the given point.  This may be called from several threads at
+   * once.
+   *
+   * @param point Point to train on.
+   * @param label Label of the point.
+   */
+  template<typename VecType>
+  void Train(const VecType& point, const size_t label);
+
+  /**
+   * Train on the given points, after the points already buffered for the
+   * calling thread.  This may be called from several threads at once.
+   *
+   * @param data Points to train on.
+   * @param labels Labels of the points.
+   */
+  template<typename MatType>
+  void Train(const MatType& data, const arma::Row<size_t>& labels);
+
+  //! Give all the buffered points to the tree.
+  void Flush();
+
+  //! Get the number of points that are buffered but not yet seen by the tree.
+  size_t Buffered();
+
+  //! Get the number of points each shard collects before training the tree.
+  size_t BatchSize() const { return batchSize; }
+  //! Get the number of shards.
+  size_t NumShards() const { return numShards; }
+
+ private:
+  //! Get the shard of the calling thread.
+  size_t Shard() const;
+
+  //! Take the buffered points of the given shard and train the tree on them.
+  void FlushShard(const size_t shard);
+
+  //! The tree being trained.
+  TreeType& tree;
+  //! The number of points each shard collects.
+  size_t batchSize;
+  //! The number of shards.
+  size_t numShards;
+
+  //! The lock of each shard.
+  std::vector<std::mutex> shardLocks;
+  //! The buffered points of each shard (one per column).
+  std::vector<arma::mat> shardPoints;
+  //! The labels of the buffered points of each shard.
+  std::vector<arma::Row<size_t>> shardLabels;
+  //! The number of buffered points of each shard.
+  std::vector<size_t> shardCounts;
+  //! The lock held while the tree is trained.
+  std::mutex treeLock;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+// Include implementation.
+#include "concurrent_hoeffding_trainer_impl.hpp"
+
+#endif
@@ -0,0 +1,151 @@
+/**
+ * @file methods/hoeffding_trees/concurrent_hoeffding_trainer_impl.hpp
+ *
+ * Implementation of the ConcurrentHoeffdingTrainer class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_HOEFFDING_TREES_CONCURRENT_HOEFFDING_TRAINER_IMPL_HPP
+#define MLPACK_METHODS_HOEFFDING_TREES_CONCURRENT_HOEFFDING_TRAINER_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "concurrent_hoeffding_trainer.hpp"
+
+namespace mlpack {
+namespace tree {
+
+template<typename TreeType>
+ConcurrentHoeffdingTrainer<TreeType>::ConcurrentHoeffdingTrainer(
+    TreeType& tree,
+    const size_t batchSize,
+    const size_t numShards) :
+    tree(tree),
+    batchSize(batchSize),
+    numShards(numShards > 0 ? numShards :
+        std::max((size_t) std::thread::hardware_concurrency(), (size_t) 1)),
+    shardLocks(this->numShards),
+    shardPoints(this->numShards),
+    shardLabels(this->numShards),
+    shardCounts(this->numShards, 0)
+{
+  if (batchSize == 0)
+  {
+    throw std::invalid_argument("ConcurrentHoeffdingTrainer: the batch size "
+        "must be positive");
+  }
+}
+
+template<typename TreeType>
+template<typename VecType>
+void ConcurrentHoeffdingTrainer<TreeType>::Train(const VecType& point,
+                                                 const size_t label)
+{
+  const size_t shard = Shard();
+  arma::mat batch;
+  arma::Row<size_t> batchLabels;
+  {
+    std::lock_guard<std::mutex> lock(shardLocks[shard]);
+    if (shardCounts[shard] == 0)
+    {
+      shardPoints[shard].set_size(point.n_elem, batchSize);
+      shardLabels[shard].set_size(batchSize);
+    }
+    else if (point.n_elem != shardPoints[shard].n_rows)
+    {
+      std::ostringstream oss;
+      oss << "ConcurrentHoeffdingTrainer::Train(): point has " << point.n_elem
+          << " dimensions, but previous points have "
+          << shardPoints[shard].n_rows << "!";
+      throw std::invalid_argument(oss.str());
+    }
+
+    shardPoints[shard].col(shardCounts[shard]) = point;
+    shardLabels[shard][shardCounts[shard]] = label;
+    if (++shardCounts[shard] < batchSize)
+      return;
+
+    // The shard is full; take its points, so that other producers can use the
+    // shard while the tree is trained.
+    batch = std::move(shardPoints[shard]);
+    batchLabels = std::move(shardLabels[shard]);
+    shardCounts[shard] = 0;
+  }
+
+  std::lock_guard<std::mutex> lock(treeLock);
+  tree.Train(batch, batchLabels, false);
+}
+
+template<typename TreeType>
+template<typename MatType>
+void ConcurrentHoeffdingTrainer<TreeType>::Train(
+    const MatType& data,
+    const arma::Row<size_t>& labels)
+{
+  if (data.n_cols != labels.n_elem)
+  {
+    std::ostringstream oss;
+    oss << "ConcurrentHoeffdingTrainer::Train(): number of points ("
+        << data.n_cols << ") does not match number of labels ("
+        << labels.n_elem << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  // The points buffered by this thread must reach the tree first.
+  FlushShard(Shard());
+
+  std::lock_guard<std::mutex> lock(treeLock);
+  tree.Train(data, labels, false);
+}
+
+template<typename TreeType>
+void ConcurrentHoeffdingTrainer<TreeType>::Flush()
+{
+  for (size_t shard = 0; shard < numShards; ++shard)
+    FlushShard(shard);
+}
+
+template<typename TreeType>
+size_t ConcurrentHoeffdingTrainer<TreeType>::Buffered()
+{
+  size_t buffered = 0;
+  for (size_t shard = 0; shard < numShards; ++shard)
+  {
+    std::lock_guard<std::mutex> lock(shardLocks[shard]);
+    buffered += shardCounts[shard];
+  }
+
+  return buffered;
+}
+
+template<typename TreeType>
+size_t ConcurrentHoeffdingTrainer<TreeType>::Shard() const
+{
+  return std::hash<std::thread::id>()(std::this_thread::get_id()) % numShards;
+}
+
+template<typename TreeType>
+void ConcurrentHoeffdingTrainer<TreeType>::FlushShard(const size_t shard)
+{
+  arma::mat batch;
+  arma::Row<size_t> batchLabels;
+  {
+    std::lock_guard<std::mutex> lock(shardLocks[shard]);
+    if (shardCounts[shard] == 0)
+      return;
+
+    batch = shardPoints[shard].cols(0, shardCounts[shard] - 1);
+    batchLabels = shardLabels[shard].cols(0, shardCounts[shard] - 1);
+    shardCounts[shard] = 0;
+  }
+
+  std::lock_guard<std::mutex> lock(treeLock);
+  tree.Train(batch, batchLabels, false);
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
@@ -18,6 +18,7 @@
 #include "gini_impurity.hpp"
 #include "hoeffding_numeric_split.hpp"
 #include "hoeffding_categorical_split.hpp"
+#include "atomic_prediction.hpp"
 
 namespace mlpack {
 namespace tree {
@@ -48,6 +49,17 @@ namespace tree {
  * categorical attributes are handled.  As far as the actual splitting goes,
  * the meat of the splitting procedure will be contained in those two classes.
  *
+ * The Classify() functions may be called by any number of threads while one
+ * thread trains the tree with Train(data, labels, batchTraining) or
+ * Train(point, label), so that a model can serve predictions while it keeps
+ * learning from a stream.  (Other functions, including the accessors below
+ * and the Train() overload that takes a DatasetInfo, must not run at the same
+ * time as training.)  Each leaf publishes its prediction atomically after each
+ * point, and a split creates the children of a leaf completely before it
+ * publishes them, so a reader either reaches the leaf or its finished
+ * children; nodes are never deleted by these Train() overloads, so readers
+ * never need to wait.
+ *
  * @tparam FitnessFunction Fitness function to use.
  * @tparam NumericSplitType Technique for splitting numeric features.
  * @tparam CategoricalSplitType Technique for splitting categorical features.
@@ -164,6 +176,11 @@ class HoeffdingTree
    * Train on a set of points, either in streaming mode or in batch mode, with
    * the given labels.
    *
+   * In streaming mode the points are first routed to the leaves they reach,
+   * and then the leaves are trained in parallel (with OpenMP), each one on its
+   * points in order.  The result is the same as when the points are passed to
+   * Train(point, label) one at a time.
+   *
    * @param data Data points to train on.
    * @param labels Labels of data points.
    * @param batchTraining If true, perform training in batch.
@@ -204,12 +221,14 @@ class HoeffdingTree
 
   //! Get the majority class.
   size_t MajorityClass() const { return majorityClass; }
-  //! Modify the majority class.
+  //! Modify the majority class (Classify() sees the change once this leaf
+  //! trains on its next point).
   size_t& MajorityClass() { return majorityClass; }
 
   //! Get the probability of the majority class (based on training samples).
   double MajorityProbability() const { return majorityProbability; }
-  //! Modify the probability of the majority class.
+  //! Modify the probability of the majority class (Classify() sees the change
+  //! once this leaf trains on its next point).
   double& MajorityProbability() { return majorityProbability; }
 
   //! Get the number of children.
@@ -314,6 +333,21 @@ class HoeffdingTree
   void serialize(Archive& ar, const unsigned int /* version */);
 
  private:
+  /**
+   * Find the leaf each of the given points reaches.  The leaves are stored in
+   * the order they are first reached, and leafPoints[i] holds the indices of
+   * the points that reach leaves[i], in increasing order.
+   *
+   * @param data Points to route.
+   * @param leaves Vector to store the reached leaves in.
+   * @param leafPoints Vector to store the indices of the points of each leaf
+   *      in.
+   */
+  template<typename MatType>
+  void RouteToLeaves(const MatType& data,
+                     std::vector<HoeffdingTree*>& leaves,
+                     std::vector<std::vector<size_t>>& leafPoints);
+
   // We need to keep some information for before we have split.
 
   //! Information for splitting of numeric features (used before split).
@@ -358,6 +392,12 @@ class HoeffdingTree
   typename NumericSplitType<FitnessFunction>::SplitInfo numericSplit;
   //! If the split has occurred, these are the children.
   std::vector<HoeffdingTree*> children;
+
+  //! The majority class and its probability, as seen by Classify().
+  AtomicPrediction publishedPrediction;
+  //! Whether Classify() should follow the children; set only once they are
+  //! complete.
+  std::atomic<bool> publishedSplit;
 };
 
 } // namespace tree
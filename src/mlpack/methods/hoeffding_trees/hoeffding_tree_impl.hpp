@@ -54,7 +54,8 @@ HoeffdingTree<
     majorityClass(0),
     majorityProbability(0.0),
     categoricalSplit(0),
-    numericSplit()
+    numericSplit(),
+    publishedSplit(false)
 {
   // Generate dimension mappings and create split objects.
   for (size_t i = 0; i < datasetInfo.Dimensionality(); ++i)
@@ -114,7 +115,8 @@ HoeffdingTree<
     majorityClass(0),
     majorityProbability(0.0),
     categoricalSplit(0),
-    numericSplit()
+    numericSplit(),
+    publishedSplit(false)
 {
   // Do we need to generate the mappings too?
   if (ownsMappings)
@@ -178,7 +180,8 @@ HoeffdingTree<
     majorityClass(0),
     majorityProbability(0.0),
     categoricalSplit(0),
-    numericSplit()
+    numericSplit(),
+    publishedSplit(false)
 {
   // Nothing to do.
 }
@@ -206,7 +209,9 @@ HoeffdingTree<FitnessFunction, NumericSplitType, CategoricalSplitType>::
     majorityClass(other.majorityClass),
     majorityProbability(other.majorityProbability),
     categoricalSplit(other.categoricalSplit),
-    numericSplit(other.numericSplit)
+    numericSplit(other.numericSplit),
+    publishedPrediction(other.publishedPrediction),
+    publishedSplit(other.publishedSplit.load())
 {
   // Copy each of the children.
   for (size_t i = 0; i < other.children.size(); ++i)
@@ -310,9 +315,61 @@ void HoeffdingTree<
   }
   else
   {
-    // We aren't training in batch mode; loop through the points.
-    for (size_t i = 0; i < data.n_cols; ++i)
-      Train(data.col(i), labels[i]);
+    // We aren't training in batch mode.  A point only changes the leaf it
+    // reaches (and the subtree that leaf grows into), so we can route all the
+    // points to the current leaves first and then train each leaf on its
+    // points in order: the leaves are independent, so they are trained in
+    // parallel, and the tree is the same as if the points were given one by
+    // one.
+    std::vector<HoeffdingTree*> leaves;
+    std::vector<std::vector<size_t>> leafPoints;
+    RouteToLeaves(data, leaves, leafPoints);
+
+    #pragma omp parallel for schedule(dynamic)
+    for (omp_size_t i = 0; i < (omp_size_t) leaves.size(); ++i)
+    {
+      for (size_t j = 0; j < leafPoints[i].size(); ++j)
+      {
+        const size_t point = leafPoints[i][j];
+        leaves[i]->Train(data.col(point), labels[point]);
+      }
+    }
+  }
+}
+
+//! Route points to the leaves they reach.
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType>
+template<typename MatType>
+void HoeffdingTree<
+    FitnessFunction,
+    NumericSplitType,
+    CategoricalSplitType
+>::RouteToLeaves(const MatType& data,
+                 std::vector<HoeffdingTree*>& leaves,
+                 std::vector<std::vector<size_t>>& leafPoints)
+{
+  leaves.clear();
+  leafPoints.clear();
+
+  std::unordered_map<HoeffdingTree*, size_t> leafIndices;
+  for (size_t i = 0; i < data.n_cols; ++i)
+  {
+    HoeffdingTree* node = this;
+    while (node->splitDimension != size_t(-1))
+      node = node->children[node->CalculateDirection(data.col(i))];
+
+    std::unordered_map<HoeffdingTree*, size_t>::iterator it =
+        leafIndices.find(node);
+    if (it == leafIndices.end())
+    {
+      it = leafIndices.insert(std::make_pair(node, leaves.size())).first;
+      leaves.push_back(node);
+      leafPoints.push_back(std::vector<size_t>());
+    }
+
+    leafPoints[it->second].push_back(i);
   }
 }
 
@@ -364,6 +421,7 @@ void HoeffdingTree<
   }
 
   // Remove any old children.
+  publishedSplit = false;
   for (size_t i = 0; i < children.size(); ++i)
     delete children[i];
   children.clear();
@@ -407,6 +465,7 @@ void HoeffdingTree<
       majorityClass = numericSplits[0].MajorityClass();
       majorityProbability = numericSplits[0].MajorityProbability();
     }
+    publishedPrediction.Store(majorityClass, majorityProbability);
 
     // Check for a split, if we should.
     if (numSamples % checkInterval == 0)
@@ -638,11 +697,11 @@ size_t HoeffdingTree<
     CategoricalSplitType
 >::Classify(const VecType& point) const
 {
-  if (children.size() == 0)
+  if (!publishedSplit.load(std::memory_order_acquire))
   {
     // If we're a leaf (or being considered a leaf), classify based on what we
     // know.
-    return majorityClass;
+    return publishedPrediction.Prediction();
   }
   else
   {
@@ -665,11 +724,10 @@ void HoeffdingTree<
             size_t& prediction,
             double& probability) const
 {
-  if (children.size() == 0)
+  if (!publishedSplit.load(std::memory_order_acquire))
   {
     // We are a leaf, so classify accordingly.
-    prediction = majorityClass;
-    probability = majorityProbability;
+    publishedPrediction.Load(prediction, probability);
   }
   else
   {
@@ -776,8 +834,13 @@ void HoeffdingTree<
     }
 
     children[i]->MajorityClass() = childMajorities[i];
+    children[i]->publishedPrediction.Store(childMajorities[i],
+        children[i]->majorityProbability);
   }
 
+  // The children are complete, so readers may now use them.
+  publishedSplit.store(true, std::memory_order_release);
+
   // Eliminate now-unnecessary split information.
   numericSplits.clear();
   categoricalSplits.clear();
@@ -818,6 +881,7 @@ void HoeffdingTree<
     ownsMappings = true; // We also own the mappings we loaded.
 
     // Clear the children.
+    publishedSplit = false;
     for (size_t i = 0; i < children.size(); ++i)
       delete children[i];
     children.clear();
@@ -825,6 +889,8 @@ void HoeffdingTree<
 
   ar & BOOST_SERIALIZATION_NVP(majorityClass);
   ar & BOOST_SERIALIZATION_NVP(majorityProbability);
+  if (Archive::is_loading::value)
+    publishedPrediction.Store(majorityClass, majorityProbability);
 
   // Depending on whether or not we have split yet, we may need to save
   // different things.
@@ -891,6 +957,7 @@ void HoeffdingTree<
           children[i]->ownsInfo = false;
         children[i]->ownsMappings = false;
       }
+      publishedSplit = !children.empty();
 
       numericSplits.clear();
       categoricalSplits.clear();
@@ -125,7 +125,8 @@ class HoeffdingTreeModel
 
   /**
    * Train in streaming mode on the given dataset.  This takes one pass.  Be
-   * sure that BuildModel() has been called first!
+   * sure that BuildModel() has been called first!  Other threads may call
+   * Classify() while the model is trained.
    *
    * @param dataset Dataset to train on.
    * @param labels Labels for training set.
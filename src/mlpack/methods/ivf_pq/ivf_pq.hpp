@@ -0,0 +1,232 @@
+/**
+ * @file methods/ivf_pq/ivf_pq.hpp
+ *
+ * Definition of the IVFPQ class, an approximate nearest neighbor index that
+ * combines an inverted file over a coarse k-means quantizer with product
+ * quantization of the residuals, as described in the following paper:
+ *
+ * @code
+ * @article{jegou2011product,
+ *   title={Product quantization for nearest neighbor search},
+ *   author={J{\'e}gou, H. and Douze, M. and Schmid, C.},
+ *   journal={IEEE Transactions on Pattern Analysis and Machine Intelligence},
+ *   volume={33},
+ *   number={1},
+ *   pages={117--128},
+ *   year={2011}
+ * }
+ * @endcode
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_IVF_PQ_IVF_PQ_HPP
+#define MLPACK_METHODS_IVF_PQ_IVF_PQ_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/methods/kmeans/kmeans.hpp>
+
+namespace mlpack {
+namespace neighbor {
+
+/**
+ * IVFPQ is an approximate nearest neighbor index for large datasets that don't
+ * fit in memory as they are.  Training works in two steps:
+ *
+ *  - A coarse quantizer is trained with k-means; each reference point is put
+ *    in the inverted list of its closest coarse centroid.
+ *
+ *  - The residual of each point (the point minus its coarse centroid) is split
+ *    into numSubspaces subvectors of equal dimensionality, and every subvector
+ *    is quantized with its own k-means codebook of at most 256 codewords.  A
+ *    point is then stored as numSubspaces bytes.
+ *
+ * The original points are not kept.  To search, the query is compared with
+ * the coarse centroids, and only the numProbes closest inverted lists are
+ * scanned; the distance to each point in those lists is approximated with one
+ * table lookup per subspace (asymmetric distance computation).  The returned
+ * distances are these Euclidean distance approximations.
+ *
+ * The codebooks may be trained on a random sample of the reference set, which
+ * keeps training affordable for very large datasets.
+ *
+ * @tparam MatType Type of the data (arma::mat or arma::fmat).
+ */
+template<typename MatType = arma::mat>
+class IVFPQ
+{
+ public:
+  //! The type of the elements of the data.
+  typedef typename MatType::elem_type ElemType;
+
+  /**
+   * Create the IVFPQ object with the given parameters, but do not train it.
+   * Be sure to call Train() before calling Search().
+   *
+   * @param numLists Number of coarse centroids (inverted lists).
+   * @param numSubspaces Number of subspaces of the product quantizer; the
+   *     dimensionality of the data must be a multiple of it.
+   * @param codebookSize Number of codewords of each subspace (at most 256).
+   * @param numProbes Number of inverted lists to scan for each query.
+   * @param trainingSamples Number of points to train the quantizers on (0
+   *     means the whole reference set).
+   * @param maxIterations Maximum number of k-means iterations.
+   */
+  IVFPQ(const size_t numLists = 256,
+        const size_t numSubspaces = 8,
+        const size_t codebookSize = 256,
+        const size_t numProbes = 8,
+        const size_t trainingSamples = 0,
+        const size_t maxIterations = 100);
+
+  /**
+   * Create the IVFPQ object and train it on the given reference set.
+   *
+   * @param referenceSet Set of reference points.
+   * @param numLists Number of coarse centroids (inverted lists).
+   * @param numSubspaces Number of subspaces of the product quantizer; the
+   *     dimensionality of the data must be a multiple of it.
+   * @param codebookSize Number of codewords of each subspace (at most 256).
+   * @param numProbes Number of inverted lists to scan for each query.
+   * @param trainingSamples Number of points to train the quantizers on (0
+   *     means the whole reference set).
+   * @param maxIterations Maximum number of k-means iterations.
+   */
+  IVFPQ(const MatType& referenceSet,
+        const size_t numLists = 256,
+        const size_t numSubspaces = 8,
+        const size_t codebookSize = 256,
+        const size_t numProbes = 8,
+        const size_t trainingSamples = 0,
+        const size_t maxIterations = 100);
+
+  /**
+   * Train the quantizers on the given reference set and encode it.  Any
+   * previous model is discarded.
+   *
+   * @param referenceSet Set of reference points.
+   */
+  void Train(const MatType& referenceSet);
+
+  /**
+   * Search for the approximate k nearest neighbors of each point in the query
+   * set.  The queries are projected on the coarse centroids as one batch, and
+   * then searched in parallel.  If fewer than k points are found in the
+   * scanned lists, the remaining neighbors are set to the number of reference
+   * points and their distances to DBL_MAX.
+   *
+   * @param querySet Set of query points.
+   * @param k Number of neighbors to search for.
+   * @param neighbors Matrix to store the indices of the neighbors in; column i
+   *     holds the neighbors of query i, from the closest.
+   * @param distances Matrix to store the approximate distances in.
+   */
+  void Search(const MatType& querySet,
+              const size_t k,
+              arma::Mat<size_t>& neighbors,
+              arma::mat& distances) const;
+
+  //! Get the number of coarse centroids (inverted lists).
+  size_t NumLists() const { return numLists; }
+  //! Modify the number of coarse centroids (this takes effect on Train()).
+  size_t& NumLists() { return numLists; }
+
+  //! Get the number of subspaces of the product quantizer.
+  size_t NumSubspaces() const { return numSubspaces; }
+  //! Modify the number of subspaces (this takes effect on Train()).
+  size_t& NumSubspaces() { return numSubspaces; }
+
+  //! Get the number of codewords of each subspace.
+  size_t CodebookSize() const { return codebookSize; }
+  //! Modify the number of codewords of each subspace (this takes effect on
+  //! Train()).
+  size_t& CodebookSize() { return codebookSize; }
+
+  //! Get the number of inverted lists scanned for each query.
+  size_t NumProbes() const { return numProbes; }
+  //! Modify the number of inverted lists scanned for each query.
+  size_t& NumProbes() { return numProbes; }
+
+  //! Get the number of points the quantizers are trained on (0 means all).
+  size_t TrainingSamples() const { return trainingSamples; }
+  //! Modify the number of points the quantizers are trained on (0 means all).
+  size_t& TrainingSamples() { return trainingSamples; }
+
+  //! Get the maximum number of k-means iterations.
+  size_t MaxIterations() const { return maxIterations; }
+  //! Modify the maximum number of k-means iterations.
+  size_t& MaxIterations() { return maxIterations; }
+
+  //! Get the number of encoded reference points.
+  size_t NumPoints() const { return listIndices.n_elem; }
+
+  //! Get the coarse centroids (one per column).
+  const arma::Mat<ElemType>& CoarseCentroids() const { return coarseCentroids; }
+  //! Get the codebooks; slice m holds the codewords of subspace m, one per
+  //! column.
+  const arma::Cube<ElemType>& Codebooks() const { return codebooks; }
+  //! Get the offsets of the inverted lists: list i spans elements
+  //! ListOffsets()[i] to ListOffsets()[i + 1] - 1 of ListIndices() and the
+  //! columns of Codes().
+  const arma::Col<size_t>& ListOffsets() const { return listOffsets; }
+  //! Get the indices of the reference points, list after list.
+  const arma::Col<size_t>& ListIndices() const { return listIndices; }
+  //! Get the codes of the reference points, list after list; each column holds
+  //! one codeword index per subspace.
+  const arma::Mat<unsigned char>& Codes() const { return codes; }
+
+  //! Serialize the model.
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */);
+
+ private:
+  /**
+   * Find the index of the closest column of 'centroids' to each column of
+   * 'points', processing the points in blocks so that the distances can be
+   * computed with matrix multiplications.
+   */
+  static void NearestCentroids(const arma::Mat<ElemType>& points,
+                               const arma::Mat<ElemType>& centroids,
+                               arma::Row<size_t>& assignments);
+
+  /**
+   * Run k-means on the given points (converted to double precision) and return
+   * the centroids.
+   */
+  arma::Mat<ElemType> TrainQuantizer(const arma::Mat<ElemType>& points,
+                                     const size_t clusters) const;
+
+  //! The number of coarse centroids.
+  size_t numLists;
+  //! The number of subspaces.
+  size_t numSubspaces;
+  //! The number of codewords of each subspace.
+  size_t codebookSize;
+  //! The number of lists scanned for each query.
+  size_t numProbes;
+  //! The number of points the quantizers are trained on.
+  size_t trainingSamples;
+  //! The maximum number of k-means iterations.
+  size_t maxIterations;
+
+  //! The coarse centroids.
+  arma::Mat<ElemType> coarseCentroids;
+  //! The codebook of each subspace.
+  arma::Cube<ElemType> codebooks;
+  //! The offsets of the inverted lists.
+  arma::Col<size_t> listOffsets;
+  //! The indices of the points in the inverted lists.
+  arma::Col<size_t> listIndices;
+  //! The codes of the points in the inverted lists.
+  arma::Mat<unsigned char> codes;
+};
+
+} // namespace neighbor
+} // namespace mlpack
+
+// Include implementation.
+#include "ivf_pq_impl.hpp"
+
+#endif
@@ -0,0 +1,309 @@
+/**
+ * @file methods/ivf_pq/ivf_pq_impl.hpp
+ *
+ * Implementation of the IVFPQ class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_IVF_PQ_IVF_PQ_IMPL_HPP
+#define MLPACK_METHODS_IVF_PQ_IVF_PQ_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "ivf_pq.hpp"
+
+#include <queue>
+
+namespace mlpack {
+namespace neighbor {
+
+template<typename MatType>
+IVFPQ<MatType>::IVFPQ(const size_t numLists,
+                      const size_t numSubspaces,
+                      const size_t codebookSize,
+                      const size_t numProbes,
+                      const size_t trainingSamples,
+                      const size_t maxIterations) :
+    numLists(numLists),
+    numSubspaces(numSubspaces),
+    codebookSize(codebookSize),
+    numProbes(numProbes),
+    trainingSamples(trainingSamples),
+    maxIterations(maxIterations)
+{
+  // Nothing to do.
+}
+
+template<typename MatType>
+IVFPQ<MatType>::IVFPQ(const MatType& referenceSet,
+                      const size_t numLists,
+                      const size_t numSubspaces,
+                      const size_t codebookSize,
+                      const size_t numProbes,
+                      const size_t trainingSamples,
+                      const size_t maxIterations) :
+    numLists(numLists),
+    numSubspaces(numSubspaces),
+    codebookSize(codebookSize),
+    numProbes(numProbes),
+    trainingSamples(trainingSamples),
+    maxIterations(maxIterations)
+{
+  Train(referenceSet);
+}
+
+template<typename MatType>
+void IVFPQ<MatType>::Train(const MatType& referenceSet)
+{
+  const size_t dims = referenceSet.n_rows;
+  const size_t n = referenceSet.n_cols;
+
+  if (numLists == 0)
+    throw std::invalid_argument("IVFPQ::Train(): the number of lists must be "
+        "positive");
+  if (numSubspaces == 0 || dims % numSubspaces != 0)
+  {
+    std::ostringstream oss;
+    oss << "IVFPQ::Train(): the dimensionality of the data (" << dims << ") "
+        << "must be a positive multiple of the number of subspaces ("
+        << numSubspaces << ")";
+    throw std::invalid_argument(oss.str());
+  }
+  if (codebookSize == 0 || codebookSize > 256)
+    throw std::invalid_argument("IVFPQ::Train(): the codebook size must be "
+        "between 1 and 256");
+
+  // Pick the points the quantizers are trained on.
+  const size_t numSamples = (trainingSamples == 0) ? n :
+      std::min(trainingSamples, n);
+  if (numSamples < std::max(numLists, codebookSize))
+  {
+    std::ostringstream oss;
+    oss << "IVFPQ::Train(): " << numSamples << " training points are not "
+        << "enough for " << numLists << " lists and codebooks of size "
+        << codebookSize;
+    throw std::invalid_argument(oss.str());
+  }
+
+  arma::Mat<ElemType> samples;
+  if (numSamples == n)
+    samples = referenceSet;
+  else
+    samples = referenceSet.cols(arma::sort(arma::randperm(n, numSamples)));
+
+  // Train the coarse quantizer, and compute the residuals of the samples.
+  coarseCentroids = TrainQuantizer(samples, numLists);
+
+  arma::Row<size_t> assignments;
+  NearestCentroids(samples, coarseCentroids, assignments);
+  for (size_t i = 0; i < numSamples; ++i)
+    samples.col(i) -= coarseCentroids.col(assignments[i]);
+
+  // Train one codebook per subspace on the residuals.
+  const size_t subDims = dims / numSubspaces;
+  codebooks.set_size(subDims, codebookSize, numSubspaces);
+  for (size_t m = 0; m < numSubspaces; ++m)
+  {
+    codebooks.slice(m) = TrainQuantizer(
+        samples.rows(m * subDims, (m + 1) * subDims - 1), codebookSize);
+  }
+  samples.reset();
+
+  // Assign every reference point to its list.
+  NearestCentroids(referenceSet, coarseCentroids, assignments);
+
+  // Lay the lists out contiguously with a counting sort; the points keep their
+  // order within each list.
+  listOffsets.zeros(numLists + 1);
+  for (size_t i = 0; i < n; ++i)
+    ++listOffsets[assignments[i] + 1];
+  for (size_t l = 0; l < numLists; ++l)
+    listOffsets[l + 1] += listOffsets[l];
+
+  listIndices.set_size(n);
+  arma::Col<size_t> position = listOffsets.head(numLists);
+  for (size_t i = 0; i < n; ++i)
+    listIndices[position[assignments[i]]++] = i;
+
+  // Encode the residuals, a block of points at a time so that the residuals
+  // of the whole reference set never need to be held at once.
+  const size_t blockSize = 4096;
+  codes.set_size(numSubspaces, n);
+  arma::Mat<ElemType> residuals;
+  arma::Row<size_t> subAssignments;
+  for (size_t begin = 0; begin < n; begin += blockSize)
+  {
+    const size_t count = std::min(blockSize, n - begin);
+    residuals.set_size(dims, count);
+    for (size_t j = 0; j < count; ++j)
+    {
+      const size_t index = listIndices[begin + j];
+      residuals.col(j) = referenceSet.col(index) -
+          coarseCentroids.col(assignments[index]);
+    }
+
+    for (size_t m = 0; m < numSubspaces; ++m)
+    {
+      NearestCentroids(residuals.rows(m * subDims, (m + 1) * subDims - 1),
+          codebooks.slice(m), subAssignments);
+      for (size_t j = 0; j < count; ++j)
+        codes(m, begin + j) = (unsigned char) subAssignments[j];
+    }
+  }
+}
+
+template<typename MatType>
+void IVFPQ<MatType>::Search(const MatType& querySet,
+                            const size_t k,
+                            arma::Mat<size_t>& neighbors,
+                            arma::mat& distances) const
+{
+  const size_t numPoints = listIndices.n_elem;
+  if (numPoints == 0)
+    Log::Fatal << "IVFPQ::Search(): the model has not been trained!"
+        << std::endl;
+  if (querySet.n_rows != coarseCentroids.n_rows)
+    Log::Fatal << "IVFPQ::Search(): dimensionality of query set ("
+        << querySet.n_rows << ") is not equal to the dimensionality the model "
+        << "was trained on (" << coarseCentroids.n_rows << ")!" << std::endl;
+  if (k > numPoints)
+    Log::Fatal << "IVFPQ::Search(): requested " << k << " neighbors, but the "
+        << "model only holds " << numPoints << " points!" << std::endl;
+
+  neighbors.set_size(k, querySet.n_cols);
+  distances.set_size(k, querySet.n_cols);
+
+  // Rank the coarse centroids for all queries with one matrix multiplication;
+  // the norm of the query doesn't change the ranking, so it is left out.
+  arma::Mat<ElemType> coarseDistances = ElemType(-2) *
+      coarseCentroids.t() * querySet;
+  coarseDistances.each_col() += arma::sum(arma::square(coarseCentroids),
+      0).t();
+
+  const size_t probes = std::min(std::max(numProbes, (size_t) 1), numLists);
+  const size_t subDims = codebooks.n_rows;
+
+  typedef std::pair<double, size_t> Candidate;
+
+  #pragma omp parallel for \
+      shared(neighbors, distances, coarseDistances) \
+      schedule(dynamic)
+  for (omp_size_t i = 0; i < (omp_size_t) querySet.n_cols; ++i)
+  {
+    const arma::uvec lists = arma::sort_index(coarseDistances.col(i));
+
+    // The worst of the k best candidates is on top of the heap.
+    std::priority_queue<Candidate> candidates;
+    arma::mat table(codebookSize, numSubspaces);
+    arma::Col<ElemType> residual;
+    for (size_t p = 0; p < probes; ++p)
+    {
+      const size_t list = lists[p];
+      if (listOffsets[list] == listOffsets[list + 1])
+        continue;
+
+      // Tabulate the squared distance from each subvector of the residual of
+      // the query to each codeword.
+      residual = querySet.col(i) - coarseCentroids.col(list);
+      for (size_t m = 0; m < numSubspaces; ++m)
+      {
+        const arma::Mat<ElemType>& codebook = codebooks.slice(m);
+        for (size_t j = 0; j < codebookSize; ++j)
+        {
+          table(j, m) = arma::accu(arma::square(codebook.col(j) -
+              residual.subvec(m * subDims, (m + 1) * subDims - 1)));
+        }
+      }
+
+      for (size_t c = listOffsets[list]; c < listOffsets[list + 1]; ++c)
+      {
+        const unsigned char* code = codes.colptr(c);
+        double distance = 0.0;
+        for (size_t m = 0; m < numSubspaces; ++m)
+          distance += table(code[m], m);
+
+        if (candidates.size() < k)
+          candidates.push(Candidate(distance, listIndices[c]));
+        else if (distance < candidates.top().first)
+        {
+          candidates.pop();
+          candidates.push(Candidate(distance, listIndices[c]));
+        }
+      }
+    }
+
+    // Fill the neighbors from the worst; slots that couldn't be filled are
+    // marked as invalid.
+    for (size_t j = k; j > candidates.size(); --j)
+    {
+      neighbors(j - 1, i) = numPoints;
+      distances(j - 1, i) = DBL_MAX;
+    }
+    for (size_t j = candidates.size(); j > 0; --j)
+    {
+      neighbors(j - 1, i) = candidates.top().second;
+      distances(j - 1, i) = std::sqrt(candidates.top().first);
+      candidates.pop();
+    }
+  }
+}
+
+template<typename MatType>
+template<typename Archive>
+void IVFPQ<MatType>::serialize(Archive& ar, const unsigned int /* version */)
+{
+  ar & BOOST_SERIALIZATION_NVP(numLists);
+  ar & BOOST_SERIALIZATION_NVP(numSubspaces);
+  ar & BOOST_SERIALIZATION_NVP(codebookSize);
+  ar & BOOST_SERIALIZATION_NVP(numProbes);
+  ar & BOOST_SERIALIZATION_NVP(trainingSamples);
+  ar & BOOST_SERIALIZATION_NVP(maxIterations);
+  ar & BOOST_SERIALIZATION_NVP(coarseCentroids);
+  ar & BOOST_SERIALIZATION_NVP(codebooks);
+  ar & BOOST_SERIALIZATION_NVP(listOffsets);
+  ar & BOOST_SERIALIZATION_NVP(listIndices);
+  ar & BOOST_SERIALIZATION_NVP(codes);
+}
+
+template<typename MatType>
+void IVFPQ<MatType>::NearestCentroids(const arma::Mat<ElemType>& points,
+                                      const arma::Mat<ElemType>& centroids,
+                                      arma::Row<size_t>& assignments)
+{
+  // ||x - c||^2 = ||x||^2 - 2 c^T x + ||c||^2, and ||x||^2 doesn't change
+  // which centroid is closest.
+  const arma::Col<ElemType> centroidNorms =
+      arma::sum(arma::square(centroids), 0).t();
+
+  const size_t blockSize = 1024;
+  assignments.set_size(points.n_cols);
+  arma::Mat<ElemType> scores;
+  for (size_t begin = 0; begin < points.n_cols; begin += blockSize)
+  {
+    const size_t end = std::min(begin + blockSize, (size_t) points.n_cols) - 1;
+    scores = ElemType(-2) * centroids.t() * points.cols(begin, end);
+    scores.each_col() += centroidNorms;
+    const arma::urowvec best = arma::index_min(scores, 0);
+    for (size_t j = 0; j < best.n_elem; ++j)
+      assignments[begin + j] = best[j];
+  }
+}
+
+template<typename MatType>
+arma::Mat<typename MatType::elem_type> IVFPQ<MatType>::TrainQuantizer(
+    const arma::Mat<ElemType>& points,
+    const size_t clusters) const
+{
+  // KMeans works on double precision data.
+  kmeans::KMeans<> kmeans(maxIterations);
+  arma::mat centroids;
+  kmeans.Cluster(arma::conv_to<arma::mat>::from(points), clusters, centroids);
+  return arma::conv_to<arma::Mat<ElemType>>::from(centroids);
+}
+
+} // namespace neighbor
+} // namespace mlpack
+
+#endif
@@ -17,6 +17,7 @@
 #include <mlpack/core/tree/binary_space_tree.hpp>
 
 #include "kde_stat.hpp"
+#include "kde_series.hpp"
 
 namespace mlpack {
 namespace kde /** Kernel Density Estimation. */ {
@@ -290,6 +291,21 @@ class KDE
   //! Modify Monte Carlo break coefficient. (0 < newCoef <= 1).
   void MCBreakCoef(const double newCoef);
 
+  //! Get the number of threads used for evaluation (0 means that OpenMP
+  //! decides).
+  size_t NumThreads() const { return numThreads; }
+  //! Modify the number of threads used for evaluation (0 means that OpenMP
+  //! decides).  Monte Carlo estimations are always computed on one thread.
+  size_t& NumThreads() { return numThreads; }
+
+  //! Get the order of the series expansion of the Gaussian kernel (0 means
+  //! that it is not used).
+  size_t SeriesOrder() const { return seriesOrder; }
+  //! Modify the order of the series expansion of the Gaussian kernel (0 means
+  //! that it is not used).  The expansion is only used with the Gaussian kernel
+  //! and the Euclidean distance.
+  size_t& SeriesOrder() { return seriesOrder; }
+
   //! Serialize the model.
   template<typename Archive>
   void serialize(Archive& ar, const unsigned int version);
@@ -341,6 +357,52 @@ class KDE
   //! is the limit before Monte Carlo estimation recurses.
   double mcBreakCoef;
 
+  //! Number of threads used for evaluation.
+  size_t numThreads;
+
+  //! Order of the series expansion of the Gaussian kernel.
+  size_t seriesOrder;
+
+  //! Get the number of threads to evaluate with.
+  size_t EvaluationThreads() const;
+
+  /**
+   * Build the series expansion of the kernel, and compute its coefficients for
+   * every reference node with at least as many descendants as coefficients
+   * (the coefficients of a node are kept until the order or the bandwidth
+   * change).  Return NULL if the expansion can't be used.
+   */
+  GaussianSeries* PrepareSeries();
+
+  /**
+   * Run the dual-tree traversal of the query tree against the reference tree.
+   * With more than one thread, the query tree is split into disjoint subtrees
+   * that are traversed in parallel.  Each thread has its own rules, so each
+   * thread spends the unused error tolerance accumulated in its own query
+   * nodes, and the estimation of a query point is only updated by the thread
+   * that owns its subtree.
+   *
+   * @param queryTree Tree of query points (the reference tree if sameSet).
+   * @param estimations Vector to add the (unnormalized) estimations to.
+   * @param sameSet Whether the query and reference sets are the same.
+   */
+  void DualTreeEvaluate(Tree& queryTree,
+                        arma::vec& estimations,
+                        const bool sameSet);
+
+  /**
+   * Run the single-tree traversal of the reference tree for every query point.
+   * With more than one thread, the query points are split across threads, each
+   * with its own rules.
+   *
+   * @param querySet Set of query points.
+   * @param estimations Vector to add the (unnormalized) estimations to.
+   * @param sameSet Whether the query and reference sets are the same.
+   */
+  void SingleTreeEvaluate(const MatType& querySet,
+                          arma::vec& estimations,
+                          const bool sameSet);
+
   //! Check whether absolute and relative error values are compatible.
   static void CheckErrorValues(const double relError, const double absError);
 
@@ -377,7 +439,7 @@ struct version<mlpack::kde::KDE<KernelType,
                                 DualTreeTraversalType,
                                 SingleTreeTraversalType>>
 {
-  typedef mpl::int_<1> type;
+  typedef mpl::int_<2> type;
   typedef mpl::integral_c_tag tag;
   BOOST_STATIC_CONSTANT(int, value = version::type::value);
   BOOST_MPL_ASSERT((boost::mpl::less<boost::mpl::int_<1>,
@@ -72,7 +72,9 @@ KDE(const double relError,
     trained(false),
     mode(mode),
     monteCarlo(monteCarlo),
-    initialSampleSize(initialSampleSize)
+    initialSampleSize(initialSampleSize),
+    numThreads(1),
+    seriesOrder(0)
 {
   CheckErrorValues(relError, absError);
   MCProb(mcProb);
@@ -106,7 +108,9 @@ KDE(const KDE& other) :
     mcProb(other.mcProb),
     initialSampleSize(other.initialSampleSize),
     mcEntryCoef(other.mcEntryCoef),
-    mcBreakCoef(other.mcBreakCoef)
+    mcBreakCoef(other.mcBreakCoef),
+    numThreads(other.numThreads),
+    seriesOrder(other.seriesOrder)
 {
   if (trained)
   {
@@ -152,7 +156,9 @@ KDE(KDE&& other) :
     mcProb(other.mcProb),
     initialSampleSize(other.initialSampleSize),
     mcEntryCoef(other.mcEntryCoef),
-    mcBreakCoef(other.mcBreakCoef)
+    mcBreakCoef(other.mcBreakCoef),
+    numThreads(other.numThreads),
+    seriesOrder(other.seriesOrder)
 {
   other.kernel = std::move(KernelType());
   other.metric = std::move(MetricType());
@@ -168,6 +174,8 @@ KDE(KDE&& other) :
   other.initialSampleSize = KDEDefaultParams::initialSampleSize;
   other.mcEntryCoef = KDEDefaultParams::mcEntryCoef;
   other.mcBreakCoef = KDEDefaultParams::mcBreakCoef;
+  other.numThreads = 1;
+  other.seriesOrder = 0;
 }
 
 template<typename KernelType,
@@ -214,6 +222,8 @@ operator=(KDE other)
   this->initialSampleSize = other.initialSampleSize;
   this->mcEntryCoef = other.mcEntryCoef;
   this->mcBreakCoef = other.mcBreakCoef;
+  this->numThreads = other.numThreads;
+  this->seriesOrder = other.seriesOrder;
 
   return *this;
 }
@@ -378,37 +388,9 @@ Evaluate(MatType querySet, arma::vec& estimations)
     }
 
     Timer::Start("computing_kde");
-
-    // Evaluate.
-    typedef KDERules<MetricType, KernelType, Tree> RuleType;
-    RuleType rules = RuleType(referenceTree->Dataset(),
-                              querySet,
-                              estimations,
-                              relError,
-                              absError,
-                              mcProb,
-                              initialSampleSize,
-                              mcEntryCoef,
-                              mcBreakCoef,
-                              metric,
-                              kernel,
-                              monteCarlo,
-                              false);
-
-    // Create traverser.
-    SingleTreeTraversalType<RuleType> traverser(rules);
-
-    // Traverse for each point.
-    for (size_t i = 0; i < querySet.n_cols; ++i)
-      traverser.Traverse(i, *referenceTree);
-
+    SingleTreeEvaluate(querySet, estimations, false);
     estimations /= referenceTree->Dataset().n_cols;
     Timer::Stop("computing_kde");
-
-    Log::Info << rules.Scores() << " node combinations were scored."
-              << std::endl;
-    Log::Info << rules.BaseCases() << " base cases were calculated."
-              << std::endl;
   }
 }
 
@@ -476,34 +458,12 @@ Evaluate(Tree* queryTree,
   }
 
   Timer::Start("computing_kde");
-
-  // Evaluate.
-  typedef KDERules<MetricType, KernelType, Tree> RuleType;
-  RuleType rules = RuleType(referenceTree->Dataset(),
-                            queryTree->Dataset(),
-                            estimations,
-                            relError,
-                            absError,
-                            mcProb,
-                            initialSampleSize,
-                            mcEntryCoef,
-                            mcBreakCoef,
-                            metric,
-                            kernel,
-                            monteCarlo,
-                            false);
-
-  // Create traverser.
-  DualTreeTraversalType<RuleType> traverser(rules);
-  traverser.Traverse(*queryTree, *referenceTree);
+  DualTreeEvaluate(*queryTree, estimations, false);
   estimations /= referenceTree->Dataset().n_cols;
   Timer::Stop("computing_kde");
 
   // Rearrange if necessary.
   RearrangeEstimations(oldFromNewQueries, estimations);
-
-  Log::Info << rules.Scores() << " node combinations were scored." << std::endl;
-  Log::Info << rules.BaseCases() << " base cases were calculated." << std::endl;
 }
 
 template<typename KernelType,
@@ -545,43 +505,280 @@ Evaluate(arma::vec& estimations)
   }
 
   Timer::Start("computing_kde");
+  if (mode == DUAL_TREE_MODE)
+    DualTreeEvaluate(*referenceTree, estimations, true);
+  else if (mode == SINGLE_TREE_MODE)
+    SingleTreeEvaluate(referenceTree->Dataset(), estimations, true);
+
+  estimations /= referenceTree->Dataset().n_cols;
+  // Rearrange if necessary.
+  RearrangeEstimations(*oldFromNewReferences, estimations);
+  Timer::Stop("computing_kde");
+}
 
-  // Evaluate.
+template<typename KernelType,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+size_t KDE<KernelType,
+         MetricType,
+         MatType,
+         TreeType,
+         DualTreeTraversalType,
+         SingleTreeTraversalType>::
+EvaluationThreads() const
+{
+  // Monte Carlo estimations draw random numbers and cache alpha values in the
+  // statistics of the reference nodes, so they can't be computed in parallel.
+  if (monteCarlo && std::is_same<KernelType, kernel::GaussianKernel>::value)
+    return 1;
+
+  return util::Threads(numThreads);
+}
+
+template<typename KernelType,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+GaussianSeries* KDE<KernelType,
+                    MetricType,
+                    MatType,
+                    TreeType,
+                    DualTreeTraversalType,
+                    SingleTreeTraversalType>::
+PrepareSeries()
+{
+  // The expansion evaluates the Gaussian kernel of the Euclidean distance
+  // itself.
+  const double bandwidth = GaussianBandwidth(kernel);
+  if (seriesOrder == 0 || bandwidth == 0.0 ||
+      !std::is_same<MetricType, metric::EuclideanDistance>::value)
+    return NULL;
+
+  // An expansion with more coefficients than reference points never pays off.
+  const size_t dimensionality = referenceTree->Dataset().n_rows;
+  if (GaussianSeries::NumTerms(dimensionality, seriesOrder) >
+      (double) referenceTree->NumDescendants())
+    return NULL;
+
+  GaussianSeries* series = new GaussianSeries(dimensionality, seriesOrder,
+      bandwidth);
+
+  // Collect the nodes that are large enough and don't have coefficients yet.
+  std::vector<Tree*> nodes;
+  std::vector<Tree*> stack(1, referenceTree);
+  while (!stack.empty())
+  {
+    Tree* node = stack.back();
+    stack.pop_back();
+    if (node->NumDescendants() < series->NumTerms())
+      continue;
+
+    if (!series->HasCoefficients(node->Stat()))
+      nodes.push_back(node);
+    for (size_t i = 0; i < node->NumChildren(); ++i)
+      stack.push_back(&node->Child(i));
+  }
+
+  #pragma omp parallel for num_threads(EvaluationThreads()) schedule(dynamic)
+  for (omp_size_t i = 0; i < (omp_size_t) nodes.size(); ++i)
+    series->ComputeCoefficients(*nodes[i]);
+
+  Log::Info << "Computed series expansions of order " << seriesOrder << " ("
+      << series->NumTerms() << " coefficients) for " << nodes.size()
+      << " reference nodes." << std::endl;
+
+  return series;
+}
+
+template<typename KernelType,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void KDE<KernelType,
+         MetricType,
+         MatType,
+         TreeType,
+         DualTreeTraversalType,
+         SingleTreeTraversalType>::
+DualTreeEvaluate(Tree& queryTree,
+                 arma::vec& estimations,
+                 const bool sameSet)
+{
   typedef KDERules<MetricType, KernelType, Tree> RuleType;
-  RuleType rules = RuleType(referenceTree->Dataset(),
-                            referenceTree->Dataset(),
-                            estimations,
-                            relError,
-                            absError,
-                            mcProb,
-                            initialSampleSize,
-                            mcEntryCoef,
-                            mcBreakCoef,
-                            metric,
-                            kernel,
-                            monteCarlo,
-                            true);
+  const size_t threads = EvaluationThreads();
+  std::unique_ptr<GaussianSeries> series(PrepareSeries());
 
-  if (mode == DUAL_TREE_MODE)
+  // Split the query tree into a frontier of disjoint subtrees.  We repeatedly
+  // replace the largest node in the frontier with its children, until there
+  // are enough subtrees to keep every thread busy.
+  std::vector<Tree*> frontier(1, &queryTree);
+  while (threads > 1 && frontier.size() < 4 * threads)
   {
+    size_t largest = frontier.size();
+    for (size_t i = 0; i < frontier.size(); ++i)
+    {
+      if (frontier[i]->NumChildren() == 0)
+        continue;
+
+      if (largest == frontier.size() || frontier[i]->NumDescendants() >
+          frontier[largest]->NumDescendants())
+        largest = i;
+    }
+
+    if (largest == frontier.size())
+      break; // Only leaves are left; we can't split any further.
+
+    Tree* node = frontier[largest];
+    frontier[largest] = &node->Child(0);
+    for (size_t i = 1; i < node->NumChildren(); ++i)
+      frontier.push_back(&node->Child(i));
+  }
+
+  if (frontier.size() == 1)
+  {
+    RuleType rules = RuleType(referenceTree->Dataset(),
+                              queryTree.Dataset(),
+                              estimations,
+                              relError,
+                              absError,
+                              mcProb,
+                              initialSampleSize,
+                              mcEntryCoef,
+                              mcBreakCoef,
+                              metric,
+                              kernel,
+                              monteCarlo,
+                              sameSet,
+                              series.get());
+
     // Create traverser.
     DualTreeTraversalType<RuleType> traverser(rules);
-    traverser.Traverse(*referenceTree, *referenceTree);
+    traverser.Traverse(queryTree, *referenceTree);
+
+    Log::Info << rules.Scores() << " node combinations were scored."
+              << std::endl;
+    Log::Info << rules.BaseCases() << " base cases were calculated."
+              << std::endl;
+    return;
   }
-  else if (mode == SINGLE_TREE_MODE)
+
+  // The statistics of the query nodes are only modified by the thread that
+  // owns their subtree, and the reference tree is only read.
+  size_t totalScores = 0;
+  size_t totalBaseCases = 0;
+
+  #pragma omp parallel num_threads(threads) \
+      reduction(+:totalScores, totalBaseCases)
   {
-    SingleTreeTraversalType<RuleType> traverser(rules);
-    for (size_t i = 0; i < referenceTree->Dataset().n_cols; ++i)
-      traverser.Traverse(i, *referenceTree);
+    MetricType threadMetric(metric);
+    KernelType threadKernel(kernel);
+    RuleType rules = RuleType(referenceTree->Dataset(),
+                              queryTree.Dataset(),
+                              estimations,
+                              relError,
+                              absError,
+                              mcProb,
+                              initialSampleSize,
+                              mcEntryCoef,
+                              mcBreakCoef,
+                              threadMetric,
+                              threadKernel,
+                              monteCarlo,
+                              sameSet,
+                              series.get());
+    DualTreeTraversalType<RuleType> traverser(rules);
+
+    #pragma omp for schedule(dynamic)
+    for (omp_size_t i = 0; i < (omp_size_t) frontier.size(); ++i)
+    {
+      // The traverser expects the combination it is given to already have
+      // been scored (unless both nodes are roots).
+      if (rules.Score(*frontier[i], *referenceTree) != DBL_MAX)
+        traverser.Traverse(*frontier[i], *referenceTree);
+    }
+
+    totalScores += rules.Scores();
+    totalBaseCases += rules.BaseCases();
   }
 
-  estimations /= referenceTree->Dataset().n_cols;
-  // Rearrange if necessary.
-  RearrangeEstimations(*oldFromNewReferences, estimations);
-  Timer::Stop("computing_kde");
+  Log::Info << totalScores << " node combinations were scored." << std::endl;
+  Log::Info << totalBaseCases << " base cases were calculated." << std::endl;
+}
+
+template<typename KernelType,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void KDE<KernelType,
+         MetricType,
+         MatType,
+         TreeType,
+         DualTreeTraversalType,
+         SingleTreeTraversalType>::
+SingleTreeEvaluate(const MatType& querySet,
+                   arma::vec& estimations,
+                   const bool sameSet)
+{
+  typedef KDERules<MetricType, KernelType, Tree> RuleType;
+  const size_t threads = EvaluationThreads();
+  std::unique_ptr<GaussianSeries> series(PrepareSeries());
 
-  Log::Info << rules.Scores() << " node combinations were scored." << std::endl;
-  Log::Info << rules.BaseCases() << " base cases were calculated." << std::endl;
+  size_t totalScores = 0;
+  size_t totalBaseCases = 0;
+
+  // Each thread has its own rules; the rules only modify the estimation and
+  // the accumulated error tolerance of their own query points.
+  #pragma omp parallel num_threads(threads) \
+      reduction(+:totalScores, totalBaseCases)
+  {
+    MetricType threadMetric(metric);
+    KernelType threadKernel(kernel);
+    RuleType rules = RuleType(referenceTree->Dataset(),
+                              querySet,
+                              estimations,
+                              relError,
+                              absError,
+                              mcProb,
+                              initialSampleSize,
+                              mcEntryCoef,
+                              mcBreakCoef,
+                              threadMetric,
+                              threadKernel,
+                              monteCarlo,
+                              sameSet,
+                              series.get());
+
+    // Create traverser.
+    SingleTreeTraversalType<RuleType> traverser(rules);
+
+    // Traverse for each point.
+    #pragma omp for schedule(dynamic, 16)
+    for (omp_size_t i = 0; i < (omp_size_t) querySet.n_cols; ++i)
+      traverser.Traverse((size_t) i, *referenceTree);
+
+    totalScores += rules.Scores();
+    totalBaseCases += rules.BaseCases();
+  }
+
+  Log::Info << totalScores << " node combinations were scored." << std::endl;
+  Log::Info << totalBaseCases << " base cases were calculated." << std::endl;
 }
 
 template<typename KernelType,
@@ -739,6 +936,13 @@ serialize(Archive& ar, const unsigned int version)
     mcBreakCoef = KDEDefaultParams::mcBreakCoef;
   }
 
+  // Backward compatibility: Old versions of KDE did not have series
+  // expansions.
+  if (version > 1)
+    ar & BOOST_SERIALIZATION_NVP(seriesOrder);
+  else if (Archive::is_loading::value)
+    seriesOrder = 0;
+
   // If we are loading, clean up memory if necessary.
   if (Archive::is_loading::value)
   {
@@ -72,7 +72,21 @@ BINDING_LONG_DESC(
     "computations an exact approach would take, this program recurses the tree "
     "whenever a fraction of the amount of the node's descendant points have "
     "already been computed. This fraction is set using " +
-    PRINT_PARAM_STRING("mc_break_coef") + ".");
+    PRINT_PARAM_STRING("mc_break_coef") + "."
+    "\n\n"
+    "The evaluation can be run on several threads with the " +
+    PRINT_PARAM_STRING("threads") + " parameter (0 uses the OpenMP default); "
+    "the query points are split across the threads.  Monte Carlo estimations "
+    "are always computed on one thread."
+    "\n\n"
+    "With the Gaussian kernel, the contribution of a large reference node can "
+    "also be approximated with a Taylor series expansion of the kernel around "
+    "the center of the node (as in the improved fast Gauss transform), which "
+    "helps when the bandwidth is large compared to the nodes.  The order of "
+    "the expansion is set with " + PRINT_PARAM_STRING("series_order") + " (0 "
+    "disables it); the number of coefficients grows quickly with the order and "
+    "the dimensionality, so this is mostly useful for low-dimensional data. "
+    "The error guarantees are not changed.");
 
 // Example.
 BINDING_EXAMPLE(
@@ -186,6 +200,9 @@ PARAM_DOUBLE_IN("mc_break_coef",
                 "c",
                 KDEDefaultParams::mcBreakCoef);
 
+PARAM_INT_IN("series_order", "Order of the series expansion of the Gaussian "
+    "kernel (0 disables it).", "", 0);
+
 // Output predictions options.
 PARAM_COL_OUT("predictions", "Vector to store density predictions.",
     "p");
@@ -206,6 +223,8 @@ static void mlpackMain()
   const int initialSampleSize = IO::GetParam<int>("initial_sample_size");
   const double mcEntryCoef = IO::GetParam<double>("mc_entry_coef");
   const double mcBreakCoef = IO::GetParam<double>("mc_break_coef");
+  const int threads = IO::GetParam<int>("threads");
+  const int seriesOrder = IO::GetParam<int>("series_order");
 
   // Initialize results vector.
   arma::vec estimations;
@@ -225,6 +244,11 @@ static void mlpackMain()
     ReportIgnoredParam("monte_carlo",
                        "Monte Carlo only works with Gaussian kernel");
   }
+  if (seriesOrder > 0 && kernelStr != "gaussian")
+  {
+    ReportIgnoredParam("series_order",
+                       "series expansions only work with Gaussian kernel");
+  }
 
   // Requirements for parameter values.
   RequireParamInSet<string>("kernel", { "gaussian", "epanechnikov",
@@ -249,6 +273,10 @@ static void mlpackMain()
       [](double x){return x > 0 && x <= 1;}, true,
       "Monte Carlo break coefficient must be greater than 0 and less than "
       "or equal to 1");
+  RequireParamValue<int>("threads", [](int x) { return x >= 0; }, true,
+      "number of threads must be nonnegative");
+  RequireParamValue<int>("series_order", [](int x) { return x >= 0; }, true,
+      "series order must be nonnegative");
 
   KDEModel* kde;
 
@@ -306,6 +334,8 @@ static void mlpackMain()
   kde->MCInitialSampleSize(initialSampleSize);
   kde->MCEntryCoefficient(mcEntryCoef);
   kde->MCBreakCoefficient(mcBreakCoef);
+  kde->NumThreads((size_t) threads);
+  kde->SeriesOrder((size_t) seriesOrder);
 
   // Evaluation.
   if (IO::HasParam("query"))
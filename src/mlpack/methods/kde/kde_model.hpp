@@ -340,6 +340,49 @@ class MCBreakCoefVisitor : public boost::static_visitor<void>
   MCBreakCoefVisitor(const double breakCoef);
 };
 
+/**
+ * NumThreadsVisitor sets the number of threads used for evaluation.
+ */
+class NumThreadsVisitor : public boost::static_visitor<void>
+{
+ private:
+  //! Number of threads.
+  const size_t numThreads;
+
+ public:
+  //! Set the number of threads of some KDEType.
+  template<typename KernelType,
+           template<typename TreeMetricType,
+                    typename TreeStatType,
+                    typename TreeMatType> class TreeType>
+  void operator()(KDEType<KernelType, TreeType>* kde) const;
+
+  //! NumThreadsVisitor constructor.
+  NumThreadsVisitor(const size_t numThreads);
+};
+
+/**
+ * SeriesOrderVisitor sets the order of the series expansion of the Gaussian
+ * kernel.
+ */
+class SeriesOrderVisitor : public boost::static_visitor<void>
+{
+ private:
+  //! Order of the expansion.
+  const size_t seriesOrder;
+
+ public:
+  //! Set the series order of some KDEType.
+  template<typename KernelType,
+           template<typename TreeMetricType,
+                    typename TreeStatType,
+                    typename TreeMatType> class TreeType>
+  void operator()(KDEType<KernelType, TreeType>* kde) const;
+
+  //! SeriesOrderVisitor constructor.
+  SeriesOrderVisitor(const size_t seriesOrder);
+};
+
 /**
  * ModeVisitor exposes the Mode() method of the KDEType.
  */
@@ -412,6 +455,12 @@ class KDEModel
   //! Break coefficient for Monte Carlo estimations.
   double mcBreakCoef;
 
+  //! Number of threads used for evaluation (this is not serialized).
+  size_t numThreads;
+
+  //! Order of the series expansion of the Gaussian kernel.
+  size_t seriesOrder;
+
   /**
    * kdeModel holds an instance of each possible combination of KernelType and
    * TreeType. It is initialized using BuildModel.
@@ -560,6 +609,20 @@ class KDEModel
   //! Modify Monte Carlo break coefficient.
   void MCBreakCoefficient(const double newBreakCoef);
 
+  //! Get the number of threads used for evaluation.
+  size_t NumThreads() const { return numThreads; }
+
+  //! Modify the number of threads used for evaluation (0 means that OpenMP
+  //! decides).
+  void NumThreads(const size_t newNumThreads);
+
+  //! Get the order of the series expansion of the Gaussian kernel.
+  size_t SeriesOrder() const { return seriesOrder; }
+
+  //! Modify the order of the series expansion of the Gaussian kernel (0
+  //! disables it).
+  void SeriesOrder(const size_t newSeriesOrder);
+
   //! Get the mode of the model.
   KDEMode Mode() const;
 
@@ -609,7 +672,7 @@ class KDEModel
 } // namespace mlpack
 
 //! Set the serialization version of the KDEModel class.
-BOOST_TEMPLATE_CLASS_VERSION(template<>, mlpack::kde::KDEModel, 1);
+BOOST_TEMPLATE_CLASS_VERSION(template<>, mlpack::kde::KDEModel, 2);
 
 #include "kde_model_impl.hpp"
 
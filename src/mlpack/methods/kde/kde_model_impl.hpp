@@ -40,7 +40,9 @@ inline KDEModel::KDEModel(const double bandwidth,
   mcProb(mcProb),
   initialSampleSize(initialSampleSize),
   mcEntryCoef(mcEntryCoef),
-  mcBreakCoef(mcBreakCoef)
+  mcBreakCoef(mcBreakCoef),
+  numThreads(1),
+  seriesOrder(0)
 {
   // Nothing to do.
 }
@@ -56,7 +58,9 @@ inline KDEModel::KDEModel(const KDEModel& other) :
   mcProb(other.mcProb),
   initialSampleSize(other.initialSampleSize),
   mcEntryCoef(other.mcEntryCoef),
-  mcBreakCoef(other.mcBreakCoef)
+  mcBreakCoef(other.mcBreakCoef),
+  numThreads(other.numThreads),
+  seriesOrder(other.seriesOrder)
 {
   // Nothing to do.
 }
@@ -73,6 +77,8 @@ inline KDEModel::KDEModel(KDEModel&& other) :
   initialSampleSize(other.initialSampleSize),
   mcEntryCoef(other.mcEntryCoef),
   mcBreakCoef(other.mcBreakCoef),
+  numThreads(other.numThreads),
+  seriesOrder(other.seriesOrder),
   kdeModel(std::move(other.kdeModel))
 {
   // Reset other model.
@@ -86,6 +92,8 @@ inline KDEModel::KDEModel(KDEModel&& other) :
   other.initialSampleSize = KDEDefaultParams::initialSampleSize;
   other.mcEntryCoef = KDEDefaultParams::mcEntryCoef;
   other.mcBreakCoef = KDEDefaultParams::mcBreakCoef;
+  other.numThreads = 1;
+  other.seriesOrder = 0;
   other.kdeModel = decltype(other.kdeModel)();
 }
 
@@ -102,6 +110,8 @@ inline KDEModel& KDEModel::operator=(KDEModel other)
   initialSampleSize = other.initialSampleSize;
   mcEntryCoef = other.mcEntryCoef;
   mcBreakCoef = other.mcBreakCoef;
+  numThreads = other.numThreads;
+  seriesOrder = other.seriesOrder;
   kdeModel = std::move(other.kdeModel);
   return *this;
 }
@@ -264,6 +274,10 @@ inline void KDEModel::BuildModel(arma::mat&& referenceSet)
   MCBreakCoefVisitor breakCoefficientVisitor(mcBreakCoef);
   boost::apply_visitor(breakCoefficientVisitor, kdeModel);
 
+  // Set the order of the series expansion.
+  SeriesOrderVisitor seriesOrderVisitor(seriesOrder);
+  boost::apply_visitor(seriesOrderVisitor, kdeModel);
+
   // Train the model.
   TrainVisitor train(std::move(referenceSet));
   boost::apply_visitor(train, kdeModel);
@@ -273,6 +287,8 @@ inline void KDEModel::BuildModel(arma::mat&& referenceSet)
 inline void KDEModel::Evaluate(arma::mat&& querySet, arma::vec& estimations)
 {
   Log::Info << "Evaluating KDE..." << std::endl;
+  NumThreadsVisitor numThreadsVisitor(numThreads);
+  boost::apply_visitor(numThreadsVisitor, kdeModel);
   DualBiKDE eval(std::move(querySet), estimations);
   boost::apply_visitor(eval, kdeModel);
 }
@@ -281,6 +297,8 @@ inline void KDEModel::Evaluate(arma::mat&& querySet, arma::vec& estimations)
 inline void KDEModel::Evaluate(arma::vec& estimations)
 {
   Log::Info << "Evaluating KDE..." << std::endl;
+  NumThreadsVisitor numThreadsVisitor(numThreads);
+  boost::apply_visitor(numThreadsVisitor, kdeModel);
   DualMonoKDE eval(estimations);
   boost::apply_visitor(eval, kdeModel);
 }
@@ -507,6 +525,42 @@ void MCBreakCoefVisitor::operator()(KDEType<KernelType, TreeType>* kde) const
     throw std::runtime_error("no KDE model initialized");
 }
 
+// Set the number of threads.
+NumThreadsVisitor::NumThreadsVisitor(const size_t numThreads) :
+    numThreads(numThreads)
+{}
+
+// Set the number of threads of the model.
+template<typename KernelType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void NumThreadsVisitor::operator()(KDEType<KernelType, TreeType>* kde) const
+{
+  if (kde)
+    kde->NumThreads() = numThreads;
+  else
+    throw std::runtime_error("no KDE model initialized");
+}
+
+// Set the order of the series expansion.
+SeriesOrderVisitor::SeriesOrderVisitor(const size_t seriesOrder) :
+    seriesOrder(seriesOrder)
+{}
+
+// Set the order of the series expansion of the model.
+template<typename KernelType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void SeriesOrderVisitor::operator()(KDEType<KernelType, TreeType>* kde) const
+{
+  if (kde)
+    kde->SeriesOrder() = seriesOrder;
+  else
+    throw std::runtime_error("no KDE model initialized");
+}
+
 // Delete model.
 template<typename KDEType>
 void DeleteVisitor::operator()(KDEType* kde) const
@@ -566,6 +620,13 @@ void KDEModel::serialize(Archive& ar, const unsigned int version)
     mcBreakCoef = KDEDefaultParams::mcBreakCoef;
   }
 
+  // Backward compatibility: Old versions of KDEModel did not have series
+  // expansions.
+  if (version > 1)
+    ar & BOOST_SERIALIZATION_NVP(seriesOrder);
+  else if (Archive::is_loading::value)
+    seriesOrder = 0;
+
   if (Archive::is_loading::value)
     boost::apply_visitor(DeleteVisitor(), kdeModel);
 
@@ -636,6 +697,21 @@ void KDEModel::MCBreakCoefficient(const double newBreakCoef)
   boost::apply_visitor(mcBreakCoefVisitor, kdeModel);
 }
 
+// Modify the number of threads used for evaluation; it is passed to the model
+// when evaluating, since it isn't serialized.
+void KDEModel::NumThreads(const size_t newNumThreads)
+{
+  numThreads = newNumThreads;
+}
+
+// Modify the order of the series expansion.
+void KDEModel::SeriesOrder(const size_t newSeriesOrder)
+{
+  seriesOrder = newSeriesOrder;
+  SeriesOrderVisitor seriesOrderVisitor(newSeriesOrder);
+  boost::apply_visitor(seriesOrderVisitor, kdeModel);
+}
+
 } // namespace kde
 } // namespace mlpack
 
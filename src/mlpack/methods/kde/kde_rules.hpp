@@ -14,6 +14,7 @@
 #define MLPACK_METHODS_KDE_RULES_HPP
 
 #include <mlpack/core/tree/traversal_info.hpp>
+#include "kde_series.hpp"
 
 namespace mlpack {
 namespace kde {
@@ -45,6 +46,9 @@ class KDERules
    *                   possible.
    * @param sameSet True if query and reference sets are the same
    *                (monochromatic evaluation).
+   * @param series Series expansion of the Gaussian kernel to use for the
+   *               reference nodes that hold its coefficients (NULL to never
+   *               use it).
    */
   KDERules(const arma::mat& referenceSet,
            const arma::mat& querySet,
@@ -58,7 +62,8 @@ class KDERules
            MetricType& metric,
            KernelType& kernel,
            const bool monteCarlo,
-           const bool sameSet);
+           const bool sameSet,
+           const GaussianSeries* series = NULL);
 
   //! Base Case.
   double BaseCase(const size_t queryIndex, const size_t referenceIndex);
@@ -109,6 +114,11 @@ class KDERules
   //! Calculate depth alpha for some node.
   double CalculateAlpha(TreeType* node);
 
+  //! Check whether the series expansion of the reference node can be used.
+  bool CanUseSeries(const TreeType& referenceNode,
+                    const bool alreadyDidRefPoint0,
+                    const double minDistance) const;
+
   //! The reference set.
   const arma::mat& referenceSet;
 
@@ -158,6 +168,9 @@ class KDERules
   //! Whether reference and query sets are the same.
   const bool sameSet;
 
+  //! Series expansion of the kernel (NULL if it's not used).
+  const GaussianSeries* series;
+
   //! Whether the kernel used for the rule is the Gaussian Kernel.
   constexpr static bool kernelIsGaussian =
       std::is_same<KernelType, kernel::GaussianKernel>::value;
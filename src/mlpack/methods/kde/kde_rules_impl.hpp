@@ -36,7 +36,8 @@ KDERules<MetricType, KernelType, TreeType>::KDERules(
     MetricType& metric,
     KernelType& kernel,
     const bool monteCarlo,
-    const bool sameSet) :
+    const bool sameSet,
+    const GaussianSeries* series) :
     referenceSet(referenceSet),
     querySet(querySet),
     densities(densities),
@@ -50,6 +51,7 @@ KDERules<MetricType, KernelType, TreeType>::KDERules(
     kernel(kernel),
     monteCarlo(monteCarlo),
     sameSet(sameSet),
+    series(series),
     absErrorTol(absError / referenceSet.n_cols),
     lastQueryIndex(querySet.n_cols),
     lastReferenceIndex(referenceSet.n_cols),
@@ -160,6 +162,17 @@ Score(const size_t queryIndex, TreeType& referenceNode)
   else
     pointAccumErrorTol = accumError(queryIndex) / refNumDesc;
 
+  // If the kernel values can't be bounded tightly enough, the series expansion
+  // of the reference node may still approximate their sum well enough.
+  double seriesError = DBL_MAX;
+  if (bound > 2 * errorTolerance + pointAccumErrorTol &&
+      CanUseSeries(referenceNode, alreadyDidRefPoint0, minDistance))
+  {
+    const KDEStat& referenceStat = referenceNode.Stat();
+    seriesError = series->TruncationError(
+        series->CenterDistance(queryPoint, referenceStat), referenceStat);
+  }
+
   if (bound <= 2 * errorTolerance + pointAccumErrorTol)
   {
     // Estimate kernel value.
@@ -184,6 +197,23 @@ Score(const size_t queryIndex, TreeType& referenceNode)
     if (kernelIsGaussian && monteCarlo)
       accumMCAlpha(queryIndex) += depthAlpha;
   }
+  else if (2 * seriesError <= 2 * errorTolerance + pointAccumErrorTol)
+  {
+    // Evaluate the series expansion of the reference node.
+    densities(queryIndex) += series->Evaluate(queryPoint,
+        referenceNode.Stat());
+
+    // Don't explore this tree branch.
+    score = DBL_MAX;
+
+    // Each kernel value is off by at most seriesError.
+    accumError(queryIndex) -= refNumDesc * (2 * seriesError -
+        2 * errorTolerance);
+
+    // Store not used alpha for Monte Carlo.
+    if (kernelIsGaussian && monteCarlo)
+      accumMCAlpha(queryIndex) += depthAlpha;
+  }
   else if (monteCarlo &&
            refNumDesc >= mcAccessCoef * initialSampleSize &&
            kernelIsGaussian)
@@ -367,6 +397,17 @@ Score(TreeType& queryNode, TreeType& referenceNode)
   // it here to prune more.
   const double pointAccumErrorTol = queryStat.AccumError() / refNumDesc;
 
+  // If the kernel values can't be bounded tightly enough, the series expansion
+  // of the reference node may still approximate their sum well enough.
+  double seriesError = DBL_MAX;
+  if (bound > 2 * errorTolerance + pointAccumErrorTol &&
+      CanUseSeries(referenceNode, alreadyDidRefPoint0, minDistance))
+  {
+    const KDEStat& referenceStat = referenceNode.Stat();
+    seriesError = series->TruncationError(
+        queryNode.MaxDistance(referenceStat.SeriesCenter()), referenceStat);
+  }
+
   // If possible, avoid some calculations because of the error tolerance.
   if (bound <= 2 * errorTolerance + pointAccumErrorTol)
   {
@@ -393,6 +434,28 @@ Score(TreeType& queryNode, TreeType& referenceNode)
     if (kernelIsGaussian && monteCarlo)
       queryStat.AccumAlpha() += depthAlpha;
   }
+  else if (2 * seriesError <= 2 * errorTolerance + pointAccumErrorTol)
+  {
+    // Evaluate the series expansion of the reference node at every query
+    // descendant.
+    for (size_t i = 0; i < queryNode.NumDescendants(); ++i)
+    {
+      const size_t queryIndex = queryNode.Descendant(i);
+      densities(queryIndex) += series->Evaluate(querySet.unsafe_col(queryIndex),
+          referenceNode.Stat());
+    }
+
+    // Prune.
+    score = DBL_MAX;
+
+    // Each kernel value is off by at most seriesError.
+    queryStat.AccumError() -= refNumDesc * (2 * seriesError -
+        2 * errorTolerance);
+
+    // Store not used alpha for Monte Carlo.
+    if (kernelIsGaussian && monteCarlo)
+      queryStat.AccumAlpha() += depthAlpha;
+  }
   else if (monteCarlo &&
            refNumDesc >= mcAccessCoef * initialSampleSize &&
            kernelIsGaussian)
@@ -573,6 +636,21 @@ CalculateAlpha(TreeType* node)
   return stat.MCAlpha();
 }
 
+template<typename MetricType, typename KernelType, typename TreeType>
+inline force_inline bool KDERules<MetricType, KernelType, TreeType>::
+CanUseSeries(const TreeType& referenceNode,
+             const bool alreadyDidRefPoint0,
+             const double minDistance) const
+{
+  // The expansion sums over all the descendants of the node, so it can't be
+  // used if one of them has already been computed, or if a query point is a
+  // descendant too.
+  return series != NULL &&
+         !alreadyDidRefPoint0 &&
+         (!sameSet || minDistance > 0) &&
+         series->HasCoefficients(referenceNode.Stat());
+}
+
 //! Clean rules base case.
 template<typename TreeType>
 inline force_inline
@@ -0,0 +1,160 @@
+/**
+ * @file methods/kde/kde_series.hpp
+ *
+ * Definition of GaussianSeries, the truncated Taylor series expansion of the
+ * Gaussian kernel used by KDERules to approximate the contribution of a whole
+ * reference node, as in the improved fast Gauss transform:
+ *
+ * @code
+ * @inproceedings{yang2003improved,
+ *   title={Improved fast Gauss transform and efficient kernel density
+ *       estimation},
+ *   author={Yang, C. and Duraiswami, R. and Gumerov, N.A. and Davis, L.},
+ *   booktitle={Proceedings of the Ninth IEEE International Conference on
+ *       Computer Vision (ICCV 2003)},
+ *   pages={664--671},
+ *   year={2003}
+ * }
+ * @endcode
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KDE_SERIES_HPP
+#define MLPACK_METHODS_KDE_SERIES_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/kernels/gaussian_kernel.hpp>
+#include "kde_stat.hpp"
+
+namespace mlpack {
+namespace kde {
+
+/**
+ * GaussianSeries expands the Gaussian kernel
+ * @f$ K(x, y) = e^{-\|x - y\|^2 / h^2} @f$ (with @f$ h^2 = 2 \sigma^2 @f$ for
+ * bandwidth @f$ \sigma @f$) around the center c of a reference node:
+ *
+ * @f[
+ * \sum_j K(x, y_j) \approx e^{-\|x - c\|^2 / h^2} \sum_{|\alpha| < p}
+ *     C_\alpha \left( \frac{x - c}{h} \right)^\alpha, \qquad
+ * C_\alpha = \frac{2^{|\alpha|}}{\alpha!} \sum_j e^{-\|y_j - c\|^2 / h^2}
+ *     \left( \frac{y_j - c}{h} \right)^\alpha.
+ * @f]
+ *
+ * The coefficients only depend on the reference node, so they are computed
+ * once and stored in its KDEStat; the contribution of the node to a query
+ * point then costs one evaluation of the polynomial.  If every reference point
+ * is within r_y of c and the query point is within r_x of c, the error of each
+ * kernel value is at most @f$ (2 r_x r_y / h^2)^p / p! @f$.
+ *
+ * There are @f$ \binom{p - 1 + d}{d} @f$ coefficients in d dimensions, so the
+ * expansion is only worth it in low dimensions.
+ */
+class GaussianSeries
+{
+ public:
+  /**
+   * Build the tables of the expansion.
+   *
+   * @param dimensionality Dimensionality of the data.
+   * @param order Order of the expansion (number of terms of the series in one
+   *     dimension).
+   * @param bandwidth Bandwidth of the Gaussian kernel.
+   */
+  GaussianSeries(const size_t dimensionality,
+                 const size_t order,
+                 const double bandwidth);
+
+  /**
+   * Compute the number of coefficients of an expansion of the given order, as
+   * a double so that it doesn't overflow.
+   */
+  static double NumTerms(const size_t dimensionality, const size_t order);
+
+  //! Get the number of coefficients of the expansion.
+  size_t NumTerms() const { return parents.size(); }
+
+  //! Get the order of the expansion.
+  size_t Order() const { return order; }
+
+  //! Get the bandwidth of the kernel.
+  double Bandwidth() const { return bandwidth; }
+
+  //! Check whether the statistic holds coefficients of this expansion.
+  bool HasCoefficients(const KDEStat& stat) const
+  {
+    return stat.SeriesOrder() == order && stat.SeriesBandwidth() == bandwidth;
+  }
+
+  /**
+   * Compute the center, the radius and the coefficients of the expansion of
+   * the given node, and store them in its statistic.
+   */
+  template<typename TreeType>
+  void ComputeCoefficients(TreeType& node) const;
+
+  /**
+   * Get the bound on the error of each kernel value, for query points within
+   * the given distance of the center of the node.
+   */
+  double TruncationError(const double queryRadius,
+                         const KDEStat& stat) const;
+
+  //! Get the distance between the given point and the center of the node.
+  template<typename VecType>
+  double CenterDistance(const VecType& query, const KDEStat& stat) const
+  {
+    return arma::norm(query - stat.SeriesCenter(), 2);
+  }
+
+  /**
+   * Approximate the sum of the kernel values between the given point and all
+   * the descendants of the node.
+   */
+  template<typename VecType>
+  double Evaluate(const VecType& query, const KDEStat& stat) const;
+
+ private:
+  //! Compute the monomials (delta)^alpha of each multi-index alpha.
+  void Monomials(const arma::vec& delta, arma::vec& monomials) const;
+
+  //! The dimensionality of the data.
+  size_t dimensionality;
+  //! The order of the expansion.
+  size_t order;
+  //! The bandwidth of the kernel.
+  double bandwidth;
+  //! The squared scale of the expansion, 2 * bandwidth^2.
+  double scale2;
+
+  //! Each monomial is the monomial of its parent times one coordinate...
+  std::vector<size_t> parents;
+  //! ... the coordinate in this vector.
+  std::vector<size_t> dims;
+  //! The constant 2^|alpha| / alpha! of each multi-index.
+  arma::vec constants;
+};
+
+//! Get the bandwidth of a Gaussian kernel.
+inline double GaussianBandwidth(const kernel::GaussianKernel& kernel)
+{
+  return kernel.Bandwidth();
+}
+
+//! Other kernels have no Gaussian series expansion.
+template<typename KernelType>
+double GaussianBandwidth(const KernelType& /* kernel */)
+{
+  return 0.0;
+}
+
+} // namespace kde
+} // namespace mlpack
+
+// Include implementation.
+#include "kde_series_impl.hpp"
+
+#endif
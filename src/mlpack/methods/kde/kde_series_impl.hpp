@@ -0,0 +1,137 @@
+/**
+ * @file methods/kde/kde_series_impl.hpp
+ *
+ * Implementation of GaussianSeries.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KDE_SERIES_IMPL_HPP
+#define MLPACK_METHODS_KDE_SERIES_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "kde_series.hpp"
+
+namespace mlpack {
+namespace kde {
+
+inline GaussianSeries::GaussianSeries(const size_t dimensionality,
+                                      const size_t order,
+                                      const double bandwidth) :
+    dimensionality(dimensionality),
+    order(order),
+    bandwidth(bandwidth),
+    scale2(2 * bandwidth * bandwidth)
+{
+  if (order == 0)
+    throw std::invalid_argument("GaussianSeries: the order must be positive");
+
+  // The multi-indices are generated degree by degree: the monomials of degree
+  // k that end with coordinate i are the monomials of degree k - 1 that only
+  // use coordinates i and up, times coordinate i.  heads[i] is the first
+  // monomial of the previous degree that only uses coordinates i and up.
+  std::vector<size_t> heads(dimensionality, 0);
+  std::vector<std::vector<size_t>> exponents(1,
+      std::vector<size_t>(dimensionality, 0));
+  std::vector<double> termConstants(1, 1.0);
+  parents.assign(1, 0);
+  dims.assign(1, 0);
+
+  size_t tail = 1;
+  for (size_t degree = 1; degree < order; ++degree)
+  {
+    for (size_t i = 0; i < dimensionality; ++i)
+    {
+      const size_t head = heads[i];
+      heads[i] = parents.size();
+      for (size_t j = head; j < tail; ++j)
+      {
+        std::vector<size_t> exponent = exponents[j];
+        ++exponent[i];
+
+        // 2^|alpha| / alpha! grows by 2 / alpha_i with each new factor.
+        termConstants.push_back(termConstants[j] * 2.0 / exponent[i]);
+        exponents.push_back(std::move(exponent));
+        parents.push_back(j);
+        dims.push_back(i);
+      }
+    }
+    tail = parents.size();
+  }
+
+  constants = arma::vec(termConstants);
+}
+
+inline double GaussianSeries::NumTerms(const size_t dimensionality,
+                                       const size_t order)
+{
+  // (order - 1 + dimensionality) choose dimensionality.
+  double terms = 1.0;
+  for (size_t i = 1; i <= dimensionality; ++i)
+    terms *= (double) (order - 1 + i) / (double) i;
+  return terms;
+}
+
+template<typename TreeType>
+void GaussianSeries::ComputeCoefficients(TreeType& node) const
+{
+  KDEStat& stat = node.Stat();
+  node.Center(stat.SeriesCenter());
+
+  arma::vec coefficients(NumTerms(), arma::fill::zeros);
+  arma::vec monomials;
+  double radius = 0.0;
+  for (size_t i = 0; i < node.NumDescendants(); ++i)
+  {
+    const arma::vec delta = node.Dataset().col(node.Descendant(i)) -
+        stat.SeriesCenter();
+    const double distance2 = arma::dot(delta, delta);
+    radius = std::max(radius, std::sqrt(distance2));
+
+    Monomials(delta / std::sqrt(scale2), monomials);
+    coefficients += std::exp(-distance2 / scale2) * monomials;
+  }
+
+  stat.SeriesCoefficients() = coefficients % constants;
+  stat.SeriesRadius() = radius;
+  stat.SeriesOrder() = order;
+  stat.SeriesBandwidth() = bandwidth;
+}
+
+inline double GaussianSeries::TruncationError(const double queryRadius,
+                                              const KDEStat& stat) const
+{
+  const double x = 2 * queryRadius * stat.SeriesRadius() / scale2;
+  double error = 1.0;
+  for (size_t i = 1; i <= order; ++i)
+    error *= x / i;
+  return error;
+}
+
+template<typename VecType>
+double GaussianSeries::Evaluate(const VecType& query,
+                                const KDEStat& stat) const
+{
+  const arma::vec delta = query - stat.SeriesCenter();
+  arma::vec monomials;
+  Monomials(delta / std::sqrt(scale2), monomials);
+
+  return std::exp(-arma::dot(delta, delta) / scale2) *
+      arma::dot(stat.SeriesCoefficients(), monomials);
+}
+
+inline void GaussianSeries::Monomials(const arma::vec& delta,
+                                      arma::vec& monomials) const
+{
+  monomials.set_size(NumTerms());
+  monomials[0] = 1.0;
+  for (size_t t = 1; t < monomials.n_elem; ++t)
+    monomials[t] = monomials[parents[t]] * delta[dims[t]];
+}
+
+} // namespace kde
+} // namespace mlpack
+
+#endif
@@ -29,7 +29,10 @@ class KDEStat
       mcBeta(0),
       mcAlpha(0),
       accumAlpha(0),
-      accumError(0)
+      accumError(0),
+      seriesRadius(0),
+      seriesBandwidth(0),
+      seriesOrder(0)
   { /* Nothing to do.*/ }
 
   //! Initialization for a fully initialized node.
@@ -38,7 +41,10 @@ class KDEStat
       mcBeta(0),
       mcAlpha(0),
       accumAlpha(0),
-      accumError(0)
+      accumError(0),
+      seriesRadius(0),
+      seriesBandwidth(0),
+      seriesOrder(0)
   { /* Nothing to do. */ }
 
   //! Get accumulated Monte Carlo alpha of the node.
@@ -65,6 +71,37 @@ class KDEStat
   //! Modify Monte Carlo alpha of the node.
   inline double& MCAlpha() { return mcAlpha; }
 
+  //! Get the center of the series expansion of the node.
+  inline const arma::vec& SeriesCenter() const { return seriesCenter; }
+
+  //! Modify the center of the series expansion of the node.
+  inline arma::vec& SeriesCenter() { return seriesCenter; }
+
+  //! Get the distance from the center to the furthest descendant.
+  inline double SeriesRadius() const { return seriesRadius; }
+
+  //! Modify the distance from the center to the furthest descendant.
+  inline double& SeriesRadius() { return seriesRadius; }
+
+  //! Get the coefficients of the series expansion of the node.
+  inline const arma::vec& SeriesCoefficients() const
+  { return seriesCoefficients; }
+
+  //! Modify the coefficients of the series expansion of the node.
+  inline arma::vec& SeriesCoefficients() { return seriesCoefficients; }
+
+  //! Get the bandwidth the coefficients were computed for.
+  inline double SeriesBandwidth() const { return seriesBandwidth; }
+
+  //! Modify the bandwidth the coefficients were computed for.
+  inline double& SeriesBandwidth() { return seriesBandwidth; }
+
+  //! Get the order of the expansion (0 if there are no coefficients).
+  inline size_t SeriesOrder() const { return seriesOrder; }
+
+  //! Modify the order of the expansion (0 if there are no coefficients).
+  inline size_t& SeriesOrder() { return seriesOrder; }
+
   //! Serialize the statistic to/from an archive.
   template<typename Archive>
   void serialize(Archive& ar, const unsigned int version)
@@ -97,6 +134,16 @@ class KDEStat
       accumAlpha = -1;
       accumError = -1;
     }
+
+    // The series expansion is a cache that is recomputed when needed.
+    if (Archive::is_loading::value)
+    {
+      seriesCenter.clear();
+      seriesRadius = 0;
+      seriesCoefficients.clear();
+      seriesBandwidth = 0;
+      seriesOrder = 0;
+    }
   }
 
  private:
@@ -111,6 +158,21 @@ class KDEStat
 
   //! Accumulated not used error tolerance in the current node.
   double accumError;
+
+  //! Center of the series expansion.
+  arma::vec seriesCenter;
+
+  //! Distance from the center to the furthest descendant.
+  double seriesRadius;
+
+  //! Coefficients of the series expansion.
+  arma::vec seriesCoefficients;
+
+  //! Bandwidth the coefficients were computed for.
+  double seriesBandwidth;
+
+  //! Order of the expansion (0 if there are no coefficients).
+  size_t seriesOrder;
 };
 
 } // namespace kde
@@ -30,6 +30,7 @@
 #include <mlpack/methods/nystroem_method/kmeans_selection.hpp>
 #include <mlpack/methods/nystroem_method/nystroem_method.hpp>
 #include <mlpack/methods/kernel_pca/kernel_rules/nystroem_method.hpp>
+#include <mlpack/methods/kernel_pca/kernel_rules/random_fourier_method.hpp>
 
 #include "kernel_pca.hpp"
 
@@ -96,7 +97,14 @@ BINDING_LONG_DESC(
     "the kernel matrix; to specify the sampling scheme, the " +
     PRINT_PARAM_STRING("sampling") + " parameter is used.  The "
     "sampling scheme for the Nystroem method can be chosen from the "
-    "following list: 'kmeans', 'random', 'ordered'.");
+    "following list: 'kmeans', 'random', 'ordered'."
+    "\n\n"
+    "For the 'gaussian' and 'laplacian' kernels, kernel PCA can instead be "
+    "approximated with 1000 random Fourier features (\"Random features for "
+    "large-scale kernel machines\", 2008) by specifying the " +
+    PRINT_PARAM_STRING("random_fourier") + " parameter.  This costs time "
+    "linear in the number of points, and the output has at most 1000 "
+    "dimensions.");
 
 // Example.
 BINDING_EXAMPLE(
@@ -128,6 +136,8 @@ PARAM_FLAG("center", "If set, the transformed data will be centered about the "
     "origin.", "c");
 
 PARAM_FLAG("nystroem_method", "If set, the Nystroem method will be used.", "n");
+PARAM_FLAG("random_fourier", "If set, random Fourier features will be used "
+    "(only for the 'gaussian' and 'laplacian' kernels).", "");
 
 PARAM_STRING_IN("sampling", "Sampling scheme to use for the Nystroem method: "
     "'kmeans', 'random', 'ordered'", "s", "kmeans");
@@ -140,16 +150,50 @@ PARAM_DOUBLE_IN("bandwidth", "Bandwidth, for 'gaussian' and 'laplacian' "
 PARAM_DOUBLE_IN("degree", "Degree of polynomial, for 'polynomial' kernel.", "D",
     1.0);
 
+//! Run KPCA with random Fourier features, for kernels that support them.
+template<typename KernelType>
+void RunRandomFourierKPCA(
+    arma::mat& dataset,
+    const bool centerTransformedData,
+    const size_t newDim,
+    KernelType& kernel,
+    const typename std::enable_if<
+        SpectralDistribution<KernelType>::IsDefined>::type* = 0)
+{
+  KernelPCA<KernelType, RandomFourierKernelRule<KernelType> > kpca(kernel,
+      centerTransformedData);
+  kpca.Apply(dataset, newDim);
+}
+
+//! Random Fourier features can't be used for other kernels.
+template<typename KernelType>
+void RunRandomFourierKPCA(
+    arma::mat& /* dataset */,
+    const bool /* centerTransformedData */,
+    const size_t /* newDim */,
+    KernelType& /* kernel */,
+    const typename std::enable_if<
+        !SpectralDistribution<KernelType>::IsDefined>::type* = 0)
+{
+  Log::Fatal << "Random Fourier features can only be used with the 'gaussian' "
+      << "and 'laplacian' kernels!" << endl;
+}
+
 //! Run RunKPCA on the specified dataset for the given kernel type.
 template<typename KernelType>
 void RunKPCA(arma::mat& dataset,
              const bool centerTransformedData,
              const bool nystroem,
+             const bool randomFourier,
              const size_t newDim,
              const string& sampling,
              KernelType& kernel)
 {
-  if (nystroem)
+  if (randomFourier)
+  {
+    RunRandomFourierKPCA(dataset, centerTransformedData, newDim, kernel);
+  }
+  else if (nystroem)
   {
     // Make sure the sampling scheme is valid.
     if (sampling == "kmeans")
@@ -213,21 +257,33 @@ static void mlpackMain()
 
   const bool centerTransformedData = IO::HasParam("center");
   const bool nystroem = IO::HasParam("nystroem_method");
+  const bool randomFourier = IO::HasParam("random_fourier");
+  if (nystroem && randomFourier)
+  {
+    Log::Fatal << "Cannot specify both " << PRINT_PARAM_STRING(
+        "nystroem_method") << " and " << PRINT_PARAM_STRING("random_fourier")
+        << "!" << endl;
+  }
+  if (randomFourier && kernelType != "gaussian" && kernelType != "laplacian")
+  {
+    Log::Fatal << "Random Fourier features can only be used with the "
+        << "'gaussian' and 'laplacian' kernels!" << endl;
+  }
   const string sampling = IO::GetParam<string>("sampling");
 
   if (kernelType == "linear")
   {
     LinearKernel kernel;
-    RunKPCA<LinearKernel>(dataset, centerTransformedData, nystroem, newDim,
-        sampling, kernel);
+    RunKPCA<LinearKernel>(dataset, centerTransformedData, nystroem,
+        randomFourier, newDim, sampling, kernel);
   }
   else if (kernelType == "gaussian")
   {
     const double bandwidth = IO::GetParam<double>("bandwidth");
 
     GaussianKernel kernel(bandwidth);
-    RunKPCA<GaussianKernel>(dataset, centerTransformedData, nystroem, newDim,
-        sampling, kernel);
+    RunKPCA<GaussianKernel>(dataset, centerTransformedData, nystroem,
+        randomFourier, newDim, sampling, kernel);
   }
   else if (kernelType == "polynomial")
   {
@@ -236,7 +292,7 @@ static void mlpackMain()
 
     PolynomialKernel kernel(degree, offset);
     RunKPCA<PolynomialKernel>(dataset, centerTransformedData, nystroem,
-        newDim, sampling, kernel);
+        randomFourier, newDim, sampling, kernel);
   }
   else if (kernelType == "hyptan")
   {
@@ -245,15 +301,15 @@ static void mlpackMain()
 
     HyperbolicTangentKernel kernel(scale, offset);
     RunKPCA<HyperbolicTangentKernel>(dataset, centerTransformedData, nystroem,
-        newDim, sampling, kernel);
+        randomFourier, newDim, sampling, kernel);
   }
   else if (kernelType == "laplacian")
   {
     const double bandwidth = IO::GetParam<double>("bandwidth");
 
     LaplacianKernel kernel(bandwidth);
-    RunKPCA<LaplacianKernel>(dataset, centerTransformedData, nystroem, newDim,
-        sampling, kernel);
+    RunKPCA<LaplacianKernel>(dataset, centerTransformedData, nystroem,
+        randomFourier, newDim, sampling, kernel);
   }
   else if (kernelType == "epanechnikov")
   {
@@ -261,13 +317,13 @@ static void mlpackMain()
 
     EpanechnikovKernel kernel(bandwidth);
     RunKPCA<EpanechnikovKernel>(dataset, centerTransformedData, nystroem,
-        newDim, sampling, kernel);
+        randomFourier, newDim, sampling, kernel);
   }
   else if (kernelType == "cosine")
   {
     CosineDistance kernel;
-    RunKPCA<CosineDistance>(dataset, centerTransformedData, nystroem, newDim,
-        sampling, kernel);
+    RunKPCA<CosineDistance>(dataset, centerTransformedData, nystroem,
+        randomFourier, newDim, sampling, kernel);
   }
 
   // Save the output dataset.
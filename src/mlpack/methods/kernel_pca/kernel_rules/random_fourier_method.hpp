@@ -0,0 +1,88 @@
+/**
+ * @file methods/kernel_pca/kernel_rules/random_fourier_method.hpp
+ *
+ * Use random Fourier features to approximate kernel PCA.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+
+#ifndef MLPACK_METHODS_KERNEL_PCA_RANDOM_FOURIER_METHOD_HPP
+#define MLPACK_METHODS_KERNEL_PCA_RANDOM_FOURIER_METHOD_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/methods/random_fourier_features/random_fourier_features.hpp>
+
+namespace mlpack {
+namespace kpca {
+
+/**
+ * Approximate kernel PCA with random Fourier features: the points are mapped to
+ * NumFeatures random features (see kernel::RandomFourierFeatures), and linear
+ * PCA is done on the features.  This costs O(n D^2 + D^3) for D features,
+ * instead of O(n^3) for the exact kernel matrix.  Only shift-invariant kernels
+ * with a kernel::SpectralDistribution (Gaussian, Laplacian and Cauchy kernels)
+ * can be used.
+ *
+ * @tparam KernelType Shift-invariant kernel.
+ * @tparam NumFeatures Number of random features (D), and the largest number of
+ *     dimensions of the output.
+ */
+template<typename KernelType, size_t NumFeatures = 1000>
+class RandomFourierKernelRule
+{
+ public:
+  /**
+   * Apply kernel PCA on the random Fourier features of the data.
+   *
+   * @param data Input data points.
+   * @param transformedData Matrix to output results into.
+   * @param eigval KPCA eigenvalues will be written to this vector.
+   * @param eigvec Eigenvectors of the covariance of the features will be
+   *     written to this matrix.
+   * @param * (rank) Rank to be used for matrix approximation.
+   * @param kernel Kernel to be used for computation.
+   */
+  static void ApplyKernelMatrix(const arma::mat& data,
+                                arma::mat& transformedData,
+                                arma::vec& eigval,
+                                arma::mat& eigvec,
+                                const size_t /* rank */,
+                                KernelType kernel = KernelType())
+  {
+    kernel::RandomFourierFeatures<KernelType> rff(kernel, NumFeatures);
+    rff.Train(data.n_rows);
+
+    arma::mat features;
+    rff.Transform(data, features);
+
+    // Center the features; this is the same as centering the approximate
+    // kernel matrix.
+    features.each_col() -= arma::mean(features, 1);
+
+    // Eigendecompose the covariance of the features, whose eigenvalues are
+    // those of the centered approximate kernel matrix.
+    arma::mat covariance = features * features.t();
+    if (!arma::eig_sym(eigval, eigvec, covariance))
+    {
+      Log::Fatal << "Failed to construct the kernel matrix." << std::endl;
+    }
+
+    // Swap the eigenvalues since they are ordered backwards (we need largest
+    // to smallest).
+    for (size_t i = 0; i < floor(eigval.n_elem / 2.0); ++i)
+      eigval.swap_rows(i, (eigval.n_elem - 1) - i);
+
+    // Flip the coefficients to produce the same effect.
+    eigvec = arma::fliplr(eigvec);
+
+    transformedData = eigvec.t() * features;
+  }
+};
+
+} // namespace kpca
+} // namespace mlpack
+
+#endif
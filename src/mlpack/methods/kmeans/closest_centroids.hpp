@@ -0,0 +1,168 @@
+/**
+ * @file methods/kmeans/closest_centroids.hpp
+ *
+ * Definition of ClosestCentroids, which finds the closest centroid to each
+ * point of a block of points.  For the Euclidean distance the distances between
+ * the whole block and every centroid are computed with one matrix
+ * multiplication.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KMEANS_CLOSEST_CENTROIDS_HPP
+#define MLPACK_METHODS_KMEANS_CLOSEST_CENTROIDS_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/metrics/lmetric.hpp>
+
+namespace mlpack {
+namespace kmeans {
+
+/**
+ * ClosestCentroids finds the closest centroid to each point of a contiguous
+ * block of points of a dataset.  For dense datasets with the Euclidean or
+ * squared Euclidean distance, the squared distances are computed as
+ *
+ *   d(x, c)^2 = ||x||^2 + ||c||^2 - 2 x^T c
+ *
+ * for the whole block at once, so the work is one matrix multiplication.  The
+ * centroids whose distance is within the rounding error of the smallest one are
+ * checked again with the metric, so the assignments are the same as when every
+ * distance is computed with the metric (ties go to the lowest index).  Sparse
+ * (arma::sp_mat) datasets are handled the same way: the products x^T c are
+ * computed from the nonzero values of the points only, so a block costs
+ * O(nnz * k) instead of O(d * k) per point.  For other metrics, every distance
+ * is computed with the metric.
+ *
+ * The object can be shared between threads.
+ *
+ * @tparam MetricType Type of metric.
+ * @tparam MatType Type of the dataset.
+ */
+template<typename MetricType, typename MatType>
+class ClosestCentroids
+{
+ public:
+  //! The number of points a block should hold for a matrix multiplication to
+  //! pay off.
+  static const size_t BlockSize = 256;
+
+  /**
+   * Prepare to search for the closest of the given centroids.  The dataset and
+   * the centroids must outlive the object.
+   *
+   * @param dataset Dataset the points come from.
+   * @param centroids Cluster centroids.
+   * @param metric Instantiated metric.
+   */
+  ClosestCentroids(const MatType& dataset,
+                   const arma::mat& centroids,
+                   MetricType& metric);
+
+  /**
+   * Find the closest centroid to each of the points begin, ..., end - 1 of the
+   * dataset.
+   *
+   * @param begin Index of the first point.
+   * @param end Index one past the last point.
+   * @param assignments Vector to store the index of the closest centroid of
+   *     each point in.
+   */
+  void Assign(const size_t begin,
+              const size_t end,
+              arma::Col<size_t>& assignments) const;
+
+  /**
+   * Add the given point of a dense dataset to the given column of a matrix of
+   * centroid sums.
+   */
+  template<typename eT>
+  static void AddPoint(const arma::Mat<eT>& dataset,
+                       const size_t point,
+                       arma::mat& sums,
+                       const size_t cluster)
+  {
+    sums.unsafe_col(cluster) += dataset.col(point);
+  }
+
+  /**
+   * Add the given point of a sparse dataset to the given column of a matrix of
+   * centroid sums; only the nonzero values of the point are visited.
+   */
+  template<typename eT>
+  static void AddPoint(const arma::SpMat<eT>& dataset,
+                       const size_t point,
+                       arma::mat& sums,
+                       const size_t cluster)
+  {
+    double* sum = sums.colptr(cluster);
+    typename arma::SpMat<eT>::const_iterator it = dataset.begin_col(point);
+    for (; it != dataset.end_col(point); ++it)
+      sum[it.row()] += (*it);
+  }
+
+ private:
+  //! 1 if the distances are computed with a matrix multiplication, 0 if they
+  //! are computed one pair at a time.
+  typedef std::integral_constant<int,
+      ((std::is_same<MatType, arma::Mat<typename MatType::elem_type>>::value ||
+        std::is_same<MatType, arma::sp_mat>::value) &&
+      (std::is_same<MetricType, metric::EuclideanDistance>::value ||
+       std::is_same<MetricType, metric::SquaredEuclideanDistance>::value)) ?
+      1 : 0> BlockType;
+
+  //! Find the closest centroids with a matrix multiplication.
+  void Assign(const size_t begin,
+              const size_t end,
+              arma::Col<size_t>& assignments,
+              const std::integral_constant<int, 1>& /* gemm */) const;
+
+  /**
+   * Compute the products x^T c of the points begin, ..., end - 1 of a dense
+   * dataset with the centroids, and the squared norms of the points.
+   */
+  template<typename eT>
+  void Products(const arma::Mat<eT>& data,
+                const size_t begin,
+                const size_t end,
+                arma::mat& products,
+                arma::rowvec& pointNorms) const;
+
+  /**
+   * Compute the products x^T c of the points begin, ..., end - 1 of a sparse
+   * dataset with the centroids, and the squared norms of the points, from the
+   * nonzero values of the points.
+   */
+  void Products(const arma::sp_mat& data,
+                const size_t begin,
+                const size_t end,
+                arma::mat& products,
+                arma::rowvec& pointNorms) const;
+
+  //! Find the closest centroids one distance at a time.
+  void Assign(const size_t begin,
+              const size_t end,
+              arma::Col<size_t>& assignments,
+              const std::integral_constant<int, 0>& /* pairwise */) const;
+
+  //! The dataset.
+  const MatType& dataset;
+  //! The centroids.
+  const arma::mat& centroids;
+  //! The instantiated metric.
+  MetricType& metric;
+  //! The squared norm of each centroid (only for matrix multiplications).
+  arma::vec centroidNorms;
+  //! The transposed centroids (only for sparse matrix multiplications).
+  arma::mat centroidsT;
+};
+
+} // namespace kmeans
+} // namespace mlpack
+
+// Include implementation.
+#include "closest_centroids_impl.hpp"
+
+#endif
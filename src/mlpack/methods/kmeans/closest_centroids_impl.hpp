@@ -0,0 +1,191 @@
+/**
+ * @file methods/kmeans/closest_centroids_impl.hpp
+ *
+ * Implementation of ClosestCentroids.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KMEANS_CLOSEST_CENTROIDS_IMPL_HPP
+#define MLPACK_METHODS_KMEANS_CLOSEST_CENTROIDS_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "closest_centroids.hpp"
+
+namespace mlpack {
+namespace kmeans {
+
+template<typename MetricType, typename MatType>
+const size_t ClosestCentroids<MetricType, MatType>::BlockSize;
+
+template<typename MetricType, typename MatType>
+ClosestCentroids<MetricType, MatType>::ClosestCentroids(
+    const MatType& dataset,
+    const arma::mat& centroids,
+    MetricType& metric) :
+    dataset(dataset),
+    centroids(centroids),
+    metric(metric)
+{
+  if (BlockType::value == 1)
+    centroidNorms = arma::sum(arma::square(centroids), 0).t();
+  if (BlockType::value == 1 && std::is_same<MatType, arma::sp_mat>::value)
+    centroidsT = centroids.t();
+}
+
+template<typename MetricType, typename MatType>
+void ClosestCentroids<MetricType, MatType>::Assign(
+    const size_t begin,
+    const size_t end,
+    arma::Col<size_t>& assignments) const
+{
+  assignments.set_size(end - begin);
+  if (end == begin)
+    return;
+
+  Assign(begin, end, assignments, BlockType());
+}
+
+template<typename MetricType, typename MatType>
+void ClosestCentroids<MetricType, MatType>::Assign(
+    const size_t begin,
+    const size_t end,
+    arma::Col<size_t>& assignments,
+    const std::integral_constant<int, 1>& /* gemm */) const
+{
+  // d(x, c)^2 = ||x||^2 + ||c||^2 - 2 x^T c, for all pairs at once.
+  arma::mat distances;
+  arma::rowvec pointNorms;
+  Products(dataset, begin, end, distances, pointNorms);
+  distances *= -2.0;
+  distances.each_col() += centroidNorms;
+  distances.each_row() += pointNorms;
+
+  // Bound the rounding error of the squared distances; it grows with the norms
+  // of the points and with the dimensionality.
+  const double tolerance = 4.0 * (dataset.n_rows + 2) *
+      std::numeric_limits<double>::epsilon() * (pointNorms.max() +
+      centroidNorms.max());
+
+  for (size_t i = 0; i < distances.n_cols; ++i)
+  {
+    const double* pointDistances = distances.colptr(i);
+    const double threshold = arma::min(distances.unsafe_col(i)) +
+        2 * tolerance;
+
+    // Count the centroids that may be the closest one.
+    size_t closestCluster = centroids.n_cols; // Invalid value.
+    size_t candidates = 0;
+    for (size_t j = 0; j < centroids.n_cols; ++j)
+    {
+      if (pointDistances[j] <= threshold)
+      {
+        if (candidates == 0)
+          closestCluster = j;
+        ++candidates;
+      }
+    }
+
+    // If there are several, the rounding error could change which one is the
+    // closest, so they are checked with the metric.
+    if (candidates > 1)
+    {
+      double bestDistance = std::numeric_limits<double>::infinity();
+      for (size_t j = 0; j < centroids.n_cols; ++j)
+      {
+        if (pointDistances[j] > threshold)
+          continue;
+
+        const double distance = metric.Evaluate(dataset.col(begin + i),
+            centroids.unsafe_col(j));
+        if (distance < bestDistance)
+        {
+          bestDistance = distance;
+          closestCluster = j;
+        }
+      }
+    }
+
+    Log::Assert(closestCluster != centroids.n_cols);
+    assignments[i] = closestCluster;
+  }
+}
+
+template<typename MetricType, typename MatType>
+template<typename eT>
+void ClosestCentroids<MetricType, MatType>::Products(
+    const arma::Mat<eT>& data,
+    const size_t begin,
+    const size_t end,
+    arma::mat& products,
+    arma::rowvec& pointNorms) const
+{
+  // The block is converted to double precision, like the centroids.
+  const arma::mat block =
+      arma::conv_to<arma::mat>::from(data.cols(begin, end - 1));
+  pointNorms = arma::sum(arma::square(block), 0);
+  products = centroids.t() * block;
+}
+
+template<typename MetricType, typename MatType>
+void ClosestCentroids<MetricType, MatType>::Products(
+    const arma::sp_mat& data,
+    const size_t begin,
+    const size_t end,
+    arma::mat& products,
+    arma::rowvec& pointNorms) const
+{
+  products.zeros(centroids.n_cols, end - begin);
+  pointNorms.zeros(end - begin);
+
+  // Each nonzero value x_d adds x_d * c_d to the product with each centroid c;
+  // the transposed centroids hold the values c_d of all centroids together.
+  for (size_t i = begin; i < end; ++i)
+  {
+    double* product = products.colptr(i - begin);
+    arma::sp_mat::const_iterator it = data.begin_col(i);
+    for (; it != data.end_col(i); ++it)
+    {
+      const double value = (*it);
+      pointNorms[i - begin] += value * value;
+      const double* centroidValues = centroidsT.colptr(it.row());
+      for (size_t j = 0; j < centroids.n_cols; ++j)
+        product[j] += value * centroidValues[j];
+    }
+  }
+}
+
+template<typename MetricType, typename MatType>
+void ClosestCentroids<MetricType, MatType>::Assign(
+    const size_t begin,
+    const size_t end,
+    arma::Col<size_t>& assignments,
+    const std::integral_constant<int, 0>& /* pairwise */) const
+{
+  for (size_t i = begin; i < end; ++i)
+  {
+    double minDistance = std::numeric_limits<double>::infinity();
+    size_t closestCluster = centroids.n_cols; // Invalid value.
+
+    for (size_t j = 0; j < centroids.n_cols; ++j)
+    {
+      const double distance = metric.Evaluate(dataset.col(i),
+          centroids.unsafe_col(j));
+      if (distance < minDistance)
+      {
+        minDistance = distance;
+        closestCluster = j;
+      }
+    }
+
+    Log::Assert(closestCluster != centroids.n_cols);
+    assignments[i - begin] = closestCluster;
+  }
+}
+
+} // namespace kmeans
+} // namespace mlpack
+
+#endif
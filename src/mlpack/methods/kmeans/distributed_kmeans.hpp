@@ -0,0 +1,243 @@
+/**
+ * @file methods/kmeans/distributed_kmeans.hpp
+ *
+ * Definition of DistributedLloydStep and DistributedInitialization, which let
+ * KMeans cluster a dataset whose points are sharded across processes: each
+ * process runs the Lloyd iterations on its own shard, and the sufficient
+ * statistics of every iteration are summed over all processes with a
+ * reduction (such as MPIReduction).
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KMEANS_DISTRIBUTED_KMEANS_HPP
+#define MLPACK_METHODS_KMEANS_DISTRIBUTED_KMEANS_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "kmeans.hpp"
+#include "allow_empty_clusters.hpp"
+#include "sample_initialization.hpp"
+#include "local_reduction.hpp"
+
+namespace mlpack {
+namespace kmeans {
+
+/**
+ * A Lloyd step that runs another Lloyd step (such as NaiveKMeans or
+ * ElkanKMeans) on the shard of the dataset held by this process, and combines
+ * its result with those of the other processes.  The means and counts
+ * computed on the shard are turned into sums, which are summed over all
+ * processes with a single reduction of (d + 1) x k values; so every process
+ * obtains the centroids of the whole dataset, while only its own points are
+ * ever read.
+ *
+ * The wrapped step must compute the means of the points closest to each
+ * centroid, and support being given centroids other than those it computed;
+ * NaiveKMeans and ElkanKMeans do.  For the processes to stay in step, the
+ * initial centroids must be the same everywhere (use
+ * DistributedInitialization, or an initial guess), and the empty cluster
+ * policy must only depend on the counts and the centroids (AllowEmptyClusters
+ * or KillEmptyClusters, but not MaxVarianceNewCluster).  DistributedKMeans
+ * gathers these choices.
+ *
+ * KMeans constructs the step itself, so the reduction of the step is not
+ * given to its constructor: when KMeans runs the step with a
+ * DistributedInitialization policy of the same reduction type, the reduction
+ * of that policy is copied into the step (see ConfigureStep()).  So the
+ * initialization and every iteration reduce over the same processes, even
+ * with a reduction that is not default-constructed, like MPIReduction over
+ * another communicator than MPI_COMM_WORLD.
+ *
+ * @tparam MetricType Type of metric used with this implementation.
+ * @tparam MatType Matrix type (arma::mat or arma::sp_mat).
+ * @tparam LloydStepType Lloyd step run on the shard of this process.
+ * @tparam ReductionType Reduction over the processes (see LocalReduction).
+ */
+template<typename MetricType,
+         typename MatType,
+         template<class, class> class LloydStepType = NaiveKMeans,
+         typename ReductionType = LocalReduction>
+class DistributedLloydStep
+{
+ public:
+  /**
+   * Construct the step with the shard of the dataset held by this process, and
+   * the given metric.
+   *
+   * @param dataset Shard of the dataset.
+   * @param metric Instantiated metric.
+   */
+  DistributedLloydStep(const MatType& dataset, MetricType& metric);
+
+  /**
+   * Run a single iteration of the Lloyd algorithm over all the shards,
+   * updating the given centroids into the newCentroids matrix.  Every process
+   * must call this with the same centroids, and obtains the same new centroids
+   * and counts (of the points of all shards).
+   *
+   * @param centroids Current cluster centroids.
+   * @param newCentroids New cluster centroids.
+   * @param counts Number of points in each cluster at the end of the iteration.
+   */
+  double Iterate(const arma::mat& centroids,
+                 arma::mat& newCentroids,
+                 arma::Col<size_t>& counts);
+
+  //! Get the number of distance calculations on the shard of this process.
+  size_t DistanceCalculations() const { return step.DistanceCalculations(); }
+
+  //! Get the reduction over the processes.
+  const ReductionType& Reduction() const { return reduction; }
+  //! Modify the reduction over the processes.
+  ReductionType& Reduction() { return reduction; }
+
+ private:
+  //! The step run on the shard of this process.
+  LloydStepType<MetricType, MatType> step;
+  //! The instantiated metric.
+  MetricType& metric;
+  //! The reduction over the processes.
+  ReductionType reduction;
+  //! The sums (and, in the last row, the counts) of the points of each cluster.
+  arma::mat statistics;
+};
+
+/**
+ * Wrap the given Lloyd step and reduction as a template taking the metric and
+ * matrix types, as KMeans expects; DistributedStep<R, S>::template Type is the
+ * step type.
+ */
+template<typename ReductionType,
+         template<class, class> class LloydStepType = NaiveKMeans>
+struct DistributedStep
+{
+  template<typename MetricType, typename MatType>
+  using Type = DistributedLloydStep<MetricType, MatType, LloydStepType,
+      ReductionType>;
+};
+
+/**
+ * An initial partition policy that gives the same initial centroids to every
+ * process.  When the wrapped policy gives centroids (like
+ * SampleInitialization), those of the first process (computed on its shard)
+ * are broadcast to the others; when it gives assignments (like
+ * RandomPartition), the centroids are the means of the assigned points of all
+ * shards.
+ *
+ * @tparam InitialPartitionPolicy Policy run on the shard of this process.
+ * @tparam ReductionType Reduction over the processes (see LocalReduction).
+ */
+template<typename InitialPartitionPolicy = SampleInitialization,
+         typename ReductionType = LocalReduction>
+class DistributedInitialization
+{
+ public:
+  /**
+   * Create the policy.
+   *
+   * @param partitioner Instantiated policy run on the shard of this process.
+   * @param reduction Instantiated reduction over the processes.
+   */
+  DistributedInitialization(
+      const InitialPartitionPolicy& partitioner = InitialPartitionPolicy(),
+      const ReductionType& reduction = ReductionType()) :
+      partitioner(partitioner),
+      reduction(reduction)
+  { }
+
+  /**
+   * Compute the initial centroids, which are the same on every process.
+   *
+   * @param data Shard of the dataset held by this process.
+   * @param clusters Number of clusters.
+   * @param centroids Matrix to put initial centroids into.
+   */
+  template<typename MatType>
+  void Cluster(const MatType& data,
+               const size_t clusters,
+               arma::mat& centroids);
+
+  //! Get the wrapped policy.
+  const InitialPartitionPolicy& Partitioner() const { return partitioner; }
+  //! Modify the wrapped policy.
+  InitialPartitionPolicy& Partitioner() { return partitioner; }
+
+  //! Get the reduction over the processes.
+  const ReductionType& Reduction() const { return reduction; }
+  //! Modify the reduction over the processes.
+  ReductionType& Reduction() { return reduction; }
+
+  //! Serialize the policy.
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */)
+  {
+    ar & BOOST_SERIALIZATION_NVP(partitioner);
+  }
+
+ private:
+  //! The policy run on the shard of this process.
+  InitialPartitionPolicy partitioner;
+  //! The reduction over the processes.
+  ReductionType reduction;
+};
+
+/**
+ * Give the distributed step run by KMeans the reduction of its
+ * DistributedInitialization policy.  This overload is chosen over the one that
+ * does nothing (in kmeans_impl.hpp) when the policy and the step use the same
+ * reduction type.
+ */
+template<typename InitialPartitionPolicy,
+         typename ReductionType,
+         typename MetricType,
+         typename MatType,
+         template<class, class> class LloydStepType>
+void ConfigureStep(
+    const DistributedInitialization<InitialPartitionPolicy, ReductionType>&
+        partitioner,
+    DistributedLloydStep<MetricType, MatType, LloydStepType, ReductionType>&
+        step)
+{
+  step.Reduction() = partitioner.Reduction();
+}
+
+/**
+ * KMeans on a dataset sharded across processes, with the given reduction:
+ * every process calls Cluster() with its own shard, and obtains the same
+ * centroids (and the assignments of its own points).  For instance,
+ * DistributedKMeans<MPIReduction, ElkanKMeans> runs Elkan's algorithm over MPI
+ * processes.  The initial centroids are those of InitialPartitionPolicy on the
+ * first process, and empty clusters keep their previous centroid (the empty
+ * cluster policy can also be KillEmptyClusters).  A reduction that is not
+ * default-constructed is given with the initial partition policy, and is then
+ * used by every iteration too:
+ *
+ * @code
+ * typedef DistributedKMeans<MPIReduction> KMeansType;
+ * KMeansType kmeans(1000, metric::EuclideanDistance(),
+ *     DistributedInitialization<SampleInitialization, MPIReduction>(
+ *     SampleInitialization(), MPIReduction(communicator)));
+ * kmeans.Cluster(shard, 10, assignments, centroids);
+ * @endcode
+ */
+template<typename ReductionType = LocalReduction,
+         template<class, class> class LloydStepType = NaiveKMeans,
+         typename MetricType = metric::EuclideanDistance,
+         typename InitialPartitionPolicy = SampleInitialization,
+         typename EmptyClusterPolicy = AllowEmptyClusters,
+         typename MatType = arma::mat>
+using DistributedKMeans = KMeans<MetricType,
+    DistributedInitialization<InitialPartitionPolicy, ReductionType>,
+    EmptyClusterPolicy,
+    DistributedStep<ReductionType, LloydStepType>::template Type,
+    MatType>;
+
+} // namespace kmeans
+} // namespace mlpack
+
+// Include implementation.
+#include "distributed_kmeans_impl.hpp"
+
+#endif
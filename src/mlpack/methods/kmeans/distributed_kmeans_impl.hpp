@@ -0,0 +1,111 @@
+/**
+ * @file methods/kmeans/distributed_kmeans_impl.hpp
+ *
+ * Implementation of DistributedLloydStep and DistributedInitialization.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KMEANS_DISTRIBUTED_KMEANS_IMPL_HPP
+#define MLPACK_METHODS_KMEANS_DISTRIBUTED_KMEANS_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "distributed_kmeans.hpp"
+
+namespace mlpack {
+namespace kmeans {
+
+template<typename MetricType,
+         typename MatType,
+         template<class, class> class LloydStepType,
+         typename ReductionType>
+DistributedLloydStep<MetricType, MatType, LloydStepType, ReductionType>::
+DistributedLloydStep(const MatType& dataset, MetricType& metric) :
+    step(dataset, metric),
+    metric(metric)
+{ /* Nothing to do. */ }
+
+template<typename MetricType,
+         typename MatType,
+         template<class, class> class LloydStepType,
+         typename ReductionType>
+double DistributedLloydStep<MetricType, MatType, LloydStepType,
+    ReductionType>::Iterate(const arma::mat& centroids,
+                            arma::mat& newCentroids,
+                            arma::Col<size_t>& counts)
+{
+  // Run the iteration on the shard of this process.
+  step.Iterate(centroids, newCentroids, counts);
+
+  // Turn the means of the shard back into sums; the centroids of empty
+  // clusters may hold invalid data, so they are skipped.
+  const size_t dimensionality = centroids.n_rows;
+  statistics.zeros(dimensionality + 1, centroids.n_cols);
+  for (size_t c = 0; c < centroids.n_cols; ++c)
+  {
+    if (counts[c] == 0)
+      continue;
+
+    statistics.submat(0, c, dimensionality - 1, c) =
+        newCentroids.col(c) * (double) counts[c];
+    statistics(dimensionality, c) = (double) counts[c];
+  }
+
+  // Sum the statistics of all the shards.
+  reduction.Sum(statistics.memptr(), statistics.n_elem);
+
+  newCentroids = statistics.head_rows(dimensionality);
+  double cNorm = 0.0;
+  for (size_t c = 0; c < centroids.n_cols; ++c)
+  {
+    // The counts are exact, as long as there are fewer than 2^53 points.
+    counts[c] = (size_t) (statistics(dimensionality, c) + 0.5);
+    if (counts[c] != 0)
+      newCentroids.col(c) /= statistics(dimensionality, c);
+
+    cNorm += std::pow(metric.Evaluate(centroids.col(c), newCentroids.col(c)),
+        2.0);
+  }
+
+  return std::sqrt(cNorm);
+}
+
+template<typename InitialPartitionPolicy, typename ReductionType>
+template<typename MatType>
+void DistributedInitialization<InitialPartitionPolicy, ReductionType>::Cluster(
+    const MatType& data,
+    const size_t clusters,
+    arma::mat& centroids)
+{
+  arma::Row<size_t> assignments;
+  if (!GetInitialAssignmentsOrCentroids(partitioner, data, clusters,
+      assignments, centroids))
+  {
+    // Every process takes the centroids of the first one.
+    reduction.Broadcast(centroids.memptr(), centroids.n_elem);
+    return;
+  }
+
+  // Sum the assigned points (and, in the last row, count them) over all
+  // shards.
+  arma::mat statistics(data.n_rows + 1, clusters, arma::fill::zeros);
+  for (size_t i = 0; i < data.n_cols; ++i)
+  {
+    statistics.submat(0, assignments[i], data.n_rows - 1, assignments[i]) +=
+        arma::vec(data.col(i));
+    statistics(data.n_rows, assignments[i]) += 1.0;
+  }
+  reduction.Sum(statistics.memptr(), statistics.n_elem);
+
+  centroids = statistics.head_rows(data.n_rows);
+  for (size_t c = 0; c < clusters; ++c)
+    if (statistics(data.n_rows, c) != 0.0)
+      centroids.col(c) /= statistics(data.n_rows, c);
+}
+
+} // namespace kmeans
+} // namespace mlpack
+
+#endif
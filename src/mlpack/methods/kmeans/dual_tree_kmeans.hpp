@@ -30,6 +30,13 @@ namespace kmeans {
  * dataset.  The conditions under which this will perform best are probably
  * limited to the case where k is close to the number of points in the dataset,
  * and the number of iterations of the k-means algorithm will be few.
+ *
+ * The tree on the centroids is kept between iterations.  When the tree type
+ * supports it (the BinarySpaceTree types) and the centroids moved by less than
+ * a tenth of the radius of the tree in the last iteration, the centroids are
+ * moved in place and only the bounds of the tree are recomputed; otherwise the
+ * tree is rebuilt.  As the centroids converge, the late iterations then avoid
+ * the cost of building a tree.
  */
 template<
     typename MetricType,
@@ -77,6 +84,9 @@ class DualTreeKMeans
   size_t DistanceCalculations() const { return distanceCalculations; }
   //! Modify the number of distance calculations.
   size_t& DistanceCalculations() { return distanceCalculations; }
+  //! Return the number of times the tree on the centroids was built (instead
+  //! of being refitted).
+  size_t CentroidTreeBuilds() const { return centroidTreeBuilds; }
 
  private:
   //! The original dataset reference.
@@ -88,6 +98,16 @@ class DualTreeKMeans
   //! The metric.
   MetricType metric;
 
+  //! The search type on the centroids.
+  typedef neighbor::NeighborSearch<neighbor::NearestNeighborSort, MetricType,
+      MatType, NNSTreeType> CentroidSearchType;
+  //! The search on the centroids, kept between iterations.
+  CentroidSearchType* centroidSearch;
+  //! The mapping from the centroids of the tree to the original centroids.
+  std::vector<size_t> oldFromNewCentroids;
+  //! The number of times the tree on the centroids was built.
+  size_t centroidTreeBuilds;
+
   //! Track distance calculations.
   size_t distanceCalculations;
   //! Track iteration number.
@@ -127,6 +147,27 @@ class DualTreeKMeans
 
   void CoalesceTree(Tree& node, const size_t child = 0);
   void DecoalesceTree(Tree& node);
+
+  // SFINAE check for trees whose bounds can be recomputed in place.
+  HAS_MEM_FUNC(RefitBounds, HasRefitBounds);
+
+  //! Move the centroids of the existing tree in place and recompute its
+  //! bounds, if they moved little enough; return whether it was refitted.
+  template<typename TreeT = Tree>
+  bool RefitCentroidTree(
+      const arma::mat& centroids,
+      const typename std::enable_if_t<HasRefitBounds<TreeT,
+          void(TreeT::*)()>::value>* = 0);
+
+  //! Trees that can't be refitted are always rebuilt.
+  template<typename TreeT = Tree>
+  bool RefitCentroidTree(
+      const arma::mat& /* centroids */,
+      const typename std::enable_if_t<!HasRefitBounds<TreeT,
+          void(TreeT::*)()>::value>* = 0)
+  {
+    return false;
+  }
 };
 
 //! Utility function for hiding children.  This actually does something, and is
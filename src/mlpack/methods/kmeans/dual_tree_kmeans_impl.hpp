@@ -59,6 +59,8 @@ DualTreeKMeans<MetricType, MatType, TreeType>::DualTreeKMeans(
     tree(new Tree(const_cast<MatType&>(dataset))),
     dataset(tree->Dataset()),
     metric(metric),
+    centroidSearch(NULL),
+    centroidTreeBuilds(0),
     distanceCalculations(0),
     iteration(0),
     upperBounds(dataset.n_cols),
@@ -86,6 +88,8 @@ DualTreeKMeans<MetricType, MatType, TreeType>::~DualTreeKMeans()
 {
   if (tree)
     delete tree;
+  if (centroidSearch)
+    delete centroidSearch;
 }
 
 // Run a single iteration.
@@ -99,16 +103,26 @@ double DualTreeKMeans<MetricType, MatType, TreeType>::Iterate(
     arma::mat& newCentroids,
     arma::Col<size_t>& counts)
 {
-  // Build a tree on the centroids.  This will make a copy if necessary, which
-  // is unfortunate, but I don't see a reasonable way around it.
-  std::vector<size_t> oldFromNewCentroids;
-  Tree* centroidTree = BuildTree<Tree>(centroids, oldFromNewCentroids);
-
-  // Find the nearest neighbors of each of the clusters.  We have to make our
-  // own TreeType, which is a little bit abuse, but we know for sure the
-  // TreeStatType we have will work.
-  neighbor::NeighborSearch<neighbor::NearestNeighborSort, MetricType, MatType,
-      NNSTreeType> nns(std::move(*centroidTree));
+  // Reuse the tree on the centroids of the last iteration if possible, and
+  // build a tree on the centroids otherwise.  This will make a copy if
+  // necessary, which is unfortunate, but I don't see a reasonable way around
+  // it.
+  if (centroidSearch == NULL ||
+      centroidSearch->ReferenceSet().n_cols != centroids.n_cols ||
+      !RefitCentroidTree(centroids))
+  {
+    delete centroidSearch;
+    oldFromNewCentroids.clear();
+    Tree* centroidTree = BuildTree<Tree>(centroids, oldFromNewCentroids);
+
+    // Find the nearest neighbors of each of the clusters.  We have to make our
+    // own TreeType, which is a little bit abuse, but we know for sure the
+    // TreeStatType we have will work.
+    centroidSearch = new CentroidSearchType(std::move(*centroidTree));
+    delete centroidTree;
+    ++centroidTreeBuilds;
+  }
+  CentroidSearchType& nns = *centroidSearch;
 
   // Reset information in the tree, if we need to.
   if (iteration > 0)
@@ -199,13 +213,47 @@ double DualTreeKMeans<MetricType, MatType, TreeType>::Iterate(
   }
   distanceCalculations += centroids.n_cols;
 
-  delete centroidTree;
-
   ++iteration;
 
   return std::sqrt(residual);
 }
 
+template<typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+template<typename TreeT>
+bool DualTreeKMeans<MetricType, MatType, TreeType>::RefitCentroidTree(
+    const arma::mat& centroids,
+    const typename std::enable_if_t<HasRefitBounds<TreeT,
+        void(TreeT::*)()>::value>*)
+{
+  // The nodes keep their centroids, so large moves would make the bounds loose
+  // and the pruning poor; then the tree is rebuilt.
+  Tree& centroidTree = centroidSearch->ReferenceTree();
+  if (clusterDistances[centroids.n_cols] >
+      0.1 * centroidTree.FurthestDescendantDistance())
+    return false;
+
+  // Move the centroids of the tree to their new coordinates, in the order of
+  // the tree.
+  MatType& treeCentroids = centroidTree.Dataset();
+  if (oldFromNewCentroids.empty())
+  {
+    treeCentroids = centroids;
+  }
+  else
+  {
+    for (size_t i = 0; i < oldFromNewCentroids.size(); ++i)
+      treeCentroids.col(i) = centroids.col(oldFromNewCentroids[i]);
+  }
+
+  // This also reinitializes the statistics of every node.
+  centroidSearch->Refit();
+  return true;
+}
+
 template<typename MetricType,
          typename MatType,
          template<typename TreeMetricType,
@@ -2,7 +2,8 @@
  * @file methods/kmeans/elkan_kmeans.hpp
  * @author Ryan Curtin
  *
- * An implementation of Elkan's algorithm for exact Lloyd iterations.
+ * An implementation of Elkan's algorithm for exact Lloyd iterations, using
+ * OpenMP for parallelization over the points.
  *
  * mlpack is free software; you may redistribute it and/or modify it under the
  * terms of the 3-clause BSD license.  You should have received a copy of the
@@ -26,7 +27,10 @@ class ElkanKMeans
 
   /**
    * Run a single iteration of Elkan's algorithm, updating the given centroids
-   * into the newCentroids matrix.
+   * into the newCentroids matrix.  The given centroids need not be those
+   * computed by the last iteration (an empty cluster policy or a
+   * DistributedLloydStep may have changed them): the bounds are then loosened
+   * by the distance between the two.
    *
    * @param centroids Current cluster centroids.
    * @param newCentroids New cluster centroids.
@@ -57,6 +61,9 @@ class ElkanKMeans
   //! Lower bounds on the distance between each point and each cluster.
   arma::mat lowerBounds;
 
+  //! The centroids computed by the last iteration, which the bounds refer to.
+  arma::mat lastCentroids;
+
   //! Track distance calculations.
   size_t distanceCalculations;
 };
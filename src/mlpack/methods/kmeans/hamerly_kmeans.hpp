@@ -2,7 +2,8 @@
  * @file methods/kmeans/hamerly_kmeans.hpp
  * @author Ryan Curtin
  *
- * An implementation of Greg Hamerly's algorithm for k-means clustering.
+ * An implementation of Greg Hamerly's algorithm for k-means clustering, using
+ * OpenMP for parallelization over the points.
  *
  * mlpack is free software; you may redistribute it and/or modify it under the
  * terms of the 3-clause BSD license.  You should have received a copy of the
@@ -17,7 +17,9 @@
 #include <mlpack/core/metrics/lmetric.hpp>
 #include "sample_initialization.hpp"
 #include "max_variance_new_cluster.hpp"
+#include "closest_centroids.hpp"
 #include "naive_kmeans.hpp"
+#include "minibatch_kmeans.hpp"
 
 #include <mlpack/core/tree/binary_space_tree.hpp>
 
@@ -155,6 +157,38 @@ class KMeans
                const bool initialAssignmentGuess = false,
                const bool initialCentroidGuess = false);
 
+  /**
+   * Perform mini-batch k-means clustering on points that are pulled from the
+   * given source one batch at a time, so that the whole dataset never needs to
+   * be in memory.  The source must provide the method
+   *
+   * @code
+   * bool NextBatch(MatType& batch);
+   * @endcode
+   *
+   * which fills the batch with the next points and returns false when there are
+   * no more points.  Each batch updates the centroids with the MiniBatchKMeans
+   * rule, whatever LloydStepType is; clustering stops when the source is
+   * exhausted or after MaxIterations() batches (if it is not 0).  Unless
+   * initialGuess is true, the initial centroids are computed by the
+   * partitioner from the first batch.  The empty cluster policy is not used:
+   * the centroid of a cluster that no point is assigned to doesn't move.
+   *
+   * @param source Source of batches of points.
+   * @param clusters Number of clusters to compute.
+   * @param centroids Matrix in which centroids are stored.
+   * @param initialGuess If true, then it is assumed that centroids contains the
+   *      initial cluster centroids.
+   */
+  template<typename BatchSourceType>
+  void Cluster(BatchSourceType& source,
+               const size_t clusters,
+               arma::mat& centroids,
+               const bool initialGuess = false,
+               const typename std::enable_if_t<
+                   !arma::is_arma_type<BatchSourceType>::value &&
+                   !arma::is_arma_sparse_type<BatchSourceType>::value>* = 0);
+
   //! Get the maximum number of iterations.
   size_t MaxIterations() const { return maxIterations; }
   //! Set the maximum number of iterations.
@@ -78,6 +78,18 @@ bool GetInitialAssignmentsOrCentroids(
   return false;
 }
 
+/**
+ * Give the Lloyd step the settings it shares with the initial partition
+ * policy.  By default there are none; see distributed_kmeans.hpp for a policy
+ * and a step that share their reduction.
+ */
+template<typename InitialPartitionPolicy, typename StepType>
+void ConfigureStep(const InitialPartitionPolicy& /* partitioner */,
+                   StepType& /* step */)
+{
+  // Nothing to do.
+}
+
 /**
  * Construct the K-Means object.
  */
@@ -192,7 +204,8 @@ Cluster(const MatType& data,
       centroids.zeros(data.n_rows, clusters);
       for (size_t i = 0; i < data.n_cols; ++i)
       {
-        centroids.col(assignments[i]) += arma::vec(data.col(i));
+        ClosestCentroids<MetricType, MatType>::AddPoint(data, i, centroids,
+            assignments[i]);
         counts[assignments[i]]++;
       }
 
@@ -208,6 +221,7 @@ Cluster(const MatType& data,
   size_t iteration = 0;
 
   LloydStepType<MetricType, MatType> lloydStep(data, metric);
+  ConfigureStep(partitioner, lloydStep);
   arma::mat centroidsOther;
   double cNorm;
 
@@ -299,7 +313,8 @@ Cluster(const MatType& data,
     centroids.zeros(data.n_rows, clusters);
     for (size_t i = 0; i < data.n_cols; ++i)
     {
-      centroids.col(assignments[i]) += arma::vec(data.col(i));
+      ClosestCentroids<MetricType, MatType>::AddPoint(data, i, centroids,
+          assignments[i]);
       counts[assignments[i]]++;
     }
 
@@ -311,30 +326,125 @@ Cluster(const MatType& data,
   Cluster(data, clusters, centroids,
       initialAssignmentGuess || initialCentroidGuess);
 
-  // Calculate final assignments in parallel over the entire dataset.
+  // Calculate final assignments in parallel over blocks of the entire
+  // dataset.
   assignments.set_size(data.n_cols);
 
-  #pragma omp parallel for
-  for (omp_size_t i = 0; i < (omp_size_t) data.n_cols; ++i)
+  typedef ClosestCentroids<MetricType, MatType> ClosestType;
+  const ClosestType closest(data, centroids, metric);
+  const size_t numBlocks = (data.n_cols + ClosestType::BlockSize - 1) /
+      ClosestType::BlockSize;
+
+  #pragma omp parallel
   {
-    // Find the closest centroid to this point.
-    double minDistance = std::numeric_limits<double>::infinity();
-    size_t closestCluster = centroids.n_cols; // Invalid value.
+    arma::Col<size_t> blockAssignments;
 
-    for (size_t j = 0; j < centroids.n_cols; ++j)
+    #pragma omp for
+    for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
     {
-      const double distance = metric.Evaluate(data.col(i), centroids.col(j));
+      const size_t begin = (size_t) b * ClosestType::BlockSize;
+      const size_t end = std::min(begin + ClosestType::BlockSize,
+          (size_t) data.n_cols);
+      closest.Assign(begin, end, blockAssignments);
+      for (size_t i = begin; i < end; ++i)
+        assignments[i] = blockAssignments[i - begin];
+    }
+  }
+}
 
-      if (distance < minDistance)
+/**
+ * Perform mini-batch k-means clustering on batches of points pulled from a
+ * source.
+ */
+template<typename MetricType,
+         typename InitialPartitionPolicy,
+         typename EmptyClusterPolicy,
+         template<class, class> class LloydStepType,
+         typename MatType>
+template<typename BatchSourceType>
+void KMeans<
+    MetricType,
+    InitialPartitionPolicy,
+    EmptyClusterPolicy,
+    LloydStepType,
+    MatType>::
+Cluster(BatchSourceType& source,
+        const size_t clusters,
+        arma::mat& centroids,
+        const bool initialGuess,
+        const typename std::enable_if_t<
+            !arma::is_arma_type<BatchSourceType>::value &&
+            !arma::is_arma_sparse_type<BatchSourceType>::value>*)
+{
+  MatType batch;
+  if (!source.NextBatch(batch))
+  {
+    Log::Warn << "KMeans::Cluster(): the batch source holds no points."
+        << std::endl;
+    return;
+  }
+
+  if (initialGuess)
+  {
+    if (centroids.n_cols != clusters)
+      Log::Fatal << "KMeans::Cluster(): wrong number of initial cluster "
+        << "centroids (" << centroids.n_cols << ", should be " << clusters
+        << ")!" << std::endl;
+
+    if (centroids.n_rows != batch.n_rows)
+      Log::Fatal << "KMeans::Cluster(): initial cluster centroids have wrong "
+        << " dimensionality (" << centroids.n_rows << ", should be "
+        << batch.n_rows << ")!" << std::endl;
+  }
+  else
+  {
+    if (clusters > batch.n_cols)
+      Log::Warn << "KMeans::Cluster(): more clusters requested than points in "
+          << "the first batch." << std::endl;
+
+    // Find the initial centroids from the first batch.
+    arma::Row<size_t> assignments;
+    bool gotAssignments = GetInitialAssignmentsOrCentroids(partitioner, batch,
+        clusters, assignments, centroids);
+    if (gotAssignments)
+    {
+      arma::Row<size_t> counts;
+      counts.zeros(clusters);
+      centroids.zeros(batch.n_rows, clusters);
+      for (size_t i = 0; i < batch.n_cols; ++i)
       {
-        minDistance = distance;
-        closestCluster = j;
+        centroids.col(assignments[i]) += arma::vec(batch.col(i));
+        counts[assignments[i]]++;
       }
-    }
 
-    Log::Assert(closestCluster != centroids.n_cols);
-    assignments[i] = closestCluster;
+      for (size_t i = 0; i < clusters; ++i)
+        if (counts[i] != 0)
+          centroids.col(i) /= counts[i];
+    }
   }
+
+  // The step object is only used through Update(), which takes each batch
+  // explicitly.
+  MiniBatchKMeans<MetricType, MatType> step(batch, metric);
+  size_t iteration = 0;
+  do
+  {
+    if (batch.n_rows != centroids.n_rows)
+      Log::Fatal << "KMeans::Cluster(): batch has wrong dimensionality ("
+          << batch.n_rows << ", should be " << centroids.n_rows << ")!"
+          << std::endl;
+
+    const double cNorm = step.Update(batch, centroids);
+
+    iteration++;
+    Log::Info << "KMeans::Cluster(): batch " << iteration << " of "
+        << batch.n_cols << " points, residual " << cNorm << ".\n";
+  } while (iteration != maxIterations && source.NextBatch(batch));
+
+  Log::Info << "KMeans::Cluster(): processed " << iteration << " batches."
+      << std::endl;
+  Log::Info << step.DistanceCalculations() << " distance calculations."
+      << std::endl;
 }
 
 template<typename MetricType,
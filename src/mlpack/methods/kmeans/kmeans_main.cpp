@@ -17,10 +17,13 @@
 #include "allow_empty_clusters.hpp"
 #include "kill_empty_clusters.hpp"
 #include "refined_start.hpp"
+#include "kmeans_parallel_initialization.hpp"
 #include "elkan_kmeans.hpp"
 #include "hamerly_kmeans.hpp"
 #include "pelleg_moore_kmeans.hpp"
 #include "dual_tree_kmeans.hpp"
+#include "minibatch_kmeans.hpp"
+#include "spherical_kmeans.hpp"
 
 using namespace mlpack;
 using namespace mlpack::kmeans;
@@ -53,14 +56,27 @@ BINDING_LONG_DESC(
     "used in each sample, the " + PRINT_PARAM_STRING("percentage") +
     " parameter is used (it should be a value between 0.0 and 1.0)."
     "\n\n"
+    "The k-means|| initialization of Bahmani et al. (\"Scalable k-means++\", "
+    "2012) can be used instead by specifying the " +
+    PRINT_PARAM_STRING("kmeans_parallel") + " parameter.  It chooses candidate"
+    " points in a few rounds, each of which picks points with probability "
+    "proportional to their squared distance to the closest candidate, and then "
+    "clusters the candidates to obtain the initial centroids.  The number of "
+    "rounds is specified with " + PRINT_PARAM_STRING("kmeans_parallel_rounds") +
+    ", and the expected number of candidates chosen in each round is the "
+    "number of clusters times " + PRINT_PARAM_STRING("oversampling") + "."
+    "\n\n"
     "There are several options available for the algorithm used for each Lloyd "
     "iteration, specified with the " + PRINT_PARAM_STRING("algorithm") + " "
     " option.  The standard O(kN) approach can be used ('naive').  Other "
     "options include the Pelleg-Moore tree-based algorithm ('pelleg-moore'), "
     "Elkan's triangle-inequality based algorithm ('elkan'), Hamerly's "
     "modification to Elkan's algorithm ('hamerly'), the dual-tree k-means "
-    "algorithm ('dualtree'), and the dual-tree k-means algorithm using the "
-    "cover tree ('dualtree-covertree')."
+    "algorithm ('dualtree'), the dual-tree k-means algorithm using the "
+    "cover tree ('dualtree-covertree'), approximate mini-batch k-means "
+    "('minibatch'), which only looks at a random batch of 1000 points in each "
+    "iteration, and spherical k-means ('spherical'), which clusters points by "
+    "cosine similarity and returns centroids of unit length."
     "\n\n"
     "The behavior for when an empty cluster is encountered can be modified with"
     " the " + PRINT_PARAM_STRING("allow_empty_clusters") + " option.  When "
@@ -148,9 +164,17 @@ PARAM_INT_IN("samplings", "Number of samplings to perform for refined start "
 PARAM_DOUBLE_IN("percentage", "Percentage of dataset to use for each refined "
     "start sampling (use when --refined_start is specified).", "p", 0.02);
 
+// Parameters for k-means|| initialization.
+PARAM_FLAG("kmeans_parallel", "Use the k-means|| initialization by Bahmani et "
+    "al. to choose initial points.", "");
+PARAM_INT_IN("kmeans_parallel_rounds", "Number of sampling rounds for "
+    "k-means|| (use when --kmeans_parallel is specified).", "", 5);
+PARAM_DOUBLE_IN("oversampling", "Oversampling factor for k-means|| (use when "
+    "--kmeans_parallel is specified).", "", 2.0);
+
 PARAM_STRING_IN("algorithm", "Algorithm to use for the Lloyd iteration "
-    "('naive', 'pelleg-moore', 'elkan', 'hamerly', 'dualtree', or "
-    "'dualtree-covertree').", "a", "naive");
+    "('naive', 'pelleg-moore', 'elkan', 'hamerly', 'dualtree', "
+    "'dualtree-covertree', 'minibatch', or 'spherical').", "a", "naive");
 
 // Given the type of initial partition policy, figure out the empty cluster
 // policy and run k-means.
@@ -179,6 +203,7 @@ static void mlpackMain()
   // Now, start building the KMeans type that we'll be using.  Start with the
   // initial partition policy.  The call to FindEmptyClusterPolicy<> results in
   // a call to RunKMeans<> and the algorithm is completed.
+  ReportIgnoredParam({{ "refined_start", true }}, "kmeans_parallel");
   if (IO::HasParam("refined_start"))
   {
     RequireParamValue<int>("samplings", [](int x) { return x > 0; }, true,
@@ -191,6 +216,18 @@ static void mlpackMain()
 
     FindEmptyClusterPolicy<RefinedStart>(RefinedStart(samplings, percentage));
   }
+  else if (IO::HasParam("kmeans_parallel"))
+  {
+    RequireParamValue<int>("kmeans_parallel_rounds",
+        [](int x) { return x > 0; }, true, "number of rounds must be positive");
+    const int rounds = IO::GetParam<int>("kmeans_parallel_rounds");
+    RequireParamValue<double>("oversampling", [](double x) { return x > 0.0; },
+        true, "oversampling factor must be positive");
+    const double oversampling = IO::GetParam<double>("oversampling");
+
+    FindEmptyClusterPolicy<KMeansParallelInitialization>(
+        KMeansParallelInitialization(rounds, oversampling));
+  }
   else
   {
     FindEmptyClusterPolicy<SampleInitialization>(SampleInitialization());
@@ -221,8 +258,8 @@ template<typename InitialPartitionPolicy, typename EmptyClusterPolicy>
 void FindLloydStepType(const InitialPartitionPolicy& ipp)
 {
   RequireParamInSet<string>("algorithm", { "elkan", "hamerly", "pelleg-moore",
-      "dualtree", "dualtree-covertree", "naive" }, true, "unknown k-means "
-      "algorithm");
+      "dualtree", "dualtree-covertree", "naive", "minibatch", "spherical" },
+      true, "unknown k-means algorithm");
 
   const string algorithm = IO::GetParam<string>("algorithm");
   if (algorithm == "elkan")
@@ -240,6 +277,12 @@ void FindLloydStepType(const InitialPartitionPolicy& ipp)
         CoverTreeDualTreeKMeans>(ipp);
   else if (algorithm == "naive")
     RunKMeans<InitialPartitionPolicy, EmptyClusterPolicy, NaiveKMeans>(ipp);
+  else if (algorithm == "minibatch")
+    RunKMeans<InitialPartitionPolicy, EmptyClusterPolicy,
+        MiniBatchKMeans>(ipp);
+  else if (algorithm == "spherical")
+    RunKMeans<InitialPartitionPolicy, EmptyClusterPolicy,
+        SphericalKMeans>(ipp);
 }
 
 // Given the template parameters, sanitize/load input and run k-means.
@@ -286,8 +329,9 @@ void RunKMeans(const InitialPartitionPolicy& ipp)
       clusters = centroids.n_cols;
 
     ReportIgnoredParam({{ "refined_start", true }}, "initial_centroids");
+    ReportIgnoredParam({{ "kmeans_parallel", true }}, "initial_centroids");
 
-    if (!IO::HasParam("refined_start"))
+    if (!IO::HasParam("refined_start") && !IO::HasParam("kmeans_parallel"))
       Log::Info << "Using initial centroid guesses." << endl;
   }
 
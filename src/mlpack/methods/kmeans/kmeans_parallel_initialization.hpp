@@ -0,0 +1,141 @@
+/**
+ * @file methods/kmeans/kmeans_parallel_initialization.hpp
+ *
+ * An implementation of the k-means|| ("scalable k-means++") initialization of
+ * Bahmani et al., which chooses initial centroids for k-means by oversampling
+ * candidates in a few passes over the data and then clustering the candidates.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KMEANS_KMEANS_PARALLEL_INITIALIZATION_HPP
+#define MLPACK_METHODS_KMEANS_KMEANS_PARALLEL_INITIALIZATION_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/math/random.hpp>
+#include <mlpack/core/metrics/lmetric.hpp>
+
+namespace mlpack {
+namespace kmeans {
+
+/**
+ * The k-means|| initialization, a parallel variant of k-means++.  A first
+ * candidate is chosen at random; then, in each of a few rounds, every point is
+ * added to the candidates independently with probability proportional to its
+ * squared distance to the closest candidate, so that about (oversampling *
+ * clusters) candidates are added per round.  The candidates are then weighted
+ * by the number of points closest to them and clustered (with weighted
+ * k-means++ seeding followed by weighted Lloyd iterations) to obtain the
+ * initial centroids.
+ *
+ * The passes over the data that compute the distances and the weights are run
+ * on several threads when OpenMP is available.  This is an implementation of
+ * the following paper:
+ *
+ * @code
+ * @article{bahmani2012scalable,
+ *   title={Scalable k-means++},
+ *   author={Bahmani, Bahman and Moseley, Benjamin and Vattani, Andrea and
+ *       Kumar, Ravi and Vassilvitskii, Sergei},
+ *   journal={Proceedings of the VLDB Endowment},
+ *   volume={5},
+ *   number={7},
+ *   pages={622--633},
+ *   year={2012}
+ * }
+ * @endcode
+ *
+ * The distances are always squared Euclidean distances.  This class can be
+ * used as the InitialPartitionPolicy of KMeans, and so also with EMFit:
+ *
+ * @code
+ * typedef KMeans<metric::SquaredEuclideanDistance,
+ *     KMeansParallelInitialization> KMeansType;
+ * EMFit<KMeansType> fitter(maxIterations, tolerance, KMeansType(maxIterations,
+ *     metric::SquaredEuclideanDistance(), KMeansParallelInitialization()));
+ * @endcode
+ */
+class KMeansParallelInitialization
+{
+ public:
+  /**
+   * Create the KMeansParallelInitialization object, optionally specifying the
+   * number of sampling rounds and the oversampling factor.
+   *
+   * @param rounds Number of sampling rounds.
+   * @param oversampling The expected number of candidates added in each round
+   *     is oversampling times the number of clusters.
+   */
+  KMeansParallelInitialization(const size_t rounds = 5,
+                               const double oversampling = 2.0) :
+      rounds(rounds), oversampling(oversampling) { }
+
+  /**
+   * Choose the given number of initial centroids from the given dataset with
+   * the k-means|| algorithm.
+   *
+   * @tparam MatType Type of data (arma::mat or arma::sp_mat).
+   * @param data Dataset to partition.
+   * @param clusters Number of clusters to split dataset into.
+   * @param centroids Matrix to store centroids into.
+   */
+  template<typename MatType>
+  void Cluster(const MatType& data,
+               const size_t clusters,
+               arma::mat& centroids);
+
+  //! Get the number of sampling rounds.
+  size_t Rounds() const { return rounds; }
+  //! Modify the number of sampling rounds.
+  size_t& Rounds() { return rounds; }
+
+  //! Get the oversampling factor.
+  double Oversampling() const { return oversampling; }
+  //! Modify the oversampling factor.
+  double& Oversampling() { return oversampling; }
+
+  //! Serialize the object.
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */)
+  {
+    ar & BOOST_SERIALIZATION_NVP(rounds);
+    ar & BOOST_SERIALIZATION_NVP(oversampling);
+  }
+
+ private:
+  /**
+   * Update the squared distance of each point to its closest candidate with
+   * the candidates from the given one on, and store the index of that
+   * candidate.
+   */
+  template<typename MatType>
+  static void UpdateDistances(const MatType& data,
+                              const std::vector<size_t>& candidates,
+                              const size_t firstCandidate,
+                              arma::vec& distances,
+                              arma::Col<size_t>& closest);
+
+  /**
+   * Cluster the weighted candidates into the given number of centroids, with
+   * weighted k-means++ seeding followed by weighted Lloyd iterations.
+   */
+  static void ClusterCandidates(const arma::mat& candidates,
+                                const arma::vec& weights,
+                                const size_t clusters,
+                                arma::mat& centroids);
+
+  //! The number of sampling rounds.
+  size_t rounds;
+  //! The oversampling factor.
+  double oversampling;
+};
+
+} // namespace kmeans
+} // namespace mlpack
+
+// Include implementation.
+#include "kmeans_parallel_initialization_impl.hpp"
+
+#endif
@@ -0,0 +1,192 @@
+/**
+ * @file methods/kmeans/kmeans_parallel_initialization_impl.hpp
+ *
+ * Implementation of the k-means|| initialization.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KMEANS_KMEANS_PARALLEL_INITIALIZATION_IMPL_HPP
+#define MLPACK_METHODS_KMEANS_KMEANS_PARALLEL_INITIALIZATION_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "kmeans_parallel_initialization.hpp"
+
+namespace mlpack {
+namespace kmeans {
+
+template<typename MatType>
+void KMeansParallelInitialization::Cluster(const MatType& data,
+                                           const size_t clusters,
+                                           arma::mat& centroids)
+{
+  // Start with one random point.
+  std::vector<size_t> candidates;
+  candidates.push_back(math::RandInt(data.n_cols));
+
+  arma::vec distances(data.n_cols);
+  distances.fill(DBL_MAX);
+  arma::Col<size_t> closest(data.n_cols);
+  UpdateDistances(data, candidates, 0, distances, closest);
+
+  const double expected = oversampling * clusters;
+  for (size_t r = 0; r < rounds; ++r)
+  {
+    const double cost = arma::accu(distances);
+    if (cost == 0.0)
+      break; // Every point is a candidate already.
+
+    // The random number generator is not thread-safe, so the sampling itself
+    // is done on one thread; it is cheap compared to the distance updates.
+    const size_t firstNew = candidates.size();
+    for (size_t i = 0; i < data.n_cols; ++i)
+      if (math::Random() < expected * distances[i] / cost)
+        candidates.push_back(i);
+
+    UpdateDistances(data, candidates, firstNew, distances, closest);
+  }
+
+  centroids.set_size(data.n_rows, clusters);
+  if (candidates.size() <= clusters)
+  {
+    // There are too few distinct points to choose from; fill the remaining
+    // centroids with random points.
+    for (size_t i = 0; i < candidates.size(); ++i)
+      centroids.col(i) = arma::vec(data.col(candidates[i]));
+    for (size_t i = candidates.size(); i < clusters; ++i)
+      centroids.col(i) = arma::vec(data.col(math::RandInt(data.n_cols)));
+    return;
+  }
+
+  // Weight each candidate by the number of points it is closest to.
+  arma::mat candidateMatrix(data.n_rows, candidates.size());
+  for (size_t i = 0; i < candidates.size(); ++i)
+    candidateMatrix.col(i) = arma::vec(data.col(candidates[i]));
+
+  arma::vec weights(candidates.size(), arma::fill::zeros);
+  for (size_t i = 0; i < data.n_cols; ++i)
+    weights[closest[i]] += 1.0;
+
+  ClusterCandidates(candidateMatrix, weights, clusters, centroids);
+}
+
+template<typename MatType>
+void KMeansParallelInitialization::UpdateDistances(
+    const MatType& data,
+    const std::vector<size_t>& candidates,
+    const size_t firstCandidate,
+    arma::vec& distances,
+    arma::Col<size_t>& closest)
+{
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) data.n_cols; ++i)
+  {
+    for (size_t j = firstCandidate; j < candidates.size(); ++j)
+    {
+      const double distance = metric::SquaredEuclideanDistance::Evaluate(
+          data.col(i), data.col(candidates[j]));
+      if (distance < distances[i])
+      {
+        distances[i] = distance;
+        closest[i] = j;
+      }
+    }
+  }
+}
+
+inline void KMeansParallelInitialization::ClusterCandidates(
+    const arma::mat& candidates,
+    const arma::vec& weights,
+    const size_t clusters,
+    arma::mat& centroids)
+{
+  // Weighted k-means++ seeding: each new centroid is a candidate chosen with
+  // probability proportional to its weight times its squared distance to the
+  // closest centroid chosen so far.
+  arma::vec distances(candidates.n_cols);
+  distances.fill(DBL_MAX);
+  for (size_t c = 0; c < clusters; ++c)
+  {
+    const arma::vec probabilities = (c == 0) ? weights :
+        arma::vec(weights % distances);
+    const double total = arma::accu(probabilities);
+
+    size_t chosen = candidates.n_cols - 1;
+    if (total > 0.0)
+    {
+      const double target = math::Random() * total;
+      double sum = 0.0;
+      for (size_t i = 0; i < candidates.n_cols; ++i)
+      {
+        sum += probabilities[i];
+        if (sum > target)
+        {
+          chosen = i;
+          break;
+        }
+      }
+    }
+    else
+    {
+      chosen = math::RandInt(candidates.n_cols);
+    }
+
+    centroids.col(c) = candidates.col(chosen);
+    for (size_t i = 0; i < candidates.n_cols; ++i)
+      distances[i] = std::min(distances[i],
+          metric::SquaredEuclideanDistance::Evaluate(candidates.col(i),
+          centroids.col(c)));
+  }
+
+  // Now refine the seeds with weighted Lloyd iterations.  A cluster that
+  // becomes empty keeps its previous centroid.
+  arma::Col<size_t> assignments(candidates.n_cols);
+  assignments.fill(clusters);
+  for (size_t iteration = 0; iteration < 100; ++iteration)
+  {
+    bool changed = false;
+    for (size_t i = 0; i < candidates.n_cols; ++i)
+    {
+      double minDistance = DBL_MAX;
+      size_t closest = 0;
+      for (size_t c = 0; c < clusters; ++c)
+      {
+        const double distance = metric::SquaredEuclideanDistance::Evaluate(
+            candidates.col(i), centroids.col(c));
+        if (distance < minDistance)
+        {
+          minDistance = distance;
+          closest = c;
+        }
+      }
+
+      if (closest != assignments[i])
+      {
+        assignments[i] = closest;
+        changed = true;
+      }
+    }
+
+    if (!changed)
+      break;
+
+    arma::mat sums(candidates.n_rows, clusters, arma::fill::zeros);
+    arma::vec clusterWeights(clusters, arma::fill::zeros);
+    for (size_t i = 0; i < candidates.n_cols; ++i)
+    {
+      sums.col(assignments[i]) += weights[i] * candidates.col(i);
+      clusterWeights[assignments[i]] += weights[i];
+    }
+
+    for (size_t c = 0; c < clusters; ++c)
+      if (clusterWeights[c] > 0.0)
+        centroids.col(c) = sums.col(c) / clusterWeights[c];
+  }
+}
+
+} // namespace kmeans
+} // namespace mlpack
+
+#endif
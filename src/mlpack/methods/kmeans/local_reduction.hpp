@@ -0,0 +1,51 @@
+/**
+ * @file methods/kmeans/local_reduction.hpp
+ *
+ * The LocalReduction policy, used by the distributed k-means and EM classes
+ * when the whole dataset is held by a single process.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KMEANS_LOCAL_REDUCTION_HPP
+#define MLPACK_METHODS_KMEANS_LOCAL_REDUCTION_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace kmeans {
+
+/**
+ * A reduction over a single process, so that every operation is a no-op.  A
+ * ReductionType policy combines values over all the processes that hold a
+ * shard of the dataset, and must implement the following methods:
+ *
+ *  - void Sum(double* values, const size_t n) const: replace the n given
+ *    values with their sum over all processes.
+ *  - void Broadcast(double* values, const size_t n) const: replace the n given
+ *    values with those of the first process.
+ *
+ * Every process must call these methods in the same order, with the same n.
+ * See MPIReduction for a reduction over MPI processes.
+ */
+class LocalReduction
+{
+ public:
+  //! Sum the given values over all processes (nothing to do).
+  void Sum(double* /* values */, const size_t /* n */) const { }
+
+  //! Take the given values of the first process (nothing to do).
+  void Broadcast(double* /* values */, const size_t /* n */) const { }
+
+  //! Get the rank of this process.
+  size_t Rank() const { return 0; }
+  //! Get the number of processes.
+  size_t Size() const { return 1; }
+};
+
+} // namespace kmeans
+} // namespace mlpack
+
+#endif
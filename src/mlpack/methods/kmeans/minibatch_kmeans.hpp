@@ -0,0 +1,141 @@
+/**
+ * @file methods/kmeans/minibatch_kmeans.hpp
+ *
+ * An implementation of a mini-batch step of the Lloyd algorithm for k-means
+ * clustering: each iteration only looks at a random batch of points, and moves
+ * the centroids towards the points assigned to them with a per-cluster learning
+ * rate.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KMEANS_MINIBATCH_KMEANS_HPP
+#define MLPACK_METHODS_KMEANS_MINIBATCH_KMEANS_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace kmeans {
+
+/**
+ * MiniBatchKMeans is a Lloyd step type for KMeans that approximates each
+ * iteration with a random batch of points, as described in the paper below.
+ * Each point of the batch is assigned to its closest centroid, and then every
+ * centroid c is moved towards each of its points x as
+ *
+ *   c = c + (x - c) / n_c,
+ *
+ * where n_c is the number of points assigned to c over every iteration so far.
+ * So each cluster has its own learning rate, which decreases as the cluster
+ * sees more points.  The cost of an iteration depends on the batch size and not
+ * on the size of the dataset; the result is approximate.
+ *
+ * @code
+ * @inproceedings{sculley2010web,
+ *   title={Web-scale k-means clustering},
+ *   author={Sculley, D.},
+ *   booktitle={Proceedings of the 19th International Conference on World Wide
+ *       Web (WWW '10)},
+ *   pages={1177--1178},
+ *   year={2010}
+ * }
+ * @endcode
+ *
+ * The counts returned by Iterate() are the numbers of points assigned to each
+ * cluster over every iteration, so a cluster is only reported as empty if no
+ * point of any batch was ever assigned to it.
+ *
+ * For datasets that don't fit in memory, see the KMeans::Cluster() overload
+ * that takes a batch source; it uses Update() to process one batch at a time.
+ *
+ * @tparam MetricType Type of metric used with this implementation.
+ * @tparam MatType Matrix type (arma::mat or arma::sp_mat).
+ */
+template<typename MetricType, typename MatType>
+class MiniBatchKMeans
+{
+ public:
+  /**
+   * Construct the MiniBatchKMeans object with the given dataset and metric.
+   *
+   * @param dataset Dataset.
+   * @param metric Instantiated metric.
+   * @param batchSize Number of points to sample for each iteration.  If it is
+   *     at least the number of points in the dataset, every point is used in
+   *     each iteration.
+   */
+  MiniBatchKMeans(const MatType& dataset,
+                  MetricType& metric,
+                  const size_t batchSize = 1000);
+
+  /**
+   * Run a single mini-batch iteration, updating the given centroids into the
+   * newCentroids matrix.
+   *
+   * @param centroids Current cluster centroids.
+   * @param newCentroids New cluster centroids.
+   * @param counts Number of points assigned to each cluster over every
+   *     iteration so far.
+   * @return The distance the centroids moved.
+   */
+  double Iterate(const arma::mat& centroids,
+                 arma::mat& newCentroids,
+                 arma::Col<size_t>& counts);
+
+  /**
+   * Update the given centroids in place with every point of the given batch.
+   * The batch does not need to come from the dataset the object was
+   * constructed with.
+   *
+   * @param batch Batch of points.
+   * @param centroids Cluster centroids to update.
+   * @return The distance the centroids moved.
+   */
+  double Update(const MatType& batch, arma::mat& centroids);
+
+  //! Get the number of points sampled for each iteration.
+  size_t BatchSize() const { return batchSize; }
+  //! Modify the number of points sampled for each iteration.
+  size_t& BatchSize() { return batchSize; }
+
+  //! Get the number of points assigned to each cluster so far.
+  const arma::Col<size_t>& ClusterCounts() const { return clusterCounts; }
+
+  size_t DistanceCalculations() const { return distanceCalculations; }
+
+ private:
+  /**
+   * Assign the given points to their closest centroid, then move each new
+   * centroid towards its points.  The centroids and newCentroids matrices may
+   * be the same, since every point is assigned before anything is moved.
+   */
+  void Step(const MatType& data,
+            const arma::Col<size_t>& points,
+            const arma::mat& centroids,
+            arma::mat& newCentroids);
+
+  //! Compute the distance between the old and the new centroids.
+  double Residual(const arma::mat& centroids, const arma::mat& newCentroids);
+
+  //! The dataset.
+  const MatType& dataset;
+  //! The instantiated metric.
+  MetricType& metric;
+  //! The number of points sampled for each iteration.
+  size_t batchSize;
+  //! The number of points assigned to each cluster so far.
+  arma::Col<size_t> clusterCounts;
+
+  //! Number of distance calculations.
+  size_t distanceCalculations;
+};
+
+} // namespace kmeans
+} // namespace mlpack
+
+// Include implementation.
+#include "minibatch_kmeans_impl.hpp"
+
+#endif
@@ -0,0 +1,148 @@
+/**
+ * @file methods/kmeans/minibatch_kmeans_impl.hpp
+ *
+ * Implementation of the mini-batch step of the Lloyd algorithm for k-means
+ * clustering.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KMEANS_MINIBATCH_KMEANS_IMPL_HPP
+#define MLPACK_METHODS_KMEANS_MINIBATCH_KMEANS_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "minibatch_kmeans.hpp"
+
+namespace mlpack {
+namespace kmeans {
+
+template<typename MetricType, typename MatType>
+MiniBatchKMeans<MetricType, MatType>::MiniBatchKMeans(const MatType& dataset,
+                                                      MetricType& metric,
+                                                      const size_t batchSize) :
+    dataset(dataset),
+    metric(metric),
+    batchSize(batchSize),
+    distanceCalculations(0)
+{
+  if (batchSize == 0)
+    throw std::invalid_argument("MiniBatchKMeans: batch size must be greater "
+        "than 0");
+}
+
+// Run a single iteration.
+template<typename MetricType, typename MatType>
+double MiniBatchKMeans<MetricType, MatType>::Iterate(
+    const arma::mat& centroids,
+    arma::mat& newCentroids,
+    arma::Col<size_t>& counts)
+{
+  // Sample the batch (with replacement), unless it would hold the whole
+  // dataset anyway.
+  arma::Col<size_t> points;
+  if (batchSize >= dataset.n_cols)
+  {
+    points.set_size(dataset.n_cols);
+    for (size_t i = 0; i < dataset.n_cols; ++i)
+      points[i] = i;
+  }
+  else
+  {
+    points.set_size(batchSize);
+    for (size_t i = 0; i < batchSize; ++i)
+      points[i] = (size_t) math::RandInt(dataset.n_cols);
+  }
+
+  newCentroids = centroids;
+  Step(dataset, points, centroids, newCentroids);
+  counts = clusterCounts;
+
+  return Residual(centroids, newCentroids);
+}
+
+// Update the centroids with a batch of points.
+template<typename MetricType, typename MatType>
+double MiniBatchKMeans<MetricType, MatType>::Update(const MatType& batch,
+                                                    arma::mat& centroids)
+{
+  arma::Col<size_t> points(batch.n_cols);
+  for (size_t i = 0; i < batch.n_cols; ++i)
+    points[i] = i;
+
+  const arma::mat oldCentroids(centroids);
+  Step(batch, points, centroids, centroids);
+
+  return Residual(oldCentroids, centroids);
+}
+
+template<typename MetricType, typename MatType>
+void MiniBatchKMeans<MetricType, MatType>::Step(
+    const MatType& data,
+    const arma::Col<size_t>& points,
+    const arma::mat& centroids,
+    arma::mat& newCentroids)
+{
+  if (clusterCounts.n_elem != centroids.n_cols)
+    clusterCounts.zeros(centroids.n_cols);
+
+  // Find the closest centroid to each point of the batch.  This is computed in
+  // parallel; the centroids are then updated sequentially, since the update of
+  // a centroid depends on the points before it.
+  arma::Col<size_t> assignments(points.n_elem);
+
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) points.n_elem; ++i)
+  {
+    double minDistance = std::numeric_limits<double>::infinity();
+    size_t closestCluster = centroids.n_cols; // Invalid value.
+
+    for (size_t j = 0; j < centroids.n_cols; ++j)
+    {
+      const double distance = metric.Evaluate(data.col(points[i]),
+          centroids.unsafe_col(j));
+      if (distance < minDistance)
+      {
+        minDistance = distance;
+        closestCluster = j;
+      }
+    }
+
+    Log::Assert(closestCluster != centroids.n_cols);
+    assignments[i] = closestCluster;
+  }
+
+  distanceCalculations += centroids.n_cols * points.n_elem;
+
+  // Move each centroid towards its points, with a learning rate of one over the
+  // number of points the cluster has seen.
+  for (size_t i = 0; i < points.n_elem; ++i)
+  {
+    const size_t cluster = assignments[i];
+    ++clusterCounts[cluster];
+    newCentroids.col(cluster) += (arma::vec(data.col(points[i])) -
+        newCentroids.col(cluster)) / (double) clusterCounts[cluster];
+  }
+}
+
+template<typename MetricType, typename MatType>
+double MiniBatchKMeans<MetricType, MatType>::Residual(
+    const arma::mat& centroids,
+    const arma::mat& newCentroids)
+{
+  double cNorm = 0.0;
+  for (size_t i = 0; i < centroids.n_cols; ++i)
+  {
+    cNorm += std::pow(metric.Evaluate(centroids.col(i), newCentroids.col(i)),
+        2.0);
+  }
+  distanceCalculations += centroids.n_cols;
+
+  return std::sqrt(cNorm);
+}
+
+} // namespace kmeans
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,205 @@
+/**
+ * @file methods/kmeans/mpi_kmeans_main.cpp
+ *
+ * Executable for running k-means over a dataset sharded across MPI processes.
+ * It is only built when mlpack is configured with -DUSE_MPI=ON.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/util/io.hpp>
+#include <mlpack/core/util/mlpack_main.hpp>
+
+#include "kmeans.hpp"
+#include "allow_empty_clusters.hpp"
+#include "kill_empty_clusters.hpp"
+#include "elkan_kmeans.hpp"
+#include "distributed_kmeans.hpp"
+#include "mpi_reduction.hpp"
+
+using namespace mlpack;
+using namespace mlpack::kmeans;
+using namespace mlpack::util;
+using namespace std;
+
+// Program Name.
+BINDING_NAME("Distributed K-Means Clustering");
+
+// Short description.
+BINDING_SHORT_DESC(
+    "An implementation of k-means clustering for datasets that are sharded "
+    "across the processes of an MPI job.  Each process reads its own shard, "
+    "and every process obtains the same centroids.");
+
+// Long description.
+BINDING_LONG_DESC(
+    "This program performs k-means clustering on a dataset whose points are "
+    "split across several shards, one for each process of an MPI job; it must "
+    "be started with mpirun (or the launcher of the MPI implementation).  Each "
+    "process only reads its own shard, given by " +
+    PRINT_PARAM_STRING("shard") + ", where '%d' is replaced by the rank of "
+    "the process.  In each Lloyd iteration, every process computes the sums and"
+    " the counts of the points of its shard closest to each centroid, and these"
+    " are summed over all processes, so that the data is never gathered on one "
+    "machine."
+    "\n\n"
+    "The initial centroids are sampled from the shard of the first process, "
+    "unless they are given with " + PRINT_PARAM_STRING("initial_centroids") +
+    ".  The Lloyd iterations of every shard can use the naive algorithm "
+    "('naive') or Elkan's algorithm ('elkan'), specified with " +
+    PRINT_PARAM_STRING("algorithm") + ".  Empty clusters keep their centroid "
+    "from the previous iteration, unless " +
+    PRINT_PARAM_STRING("kill_empty_clusters") + " is specified."
+    "\n\n"
+    "The centroids are saved by the first process to the file given by " +
+    PRINT_PARAM_STRING("centroid") + ", and each process can save the "
+    "assignments of the points of its shard to the file given by " +
+    PRINT_PARAM_STRING("output") + " (where '%d' is also replaced by the rank "
+    "of the process).");
+
+// Example.
+BINDING_EXAMPLE(
+    "For example, to find 10 clusters in a dataset split in 32 shards "
+    "shard-0.csv to shard-31.csv, saving the centroids to centroids.csv and "
+    "the assignments of each shard to assignments-0.csv to "
+    "assignments-31.csv, the following command could be used:"
+    "\n\n"
+    "$ mpirun -np 32 mlpack_mpi_kmeans --shard shard-%d.csv --clusters 10 "
+    "--centroid centroids.csv --output assignments-%d.csv");
+
+// See also...
+BINDING_SEE_ALSO("@kmeans", "#kmeans");
+BINDING_SEE_ALSO("mlpack::kmeans::DistributedLloydStep class documentation",
+        "@doxygen/classmlpack_1_1kmeans_1_1DistributedLloydStep.html");
+
+// Required options.
+PARAM_STRING_IN_REQ("shard", "Shard of the dataset held by each process; '%d' "
+    "is replaced by the rank of the process.", "i");
+PARAM_INT_IN_REQ("clusters", "Number of clusters to find (0 autodetects from "
+    "initial centroids).", "c");
+
+// Output options.
+PARAM_STRING_IN("output", "File to save the assignments of the points of each "
+    "shard to; '%d' is replaced by the rank of the process.", "o", "");
+PARAM_STRING_IN("centroid", "File to save the centroids to (by the first "
+    "process).", "C", "");
+
+// k-means configuration options.
+PARAM_FLAG("kill_empty_clusters", "Remove empty clusters when they occur.",
+    "E");
+PARAM_INT_IN("max_iterations", "Maximum number of iterations before k-means "
+    "terminates.", "m", 1000);
+PARAM_INT_IN("seed", "Random seed.  If 0, 'std::time(NULL)' is used.", "s", 0);
+PARAM_MATRIX_IN("initial_centroids", "Start with the specified initial "
+    "centroids.", "I");
+PARAM_STRING_IN("algorithm", "Algorithm to use for the Lloyd iteration of each "
+    "shard ('naive' or 'elkan').", "a", "naive");
+
+// Replace the first '%d' in the given filename by the given rank.
+string ShardFilename(const string& filename, const size_t rank);
+
+// Given the empty cluster policy and the Lloyd step type, load the shard and
+// run k-means.
+template<typename EmptyClusterPolicy,
+         template<class, class> class LloydStepType>
+void RunKMeans(const MPIReduction& reduction);
+
+static void mlpackMain()
+{
+  MPI_Init(NULL, NULL);
+  const MPIReduction reduction;
+
+  // Initialize random seed; only the first process samples the centroids.
+  if (IO::GetParam<int>("seed") != 0)
+    math::RandomSeed((size_t) IO::GetParam<int>("seed"));
+  else
+    math::RandomSeed((size_t) std::time(NULL));
+
+  RequireParamInSet<string>("algorithm", { "naive", "elkan" }, true,
+      "unknown k-means algorithm");
+  RequireAtLeastOnePassed({ "output", "centroid" }, false,
+      "no results will be saved");
+
+  const string algorithm = IO::GetParam<string>("algorithm");
+  if (IO::HasParam("kill_empty_clusters"))
+  {
+    if (algorithm == "elkan")
+      RunKMeans<KillEmptyClusters, ElkanKMeans>(reduction);
+    else
+      RunKMeans<KillEmptyClusters, NaiveKMeans>(reduction);
+  }
+  else
+  {
+    if (algorithm == "elkan")
+      RunKMeans<AllowEmptyClusters, ElkanKMeans>(reduction);
+    else
+      RunKMeans<AllowEmptyClusters, NaiveKMeans>(reduction);
+  }
+
+  MPI_Finalize();
+}
+
+string ShardFilename(const string& filename, const size_t rank)
+{
+  const size_t position = filename.find("%d");
+  if (position == string::npos)
+    return filename;
+
+  ostringstream oss;
+  oss << filename.substr(0, position) << rank << filename.substr(position + 2);
+  return oss.str();
+}
+
+template<typename EmptyClusterPolicy,
+         template<class, class> class LloydStepType>
+void RunKMeans(const MPIReduction& reduction)
+{
+  if (!IO::HasParam("initial_centroids"))
+  {
+    RequireParamValue<int>("clusters", [](int x) { return x > 0; }, true,
+        "number of clusters must be positive");
+  }
+
+  RequireParamValue<int>("max_iterations", [](int x) { return x >= 0; }, true,
+    "maximum iterations must be positive or 0 (for no limit)");
+  const int maxIterations = IO::GetParam<int>("max_iterations");
+
+  const size_t rank = reduction.Rank();
+  arma::mat shard;
+  data::Load(ShardFilename(IO::GetParam<string>("shard"), rank), shard, true);
+  Log::Info << "Process " << rank << " of " << reduction.Size() << " holds "
+      << shard.n_cols << " points." << endl;
+
+  size_t clusters = (size_t) IO::GetParam<int>("clusters");
+  arma::mat centroids;
+  const bool initialCentroidGuess = IO::HasParam("initial_centroids");
+  if (initialCentroidGuess)
+  {
+    centroids = std::move(IO::GetParam<arma::mat>("initial_centroids"));
+    if (clusters == 0)
+      clusters = centroids.n_cols;
+  }
+
+  Timer::Start("clustering");
+  DistributedKMeans<MPIReduction, LloydStepType, metric::EuclideanDistance,
+      SampleInitialization, EmptyClusterPolicy> kmeans(maxIterations,
+      metric::EuclideanDistance(), DistributedInitialization<
+      SampleInitialization, MPIReduction>(SampleInitialization(), reduction));
+
+  arma::Row<size_t> assignments;
+  kmeans.Cluster(shard, clusters, assignments, centroids, false,
+      initialCentroidGuess);
+  Timer::Stop("clustering");
+
+  if (IO::HasParam("output"))
+  {
+    data::Save(ShardFilename(IO::GetParam<string>("output"), rank),
+        assignments, true);
+  }
+
+  if (IO::HasParam("centroid") && rank == 0)
+    data::Save(IO::GetParam<string>("centroid"), centroids, true);
+}
@@ -0,0 +1,111 @@
+/**
+ * @file methods/kmeans/mpi_reduction.hpp
+ *
+ * The MPIReduction policy, which combines the sufficient statistics of the
+ * distributed k-means and EM classes over MPI processes.  This header needs
+ * MPI; it is only used when mlpack is configured with -DUSE_MPI=ON.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KMEANS_MPI_REDUCTION_HPP
+#define MLPACK_METHODS_KMEANS_MPI_REDUCTION_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include <mpi.h>
+
+namespace mlpack {
+namespace kmeans {
+
+/**
+ * A reduction over the processes of an MPI communicator (by default
+ * MPI_COMM_WORLD), where each process holds one shard of the dataset.  Sums
+ * are computed with MPI_Allreduce() and broadcasts with MPI_Bcast(), so every
+ * process of the communicator must take part in each of them; MPI must be
+ * initialized before any of them.  For example, to cluster the shards of a
+ * dataset with k-means:
+ *
+ * @code
+ * MPI_Init(&argc, &argv);
+ * arma::mat shard; // The points held by this process.
+ * DistributedKMeans<MPIReduction> kmeans;
+ * kmeans.Cluster(shard, 10, assignments, centroids);
+ * MPI_Finalize();
+ * @endcode
+ *
+ * Every process obtains the same centroids, and the assignments of the points
+ * of its shard.  To reduce over another communicator, give the reduction to
+ * the DistributedInitialization policy of DistributedKMeans (which passes it on
+ * to the Lloyd step), or to DistributedEMFit.
+ */
+class MPIReduction
+{
+ public:
+  /**
+   * Create the reduction over the given communicator.
+   *
+   * @param communicator Communicator of the processes that hold the shards.
+   */
+  MPIReduction(MPI_Comm communicator = MPI_COMM_WORLD) :
+      communicator(communicator)
+  { }
+
+  //! Replace the given values with their sum over all processes.
+  void Sum(double* values, const size_t n) const
+  {
+    // MPI counts are ints, so large arrays are reduced in several parts.
+    for (size_t begin = 0; begin < n; begin += MaxCount())
+    {
+      const int count = (int) std::min(n - begin, MaxCount());
+      MPI_Allreduce(MPI_IN_PLACE, values + begin, count, MPI_DOUBLE, MPI_SUM,
+          communicator);
+    }
+  }
+
+  //! Replace the given values with those of the first process.
+  void Broadcast(double* values, const size_t n) const
+  {
+    for (size_t begin = 0; begin < n; begin += MaxCount())
+    {
+      const int count = (int) std::min(n - begin, MaxCount());
+      MPI_Bcast(values + begin, count, MPI_DOUBLE, 0, communicator);
+    }
+  }
+
+  //! Get the rank of this process.
+  size_t Rank() const
+  {
+    int rank;
+    MPI_Comm_rank(communicator, &rank);
+    return (size_t) rank;
+  }
+
+  //! Get the number of processes.
+  size_t Size() const
+  {
+    int size;
+    MPI_Comm_size(communicator, &size);
+    return (size_t) size;
+  }
+
+  //! Get the communicator.
+  MPI_Comm Communicator() const { return communicator; }
+
+ private:
+  //! The largest number of values sent in one MPI call.
+  static size_t MaxCount()
+  {
+    return (size_t) std::numeric_limits<int>::max();
+  }
+
+  //! The communicator of the processes.
+  MPI_Comm communicator;
+};
+
+} // namespace kmeans
+} // namespace mlpack
+
+#endif
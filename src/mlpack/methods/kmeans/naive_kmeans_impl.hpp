@@ -40,37 +40,40 @@ double NaiveKMeans<MetricType, MatType>::Iterate(const arma::mat& centroids,
   counts.zeros(centroids.n_cols);
 
   // Find the closest centroid to each point and update the new centroids.
-  // Computed in parallel over the complete dataset
+  // Computed in parallel over blocks of points of the complete dataset; for
+  // the Euclidean distance, the distances of a block are computed with one
+  // matrix multiplication.
+  typedef ClosestCentroids<MetricType, MatType> ClosestType;
+  const ClosestType closest(dataset, centroids, metric);
+  const size_t numBlocks = (dataset.n_cols + ClosestType::BlockSize - 1) /
+      ClosestType::BlockSize;
+
   #pragma omp parallel
   {
     // The current state of the K-means is private for each thread
     arma::mat localCentroids(centroids.n_rows, centroids.n_cols,
         arma::fill::zeros);
     arma::Col<size_t> localCounts(centroids.n_cols, arma::fill::zeros);
+    arma::Col<size_t> assignments;
 
-    #pragma omp for
-    for (omp_size_t i = 0; i < (omp_size_t) dataset.n_cols; ++i)
+    // The static schedule gives each thread the same range of points in every
+    // iteration, which stays on its NUMA node (see data::FirstTouch()).
+    #pragma omp for schedule(static)
+    for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
     {
-      // Find the closest centroid to this point.
-      double minDistance = std::numeric_limits<double>::infinity();
-      size_t closestCluster = centroids.n_cols; // Invalid value.
+      const size_t begin = (size_t) b * ClosestType::BlockSize;
+      const size_t end = std::min(begin + ClosestType::BlockSize,
+          (size_t) dataset.n_cols);
+      closest.Assign(begin, end, assignments);
 
-      for (size_t j = 0; j < centroids.n_cols; ++j)
+      // We now have the minimum distance centroid indices.  Update those
+      // centroids.
+      for (size_t i = begin; i < end; ++i)
       {
-        const double distance = metric.Evaluate(dataset.col(i),
-            centroids.unsafe_col(j));
-        if (distance < minDistance)
-        {
-          minDistance = distance;
-          closestCluster = j;
-        }
+        const size_t closestCluster = assignments[i - begin];
+        ClosestType::AddPoint(dataset, i, localCentroids, closestCluster);
+        localCounts(closestCluster)++;
       }
-
-      Log::Assert(closestCluster != centroids.n_cols);
-
-      // We now have the minimum distance centroid index.  Update that centroid.
-      localCentroids.unsafe_col(closestCluster) += dataset.col(i);
-      localCounts(closestCluster)++;
     }
     // Combine calculated state from each thread
     #pragma omp critical
@@ -0,0 +1,98 @@
+/**
+ * @file methods/kmeans/spherical_kmeans.hpp
+ *
+ * A step of the Lloyd algorithm for spherical k-means, which clusters points
+ * by cosine similarity.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KMEANS_SPHERICAL_KMEANS_HPP
+#define MLPACK_METHODS_KMEANS_SPHERICAL_KMEANS_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "closest_centroids.hpp"
+
+namespace mlpack {
+namespace kmeans {
+
+/**
+ * SphericalKMeans is a Lloyd step type for KMeans that clusters points by the
+ * cosine similarity of their directions, which suits text represented by
+ * (sparse) TF-IDF vectors.  Each point is assigned to the centroid c that
+ * maximizes x^T c / ||c||, and each new centroid is the sum of its points,
+ * scaled to unit length.  The returned centroids therefore have unit length;
+ * the points are usually normalized beforehand, so that each point has the
+ * same weight in its centroid.
+ *
+ * Since every centroid is scaled to unit length, the closest centroid in
+ * Euclidean distance is the one with the largest cosine similarity, so the
+ * assignments use ClosestCentroids, with one matrix multiplication per block of
+ * points (from the nonzero values only, for arma::sp_mat).
+ *
+ * @code
+ * @article{dhillon2001concept,
+ *   title={Concept decompositions for large sparse text data using
+ *       clustering},
+ *   author={Dhillon, Inderjit S. and Modha, Dharmendra S.},
+ *   journal={Machine Learning},
+ *   volume={42},
+ *   number={1--2},
+ *   pages={143--175},
+ *   year={2001}
+ * }
+ * @endcode
+ *
+ * @tparam MetricType Type of metric (only used by KMeans, for instance for
+ *     empty clusters; the steps use the cosine similarity).
+ * @tparam MatType Matrix type (arma::mat or arma::sp_mat).
+ */
+template<typename MetricType, typename MatType>
+class SphericalKMeans
+{
+ public:
+  /**
+   * Construct the SphericalKMeans object with the given dataset and metric.
+   *
+   * @param dataset Dataset.
+   * @param metric Instantiated metric.
+   */
+  SphericalKMeans(const MatType& dataset, MetricType& metric);
+
+  /**
+   * Run a single iteration of spherical k-means, updating the given centroids
+   * into the newCentroids matrix.  If any cluster is empty, then the centroid
+   * associated with that cluster is filled with zeros (it will be corrected
+   * later).  The returned value is the Euclidean norm of the change of the
+   * centroids, once scaled to unit length.
+   *
+   * @param centroids Current cluster centroids.
+   * @param newCentroids New cluster centroids (of unit length).
+   * @param counts Number of points in each cluster at the end of the iteration.
+   */
+  double Iterate(const arma::mat& centroids,
+                 arma::mat& newCentroids,
+                 arma::Col<size_t>& counts);
+
+  //! Get the number of similarity calculations.
+  size_t DistanceCalculations() const { return distanceCalculations; }
+
+ private:
+  //! The dataset.
+  const MatType& dataset;
+  //! The instantiated metric.
+  MetricType& metric;
+
+  //! Number of similarity calculations.
+  size_t distanceCalculations;
+};
+
+} // namespace kmeans
+} // namespace mlpack
+
+// Include implementation.
+#include "spherical_kmeans_impl.hpp"
+
+#endif
@@ -0,0 +1,106 @@
+/**
+ * @file methods/kmeans/spherical_kmeans_impl.hpp
+ *
+ * Implementation of the SphericalKMeans Lloyd step.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KMEANS_SPHERICAL_KMEANS_IMPL_HPP
+#define MLPACK_METHODS_KMEANS_SPHERICAL_KMEANS_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "spherical_kmeans.hpp"
+
+namespace mlpack {
+namespace kmeans {
+
+template<typename MetricType, typename MatType>
+SphericalKMeans<MetricType, MatType>::SphericalKMeans(const MatType& dataset,
+                                                      MetricType& metric) :
+    dataset(dataset),
+    metric(metric),
+    distanceCalculations(0)
+{ /* Nothing to do. */ }
+
+template<typename MetricType, typename MatType>
+double SphericalKMeans<MetricType, MatType>::Iterate(
+    const arma::mat& centroids,
+    arma::mat& newCentroids,
+    arma::Col<size_t>& counts)
+{
+  // Scale the centroids to unit length; then the closest one in Euclidean
+  // distance has the largest cosine similarity.
+  arma::mat unitCentroids(centroids);
+  for (size_t i = 0; i < unitCentroids.n_cols; ++i)
+  {
+    const double norm = arma::norm(unitCentroids.col(i), 2);
+    if (norm > 0.0)
+      unitCentroids.col(i) /= norm;
+  }
+
+  newCentroids.zeros(centroids.n_rows, centroids.n_cols);
+  counts.zeros(centroids.n_cols);
+
+  metric::EuclideanDistance euclidean;
+  typedef ClosestCentroids<metric::EuclideanDistance, MatType> ClosestType;
+  const ClosestType closest(dataset, unitCentroids, euclidean);
+  const size_t numBlocks = (dataset.n_cols + ClosestType::BlockSize - 1) /
+      ClosestType::BlockSize;
+
+  #pragma omp parallel
+  {
+    arma::mat localCentroids(centroids.n_rows, centroids.n_cols,
+        arma::fill::zeros);
+    arma::Col<size_t> localCounts(centroids.n_cols, arma::fill::zeros);
+    arma::Col<size_t> assignments;
+
+    #pragma omp for
+    for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+    {
+      const size_t begin = (size_t) b * ClosestType::BlockSize;
+      const size_t end = std::min(begin + ClosestType::BlockSize,
+          (size_t) dataset.n_cols);
+      closest.Assign(begin, end, assignments);
+
+      for (size_t i = begin; i < end; ++i)
+      {
+        const size_t closestCluster = assignments[i - begin];
+        ClosestType::AddPoint(dataset, i, localCentroids, closestCluster);
+        localCounts(closestCluster)++;
+      }
+    }
+
+    #pragma omp critical
+    {
+      newCentroids += localCentroids;
+      counts += localCounts;
+    }
+  }
+
+  // The new centroids are the directions of the sums of their points.
+  double cNorm = 0.0;
+  for (size_t i = 0; i < centroids.n_cols; ++i)
+  {
+    if (counts(i) != 0)
+    {
+      const double norm = arma::norm(newCentroids.col(i), 2);
+      if (norm > 0.0)
+        newCentroids.col(i) /= norm;
+    }
+
+    cNorm += arma::accu(arma::square(unitCentroids.col(i) -
+        newCentroids.col(i)));
+  }
+
+  distanceCalculations += centroids.n_cols * dataset.n_cols;
+
+  return std::sqrt(cNorm);
+}
+
+} // namespace kmeans
+} // namespace mlpack
+
+#endif
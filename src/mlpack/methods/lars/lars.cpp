@@ -169,6 +169,150 @@ double LARS::Train(const arma::mat& matX,
 {
   Timer::Start("lars_regression");
 
+  // This matrix may end up holding the transpose -- if necessary.
+  arma::mat dataTrans;
+  // dataRef is row-major.
+  const arma::mat& dataRef = (transposeData ? dataTrans : matX);
+  if (transposeData)
+    dataTrans = trans(matX);
+
+  PrepareGram(dataRef);
+  const double maxCorr = TrainPath(dataRef, y, beta);
+
+  Timer::Stop("lars_regression");
+
+  // If the maximum correlation was too small, no path was computed.
+  if (maxCorr < lambda1)
+    return maxCorr;
+
+  return ComputeError(matX, y, !transposeData);
+}
+
+double LARS::Train(const arma::mat& data,
+                   const arma::rowvec& responses,
+                   const bool transposeData)
+{
+  arma::vec beta;
+  return Train(data, responses, beta, transposeData);
+}
+
+double LARS::Train(const arma::mat& data,
+                   const arma::mat& responses,
+                   arma::mat& betas,
+                   const bool transposeData)
+{
+  if (responses.n_rows == 0)
+    Log::Fatal << "LARS::Train(): no responses given!" << std::endl;
+
+  Timer::Start("lars_regression");
+
+  arma::mat dataTrans;
+  const arma::mat& dataRef = (transposeData ? dataTrans : data);
+  if (transposeData)
+    dataTrans = trans(data);
+
+  // The Gram matrix is computed once and shared by every path.
+  PrepareGram(dataRef);
+
+  betas.set_size(dataRef.n_cols, responses.n_rows);
+  const size_t last = responses.n_rows - 1;
+
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t i = 0; i < (omp_size_t) responses.n_rows; ++i)
+  {
+    // Each path needs its own active set and Cholesky factor.
+    LARS path(useCholesky, *matGram, lambda1, lambda2, tolerance);
+    arma::vec beta;
+    path.TrainPath(dataRef, responses.row(i), beta);
+    betas.col(i) = beta;
+
+    // The last path is the model held by this object.
+    if ((size_t) i == last)
+    {
+      matUtriCholFactor = std::move(path.matUtriCholFactor);
+      betaPath = std::move(path.betaPath);
+      lambdaPath = std::move(path.lambdaPath);
+      activeSet = std::move(path.activeSet);
+      isActive = std::move(path.isActive);
+      ignoreSet = std::move(path.ignoreSet);
+      isIgnored = std::move(path.isIgnored);
+    }
+  }
+
+  Timer::Stop("lars_regression");
+
+  if (transposeData)
+    return arma::accu(arma::square(responses - trans(betas) * data));
+  else
+    return arma::accu(arma::square(responses - trans(data * betas)));
+}
+
+void LARS::ComputeGram(const arma::mat& data,
+                       arma::mat& gram,
+                       const bool transposeData,
+                       const size_t blockSize)
+{
+  const size_t dims = (transposeData ? data.n_rows : data.n_cols);
+  const size_t numBlocks = (dims + blockSize - 1) / blockSize;
+  gram.set_size(dims, dims);
+
+  // Only the upper triangle is computed; each block of columns is written by
+  // a single thread.  The blocks further right are larger, so they are
+  // scheduled dynamically.
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+  {
+    const size_t first = b * blockSize;
+    const size_t last = std::min(first + blockSize, dims) - 1;
+    if (transposeData)
+    {
+      gram.submat(0, first, last, last) = data.rows(0, last) *
+          trans(data.rows(first, last));
+    }
+    else
+    {
+      gram.submat(0, first, last, last) = trans(data.cols(0, last)) *
+          data.cols(first, last);
+    }
+  }
+
+  gram = arma::symmatu(gram);
+}
+
+void LARS::Predict(const arma::mat& points,
+                   arma::rowvec& predictions,
+                   const bool rowMajor) const
+{
+  // We really only need to store beta internally...
+  if (rowMajor)
+    predictions = trans(points * betaPath.back());
+  else
+    predictions = betaPath.back().t() * points;
+}
+
+// Private functions.
+void LARS::PrepareGram(const arma::mat& dataRef)
+{
+  // A precalculated Gram matrix of the wrong size can't be used.
+  if (matGram != &matGramInternal &&
+      matGram->n_elem != dataRef.n_cols * dataRef.n_cols)
+    matGram = &matGramInternal;
+
+  // Compute the Gram matrix.  If this is the elastic net problem, we will add
+  // lambda2 * I_n to the matrix.
+  if (matGram == &matGramInternal)
+  {
+    ComputeGram(dataRef, matGramInternal, false);
+
+    if (elasticNet && !useCholesky)
+      matGramInternal.diag() += lambda2;
+  }
+}
+
+double LARS::TrainPath(const arma::mat& dataRef,
+                       const arma::rowvec& y,
+                       arma::vec& beta)
+{
   // Clear any previous solution information.
   betaPath.clear();
   lambdaPath.clear();
@@ -178,13 +322,6 @@ double LARS::Train(const arma::mat& matX,
   isIgnored.clear();
   matUtriCholFactor.reset();
 
-  // This matrix may end up holding the transpose -- if necessary.
-  arma::mat dataTrans;
-  // dataRef is row-major.
-  const arma::mat& dataRef = (transposeData ? dataTrans : matX);
-  if (transposeData)
-    dataTrans = trans(matX);
-
   // Compute X' * y.
   arma::vec vecXTy = trans(y * dataRef);
 
@@ -217,26 +354,15 @@ double LARS::Train(const arma::mat& matX,
 
   betaPath.push_back(beta);
   lambdaPath.push_back(maxCorr);
+  const double maxCorrInitial = maxCorr;
 
   // If the maximum correlation is too small, there is no reason to continue.
   if (maxCorr < lambda1)
   {
     lambdaPath[0] = lambda1;
-    Timer::Stop("lars_regression");
     return maxCorr;
   }
 
-  // Compute the Gram matrix.  If this is the elastic net problem, we will add
-  // lambda2 * I_n to the matrix.
-  if (matGram->n_elem != dataRef.n_cols * dataRef.n_cols)
-  {
-    // In this case, matGram should reference matGramInternal.
-    matGramInternal = trans(dataRef) * dataRef;
-
-    if (elasticNet && !useCholesky)
-      matGramInternal += lambda2 * arma::eye(dataRef.n_cols, dataRef.n_cols);
-  }
-
   // Main loop.
   while (((activeSet.size() + ignoreSet.size()) < dataRef.n_cols) &&
          (maxCorr > tolerance))
@@ -360,13 +486,15 @@ double LARS::Train(const arma::mat& matX,
     // If not all variables are active.
     if ((activeSet.size() + ignoreSet.size()) < dataRef.n_cols)
     {
-      // Compute correlations with direction.
+      // Compute correlations with direction.  A single matrix-vector product
+      // is much faster than one dot product per dimension.
+      const arma::vec dirCorrs = trans(dataRef) * yHatDirection;
       for (size_t ind = 0; ind < dataRef.n_cols; ind++)
       {
         if (isActive[ind] || isIgnored[ind])
           continue;
 
-        double dirCorr = dot(dataRef.col(ind), yHatDirection);
+        const double dirCorr = dirCorrs(ind);
         double val1 = (maxCorr - corr(ind)) / (normalization - dirCorr);
         double val2 = (maxCorr + corr(ind)) / (normalization + dirCorr);
         if ((val1 > 0) && (val1 < gamma))
@@ -454,30 +582,10 @@ double LARS::Train(const arma::mat& matX,
   // Unfortunate copy...
   beta = betaPath.back();
 
-  Timer::Stop("lars_regression");
-  return ComputeError(matX, y, !transposeData);
+  return maxCorrInitial;
 }
 
-double LARS::Train(const arma::mat& data,
-                   const arma::rowvec& responses,
-                   const bool transposeData)
-{
-  arma::vec beta;
-  return Train(data, responses, beta, transposeData);
-}
 
-void LARS::Predict(const arma::mat& points,
-                   arma::rowvec& predictions,
-                   const bool rowMajor) const
-{
-  // We really only need to store beta internally...
-  if (rowMajor)
-    predictions = trans(points * betaPath.back());
-  else
-    predictions = betaPath.back().t() * points;
-}
-
-// Private functions.
 void LARS::Deactivate(const size_t activeVarInd)
 {
   isActive[activeSet[activeVarInd]] = false;
@@ -554,21 +662,18 @@ void LARS::CholeskyInsert(double sqNormNewX, const arma::vec& newGramCol)
   }
   else
   {
-    arma::mat matNewR = arma::mat(n + 1, n + 1);
-
     if (elasticNet)
       sqNormNewX += lambda2;
 
     arma::vec matUtriCholFactork = solve(trimatl(trans(matUtriCholFactor)),
         newGramCol);
 
-    matNewR(arma::span(0, n - 1), arma::span(0, n - 1)) = matUtriCholFactor;
-    matNewR(arma::span(0, n - 1), n) = matUtriCholFactork;
-    matNewR(n, arma::span(0, n - 1)).fill(0.0);
-    matNewR(n, n) = sqrt(sqNormNewX - dot(matUtriCholFactork,
-                                          matUtriCholFactork));
-
-    matUtriCholFactor = matNewR;
+    // Grow the factor in place; resize() keeps the existing elements.
+    matUtriCholFactor.resize(n + 1, n + 1);
+    matUtriCholFactor(arma::span(0, n - 1), n) = matUtriCholFactork;
+    matUtriCholFactor(n, arma::span(0, n - 1)).fill(0.0);
+    matUtriCholFactor(n, n) = sqrt(sqNormNewX - dot(matUtriCholFactork,
+                                                    matUtriCholFactork));
   }
 }
 
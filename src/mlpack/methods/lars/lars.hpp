@@ -236,6 +236,44 @@ class LARS
                const arma::rowvec& responses,
                const bool transposeData = true);
 
+  /**
+   * Run LARS on several response vectors that share the same data matrix.  The
+   * Gram matrix (or the given precalculated Gram matrix) is computed once, and
+   * the solution paths of the different responses are computed in parallel
+   * with OpenMP.  The coefficients of the i'th row of the responses are stored
+   * in the i'th column of betas.  When this returns, the model (its solution
+   * path and active set) is the one of the last response.
+   *
+   * @param data Column-major input data (or row-major input data if
+   *     transposeData = false).
+   * @param responses Matrix of targets; each row is a response vector.
+   * @param betas Matrix to store the solutions (one column per response) in.
+   * @param transposeData Set to false if the data is row-major.
+   * @return Sum of the minimum cost errors of every response.
+   */
+  double Train(const arma::mat& data,
+               const arma::mat& responses,
+               arma::mat& betas,
+               const bool transposeData = true);
+
+  /**
+   * Compute the Gram matrix X^T X of the given data, where the rows of X are
+   * the points, in parallel: the upper triangle is split into blocks of
+   * columns, and each block is computed by one thread.  The result can be
+   * passed to the constructors that take a precalculated Gram matrix, so that
+   * it is shared between many LARS objects that use the same data.
+   *
+   * @param data Column-major input data (or row-major input data if
+   *     transposeData = false).
+   * @param gram Matrix to store the Gram matrix in.
+   * @param transposeData Set to false if the data is row-major.
+   * @param blockSize Number of columns of the Gram matrix in each block.
+   */
+  static void ComputeGram(const arma::mat& data,
+                          arma::mat& gram,
+                          const bool transposeData = true,
+                          const size_t blockSize = 64);
+
   /**
    * Predict y_i for each data point in the given data matrix using the
    * currently-trained LARS model.
@@ -334,6 +372,29 @@ class LARS
   //! Membership indicator for set of ignored variables.
   std::vector<bool> isIgnored;
 
+  /**
+   * Make sure that matGram holds the Gram matrix of the given row-major data.
+   * If no precalculated Gram matrix of the right size was given, it is
+   * computed into matGramInternal (with lambda2 * I added for the elastic net
+   * when the Cholesky decomposition is not used).
+   *
+   * @param dataRef Row-major input data.
+   */
+  void PrepareGram(const arma::mat& dataRef);
+
+  /**
+   * Compute the solution path of the given responses for row-major data,
+   * using the Gram matrix that matGram points to.
+   *
+   * @param dataRef Row-major input data.
+   * @param y A vector of targets.
+   * @param beta Vector to store the solution in.
+   * @return The initial maximum correlation of the dimensions with y.
+   */
+  double TrainPath(const arma::mat& dataRef,
+                   const arma::rowvec& y,
+                   arma::vec& beta);
+
   /**
    * Remove activeVarInd'th element from active set.
    *
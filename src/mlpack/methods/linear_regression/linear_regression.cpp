@@ -29,7 +29,8 @@ LinearRegression::LinearRegression(const arma::mat& predictors,
                                    const double lambda,
                                    const bool intercept) :
     lambda(lambda),
-    intercept(intercept)
+    intercept(intercept),
+    blockSize(4096)
 {
   Train(predictors, responses, weights, intercept);
 }
@@ -51,41 +52,93 @@ double LinearRegression::Train(const arma::mat& predictors,
   /*
    * We want to calculate the a_i coefficients of:
    * \sum_{i=0}^n (a_i * x_i^i)
-   * In order to get the intercept value, we will add a row of ones.
+   * For the intercept value, the normal equations get an extra first row and
+   * column, as if a row of ones was added to the predictors.
    */
+  const size_t dims = predictors.n_rows + (intercept ? 1 : 0);
+  arma::mat gram(dims, dims, arma::fill::zeros);
+  arma::vec moments(dims, arma::fill::zeros);
+  double responseMoment = 0.0;
 
-  // We store the number of rows and columns of the predictors.
-  // Reminder: Armadillo stores the data transposed from how we think of it,
-  //           that is, columns are actually rows (see: column major order).
-  const size_t nCols = predictors.n_cols;
+  Accumulate(predictors, responses, weights, gram, moments, responseMoment);
+  Solve(gram, moments);
 
-  arma::mat p = predictors;
-  arma::rowvec r = responses;
+  return ComputeError(predictors, responses);
+}
 
-  // Here we add the row of ones to the predictors.
-  // The intercept is not penalized. Add an "all ones" row to design and set
-  // intercept = false to get a penalized intercept.
-  if (intercept)
+void LinearRegression::Accumulate(const arma::mat& predictors,
+                                  const arma::rowvec& responses,
+                                  const arma::rowvec& weights,
+                                  arma::mat& gram,
+                                  arma::vec& moments,
+                                  double& responseMoment) const
+{
+  const size_t offset = intercept ? 1 : 0;
+  const size_t dims = predictors.n_rows;
+  const bool weighted = (weights.n_elem > 0);
+
+  for (size_t begin = 0; begin < predictors.n_cols; begin += blockSize)
   {
-    p.insert_rows(0, arma::ones<arma::mat>(1, nCols));
+    const size_t points = std::min(blockSize, predictors.n_cols - begin);
+
+    // Alias the block of points and responses; they are not modified.
+    const arma::mat block(const_cast<double*>(predictors.colptr(begin)), dims,
+        points, false, true);
+    const arma::rowvec y(const_cast<double*>(responses.memptr()) + begin,
+        points, false, true);
+
+    // With weights, only the weighted block is copied.
+    arma::mat weightedBlock;
+    arma::rowvec weightedY;
+    if (weighted)
+    {
+      const arma::rowvec w = weights.subvec(begin, begin + points - 1);
+      weightedBlock = block.each_row() % w;
+      weightedY = y % w;
+    }
+    const arma::mat& wBlock = weighted ? weightedBlock : block;
+    const arma::rowvec& wY = weighted ? weightedY : y;
+
+    // a * (X W X^T) = y W X^T.
+    gram.submat(offset, offset, gram.n_rows - 1, gram.n_cols - 1) +=
+        wBlock * block.t();
+    moments.subvec(offset, moments.n_elem - 1) += block * wY.t();
+    responseMoment += arma::dot(wY, y);
+
+    if (intercept)
+    {
+      const arma::vec sums = arma::sum(wBlock, 1);
+      gram(0, 0) += weighted ? arma::accu(weights.subvec(begin,
+          begin + points - 1)) : points;
+      gram.submat(1, 0, gram.n_rows - 1, 0) += sums;
+      gram.submat(0, 1, 0, gram.n_cols - 1) += sums.t();
+      moments[0] += arma::accu(wY);
+    }
   }
+}
 
-  if (weights.n_elem > 0)
+void LinearRegression::Solve(const arma::mat& gram, const arma::vec& moments)
+{
+  // The total runtime of this is O(d^3): the normal equations are symmetric
+  // positive definite unless the data is degenerate and lambda is 0.
+  // The intercept is penalized too; add an "all ones" row to the design and
+  // set intercept = false to control this.
+  arma::mat cov = gram;
+  cov.diag() += lambda;
+
+  arma::mat upper;
+  if (arma::chol(upper, cov))
   {
-    p = p * diagmat(sqrt(weights));
-    r = sqrt(weights) % responses;
+    // cov = upper^T * upper, so two triangular solves are enough.
+    const arma::vec lower = arma::solve(arma::trimatl(upper.t()), moments);
+    parameters = arma::solve(arma::trimatu(upper), lower);
+  }
+  else
+  {
+    Log::Info << "LinearRegression::Train(): the normal equations are "
+        << "singular; falling back to a general solver." << std::endl;
+    parameters = arma::solve(cov, moments);
   }
-
-  // Convert to this form:
-  // a * (X X^T) = y X^T.
-  // Then we'll use Armadillo to solve it.
-  // The total runtime of this should be O(d^2 N) + O(d^3) + O(dN).
-  // (assuming the SVD is used to solve it)
-  arma::mat cov = p * p.t() +
-      lambda * arma::eye<arma::mat>(p.n_rows, p.n_rows);
-
-  parameters = arma::solve(cov, p * r.t());
-  return ComputeError(predictors, responses);
 }
 
 void LinearRegression::Predict(const arma::mat& points,
@@ -14,6 +14,7 @@
 #define MLPACK_METHODS_LINEAR_REGRESSION_LINEAR_REGRESSION_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/data/prefetch_loader.hpp>
 
 namespace mlpack {
 namespace regression /** Regression methods. */ {
@@ -22,6 +23,12 @@ namespace regression /** Regression methods. */ {
  * A simple linear regression algorithm using ordinary least squares.
  * Optionally, this class can perform ridge regression, if the lambda parameter
  * is set to a number greater than zero.
+ *
+ * The model is trained by accumulating the normal equations X W X^T and
+ * X W y^T over blocks of points, and by solving them with a Cholesky
+ * decomposition; the data is never copied, so training only needs O(d^2)
+ * memory, and it can also read the points chunk by chunk from a
+ * data::PrefetchLoader.
  */
 class LinearRegression
 {
@@ -59,7 +66,7 @@ class LinearRegression
    * called (or make sure the model parameters are set) before calling
    * Predict()!
    */
-  LinearRegression() : lambda(0.0), intercept(true) { }
+  LinearRegression() : lambda(0.0), intercept(true), blockSize(4096) { }
 
   /**
    * Train the LinearRegression model on the given data. Careful! This will
@@ -95,6 +102,22 @@ class LinearRegression
                const arma::rowvec& weights,
                const bool intercept = true);
 
+  /**
+   * Train the LinearRegression model on the points read chunk by chunk from
+   * the given loader.  The first row of the responses of each chunk holds
+   * the responses y of its points; if there is a second row, it holds the
+   * observation weights.  Only the normal equations are kept between chunks,
+   * so the memory does not depend on the number of points.  Careful!  This
+   * will completely ignore and overwrite the existing model.
+   *
+   * @param loader The loader of the chunks.
+   * @param intercept Whether or not to fit an intercept term.
+   * @return The (weighted) least squares error after training.
+   */
+  template<typename SourceType>
+  double Train(data::PrefetchLoader<SourceType>& loader,
+               const bool intercept = true);
+
   /**
    * Calculate y_i for each data point in points.
    *
@@ -136,6 +159,11 @@ class LinearRegression
   //! Return whether or not an intercept term is used in the model.
   bool Intercept() const { return intercept; }
 
+  //! Get the number of points accumulated at once in the normal equations.
+  size_t BlockSize() const { return blockSize; }
+  //! Modify the number of points accumulated at once in the normal equations.
+  size_t& BlockSize() { return blockSize; }
+
   /**
    * Serialize the model.
    */
@@ -148,6 +176,31 @@ class LinearRegression
   }
 
  private:
+  /**
+   * Add the given points to the normal equations, in blocks of BlockSize()
+   * points.  The points are not copied (only a block is, if there are
+   * weights).
+   *
+   * @param predictors X, the points to add.
+   * @param responses y, the responses to the points.
+   * @param weights Observation weights, or an empty vector.
+   * @param gram The accumulated X W X^T, with the intercept first.
+   * @param moments The accumulated X W y^T, with the intercept first.
+   * @param responseMoment The accumulated y W y^T.
+   */
+  void Accumulate(const arma::mat& predictors,
+                  const arma::rowvec& responses,
+                  const arma::rowvec& weights,
+                  arma::mat& gram,
+                  arma::vec& moments,
+                  double& responseMoment) const;
+
+  /**
+   * Solve the regularized normal equations with a Cholesky decomposition,
+   * falling back to a general solver if the matrix is singular.
+   */
+  void Solve(const arma::mat& gram, const arma::vec& moments);
+
   /**
    * The calculated B.
    * Initialized and filled by constructor to hold the least squares solution.
@@ -162,9 +215,15 @@ class LinearRegression
 
   //! Indicates whether first parameter is intercept.
   bool intercept;
+
+  //! The number of points accumulated at once in the normal equations.
+  size_t blockSize;
 };
 
 } // namespace regression
 } // namespace mlpack
 
+// Include implementation of templated functions.
+#include "linear_regression_impl.hpp"
+
 #endif // MLPACK_METHODS_LINEAR_REGRESSION_HPP
@@ -0,0 +1,78 @@
+/**
+ * @file methods/linear_regression/linear_regression_impl.hpp
+ *
+ * Implementation of the templated functions of linear regression.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_LINEAR_REGRESSION_LINEAR_REGRESSION_IMPL_HPP
+#define MLPACK_METHODS_LINEAR_REGRESSION_LINEAR_REGRESSION_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "linear_regression.hpp"
+
+namespace mlpack {
+namespace regression {
+
+template<typename SourceType>
+double LinearRegression::Train(data::PrefetchLoader<SourceType>& loader,
+                               const bool intercept)
+{
+  this->intercept = intercept;
+
+  arma::mat gram, chunk, chunkResponses;
+  arma::vec moments;
+  double responseMoment = 0.0;
+  double totalWeight = 0.0;
+
+  loader.Reset();
+  while (loader.Next(chunk, chunkResponses))
+  {
+    if (gram.n_elem == 0)
+    {
+      const size_t dims = chunk.n_rows + (intercept ? 1 : 0);
+      gram.zeros(dims, dims);
+      moments.zeros(dims);
+    }
+    else if (gram.n_rows != chunk.n_rows + (intercept ? 1 : 0))
+    {
+      Log::Fatal << "LinearRegression::Train(): all the chunks must have the "
+          << "same number of dimensions!" << std::endl;
+    }
+
+    if (chunkResponses.n_rows == 0 || chunkResponses.n_cols != chunk.n_cols)
+    {
+      Log::Fatal << "LinearRegression::Train(): the responses of a chunk must "
+          << "have one column per point!" << std::endl;
+    }
+
+    const arma::rowvec responses = chunkResponses.row(0);
+    const arma::rowvec weights = (chunkResponses.n_rows > 1) ?
+        arma::rowvec(chunkResponses.row(1)) : arma::rowvec();
+
+    Accumulate(chunk, responses, weights, gram, moments, responseMoment);
+    totalWeight += (weights.n_elem > 0) ? arma::accu(weights) : chunk.n_cols;
+  }
+
+  if (gram.n_elem == 0)
+  {
+    Log::Fatal << "LinearRegression::Train(): the loader has no points!"
+        << std::endl;
+  }
+
+  Solve(gram, moments);
+
+  // The squared error follows from the normal equations:
+  // (y - b^T X) W (y - b^T X)^T = y W y^T - 2 b^T X W y^T + b^T X W X^T b.
+  const double error = responseMoment - 2 * arma::dot(parameters, moments) +
+      arma::as_scalar(parameters.t() * gram * parameters);
+  return error / totalWeight;
+}
+
+} // namespace regression
+} // namespace mlpack
+
+#endif
@@ -163,9 +163,9 @@ class LinearSVMFunction
   arma::mat& InitialPoint() { return initialPoint; }
 
   //! Get the dataset.
-  const arma::sp_mat& Dataset() const { return dataset; }
+  const MatType& Dataset() const { return dataset; }
   //! Modify the dataset.
-  arma::sp_mat& Dataset() { return dataset; }
+  MatType& Dataset() { return dataset; }
 
   //! Sets the regularization parameter.
   double& Lambda() { return lambda; }
@@ -178,7 +178,28 @@ class LinearSVMFunction
   //! Return the number of functions.
   size_t NumFunctions() const;
 
+  //! Get the number of points processed together in the loss and gradient.
+  size_t BlockSize() const { return blockSize; }
+  //! Modify the number of points processed together in the loss and gradient.
+  size_t& BlockSize() { return blockSize; }
+
  private:
+  /**
+   * Compute the hinge loss on the given points, and optionally its gradient.
+   * The points are processed in blocks of BlockSize() points, in parallel
+   * when OpenMP is available.
+   *
+   * @param parameters The parameters of the SVM.
+   * @param firstId Index of the first point to use.
+   * @param batchSize Number of points to use.
+   * @param gradient If not NULL, the gradient is stored here.
+   * @return The value of the loss function at the given parameters.
+   */
+  double ComputeLoss(const arma::mat& parameters,
+                     const size_t firstId,
+                     const size_t batchSize,
+                     arma::mat* gradient) const;
+
   //! The initial point, from which to start the optimization.
   arma::mat initialPoint;
 
@@ -199,6 +220,9 @@ class LinearSVMFunction
 
   //! Intercept term flag.
   bool fitIntercept;
+
+  //! The number of points processed together in the loss and gradient.
+  size_t blockSize;
 };
 
 } // namespace svm
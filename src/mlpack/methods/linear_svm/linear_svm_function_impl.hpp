@@ -35,7 +35,8 @@ LinearSVMFunction<MatType>::LinearSVMFunction(
     numClasses(numClasses),
     lambda(lambda),
     delta(delta),
-    fitIntercept(fitIntercept)
+    fitIntercept(fitIntercept),
+    blockSize(256)
 {
   InitializeWeights(initialPoint, dataset.n_rows, numClasses, fitIntercept);
   initialPoint *= 0.005;
@@ -110,36 +111,20 @@ void LinearSVMFunction<MatType>::GetGroundTruthMatrix(
 template <typename MatType>
 void LinearSVMFunction<MatType>::Shuffle()
 {
-  // Determine new ordering.
-  arma::uvec ordering = arma::shuffle(arma::linspace<arma::uvec>(0,
-      dataset.n_cols - 1, dataset.n_cols));
+  // Recover the labels from the ground truth matrix, which has exactly one
+  // entry in each column.
+  arma::Row<size_t> labels(groundTruth.n_cols);
+  for (size_t i = 0; i < groundTruth.n_cols; ++i)
+    labels[i] = groundTruth.row_indices[groundTruth.col_ptrs[i]];
+
+  // This works for both dense and sparse data.
+  MatType newData;
+  arma::Row<size_t> newLabels;
+  math::ShuffleData(dataset, labels, newData, newLabels);
 
-  // Re-sort data.
-  arma::mat newData = dataset.cols(ordering);
   math::ClearAlias(dataset);
   dataset = std::move(newData);
-
-  // Assemble data for batch constructor.  We need reverse orderings though...
-  arma::uvec reverseOrdering(ordering.n_elem);
-  for (size_t i = 0; i < ordering.n_elem; ++i)
-    reverseOrdering[ordering[i]] = i;
-
-  arma::umat newLocations(2, groundTruth.n_nonzero);
-  arma::vec values(groundTruth.n_nonzero);
-  arma::sp_mat::const_iterator it = groundTruth.begin();
-  size_t loc = 0;
-  while (it != groundTruth.end())
-  {
-    newLocations(0, loc) = reverseOrdering(it.col());
-    newLocations(1, loc) = it.row();
-    values(loc) = (*it);
-
-    ++it;
-    ++loc;
-  }
-
-  groundTruth = arma::sp_mat(newLocations, values, groundTruth.n_rows,
-                             groundTruth.n_cols);
+  GetGroundTruthMatrix(newLabels, groundTruth);
 }
 
 template <typename MatType>
@@ -148,48 +133,9 @@ double LinearSVMFunction<MatType>::Evaluate(
 {
   // The objective function is the hinge loss function and it is
   // calculated over all the training examples.
-
-  // Calculate the loss and regularization terms.
   // L_i = Σ_i Σ_m max(0, Δ + (w_m x_i + b_m) - (w_{y_i} x_i + b_{y_i}))
   // where (m != y_i)
-  double loss, regularization;
-
-  // Scores for each class are evaluated.
-  arma::mat scores;
-
-  // Check intercept condition.
-  if (!fitIntercept)
-  {
-    scores = parameters.t() * dataset;
-  }
-  else
-  {
-    // When using `fitIntercept` we need to add the `b_i` term explicitly.
-    // The first `parameters.n_rows - 1` rows of parameters holds the value
-    // of Weights `w_i`, and the last row holds `b_i`.
-    // On calculating the score, we add `b_i` term to each element of
-    // `i_th` row of `scores`.
-    scores = parameters.rows(0, dataset.n_rows - 1).t() * dataset
-        + arma::repmat(parameters.row(dataset.n_rows).t(), 1,
-        dataset.n_cols);
-  }
-
-  // Evaluate the margin by the following steps:
-  //  - Subtracting the score of correct class from all the class scores.
-  //  - Adding the margin parameter `delta`.
-  //  - Removing the `delta` parameter from correct class label in each
-  //    column.
-  arma::mat margin = scores - (arma::repmat(arma::ones(numClasses).t()
-      * (scores % groundTruth), numClasses, 1)) + delta
-      - (delta * groundTruth);
-
-  // The Hinge Loss Function
-  loss = arma::accu(arma::clamp(margin, 0.0, DBL_MAX)) / dataset.n_cols;
-
-  // Adding the regularization term.
-  regularization = 0.5 * lambda * arma::dot(parameters, parameters);
-
-  return loss + regularization;
+  return ComputeLoss(parameters, 0, dataset.n_cols, NULL);
 }
 
 template <typename MatType>
@@ -198,40 +144,7 @@ double LinearSVMFunction<MatType>::Evaluate(
     const size_t firstId,
     const size_t batchSize)
 {
-  const size_t lastId = firstId + batchSize - 1;
-
-  // Calculate the loss and regularization terms.
-  double loss, regularization, cost;
-
-  // Scores for each class are evaluated.
-  arma::mat scores;
-
-  // Check intercept condition.
-  if (!fitIntercept)
-  {
-    scores = parameters.t() * dataset.cols(firstId, lastId);
-  }
-  else
-  {
-    scores = parameters.rows(0, dataset.n_rows - 1).t()
-        * dataset.cols(firstId, lastId)
-        + arma::repmat(parameters.row(dataset.n_rows).t(), 1,
-        dataset.n_cols);
-  }
-
-  arma::mat margin = scores - (arma::repmat(arma::ones(numClasses).t()
-      * (scores % groundTruth.cols(firstId, lastId)), numClasses, 1))
-      + delta - (delta * groundTruth.cols(firstId, lastId));
-
-  // The Hinge Loss Function
-  loss = arma::accu(arma::clamp(margin, 0.0, DBL_MAX));
-  loss /= batchSize;
-
-  // Adding the regularization term.
-  regularization = 0.5 * lambda * arma::dot(parameters, parameters);
-
-  cost = loss + regularization;
-  return cost;
+  return ComputeLoss(parameters, firstId, batchSize, NULL);
 }
 
 template <typename MatType>
@@ -240,62 +153,9 @@ void LinearSVMFunction<MatType>::Gradient(
     const arma::mat& parameters,
     GradType& gradient)
 {
-  // The objective is to minimize the loss, which is evaluated as the sum
-  // of all the positive elements of `margin` matrix.
-  // So, we focus of these positive elements and reduce them.
-  // Also, we need to increase the score of the correct class.
-
-  // Scores for each class are evaluated.
-  arma::mat scores;
-
-  if (!fitIntercept)
-  {
-    scores = parameters.t() * dataset;
-  }
-  else
-  {
-    scores = parameters.rows(0, dataset.n_rows - 1).t() * dataset
-        + arma::repmat(parameters.row(dataset.n_rows).t(), 1,
-        dataset.n_cols);
-  }
-
-  arma::mat margin = scores - (arma::repmat(arma::ones(numClasses).t()
-      * (scores % groundTruth), numClasses, 1)) + delta
-      - (delta * groundTruth);
-
-  // An element of `mask` matrix holds `1` corresponding to
-  // each positive element of `margin` matrix.
-  arma::mat mask = margin.for_each([](arma::mat::elem_type& val)
-      { val = (val > 0) ? 1: 0; });
-
-  arma::mat difference = groundTruth
-      % (-arma::repmat(arma::sum(mask), numClasses, 1)) + mask;
-
-  // The gradient is evaluated as follows:
-  //  - Add `x_i` to `w_j` if `margin_i_m`is positive.
-  //  - Subtract `x_i` from `w_y_i` for each positive
-  //    `margin_i_j`.
-  //  - Take the average over the size of dataset.
-  //  - Add the regularization parameter.
-
-  // Check intercept condition
-  if (!fitIntercept)
-  {
-    gradient = dataset * difference.t();
-  }
-  else
-  {
-    gradient.set_size(arma::size(parameters));
-    gradient.submat(0, 0, parameters.n_rows - 2, parameters.n_cols - 1) =
-        dataset * difference.t();
-    gradient.row(parameters.n_rows - 1) =
-        arma::ones<arma::rowvec>(dataset.n_cols) * difference.t();
-  }
-
-  gradient /= dataset.n_cols;
-
-  // Adding the regularization contribution to the gradient.
-  gradient += lambda * parameters;
+  arma::mat g;
+  ComputeLoss(parameters, 0, dataset.n_cols, &g);
+  gradient = std::move(g);
 }
 
 template <typename MatType>
@@ -306,53 +166,9 @@ void LinearSVMFunction<MatType>::Gradient(
     GradType& gradient,
     const size_t batchSize)
 {
-  const size_t lastId = firstId + batchSize - 1;
-
-  // Scores for each class are evaluated.
-  arma::mat scores;
-
-  // Check intercept condition.
-  if (!fitIntercept)
-  {
-    scores = parameters.t() * dataset.cols(firstId, lastId);
-  }
-  else
-  {
-    scores = parameters.rows(0, dataset.n_rows - 1).t()
-        * dataset.cols(firstId, lastId)
-        + arma::repmat(parameters.row(dataset.n_rows).t(), 1, batchSize);
-  }
-
-  arma::mat margin = scores - (arma::repmat(arma::ones(numClasses).t()
-      * (scores % groundTruth.cols(firstId, lastId)), numClasses, 1))
-      + delta - (delta * groundTruth.cols(firstId, lastId));
-
-  // For each sample, find the total number of classes where
-  // ( margin > 0 ).
-  arma::mat mask = margin.for_each([](arma::mat::elem_type& val)
-      { val = (val > 0) ? 1: 0; });
-
-  arma::mat difference = groundTruth.cols(firstId, lastId)
-      % (-arma::repmat(arma::sum(mask), numClasses, 1)) + mask;
-
-  // Check intercept condition
-  if (!fitIntercept)
-  {
-    gradient = dataset.cols(firstId, lastId) * difference.t();
-  }
-  else
-  {
-    gradient.set_size(arma::size(parameters));
-    gradient.submat(0, 0, parameters.n_rows - 2, parameters.n_cols - 1) =
-        dataset.cols(firstId, lastId) * difference.t();
-    gradient.row(parameters.n_rows - 1) =
-        arma::ones<arma::rowvec>(batchSize) * difference.t();
-  }
-
-  gradient /= batchSize;
-
-  // Adding the regularization contribution to the gradient.
-  gradient += lambda * parameters;
+  arma::mat g;
+  ComputeLoss(parameters, firstId, batchSize, &g);
+  gradient = std::move(g);
 }
 
 template <typename MatType>
@@ -361,61 +177,9 @@ double LinearSVMFunction<MatType>::EvaluateWithGradient(
     const arma::mat& parameters,
     GradType& gradient) const
 {
-  double loss, regularization, cost;
-
-  // Scores for each class are evaluated.
-  arma::mat scores;
-
-  if (!fitIntercept)
-  {
-    scores = parameters.t() * dataset;
-  }
-  else
-  {
-    scores = parameters.rows(0, dataset.n_rows - 1).t() * dataset
-        + arma::repmat(parameters.row(dataset.n_rows).t(), 1,
-        dataset.n_cols);
-  }
-
-  arma::mat margin = scores - (arma::repmat(arma::ones(numClasses).t()
-      * (scores % groundTruth), numClasses, 1)) + delta
-      - (delta * groundTruth);
-
-  // For each sample, find the total number of classes where
-  // ( margin > 0 ).
-  arma::mat mask = margin.for_each([](arma::mat::elem_type& val)
-      { val = (val > 0) ? 1: 0; });
-
-  arma::mat difference = groundTruth
-      % (-arma::repmat(arma::sum(mask), numClasses, 1)) + mask;
-
-  // Check intercept condition
-  if (!fitIntercept)
-  {
-    gradient = dataset * difference.t();
-  }
-  else
-  {
-    gradient.set_size(arma::size(parameters));
-    gradient.submat(0, 0, parameters.n_rows - 2, parameters.n_cols - 1) =
-            dataset * difference.t();
-    gradient.row(parameters.n_rows - 1) =
-            arma::ones<arma::rowvec>(dataset.n_cols) * difference.t();
-  }
-
-  gradient /= dataset.n_cols;
-
-  // Adding the regularization contribution to the gradient.
-  gradient += lambda * parameters;
-
-  // The Hinge Loss Function
-  loss = arma::accu(arma::clamp(margin, 0.0, DBL_MAX));
-  loss /= dataset.n_cols;
-
-  // Adding the regularization term.
-  regularization = 0.5 * lambda * arma::dot(parameters, parameters);
-
-  cost = loss + regularization;
+  arma::mat g;
+  const double cost = ComputeLoss(parameters, 0, dataset.n_cols, &g);
+  gradient = std::move(g);
   return cost;
 }
 
@@ -427,67 +191,103 @@ double LinearSVMFunction<MatType>::EvaluateWithGradient(
     GradType& gradient,
     const size_t batchSize) const
 {
-  const size_t lastId = firstId + batchSize - 1;
-
-  // Calculate the loss and regularization terms.
-  double loss, regularization, cost;
-
-  // Scores for each class are evaluated.
-  arma::mat scores;
-
-  // Check intercept condition.
-  if (!fitIntercept)
-  {
-    scores = parameters.t() * dataset.cols(firstId, lastId);
-  }
-  else
-  {
-    scores = parameters.rows(0, dataset.n_rows - 1).t()
-        * dataset.cols(firstId, lastId)
-        + arma::repmat(parameters.row(dataset.n_rows).t(), 1, dataset.n_cols);
-  }
+  arma::mat g;
+  const double cost = ComputeLoss(parameters, firstId, batchSize, &g);
+  gradient = std::move(g);
+  return cost;
+}
 
-  arma::mat margin = scores - (arma::repmat(arma::ones(numClasses).t()
-      * (scores % groundTruth.cols(firstId, lastId)), numClasses, 1))
-      + delta - (delta * groundTruth.cols(firstId, lastId));
+template <typename MatType>
+double LinearSVMFunction<MatType>::ComputeLoss(
+    const arma::mat& parameters,
+    const size_t firstId,
+    const size_t batchSize,
+    arma::mat* gradient) const
+{
+  const size_t numFeatures = dataset.n_rows;
+  const size_t numBlocks = (batchSize + blockSize - 1) / blockSize;
 
-  // For each sample, find the total number of classes where
-  // ( margin > 0 ).
-  arma::mat mask = margin.for_each([](arma::mat::elem_type& val)
-      { val = (val > 0) ? 1: 0; });
+  if (gradient)
+    gradient->zeros(arma::size(parameters));
 
-  arma::mat difference = groundTruth.cols(firstId, lastId)
-      % (-arma::repmat(arma::sum(mask), numClasses, 1)) + mask;
+  double loss = 0.0;
 
-  // Check intercept condition
-  if (!fitIntercept)
+  // The batch is split into blocks of points, so that the scores and the
+  // differences of a block stay in cache.  The blocks are processed in
+  // parallel, and each thread accumulates its own gradient.
+  #pragma omp parallel if (numBlocks > 1)
   {
-    gradient = dataset.cols(firstId, lastId) * difference.t();
+    arma::mat localGradient;
+    if (gradient)
+      localGradient.zeros(arma::size(parameters));
+    double localLoss = 0.0;
+
+    #pragma omp for schedule(dynamic)
+    for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+    {
+      const size_t begin = firstId + b * blockSize;
+      const size_t end = std::min(begin + blockSize, firstId + batchSize) - 1;
+      const size_t points = end - begin + 1;
+
+      // Scores for each class are evaluated.  When using `fitIntercept`,
+      // the last row of the parameters holds the intercepts `b_i`.
+      arma::mat scores = parameters.rows(0, numFeatures - 1).t() *
+          dataset.cols(begin, end);
+      if (fitIntercept)
+        scores.each_col() += parameters.row(numFeatures).t();
+
+      // An element of `difference` is 1 for each positive margin of a wrong
+      // class, and minus the number of those on the correct class.
+      arma::mat difference(numClasses, points, arma::fill::zeros);
+      for (size_t i = 0; i < points; ++i)
+      {
+        const size_t label =
+            groundTruth.row_indices[groundTruth.col_ptrs[begin + i]];
+        const double correctScore = scores(label, i);
+        for (size_t m = 0; m < numClasses; ++m)
+        {
+          if (m == label)
+            continue;
+
+          const double margin = scores(m, i) - correctScore + delta;
+          if (margin > 0)
+          {
+            localLoss += margin;
+            difference(m, i) = 1;
+            difference(label, i) -= 1;
+          }
+        }
+      }
+
+      // The gradient is evaluated as follows:
+      //  - Add `x_i` to `w_j` if `margin_i_m`is positive.
+      //  - Subtract `x_i` from `w_y_i` for each positive
+      //    `margin_i_j`.
+      if (gradient)
+      {
+        localGradient.rows(0, numFeatures - 1) += dataset.cols(begin, end) *
+            difference.t();
+        if (fitIntercept)
+          localGradient.row(numFeatures) += arma::sum(difference, 1).t();
+      }
+    }
+
+    #pragma omp critical
+    {
+      loss += localLoss;
+      if (gradient)
+        (*gradient) += localGradient;
+    }
   }
-  else
+
+  // Take the average over the size of the batch, and add the regularization.
+  if (gradient)
   {
-    gradient.set_size(arma::size(parameters));
-    gradient.submat(0, 0, parameters.n_rows - 2, parameters.n_cols - 1) =
-        dataset.cols(firstId, lastId) * difference.t();
-    gradient.row(parameters.n_rows - 1) =
-        arma::ones<arma::rowvec>(batchSize) * difference.t();
+    (*gradient) /= batchSize;
+    (*gradient) += lambda * parameters;
   }
 
-  gradient /= batchSize;
-
-
-  // Adding the regularization contribution to the gradient.
-  gradient += lambda * parameters;
-
-  // The Hinge Loss Function
-  loss = arma::accu(arma::clamp(margin.cols(firstId, lastId), 0.0, DBL_MAX));
-  loss /= batchSize;
-
-  // Adding the regularization term.
-  regularization = 0.5 * lambda * arma::dot(parameters, parameters);
-
-  cost = loss + regularization;
-  return cost;
+  return loss / batchSize + 0.5 * lambda * arma::dot(parameters, parameters);
 }
 
 template <typename MatType>
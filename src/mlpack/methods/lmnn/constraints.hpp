@@ -186,6 +186,14 @@ class Constraints
   //! Modify the number of target neighbors (k).
   size_t& K() { return k; }
 
+  //! Get the number of times the impostor trees are refit to the new
+  //! coordinates of the points before they are rebuilt.
+  size_t RebuildInterval() const { return rebuildInterval; }
+  //! Modify the number of times the impostor trees are refit to the new
+  //! coordinates of the points before they are rebuilt.  If this is 0, the
+  //! trees are rebuilt on every search.
+  size_t& RebuildInterval() { return rebuildInterval; }
+
   //! Access the boolean value of precalculated.
   const bool& PreCalulated() const { return precalculated; }
   //! Modify the value of precalculated.
@@ -204,6 +212,20 @@ class Constraints
   //! Store indices of data points having different label.
   std::vector<arma::uvec> indexDiff;
 
+  //! For each class, the search for impostors among the points of the other
+  //! classes.  The trees are reused between calls.
+  std::vector<KNN> impostorSearch;
+
+  //! For each class, the index in the dataset of each column of the reference
+  //! set of the tree of impostorSearch.
+  std::vector<arma::uvec> impostorOrder;
+
+  //! For each class, the number of times the tree was refit since it was built.
+  arma::Col<size_t> refits;
+
+  //! The number of refits of a tree before it is rebuilt.
+  size_t rebuildInterval;
+
   //! False if nothing has ever been precalculated.
   bool precalculated;
 
@@ -213,6 +235,15 @@ class Constraints
   */
   inline void Precalculate(const arma::Row<size_t>& labels);
 
+  /**
+  * Make impostorSearch[i] search the points of the other classes than the
+  * i'th one, at their coordinates in the given dataset.  The tree is built on
+  * the first call, and then refit to the new coordinates (without copying the
+  * points of the classes), unless the dimensionality changed or it was refit
+  * RebuildInterval() times already.
+  */
+  inline void UpdateImpostorSearch(const size_t i, const arma::mat& dataset);
+
   /**
   * Re-order neighbors on the basis of increasing norm in case
   * of ties among distances.
@@ -24,6 +24,7 @@ Constraints<MetricType>::Constraints(
     const arma::Row<size_t>& labels,
     const size_t k) :
     k(k),
+    rebuildInterval(10),
     precalculated(false)
 {
   // Ensure a valid k is passed.
@@ -171,9 +172,6 @@ void Constraints<MetricType>::Impostors(arma::Mat<size_t>& outputMatrix,
   // Perform pre-calculation. If neccesary.
   Precalculate(labels);
 
-  // KNN instance.
-  KNN knn;
-
   arma::Mat<size_t> neighbors;
   arma::mat distances;
 
@@ -181,8 +179,9 @@ void Constraints<MetricType>::Impostors(arma::Mat<size_t>& outputMatrix,
   {
     // Perform KNN search with differently labeled points as reference
     // set and  same class points as query set.
-    knn.Train(dataset.cols(indexDiff[i]));
-    knn.Search(dataset.cols(indexSame[i]), k, neighbors, distances);
+    UpdateImpostorSearch(i, dataset);
+    impostorSearch[i].Search(dataset.cols(indexSame[i]), k, neighbors,
+        distances);
 
     // Re-order neighbors on the basis of increasing norm in case
     // of ties among distances.
@@ -209,9 +208,6 @@ void Constraints<MetricType>::Impostors(arma::Mat<size_t>& outputNeighbors,
   // Perform pre-calculation. If neccesary.
   Precalculate(labels);
 
-  // KNN instance.
-  KNN knn;
-
   arma::Mat<size_t> neighbors;
   arma::mat distances;
 
@@ -219,8 +215,9 @@ void Constraints<MetricType>::Impostors(arma::Mat<size_t>& outputNeighbors,
   {
     // Perform KNN search with differently labeled points as reference
     // set and  same class points as query set.
-    knn.Train(dataset.cols(indexDiff[i]));
-    knn.Search(dataset.cols(indexSame[i]), k, neighbors, distances);
+    UpdateImpostorSearch(i, dataset);
+    impostorSearch[i].Search(dataset.cols(indexSame[i]), k, neighbors,
+        distances);
 
     // Re-order neighbors on the basis of increasing norm in case
     // of ties among distances.
@@ -252,9 +249,6 @@ void Constraints<MetricType>::Impostors(arma::Mat<size_t>& outputMatrix,
   arma::mat subDataset = dataset.cols(begin, begin + batchSize - 1);
   arma::Row<size_t> sublabels = labels.cols(begin, begin + batchSize - 1);
 
-  // KNN instance.
-  KNN knn;
-
   arma::Mat<size_t> neighbors;
   arma::mat distances;
 
@@ -268,8 +262,9 @@ void Constraints<MetricType>::Impostors(arma::Mat<size_t>& outputMatrix,
 
     // Perform KNN search with differently labeled points as reference
     // set and same class points as query set.
-    knn.Train(dataset.cols(indexDiff[i]));
-    knn.Search(subDataset.cols(subIndexSame), k, neighbors, distances);
+    UpdateImpostorSearch(i, dataset);
+    impostorSearch[i].Search(subDataset.cols(subIndexSame), k, neighbors,
+        distances);
 
     // Re-order neighbors on the basis of increasing norm in case
     // of ties among distances.
@@ -301,9 +296,6 @@ void Constraints<MetricType>::Impostors(arma::Mat<size_t>& outputNeighbors,
   arma::mat subDataset = dataset.cols(begin, begin + batchSize - 1);
   arma::Row<size_t> sublabels = labels.cols(begin, begin + batchSize - 1);
 
-  // KNN instance.
-  KNN knn;
-
   arma::Mat<size_t> neighbors;
   arma::mat distances;
 
@@ -317,8 +309,9 @@ void Constraints<MetricType>::Impostors(arma::Mat<size_t>& outputNeighbors,
 
     // Perform KNN search with differently labeled points as reference
     // set and same class points as query set.
-    knn.Train(dataset.cols(indexDiff[i]));
-    knn.Search(subDataset.cols(subIndexSame), k, neighbors, distances);
+    UpdateImpostorSearch(i, dataset);
+    impostorSearch[i].Search(subDataset.cols(subIndexSame), k, neighbors,
+        distances);
 
     // Re-order neighbors on the basis of increasing norm in case
     // of ties among distances.
@@ -348,9 +341,6 @@ void Constraints<MetricType>::Impostors(arma::Mat<size_t>& outputNeighbors,
   // Perform pre-calculation. If neccesary.
   Precalculate(labels);
 
-  // KNN instance.
-  KNN knn;
-
   arma::Mat<size_t> neighbors;
   arma::mat distances;
 
@@ -365,8 +355,8 @@ void Constraints<MetricType>::Impostors(arma::Mat<size_t>& outputNeighbors,
 
     // Perform KNN search with differently labeled points as reference
     // set and same class points as query set.
-    knn.Train(dataset.cols(indexDiff[i]));
-    knn.Search(dataset.cols(points.elem(subIndexSame)),
+    UpdateImpostorSearch(i, dataset);
+    impostorSearch[i].Search(dataset.cols(points.elem(subIndexSame)),
         k, neighbors, distances);
 
     // Re-order neighbors on the basis of increasing norm in case
@@ -439,9 +429,50 @@ inline void Constraints<MetricType>::Precalculate(
     indexDiff[i] = arma::find(labels != uniqueLabels[i]);
   }
 
+  // The trees of the impostor searches are built on the first search.
+  impostorSearch.clear();
+  impostorSearch.resize(uniqueLabels.n_elem);
+  impostorOrder.resize(uniqueLabels.n_elem);
+  refits.zeros(uniqueLabels.n_elem);
+
   precalculated = true;
 }
 
+template<typename MetricType>
+inline void Constraints<MetricType>::UpdateImpostorSearch(
+    const size_t i,
+    const arma::mat& dataset)
+{
+  KNN& knn = impostorSearch[i];
+  if (knn.ReferenceSet().n_cols != indexDiff[i].n_elem ||
+      knn.ReferenceSet().n_rows != dataset.n_rows ||
+      refits[i] >= rebuildInterval)
+  {
+    knn.Train(dataset.cols(indexDiff[i]));
+
+    // Remember which point of the dataset each column of the tree holds.
+    if (knn.OldFromNewReferences().empty())
+    {
+      impostorOrder[i] = indexDiff[i];
+    }
+    else
+    {
+      impostorOrder[i] = indexDiff[i].elem(arma::conv_to<arma::uvec>::from(
+          knn.OldFromNewReferences()));
+    }
+
+    refits[i] = 0;
+  }
+  else
+  {
+    // Move the points of the tree to their new coordinates (without any
+    // intermediate copy) and recompute the bounds of the existing tree.
+    knn.ReferenceTree().Dataset() = dataset.cols(impostorOrder[i]);
+    knn.Refit();
+    ++refits[i];
+  }
+}
+
 } // namespace lmnn
 } // namespace mlpack
 
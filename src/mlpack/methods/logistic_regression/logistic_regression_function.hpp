@@ -118,6 +118,28 @@ class LogisticRegressionFunction
                 GradType& gradient,
                 const size_t batchSize = 1) const;
 
+  /**
+   * Evaluate the gradient of the logistic regression log-likelihood function
+   * for the given batch as a sparse matrix.  Only the intercept and the
+   * features which are nonzero in a point of the batch get a gradient, so with
+   * sparse predictors the cost only depends on the nonzeros of the batch, not
+   * on the number of features.  The L2 regularization is applied lazily, to
+   * these features only; this makes the gradients of the batches separable, as
+   * sparse optimizers like ens::ParallelSGD (or ens::SGD with an arma::sp_mat
+   * gradient type) expect.
+   *
+   * @param parameters Vector of logistic regression parameters.
+   * @param begin Index of the starting point to use for objective function
+   *     gradient evaluation.
+   * @param gradient Sparse vector to output gradient into.
+   * @param batchSize Number of points to be processed as a batch for objective
+   *     function gradient evaluation.
+   */
+  void Gradient(const arma::mat& parameters,
+                const size_t begin,
+                arma::sp_mat& gradient,
+                const size_t batchSize = 1) const;
+
   /**
    * Evaluate the gradient of the logistic regression log-likelihood function
    * with the given parameters, and with respect to only one feature in the
@@ -152,6 +174,18 @@ class LogisticRegressionFunction
                               GradType& gradient,
                               const size_t batchSize = 1) const;
 
+  /**
+   * Evaluate the objective function and the sparse gradient of the logistic
+   * regression log-likelihood function simultaneously, for the given batch
+   * size from a given point in the dataset.  As in the sparse Gradient(), the
+   * regularization only involves the features which appear in the batch, for
+   * both the objective and the gradient.
+   */
+  double EvaluateWithGradient(const arma::mat& parameters,
+                              const size_t begin,
+                              arma::sp_mat& gradient,
+                              const size_t batchSize = 1) const;
+
   //! Return the number of separable functions (the number of predictor points).
   size_t NumFunctions() const { return predictors.n_cols; }
 
@@ -159,6 +193,13 @@ class LogisticRegressionFunction
   size_t NumFeatures() const { return predictors.n_rows + 1; }
 
  private:
+  //! Compute the sparse gradient of the given batch, and return the
+  //! objective with the lazy regularization.
+  double SparseEvaluateWithGradient(const arma::mat& parameters,
+                                    const size_t begin,
+                                    arma::sp_mat& gradient,
+                                    const size_t batchSize) const;
+
   //! The matrix of data points (predictors).  This is an alias until shuffling
   //! is done.
   MatType predictors;
@@ -206,6 +206,76 @@ void LogisticRegressionFunction<MatType>::PartialGradient(
   }
 }
 
+template<typename MatType>
+void LogisticRegressionFunction<MatType>::Gradient(
+    const arma::mat& parameters,
+    const size_t begin,
+    arma::sp_mat& gradient,
+    const size_t batchSize) const
+{
+  SparseEvaluateWithGradient(parameters, begin, gradient, batchSize);
+}
+
+template<typename MatType>
+double LogisticRegressionFunction<MatType>::EvaluateWithGradient(
+    const arma::mat& parameters,
+    const size_t begin,
+    arma::sp_mat& gradient,
+    const size_t batchSize) const
+{
+  return SparseEvaluateWithGradient(parameters, begin, gradient, batchSize);
+}
+
+template<typename MatType>
+double LogisticRegressionFunction<MatType>::SparseEvaluateWithGradient(
+    const arma::mat& parameters,
+    const size_t begin,
+    arma::sp_mat& gradient,
+    const size_t batchSize) const
+{
+  // Only the nonzeros of the batch are visited.
+  const arma::sp_mat batch(predictors.cols(begin, begin + batchSize - 1));
+
+  const arma::rowvec sigmoids = 1.0 / (1.0 + arma::exp(-(parameters(0, 0) +
+      parameters.tail_cols(parameters.n_elem - 1) * batch)));
+  const arma::rowvec respD = arma::conv_to<arma::rowvec>::from(
+      responses.subvec(begin, begin + batchSize - 1));
+
+  // The gradient of each feature is the sum of the errors of the points in
+  // which it appears; the sparse product keeps the other features empty.
+  const arma::sp_mat features = batch * arma::sp_mat(arma::vec(
+      (sigmoids - respD).t()));
+
+  // The regularization of the touched features, scaled to the batch.
+  const double scale = lambda * batchSize / predictors.n_cols;
+  arma::umat locations(2, features.n_nonzero + 1);
+  arma::vec values(features.n_nonzero + 1);
+  locations(0, 0) = 0;
+  locations(1, 0) = 0;
+  values[0] = -arma::accu(respD - sigmoids);
+
+  double objectiveRegularization = 0.0;
+  size_t i = 1;
+  for (arma::sp_mat::const_iterator it = features.begin();
+      it != features.end(); ++it, ++i)
+  {
+    const double weight = parameters(0, it.row() + 1);
+    locations(0, i) = 0;
+    locations(1, i) = it.row() + 1;
+    values[i] = (*it) + scale * weight;
+    objectiveRegularization += 0.5 * scale * weight * weight;
+  }
+
+  gradient = arma::sp_mat(locations, values, parameters.n_rows,
+      parameters.n_cols);
+
+  const double result = arma::accu(arma::log(1.0 - respD + sigmoids %
+      (2 * respD - 1.0)));
+
+  // Invert the result, because it's a minimization.
+  return objectiveRegularization - result;
+}
+
 template<typename MatType>
 template<typename GradType>
 double LogisticRegressionFunction<MatType>::EvaluateWithGradient(
@@ -95,6 +95,11 @@ BINDING_LONG_DESC(
     PRINT_PARAM_STRING("probabilities") + " instead of " +
     PRINT_PARAM_STRING("output_probabilities") +
     "\n\n"
+    "If most of the entries of the training and test data are zero, the " +
+    PRINT_PARAM_STRING("sparse") + " flag can be given to train and classify "
+    "with the data stored as sparse matrices; the products with the data then "
+    "only visit its nonzero entries."
+    "\n\n"
     "This implementation of logistic regression does not support the general "
     "multi-class case but instead only the two-class case.  Any labels must "
     "be either 0 or 1.  For more classes, see the softmax_regression "
@@ -171,6 +176,23 @@ PARAM_DOUBLE_IN("decision_boundary", "Decision boundary for prediction; if the "
     "logistic function for a point is less than the boundary, the class is "
     "taken to be 0; otherwise, the class is 1.", "d", 0.5);
 
+PARAM_FLAG("sparse", "Train and classify with the data stored as sparse "
+    "matrices.", "S");
+
+// Train the dense model on sparse data; only the type of the data differs, so
+// the parameters can be moved in and out of a sparse model.
+template<typename OptimizerType>
+void TrainSparse(LogisticRegression<>& model,
+                 const arma::sp_mat& regressors,
+                 const arma::Row<size_t>& responses,
+                 OptimizerType& optimizer)
+{
+  LogisticRegression<arma::sp_mat> sparseModel(0, model.Lambda());
+  sparseModel.Parameters() = std::move(model.Parameters());
+  sparseModel.Train(regressors, responses, optimizer);
+  model.Parameters() = std::move(sparseModel.Parameters());
+}
+
 static void mlpackMain()
 {
   // Collect command-line options.
@@ -321,6 +343,15 @@ static void mlpackMain()
   {
     model->Lambda() = lambda;
 
+    arma::sp_mat sparseRegressors;
+    if (IO::HasParam("sparse"))
+    {
+      sparseRegressors = arma::sp_mat(regressors);
+      regressors.reset();
+      Log::Info << "Training on a sparse matrix with "
+          << sparseRegressors.n_nonzero << " nonzero entries." << endl;
+    }
+
     if (optimizerType == "sgd")
     {
       ens::SGD<> sgdOpt;
@@ -331,7 +362,10 @@ static void mlpackMain()
       Log::Info << "Training model with SGD optimizer." << endl;
 
       // This will train the model.
-      model->Train(regressors, responses, sgdOpt);
+      if (IO::HasParam("sparse"))
+        TrainSparse(*model, sparseRegressors, responses, sgdOpt);
+      else
+        model->Train(regressors, responses, sgdOpt);
     }
     else if (optimizerType == "lbfgs")
     {
@@ -341,7 +375,10 @@ static void mlpackMain()
       Log::Info << "Training model with L-BFGS optimizer." << endl;
 
       // This will train the model.
-      model->Train(regressors, responses, lbfgsOpt);
+      if (IO::HasParam("sparse"))
+        TrainSparse(*model, sparseRegressors, responses, lbfgsOpt);
+      else
+        model->Train(regressors, responses, lbfgsOpt);
     }
   }
 
@@ -364,11 +401,22 @@ static void mlpackMain()
 
     // We must perform predictions on the test set.  Training (and the
     // optimizer) are irrelevant here; we'll pass in the model we have.
+    arma::sp_mat sparseTestSet;
+    LogisticRegression<arma::sp_mat> sparseModel(0, model->Lambda());
+    if (IO::HasParam("sparse"))
+    {
+      sparseTestSet = arma::sp_mat(testSet);
+      sparseModel.Parameters() = model->Parameters();
+    }
+
     if (IO::HasParam("predictions") || IO::HasParam("output"))
     {
       Log::Info << "Predicting classes of points in '"
           << IO::GetPrintableParam<arma::mat>("test") << "'." << endl;
-      model->Classify(testSet, predictions, decisionBoundary);
+      if (IO::HasParam("sparse"))
+        sparseModel.Classify(sparseTestSet, predictions, decisionBoundary);
+      else
+        model->Classify(testSet, predictions, decisionBoundary);
 
       // The IO param "output" is deprecated and replaced by "predictions"
       // "output" parameter will be removed in mlpack 4.
@@ -386,7 +434,10 @@ static void mlpackMain()
       Log::Info << "Calculating class probabilities of points in '"
           << IO::GetPrintableParam<arma::mat>("test") << "'." << endl;
       arma::mat probabilities;
-      model->Classify(testSet, probabilities);
+      if (IO::HasParam("sparse"))
+        sparseModel.Classify(sparseTestSet, probabilities);
+      else
+        model->Classify(testSet, probabilities);
 
       if (IO::HasParam("output_probabilities"))
         IO::GetParam<arma::mat>("output_probabilities") = probabilities;
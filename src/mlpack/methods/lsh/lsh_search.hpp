@@ -290,9 +290,20 @@ class LSHSearch
   //! Get the bucket size of the second hash.
   size_t BucketSize() const { return bucketSize; }
 
-  //! Get the second hash table.
-  const std::vector<arma::Col<size_t>>& SecondHashTable() const
-      { return secondHashTable; }
+  //! Get the offsets of the rows of the second hash table: the points of row i
+  //! are held in elements BucketOffsets()[i] to BucketOffsets()[i + 1] - 1 of
+  //! BucketContents().
+  const arma::Col<size_t>& BucketOffsets() const { return bucketOffsets; }
+
+  //! Get the points of the second hash table, stored row after row.
+  const arma::Col<size_t>& BucketContents() const { return bucketContents; }
+
+  /**
+   * Get the second hash table as one vector of points per row.  This is kept
+   * for compatibility only: the table is now stored in BucketOffsets() and
+   * BucketContents(), so each call builds a copy of it.
+   */
+  mlpack_deprecated std::vector<arma::Col<size_t>> SecondHashTable() const;
 
   //! Get the projection tables.
   const arma::cube& Projections() { return projections; }
@@ -306,25 +317,51 @@ class LSHSearch
   }
 
  private:
+  //! The number of queries that are projected together by ProjectQueries()
+  //! during a search.
+  static const size_t queryBlockSize = 1024;
+
+  /**
+   * Get the number of tables to search, given the number requested by the
+   * user (0 means all tables).
+   */
+  size_t TablesToSearch(const size_t numTablesToSearch) const;
+
   /**
-   * This function takes a query and hashes it into each of the hash tables to
-   * get keys for the query and then the key is hashed to a bucket of the second
-   * hash table and all the points (if any) in those buckets are collected as
-   * the potential neighbor candidates.
+   * Project a block of queries on the first 'numTablesToSearch' tables with a
+   * single matrix multiplication.  Column i of the result holds the
+   * projections of query (begin + i), table after table; that is, it can be
+   * seen as a (numProj x numTablesToSearch) matrix.
    *
-   * @param queryPoint The query point currently being processed.
+   * @param querySet Set of query points.
+   * @param begin Index of the first query of the block.
+   * @param count Number of queries in the block.
+   * @param numTablesToSearch The number of tables to project the queries on.
+   * @param queryProjections Matrix to store the projections of the queries.
+   */
+  void ProjectQueries(const MatType& querySet,
+                      const size_t begin,
+                      const size_t count,
+                      const size_t numTablesToSearch,
+                      arma::mat& queryProjections) const;
+
+  /**
+   * This function takes the projections of a query in each of the hash tables
+   * to get keys for the query and then the key is hashed to a bucket of the
+   * second hash table and all the points (if any) in those buckets are
+   * collected as the potential neighbor candidates.
+   *
+   * @param queryProjections The projections of the query currently being
+   *    processed (numProj x number of tables to search), as computed by
+   *    ProjectQueries().
    * @param referenceIndices The list of neighbor candidates obtained from
    *    hashing the query into all the hash tables and eventually into
    *    multiple buckets of the second hash table.
-   * @param numTablesToSearch The number of tables to perform the search in. If
-   *    0, all tables are searched.
    * @param T The number of additional probing bins for multiprobe LSH. If 0,
    *    single-probe is used.
    */
-  template<typename VecType>
-  void ReturnIndicesFromTable(const VecType& queryPoint,
+  void ReturnIndicesFromTable(const arma::mat& queryProjections,
                               arma::uvec& referenceIndices,
-                              size_t numTablesToSearch,
                               const size_t T) const;
 
   /**
@@ -450,15 +487,16 @@ class LSHSearch
   //! The bucket size of the second hash.
   size_t bucketSize;
 
-  //! The final hash table; should be (< secondHashSize) vectors each with
-  //! (<= bucketSize) elements.
-  std::vector<arma::Col<size_t>> secondHashTable;
+  //! The offsets of the rows of the final hash table in bucketContents; there
+  //! are (< secondHashSize) rows, and row i spans bucketOffsets[i] to
+  //! bucketOffsets[i + 1] - 1.
+  arma::Col<size_t> bucketOffsets;
 
-  //! The number of elements present in each hash bucket; should be
-  //! secondHashSize.
-  arma::Col<size_t> bucketContentSize;
+  //! The points of the final hash table, stored row after row; each row has
+  //! (<= bucketSize) elements.
+  arma::Col<size_t> bucketContents;
 
-  //! For a particular hash value, points to the row in secondHashTable
+  //! For a particular hash value, points to the row in the final hash table
   //! corresponding to this value. Length secondHashSize.
   arma::Col<size_t> bucketRowInHashTable;
 
@@ -486,7 +524,7 @@ class LSHSearch
 
 //! Set the serialization version of the LSHSearch class.
 BOOST_TEMPLATE_CLASS_VERSION(template<typename SortPolicy>,
-    mlpack::neighbor::LSHSearch<SortPolicy>, 1);
+    mlpack::neighbor::LSHSearch<SortPolicy>, 2);
 
 // Include implementation.
 #include "lsh_search_impl.hpp"
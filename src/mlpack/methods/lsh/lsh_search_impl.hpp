@@ -83,8 +83,8 @@ LSHSearch<SortPolicy, MatType>::LSHSearch(const LSHSearch& other) :
     secondHashSize(other.secondHashSize),
     secondHashWeights(other.secondHashWeights),
     bucketSize(other.bucketSize),
-    secondHashTable(other.secondHashTable),
-    bucketContentSize(other.bucketContentSize),
+    bucketOffsets(other.bucketOffsets),
+    bucketContents(other.bucketContents),
     bucketRowInHashTable(other.bucketRowInHashTable),
     distanceEvaluations(other.distanceEvaluations)
 {
@@ -103,8 +103,8 @@ LSHSearch<SortPolicy, MatType>::LSHSearch(LSHSearch&& other) :
     secondHashSize(other.secondHashSize),
     secondHashWeights(std::move(other.secondHashWeights)),
     bucketSize(other.bucketSize),
-    secondHashTable(std::move(other.secondHashTable)),
-    bucketContentSize(std::move(other.bucketContentSize)),
+    bucketOffsets(std::move(other.bucketOffsets)),
+    bucketContents(std::move(other.bucketContents)),
     bucketRowInHashTable(std::move(other.bucketRowInHashTable)),
     distanceEvaluations(other.distanceEvaluations)
 {
@@ -131,8 +131,8 @@ LSHSearch<SortPolicy, MatType>& LSHSearch<SortPolicy, MatType>::operator=(
   secondHashSize = other.secondHashSize;
   secondHashWeights = other.secondHashWeights;
   bucketSize = other.bucketSize;
-  secondHashTable = other.secondHashTable;
-  bucketContentSize = other.bucketContentSize;
+  bucketOffsets = other.bucketOffsets;
+  bucketContents = other.bucketContents;
   bucketRowInHashTable = other.bucketRowInHashTable;
   distanceEvaluations = other.distanceEvaluations;
 
@@ -153,8 +153,8 @@ LSHSearch<SortPolicy, MatType>& LSHSearch<SortPolicy, MatType>::operator=(
   secondHashSize = other.secondHashSize;
   secondHashWeights = std::move(other.secondHashWeights);
   bucketSize = other.bucketSize;
-  secondHashTable = std::move(other.secondHashTable);
-  bucketContentSize = std::move(other.bucketContentSize);
+  bucketOffsets = std::move(other.bucketOffsets);
+  bucketContents = std::move(other.bucketContents);
   bucketRowInHashTable = std::move(other.bucketRowInHashTable);
   distanceEvaluations = other.distanceEvaluations;
 
@@ -309,37 +309,44 @@ void LSHSearch<SortPolicy, MatType>::Train(MatType referenceSet,
   secondHashBinCounts.transform([effectiveBucketSize](size_t val)
       { return std::min(val, effectiveBucketSize); });
 
+  // The rows of the second hash table are stored one after the other in
+  // 'bucketContents', and row r spans bucketOffsets[r] to
+  // bucketOffsets[r + 1] - 1.  First we give a row to each nonempty bucket, in
+  // the order the buckets are first seen, and compute where each row starts.
   const size_t numRowsInTable = arma::accu(secondHashBinCounts > 0);
-  bucketContentSize.zeros(numRowsInTable);
-  secondHashTable.resize(numRowsInTable);
-
-  // Next we must assign each point in each table to the right second hash
-  // table.
+  bucketOffsets.zeros(numRowsInTable + 1);
   size_t currentRow = 0;
   for (size_t i = 0; i < numTables; ++i)
   {
-    // Insert the point in the corresponding row to its bucket in the
-    // 'secondHashTable'.
     for (size_t j = 0; j < secondHashVectors.n_cols; ++j)
     {
       // This is the bucket number.
-      size_t hashInd = (size_t) secondHashVectors(i, j);
-      // The point ID is 'j'.
-
-      // If this is currently an empty bucket, start a new row keep track of
-      // which row corresponds to the bucket.
-      const size_t maxSize = secondHashBinCounts[hashInd];
+      const size_t hashInd = (size_t) secondHashVectors(i, j);
       if (bucketRowInHashTable[hashInd] == secondHashSize)
       {
         bucketRowInHashTable[hashInd] = currentRow;
-        secondHashTable[currentRow].set_size(maxSize);
+        bucketOffsets[currentRow + 1] = secondHashBinCounts[hashInd];
         currentRow++;
       }
+    }
+  }
+
+  for (size_t r = 0; r < numRowsInTable; ++r)
+    bucketOffsets[r + 1] += bucketOffsets[r];
 
-      // If this vector in the hash table is not full, add the point.
-      const size_t index = bucketRowInHashTable[hashInd];
-      if (bucketContentSize[index] < maxSize)
-        secondHashTable[index](bucketContentSize[index]++) = j;
+  // Next we must assign each point in each table to the right row of the
+  // second hash table.  'nextInRow' holds the position of the next point of
+  // each row.
+  bucketContents.set_size(bucketOffsets[numRowsInTable]);
+  arma::Col<size_t> nextInRow = bucketOffsets.head(numRowsInTable);
+  for (size_t i = 0; i < numTables; ++i)
+  {
+    for (size_t j = 0; j < secondHashVectors.n_cols; ++j)
+    {
+      // The point ID is 'j'.  If its row is not full, add the point.
+      const size_t row = bucketRowInHashTable[secondHashVectors(i, j)];
+      if (nextInRow[row] < bucketOffsets[row + 1])
+        bucketContents[nextInRow[row]++] = j;
     } // Loop over all points in the reference set.
   } // Loop over tables.
 
@@ -703,34 +710,71 @@ void LSHSearch<SortPolicy, MatType>::GetAdditionalProbingBins(
 }
 
 template<typename SortPolicy, typename MatType>
-template<typename VecType>
+std::vector<arma::Col<size_t>>
+LSHSearch<SortPolicy, MatType>::SecondHashTable() const
+{
+  const size_t numRows = (bucketOffsets.n_elem == 0) ? 0 :
+      bucketOffsets.n_elem - 1;
+
+  std::vector<arma::Col<size_t>> secondHashTable(numRows);
+  for (size_t i = 0; i < numRows; ++i)
+  {
+    if (bucketOffsets[i + 1] > bucketOffsets[i])
+    {
+      secondHashTable[i] = bucketContents.subvec(bucketOffsets[i],
+          bucketOffsets[i + 1] - 1);
+    }
+  }
+
+  return secondHashTable;
+}
+
+template<typename SortPolicy, typename MatType>
+size_t LSHSearch<SortPolicy, MatType>::TablesToSearch(
+    const size_t numTablesToSearch) const
+{
+  // If no user input is given, search all.  Also make sure that the existing
+  // number of tables is not exceeded.
+  if (numTablesToSearch == 0 || numTablesToSearch > numTables)
+    return numTables;
+
+  return numTablesToSearch;
+}
+
+template<typename SortPolicy, typename MatType>
+void LSHSearch<SortPolicy, MatType>::ProjectQueries(
+    const MatType& querySet,
+    const size_t begin,
+    const size_t count,
+    const size_t numTablesToSearch,
+    arma::mat& queryProjections) const
+{
+  // The slices of the projection cube are contiguous, so the projections of
+  // the first 'numTablesToSearch' tables can be seen as one (dims x
+  // (numProj * numTablesToSearch)) matrix, and all the queries of the block
+  // can be projected on every table with one matrix multiplication.
+  const arma::mat allProjections(const_cast<double*>(projections.memptr()),
+      projections.n_rows, numProj * numTablesToSearch, false, true);
+  queryProjections = allProjections.t() *
+      querySet.cols(begin, begin + count - 1);
+}
+
+template<typename SortPolicy, typename MatType>
 void LSHSearch<SortPolicy, MatType>::ReturnIndicesFromTable(
-    const VecType& queryPoint,
+    const arma::mat& queryProjections,
     arma::uvec& referenceIndices,
-    size_t numTablesToSearch,
     const size_t T) const
 {
-  // Decide on the number of tables to look into.
-  if (numTablesToSearch == 0) // If no user input is given, search all.
-    numTablesToSearch = numTables;
-
-  // Sanity check to make sure that the existing number of tables is not
-  // exceeded.
-  if (numTablesToSearch > numTables)
-    numTablesToSearch = numTables;
-
   // Hash the query in each of the 'numTablesToSearch' hash tables using the
   // 'numProj' projections for each table. This gives us 'numTablesToSearch'
   // keys for the query where each key is a 'numProj' dimensional integer
   // vector.
+  const size_t numTablesToSearch = queryProjections.n_cols;
 
-  // Compute the projection of the query in each table.
+  // The projection of the query in each table was already computed.
   arma::mat allProjInTables(numProj, numTablesToSearch);
-  arma::mat queryCodesNotFloored(numProj, numTablesToSearch);
-  for (size_t i = 0; i < numTablesToSearch; ++i)
-    queryCodesNotFloored.unsafe_col(i) = projections.slice(i).t() * queryPoint;
-
-  queryCodesNotFloored += offsets.cols(0, numTablesToSearch - 1);
+  arma::mat queryCodesNotFloored = queryProjections +
+      offsets.cols(0, numTablesToSearch - 1);
   allProjInTables = arma::floor(queryCodesNotFloored / hashWidth);
 
   // Use hashMat to store the primary probing codes and any additional codes
@@ -776,8 +820,8 @@ void LSHSearch<SortPolicy, MatType>::ReturnIndicesFromTable(
     {
       const size_t hashInd = hashMat(p, i); // find query's bucket
       const size_t tableRow = bucketRowInHashTable[hashInd];
-      if (tableRow < secondHashSize)
-        maxNumPoints += bucketContentSize[tableRow]; // count bucket contents
+      if (tableRow < secondHashSize) // count bucket contents
+        maxNumPoints += bucketOffsets[tableRow + 1] - bucketOffsets[tableRow];
     }
   }
 
@@ -808,11 +852,12 @@ void LSHSearch<SortPolicy, MatType>::ReturnIndicesFromTable(
         size_t hashInd = hashMat(p, i);
         size_t tableRow = bucketRowInHashTable[hashInd];
 
-        if (tableRow < secondHashSize && bucketContentSize[tableRow] > 0)
+        if (tableRow < secondHashSize)
         {
           // Pick the indices in the bucket corresponding to hashInd.
-          for (size_t j = 0; j < bucketContentSize[tableRow]; ++j)
-            refPointsConsidered[ secondHashTable[tableRow](j) ]++;
+          for (size_t j = bucketOffsets[tableRow];
+               j < bucketOffsets[tableRow + 1]; ++j)
+            refPointsConsidered[bucketContents[j]]++;
         }
       }
     }
@@ -841,9 +886,10 @@ void LSHSearch<SortPolicy, MatType>::ReturnIndicesFromTable(
 
         if (tableRow < secondHashSize)
         {
-          // Store all secondHashTable points in the candidates set.
-          for (size_t j = 0; j < bucketContentSize[tableRow]; ++j)
-            refPointsConsideredSmall(start++) = secondHashTable[tableRow](j);
+          // Store all points of the bucket in the candidates set.
+          for (size_t j = bucketOffsets[tableRow];
+               j < bucketOffsets[tableRow + 1]; ++j)
+            refPointsConsideredSmall(start++) = bucketContents[j];
        }
       }
     }
@@ -908,32 +954,45 @@ void LSHSearch<SortPolicy, MatType>::Search(
         <<" additional probing bins per table per query." << std::endl;
 
   size_t avgIndicesReturned = 0;
+  const size_t tablesToSearch = TablesToSearch(numTablesToSearch);
 
   Timer::Start("computing_neighbors");
 
-  // Parallelization to process more than one query at a time.
-  #pragma omp parallel for \
-      shared(resultingNeighbors, distances) \
-      schedule(dynamic)\
-      reduction(+:avgIndicesReturned)
-  for (omp_size_t i = 0; i < (omp_size_t) querySet.n_cols; ++i)
+  // The queries are hashed in blocks: each block is projected on all tables
+  // at once, and then the queries of the block are processed in parallel.
+  arma::mat queryProjections;
+  for (size_t begin = 0; begin < querySet.n_cols; begin += queryBlockSize)
   {
-    // Go through every query point.
-    // Hash every query into every hash table and eventually into the
-    // 'secondHashTable' to obtain the neighbor candidates.
-    arma::uvec refIndices;
-    ReturnIndicesFromTable(querySet.col(i), refIndices, numTablesToSearch,
-        Teffective);
-
-    // An informative book-keeping for the number of neighbor candidates
-    // returned on average.
-    // Make atomic to avoid race conditions when multiple threads are running
-    // #pragma omp atomic
-    avgIndicesReturned = avgIndicesReturned + refIndices.n_elem;
-
-    // Sequentially go through all the candidates and save the best 'k'
-    // candidates.
-    BaseCase(i, refIndices, k, querySet, resultingNeighbors, distances);
+    const size_t count = std::min((size_t) queryBlockSize,
+        (size_t) querySet.n_cols - begin);
+    ProjectQueries(querySet, begin, count, tablesToSearch, queryProjections);
+
+    // Parallelization to process more than one query at a time.  Each thread
+    // counts the candidates of its own queries, and the counts are summed by
+    // the reduction.
+    #pragma omp parallel for \
+        shared(resultingNeighbors, distances, queryProjections) \
+        schedule(dynamic)\
+        reduction(+:avgIndicesReturned)
+    for (omp_size_t c = 0; c < (omp_size_t) count; ++c)
+    {
+      // Go through every query point.
+      // Hash every query into every hash table and eventually into the
+      // second hash table to obtain the neighbor candidates.
+      const size_t i = begin + c;
+      const arma::mat queryProjection(queryProjections.colptr(c), numProj,
+          tablesToSearch);
+      arma::uvec refIndices;
+      ReturnIndicesFromTable(queryProjection, refIndices, Teffective);
+
+      // An informative book-keeping for the number of neighbor candidates
+      // returned on average.
+      avgIndicesReturned += refIndices.n_elem;
+
+      // Sequentially go through all the candidates and save the best 'k'
+      // candidates.
+      BaseCase(i, refIndices, k, querySet, resultingNeighbors, distances);
+    }
   }
 
   Timer::Stop("computing_neighbors");
@@ -974,32 +1033,46 @@ Search(const size_t k,
       " additional probing bins per table per query."<< std::endl;
 
   size_t avgIndicesReturned = 0;
+  const size_t tablesToSearch = TablesToSearch(numTablesToSearch);
 
   Timer::Start("computing_neighbors");
 
-  // Parallelization to process more than one query at a time.
-  #pragma omp parallel for \
-      shared(resultingNeighbors, distances) \
-      schedule(dynamic)\
-      reduction(+:avgIndicesReturned)
-  for (omp_size_t i = 0; i < (omp_size_t) referenceSet.n_cols; ++i)
+  // The queries are hashed in blocks: each block is projected on all tables
+  // at once, and then the queries of the block are processed in parallel.
+  arma::mat queryProjections;
+  for (size_t begin = 0; begin < referenceSet.n_cols; begin += queryBlockSize)
   {
-    // Go through every query point.
-    // Hash every query into every hash table and eventually into the
-    // 'secondHashTable' to obtain the neighbor candidates.
-    arma::uvec refIndices;
-    ReturnIndicesFromTable(referenceSet.col(i), refIndices, numTablesToSearch,
-        Teffective);
-
-    // An informative book-keeping for the number of neighbor candidates
-    // returned on average.
-    // Make atomic to avoid race conditions when multiple threads are running.
-    // #pragma omp atomic
-    avgIndicesReturned += refIndices.n_elem;
-
-    // Sequentially go through all the candidates and save the best 'k'
-    // candidates.
-    BaseCase(i, refIndices, k, resultingNeighbors, distances);
+    const size_t count = std::min((size_t) queryBlockSize,
+        (size_t) referenceSet.n_cols - begin);
+    ProjectQueries(referenceSet, begin, count, tablesToSearch,
+        queryProjections);
+
+    // Parallelization to process more than one query at a time.  Each thread
+    // counts the candidates of its own queries, and the counts are summed by
+    // the reduction.
+    #pragma omp parallel for \
+        shared(resultingNeighbors, distances, queryProjections) \
+        schedule(dynamic)\
+        reduction(+:avgIndicesReturned)
+    for (omp_size_t c = 0; c < (omp_size_t) count; ++c)
+    {
+      // Go through every query point.
+      // Hash every query into every hash table and eventually into the
+      // second hash table to obtain the neighbor candidates.
+      const size_t i = begin + c;
+      const arma::mat queryProjection(queryProjections.colptr(c), numProj,
+          tablesToSearch);
+      arma::uvec refIndices;
+      ReturnIndicesFromTable(queryProjection, refIndices, Teffective);
+
+      // An informative book-keeping for the number of neighbor candidates
+      // returned on average.
+      avgIndicesReturned += refIndices.n_elem;
+
+      // Sequentially go through all the candidates and save the best 'k'
+      // candidates.
+      BaseCase(i, refIndices, k, resultingNeighbors, distances);
+    }
   }
 
   Timer::Stop("computing_neighbors");
@@ -1073,74 +1146,103 @@ void LSHSearch<SortPolicy, MatType>::serialize(Archive& ar,
   ar & BOOST_SERIALIZATION_NVP(bucketSize);
   // needs specific handling for new version
 
-  // Backward compatibility: in older versions of LSHSearch, the secondHashTable
-  // was stored as an arma::Mat<size_t>.  So we need to properly load that, then
-  // prune it down to size.
-  if (version == 0)
+  if (version >= 2)
+  {
+    ar & BOOST_SERIALIZATION_NVP(bucketOffsets);
+    ar & BOOST_SERIALIZATION_NVP(bucketContents);
+    ar & BOOST_SERIALIZATION_NVP(bucketRowInHashTable);
+  }
+  else
   {
-    arma::Mat<size_t> tmpSecondHashTable;
-    ar & BOOST_SERIALIZATION_NVP(tmpSecondHashTable);
+    // Backward compatibility: older versions of LSHSearch held each row of the
+    // second hash table in its own vector, along with the number of points in
+    // each row.  We load those, and then pack the rows together.
+    std::vector<arma::Col<size_t>> secondHashTable;
+    arma::Col<size_t> bucketContentSize;
+
+    // In the first version of LSHSearch, the second hash table was stored as an
+    // arma::Mat<size_t>.  So we need to properly load that, then prune it down
+    // to size.
+    if (version == 0)
+    {
+      arma::Mat<size_t> tmpSecondHashTable;
+      ar & BOOST_SERIALIZATION_NVP(tmpSecondHashTable);
 
-    // The old secondHashTable was stored in row-major format, so we transpose
-    // it.
-    tmpSecondHashTable = tmpSecondHashTable.t();
+      // The old secondHashTable was stored in row-major format, so we transpose
+      // it.
+      tmpSecondHashTable = tmpSecondHashTable.t();
 
-    secondHashTable.resize(tmpSecondHashTable.n_cols);
-    for (size_t i = 0; i < tmpSecondHashTable.n_cols; ++i)
+      secondHashTable.resize(tmpSecondHashTable.n_cols);
+      for (size_t i = 0; i < tmpSecondHashTable.n_cols; ++i)
+      {
+        // Find length of each column.  We know we are at the end of the list
+        // when the value referenceSet.n_cols is seen.
+
+        size_t len = 0;
+        for (; len < tmpSecondHashTable.n_rows; ++len)
+          if (tmpSecondHashTable(len, i) == referenceSet.n_cols)
+            break;
+
+        // Set the size of the new column correctly.
+        secondHashTable[i].set_size(len);
+        for (size_t j = 0; j < len; ++j)
+          secondHashTable[i](j) = tmpSecondHashTable(j, i);
+      }
+    }
+    else
     {
-      // Find length of each column.  We know we are at the end of the list when
-      // the value referenceSet.n_cols is seen.
+      size_t tables;
+      if (Archive::is_saving::value)
+        tables = secondHashTable.size();
+      ar & BOOST_SERIALIZATION_NVP(tables);
 
-      size_t len = 0;
-      for (; len < tmpSecondHashTable.n_rows; ++len)
-        if (tmpSecondHashTable(len, i) == referenceSet.n_cols)
-          break;
+      // Set size of second hash table if needed.
+      if (Archive::is_loading::value)
+      {
+        secondHashTable.clear();
+        secondHashTable.resize(tables);
+      }
 
-      // Set the size of the new column correctly.
-      secondHashTable[i].set_size(len);
-      for (size_t j = 0; j < len; ++j)
-        secondHashTable[i](j) = tmpSecondHashTable(j, i);
+      ar & BOOST_SERIALIZATION_NVP(secondHashTable);
     }
-  }
-  else
-  {
-    size_t tables;
-    if (Archive::is_saving::value)
-      tables = secondHashTable.size();
-    ar & BOOST_SERIALIZATION_NVP(tables);
 
-    // Set size of second hash table if needed.
-    if (Archive::is_loading::value)
+    // Backward compatibility: old versions of LSHSearch held bucketContentSize
+    // for all possible buckets (of size secondHashSize), but now we hold a
+    // compressed representation.
+    if (version == 0)
     {
-      secondHashTable.clear();
-      secondHashTable.resize(tables);
+      // The vector was stored in the old uncompressed form.  So we need to
+      // shrink it.  But we can't do that until we have bucketRowInHashTable, so
+      // we also have to load that.
+      arma::Col<size_t> tmpBucketContentSize;
+      ar & BOOST_SERIALIZATION_NVP(tmpBucketContentSize);
+      ar & BOOST_SERIALIZATION_NVP(bucketRowInHashTable);
+
+      // Compress into a smaller vector by just dropping all of the zeros.
+      bucketContentSize.zeros(secondHashTable.size());
+      for (size_t i = 0; i < tmpBucketContentSize.n_elem; ++i)
+        if (tmpBucketContentSize[i] > 0)
+          bucketContentSize[bucketRowInHashTable[i]] = tmpBucketContentSize[i];
+    }
+    else
+    {
+      ar & BOOST_SERIALIZATION_NVP(bucketContentSize);
+      ar & BOOST_SERIALIZATION_NVP(bucketRowInHashTable);
     }
 
-    ar & BOOST_SERIALIZATION_NVP(secondHashTable);
-  }
-
-  // Backward compatibility: old versions of LSHSearch held bucketContentSize
-  // for all possible buckets (of size secondHashSize), but now we hold a
-  // compressed representation.
-  if (version == 0)
-  {
-    // The vector was stored in the old uncompressed form.  So we need to shrink
-    // it.  But we can't do that until we have bucketRowInHashTable, so we also
-    // have to load that.
-    arma::Col<size_t> tmpBucketContentSize;
-    ar & BOOST_SERIALIZATION_NVP(tmpBucketContentSize);
-    ar & BOOST_SERIALIZATION_NVP(bucketRowInHashTable);
+    bucketOffsets.set_size(secondHashTable.size() + 1);
+    bucketOffsets[0] = 0;
+    for (size_t i = 0; i < secondHashTable.size(); ++i)
+    {
+      bucketContentSize[i] = std::min((size_t) bucketContentSize[i],
+          (size_t) secondHashTable[i].n_elem);
+      bucketOffsets[i + 1] = bucketOffsets[i] + bucketContentSize[i];
+    }
 
-    // Compress into a smaller vector by just dropping all of the zeros.
-    bucketContentSize.set_size(secondHashTable.size());
-    for (size_t i = 0; i < tmpBucketContentSize.n_elem; ++i)
-      if (tmpBucketContentSize[i] > 0)
-        bucketContentSize[bucketRowInHashTable[i]] = tmpBucketContentSize[i];
-  }
-  else
-  {
-    ar & BOOST_SERIALIZATION_NVP(bucketContentSize);
-    ar & BOOST_SERIALIZATION_NVP(bucketRowInHashTable);
+    bucketContents.set_size(bucketOffsets[secondHashTable.size()]);
+    for (size_t i = 0; i < secondHashTable.size(); ++i)
+      for (size_t j = 0; j < bucketContentSize[i]; ++j)
+        bucketContents[bucketOffsets[i] + j] = secondHashTable[i][j];
   }
 
   ar & BOOST_SERIALIZATION_NVP(distanceEvaluations);
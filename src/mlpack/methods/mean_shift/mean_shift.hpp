@@ -25,7 +25,9 @@ namespace meanshift /** Mean shift clustering. */ {
 /**
  * This class implements mean shift clustering.  For each point in dataset,
  * apply mean shift algorithm until maximum iterations or convergence.  Then
- * remove duplicate centroids.
+ * remove duplicate centroids.  The centroids of all the seeds are shifted
+ * together, one iteration at a time, with a parallel single-tree range search
+ * on a tree built once on the dataset.
  *
  * A simple example of how to run mean shift clustering is shown below.
  *
@@ -127,34 +129,34 @@ class MeanShift
                 MatType& seeds);
 
   /**
-   * Use kernel to calculate new centroid given dataset and valid neighbors.
+   * Return the weight of a neighbor at the given distance from the current
+   * centroid when the kernel is used: the gradient of the kernel divided by the
+   * scaled distance, or 0 for a neighbor at the centroid itself.
    *
-   * @param data The whole dataset
-   * @param neighbors Valid neighbors
-   * @param distances Distances to neighbors
-   # @param centroid Store calculated centroid
+   * @param distance Distance between the neighbor and the centroid.
    */
   template<bool ApplyKernel = UseKernel>
-  typename std::enable_if<ApplyKernel, bool>::type
-  CalculateCentroid(const MatType& data,
-                    const std::vector<size_t>& neighbors,
-                    const std::vector<double>& distances,
-                    arma::colvec& centroid);
+  typename std::enable_if<ApplyKernel, double>::type
+  NeighborWeight(const double distance);
 
   /**
-   * Use mean to calculate new centroid given dataset and valid neighbors.
-   *
-   * @param data The whole dataset
-   * @param neighbors Valid neighbors
-   * @param distances Distances to neighbors
-   # @param centroid Store calculated centroid
+   * Return the weight of a neighbor when the mean is used; this is always 1.
    */
   template<bool ApplyKernel = UseKernel>
-  typename std::enable_if<!ApplyKernel, bool>::type
-  CalculateCentroid(const MatType& data,
-                    const std::vector<size_t>& neighbors,
-                    const std::vector<double>&, /*unused*/
-                    arma::colvec& centroid);
+  typename std::enable_if<!ApplyKernel, double>::type
+  NeighborWeight(const double /* distance */) { return 1.0; }
+
+  /**
+   * Remove duplicate centroids.  The candidates are considered in order, and
+   * each one is kept unless it is closer than the radius to a centroid that
+   * was already kept.  Only the kept centroids are searched for (with a tree
+   * built on the candidates), so this scales with the number of candidates
+   * rather than its square.
+   *
+   * @param candidates Converged centroids, in the order of their seeds.
+   * @param centroids Matrix to store the kept centroids in.
+   */
+  void RemoveDuplicates(const arma::mat& candidates, arma::mat& centroids);
 
   /**
    * If distance of two centroids is less than radius, one will be removed.
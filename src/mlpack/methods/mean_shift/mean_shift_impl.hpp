@@ -129,51 +129,47 @@ void MeanShift<UseKernel, KernelType, MatType>::GenSeeds(
   seeds *= binSize;
 }
 
-// Calculate new centroid with given kernel.
+// Weight of a neighbor with the given kernel.
 template<bool UseKernel, typename KernelType, typename MatType>
 template<bool ApplyKernel>
-typename std::enable_if<ApplyKernel, bool>::type
-MeanShift<UseKernel, KernelType, MatType>::
-CalculateCentroid(const MatType& data,
-                  const std::vector<size_t>& neighbors,
-                  const std::vector<double>& distances,
-                  arma::colvec& centroid)
+typename std::enable_if<ApplyKernel, double>::type
+MeanShift<UseKernel, KernelType, MatType>::NeighborWeight(
+    const double distance)
 {
-  double sumWeight = 0;
-  for (size_t i = 0; i < neighbors.size(); ++i)
-  {
-    if (distances[i] > 0)
-    {
-      double dist = distances[i] / radius;
-      double weight = kernel.Gradient(dist) / dist;
-      sumWeight += weight;
-      centroid += weight * data.unsafe_col(neighbors[i]);
-    }
-  }
+  if (distance <= 0)
+    return 0.0;
 
-  if (sumWeight != 0)
-  {
-    centroid /= sumWeight;
-    return true;
-  }
-  return false;
+  const double dist = distance / radius;
+  return kernel.Gradient(dist) / dist;
 }
 
-// Calculate new centroid by mean.
 template<bool UseKernel, typename KernelType, typename MatType>
-template<bool ApplyKernel>
-typename std::enable_if<!ApplyKernel, bool>::type
-MeanShift<UseKernel, KernelType, MatType>::
-CalculateCentroid(const MatType& data,
-                  const std::vector<size_t>& neighbors,
-                  const std::vector<double>&, /*unused*/
-                  arma::colvec& centroid)
+void MeanShift<UseKernel, KernelType, MatType>::RemoveDuplicates(
+    const arma::mat& candidates,
+    arma::mat& centroids)
 {
-  for (size_t i = 0; i < neighbors.size(); ++i)
-    centroid += data.unsafe_col(neighbors[i]);
+  range::RangeSearch<> candidateSearcher(candidates, false, true);
+  const math::Range validRadius(0, radius);
+  std::vector<std::vector<size_t>> neighbors;
+  std::vector<std::vector<double>> distances;
+
+  std::vector<bool> duplicated(candidates.n_cols, false);
+  std::vector<size_t> kept;
+  for (size_t i = 0; i < candidates.n_cols; ++i)
+  {
+    if (duplicated[i])
+      continue;
+
+    // Keep this centroid, and mark the later candidates close to it.
+    kept.push_back(i);
+    candidateSearcher.Search(arma::mat(candidates.col(i)), validRadius,
+        neighbors, distances);
+    for (size_t j = 0; j < neighbors[0].size(); ++j)
+      if (distances[0][j] < radius && neighbors[0][j] > i)
+        duplicated[neighbors[0][j]] = true;
+  }
 
-  centroid /= neighbors.size();
-  return true;
+  centroids = candidates.cols(arma::conv_to<arma::uvec>::from(kept));
 }
 
 /**
@@ -202,63 +198,89 @@ inline void MeanShift<UseKernel, KernelType, MatType>::Cluster(
     pSeeds = &seeds;
   }
 
-  // Holds all centroids before removing duplicate ones.
-  arma::mat allCentroids(pSeeds->n_rows, pSeeds->n_cols);
+  // Holds all centroids before removing duplicate ones.  The initial centroid
+  // of each seed is the seed itself.
+  arma::mat allCentroids(*pSeeds);
 
   assignments.set_size(data.n_cols);
 
-  range::RangeSearch<> rangeSearcher(data);
-  math::Range validRadius(0, radius);
-  std::vector<std::vector<size_t> > neighbors;
-  std::vector<std::vector<double> > distances;
-
-  // For each seed, perform mean shift algorithm.
-  for (size_t i = 0; i < pSeeds->n_cols; ++i)
+  // The tree on the dataset is built once, and every iteration searches the
+  // centroids of all the seeds that are still moving, in parallel.
+  range::RangeSearch<> rangeSearcher(data, false, true);
+  rangeSearcher.NumThreads() = 0;
+  const math::Range validRadius(0, radius);
+
+  // The seeds whose centroids are still moving, and whether each seed has
+  // converged.
+  std::vector<size_t> active(pSeeds->n_cols);
+  for (size_t i = 0; i < active.size(); ++i)
+    active[i] = i;
+  std::vector<bool> converged(pSeeds->n_cols, false);
+
+  arma::mat sums;
+  arma::vec sumWeights;
+  arma::Col<size_t> counts;
+  for (size_t completedIterations = 0; !active.empty() &&
+      (completedIterations < maxIterations || forceConvergence);
+      completedIterations++)
   {
-    // Initial centroid is the seed itself.
-    allCentroids.col(i) = pSeeds->unsafe_col(i);
-    for (size_t completedIterations = 0; completedIterations < maxIterations
-        || forceConvergence; completedIterations++)
+    const arma::mat queries = allCentroids.cols(
+        arma::conv_to<arma::uvec>::from(active));
+
+    // Accumulate the weighted neighbors of each centroid.  In single-tree mode
+    // each query point is handled by a single thread, so the columns can be
+    // updated without synchronization.
+    sums.zeros(data.n_rows, active.size());
+    sumWeights.zeros(active.size());
+    counts.zeros(active.size());
+    rangeSearcher.Search(queries, validRadius,
+        [&](const size_t q, const size_t r, const double distance)
+        {
+          const double weight = NeighborWeight(distance);
+          sums.col(q) += weight * data.col(r);
+          sumWeights[q] += weight;
+          ++counts[q];
+        });
+
+    std::vector<size_t> stillActive;
+    for (size_t q = 0; q < active.size(); ++q)
     {
-      // Store new centroid in this.
-      arma::colvec newCentroid = arma::zeros<arma::colvec>(pSeeds->n_rows);
-
-      rangeSearcher.Search(allCentroids.unsafe_col(i), validRadius,
-          neighbors, distances);
-      if (neighbors[0].size() == 0) // There are no points in the cluster.
-        break;
+      const size_t i = active[q];
+      if (counts[q] == 0) // There are no points in the cluster.
+        continue;
 
       // Calculate new centroid.
-      if (!CalculateCentroid(data, neighbors[0], distances[0], newCentroid))
-        newCentroid = allCentroids.unsafe_col(i);
+      arma::colvec newCentroid = (sumWeights[q] != 0) ?
+          arma::colvec(sums.col(q) / sumWeights[q]) :
+          arma::colvec(allCentroids.col(i));
 
       // If the mean shift vector is small enough, it has converged.
       if (metric::EuclideanDistance::Evaluate(newCentroid,
           allCentroids.unsafe_col(i)) < 1e-3 * radius)
       {
-        // Determine if the new centroid is duplicate with old ones.
-        bool isDuplicated = false;
-        for (size_t k = 0; k < centroids.n_cols; ++k)
-        {
-          const double distance = metric::EuclideanDistance::Evaluate(
-              allCentroids.unsafe_col(i), centroids.unsafe_col(k));
-          if (distance < radius)
-          {
-            isDuplicated = true;
-            break;
-          }
-        }
-
-        if (!isDuplicated)
-          centroids.insert_cols(centroids.n_cols, allCentroids.unsafe_col(i));
-
-        // Get out of the loop.
-        break;
+        converged[i] = true;
+        continue;
       }
 
       // Update the centroid.
       allCentroids.col(i) = newCentroid;
+      stillActive.push_back(i);
     }
+
+    active.swap(stillActive);
+  }
+
+  // Remove the converged centroids that duplicate earlier ones.
+  std::vector<size_t> convergedSeeds;
+  for (size_t i = 0; i < converged.size(); ++i)
+    if (converged[i])
+      convergedSeeds.push_back(i);
+
+  centroids.set_size(data.n_rows, 0);
+  if (!convergedSeeds.empty())
+  {
+    RemoveDuplicates(allCentroids.cols(
+        arma::conv_to<arma::uvec>::from(convergedSeeds)), centroids);
   }
 
   // If no centroid has converged due to too little iterations and without
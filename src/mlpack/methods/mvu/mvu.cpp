@@ -13,13 +13,12 @@
  */
 #include "mvu.hpp"
 
-#include <mlpack/core/optimizers/sdp/lrsdp.hpp>
-
 #include <mlpack/methods/neighbor_search/neighbor_search.hpp>
+#include <ensmallen.hpp>
 
 using namespace mlpack;
 using namespace mlpack::mvu;
-using namespace mlpack::optimization;
+using namespace mlpack::neighbor;
 
 MVU::MVU(const arma::mat& data) : data(data)
 {
@@ -30,74 +29,142 @@ void MVU::Unfold(const size_t newDim,
                  const size_t numNeighbors,
                  arma::mat& outputData)
 {
+  Solve(data, newDim, numNeighbors, outputData);
+}
+
+void MVU::Unfold(const size_t newDim,
+                 const size_t numNeighbors,
+                 const size_t numLandmarks,
+                 arma::mat& outputData)
+{
+  if (numLandmarks == 0 || numLandmarks >= data.n_cols)
+  {
+    Solve(data, newDim, numNeighbors, outputData);
+    return;
+  }
+
+  if (numNeighbors >= numLandmarks)
+  {
+    std::ostringstream oss;
+    oss << "MVU::Unfold(): the number of neighbors (" << numNeighbors
+        << ") must be less than the number of landmarks (" << numLandmarks
+        << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  // Choose the landmarks at random, and unfold them.
+  const arma::uvec landmarks = arma::sort(arma::randperm(data.n_cols,
+      numLandmarks));
+  const arma::mat landmarkData = data.cols(landmarks);
+  arma::mat landmarkOutput;
+  Solve(landmarkData, newDim, numNeighbors, landmarkOutput);
+
+  // Find the nearest landmarks of every point.
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  KNN knn(landmarkData);
+  knn.Search(data, numNeighbors, neighbors, distances);
+
+  // Each point is reconstructed from its nearest landmarks with the weights
+  // that best reconstruct it in the original space (as in LLE): w solves
+  // G w = 1, where G is the (regularized) Gram matrix of the differences
+  // between the landmarks and the point, and is normalized to sum to 1.
+  outputData.set_size(newDim, data.n_cols);
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) data.n_cols; ++i)
+  {
+    // A landmark is its own nearest landmark.
+    if (distances(0, i) == 0.0)
+    {
+      outputData.col(i) = landmarkOutput.col(neighbors(0, i));
+      continue;
+    }
+
+    arma::mat differences(data.n_rows, numNeighbors);
+    for (size_t j = 0; j < numNeighbors; ++j)
+      differences.col(j) = landmarkData.col(neighbors(j, i)) - data.col(i);
+
+    arma::mat gram = differences.t() * differences;
+    const double trace = arma::trace(gram);
+    gram.diag() += 1e-3 * (trace > 0.0 ? trace : 1.0);
+
+    arma::vec weights;
+    if (!arma::solve(weights, gram, arma::ones<arma::vec>(numNeighbors)))
+      weights.ones(numNeighbors);
+    weights /= arma::accu(weights);
+
+    outputData.col(i).zeros();
+    for (size_t j = 0; j < numNeighbors; ++j)
+      outputData.col(i) += weights[j] * landmarkOutput.col(neighbors(j, i));
+  }
+}
+
+void MVU::Solve(const arma::mat& points,
+                const size_t newDim,
+                const size_t numNeighbors,
+                arma::mat& outputData)
+{
+  const size_t n = points.n_cols;
+
   // First we have to choose the output point.  We'll take a linear projection
   // of the data for now (this is probably not a good final solution).
-//  outputData = trans(data.rows(0, newDim - 1));
+//  outputData = trans(points.rows(0, newDim - 1));
   // Following Nick's idea.
-  outputData.randu(data.n_cols, newDim);
+  outputData.randu(n, newDim);
 
-  // The number of constraints is the number of nearest neighbors plus one.
-  LRSDP<arma::sp_mat> mvuSolver(numNeighbors * data.n_cols + 1, outputData);
+  // There is one sparse constraint for each nearest neighbor of each point,
+  // and one dense constraint.
+  ens::LRSDP<ens::SDP<arma::sp_mat>> mvuSolver(numNeighbors * n, 1,
+      outputData);
 
   // Set up the objective.  Because we are maximizing the trace of (R R^T),
   // we'll instead state it as min(-I_n * (R R^T)), meaning C() is -I_n.
-  mvuSolver.C().eye(data.n_cols, data.n_cols);
-  mvuSolver.C() *= -1;
-
-  // Now set up each of the constraints.
-  // The first constraint is trace(ones * R * R^T) = 0.
-  mvuSolver.B()[0] = 0;
-  mvuSolver.A()[0].ones(data.n_cols, data.n_cols);
+  mvuSolver.SDP().C().eye(n, n);
+  mvuSolver.SDP().C() *= -1;
 
-  // All of our other constraints will be sparse except the first.  So set that
-  // vector of modes accordingly.
-  mvuSolver.AModes().ones();
-  mvuSolver.AModes()[0] = 0;
+  // The dense constraint is trace(ones * R * R^T) = 0, which centers the
+  // output.
+  mvuSolver.SDP().DenseB()[0] = 0;
+  mvuSolver.SDP().DenseA()[0].ones(n, n);
 
   // Now all of the other constraints.  We first have to run KNN to get the
   // list of nearest neighbors.
   arma::Mat<size_t> neighbors;
   arma::mat distances;
 
-  KNN knn(data);
+  KNN knn(points);
   knn.Search(numNeighbors, neighbors, distances);
 
   // Add each of the other constraints.  They are sparse constraints:
-  //   Tr(A_ij K) = d_ij;
+  //   Tr(A_ij K) = d_ij^2;
   //   A_ij = zeros except for 1 at (i, i), (j, j); -1 at (i, j), (j, i).
-  for (size_t i = 0; i < neighbors.n_cols; ++i)
+  // Every constraint is independent, so they are built in parallel.
+  arma::vec& b = mvuSolver.SDP().SparseB();
+  std::vector<arma::sp_mat>& a = mvuSolver.SDP().SparseA();
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) n; ++i)
   {
     for (size_t j = 0; j < numNeighbors; ++j)
     {
       // This is the index of the constraint.
-      const size_t index = (i * numNeighbors) + j + 1;
-
-      arma::mat& aRef = mvuSolver.A()[index];
-
-      aRef.set_size(3, 4);
-
-      // A_ij(i, i) = 1.
-      aRef(0, 0) = i;
-      aRef(1, 0) = i;
-      aRef(2, 0) = 1;
-
-      // A_ij(i, j) = -1.
-      aRef(0, 1) = i;
-      aRef(1, 1) = neighbors(j, i);
-      aRef(2, 1) = -1;
-
-      // A_ij(j, i) = -1.
-      aRef(0, 2) = neighbors(j, i);
-      aRef(1, 2) = i;
-      aRef(2, 2) = -1;
-
-      // A_ij(j, j) = 1.
-      aRef(0, 3) = neighbors(j, i);
-      aRef(1, 3) = neighbors(j, i);
-      aRef(2, 3) = 1;
-
-      // The constraint b_ij is the distance between these two points.
-      mvuSolver.B()[index] = distances(j, i);
+      const size_t index = (i * numNeighbors) + j;
+      const size_t neighbor = neighbors(j, i);
+
+      arma::umat locations(2, 4);
+      locations(0, 0) = i;
+      locations(1, 0) = i;
+      locations(0, 1) = i;
+      locations(1, 1) = neighbor;
+      locations(0, 2) = neighbor;
+      locations(1, 2) = i;
+      locations(0, 3) = neighbor;
+      locations(1, 3) = neighbor;
+      const arma::vec values = { 1.0, -1.0, -1.0, 1.0 };
+
+      a[index] = arma::sp_mat(locations, values, n, n);
+
+      // The constraint b_ij is the squared distance between these two points.
+      b[index] = distances(j, i) * distances(j, i);
     }
   }
 
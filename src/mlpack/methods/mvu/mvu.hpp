@@ -28,17 +28,74 @@ namespace mvu {
  *
  * - dataset
  * - new dimensionality
+ *
+ * Since MVU solves a semidefinite program over the kernel of all the points,
+ * it can only be run on small datasets.  For larger datasets, landmark MVU can
+ * be used instead: only a subset of the points (the landmarks) is unfolded by
+ * the semidefinite program, and every other point is reconstructed from its
+ * nearest landmarks with the locally linear weights that best reconstruct it
+ * in the original space.
+ *
+ * @code
+ * @inproceedings{weinberger2005nonlinear,
+ *   title={Nonlinear dimensionality reduction by semidefinite programming and
+ *       kernel matrix factorization},
+ *   author={Weinberger, Kilian Q. and Packer, Benjamin D. and Saul, Lawrence
+ *       K.},
+ *   booktitle={Proceedings of the Tenth International Workshop on Artificial
+ *       Intelligence and Statistics (AISTATS 2005)},
+ *   pages={381--388},
+ *   year={2005}
+ * }
+ * @endcode
  */
 class MVU
 {
  public:
   MVU(const arma::mat& dataIn);
 
+  /**
+   * Unfold the dataset into the given number of dimensions, preserving the
+   * distances to the nearest neighbors of each point.
+   *
+   * @param newDim Dimensionality of the output.
+   * @param numNeighbors Number of nearest neighbors of each point whose
+   *     distances are preserved.
+   * @param outputCoordinates Matrix to store the unfolded points in.
+   */
   void Unfold(const size_t newDim,
               const size_t numNeighbors,
               arma::mat& outputCoordinates);
 
+  /**
+   * Unfold the dataset with landmark MVU: the distances between the given
+   * number of randomly chosen landmarks and their nearest neighbors among the
+   * landmarks are preserved, and every point is reconstructed from its
+   * numNeighbors nearest landmarks.  If numLandmarks is 0 or at least the
+   * number of points, this is the same as Unfold() without landmarks.
+   *
+   * @param newDim Dimensionality of the output.
+   * @param numNeighbors Number of nearest neighbors of each point whose
+   *     distances are preserved, and number of landmarks each point is
+   *     reconstructed from.
+   * @param numLandmarks Number of landmarks.
+   * @param outputCoordinates Matrix to store the unfolded points in.
+   */
+  void Unfold(const size_t newDim,
+              const size_t numNeighbors,
+              const size_t numLandmarks,
+              arma::mat& outputCoordinates);
+
  private:
+  /**
+   * Solve the MVU semidefinite program for the given points, and store the
+   * unfolded points (one per column) in outputCoordinates.
+   */
+  static void Solve(const arma::mat& points,
+                    const size_t newDim,
+                    const size_t numNeighbors,
+                    arma::mat& outputCoordinates);
+
   const arma::mat& data;
 };
 
@@ -23,7 +23,13 @@ BINDING_LONG_DESC("This program implements "
     "Maximum Variance Unfolding, a nonlinear dimensionality reduction "
     "technique.  The method minimizes dimensionality by unfolding a manifold "
     "such that the distances to the nearest neighbors of each point are held "
-    "constant.");
+    "constant."
+    "\n\n"
+    "Since the full problem grows quickly with the number of points, landmark "
+    "MVU can be used for larger datasets by specifying the number of landmarks "
+    "with " + PRINT_PARAM_STRING("landmarks") + ".  Only the landmarks are "
+    "unfolded, and every other point is reconstructed from its nearest "
+    "landmarks.");
 
 PARAM_MATRIX_IN_REQ("input", "Input dataset.", "i");
 PARAM_INT_IN_REQ("new_dim", "New dimensionality of dataset.", "d");
@@ -31,6 +37,8 @@ PARAM_INT_IN_REQ("new_dim", "New dimensionality of dataset.", "d");
 PARAM_MATRIX_OUT("output", "Matrix to save unfolded dataset to.", "o");
 PARAM_INT_IN("num_neighbors", "Number of nearest neighbors to consider while "
     "unfolding.", "k", 5);
+PARAM_INT_IN("landmarks", "Number of landmarks to use for landmark MVU (0 "
+    "uses every point).", "l", 0);
 
 using namespace mlpack;
 using namespace mlpack::mvu;
@@ -47,6 +55,7 @@ int main(int argc, char **argv)
   const string outputFile = IO::GetParam<string>("output_file");
   const int newDim = IO::GetParam<int>("new_dim");
   const int numNeighbors = IO::GetParam<int>("num_neighbors");
+  const int landmarks = IO::GetParam<int>("landmarks");
 
   if (!IO::HasParam("output"))
   {
@@ -75,11 +84,19 @@ int main(int argc, char **argv)
         << data.n_cols << ")." << std::endl;
   }
 
+  // Verify that the number of landmarks is valid.
+  if (landmarks < 0 || (landmarks > 0 && landmarks <= numNeighbors))
+  {
+    Log::Fatal << "Invalid number of landmarks (" << landmarks << ").  Must "
+        << "be 0 or greater than the number of neighbors (" << numNeighbors
+        << ")." << std::endl;
+  }
+
   // Now run MVU.
   MVU mvu(data);
 
   mat output;
-  mvu.Unfold(newDim, numNeighbors, output);
+  mvu.Unfold(newDim, numNeighbors, (size_t) landmarks, output);
 
   // Save results to file.
   if (IO::HasParam("output"))
@@ -120,6 +120,26 @@ class NaiveBayesClassifier
              const size_t numClasses,
              const bool incremental = true);
 
+  /**
+   * Train the Naive Bayes classifier on the given sparse dataset.  The model is
+   * the same as the one the dense overload of Train() computes, but the time
+   * taken only grows with the number of nonzero values of the data (plus the
+   * size of the model): the contribution of the zero values of a dimension to
+   * its statistics is added in closed form, and the incremental algorithm
+   * merges the statistics of the whole dataset into the model at once instead
+   * of one point at a time.  The dimensions are processed in parallel.
+   *
+   * @param data The dataset to train on.
+   * @param labels The labels for the dataset.
+   * @param numClasses The numbe of classes in the dataset.
+   * @param incremental Whether or not to use the incremental algorithm for
+   *      training.
+   */
+  void Train(const arma::SpMat<ElemType>& data,
+             const arma::Row<size_t>& labels,
+             const size_t numClasses,
+             const bool incremental = true);
+
   /**
    * Train the Naive Bayes classifier on the given point.  This will use the
    * incremental algorithm for updating the model parameters.  The data must be
@@ -241,6 +261,26 @@ class NaiveBayesClassifier
   template<typename MatType>
   void LogLikelihood(const MatType& data,
                      ModelMatType& logLikelihoods) const;
+
+  /**
+   * Compute the unnormalized posterior log probability of the given sparse
+   * points, without forming the dense difference between each point and each
+   * mean.
+   *
+   * @param data Set of points to compute posterior log probability for.
+   * @param logLikelihoods Matrix to store log likelihoods in.
+   */
+  void LogLikelihood(const arma::SpMat<ElemType>& data,
+                     ModelMatType& logLikelihoods) const;
+
+  /**
+   * Set the size of the model for the given dimensionality and number of
+   * classes, if the number of classes has changed.  If the incremental
+   * algorithm will be used, the model is set to zero.
+   */
+  void ResizeModel(const size_t dimensionality,
+                   const size_t numClasses,
+                   const bool incremental);
 };
 
 } // namespace naive_bayes
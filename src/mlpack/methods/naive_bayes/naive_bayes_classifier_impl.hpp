@@ -85,25 +85,15 @@ void NaiveBayesClassifier<ModelMatType>::Train(
       "NaiveBayesClassifier: element type of given data must match the element "
       "type of the model!");
 
-  // Do we need to resize the model?
-  if (probabilities.n_elem != numClasses)
-  {
-    // Perform training, after initializing the model to 0 (that is, if Train()
-    // won't do that for us, which it won't if we're using the incremental
-    // algorithm).
-    if (incremental)
-    {
-      probabilities.zeros(numClasses);
-      means.zeros(data.n_rows, numClasses);
-      variances.zeros(data.n_rows, numClasses);
-    }
-    else
-    {
-      probabilities.set_size(numClasses);
-      means.set_size(data.n_rows, numClasses);
-      variances.set_size(data.n_rows, numClasses);
-    }
-  }
+  ResizeModel(data.n_rows, numClasses, incremental);
+
+  // Every dimension is estimated independently of the others, so blocks of
+  // dimensions are processed in parallel; each block visits the points in
+  // order, so the model is exactly the same as if the points were visited one
+  // at a time.  The blocks cover a few consecutive rows of each column of the
+  // data, to keep the accesses to it contiguous.
+  const size_t blockRows = 64;
+  const omp_size_t numBlocks = (data.n_rows + blockRows - 1) / blockRows;
 
   // Calculate the class probabilities as well as the sample mean and variance
   // for each of the features with respect to each of the labels.
@@ -112,15 +102,29 @@ void NaiveBayesClassifier<ModelMatType>::Train(
     // Use incremental algorithm.
     // Fist, de-normalize probabilities.
     probabilities *= trainingPoints;
-
+    const ModelMatType oldCounts(probabilities);
     for (size_t j = 0; j < data.n_cols; ++j)
-    {
-      const size_t label = labels[j];
-      ++probabilities[label];
+      ++probabilities[labels[j]];
 
-      arma::vec delta = data.col(j) - means.col(label);
-      means.col(label) += delta / probabilities[label];
-      variances.col(label) += delta % (data.col(j) - means.col(label));
+    #pragma omp parallel for
+    for (omp_size_t b = 0; b < numBlocks; ++b)
+    {
+      const size_t first = b * blockRows;
+      const size_t last = std::min(first + blockRows, (size_t) data.n_rows);
+
+      ModelMatType counts(oldCounts);
+      for (size_t j = 0; j < data.n_cols; ++j)
+      {
+        const size_t label = labels[j];
+        ++counts[label];
+
+        for (size_t d = first; d < last; ++d)
+        {
+          const ElemType delta = data(d, j) - means(d, label);
+          means(d, label) += delta / counts[label];
+          variances(d, label) += delta * (data(d, j) - means(d, label));
+        }
+      }
     }
 
     for (size_t i = 0; i < probabilities.n_elem; ++i)
@@ -142,25 +146,127 @@ void NaiveBayesClassifier<ModelMatType>::Train(
     // too slow, it's an option to use the faster algorithm by default and then
     // have this (and the incremental algorithm) be other options.
 
-    // Calculate the means.
     for (size_t j = 0; j < data.n_cols; ++j)
+      ++probabilities[labels[j]];
+
+    #pragma omp parallel for
+    for (omp_size_t b = 0; b < numBlocks; ++b)
     {
-      const size_t label = labels[j];
-      ++probabilities[label];
-      means.col(label) += data.col(j);
+      const size_t first = b * blockRows;
+      const size_t last = std::min(first + blockRows, (size_t) data.n_rows);
+
+      // Calculate the means.
+      for (size_t j = 0; j < data.n_cols; ++j)
+        for (size_t d = first; d < last; ++d)
+          means(d, labels[j]) += data(d, j);
+
+      // Normalize means.
+      for (size_t i = 0; i < probabilities.n_elem; ++i)
+        if (probabilities[i] != 0.0)
+          for (size_t d = first; d < last; ++d)
+            means(d, i) /= probabilities[i];
+
+      // Calculate variances.
+      for (size_t j = 0; j < data.n_cols; ++j)
+      {
+        const size_t label = labels[j];
+        for (size_t d = first; d < last; ++d)
+        {
+          const ElemType diff = data(d, j) - means(d, label);
+          variances(d, label) += diff * diff;
+        }
+      }
+
+      // Normalize variances.
+      for (size_t i = 0; i < probabilities.n_elem; ++i)
+        if (probabilities[i] > 1)
+          for (size_t d = first; d < last; ++d)
+            variances(d, i) /= (probabilities[i] - 1);
     }
+  }
 
-    // Normalize means.
-    for (size_t i = 0; i < probabilities.n_elem; ++i)
-      if (probabilities[i] != 0.0)
-        means.col(i) /= probabilities[i];
+  // Add epsilon to prevent log of zero.
+  variances += epsilon;
 
-    // Calculate variances.
-    for (size_t j = 0; j < data.n_cols; ++j)
+  probabilities /= data.n_cols;
+  trainingPoints += data.n_cols;
+}
+
+template<typename ModelMatType>
+void NaiveBayesClassifier<ModelMatType>::Train(
+    const arma::SpMat<ElemType>& data,
+    const arma::Row<size_t>& labels,
+    const size_t numClasses,
+    const bool incremental)
+{
+  ResizeModel(data.n_rows, numClasses, incremental);
+
+  // First compute the number of points, the means, and the sums of squared
+  // differences from the mean (M2) of the given data alone.
+  ModelMatType counts(numClasses, 1, arma::fill::zeros);
+  for (size_t j = 0; j < data.n_cols; ++j)
+    ++counts[labels[j]];
+
+  // In the transpose, the nonzero values of each dimension are contiguous.
+  const arma::SpMat<ElemType> dataT = data.t();
+  ModelMatType dataMeans(data.n_rows, numClasses, arma::fill::zeros);
+  ModelMatType dataM2(data.n_rows, numClasses);
+
+  #pragma omp parallel for
+  for (omp_size_t d = 0; d < (omp_size_t) data.n_rows; ++d)
+  {
+    typedef typename arma::SpMat<ElemType>::const_iterator IteratorType;
+    const IteratorType end = dataT.end_col(d);
+
+    for (IteratorType it = dataT.begin_col(d); it != end; ++it)
+      dataMeans(d, labels[it.row()]) += (*it);
+    for (size_t i = 0; i < numClasses; ++i)
+      if (counts[i] != 0.0)
+        dataMeans(d, i) /= counts[i];
+
+    // Each zero value contributes the square of the mean to M2; each nonzero
+    // value replaces that with its own squared difference.
+    for (size_t i = 0; i < numClasses; ++i)
+      dataM2(d, i) = counts[i] * dataMeans(d, i) * dataMeans(d, i);
+    for (IteratorType it = dataT.begin_col(d); it != end; ++it)
+    {
+      const size_t label = labels[it.row()];
+      const ElemType mean = dataMeans(d, label);
+      dataM2(d, label) += ((*it) - mean) * ((*it) - mean) - mean * mean;
+    }
+  }
+
+  if (incremental)
+  {
+    // Merge the statistics of the data with the model; this gives the same
+    // result as the incremental algorithm of the dense overload, up to
+    // floating-point error.  Fist, de-normalize probabilities.
+    probabilities *= trainingPoints;
+    for (size_t i = 0; i < numClasses; ++i)
+    {
+      if (counts[i] == 0.0)
+        continue;
+
+      const double oldCount = probabilities[i];
+      probabilities[i] += counts[i];
+
+      const arma::Col<ElemType> delta = dataMeans.col(i) - means.col(i);
+      means.col(i) += delta * (counts[i] / probabilities[i]);
+      variances.col(i) += dataM2.col(i) +
+          arma::square(delta) * (oldCount * counts[i] / probabilities[i]);
+    }
+
+    for (size_t i = 0; i < probabilities.n_elem; ++i)
     {
-      const size_t label = labels[j];
-      variances.col(label) += square(data.col(j) - means.col(label));
+      if (probabilities[i] > 2)
+        variances.col(i) /= (probabilities[i] - 1);
     }
+  }
+  else
+  {
+    probabilities = counts;
+    means = std::move(dataMeans);
+    variances = std::move(dataM2);
 
     // Normalize variances.
     for (size_t i = 0; i < probabilities.n_elem; ++i)
@@ -175,6 +281,33 @@ void NaiveBayesClassifier<ModelMatType>::Train(
   trainingPoints += data.n_cols;
 }
 
+template<typename ModelMatType>
+void NaiveBayesClassifier<ModelMatType>::ResizeModel(
+    const size_t dimensionality,
+    const size_t numClasses,
+    const bool incremental)
+{
+  // Do we need to resize the model?
+  if (probabilities.n_elem != numClasses)
+  {
+    // Perform training, after initializing the model to 0 (that is, if Train()
+    // won't do that for us, which it won't if we're using the incremental
+    // algorithm).
+    if (incremental)
+    {
+      probabilities.zeros(numClasses);
+      means.zeros(dimensionality, numClasses);
+      variances.zeros(dimensionality, numClasses);
+    }
+    else
+    {
+      probabilities.set_size(numClasses);
+      means.set_size(dimensionality, numClasses);
+      variances.set_size(dimensionality, numClasses);
+    }
+  }
+}
+
 template<typename ModelMatType>
 template<typename VecType>
 void NaiveBayesClassifier<ModelMatType>::Train(const VecType& point,
@@ -230,6 +363,42 @@ void NaiveBayesClassifier<ModelMatType>::LogLikelihood(
   }
 }
 
+template<typename ModelMatType>
+void NaiveBayesClassifier<ModelMatType>::LogLikelihood(
+    const arma::SpMat<ElemType>& data,
+    ModelMatType& logLikelihoods) const
+{
+  logLikelihoods = arma::log(arma::repmat(probabilities, 1, data.n_cols));
+  const ModelMatType invVar = 1.0 / variances;
+
+  // The exponent of a point without nonzero values is -1/2 sum(mean^2 / var);
+  // each nonzero value x of the point replaces mean^2 with (x - mean)^2 in
+  // that sum.
+  for (size_t i = 0; i < means.n_cols; ++i)
+  {
+    logLikelihoods.row(i) += data.n_rows / -2.0 * log(2 * M_PI) - 0.5 *
+        arma::accu(arma::log(variances.col(i))) - 0.5 *
+        arma::accu(arma::square(means.col(i)) % invVar.col(i));
+  }
+
+  #pragma omp parallel for
+  for (omp_size_t j = 0; j < (omp_size_t) data.n_cols; ++j)
+  {
+    typedef typename arma::SpMat<ElemType>::const_iterator IteratorType;
+    const IteratorType end = data.end_col(j);
+    for (IteratorType it = data.begin_col(j); it != end; ++it)
+    {
+      const size_t d = it.row();
+      for (size_t i = 0; i < means.n_cols; ++i)
+      {
+        const ElemType mean = means(d, i);
+        logLikelihoods(i, j) -= 0.5 * invVar(d, i) *
+            (((*it) - mean) * ((*it) - mean) - mean * mean);
+      }
+    }
+  }
+}
+
 template<typename ModelMatType>
 template<typename VecType>
 size_t NaiveBayesClassifier<ModelMatType>::Classify(const VecType& point) const
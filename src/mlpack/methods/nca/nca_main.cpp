@@ -90,7 +90,11 @@ BINDING_LONG_DESC(
     PRINT_PARAM_STRING("max_step") + " (which both refer to the line search "
     "routine).  For more details on the L-BFGS optimizer, consult either the "
     "mlpack L-BFGS documentation (in lbfgs.hpp) or the vast set of published "
-    "literature on L-BFGS."
+    "literature on L-BFGS.  With L-BFGS, the objective can also be "
+    "approximated by only considering the nearest neighbors of each point; "
+    "the number of neighbors is specified with " +
+    PRINT_PARAM_STRING("num_neighbors") + ", and this is much faster on large "
+    "datasets."
     "\n\n"
     "By default, the SGD optimizer is used.");
 
@@ -135,6 +139,10 @@ PARAM_DOUBLE_IN("min_step", "Minimum step of line search for L-BFGS.", "m",
 PARAM_DOUBLE_IN("max_step", "Maximum step of line search for L-BFGS.", "M",
     1e20);
 
+PARAM_INT_IN("num_neighbors", "If positive, the L-BFGS objective only "
+    "considers this many nearest neighbors (in the learned space) of each "
+    "point; 0 uses all points.", "k", 0);
+
 PARAM_INT_IN("seed", "Random seed.  If 0, 'std::time(NULL)' is used.", "s", 0);
 
 using namespace mlpack;
@@ -167,6 +175,7 @@ static void mlpackMain()
     ReportIgnoredParam("min_step", "L-BFGS optimizer is not being used");
     ReportIgnoredParam("max_step", "L-BFGS optimizer is not being used");
     ReportIgnoredParam("batch_size", "L-BFGS optimizer is not being used");
+    ReportIgnoredParam("num_neighbors", "L-BFGS optimizer is not being used");
   }
   else if (optimizerType == "lbfgs")
   {
@@ -188,6 +197,10 @@ static void mlpackMain()
   const double maxStep = IO::GetParam<double>("max_step");
   const size_t batchSize = (size_t) IO::GetParam<int>("batch_size");
 
+  RequireParamValue<int>("num_neighbors", [](int x) { return x >= 0; }, true,
+      "number of neighbors must be non-negative");
+  const size_t numNeighbors = (size_t) IO::GetParam<int>("num_neighbors");
+
   // Load data.
   arma::mat data = std::move(IO::GetParam<arma::mat>("input"));
 
@@ -260,6 +273,7 @@ static void mlpackMain()
     nca.Optimizer().MaxLineSearchTrials() = maxLineSearchTrials;
     nca.Optimizer().MinStep() = minStep;
     nca.Optimizer().MaxStep() = maxStep;
+    nca.ErrorFunction().NumNeighbors() = numNeighbors;
 
     nca.LearnDistance(distance);
   }
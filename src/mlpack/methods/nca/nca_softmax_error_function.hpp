@@ -17,6 +17,7 @@
 #include <mlpack/core/metrics/lmetric.hpp>
 #include <mlpack/core/math/make_alias.hpp>
 #include <mlpack/core/math/shuffle_data.hpp>
+#include <mlpack/methods/neighbor_search/neighbor_search.hpp>
 
 namespace mlpack {
 namespace nca {
@@ -40,6 +41,17 @@ namespace nca {
  * optimizers use, overloads of Evaluate() and Gradient() are given which only
  * operate on one point in the dataset.  This is useful for optimizers like
  * stochastic gradient descent (see mlpack::optimization::SGD).
+ *
+ * The non-separable Evaluate() and Gradient() are parallelized with OpenMP;
+ * the gradient is assembled block-by-block with matrix products instead of one
+ * outer product per pair of points.  Since the exact objective still touches
+ * every pair of points, a truncated approximation is also available: if
+ * NumNeighbors() is set to a positive value k, then p_ij is only computed for
+ * the k nearest neighbors (in the stretched space) of each point, and all
+ * other p_ij are taken to be 0.  Distant points contribute almost nothing to
+ * the softmax, so this is a good approximation that reduces the cost of each
+ * non-separable evaluation from O(n^2) to roughly O(n k log n).  The truncation
+ * is not used by the separable overloads.
  */
 template<typename MetricType = metric::SquaredEuclideanDistance>
 class SoftmaxErrorFunction
@@ -131,6 +143,20 @@ class SoftmaxErrorFunction
    */
   size_t NumFunctions() const { return dataset.n_cols; }
 
+  //! Get the number of neighbors used by the non-separable objective (0 means
+  //! all points are used).
+  size_t NumNeighbors() const { return numNeighbors; }
+  //! Modify the number of neighbors used by the non-separable objective (0
+  //! means all points are used).
+  size_t& NumNeighbors() { return numNeighbors; }
+
+  //! Get the number of points whose gradient contributions are computed
+  //! together in the non-separable Gradient().
+  size_t BlockSize() const { return blockSize; }
+  //! Modify the number of points whose gradient contributions are computed
+  //! together in the non-separable Gradient().
+  size_t& BlockSize() { return blockSize; }
+
  private:
   //! The dataset.  This is an alias until Shuffle() is called.
   arma::mat dataset;
@@ -151,8 +177,21 @@ class SoftmaxErrorFunction
   //! Evaluate() and Gradient().
   arma::vec denominators;
 
+  //! Number of nearest neighbors to use for the truncated objective.
+  size_t numNeighbors;
+  //! Number of points to handle at once in the non-separable Gradient().
+  size_t blockSize;
+  //! Nearest neighbors of each point in the stretched dataset, if the
+  //! truncated objective is used.
+  arma::Mat<size_t> neighbors;
+  //! exp(-d(A x_i, A x_k)) for each neighbor k of each point i, if the
+  //! truncated objective is used.
+  arma::mat neighborEvals;
+
   //! False if nothing has ever been precalculated (only at construction time).
   bool precalculated;
+  //! The number of neighbors used for the last precalculation.
+  size_t precalculatedNeighbors;
 
   /**
    * Precalculate the denominators and numerators that will make up the p_ij,
@@ -163,11 +202,17 @@ class SoftmaxErrorFunction
    * This will update last_coordinates_ and stretched_dataset_, and also
    * calculate the p_i and denominators_ which are used in the calculation of
    * p_i or p_ij.  The calculation will be O((n * (n + 1)) / 2), which is not
-   * great.
+   * great, unless the truncated objective is used (see NumNeighbors()).
    *
    * @param coordinates Coordinates matrix to use for precalculation.
    */
   void Precalculate(const arma::mat& coordinates);
+
+  //! Returns true if the truncated objective should be used.
+  bool Truncated() const
+  {
+    return (numNeighbors > 0) && (numNeighbors + 1 < dataset.n_cols);
+  }
 };
 
 } // namespace nca
@@ -29,7 +29,10 @@ SoftmaxErrorFunction<MetricType>::SoftmaxErrorFunction(
     dataset(math::MakeAlias(const_cast<arma::mat&>(dataset), false)),
     labels(math::MakeAlias(const_cast<arma::Row<size_t>&>(labels), false)),
     metric(metric),
-    precalculated(false)
+    numNeighbors(0),
+    blockSize(64),
+    precalculated(false),
+    precalculatedNeighbors(0)
 { /* nothing to do */ }
 
 //! Shuffle the dataset.
@@ -46,6 +49,9 @@ void SoftmaxErrorFunction<MetricType>::Shuffle()
 
   dataset = std::move(newDataset);
   labels = std::move(newLabels);
+
+  // The precalculated values refer to the old ordering of the points.
+  precalculated = false;
 }
 
 //! The non-separable implementation, which uses Precalculate() to save time.
@@ -68,18 +74,20 @@ double SoftmaxErrorFunction<MetricType>::Evaluate(const arma::mat& coordinates,
 {
   // Unfortunately each evaluation will take O(N) time because it requires a
   // scan over all points in the dataset.  Our objective is to compute p_i.
-  double denominator = 0;
-  double numerator = 0;
   double result = 0;
 
   // It's quicker to do this now than one point at a time later.
   stretchedDataset = coordinates * dataset;
   for (size_t i = begin; i < begin + batchSize; ++i)
   {
-    for (size_t k = 0; k < dataset.n_cols; ++k)
+    double denominator = 0;
+    double numerator = 0;
+
+    #pragma omp parallel for reduction(+:numerator, denominator)
+    for (omp_size_t k = 0; k < (omp_size_t) dataset.n_cols; ++k)
     {
       // Don't consider the case where the points are the same.
-      if (k == i)
+      if ((size_t) k == i)
         continue;
 
       // We want to evaluate exp(-D(A x_i, A x_k)).
@@ -119,35 +127,90 @@ void SoftmaxErrorFunction<MetricType>::Gradient(const arma::mat& coordinates,
   //   sum_i (p_i sum_k (p_ik x_ik x_ik^T) -
   //       sum_{j in class of i} (p_ij x_ij x_ij^T)
   // We can algebraically manipulate the whole thing to produce a more
-  // memory-friendly way to calculate this.  Looping over each i and k (again
-  // O((n * (n + 1)) / 2) as with the last step, we can add the following to the
-  // sum:
+  // memory-friendly way to calculate this.  For each pair of points i and k,
+  // the sum picks up w_ik x_ik x_ik^T, where
+  //
+  //   w_ik = (p_i - [i and k in the same class]) p_ik +
+  //          (p_k - [i and k in the same class]) p_ki.
   //
-  //   if class of i is the same as the class of k, add
-  //     (((p_i - (1 / p_i)) p_ik) + ((p_k - (1 / p_k)) p_ki)) x_ik x_ik^T
-  //   otherwise, add
-  //     (p_i p_ik + p_k p_ki) x_ik x_ik^T
+  // Since W is symmetric, the sum over all pairs is X (D - W) X^T, where D is
+  // the diagonal matrix holding the row sums of W.  That lets a block of points
+  // be handled with two matrix products instead of one outer product per pair.
+  // x_ik is invariant to translation, so the dataset is centered first to keep
+  // the two products from cancelling badly.
+  const size_t n = dataset.n_cols;
+  const arma::mat centered = dataset.each_col() - arma::mean(dataset, 1);
+
   arma::mat sum;
-  sum.zeros(stretchedDataset.n_rows, stretchedDataset.n_rows);
-  for (size_t i = 0; i < stretchedDataset.n_cols; ++i)
+  sum.zeros(dataset.n_rows, dataset.n_rows);
+  if (Truncated())
   {
-    for (size_t k = (i + 1); k < stretchedDataset.n_cols; ++k)
+    // Only the neighbors of each point contribute, so W is sparse and not
+    // symmetric; in that case it is cheapest to sum the outer products of each
+    // point with its neighbors directly.
+    #pragma omp parallel
     {
-      // Calculate p_ik and p_ki first.
-      double eval = exp(-metric.Evaluate(stretchedDataset.unsafe_col(i),
-                                         stretchedDataset.unsafe_col(k)));
-      double p_ik = 0, p_ki = 0;
-      p_ik = eval / denominators(i);
-      p_ki = eval / denominators(k);
+      arma::mat localSum(dataset.n_rows, dataset.n_rows, arma::fill::zeros);
+      arma::mat diffs(dataset.n_rows, neighbors.n_rows);
+      arma::rowvec weights(neighbors.n_rows);
 
-      // Subtract x_i from x_k.  We are not using stretched points here.
-      arma::vec x_ik = dataset.col(i) - dataset.col(k);
-      arma::mat secondTerm = (x_ik * trans(x_ik));
+      #pragma omp for schedule(dynamic)
+      for (omp_size_t i = 0; i < (omp_size_t) n; ++i)
+      {
+        for (size_t j = 0; j < neighbors.n_rows; ++j)
+        {
+          const size_t k = neighbors(j, i);
+          const double same = (labels[i] == labels[k]) ? 1.0 : 0.0;
+          weights[j] = (p[i] - same) * neighborEvals(j, i) / denominators[i];
+          diffs.col(j) = dataset.col(i) - dataset.col(k);
+        }
+
+        localSum += (diffs.each_row() % weights) * trans(diffs);
+      }
 
-      if (labels[i] == labels[k])
-        sum += ((p[i] - 1) * p_ik + (p[k] - 1) * p_ki) * secondTerm;
-      else
-        sum += (p[i] * p_ik + p[k] * p_ki) * secondTerm;
+      #pragma omp critical
+      sum += localSum;
+    }
+  }
+  else
+  {
+    const size_t numBlocks = (n + blockSize - 1) / blockSize;
+
+    #pragma omp parallel
+    {
+      arma::mat localSum(dataset.n_rows, dataset.n_rows, arma::fill::zeros);
+      arma::mat weights;
+
+      #pragma omp for schedule(dynamic)
+      for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+      {
+        const size_t first = b * blockSize;
+        const size_t last = std::min(first + blockSize, n) - 1;
+
+        // Column j of the weights holds w_ik for point i = first + j.
+        weights.zeros(n, last - first + 1);
+        for (size_t i = first; i <= last; ++i)
+        {
+          for (size_t k = 0; k < n; ++k)
+          {
+            if (k == i)
+              continue;
+
+            const double eval = std::exp(-metric.Evaluate(
+                stretchedDataset.unsafe_col(i), stretchedDataset.unsafe_col(k)));
+            const double same = (labels[i] == labels[k]) ? 1.0 : 0.0;
+            weights(k, i - first) = (p[i] - same) * eval / denominators(i) +
+                (p[k] - same) * eval / denominators(k);
+          }
+        }
+
+        const arma::mat block = centered.cols(first, last);
+        localSum += (block.each_row() % arma::sum(weights, 0)) * trans(block) -
+            block * trans(centered * weights);
+      }
+
+      #pragma omp critical
+      sum += localSum;
     }
   }
 
@@ -165,10 +228,10 @@ void SoftmaxErrorFunction<MetricType>::Gradient(const arma::mat& coordinates,
 {
   // The gradient involves two matrix terms which are eventually combined into
   // one.
-  GradType firstTerm, secondTerm;
-  // We will need to calculate p_i before this evaluation is done, so
-  // these two variables will hold the information necessary for that.
-  double numerator, denominator;
+  arma::mat firstTerm, secondTerm;
+  // exp(-D(A x_i, A x_k)) for every k, and the same only for the k in the
+  // class of i.  The sums of these are the denominator and numerator of p_i.
+  arma::rowvec evals(dataset.n_cols), sameEvals(dataset.n_cols);
 
   gradient.zeros(coordinates.n_rows, coordinates.n_rows);
 
@@ -176,41 +239,26 @@ void SoftmaxErrorFunction<MetricType>::Gradient(const arma::mat& coordinates,
   stretchedDataset = coordinates * dataset;
   for (size_t i = begin; i < begin + batchSize; ++i)
   {
-    numerator = 0;
-    denominator = 0;
-
-    firstTerm.zeros(coordinates.n_rows, coordinates.n_cols);
-    secondTerm.zeros(coordinates.n_rows, coordinates.n_cols);
-
-    for (size_t k = 0; k < dataset.n_cols; ++k)
+    #pragma omp parallel for
+    for (omp_size_t k = 0; k < (omp_size_t) dataset.n_cols; ++k)
     {
       // Don't consider the case where the points are the same.
-      if (i == k)
-        continue;
-
-      // Calculate the numerator of p_ik.
-      double eval = exp(-metric.Evaluate(stretchedDataset.unsafe_col(i),
-                                         stretchedDataset.unsafe_col(k)));
-
-      // If the points are in the same class, we must add to the second term of
-      // the gradient as well as the numerator of p_i.  We will divide by the
-      // denominator of p_ik later.  For x_ik we are not using stretched points.
-      GradType x_ik = dataset.col(i) - dataset.col(k);
-      if (labels[i] == labels[k])
+      if ((size_t) k == i)
       {
-        numerator += eval;
-        secondTerm += eval * x_ik * trans(x_ik);
+        evals[k] = 0.0;
+        sameEvals[k] = 0.0;
+        continue;
       }
 
-      // We always have to add to the denominator of p_i
-      // and the first term of the gradient computation.
-      // We will divide by the denominator of p_ik later.
-      denominator += eval;
-      firstTerm += eval * x_ik * trans(x_ik);
+      evals[k] = std::exp(-metric.Evaluate(stretchedDataset.unsafe_col(i),
+                                           stretchedDataset.unsafe_col(k)));
+      sameEvals[k] = (labels[i] == labels[k]) ? evals[k] : 0.0;
     }
 
+    const double numerator = arma::accu(sameEvals);
+    const double denominator = arma::accu(evals);
+
     // Calculate p_i.
-    double p = 0;
     if (denominator == 0)
     {
       Log::Warn << "Denominator of p_" << i << " is 0!" << std::endl;
@@ -218,12 +266,14 @@ void SoftmaxErrorFunction<MetricType>::Gradient(const arma::mat& coordinates,
       // no gradient contribution from this point.
       continue;
     }
-    else
-    {
-      p = numerator / denominator;
-      firstTerm /= denominator;
-      secondTerm /= denominator;
-    }
+    const double p = numerator / denominator;
+
+    // The first term is sum_k p_ik x_ik x_ik^T and the second term is the same
+    // sum, but only over the points in the class of i.  For x_ik we are not
+    // using stretched points.
+    const arma::mat diffs = dataset.each_col() - dataset.col(i);
+    firstTerm = (diffs.each_row() % evals) * trans(diffs) / denominator;
+    secondTerm = (diffs.each_row() % sameEvals) * trans(diffs) / denominator;
 
     // Now multiply the first term by p_i, and add the two together and multiply
     // all by 2 * A.  We negate it though, because our optimizer is a minimizer.
@@ -248,7 +298,7 @@ void SoftmaxErrorFunction<MetricType>::Precalculate(
     lastCoordinates.set_size(coordinates.n_rows, coordinates.n_cols);
   }
   else if ((accu(coordinates == lastCoordinates) == coordinates.n_elem) &&
-      precalculated)
+      precalculated && (precalculatedNeighbors == numNeighbors))
   {
     return; // No need to calculate; we already have this stuff saved.
   }
@@ -265,23 +315,64 @@ void SoftmaxErrorFunction<MetricType>::Precalculate(
   // order of O((n * (n + 1)) / 2), which really isn't all that great.
   p.zeros(stretchedDataset.n_cols);
   denominators.zeros(stretchedDataset.n_cols);
-  for (size_t i = 0; i < stretchedDataset.n_cols; ++i)
+  if (Truncated())
+  {
+    // Only the nearest neighbors of each point in the stretched space are
+    // considered; all the other p_ij are taken to be 0.
+    neighbor::NeighborSearch<neighbor::NearestNeighborSort, MetricType> knn(
+        stretchedDataset, neighbor::DUAL_TREE_MODE, 0.0, metric);
+    arma::mat distances;
+    knn.Search(numNeighbors, neighbors, distances);
+    neighborEvals = arma::exp(-distances);
+
+    #pragma omp parallel for
+    for (omp_size_t i = 0; i < (omp_size_t) stretchedDataset.n_cols; ++i)
+    {
+      for (size_t j = 0; j < neighbors.n_rows; ++j)
+      {
+        denominators[i] += neighborEvals(j, i);
+        if (labels[i] == labels[neighbors(j, i)])
+          p[i] += neighborEvals(j, i);
+      }
+    }
+  }
+  else
   {
-    for (size_t j = (i + 1); j < stretchedDataset.n_cols; ++j)
+    neighbors.reset();
+    neighborEvals.reset();
+
+    #pragma omp parallel
     {
-      // Evaluate exp(-d(x_i, x_j)).
-      double eval = exp(-metric.Evaluate(stretchedDataset.unsafe_col(i),
-                                         stretchedDataset.unsafe_col(j)));
+      arma::vec localP(stretchedDataset.n_cols, arma::fill::zeros);
+      arma::vec localDenominators(stretchedDataset.n_cols, arma::fill::zeros);
 
-      // Add this to the denominators of both p_i and p_j: K(i, j) = K(j, i).
-      denominators[i] += eval;
-      denominators[j] += eval;
+      #pragma omp for schedule(dynamic)
+      for (omp_size_t i = 0; i < (omp_size_t) stretchedDataset.n_cols; ++i)
+      {
+        for (size_t j = (i + 1); j < stretchedDataset.n_cols; ++j)
+        {
+          // Evaluate exp(-d(x_i, x_j)).
+          double eval = exp(-metric.Evaluate(stretchedDataset.unsafe_col(i),
+                                             stretchedDataset.unsafe_col(j)));
+
+          // Add this to the denominators of both p_i and p_j: K(i, j) =
+          // K(j, i).
+          localDenominators[i] += eval;
+          localDenominators[j] += eval;
+
+          // If i and j are the same class, add to numerator of both.
+          if (labels[i] == labels[j])
+          {
+            localP[i] += eval;
+            localP[j] += eval;
+          }
+        }
+      }
 
-      // If i and j are the same class, add to numerator of both.
-      if (labels[i] == labels[j])
+      #pragma omp critical
       {
-        p[i] += eval;
-        p[j] += eval;
+        p += localP;
+        denominators += localDenominators;
       }
     }
   }
@@ -304,6 +395,7 @@ void SoftmaxErrorFunction<MetricType>::Precalculate(
 
   // We've done a precalculation.  Mark it as done.
   precalculated = true;
+  precalculatedNeighbors = numNeighbors;
 }
 
 } // namespace nca
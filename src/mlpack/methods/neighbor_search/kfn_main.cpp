@@ -103,6 +103,9 @@ PARAM_INT_IN("leaf_size", "Leaf size for tree building (used for kd-trees, "
     "Hilbert R trees, R+ trees, R++ trees, and octrees).", "l", 20);
 PARAM_FLAG("random_basis", "Before tree-building, project the data onto a "
     "random orthogonal basis.", "R");
+PARAM_FLAG("single_precision", "Keep the reference set and the tree in single "
+    "precision, which halves the memory of the model; only the 'kd', 'cover', "
+    "'r-star' and 'ball' trees support it.", "");
 PARAM_INT_IN("seed", "Random seed (if 0, std::time(NULL) is used).", "s", 0);
 
 // Search settings.
@@ -114,6 +117,11 @@ PARAM_DOUBLE_IN("percentage", "If specified, will do approximate furthest "
     "neighbor search. Must be in the range (0,1] (decimal form). Resultant "
     "neighbors will be at least (p*100) % of the distance as the true furthest "
     "neighbor.", "p", 1);
+PARAM_FLAG("auto", "If set, choose the tree type, leaf size and algorithm by "
+    "timing a few candidates on a sample of the reference and query sets; the "
+    "choice is saved with the model.", "");
+PARAM_DOUBLE_IN("auto_budget", "Time budget (in seconds) for choosing the tree "
+    "type, leaf size and algorithm automatically.", "", 10.0);
 
 static void mlpackMain()
 {
@@ -127,6 +135,14 @@ static void mlpackMain()
 
   ReportIgnoredParam({{ "input_model", true }}, "tree_type");
   ReportIgnoredParam({{ "input_model", true }}, "random_basis");
+  ReportIgnoredParam({{ "input_model", true }}, "single_precision");
+  ReportIgnoredParam({{ "input_model", true }}, "auto");
+  ReportIgnoredParam({{ "auto", false }}, "auto_budget");
+  ReportIgnoredParam({{ "auto", true }}, "tree_type");
+  ReportIgnoredParam({{ "auto", true }}, "leaf_size");
+  ReportIgnoredParam({{ "auto", true }}, "algorithm");
+  RequireParamValue<double>("auto_budget", [](double x) { return x >= 0.0; },
+      true, "time budget must be nonnegative");
 
   // Notify the user of parameters that will be only be considered for query
   // tree.
@@ -202,6 +218,7 @@ static void mlpackMain()
         "ub", "oct" }, true, "unknown tree type");
     const string treeType = IO::GetParam<string>("tree_type");
     const bool randomBasis = IO::HasParam("random_basis");
+    const bool singlePrecision = IO::HasParam("single_precision");
 
     kfn = new KFNModel();
 
@@ -235,16 +252,40 @@ static void mlpackMain()
     else if (treeType == "oct")
       tree = KFNModel::OCTREE;
 
+    if (singlePrecision && !IO::HasParam("auto") &&
+        !KFNModel::SupportsSinglePrecision(tree))
+    {
+      Log::Fatal << PRINT_PARAM_STRING("single_precision") << " is only "
+          << "supported with the 'kd', 'cover', 'r-star' and 'ball' trees, not "
+          << "with '" << treeType << "'." << endl;
+    }
+
     kfn->TreeType() = tree;
     kfn->RandomBasis() = randomBasis;
+    kfn->SinglePrecision() = singlePrecision;
 
     Log::Info << "Using reference data from "
         << IO::GetPrintableParam<arma::mat>("reference") << "." << endl;
 
     arma::mat referenceSet = std::move(IO::GetParam<arma::mat>("reference"));
 
-    kfn->BuildModel(std::move(referenceSet), size_t(lsInt), searchMode,
-        epsilon);
+    if (IO::HasParam("auto"))
+    {
+      // The candidates are timed on the query set that will be searched, if
+      // there is one.
+      arma::mat noQuerySet;
+      const arma::mat& querySet = IO::HasParam("query") ?
+          IO::GetParam<arma::mat>("query") : noQuerySet;
+      const int k = IO::HasParam("k") ? IO::GetParam<int>("k") : 1;
+      kfn->AutoBuildModel(std::move(referenceSet), querySet,
+          (size_t) std::max(k, 1), epsilon,
+          IO::GetParam<double>("auto_budget"));
+    }
+    else
+    {
+      kfn->BuildModel(std::move(referenceSet), size_t(lsInt), searchMode,
+          epsilon);
+    }
   }
   else
   {
@@ -267,6 +308,11 @@ static void mlpackMain()
         << " dataset)." << endl;
   }
 
+  // Set the number of threads to use for search.
+  RequireParamValue<int>("threads", [](int x) { return x >= 0; }, true,
+      "number of threads must be nonnegative");
+  kfn->NumThreads() = (size_t) IO::GetParam<int>("threads");
+
   // Perform search, if desired.
   if (IO::HasParam("k"))
   {
@@ -115,6 +115,9 @@ PARAM_DOUBLE_IN("rho", "Balance threshold (only valid for spill trees).", "b",
 
 PARAM_FLAG("random_basis", "Before tree-building, project the data onto a "
     "random orthogonal basis.", "R");
+PARAM_FLAG("single_precision", "Keep the reference set and the tree in single "
+    "precision, which halves the memory of the model; only the 'kd', 'cover', "
+    "'r-star' and 'ball' trees support it.", "");
 PARAM_INT_IN("seed", "Random seed (if 0, std::time(NULL) is used).", "s", 0);
 
 // Search settings.
@@ -122,6 +125,11 @@ PARAM_STRING_IN("algorithm", "Type of neighbor search: 'naive', 'single_tree', "
     "'dual_tree', 'greedy'.", "a", "dual_tree");
 PARAM_DOUBLE_IN("epsilon", "If specified, will do approximate nearest neighbor "
     "search with given relative error.", "e", 0);
+PARAM_FLAG("auto", "If set, choose the tree type, leaf size and algorithm by "
+    "timing a few candidates on a sample of the reference and query sets; the "
+    "choice is saved with the model.", "");
+PARAM_DOUBLE_IN("auto_budget", "Time budget (in seconds) for choosing the tree "
+    "type, leaf size and algorithm automatically.", "", 10.0);
 
 static void mlpackMain()
 {
@@ -135,6 +143,14 @@ static void mlpackMain()
 
   ReportIgnoredParam({{ "input_model", true }}, "tree_type");
   ReportIgnoredParam({{ "input_model", true }}, "random_basis");
+  ReportIgnoredParam({{ "input_model", true }}, "single_precision");
+  ReportIgnoredParam({{ "input_model", true }}, "auto");
+  ReportIgnoredParam({{ "auto", false }}, "auto_budget");
+  ReportIgnoredParam({{ "auto", true }}, "tree_type");
+  ReportIgnoredParam({{ "auto", true }}, "leaf_size");
+  ReportIgnoredParam({{ "auto", true }}, "algorithm");
+  RequireParamValue<double>("auto_budget", [](double x) { return x >= 0.0; },
+      true, "time budget must be nonnegative");
   ReportIgnoredParam({{ "input_model", true }}, "tau");
   ReportIgnoredParam({{ "input_model", true }}, "rho");
   if (IO::HasParam("input_model") && IO::HasParam("leaf_size"))
@@ -211,6 +227,7 @@ static void mlpackMain()
     // Get all the parameters.
     const string treeType = IO::GetParam<string>("tree_type");
     const bool randomBasis = IO::HasParam("random_basis");
+    const bool singlePrecision = IO::HasParam("single_precision");
 
     KNNModel::TreeTypes tree = KNNModel::KD_TREE;
     RequireParamInSet<string>("tree_type", { "kd", "cover", "r", "r-star",
@@ -250,8 +267,17 @@ static void mlpackMain()
     else if (treeType == "oct")
       tree = KNNModel::OCTREE;
 
+    if (singlePrecision && !IO::HasParam("auto") &&
+        !KNNModel::SupportsSinglePrecision(tree))
+    {
+      Log::Fatal << PRINT_PARAM_STRING("single_precision") << " is only "
+          << "supported with the 'kd', 'cover', 'r-star' and 'ball' trees, not "
+          << "with '" << treeType << "'." << endl;
+    }
+
     knn->TreeType() = tree;
     knn->RandomBasis() = randomBasis;
+    knn->SinglePrecision() = singlePrecision;
     knn->LeafSize() = size_t(lsInt);
     knn->Tau() = tau;
     knn->Rho() = rho;
@@ -261,8 +287,23 @@ static void mlpackMain()
 
     arma::mat referenceSet = std::move(IO::GetParam<arma::mat>("reference"));
 
-    knn->BuildModel(std::move(referenceSet), size_t(lsInt), searchMode,
-        epsilon);
+    if (IO::HasParam("auto"))
+    {
+      // The candidates are timed on the query set that will be searched, if
+      // there is one.
+      arma::mat noQuerySet;
+      const arma::mat& querySet = IO::HasParam("query") ?
+          IO::GetParam<arma::mat>("query") : noQuerySet;
+      const int k = IO::HasParam("k") ? IO::GetParam<int>("k") : 1;
+      knn->AutoBuildModel(std::move(referenceSet), querySet,
+          (size_t) std::max(k, 1), epsilon,
+          IO::GetParam<double>("auto_budget"));
+    }
+    else
+    {
+      knn->BuildModel(std::move(referenceSet), size_t(lsInt), searchMode,
+          epsilon);
+    }
   }
   else
   {
@@ -285,6 +326,11 @@ static void mlpackMain()
         << " dataset)." << endl;
   }
 
+  // Set the number of threads to use for search.
+  RequireParamValue<int>("threads", [](int x) { return x >= 0; }, true,
+      "number of threads must be nonnegative");
+  knn->NumThreads() = (size_t) IO::GetParam<int>("threads");
+
   // Perform search, if desired.
   if (IO::HasParam("k"))
   {
@@ -0,0 +1,47 @@
+/**
+ * @file methods/neighbor_search/neighbor_search.cpp
+ *
+ * Explicit instantiations of the most common NeighborSearch types and of
+ * NSModel, which are declared extern in typedef.hpp and ns_model.hpp, so that
+ * the programs that use them do not have to compile them.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "ns_model.hpp"
+
+namespace mlpack {
+namespace neighbor {
+
+template class NeighborSearch<NearestNeighborSort, metric::EuclideanDistance,
+    arma::mat, tree::KDTree>;
+template class NeighborSearch<NearestNeighborSort, metric::EuclideanDistance,
+    arma::mat, tree::BallTree>;
+template class NeighborSearch<NearestNeighborSort, metric::EuclideanDistance,
+    arma::mat, tree::StandardCoverTree>;
+template class NeighborSearch<NearestNeighborSort, metric::EuclideanDistance,
+    arma::fmat, tree::KDTree>;
+template class NeighborSearch<NearestNeighborSort, metric::EuclideanDistance,
+    arma::fmat, tree::BallTree>;
+template class NeighborSearch<NearestNeighborSort, metric::EuclideanDistance,
+    arma::fmat, tree::StandardCoverTree>;
+template class NeighborSearch<FurthestNeighborSort, metric::EuclideanDistance,
+    arma::mat, tree::KDTree>;
+template class NeighborSearch<FurthestNeighborSort, metric::EuclideanDistance,
+    arma::mat, tree::BallTree>;
+template class NeighborSearch<FurthestNeighborSort, metric::EuclideanDistance,
+    arma::mat, tree::StandardCoverTree>;
+template class NeighborSearch<FurthestNeighborSort, metric::EuclideanDistance,
+    arma::fmat, tree::KDTree>;
+template class NeighborSearch<FurthestNeighborSort, metric::EuclideanDistance,
+    arma::fmat, tree::BallTree>;
+template class NeighborSearch<FurthestNeighborSort, metric::EuclideanDistance,
+    arma::fmat, tree::StandardCoverTree>;
+
+template class NSModel<NearestNeighborSort>;
+template class NSModel<FurthestNeighborSort>;
+
+} // namespace neighbor
+} // namespace mlpack
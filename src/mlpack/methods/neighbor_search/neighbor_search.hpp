@@ -14,6 +14,7 @@
 #define MLPACK_METHODS_NEIGHBOR_SEARCH_NEIGHBOR_SEARCH_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/util/sfinae_utility.hpp>
 #include <vector>
 #include <string>
 
@@ -22,6 +23,8 @@
 #include <mlpack/core/tree/binary_space_tree/binary_space_tree.hpp>
 
 #include "neighbor_search_stat.hpp"
+#include "neighbor_search_cache.hpp"
+#include "search_statistics.hpp"
 #include "sort_policies/nearest_neighbor_sort.hpp"
 #include "neighbor_search_rules.hpp"
 
@@ -74,17 +77,23 @@ template<typename SortPolicy = NearestNeighborSort,
                   typename TreeMatType> class TreeType = tree::KDTree,
          template<typename RuleType> class DualTreeTraversalType =
              TreeType<MetricType,
-                      NeighborSearchStat<SortPolicy>,
+                      NeighborSearchStat<SortPolicy,
+                          typename MatType::elem_type>,
                       MatType>::template DualTreeTraverser,
          template<typename RuleType> class SingleTreeTraversalType =
              TreeType<MetricType,
-                      NeighborSearchStat<SortPolicy>,
+                      NeighborSearchStat<SortPolicy,
+                          typename MatType::elem_type>,
                       MatType>::template SingleTreeTraverser>
 class NeighborSearch
 {
  public:
-  //! Convenience typedef.
-  typedef TreeType<MetricType, NeighborSearchStat<SortPolicy>, MatType> Tree;
+  //! The type of the elements of the data.
+  typedef typename MatType::elem_type ElemType;
+  //! Convenience typedef.  The bounds of the nodes are kept with the element
+  //! type of the data.
+  typedef TreeType<MetricType, NeighborSearchStat<SortPolicy, ElemType>,
+      MatType> Tree;
 
   /**
    * Initialize the NeighborSearch object, passing a reference dataset (this is
@@ -206,6 +215,52 @@ class NeighborSearch
    */
   void Train(Tree referenceTree);
 
+  /**
+   * Add the given points to the reference set.  The new points get the next
+   * indices of the reference set (starting at ReferenceSet().n_cols), so the
+   * indices of the existing points don't change.  For trees that support point
+   * insertion (the RectangleTree types and the cover tree), the points are
+   * inserted into the existing tree, and statistics are reset lazily at the
+   * next search; otherwise (and in naive mode) the reference tree is rebuilt
+   * with the default tree parameters.
+   *
+   * Once more than RebuildRatio() times the number of reference points have
+   * been inserted or removed since the tree was built, it is rebuilt from
+   * scratch so that its quality does not degrade.
+   *
+   * @param points Points to add to the reference set.
+   */
+  void Insert(const MatType& points);
+
+  /**
+   * Remove the reference point with the given index, so that later searches do
+   * not return it.  The point keeps its column in the reference set, so the
+   * indices of the other points don't change (and monochromatic search still
+   * returns a column for it, which should be ignored).  This is only supported
+   * for trees that support point deletion (the RectangleTree types and the
+   * cover tree); for other trees a std::invalid_argument is thrown.  A cover
+   * tree reinserts the points below the removed one, so removing a point near
+   * its root costs about as much as rebuilding it (see
+   * CoverTree::DeletePoint()).
+   *
+   * @param index Index of the reference point to remove.
+   * @return false if the point is not held by the tree (for instance because
+   *     it was already removed, or because it is the last point of a cover
+   *     tree).
+   */
+  bool Remove(const size_t index);
+
+  /**
+   * Update the reference tree after the coordinates of the reference points
+   * were modified in place, through ReferenceTree().Dataset().  For trees that
+   * support it (the BinarySpaceTree types), the bounds of the existing tree are
+   * recomputed with RefitBounds(), which is much cheaper than building a new
+   * tree; the results stay exact, but searches get slower as the points move
+   * away from where the tree was built, so it should be rebuilt with Train()
+   * from time to time.  Other trees are rebuilt.
+   */
+  void Refit();
+
   /**
    * For each point in the query set, compute the nearest neighbors and store
    * the output in the given matrices.  The matrices will be set to the size of
@@ -217,6 +272,10 @@ class NeighborSearch
    * worthwhile to set singleMode = false (either in the constructor or with
    * SingleMode()).
    *
+   * If the query cache is enabled (see Cache()), the results of query points
+   * that were searched for recently are taken from the cache, and only the
+   * other query points are searched for.
+   *
    * @param querySet Set of query points (can be just one point).
    * @param k Number of neighbors to search for.
    * @param neighbors Matrix storing lists of neighbors for each query point.
@@ -272,6 +331,78 @@ class NeighborSearch
               arma::Mat<size_t>& neighbors,
               arma::mat& distances);
 
+  /**
+   * For each point in the query set, compute the nearest neighbors, as with
+   * the other overload of Search(), but without modifying this object: the
+   * query cache is not used, and the statistics of the search are stored in
+   * the given object instead of Statistics().  This overload is reentrant, so
+   * several threads may search the same NeighborSearch object (and share one
+   * reference tree) at once, as long as no non-const method is called at the
+   * same time.
+   *
+   * The only exception is single-tree search with trees whose first point is
+   * the centroid and that have self-children (i.e. cover trees), which caches
+   * distances in the statistics of the reference tree; use dual-tree search
+   * to query such trees concurrently.
+   *
+   * @param querySet Set of query points (can be just one point).
+   * @param k Number of neighbors to search for.
+   * @param neighbors Matrix storing lists of neighbors for each query point.
+   * @param distances Matrix storing distances of neighbors for each query
+   *     point.
+   * @param searchStatistics Object to store the statistics of the search in.
+   * @param truncated If given, set to the indices of the query points whose
+   *     budget of base cases ran out (see MaxBaseCases()).
+   */
+  void Search(const MatType& querySet,
+              const size_t k,
+              arma::Mat<size_t>& neighbors,
+              arma::mat& distances,
+              SearchStatistics& searchStatistics,
+              std::vector<size_t>* truncated = NULL) const;
+
+  /**
+   * Given a pre-built query tree, search for the nearest neighbors of each
+   * point in the query tree without modifying this object, storing the
+   * statistics of the search in the given object.  The same restrictions as
+   * for the other reentrant overloads apply, and the query tree must not be
+   * shared with other searches (the bounds in its statistics are modified; see
+   * the non-const overload).
+   *
+   * @param queryTree Tree built on query points.
+   * @param k Number of neighbors to search for.
+   * @param neighbors Matrix storing lists of neighbors for each query point.
+   * @param distances Matrix storing distances of neighbors for each query
+   *      point.
+   * @param searchStatistics Object to store the statistics of the search in.
+   */
+  void Search(Tree& queryTree,
+              const size_t k,
+              arma::Mat<size_t>& neighbors,
+              arma::mat& distances,
+              SearchStatistics& searchStatistics) const;
+
+  /**
+   * Search for the nearest neighbors of every point in the reference set
+   * without modifying this object, storing the statistics of the search in the
+   * given object.  In dual-tree mode, the query tree is a copy of the
+   * reference tree, so that the reference tree is only read.  The same
+   * restrictions as for the other reentrant overloads apply.
+   *
+   * @param k Number of neighbors to search for.
+   * @param neighbors Matrix storing lists of neighbors for each query point.
+   * @param distances Matrix storing distances of neighbors for each query
+   *      point.
+   * @param searchStatistics Object to store the statistics of the search in.
+   * @param truncated If given, set to the indices of the query points whose
+   *     budget of base cases ran out (see MaxBaseCases()).
+   */
+  void Search(const size_t k,
+              arma::Mat<size_t>& neighbors,
+              arma::mat& distances,
+              SearchStatistics& searchStatistics,
+              std::vector<size_t>* truncated = NULL) const;
+
   /**
    * Calculate the average relative error (effective error) between the
    * distances calculated and the true distances provided.  The input matrices
@@ -311,6 +442,13 @@ class NeighborSearch
   //! Return the number of node combination scores during the last search.
   size_t Scores() const { return scores; }
 
+  //! Return the statistics of the traversals performed during the last search:
+  //! prunes by bound type, reference leaves reached, visited nodes, the maximum
+  //! recursion depth of the traversers, the time spent in base cases and in
+  //! scoring, and the time spent building the query tree and searching.  The
+  //! reentrant overloads of Search() fill a given SearchStatistics instead.
+  const SearchStatistics& Statistics() const { return statistics; }
+
   //! Access the search mode.
   NeighborSearchMode SearchMode() const { return searchMode; }
   //! Modify the search mode.
@@ -321,9 +459,64 @@ class NeighborSearch
   //! Modify the relative error to be considered in approximate search.
   double& Epsilon() { return epsilon; }
 
+  //! Get the number of threads used for search (0 means that OpenMP decides).
+  size_t NumThreads() const { return numThreads; }
+  //! Modify the number of threads used for search (0 means that OpenMP
+  //! decides).
+  size_t& NumThreads() { return numThreads; }
+
+  //! Get whether dual-tree search evaluates pairs of leaves as blocks (see
+  //! NeighborSearchRules::LeafBaseCases()).
+  bool BlockBaseCases() const { return blockBaseCases; }
+  //! Modify whether dual-tree search evaluates pairs of leaves as blocks.  This
+  //! is mostly useful for high-dimensional data, where computing the distances
+  //! between two leaves with one matrix multiplication is much faster.
+  bool& BlockBaseCases() { return blockBaseCases; }
+
+  //! Get the maximum number of base cases per query point in single-tree and
+  //! greedy search (0 means no limit).
+  size_t MaxBaseCases() const { return maxBaseCases; }
+  //! Modify the maximum number of base cases per query point in single-tree
+  //! and greedy search (0 means no limit).  This bounds the work done for each
+  //! query point: once a query point has computed that many distances, the
+  //! search stops for it and the best neighbors found so far are returned.
+  //! Such query points are listed by TruncatedQueries().
+  size_t& MaxBaseCases() { return maxBaseCases; }
+
+  //! Get the indices of the query points of the last search whose budget of
+  //! base cases ran out; their results are approximate.  Results taken from
+  //! the cache are never approximate, and truncated results aren't cached.
+  const std::vector<size_t>& TruncatedQueries() const
+  {
+    return truncatedQueries;
+  }
+
+  //! Get the fraction of the reference set that may be inserted or removed
+  //! before the tree is rebuilt.
+  double RebuildRatio() const { return rebuildRatio; }
+  //! Modify the fraction of the reference set that may be inserted or removed
+  //! before the tree is rebuilt.
+  double& RebuildRatio() { return rebuildRatio; }
+
+  //! Get the cache of recent query results.
+  const NeighborSearchCache<ElemType>& Cache() const { return cache; }
+  //! Modify the cache of recent query results.  It is disabled by default;
+  //! enable it with Cache().MaxSize(size).  The cache is cleared whenever the
+  //! reference set changes through Train(), Insert(), or Remove() (but not if
+  //! the reference tree is modified directly).
+  NeighborSearchCache<ElemType>& Cache() { return cache; }
+
   //! Access the reference dataset.
   const MatType& ReferenceSet() const { return *referenceSet; }
 
+  //! Get the mapping from the columns of ReferenceSet() to the original
+  //! indices of the reference points (empty if the tree does not rearrange the
+  //! dataset).
+  const std::vector<size_t>& OldFromNewReferences() const
+  {
+    return oldFromNewReferences;
+  }
+
   //! Access the reference tree.
   const Tree& ReferenceTree() const { return *referenceTree; }
   //! Modify the reference tree.
@@ -353,14 +546,212 @@ class NeighborSearch
   size_t baseCases;
   //! The total number of scores (applicable for non-naive search).
   size_t scores;
+  //! The statistics of the last search.
+  SearchStatistics statistics;
 
   //! If this is true, the reference tree bounds need to be reset on a call to
   //! Search() without a query set.
   bool treeNeedsReset;
 
+  //! The number of threads to use for search; 0 means the OpenMP default.
+  size_t numThreads;
+
+  //! If true, dual-tree search evaluates pairs of leaves as blocks.
+  bool blockBaseCases;
+
+  //! The maximum number of base cases per query point in single-tree and
+  //! greedy search (0 means no limit).
+  size_t maxBaseCases;
+
+  //! The query points of the last search whose budget ran out.
+  std::vector<size_t> truncatedQueries;
+
+  //! The cache of recent query results.
+  NeighborSearchCache<ElemType> cache;
+
+  //! The number of points inserted or removed since the tree was built.
+  size_t changes;
+  //! The fraction of the reference set that may change before a rebuild.
+  double rebuildRatio;
+
+  // SFINAE checks for trees that support point insertion and deletion.
+  HAS_MEM_FUNC(InsertPoint, HasInsertPoint);
+  HAS_MEM_FUNC(DeletePoint, HasDeletePoint);
+
+  //! Return the reference set in its original (unpermuted) order.
+  MatType OriginalReferenceSet() const;
+
+  //! Insert points into a tree that supports point insertion.
+  template<typename TreeT = Tree>
+  void InsertPoints(
+      const MatType& points,
+      const typename std::enable_if_t<HasInsertPoint<TreeT,
+          void(TreeT::*)(const size_t)>::value>* = 0);
+
+  //! Insert points by rebuilding a tree that doesn't support point insertion.
+  template<typename TreeT = Tree>
+  void InsertPoints(
+      const MatType& points,
+      const typename std::enable_if_t<!HasInsertPoint<TreeT,
+          void(TreeT::*)(const size_t)>::value>* = 0);
+
+  //! Remove a point from a tree that supports point deletion.
+  template<typename TreeT = Tree>
+  bool RemovePoint(
+      const size_t index,
+      const typename std::enable_if_t<HasDeletePoint<TreeT,
+          bool(TreeT::*)(const size_t)>::value>* = 0);
+
+  //! Points can't be removed from other trees.
+  template<typename TreeT = Tree>
+  bool RemovePoint(
+      const size_t index,
+      const typename std::enable_if_t<!HasDeletePoint<TreeT,
+          bool(TreeT::*)(const size_t)>::value>* = 0);
+
+  /**
+   * Rebuild a tree that supports point deletion from scratch, on the whole
+   * reference set, and remove the points that had been removed from the old
+   * tree.
+   */
+  template<typename TreeT = Tree>
+  void RebuildTree(
+      const typename std::enable_if_t<HasDeletePoint<TreeT,
+          bool(TreeT::*)(const size_t)>::value>* = 0);
+
+  //! Other trees are rebuilt by Insert() itself.
+  template<typename TreeT = Tree>
+  void RebuildTree(
+      const typename std::enable_if_t<!HasDeletePoint<TreeT,
+          bool(TreeT::*)(const size_t)>::value>* = 0) { }
+
+  // SFINAE check for trees whose bounds can be recomputed in place.
+  HAS_MEM_FUNC(RefitBounds, HasRefitBounds);
+
+  //! Recompute the bounds of a tree that supports it.
+  template<typename TreeT = Tree>
+  void RefitTree(
+      const typename std::enable_if_t<HasRefitBounds<TreeT,
+          void(TreeT::*)()>::value>* = 0);
+
+  //! Rebuild a tree whose bounds can't be recomputed in place.
+  template<typename TreeT = Tree>
+  void RefitTree(
+      const typename std::enable_if_t<!HasRefitBounds<TreeT,
+          void(TreeT::*)()>::value>* = 0);
+
+  //! Mark every point held by the given node and its descendants.
+  static void MarkPoints(const Tree& node, std::vector<bool>& held);
+
   //! The NSModel class should have access to internal members.
   template<typename SortPol>
   friend class TrainVisitor;
+
+  //! Return the number of threads that a search may use.
+  size_t SearchThreads() const;
+
+  //! Search for the neighbors of the given query points without using the
+  //! query cache, storing the statistics and the truncated query points of the
+  //! search in the given objects.
+  void UncachedSearch(const MatType& querySet,
+                      const size_t k,
+                      arma::Mat<size_t>& neighbors,
+                      arma::mat& distances,
+                      SearchStatistics& searchStatistics,
+                      std::vector<size_t>& truncated) const;
+
+  //! Search for the neighbors of the points of the given query tree, storing
+  //! the statistics of the search in the given object.
+  void QueryTreeSearch(Tree& queryTree,
+                       const size_t k,
+                       arma::Mat<size_t>& neighbors,
+                       arma::mat& distances,
+                       const bool sameSet,
+                       SearchStatistics& searchStatistics) const;
+
+  /**
+   * Search for the neighbors of every point in the reference set, storing the
+   * statistics and the truncated query points of the search in the given
+   * objects.  In dual-tree mode, the query tree is the reference tree itself
+   * (whose bounds must have been reset), or a copy of it if copyReferenceTree
+   * is true.
+   */
+  void MonochromaticSearch(const size_t k,
+                           arma::Mat<size_t>& neighbors,
+                           arma::mat& distances,
+                           SearchStatistics& searchStatistics,
+                           std::vector<size_t>& truncated,
+                           const bool copyReferenceTree) const;
+
+  //! Reset the bounds in the statistics of the given node and its
+  //! descendants.
+  static void ResetStatistics(Tree& node);
+
+  /**
+   * Perform a dual-tree search of the given query tree against the reference
+   * tree, storing the results (in the ordering of the query tree's dataset) in
+   * the given matrices.  If OpenMP is available and more than one thread may be
+   * used, the query tree is split into a frontier of disjoint subtrees which
+   * are traversed in parallel against the shared reference tree.  Each thread
+   * holds its own NeighborSearchRules object, and the per-thread candidate
+   * lists are merged once the traversal is finished.
+   *
+   * @param queryTree Tree built on query points.
+   * @param k Number of neighbors to search for.
+   * @param neighbors Matrix to store lists of neighbors for each query point.
+   * @param distances Matrix to store distances of neighbors for each query
+   *      point.
+   * @param sameSet Denotes whether or not the reference and query sets are the
+   *      same.
+   * @param searchStatistics Object to add the statistics of the search to.
+   */
+  void DualTreeSearch(Tree& queryTree,
+                      const size_t k,
+                      arma::Mat<size_t>& neighbors,
+                      arma::mat& distances,
+                      const bool sameSet,
+                      SearchStatistics& searchStatistics) const;
+
+  /**
+   * Perform a single-tree search for the points in the given query set, using
+   * the given number of threads.  The query set is split into contiguous
+   * blocks, and each block is searched with its own NeighborSearchRules
+   * object.  The given matrices must already be sized k x querySet.n_cols.
+   *
+   * @param querySet Set of query points.
+   * @param k Number of neighbors to search for.
+   * @param threads Number of threads to use.
+   * @param neighbors Matrix to store lists of neighbors for each query point.
+   * @param distances Matrix to store distances of neighbors for each query
+   *      point.
+   * @param searchStatistics Object to add the statistics of the search to.
+   * @param truncated The truncated query points are appended to this.
+   */
+  void SingleTreeSearch(const MatType& querySet,
+                        const size_t k,
+                        const size_t threads,
+                        arma::Mat<size_t>& neighbors,
+                        arma::mat& distances,
+                        SearchStatistics& searchStatistics,
+                        std::vector<size_t>& truncated) const;
+
+  /**
+   * Merge a set of per-thread results into a single set of results.  Each of
+   * the per-thread matrices must have k rows sorted from best to worst, as
+   * returned by NeighborSearchRules::GetResults().  Duplicate neighbors (which
+   * are possible if a query point was held by more than one query subtree) are
+   * only taken once.
+   *
+   * @param threadNeighbors Per-thread lists of neighbors.
+   * @param threadDistances Per-thread lists of distances.
+   * @param neighbors Matrix to store merged lists of neighbors.
+   * @param distances Matrix to store merged lists of distances.
+   */
+  static void MergeResults(
+      const std::vector<arma::Mat<size_t>>& threadNeighbors,
+      const std::vector<arma::mat>& threadDistances,
+      arma::Mat<size_t>& neighbors,
+      arma::mat& distances);
 }; // class NeighborSearch
 
 } // namespace neighbor
@@ -0,0 +1,163 @@
+/**
+ * @file methods/neighbor_search/neighbor_search_cache.hpp
+ *
+ * Definition of NeighborSearchCache, a least-recently-used cache of the
+ * results of neighbor search queries.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_NEIGHBOR_SEARCH_NEIGHBOR_SEARCH_CACHE_HPP
+#define MLPACK_METHODS_NEIGHBOR_SEARCH_NEIGHBOR_SEARCH_CACHE_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <list>
+#include <unordered_map>
+
+namespace mlpack {
+namespace neighbor {
+
+/**
+ * The NeighborSearchCache holds the neighbors and distances found for recently
+ * searched query points, so that a query that is repeated doesn't need to be
+ * searched again.  Entries are keyed on a hash of the query point and the
+ * number of neighbors; the query point itself is stored too, so a hash
+ * collision can never return the results of a different query.  When the cache
+ * is full, the least recently used entry is dropped.
+ *
+ * The cache knows nothing about the reference set; its owner must call Clear()
+ * whenever the reference set changes.  The results also depend on the
+ * approximation level and the search mode, so the cache is cleared
+ * automatically when Settings() is called with different values.
+ *
+ * @tparam ElemType Type of the elements of the query points.
+ */
+template<typename ElemType>
+class NeighborSearchCache
+{
+ public:
+  /**
+   * Create the cache.  With a maximum size of 0 (the default) the cache is
+   * disabled.
+   *
+   * @param maxSize Maximum number of queries to hold.
+   */
+  NeighborSearchCache(const size_t maxSize = 0);
+
+  //! Copy the given cache.
+  NeighborSearchCache(const NeighborSearchCache& other);
+
+  //! Copy the given cache.
+  NeighborSearchCache& operator=(const NeighborSearchCache& other);
+
+  /**
+   * Look for the results of the given query.  If they are found, they are
+   * stored in the given column of the neighbors and distances matrices, and
+   * the entry becomes the most recently used.
+   *
+   * @param query Query point.
+   * @param k Number of neighbors searched for.
+   * @param neighbors Matrix to store the indices of the neighbors in.
+   * @param distances Matrix to store the distances to the neighbors in.
+   * @param col Column of the matrices to store the results in.
+   * @return true if the query was found.
+   */
+  template<typename VecType>
+  bool Lookup(const VecType& query,
+              const size_t k,
+              arma::Mat<size_t>& neighbors,
+              arma::mat& distances,
+              const size_t col);
+
+  /**
+   * Store the results of the given query.  If the cache is full, the least
+   * recently used entry is dropped.
+   *
+   * @param query Query point.
+   * @param k Number of neighbors searched for.
+   * @param neighbors Indices of the neighbors of the query.
+   * @param distances Distances to the neighbors of the query.
+   */
+  template<typename VecType>
+  void Store(const VecType& query,
+             const size_t k,
+             const arma::Col<size_t>& neighbors,
+             const arma::vec& distances);
+
+  /**
+   * Record the settings the cached results are computed with, and clear the
+   * cache if they differ from the settings of the cached results.
+   *
+   * @param epsilon Relative error of the search.
+   * @param searchMode Search mode (cast to an integer).
+   */
+  void Settings(const double epsilon, const int searchMode);
+
+  //! Drop every entry.
+  void Clear();
+
+  //! Get the number of queries held in the cache.
+  size_t Size() const { return entries.size(); }
+
+  //! Get the maximum number of queries held (0 means the cache is disabled).
+  size_t MaxSize() const { return maxSize; }
+  //! Set the maximum number of queries held (0 disables the cache).  Entries
+  //! are dropped if there are too many.
+  void MaxSize(const size_t size);
+
+  //! Get the number of lookups that found their query.
+  size_t Hits() const { return hits; }
+  //! Get the number of lookups that did not find their query.
+  size_t Misses() const { return misses; }
+
+ private:
+  //! A cached query and its results.
+  struct Entry
+  {
+    size_t hash;
+    size_t k;
+    arma::Col<ElemType> query;
+    arma::Col<size_t> neighbors;
+    arma::vec distances;
+  };
+
+  typedef typename std::list<Entry>::iterator EntryIterator;
+
+  //! Compute the hash of a query.
+  template<typename VecType>
+  static size_t Hash(const VecType& query, const size_t k);
+
+  //! Find the entry of the given query, or return entries.end().
+  template<typename VecType>
+  EntryIterator Find(const VecType& query, const size_t k, const size_t hash);
+
+  //! Rebuild the index after the list of entries has been copied.
+  void Reindex();
+
+  //! The maximum number of entries.
+  size_t maxSize;
+  //! The entries, from the most to the least recently used.
+  std::list<Entry> entries;
+  //! The entries, indexed by their hash.
+  std::unordered_multimap<size_t, EntryIterator> index;
+
+  //! The relative error the cached results were computed with.
+  double epsilon;
+  //! The search mode the cached results were computed with.
+  int searchMode;
+
+  //! The number of lookups that found their query.
+  size_t hits;
+  //! The number of lookups that did not find their query.
+  size_t misses;
+};
+
+} // namespace neighbor
+} // namespace mlpack
+
+// Include implementation.
+#include "neighbor_search_cache_impl.hpp"
+
+#endif
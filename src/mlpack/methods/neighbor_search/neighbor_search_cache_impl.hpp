@@ -0,0 +1,219 @@
+/**
+ * @file methods/neighbor_search/neighbor_search_cache_impl.hpp
+ *
+ * Implementation of NeighborSearchCache.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_NEIGHBOR_SEARCH_NEIGHBOR_SEARCH_CACHE_IMPL_HPP
+#define MLPACK_METHODS_NEIGHBOR_SEARCH_NEIGHBOR_SEARCH_CACHE_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "neighbor_search_cache.hpp"
+
+#include <cstring>
+
+namespace mlpack {
+namespace neighbor {
+
+template<typename ElemType>
+NeighborSearchCache<ElemType>::NeighborSearchCache(const size_t maxSize) :
+    maxSize(maxSize),
+    epsilon(0.0),
+    searchMode(0),
+    hits(0),
+    misses(0)
+{
+  // Nothing to do.
+}
+
+template<typename ElemType>
+NeighborSearchCache<ElemType>::NeighborSearchCache(
+    const NeighborSearchCache& other) :
+    maxSize(other.maxSize),
+    entries(other.entries),
+    epsilon(other.epsilon),
+    searchMode(other.searchMode),
+    hits(other.hits),
+    misses(other.misses)
+{
+  Reindex();
+}
+
+template<typename ElemType>
+NeighborSearchCache<ElemType>& NeighborSearchCache<ElemType>::operator=(
+    const NeighborSearchCache& other)
+{
+  if (&other == this)
+    return *this;
+
+  maxSize = other.maxSize;
+  entries = other.entries;
+  epsilon = other.epsilon;
+  searchMode = other.searchMode;
+  hits = other.hits;
+  misses = other.misses;
+  Reindex();
+
+  return *this;
+}
+
+template<typename ElemType>
+template<typename VecType>
+bool NeighborSearchCache<ElemType>::Lookup(const VecType& query,
+                                           const size_t k,
+                                           arma::Mat<size_t>& neighbors,
+                                           arma::mat& distances,
+                                           const size_t col)
+{
+  EntryIterator it = Find(query, k, Hash(query, k));
+  if (it == entries.end())
+  {
+    ++misses;
+    return false;
+  }
+
+  // This is now the most recently used entry.
+  entries.splice(entries.begin(), entries, it);
+
+  neighbors.col(col) = it->neighbors;
+  distances.col(col) = it->distances;
+  ++hits;
+  return true;
+}
+
+template<typename ElemType>
+template<typename VecType>
+void NeighborSearchCache<ElemType>::Store(const VecType& query,
+                                          const size_t k,
+                                          const arma::Col<size_t>& neighbors,
+                                          const arma::vec& distances)
+{
+  if (maxSize == 0)
+    return;
+
+  const size_t hash = Hash(query, k);
+  EntryIterator it = Find(query, k, hash);
+  if (it != entries.end())
+  {
+    // Just refresh the results.
+    entries.splice(entries.begin(), entries, it);
+    it->neighbors = neighbors;
+    it->distances = distances;
+    return;
+  }
+
+  // Make room for the new entry.
+  if (entries.size() == maxSize)
+  {
+    EntryIterator last = std::prev(entries.end());
+    std::pair<typename std::unordered_multimap<size_t,
+        EntryIterator>::iterator, typename std::unordered_multimap<size_t,
+        EntryIterator>::iterator> range = index.equal_range(last->hash);
+    for (; range.first != range.second; ++range.first)
+    {
+      if (range.first->second == last)
+      {
+        index.erase(range.first);
+        break;
+      }
+    }
+    entries.pop_back();
+  }
+
+  Entry entry;
+  entry.hash = hash;
+  entry.k = k;
+  entry.query = query;
+  entry.neighbors = neighbors;
+  entry.distances = distances;
+  entries.push_front(std::move(entry));
+  index.insert(std::make_pair(hash, entries.begin()));
+}
+
+template<typename ElemType>
+void NeighborSearchCache<ElemType>::Settings(const double epsilon,
+                                             const int searchMode)
+{
+  if (epsilon != this->epsilon || searchMode != this->searchMode)
+  {
+    Clear();
+    this->epsilon = epsilon;
+    this->searchMode = searchMode;
+  }
+}
+
+template<typename ElemType>
+void NeighborSearchCache<ElemType>::Clear()
+{
+  entries.clear();
+  index.clear();
+}
+
+template<typename ElemType>
+void NeighborSearchCache<ElemType>::MaxSize(const size_t size)
+{
+  maxSize = size;
+  while (entries.size() > maxSize)
+    entries.pop_back();
+  Reindex();
+}
+
+template<typename ElemType>
+template<typename VecType>
+size_t NeighborSearchCache<ElemType>::Hash(const VecType& query,
+                                           const size_t k)
+{
+  // FNV-1a over the bytes of the query, followed by k.
+  const unsigned char* bytes = (const unsigned char*) query.colptr(0);
+  const size_t numBytes = query.n_elem * sizeof(ElemType);
+  uint64_t hash = 14695981039346656037ULL;
+  for (size_t i = 0; i < numBytes; ++i)
+  {
+    hash ^= bytes[i];
+    hash *= 1099511628211ULL;
+  }
+
+  hash ^= (uint64_t) k;
+  hash *= 1099511628211ULL;
+
+  return (size_t) hash;
+}
+
+template<typename ElemType>
+template<typename VecType>
+typename NeighborSearchCache<ElemType>::EntryIterator
+NeighborSearchCache<ElemType>::Find(const VecType& query,
+                                    const size_t k,
+                                    const size_t hash)
+{
+  std::pair<typename std::unordered_multimap<size_t, EntryIterator>::iterator,
+      typename std::unordered_multimap<size_t, EntryIterator>::iterator> range =
+      index.equal_range(hash);
+  for (; range.first != range.second; ++range.first)
+  {
+    const Entry& entry = *range.first->second;
+    if (entry.k == k && entry.query.n_elem == query.n_elem &&
+        std::memcmp(entry.query.memptr(), query.colptr(0),
+            query.n_elem * sizeof(ElemType)) == 0)
+      return range.first->second;
+  }
+
+  return entries.end();
+}
+
+template<typename ElemType>
+void NeighborSearchCache<ElemType>::Reindex()
+{
+  index.clear();
+  for (EntryIterator it = entries.begin(); it != entries.end(); ++it)
+    index.insert(std::make_pair(it->hash, it));
+}
+
+} // namespace neighbor
+} // namespace mlpack
+
+#endif
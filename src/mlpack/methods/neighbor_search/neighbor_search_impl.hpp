@@ -17,6 +17,7 @@
 #include <mlpack/core/tree/greedy_single_tree_traverser.hpp>
 #include "neighbor_search_rules.hpp"
 #include <mlpack/core/tree/spill_tree/is_spill_tree.hpp>
+#include <chrono>
 
 namespace mlpack {
 namespace neighbor {
@@ -68,7 +69,13 @@ SingleTreeTraversalType>::NeighborSearch(MatType referenceSetIn,
     metric(metric),
     baseCases(0),
     scores(0),
-    treeNeedsReset(false)
+    treeNeedsReset(false),
+    numThreads(0),
+    blockBaseCases(false),
+    maxBaseCases(0),
+    cache(),
+    changes(0),
+    rebuildRatio(0.5)
 {
   if (epsilon < 0)
     throw std::invalid_argument("epsilon must be non-negative");
@@ -95,7 +102,13 @@ SingleTreeTraversalType>::NeighborSearch(Tree referenceTree,
     metric(metric),
     baseCases(0),
     scores(0),
-    treeNeedsReset(false)
+    treeNeedsReset(false),
+    numThreads(0),
+    blockBaseCases(false),
+    maxBaseCases(0),
+    cache(),
+    changes(0),
+    rebuildRatio(0.5)
 {
   if (epsilon < 0)
     throw std::invalid_argument("epsilon must be non-negative");
@@ -121,7 +134,13 @@ SingleTreeTraversalType>::NeighborSearch(const NeighborSearchMode mode,
     metric(metric),
     baseCases(0),
     scores(0),
-    treeNeedsReset(false)
+    treeNeedsReset(false),
+    numThreads(0),
+    blockBaseCases(false),
+    maxBaseCases(0),
+    cache(),
+    changes(0),
+    rebuildRatio(0.5)
 {
   if (epsilon < 0)
     throw std::invalid_argument("epsilon must be non-negative");
@@ -129,7 +148,7 @@ SingleTreeTraversalType>::NeighborSearch(const NeighborSearchMode mode,
   // Build the tree on the empty dataset, if necessary.
   if (mode != NAIVE_MODE)
   {
-    referenceTree = BuildTree<Tree>(std::move(arma::mat()),
+    referenceTree = BuildTree<Tree>(std::move(MatType()),
         oldFromNewReferences);
     referenceSet = &referenceTree->Dataset();
   }
@@ -155,7 +174,15 @@ SingleTreeTraversalType>::NeighborSearch(const NeighborSearch& other) :
     metric(other.metric),
     baseCases(other.baseCases),
     scores(other.scores),
-    treeNeedsReset(false)
+    statistics(other.statistics),
+    treeNeedsReset(false),
+    numThreads(other.numThreads),
+    blockBaseCases(other.blockBaseCases),
+    maxBaseCases(other.maxBaseCases),
+    truncatedQueries(other.truncatedQueries),
+    cache(other.cache),
+    changes(other.changes),
+    rebuildRatio(other.rebuildRatio)
 {
   // Nothing else to do.
 }
@@ -179,7 +206,15 @@ SingleTreeTraversalType>::NeighborSearch(NeighborSearch&& other) :
     metric(std::move(other.metric)),
     baseCases(other.baseCases),
     scores(other.scores),
-    treeNeedsReset(other.treeNeedsReset)
+    statistics(other.statistics),
+    treeNeedsReset(other.treeNeedsReset),
+    numThreads(other.numThreads),
+    blockBaseCases(other.blockBaseCases),
+    maxBaseCases(other.maxBaseCases),
+    truncatedQueries(other.truncatedQueries),
+    cache(other.cache),
+    changes(other.changes),
+    rebuildRatio(other.rebuildRatio)
 {
   // Clear the other model.
   other.referenceTree = BuildTree<Tree>(std::move(MatType()),
@@ -232,7 +267,17 @@ NeighborSearch<SortPolicy,
   metric = other.metric;
   baseCases = other.baseCases;
   scores = other.scores;
+  statistics = other.statistics;
   treeNeedsReset = false;
+  numThreads = other.numThreads;
+  blockBaseCases = other.blockBaseCases;
+  maxBaseCases = other.maxBaseCases;
+  truncatedQueries = other.truncatedQueries;
+  cache = other.cache;
+  changes = other.changes;
+  rebuildRatio = other.rebuildRatio;
+
+  return *this;
 }
 
 // Move operator.
@@ -274,13 +319,21 @@ NeighborSearch<SortPolicy,
   metric = other.metric;
   baseCases = other.baseCases;
   scores = other.scores;
+  statistics = other.statistics;
   treeNeedsReset = other.treeNeedsReset;
+  numThreads = other.numThreads;
+  blockBaseCases = other.blockBaseCases;
+  maxBaseCases = other.maxBaseCases;
+  truncatedQueries = other.truncatedQueries;
+  cache = other.cache;
+  changes = other.changes;
+  rebuildRatio = other.rebuildRatio;
 
   // Reset the other object.  Clean memory if needed.
   if (!other.referenceTree)
     delete other.referenceSet;
 
-  other.referenceTree = BuildTree<Tree>(std::move(arma::mat()),
+  other.referenceTree = BuildTree<Tree>(std::move(MatType()),
       other.oldFromNewReferences);
   other.referenceSet = &other.referenceTree->Dataset();
   other.searchMode = DUAL_TREE_MODE,
@@ -288,6 +341,8 @@ NeighborSearch<SortPolicy,
   other.baseCases = 0;
   other.scores = 0;
   other.treeNeedsReset = false;
+
+  return *this;
 }
 
 // Clean memory.
@@ -342,6 +397,9 @@ DualTreeTraversalType, SingleTreeTraversalType>::Train(MatType referenceSetIn)
   {
     referenceSet = new MatType(std::move(referenceSetIn));
   }
+
+  changes = 0;
+  cache.Clear();
 }
 
 template<typename SortPolicy,
@@ -371,6 +429,304 @@ DualTreeTraversalType, SingleTreeTraversalType>::Train(Tree referenceTree)
 
   this->referenceTree = new Tree(std::move(referenceTree));
   this->referenceSet = &this->referenceTree->Dataset();
+  changes = 0;
+  cache.Clear();
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::Insert(const MatType& points)
+{
+  if (points.n_cols == 0)
+    return;
+
+  if (referenceSet->n_cols > 0 && points.n_rows != referenceSet->n_rows)
+  {
+    std::stringstream ss;
+    ss << "cannot insert points of dimensionality " << points.n_rows << " into "
+        << "a reference set of dimensionality " << referenceSet->n_rows;
+    throw std::invalid_argument(ss.str());
+  }
+
+  // There is nothing to keep from an empty model.
+  if (referenceSet->n_cols == 0)
+  {
+    Train(MatType(points));
+    return;
+  }
+
+  if (searchMode == NAIVE_MODE)
+  {
+    Train(MatType(arma::join_rows(*referenceSet, points)));
+    return;
+  }
+
+  InsertPoints(points);
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+bool NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::Remove(const size_t index)
+{
+  if (searchMode == NAIVE_MODE)
+    throw std::invalid_argument("cannot remove points when naive search "
+        "(without trees) is used");
+
+  if (index >= referenceSet->n_cols)
+  {
+    std::stringstream ss;
+    ss << "cannot remove point " << index << "; the reference set has only "
+        << referenceSet->n_cols << " points";
+    throw std::invalid_argument(ss.str());
+  }
+
+  return RemovePoint(index);
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::Refit()
+{
+  // Without a tree, there is nothing to update but the cached results.
+  cache.Clear();
+  if (searchMode == NAIVE_MODE)
+    return;
+
+  RefitTree();
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+template<typename TreeT>
+void NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::RefitTree(
+    const typename std::enable_if_t<HasRefitBounds<TreeT,
+        void(TreeT::*)()>::value>*)
+{
+  // This also reinitializes the statistics of every node.
+  referenceTree->RefitBounds();
+  treeNeedsReset = false;
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+template<typename TreeT>
+void NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::RefitTree(
+    const typename std::enable_if_t<!HasRefitBounds<TreeT,
+        void(TreeT::*)()>::value>*)
+{
+  // Trees that support point deletion are rebuilt without the removed points.
+  if (HasDeletePoint<TreeT, bool(TreeT::*)(const size_t)>::value)
+    RebuildTree();
+  else
+    Train(OriginalReferenceSet());
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+MatType NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::OriginalReferenceSet() const
+{
+  if (oldFromNewReferences.empty())
+    return *referenceSet;
+
+  MatType original(referenceSet->n_rows, referenceSet->n_cols);
+  for (size_t i = 0; i < referenceSet->n_cols; ++i)
+    original.col(oldFromNewReferences[i]) = referenceSet->col(i);
+
+  return original;
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+template<typename TreeT>
+void NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::InsertPoints(
+    const MatType& points,
+    const typename std::enable_if_t<HasInsertPoint<TreeT,
+        void(TreeT::*)(const size_t)>::value>*)
+{
+  // The tree holds a pointer to its dataset, so we can grow it in place and
+  // then insert the new columns one by one.
+  const size_t oldSize = referenceSet->n_cols;
+  referenceTree->Dataset().insert_cols(oldSize, points);
+  referenceSet = &referenceTree->Dataset();
+  for (size_t i = oldSize; i < referenceSet->n_cols; ++i)
+    referenceTree->InsertPoint(i);
+
+  // The statistics of the nodes are now stale, and so are the cached results.
+  treeNeedsReset = true;
+  cache.Clear();
+
+  changes += points.n_cols;
+  if (changes > rebuildRatio * referenceSet->n_cols)
+    RebuildTree();
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+template<typename TreeT>
+void NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::InsertPoints(
+    const MatType& points,
+    const typename std::enable_if_t<!HasInsertPoint<TreeT,
+        void(TreeT::*)(const size_t)>::value>*)
+{
+  // The tree can't be modified, so build a new one.  The old points keep their
+  // original indices.
+  Train(MatType(arma::join_rows(OriginalReferenceSet(), points)));
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+template<typename TreeT>
+bool NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::RemovePoint(
+    const size_t index,
+    const typename std::enable_if_t<HasDeletePoint<TreeT,
+        bool(TreeT::*)(const size_t)>::value>*)
+{
+  if (!referenceTree->DeletePoint(index))
+    return false;
+
+  treeNeedsReset = true;
+  cache.Clear();
+
+  ++changes;
+  if (changes > rebuildRatio * referenceSet->n_cols)
+    RebuildTree();
+
+  return true;
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+template<typename TreeT>
+bool NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::RemovePoint(
+    const size_t /* index */,
+    const typename std::enable_if_t<!HasDeletePoint<TreeT,
+        bool(TreeT::*)(const size_t)>::value>*)
+{
+  throw std::invalid_argument("the reference tree type does not support "
+      "removing points");
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+template<typename TreeT>
+void NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::RebuildTree(
+    const typename std::enable_if_t<HasDeletePoint<TreeT,
+        bool(TreeT::*)(const size_t)>::value>*)
+{
+  // Find which points are still in the tree.
+  std::vector<bool> held(referenceSet->n_cols, false);
+  MarkPoints(*referenceTree, held);
+
+  // Build the new tree on the whole dataset, so that the indices stay the
+  // same, and then drop the removed points.
+  MatType dataset(std::move(referenceTree->Dataset()));
+  delete referenceTree;
+  referenceTree = BuildTree<Tree>(std::move(dataset), oldFromNewReferences);
+  referenceSet = &referenceTree->Dataset();
+  for (size_t i = 0; i < held.size(); ++i)
+    if (!held[i])
+      referenceTree->DeletePoint(i);
+
+  // Deletions may have moved points between nodes.
+  treeNeedsReset = true;
+  changes = 0;
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::MarkPoints(
+    const Tree& node,
+    std::vector<bool>& held)
+{
+  for (size_t i = 0; i < node.NumPoints(); ++i)
+    held[node.Point(i)] = true;
+
+  for (size_t i = 0; i < node.NumChildren(); ++i)
+    MarkPoints(node.Child(i), held);
 }
 
 /**
@@ -391,6 +747,101 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
     const size_t k,
     arma::Mat<size_t>& neighbors,
     arma::mat& distances)
+{
+  if (cache.MaxSize() == 0)
+  {
+    UncachedSearch(querySet, k, neighbors, distances, statistics,
+        truncatedQueries);
+    baseCases = statistics.BaseCases();
+    scores = statistics.Scores();
+    return;
+  }
+
+  // Take the results we already know from the cache.
+  cache.Settings(epsilon, (int) searchMode);
+  neighbors.set_size(k, querySet.n_cols);
+  distances.set_size(k, querySet.n_cols);
+  std::vector<size_t> misses;
+  for (size_t i = 0; i < querySet.n_cols; ++i)
+    if (!cache.Lookup(querySet.col(i), k, neighbors, distances, i))
+      misses.push_back(i);
+
+  if (misses.empty())
+    return;
+
+  // Search for the other points, and remember their results.
+  MatType missSubset;
+  if (misses.size() < querySet.n_cols)
+    missSubset = querySet.cols(arma::conv_to<arma::uvec>::from(misses));
+  const MatType& missQueries = (misses.size() == querySet.n_cols) ?
+      querySet : missSubset;
+  arma::Mat<size_t> missNeighbors;
+  arma::mat missDistances;
+  UncachedSearch(missQueries, k, missNeighbors, missDistances, statistics,
+      truncatedQueries);
+  baseCases = statistics.BaseCases();
+  scores = statistics.Scores();
+
+  // Approximate results (from a search that ran out of budget) aren't cached.
+  std::vector<bool> truncated(misses.size(), false);
+  for (size_t i = 0; i < truncatedQueries.size(); ++i)
+  {
+    truncated[truncatedQueries[i]] = true;
+    truncatedQueries[i] = misses[truncatedQueries[i]];
+  }
+
+  for (size_t i = 0; i < misses.size(); ++i)
+  {
+    neighbors.col(misses[i]) = missNeighbors.col(i);
+    distances.col(misses[i]) = missDistances.col(i);
+    if (!truncated[i])
+    {
+      cache.Store(missQueries.col(i), k, missNeighbors.col(i),
+          missDistances.col(i));
+    }
+  }
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::Search(
+    const MatType& querySet,
+    const size_t k,
+    arma::Mat<size_t>& neighbors,
+    arma::mat& distances,
+    SearchStatistics& searchStatistics,
+    std::vector<size_t>* truncated) const
+{
+  std::vector<size_t> truncatedLocal;
+  UncachedSearch(querySet, k, neighbors, distances, searchStatistics,
+      truncatedLocal);
+  if (truncated)
+    *truncated = std::move(truncatedLocal);
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::UncachedSearch(
+    const MatType& querySet,
+    const size_t k,
+    arma::Mat<size_t>& neighbors,
+    arma::mat& distances,
+    SearchStatistics& searchStatistics,
+    std::vector<size_t>& truncated) const
 {
   if (k > referenceSet->n_cols)
   {
@@ -402,8 +853,11 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
 
   Timer::Start("computing_neighbors");
 
-  baseCases = 0;
-  scores = 0;
+  searchStatistics.Reset();
+  truncated.clear();
+  MetricType searchMetric(metric);
+  const std::chrono::steady_clock::time_point searchStart =
+      std::chrono::steady_clock::now();
 
   // This will hold mappings for query points, if necessary.
   std::vector<size_t> oldFromNewQueries;
@@ -438,22 +892,40 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
     case NAIVE_MODE:
     {
       // Create the helper object for the tree traversal.
-      RuleType rules(*referenceSet, querySet, k, metric, epsilon);
+      RuleType rules(*referenceSet, querySet, k, searchMetric, epsilon);
 
-      // The naive brute-force traversal.
+      // The naive brute-force traversal.  It does nothing but base cases.
+      const std::chrono::steady_clock::time_point naiveStart =
+          std::chrono::steady_clock::now();
       for (size_t i = 0; i < querySet.n_cols; ++i)
         for (size_t j = 0; j < referenceSet->n_cols; ++j)
           rules.BaseCase(i, j);
 
-      baseCases += querySet.n_cols * referenceSet->n_cols;
+      searchStatistics.AddRules(rules);
+      searchStatistics.BaseCaseTime() = std::chrono::duration<double>(
+          std::chrono::steady_clock::now() - naiveStart).count();
 
       rules.GetResults(*neighborPtr, *distancePtr);
       break;
     }
     case SINGLE_TREE_MODE:
     {
+      // Trees with self-children cache base cases in the statistics of the
+      // reference nodes during single-tree search, so the query points can
+      // only be split across threads for other types of trees.
+      const size_t threads = (tree::TreeTraits<Tree>::FirstPointIsCentroid &&
+          tree::TreeTraits<Tree>::HasSelfChildren) ? 1 : SearchThreads();
+
+      if (threads > 1 && querySet.n_cols > 1)
+      {
+        SingleTreeSearch(querySet, k, threads, *neighborPtr, *distancePtr,
+            searchStatistics, truncated);
+        break;
+      }
+
       // Create the helper object for the tree traversal.
-      RuleType rules(*referenceSet, querySet, k, metric, epsilon);
+      RuleType rules(*referenceSet, querySet, k, searchMetric, epsilon);
+      rules.MaxBaseCases() = maxBaseCases;
 
       // Create the traverser.
       SingleTreeTraversalType<RuleType> traverser(rules);
@@ -462,14 +934,15 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
       for (size_t i = 0; i < querySet.n_cols; ++i)
         traverser.Traverse(i, *referenceTree);
 
-      scores += rules.Scores();
-      baseCases += rules.BaseCases();
+      searchStatistics.AddRules(rules);
+      searchStatistics.AddTraverser(traverser);
 
       Log::Info << rules.Scores() << " node combinations were scored."
           << std::endl;
       Log::Info << rules.BaseCases() << " base cases were calculated."
           << std::endl;
 
+      rules.GetTruncated(truncated);
       rules.GetResults(*neighborPtr, *distancePtr);
       break;
     }
@@ -478,27 +951,17 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
       // Build the query tree.
       Timer::Stop("computing_neighbors");
       Timer::Start("tree_building");
+      const std::chrono::steady_clock::time_point buildStart =
+          std::chrono::steady_clock::now();
       Tree* queryTree = BuildTree<Tree>(querySet, oldFromNewQueries);
+      searchStatistics.TreeBuildingTime() = std::chrono::duration<double>(
+          std::chrono::steady_clock::now() - buildStart).count();
       Timer::Stop("tree_building");
       Timer::Start("computing_neighbors");
 
-      // Create the helper object for the tree traversal.
-      RuleType rules(*referenceSet, queryTree->Dataset(), k, metric, epsilon);
-
-      // Create the traverser.
-      DualTreeTraversalType<RuleType> traverser(rules);
-
-      traverser.Traverse(*queryTree, *referenceTree);
-
-      scores += rules.Scores();
-      baseCases += rules.BaseCases();
-
-      Log::Info << rules.Scores() << " node combinations were scored."
-          << std::endl;
-      Log::Info << rules.BaseCases() << " base cases were calculated."
-          << std::endl;
-
-      rules.GetResults(*neighborPtr, *distancePtr);
+      // Run the (possibly parallel) dual-tree traversal.
+      DualTreeSearch(*queryTree, k, *neighborPtr, *distancePtr, false,
+          searchStatistics);
 
       delete queryTree;
       break;
@@ -506,7 +969,8 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
     case GREEDY_SINGLE_TREE_MODE:
     {
       // Create the helper object for the tree traversal.
-      RuleType rules(*referenceSet, querySet, k, metric);
+      RuleType rules(*referenceSet, querySet, k, searchMetric);
+      rules.MaxBaseCases() = maxBaseCases;
 
       // Create the traverser.
       tree::GreedySingleTreeTraverser<Tree, RuleType> traverser(rules);
@@ -515,20 +979,24 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
       for (size_t i = 0; i < querySet.n_cols; ++i)
         traverser.Traverse(i, *referenceTree);
 
-      scores += rules.Scores();
-      baseCases += rules.BaseCases();
+      searchStatistics.AddRules(rules);
+      searchStatistics.AddTraverser(traverser);
 
       Log::Info << rules.Scores() << " node combinations were scored."
           << std::endl;
       Log::Info << rules.BaseCases() << " base cases were calculated."
           << std::endl;
 
+      rules.GetTruncated(truncated);
       rules.GetResults(*neighborPtr, *distancePtr);
       break;
     }
   }
 
   Timer::Stop("computing_neighbors");
+  searchStatistics.SearchTime() = std::chrono::duration<double>(
+      std::chrono::steady_clock::now() - searchStart).count() -
+      searchStatistics.TreeBuildingTime();
 
   // Map points back to original indices, if necessary.
   if (tree::TreeTraits<Tree>::RearrangesDataset)
@@ -588,7 +1056,7 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
       delete neighborPtr;
     }
   }
-} // Search()
+} // UncachedSearch()
 
 template<typename SortPolicy,
          typename MetricType,
@@ -605,6 +1073,48 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
     arma::Mat<size_t>& neighbors,
     arma::mat& distances,
     bool sameSet)
+{
+  QueryTreeSearch(queryTree, k, neighbors, distances, sameSet, statistics);
+  baseCases = statistics.BaseCases();
+  scores = statistics.Scores();
+  truncatedQueries.clear();
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::Search(
+    Tree& queryTree,
+    const size_t k,
+    arma::Mat<size_t>& neighbors,
+    arma::mat& distances,
+    SearchStatistics& searchStatistics) const
+{
+  QueryTreeSearch(queryTree, k, neighbors, distances, false, searchStatistics);
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::QueryTreeSearch(
+    Tree& queryTree,
+    const size_t k,
+    arma::Mat<size_t>& neighbors,
+    arma::mat& distances,
+    const bool sameSet,
+    SearchStatistics& searchStatistics) const
 {
   if (k > referenceSet->n_cols)
   {
@@ -621,8 +1131,9 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
 
   Timer::Start("computing_neighbors");
 
-  baseCases = 0;
-  scores = 0;
+  searchStatistics.Reset();
+  const std::chrono::steady_clock::time_point searchStart =
+      std::chrono::steady_clock::now();
 
   // Get a reference to the query set.
   const MatType& querySet = queryTree.Dataset();
@@ -637,26 +1148,14 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
   neighborPtr->set_size(k, querySet.n_cols);
   distances.set_size(k, querySet.n_cols);
 
-  // Create the helper object for the traversal.
-  typedef NeighborSearchRules<SortPolicy, MetricType, Tree> RuleType;
-  RuleType rules(*referenceSet, querySet, k, metric, epsilon, sameSet);
-
-  // Create the traverser.
-  DualTreeTraversalType<RuleType> traverser(rules);
-  traverser.Traverse(queryTree, *referenceTree);
-
-  scores += rules.Scores();
-  baseCases += rules.BaseCases();
-
-  Log::Info << rules.Scores() << " node combinations were scored." << std::endl;
-  Log::Info << rules.BaseCases() << " base cases were calculated." << std::endl;
-
-  rules.GetResults(*neighborPtr, distances);
-
-  Log::Info << rules.Scores() << " node combinations were scored.\n";
-  Log::Info << rules.BaseCases() << " base cases were calculated.\n";
+  // Run the (possibly parallel) dual-tree traversal.
+  DualTreeSearch(queryTree, k, *neighborPtr, distances, sameSet,
+      searchStatistics);
 
   Timer::Stop("computing_neighbors");
+  searchStatistics.SearchTime() = std::chrono::duration<double>(
+      std::chrono::steady_clock::now() - searchStart).count() -
+      searchStatistics.TreeBuildingTime();
 
   // Do we need to map indices?
   if (!oldFromNewReferences.empty() &&
@@ -688,6 +1187,62 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
     const size_t k,
     arma::Mat<size_t>& neighbors,
     arma::mat& distances)
+{
+  // The dual-tree monochromatic search uses the reference tree as the query
+  // tree, so its bounds may need to be reset.
+  if (searchMode == DUAL_TREE_MODE && treeNeedsReset &&
+      k < referenceSet->n_cols)
+    ResetStatistics(*referenceTree);
+
+  MonochromaticSearch(k, neighbors, distances, statistics, truncatedQueries,
+      false);
+  baseCases = statistics.BaseCases();
+  scores = statistics.Scores();
+
+  // Next time we perform this search, we'll need to reset the tree.
+  if (searchMode == DUAL_TREE_MODE)
+    treeNeedsReset = true;
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::Search(
+    const size_t k,
+    arma::Mat<size_t>& neighbors,
+    arma::mat& distances,
+    SearchStatistics& searchStatistics,
+    std::vector<size_t>* truncated) const
+{
+  std::vector<size_t> truncatedLocal;
+  MonochromaticSearch(k, neighbors, distances, searchStatistics,
+      truncatedLocal, true);
+  if (truncated)
+    *truncated = std::move(truncatedLocal);
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::MonochromaticSearch(
+    const size_t k,
+    arma::Mat<size_t>& neighbors,
+    arma::mat& distances,
+    SearchStatistics& searchStatistics,
+    std::vector<size_t>& truncated,
+    const bool copyReferenceTree) const
 {
   if (k > referenceSet->n_cols)
   {
@@ -707,8 +1262,11 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
 
   Timer::Start("computing_neighbors");
 
-  baseCases = 0;
-  scores = 0;
+  searchStatistics.Reset();
+  truncated.clear();
+  MetricType searchMetric(metric);
+  const std::chrono::steady_clock::time_point searchStart =
+      std::chrono::steady_clock::now();
 
   arma::Mat<size_t>* neighborPtr = &neighbors;
   arma::mat* distancePtr = &distances;
@@ -725,25 +1283,37 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
   neighborPtr->set_size(k, referenceSet->n_cols);
   distancePtr->set_size(k, referenceSet->n_cols);
 
-  // Create the helper object for the traversal.
   typedef NeighborSearchRules<SortPolicy, MetricType, Tree> RuleType;
-  RuleType rules(*referenceSet, *referenceSet, k, metric, epsilon,
-      true /* don't return the same point as nearest neighbor */);
 
   switch (searchMode)
   {
     case NAIVE_MODE:
     {
-      // The naive brute-force solution.
+      // Create the helper object for the traversal.
+      RuleType rules(*referenceSet, *referenceSet, k, searchMetric, epsilon,
+          true /* don't return the same point as nearest neighbor */);
+
+      // The naive brute-force solution.  It does nothing but base cases.
+      const std::chrono::steady_clock::time_point naiveStart =
+          std::chrono::steady_clock::now();
       for (size_t i = 0; i < referenceSet->n_cols; ++i)
         for (size_t j = 0; j < referenceSet->n_cols; ++j)
           rules.BaseCase(i, j);
 
-      baseCases += referenceSet->n_cols * referenceSet->n_cols;
+      searchStatistics.AddRules(rules);
+      searchStatistics.BaseCaseTime() = std::chrono::duration<double>(
+          std::chrono::steady_clock::now() - naiveStart).count();
+
+      rules.GetResults(*neighborPtr, *distancePtr);
       break;
     }
     case SINGLE_TREE_MODE:
     {
+      // Create the helper object for the traversal.
+      RuleType rules(*referenceSet, *referenceSet, k, searchMetric, epsilon,
+          true /* don't return the same point as nearest neighbor */);
+      rules.MaxBaseCases() = maxBaseCases;
+
       // Create the traverser.
       SingleTreeTraversalType<RuleType> traverser(rules);
 
@@ -751,68 +1321,60 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
       for (size_t i = 0; i < referenceSet->n_cols; ++i)
         traverser.Traverse(i, *referenceTree);
 
-      scores += rules.Scores();
-      baseCases += rules.BaseCases();
+      searchStatistics.AddRules(rules);
+      searchStatistics.AddTraverser(traverser);
 
       Log::Info << rules.Scores() << " node combinations were scored."
           << std::endl;
       Log::Info << rules.BaseCases() << " base cases were calculated."
           << std::endl;
+
+      rules.GetTruncated(truncated);
+      rules.GetResults(*neighborPtr, *distancePtr);
       break;
     }
     case DUAL_TREE_MODE:
     {
-      // The dual-tree monochromatic search case may require resetting the
-      // bounds in the tree.
-      if (treeNeedsReset)
-      {
-        std::stack<Tree*> nodes;
-        nodes.push(referenceTree);
-        while (!nodes.empty())
-        {
-          Tree* node = nodes.top();
-          nodes.pop();
-
-          // Reset bounds of this node.
-          node->Stat().Reset();
-
-          // Then add the children.
-          for (size_t i = 0; i < node->NumChildren(); ++i)
-            nodes.push(&node->Child(i));
-        }
-      }
-
-      // Create the traverser.
-      DualTreeTraversalType<RuleType> traverser(rules);
-
       if (tree::IsSpillTree<Tree>::value)
       {
         // For Dual Tree Search on SpillTree, the queryTree must be built with
         // non overlapping (tau = 0).
+        const std::chrono::steady_clock::time_point buildStart =
+            std::chrono::steady_clock::now();
         Tree queryTree(*referenceSet);
-        traverser.Traverse(queryTree, *referenceTree);
+        searchStatistics.TreeBuildingTime() = std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - buildStart).count();
+        DualTreeSearch(queryTree, k, *neighborPtr, *distancePtr, true,
+            searchStatistics);
+      }
+      else if (copyReferenceTree)
+      {
+        // The bounds of the query tree are modified during the traversal, so
+        // a copy of the reference tree is used, and the reference tree is only
+        // read.
+        const std::chrono::steady_clock::time_point buildStart =
+            std::chrono::steady_clock::now();
+        Tree queryTree(*referenceTree);
+        ResetStatistics(queryTree);
+        searchStatistics.TreeBuildingTime() = std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - buildStart).count();
+        DualTreeSearch(queryTree, k, *neighborPtr, *distancePtr, true,
+            searchStatistics);
       }
       else
       {
-        traverser.Traverse(*referenceTree, *referenceTree);
-        // Next time we perform this search, we'll need to reset the tree.
-        treeNeedsReset = true;
+        DualTreeSearch(*referenceTree, k, *neighborPtr, *distancePtr, true,
+            searchStatistics);
       }
-
-      scores += rules.Scores();
-      baseCases += rules.BaseCases();
-
-      Log::Info << rules.Scores() << " node combinations were scored."
-          << std::endl;
-      Log::Info << rules.BaseCases() << " base cases were calculated."
-          << std::endl;
-
-      // Next time we perform this search, we'll need to reset the tree.
-      treeNeedsReset = true;
       break;
     }
     case GREEDY_SINGLE_TREE_MODE:
     {
+      // Create the helper object for the traversal.
+      RuleType rules(*referenceSet, *referenceSet, k, searchMetric, epsilon,
+          true /* don't return the same point as nearest neighbor */);
+      rules.MaxBaseCases() = maxBaseCases;
+
       // Create the traverser.
       tree::GreedySingleTreeTraverser<Tree, RuleType> traverser(rules);
 
@@ -820,20 +1382,24 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
       for (size_t i = 0; i < referenceSet->n_cols; ++i)
         traverser.Traverse(i, *referenceTree);
 
-      scores += rules.Scores();
-      baseCases += rules.BaseCases();
+      searchStatistics.AddRules(rules);
+      searchStatistics.AddTraverser(traverser);
 
       Log::Info << rules.Scores() << " node combinations were scored."
           << std::endl;
       Log::Info << rules.BaseCases() << " base cases were calculated."
           << std::endl;
+
+      rules.GetTruncated(truncated);
+      rules.GetResults(*neighborPtr, *distancePtr);
       break;
     }
   }
 
-  rules.GetResults(*neighborPtr, *distancePtr);
-
   Timer::Stop("computing_neighbors");
+  searchStatistics.SearchTime() = std::chrono::duration<double>(
+      std::chrono::steady_clock::now() - searchStart).count() -
+      searchStatistics.TreeBuildingTime();
 
   // Do we need to map the reference indices?
   if (!oldFromNewReferences.empty() &&
@@ -859,6 +1425,330 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
   }
 }
 
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::ResetStatistics(Tree& node)
+{
+  std::stack<Tree*> nodes;
+  nodes.push(&node);
+  while (!nodes.empty())
+  {
+    Tree* current = nodes.top();
+    nodes.pop();
+
+    // Reset bounds of this node.
+    current->Stat().Reset();
+
+    // Then add the children.
+    for (size_t i = 0; i < current->NumChildren(); ++i)
+      nodes.push(&current->Child(i));
+  }
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+size_t NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::SearchThreads() const
+{
+  return util::Threads(numThreads);
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::DualTreeSearch(
+    Tree& queryTree,
+    const size_t k,
+    arma::Mat<size_t>& neighbors,
+    arma::mat& distances,
+    const bool sameSet,
+    SearchStatistics& searchStatistics) const
+{
+  typedef NeighborSearchRules<SortPolicy, MetricType, Tree> RuleType;
+  const MatType& querySet = queryTree.Dataset();
+
+  const size_t threads = SearchThreads();
+
+  // Split the query tree into a frontier of disjoint subtrees.  We repeatedly
+  // replace the largest node in the frontier with its children, until there
+  // are enough subtrees to keep every thread busy.
+  std::vector<Tree*> frontier(1, &queryTree);
+  while (threads > 1 && frontier.size() < 4 * threads)
+  {
+    size_t largest = frontier.size();
+    for (size_t i = 0; i < frontier.size(); ++i)
+    {
+      if (frontier[i]->NumChildren() == 0)
+        continue;
+
+      if (largest == frontier.size() || frontier[i]->NumDescendants() >
+          frontier[largest]->NumDescendants())
+        largest = i;
+    }
+
+    if (largest == frontier.size())
+      break; // Only leaves are left; we can't split any further.
+
+    Tree* node = frontier[largest];
+    frontier[largest] = &node->Child(0);
+    for (size_t i = 1; i < node->NumChildren(); ++i)
+      frontier.push_back(&node->Child(i));
+  }
+
+  if (frontier.size() == 1)
+  {
+    // There is nothing to split, so just run the traversal on one thread.
+    MetricType searchMetric(metric);
+    RuleType rules(*referenceSet, querySet, k, searchMetric, epsilon, sameSet);
+    rules.BlockBaseCases() = blockBaseCases;
+
+    DualTreeTraversalType<RuleType> traverser(rules);
+    traverser.Traverse(queryTree, *referenceTree);
+
+    searchStatistics.AddRules(rules);
+    searchStatistics.AddTraverser(traverser);
+
+    Log::Info << rules.Scores() << " node combinations were scored."
+        << std::endl;
+    Log::Info << rules.BaseCases() << " base cases were calculated."
+        << std::endl;
+
+    rules.GetResults(neighbors, distances);
+    return;
+  }
+
+  // Each thread traverses the subtrees it takes from the frontier with its own
+  // rules object.  The frontier subtrees hold disjoint sets of query points
+  // when no point is held by two nodes, so then the rules of all threads share
+  // one set of candidate lists, and each list is only modified by the thread
+  // that owns the query point; the results are kept once, as in a serial
+  // search.  Otherwise (as in spill trees) each thread has its own candidate
+  // lists, which are merged afterwards.  The statistics of each query node are
+  // only modified by the thread that owns its subtree, and the reference tree
+  // is only read.
+  const bool shareCandidates = tree::TreeTraits<Tree>::UniqueNumDescendants;
+  const MatType noQueries;
+  MetricType searchMetric(metric);
+  RuleType sharedRules(*referenceSet, shareCandidates ? querySet : noQueries,
+      k, searchMetric, epsilon, sameSet);
+  sharedRules.BlockBaseCases() = blockBaseCases;
+
+  std::vector<arma::Mat<size_t>> threadNeighbors(shareCandidates ? 0 :
+      threads);
+  std::vector<arma::mat> threadDistances(shareCandidates ? 0 : threads);
+  std::vector<SearchStatistics> threadStatistics(threads);
+  size_t totalScores = 0;
+  size_t totalBaseCases = 0;
+
+  #pragma omp parallel num_threads(threads) \
+      reduction(+:totalScores, totalBaseCases)
+  {
+    #ifdef HAS_OPENMP
+    const size_t threadId = (size_t) omp_get_thread_num();
+    #else
+    const size_t threadId = 0;
+    #endif
+
+    MetricType threadMetric(metric);
+    RuleType rules = shareCandidates ? sharedRules.Share(threadMetric) :
+        RuleType(*referenceSet, querySet, k, threadMetric, epsilon, sameSet);
+    rules.BlockBaseCases() = blockBaseCases;
+    DualTreeTraversalType<RuleType> traverser(rules);
+
+    #pragma omp for schedule(dynamic)
+    for (omp_size_t i = 0; i < (omp_size_t) frontier.size(); ++i)
+    {
+      // The traverser expects the combination it is given to already have
+      // been scored (unless both nodes are roots).
+      if (rules.Score(*frontier[i], *referenceTree) != DBL_MAX)
+        traverser.Traverse(*frontier[i], *referenceTree);
+    }
+
+    totalScores += rules.Scores();
+    totalBaseCases += rules.BaseCases();
+    threadStatistics[threadId].AddRules(rules);
+    threadStatistics[threadId].AddTraverser(traverser);
+
+    if (!shareCandidates)
+      rules.GetResults(threadNeighbors[threadId], threadDistances[threadId]);
+  }
+
+  for (size_t i = 0; i < threads; ++i)
+    searchStatistics += threadStatistics[i];
+
+  Log::Info << totalScores << " node combinations were scored." << std::endl;
+  Log::Info << totalBaseCases << " base cases were calculated." << std::endl;
+
+  if (shareCandidates)
+    sharedRules.GetResults(neighbors, distances);
+  else
+    MergeResults(threadNeighbors, threadDistances, neighbors, distances);
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::SingleTreeSearch(
+    const MatType& querySet,
+    const size_t k,
+    const size_t threads,
+    arma::Mat<size_t>& neighbors,
+    arma::mat& distances,
+    SearchStatistics& searchStatistics,
+    std::vector<size_t>& truncated) const
+{
+  typedef NeighborSearchRules<SortPolicy, MetricType, Tree> RuleType;
+
+  // Split the query set into contiguous blocks.  Using a few more blocks than
+  // threads helps to balance the load when some queries are more expensive
+  // than others.
+  const size_t numBlocks = std::min((size_t) querySet.n_cols, 4 * threads);
+  const size_t blockSize = (querySet.n_cols + numBlocks - 1) / numBlocks;
+
+  std::vector<SearchStatistics> blockStatistics(numBlocks);
+  std::vector<std::vector<size_t>> blockTruncated(numBlocks);
+  size_t totalScores = 0;
+  size_t totalBaseCases = 0;
+
+  #pragma omp parallel for num_threads(threads) schedule(dynamic) \
+      reduction(+:totalScores, totalBaseCases)
+  for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+  {
+    const size_t begin = b * blockSize;
+    if (begin >= querySet.n_cols)
+      continue;
+    const size_t end = std::min(begin + blockSize, (size_t) querySet.n_cols);
+
+    // Each block gets its own rules object, so that the candidate lists are
+    // only as large as the block.
+    const MatType queryBlock(querySet.cols(begin, end - 1));
+    MetricType blockMetric(metric);
+    RuleType rules(*referenceSet, queryBlock, k, blockMetric, epsilon);
+    rules.MaxBaseCases() = maxBaseCases;
+    SingleTreeTraversalType<RuleType> traverser(rules);
+
+    for (size_t i = 0; i < queryBlock.n_cols; ++i)
+      traverser.Traverse(i, *referenceTree);
+
+    totalScores += rules.Scores();
+    totalBaseCases += rules.BaseCases();
+    blockStatistics[b].AddRules(rules);
+    blockStatistics[b].AddTraverser(traverser);
+    rules.GetTruncated(blockTruncated[b], begin);
+
+    arma::Mat<size_t> blockNeighbors;
+    arma::mat blockDistances;
+    rules.GetResults(blockNeighbors, blockDistances);
+    neighbors.cols(begin, end - 1) = blockNeighbors;
+    distances.cols(begin, end - 1) = blockDistances;
+  }
+
+  for (size_t b = 0; b < numBlocks; ++b)
+  {
+    searchStatistics += blockStatistics[b];
+    truncated.insert(truncated.end(), blockTruncated[b].begin(),
+        blockTruncated[b].end());
+  }
+
+  Log::Info << totalScores << " node combinations were scored." << std::endl;
+  Log::Info << totalBaseCases << " base cases were calculated." << std::endl;
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::MergeResults(
+    const std::vector<arma::Mat<size_t>>& threadNeighbors,
+    const std::vector<arma::mat>& threadDistances,
+    arma::Mat<size_t>& neighbors,
+    arma::mat& distances)
+{
+  // OpenMP may give us fewer threads than we asked for; any thread that did
+  // not run will have empty results, and is skipped.
+  std::vector<size_t> sources;
+  for (size_t t = 0; t < threadNeighbors.size(); ++t)
+    if (threadNeighbors[t].n_cols > 0)
+      sources.push_back(t);
+
+  const size_t k = threadNeighbors[sources[0]].n_rows;
+  const size_t n = threadNeighbors[sources[0]].n_cols;
+  const size_t invalid = size_t() - 1;
+
+  neighbors.set_size(k, n);
+  distances.set_size(k, n);
+
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) n; ++i)
+  {
+    // Each per-thread list is sorted, so this is a simple multiway merge.
+    std::vector<size_t> position(sources.size(), 0);
+    for (size_t j = 0; j < k; ++j)
+    {
+      size_t best = sources.size();
+      for (size_t s = 0; s < sources.size(); ++s)
+      {
+        const arma::Mat<size_t>& tn = threadNeighbors[sources[s]];
+        const arma::mat& td = threadDistances[sources[s]];
+
+        // Skip any neighbors that we have already taken.
+        while (position[s] < k && tn(position[s], i) != invalid &&
+            arma::any(neighbors.col(i).head(j) == tn(position[s], i)))
+          ++position[s];
+
+        if (position[s] == k)
+          continue;
+
+        if (best == sources.size() || SortPolicy::IsBetter(td(position[s], i),
+            threadDistances[sources[best]](position[best], i)))
+          best = s;
+      }
+
+      if (best == sources.size())
+      {
+        neighbors(j, i) = invalid;
+        distances(j, i) = SortPolicy::WorstDistance();
+      }
+      else
+      {
+        neighbors(j, i) = threadNeighbors[sources[best]](position[best], i);
+        distances(j, i) = threadDistances[sources[best]](position[best], i);
+        ++position[best];
+      }
+    }
+  }
+}
+
 //! Calculate the average relative error.
 template<typename SortPolicy,
          typename MetricType,
@@ -995,6 +1885,9 @@ DualTreeTraversalType, SingleTreeTraversalType>::serialize(
   {
     baseCases = 0;
     scores = 0;
+    statistics.Reset();
+    changes = 0;
+    cache.Clear();
   }
 }
 
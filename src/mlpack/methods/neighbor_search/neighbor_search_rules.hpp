@@ -14,6 +14,9 @@
 #define MLPACK_METHODS_NEIGHBOR_SEARCH_NEIGHBOR_SEARCH_RULES_HPP
 
 #include <mlpack/core/tree/traversal_info.hpp>
+#include <mlpack/core/tree/rule_traits.hpp>
+#include <mlpack/core/tree/hrectbound.hpp>
+#include "neighbor_search_stat.hpp"
 
 #include <queue>
 
@@ -25,7 +28,8 @@ namespace neighbor {
  * NeighborSearch class when performing distance-based neighbor searches.  For
  * each point in the query dataset, it keeps track of the k neighbors in the
  * reference dataset which have the 'best' distance according to a given sorting
- * policy.
+ * policy.  The distances of the candidates are stored with the element type of
+ * the datasets (see StoredDistance), and are returned in double precision.
  *
  * @tparam SortPolicy The sort policy for distances.
  * @tparam MetricType The metric to use for computation.
@@ -63,6 +67,32 @@ class NeighborSearchRules
    */
   void GetResults(arma::Mat<size_t>& neighbors, arma::mat& distances);
 
+  /**
+   * Return a new rules object for the same search, with no candidates, so
+   * that another thread can search a disjoint part of the query tree.
+   */
+  NeighborSearchRules Split() const;
+
+  /**
+   * Add the candidates and the counters of the given rules object (returned
+   * by Split()) to these rules.
+   *
+   * @param shard Rules object to merge.
+   */
+  void Merge(const NeighborSearchRules& shard);
+
+  /**
+   * Return a new rules object for the same search, with the given metric and
+   * counters of its own, that uses the candidate lists of these rules.  This
+   * lets threads search disjoint parts of the query tree while the candidates
+   * of each query point are kept only once; the query tree must not hold any
+   * point in two nodes (TreeTraits::UniqueNumDescendants).  These rules must
+   * outlive the returned rules, and hold the results.
+   *
+   * @param metric Instantiated metric for the new rules.
+   */
+  NeighborSearchRules Share(MetricType& metric);
+
   /**
    * Get the distance from the query point to the reference point.
    * This will update the list of candidates with the new point if appropriate
@@ -73,6 +103,27 @@ class NeighborSearchRules
    */
   double BaseCase(const size_t queryIndex, const size_t referenceIndex);
 
+  /**
+   * Compute the base cases between every point of a query leaf and every point
+   * of a reference leaf at once.  Query points whose candidate lists cannot be
+   * improved by the reference node (according to Score()) are skipped.  The
+   * distances for the remaining points are computed as one block: with a
+   * single matrix multiplication (using ||q||^2 + ||r||^2 - 2 q^T r) for the
+   * Euclidean distance, with the batched LMetric::Evaluate() for other
+   * L-metrics, and pair by pair otherwise.  Points that improve a candidate
+   * list under the matrix multiplication are re-evaluated exactly before they
+   * are inserted, so the results are the same as with BaseCase().
+   *
+   * The points held by each node must be stored contiguously in the dataset
+   * (as for the BinarySpaceTree).  Traversers only call this when
+   * BlockBaseCases() is true.
+   *
+   * @param queryNode Query leaf.
+   * @param referenceNode Reference leaf.
+   * @return Number of query/reference pairs that were evaluated.
+   */
+  size_t LeafBaseCases(TreeType& queryNode, TreeType& referenceNode);
+
   /**
    * Get the score for recursion order.  A low score indicates priority for
    * recursion, while DBL_MAX indicates that the node should not be recursed
@@ -149,6 +200,24 @@ class NeighborSearchRules
   //! Modify the number of scores that have been performed.
   size_t& Scores() { return scores; }
 
+  //! Get the number of node combinations pruned with the bound derived from
+  //! the traversal information (without computing a node-to-node distance).
+  size_t TraversalInfoPrunes() const { return traversalInfoPrunes; }
+  //! Get the number of node combinations pruned after computing the bound
+  //! distance.
+  size_t BoundPrunes() const { return boundPrunes; }
+  //! Get the number of reference leaves that were scored and not pruned.
+  size_t ReferenceLeaves() const { return referenceLeaves; }
+  //! Get the total number of points in the reference leaves that were scored
+  //! and not pruned.
+  size_t ReferenceLeafPoints() const { return referenceLeafPoints; }
+
+  //! Get whether traversers should evaluate leaf pairs with LeafBaseCases().
+  bool BlockBaseCases() const { return blockBaseCases; }
+  //! Modify whether traversers should evaluate leaf pairs with
+  //! LeafBaseCases().
+  bool& BlockBaseCases() { return blockBaseCases; }
+
   //! Convenience typedef.
   typedef typename tree::TraversalInfo<TreeType> TraversalInfoType;
 
@@ -161,6 +230,26 @@ class NeighborSearchRules
   //! results.  This is only needed in defeatist search mode.
   size_t MinimumBaseCases() const { return k; }
 
+  //! Get the maximum number of base cases per query point (0 means no limit).
+  size_t MaxBaseCases() const { return maxBaseCases; }
+  //! Modify the maximum number of base cases per query point (0 means no
+  //! limit).  Once a query point has used its budget, BaseCase() does not
+  //! compute any more distances for it and Score() prunes every node, so the
+  //! candidates found so far are returned.  In dual-tree search the blocks of
+  //! LeafBaseCases() are not limited.
+  size_t& MaxBaseCases() { return maxBaseCases; }
+
+  /**
+   * Append to the given list the indices (plus the given offset) of the query
+   * points whose budget of base cases ran out before the search was done;
+   * their results are approximate.
+   *
+   * @param queries List of query points to append to.
+   * @param offset Offset added to each index.
+   */
+  void GetTruncated(std::vector<size_t>& queries,
+                    const size_t offset = 0) const;
+
  protected:
   //! The reference set.
   const typename TreeType::Mat& referenceSet;
@@ -168,8 +257,13 @@ class NeighborSearchRules
   //! The query set.
   const typename TreeType::Mat& querySet;
 
+  //! The element type of the datasets, in which candidate distances are kept.
+  typedef typename TreeType::Mat::elem_type ElemType;
+  //! Conversion of distances to and from ElemType.
+  typedef StoredDistance<SortPolicy, ElemType> Distance;
+
   //! Candidate represents a possible candidate neighbor (distance, index).
-  typedef std::pair<double, size_t> Candidate;
+  typedef std::pair<ElemType, size_t> Candidate;
 
   //! Compare two candidates based on the distance.
   struct CandidateCmp {
@@ -185,6 +279,9 @@ class NeighborSearchRules
 
   //! Set of candidate neighbors for each point.
   std::vector<CandidateList> candidates;
+  //! The rules whose candidates are used instead, for rules returned by
+  //! Share(); NULL otherwise.
+  NeighborSearchRules* owner;
 
   //! Number of neighbors to search for.
   const size_t k;
@@ -210,10 +307,55 @@ class NeighborSearchRules
   //! The number of scores that have been performed.
   size_t scores;
 
+  //! The number of prunes made with the traversal information.
+  size_t traversalInfoPrunes;
+  //! The number of prunes made with the bound distance.
+  size_t boundPrunes;
+  //! The number of reference leaves that were not pruned.
+  size_t referenceLeaves;
+  //! The number of points in the reference leaves that were not pruned.
+  size_t referenceLeafPoints;
+
+  //! If true, leaf pairs are evaluated as blocks with LeafBaseCases().
+  bool blockBaseCases;
+
   //! Traversal info for the parent combination; this is updated by the
   //! traversal before each call to Score().
   TraversalInfoType traversalInfo;
 
+  //! The maximum number of base cases per query point (0 means no limit).
+  size_t maxBaseCases;
+  //! The number of base cases of each query point, when there is a budget.
+  std::vector<size_t> queryBaseCases;
+  //! Whether each query point ran out of budget, when there is a budget.
+  std::vector<bool> truncated;
+
+  /**
+   * Create rules for the same search as the given rules, with the given metric,
+   * that use the candidate lists of the given rules.  This is used by Share().
+   */
+  NeighborSearchRules(NeighborSearchRules& other, MetricType& metric);
+
+  //! Get the candidate list of the given query point.
+  CandidateList& Candidates(const size_t queryIndex)
+  {
+    return (owner == NULL) ? candidates[queryIndex] :
+        owner->candidates[queryIndex];
+  }
+
+  //! Get the candidate list of the given query point.
+  const CandidateList& Candidates(const size_t queryIndex) const
+  {
+    return (owner == NULL) ? candidates[queryIndex] :
+        owner->candidates[queryIndex];
+  }
+
+  /**
+   * Return whether the given query point has used its budget of base cases,
+   * and if so, mark it as truncated.
+   */
+  bool OverBudget(const size_t queryIndex);
+
   /**
    * Recalculate the bound for a given query node.
    */
@@ -229,9 +371,56 @@ class NeighborSearchRules
   void InsertNeighbor(const size_t queryIndex,
                       const size_t neighbor,
                       const double distance);
+
+  /**
+   * Compute the distances between the given query points and the given
+   * contiguous reference points with one matrix multiplication (for dense
+   * datasets and the Euclidean distance).  The distances may be off by a
+   * rounding error; a bound on that error is returned.
+   */
+  template<typename RefBlockType>
+  double ComputeBlock(const arma::uvec& queries,
+                    const RefBlockType& refBlock,
+                    arma::mat& distances,
+                    const std::integral_constant<int, 2>& /* gemm */);
+
+  /**
+   * Compute the distances between the given query points and the given
+   * contiguous reference points with LMetric::Evaluate() on whole blocks (for
+   * dense datasets and L-metrics).  The distances are exact, so 0 is returned.
+   */
+  template<typename RefBlockType>
+  double ComputeBlock(const arma::uvec& queries,
+                    const RefBlockType& refBlock,
+                    arma::mat& distances,
+                    const std::integral_constant<int, 1>& /* batched */);
+
+  /**
+   * Compute the distances between the given query points and the given
+   * contiguous reference points one pair at a time.  The distances are
+   * exact, so 0 is returned.
+   */
+  template<typename RefBlockType>
+  double ComputeBlock(const arma::uvec& queries,
+                    const RefBlockType& refBlock,
+                    arma::mat& distances,
+                    const std::integral_constant<int, 0>& /* pairwise */);
 };
 
 } // namespace neighbor
+
+namespace tree {
+
+//! NeighborSearchRules can be split between threads.
+template<typename SortPolicy, typename MetricType, typename TreeType>
+class RuleTraits<neighbor::NeighborSearchRules<SortPolicy, MetricType,
+    TreeType>>
+{
+ public:
+  static const bool IsSplittable = true;
+};
+
+} // namespace tree
 } // namespace mlpack
 
 // Include implementation.
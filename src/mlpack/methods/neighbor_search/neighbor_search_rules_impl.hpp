@@ -29,6 +29,7 @@ NeighborSearchRules<SortPolicy, MetricType, TreeType>::NeighborSearchRules(
     const bool sameSet) :
     referenceSet(referenceSet),
     querySet(querySet),
+    owner(NULL),
     k(k),
     metric(metric),
     sameSet(sameSet),
@@ -36,7 +37,13 @@ NeighborSearchRules<SortPolicy, MetricType, TreeType>::NeighborSearchRules(
     lastQueryIndex(querySet.n_cols),
     lastReferenceIndex(referenceSet.n_cols),
     baseCases(0),
-    scores(0)
+    scores(0),
+    traversalInfoPrunes(0),
+    boundPrunes(0),
+    referenceLeaves(0),
+    referenceLeafPoints(0),
+    blockBaseCases(false),
+    maxBaseCases(0)
 {
   // We must set the traversal info last query and reference node pointers to
   // something that is both invalid (i.e. not a tree node) and not NULL.  We'll
@@ -48,8 +55,8 @@ NeighborSearchRules<SortPolicy, MetricType, TreeType>::NeighborSearchRules(
   // It will be initialized with k candidates: (WorstDistance, size_t() - 1)
   // The list of candidates will be updated when visiting new points with the
   // BaseCase() method.
-  const Candidate def = std::make_pair(SortPolicy::WorstDistance(),
-      size_t() - 1);
+  const Candidate def = std::make_pair(
+      Distance::Store(SortPolicy::WorstDistance()), size_t() - 1);
 
   std::vector<Candidate> vect(k, def);
   CandidateList pqueue(CandidateCmp(), std::move(vect));
@@ -59,6 +66,34 @@ NeighborSearchRules<SortPolicy, MetricType, TreeType>::NeighborSearchRules(
     candidates.push_back(pqueue);
 }
 
+template<typename SortPolicy, typename MetricType, typename TreeType>
+NeighborSearchRules<SortPolicy, MetricType, TreeType>::NeighborSearchRules(
+    NeighborSearchRules& other,
+    MetricType& metric) :
+    referenceSet(other.referenceSet),
+    querySet(other.querySet),
+    owner(&other),
+    k(other.k),
+    metric(metric),
+    sameSet(other.sameSet),
+    epsilon(other.epsilon),
+    lastQueryIndex(querySet.n_cols),
+    lastReferenceIndex(referenceSet.n_cols),
+    baseCases(0),
+    scores(0),
+    traversalInfoPrunes(0),
+    boundPrunes(0),
+    referenceLeaves(0),
+    referenceLeafPoints(0),
+    blockBaseCases(other.blockBaseCases),
+    maxBaseCases(other.maxBaseCases)
+{
+  // These rules have no candidate lists of their own; they use those of the
+  // other rules.
+  traversalInfo.LastQueryNode() = (TreeType*) this;
+  traversalInfo.LastReferenceNode() = (TreeType*) this;
+}
+
 template<typename SortPolicy, typename MetricType, typename TreeType>
 void NeighborSearchRules<SortPolicy, MetricType, TreeType>::GetResults(
     arma::Mat<size_t>& neighbors,
@@ -69,16 +104,105 @@ void NeighborSearchRules<SortPolicy, MetricType, TreeType>::GetResults(
 
   for (size_t i = 0; i < querySet.n_cols; ++i)
   {
-    CandidateList& pqueue = candidates[i];
+    CandidateList& pqueue = Candidates(i);
     for (size_t j = 1; j <= k; ++j)
     {
       neighbors(k - j, i) = pqueue.top().second;
-      distances(k - j, i) = pqueue.top().first;
+      distances(k - j, i) = Distance::Load(pqueue.top().first);
       pqueue.pop();
     }
   }
 };
 
+template<typename SortPolicy, typename MetricType, typename TreeType>
+NeighborSearchRules<SortPolicy, MetricType, TreeType>
+NeighborSearchRules<SortPolicy, MetricType, TreeType>::Split() const
+{
+  NeighborSearchRules shard(referenceSet, querySet, k, metric, epsilon,
+      sameSet);
+  shard.blockBaseCases = blockBaseCases;
+  shard.maxBaseCases = maxBaseCases;
+  return shard;
+}
+
+template<typename SortPolicy, typename MetricType, typename TreeType>
+NeighborSearchRules<SortPolicy, MetricType, TreeType>
+NeighborSearchRules<SortPolicy, MetricType, TreeType>::Share(
+    MetricType& metric)
+{
+  return NeighborSearchRules((owner == NULL) ? *this : *owner, metric);
+}
+
+template<typename SortPolicy, typename MetricType, typename TreeType>
+void NeighborSearchRules<SortPolicy, MetricType, TreeType>::Merge(
+    const NeighborSearchRules& shard)
+{
+  for (size_t i = 0; i < querySet.n_cols; ++i)
+  {
+    // Only the candidates that were actually found are inserted.
+    CandidateList pqueue = shard.Candidates(i);
+    while (!pqueue.empty())
+    {
+      if (pqueue.top().second != size_t() - 1)
+      {
+        InsertNeighbor(i, pqueue.top().second,
+            Distance::Load(pqueue.top().first));
+      }
+      pqueue.pop();
+    }
+  }
+
+  baseCases += shard.baseCases;
+  scores += shard.scores;
+  traversalInfoPrunes += shard.traversalInfoPrunes;
+  boundPrunes += shard.boundPrunes;
+  referenceLeaves += shard.referenceLeaves;
+  referenceLeafPoints += shard.referenceLeafPoints;
+
+  if (!shard.queryBaseCases.empty())
+  {
+    if (queryBaseCases.empty())
+    {
+      queryBaseCases.resize(querySet.n_cols, 0);
+      truncated.resize(querySet.n_cols, false);
+    }
+
+    for (size_t i = 0; i < querySet.n_cols; ++i)
+    {
+      queryBaseCases[i] += shard.queryBaseCases[i];
+      truncated[i] = truncated[i] || shard.truncated[i];
+    }
+  }
+}
+
+template<typename SortPolicy, typename MetricType, typename TreeType>
+void NeighborSearchRules<SortPolicy, MetricType, TreeType>::GetTruncated(
+    std::vector<size_t>& queries,
+    const size_t offset) const
+{
+  for (size_t i = 0; i < truncated.size(); ++i)
+    if (truncated[i])
+      queries.push_back(i + offset);
+}
+
+template<typename SortPolicy, typename MetricType, typename TreeType>
+inline bool NeighborSearchRules<SortPolicy, MetricType, TreeType>::OverBudget(
+    const size_t queryIndex)
+{
+  // The counts are only allocated when a budget is used.
+  if (queryBaseCases.empty())
+  {
+    queryBaseCases.resize(querySet.n_cols, 0);
+    truncated.resize(querySet.n_cols, false);
+  }
+
+  if (queryBaseCases[queryIndex] < maxBaseCases)
+    return false;
+
+  truncated[queryIndex] = true;
+  return true;
+}
+
 template<typename SortPolicy, typename MetricType, typename TreeType>
 inline force_inline // Absolutely MUST be inline so optimizations can happen.
 double NeighborSearchRules<SortPolicy, MetricType, TreeType>::
@@ -93,6 +217,15 @@ BaseCase(const size_t queryIndex, const size_t referenceIndex)
   if ((lastQueryIndex == queryIndex) && (lastReferenceIndex == referenceIndex))
     return lastBaseCase;
 
+  // Once the budget of the query point is spent, no more distances are
+  // computed for it.
+  if (maxBaseCases != 0)
+  {
+    if (OverBudget(queryIndex))
+      return SortPolicy::WorstDistance();
+    ++queryBaseCases[queryIndex];
+  }
+
   double distance = metric.Evaluate(querySet.col(queryIndex),
                                     referenceSet.col(referenceIndex));
   ++baseCases;
@@ -107,6 +240,150 @@ BaseCase(const size_t queryIndex, const size_t referenceIndex)
   return distance;
 }
 
+template<typename SortPolicy, typename MetricType, typename TreeType>
+size_t NeighborSearchRules<SortPolicy, MetricType, TreeType>::LeafBaseCases(
+    TreeType& queryNode,
+    TreeType& referenceNode)
+{
+  typedef typename TreeType::Mat MatType;
+  typedef typename MatType::elem_type ElemType;
+
+  // Pick the way the block is computed at compile time: 2 means a matrix
+  // multiplication, 1 means the batched LMetric, and 0 means pair by pair.
+  const bool dense = std::is_same<MatType, arma::Mat<ElemType>>::value;
+  const bool lmetric = bound::meta::IsLMetric<MetricType>::Value;
+  const bool euclidean =
+      std::is_same<MetricType, metric::EuclideanDistance>::value ||
+      std::is_same<MetricType, metric::SquaredEuclideanDistance>::value;
+  typedef std::integral_constant<int, (!dense) ? 0 :
+      (euclidean ? 2 : (lmetric ? 1 : 0))> BlockType;
+
+  // Collect the query points that the reference node may improve.
+  arma::uvec queries(queryNode.NumPoints());
+  size_t numQueries = 0;
+  for (size_t i = 0; i < queryNode.NumPoints(); ++i)
+  {
+    const size_t queryIndex = queryNode.Point(i);
+    if (Score(queryIndex, referenceNode) != DBL_MAX)
+      queries[numQueries++] = queryIndex;
+  }
+
+  const size_t numReferences = referenceNode.NumPoints();
+  if (numQueries == 0 || numReferences == 0)
+    return 0;
+  queries.resize(numQueries);
+
+  const size_t refBegin = referenceNode.Point(0);
+  arma::mat distances;
+  const double tolerance = ComputeBlock(queries, referenceSet.cols(refBegin,
+      refBegin + numReferences - 1), distances, BlockType());
+  for (size_t i = 0; i < numQueries; ++i)
+  {
+    const size_t queryIndex = queries[i];
+    for (size_t j = 0; j < numReferences; ++j)
+    {
+      const size_t referenceIndex = refBegin + j;
+      if (sameSet && (queryIndex == referenceIndex))
+        continue;
+
+      ++baseCases;
+      double distance = distances(j, i);
+      if (tolerance > 0.0)
+      {
+        // The distance is only approximate; skip the point if it can't be a
+        // candidate even with the largest possible rounding error, and
+        // otherwise compute the exact distance.
+        if (!SortPolicy::IsBetter(SortPolicy::CombineBest(distance, tolerance),
+            Distance::Load(Candidates(queryIndex).top().first)))
+          continue;
+
+        distance = metric.Evaluate(querySet.col(queryIndex),
+            referenceSet.col(referenceIndex));
+      }
+
+      InsertNeighbor(queryIndex, referenceIndex, distance);
+    }
+  }
+
+  return numQueries * numReferences;
+}
+
+template<typename SortPolicy, typename MetricType, typename TreeType>
+template<typename RefBlockType>
+double NeighborSearchRules<SortPolicy, MetricType, TreeType>::ComputeBlock(
+    const arma::uvec& queries,
+    const RefBlockType& refBlock,
+    arma::mat& distances,
+    const std::integral_constant<int, 2>& /* gemm */)
+{
+  typedef typename TreeType::Mat::elem_type ElemType;
+
+  // d(q, r)^2 = ||q||^2 + ||r||^2 - 2 q^T r, for all pairs at once.
+  const arma::Mat<ElemType> queryBlock = querySet.cols(queries);
+  const arma::Row<ElemType> queryNorms = arma::sum(arma::square(queryBlock), 0);
+  const arma::Row<ElemType> refNorms = arma::sum(arma::square(refBlock), 0);
+
+  arma::Mat<ElemType> block = -2 * refBlock.t() * queryBlock;
+  block.each_col() += refNorms.t();
+  block.each_row() += queryNorms;
+
+  // Rounding may make some distances slightly negative.
+  distances = arma::conv_to<arma::mat>::from(arma::clamp(block, 0,
+      std::numeric_limits<ElemType>::max()));
+
+  // Bound the rounding error of the squared distances; it grows with the norms
+  // of the points and with the dimensionality.
+  double tolerance = 4.0 * (refBlock.n_rows + 2) *
+      std::numeric_limits<ElemType>::epsilon() * ((double) queryNorms.max() +
+      (double) refNorms.max());
+  if (MetricType::TakeRoot)
+  {
+    // sqrt(d^2 + e) - sqrt(d^2) <= sqrt(e).
+    distances = arma::sqrt(distances);
+    tolerance = std::sqrt(tolerance);
+  }
+
+  return tolerance;
+}
+
+template<typename SortPolicy, typename MetricType, typename TreeType>
+template<typename RefBlockType>
+double NeighborSearchRules<SortPolicy, MetricType, TreeType>::ComputeBlock(
+    const arma::uvec& queries,
+    const RefBlockType& refBlock,
+    arma::mat& distances,
+    const std::integral_constant<int, 1>& /* batched */)
+{
+  typedef typename TreeType::Mat::elem_type ElemType;
+
+  distances.set_size(refBlock.n_cols, queries.n_elem);
+  arma::Col<ElemType> queryDistances;
+  for (size_t i = 0; i < queries.n_elem; ++i)
+  {
+    metric.Evaluate(querySet.col(queries[i]), refBlock, queryDistances);
+    distances.col(i) = arma::conv_to<arma::vec>::from(queryDistances);
+  }
+
+  return 0.0;
+}
+
+template<typename SortPolicy, typename MetricType, typename TreeType>
+template<typename RefBlockType>
+double NeighborSearchRules<SortPolicy, MetricType, TreeType>::ComputeBlock(
+    const arma::uvec& queries,
+    const RefBlockType& refBlock,
+    arma::mat& distances,
+    const std::integral_constant<int, 0>& /* pairwise */)
+{
+  distances.set_size(refBlock.n_cols, queries.n_elem);
+  for (size_t i = 0; i < queries.n_elem; ++i)
+    for (size_t j = 0; j < refBlock.n_cols; ++j)
+      distances(j, i) = metric.Evaluate(querySet.col(queries[i]),
+          refBlock.col(j));
+
+  return 0.0;
+}
+
 template<typename SortPolicy, typename MetricType, typename TreeType>
 inline double NeighborSearchRules<SortPolicy, MetricType, TreeType>::Score(
     const size_t queryIndex,
@@ -129,7 +406,8 @@ inline double NeighborSearchRules<SortPolicy, MetricType, TreeType>::Score(
       else
         baseCase = BaseCase(queryIndex, referenceNode.Point(0));
 
-      // Save this evaluation.
+      // Save this evaluation.  The base case was computed on the dataset, so
+      // it is exact in its element type.
       referenceNode.Stat().LastDistance() = baseCase;
     }
 
@@ -143,11 +421,27 @@ inline double NeighborSearchRules<SortPolicy, MetricType, TreeType>::Score(
   }
 
   // Compare against the best k'th distance for this query point so far.
-  double bestDistance = candidates[queryIndex].top().first;
+  double bestDistance = Distance::Load(Candidates(queryIndex).top().first);
   bestDistance = SortPolicy::Relax(bestDistance, epsilon);
 
-  return (SortPolicy::IsBetter(distance, bestDistance)) ?
-      SortPolicy::ConvertToScore(distance) : DBL_MAX;
+  if (!SortPolicy::IsBetter(distance, bestDistance))
+  {
+    ++boundPrunes;
+    return DBL_MAX;
+  }
+
+  // The node can't be pruned, but the query point has no budget left to visit
+  // it.
+  if (maxBaseCases != 0 && OverBudget(queryIndex))
+    return DBL_MAX;
+
+  if (referenceNode.IsLeaf())
+  {
+    ++referenceLeaves;
+    referenceLeafPoints += referenceNode.NumPoints();
+  }
+
+  return SortPolicy::ConvertToScore(distance);
 }
 
 template<typename SortPolicy, typename MetricType, typename TreeType>
@@ -179,7 +473,7 @@ inline double NeighborSearchRules<SortPolicy, MetricType, TreeType>::Rescore(
   const double distance = SortPolicy::ConvertToDistance(oldScore);
 
   // Just check the score again against the distances.
-  double bestDistance = candidates[queryIndex].top().first;
+  double bestDistance = Distance::Load(Candidates(queryIndex).top().first);
   bestDistance = SortPolicy::Relax(bestDistance, epsilon);
 
   return (SortPolicy::IsBetter(distance, bestDistance)) ? oldScore : DBL_MAX;
@@ -290,6 +584,7 @@ inline double NeighborSearchRules<SortPolicy, MetricType, TreeType>::Score(
       // There isn't any need to set the traversal information because no
       // descendant combinations will be visited, and those are the only
       // combinations that would depend on the traversal information.
+      ++traversalInfoPrunes;
       return DBL_MAX;
     }
   }
@@ -335,6 +630,12 @@ inline double NeighborSearchRules<SortPolicy, MetricType, TreeType>::Score(
     traversalInfo.LastReferenceNode() = &referenceNode;
     traversalInfo.LastScore() = distance;
 
+    if (referenceNode.IsLeaf())
+    {
+      ++referenceLeaves;
+      referenceLeafPoints += referenceNode.NumPoints();
+    }
+
     return SortPolicy::ConvertToScore(distance);
   }
   else
@@ -342,6 +643,7 @@ inline double NeighborSearchRules<SortPolicy, MetricType, TreeType>::Score(
     // There isn't any need to set the traversal information because no
     // descendant combinations will be visited, and those are the only
     // combinations that would depend on the traversal information.
+    ++boundPrunes;
     return DBL_MAX;
   }
 }
@@ -404,7 +706,8 @@ inline double NeighborSearchRules<SortPolicy, MetricType, TreeType>::
   // Loop over points held in the node.
   for (size_t i = 0; i < queryNode.NumPoints(); ++i)
   {
-    const double distance = candidates[queryNode.Point(i)].top().first;
+    const double distance =
+        Distance::Load(Candidates(queryNode.Point(i)).top().first);
     if (SortPolicy::IsBetter(worstDistance, distance))
       worstDistance = distance;
     if (SortPolicy::IsBetter(distance, bestPointDistance))
@@ -417,8 +720,10 @@ inline double NeighborSearchRules<SortPolicy, MetricType, TreeType>::
   // assemble bounds.
   for (size_t i = 0; i < queryNode.NumChildren(); ++i)
   {
-    const double firstBound = queryNode.Child(i).Stat().FirstBound();
-    const double auxBound = queryNode.Child(i).Stat().AuxBound();
+    const double firstBound =
+        Distance::Load(queryNode.Child(i).Stat().FirstBound());
+    const double auxBound =
+        Distance::Load(queryNode.Child(i).Stat().AuxBound());
 
     if (SortPolicy::IsBetter(worstDistance, firstBound))
       worstDistance = firstBound;
@@ -450,28 +755,33 @@ inline double NeighborSearchRules<SortPolicy, MetricType, TreeType>::
     // The parent's worst distance bound implies that the bound for this node
     // must be at least as good.  Thus, if the parent worst distance bound is
     // better, then take it.
-    if (SortPolicy::IsBetter(queryNode.Parent()->Stat().FirstBound(),
-        worstDistance))
-      worstDistance = queryNode.Parent()->Stat().FirstBound();
+    const double parentFirstBound =
+        Distance::Load(queryNode.Parent()->Stat().FirstBound());
+    if (SortPolicy::IsBetter(parentFirstBound, worstDistance))
+      worstDistance = parentFirstBound;
 
     // The parent's best distance bound implies that the bound for this node
     // must be at least as good.  Thus, if the parent best distance bound is
     // better, then take it.
-    if (SortPolicy::IsBetter(queryNode.Parent()->Stat().SecondBound(),
-        bestDistance))
-      bestDistance = queryNode.Parent()->Stat().SecondBound();
+    const double parentSecondBound =
+        Distance::Load(queryNode.Parent()->Stat().SecondBound());
+    if (SortPolicy::IsBetter(parentSecondBound, bestDistance))
+      bestDistance = parentSecondBound;
   }
 
   // Could the existing bounds be better?
-  if (SortPolicy::IsBetter(queryNode.Stat().FirstBound(), worstDistance))
-    worstDistance = queryNode.Stat().FirstBound();
-  if (SortPolicy::IsBetter(queryNode.Stat().SecondBound(), bestDistance))
-    bestDistance = queryNode.Stat().SecondBound();
-
-  // Cache bounds for later.
-  queryNode.Stat().FirstBound() = worstDistance;
-  queryNode.Stat().SecondBound() = bestDistance;
-  queryNode.Stat().AuxBound() = auxDistance;
+  const double firstBound = Distance::Load(queryNode.Stat().FirstBound());
+  const double secondBound = Distance::Load(queryNode.Stat().SecondBound());
+  if (SortPolicy::IsBetter(firstBound, worstDistance))
+    worstDistance = firstBound;
+  if (SortPolicy::IsBetter(secondBound, bestDistance))
+    bestDistance = secondBound;
+
+  // Cache bounds for later.  The stored bounds may be rounded (towards the
+  // worst distance) to the element type of the dataset.
+  queryNode.Stat().FirstBound() = Distance::Store(worstDistance);
+  queryNode.Stat().SecondBound() = Distance::Store(bestDistance);
+  queryNode.Stat().AuxBound() = Distance::Store(auxDistance);
 
   worstDistance = SortPolicy::Relax(worstDistance, epsilon);
 
@@ -499,8 +809,8 @@ InsertNeighbor(
     const size_t neighbor,
     const double distance)
 {
-  CandidateList& pqueue = candidates[queryIndex];
-  Candidate c = std::make_pair(distance, neighbor);
+  CandidateList& pqueue = Candidates(queryIndex);
+  Candidate c = std::make_pair(Distance::Store(distance), neighbor);
 
   if (CandidateCmp()(c, pqueue.top()))
   {
@@ -19,26 +19,86 @@ namespace mlpack {
 namespace neighbor {
 
 /**
- * Extra data for each node in the tree.  For neighbor searches, each node only
- * needs to store a bound on neighbor distances.
+ * StoredDistance converts distances between double precision, in which the
+ * sort policies compute them, and the element type of the dataset, in which
+ * the candidates of NeighborSearchRules and the bounds of NeighborSearchStat
+ * are stored.  A distance that can't be represented exactly is rounded
+ * towards the worst distance, so that a stored bound is never tighter than
+ * the true one and nothing is pruned that shouldn't be; the maximum value of
+ * the element type stands for DBL_MAX.
+ *
+ * @tparam SortPolicy The sort policy for distances.
+ * @tparam ElemType Type of the stored distances.
  */
+template<typename SortPolicy, typename ElemType>
+struct StoredDistance
+{
+  //! Convert the given distance to ElemType, rounding towards the worst
+  //! distance.
+  static ElemType Store(const double distance)
+  {
+    const ElemType maxValue = std::numeric_limits<ElemType>::max();
+    if (distance >= (double) maxValue)
+      return maxValue;
+    if (distance <= (double) std::numeric_limits<ElemType>::lowest())
+      return std::numeric_limits<ElemType>::lowest();
+
+    ElemType stored = (ElemType) distance;
+    if ((double) stored != distance &&
+        SortPolicy::IsBetter((double) stored, distance))
+    {
+      // Smaller distances are better for a policy that prefers 0 to 1.
+      stored = std::nextafter(stored, SortPolicy::IsBetter(0.0, 1.0) ?
+          maxValue : std::numeric_limits<ElemType>::lowest());
+    }
+    return stored;
+  }
+
+  //! Convert the given stored distance back to double precision.
+  static double Load(const ElemType distance)
+  {
+    return (distance == std::numeric_limits<ElemType>::max()) ? DBL_MAX :
+        (double) distance;
+  }
+};
+
+//! Distances are computed in double precision, so no conversion is needed.
 template<typename SortPolicy>
+struct StoredDistance<SortPolicy, double>
+{
+  static double Store(const double distance) { return distance; }
+  static double Load(const double distance) { return distance; }
+};
+
+/**
+ * Extra data for each node in the tree.  For neighbor searches, each node only
+ * needs to store a bound on neighbor distances.  The bounds are stored with the
+ * given element type (see StoredDistance), so that the statistics of a tree
+ * built on single-precision data take half the memory.
+ *
+ * @tparam SortPolicy The sort policy for distances.
+ * @tparam ElemType Type of the stored bounds.
+ */
+template<typename SortPolicy, typename ElemType = double>
 class NeighborSearchStat
 {
  private:
+  //! Conversion of the worst distance to ElemType.
+  typedef StoredDistance<SortPolicy, ElemType> Distance;
+
   //! The first bound on the node's neighbor distances (B_1).  This represents
   //! the worst candidate distance of any descendants of this node.
-  double firstBound;
+  ElemType firstBound;
   //! The second bound on the node's neighbor distances (B_2).  This represents
   //! a bound on the worst distance of any descendants of this node assembled
   //! using the best descendant candidate distance modified by the furthest
   //! descendant distance.
-  double secondBound;
+  ElemType secondBound;
   //! The aux bound on the node's neighbor distances (B_aux). This represents
   //! the best descendant candidate distance (used to calculate secondBound).
-  double auxBound;
+  ElemType auxBound;
   //! The last distance evaluation.
-  double lastDistance;
+  ElemType lastDistance;
 
  public:
   /**
@@ -46,9 +106,9 @@ class NeighborSearchStat
    * our sorting policy.
    */
   NeighborSearchStat() :
-      firstBound(SortPolicy::WorstDistance()),
-      secondBound(SortPolicy::WorstDistance()),
-      auxBound(SortPolicy::WorstDistance()),
+      firstBound(Distance::Store(SortPolicy::WorstDistance())),
+      secondBound(Distance::Store(SortPolicy::WorstDistance())),
+      auxBound(Distance::Store(SortPolicy::WorstDistance())),
       lastDistance(0.0) { }
 
   /**
@@ -57,9 +117,9 @@ class NeighborSearchStat
    */
   template<typename TreeType>
   NeighborSearchStat(TreeType& /* node */) :
-      firstBound(SortPolicy::WorstDistance()),
-      secondBound(SortPolicy::WorstDistance()),
-      auxBound(SortPolicy::WorstDistance()),
+      firstBound(Distance::Store(SortPolicy::WorstDistance())),
+      secondBound(Distance::Store(SortPolicy::WorstDistance())),
+      auxBound(Distance::Store(SortPolicy::WorstDistance())),
       lastDistance(0.0) { }
 
   /**
@@ -67,28 +127,28 @@ class NeighborSearchStat
    */
   void Reset()
   {
-    firstBound = SortPolicy::WorstDistance();
-    secondBound = SortPolicy::WorstDistance();
-    auxBound = SortPolicy::WorstDistance();
+    firstBound = Distance::Store(SortPolicy::WorstDistance());
+    secondBound = Distance::Store(SortPolicy::WorstDistance());
+    auxBound = Distance::Store(SortPolicy::WorstDistance());
     lastDistance = 0.0;
   }
 
   //! Get the first bound.
-  double FirstBound() const { return firstBound; }
+  ElemType FirstBound() const { return firstBound; }
   //! Modify the first bound.
-  double& FirstBound() { return firstBound; }
+  ElemType& FirstBound() { return firstBound; }
   //! Get the second bound.
-  double SecondBound() const { return secondBound; }
+  ElemType SecondBound() const { return secondBound; }
   //! Modify the second bound.
-  double& SecondBound() { return secondBound; }
+  ElemType& SecondBound() { return secondBound; }
   //! Get the aux bound.
-  double AuxBound() const { return auxBound; }
+  ElemType AuxBound() const { return auxBound; }
   //! Modify the aux bound.
-  double& AuxBound() { return auxBound; }
+  ElemType& AuxBound() { return auxBound; }
   //! Get the last distance calculation.
-  double LastDistance() const { return lastDistance; }
+  ElemType LastDistance() const { return lastDistance; }
   //! Modify the last distance calculation.
-  double& LastDistance() { return lastDistance; }
+  ElemType& LastDistance() { return lastDistance; }
 
   //! Serialize the statistic to/from an archive.
   template<typename Archive>
@@ -32,18 +32,53 @@ namespace neighbor {
 template<typename SortPolicy,
          template<typename TreeMetricType,
                   typename TreeStatType,
-                  typename TreeMatType> class TreeType>
+                  typename TreeMatType> class TreeType,
+         typename MatType = arma::mat>
 using NSType = NeighborSearch<SortPolicy,
                               metric::EuclideanDistance,
-                              arma::mat,
+                              MatType,
                               TreeType,
                               TreeType<metric::EuclideanDistance,
-                                  NeighborSearchStat<SortPolicy>,
-                                  arma::mat>::template DualTreeTraverser>;
+                                  NeighborSearchStat<SortPolicy,
+                                      typename MatType::elem_type>,
+                                  MatType>::template DualTreeTraverser>;
+
+/**
+ * SetConverter converts the double-precision sets given to NSModel to the
+ * matrix type of the NSType that holds them, and back.  No copy is made for
+ * arma::mat.
+ *
+ * @tparam MatType Matrix type of the NSType.
+ */
+template<typename MatType>
+struct SetConverter
+{
+  //! Convert the given set to MatType.
+  static MatType ToModel(const arma::mat& set)
+  {
+    return arma::conv_to<MatType>::from(set);
+  }
+
+  //! Convert the given set of the NSType back to double precision.
+  static arma::mat FromModel(const MatType& set)
+  {
+    return arma::conv_to<arma::mat>::from(set);
+  }
+};
+
+//! The sets of double-precision models are used as they are.
+template<>
+struct SetConverter<arma::mat>
+{
+  static const arma::mat& ToModel(const arma::mat& set) { return set; }
+  static arma::mat&& ToModel(arma::mat&& set) { return std::move(set); }
+  static const arma::mat& FromModel(const arma::mat& set) { return set; }
+};
 
 /**
  * MonoSearchVisitor executes a monochromatic neighbor search on the given
  * NSType. We don't make any difference for different instantiations of NSType.
+ * If a SearchStatistics object is given, the reentrant (const) search is used.
  */
 class MonoSearchVisitor : public boost::static_visitor<void>
 {
@@ -54,6 +89,8 @@ class MonoSearchVisitor : public boost::static_visitor<void>
   arma::Mat<size_t>& neighbors;
   //! Result matrix for distances.
   arma::mat& distances;
+  //! Statistics of the search, for the reentrant search (or NULL).
+  SearchStatistics* statistics;
 
  public:
   //! Perform monochromatic nearest neighbor search.
@@ -63,10 +100,12 @@ class MonoSearchVisitor : public boost::static_visitor<void>
   //! Construct the MonoSearchVisitor object with the given parameters.
   MonoSearchVisitor(const size_t k,
                     arma::Mat<size_t>& neighbors,
-                    arma::mat& distances) :
+                    arma::mat& distances,
+                    SearchStatistics* statistics = NULL) :
       k(k),
       neighbors(neighbors),
-      distances(distances)
+      distances(distances),
+      statistics(statistics)
   {};
 };
 
@@ -74,7 +113,8 @@ class MonoSearchVisitor : public boost::static_visitor<void>
  * BiSearchVisitor executes a bichromatic neighbor search on the given NSType.
  * We use template specialization to differentiate those tree types that
  * accept leafSize as a parameter. In these cases, before doing neighbor search,
- * a query tree with proper leafSize is built from the querySet.
+ * a query tree with proper leafSize is built from the querySet.  If a
+ * SearchStatistics object is given, the reentrant (const) search is used.
  */
 template<typename SortPolicy>
 class BiSearchVisitor : public boost::static_visitor<void>
@@ -94,29 +134,45 @@ class BiSearchVisitor : public boost::static_visitor<void>
   const double tau;
   //! Balance threshold (for spill trees).
   const double rho;
+  //! Statistics of the search, for the reentrant search (or NULL).
+  SearchStatistics* statistics;
 
   //! Bichromatic neighbor search on the given NSType considering the leafSize.
   template<typename NSType>
   void SearchLeaf(NSType* ns) const;
 
+  //! Search with the given query set or query tree, with the reentrant
+  //! overload if statistics were given.
+  template<typename NSType, typename QueryType>
+  void Run(NSType* ns,
+           QueryType&& query,
+           arma::Mat<size_t>& neighborsOut,
+           arma::mat& distancesOut) const;
+
  public:
   //! Alias template necessary for visual c++ compiler.
   template<template<typename TreeMetricType,
                     typename TreeStatType,
-                    typename TreeMatType> class TreeType>
-  using NSTypeT = NSType<SortPolicy, TreeType>;
+                    typename TreeMatType> class TreeType,
+           typename MatType = arma::mat>
+  using NSTypeT = NSType<SortPolicy, TreeType, MatType>;
 
   //! Default Bichromatic neighbor search on the given NSType instance.
   template<template<typename TreeMetricType,
                     typename TreeStatType,
-                    typename TreeMatType> class TreeType>
-  void operator()(NSTypeT<TreeType>* ns) const;
+                    typename TreeMatType> class TreeType,
+           typename MatType>
+  void operator()(NSTypeT<TreeType, MatType>* ns) const;
 
   //! Bichromatic neighbor search on the given NSType specialized for KDTrees.
   void operator()(NSTypeT<tree::KDTree>* ns) const;
+  //! Bichromatic neighbor search specialized for single-precision KDTrees.
+  void operator()(NSTypeT<tree::KDTree, arma::fmat>* ns) const;
 
   //! Bichromatic neighbor search on the given NSType specialized for BallTrees.
   void operator()(NSTypeT<tree::BallTree>* ns) const;
+  //! Bichromatic neighbor search specialized for single-precision BallTrees.
+  void operator()(NSTypeT<tree::BallTree, arma::fmat>* ns) const;
 
   //! Bichromatic neighbor search specialized for SPTrees.
   void operator()(SpillKNN* ns) const;
@@ -131,7 +187,8 @@ class BiSearchVisitor : public boost::static_visitor<void>
                   arma::mat& distances,
                   const size_t leafSize,
                   const double tau,
-                  const double rho);
+                  const double rho,
+                  SearchStatistics* statistics = NULL);
 };
 
 /**
@@ -161,20 +218,26 @@ class TrainVisitor : public boost::static_visitor<void>
   //! Alias template necessary for visual c++ compiler.
   template<template<typename TreeMetricType,
                     typename TreeStatType,
-                    typename TreeMatType> class TreeType>
-  using NSTypeT = NSType<SortPolicy, TreeType>;
+                    typename TreeMatType> class TreeType,
+           typename MatType = arma::mat>
+  using NSTypeT = NSType<SortPolicy, TreeType, MatType>;
 
   //! Default Train on the given NSType instance.
   template<template<typename TreeMetricType,
                     typename TreeStatType,
-                    typename TreeMatType> class TreeType>
-  void operator()(NSTypeT<TreeType>* ns) const;
+                    typename TreeMatType> class TreeType,
+           typename MatType>
+  void operator()(NSTypeT<TreeType, MatType>* ns) const;
 
   //! Train on the given NSType specialized for KDTrees.
   void operator()(NSTypeT<tree::KDTree>* ns) const;
+  //! Train specialized for single-precision KDTrees.
+  void operator()(NSTypeT<tree::KDTree, arma::fmat>* ns) const;
 
   //! Train on the given NSType specialized for BallTrees.
   void operator()(NSTypeT<tree::BallTree>* ns) const;
+  //! Train specialized for single-precision BallTrees.
+  void operator()(NSTypeT<tree::BallTree, arma::fmat>* ns) const;
 
   //! Train specialized for SPTrees.
   void operator()(SpillKNN* ns) const;
@@ -190,6 +253,86 @@ class TrainVisitor : public boost::static_visitor<void>
                const double rho);
 };
 
+/**
+ * InsertVisitor adds points to the reference set of the given NSType.  As in
+ * TrainVisitor, the tree types that accept leafSize (or tau and rho) as
+ * parameters are rebuilt with the proper parameters, since they don't support
+ * point insertion.
+ */
+template<typename SortPolicy>
+class InsertVisitor : public boost::static_visitor<void>
+{
+ private:
+  //! The points to insert.
+  const arma::mat& points;
+  //! The leaf size, used only by BinarySpaceTree.
+  size_t leafSize;
+  //! Overlapping size (for spill trees).
+  const double tau;
+  //! Balance threshold (for spill trees).
+  const double rho;
+
+  //! Insert into the given NSType by rebuilding it with the leafSize.
+  template<typename NSType>
+  void InsertLeaf(NSType* ns) const;
+
+ public:
+  //! Alias template necessary for visual c++ compiler.
+  template<template<typename TreeMetricType,
+                    typename TreeStatType,
+                    typename TreeMatType> class TreeType,
+           typename MatType = arma::mat>
+  using NSTypeT = NSType<SortPolicy, TreeType, MatType>;
+
+  //! Default Insert on the given NSType instance.
+  template<template<typename TreeMetricType,
+                    typename TreeStatType,
+                    typename TreeMatType> class TreeType,
+           typename MatType>
+  void operator()(NSTypeT<TreeType, MatType>* ns) const;
+
+  //! Insert on the given NSType specialized for KDTrees.
+  void operator()(NSTypeT<tree::KDTree>* ns) const;
+  //! Insert specialized for single-precision KDTrees.
+  void operator()(NSTypeT<tree::KDTree, arma::fmat>* ns) const;
+
+  //! Insert on the given NSType specialized for BallTrees.
+  void operator()(NSTypeT<tree::BallTree>* ns) const;
+  //! Insert specialized for single-precision BallTrees.
+  void operator()(NSTypeT<tree::BallTree, arma::fmat>* ns) const;
+
+  //! Insert specialized for SPTrees.
+  void operator()(SpillKNN* ns) const;
+
+  //! Insert specialized for octrees.
+  void operator()(NSTypeT<tree::Octree>* ns) const;
+
+  //! Construct the InsertVisitor object with the given points, leafSize for
+  //! BinarySpaceTrees, and tau and rho for spill trees.
+  InsertVisitor(const arma::mat& points,
+                const size_t leafSize,
+                const double tau,
+                const double rho);
+};
+
+/**
+ * RemoveVisitor removes a point from the reference set of the given NSType.
+ */
+class RemoveVisitor : public boost::static_visitor<bool>
+{
+ private:
+  //! The index of the point to remove.
+  size_t index;
+
+ public:
+  //! Construct the RemoveVisitor object with the given index.
+  RemoveVisitor(const size_t index) : index(index) { }
+
+  //! Remove the point from the given NSType instance.
+  template<typename NSType>
+  bool operator()(NSType* ns) const;
+};
+
 /**
  * SearchModeVisitor exposes the SearchMode() method of the given NSType.
  */
@@ -213,14 +356,58 @@ class EpsilonVisitor : public boost::static_visitor<double&>
 };
 
 /**
- * ReferenceSetVisitor exposes the referenceSet of the given NSType.
+ * NumThreadsVisitor exposes the NumThreads method of the given NSType.
  */
-class ReferenceSetVisitor : public boost::static_visitor<const arma::mat&>
+class NumThreadsVisitor : public boost::static_visitor<size_t&>
+{
+ public:
+  //! Return the number of threads used for search.
+  template<typename NSType>
+  size_t& operator()(NSType *ns) const;
+};
+
+/**
+ * CacheSizeVisitor gets (and, if a size is given, sets) the maximum size of
+ * the cache of the given NSType.  The caches of single- and double-precision
+ * NSTypes are of different types, so they are not exposed directly.
+ */
+class CacheSizeVisitor : public boost::static_visitor<size_t>
+{
+ private:
+  //! The new maximum size of the cache, or NULL to only get it.
+  const size_t* size;
+
+ public:
+  //! Construct the CacheSizeVisitor, with the new maximum size (or NULL).
+  CacheSizeVisitor(const size_t* size = NULL) : size(size) { }
+
+  //! Return the maximum size of the cache of recent query results.
+  template<typename NSType>
+  size_t operator()(NSType *ns) const;
+};
+
+/**
+ * ReferenceSetVisitor returns the referenceSet of the given NSType, in double
+ * precision.
+ */
+class ReferenceSetVisitor : public boost::static_visitor<arma::mat>
 {
  public:
   //! Return the reference set.
   template<typename NSType>
-  const arma::mat& operator()(NSType *ns) const;
+  arma::mat operator()(NSType *ns) const;
+};
+
+/**
+ * ReferenceSizeVisitor returns the size of the referenceSet of the given
+ * NSType, without copying it.
+ */
+class ReferenceSizeVisitor : public boost::static_visitor<arma::SizeMat>
+{
+ public:
+  //! Return the size of the reference set.
+  template<typename NSType>
+  arma::SizeMat operator()(NSType *ns) const;
 };
 
 /**
@@ -285,10 +472,15 @@ class NSModel
   //! This is the random projection matrix; only used if randomBasis is true.
   arma::mat q;
 
+  //! If true, the reference set and the trees are kept in single precision.
+  bool singlePrecision;
+
   /**
    * nSearch holds an instance of the NeigborSearch class for the current
    * treeType. It is initialized every time BuildModel is executed.
    * We access to the contained value through the visitor classes defined above.
+   * The single-precision types come last, so that the types of models saved
+   * before they were added are unchanged.
    */
   boost::variant<NSType<SortPolicy, tree::KDTree>*,
                  NSType<SortPolicy, tree::StandardCoverTree>*,
@@ -304,7 +496,11 @@ class NSModel
                  NSType<SortPolicy, tree::MaxRPTree>*,
                  SpillKNN*,
                  NSType<SortPolicy, tree::UBTree>*,
-                 NSType<SortPolicy, tree::Octree>*> nSearch;
+                 NSType<SortPolicy, tree::Octree>*,
+                 NSType<SortPolicy, tree::KDTree, arma::fmat>*,
+                 NSType<SortPolicy, tree::StandardCoverTree, arma::fmat>*,
+                 NSType<SortPolicy, tree::RStarTree, arma::fmat>*,
+                 NSType<SortPolicy, tree::BallTree, arma::fmat>*> nSearch;
 
  public:
   /**
@@ -314,8 +510,12 @@ class NSModel
    * @param treeType Type of tree to use.
    * @param randomBasis Whether or not to project the points onto a random basis
    *      before searching.
+   * @param singlePrecision Whether or not to keep the reference set and the
+   *      tree in single precision (see SinglePrecision()).
    */
-  NSModel(TreeTypes treeType = TreeTypes::KD_TREE, bool randomBasis = false);
+  NSModel(TreeTypes treeType = TreeTypes::KD_TREE,
+          bool randomBasis = false,
+          bool singlePrecision = false);
 
   /**
    * Copy the given NSModel.
@@ -352,8 +552,12 @@ class NSModel
   template<typename Archive>
   void serialize(Archive& ar, const unsigned int /* version */);
 
-  //! Expose the dataset.
-  const arma::mat& Dataset() const;
+  //! Get the dataset, in double precision.  This is a copy of the reference
+  //! set; use DatasetSize() to get only its size.
+  arma::mat Dataset() const;
+
+  //! Get the size of the dataset.
+  arma::SizeMat DatasetSize() const;
 
   //! Expose SearchMode.
   NeighborSearchMode SearchMode() const;
@@ -363,6 +567,18 @@ class NSModel
   double Epsilon() const;
   double& Epsilon();
 
+  //! Expose the number of threads used for search (0 means the OpenMP
+  //! default).
+  size_t NumThreads() const;
+  size_t& NumThreads();
+
+  //! Get the maximum number of queries whose results are cached (0 means that
+  //! the cache is disabled).
+  size_t CacheSize() const;
+  //! Set the maximum number of queries whose results are cached (0 disables
+  //! the cache).  This must be set again after BuildModel().
+  void CacheSize(const size_t size);
+
   //! Expose leafSize.
   size_t LeafSize() const { return leafSize; }
   size_t& LeafSize() { return leafSize; }
@@ -383,12 +599,72 @@ class NSModel
   bool RandomBasis() const { return randomBasis; }
   bool& RandomBasis() { return randomBasis; }
 
-  //! Build the reference tree.
+  //! Get whether the reference set and the tree are kept in single precision.
+  bool SinglePrecision() const { return singlePrecision; }
+  //! Modify whether the reference set and the tree are kept in single
+  //! precision; this takes effect at the next BuildModel().  Single precision
+  //! halves the memory of the model and speeds up the distance computations,
+  //! and is supported with kd-trees, cover trees, R* trees and ball trees.
+  //! Queries are converted to single precision too, and the distances are
+  //! returned in double precision but are as precise as single-precision
+  //! computations allow.
+  bool& SinglePrecision() { return singlePrecision; }
+
+  //! Return whether the given tree type supports single precision.
+  static bool SupportsSinglePrecision(const TreeTypes treeType);
+
+  /**
+   * Build the reference tree.  If SinglePrecision() is set, the reference set
+   * is converted to single precision; a std::invalid_argument is thrown if the
+   * tree type doesn't support it.
+   */
   void BuildModel(arma::mat&& referenceSet,
                   const size_t leafSize,
                   const NeighborSearchMode searchMode,
                   const double epsilon = 0);
 
+  /**
+   * Choose the tree type, leaf size and search mode that search a sample of the
+   * given query set fastest, and build the reference tree with them.  The
+   * candidates (kd-trees, ball trees, cover trees, vantage point trees, R*
+   * trees, UB trees and, in low dimensions, octrees, with several leaf sizes
+   * and with dual-tree, single-tree, greedy (only if epsilon is nonzero) and
+   * naive search) are each built on a random sample of the reference set and
+   * timed on a sample of the query set, in order of how likely they are to
+   * win, until the time budget is spent.  The choice is kept in TreeType(),
+   * LeafSize() and SearchMode(), and so is saved with the model.
+   *
+   * @param referenceSet Set of reference points.
+   * @param querySet Set of query points to sample; if it is empty, the
+   *     candidates are timed with monochromatic search.
+   * @param k Number of neighbors that will be searched for.
+   * @param epsilon Relative approximation error allowed in the search.
+   * @param timeBudget Time (in seconds) after which no more candidates are
+   *     tried; at least one candidate is always tried.
+   * @param sampleSize Number of points sampled from each set.
+   */
+  void AutoBuildModel(arma::mat&& referenceSet,
+                      const arma::mat& querySet,
+                      const size_t k,
+                      const double epsilon = 0,
+                      const double timeBudget = 10.0,
+                      const size_t sampleSize = 1000);
+
+  /**
+   * Add points to the reference set.  R tree variants and cover trees insert
+   * the points into the existing tree; other trees are rebuilt.  The new
+   * points get the next indices of the reference set.
+   */
+  void Insert(arma::mat&& points);
+
+  /**
+   * Remove the reference point with the given index.  This is only supported
+   * by the R tree variants and cover trees; for other trees a
+   * std::invalid_argument is thrown.  Returns false if the point was not in
+   * the tree.
+   */
+  bool Remove(const size_t index);
+
   //! Perform neighbor search.  The query set will be reordered.
   void Search(arma::mat&& querySet,
               const size_t k,
@@ -400,6 +676,25 @@ class NSModel
               arma::Mat<size_t>& neighbors,
               arma::mat& distances);
 
+  /**
+   * Perform neighbor search without modifying the model, storing the
+   * statistics of the search in the given object.  Several threads may search
+   * the same model at once, as long as no non-const method is called at the
+   * same time (see NeighborSearch::Search()).
+   */
+  void Search(const arma::mat& querySet,
+              const size_t k,
+              arma::Mat<size_t>& neighbors,
+              arma::mat& distances,
+              SearchStatistics& statistics) const;
+
+  //! Perform monochromatic neighbor search without modifying the model,
+  //! storing the statistics of the search in the given object.
+  void Search(const size_t k,
+              arma::Mat<size_t>& neighbors,
+              arma::mat& distances,
+              SearchStatistics& statistics) const;
+
   //! Return a string representation of the current tree type.
   std::string TreeName() const;
 };
@@ -409,9 +704,33 @@ class NSModel
 
 //! Set the serialization version of the NSModel class.
 BOOST_TEMPLATE_CLASS_VERSION(template<typename SortPolicy>,
-    mlpack::neighbor::NSModel<SortPolicy>, 1);
+    mlpack::neighbor::NSModel<SortPolicy>, 2);
 
 // Include implementation.
 #include "ns_model_impl.hpp"
 
+#ifndef MLPACK_NO_EXTERN_TEMPLATES
+
+namespace mlpack {
+namespace neighbor {
+
+// NSModel, with all of its tree types, and the cover tree searches are compiled
+// once, in libmlpack (see neighbor_search.cpp), like the other common neighbor
+// search types (see typedef.hpp).
+extern template class NeighborSearch<NearestNeighborSort,
+    metric::EuclideanDistance, arma::mat, tree::StandardCoverTree>;
+extern template class NeighborSearch<NearestNeighborSort,
+    metric::EuclideanDistance, arma::fmat, tree::StandardCoverTree>;
+extern template class NeighborSearch<FurthestNeighborSort,
+    metric::EuclideanDistance, arma::mat, tree::StandardCoverTree>;
+extern template class NeighborSearch<FurthestNeighborSort,
+    metric::EuclideanDistance, arma::fmat, tree::StandardCoverTree>;
+extern template class NSModel<NearestNeighborSort>;
+extern template class NSModel<FurthestNeighborSort>;
+
+} // namespace neighbor
+} // namespace mlpack
+
+#endif
+
 #endif
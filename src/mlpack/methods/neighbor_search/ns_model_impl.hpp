@@ -27,9 +27,13 @@ namespace neighbor {
 template<typename NSType>
 void MonoSearchVisitor::operator()(NSType *ns) const
 {
-  if (ns)
-    return ns->Search(k, neighbors, distances);
-  throw std::runtime_error("no neighbor search model initialized");
+  if (!ns)
+    throw std::runtime_error("no neighbor search model initialized");
+
+  if (statistics)
+    ns->Search(k, neighbors, distances, *statistics);
+  else
+    ns->Search(k, neighbors, distances);
 }
 
 //! Save parameters for bichromatic neighbor search.
@@ -40,25 +44,30 @@ BiSearchVisitor<SortPolicy>::BiSearchVisitor(const arma::mat& querySet,
                                              arma::mat& distances,
                                              const size_t leafSize,
                                              const double tau,
-                                             const double rho) :
+                                             const double rho,
+                                             SearchStatistics* statistics) :
     querySet(querySet),
     k(k),
     neighbors(neighbors),
     distances(distances),
     leafSize(leafSize),
     tau(tau),
-    rho(rho)
+    rho(rho),
+    statistics(statistics)
 {}
 
 //! Default Bichromatic neighbor search on the given NSType instance.
 template<typename SortPolicy>
 template<template<typename TreeMetricType,
                   typename TreeStatType,
-                  typename TreeMatType> class TreeType>
-void BiSearchVisitor<SortPolicy>::operator()(NSTypeT<TreeType>* ns) const
+                  typename TreeMatType> class TreeType,
+         typename MatType>
+void BiSearchVisitor<SortPolicy>::operator()(
+    NSTypeT<TreeType, MatType>* ns) const
 {
   if (ns)
-    return ns->Search(querySet, k, neighbors, distances);
+    return Run(ns, SetConverter<MatType>::ToModel(querySet), neighbors,
+        distances);
   throw std::runtime_error("no neighbor search model initialized");
 }
 
@@ -71,6 +80,16 @@ void BiSearchVisitor<SortPolicy>::operator()(NSTypeT<tree::KDTree>* ns) const
   throw std::runtime_error("no neighbor search model initialized");
 }
 
+//! Bichromatic neighbor search specialized for single-precision KDTrees.
+template<typename SortPolicy>
+void BiSearchVisitor<SortPolicy>::operator()(
+    NSTypeT<tree::KDTree, arma::fmat>* ns) const
+{
+  if (ns)
+    return SearchLeaf(ns);
+  throw std::runtime_error("no neighbor search model initialized");
+}
+
 //! Bichromatic neighbor search on the given NSType specialized for BallTrees.
 template<typename SortPolicy>
 void BiSearchVisitor<SortPolicy>::operator()(NSTypeT<tree::BallTree>* ns) const
@@ -80,6 +99,16 @@ void BiSearchVisitor<SortPolicy>::operator()(NSTypeT<tree::BallTree>* ns) const
   throw std::runtime_error("no neighbor search model initialized");
 }
 
+//! Bichromatic neighbor search specialized for single-precision BallTrees.
+template<typename SortPolicy>
+void BiSearchVisitor<SortPolicy>::operator()(
+    NSTypeT<tree::BallTree, arma::fmat>* ns) const
+{
+  if (ns)
+    return SearchLeaf(ns);
+  throw std::runtime_error("no neighbor search model initialized");
+}
+
 //! Bichromatic neighbor search specialized for SPTrees.
 template<typename SortPolicy>
 void BiSearchVisitor<SortPolicy>::operator()(SpillKNN* ns) const
@@ -92,10 +121,10 @@ void BiSearchVisitor<SortPolicy>::operator()(SpillKNN* ns) const
       // non overlapping (tau = 0).
       typename SpillKNN::Tree queryTree(std::move(querySet), 0 /* tau*/,
           leafSize, rho);
-      ns->Search(queryTree, k, neighbors, distances);
+      Run(ns, queryTree, neighbors, distances);
     }
     else
-      ns->Search(querySet, k, neighbors, distances);
+      Run(ns, querySet, neighbors, distances);
   }
   else
     throw std::runtime_error("no neighbor search model initialized");
@@ -115,15 +144,16 @@ template<typename SortPolicy>
 template<typename NSType>
 void BiSearchVisitor<SortPolicy>::SearchLeaf(NSType* ns) const
 {
+  typedef typename NSType::Tree::Mat MatType;
   if (ns->SearchMode() == DUAL_TREE_MODE)
   {
     std::vector<size_t> oldFromNewQueries;
-    typename NSType::Tree queryTree(std::move(querySet), oldFromNewQueries,
-        leafSize);
+    typename NSType::Tree queryTree(SetConverter<MatType>::ToModel(querySet),
+        oldFromNewQueries, leafSize);
 
     arma::Mat<size_t> neighborsOut;
     arma::mat distancesOut;
-    ns->Search(queryTree, k, neighborsOut, distancesOut);
+    Run(ns, queryTree, neighborsOut, distancesOut);
 
     // Unmap the query points.
     distances.set_size(distancesOut.n_rows, distancesOut.n_cols);
@@ -135,7 +165,21 @@ void BiSearchVisitor<SortPolicy>::SearchLeaf(NSType* ns) const
     }
   }
   else
-    ns->Search(querySet, k, neighbors, distances);
+    Run(ns, SetConverter<MatType>::ToModel(querySet), neighbors, distances);
+}
+
+//! Search with the reentrant overload if statistics were given.
+template<typename SortPolicy>
+template<typename NSType, typename QueryType>
+void BiSearchVisitor<SortPolicy>::Run(NSType* ns,
+                                      QueryType&& query,
+                                      arma::Mat<size_t>& neighborsOut,
+                                      arma::mat& distancesOut) const
+{
+  if (statistics)
+    ns->Search(query, k, neighborsOut, distancesOut, *statistics);
+  else
+    ns->Search(query, k, neighborsOut, distancesOut);
 }
 
 //! Save parameters for Train.
@@ -154,11 +198,12 @@ TrainVisitor<SortPolicy>::TrainVisitor(arma::mat&& referenceSet,
 template<typename SortPolicy>
 template<template<typename TreeMetricType,
                   typename TreeStatType,
-                  typename TreeMatType> class TreeType>
-void TrainVisitor<SortPolicy>::operator()(NSTypeT<TreeType>* ns) const
+                  typename TreeMatType> class TreeType,
+         typename MatType>
+void TrainVisitor<SortPolicy>::operator()(NSTypeT<TreeType, MatType>* ns) const
 {
   if (ns)
-    return ns->Train(std::move(referenceSet));
+    return ns->Train(SetConverter<MatType>::ToModel(std::move(referenceSet)));
   throw std::runtime_error("no neighbor search model initialized");
 }
 
@@ -171,6 +216,16 @@ void TrainVisitor<SortPolicy>::operator()(NSTypeT<tree::KDTree>* ns) const
   throw std::runtime_error("no neighbor search model initialized");
 }
 
+//! Train specialized for single-precision KDTrees.
+template<typename SortPolicy>
+void TrainVisitor<SortPolicy>::operator()(
+    NSTypeT<tree::KDTree, arma::fmat>* ns) const
+{
+  if (ns)
+    return TrainLeaf(ns);
+  throw std::runtime_error("no neighbor search model initialized");
+}
+
 //! Train on the given NSType specialized for BallTrees.
 template<typename SortPolicy>
 void TrainVisitor<SortPolicy>::operator()(NSTypeT<tree::BallTree>* ns) const
@@ -180,6 +235,16 @@ void TrainVisitor<SortPolicy>::operator()(NSTypeT<tree::BallTree>* ns) const
   throw std::runtime_error("no neighbor search model initialized");
 }
 
+//! Train specialized for single-precision BallTrees.
+template<typename SortPolicy>
+void TrainVisitor<SortPolicy>::operator()(
+    NSTypeT<tree::BallTree, arma::fmat>* ns) const
+{
+  if (ns)
+    return TrainLeaf(ns);
+  throw std::runtime_error("no neighbor search model initialized");
+}
+
 //! Train specialized for SPTrees.
 template<typename SortPolicy>
 void TrainVisitor<SortPolicy>::operator()(SpillKNN* ns) const
@@ -212,12 +277,14 @@ template<typename SortPolicy>
 template<typename NSType>
 void TrainVisitor<SortPolicy>::TrainLeaf(NSType* ns) const
 {
+  typedef typename NSType::Tree::Mat MatType;
   if (ns->SearchMode() == NAIVE_MODE)
-    ns->Train(std::move(referenceSet));
+    ns->Train(SetConverter<MatType>::ToModel(std::move(referenceSet)));
   else
   {
     std::vector<size_t> oldFromNewReferences;
-    typename NSType::Tree referenceTree(std::move(referenceSet),
+    typename NSType::Tree referenceTree(
+        SetConverter<MatType>::ToModel(std::move(referenceSet)),
         oldFromNewReferences, leafSize);
     ns->Train(std::move(referenceTree));
     // Set the mappings.
@@ -225,6 +292,128 @@ void TrainVisitor<SortPolicy>::TrainLeaf(NSType* ns) const
   }
 }
 
+//! Save parameters for Insert.
+template<typename SortPolicy>
+InsertVisitor<SortPolicy>::InsertVisitor(const arma::mat& points,
+                                         const size_t leafSize,
+                                         const double tau,
+                                         const double rho) :
+    points(points),
+    leafSize(leafSize),
+    tau(tau),
+    rho(rho)
+{}
+
+//! Default Insert on the given NSType instance.
+template<typename SortPolicy>
+template<template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         typename MatType>
+void InsertVisitor<SortPolicy>::operator()(
+    NSTypeT<TreeType, MatType>* ns) const
+{
+  if (ns)
+    return ns->Insert(SetConverter<MatType>::ToModel(points));
+  throw std::runtime_error("no neighbor search model initialized");
+}
+
+//! Insert on the given NSType specialized for KDTrees.
+template<typename SortPolicy>
+void InsertVisitor<SortPolicy>::operator()(NSTypeT<tree::KDTree>* ns) const
+{
+  if (ns)
+    return InsertLeaf(ns);
+  throw std::runtime_error("no neighbor search model initialized");
+}
+
+//! Insert specialized for single-precision KDTrees.
+template<typename SortPolicy>
+void InsertVisitor<SortPolicy>::operator()(
+    NSTypeT<tree::KDTree, arma::fmat>* ns) const
+{
+  if (ns)
+    return InsertLeaf(ns);
+  throw std::runtime_error("no neighbor search model initialized");
+}
+
+//! Insert on the given NSType specialized for BallTrees.
+template<typename SortPolicy>
+void InsertVisitor<SortPolicy>::operator()(NSTypeT<tree::BallTree>* ns) const
+{
+  if (ns)
+    return InsertLeaf(ns);
+  throw std::runtime_error("no neighbor search model initialized");
+}
+
+//! Insert specialized for single-precision BallTrees.
+template<typename SortPolicy>
+void InsertVisitor<SortPolicy>::operator()(
+    NSTypeT<tree::BallTree, arma::fmat>* ns) const
+{
+  if (ns)
+    return InsertLeaf(ns);
+  throw std::runtime_error("no neighbor search model initialized");
+}
+
+//! Insert specialized for SPTrees.
+template<typename SortPolicy>
+void InsertVisitor<SortPolicy>::operator()(SpillKNN* ns) const
+{
+  if (ns)
+    return InsertLeaf(ns);
+  throw std::runtime_error("no neighbor search model initialized");
+}
+
+//! Insert specialized for Octrees.
+template<typename SortPolicy>
+void InsertVisitor<SortPolicy>::operator()(NSTypeT<tree::Octree>* ns) const
+{
+  if (ns)
+    return InsertLeaf(ns);
+  throw std::runtime_error("no neighbor search model initialized");
+}
+
+//! Insert into the given NSType by rebuilding it with the leafSize.
+template<typename SortPolicy>
+template<typename NSType>
+void InsertVisitor<SortPolicy>::InsertLeaf(NSType* ns) const
+{
+  typedef typename NSType::Tree::Mat MatType;
+  if (ns->SearchMode() == NAIVE_MODE)
+    return ns->Insert(SetConverter<MatType>::ToModel(points));
+
+  // Restore the original order of the reference set, so that the indices of
+  // the old points don't change, and retrain on it.
+  const arma::mat& referenceSet =
+      SetConverter<MatType>::FromModel(ns->ReferenceSet());
+  const std::vector<size_t>& oldFromNew = ns->OldFromNewReferences();
+  arma::mat newReferenceSet(referenceSet.n_rows,
+      referenceSet.n_cols + points.n_cols);
+  if (oldFromNew.empty())
+  {
+    newReferenceSet.head_cols(referenceSet.n_cols) = referenceSet;
+  }
+  else
+  {
+    for (size_t i = 0; i < referenceSet.n_cols; ++i)
+      newReferenceSet.col(oldFromNew[i]) = referenceSet.col(i);
+  }
+  newReferenceSet.tail_cols(points.n_cols) = points;
+
+  TrainVisitor<SortPolicy> tn(std::move(newReferenceSet), leafSize, tau, rho);
+  tn(ns);
+}
+
+//! Remove the point from the given NSType instance.
+template<typename NSType>
+bool RemoveVisitor::operator()(NSType* ns) const
+{
+  if (ns)
+    return ns->Remove(index);
+  throw std::runtime_error("no neighbor search model initialized");
+}
+
 //! Return the search mode.
 template<typename NSType>
 NeighborSearchMode& SearchModeVisitor::operator()(NSType* ns) const
@@ -243,12 +432,43 @@ double& EpsilonVisitor::operator()(NSType* ns) const
   throw std::runtime_error("no neighbor search model initialized");
 }
 
-//! Expose the referenceSet of the given NSType.
+//! Expose the NumThreads method of the given NSType.
+template<typename NSType>
+size_t& NumThreadsVisitor::operator()(NSType* ns) const
+{
+  if (ns)
+    return ns->NumThreads();
+  throw std::runtime_error("no neighbor search model initialized");
+}
+
+//! Get (and maybe set) the maximum size of the cache of the given NSType.
+template<typename NSType>
+size_t CacheSizeVisitor::operator()(NSType* ns) const
+{
+  if (!ns)
+    throw std::runtime_error("no neighbor search model initialized");
+
+  if (size)
+    ns->Cache().MaxSize(*size);
+  return ns->Cache().MaxSize();
+}
+
+//! Return the referenceSet of the given NSType in double precision.
+template<typename NSType>
+arma::mat ReferenceSetVisitor::operator()(NSType* ns) const
+{
+  if (ns)
+    return SetConverter<typename NSType::Tree::Mat>::FromModel(
+        ns->ReferenceSet());
+  throw std::runtime_error("no neighbor search model initialized");
+}
+
+//! Return the size of the referenceSet of the given NSType.
 template<typename NSType>
-const arma::mat& ReferenceSetVisitor::operator()(NSType* ns) const
+arma::SizeMat ReferenceSizeVisitor::operator()(NSType* ns) const
 {
   if (ns)
-    return ns->ReferenceSet();
+    return arma::size(ns->ReferenceSet());
   throw std::runtime_error("no neighbor search model initialized");
 }
 
@@ -265,12 +485,15 @@ void DeleteVisitor::operator()(NSType* ns) const
  * basis should be used.
  */
 template<typename SortPolicy>
-NSModel<SortPolicy>::NSModel(TreeTypes treeType, bool randomBasis) :
+NSModel<SortPolicy>::NSModel(TreeTypes treeType,
+                             bool randomBasis,
+                             bool singlePrecision) :
     treeType(treeType),
     leafSize(20),
     tau(0),
     rho(0.7),
-    randomBasis(randomBasis)
+    randomBasis(randomBasis),
+    singlePrecision(singlePrecision)
 {
   // Nothing to do.
 }
@@ -283,6 +506,7 @@ NSModel<SortPolicy>::NSModel(const NSModel& other) :
     rho(other.rho),
     randomBasis(other.randomBasis),
     q(other.q),
+    singlePrecision(other.singlePrecision),
     nSearch(other.nSearch)
 {
   // Nothing to do.
@@ -296,6 +520,7 @@ NSModel<SortPolicy>::NSModel(NSModel&& other) :
     rho(other.rho),
     randomBasis(other.randomBasis),
     q(std::move(other.q)),
+    singlePrecision(other.singlePrecision),
     nSearch(other.nSearch)
 {
   // Reset parameters of the other model.
@@ -304,6 +529,7 @@ NSModel<SortPolicy>::NSModel(NSModel&& other) :
   other.tau = 0;
   other.rho = 0.7;
   other.randomBasis = false;
+  other.singlePrecision = false;
   other.nSearch = decltype(other.nSearch)();
 }
 
@@ -318,6 +544,7 @@ NSModel<SortPolicy>& NSModel<SortPolicy>::operator=(const NSModel& other)
   rho = other.rho;
   randomBasis = other.randomBasis;
   q = other.q;
+  singlePrecision = other.singlePrecision;
   nSearch = other.nSearch;
 
   return *this;
@@ -334,6 +561,7 @@ NSModel<SortPolicy>& NSModel<SortPolicy>::operator=(NSModel&& other)
   rho = other.rho;
   randomBasis = other.randomBasis;
   q = std::move(other.q);
+  singlePrecision = other.singlePrecision;
   // Copy the pointer and type.
   nSearch = other.nSearch;
 
@@ -343,6 +571,7 @@ NSModel<SortPolicy>& NSModel<SortPolicy>::operator=(NSModel&& other)
   other.tau = 0;
   other.rho = 0.7;
   other.randomBasis = false;
+  other.singlePrecision = false;
   other.nSearch = decltype(other.nSearch)();
 
   return *this;
@@ -371,6 +600,11 @@ void NSModel<SortPolicy>::serialize(Archive& ar, const unsigned int version)
   }
   ar & BOOST_SERIALIZATION_NVP(randomBasis);
   ar & BOOST_SERIALIZATION_NVP(q);
+  // Older versions only had double-precision models.
+  if (version > 1)
+    ar & BOOST_SERIALIZATION_NVP(singlePrecision);
+  else if (Archive::is_loading::value)
+    singlePrecision = false;
 
   // This should never happen, but just in case, be clean with memory.
   if (Archive::is_loading::value)
@@ -379,13 +613,20 @@ void NSModel<SortPolicy>::serialize(Archive& ar, const unsigned int version)
   ar & BOOST_SERIALIZATION_NVP(nSearch);
 }
 
-//! Expose the dataset.
+//! Get the dataset, in double precision.
 template<typename SortPolicy>
-const arma::mat& NSModel<SortPolicy>::Dataset() const
+arma::mat NSModel<SortPolicy>::Dataset() const
 {
   return boost::apply_visitor(ReferenceSetVisitor(), nSearch);
 }
 
+//! Get the size of the dataset.
+template<typename SortPolicy>
+arma::SizeMat NSModel<SortPolicy>::DatasetSize() const
+{
+  return boost::apply_visitor(ReferenceSizeVisitor(), nSearch);
+}
+
 //! Access the search mode.
 template<typename SortPolicy>
 NeighborSearchMode NSModel<SortPolicy>::SearchMode() const
@@ -412,6 +653,46 @@ double& NSModel<SortPolicy>::Epsilon()
   return boost::apply_visitor(EpsilonVisitor(), nSearch);
 }
 
+template<typename SortPolicy>
+size_t NSModel<SortPolicy>::NumThreads() const
+{
+  return boost::apply_visitor(NumThreadsVisitor(), nSearch);
+}
+
+template<typename SortPolicy>
+size_t& NSModel<SortPolicy>::NumThreads()
+{
+  return boost::apply_visitor(NumThreadsVisitor(), nSearch);
+}
+
+template<typename SortPolicy>
+size_t NSModel<SortPolicy>::CacheSize() const
+{
+  return boost::apply_visitor(CacheSizeVisitor(), nSearch);
+}
+
+template<typename SortPolicy>
+void NSModel<SortPolicy>::CacheSize(const size_t size)
+{
+  boost::apply_visitor(CacheSizeVisitor(&size), nSearch);
+}
+
+//! Return whether the given tree type supports single precision.
+template<typename SortPolicy>
+bool NSModel<SortPolicy>::SupportsSinglePrecision(const TreeTypes treeType)
+{
+  switch (treeType)
+  {
+    case KD_TREE:
+    case COVER_TREE:
+    case R_STAR_TREE:
+    case BALL_TREE:
+      return true;
+    default:
+      return false;
+  }
+}
+
 //! Build the reference tree.
 template<typename SortPolicy>
 void NSModel<SortPolicy>::BuildModel(arma::mat&& referenceSet,
@@ -419,6 +700,13 @@ void NSModel<SortPolicy>::BuildModel(arma::mat&& referenceSet,
                                      const NeighborSearchMode searchMode,
                                      const double epsilon)
 {
+  if (singlePrecision && !SupportsSinglePrecision(treeType))
+  {
+    throw std::invalid_argument("NSModel::BuildModel(): single precision is "
+        "only supported with kd-trees, cover trees, R* trees and ball trees, "
+        "not with the " + TreeName());
+  }
+
   this->leafSize = leafSize;
   // Initialize random basis if necessary.
   if (randomBasis)
@@ -468,20 +756,36 @@ void NSModel<SortPolicy>::BuildModel(arma::mat&& referenceSet,
   switch (treeType)
   {
     case KD_TREE:
-      nSearch = new NSType<SortPolicy, tree::KDTree>(searchMode, epsilon);
+      if (singlePrecision)
+        nSearch = new NSType<SortPolicy, tree::KDTree, arma::fmat>(searchMode,
+            epsilon);
+      else
+        nSearch = new NSType<SortPolicy, tree::KDTree>(searchMode, epsilon);
       break;
     case COVER_TREE:
-      nSearch = new NSType<SortPolicy, tree::StandardCoverTree>(searchMode,
-          epsilon);
+      if (singlePrecision)
+        nSearch = new NSType<SortPolicy, tree::StandardCoverTree, arma::fmat>(
+            searchMode, epsilon);
+      else
+        nSearch = new NSType<SortPolicy, tree::StandardCoverTree>(searchMode,
+            epsilon);
       break;
     case R_TREE:
       nSearch = new NSType<SortPolicy, tree::RTree>(searchMode, epsilon);
       break;
     case R_STAR_TREE:
-      nSearch = new NSType<SortPolicy, tree::RStarTree>(searchMode, epsilon);
+      if (singlePrecision)
+        nSearch = new NSType<SortPolicy, tree::RStarTree, arma::fmat>(
+            searchMode, epsilon);
+      else
+        nSearch = new NSType<SortPolicy, tree::RStarTree>(searchMode, epsilon);
       break;
     case BALL_TREE:
-      nSearch = new NSType<SortPolicy, tree::BallTree>(searchMode, epsilon);
+      if (singlePrecision)
+        nSearch = new NSType<SortPolicy, tree::BallTree, arma::fmat>(
+            searchMode, epsilon);
+      else
+        nSearch = new NSType<SortPolicy, tree::BallTree>(searchMode, epsilon);
       break;
     case X_TREE:
       nSearch = new NSType<SortPolicy, tree::XTree>(searchMode, epsilon);
@@ -526,6 +830,173 @@ void NSModel<SortPolicy>::BuildModel(arma::mat&& referenceSet,
   }
 }
 
+//! Choose the tree type, leaf size and search mode, and build the tree.
+template<typename SortPolicy>
+void NSModel<SortPolicy>::AutoBuildModel(arma::mat&& referenceSet,
+                                         const arma::mat& querySet,
+                                         const size_t k,
+                                         const double epsilon,
+                                         const double timeBudget,
+                                         const size_t sampleSize)
+{
+  const bool monochromatic = querySet.is_empty();
+  if (referenceSet.n_cols < (monochromatic ? 2 : 1))
+  {
+    throw std::invalid_argument("NSModel::AutoBuildModel(): the reference set "
+        "is too small to search");
+  }
+
+  if (!monochromatic && querySet.n_rows != referenceSet.n_rows)
+  {
+    std::ostringstream oss;
+    oss << "NSModel::AutoBuildModel(): the query set has dimensionality "
+        << querySet.n_rows << ", but the reference set has dimensionality "
+        << referenceSet.n_rows;
+    throw std::invalid_argument(oss.str());
+  }
+
+  // The reference sample must hold at least k points (other than the query
+  // point itself, for monochromatic search).
+  const size_t referenceSamples = std::min((size_t) referenceSet.n_cols,
+      std::max(sampleSize, k + 1));
+  const arma::mat referenceSample = referenceSet.cols(
+      arma::randperm(referenceSet.n_cols, referenceSamples));
+  arma::mat querySample;
+  if (!monochromatic)
+  {
+    querySample = querySet.cols(arma::randperm(querySet.n_cols,
+        std::min((size_t) querySet.n_cols, std::max(sampleSize, size_t(1)))));
+  }
+  const size_t sampleK = std::max(size_t(1), std::min(k,
+      referenceSamples - (monochromatic ? 1 : 0)));
+
+  // The candidates, in order of how likely they are to win: first the default
+  // leaf size on every tree, then the other leaf sizes on the trees that use
+  // them.
+  struct Candidate
+  {
+    TreeTypes treeType;
+    size_t leafSize;
+    NeighborSearchMode searchMode;
+  };
+  std::vector<NeighborSearchMode> searchModes = { DUAL_TREE_MODE,
+      SINGLE_TREE_MODE };
+  if (epsilon > 0)
+    searchModes.push_back(GREEDY_SINGLE_TREE_MODE);
+
+  std::vector<TreeTypes> leafTrees = { KD_TREE, BALL_TREE };
+  // An octree node has 2^d children, so it is only worth trying in low
+  // dimensions.
+  if (referenceSet.n_rows <= 8)
+    leafTrees.push_back(OCTREE);
+  const std::vector<TreeTypes> otherTrees = { COVER_TREE, VP_TREE,
+      R_STAR_TREE, UB_TREE };
+
+  std::vector<Candidate> candidates;
+  for (const TreeTypes tree : leafTrees)
+    for (const NeighborSearchMode mode : searchModes)
+      candidates.push_back({ tree, 20, mode });
+  for (const TreeTypes tree : otherTrees)
+    for (const NeighborSearchMode mode : searchModes)
+      candidates.push_back({ tree, 20, mode });
+  candidates.push_back({ KD_TREE, 20, NAIVE_MODE });
+  for (const size_t size : { 10, 40 })
+    for (const TreeTypes tree : leafTrees)
+      for (const NeighborSearchMode mode : searchModes)
+        candidates.push_back({ tree, size, mode });
+
+  // A single-precision model can only use some of the trees.
+  if (singlePrecision)
+  {
+    candidates.erase(std::remove_if(candidates.begin(), candidates.end(),
+        [](const Candidate& c)
+        {
+          return !SupportsSinglePrecision(c.treeType);
+        }), candidates.end());
+  }
+
+  // Name the search modes in the log.
+  auto modeName = [](const NeighborSearchMode mode) -> std::string
+  {
+    switch (mode)
+    {
+      case NAIVE_MODE:
+        return "naive";
+      case SINGLE_TREE_MODE:
+        return "single-tree";
+      case DUAL_TREE_MODE:
+        return "dual-tree";
+      default:
+        return "greedy single-tree";
+    }
+  };
+
+  arma::wall_clock totalClock;
+  totalClock.tic();
+  size_t best = 0;
+  double bestTime = DBL_MAX;
+  size_t tried = 0;
+  for (size_t i = 0; i < candidates.size(); ++i)
+  {
+    if (tried > 0 && totalClock.toc() >= timeBudget)
+      break;
+
+    NSModel candidate(candidates[i].treeType, randomBasis, singlePrecision);
+    candidate.Tau() = tau;
+    candidate.Rho() = rho;
+
+    arma::wall_clock clock;
+    clock.tic();
+    candidate.BuildModel(arma::mat(referenceSample), candidates[i].leafSize,
+        candidates[i].searchMode, epsilon);
+    arma::Mat<size_t> neighbors;
+    arma::mat distances;
+    SearchStatistics statistics;
+    if (monochromatic)
+      candidate.Search(sampleK, neighbors, distances, statistics);
+    else
+      candidate.Search(querySample, sampleK, neighbors, distances, statistics);
+    const double time = clock.toc();
+    ++tried;
+
+    Log::Info << "Tried " << modeName(candidates[i].searchMode) << " "
+        << candidate.TreeName() << " search with leaf size "
+        << candidates[i].leafSize << ": " << time << "s." << std::endl;
+    if (time < bestTime)
+    {
+      best = i;
+      bestTime = time;
+    }
+  }
+
+  treeType = candidates[best].treeType;
+  Log::Info << "Chose " << modeName(candidates[best].searchMode) << " "
+      << TreeName() << " search with leaf size " << candidates[best].leafSize
+      << " (tried " << tried << " of " << candidates.size() << " candidates)."
+      << std::endl;
+  BuildModel(std::move(referenceSet), candidates[best].leafSize,
+      candidates[best].searchMode, epsilon);
+}
+
+//! Add points to the reference set.
+template<typename SortPolicy>
+void NSModel<SortPolicy>::Insert(arma::mat&& points)
+{
+  // The points must be projected onto the same basis as the reference set.
+  if (randomBasis)
+    points = q * points;
+
+  InsertVisitor<SortPolicy> insert(points, leafSize, tau, rho);
+  boost::apply_visitor(insert, nSearch);
+}
+
+//! Remove a point from the reference set.
+template<typename SortPolicy>
+bool NSModel<SortPolicy>::Remove(const size_t index)
+{
+  return boost::apply_visitor(RemoveVisitor(index), nSearch);
+}
+
 //! Perform neighbor search.  The query set will be reordered.
 template<typename SortPolicy>
 void NSModel<SortPolicy>::Search(arma::mat&& querySet,
@@ -594,6 +1065,35 @@ void NSModel<SortPolicy>::Search(const size_t k,
   boost::apply_visitor(search, nSearch);
 }
 
+//! Perform neighbor search without modifying the model.
+template<typename SortPolicy>
+void NSModel<SortPolicy>::Search(const arma::mat& querySet,
+                                 const size_t k,
+                                 arma::Mat<size_t>& neighbors,
+                                 arma::mat& distances,
+                                 SearchStatistics& statistics) const
+{
+  // We may need to map the query set randomly.
+  arma::mat mappedQuerySet;
+  if (randomBasis)
+    mappedQuerySet = q * querySet;
+
+  BiSearchVisitor<SortPolicy> search(randomBasis ? mappedQuerySet : querySet,
+      k, neighbors, distances, leafSize, tau, rho, &statistics);
+  boost::apply_visitor(search, nSearch);
+}
+
+//! Perform monochromatic neighbor search without modifying the model.
+template<typename SortPolicy>
+void NSModel<SortPolicy>::Search(const size_t k,
+                                 arma::Mat<size_t>& neighbors,
+                                 arma::mat& distances,
+                                 SearchStatistics& statistics) const
+{
+  MonoSearchVisitor search(k, neighbors, distances, &statistics);
+  boost::apply_visitor(search, nSearch);
+}
+
 //! Get the name of the tree type.
 template<typename SortPolicy>
 std::string NSModel<SortPolicy>::TreeName() const
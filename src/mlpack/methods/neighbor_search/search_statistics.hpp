@@ -0,0 +1,246 @@
+/**
+ * @file methods/neighbor_search/search_statistics.hpp
+ *
+ * Definition of SearchStatistics, which collects counters and timings about
+ * the traversals performed during a neighbor search.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_NEIGHBOR_SEARCH_SEARCH_STATISTICS_HPP
+#define MLPACK_METHODS_NEIGHBOR_SEARCH_SEARCH_STATISTICS_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/util/sfinae_utility.hpp>
+#include <mlpack/core/tree/traversal_statistics.hpp>
+
+namespace mlpack {
+namespace neighbor {
+
+/**
+ * SearchStatistics holds information about the last search performed by a
+ * NeighborSearch object, to help understand why a search is slow for some
+ * dataset, tree type, or leaf size.  The counters come from the
+ * NeighborSearchRules and the tree traversers; a traverser that doesn't count
+ * visited nodes or prunes (like the naive search) leaves those counters at 0.
+ *
+ * The timings are measured with a wall clock, in seconds.  The counters are
+ * summed over all threads, so with a parallel search they are not comparable
+ * with the timings.  The same holds for the time spent in base cases and in
+ * scoring, which the traversers measure around each batch of BaseCase() and
+ * Score() calls (see tree::TraversalStatistics) and which are summed over all
+ * threads too.  The maximum depth is the deepest recursion of any traverser.
+ */
+class SearchStatistics
+{
+ public:
+  //! Create the object with all counters set to 0.
+  SearchStatistics() { Reset(); }
+
+  //! Set all counters and timings to 0.
+  void Reset()
+  {
+    baseCases = 0;
+    scores = 0;
+    nodesVisited = 0;
+    prunes = 0;
+    traversalInfoPrunes = 0;
+    boundPrunes = 0;
+    referenceLeaves = 0;
+    referenceLeafPoints = 0;
+    maxDepth = 0;
+    baseCaseTime = 0.0;
+    scoreTime = 0.0;
+    treeBuildingTime = 0.0;
+    searchTime = 0.0;
+  }
+
+  //! Add the counters of the given NeighborSearchRules object.
+  template<typename RuleType>
+  void AddRules(const RuleType& rules)
+  {
+    baseCases += rules.BaseCases();
+    scores += rules.Scores();
+    traversalInfoPrunes += rules.TraversalInfoPrunes();
+    boundPrunes += rules.BoundPrunes();
+    referenceLeaves += rules.ReferenceLeaves();
+    referenceLeafPoints += rules.ReferenceLeafPoints();
+  }
+
+  //! Add the counters, the base case and score times and the maximum depth of
+  //! the given traverser.  Counters that the traverser doesn't provide are left
+  //! unchanged.
+  template<typename TraverserType>
+  void AddTraverser(const TraverserType& traverser)
+  {
+    nodesVisited += NumVisited(traverser);
+    prunes += NumPrunes(traverser);
+    AddTraversalStatistics(traverser);
+  }
+
+  //! Add the counters, the base case and score times and the maximum depth
+  //! (but not the tree building and search times) of another object.
+  SearchStatistics& operator+=(const SearchStatistics& other)
+  {
+    maxDepth = std::max(maxDepth, other.maxDepth);
+    baseCaseTime += other.baseCaseTime;
+    scoreTime += other.scoreTime;
+    baseCases += other.baseCases;
+    scores += other.scores;
+    nodesVisited += other.nodesVisited;
+    prunes += other.prunes;
+    traversalInfoPrunes += other.traversalInfoPrunes;
+    boundPrunes += other.boundPrunes;
+    referenceLeaves += other.referenceLeaves;
+    referenceLeafPoints += other.referenceLeafPoints;
+    return *this;
+  }
+
+  //! Get the number of base cases (distance evaluations between points).
+  size_t BaseCases() const { return baseCases; }
+  //! Get the number of node combinations that were scored.
+  size_t Scores() const { return scores; }
+  //! Get the number of node combinations visited by dual-tree traversers.
+  size_t NodesVisited() const { return nodesVisited; }
+  //! Get the number of prunes counted by the traversers.
+  size_t Prunes() const { return prunes; }
+  //! Get the number of node combinations pruned with the cheap bound derived
+  //! from the previous combination (the traversal information), without
+  //! computing a node-to-node distance.
+  size_t TraversalInfoPrunes() const { return traversalInfoPrunes; }
+  //! Get the number of node combinations pruned after computing the bound
+  //! distance between the nodes (or between the query point and the node).
+  size_t BoundPrunes() const { return boundPrunes; }
+  //! Get the number of times a reference leaf was reached (not pruned).
+  size_t ReferenceLeaves() const { return referenceLeaves; }
+  //! Get the total number of points held by the reference leaves reached.
+  size_t ReferenceLeafPoints() const { return referenceLeafPoints; }
+  //! Get the average number of points in the reference leaves reached.
+  double AverageLeafSize() const
+  {
+    return (referenceLeaves == 0) ? 0.0 :
+        (double) referenceLeafPoints / (double) referenceLeaves;
+  }
+
+  //! Get the maximum recursion depth reached by the traversers (for the
+  //! traversers that are not recursive, the number of levels visited).
+  size_t MaxDepth() const { return maxDepth; }
+  //! Get the time spent in base cases, in seconds.
+  double BaseCaseTime() const { return baseCaseTime; }
+  //! Modify the time spent in base cases, in seconds.
+  double& BaseCaseTime() { return baseCaseTime; }
+  //! Get the time spent scoring nodes, in seconds.
+  double ScoreTime() const { return scoreTime; }
+
+  //! Get the time spent building the query tree, in seconds.
+  double TreeBuildingTime() const { return treeBuildingTime; }
+  //! Modify the time spent building the query tree, in seconds.
+  double& TreeBuildingTime() { return treeBuildingTime; }
+  //! Get the time spent searching (without building the query tree), in
+  //! seconds.
+  double SearchTime() const { return searchTime; }
+  //! Modify the time spent searching, in seconds.
+  double& SearchTime() { return searchTime; }
+
+ private:
+  HAS_MEM_FUNC(NumVisited, HasNumVisited);
+  HAS_MEM_FUNC(NumPrunes, HasNumPrunes);
+  HAS_MEM_FUNC(Statistics, HasStatistics);
+
+  //! Get the number of visited nodes of a traverser that counts them.
+  template<typename TraverserType>
+  static size_t NumVisited(
+      const TraverserType& traverser,
+      const typename std::enable_if_t<HasNumVisited<TraverserType,
+          size_t(TraverserType::*)() const>::value>* = 0)
+  {
+    return traverser.NumVisited();
+  }
+
+  //! Other traversers don't count visited nodes.
+  template<typename TraverserType>
+  static size_t NumVisited(
+      const TraverserType& /* traverser */,
+      const typename std::enable_if_t<!HasNumVisited<TraverserType,
+          size_t(TraverserType::*)() const>::value>* = 0)
+  {
+    return 0;
+  }
+
+  //! Get the number of prunes of a traverser that counts them.
+  template<typename TraverserType>
+  static size_t NumPrunes(
+      const TraverserType& traverser,
+      const typename std::enable_if_t<HasNumPrunes<TraverserType,
+          size_t(TraverserType::*)() const>::value>* = 0)
+  {
+    return traverser.NumPrunes();
+  }
+
+  //! Other traversers don't count prunes.
+  template<typename TraverserType>
+  static size_t NumPrunes(
+      const TraverserType& /* traverser */,
+      const typename std::enable_if_t<!HasNumPrunes<TraverserType,
+          size_t(TraverserType::*)() const>::value>* = 0)
+  {
+    return 0;
+  }
+
+  //! Add the timings and the maximum depth of a traverser that measures them.
+  template<typename TraverserType>
+  void AddTraversalStatistics(
+      const TraverserType& traverser,
+      const typename std::enable_if_t<HasStatistics<TraverserType, const
+          tree::TraversalStatistics&(TraverserType::*)() const>::value>* = 0)
+  {
+    const tree::TraversalStatistics& traversal = traverser.Statistics();
+    maxDepth = std::max(maxDepth, traversal.MaxDepth());
+    baseCaseTime += traversal.BaseCaseTime();
+    scoreTime += traversal.ScoreTime();
+  }
+
+  //! Other traversers don't measure anything.
+  template<typename TraverserType>
+  void AddTraversalStatistics(
+      const TraverserType& /* traverser */,
+      const typename std::enable_if_t<!HasStatistics<TraverserType, const
+          tree::TraversalStatistics&(TraverserType::*)() const>::value>* = 0)
+  {
+    // Nothing to do.
+  }
+
+  //! The number of base cases.
+  size_t baseCases;
+  //! The number of scores.
+  size_t scores;
+  //! The number of node combinations visited.
+  size_t nodesVisited;
+  //! The number of prunes counted by the traversers.
+  size_t prunes;
+  //! The number of prunes made with the traversal information.
+  size_t traversalInfoPrunes;
+  //! The number of prunes made with the bound distance.
+  size_t boundPrunes;
+  //! The number of reference leaves reached.
+  size_t referenceLeaves;
+  //! The number of points in the reference leaves reached.
+  size_t referenceLeafPoints;
+  //! The maximum recursion depth of the traversers.
+  size_t maxDepth;
+  //! The time spent in base cases.
+  double baseCaseTime;
+  //! The time spent scoring nodes.
+  double scoreTime;
+  //! The time spent building the query tree.
+  double treeBuildingTime;
+  //! The time spent searching.
+  double searchTime;
+};
+
+} // namespace neighbor
+} // namespace mlpack
+
+#endif
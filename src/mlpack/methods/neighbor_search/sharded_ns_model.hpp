@@ -0,0 +1,169 @@
+/**
+ * @file methods/neighbor_search/sharded_ns_model.hpp
+ *
+ * Definition of ShardedNSModel, which searches for neighbors in a reference set
+ * split into several shards, each with its own NSModel, and merges the results
+ * of the shards.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_NEIGHBOR_SEARCH_SHARDED_NS_MODEL_HPP
+#define MLPACK_METHODS_NEIGHBOR_SEARCH_SHARDED_NS_MODEL_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/tree/hrectbound.hpp>
+#include "ns_model.hpp"
+
+namespace mlpack {
+namespace neighbor {
+
+/**
+ * ShardedNSModel holds a reference set split into shards, each with its own
+ * NSModel (and so its own tree), and answers a query batch by searching every
+ * shard and merging the per-shard top-k lists with a k-way merge.  This is the
+ * layout of a reference set too large for one machine: each shard can be
+ * serialized, loaded and searched on its own node, and the lists it returns
+ * combined with Merge().
+ *
+ * With pruning, each query is first searched in its home shard (the one whose
+ * bounding box is closest to it), and then the k-th distance found so far is
+ * used as a bound for the other shards: a shard is only searched for the
+ * queries that its bounding box could improve.  The results are the same as
+ * without pruning.  Shards added with AddShard() that use a random basis have
+ * no bounding box in the space of the queries, and are never pruned.
+ *
+ * @tparam SortPolicy The sort policy for distances; see NearestNeighborSort.
+ */
+template<typename SortPolicy>
+class ShardedNSModel
+{
+ public:
+  //! The type of the tree of each shard.
+  typedef typename NSModel<SortPolicy>::TreeTypes TreeTypes;
+
+  /**
+   * Initialize the ShardedNSModel with the given type of tree and whether or
+   * not a random basis should be used for the shards built by BuildModel().
+   *
+   * @param treeType Type of tree to build for each shard.
+   * @param randomBasis Whether or not to project the points of each shard onto
+   *     a random basis.
+   */
+  ShardedNSModel(const TreeTypes treeType = TreeTypes::KD_TREE,
+                 const bool randomBasis = false);
+
+  /**
+   * Split the given reference set into the given number of contiguous shards
+   * (of nearly equal sizes), and build the model of each shard.  Point i of
+   * the reference set is then returned as neighbor i.
+   *
+   * @param referenceSet Set of reference points.
+   * @param shards Number of shards.
+   * @param leafSize Leaf size of the tree of each shard.
+   * @param searchMode Search mode of each shard.
+   * @param epsilon Relative approximation error of each shard.
+   */
+  void BuildModel(const arma::mat& referenceSet,
+                  const size_t shards,
+                  const size_t leafSize,
+                  const NeighborSearchMode searchMode,
+                  const double epsilon = 0);
+
+  /**
+   * Append the given model, already built on its shard, to the shards; its
+   * points are numbered after those of the previous shards.
+   *
+   * @param shard Model of the new shard.
+   */
+  void AddShard(NSModel<SortPolicy>&& shard);
+
+  /**
+   * Find the k neighbors of each query point among the points of all shards.
+   * Several threads may search the model at once.
+   *
+   * @param querySet Set of query points.
+   * @param k Number of neighbors to find.
+   * @param neighbors Matrix to store the indices of the neighbors in.
+   * @param distances Matrix to store the distances to the neighbors in.
+   * @param prune Whether to skip the shards that cannot improve the neighbors
+   *     of a query.
+   */
+  void Search(const arma::mat& querySet,
+              const size_t k,
+              arma::Mat<size_t>& neighbors,
+              arma::mat& distances,
+              const bool prune = true) const;
+
+  /**
+   * Merge the neighbor lists of several shards into the k best neighbors of
+   * each query.  The lists of each shard must be sorted (as returned by
+   * NeighborSearch), and may have any number of rows; the index of a neighbor
+   * of shard s is offset by offsets[s].  Entries with an index of size_t() - 1
+   * end the list of a query, and are also used to pad the results if there are
+   * fewer than k neighbors.
+   *
+   * @param shardNeighbors Neighbors of the queries in each shard.
+   * @param shardDistances Distances to the neighbors in each shard.
+   * @param offsets Index of the first point of each shard.
+   * @param k Number of neighbors to keep.
+   * @param neighbors Matrix to store the merged neighbors in.
+   * @param distances Matrix to store the merged distances in.
+   */
+  static void Merge(const std::vector<arma::Mat<size_t>>& shardNeighbors,
+                    const std::vector<arma::mat>& shardDistances,
+                    const std::vector<size_t>& offsets,
+                    const size_t k,
+                    arma::Mat<size_t>& neighbors,
+                    arma::mat& distances);
+
+  //! Get the number of shards.
+  size_t NumShards() const { return shards.size(); }
+  //! Get the model of the given shard.
+  const NSModel<SortPolicy>& Shard(const size_t i) const { return shards[i]; }
+  //! Modify the model of the given shard.
+  NSModel<SortPolicy>& Shard(const size_t i) { return shards[i]; }
+  //! Get the index of the first point of the given shard.
+  size_t Offset(const size_t i) const { return offsets[i]; }
+  //! Get the total number of reference points.
+  size_t NumPoints() const;
+
+  //! Get the type of tree built by BuildModel().
+  TreeTypes TreeType() const { return treeType; }
+  //! Modify the type of tree built by BuildModel().
+  TreeTypes& TreeType() { return treeType; }
+
+  //! Get whether BuildModel() uses a random basis.
+  bool RandomBasis() const { return randomBasis; }
+  //! Modify whether BuildModel() uses a random basis.
+  bool& RandomBasis() { return randomBasis; }
+
+  //! Serialize the model.
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */);
+
+ private:
+  //! The type of the bounding box of each shard.
+  typedef bound::HRectBound<metric::EuclideanDistance> BoundType;
+
+  //! Type of tree built by BuildModel().
+  TreeTypes treeType;
+  //! Whether BuildModel() uses a random basis.
+  bool randomBasis;
+  //! The model of each shard.
+  std::vector<NSModel<SortPolicy>> shards;
+  //! The index of the first point of each shard.
+  std::vector<size_t> offsets;
+  //! The bounding box of each shard (empty if it is unknown).
+  std::vector<BoundType> bounds;
+};
+
+} // namespace neighbor
+} // namespace mlpack
+
+// Include implementation.
+#include "sharded_ns_model_impl.hpp"
+
+#endif
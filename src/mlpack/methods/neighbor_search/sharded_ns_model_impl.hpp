@@ -0,0 +1,277 @@
+/**
+ * @file methods/neighbor_search/sharded_ns_model_impl.hpp
+ *
+ * Implementation of ShardedNSModel.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_NEIGHBOR_SEARCH_SHARDED_NS_MODEL_IMPL_HPP
+#define MLPACK_METHODS_NEIGHBOR_SEARCH_SHARDED_NS_MODEL_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "sharded_ns_model.hpp"
+
+#include <boost/serialization/vector.hpp>
+
+namespace mlpack {
+namespace neighbor {
+
+template<typename SortPolicy>
+ShardedNSModel<SortPolicy>::ShardedNSModel(const TreeTypes treeType,
+                                           const bool randomBasis) :
+    treeType(treeType),
+    randomBasis(randomBasis)
+{ /* Nothing to do. */ }
+
+template<typename SortPolicy>
+void ShardedNSModel<SortPolicy>::BuildModel(const arma::mat& referenceSet,
+                                            const size_t shards,
+                                            const size_t leafSize,
+                                            const NeighborSearchMode searchMode,
+                                            const double epsilon)
+{
+  if (shards == 0 || shards > referenceSet.n_cols)
+  {
+    std::ostringstream oss;
+    oss << "ShardedNSModel::BuildModel(): cannot split " << referenceSet.n_cols
+        << " points into " << shards << " shards";
+    throw std::invalid_argument(oss.str());
+  }
+
+  this->shards.clear();
+  this->shards.reserve(shards);
+  offsets.clear();
+  bounds.clear();
+  for (size_t s = 0; s < shards; ++s)
+  {
+    const size_t begin = s * referenceSet.n_cols / shards;
+    const size_t end = (s + 1) * referenceSet.n_cols / shards;
+    arma::mat shard = referenceSet.cols(begin, end - 1);
+
+    // The bounding box is taken before any random basis is applied, so that
+    // it is in the space of the queries.
+    BoundType bound(referenceSet.n_rows);
+    bound |= shard;
+
+    this->shards.push_back(NSModel<SortPolicy>(treeType, randomBasis));
+    this->shards.back().BuildModel(std::move(shard), leafSize, searchMode,
+        epsilon);
+    offsets.push_back(begin);
+    bounds.push_back(std::move(bound));
+  }
+}
+
+template<typename SortPolicy>
+void ShardedNSModel<SortPolicy>::AddShard(NSModel<SortPolicy>&& shard)
+{
+  if (!shards.empty() &&
+      shard.DatasetSize().n_rows != shards.front().DatasetSize().n_rows)
+  {
+    std::ostringstream oss;
+    oss << "ShardedNSModel::AddShard(): the shard has dimensionality "
+        << shard.DatasetSize().n_rows << ", but the other shards have "
+        << "dimensionality " << shards.front().DatasetSize().n_rows;
+    throw std::invalid_argument(oss.str());
+  }
+
+  const size_t offset = NumPoints();
+  bounds.push_back(BoundType());
+  if (!shard.RandomBasis())
+  {
+    bounds.back() = BoundType(shard.DatasetSize().n_rows);
+    bounds.back() |= shard.Dataset();
+  }
+
+  shards.push_back(std::move(shard));
+  offsets.push_back(offset);
+}
+
+template<typename SortPolicy>
+size_t ShardedNSModel<SortPolicy>::NumPoints() const
+{
+  return shards.empty() ? 0 :
+      offsets.back() + shards.back().DatasetSize().n_cols;
+}
+
+template<typename SortPolicy>
+void ShardedNSModel<SortPolicy>::Search(const arma::mat& querySet,
+                                        const size_t k,
+                                        arma::Mat<size_t>& neighbors,
+                                        arma::mat& distances,
+                                        const bool prune) const
+{
+  if (shards.empty())
+  {
+    throw std::invalid_argument("ShardedNSModel::Search(): no shards have "
+        "been built or added");
+  }
+
+  if (k == 0 || k > NumPoints())
+  {
+    std::ostringstream oss;
+    oss << "ShardedNSModel::Search(): requested " << k << " neighbors, but "
+        << "the shards hold " << NumPoints() << " points";
+    throw std::invalid_argument(oss.str());
+  }
+
+  if (querySet.n_rows != shards.front().DatasetSize().n_rows)
+  {
+    std::ostringstream oss;
+    oss << "ShardedNSModel::Search(): the query set has dimensionality "
+        << querySet.n_rows << ", but the shards have dimensionality "
+        << shards.front().DatasetSize().n_rows;
+    throw std::invalid_argument(oss.str());
+  }
+
+  // The best distance from each query to the bounding box of each shard, and
+  // the shard with the best one.
+  arma::mat boundDistances(shards.size(), querySet.n_cols);
+  arma::Row<size_t> home(querySet.n_cols, arma::fill::zeros);
+  for (size_t q = 0; q < querySet.n_cols; ++q)
+  {
+    for (size_t s = 0; s < shards.size(); ++s)
+    {
+      boundDistances(s, q) = (bounds[s].Dim() == 0) ?
+          SortPolicy::BestDistance() :
+          SortPolicy::BestPointToNodeDistance(querySet.col(q), &bounds[s]);
+      if (SortPolicy::IsBetter(boundDistances(s, q),
+          boundDistances(home[q], q)))
+        home[q] = s;
+    }
+  }
+
+  neighbors.set_size(k, querySet.n_cols);
+  neighbors.fill(size_t() - 1);
+  distances.set_size(k, querySet.n_cols);
+  distances.fill(SortPolicy::WorstDistance());
+
+  // Search every query in its home shard first, to get a good bound for the
+  // other shards; the bound is tightened after each shard.
+  for (size_t pass = 0; pass < 2; ++pass)
+  {
+    for (size_t s = 0; s < shards.size(); ++s)
+    {
+      std::vector<arma::uword> selected;
+      for (size_t q = 0; q < querySet.n_cols; ++q)
+      {
+        if ((pass == 0) != (home[q] == s))
+          continue;
+
+        const double bound = SortPolicy::Relax(distances(k - 1, q),
+            shards[s].Epsilon());
+        if (pass == 0 || !prune ||
+            SortPolicy::IsBetter(boundDistances(s, q), bound))
+          selected.push_back(q);
+      }
+
+      if (selected.empty())
+        continue;
+
+      const arma::uvec queries(selected);
+      std::vector<arma::Mat<size_t>> shardNeighbors(2);
+      std::vector<arma::mat> shardDistances(2);
+      shardNeighbors[0] = neighbors.cols(queries);
+      shardDistances[0] = distances.cols(queries);
+
+      SearchStatistics statistics;
+      shards[s].Search(arma::mat(querySet.cols(queries)),
+          std::min(k, (size_t) shards[s].DatasetSize().n_cols),
+          shardNeighbors[1], shardDistances[1], statistics);
+
+      arma::Mat<size_t> mergedNeighbors;
+      arma::mat mergedDistances;
+      Merge(shardNeighbors, shardDistances, { 0, offsets[s] }, k,
+          mergedNeighbors, mergedDistances);
+      neighbors.cols(queries) = mergedNeighbors;
+      distances.cols(queries) = mergedDistances;
+    }
+  }
+}
+
+template<typename SortPolicy>
+void ShardedNSModel<SortPolicy>::Merge(
+    const std::vector<arma::Mat<size_t>>& shardNeighbors,
+    const std::vector<arma::mat>& shardDistances,
+    const std::vector<size_t>& offsets,
+    const size_t k,
+    arma::Mat<size_t>& neighbors,
+    arma::mat& distances)
+{
+  const size_t shards = shardNeighbors.size();
+  if (shardDistances.size() != shards || offsets.size() != shards)
+  {
+    throw std::invalid_argument("ShardedNSModel::Merge(): the numbers of "
+        "neighbor lists, distance lists and offsets differ");
+  }
+
+  const size_t queries = (shards == 0) ? 0 : shardNeighbors[0].n_cols;
+  for (size_t s = 0; s < shards; ++s)
+  {
+    if (shardNeighbors[s].n_cols != queries ||
+        shardDistances[s].n_rows != shardNeighbors[s].n_rows ||
+        shardDistances[s].n_cols != queries)
+    {
+      std::ostringstream oss;
+      oss << "ShardedNSModel::Merge(): the neighbors and distances of shard "
+          << s << " do not have the same size as those of shard 0";
+      throw std::invalid_argument(oss.str());
+    }
+  }
+
+  neighbors.set_size(k, queries);
+  distances.set_size(k, queries);
+
+  #pragma omp parallel for
+  for (omp_size_t q = 0; q < (omp_size_t) queries; ++q)
+  {
+    // The position of the next candidate of each shard.
+    std::vector<size_t> positions(shards, 0);
+    for (size_t i = 0; i < k; ++i)
+    {
+      size_t best = shards;
+      for (size_t s = 0; s < shards; ++s)
+      {
+        const size_t p = positions[s];
+        if (p == shardNeighbors[s].n_rows ||
+            shardNeighbors[s](p, q) == size_t() - 1)
+          continue;
+
+        if (best == shards || SortPolicy::IsBetter(shardDistances[s](p, q),
+            shardDistances[best](positions[best], q)))
+          best = s;
+      }
+
+      if (best == shards)
+      {
+        neighbors(i, q) = size_t() - 1;
+        distances(i, q) = SortPolicy::WorstDistance();
+        continue;
+      }
+
+      neighbors(i, q) = shardNeighbors[best](positions[best], q) +
+          offsets[best];
+      distances(i, q) = shardDistances[best](positions[best], q);
+      ++positions[best];
+    }
+  }
+}
+
+template<typename SortPolicy>
+template<typename Archive>
+void ShardedNSModel<SortPolicy>::serialize(Archive& ar,
+                                           const unsigned int /* version */)
+{
+  ar & BOOST_SERIALIZATION_NVP(treeType);
+  ar & BOOST_SERIALIZATION_NVP(randomBasis);
+  ar & BOOST_SERIALIZATION_NVP(shards);
+  ar & BOOST_SERIALIZATION_NVP(offsets);
+  ar & BOOST_SERIALIZATION_NVP(bounds);
+}
+
+} // namespace neighbor
+} // namespace mlpack
+
+#endif
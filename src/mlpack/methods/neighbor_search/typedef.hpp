@@ -66,6 +66,31 @@ using DefeatistKNN = NeighborSearch<
  */
 typedef DefeatistKNN<tree::SPTree> SpillKNN;
 
+#ifndef MLPACK_NO_EXTERN_TEMPLATES
+
+// The most common neighbor search types are compiled once, in libmlpack (see
+// neighbor_search.cpp), instead of in every program that uses them; the cover
+// tree types are declared in ns_model.hpp.  Define MLPACK_NO_EXTERN_TEMPLATES
+// to compile them in each program instead.
+extern template class NeighborSearch<NearestNeighborSort,
+    metric::EuclideanDistance, arma::mat, tree::KDTree>;
+extern template class NeighborSearch<NearestNeighborSort,
+    metric::EuclideanDistance, arma::mat, tree::BallTree>;
+extern template class NeighborSearch<NearestNeighborSort,
+    metric::EuclideanDistance, arma::fmat, tree::KDTree>;
+extern template class NeighborSearch<NearestNeighborSort,
+    metric::EuclideanDistance, arma::fmat, tree::BallTree>;
+extern template class NeighborSearch<FurthestNeighborSort,
+    metric::EuclideanDistance, arma::mat, tree::KDTree>;
+extern template class NeighborSearch<FurthestNeighborSort,
+    metric::EuclideanDistance, arma::mat, tree::BallTree>;
+extern template class NeighborSearch<FurthestNeighborSort,
+    metric::EuclideanDistance, arma::fmat, tree::KDTree>;
+extern template class NeighborSearch<FurthestNeighborSort,
+    metric::EuclideanDistance, arma::fmat, tree::BallTree>;
+
+#endif
+
 } // namespace neighbor
 } // namespace mlpack
 
@@ -61,7 +61,11 @@ BINDING_LONG_DESC(
     "The maximum number of iterations is specified with " +
     PRINT_PARAM_STRING("max_iterations") + ", and the minimum residue "
     "required for algorithm termination is specified with the " +
-    PRINT_PARAM_STRING("min_residue") + " parameter.");
+    PRINT_PARAM_STRING("min_residue") + " parameter."
+    "\n\n"
+    "If most of the entries of the input are zero, the " +
+    PRINT_PARAM_STRING("sparse") + " flag can be given to factorize it as a "
+    "sparse matrix; the update rules then only visit its nonzero entries.");
 
 // Example.
 BINDING_EXAMPLE(
@@ -103,6 +107,8 @@ PARAM_STRING_IN("update_rules", "Update rules for each iteration; ( multdist | "
 PARAM_MATRIX_IN("initial_w", "Initial W matrix.", "p");
 PARAM_MATRIX_IN("initial_h", "Initial H matrix.", "q");
 
+PARAM_FLAG("sparse", "Factorize the input as a sparse matrix.", "S");
+
 void LoadInitialWH(const bool bindingTransposed, arma::mat& w, arma::mat& h)
 {
   // Note that these datasets will typically be transposed on load, since we are
@@ -138,8 +144,8 @@ void SaveWH(const bool bindingTransposed, arma::mat&& w, arma::mat&& h)
   }
 }
 
-template<typename UpdateRuleType>
-void ApplyFactorization(const arma::mat& V,
+template<typename UpdateRuleType, typename MatType>
+void ApplyFactorization(const MatType& V,
                         const size_t r,
                         arma::mat& W,
                         arma::mat& H)
@@ -200,6 +206,34 @@ void ApplyFactorization(const arma::mat& V,
   }
 }
 
+template<typename MatType>
+void Factorize(const MatType& V,
+               const size_t r,
+               const string& updateRules,
+               arma::mat& W,
+               arma::mat& H)
+{
+  // Perform NMF with the specified update rules.
+  if (updateRules == "multdist")
+  {
+    Log::Info << "Performing NMF with multiplicative distance-based update "
+        << "rules." << std::endl;
+    ApplyFactorization<NMFMultiplicativeDistanceUpdate>(V, r, W, H);
+  }
+  else if (updateRules == "multdiv")
+  {
+    Log::Info << "Performing NMF with multiplicative divergence-based update "
+        << "rules." << std::endl;
+    ApplyFactorization<NMFMultiplicativeDivergenceUpdate>(V, r, W, H);
+  }
+  else if (updateRules == "als")
+  {
+    Log::Info << "Performing NMF with alternating least squared update rules."
+        << std::endl;
+    ApplyFactorization<NMFALSUpdate>(V, r, W, H);
+  }
+}
+
 static void mlpackMain()
 {
   // Initialize random seed.
@@ -227,24 +261,17 @@ static void mlpackMain()
   arma::mat W;
   arma::mat H;
 
-  // Perform NMF with the specified update rules.
-  if (updateRules == "multdist")
-  {
-    Log::Info << "Performing NMF with multiplicative distance-based update "
-        << "rules." << std::endl;
-    ApplyFactorization<NMFMultiplicativeDistanceUpdate>(V, r, W, H);
-  }
-  else if (updateRules == "multdiv")
+  if (IO::HasParam("sparse"))
   {
-    Log::Info << "Performing NMF with multiplicative divergence-based update "
-        << "rules." << std::endl;
-    ApplyFactorization<NMFMultiplicativeDivergenceUpdate>(V, r, W, H);
+    const arma::sp_mat sparseV(V);
+    V.reset();
+    Log::Info << "Factorizing a sparse matrix with " << sparseV.n_nonzero
+        << " nonzero entries." << std::endl;
+    Factorize(sparseV, r, updateRules, W, H);
   }
-  else if (updateRules == "als")
+  else
   {
-    Log::Info << "Performing NMF with alternating least squared update rules."
-        << std::endl;
-    ApplyFactorization<NMFALSUpdate>(V, r, W, H);
+    Factorize(V, r, updateRules, W, H);
   }
 
   // Save results.  Remember from our discussion in the comments earlier that we
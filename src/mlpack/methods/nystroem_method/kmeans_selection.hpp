@@ -20,7 +20,11 @@ namespace mlpack {
 namespace kernel {
 
 /**
- * Implementation of the kmeans sampling scheme.
+ * Implementation of the kmeans sampling scheme.  With the default clustering
+ * type, each iteration assigns blocks of points to the centroids with a matrix
+ * multiplication, in parallel (see kmeans::NaiveKMeans); for very large
+ * datasets, a KMeans type with the kmeans::MiniBatchKMeans step can be given
+ * instead.
  *
  * @tparam ClusteringType Type of clustering.
  * @tparam maxIterations Maximum number of iterations allowed before giving up.
@@ -16,6 +16,8 @@
 
 #include <mlpack/prereqs.hpp>
 
+#include <unordered_set>
+
 namespace mlpack {
 namespace kernel {
 
@@ -23,7 +25,9 @@ class RandomSelection
 {
  public:
   /**
-   * Randomly select the specified number of points in the dataset.
+   * Randomly select the specified number of distinct points in the dataset
+   * (if m is greater than the number of points, some points are selected more
+   * than once).  This takes O(m) time, whatever the size of the dataset.
    *
    * @param data Dataset to sample from.
    * @param m Number of points to select.
@@ -32,8 +36,27 @@ class RandomSelection
   const static arma::Col<size_t> Select(const arma::mat& data, const size_t m)
   {
     arma::Col<size_t> selectedPoints(m);
-    for (size_t i = 0; i < m; ++i)
-      selectedPoints(i) = math::RandInt(0, data.n_cols);
+    if (m > data.n_cols)
+    {
+      for (size_t i = 0; i < m; ++i)
+        selectedPoints(i) = math::RandInt(0, data.n_cols);
+
+      return selectedPoints;
+    }
+
+    // Floyd's algorithm: after the iteration with j, the selected points are
+    // a uniformly random subset of [0, j].  Duplicate landmarks would only
+    // make the mini-kernel matrix singular.
+    std::unordered_set<size_t> selected;
+    selected.reserve(m);
+    size_t i = 0;
+    for (size_t j = data.n_cols - m; j < data.n_cols; ++j, ++i)
+    {
+      const size_t t = math::RandInt(0, j + 1);
+      const size_t point = (selected.count(t) == 0) ? t : j;
+      selected.insert(point);
+      selectedPoints(i) = point;
+    }
 
     return selectedPoints;
   }
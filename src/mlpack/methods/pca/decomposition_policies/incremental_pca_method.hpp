@@ -0,0 +1,255 @@
+/**
+ * @file methods/pca/decomposition_policies/incremental_pca_method.hpp
+ *
+ * Implementation of the incremental PCA policy for use in the Principal
+ * Components Analysis method.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+
+#ifndef MLPACK_METHODS_PCA_DECOMPOSITION_POLICIES_INCREMENTAL_PCA_METHOD_HPP
+#define MLPACK_METHODS_PCA_DECOMPOSITION_POLICIES_INCREMENTAL_PCA_METHOD_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace pca {
+
+/**
+ * Implementation of the incremental PCA policy.  The mean of the points and a
+ * low-rank SVD of the centered points are updated batch by batch, with the
+ * incremental SVD of the following paper, so only the current batch and the
+ * rank-k factorization are kept in memory:
+ *
+ * @code
+ * @article{Ross2008,
+ *   author  = {Ross, David A. and Lim, Jongwoo and Lin, Ruei-Sung and
+ *              Yang, Ming-Hsuan},
+ *   title   = {Incremental Learning for Robust Visual Tracking},
+ *   journal = {International Journal of Computer Vision},
+ *   volume  = {77},
+ *   number  = {1},
+ *   pages   = {125--141},
+ *   year    = {2008},
+ * }
+ * @endcode
+ *
+ * Each batch B with m points is centered on its own mean, and a column that
+ * accounts for the move of the mean is appended to it; the part of B outside
+ * of the current basis U is orthonormalized into Q, and the SVD of the small
+ * (k + m + 1) x (k + m + 1) matrix [diag(s), U^T B; 0, Q^T B] gives the new
+ * factorization.  The cost of a batch is O(d (k + m)^2) for d dimensions.
+ *
+ * When used by PCA::Apply() on a matrix, the points are visited in batches of
+ * BatchSize() columns.  Data which doesn't fit in memory can instead be given
+ * batch by batch to Update(), or read from a data::PrefetchLoader by
+ * PCA::Apply():
+ *
+ * @code
+ * IncrementalPCAPolicy policy;
+ * for (size_t i = 0; i < numBatches; ++i)
+ *   policy.Update(batches[i], 10);
+ *
+ * arma::mat transformed;
+ * policy.Transform(newPoints, transformed);
+ * @endcode
+ */
+class IncrementalPCAPolicy
+{
+ public:
+  /**
+   * Use the incremental SVD to perform the principal components analysis
+   * (PCA).
+   *
+   * @param batchSize Number of points in each batch when a whole matrix is
+   *     given to Apply().
+   */
+  IncrementalPCAPolicy(const size_t batchSize = 1000) :
+      batchSize(batchSize),
+      numPoints(0)
+  {
+    if (batchSize == 0)
+    {
+      throw std::invalid_argument("IncrementalPCAPolicy::"
+          "IncrementalPCAPolicy(): the batch size must be positive!");
+    }
+  }
+
+  /**
+   * Apply Principal Component Analysis to the provided data set, visiting the
+   * centered points in batches.
+   *
+   * @param * (data) Data matrix.
+   * @param centeredData Centered data matrix.
+   * @param transformedData Matrix to put results of PCA into.
+   * @param eigVal Vector to put eigenvalues into.
+   * @param eigvec Matrix to put eigenvectors (loadings) into.
+   * @param rank Rank of the decomposition.
+   */
+  void Apply(const arma::mat& /* data */,
+             const arma::mat& centeredData,
+             arma::mat& transformedData,
+             arma::vec& eigVal,
+             arma::mat& eigvec,
+             const size_t rank)
+  {
+    Reset();
+    for (size_t start = 0; start < centeredData.n_cols; start += batchSize)
+    {
+      const size_t end = std::min(start + batchSize,
+          (size_t) centeredData.n_cols) - 1;
+      Update(centeredData.cols(start, end), rank);
+    }
+
+    EigenValues(eigVal);
+    eigvec = u;
+
+    // Project the samples to the principals.
+    transformedData = arma::trans(eigvec) * centeredData;
+  }
+
+  /**
+   * Add the given batch of points to the factorization, updating the mean and
+   * keeping at most the given number of principal components.
+   *
+   * @param batch New points, one per column.
+   * @param rank Maximum number of principal components to keep.
+   */
+  void Update(const arma::mat& batch, const size_t rank)
+  {
+    if (batch.n_cols == 0)
+      return;
+
+    if (rank == 0)
+    {
+      throw std::invalid_argument("IncrementalPCAPolicy::Update(): the rank "
+          "must be positive!");
+    }
+
+    if (numPoints > 0 && batch.n_rows != mean.n_elem)
+    {
+      throw std::invalid_argument("IncrementalPCAPolicy::Update(): the batch "
+          "has " + std::to_string(batch.n_rows) + " dimensions, but the "
+          "factorization has " + std::to_string(mean.n_elem) + "!");
+    }
+
+    const size_t m = batch.n_cols;
+    const arma::vec batchMean = arma::mean(batch, 1);
+    arma::mat centered = batch.each_col() - batchMean;
+
+    if (numPoints == 0)
+    {
+      mean = batchMean;
+      numPoints = m;
+
+      arma::mat v;
+      arma::svd_econ(u, s, v, centered, 'l');
+      Truncate(rank);
+      return;
+    }
+
+    // Moving the mean adds a rank-one term to the scatter of the points.
+    const double n = (double) numPoints;
+    arma::mat b(batch.n_rows, m + 1);
+    b.head_cols(m) = centered;
+    b.col(m) = std::sqrt(n * m / (n + m)) * (batchMean - mean);
+    centered.reset();
+
+    // Split the batch into its part in the span of u and the rest.
+    const arma::mat projection = u.t() * b;
+    arma::mat q, r;
+    arma::qr_econ(q, r, b - u * projection);
+
+    const size_t k = s.n_elem;
+    arma::mat middle(k + r.n_rows, k + b.n_cols, arma::fill::zeros);
+    middle.submat(0, 0, k - 1, k - 1) = arma::diagmat(s);
+    middle.submat(0, k, k - 1, middle.n_cols - 1) = projection;
+    middle.submat(k, k, middle.n_rows - 1, middle.n_cols - 1) = r;
+
+    arma::mat middleU, middleV;
+    arma::svd_econ(middleU, s, middleV, middle, 'l');
+    u = arma::join_rows(u, q) * middleU;
+    Truncate(rank);
+
+    mean = (n * mean + m * batchMean) / (n + m);
+    numPoints += m;
+  }
+
+  /**
+   * Project the given points onto the principal components.
+   *
+   * @param data Points to transform, one per column.
+   * @param transformedData Matrix to put the principal components of each
+   *     point into.
+   */
+  void Transform(const arma::mat& data, arma::mat& transformedData) const
+  {
+    transformedData = u.t() * data;
+    transformedData.each_col() -= u.t() * mean;
+  }
+
+  /**
+   * Get the eigenvalues of the covariance matrix of the points seen so far.
+   *
+   * @param eigVal Vector to put eigenvalues into.
+   */
+  void EigenValues(arma::vec& eigVal) const
+  {
+    // The covariance matrix is X * X' / (N - 1).
+    eigVal = arma::square(s) / std::max<double>(numPoints - 1.0, 1.0);
+  }
+
+  //! Forget all the points seen so far.
+  void Reset()
+  {
+    u.reset();
+    s.reset();
+    mean.reset();
+    numPoints = 0;
+  }
+
+  //! Get the principal components (eigenvectors), one per column.
+  const arma::mat& EigenVectors() const { return u; }
+  //! Get the singular values of the centered points.
+  const arma::vec& SingularValues() const { return s; }
+  //! Get the mean of the points seen so far.
+  const arma::vec& Mean() const { return mean; }
+  //! Get the number of points seen so far.
+  size_t NumPoints() const { return numPoints; }
+
+  //! Get the batch size.
+  size_t BatchSize() const { return batchSize; }
+  //! Modify the batch size.
+  size_t& BatchSize() { return batchSize; }
+
+ private:
+  //! Keep at most the given number of principal components.
+  void Truncate(const size_t rank)
+  {
+    if (s.n_elem > rank)
+    {
+      u = u.head_cols(rank);
+      s = s.head(rank);
+    }
+  }
+
+  //! Locally stored batch size.
+  size_t batchSize;
+
+  //! The principal components.
+  arma::mat u;
+  //! The singular values of the centered points.
+  arma::vec s;
+  //! The mean of the points.
+  arma::vec mean;
+  //! The number of points seen so far.
+  size_t numPoints;
+};
+
+} // namespace pca
+} // namespace mlpack
+
+#endif
@@ -77,6 +77,44 @@ class RandomizedBlockKrylovSVDPolicy
     transformedData = arma::trans(eigvec) * centeredData;
   }
 
+  /**
+   * Apply Principal Component Analysis to the provided sparse data set using
+   * the randomized block krylov SVD method, without densifying it; the data
+   * is centered implicitly.
+   *
+   * @param data Sparse data matrix.
+   * @param rowMean Mean of the points of the data.
+   * @param transformedData Matrix to put results of PCA into.
+   * @param eigVal Vector to put eigenvalues into.
+   * @param eigvec Matrix to put eigenvectors (loadings) into.
+   * @param rank Rank of the decomposition.
+   */
+  void Apply(const arma::sp_mat& data,
+             const arma::vec& rowMean,
+             arma::mat& transformedData,
+             arma::vec& eigVal,
+             arma::mat& eigvec,
+             const size_t rank)
+  {
+    // This matrix will store the right singular values; we do not need them.
+    arma::mat v;
+
+    svd::RandomizedBlockKrylovSVD rsvd(maxIterations, blockSize);
+    rsvd.Apply(data, eigvec, eigVal, v, rank, rowMean);
+
+    // Now we must square the singular values to get the eigenvalues.
+    // In addition we must divide by the number of points, because the
+    // covariance matrix is X * X' / (N - 1).
+    eigVal %= eigVal / (data.n_cols - 1);
+
+    // Project the samples to the principals: eigvec^T (X - mu 1^T) is the
+    // transpose of X^T eigvec, minus eigvec^T mu in each column.
+    arma::mat projection;
+    math::SparseTransTimes(data, eigvec, projection);
+    transformedData = projection.t();
+    transformedData.each_col() -= arma::trans(eigvec) * rowMean;
+  }
+
   //! Get the number of iterations for the power method.
   size_t MaxIterations() const { return maxIterations; }
   //! Modify the number of iterations for the power method.
@@ -17,6 +17,7 @@
 #define MLPACK_METHODS_PCA_PCA_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/data/prefetch_loader.hpp>
 #include <mlpack/methods/pca/decomposition_policies/exact_svd_method.hpp>
 
 namespace mlpack {
@@ -105,6 +106,47 @@ class PCA
    */
   double Apply(arma::mat& data, const double varRetained);
 
+  /**
+   * Use PCA for dimensionality reduction on the given sparse dataset, without
+   * densifying it: the mean is subtracted implicitly by the decomposition, and
+   * the scaling (if any) is applied to the nonzeros only.  This will save the
+   * newDimension largest principal components of each point into
+   * transformedData.  The parameter returned is the amount of the total
+   * variance of the data that is retained.  The decomposition policy must
+   * provide a sparse Apply(), like RandomizedSVDPolicy and
+   * RandomizedBlockKrylovSVDPolicy.
+   *
+   * @param data Sparse data matrix.
+   * @param transformedData Matrix to store the principal components of each
+   *     point in.
+   * @param newDimension New dimension of the data.
+   * @return Amount of the variance of the data retained (between 0 and 1).
+   */
+  double Apply(const arma::sp_mat& data,
+               arma::mat& transformedData,
+               const size_t newDimension);
+
+  /**
+   * Apply Principal Component Analysis to the points read chunk by chunk from
+   * the given loader (the responses of the chunks are ignored), keeping at
+   * most the given number of principal components.  Each chunk is given to
+   * the Update() method of the decomposition policy, so the policy must be
+   * incremental, like IncrementalPCAPolicy; the principal components of new
+   * points can then be computed with Decomposition().Transform().  The data
+   * can't be scaled, since the standard deviations are not known before the
+   * last chunk.
+   *
+   * @param loader The loader of the chunks.
+   * @param eigVal Vector to put eigenvalues into.
+   * @param eigvec Matrix to put eigenvectors (loadings) into.
+   * @param rank Maximum number of principal components to keep.
+   */
+  template<typename SourceType>
+  void Apply(data::PrefetchLoader<SourceType>& loader,
+             arma::vec& eigVal,
+             arma::mat& eigvec,
+             const size_t rank);
+
   //! Get whether or not this PCA object will scale (by standard deviation)
   //! the data when PCA is performed.
   bool ScaleData() const { return scaleData; }
@@ -112,6 +154,11 @@ class PCA
   //! the data when PCA is performed.
   bool& ScaleData() { return scaleData; }
 
+  //! Get the decomposition policy.
+  const DecompositionPolicy& Decomposition() const { return decomposition; }
+  //! Modify the decomposition policy.
+  DecompositionPolicy& Decomposition() { return decomposition; }
+
  private:
   //! Scaling the data is when we reduce the variance of each dimension to 1.
   void ScaleData(arma::mat& centeredData)
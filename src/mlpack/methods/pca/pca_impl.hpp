@@ -171,6 +171,108 @@ double PCA<DecompositionPolicy>::Apply(arma::mat& data,
   return varSum;
 }
 
+/**
+ * Use PCA for dimensionality reduction on the given sparse dataset, without
+ * densifying it.
+ */
+template<typename DecompositionPolicy>
+double PCA<DecompositionPolicy>::Apply(const arma::sp_mat& data,
+                                       arma::mat& transformedData,
+                                       const size_t newDimension)
+{
+  // Parameter validation.
+  if (newDimension == 0)
+    Log::Fatal << "PCA::Apply(): newDimension (" << newDimension << ") cannot "
+        << "be zero!" << std::endl;
+  if (newDimension > data.n_rows)
+    Log::Fatal << "PCA::Apply(): newDimension (" << newDimension << ") cannot "
+        << "be greater than the existing dimensionality of the data ("
+        << data.n_rows << ")!" << std::endl;
+
+  arma::mat eigvec;
+  arma::vec eigVal;
+
+  Timer::Start("pca");
+
+  // The mean and the variance of each dimension only need the nonzeros.
+  arma::vec rowMean = arma::mat(arma::sum(data, 1)) / data.n_cols;
+  arma::vec variance = (arma::mat(arma::sum(arma::square(data), 1)) -
+      data.n_cols * arma::square(rowMean)) / (data.n_cols - 1);
+  variance.transform([](const double x) { return std::max(x, 0.0); });
+
+  if (scaleData)
+  {
+    // Dividing each dimension by its standard deviation keeps the zeros.
+    arma::vec stdDev = arma::sqrt(variance);
+    for (size_t i = 0; i < stdDev.n_elem; ++i)
+      if (stdDev[i] == 0)
+        stdDev[i] = 1e-50;
+
+    arma::sp_mat scaledData(data);
+    for (arma::sp_mat::iterator it = scaledData.begin();
+        it != scaledData.end(); ++it)
+      (*it) /= stdDev[it.row()];
+
+    rowMean /= stdDev;
+    variance /= arma::square(stdDev);
+
+    decomposition.Apply(scaledData, rowMean, transformedData, eigVal, eigvec,
+        newDimension);
+  }
+  else
+  {
+    decomposition.Apply(data, rowMean, transformedData, eigVal, eigvec,
+        newDimension);
+  }
+
+  if (newDimension < transformedData.n_rows)
+    // Drop unnecessary rows.
+    transformedData.shed_rows(newDimension, transformedData.n_rows - 1);
+
+  const size_t eigDim = std::min(newDimension, (size_t) eigVal.n_elem);
+
+  Timer::Stop("pca");
+
+  // The total variance is the trace of the covariance matrix.
+  const double totalVariance = arma::accu(variance);
+  if (totalVariance == 0.0)
+    return 1.0;
+
+  return std::min(1.0, arma::accu(eigVal.head(eigDim)) / totalVariance);
+}
+
+/**
+ * Apply Principal Component Analysis to the points read chunk by chunk from
+ * the given loader, with an incremental decomposition policy.
+ */
+template<typename DecompositionPolicy>
+template<typename SourceType>
+void PCA<DecompositionPolicy>::Apply(data::PrefetchLoader<SourceType>& loader,
+                                     arma::vec& eigVal,
+                                     arma::mat& eigvec,
+                                     const size_t rank)
+{
+  if (scaleData)
+    Log::Fatal << "PCA::Apply(): the data can't be scaled when it is read "
+        << "from a loader!" << std::endl;
+  if (rank == 0)
+    Log::Fatal << "PCA::Apply(): rank (" << rank << ") cannot be zero!"
+        << std::endl;
+
+  Timer::Start("pca");
+
+  arma::mat chunk, responses;
+  decomposition.Reset();
+  loader.Reset();
+  while (loader.Next(chunk, responses))
+    decomposition.Update(chunk, rank);
+
+  decomposition.EigenValues(eigVal);
+  eigvec = decomposition.EigenVectors();
+
+  Timer::Stop("pca");
+}
+
 } // namespace pca
 } // namespace mlpack
 
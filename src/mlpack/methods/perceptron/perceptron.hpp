@@ -95,6 +95,23 @@ class Perceptron
    * This training does not reset the model weights, so you can call Train() on
    * multiple datasets sequentially.
    *
+   * If NumShards() is greater than 1, the perceptron is trained with
+   * iterative parameter mixing: in each iteration the dataset is split into
+   * that many contiguous shards, a pass is made over each shard in parallel
+   * (each starting from the current weights), and the weights of the shards
+   * are averaged.  Training stops when no shard misclassifies a point.
+   *
+   * @code
+   * @inproceedings{mcdonald2010distributed,
+   *   title={Distributed Training Strategies for the Structured Perceptron},
+   *   author={McDonald, Ryan and Hall, Keith and Mann, Gideon},
+   *   booktitle={Human Language Technologies: The 2010 Annual Conference of
+   *       the North American Chapter of the ACL},
+   *   pages={456--464},
+   *   year={2010}
+   * }
+   * @endcode
+   *
    * @param data Dataset on which training should be performed.
    * @param labels Labels of the dataset.
    * @param numClasses Number of classes in the data.
@@ -108,7 +125,8 @@ class Perceptron
 
   /**
    * Classification function. After training, use the weights matrix to
-   * classify test, and put the predicted classes in predictedLabels.
+   * classify test, and put the predicted classes in predictedLabels.  The
+   * points are scored in blocks, with one matrix multiplication per block.
    *
    * @param test Testing data or data to classify.
    * @param predictedLabels Vector to store the predicted classes after
@@ -127,6 +145,13 @@ class Perceptron
   //! Modify the maximum number of iterations.
   size_t& MaxIterations() { return maxIterations; }
 
+  //! Get the number of shards used for parallel training (1 for serial
+  //! training).
+  size_t NumShards() const { return numShards; }
+  //! Modify the number of shards used for parallel training (1 for serial
+  //! training).
+  size_t& NumShards() { return numShards; }
+
   //! Get the number of classes this perceptron has been trained for.
   size_t NumClasses() const { return weights.n_cols; }
 
@@ -141,9 +166,26 @@ class Perceptron
   arma::vec& Biases() { return biases; }
 
  private:
+  /**
+   * Make one pass of the perceptron learning algorithm over the points
+   * [begin, end) of the dataset, updating the given weights and biases, and
+   * return the number of misclassified points.
+   */
+  size_t Pass(const MatType& data,
+              const arma::Row<size_t>& labels,
+              const arma::rowvec& instanceWeights,
+              const size_t begin,
+              const size_t end,
+              arma::mat& passWeights,
+              arma::vec& passBiases) const;
+
   //! The maximum number of iterations during training.
   size_t maxIterations;
 
+  //! The number of shards used for parallel training.  This is not
+  //! serialized, since it does not change the model.
+  size_t numShards;
+
   /**
    * Stores the weights for each of the input class labels.  Each column
    * corresponds to the weights for one class label, and each row corresponds to
@@ -30,7 +30,8 @@ Perceptron<LearnPolicy, WeightInitializationPolicy, MatType>::Perceptron(
     const size_t numClasses,
     const size_t dimensionality,
     const size_t maxIterations) :
-    maxIterations(maxIterations)
+    maxIterations(maxIterations),
+    numShards(1)
 {
   WeightInitializationPolicy wip;
   wip.Initialize(weights, biases, dimensionality, numClasses);
@@ -56,7 +57,8 @@ Perceptron<LearnPolicy, WeightInitializationPolicy, MatType>::Perceptron(
     const arma::Row<size_t>& labels,
     const size_t numClasses,
     const size_t maxIterations) :
-    maxIterations(maxIterations)
+    maxIterations(maxIterations),
+    numShards(1)
 {
   // Start training.
   Train(data, labels, numClasses);
@@ -84,7 +86,8 @@ Perceptron<LearnPolicy, WeightInitializationPolicy, MatType>::Perceptron(
     const arma::Row<size_t>& labels,
     const size_t numClasses,
     const arma::rowvec& instanceWeights) :
-    maxIterations(other.maxIterations)
+    maxIterations(other.maxIterations),
+    numShards(other.numShards)
 {
   Train(data, labels, numClasses, instanceWeights);
 }
@@ -106,27 +109,24 @@ void Perceptron<LearnPolicy, WeightInitializationPolicy, MatType>::Classify(
     const MatType& test,
     arma::Row<size_t>& predictedLabels)
 {
-  arma::vec tempLabelMat;
-  arma::uword maxIndex = 0;
+  predictedLabels.set_size(test.n_cols);
 
-  // Could probably be faster if done in batch.
-  for (size_t i = 0; i < test.n_cols; ++i)
+  // Score the points in blocks, so that the scores of a block are computed
+  // with one matrix multiplication but the whole score matrix is not held in
+  // memory.
+  const size_t blockSize = 4096;
+  for (size_t begin = 0; begin < test.n_cols; begin += blockSize)
   {
-    tempLabelMat = weights.t() * test.col(i) + biases;
-    tempLabelMat.max(maxIndex);
-    predictedLabels(0, i) = maxIndex;
+    const size_t end = std::min(begin + blockSize, (size_t) test.n_cols) - 1;
+    arma::mat scores = weights.t() * test.cols(begin, end);
+    scores.each_col() += biases;
+
+    const arma::urowvec maxIndices = arma::index_max(scores, 0);
+    for (size_t i = 0; i < maxIndices.n_elem; ++i)
+      predictedLabels[begin + i] = maxIndices[i];
   }
 }
 
-/**
- * Training function.  It trains on trainData using the cost matrix
- * instanceWeights.
- *
- * @param data Data to train on.
- * @param labels Labels of data.
- * @param instanceWeights Cost matrix. Stores the cost of mispredicting
- *      instances.  This is useful for boosting.
- */
 template<
     typename LearnPolicy,
     typename WeightInitializationPolicy,
@@ -139,15 +139,80 @@ void Perceptron<LearnPolicy, WeightInitializationPolicy, MatType>::Train(
     const arma::rowvec& instanceWeights)
 {
   // Do we need to resize the weights?
-  if (weights.n_elem != numClasses)
+  if (weights.n_cols != numClasses || weights.n_rows != data.n_rows)
   {
     WeightInitializationPolicy wip;
     wip.Initialize(weights, biases, data.n_rows, numClasses);
   }
 
-  size_t j, i = 0;
+  size_t i = 0;
   bool converged = false;
-  size_t tempLabel;
+
+  const size_t shards = std::max((size_t) 1, std::min(numShards,
+      (size_t) data.n_cols));
+  if (shards == 1)
+  {
+    // This loop is for each iteration, and we stop when a pass over the
+    // dataset classifies every point correctly.
+    while ((i < maxIterations) && (!converged))
+    {
+      ++i;
+      converged = (Pass(data, labels, instanceWeights, 0, data.n_cols, weights,
+          biases) == 0);
+    }
+
+    return;
+  }
+
+  std::vector<arma::mat> shardWeights(shards);
+  std::vector<arma::vec> shardBiases(shards);
+  while ((i < maxIterations) && (!converged))
+  {
+    ++i;
+
+    // Each shard makes a pass from the current weights.
+    size_t mistakes = 0;
+    #pragma omp parallel for schedule(dynamic) reduction(+:mistakes)
+    for (omp_size_t s = 0; s < (omp_size_t) shards; ++s)
+    {
+      const size_t begin = (data.n_cols * s) / shards;
+      const size_t end = (data.n_cols * (s + 1)) / shards;
+
+      shardWeights[s] = weights;
+      shardBiases[s] = biases;
+      mistakes += Pass(data, labels, instanceWeights, begin, end,
+          shardWeights[s], shardBiases[s]);
+    }
+    converged = (mistakes == 0);
+
+    // Mix the weights of the shards uniformly.
+    weights = shardWeights[0];
+    biases = shardBiases[0];
+    for (size_t s = 1; s < shards; ++s)
+    {
+      weights += shardWeights[s];
+      biases += shardBiases[s];
+    }
+    weights /= shards;
+    biases /= shards;
+  }
+}
+
+template<
+    typename LearnPolicy,
+    typename WeightInitializationPolicy,
+    typename MatType
+>
+size_t Perceptron<LearnPolicy, WeightInitializationPolicy, MatType>::Pass(
+    const MatType& data,
+    const arma::Row<size_t>& labels,
+    const arma::rowvec& instanceWeights,
+    const size_t begin,
+    const size_t end,
+    arma::mat& passWeights,
+    arma::vec& passBiases) const
+{
+  size_t mistakes = 0;
   arma::uword maxIndexRow = 0, maxIndexCol = 0;
   arma::mat tempLabelMat;
 
@@ -155,41 +220,33 @@ void Perceptron<LearnPolicy, WeightInitializationPolicy, MatType>::Train(
 
   const bool hasWeights = (instanceWeights.n_elem > 0);
 
-  while ((i < maxIterations) && (!converged))
+  for (size_t j = begin; j < end; ++j)
   {
-    // This outer loop is for each iteration, and we use the 'converged'
-    // variable for noting whether or not convergence has been reached.
-    ++i;
-    converged = true;
+    // Multiply for each variable and check whether the current weight vector
+    // correctly classifies this.
+    tempLabelMat = passWeights.t() * data.col(j) + passBiases;
+
+    tempLabelMat.max(maxIndexRow, maxIndexCol);
 
-    // Now this inner loop is for going through the dataset in each iteration.
-    for (j = 0; j < data.n_cols; ++j)
+    // Check whether prediction is correct.
+    if (maxIndexRow != labels(0, j))
     {
-      // Multiply for each variable and check whether the current weight vector
-      // correctly classifies this.
-      tempLabelMat = weights.t() * data.col(j) + biases;
-
-      tempLabelMat.max(maxIndexRow, maxIndexCol);
-
-      // Check whether prediction is correct.
-      if (maxIndexRow != labels(0, j))
-      {
-        // Due to incorrect prediction, convergence set to false.
-        converged = false;
-        tempLabel = labels(0, j);
-
-        // Send maxIndexRow for knowing which weight to update, send j to know
-        // the value of the vector to update it with.  Send tempLabel to know
-        // the correct class.
-        if (hasWeights)
-          LP.UpdateWeights(data.col(j), weights, biases, maxIndexRow, tempLabel,
-              instanceWeights(j));
-        else
-          LP.UpdateWeights(data.col(j), weights, biases, maxIndexRow,
-              tempLabel);
-      }
+      ++mistakes;
+      const size_t tempLabel = labels(0, j);
+
+      // Send maxIndexRow for knowing which weight to update, send j to know
+      // the value of the vector to update it with.  Send tempLabel to know the
+      // correct class.
+      if (hasWeights)
+        LP.UpdateWeights(data.col(j), passWeights, passBiases, maxIndexRow,
+            tempLabel, instanceWeights(j));
+      else
+        LP.UpdateWeights(data.col(j), passWeights, passBiases, maxIndexRow,
+            tempLabel);
     }
   }
+
+  return mistakes;
 }
 
 //! Serialize the perceptron.
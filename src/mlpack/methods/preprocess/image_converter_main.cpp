@@ -37,7 +37,11 @@ BINDING_LONG_DESC(
     PRINT_PARAM_STRING("height") + " width " + PRINT_PARAM_STRING("width")
     + " and channel " + PRINT_PARAM_STRING("channels") + " of the images that"
     " needs to be loaded; otherwise, these parameters will be automatically"
-    " detected from the image."
+    " detected from the image.  If " + PRINT_PARAM_STRING("height") + " and " +
+    PRINT_PARAM_STRING("width") + " are given when loading images, each image"
+    " is resized to that size, and if " + PRINT_PARAM_STRING("normalize") +
+    " is specified, the pixel values are scaled to [0, 1].  Images are decoded"
+    " in parallel."
     "\n"
     "There are other options too, that can be specified such as " +
     PRINT_PARAM_STRING("quality")
@@ -78,6 +82,8 @@ PARAM_INT_IN("quality", "Compression of the image if saved as jpg (0-100).",
 
 PARAM_INT_IN("height", "Height of the images.", "H", 0);
 PARAM_FLAG("save", "Save a dataset as images.", "s");
+PARAM_FLAG("normalize", "Scale pixel values to [0, 1] when loading images.",
+    "N");
 PARAM_MATRIX_IN("dataset", "Input matrix to save as images.", "I");
 
 static void mlpackMain()
@@ -89,11 +95,20 @@ static void mlpackMain()
 
   if (!IO::HasParam("save"))
   {
-    ReportIgnoredParam("width", "Width of image is determined from file.");
-    ReportIgnoredParam("height", "Height of image is determined from file.");
     ReportIgnoredParam("channels", "Number of channels determined from file.");
+    RequireNoneOrAllPassed({ "width", "height" }, true, "Both width and height "
+        "are needed to resize images!");
+    RequireParamValue<int>("width", [](int x) { return x >= 0;}, true,
+        "width must be positive");
+    RequireParamValue<int>("height", [](int x) { return x >= 0;}, true,
+        "height must be positive");
+
+    // If the size is given, the images are resized to that size.
+    const size_t width = IO::GetParam<int>("width");
+    const size_t height = IO::GetParam<int>("height");
     data::ImageInfo info;
-    Load(fileNames, out, info, true);
+    Load(fileNames, out, info, true, width, height,
+        IO::HasParam("normalize"));
     if (IO::HasParam("output"))
       IO::GetParam<arma::mat>("output") = std::move(out);
   }
@@ -12,6 +12,7 @@
 #include <mlpack/prereqs.hpp>
 #include <mlpack/core/util/io.hpp>
 #include <mlpack/core/util/mlpack_main.hpp>
+#include <mlpack/core/math/moments.hpp>
 
 #include <boost/format.hpp>
 #include <boost/lexical_cast.hpp>
@@ -79,97 +80,6 @@ PARAM_FLAG("row_major", "If specified, the program will calculate statistics "
     "across rows, not across columns.  (Remember that in mlpack, a column "
     "represents a point, so this option is generally not necessary.)", "r");
 
-/**
- * Calculates the sum of deviations to the Nth Power.
- *
- * @param input Vector that captures a dimension of a dataset.
- * @param rowMean Mean of the given vector.
- * @param n Degree of power.
- * @return sum of nth power deviations.
- */
-double SumNthPowerDeviations(const arma::rowvec& input,
-                             const double& fMean,
-                             size_t n)
-{
-  return arma::sum(arma::pow(input - fMean, static_cast<double>(n)));
-}
-
-/**
- * Calculates Skewness of the given vector.
- *
- * @param input Vector that captures a dimension of a dataset
- * @param rowStd Standard Deviation of the given vector.
- * @param rowMean Mean of the given vector.
- * @return Skewness of the given vector.
- */
-double Skewness(const arma::rowvec& input,
-                const double& fStd,
-                const double& fMean,
-                const bool population)
-{
-  double skewness = 0;
-  const double S3 = pow(fStd, 3);
-  const double M3 = SumNthPowerDeviations(input, fMean, 3);
-  const double n = input.n_elem;
-  if (population)
-  {
-    // Calculate population skewness
-    skewness = M3 / (n * S3);
-  }
-  else
-  {
-    // Calculate sample skewness.
-    skewness = n * M3 / ((n - 1) * (n - 2) * S3);
-  }
-  return skewness;
-}
-
-/**
- * Calculates excess kurtosis of the given vector.
- *
- * @param input Vector that captures a dimension of a dataset
- * @param rowStd Standard Deviation of the given vector.
- * @param rowMean Mean of the given vector.
- * @return Kurtosis of the given vector.
- */
-double Kurtosis(const arma::rowvec& input,
-                const double& fStd,
-                const double& fMean,
-                const bool population)
-{
-  double kurtosis = 0;
-  const double M4 = SumNthPowerDeviations(input, fMean, 4);
-  const double n = input.n_elem;
-  if (population)
-  {
-    // Calculate population excess kurtosis.
-    const double M2 = SumNthPowerDeviations(input, fMean, 2);
-    kurtosis = n * (M4 / pow(M2, 2)) - 3;
-  }
-  else
-  {
-    // Calculate sample excess kurtosis.
-    const double S4 = pow(fStd, 4);
-    const double norm3 = (3 * (n - 1) * (n - 1)) / ((n - 2) * (n - 3));
-    const double normC = (n * (n + 1)) / ((n - 1) * (n - 2) * (n - 3));
-    const double normM = M4 / S4;
-    kurtosis = normC * normM - norm3;
-  }
-  return kurtosis;
-}
-
-/**
- * Calculates standard error of standard deviation.
- *
- * @param input Vector that captures a dimension of a dataset
- * @param rowStd Standard Deviation of the given vector.
- * @return Standard error of the stanrdard devation of the given vector.
- */
-double StandardError(const size_t size, const double& fStd)
-{
-  return fStd / sqrt(size);
-}
-
 static void mlpackMain()
 {
   const size_t dimension = static_cast<size_t>(IO::GetParam<int>("dimension"));
@@ -201,50 +111,65 @@ static void mlpackMain()
       % "dim" % "var" % "mean" % "std" % "median" % "min" % "max"
       % "range" % "skew" % "kurt" % "SE" << endl;
 
-  // Lambda function to print out the results.
-  auto PrintStatResults = [&](size_t dim, bool rowMajor)
-  {
-    arma::rowvec feature;
-    if (rowMajor)
-      feature = arma::conv_to<arma::rowvec>::from(data.col(dim));
-    else
-      feature = data.row(dim);
-
-    // f at the front of the variable names means "feature".
-    const double fMax = arma::max(feature);
-    const double fMin = arma::min(feature);
-    const double fMean = arma::mean(feature);
-    const double fStd = arma::stddev(feature, population);
-
-    // Print statistics of the given dimension.
-    Log::Info << boost::format(numberFormat)
-        % dim
-        % arma::var(feature, population)
-        % fMean
-        % fStd
-        % arma::median(feature)
-        % fMin
-        % fMax
-        % (fMax - fMin) // range
-        % Skewness(feature, fStd, fMean, population)
-        % Kurtosis(feature, fStd, fMean, population)
-        % StandardError(feature.n_elem, fStd)
-        << endl;
-  };
-
   // If the user specified dimension, describe statistics of the given
   // dimension. If a dimension is not specified, describe all dimensions.
-  if (IO::HasParam("dimension"))
+  const size_t dimensions = rowMajor ? data.n_cols : data.n_rows;
+  const bool oneDimension = IO::HasParam("dimension");
+  if (oneDimension && dimension >= dimensions)
   {
-    PrintStatResults(dimension, rowMajor);
+    Log::Fatal << "Invalid value for " << PRINT_PARAM_STRING("dimension")
+        << " (" << dimension << "); the data has only " << dimensions
+        << " dimensions!" << endl;
   }
-  else
+
+  // All the moments of all the dimensions are computed in a single pass over
+  // the data.  In row-major mode, the dimensions are the columns, which are
+  // transposed a block of rows at a time.
+  math::Moments moments;
+  if (oneDimension)
   {
-    const size_t dimensions = rowMajor ? data.n_cols : data.n_rows;
-    for (size_t i = 0; i < dimensions; ++i)
+    moments.Update(rowMajor ? arma::mat(data.col(dimension).t()) :
+        arma::mat(data.row(dimension)));
+  }
+  else if (rowMajor)
+  {
+    for (size_t r = 0; r < data.n_rows; r += 1024)
     {
-      PrintStatResults(i, rowMajor);
+      const size_t last = std::min(r + 1024, (size_t) data.n_rows) - 1;
+      moments.Update(arma::mat(data.rows(r, last).t()));
     }
   }
+  else
+  {
+    moments.Update(data);
+  }
+
+  const arma::vec variance = moments.Variance(population);
+  const arma::vec stddev = moments.Stddev(population);
+  const arma::vec skewness = moments.Skewness(population);
+  const arma::vec kurtosis = moments.Kurtosis(population);
+
+  for (size_t i = 0; i < moments.Dimensionality(); ++i)
+  {
+    // The median is the only statistic that needs its own pass.
+    const size_t dim = oneDimension ? dimension : i;
+    const double median = rowMajor ? arma::median(arma::vec(data.col(dim))) :
+        arma::median(arma::rowvec(data.row(dim)));
+
+    // Print statistics of the given dimension.
+    Log::Info << boost::format(numberFormat)
+        % dim
+        % variance[i]
+        % moments.Mean()[i]
+        % stddev[i]
+        % median
+        % moments.Min()[i]
+        % moments.Max()[i]
+        % (moments.Max()[i] - moments.Min()[i]) // range
+        % skewness[i]
+        % kurtosis[i]
+        % (stddev[i] / sqrt(moments.Count())) // standard error
+        << endl;
+  }
   Timer::Stop("statistics");
 }
@@ -77,10 +77,19 @@ class ScalingModel
   template<typename MatType>
   void Transform(const MatType& input, MatType& output);
 
+  //! Transform to scale features in place.
+  template<typename MatType>
+  void Transform(MatType& input);
+
   // Fit to intialize the scaling parameter.
   template<typename MatType>
   void Fit(const MatType& input);
 
+  // Update the scaling parameters with another batch of points (if no scaler
+  // has been fit yet, this is the same as Fit()).
+  template<typename MatType>
+  void PartialFit(const MatType& input);
+
   // Scale back the dataset to their original values.
   template<typename MatType>
   void InverseTransform(const MatType& input, MatType& output);
@@ -66,18 +66,18 @@ void QUIC_SVD::ExtractSVD(arma::mat& u,
 
   // Calculate the approximate SVD of the original matrix, using the SVD of the
   // squared projected matrix.
+  // Sigma is diagonal, so instead of multiplying by its inverse, the columns
+  // of U are divided by the singular values.
   v = basis * vBar;
-  sigma = arma::sqrt(diagmat(sigmaBar));
-  u = projectedMat * vBar * sigma.i();
+  const arma::vec singularValues = arma::sqrt(sigmaBar);
+  sigma = arma::diagmat(singularValues);
+  u = projectedMat * vBar;
+  u.each_row() /= singularValues.t();
 
   // Since columns are sampled, the unitary matrices have to be exchanged, if
   // the transposed matrix is not passed.
   if (dataset.n_cols > dataset.n_rows)
-  {
-    arma::mat tempMat = u;
-    u = v;
-    v = tempMat;
-  }
+    u.swap(v);
 }
 
 } // namespace svd
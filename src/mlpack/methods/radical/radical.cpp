@@ -13,6 +13,7 @@
 #include "radical.hpp"
 #include <mlpack/core/util/log.hpp>
 #include <mlpack/core/util/timers.hpp>
+#include <mlpack/core/math/random.hpp>
 
 using namespace std;
 using namespace arma;
@@ -24,12 +25,14 @@ Radical::Radical(const double noiseStdDev,
                  const size_t replicates,
                  const size_t angles,
                  const size_t sweeps,
-                 const size_t m) :
+                 const size_t m,
+                 const bool approximateEntropy) :
     noiseStdDev(noiseStdDev),
     replicates(replicates),
     angles(angles),
     sweeps(sweeps),
-    m(m)
+    m(m),
+    approximateEntropy(approximateEntropy)
 {
   // Nothing to do here.
 }
@@ -66,30 +69,75 @@ double Radical::Vasicek(vec& z) const
 }
 
 
+double Radical::ApproximateVasicek(const vec& z) const
+{
+  const double lo = z.min();
+  const double hi = z.max();
+  if (!(hi > lo))
+    return (z.n_elem - m) * log(DBL_MIN);
+
+  // Count the points in each of about n / m bins of equal width.
+  const size_t bins = std::max((size_t) 1, (size_t) (z.n_elem / m));
+  const double scale = bins / (hi - lo);
+  std::vector<size_t> counts(bins, 0);
+  for (uword i = 0; i < z.n_elem; ++i)
+    ++counts[std::min((size_t) ((z[i] - lo) * scale), bins - 1)];
+
+  // The m-spacing of each of the c points of a bin of width w is about
+  // m * w / c.
+  const double width = (hi - lo) / bins;
+  double sum = 0;
+  for (size_t b = 0; b < bins; ++b)
+  {
+    if (counts[b] > 0)
+      sum += counts[b] * log(max(m * width / counts[b], DBL_MIN));
+  }
+
+  return sum;
+}
+
+
 double Radical::DoRadical2D(const mat& matX)
 {
-  CopyAndPerturb(perturbed, matX);
+  std::mt19937& generator = math::RandGen();
+  const uint64_t key = (uint64_t(generator()) << 32) | generator();
+  return Radical2D(matX, key);
+}
 
-  mat::fixed<2, 2> matJacobi;
+
+double Radical::Radical2D(const mat& matX, const uint64_t noiseKey) const
+{
+  // Make the perturbed replicates, with the Box-Muller transform on the
+  // counter-based generator.
+  mat perturbed = repmat(matX, replicates, 1);
+  const size_t numPairs = (perturbed.n_elem + 1) / 2;
+  for (size_t j = 0; j < numPairs; ++j)
+  {
+    const double radius = noiseStdDev * std::sqrt(-2.0 * std::log(1.0 -
+        math::RandomCounter(noiseKey, 2 * j)));
+    const double angle = 2.0 * M_PI * math::RandomCounter(noiseKey, 2 * j + 1);
+
+    perturbed[2 * j] += radius * std::cos(angle);
+    if (2 * j + 1 < perturbed.n_elem)
+      perturbed[2 * j + 1] += radius * std::sin(angle);
+  }
 
   vec values(angles);
 
-  for (size_t i = 0; i < angles; ++i)
+  // Each angle only needs its own two rotated columns.
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) angles; ++i)
   {
     const double theta = (i / (double) angles) * M_PI / 2.0;
     const double cosTheta = cos(theta);
     const double sinTheta = sin(theta);
 
-    matJacobi(0, 0) = cosTheta;
-    matJacobi(1, 0) = -sinTheta;
-    matJacobi(0, 1) = sinTheta;
-    matJacobi(1, 1) = cosTheta;
-
-    candidate = perturbed * matJacobi;
-    vec candidateY1 = candidate.unsafe_col(0);
-    vec candidateY2 = candidate.unsafe_col(1);
+    vec candidateY1 = cosTheta * perturbed.col(0) - sinTheta *
+        perturbed.col(1);
+    vec candidateY2 = sinTheta * perturbed.col(0) + cosTheta *
+        perturbed.col(1);
 
-    values(i) = Vasicek(candidateY1) + Vasicek(candidateY2);
+    values(i) = Entropy(candidateY1) + Entropy(candidateY2);
   }
 
   uword indOpt = 0;
@@ -114,10 +162,8 @@ void Radical::DoRadical(const mat& matXT, mat& matY, mat& matW)
     m = floor(sqrt((double) matX.n_rows));
 
   const size_t nDims = matX.n_cols;
-  const size_t nPoints = matX.n_rows;
 
   Timer::Start("radical_whiten_data");
-  mat matXWhitened;
   mat matWhitening;
   WhitenFeatureMajorMatrix(matX, matY, matWhitening);
   Timer::Stop("radical_whiten_data");
@@ -132,42 +178,67 @@ void Radical::DoRadical(const mat& matXT, mat& matY, mat& matW)
   Timer::Start("radical_do_radical");
   matW = matWhitening;
 
-  mat matYSubspace(nPoints, 2);
-
-  mat matJ = eye(nDims, nDims);
+  // Each sweep visits every pair of dimensions once, in the rounds of a
+  // round-robin tournament: dimension nDims - 1 (or a dummy dimension, if
+  // nDims is odd) is fixed and the others rotate, so the pairs of a round are
+  // disjoint and can be solved and applied in parallel.
+  const size_t players = nDims + (nDims % 2);
+  const size_t rounds = (players > 1) ? players - 1 : 0;
+  std::vector<size_t> first, second;
+  std::vector<uint64_t> keys;
 
   for (size_t sweepNum = 0; sweepNum < sweeps; sweepNum++)
   {
     Log::Info << "RADICAL: sweep " << sweepNum << "." << std::endl;
 
-    for (size_t i = 0; i < nDims - 1; ++i)
+    for (size_t r = 0; r < rounds; ++r)
     {
-      for (size_t j = i + 1; j < nDims; ++j)
+      first.clear();
+      second.clear();
+      keys.clear();
+      for (size_t k = 0; k < players / 2; ++k)
       {
-        Log::Debug << "RADICAL 2D on dimensions " << i << " and " << j << "."
-            << std::endl;
+        const size_t a = (r + k) % rounds;
+        const size_t b = (k == 0) ? rounds : (r + rounds - k) % rounds;
+        if (a >= nDims || b >= nDims)
+          continue;
+
+        first.push_back(std::min(a, b));
+        second.push_back(std::max(a, b));
+        Log::Debug << "RADICAL 2D on dimensions " << first.back() << " and "
+            << second.back() << "." << std::endl;
+
+        // The noise keys are drawn here, so that the result does not depend
+        // on the number of threads.
+        std::mt19937& generator = math::RandGen();
+        keys.push_back((uint64_t(generator()) << 32) | generator());
+      }
 
+      #pragma omp parallel for schedule(dynamic)
+      for (omp_size_t p = 0; p < (omp_size_t) first.size(); ++p)
+      {
+        const size_t i = first[p];
+        const size_t j = second[p];
+
+        mat matYSubspace(matY.n_rows, 2);
         matYSubspace.col(0) = matY.col(i);
         matYSubspace.col(1) = matY.col(j);
 
-        const double thetaOpt = DoRadical2D(matYSubspace);
+        const double thetaOpt = Radical2D(matYSubspace, keys[p]);
 
         const double cosThetaOpt = cos(thetaOpt);
         const double sinThetaOpt = sin(thetaOpt);
 
-        // Set elements of transformation matrix.
-        matJ(i, i) = cosThetaOpt;
-        matJ(j, i) = -sinThetaOpt;
-        matJ(i, j) = sinThetaOpt;
-        matJ(j, j) = cosThetaOpt;
-
-        matY *= matJ;
+        // Only columns i and j change, in both Y and W (so that Y = X W).
+        matY.col(i) = cosThetaOpt * matYSubspace.col(0) - sinThetaOpt *
+            matYSubspace.col(1);
+        matY.col(j) = sinThetaOpt * matYSubspace.col(0) + cosThetaOpt *
+            matYSubspace.col(1);
 
-        // Unset elements of transformation matrix, so matJ = eye() again.
-        matJ(i, i) = 1;
-        matJ(j, i) = 0;
-        matJ(i, j) = 0;
-        matJ(j, j) = 1;
+        const vec wI = matW.col(i);
+        const vec wJ = matW.col(j);
+        matW.col(i) = cosThetaOpt * wI - sinThetaOpt * wJ;
+        matW.col(j) = sinThetaOpt * wI + cosThetaOpt * wJ;
       }
     }
   }
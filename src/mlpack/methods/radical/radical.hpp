@@ -55,15 +55,20 @@ class Radical
    * @param sweeps Number of sweeps.  Each sweep calls Radical2D once for each
    *    pair of dimensions
    * @param m The variable m from Vasicek's m-spacing estimator of entropy.
+   * @param approximateEntropy If true, use ApproximateVasicek() instead of
+   *    Vasicek() to evaluate the angles during Radical2D.
    */
   Radical(const double noiseStdDev = 0.175,
           const size_t replicates = 30,
           const size_t angles = 150,
           const size_t sweeps = 0,
-          const size_t m = 0);
+          const size_t m = 0,
+          const bool approximateEntropy = false);
 
   /**
-   * Run RADICAL.
+   * Run RADICAL.  Each sweep is split into rounds of disjoint pairs of
+   * dimensions (a round-robin schedule), and the pairs of a round are solved in
+   * parallel.
    *
    * @param matX Input data into the algorithm - a matrix where each column is
    *    a point and each row is a dimension.
@@ -81,6 +86,18 @@ class Radical
    */
   double Vasicek(arma::vec& x) const;
 
+  /**
+   * An approximation of Vasicek's m-spacing estimator that does not sort the
+   * sample.  The range of the sample is split into about n / m bins of equal
+   * width, and each point of a bin is given the m-spacing that the bin would
+   * have if its points were evenly spread, so the estimate takes O(n) time.
+   * It is suited to comparing the entropies of samples of the same size, as
+   * Radical2D does.
+   *
+   * @param x Empirical sample (one-dimensional) over which to estimate entropy.
+   */
+  double ApproximateVasicek(const arma::vec& x) const;
+
   /**
    * Make replicates of each data point (the number of replicates is set in
    * either the constructor or with Replicates()) and perturb data with Gaussian
@@ -88,7 +105,8 @@ class Radical
    */
   void CopyAndPerturb(arma::mat& xNew, const arma::mat& x) const;
 
-  //! Two-dimensional version of RADICAL.
+  //! Two-dimensional version of RADICAL.  The angles are evaluated in
+  //! parallel.
   double DoRadical2D(const arma::mat& matX);
 
   //! Get the standard deviation of the additive Gaussian noise.
@@ -111,7 +129,25 @@ class Radical
   //! Modify the number of sweeps.
   size_t& Sweeps() { return sweeps; }
 
+  //! Get whether the approximate entropy estimator is used.
+  bool ApproximateEntropy() const { return approximateEntropy; }
+  //! Modify whether the approximate entropy estimator is used.
+  bool& ApproximateEntropy() { return approximateEntropy; }
+
  private:
+  /**
+   * Run Radical2D, with the noise of the replicates drawn from the
+   * counter-based generator with the given key, so that the result does not
+   * depend on the thread that runs it.
+   */
+  double Radical2D(const arma::mat& matX, const uint64_t noiseKey) const;
+
+  //! Estimate the entropy of the sample with the selected estimator.
+  double Entropy(arma::vec& x) const
+  {
+    return approximateEntropy ? ApproximateVasicek(x) : Vasicek(x);
+  }
+
   //! Standard deviation of the Gaussian noise added to the replicates of
   //! the data points during Radical2D.
   double noiseStdDev;
@@ -129,10 +165,8 @@ class Radical
   //! Value of m to use for Vasicek's m-spacing estimator of entropy.
   size_t m;
 
-  //! Internal matrix, held as member variable to prevent memory reallocations.
-  arma::mat perturbed;
-  //! Internal matrix, held as member variable to prevent memory reallocations.
-  arma::mat candidate;
+  //! Whether to use the approximate entropy estimator during Radical2D.
+  bool approximateEntropy;
 };
 
 void WhitenFeatureMajorMatrix(const arma::mat& matX,
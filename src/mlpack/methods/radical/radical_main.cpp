@@ -73,6 +73,9 @@ PARAM_INT_IN("sweeps", "Number of sweeps; each sweep calls Radical2D once for "
 PARAM_INT_IN("seed", "Random seed.  If 0, 'std::time(NULL)' is used.", "s", 0);
 PARAM_FLAG("objective", "If set, an estimate of the final objective function "
     "is printed.", "O");
+PARAM_FLAG("approximate_entropy", "If set, the angles of Radical2D are "
+    "evaluated with a faster approximation of the entropy estimator that does "
+    "not sort the data.", "A");
 
 using namespace mlpack;
 using namespace mlpack::radical;
@@ -118,7 +121,8 @@ static void mlpackMain()
   }
 
   // Run RADICAL.
-  Radical rad(noiseStdDev, nReplicates, nAngles, nSweeps);
+  Radical rad(noiseStdDev, nReplicates, nAngles, nSweeps, 0,
+      IO::HasParam("approximate_entropy"));
   mat matY;
   mat matW;
   rad.DoRadical(matX, matY, matW);
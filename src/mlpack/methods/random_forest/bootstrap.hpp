@@ -47,6 +47,19 @@ void Bootstrap(const MatType& dataset,
   }
 }
 
+/**
+ * Draw a bootstrap sample of the given number of points, as the indices of the
+ * sampled points (an index may appear several times).  The indices are the
+ * same as those used by the overload above, so training on them gives the same
+ * results without copying the dataset.
+ */
+inline void Bootstrap(const size_t numPoints, arma::uvec& indices)
+{
+  // Random sampling with replacement.
+  indices = arma::randi<arma::uvec>(numPoints,
+      arma::distr_param(0, numPoints - 1));
+}
+
 } // namespace tree
 } // namespace mlpack
 
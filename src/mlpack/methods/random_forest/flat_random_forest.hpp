@@ -0,0 +1,128 @@
+/**
+ * @file methods/random_forest/flat_random_forest.hpp
+ *
+ * Definition of FlatRandomForest, a copy of a trained RandomForest whose trees
+ * are laid out in contiguous arrays for fast classification.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RANDOM_FOREST_FLAT_RANDOM_FOREST_HPP
+#define MLPACK_METHODS_RANDOM_FOREST_FLAT_RANDOM_FOREST_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/methods/decision_tree/flat_decision_tree.hpp>
+#include "random_forest.hpp"
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * A FlatRandomForest holds the same model as a trained RandomForest, with each
+ * tree converted to a FlatDecisionTree.  The batch Classify() overloads split
+ * the points into blocks; each block is classified by one tree after the other,
+ * so that the nodes of a tree stay in cache while the points of the block go
+ * through it, and the blocks are processed in parallel with OpenMP.  The
+ * predictions are the same as those of RandomForest::Classify().
+ *
+ * @code
+ * extern RandomForest<> forest;
+ * extern arma::mat points;
+ *
+ * FlatRandomForest<RandomForest<>> flatForest(forest);
+ * arma::Row<size_t> predictions;
+ * arma::mat probabilities;
+ * flatForest.Classify(points, predictions, probabilities);
+ * @endcode
+ *
+ * @tparam ForestType Type of the RandomForest to flatten.
+ */
+template<typename ForestType>
+class FlatRandomForest
+{
+ public:
+  //! The type of the flat trees.
+  typedef FlatDecisionTree<typename ForestType::DecisionTreeType> FlatTreeType;
+
+  //! Create an empty flat forest; Compile() must be called before
+  //! classifying.
+  FlatRandomForest() { }
+
+  //! Create the flat copy of the given forest.
+  FlatRandomForest(const ForestType& forest) { Compile(forest); }
+
+  /**
+   * Replace the model with a flat copy of the given forest.
+   *
+   * @param forest Trained forest to copy.
+   */
+  void Compile(const ForestType& forest);
+
+  /**
+   * Predict the class of the given point.
+   *
+   * @param point Point to classify.
+   */
+  template<typename VecType>
+  size_t Classify(const VecType& point) const;
+
+  /**
+   * Predict the class of the given point and return the class probabilities,
+   * averaged over the trees.
+   *
+   * @param point Point to classify.
+   * @param prediction This will be set to the predicted class of the point.
+   * @param probabilities This will be filled with class probabilities for the
+   *      point.
+   */
+  template<typename VecType>
+  void Classify(const VecType& point,
+                size_t& prediction,
+                arma::vec& probabilities) const;
+
+  /**
+   * Predict the classes of the given points.
+   *
+   * @param data Set of points to classify.
+   * @param predictions This will be filled with predictions for each point.
+   */
+  template<typename MatType>
+  void Classify(const MatType& data,
+                arma::Row<size_t>& predictions) const;
+
+  /**
+   * Predict the classes of the given points and return the class
+   * probabilities, averaged over the trees.
+   *
+   * @param data Set of points to classify.
+   * @param predictions This will be filled with predictions for each point.
+   * @param probabilities This will be filled with class probabilities for each
+   *      point.
+   */
+  template<typename MatType>
+  void Classify(const MatType& data,
+                arma::Row<size_t>& predictions,
+                arma::mat& probabilities) const;
+
+  //! Get the number of trees.
+  size_t NumTrees() const { return trees.size(); }
+  //! Get the given tree.
+  const FlatTreeType& Tree(const size_t i) const { return trees[i]; }
+
+  //! The number of points classified together by each tree.
+  static const size_t BlockSize = 256;
+
+ private:
+  //! The trees.
+  std::vector<FlatTreeType> trees;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+// Include implementation.
+#include "flat_random_forest_impl.hpp"
+
+#endif
@@ -0,0 +1,127 @@
+/**
+ * @file methods/random_forest/flat_random_forest_impl.hpp
+ *
+ * Implementation of FlatRandomForest.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RANDOM_FOREST_FLAT_RANDOM_FOREST_IMPL_HPP
+#define MLPACK_METHODS_RANDOM_FOREST_FLAT_RANDOM_FOREST_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "flat_random_forest.hpp"
+
+namespace mlpack {
+namespace tree {
+
+template<typename ForestType>
+const size_t FlatRandomForest<ForestType>::BlockSize;
+
+template<typename ForestType>
+void FlatRandomForest<ForestType>::Compile(const ForestType& forest)
+{
+  trees.clear();
+  trees.resize(forest.NumTrees());
+  for (size_t i = 0; i < forest.NumTrees(); ++i)
+    trees[i].Compile(forest.Tree(i));
+}
+
+template<typename ForestType>
+template<typename VecType>
+size_t FlatRandomForest<ForestType>::Classify(const VecType& point) const
+{
+  size_t prediction;
+  arma::vec probabilities;
+  Classify(point, prediction, probabilities);
+
+  return prediction;
+}
+
+template<typename ForestType>
+template<typename VecType>
+void FlatRandomForest<ForestType>::Classify(const VecType& point,
+                                            size_t& prediction,
+                                            arma::vec& probabilities) const
+{
+  // Check edge case.
+  if (trees.size() == 0)
+  {
+    throw std::invalid_argument("FlatRandomForest::Classify(): no random "
+        "forest compiled!");
+  }
+
+  probabilities.zeros(trees[0].NumClasses());
+  for (size_t i = 0; i < trees.size(); ++i)
+    probabilities += trees[i].LeafProbabilities().col(trees[i].Leaf(point));
+
+  probabilities /= trees.size();
+  arma::uword maxIndex = 0;
+  probabilities.max(maxIndex);
+  prediction = (size_t) maxIndex;
+}
+
+template<typename ForestType>
+template<typename MatType>
+void FlatRandomForest<ForestType>::Classify(
+    const MatType& data,
+    arma::Row<size_t>& predictions) const
+{
+  arma::mat probabilities;
+  Classify(data, predictions, probabilities);
+}
+
+template<typename ForestType>
+template<typename MatType>
+void FlatRandomForest<ForestType>::Classify(
+    const MatType& data,
+    arma::Row<size_t>& predictions,
+    arma::mat& probabilities) const
+{
+  // Check edge case.
+  if (trees.size() == 0)
+  {
+    predictions.clear();
+    probabilities.clear();
+
+    throw std::invalid_argument("FlatRandomForest::Classify(): no random "
+        "forest compiled!");
+  }
+
+  predictions.set_size(data.n_cols);
+  probabilities.zeros(trees[0].NumClasses(), data.n_cols);
+
+  // Each block of points goes through the trees one after the other, so that
+  // the nodes of one tree are reused by all the points of the block.
+  const size_t numBlocks = (data.n_cols + BlockSize - 1) / BlockSize;
+  #pragma omp parallel for
+  for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+  {
+    const size_t begin = b * BlockSize;
+    const size_t end = std::min((size_t) data.n_cols, begin + BlockSize) - 1;
+
+    arma::Row<size_t> leaves;
+    for (size_t t = 0; t < trees.size(); ++t)
+    {
+      trees[t].Leaves(data.cols(begin, end), leaves);
+      for (size_t i = 0; i < leaves.n_elem; ++i)
+        probabilities.col(begin + i) +=
+            trees[t].LeafProbabilities().col(leaves[i]);
+    }
+
+    for (size_t i = begin; i <= end; ++i)
+    {
+      probabilities.col(i) /= trees.size();
+      arma::uword maxIndex = 0;
+      probabilities.col(i).max(maxIndex);
+      predictions[i] = maxIndex;
+    }
+  }
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,161 @@
+/**
+ * @file methods/random_forest/lazy_random_forest.hpp
+ *
+ * Definition of LazyRandomForest, a view of a RandomForest saved to a file
+ * whose trees are only deserialized when they are first used.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RANDOM_FOREST_LAZY_RANDOM_FOREST_HPP
+#define MLPACK_METHODS_RANDOM_FOREST_LAZY_RANDOM_FOREST_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/data/load_numeric_csv.hpp>
+#include "random_forest.hpp"
+
+#include <memory>
+#include <mutex>
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * A LazyRandomForest gives access to a RandomForest that was saved with
+ * LazyRandomForest::Save().  That file holds an index of the trees followed by
+ * each tree, serialized on its own with the portable binary archive.  Opening
+ * the file only memory-maps it and reads the index; each tree is deserialized
+ * the first time it is used (by Tree() or Classify()), so a model can be
+ * opened quickly and only the trees that are used take memory.
+ *
+ * The trees can be loaded from several threads at once; each tree is only
+ * loaded once.  The predictions are the same as those of
+ * RandomForest::Classify().
+ *
+ * @code
+ * extern RandomForest<> forest;
+ * LazyRandomForest<RandomForest<>>::Save(forest, "forest.lazy");
+ *
+ * // Later (and possibly in another program).
+ * LazyRandomForest<RandomForest<>> lazyForest("forest.lazy");
+ * extern arma::mat points;
+ * arma::Row<size_t> predictions;
+ * lazyForest.Classify(points, predictions);
+ * @endcode
+ *
+ * @tparam ForestType Type of the saved RandomForest.
+ */
+template<typename ForestType>
+class LazyRandomForest
+{
+ public:
+  //! The type of the trees.
+  typedef typename ForestType::DecisionTreeType DecisionTreeType;
+
+  /**
+   * Save the given forest to a file that a LazyRandomForest can open.  A
+   * std::runtime_error is thrown if the file can't be written.
+   *
+   * @param forest Forest to save.
+   * @param filename Name of the file to write.
+   */
+  static void Save(const ForestType& forest, const std::string& filename);
+
+  /**
+   * Open the given file, written by Save().  No tree is loaded.  A
+   * std::runtime_error is thrown if the file can't be opened or was not
+   * written by Save().
+   *
+   * @param filename Name of the file to open.
+   */
+  LazyRandomForest(const std::string& filename);
+
+  //! Get the number of trees in the forest.
+  size_t NumTrees() const { return numTrees; }
+
+  /**
+   * Get the given tree, loading it if it hasn't been used yet.  A
+   * std::runtime_error is thrown if the tree can't be deserialized.
+   *
+   * @param i Index of the tree.
+   */
+  const DecisionTreeType& Tree(const size_t i) const;
+
+  //! Return whether the given tree has been loaded.  This should not be called
+  //! while other threads may be loading trees.
+  bool IsLoaded(const size_t i) const { return (bool) trees[i]; }
+
+  //! Load all the trees that are not loaded yet.  If a tree can't be
+  //! deserialized, the other trees are still loaded and then the
+  //! std::runtime_error of the failing tree is thrown.
+  void LoadAll() const;
+
+  /**
+   * Predict the class of the given point.
+   *
+   * @param point Point to classify.
+   */
+  template<typename VecType>
+  size_t Classify(const VecType& point) const;
+
+  /**
+   * Predict the class of the given point and return the class probabilities,
+   * averaged over the trees.
+   *
+   * @param point Point to classify.
+   * @param prediction This will be set to the predicted class of the point.
+   * @param probabilities This will be filled with class probabilities for the
+   *      point.
+   */
+  template<typename VecType>
+  void Classify(const VecType& point,
+                size_t& prediction,
+                arma::vec& probabilities) const;
+
+  /**
+   * Predict the classes of the given points.
+   *
+   * @param data Set of points to classify.
+   * @param predictions This will be filled with predictions for each point.
+   */
+  template<typename MatType>
+  void Classify(const MatType& data,
+                arma::Row<size_t>& predictions) const;
+
+  /**
+   * Predict the classes of the given points and return the class
+   * probabilities, averaged over the trees.
+   *
+   * @param data Set of points to classify.
+   * @param predictions This will be filled with predictions for each point.
+   * @param probabilities This will be filled with class probabilities for each
+   *      point.
+   */
+  template<typename MatType>
+  void Classify(const MatType& data,
+                arma::Row<size_t>& predictions,
+                arma::mat& probabilities) const;
+
+ private:
+  //! The mapped file.
+  std::unique_ptr<data::MappedTextFile> file;
+  //! The number of trees.
+  size_t numTrees;
+  //! The position of each tree in the file, followed by the end of the last
+  //! tree.
+  std::vector<size_t> offsets;
+  //! The trees that have been loaded (the others are NULL).
+  mutable std::vector<std::unique_ptr<DecisionTreeType>> trees;
+  //! Makes sure each tree is loaded only once.
+  mutable std::unique_ptr<std::once_flag[]> loadFlags;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+// Include implementation.
+#include "lazy_random_forest_impl.hpp"
+
+#endif
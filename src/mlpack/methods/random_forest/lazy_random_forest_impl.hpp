@@ -0,0 +1,280 @@
+/**
+ * @file methods/random_forest/lazy_random_forest_impl.hpp
+ *
+ * Implementation of LazyRandomForest.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RANDOM_FOREST_LAZY_RANDOM_FOREST_IMPL_HPP
+#define MLPACK_METHODS_RANDOM_FOREST_LAZY_RANDOM_FOREST_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "lazy_random_forest.hpp"
+
+#include <mlpack/core/data/portable_binary_archive.hpp>
+
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <streambuf>
+
+namespace mlpack {
+namespace tree {
+namespace lazy {
+
+//! The first bytes of the files written by LazyRandomForest::Save().
+static const char magic[8] = { 'M', 'L', 'P', 'K', 'L', 'Z', 'R', 'F' };
+
+//! Write the given value as 8 little-endian bytes.
+inline void WriteUInt64(std::ostream& stream, const uint64_t value)
+{
+  char bytes[8];
+  for (size_t i = 0; i < 8; ++i)
+    bytes[i] = (char) ((value >> (8 * i)) & 0xFF);
+  stream.write(bytes, 8);
+}
+
+//! Read 8 little-endian bytes.
+inline uint64_t ReadUInt64(const char* bytes)
+{
+  uint64_t value = 0;
+  for (size_t i = 0; i < 8; ++i)
+    value |= uint64_t((unsigned char) bytes[i]) << (8 * i);
+  return value;
+}
+
+//! A read-only stream buffer over memory that is not owned, so that a tree
+//! can be deserialized directly from the mapped file.
+class MemoryBuffer : public std::streambuf
+{
+ public:
+  MemoryBuffer(const char* data, const size_t size)
+  {
+    char* begin = const_cast<char*>(data);
+    setg(begin, begin, begin + size);
+  }
+};
+
+} // namespace lazy
+
+template<typename ForestType>
+void LazyRandomForest<ForestType>::Save(const ForestType& forest,
+                                        const std::string& filename)
+{
+  std::ofstream stream(filename.c_str(), std::ios::binary);
+  if (!stream.is_open())
+    throw std::runtime_error("Cannot open file '" + filename + "'.");
+
+  // The index is written once the positions of the trees are known.
+  const size_t numTrees = forest.NumTrees();
+  stream.write(lazy::magic, 8);
+  lazy::WriteUInt64(stream, numTrees);
+  for (size_t i = 0; i <= numTrees; ++i)
+    lazy::WriteUInt64(stream, 0);
+
+  std::vector<uint64_t> offsets(numTrees + 1);
+  for (size_t i = 0; i < numTrees; ++i)
+  {
+    offsets[i] = (uint64_t) stream.tellp();
+    data::PortableBinaryOArchive ar(stream);
+    ar << boost::serialization::make_nvp("tree", forest.Tree(i));
+  }
+  offsets[numTrees] = (uint64_t) stream.tellp();
+
+  stream.seekp(16);
+  for (size_t i = 0; i <= numTrees; ++i)
+    lazy::WriteUInt64(stream, offsets[i]);
+
+  if (!stream.good())
+    throw std::runtime_error("Cannot write file '" + filename + "'.");
+}
+
+template<typename ForestType>
+LazyRandomForest<ForestType>::LazyRandomForest(const std::string& filename) :
+    file(new data::MappedTextFile(filename)),
+    numTrees(0)
+{
+  const char* data = file->Data();
+  const size_t size = file->Size();
+  if (size < 16 || std::memcmp(data, lazy::magic, 8) != 0)
+  {
+    throw std::runtime_error("LazyRandomForest: file '" + filename + "' was "
+        "not written by LazyRandomForest::Save().");
+  }
+
+  const uint64_t storedNumTrees = lazy::ReadUInt64(data + 8);
+  if (storedNumTrees >= (size - 16) / 8)
+  {
+    throw std::runtime_error("LazyRandomForest: the index of file '" +
+        filename + "' is truncated.");
+  }
+
+  numTrees = (size_t) storedNumTrees;
+  offsets.resize(numTrees + 1);
+  const size_t indexEnd = 16 + 8 * (numTrees + 1);
+  for (size_t i = 0; i <= numTrees; ++i)
+  {
+    const uint64_t offset = lazy::ReadUInt64(data + 16 + 8 * i);
+    if (offset < (i == 0 ? indexEnd : offsets[i - 1]) || offset > size)
+    {
+      throw std::runtime_error("LazyRandomForest: the index of file '" +
+          filename + "' is invalid.");
+    }
+
+    offsets[i] = (size_t) offset;
+  }
+
+  trees.resize(numTrees);
+  loadFlags.reset(new std::once_flag[numTrees]);
+}
+
+template<typename ForestType>
+const typename LazyRandomForest<ForestType>::DecisionTreeType&
+LazyRandomForest<ForestType>::Tree(const size_t i) const
+{
+  // If loading fails, the exception leaves the flag unset, so the next call
+  // tries again.
+  std::call_once(loadFlags[i], [this, i]()
+  {
+    lazy::MemoryBuffer buffer(file->Data() + offsets[i],
+        offsets[i + 1] - offsets[i]);
+    std::istream stream(&buffer);
+
+    std::unique_ptr<DecisionTreeType> tree(new DecisionTreeType());
+    try
+    {
+      data::PortableBinaryIArchive ar(stream);
+      ar >> boost::serialization::make_nvp("tree", *tree);
+    }
+    catch (std::exception& e)
+    {
+      throw std::runtime_error("LazyRandomForest::Tree(): cannot load tree " +
+          std::to_string(i) + ": " + e.what());
+    }
+
+    trees[i] = std::move(tree);
+  });
+
+  return *trees[i];
+}
+
+template<typename ForestType>
+void LazyRandomForest<ForestType>::LoadAll() const
+{
+  // An exception can't leave the parallel region, so the first one thrown by
+  // Tree() is rethrown once all the other trees have been tried.
+  std::exception_ptr exception;
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t i = 0; i < (omp_size_t) numTrees; ++i)
+  {
+    try
+    {
+      Tree(i);
+    }
+    catch (...)
+    {
+      #pragma omp critical
+      {
+        if (!exception)
+          exception = std::current_exception();
+      }
+    }
+  }
+
+  if (exception)
+    std::rethrow_exception(exception);
+}
+
+template<typename ForestType>
+template<typename VecType>
+size_t LazyRandomForest<ForestType>::Classify(const VecType& point) const
+{
+  size_t prediction;
+  arma::vec probabilities;
+  Classify(point, prediction, probabilities);
+
+  return prediction;
+}
+
+template<typename ForestType>
+template<typename VecType>
+void LazyRandomForest<ForestType>::Classify(const VecType& point,
+                                            size_t& prediction,
+                                            arma::vec& probabilities) const
+{
+  // Check edge case.
+  if (numTrees == 0)
+  {
+    probabilities.clear();
+    prediction = 0;
+
+    throw std::invalid_argument("LazyRandomForest::Classify(): the forest has "
+        "no trees!");
+  }
+
+  probabilities.zeros(Tree(0).NumClasses());
+  for (size_t i = 0; i < numTrees; ++i)
+  {
+    arma::vec treeProbs;
+    size_t treePrediction; // Ignored.
+    Tree(i).Classify(point, treePrediction, treeProbs);
+
+    probabilities += treeProbs;
+  }
+
+  // Find maximum element after renormalizing probabilities.
+  probabilities /= numTrees;
+  arma::uword maxIndex = 0;
+  probabilities.max(maxIndex);
+
+  // Set prediction.
+  prediction = (size_t) maxIndex;
+}
+
+template<typename ForestType>
+template<typename MatType>
+void LazyRandomForest<ForestType>::Classify(
+    const MatType& data,
+    arma::Row<size_t>& predictions) const
+{
+  arma::mat probabilities;
+  Classify(data, predictions, probabilities);
+}
+
+template<typename ForestType>
+template<typename MatType>
+void LazyRandomForest<ForestType>::Classify(const MatType& data,
+                                            arma::Row<size_t>& predictions,
+                                            arma::mat& probabilities) const
+{
+  // Check edge case.
+  if (numTrees == 0)
+  {
+    predictions.clear();
+    probabilities.clear();
+
+    throw std::invalid_argument("LazyRandomForest::Classify(): the forest has "
+        "no trees!");
+  }
+
+  // Every tree is needed, so load them all at once (in parallel) instead of
+  // one by one by the first points.
+  LoadAll();
+
+  probabilities.set_size(Tree(0).NumClasses(), data.n_cols);
+  predictions.set_size(data.n_cols);
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) data.n_cols; ++i)
+  {
+    arma::vec probs = probabilities.unsafe_col(i);
+    Classify(data.col(i), predictions[i], probs);
+  }
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,22 @@
+/**
+ * @file methods/random_forest/random_forest.cpp
+ *
+ * Explicit instantiations of the default RandomForest types, which are declared
+ * extern in random_forest.hpp, so that the programs that use them do not have
+ * to compile them.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "random_forest.hpp"
+
+namespace mlpack {
+namespace tree {
+
+MLPACK_RANDOM_FOREST_INSTANTIATE(template, GiniGain)
+MLPACK_RANDOM_FOREST_INSTANTIATE(template, InformationGain)
+
+} // namespace tree
+} // namespace mlpack
@@ -14,6 +14,7 @@
 
 #include <mlpack/methods/decision_tree/decision_tree.hpp>
 #include <mlpack/methods/decision_tree/multiple_random_dimension_select.hpp>
+#include <mlpack/methods/decision_tree/quickscorer.hpp>
 #include "bootstrap.hpp"
 
 namespace mlpack {
@@ -332,6 +333,15 @@ class RandomForest
   //! Get the number of trees in the forest.
   size_t NumTrees() const { return trees.size(); }
 
+  /**
+   * Replace the trees of the given scorer with the trees of the forest, so
+   * that the scorer gives the same predictions as Classify().  The trees must
+   * only have binary numeric splits (see QuickScorer).
+   *
+   * @param scorer Scorer to store the forest in.
+   */
+  void Compile(QuickScorer& scorer) const;
+
   /**
    * Serialize the random forest.
    */
@@ -381,4 +391,52 @@ class RandomForest
 // Include implementation.
 #include "random_forest_impl.hpp"
 
+/**
+ * Declare (with PREFIX "extern template") or define (with PREFIX "template")
+ * the explicit instantiations of the default RandomForest with the given
+ * fitness function, and of its Train() and Classify() overloads for arma::mat
+ * data.
+ */
+#define MLPACK_RANDOM_FOREST_INSTANTIATE(PREFIX, FITNESS) \
+  PREFIX class RandomForest<FITNESS>; \
+  PREFIX double RandomForest<FITNESS>::Train(const arma::mat&, \
+      const arma::Row<size_t>&, const size_t, const size_t, const size_t, \
+      const double, const size_t, MultipleRandomDimensionSelect); \
+  PREFIX double RandomForest<FITNESS>::Train(const arma::mat&, \
+      const data::DatasetInfo&, const arma::Row<size_t>&, const size_t, \
+      const size_t, const size_t, const double, const size_t, \
+      MultipleRandomDimensionSelect); \
+  PREFIX double RandomForest<FITNESS>::Train(const arma::mat&, \
+      const arma::Row<size_t>&, const size_t, const arma::rowvec&, \
+      const size_t, const size_t, const double, const size_t, \
+      MultipleRandomDimensionSelect); \
+  PREFIX double RandomForest<FITNESS>::Train(const arma::mat&, \
+      const data::DatasetInfo&, const arma::Row<size_t>&, const size_t, \
+      const arma::rowvec&, const size_t, const size_t, const double, \
+      const size_t, MultipleRandomDimensionSelect); \
+  PREFIX size_t RandomForest<FITNESS>::Classify(const arma::vec&) const; \
+  PREFIX void RandomForest<FITNESS>::Classify(const arma::vec&, size_t&, \
+      arma::vec&) const; \
+  PREFIX void RandomForest<FITNESS>::Classify(const arma::mat&, \
+      arma::Row<size_t>&) const; \
+  PREFIX void RandomForest<FITNESS>::Classify(const arma::mat&, \
+      arma::Row<size_t>&, arma::mat&) const;
+
+#ifndef MLPACK_NO_EXTERN_TEMPLATES
+
+namespace mlpack {
+namespace tree {
+
+// The default random forests with the Gini gain and the information gain are
+// compiled once, in libmlpack (see random_forest.cpp), instead of in every
+// program that uses them.  Define MLPACK_NO_EXTERN_TEMPLATES to compile them in
+// each program instead.
+MLPACK_RANDOM_FOREST_INSTANTIATE(extern template, GiniGain)
+MLPACK_RANDOM_FOREST_INSTANTIATE(extern template, InformationGain)
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
+
 #endif
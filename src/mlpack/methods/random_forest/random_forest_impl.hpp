@@ -407,6 +407,32 @@ void RandomForest<
   }
 }
 
+template<
+    typename FitnessFunction,
+    typename DimensionSelectionType,
+    template<typename> class NumericSplitType,
+    template<typename> class CategoricalSplitType,
+    typename ElemType
+>
+void RandomForest<
+    FitnessFunction,
+    DimensionSelectionType,
+    NumericSplitType,
+    CategoricalSplitType,
+    ElemType
+>::Compile(QuickScorer& scorer) const
+{
+  if (trees.size() == 0)
+  {
+    throw std::invalid_argument("RandomForest::Compile(): no random forest "
+        "trained!");
+  }
+
+  scorer.Clear();
+  for (size_t i = 0; i < trees.size(); ++i)
+    scorer.AddTree(trees[i]);
+}
+
 template<
     typename FitnessFunction,
     typename DimensionSelectionType,
@@ -463,6 +489,19 @@ double RandomForest<
          const size_t maximumDepth,
          DimensionSelectionType& dimensionSelector)
 {
+  // If the numeric split type searches histograms, every dimension is binned
+  // once for all the trees, with bin boundaries taken from all the points.
+  const bool useBins = !UseDatasetInfo &&
+      NumericSplitTraits<NumericSplitType<FitnessFunction>>::UsesBins;
+  HistogramBins<ElemType> bins;
+  if (useBins && dataset.n_cols > 0)
+  {
+    Timer::Start("bin_dataset");
+    bins = HistogramBins<ElemType>(dataset,
+        arma::regspace<arma::uvec>(0, dataset.n_cols - 1));
+    Timer::Stop("bin_dataset");
+  }
+
   // Train each tree individually.
   trees.resize(numTrees); // This will fill the vector with untrained trees.
   double avgGain = 0.0;
@@ -470,12 +509,11 @@ double RandomForest<
   #pragma omp parallel for reduction( + : avgGain)
   for (omp_size_t i = 0; i < numTrees; ++i)
   {
+    // The bootstrap sample is only a set of indices into the dataset, so the
+    // dataset is never copied.
     Timer::Start("bootstrap");
-    MatType bootstrapDataset;
-    arma::Row<size_t> bootstrapLabels;
-    arma::rowvec bootstrapWeights;
-    Bootstrap<UseWeights>(dataset, labels, weights, bootstrapDataset,
-        bootstrapLabels, bootstrapWeights);
+    arma::uvec bootstrapIndices;
+    Bootstrap(dataset.n_cols, bootstrapIndices);
     Timer::Stop("bootstrap");
 
     // Now build the decision tree.
@@ -484,29 +522,42 @@ double RandomForest<
     {
       if (UseDatasetInfo)
       {
-        avgGain += trees[i].Train(bootstrapDataset, datasetInfo,
-            bootstrapLabels, numClasses, bootstrapWeights, minimumLeafSize,
-            minimumGainSplit, maximumDepth, dimensionSelector);
+        avgGain += trees[i].Train(dataset, bootstrapIndices, datasetInfo,
+            labels, numClasses, weights, minimumLeafSize, minimumGainSplit,
+            maximumDepth, dimensionSelector);
+      }
+      else if (useBins)
+      {
+        avgGain += trees[i].Train(dataset, bootstrapIndices, bins, labels,
+            numClasses, weights, minimumLeafSize, minimumGainSplit,
+            maximumDepth, dimensionSelector);
       }
       else
       {
-        avgGain += trees[i].Train(bootstrapDataset, bootstrapLabels, numClasses,
-            bootstrapWeights, minimumLeafSize, minimumGainSplit, maximumDepth,
-            dimensionSelector);
+        avgGain += trees[i].Train(dataset, bootstrapIndices, labels,
+            numClasses, weights, minimumLeafSize, minimumGainSplit,
+            maximumDepth, dimensionSelector);
       }
     }
     else
     {
       if (UseDatasetInfo)
       {
-        avgGain += trees[i].Train(bootstrapDataset, datasetInfo,
-            bootstrapLabels, numClasses, minimumLeafSize, minimumGainSplit,
+        avgGain += trees[i].Train(dataset, bootstrapIndices, datasetInfo,
+            labels, numClasses, minimumLeafSize, minimumGainSplit,
             maximumDepth, dimensionSelector);
       }
+      else if (useBins)
+      {
+        avgGain += trees[i].Train(dataset, bootstrapIndices, bins, labels,
+            numClasses, minimumLeafSize, minimumGainSplit, maximumDepth,
+            dimensionSelector);
+      }
       else
       {
-        avgGain += trees[i].Train(bootstrapDataset, bootstrapLabels, numClasses,
-            minimumLeafSize, minimumGainSplit, maximumDepth, dimensionSelector);
+        avgGain += trees[i].Train(dataset, bootstrapIndices, labels,
+            numClasses, minimumLeafSize, minimumGainSplit, maximumDepth,
+            dimensionSelector);
       }
     }
     Timer::Stop("train_tree");
@@ -145,6 +145,13 @@ class RandomForestModel
   // Create the model.
   RandomForestModel() { /* Nothing to do. */ }
 
+  // Classify the given points; this is used by the Python bindings to run the
+  // model without going through the whole program.
+  void Classify(const arma::mat& data, arma::Row<size_t>& predictions) const
+  {
+    rf.Classify(data, predictions);
+  }
+
   // Serialize the model.
   template<typename Archive>
   void serialize(Archive& ar, const unsigned int /* version */)
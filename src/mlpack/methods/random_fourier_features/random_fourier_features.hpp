@@ -0,0 +1,131 @@
+/**
+ * @file methods/random_fourier_features/random_fourier_features.hpp
+ *
+ * Random Fourier features, an explicit feature map whose inner products
+ * approximate a shift-invariant kernel.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RANDOM_FOURIER_FEATURES_RANDOM_FOURIER_FEATURES_HPP
+#define MLPACK_METHODS_RANDOM_FOURIER_FEATURES_RANDOM_FOURIER_FEATURES_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "spectral_distribution.hpp"
+
+namespace mlpack {
+namespace kernel {
+
+/**
+ * RandomFourierFeatures maps points to D random features,
+ *
+ * @f[
+ * z(x) = \sqrt{2 / D} \cos(W x + b),
+ * @f]
+ *
+ * where the rows of W are drawn from the spectral distribution of the kernel
+ * (see SpectralDistribution) and b is uniform on [0, 2 pi).  Then
+ * z(x)^T z(y) is an unbiased estimate of K(x, y), so that linear methods
+ * (like LogisticRegression or LinearSVM) trained on the features approximate
+ * kernel machines, at a cost linear in the number of points:
+ *
+ * @code
+ * @inproceedings{rahimi2008random,
+ *   title={Random features for large-scale kernel machines},
+ *   author={Rahimi, Ali and Recht, Benjamin},
+ *   booktitle={Advances in Neural Information Processing Systems},
+ *   pages={1177--1184},
+ *   year={2008}
+ * }
+ * @endcode
+ *
+ * For example, to train a logistic regression model with an approximate
+ * Gaussian kernel:
+ *
+ * @code
+ * RandomFourierFeatures<GaussianKernel> rff(GaussianKernel(0.5), 1000);
+ * rff.Train(data.n_rows);
+ *
+ * arma::mat features;
+ * rff.Transform(data, features);
+ * LogisticRegression<> lr(features, labels);
+ * @endcode
+ *
+ * @tparam KernelType Shift-invariant kernel to approximate; it must have a
+ *     SpectralDistribution (GaussianKernel, LaplacianKernel or CauchyKernel).
+ */
+template<typename KernelType>
+class RandomFourierFeatures
+{
+  static_assert(SpectralDistribution<KernelType>::IsDefined,
+      "RandomFourierFeatures: the spectral distribution of the kernel is not "
+      "known; specialize SpectralDistribution for it.");
+
+ public:
+  /**
+   * Create the feature map for the given kernel, but do not draw the random
+   * features; call Train() before Transform().
+   *
+   * @param kernel Kernel to approximate.
+   * @param numFeatures Number of random features (D).
+   */
+  RandomFourierFeatures(const KernelType& kernel = KernelType(),
+                        const size_t numFeatures = 100);
+
+  /**
+   * Draw the random features, for points of the given dimensionality.
+   *
+   * @param dimensionality Dimensionality of the points.
+   */
+  void Train(const size_t dimensionality);
+
+  /**
+   * Map the given points to the random features.  Each column of features
+   * corresponds to the column of data with the same index.
+   *
+   * @param data Points to map.
+   * @param features Matrix to store the features into (of size
+   *     NumFeatures() x data.n_cols).
+   */
+  void Transform(const arma::mat& data, arma::mat& features) const;
+
+  //! Get the kernel.
+  const KernelType& Kernel() const { return kernel; }
+  //! Modify the kernel.  Call Train() again for the change to apply.
+  KernelType& Kernel() { return kernel; }
+
+  //! Get the number of random features.
+  size_t NumFeatures() const { return numFeatures; }
+  //! Modify the number of random features.  Call Train() again for the change
+  //! to apply.
+  size_t& NumFeatures() { return numFeatures; }
+
+  //! Get the random frequencies (one row per feature).
+  const arma::mat& Frequencies() const { return frequencies; }
+  //! Get the random offsets (one per feature).
+  const arma::vec& Offsets() const { return offsets; }
+
+  //! Serialize the feature map.
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */);
+
+ private:
+  //! The kernel to approximate.
+  KernelType kernel;
+  //! The number of random features.
+  size_t numFeatures;
+  //! The random frequencies W, one row per feature.
+  arma::mat frequencies;
+  //! The random offsets b, one per feature.
+  arma::vec offsets;
+};
+
+} // namespace kernel
+} // namespace mlpack
+
+// Include implementation.
+#include "random_fourier_features_impl.hpp"
+
+#endif
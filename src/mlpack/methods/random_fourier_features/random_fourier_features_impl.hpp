@@ -0,0 +1,86 @@
+/**
+ * @file methods/random_fourier_features/random_fourier_features_impl.hpp
+ *
+ * Implementation of random Fourier features.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RANDOM_FOURIER_FEATURES_RANDOM_FOURIER_FEATURES_IMPL_HPP
+#define MLPACK_METHODS_RANDOM_FOURIER_FEATURES_RANDOM_FOURIER_FEATURES_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "random_fourier_features.hpp"
+
+namespace mlpack {
+namespace kernel {
+
+template<typename KernelType>
+RandomFourierFeatures<KernelType>::RandomFourierFeatures(
+    const KernelType& kernel,
+    const size_t numFeatures) :
+    kernel(kernel),
+    numFeatures(numFeatures)
+{
+  if (numFeatures == 0)
+  {
+    throw std::invalid_argument("RandomFourierFeatures::"
+        "RandomFourierFeatures(): numFeatures must be greater than 0!");
+  }
+}
+
+template<typename KernelType>
+void RandomFourierFeatures<KernelType>::Train(const size_t dimensionality)
+{
+  // The frequencies are drawn as columns, then stored as rows, so that the
+  // projection of all the points is one matrix multiplication.
+  arma::mat draws(dimensionality, numFeatures);
+  SpectralDistribution<KernelType>::Random(kernel, draws);
+  frequencies = draws.t();
+
+  offsets.randu(numFeatures);
+  offsets *= 2.0 * M_PI;
+}
+
+template<typename KernelType>
+void RandomFourierFeatures<KernelType>::Transform(const arma::mat& data,
+                                                  arma::mat& features) const
+{
+  if (frequencies.n_rows == 0)
+  {
+    throw std::runtime_error("RandomFourierFeatures::Transform(): the random "
+        "features have not been drawn; call Train() first!");
+  }
+
+  if (data.n_rows != frequencies.n_cols)
+  {
+    std::ostringstream oss;
+    oss << "RandomFourierFeatures::Transform(): dimensionality of the data ("
+        << data.n_rows << ") does not match the dimensionality of the "
+        << "features (" << frequencies.n_cols << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  features = frequencies * data;
+  features.each_col() += offsets;
+  features = std::sqrt(2.0 / frequencies.n_rows) * arma::cos(features);
+}
+
+template<typename KernelType>
+template<typename Archive>
+void RandomFourierFeatures<KernelType>::serialize(
+    Archive& ar,
+    const unsigned int /* version */)
+{
+  ar & BOOST_SERIALIZATION_NVP(kernel);
+  ar & BOOST_SERIALIZATION_NVP(numFeatures);
+  ar & BOOST_SERIALIZATION_NVP(frequencies);
+  ar & BOOST_SERIALIZATION_NVP(offsets);
+}
+
+} // namespace kernel
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,116 @@
+/**
+ * @file methods/random_fourier_features/spectral_distribution.hpp
+ *
+ * The spectral distributions of the shift-invariant kernels that random
+ * Fourier features can approximate.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RANDOM_FOURIER_FEATURES_SPECTRAL_DISTRIBUTION_HPP
+#define MLPACK_METHODS_RANDOM_FOURIER_FEATURES_SPECTRAL_DISTRIBUTION_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/kernels/gaussian_kernel.hpp>
+#include <mlpack/core/kernels/laplacian_kernel.hpp>
+#include <mlpack/core/kernels/cauchy_kernel.hpp>
+
+namespace mlpack {
+namespace kernel {
+
+/**
+ * The SpectralDistribution of a shift-invariant kernel K(x, y) = k(x - y) is
+ * the distribution p(w) whose Fourier transform is k (Bochner's theorem), so
+ * that K(x, y) = E_w[cos(w^T (x - y))].  The class is specialized for each
+ * kernel that RandomFourierFeatures supports; by default, IsDefined is false.
+ * A specialization should look like this:
+ *
+ * @code
+ * template<>
+ * class SpectralDistribution<MyKernel>
+ * {
+ *  public:
+ *   static const bool IsDefined = true;
+ *
+ *   // Fill the columns of frequencies with independent draws of w.
+ *   static void Random(const MyKernel& kernel, arma::mat& frequencies);
+ * };
+ * @endcode
+ */
+template<typename KernelType>
+class SpectralDistribution
+{
+ public:
+  //! Whether the spectral distribution of the kernel is known.
+  static const bool IsDefined = false;
+};
+
+/**
+ * The Gaussian kernel exp(-||x - y||^2 / (2 mu^2)) has the spectral
+ * distribution N(0, mu^-2 I).
+ */
+template<>
+class SpectralDistribution<GaussianKernel>
+{
+ public:
+  //! The spectral distribution of the Gaussian kernel is known.
+  static const bool IsDefined = true;
+
+  //! Fill the columns of frequencies with independent draws of w.
+  static void Random(const GaussianKernel& kernel, arma::mat& frequencies)
+  {
+    frequencies.randn();
+    frequencies /= kernel.Bandwidth();
+  }
+};
+
+/**
+ * The Laplacian kernel exp(-||x - y|| / mu) has a multivariate Cauchy spectral
+ * distribution with scale 1 / mu; a draw is z / (mu |u|), with z ~ N(0, I) and
+ * u ~ N(0, 1).
+ */
+template<>
+class SpectralDistribution<LaplacianKernel>
+{
+ public:
+  //! The spectral distribution of the Laplacian kernel is known.
+  static const bool IsDefined = true;
+
+  //! Fill the columns of frequencies with independent draws of w.
+  static void Random(const LaplacianKernel& kernel, arma::mat& frequencies)
+  {
+    frequencies.randn();
+    arma::rowvec scales(frequencies.n_cols, arma::fill::randn);
+    scales = 1.0 / (kernel.Bandwidth() * arma::abs(scales));
+    frequencies.each_row() %= scales;
+  }
+};
+
+/**
+ * The Cauchy kernel 1 / (1 + ||x - y||^2 / sigma^2) is a mixture of Gaussian
+ * kernels, E_t[exp(-t ||x - y||^2 / sigma^2)] with t ~ Exp(1), so a draw is
+ * sqrt(2 t) z / sigma, with z ~ N(0, I).
+ */
+template<>
+class SpectralDistribution<CauchyKernel>
+{
+ public:
+  //! The spectral distribution of the Cauchy kernel is known.
+  static const bool IsDefined = true;
+
+  //! Fill the columns of frequencies with independent draws of w.
+  static void Random(const CauchyKernel& kernel, arma::mat& frequencies)
+  {
+    frequencies.randn();
+    arma::rowvec scales(frequencies.n_cols, arma::fill::randu);
+    scales = arma::sqrt(-2.0 * arma::log(1.0 - scales)) / kernel.Bandwidth();
+    frequencies.each_row() %= scales;
+  }
+};
+
+} // namespace kernel
+} // namespace mlpack
+
+#endif
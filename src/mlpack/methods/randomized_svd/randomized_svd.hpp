@@ -14,6 +14,8 @@
 #define MLPACK_METHODS_RANDOMIZED_SVD_RANDOMIZED_SVD_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/math/lin_alg.hpp>
+#include <mlpack/core/data/prefetch_loader.hpp>
 
 namespace mlpack {
 namespace svd {
@@ -62,6 +64,25 @@ namespace svd {
  * // Use the Apply() method to get a factorization.
  * rSVD.Apply(data, u, s, v, rank);
  * @endcode
+ *
+ * Sparse matrices are never densified: the centering is applied implicitly to
+ * the products with the random matrices, and these products are computed in
+ * parallel with OpenMP.  A matrix which doesn't fit in memory can be read once,
+ * chunk by chunk, from a data::PrefetchLoader; the single-pass method of the
+ * following paper is then used.
+ *
+ * @code
+ * @article{Tropp2017,
+ *   author  = {Tropp, J. A. and Yurtsever, A. and Udell, M. and Cevher, V.},
+ *   title   = {Practical Sketching Algorithms for Low-Rank Matrix
+ *              Approximation},
+ *   journal = {SIAM J. Matrix Anal. Appl.},
+ *   volume  = {38},
+ *   number  = {4},
+ *   pages   = {1454--1485},
+ *   year    = {2017},
+ * }
+ * @endcode
  */
 class RandomizedSVD
 {
@@ -164,13 +185,13 @@ class RandomizedSVD
     if (data.n_cols >= data.n_rows)
     {
       R = arma::randn<arma::mat>(data.n_rows, iteratedPower);
-      Q = (data.t() * R) - arma::repmat(arma::trans(R.t() * rowMean),
+      Q = TransTimes(data, R) - arma::repmat(arma::trans(R.t() * rowMean),
           data.n_cols, 1);
     }
     else
     {
       R = arma::randn<arma::mat>(data.n_cols, iteratedPower);
-      Q = (data * R) - (rowMean * (arma::ones(1, data.n_cols) * R));
+      Q = Times(data, R) - (rowMean * (arma::ones(1, data.n_cols) * R));
     }
 
     // Form a matrix Q whose columns constitute a
@@ -189,15 +210,17 @@ class RandomizedSVD
     {
       if (data.n_cols >= data.n_rows)
       {
-        Q = (data * Q) - rowMean * (arma::ones(1, data.n_cols) * Q);
+        Q = Times(data, Q) - rowMean * (arma::ones(1, data.n_cols) * Q);
         arma::lu(Q, v, Q);
-        Q = (data.t() * Q) - arma::repmat(rowMean.t() * Q, data.n_cols, 1);
+        Q = TransTimes(data, Q) - arma::repmat(rowMean.t() * Q, data.n_cols,
+            1);
       }
       else
       {
-        Q = (data.t() * Q) - arma::repmat(rowMean.t() * Q, data.n_cols, 1);
+        Q = TransTimes(data, Q) - arma::repmat(rowMean.t() * Q, data.n_cols,
+            1);
         arma::lu(Q, v, Q);
-        Q = (data * Q) - (rowMean * (arma::ones(1, data.n_cols) * Q));
+        Q = Times(data, Q) - (rowMean * (arma::ones(1, data.n_cols) * Q));
       }
 
       // Computing the LU decomposition is more efficient than computing the QR
@@ -219,18 +242,46 @@ class RandomizedSVD
     // applied to Q.
     if (data.n_cols >= data.n_rows)
     {
-      Qdata = (data * Q) - rowMean * (arma::ones(1, data.n_cols) * Q);
+      Qdata = Times(data, Q) - rowMean * (arma::ones(1, data.n_cols) * Q);
       arma::svd_econ(u, s, v, Qdata);
       v = Q * v;
     }
     else
     {
-      Qdata = (Q.t() * data) - arma::repmat(Q.t() * rowMean, 1,  data.n_cols);
+      Qdata = TransTimes(data, Q).t() - arma::repmat(Q.t() * rowMean, 1,
+          data.n_cols);
       arma::svd_econ(u, s, v, Qdata);
       u = Q * u;
     }
   }
 
+  /**
+   * Compute the randomized SVD of a matrix which is read only once, chunk by
+   * chunk, from the given loader; each chunk holds the next columns of the
+   * matrix (the responses are ignored).  The sketches Y = A * Omega and
+   * W = Psi * A are accumulated while the chunks are loaded in the background,
+   * and the factorization is recovered from them, so only the sketches and one
+   * chunk are kept in memory.  The size of the range sketch is the size of the
+   * normalized power iterations (Default: 2 * rank + 1), and the size of the
+   * co-range sketch is twice that plus one.  No power iterations are
+   * performed; the factorization is truncated to the given rank.
+   *
+   * @param loader The loader of the chunks.
+   * @param u First unitary matrix.
+   * @param s Singular values.
+   * @param v Second unitary matrix; one row per column of the matrix.
+   * @param rank Rank of the approximation.
+   * @param center Whether to factorize the matrix with its mean column
+   *     subtracted from each column, as PCA does.
+   */
+  template<typename SourceType>
+  void Apply(data::PrefetchLoader<SourceType>& loader,
+             arma::mat& u,
+             arma::vec& s,
+             arma::mat& v,
+             const size_t rank,
+             const bool center = false);
+
   //! Get the size of the normalized power iterations.
   size_t IteratedPower() const { return iteratedPower; }
   //! Modify the size of the normalized power iterations.
@@ -247,6 +298,34 @@ class RandomizedSVD
   double& Epsilon() { return eps; }
 
  private:
+  //! Compute data * x.
+  static arma::mat Times(const arma::mat& data, const arma::mat& x)
+  {
+    return data * x;
+  }
+
+  //! Compute data * x in parallel, without densifying data.
+  static arma::mat Times(const arma::sp_mat& data, const arma::mat& x)
+  {
+    arma::mat result;
+    math::SparseTimes(data, x, result);
+    return result;
+  }
+
+  //! Compute data^T * x.
+  static arma::mat TransTimes(const arma::mat& data, const arma::mat& x)
+  {
+    return data.t() * x;
+  }
+
+  //! Compute data^T * x in parallel, without densifying data.
+  static arma::mat TransTimes(const arma::sp_mat& data, const arma::mat& x)
+  {
+    arma::mat result;
+    math::SparseTransTimes(data, x, result);
+    return result;
+  }
+
   //! Locally stored size of the normalized power iterations.
   size_t iteratedPower;
 
@@ -260,4 +339,7 @@ class RandomizedSVD
 } // namespace svd
 } // namespace mlpack
 
+// Include implementation.
+#include "randomized_svd_impl.hpp"
+
 #endif
@@ -0,0 +1,119 @@
+/**
+ * @file methods/randomized_svd/randomized_svd_impl.hpp
+ *
+ * Implementation of the single-pass randomized SVD method.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RANDOMIZED_SVD_RANDOMIZED_SVD_IMPL_HPP
+#define MLPACK_METHODS_RANDOMIZED_SVD_RANDOMIZED_SVD_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "randomized_svd.hpp"
+
+namespace mlpack {
+namespace svd {
+
+template<typename SourceType>
+void RandomizedSVD::Apply(data::PrefetchLoader<SourceType>& loader,
+                          arma::mat& u,
+                          arma::vec& s,
+                          arma::mat& v,
+                          const size_t rank,
+                          const bool center)
+{
+  if (rank == 0)
+  {
+    throw std::invalid_argument("RandomizedSVD::Apply(): the rank must be "
+        "positive!");
+  }
+
+  const size_t k = (iteratedPower == 0) ? 2 * rank + 1 : iteratedPower;
+  const size_t l = 2 * k + 1;
+
+  // Y = A * Omega is accumulated over the chunks; the rows of Omega of the
+  // columns of each chunk are drawn when the chunk arrives, and their sum is
+  // kept for the centering.  The columns of W = Psi * A are stored by chunk.
+  arma::mat y, psi, chunk, responses, omega;
+  arma::vec sum;
+  arma::rowvec omegaSum(k, arma::fill::zeros);
+  std::vector<arma::mat> coRange;
+  size_t n = 0;
+
+  loader.Reset();
+  while (loader.Next(chunk, responses))
+  {
+    if (chunk.n_cols == 0)
+      continue;
+
+    if (psi.is_empty())
+    {
+      psi = arma::randn<arma::mat>(l, chunk.n_rows);
+      y.zeros(chunk.n_rows, k);
+      sum.zeros(chunk.n_rows);
+    }
+    else if (chunk.n_rows != psi.n_cols)
+    {
+      throw std::invalid_argument("RandomizedSVD::Apply(): all the chunks "
+          "must have the same number of rows!");
+    }
+
+    omega = arma::randn<arma::mat>(chunk.n_cols, k);
+    y += chunk * omega;
+    coRange.push_back(psi * chunk);
+
+    if (center)
+    {
+      sum += arma::sum(chunk, 1);
+      omegaSum += arma::sum(omega, 0);
+    }
+
+    n += chunk.n_cols;
+  }
+
+  if (n == 0)
+  {
+    throw std::invalid_argument("RandomizedSVD::Apply(): the loader returned "
+        "no data!");
+  }
+
+  arma::mat w(l, n);
+  size_t offset = 0;
+  for (size_t c = 0; c < coRange.size(); ++c)
+  {
+    w.cols(offset, offset + coRange[c].n_cols - 1) = coRange[c];
+    offset += coRange[c].n_cols;
+  }
+  coRange.clear();
+
+  // The sketches of the centered matrix A - mean * 1^T.
+  if (center)
+  {
+    const arma::vec mean = sum / n;
+    y -= mean * omegaSum;
+    w.each_col() -= psi * mean;
+  }
+
+  // A ~ Q * X, where Q is a basis of the range sketch and X is the least
+  // squares solution of (Psi * Q) * X = W.
+  arma::mat q, r;
+  arma::qr_econ(q, r, y);
+  const arma::mat x = arma::solve(psi * q, w);
+
+  arma::mat ux;
+  arma::svd_econ(ux, s, v, x);
+  u = q * ux;
+
+  const size_t kept = std::min(rank, (size_t) s.n_elem);
+  u = u.head_cols(kept);
+  s = s.head(kept);
+  v = v.head_cols(kept);
+}
+
+} // namespace svd
+} // namespace mlpack
+
+#endif
@@ -259,6 +259,76 @@ class RangeSearch
               std::vector<std::vector<size_t>>& neighbors,
               std::vector<std::vector<double>>& distances);
 
+  /**
+   * Search for all reference points in the given range for each point in the
+   * query set, and pass each result to the given callback instead of storing
+   * it.  The callback is called as
+   *
+   * @code
+   * callback(queryIndex, referenceIndex, distance);
+   * @endcode
+   *
+   * for every reference point that falls into the given range of a query
+   * point, with the indices of the original query and reference sets.  The
+   * results of one query point are not reported in any particular order, and
+   * during dual-tree search they are interleaved with the results of other
+   * query points.  This is useful when the results are aggregated on the fly,
+   * or when there are too many of them to hold in memory.
+   *
+   * If NumThreads() is not 1, the search is split across threads, and the
+   * callback may be called from several threads at once; it must then be
+   * thread-safe.
+   *
+   * @param querySet Set of query points to search with.
+   * @param range Range of distances in which to search.
+   * @param callback Function object to call for each result.
+   */
+  template<typename CallbackType>
+  void Search(const MatType& querySet,
+              const math::Range& range,
+              CallbackType&& callback);
+
+  /**
+   * Search for all points in the given range for each point in the reference
+   * set (which was passed to the constructor), and pass each result to the
+   * given callback instead of storing it.  A point is not returned in the
+   * results of itself.  See the other callback overload of Search() for
+   * details on the callback.
+   *
+   * @param range Range of distances in which to search.
+   * @param callback Function object to call for each result.
+   */
+  template<typename CallbackType>
+  void Search(const math::Range& range, CallbackType&& callback);
+
+  /**
+   * Search for all reference points in the given range for each point in the
+   * query set, and store the results in compressed sparse row format: the
+   * results for query point i are held in elements offsets[i] to
+   * offsets[i + 1] - 1 of the neighbors and distances vectors.  This uses far
+   * less memory than one std::vector per query point when each query point has
+   * few neighbors.
+   *
+   * - offsets.n_elem equals the number of query points plus one.
+   *
+   * - neighbors.n_elem and distances.n_elem both equal the total number of
+   *   results.
+   *
+   * - The results of each query point are not sorted in any particular order.
+   *
+   * @param querySet Set of query points to search with.
+   * @param range Range of distances in which to search.
+   * @param offsets Vector which will hold the offset of the results of each
+   *      query point.
+   * @param neighbors Vector which will hold the indices of the results.
+   * @param distances Vector which will hold the distances of the results.
+   */
+  void Search(const MatType& querySet,
+              const math::Range& range,
+              arma::Col<size_t>& offsets,
+              arma::Col<size_t>& neighbors,
+              arma::vec& distances);
+
   //! Get whether single-tree search is being used.
   bool SingleMode() const { return singleMode; }
   //! Modify whether single-tree search is being used.
@@ -269,6 +339,13 @@ class RangeSearch
   //! Modify whether naive search is being used.
   bool& Naive() { return naive; }
 
+  //! Get the number of threads used by the callback overloads of Search() (0
+  //! means that OpenMP decides).
+  size_t NumThreads() const { return numThreads; }
+  //! Modify the number of threads used by the callback overloads of Search()
+  //! (0 means that OpenMP decides).  The default is 1.
+  size_t& NumThreads() { return numThreads; }
+
   //! Get the number of base cases during the last search.
   size_t BaseCases() const { return baseCases; }
   //! Get the number of scores during the last search.
@@ -309,6 +386,31 @@ class RangeSearch
   //! The total number of scores during the last search.
   size_t scores;
 
+  //! The number of threads used by the callback overloads of Search().
+  size_t numThreads;
+
+  //! Get the number of threads the callback overloads of Search() will use.
+  size_t SearchThreads() const;
+
+  /**
+   * Run the search of the callback overloads of Search(), split across
+   * SearchThreads() threads.  In naive and single-tree mode the query set is
+   * split into blocks; in dual-tree mode the query tree is split into disjoint
+   * subtrees.
+   *
+   * @param querySet Set of query points (the dataset of the query tree).
+   * @param queryTree Query tree (only used in dual-tree mode).
+   * @param range Range of distances in which to search.
+   * @param results Object that reports the results; each thread uses a copy.
+   * @param sameSet Whether the query set is the reference set.
+   */
+  template<typename ResultsType>
+  void CallbackTraversal(const MatType& querySet,
+                         Tree* queryTree,
+                         const math::Range& range,
+                         const ResultsType& results,
+                         const bool sameSet = false);
+
   //! For access to mappings when building models.
   friend class TrainVisitor;
 };
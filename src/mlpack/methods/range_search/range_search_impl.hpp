@@ -18,6 +18,8 @@
 // The rules for traversal.
 #include "range_search_rules.hpp"
 
+#include <mlpack/core/tree/parallel_dual_tree_traversal.hpp>
+
 namespace mlpack {
 namespace range {
 
@@ -61,7 +63,8 @@ RangeSearch<MetricType, MatType, TreeType>::RangeSearch(
     singleMode(!naive && singleMode),
     metric(metric),
     baseCases(0),
-    scores(0)
+    scores(0),
+    numThreads(1)
 {
   // Nothing to do.
 }
@@ -82,7 +85,8 @@ RangeSearch<MetricType, MatType, TreeType>::RangeSearch(
     singleMode(singleMode),
     metric(metric),
     baseCases(0),
-    scores(0)
+    scores(0),
+    numThreads(1)
 {
   // Nothing else to initialize.
 }
@@ -103,7 +107,8 @@ RangeSearch<MetricType, MatType, TreeType>::RangeSearch(
     singleMode(singleMode),
     metric(metric),
     baseCases(0),
-    scores(0)
+    scores(0),
+    numThreads(1)
 {
   // Build the tree on the empty dataset, if necessary.
   if (!naive)
@@ -131,7 +136,8 @@ RangeSearch<MetricType, MatType, TreeType>::RangeSearch(
     singleMode(other.singleMode),
     metric(other.metric),
     baseCases(other.baseCases),
-    scores(other.scores)
+    scores(other.scores),
+    numThreads(other.numThreads)
 {
   // Nothing to do.
 }
@@ -150,7 +156,8 @@ RangeSearch<MetricType, MatType, TreeType>::RangeSearch(RangeSearch&& other) :
     singleMode(other.singleMode),
     metric(std::move(other.metric)),
     baseCases(other.baseCases),
-    scores(other.scores)
+    scores(other.scores),
+    numThreads(other.numThreads)
 {
   // Clear other object.
   other.referenceTree =
@@ -187,6 +194,7 @@ RangeSearch<MetricType, MatType, TreeType>::operator=(RangeSearch other)
   metric = std::move(other.metric);
   baseCases = other.baseCases;
   scores = other.scores;
+  numThreads = other.numThreads;
 
   return *this;
 }
@@ -618,6 +626,253 @@ void RangeSearch<MetricType, MatType, TreeType>::Search(
   }
 }
 
+template<typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+template<typename CallbackType>
+void RangeSearch<MetricType, MatType, TreeType>::Search(
+    const MatType& querySet,
+    const math::Range& range,
+    CallbackType&& callback)
+{
+  if (querySet.n_rows != referenceSet->n_rows)
+  {
+    std::ostringstream oss;
+    oss << "RangeSearch::Search(): dimensionalities of query set ("
+        << querySet.n_rows << ") and reference set (" << referenceSet->n_rows
+        << ") do not match!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  // If there are no points, there is no search to be done.
+  if (referenceSet->n_cols == 0)
+    return;
+
+  Timer::Start("range_search/computing_neighbors");
+
+  // This will hold mappings for query points, if necessary.
+  std::vector<size_t> oldFromNewQueries;
+
+  // Nothing is stored, so each index is mapped back to its original index as
+  // soon as the result is found.  Query indices only need to be mapped if we
+  // build the query tree ourselves, and reference indices only if we built the
+  // reference tree ourselves.
+  const bool mapQueries = tree::TreeTraits<Tree>::RearrangesDataset &&
+      !singleMode && !naive;
+  const bool mapReferences = tree::TreeTraits<Tree>::RearrangesDataset &&
+      treeOwner;
+  auto mappedCallback = [&](const size_t queryIndex,
+                            const size_t referenceIndex,
+                            const double distance)
+  {
+    callback(mapQueries ? oldFromNewQueries[queryIndex] : queryIndex,
+        mapReferences ? oldFromNewReferences[referenceIndex] : referenceIndex,
+        distance);
+  };
+
+  CallbackResults<decltype(mappedCallback)> results(mappedCallback);
+
+  if (naive || singleMode)
+  {
+    CallbackTraversal(querySet, NULL, range, results);
+  }
+  else // Dual-tree recursion.
+  {
+    // Build the query tree.
+    Timer::Stop("range_search/computing_neighbors");
+    Timer::Start("range_search/tree_building");
+    Tree* queryTree = BuildTree<Tree>(querySet, oldFromNewQueries);
+    Timer::Stop("range_search/tree_building");
+    Timer::Start("range_search/computing_neighbors");
+
+    CallbackTraversal(queryTree->Dataset(), queryTree, range, results);
+
+    // Clean up tree memory.
+    delete queryTree;
+  }
+
+  Timer::Stop("range_search/computing_neighbors");
+}
+
+template<typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+template<typename CallbackType>
+void RangeSearch<MetricType, MatType, TreeType>::Search(
+    const math::Range& range,
+    CallbackType&& callback)
+{
+  // If there are no points, there is no search to be done.
+  if (referenceSet->n_cols == 0)
+    return;
+
+  Timer::Start("range_search/computing_neighbors");
+
+  // Here, we will use the query set as the reference set, so both indices must
+  // be mapped if we built the tree ourselves.
+  const bool mapIndices = tree::TreeTraits<Tree>::RearrangesDataset &&
+      treeOwner;
+  auto mappedCallback = [&](const size_t queryIndex,
+                            const size_t referenceIndex,
+                            const double distance)
+  {
+    callback(mapIndices ? oldFromNewReferences[queryIndex] : queryIndex,
+        mapIndices ? oldFromNewReferences[referenceIndex] : referenceIndex,
+        distance);
+  };
+
+  CallbackResults<decltype(mappedCallback)> results(mappedCallback);
+  CallbackTraversal(*referenceSet, referenceTree, range, results,
+      true /* don't return the query in the results */);
+
+  Timer::Stop("range_search/computing_neighbors");
+}
+
+template<typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void RangeSearch<MetricType, MatType, TreeType>::Search(
+    const MatType& querySet,
+    const math::Range& range,
+    arma::Col<size_t>& offsets,
+    arma::Col<size_t>& neighbors,
+    arma::vec& distances)
+{
+  // Collect the results in the order they are found, and count how many
+  // results each query point has.
+  std::vector<size_t> queries, unsortedNeighbors;
+  std::vector<double> unsortedDistances;
+  offsets.zeros(querySet.n_cols + 1);
+  Search(querySet, range, [&](const size_t queryIndex,
+                              const size_t referenceIndex,
+                              const double distance)
+  {
+    // The callback may be called from several threads at once.
+    #pragma omp critical(range_search_csr)
+    {
+      queries.push_back(queryIndex);
+      unsortedNeighbors.push_back(referenceIndex);
+      unsortedDistances.push_back(distance);
+      ++offsets[queryIndex + 1];
+    }
+  });
+
+  // Turn the counts into offsets, and then place each result in the range of
+  // its query point.
+  for (size_t i = 1; i < offsets.n_elem; ++i)
+    offsets[i] += offsets[i - 1];
+
+  neighbors.set_size(queries.size());
+  distances.set_size(queries.size());
+  arma::Col<size_t> next = offsets.head(querySet.n_cols);
+  for (size_t i = 0; i < queries.size(); ++i)
+  {
+    const size_t position = next[queries[i]]++;
+    neighbors[position] = unsortedNeighbors[i];
+    distances[position] = unsortedDistances[i];
+  }
+}
+
+template<typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+size_t RangeSearch<MetricType, MatType, TreeType>::SearchThreads() const
+{
+  // Trees whose first point is the centroid (like the cover tree) cache
+  // distances in the statistics of the reference nodes during the search, so
+  // they can only be searched by one thread.
+  if (tree::TreeTraits<Tree>::FirstPointIsCentroid)
+    return 1;
+
+  return util::Threads(numThreads);
+}
+
+template<typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+template<typename ResultsType>
+void RangeSearch<MetricType, MatType, TreeType>::CallbackTraversal(
+    const MatType& querySet,
+    Tree* queryTree,
+    const math::Range& range,
+    const ResultsType& results,
+    const bool sameSet)
+{
+  typedef RangeSearchRules<MetricType, Tree, ResultsType> RuleType;
+
+  const size_t threads = SearchThreads();
+  size_t totalBaseCases = 0;
+  size_t totalScores = 0;
+
+  if (naive || singleMode)
+  {
+    // Split the query set into contiguous blocks.  Using a few more blocks
+    // than threads helps to balance the load when some queries are more
+    // expensive than others.
+    const size_t numBlocks = std::max((size_t) 1,
+        std::min((size_t) querySet.n_cols, 4 * threads));
+    const size_t blockSize = (querySet.n_cols + numBlocks - 1) / numBlocks;
+
+    #pragma omp parallel for num_threads(threads) schedule(dynamic) \
+        reduction(+:totalBaseCases, totalScores)
+    for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+    {
+      const size_t begin = b * blockSize;
+      const size_t end = std::min(begin + blockSize, (size_t) querySet.n_cols);
+      if (begin >= end)
+        continue;
+
+      // Each block gets its own rules object, which holds its own copy of the
+      // results object; the callback itself is shared.
+      MetricType blockMetric(metric);
+      RuleType rules(*referenceSet, querySet, range, results, blockMetric,
+          sameSet);
+
+      if (naive)
+      {
+        // The naive brute-force solution.
+        for (size_t i = begin; i < end; ++i)
+          for (size_t j = 0; j < referenceSet->n_cols; ++j)
+            rules.BaseCase(i, j);
+
+        totalBaseCases += (end - begin) * referenceSet->n_cols;
+      }
+      else
+      {
+        typename Tree::template SingleTreeTraverser<RuleType> traverser(rules);
+        for (size_t i = begin; i < end; ++i)
+          traverser.Traverse(i, *referenceTree);
+
+        totalBaseCases += rules.BaseCases();
+        totalScores += rules.Scores();
+      }
+    }
+
+    baseCases = totalBaseCases;
+    scores = totalScores;
+    return;
+  }
+
+  // The rules can be split between threads, so the generic parallel
+  // traversal takes care of splitting the query tree.
+  RuleType rules(*referenceSet, querySet, range, results, metric, sameSet);
+  tree::ParallelDualTreeTraversal<Tree::template DualTreeTraverser>(
+      *queryTree, *referenceTree, rules, threads);
+
+  baseCases = rules.BaseCases();
+  scores = rules.Scores();
+}
+
 template<typename MetricType,
          typename MatType,
          template<typename TreeMetricType,
@@ -0,0 +1,103 @@
+/**
+ * @file methods/range_search/range_search_results.hpp
+ *
+ * Definition of the classes that RangeSearchRules use to store the results of
+ * a range search: VectorResults, which appends them to one vector per query
+ * point, and CallbackResults, which hands each result to a callback as soon as
+ * it is found.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RANGE_SEARCH_RANGE_SEARCH_RESULTS_HPP
+#define MLPACK_METHODS_RANGE_SEARCH_RANGE_SEARCH_RESULTS_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace range {
+
+/**
+ * VectorResults stores the neighbors and distances of each query point in a
+ * separate std::vector.  This is the default way RangeSearchRules store their
+ * results.
+ */
+class VectorResults
+{
+ public:
+  /**
+   * Store the results in the given vectors, which must already hold one
+   * (possibly empty) vector per query point.
+   */
+  VectorResults(std::vector<std::vector<size_t>>& neighbors,
+                std::vector<std::vector<double>>& distances) :
+      neighbors(neighbors),
+      distances(distances)
+  { }
+
+  //! Add a reference point that is in the range of a query point.
+  void Add(const size_t queryIndex,
+           const size_t referenceIndex,
+           const double distance)
+  {
+    neighbors[queryIndex].push_back(referenceIndex);
+    distances[queryIndex].push_back(distance);
+  }
+
+  //! Make room for up to the given number of new results for a query point.
+  void Reserve(const size_t queryIndex, const size_t count)
+  {
+    const size_t oldSize = neighbors[queryIndex].size();
+    neighbors[queryIndex].reserve(oldSize + count);
+    distances[queryIndex].reserve(oldSize + count);
+  }
+
+ private:
+  //! The neighbors of each query point.
+  std::vector<std::vector<size_t>>& neighbors;
+  //! The distances to the neighbors of each query point.
+  std::vector<std::vector<double>>& distances;
+};
+
+/**
+ * CallbackResults calls a callback for each result, so that the results don't
+ * need to be stored at all.  The callback is called as
+ *
+ * @code
+ * callback(queryIndex, referenceIndex, distance);
+ * @endcode
+ *
+ * The results of a query point are not reported contiguously: during dual-tree
+ * search the results of different query points are interleaved.
+ *
+ * @tparam CallbackType Type of the callback (a function object).
+ */
+template<typename CallbackType>
+class CallbackResults
+{
+ public:
+  //! Hand the results to the given callback, which must outlive this object.
+  CallbackResults(CallbackType& callback) : callback(callback) { }
+
+  //! Report a reference point that is in the range of a query point.
+  void Add(const size_t queryIndex,
+           const size_t referenceIndex,
+           const double distance)
+  {
+    callback(queryIndex, referenceIndex, distance);
+  }
+
+  //! Nothing needs to be reserved.
+  void Reserve(const size_t /* queryIndex */, const size_t /* count */) { }
+
+ private:
+  //! The callback.
+  CallbackType& callback;
+};
+
+} // namespace range
+} // namespace mlpack
+
+#endif
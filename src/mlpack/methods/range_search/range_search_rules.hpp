@@ -13,6 +13,8 @@
 #define MLPACK_METHODS_RANGE_SEARCH_RANGE_SEARCH_RULES_HPP
 
 #include <mlpack/core/tree/traversal_info.hpp>
+#include <mlpack/core/tree/rule_traits.hpp>
+#include "range_search_results.hpp"
 
 namespace mlpack {
 namespace range {
@@ -24,7 +26,9 @@ namespace range {
  * @tparam MetricType The metric to use for computation.
  * @tparam TreeType The tree type to use; must adhere to the TreeType API.
  */
-template<typename MetricType, typename TreeType>
+template<typename MetricType,
+         typename TreeType,
+         typename ResultsType = VectorResults>
 class RangeSearchRules
 {
  public:
@@ -49,6 +53,26 @@ class RangeSearchRules
                    MetricType& metric,
                    const bool sameSet = false);
 
+  /**
+   * Construct the RangeSearchRules object, storing the results with the given
+   * ResultsType object (for instance, a CallbackResults object that hands each
+   * result to a callback).
+   *
+   * @param referenceSet Set of reference data.
+   * @param querySet Set of query data.
+   * @param range Range to search for.
+   * @param results Object that stores (or reports) the results.
+   * @param metric Instantiated metric.
+   * @param sameSet If true, the query and reference set are taken to be the
+   *      same, and a query point will not return itself in the results.
+   */
+  RangeSearchRules(const arma::mat& referenceSet,
+                   const arma::mat& querySet,
+                   const math::Range& range,
+                   const ResultsType& results,
+                   MetricType& metric,
+                   const bool sameSet = false);
+
   /**
    * Compute the base case between the given query point and reference point.
    *
@@ -107,6 +131,21 @@ class RangeSearchRules
                  TreeType& referenceNode,
                  const double oldScore) const;
 
+  /**
+   * Return a new rules object for the same search, storing its results with
+   * the same ResultsType object, so that another thread can search a disjoint
+   * part of the query tree.
+   */
+  RangeSearchRules Split() const;
+
+  /**
+   * Add the counters of the given rules object (returned by Split()) to these
+   * rules.  The results were already stored by the shared ResultsType object.
+   *
+   * @param shard Rules object to merge.
+   */
+  void Merge(const RangeSearchRules& shard);
+
   typedef typename tree::TraversalInfo<TreeType> TraversalInfoType;
 
   const TraversalInfoType& TraversalInfo() const { return traversalInfo; }
@@ -131,11 +170,8 @@ class RangeSearchRules
   //! The range of distances for which we are searching.
   const math::Range& range;
 
-  //! The vector the resultant neighbor indices should be stored in.
-  std::vector<std::vector<size_t> >& neighbors;
-
-  //! The vector the resultant neighbor distances should be stored in.
-  std::vector<std::vector<double> >& distances;
+  //! The object that stores the resulting neighbors and distances.
+  ResultsType results;
 
   //! The instantiated metric.
   MetricType& metric;
@@ -163,6 +199,18 @@ class RangeSearchRules
 };
 
 } // namespace range
+
+namespace tree {
+
+//! RangeSearchRules can be split between threads.
+template<typename MetricType, typename TreeType, typename ResultsType>
+class RuleTraits<range::RangeSearchRules<MetricType, TreeType, ResultsType>>
+{
+ public:
+  static const bool IsSplittable = true;
+};
+
+} // namespace tree
 } // namespace mlpack
 
 // Include implementation.
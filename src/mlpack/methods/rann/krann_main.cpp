@@ -241,6 +241,11 @@ static void mlpackMain()
   rann->SampleAtLeaves() = IO::HasParam("sample_at_leaves");
   rann->FirstLeafExact() = IO::HasParam("sample_at_leaves");
 
+  // Set the number of threads to use for search.
+  RequireParamValue<int>("threads", [](int x) { return x >= 0; }, true,
+      "number of threads must be nonnegative");
+  rann->NumThreads() = (size_t) IO::GetParam<int>("threads");
+
   // Perform search, if desired.
   if (IO::HasParam("k"))
   {
@@ -171,6 +171,16 @@ class SingleSampleLimitVisitor : public boost::static_visitor<size_t&>
   size_t& operator()(RAType* ra) const;
 };
 
+/**
+ * Exposes the NumThreads() method of the given RAType.
+ */
+class NumThreadsVisitor : public boost::static_visitor<size_t&>
+{
+ public:
+  template<typename RAType>
+  size_t& operator()(RAType* ra) const;
+};
+
 /**
  * Exposes the FirstLeafExact() method of the given RAType.
  */
@@ -392,6 +402,13 @@ class RAModel
   //! Modify the limit on the size of a node that can be approximation.
   size_t& SingleSampleLimit();
 
+  //! Get the number of threads used for naive and single-tree search (0 means
+  //! that OpenMP decides).
+  size_t NumThreads() const;
+  //! Modify the number of threads used for naive and single-tree search (0
+  //! means that OpenMP decides).
+  size_t& NumThreads();
+
   //! Get the leaf size (only relevant when the kd-tree is used).
   size_t LeafSize() const;
   //! Modify the leaf size (only relevant when the kd-tree is used).
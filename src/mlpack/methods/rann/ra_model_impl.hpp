@@ -180,6 +180,15 @@ size_t& SingleSampleLimitVisitor::operator()(RAType* ra) const
   throw std::runtime_error("no rank-approximate search model is initialized");
 }
 
+//! Exposes the NumThreads() method of the given RAType.
+template<typename RAType>
+size_t& NumThreadsVisitor::operator()(RAType* ra) const
+{
+  if (ra)
+    return ra->NumThreads();
+  throw std::runtime_error("no rank-approximate search model is initialized");
+}
+
 //! Exposes the FirstLeafExact() method of the given RAType.
 template<typename RAType>
 bool& FirstLeafExactVisitor::operator()(RAType* ra) const
@@ -440,6 +449,18 @@ size_t& RAModel<SortPolicy>::SingleSampleLimit()
   return boost::apply_visitor(SingleSampleLimitVisitor(), raSearch);
 }
 
+template<typename SortPolicy>
+size_t RAModel<SortPolicy>::NumThreads() const
+{
+  return boost::apply_visitor(NumThreadsVisitor(), raSearch);
+}
+
+template<typename SortPolicy>
+size_t& RAModel<SortPolicy>::NumThreads()
+{
+  return boost::apply_visitor(NumThreadsVisitor(), raSearch);
+}
+
 template<typename SortPolicy>
 size_t RAModel<SortPolicy>::LeafSize() const
 {
@@ -356,6 +356,14 @@ class RASearch
   //! Modify the limit on the size of a node that can be approximation.
   size_t& SingleSampleLimit() { return singleSampleLimit; }
 
+  //! Get the number of threads used for naive and single-tree search (0 means
+  //! that OpenMP decides).
+  size_t NumThreads() const { return numThreads; }
+  //! Modify the number of threads used for naive and single-tree search (0
+  //! means that OpenMP decides).  Each thread samples with its own random
+  //! number generator, so the results depend on the number of threads.
+  size_t& NumThreads() { return numThreads; }
+
   //! Serialize the object.
   template<typename Archive>
   void serialize(Archive& ar, const unsigned int /* version */);
@@ -393,6 +401,34 @@ class RASearch
   //! Instantiation of kernel.
   MetricType metric;
 
+  //! The number of threads to use for search; 0 means the OpenMP default.
+  size_t numThreads;
+
+  //! Return the number of threads that a search may use.
+  size_t SearchThreads() const;
+
+  /**
+   * Perform a naive or single-tree search for the points in the given query
+   * set, using the given number of threads.  The query set is split into
+   * contiguous blocks, and each block is searched with its own RASearchRules
+   * object.  The given matrices must already be sized k x querySet.n_cols.
+   *
+   * @param querySet Set of query points.
+   * @param k Number of neighbors to search for.
+   * @param threads Number of threads to use.
+   * @param distinctSamples For naive search, the reference points sampled for
+   *     every query point (on top of the samples made by the rules).
+   * @param neighbors Matrix to store lists of neighbors for each query point.
+   * @param distances Matrix to store distances of neighbors for each query
+   *      point.
+   */
+  void BlockSearch(const MatType& querySet,
+                   const size_t k,
+                   const size_t threads,
+                   const arma::uvec& distinctSamples,
+                   arma::Mat<size_t>& neighbors,
+                   arma::mat& distances);
+
   //! For access to mappings when building models.
   template<typename SortPol>
   friend class TrainVisitor;
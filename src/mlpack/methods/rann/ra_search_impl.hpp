@@ -76,7 +76,8 @@ RASearch(MatType referenceSetIn,
     sampleAtLeaves(sampleAtLeaves),
     firstLeafExact(firstLeafExact),
     singleSampleLimit(singleSampleLimit),
-    metric(metric)
+    metric(metric),
+    numThreads(0)
 {
   // Nothing to do.
 }
@@ -108,7 +109,8 @@ RASearch(Tree* referenceTree,
     sampleAtLeaves(sampleAtLeaves),
     firstLeafExact(firstLeafExact),
     singleSampleLimit(singleSampleLimit),
-    metric(metric)
+    metric(metric),
+    numThreads(0)
 // Nothing else to initialize.
 {  }
 
@@ -139,7 +141,8 @@ RASearch(const bool naive,
     sampleAtLeaves(sampleAtLeaves),
     firstLeafExact(firstLeafExact),
     singleSampleLimit(singleSampleLimit),
-    metric(metric)
+    metric(metric),
+    numThreads(0)
 {
   // Build the tree on the empty dataset, if necessary.
   if (!naive)
@@ -291,7 +294,24 @@ Search(const MatType& querySet,
 
   typedef RASearchRules<SortPolicy, MetricType, Tree> RuleType;
 
-  if (naive)
+  const size_t threads = SearchThreads();
+  if ((naive || singleMode) && threads > 1 && querySet.n_cols > 1)
+  {
+    // Find how many samples from the reference set we need and sample
+    // uniformly from the reference set without replacement.
+    arma::uvec distinctSamples;
+    if (naive)
+    {
+      const size_t numSamples = RAUtil::MinimumSamplesReqd(
+          referenceSet->n_cols, k, tau, alpha);
+      math::ObtainDistinctSamples(0, referenceSet->n_cols, numSamples,
+          distinctSamples);
+    }
+
+    BlockSearch(querySet, k, threads, distinctSamples, *neighborPtr,
+        *distancePtr);
+  }
+  else if (naive)
   {
     RuleType rules(*referenceSet, querySet, k, metric, tau, alpha, naive,
         sampleAtLeaves, firstLeafExact, singleSampleLimit, false);
@@ -597,6 +617,83 @@ void RASearch<SortPolicy, MetricType, MatType, TreeType>::ResetQueryTree(
     ResetQueryTree(&queryNode->Child(i));
 }
 
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+size_t RASearch<SortPolicy, MetricType, MatType, TreeType>::SearchThreads()
+    const
+{
+  return util::Threads(numThreads);
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void RASearch<SortPolicy, MetricType, MatType, TreeType>::BlockSearch(
+    const MatType& querySet,
+    const size_t k,
+    const size_t threads,
+    const arma::uvec& distinctSamples,
+    arma::Mat<size_t>& neighbors,
+    arma::mat& distances)
+{
+  typedef RASearchRules<SortPolicy, MetricType, Tree> RuleType;
+
+  // Split the query set into contiguous blocks.  Using a few more blocks than
+  // threads helps to balance the load when some queries are more expensive
+  // than others.
+  const size_t numBlocks = std::min((size_t) querySet.n_cols, 4 * threads);
+  const size_t blockSize = (querySet.n_cols + numBlocks - 1) / numBlocks;
+  size_t totalDistComputations = 0;
+
+  #pragma omp parallel for num_threads(threads) schedule(dynamic) \
+      reduction(+:totalDistComputations)
+  for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+  {
+    const size_t begin = b * blockSize;
+    if (begin >= querySet.n_cols)
+      continue;
+    const size_t end = std::min(begin + blockSize, (size_t) querySet.n_cols);
+
+    // Each block gets its own rules object; the samples it makes are drawn
+    // from the random number generator of the thread.
+    const MatType queryBlock(querySet.cols(begin, end - 1));
+    MetricType blockMetric(metric);
+    RuleType rules(*referenceSet, queryBlock, k, blockMetric, tau, alpha,
+        naive, sampleAtLeaves, firstLeafExact, singleSampleLimit, false);
+
+    if (naive)
+    {
+      for (size_t i = 0; i < queryBlock.n_cols; ++i)
+        for (size_t j = 0; j < distinctSamples.n_elem; ++j)
+          rules.BaseCase(i, (size_t) distinctSamples[j]);
+    }
+    else if (!referenceTree->IsLeaf())
+    {
+      typename Tree::template SingleTreeTraverser<RuleType> traverser(rules);
+      for (size_t i = 0; i < queryBlock.n_cols; ++i)
+        traverser.Traverse(i, *referenceTree);
+    }
+
+    totalDistComputations += rules.NumDistComputations();
+
+    arma::Mat<size_t> blockNeighbors;
+    arma::mat blockDistances;
+    rules.GetResults(blockNeighbors, blockDistances);
+    neighbors.cols(begin, end - 1) = blockNeighbors;
+    distances.cols(begin, end - 1) = blockDistances;
+  }
+
+  Log::Info << "Average number of distance calculations per query point: "
+      << (totalDistComputations / querySet.n_cols) << "." << std::endl;
+}
+
 template<typename SortPolicy,
          typename MetricType,
          typename MatType,
@@ -14,6 +14,7 @@
 
 #include "regularized_svd_function.hpp"
 #include <mlpack/core/math/make_alias.hpp>
+#include <mlpack/methods/amf/sgd_schedule.hpp>
 
 namespace mlpack {
 namespace svd {
@@ -227,11 +228,15 @@ inline double ParallelSGD<ExponentialBackoff>::Optimize(
   double overallObjective = DBL_MAX;
   double lastObjective;
 
-  // The order in which the functions will be visited.
-  arma::Col<size_t> visitationOrder = arma::linspace<arma::Col<size_t>>(0,
-      (function.NumFunctions() - 1), function.NumFunctions());
+  const arma::mat& data = function.Dataset();
+  // The ratings are split into blocks that share no user and no item, and the
+  // blocks visited at the same time only change distinct parameters, so no
+  // atomic updates are needed.
+  mlpack::amf::SGDSchedule schedule(mlpack::amf::SGDSchedule::STRATIFIED);
+  schedule.Reset(data, function.NumUsers(), function.NumItems());
 
-  const arma::mat data = function.Dataset();
+  const size_t numUsers = function.NumUsers();
+  const double lambda = function.Lambda();
 
   // Iterate till the objective is within tolerance or the maximum number of
   // allowed iterations is reached. If maxIterations is 0, this will iterate
@@ -270,52 +275,25 @@ inline double ParallelSGD<ExponentialBackoff>::Optimize(
     // Get the stepsize for this iteration
     double stepSize = decayPolicy.StepSize(i);
 
-    if (shuffle) // Determine order of visitation.
-      std::shuffle(visitationOrder.begin(), visitationOrder.end(),
-          mlpack::math::randGen);
-
-    #pragma omp parallel
+    schedule.Epoch([&](const size_t j)
     {
-      // Each processor gets a subset of the instances.
-      // Each subset is of size threadShareSize.
-      size_t threadId = 0;
-      #ifdef HAS_OPENMP
-        threadId = omp_get_thread_num();
-      #endif
-
-      for (size_t j = threadId * threadShareSize;
-          j < (threadId + 1) * threadShareSize && j < visitationOrder.n_elem;
-          ++j)
-      {
-        const size_t numUsers = function.NumUsers();
-
-        // Indices for accessing the the correct parameter columns.
-        const size_t user = data(0, visitationOrder[j]);
-        const size_t item = data(1, visitationOrder[j]) + numUsers;
-
-        // Prediction error for the example.
-        const double rating = data(2, visitationOrder[j]);
-        double ratingError = rating - arma::dot(iterate.col(user),
-            iterate.col(item));
-
-        double lambda = function.Lambda();
-
-        arma::mat userUpdate = stepSize * (lambda * iterate.col(user) -
-            ratingError * iterate.col(item));
-        arma::mat itemUpdate = stepSize * (lambda * iterate.col(item) -
-            ratingError * iterate.col(user));
-
-        // Gradient is non-zero only for the parameter columns corresponding to
-        // the example.
-        for (size_t i = 0; i < iterate.n_rows; ++i)
-        {
-          #pragma omp atomic
-          iterate(i, user) -= userUpdate(i);
-          #pragma omp atomic
-          iterate(i, item) -= itemUpdate(i);
-        }
-      }
-    }
+      // Indices for accessing the the correct parameter columns.
+      const size_t user = data(0, j);
+      const size_t item = data(1, j) + numUsers;
+
+      // Prediction error for the example.
+      const double rating = data(2, j);
+      const double ratingError = rating - arma::dot(iterate.col(user),
+          iterate.col(item));
+
+      // Gradient is non-zero only for the parameter columns corresponding to
+      // the example.
+      const arma::vec userUpdate = stepSize * (lambda * iterate.col(user) -
+          ratingError * iterate.col(item));
+      iterate.col(item) -= stepSize * (lambda * iterate.col(item) -
+          ratingError * iterate.col(user));
+      iterate.col(user) -= userUpdate;
+    }, shuffle);
   }
   mlpack::Log::Info << "\n Parallel SGD terminated with objective : "
       << overallObjective << std::endl;
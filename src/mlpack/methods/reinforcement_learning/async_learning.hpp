@@ -73,7 +73,9 @@ class AsyncLearning
                 EnvironmentType environment = EnvironmentType());
 
   /**
-   * Starting async training.
+   * Starting async training.  Each thread steps a fixed subset of the
+   * workers, which apply their updates to the shared learning network without
+   * any lock (Hogwild!-style), and keep their own copy of the target network.
    *
    * @tparam Measure The type of the measurement. It should be a
    *   callable object like
@@ -14,7 +14,7 @@
 #define MLPACK_METHODS_RL_ASYNC_LEARNING_IMPL_HPP
 
 #include <mlpack/prereqs.hpp>
-#include "queue"
+#include <atomic>
 
 namespace mlpack {
 namespace rl {
@@ -68,10 +68,9 @@ void AsyncLearning<
   NetworkType learningNetwork = std::move(this->learningNetwork);
   if (learningNetwork.Parameters().is_empty())
     learningNetwork.ResetParameters();
-  NetworkType targetNetwork = learningNetwork;
-  size_t totalSteps = 0;
+  std::atomic<size_t> totalSteps(0);
   PolicyType policy = this->policy;
-  bool stop = false;
+  std::atomic<bool> stop(false);
 
   // Set up worker pool, worker 0 will be deterministic for evaluation.
   std::vector<WorkerType> workers;
@@ -80,11 +79,6 @@ void AsyncLearning<
     workers.push_back(WorkerType(updater, environment, config, !i));
     workers.back().Initialize(learningNetwork);
   }
-  // Set up task queue corresponding to worker pool.
-  std::queue<size_t> tasks;
-  for (size_t i = 0; i <= config.NumWorkers(); ++i)
-    tasks.push(i);
-
   /**
    * Compute the number of threads for the for-loop. In general, we should use
    * OpenMP task rather than for-loop, here we do so to be compatible with some
@@ -95,45 +89,35 @@ void AsyncLearning<
   numThreads++;
   Log::Debug << numThreads << " threads will be used in total." << std::endl;
 
-  #pragma omp parallel for shared(stop, workers, tasks, learningNetwork, \
-      targetNetwork, totalSteps, policy)
+  /**
+   * The workers are dealt out to the threads once: thread i steps workers i,
+   * i + numThreads, ... in turn, so no worker is ever shared and no lock is
+   * needed to hand them out.  Threads beyond the number of workers have
+   * nothing to do.
+   */
+  const size_t numTasks = workers.size();
+  #pragma omp parallel for shared(stop, workers, learningNetwork, \
+      totalSteps, policy)
   for (omp_size_t i = 0; i < numThreads; ++i)
   {
-    #pragma omp critical
-    {
-      #ifdef HAS_OPENMP
-        Log::Debug << "Thread " << omp_get_thread_num() <<
-            " started." << std::endl;
-      #endif
-    }
-    size_t task = std::numeric_limits<size_t>::max();
+    if ((size_t) i >= numTasks)
+      continue;
+
+    size_t task = i;
     while (!stop)
     {
-      // Assign task to current thread from queue.
-      #pragma omp critical
-      {
-        if (task != std::numeric_limits<size_t>::max())
-          tasks.push(task);
-
-        if (!tasks.empty())
-        {
-          task = tasks.front();
-          tasks.pop();
-        }
-      };
-
-      // This may happen when threads are more than workers.
-      if (task == std::numeric_limits<size_t>::max())
-        continue;
-
       // Get corresponding worker.
       WorkerType& worker = workers[task];
       double episodeReturn;
-      if (worker.Step(learningNetwork, targetNetwork, totalSteps,
-          policy, episodeReturn) && !task)
+      if (worker.Step(learningNetwork, totalSteps, policy, episodeReturn) &&
+          !task)
       {
         stop = measure(episodeReturn);
       }
+
+      task += numThreads;
+      if (task >= numTasks)
+        task = i;
     }
   }
 
@@ -0,0 +1,165 @@
+/**
+ * @file methods/reinforcement_learning/environment/vector_environment.hpp
+ *
+ * Wrapper that steps several copies of an RL environment in lockstep.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RL_ENVIRONMENT_VECTOR_ENVIRONMENT_HPP
+#define MLPACK_METHODS_RL_ENVIRONMENT_VECTOR_ENVIRONMENT_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace rl {
+
+/**
+ * A vector of copies of an environment, which are stepped together.  The
+ * states of all the copies are encoded into the columns of one matrix, so that
+ * an agent can compute the actions of all of them with a single pass of its
+ * network.  This is used by QLearning::Episodes() and SAC::Episodes().
+ *
+ * @code
+ * VectorEnvironment<CartPole> environments(8);
+ * std::vector<CartPole::State> states;
+ * environments.InitialSample(states);
+ *
+ * arma::mat encoded;
+ * environments.Encode(states, encoded);
+ * @endcode
+ *
+ * Any of the built-in environments (CartPole, MountainCar, Pendulum, ...) and
+ * any wrapper of them, like RewardClipping, can be used.
+ *
+ * @tparam EnvironmentType The type of the environment to copy.
+ */
+template <typename EnvironmentType>
+class VectorEnvironment
+{
+ public:
+  //! Convenient typedef for state.
+  using State = typename EnvironmentType::State;
+
+  //! Convenient typedef for action.
+  using Action = typename EnvironmentType::Action;
+
+  /**
+   * Create the given number of copies of the given environment.
+   *
+   * @param numEnvironments Number of copies to step together.
+   * @param environment The environment to copy.
+   */
+  VectorEnvironment(const size_t numEnvironments,
+                    const EnvironmentType& environment = EnvironmentType()) :
+      environments(numEnvironments, environment)
+  {
+    if (numEnvironments == 0)
+    {
+      throw std::invalid_argument("VectorEnvironment::VectorEnvironment(): "
+          "the number of environments must be positive!");
+    }
+  }
+
+  /**
+   * Restart all the environments, and get their initial states.
+   *
+   * @param states The initial state of each environment.
+   */
+  void InitialSample(std::vector<State>& states)
+  {
+    states.resize(environments.size());
+    for (size_t i = 0; i < environments.size(); ++i)
+      states[i] = environments[i].InitialSample();
+  }
+
+  /**
+   * Restart the given environment, and get its initial state.
+   *
+   * @param i Index of the environment.
+   * @return The initial state.
+   */
+  State InitialSample(const size_t i)
+  {
+    return environments[i].InitialSample();
+  }
+
+  /**
+   * Step each of the environments with its action.  Only the environments
+   * whose flag in the given mask is set are stepped; the next state and the
+   * reward of the others are left as they are.
+   *
+   * @param states The current state of each environment.
+   * @param actions The action of each environment.
+   * @param nextStates The next state of each environment.
+   * @param rewards The reward of each environment.
+   * @param active Which environments to step; if empty, all are stepped.
+   */
+  void Sample(const std::vector<State>& states,
+              const std::vector<Action>& actions,
+              std::vector<State>& nextStates,
+              arma::rowvec& rewards,
+              const std::vector<bool>& active = std::vector<bool>())
+  {
+    nextStates.resize(environments.size());
+    if (rewards.n_elem != environments.size())
+      rewards.zeros(environments.size());
+
+    for (size_t i = 0; i < environments.size(); ++i)
+    {
+      if (active.empty() || active[i])
+      {
+        rewards[i] = environments[i].Sample(states[i], actions[i],
+            nextStates[i]);
+      }
+    }
+  }
+
+  /**
+   * Check whether the given state of the given environment is terminal.
+   *
+   * @param i Index of the environment.
+   * @param state The state to check.
+   * @return true if the state is terminal.
+   */
+  bool IsTerminal(const size_t i, const State& state) const
+  {
+    return environments[i].IsTerminal(state);
+  }
+
+  /**
+   * Encode the given states into the columns of a matrix.  The matrix keeps
+   * its memory if it already has the right size.
+   *
+   * @param states The states to encode, one per environment.
+   * @param encoded The encoded states, one per column.
+   */
+  void Encode(const std::vector<State>& states, arma::mat& encoded) const
+  {
+    encoded.set_size(states.front().Encode().n_elem, states.size());
+    for (size_t i = 0; i < states.size(); ++i)
+      encoded.col(i) = states[i].Encode();
+  }
+
+  //! Get the number of environments.
+  size_t NumEnvironments() const { return environments.size(); }
+
+  //! Get the given environment.
+  const EnvironmentType& Environment(const size_t i) const
+  {
+    return environments[i];
+  }
+  //! Modify the given environment.
+  EnvironmentType& Environment(const size_t i) { return environments[i]; }
+
+ private:
+  //! The copies of the environment.
+  std::vector<EnvironmentType> environments;
+};
+
+} // namespace rl
+} // namespace mlpack
+
+#endif
@@ -17,6 +17,7 @@
 
 #include "replay/random_replay.hpp"
 #include "replay/prioritized_replay.hpp"
+#include "environment/vector_environment.hpp"
 #include "training_config.hpp"
 
 namespace mlpack {
@@ -110,6 +111,19 @@ class QLearning
    */
   double Episode();
 
+  /**
+   * Execute an episode in each of the given environments, which are stepped
+   * in lockstep: the actions of all the running environments are computed
+   * with one pass of the learning network over their encoded states, and the
+   * agent is trained once per step of the environments.  An environment that
+   * reaches a terminal state waits for the others to finish.  The replay
+   * method must store single-step transitions.
+   *
+   * @param environments The environments to run.
+   * @return Return of the episode of each environment.
+   */
+  arma::vec Episodes(VectorEnvironment<EnvironmentType>& environments);
+
   //! Modify total steps from beginning.
   size_t& TotalSteps() { return totalSteps; }
   //! Get total steps from beginning.
@@ -181,6 +195,21 @@ class QLearning
 
   //! Locally-stored flag indicating training mode or test mode.
   bool deterministic;
+
+  //! Locally-stored sampled states, kept between the training steps.
+  arma::mat sampledStates;
+
+  //! Locally-stored sampled actions.
+  std::vector<ActionType> sampledActions;
+
+  //! Locally-stored sampled rewards.
+  arma::rowvec sampledRewards;
+
+  //! Locally-stored sampled next states.
+  arma::mat sampledNextStates;
+
+  //! Locally-stored termination information of the sampled transitions.
+  arma::irowvec isTerminal;
 };
 
 } // namespace rl
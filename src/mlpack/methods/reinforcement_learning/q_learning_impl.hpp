@@ -132,13 +132,7 @@ void QLearning<
 {
   // Start experience replay.
 
-  // Sample from previous experience.
-  arma::mat sampledStates;
-  std::vector<ActionType> sampledActions;
-  arma::rowvec sampledRewards;
-  arma::mat sampledNextStates;
-  arma::irowvec isTerminal;
-
+  // Sample from previous experience, into the buffers of the agent.
   replayMethod.Sample(sampledStates, sampledActions, sampledRewards,
       sampledNextStates, isTerminal);
 
@@ -219,13 +213,7 @@ void QLearning<
 {
   // Start experience replay.
 
-  // Sample from previous experience.
-  arma::mat sampledStates;
-  std::vector<ActionType> sampledActions;
-  arma::rowvec sampledRewards;
-  arma::mat sampledNextStates;
-  arma::irowvec isTerminal;
-
+  // Sample from previous experience, into the buffers of the agent.
   replayMethod.Sample(sampledStates, sampledActions, sampledRewards,
       sampledNextStates, isTerminal);
 
@@ -385,6 +373,96 @@ double QLearning<
   return totalReturn;
 }
 
+template <
+  typename EnvironmentType,
+  typename NetworkType,
+  typename UpdaterType,
+  typename BehaviorPolicyType,
+  typename ReplayType
+>
+arma::vec QLearning<
+  EnvironmentType,
+  NetworkType,
+  UpdaterType,
+  BehaviorPolicyType,
+  ReplayType
+>::Episodes(VectorEnvironment<EnvironmentType>& environments)
+{
+  // The n-step buffer of the replay would mix the environments.
+  if (replayMethod.NSteps() != 1)
+  {
+    throw std::invalid_argument("QLearning::Episodes(): the replay method "
+        "must store single-step transitions!");
+  }
+
+  const size_t numEnvironments = environments.NumEnvironments();
+  std::vector<StateType> states, nextStates;
+  std::vector<ActionType> actions(numEnvironments);
+  std::vector<bool> active(numEnvironments);
+  arma::rowvec rewards;
+  arma::mat encodedStates, actionValues;
+  arma::vec returns(numEnvironments, arma::fill::zeros);
+
+  // Get the initial states from the environments.
+  environments.InitialSample(states);
+  size_t numActive = 0;
+  for (size_t i = 0; i < numEnvironments; ++i)
+  {
+    active[i] = !environments.IsTerminal(i, states[i]);
+    numActive += active[i];
+  }
+
+  // Running until all the environments get to a terminal state.
+  while (numActive > 0)
+  {
+    // Get the action values of all the states at once, and select an action
+    // for each running environment according to the behavior policy.
+    environments.Encode(states, encodedStates);
+    learningNetwork.Predict(encodedStates, actionValues);
+    for (size_t i = 0; i < numEnvironments; ++i)
+    {
+      if (active[i])
+      {
+        actions[i] = policy.Sample(actionValues.col(i), deterministic,
+            config.NoisyQLearning());
+      }
+    }
+
+    // Interact with the environments to advance to the next states.
+    environments.Sample(states, actions, nextStates, rewards, active);
+
+    for (size_t i = 0; i < numEnvironments; ++i)
+    {
+      if (!active[i])
+        continue;
+
+      returns[i] += rewards[i];
+      totalSteps++;
+
+      // Store the transition for replay.
+      const bool isEnd = environments.IsTerminal(i, nextStates[i]);
+      replayMethod.Store(states[i], actions[i], rewards[i], nextStates[i],
+          isEnd, config.Discount());
+      states[i] = nextStates[i];
+
+      if (isEnd)
+      {
+        active[i] = false;
+        --numActive;
+      }
+    }
+
+    if (deterministic || totalSteps < config.ExplorationSteps())
+      continue;
+    if (config.IsCategorical())
+      TrainCategoricalAgent();
+    else
+      TrainAgent();
+  }
+
+  return returns;
+}
+
 } // namespace rl
 } // namespace mlpack
 
@@ -197,20 +197,40 @@ class PrioritizedReplay
    */
   arma::ucolvec SampleProportional()
   {
-    arma::ucolvec idxes(batchSize);
-    double totalSum = idxSum.Sum(0, (full ? capacity : position));
-    double sumPerRange = totalSum / batchSize;
-    for (size_t bt = 0; bt < batchSize; bt++)
-    {
-      const double mass = arma::randu() * sumPerRange + bt * sumPerRange;
-      idxes(bt) = idxSum.FindPrefixSum(mass);
-    }
+    arma::ucolvec idxes;
+    SampleProportional(idxes);
     return idxes;
   }
 
+  /**
+   * Sample some experience according to their priorities: the total priority
+   * is split into batchSize strata, and one mass is drawn uniformly in each
+   * stratum.  All the masses search the sum tree at once.
+   *
+   * @param idxes The indices to be chosen.
+   */
+  void SampleProportional(arma::ucolvec& idxes)
+  {
+    const size_t upperBound = full ? capacity : position;
+    const double sumPerRange = idxSum.Sum(0, upperBound) / batchSize;
+
+    masses.randu(batchSize);
+    for (size_t bt = 0; bt < batchSize; bt++)
+      masses[bt] = (masses[bt] + bt) * sumPerRange;
+
+    idxSum.FindPrefixSum(masses, idxes);
+
+    // Rounding can push the last mass past the stored transitions.
+    for (size_t bt = 0; bt < batchSize; bt++)
+      idxes[bt] = std::min(idxes[bt], (arma::uword) upperBound - 1);
+  }
+
   /**
    * Sample some experience according to their priorities.
    *
+   * The outputs are resized to the batch size, so passing the same objects at
+   * each step reuses their memory.
+   *
    * @param sampledStates Sampled encoded states.
    * @param sampledActions Sampled actions.
    * @param sampledRewards Sampled rewards.
@@ -224,26 +244,22 @@ class PrioritizedReplay
               arma::mat& sampledNextStates,
               arma::irowvec& isTerminal)
   {
-    sampledIndices = SampleProportional();
+    SampleProportional(sampledIndices);
     BetaAnneal();
 
     sampledStates = states.cols(sampledIndices);
+    sampledActions.resize(sampledIndices.n_rows);
     for (size_t t = 0; t < sampledIndices.n_rows; t ++)
-      sampledActions.push_back(actions[sampledIndices[t]]);
+      sampledActions[t] = actions[sampledIndices[t]];
     sampledRewards = rewards.elem(sampledIndices).t();
     sampledNextStates = nextStates.cols(sampledIndices);
     isTerminal = this->isTerminal.elem(sampledIndices).t();
 
     // Calculate the weights of sampled transitions.
-
-    size_t numSample = full ? capacity : position;
-    weights = arma::rowvec(sampledIndices.n_rows);
-
+    const double scale = (full ? capacity : position) / idxSum.Sum();
+    weights.set_size(sampledIndices.n_rows);
     for (size_t i = 0; i < sampledIndices.n_rows; ++i)
-    {
-      double p_sample = idxSum.Get(sampledIndices(i)) / idxSum.Sum();
-      weights(i) = pow(numSample * p_sample, -beta);
-    }
+      weights(i) = std::pow(scale * idxSum.Get(sampledIndices(i)), -beta);
     weights /= weights.max();
   }
 
@@ -307,6 +323,15 @@ class PrioritizedReplay
   //! Get the number of steps for n-step agent.
   const size_t& NSteps() const { return nSteps; }
 
+  //! Get the indices of the transitions of the last sample.
+  const arma::ucolvec& SampledIndices() const { return sampledIndices; }
+
+  //! Get the encoded states of the stored transitions, one per column.
+  const arma::mat& States() const { return states; }
+
+  //! Get the encoded next states of the stored transitions, one per column.
+  const arma::mat& NextStates() const { return nextStates; }
+
  private:
   //! Locally-stored number of examples of each sample.
   size_t batchSize;
@@ -345,6 +370,9 @@ class PrioritizedReplay
   //! Locally-stored the weights of sampled transitions.
   arma::rowvec weights;
 
+  //! Locally-stored masses of the last sample, one per stratum.
+  arma::colvec masses;
+
   //! Locally-stored number of steps to look into the future.
   size_t nSteps;
 
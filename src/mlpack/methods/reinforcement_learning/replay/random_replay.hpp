@@ -13,6 +13,7 @@
 #define MLPACK_METHODS_RL_REPLAY_RANDOM_REPLAY_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/math/random.hpp>
 #include <cassert>
 
 namespace mlpack {
@@ -173,6 +174,9 @@ class RandomReplay
   /**
    * Sample some experiences.
    *
+   * The outputs are resized to the batch size, so passing the same objects at
+   * each step reuses their memory.
+   *
    * @param sampledStates Sampled encoded states.
    * @param sampledActions Sampled actions.
    * @param sampledRewards Sampled rewards.
@@ -186,13 +190,17 @@ class RandomReplay
               arma::mat& sampledNextStates,
               arma::irowvec& isTerminal)
   {
-    size_t upperBound = full ? capacity : position;
-    arma::uvec sampledIndices = arma::randi<arma::uvec>(
-        batchSize, arma::distr_param(0, upperBound - 1));
+    // The indices and the sampled matrices keep their memory from one sample
+    // to the next, so no allocation happens once they have the batch size.
+    const int upperBound = full ? capacity : position;
+    sampledIndices.set_size(batchSize);
+    for (size_t t = 0; t < batchSize; ++t)
+      sampledIndices[t] = math::RandInt(upperBound);
 
     sampledStates = states.cols(sampledIndices);
+    sampledActions.resize(sampledIndices.n_rows);
     for (size_t t = 0; t < sampledIndices.n_rows; t ++)
-      sampledActions.push_back(actions[sampledIndices[t]]);
+      sampledActions[t] = actions[sampledIndices[t]];
     sampledRewards = rewards.elem(sampledIndices).t();
     sampledNextStates = nextStates.cols(sampledIndices);
     isTerminal = this->isTerminal.elem(sampledIndices).t();
@@ -227,6 +235,15 @@ class RandomReplay
   //! Get the number of steps for n-step agent.
   const size_t& NSteps() const { return nSteps; }
 
+  //! Get the indices of the transitions of the last sample.
+  const arma::uvec& SampledIndices() const { return sampledIndices; }
+
+  //! Get the encoded states of the stored transitions, one per column.
+  const arma::mat& States() const { return states; }
+
+  //! Get the encoded next states of the stored transitions, one per column.
+  const arma::mat& NextStates() const { return nextStates; }
+
  private:
   //! Locally-stored number of examples of each sample.
   size_t batchSize;
@@ -260,6 +277,9 @@ class RandomReplay
 
   //! Locally-stored termination information of previous experience.
   arma::irowvec isTerminal;
+
+  //! Locally-stored indices of the last sample.
+  arma::uvec sampledIndices;
 };
 
 } // namespace rl
@@ -78,10 +78,17 @@ class SumTree
     {
       element[indices[i] + capacity] = data[i];
     }
-    // update the total tree with bottom-up technique.
-    for (size_t i = capacity - 1; i > 0; i--)
+
+    // Only the ancestors of the changed leaves are updated, bottom-up, so the
+    // cost is O(n log(capacity)) for n indices rather than O(capacity).
+    for (size_t i = 0; i < indices.n_rows; ++i)
     {
-      element[i] = element[2 * i] + element[2 * i + 1];
+      size_t idx = (indices[i] + capacity) / 2;
+      while (idx >= 1)
+      {
+        element[idx] = element[2 * idx] + element[2 * idx + 1];
+        idx /= 2;
+      }
     }
   }
 
@@ -178,6 +185,36 @@ class SumTree
     return idx - capacity;
   }
 
+  /**
+   * Find, for each of the given masses, the highest index `idx` in the array
+   * such that sum(arr[0] + arr[1] + ... + arr[idx]) <= mass.  All the masses
+   * descend the tree together, one level at a time, in a branch-free loop
+   * over the batch.
+   *
+   * @param masses The upper bounds of the segment array sums.
+   * @param indices The found indices, one per mass.
+   */
+  void FindPrefixSum(arma::Col<T> masses, arma::ucolvec& indices)
+  {
+    indices.ones(masses.n_elem);
+    const T* tree = element.data();
+    T* mass = masses.memptr();
+    arma::uword* idx = indices.memptr();
+
+    for (size_t level = 1; level < capacity; level *= 2)
+    {
+      for (size_t i = 0; i < masses.n_elem; ++i)
+      {
+        const T left = tree[2 * idx[i]];
+        const bool right = (left <= mass[i]);
+        mass[i] -= right ? left : T(0);
+        idx[i] = 2 * idx[i] + right;
+      }
+    }
+
+    indices -= capacity;
+  }
+
  private:
   //! The capacity of the data array.
   size_t capacity;
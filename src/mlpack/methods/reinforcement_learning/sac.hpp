@@ -16,6 +16,7 @@
 #include <mlpack/prereqs.hpp>
 
 #include "replay/random_replay.hpp"
+#include "environment/vector_environment.hpp"
 #include <mlpack/methods/ann/activation_functions/tanh_function.hpp>
 #include <mlpack/methods/ann/loss_functions/mean_squared_error.hpp>
 #include <mlpack/methods/ann/visitor/parameters_visitor.hpp>
@@ -122,6 +123,19 @@ class SAC
    */
   double Episode();
 
+  /**
+   * Execute an episode in each of the given environments, which are stepped
+   * in lockstep: the actions of all the running environments are computed
+   * with one pass of the policy network over their encoded states, and the
+   * networks are updated UpdateInterval() times per step of the environments.
+   * An environment that reaches a terminal state waits for the others to
+   * finish.  The replay method must store single-step transitions.
+   *
+   * @param environments The environments to run.
+   * @return Return of the episode of each environment.
+   */
+  arma::vec Episodes(VectorEnvironment<EnvironmentType>& environments);
+
   //! Modify total steps from beginning.
   size_t& TotalSteps() { return totalSteps; }
   //! Get total steps from beginning.
@@ -358,6 +358,107 @@ double SAC<
   return totalReturn;
 }
 
+template <
+  typename EnvironmentType,
+  typename QNetworkType,
+  typename PolicyNetworkType,
+  typename UpdaterType,
+  typename ReplayType
+>
+arma::vec SAC<
+  EnvironmentType,
+  QNetworkType,
+  PolicyNetworkType,
+  UpdaterType,
+  ReplayType
+>::Episodes(VectorEnvironment<EnvironmentType>& environments)
+{
+  // The n-step buffer of the replay would mix the environments.
+  if (replayMethod.NSteps() != 1)
+  {
+    throw std::invalid_argument("SAC::Episodes(): the replay method must "
+        "store single-step transitions!");
+  }
+
+  const size_t numEnvironments = environments.NumEnvironments();
+  std::vector<StateType> states, nextStates;
+  std::vector<ActionType> actions(numEnvironments);
+  std::vector<bool> active(numEnvironments);
+  arma::rowvec rewards;
+  arma::mat encodedStates, outputActions;
+  arma::vec returns(numEnvironments, arma::fill::zeros);
+
+  // Get the initial states from the environments.
+  environments.InitialSample(states);
+  size_t numActive = 0;
+  for (size_t i = 0; i < numEnvironments; ++i)
+  {
+    active[i] = !environments.IsTerminal(i, states[i]);
+    numActive += active[i];
+  }
+
+  // Track the steps in this episode.
+  size_t steps = 0;
+
+  // Running until all the environments get to a terminal state.
+  while (numActive > 0)
+  {
+    if (config.StepLimit() && steps >= config.StepLimit())
+      break;
+
+    // Get the actions of all the states at once, from policy.
+    environments.Encode(states, encodedStates);
+    policyNetwork.Predict(encodedStates, outputActions);
+    if (!deterministic)
+    {
+      arma::mat noise = arma::randn<arma::mat>(arma::size(outputActions)) *
+          0.1;
+      outputActions += arma::clamp(noise, -0.25, 0.25);
+    }
+
+    for (size_t i = 0; i < numEnvironments; ++i)
+    {
+      if (active[i])
+      {
+        actions[i].action = arma::conv_to<std::vector<double>>::from(
+            outputActions.col(i));
+      }
+    }
+
+    // Interact with the environments to advance to the next states.
+    environments.Sample(states, actions, nextStates, rewards, active);
+    steps++;
+
+    for (size_t i = 0; i < numEnvironments; ++i)
+    {
+      if (!active[i])
+        continue;
+
+      returns[i] += rewards[i];
+      totalSteps++;
+
+      // Store the transition for replay.
+      const bool isEnd = environments.IsTerminal(i, nextStates[i]);
+      replayMethod.Store(states[i], actions[i], rewards[i], nextStates[i],
+          isEnd, config.Discount());
+      states[i] = nextStates[i];
+
+      if (isEnd)
+      {
+        active[i] = false;
+        --numActive;
+      }
+    }
+
+    if (deterministic || totalSteps < config.ExplorationSteps())
+      continue;
+    for (size_t i = 0; i < config.UpdateInterval(); i++)
+      Update();
+  }
+
+  return returns;
+}
+
 } // namespace rl
 } // namespace mlpack
 #endif
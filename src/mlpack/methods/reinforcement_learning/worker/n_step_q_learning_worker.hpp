@@ -15,6 +15,8 @@
 
 #include <mlpack/methods/reinforcement_learning/training_config.hpp>
 
+#include <atomic>
+
 namespace mlpack {
 namespace rl {
 
@@ -60,7 +62,8 @@ class NStepQLearningWorker
       environment(environment),
       config(config),
       deterministic(deterministic),
-      pending(config.UpdateInterval())
+      pending(config.UpdateInterval()),
+      targetVersion(0)
   { Reset(); }
 
   /**
@@ -81,6 +84,8 @@ class NStepQLearningWorker
       pending(other.pending),
       pendingIndex(other.pendingIndex),
       network(other.network),
+      targetNetwork(other.targetNetwork),
+      targetVersion(other.targetVersion),
       state(other.state)
   {
     #if ENS_VERSION_MAJOR >= 2
@@ -111,6 +116,8 @@ class NStepQLearningWorker
       pending(std::move(other.pending)),
       pendingIndex(std::move(other.pendingIndex)),
       network(std::move(other.network)),
+      targetNetwork(std::move(other.targetNetwork)),
+      targetVersion(other.targetVersion),
       state(std::move(other.state))
   {
     #if ENS_VERSION_MAJOR >= 2
@@ -146,6 +153,8 @@ class NStepQLearningWorker
     pending = other.pending;
     pendingIndex = other.pendingIndex;
     network = other.network;
+    targetNetwork = other.targetNetwork;
+    targetVersion = other.targetVersion;
     state = other.state;
 
     #if ENS_VERSION_MAJOR >= 2
@@ -183,6 +192,8 @@ class NStepQLearningWorker
     pending = std::move(other.pending);
     pendingIndex = std::move(other.pendingIndex);
     network = std::move(other.network);
+    targetNetwork = std::move(other.targetNetwork);
+    targetVersion = other.targetVersion;
     state = std::move(other.state);
 
     #if ENS_VERSION_MAJOR >= 2
@@ -227,13 +238,21 @@ class NStepQLearningWorker
 
     // Build local network.
     network = learningNetwork;
+
+    // Build the local copy of the target network.
+    targetNetwork = learningNetwork;
+    targetVersion = 0;
   }
 
   /**
    * The agent will execute one step.
    *
+   * Nothing is locked: the gradients are applied to the shared learning
+   * network without synchronization, as in Hogwild!, and the target network
+   * is a local copy of the learning network, refreshed whenever the shared
+   * step counter crosses a multiple of TargetNetworkSyncInterval().
+   *
    * @param learningNetwork The shared learning network.
-   * @param targetNetwork The shared target network.
    * @param totalSteps The shared counter for total steps.
    * @param policy The shared behavior policy.
    * @param totalReward This will be the episode return if the episode ends
@@ -241,8 +260,7 @@ class NStepQLearningWorker
    * @return Indicate whether current episode ends after this step.
    */
   bool Step(NetworkType& learningNetwork,
-            NetworkType& targetNetwork,
-            size_t& totalSteps,
+            std::atomic<size_t>& totalSteps,
             PolicyType& policy,
             double& totalReward)
   {
@@ -272,7 +290,6 @@ class NStepQLearningWorker
       return false;
     }
 
-    #pragma omp atomic
     totalSteps++;
 
     pending[pendingIndex] = std::make_tuple(state, action, reward, nextState);
@@ -280,6 +297,15 @@ class NStepQLearningWorker
 
     if (terminal || pendingIndex >= config.UpdateInterval())
     {
+      // Sync the local target network with the global network once per
+      // interval of the shared step counter.
+      const size_t version = totalSteps / config.TargetNetworkSyncInterval();
+      if (version != targetVersion)
+      {
+        targetNetwork = learningNetwork;
+        targetVersion = version;
+      }
+
       // Initialize the gradient storage.
       arma::mat totalGradients(learningNetwork.Parameters().n_rows,
           learningNetwork.Parameters().n_cols, arma::fill::zeros);
@@ -289,8 +315,7 @@ class NStepQLearningWorker
       double target = 0;
       if (!terminal)
       {
-        #pragma omp critical
-        { targetNetwork.Predict(nextState.Encode(), actionValue); };
+        targetNetwork.Predict(nextState.Encode(), actionValue);
         target = actionValue.max();
       }
 
@@ -334,13 +359,6 @@ class NStepQLearningWorker
       pendingIndex = 0;
     }
 
-    // Update global target network.
-    if (totalSteps % config.TargetNetworkSyncInterval() == 0)
-    {
-      #pragma omp critical
-      { targetNetwork = learningNetwork; }
-    }
-
     policy.Anneal();
 
     if (terminal)
@@ -395,6 +413,12 @@ class NStepQLearningWorker
   //! Local network of the worker.
   NetworkType network;
 
+  //! Local copy of the target network.
+  NetworkType targetNetwork;
+
+  //! Sync interval of the shared step counter the target network is from.
+  size_t targetVersion;
+
   //! Current state of the agent.
   StateType state;
 };
@@ -27,49 +27,101 @@ SoftmaxRegression(const size_t inputSize,
       parameters, inputSize, numClasses, fitIntercept);
 }
 
+template<typename MatType>
+void SoftmaxRegression::ClassifyInternal(const MatType& dataset,
+                                         arma::mat& probabilities) const
+{
+  if (dataset.n_rows != FeatureSize())
+  {
+    std::ostringstream oss;
+    oss << "SoftmaxRegression::Classify(): dataset has " << dataset.n_rows
+        << " dimensions, but model has " << FeatureSize() << " dimensions!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  // Calculate the probabilities for each test input.
+  arma::mat hypothesis;
+  if (fitIntercept)
+  {
+    // In order to add the intercept term, we should compute following matrix:
+    //     [1; data] = arma::join_cols(ones(1, data.n_cols), data)
+    //     hypothesis = arma::exp(parameters * [1; data]).
+    //
+    // Since the cost of join maybe high due to the copy of original data,
+    // split the hypothesis computation to two components.
+    hypothesis = arma::exp(
+      arma::repmat(parameters.col(0), 1, dataset.n_cols) +
+      parameters.cols(1, parameters.n_cols - 1) * dataset);
+  }
+  else
+  {
+    hypothesis = arma::exp(parameters * dataset);
+  }
+
+  probabilities = hypothesis / arma::repmat(arma::sum(hypothesis, 0),
+                                            numClasses, 1);
+}
+
+
 void SoftmaxRegression::Classify(const arma::mat& dataset,
                                  arma::Row<size_t>& labels)
     const
 {
   arma::mat probabilities;
-  Classify(dataset, probabilities);
+  ClassifyInternal(dataset, probabilities);
+  GetLabels(probabilities, labels);
+}
 
-  // Prepare necessary data.
-  labels.zeros(dataset.n_cols);
-  double maxProbability = 0;
+void SoftmaxRegression::Classify(const arma::sp_mat& dataset,
+                                 arma::Row<size_t>& labels)
+    const
+{
+  arma::mat probabilities;
+  ClassifyInternal(dataset, probabilities);
+  GetLabels(probabilities, labels);
+}
 
-  // For each test input.
-  for (size_t i = 0; i < dataset.n_cols; ++i)
-  {
-    // For each class.
-    for (size_t j = 0; j < numClasses; ++j)
-    {
-      // If a higher class probability is encountered, change prediction.
-      if (probabilities(j, i) > maxProbability)
-      {
-        maxProbability = probabilities(j, i);
-        labels(i) = j;
-      }
-    }
+void SoftmaxRegression::Classify(const arma::mat& dataset,
+                                 arma::Row<size_t>& labels,
+                                 arma::mat& probabilities)
+    const
+{
+  ClassifyInternal(dataset, probabilities);
+  GetLabels(probabilities, labels);
+}
 
-    // Set maximum probability to zero for the next input.
-    maxProbability = 0;
-  }
+void SoftmaxRegression::Classify(const arma::sp_mat& dataset,
+                                 arma::Row<size_t>& labels,
+                                 arma::mat& probabilities)
+    const
+{
+  ClassifyInternal(dataset, probabilities);
+  GetLabels(probabilities, labels);
 }
 
 void SoftmaxRegression::Classify(const arma::mat& dataset,
-                                 arma::Row<size_t>& labels,
                                  arma::mat& probabilities)
     const
 {
-  Classify(dataset, probabilities);
+  ClassifyInternal(dataset, probabilities);
+}
 
+void SoftmaxRegression::Classify(const arma::sp_mat& dataset,
+                                 arma::mat& probabilities)
+    const
+{
+  ClassifyInternal(dataset, probabilities);
+}
+
+void SoftmaxRegression::GetLabels(const arma::mat& probabilities,
+                                  arma::Row<size_t>& labels) const
+{
   // Prepare necessary data.
-  labels.zeros(dataset.n_cols);
+  labels.zeros(probabilities.n_cols);
   double maxProbability = 0;
 
   // For each test input.
-  for (size_t i = 0; i < dataset.n_cols; ++i)
+  for (size_t i = 0; i < probabilities.n_cols; ++i)
   {
     // For each class.
     for (size_t j = 0; j < numClasses; ++j)
@@ -87,41 +139,6 @@ void SoftmaxRegression::Classify(const arma::mat& dataset,
   }
 }
 
-void SoftmaxRegression::Classify(const arma::mat& dataset,
-                                 arma::mat& probabilities)
-    const
-{
-  if (dataset.n_rows != FeatureSize())
-  {
-    std::ostringstream oss;
-    oss << "SoftmaxRegression::Classify(): dataset has " << dataset.n_rows
-        << " dimensions, but model has " << FeatureSize() << " dimensions!";
-    throw std::invalid_argument(oss.str());
-  }
-
-  // Calculate the probabilities for each test input.
-  arma::mat hypothesis;
-  if (fitIntercept)
-  {
-    // In order to add the intercept term, we should compute following matrix:
-    //     [1; data] = arma::join_cols(ones(1, data.n_cols), data)
-    //     hypothesis = arma::exp(parameters * [1; data]).
-    //
-    // Since the cost of join maybe high due to the copy of original data,
-    // split the hypothesis computation to two components.
-    hypothesis = arma::exp(
-      arma::repmat(parameters.col(0), 1, dataset.n_cols) +
-      parameters.cols(1, parameters.n_cols - 1) * dataset);
-  }
-  else
-  {
-    hypothesis = arma::exp(parameters * dataset);
-  }
-
-  probabilities = hypothesis / arma::repmat(arma::sum(hypothesis, 0),
-                                            numClasses, 1);
-}
-
 double SoftmaxRegression::ComputeAccuracy(
     const arma::mat& testData,
     const arma::Row<size_t>& labels) const
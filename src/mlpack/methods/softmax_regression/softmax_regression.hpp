@@ -117,6 +117,49 @@ class SoftmaxRegression
                     const bool fitIntercept,
                     OptimizerType optimizer,
                     CallbackTypes&&... callbacks);
+  /**
+   * Construct the SoftmaxRegression class with the provided sparse data and
+   * labels, and train the model.  The products with the data only visit its
+   * nonzeros, so the data never has to be densified.
+   *
+   * @tparam OptimizerType Desired optimizer type.
+   * @param data Sparse input training features, one sample per column.
+   * @param labels Labels associated with the feature data.
+   * @param numClasses Number of classes for classification.
+   * @param lambda L2-regularization constant.
+   * @param fitIntercept add intercept term or not.
+   * @param optimizer Desired optimizer.
+   */
+  template<typename OptimizerType = ens::L_BFGS>
+  SoftmaxRegression(const arma::sp_mat& data,
+                    const arma::Row<size_t>& labels,
+                    const size_t numClasses,
+                    const double lambda = 0.0001,
+                    const bool fitIntercept = false,
+                    OptimizerType optimizer = OptimizerType());
+  /**
+   * Construct the SoftmaxRegression class with the provided sparse data and
+   * labels, and train the model with the given callbacks.
+   *
+   * @tparam OptimizerType Desired optimizer type.
+   * @tparam CallbackTypes Types of Callback Functions.
+   * @param data Sparse input training features, one sample per column.
+   * @param labels Labels associated with the feature data.
+   * @param numClasses Number of classes for classification.
+   * @param lambda L2-regularization constant.
+   * @param fitIntercept add intercept term or not.
+   * @param optimizer Desired optimizer.
+   * @param callbacks Callback function for ensmallen optimizer `OptimizerType`.
+   *        See https://www.ensmallen.org/docs.html#callback-documentation.
+   */
+  template<typename OptimizerType, typename... CallbackTypes>
+  SoftmaxRegression(const arma::sp_mat& data,
+                    const arma::Row<size_t>& labels,
+                    const size_t numClasses,
+                    const double lambda,
+                    const bool fitIntercept,
+                    OptimizerType optimizer,
+                    CallbackTypes&&... callbacks);
   /**
    * Classify the given points, returning the predicted labels for each point.
    * The function calculates the probabilities for every class, given a data
@@ -126,6 +169,15 @@ class SoftmaxRegression
    * @param labels Predicted labels for each point.
    */
   void Classify(const arma::mat& dataset, arma::Row<size_t>& labels) const;
+
+  /**
+   * Classify the given sparse points, returning the predicted labels for each
+   * point.
+   *
+   * @param dataset Sparse set of points to classify.
+   * @param labels Predicted labels for each point.
+   */
+  void Classify(const arma::sp_mat& dataset, arma::Row<size_t>& labels) const;
   /**
    * Classify the given point. The predicted class label is returned.
    * The function calculates the probabilites for every class, given the point.
@@ -151,6 +203,18 @@ class SoftmaxRegression
                 arma::Row<size_t>& labels,
                 arma::mat& probabilities) const;
 
+  /**
+   * Classify the given sparse points, returning class probabilities and
+   * predicted class label for each point.
+   *
+   * @param dataset Sparse matrix of data points to be classified.
+   * @param labels Predicted labels for each point.
+   * @param probabilities Class probabilities for each point.
+   */
+  void Classify(const arma::sp_mat& dataset,
+                arma::Row<size_t>& labels,
+                arma::mat& probabilities) const;
+
   /**
    * Classify the given points, returning class probabilities for each point.
    *
@@ -160,6 +224,16 @@ class SoftmaxRegression
   void Classify(const arma::mat& dataset,
                 arma::mat& probabilities) const;
 
+  /**
+   * Classify the given sparse points, returning class probabilities for each
+   * point.
+   *
+   * @param dataset Sparse matrix of data points to be classified.
+   * @param probabilities Class probabilities for each point.
+   */
+  void Classify(const arma::sp_mat& dataset,
+                arma::mat& probabilities) const;
+
   /**
    * Computes accuracy of the learned model given the feature data and the
    * labels associated with each data point. Predictions are made using the
@@ -185,6 +259,23 @@ class SoftmaxRegression
                const arma::Row<size_t>& labels,
                const size_t numClasses,
                OptimizerType optimizer = OptimizerType());
+  /**
+   * Train the softmax regression with the given sparse training data.  With a
+   * separable optimizer which takes sparse gradients (like ens::ParallelSGD),
+   * each step only touches the parameters of the features in the batch.
+   *
+   * @tparam OptimizerType Desired optimizer type.
+   * @param data Sparse input data with each column as one example.
+   * @param labels Labels associated with the feature data.
+   * @param numClasses Number of classes for classification.
+   * @param optimizer Desired optimizer.
+   * @return Objective value of the final point.
+   */
+  template<typename OptimizerType = ens::L_BFGS>
+  double Train(const arma::sp_mat& data,
+               const arma::Row<size_t>& labels,
+               const size_t numClasses,
+               OptimizerType optimizer = OptimizerType());
   /**
    * Train the softmax regression with the given training data.
    *
@@ -204,6 +295,26 @@ class SoftmaxRegression
                const size_t numClasses,
                OptimizerType optimizer,
                CallbackTypes&&... callbacks);
+  /**
+   * Train the softmax regression with the given sparse training data and
+   * callbacks.
+   *
+   * @tparam OptimizerType Desired optimizer type.
+   * @tparam CallbackTypes Types of Callback Functions.
+   * @param data Sparse input data with each column as one example.
+   * @param labels Labels associated with the feature data.
+   * @param numClasses Number of classes for classification.
+   * @param optimizer Desired optimizer.
+   * @param callbacks Callback function for ensmallen optimizer `OptimizerType`.
+   *      See https://www.ensmallen.org/docs.html#callback-documentation.
+   * @return Objective value of the final point.
+   */
+  template<typename OptimizerType = ens::L_BFGS, typename... CallbackTypes>
+  double Train(const arma::sp_mat& data,
+               const arma::Row<size_t>& labels,
+               const size_t numClasses,
+               OptimizerType optimizer,
+               CallbackTypes&&... callbacks);
 
   //! Sets the number of classes.
   size_t& NumClasses() { return numClasses; }
@@ -241,6 +352,23 @@ class SoftmaxRegression
   }
 
  private:
+  //! Train the model on dense or sparse data.
+  template<typename MatType, typename OptimizerType, typename... CallbackTypes>
+  double TrainInternal(const MatType& data,
+                       const arma::Row<size_t>& labels,
+                       const size_t numClasses,
+                       OptimizerType& optimizer,
+                       CallbackTypes&&... callbacks);
+
+  //! Compute the class probabilities of dense or sparse points.
+  template<typename MatType>
+  void ClassifyInternal(const MatType& dataset,
+                        arma::mat& probabilities) const;
+
+  //! Get the most probable class of each point.
+  void GetLabels(const arma::mat& probabilities,
+                 arma::Row<size_t>& labels) const;
+
   //! Parameters after optimization.
   arma::mat parameters;
   //! Number of classes.
@@ -18,7 +18,16 @@
 namespace mlpack {
 namespace regression {
 
-class SoftmaxRegressionFunction
+/**
+ * The objective function of softmax regression.  The data can be dense
+ * (arma::mat) or sparse (arma::sp_mat); with sparse data, the products with
+ * the data only visit its nonzeros, and the sparse batch Gradient() only
+ * touches the parameters of the features which appear in the batch.
+ *
+ * @tparam MatType Type of the data matrix.
+ */
+template<typename MatType = arma::mat>
+class SoftmaxRegressionFunctionType
 {
  public:
   /**
@@ -31,11 +40,11 @@ class SoftmaxRegressionFunction
    * @param lambda L2-regularization constant.
    * @param fitIntercept Intercept term flag.
    */
-  SoftmaxRegressionFunction(const arma::mat& data,
-                            const arma::Row<size_t>& labels,
-                            const size_t numClasses,
-                            const double lambda = 0.0001,
-                            const bool fitIntercept = false);
+  SoftmaxRegressionFunctionType(const MatType& data,
+                                const arma::Row<size_t>& labels,
+                                const size_t numClasses,
+                                const double lambda = 0.0001,
+                                const bool fitIntercept = false);
 
   //! Initializes the parameters of the model to suitable values.
   const arma::mat InitializeWeights();
@@ -150,6 +159,25 @@ class SoftmaxRegressionFunction
                 arma::mat& gradient,
                 const size_t batchSize = 1) const;
 
+  /**
+   * Evaluate the gradient of the objective function on a subset of the data
+   * as a sparse matrix.  Only the intercepts and the columns of the features
+   * which are nonzero in a point of the batch get a gradient, so with sparse
+   * data the cost only depends on the nonzeros of the batch.  The L2
+   * regularization is applied lazily, to these columns only; this makes the
+   * gradients of the batches separable, as sparse optimizers like
+   * ens::ParallelSGD (or ens::SGD with an arma::sp_mat gradient type) expect.
+   *
+   * @param parameters Current values of the model parameters.
+   * @param start First index of the data points to use.
+   * @param gradient Sparse matrix to store gradient into.
+   * @param batchSize Number of data points to evaluate gradient for.
+   */
+  void Gradient(const arma::mat& parameters,
+                const size_t start,
+                arma::sp_mat& gradient,
+                const size_t batchSize = 1) const;
+
   /**
    * Evaluates the gradient values of the objective function given the current
    * set of parameters for a single feature indexed by j.
@@ -188,8 +216,19 @@ class SoftmaxRegressionFunction
   bool FitIntercept() const { return fitIntercept; }
 
  private:
+  //! Get the given columns of dense data.
+  static arma::mat SelectColumns(const arma::mat& data,
+                                 const arma::uvec& ordering)
+  {
+    return data.cols(ordering);
+  }
+
+  //! Get the given columns of sparse data, visiting only the nonzeros.
+  static arma::sp_mat SelectColumns(const arma::sp_mat& data,
+                                    const arma::uvec& ordering);
+
   //! Training data matrix.  This is an alias until the data is shuffled.
-  arma::mat data;
+  MatType data;
   //! Label matrix for the provided data.
   arma::sp_mat groundTruth;
   //! Initial parameter point.
@@ -202,7 +241,13 @@ class SoftmaxRegressionFunction
   bool fitIntercept;
 };
 
+//! The objective function of softmax regression on dense data.
+using SoftmaxRegressionFunction = SoftmaxRegressionFunctionType<arma::mat>;
+
 } // namespace regression
 } // namespace mlpack
 
+// Include implementation.
+#include "softmax_regression_function_impl.hpp"
+
 #endif
@@ -49,6 +49,37 @@ SoftmaxRegression::SoftmaxRegression(
   Train(data, labels, numClasses, optimizer, callbacks...);
 }
 
+template<typename OptimizerType>
+SoftmaxRegression::SoftmaxRegression(
+    const arma::sp_mat& data,
+    const arma::Row<size_t>& labels,
+    const size_t numClasses,
+    const double lambda,
+    const bool fitIntercept,
+    OptimizerType optimizer) :
+    numClasses(numClasses),
+    lambda(lambda),
+    fitIntercept(fitIntercept)
+{
+  Train(data, labels, numClasses, optimizer);
+}
+
+template<typename OptimizerType, typename... CallbackTypes>
+SoftmaxRegression::SoftmaxRegression(
+    const arma::sp_mat& data,
+    const arma::Row<size_t>& labels,
+    const size_t numClasses,
+    const double lambda,
+    const bool fitIntercept,
+    OptimizerType optimizer,
+    CallbackTypes&&... callbacks) :
+    numClasses(numClasses),
+    lambda(lambda),
+    fitIntercept(fitIntercept)
+{
+  Train(data, labels, numClasses, optimizer, callbacks...);
+}
+
 template<typename VecType>
 size_t SoftmaxRegression::Classify(const VecType& point) const
 {
@@ -63,20 +94,16 @@ double SoftmaxRegression::Train(const arma::mat& data,
                                 const size_t numClasses,
                                 OptimizerType optimizer)
 {
-  SoftmaxRegressionFunction regressor(data, labels, numClasses, lambda,
-                                      fitIntercept);
-  if (parameters.n_elem != regressor.GetInitialPoint().n_elem)
-    parameters = regressor.GetInitialPoint();
-
-  // Train the model.
-  Timer::Start("softmax_regression_optimization");
-  const double out = optimizer.Optimize(regressor, parameters);
-  Timer::Stop("softmax_regression_optimization");
-
-  Log::Info << "SoftmaxRegression::SoftmaxRegression(): final objective of "
-            << "trained model is " << out << "." << std::endl;
+  return TrainInternal(data, labels, numClasses, optimizer);
+}
 
-  return out;
+template<typename OptimizerType>
+double SoftmaxRegression::Train(const arma::sp_mat& data,
+                                const arma::Row<size_t>& labels,
+                                const size_t numClasses,
+                                OptimizerType optimizer)
+{
+  return TrainInternal(data, labels, numClasses, optimizer);
 }
 
 template<typename OptimizerType, typename... CallbackTypes>
@@ -86,8 +113,28 @@ double SoftmaxRegression::Train(const arma::mat& data,
                                 OptimizerType optimizer,
                                 CallbackTypes&&... callbacks)
 {
-  SoftmaxRegressionFunction regressor(data, labels, numClasses, lambda,
-                                      fitIntercept);
+  return TrainInternal(data, labels, numClasses, optimizer, callbacks...);
+}
+
+template<typename OptimizerType, typename... CallbackTypes>
+double SoftmaxRegression::Train(const arma::sp_mat& data,
+                                const arma::Row<size_t>& labels,
+                                const size_t numClasses,
+                                OptimizerType optimizer,
+                                CallbackTypes&&... callbacks)
+{
+  return TrainInternal(data, labels, numClasses, optimizer, callbacks...);
+}
+
+template<typename MatType, typename OptimizerType, typename... CallbackTypes>
+double SoftmaxRegression::TrainInternal(const MatType& data,
+                                        const arma::Row<size_t>& labels,
+                                        const size_t numClasses,
+                                        OptimizerType& optimizer,
+                                        CallbackTypes&&... callbacks)
+{
+  SoftmaxRegressionFunctionType<MatType> regressor(data, labels, numClasses,
+      lambda, fitIntercept);
   if (parameters.n_elem != regressor.GetInitialPoint().n_elem)
     parameters = regressor.GetInitialPoint();
 
@@ -11,6 +11,8 @@
  */
 #include "sparse_autoencoder_function.hpp"
 
+#include <mlpack/core/math/make_alias.hpp>
+
 using namespace mlpack;
 using namespace mlpack::nn;
 using namespace std;
@@ -21,7 +23,7 @@ SparseAutoencoderFunction::SparseAutoencoderFunction(const arma::mat& data,
                                                      const double lambda,
                                                      const double beta,
                                                      const double rho) :
-    data(data),
+    data(math::MakeAlias(const_cast<arma::mat&>(data), false)),
     visibleSize(visibleSize),
     hiddenSize(hiddenSize),
     lambda(lambda),
@@ -71,9 +73,74 @@ const arma::mat SparseAutoencoderFunction::InitializeWeights()
   return parameters;
 }
 
+/** Shuffles the order of the data points.
+  */
+void SparseAutoencoderFunction::Shuffle()
+{
+  arma::mat newData = data.cols(arma::shuffle(arma::linspace<arma::uvec>(0,
+      data.n_cols - 1, data.n_cols)));
+  math::ClearAlias(data);
+  data = std::move(newData);
+}
+
 /** Evaluates the objective function given the parameters.
   */
 double SparseAutoencoderFunction::Evaluate(const arma::mat& parameters) const
+{
+  return Evaluate(parameters, 0, data.n_cols);
+}
+
+/** Calculates and stores the gradient values given a set of parameters.
+  */
+void SparseAutoencoderFunction::Gradient(const arma::mat& parameters,
+                                         arma::mat& gradient) const
+{
+  Gradient(parameters, 0, gradient, data.n_cols);
+}
+
+/** Evaluates the objective function and the gradient given the parameters.
+  */
+double SparseAutoencoderFunction::EvaluateWithGradient(
+    const arma::mat& parameters,
+    arma::mat& gradient) const
+{
+  return EvaluateWithGradient(parameters, 0, gradient, data.n_cols);
+}
+
+double SparseAutoencoderFunction::Evaluate(const arma::mat& parameters,
+                                           const size_t begin,
+                                           const size_t batchSize) const
+{
+  // The mini-batch is an alias of the columns of the data.
+  const arma::mat batch(const_cast<double*>(data.colptr(begin)), data.n_rows,
+      batchSize, false, true);
+  return Forward(parameters, batch);
+}
+
+void SparseAutoencoderFunction::Gradient(const arma::mat& parameters,
+                                         const size_t begin,
+                                         arma::mat& gradient,
+                                         const size_t batchSize) const
+{
+  EvaluateWithGradient(parameters, begin, gradient, batchSize);
+}
+
+double SparseAutoencoderFunction::EvaluateWithGradient(
+    const arma::mat& parameters,
+    const size_t begin,
+    arma::mat& gradient,
+    const size_t batchSize) const
+{
+  // The mini-batch is an alias of the columns of the data.
+  const arma::mat batch(const_cast<double*>(data.colptr(begin)), data.n_rows,
+      batchSize, false, true);
+  const double cost = Forward(parameters, batch);
+  Backward(parameters, batch, gradient);
+  return cost;
+}
+
+double SparseAutoencoderFunction::Forward(const arma::mat& parameters,
+                                          const arma::mat& batch) const
 {
   // The objective function is the average squared reconstruction error of the
   // network. w1 and b1 are the weights and biases associated with the hidden
@@ -96,31 +163,22 @@ double SparseAutoencoderFunction::Evaluate(const arma::mat& parameters) const
   // b1 <- parameters.submat(0, l2, l1-1, l2)
   // b2 <- parameters.submat(l3, 0, l3, l2-1).t()
 
-  arma::mat hiddenLayer, outputLayer;
-
-  // Compute activations of the hidden and output layers.
-  Sigmoid(parameters.submat(0, 0, l1 - 1, l2 - 1) * data +
-      arma::repmat(parameters.submat(0, l2, l1 - 1, l2), 1, data.n_cols),
-      hiddenLayer);
+  // Compute activations of the hidden and output layers.  The buffers keep
+  // their memory between calls with the same batch size.
+  hiddenLayer = parameters.submat(0, 0, l1 - 1, l2 - 1) * batch;
+  hiddenLayer.each_col() += parameters.submat(0, l2, l1 - 1, l2);
+  hiddenLayer = 1.0 / (1 + arma::exp(-hiddenLayer));
 
-  Sigmoid(parameters.submat(l1, 0, l3 - 1, l2 - 1).t() * hiddenLayer +
-      arma::repmat(parameters.submat(l3, 0, l3, l2 - 1).t(), 1, data.n_cols),
-      outputLayer);
-
-  arma::mat rhoCap, diff;
+  outputLayer = parameters.submat(l1, 0, l3 - 1, l2 - 1).t() * hiddenLayer;
+  outputLayer.each_col() += parameters.submat(l3, 0, l3, l2 - 1).t();
+  outputLayer = 1.0 / (1 + arma::exp(-outputLayer));
 
   // Average activations of the hidden layer.
-  rhoCap = arma::sum(hiddenLayer, 1) / data.n_cols;
-  // Difference between the reconstructed data and the original data.
-  diff = outputLayer - data;
-
-  double wL2SquaredNorm;
+  rhoCap = arma::sum(hiddenLayer, 1) / batch.n_cols;
 
   // Calculate squared L2-norms of w1 and w2.
-  wL2SquaredNorm = arma::accu(parameters.submat(0, 0, l3 - 1, l2 - 1) %
-      parameters.submat(0, 0, l3 - 1, l2 - 1));
-
-  double sumOfSquaresError, weightDecay, klDivergence, cost;
+  const double wL2SquaredNorm = arma::accu(arma::square(
+      parameters.submat(0, 0, l3 - 1, l2 - 1)));
 
   // Calculate the reconstruction error, the regularization cost and the KL
   // divergence cost terms. 'sumOfSquaresError' is the average squared l2-norm
@@ -128,83 +186,53 @@ double SparseAutoencoderFunction::Evaluate(const arma::mat& parameters) const
   // of the weights w1 and w2. 'klDivergence' is the cost of the hidden layer
   // activations not being low. It is given by the following formula:
   // KL = sum_over_hSize(rho*log(rho/rhoCaq) + (1-rho)*log((1-rho)/(1-rhoCap)))
-  sumOfSquaresError = 0.5 * arma::accu(diff % diff) / data.n_cols;
-  weightDecay = 0.5 * lambda * wL2SquaredNorm;
-  klDivergence = beta * arma::accu(rho * arma::log(rho / rhoCap) + (1 - rho) *
-      arma::log((1 - rho) / (1 - rhoCap)));
+  const double sumOfSquaresError = 0.5 * arma::accu(arma::square(outputLayer -
+      batch)) / batch.n_cols;
+  const double weightDecay = 0.5 * lambda * wL2SquaredNorm;
+  const double klDivergence = beta * arma::accu(rho * arma::log(rho / rhoCap) +
+      (1 - rho) * arma::log((1 - rho) / (1 - rhoCap)));
 
   // The cost is the sum of the terms calculated above.
-  cost = sumOfSquaresError + weightDecay + klDivergence;
-
-  return cost;
+  return sumOfSquaresError + weightDecay + klDivergence;
 }
 
-/** Calculates and stores the gradient values given a set of parameters.
-  */
-void SparseAutoencoderFunction::Gradient(const arma::mat& parameters,
+void SparseAutoencoderFunction::Backward(const arma::mat& parameters,
+                                         const arma::mat& batch,
                                          arma::mat& gradient) const
 {
-  // Performs a feedforward pass of the neural network, and computes the
-  // activations of the output layer as in the Evaluate() method. It uses the
-  // Backpropagation algorithm to calculate the delta values at each layer,
-  // except for the input layer. The delta values are then used with input layer
-  // and hidden layer activations to get the parameter gradients.
+  // Uses the activations of the Forward() pass, with the Backpropagation
+  // algorithm to calculate the delta values at each layer, except for the
+  // input layer. The delta values are then used with input layer and hidden
+  // layer activations to get the parameter gradients.
 
   // Compute the limits for the parameters w1, w2, b1 and b2.
   const size_t l1 = hiddenSize;
   const size_t l2 = visibleSize;
   const size_t l3 = 2 * hiddenSize;
 
-  // w1, w2, b1 and b2 are not extracted separately, 'parameters' is directly
-  // used in their place to avoid copying data. The following representations
-  // are used:
-  // w1 <- parameters.submat(0, 0, l1-1, l2-1)
-  // w2 <- parameters.submat(l1, 0, l3-1, l2-1).t()
-  // b1 <- parameters.submat(0, l2, l1-1, l2)
-  // b2 <- parameters.submat(l3, 0, l3, l2-1).t()
-
-  arma::mat hiddenLayer, outputLayer;
-
-  // Compute activations of the hidden and output layers.
-  Sigmoid(parameters.submat(0, 0, l1 - 1, l2 - 1) * data +
-      arma::repmat(parameters.submat(0, l2, l1 - 1, l2), 1, data.n_cols),
-      hiddenLayer);
-
-  Sigmoid(parameters.submat(l1, 0, l3 - 1, l2 - 1).t() * hiddenLayer +
-      arma::repmat(parameters.submat(l3, 0, l3, l2 - 1).t(), 1, data.n_cols),
-      outputLayer);
-
-  arma::mat rhoCap, diff;
-
-  // Average activations of the hidden layer.
-  rhoCap = arma::sum(hiddenLayer, 1) / data.n_cols;
-  // Difference between the reconstructed data and the original data.
-  diff = outputLayer - data;
-
-  arma::mat klDivGrad, delOut, delHid;
-
   // The delta vector for the output layer is given by diff * f'(z), where z is
   // the preactivation and f is the activation function. The derivative of the
   // sigmoid function turns out to be f(z) * (1 - f(z)). For every other layer
   // in the neural network which comes before the output layer, the delta values
   // are given del_n = w_n' * del_(n+1) * f'(z_n). Since our cost function also
   // includes the KL divergence term, we adjust for that in the formula below.
-  klDivGrad = beta * (-(rho / rhoCap) + (1 - rho) / (1 - rhoCap));
-  delOut = diff % outputLayer % (1 - outputLayer);
-  delHid = (parameters.submat(l1, 0, l3 - 1, l2 - 1) * delOut +
-      arma::repmat(klDivGrad, 1, data.n_cols)) % hiddenLayer %
-      (1 - hiddenLayer);
+  const arma::vec klDivGrad = beta * (-(rho / rhoCap) + (1 - rho) /
+      (1 - rhoCap));
+  delOut = (outputLayer - batch) % outputLayer % (1 - outputLayer);
+  delHid = parameters.submat(l1, 0, l3 - 1, l2 - 1) * delOut;
+  delHid.each_col() += klDivGrad;
+  delHid %= hiddenLayer % (1 - hiddenLayer);
 
   gradient.zeros(2 * hiddenSize + 1, visibleSize + 1);
 
   // Compute the gradient values using the activations and the delta values. The
   // formula also accounts for the regularization terms in the objective.
   // function.
-  gradient.submat(0, 0, l1 - 1, l2 - 1) = delHid * data.t() / data.n_cols +
+  gradient.submat(0, 0, l1 - 1, l2 - 1) = delHid * batch.t() / batch.n_cols +
       lambda * parameters.submat(0, 0, l1 - 1, l2 - 1);
-  gradient.submat(l1, 0, l3 - 1, l2 - 1) =
-      (delOut * hiddenLayer.t() / data.n_cols +
-      lambda * parameters.submat(l1, 0, l3 - 1, l2 - 1).t()).t();
-  gradient.submat(0, l2, l1 - 1, l2) = arma::sum(delHid, 1) / data.n_cols;
-  gradient.submat(l3, 0, l3, l2 - 1) = (arma::sum(delOut, 1) / data.n_cols).t();
+  gradient.submat(l1, 0, l3 - 1, l2 - 1) = hiddenLayer * delOut.t() /
+      batch.n_cols + lambda * parameters.submat(l1, 0, l3 - 1, l2 - 1);
+  gradient.submat(0, l2, l1 - 1, l2) = arma::sum(delHid, 1) / batch.n_cols;
+  gradient.submat(l3, 0, l3, l2 - 1) = (arma::sum(delOut, 1) /
+      batch.n_cols).t();
 }
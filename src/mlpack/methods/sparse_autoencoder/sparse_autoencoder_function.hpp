@@ -22,6 +22,14 @@ namespace nn {
  * This is a class for the sparse autoencoder objective function. It can be used
  * to create learning models like self-taught learning, stacked autoencoders,
  * conditional random fields (CRFs), and so forth.
+ *
+ * The function can be optimized as a whole (e.g. with L-BFGS, which uses
+ * EvaluateWithGradient() to do only one forward pass per iteration) or as a
+ * separable function, in mini-batches of data points (e.g. with SGD).  The
+ * objective of a mini-batch is the objective of the autoencoder on the points
+ * of that mini-batch only.  The activations of the layers are kept in buffers
+ * that are reused between calls, so an object should not be used by several
+ * threads at once.
  */
 class SparseAutoencoderFunction
 {
@@ -47,6 +55,9 @@ class SparseAutoencoderFunction
   //! Initializes the parameters of the model to suitable values.
   const arma::mat InitializeWeights();
 
+  //! Shuffle the order of the data points (for separable optimizers).
+  void Shuffle();
+
   /**
    * Evaluates the objective function of the sparse autoencoder model using the
    * given parameters. The cost function has terms for the reconstruction
@@ -70,6 +81,59 @@ class SparseAutoencoderFunction
    */
   void Gradient(const arma::mat& parameters, arma::mat& gradient) const;
 
+  /**
+   * Evaluates the objective function and its gradient given the current set of
+   * parameters, with a single feedforward pass.
+   *
+   * @param parameters Current values of the model parameters.
+   * @param gradient Matrix where gradient values will be stored.
+   */
+  double EvaluateWithGradient(const arma::mat& parameters,
+                              arma::mat& gradient) const;
+
+  /**
+   * Evaluates the objective function on the mini-batch of data points
+   * [begin, begin + batchSize).
+   *
+   * @param parameters Current values of the model parameters.
+   * @param begin Index of the first data point of the mini-batch.
+   * @param batchSize Number of data points in the mini-batch.
+   */
+  double Evaluate(const arma::mat& parameters,
+                  const size_t begin,
+                  const size_t batchSize = 1) const;
+
+  /**
+   * Evaluates the gradient of the objective function on the mini-batch of data
+   * points [begin, begin + batchSize).
+   *
+   * @param parameters Current values of the model parameters.
+   * @param begin Index of the first data point of the mini-batch.
+   * @param gradient Matrix where gradient values will be stored.
+   * @param batchSize Number of data points in the mini-batch.
+   */
+  void Gradient(const arma::mat& parameters,
+                const size_t begin,
+                arma::mat& gradient,
+                const size_t batchSize = 1) const;
+
+  /**
+   * Evaluates the objective function and its gradient on the mini-batch of data
+   * points [begin, begin + batchSize), with a single feedforward pass.
+   *
+   * @param parameters Current values of the model parameters.
+   * @param begin Index of the first data point of the mini-batch.
+   * @param gradient Matrix where gradient values will be stored.
+   * @param batchSize Number of data points in the mini-batch.
+   */
+  double EvaluateWithGradient(const arma::mat& parameters,
+                              const size_t begin,
+                              arma::mat& gradient,
+                              const size_t batchSize = 1) const;
+
+  //! Return the number of separable functions (the number of data points).
+  size_t NumFunctions() const { return data.n_cols; }
+
   /**
    * Returns the elementwise sigmoid of the passed matrix, where the sigmoid
    * function of a real number 'x' is [1 / (1 + exp(-x))].
@@ -146,8 +210,22 @@ class SparseAutoencoderFunction
   }
 
  private:
-  //! The matrix of data points.
-  const arma::mat& data;
+  /**
+   * Compute the activations of the hidden and output layers for the given
+   * data points into the layer buffers, and return the cost.
+   */
+  double Forward(const arma::mat& parameters, const arma::mat& batch) const;
+
+  /**
+   * Compute the gradient for the given data points from the layer buffers
+   * filled by Forward().
+   */
+  void Backward(const arma::mat& parameters,
+                const arma::mat& batch,
+                arma::mat& gradient) const;
+
+  //! The matrix of data points.  This is an alias until the data is shuffled.
+  arma::mat data;
   //! Initial parameter vector.
   arma::mat initialPoint;
   //! Size of the visible layer.
@@ -160,6 +238,17 @@ class SparseAutoencoderFunction
   double beta;
   //! Sparsity parameter.
   double rho;
+
+  //! Buffer for the activations of the hidden layer.
+  mutable arma::mat hiddenLayer;
+  //! Buffer for the activations of the output layer.
+  mutable arma::mat outputLayer;
+  //! Buffer for the average activations of the hidden layer.
+  mutable arma::vec rhoCap;
+  //! Buffer for the delta values of the output layer.
+  mutable arma::mat delOut;
+  //! Buffer for the delta values of the hidden layer.
+  mutable arma::mat delHid;
 };
 
 } // namespace nn
@@ -157,7 +157,9 @@ namespace ens {
    * Template specialization for the SGD and parallel SGD optimizer. Used
    * because the gradient affects only a small number of parameters per example,
    * and thus the normal abstraction does not work as fast as we might like it
-   * to.
+   * to.  The parallel SGD visits the ratings in shuffled chunks and applies
+   * its updates without atomics, Hogwild-style (see amf::SGDSchedule); the
+   * thread share size of the optimizer is not used.
    */
   template <>
   template <>
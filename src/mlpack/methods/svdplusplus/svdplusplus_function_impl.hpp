@@ -15,6 +15,7 @@
 
 #include "svdplusplus_function.hpp"
 #include <mlpack/core/math/make_alias.hpp>
+#include <mlpack/methods/amf/sgd_schedule.hpp>
 
 namespace mlpack {
 namespace svd {
@@ -402,16 +403,18 @@ inline double ParallelSGD<ExponentialBackoff>::Optimize(
   double overallObjective = DBL_MAX;
   double lastObjective;
 
-  // The order in which the functions will be visited.
-  arma::Col<size_t> visitationOrder = arma::linspace<arma::Col<size_t>>(0,
-      (function.NumFunctions() - 1), function.NumFunctions());
-
-  const arma::mat data = function.Dataset();
-  const arma::sp_mat implicitData = function.ImplicitDataset();
+  const arma::mat& data = function.Dataset();
+  const arma::sp_mat& implicitData = function.ImplicitDataset();
   const size_t numUsers = function.NumUsers();
   const size_t numItems = function.NumItems();
   const double lambda = function.Lambda();
 
+  // The updates also change the implicit factors of all the items the user
+  // interacted with, so the ratings can't be split into independent blocks.
+  // They are applied Hogwild-style instead, without atomic updates.
+  mlpack::amf::SGDSchedule schedule(mlpack::amf::SGDSchedule::HOGWILD);
+  schedule.Reset(data, numUsers, numItems);
+
   // Rank of decomposition.
   const size_t rank = function.Rank();
 
@@ -452,101 +455,57 @@ inline double ParallelSGD<ExponentialBackoff>::Optimize(
     // Get the stepsize for this iteration
     double stepSize = decayPolicy.StepSize(i);
 
-    if (shuffle) // Determine order of visitation.
-      std::shuffle(visitationOrder.begin(), visitationOrder.end(),
-          mlpack::math::randGen);
-
-    #pragma omp parallel
+    schedule.Epoch([&](const size_t j)
     {
-      // Each processor gets a subset of the instances.
-      // Each subset is of size threadShareSize.
-      size_t threadId = 0;
-      #ifdef HAS_OPENMP
-        threadId = omp_get_thread_num();
-      #endif
-
-      for (size_t j = threadId * threadShareSize;
-          j < (threadId + 1) * threadShareSize && j < visitationOrder.n_elem;
-          ++j)
+      // Indices for accessing the the correct parameter columns.
+      const size_t user = data(0, j);
+      const size_t item = data(1, j) + numUsers;
+      const size_t implicitStart = numUsers + numItems;
+
+      // Prediction error for the example.
+      const double rating = data(2, j);
+      const double userBias = iterate(rank, user);
+      const double itemBias = iterate(rank, item);
+      // Iterate through each item which the user interacted with to calculate
+      // user vector.
+      arma::vec userVec(rank, arma::fill::zeros);
+      arma::sp_mat::const_iterator it = implicitData.begin_col(user);
+      arma::sp_mat::const_iterator it_end = implicitData.end_col(user);
+      size_t implicitCount = 0;
+      for (; it != it_end; ++it)
       {
-        // Indices for accessing the the correct parameter columns.
-        const size_t user = data(0, visitationOrder[j]);
-        const size_t item = data(1, visitationOrder[j]) + numUsers;
-        const size_t implicitStart = numUsers + numItems;
-
-        // Prediction error for the example.
-        const double rating = data(2, visitationOrder[j]);
-        const double userBias = iterate(rank, user);
-        const double itemBias = iterate(rank, item);
-        // Iterate through each item which the user interacted with to calculate
-        // user vector.
-        arma::vec userVec(rank, arma::fill::zeros);
-        arma::sp_mat::const_iterator it = implicitData.begin_col(user);
-        arma::sp_mat::const_iterator it_end = implicitData.end_col(user);
-        size_t implicitCount = 0;
-        for (; it != it_end; ++it)
-        {
-          userVec += iterate.col(implicitStart + it.row()).subvec(0, rank - 1);
-          implicitCount += 1;
-        }
-        if (implicitCount != 0)
-          userVec /= std::sqrt(implicitCount);
-        userVec += iterate.col(user).subvec(0, rank - 1);
-
-        double ratingError = rating - userBias - itemBias -
-        arma::dot(userVec, iterate.col(item).subvec(0, rank - 1));
-
-        arma::mat userVecUpdate = stepSize * 2 * (
-            lambda * iterate.col(user).subvec(0, rank - 1) -
-            ratingError * iterate.col(item).subvec(0, rank - 1));
-        arma::mat itemVecUpdate = stepSize * 2 * (
-            lambda * iterate.col(item).subvec(0, rank - 1) -
-            ratingError * userVec);
-        double userBiasUpdate = stepSize * 2 * (
-            lambda * iterate(rank, user) - ratingError);
-        double itemBiasUpdate = stepSize * 2 * (
-            lambda * iterate(rank, item) - ratingError);
-
-        // Update of item implicit vectors.
-        arma::mat itemImplicitUpdate(rank, implicitCount);
-        arma::Col<size_t> implicitItems(implicitCount);
-        it = implicitData.begin_col(user);
-        it_end = implicitData.end_col(user);
-        size_t implicitIndex = 0;
-        for (; it != it_end; ++it, ++implicitIndex)
-        {
-          itemImplicitUpdate.col(implicitIndex) =
-              stepSize * 2.0 * (lambda / implicitCount *
-              iterate.col(implicitStart + it.row()).subvec(0, rank - 1) -
-              ratingError / std::sqrt(implicitCount) *
-              iterate.col(item).subvec(0, rank - 1));
-          implicitItems(implicitIndex) = it.row();
-        }
-
-        // Gradient is non-zero only for the parameter columns corresponding to
-        // the example.
-        for (size_t i = 0; i < rank; ++i)
-        {
-          #pragma omp atomic
-          iterate(i, user) -= userVecUpdate(i);
-          #pragma omp atomic
-          iterate(i, item) -= itemVecUpdate(i);
-        }
-        #pragma omp atomic
-        iterate(rank, user) -= userBiasUpdate;
-        #pragma omp atomic
-        iterate(rank, item) -= itemBiasUpdate;
-        for (size_t k = 0; k < implicitCount; ++k)
-        {
-          for (size_t i = 0; i < rank; ++i)
-          {
-            #pragma omp atomic
-            iterate(i, implicitStart + implicitItems(k)) -=
-                itemImplicitUpdate(i, k);
-          }
-        }
+        userVec += iterate.col(implicitStart + it.row()).subvec(0, rank - 1);
+        implicitCount += 1;
       }
-    }
+      if (implicitCount != 0)
+        userVec /= std::sqrt(implicitCount);
+      userVec += iterate.col(user).subvec(0, rank - 1);
+
+      const double ratingError = rating - userBias - itemBias -
+          arma::dot(userVec, iterate.col(item).subvec(0, rank - 1));
+
+      // Gradient is non-zero only for the parameter columns corresponding to
+      // the example.  The item vector is kept for the implicit updates.
+      const arma::vec itemVec = iterate.col(item).subvec(0, rank - 1);
+      iterate.col(user).subvec(0, rank - 1) -= stepSize * 2 * (
+          lambda * iterate.col(user).subvec(0, rank - 1) -
+          ratingError * itemVec);
+      iterate.col(item).subvec(0, rank - 1) -= stepSize * 2 * (
+          lambda * itemVec - ratingError * userVec);
+      iterate(rank, user) -= stepSize * 2 * (lambda * userBias - ratingError);
+      iterate(rank, item) -= stepSize * 2 * (lambda * itemBias - ratingError);
+
+      // Update of item implicit vectors.
+      it = implicitData.begin_col(user);
+      for (; it != it_end; ++it)
+      {
+        // Note that implicitCount != 0 if this loop is acutally executed.
+        iterate.col(implicitStart + it.row()).subvec(0, rank - 1) -=
+            stepSize * 2.0 * (lambda / implicitCount *
+            iterate.col(implicitStart + it.row()).subvec(0, rank - 1) -
+            ratingError / std::sqrt(implicitCount) * itemVec);
+      }
+    }, shuffle);
   }
   mlpack::Log::Info << "\n Parallel SGD terminated with objective : "
       << overallObjective << std::endl;
@@ -128,6 +128,11 @@ or upgrade Boost to 1.59 or newer.
 #include <mlpack/core/util/log.hpp>
 #include <mlpack/core/util/timers.hpp>
 
+// Use OpenMP if compiled with -DHAS_OPENMP.
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
 // This can be removed with Visual Studio supports an OpenMP version with
 // unsigned loop variables.
 #ifdef _WIN32
@@ -136,6 +141,9 @@ or upgrade Boost to 1.59 or newer.
   #define omp_size_t size_t
 #endif
 
+// All code should be able to control the number of threads.
+#include <mlpack/core/util/threads.hpp>
+
 // We need to be able to mark functions deprecated.
 #include <mlpack/core/util/deprecated.hpp>
 
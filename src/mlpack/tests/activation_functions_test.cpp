@@ -32,6 +32,7 @@
 #include <mlpack/methods/ann/activation_functions/spline_function.hpp>
 #include <mlpack/methods/ann/activation_functions/poisson1_function.hpp>
 #include <mlpack/methods/ann/activation_functions/gaussian_function.hpp>
+#include <mlpack/methods/ann/activation_functions/fast_activation_functions.hpp>
 
 #include "catch.hpp"
 
@@ -1135,3 +1136,83 @@ TEST_CASE("SoftminFunctionTest", "[ActivationFunctionsTest]")
   CheckSoftminDerivativeCorrect(activationData,
                                 desiredDerivatives);
 }
+
+/**
+ * Check that the approximations of FastPrecision are within 1e-7 of the
+ * standard library functions.
+ */
+TEST_CASE("FastPrecisionTest", "[ActivationFunctionsTest]")
+{
+  const arma::vec expData = arma::linspace(-700, 700, 10001);
+  for (size_t i = 0; i < expData.n_elem; ++i)
+  {
+    REQUIRE(FastPrecision::Exp(expData[i]) ==
+        Approx(std::exp(expData[i])).epsilon(1e-7));
+  }
+
+  const arma::vec tanhData = arma::linspace(-25, 25, 10001);
+  for (size_t i = 0; i < tanhData.n_elem; ++i)
+  {
+    REQUIRE(FastPrecision::Tanh(tanhData[i]) ==
+        Approx(std::tanh(tanhData[i])).epsilon(1e-7).margin(1e-15));
+  }
+}
+
+/**
+ * Compare a fast activation function with the given function, for both
+ * precision policies, and check that the fast layer can overwrite its input.
+ *
+ * @param outputDeriv Whether the derivative is computed from the output.
+ */
+template<template<typename> class FastFunction, typename ActivationFunction>
+void CheckFastActivationCorrect(const bool outputDeriv)
+{
+  const arma::mat input = arma::linspace<arma::rowvec>(-10, 10, 1001);
+
+  arma::mat activations, fastActivations, accurateActivations;
+  ActivationFunction::Fn(input, activations);
+  FastFunction<FastPrecision>::Fn(input, fastActivations);
+  FastFunction<AccuratePrecision>::Fn(input, accurateActivations);
+
+  const arma::mat& derivInput = outputDeriv ? activations : input;
+  arma::mat derivatives, fastDerivatives, accurateDerivatives;
+  ActivationFunction::Deriv(derivInput, derivatives);
+  FastFunction<FastPrecision>::Deriv(derivInput, fastDerivatives);
+  FastFunction<AccuratePrecision>::Deriv(derivInput, accurateDerivatives);
+
+  for (size_t i = 0; i < input.n_elem; ++i)
+  {
+    REQUIRE(fastActivations[i] ==
+        Approx(activations[i]).epsilon(1e-6).margin(1e-12));
+    REQUIRE(accurateActivations[i] ==
+        Approx(activations[i]).epsilon(1e-10).margin(1e-14));
+    REQUIRE(FastFunction<FastPrecision>::Fn(input[i]) ==
+        Approx(fastActivations[i]).epsilon(1e-12).margin(1e-15));
+
+    REQUIRE(fastDerivatives[i] ==
+        Approx(derivatives[i]).epsilon(1e-6).margin(1e-12));
+    REQUIRE(accurateDerivatives[i] ==
+        Approx(derivatives[i]).epsilon(1e-10).margin(1e-14));
+  }
+
+  // The output of the layer may be its input.
+  BaseLayer<FastFunction<FastPrecision>> layer;
+  arma::mat inPlace(input);
+  arma::mat output(inPlace.memptr(), inPlace.n_rows, inPlace.n_cols, false,
+      true);
+  layer.Forward(inPlace, output);
+  for (size_t i = 0; i < input.n_elem; ++i)
+    REQUIRE(inPlace[i] == Approx(fastActivations[i]).epsilon(1e-12));
+}
+
+/**
+ * Check the fast activation functions against the exact functions.
+ */
+TEST_CASE("FastActivationFunctionsTest", "[ActivationFunctionsTest]")
+{
+  CheckFastActivationCorrect<FastLogisticFunction, LogisticFunction>(true);
+  CheckFastActivationCorrect<FastTanhFunction, TanhFunction>(true);
+  CheckFastActivationCorrect<FastSwishFunction, SwishFunction>(false);
+  CheckFastActivationCorrect<FastGELUFunction, GELUFunction>(false);
+  CheckFastActivationCorrect<FastMishFunction, MishFunction>(false);
+}
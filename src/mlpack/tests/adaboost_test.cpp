@@ -891,3 +891,90 @@ TEST_CASE("ID3DecisionStumpSerializationTest", "[AdaBoostTest]")
             abBinary.WeakLearner(i).SplitDimension());
   }
 }
+
+/**
+ * Make sure that the blocked Classify() overloads give the same votes as
+ * accumulating the predictions of each weak learner over the whole dataset,
+ * when the dataset holds several blocks.
+ */
+TEST_CASE("BlockClassifyTest", "[AdaBoostTest]")
+{
+  arma::mat inputData;
+  if (!data::Load("iris.csv", inputData))
+    FAIL("Cannot load test dataset iris.csv!");
+
+  arma::Mat<size_t> labels;
+  if (!data::Load("iris_labels.txt", labels))
+    FAIL("Cannot load labels for iris_labels.txt");
+
+  const size_t numClasses = 3;
+  arma::Row<size_t> labelsvec = labels.row(0);
+  ID3DecisionStump ds(inputData, labelsvec, numClasses, 6);
+  AdaBoost<ID3DecisionStump> a(inputData, labelsvec, numClasses, ds, 50,
+      1e-10);
+
+  // Repeat the data so that the last block is only partially filled.
+  const arma::mat testData = arma::repmat(inputData, 1, 5);
+  REQUIRE(testData.n_cols > 2 * AdaBoost<ID3DecisionStump>::BlockSize);
+  REQUIRE(testData.n_cols % AdaBoost<ID3DecisionStump>::BlockSize != 0);
+
+  arma::mat votes(numClasses, testData.n_cols, arma::fill::zeros);
+  arma::Row<size_t> learnerLabels;
+  for (size_t i = 0; i < a.WeakLearners(); ++i)
+  {
+    a.WeakLearner(i).Classify(testData, learnerLabels);
+    for (size_t j = 0; j < testData.n_cols; ++j)
+      votes(learnerLabels[j], j) += a.Alpha(i);
+  }
+  votes.each_row() /= arma::sum(votes, 0);
+
+  arma::Row<size_t> predictions, probPredictions;
+  arma::mat probabilities;
+  a.Classify(testData, predictions);
+  a.Classify(testData, probPredictions, probabilities);
+
+  REQUIRE(probabilities.n_rows == numClasses);
+  REQUIRE(probabilities.n_cols == testData.n_cols);
+  CheckMatrices(probabilities, votes);
+  for (size_t j = 0; j < testData.n_cols; ++j)
+  {
+    REQUIRE(predictions[j] == probPredictions[j]);
+    REQUIRE(probabilities(predictions[j], j) == Approx(votes.col(j).max()));
+  }
+}
+
+/**
+ * Make sure that AdaBoost with decision stumps compiled into a QuickScorer
+ * makes the same predictions as the model.
+ */
+TEST_CASE("AdaBoostCompileTest", "[AdaBoostTest]")
+{
+  arma::mat inputData;
+  if (!data::Load("iris.csv", inputData))
+    FAIL("Cannot load test dataset iris.csv!");
+
+  arma::Mat<size_t> labels;
+  if (!data::Load("iris_labels.txt", labels))
+    FAIL("Cannot load labels for iris_labels.txt");
+
+  const size_t numClasses = 3;
+  arma::Row<size_t> labelsvec = labels.row(0);
+  ID3DecisionStump ds(inputData, labelsvec, numClasses, 6);
+  AdaBoost<ID3DecisionStump> a(inputData, labelsvec, numClasses, ds, 50,
+      1e-10);
+
+  QuickScorer scorer;
+  a.Compile(scorer);
+  REQUIRE(scorer.NumTrees() == a.WeakLearners());
+
+  arma::Row<size_t> predictions, scorerPredictions;
+  arma::mat probabilities, scorerProbabilities;
+  a.Classify(inputData, predictions, probabilities);
+  scorer.Classify(inputData, scorerPredictions, scorerProbabilities);
+
+  REQUIRE(scorerProbabilities.n_rows == numClasses);
+  REQUIRE(scorerProbabilities.n_cols == inputData.n_cols);
+  CheckMatrices(scorerProbabilities, probabilities);
+  for (size_t j = 0; j < inputData.n_cols; ++j)
+    REQUIRE(scorerPredictions[j] == predictions[j]);
+}
@@ -1075,6 +1075,40 @@ TEST_CASE("LSTMLayerParametersTest", "[ANNLayerTest]")
   REQUIRE(layer1.Rho() == layer2.Rho());
 }
 
+/**
+ * Make sure that the LSTM layer uses new weights when they are changed between
+ * two sequences.
+ */
+TEST_CASE("LSTMLayerWeightsChangeTest", "[ANNLayerTest]")
+{
+  const size_t rho = 3, inputSize = 4, outputSize = 5, batchSize = 2;
+  arma::cube input = arma::randu(inputSize, batchSize, rho);
+
+  LSTM<> layer(inputSize, outputSize, rho);
+  layer.Reset();
+  layer.ResetCell(rho);
+  layer.Parameters().randu();
+
+  LSTM<> reference(inputSize, outputSize, rho);
+  reference.Reset();
+  reference.ResetCell(rho);
+  reference.Parameters() = 0.5 * arma::randu(layer.Parameters().n_rows, 1);
+
+  arma::mat output, referenceOutput;
+  for (size_t seqNum = 0; seqNum < rho; ++seqNum)
+    layer.Forward(input.slice(seqNum), output);
+
+  // Start a new sequence with the weights of the reference layer.
+  layer.Parameters() = reference.Parameters();
+  layer.ResetCell(rho);
+  for (size_t seqNum = 0; seqNum < rho; ++seqNum)
+  {
+    layer.Forward(input.slice(seqNum), output);
+    reference.Forward(input.slice(seqNum), referenceOutput);
+    CheckMatrices(output, referenceOutput, 1e-12);
+  }
+}
+
 /**
  * Test the FastLSTM layer with a user defined rho parameter and without.
  */
@@ -1848,6 +1882,95 @@ TEST_CASE("LookupLayerParametersTest", "[ANNLayerTest]")
   REQUIRE(layer.EmbeddingSize() == 8);
 }
 
+/**
+ * Make sure that a sparse Lookup layer only computes the gradient of the
+ * embeddings of its input, and updates only those embeddings.
+ */
+TEST_CASE("SparseLookupLayerTest", "[ANNLayerTest]")
+{
+  const size_t vocabSize = 50;
+  const size_t embeddingSize = 3;
+  const size_t seqLength = 4;
+  const size_t batchSize = 5;
+
+  Lookup<> dense(vocabSize, embeddingSize);
+  dense.Parameters().randu();
+  Lookup<> sparse(vocabSize, embeddingSize, LookupUpdate::SGD, 0.1);
+  sparse.Embeddings() = dense.Parameters();
+  REQUIRE(sparse.Sparse() == true);
+  REQUIRE(sparse.Parameters().n_elem == 0);
+
+  // Tokens 1 to 10 only, with repetitions.
+  arma::mat input(seqLength, batchSize);
+  for (size_t i = 0; i < input.n_elem; ++i)
+    input(i) = math::RandInt(1, 11);
+
+  arma::mat output, sparseOutput;
+  dense.Forward(input, output);
+  sparse.Forward(input, sparseOutput);
+  CheckMatrices(output, sparseOutput);
+
+  arma::mat error = arma::randu(embeddingSize * seqLength, batchSize);
+  arma::mat gradient, unusedGradient;
+  dense.Gradient(input, error, gradient);
+  sparse.Gradient(input, error, unusedGradient);
+  REQUIRE(unusedGradient.n_elem == 0);
+
+  const arma::uvec expectedTokens =
+      arma::unique(arma::conv_to<arma::uvec>::from(arma::vectorise(input))) -
+      1;
+  REQUIRE(sparse.TouchedTokens().n_elem == expectedTokens.n_elem);
+  for (size_t i = 0; i < expectedTokens.n_elem; ++i)
+    REQUIRE(sparse.TouchedTokens()[i] == expectedTokens[i]);
+
+  CheckMatrices(sparse.SparseGradient(),
+      arma::mat(gradient.cols(expectedTokens)));
+
+  // Gradient descent on the whole table gives the same embeddings.
+  CheckMatrices(sparse.Embeddings(), dense.Parameters() - 0.1 * gradient);
+}
+
+/**
+ * Make sure that the lazy Adam update of a sparse Lookup layer leaves the
+ * embeddings of unseen tokens untouched, and survives serialization.
+ */
+TEST_CASE("SparseLookupLayerAdamTest", "[ANNLayerTest]")
+{
+  Lookup<> layer(20, 4, LookupUpdate::ADAM, 0.01);
+  const arma::mat embeddings = layer.Embeddings();
+
+  arma::mat input("1 2; 3 3");
+  arma::mat error = arma::randn(8, 2), output, gradient;
+  layer.Forward(input, output);
+  layer.Gradient(input, error, gradient);
+
+  // The first step of Adam moves each weight by about the step size.
+  const arma::mat difference = layer.Embeddings() - embeddings;
+  for (size_t token = 0; token < 20; ++token)
+  {
+    const bool seen = (token < 3);
+    for (size_t i = 0; i < 4; ++i)
+    {
+      if (seen)
+        REQUIRE(std::abs(difference(i, token)) == Approx(0.01).epsilon(1e-2));
+      else
+        REQUIRE(difference(i, token) == 0.0);
+    }
+  }
+
+  Lookup<> xmlLayer, textLayer, binaryLayer;
+  SerializeObjectAll(layer, xmlLayer, textLayer, binaryLayer);
+  REQUIRE(binaryLayer.Sparse() == true);
+  REQUIRE(binaryLayer.Parameters().n_elem == 0);
+  CheckMatrices(binaryLayer.Embeddings(), layer.Embeddings());
+  CheckMatrices(textLayer.Embeddings(), layer.Embeddings(), 1e-5);
+
+  // The restored moments give the same next step.
+  layer.Gradient(input, error, gradient);
+  binaryLayer.Gradient(input, error, gradient);
+  CheckMatrices(binaryLayer.Embeddings(), layer.Embeddings());
+}
+
 /**
  * Simple LogSoftMax module test.
  */
@@ -3733,6 +3856,65 @@ TEST_CASE("MaxPoolingTestCase", "[ANNLayerTest]")
   REQUIRE(output.n_cols == 1);
 }
 
+/**
+ * Make sure that pooling a batch of multi-channel inputs gives the same results
+ * as pooling each input alone, and that the max pooling error goes to the
+ * maxima of the windows.
+ */
+TEST_CASE("PoolingBatchTestCase", "[ANNLayerTest]")
+{
+  arma::mat input(6 * 5 * 3, 4, arma::fill::randu);
+  arma::mat output, gy, g;
+
+  MaxPooling<> maxPooling(2, 2, 2, 2);
+  maxPooling.InputWidth() = 6;
+  maxPooling.InputHeight() = 5;
+  MeanPooling<> meanPooling(3, 2, 1, 2);
+  meanPooling.InputWidth() = 6;
+  meanPooling.InputHeight() = 5;
+
+  for (size_t l = 0; l < 2; ++l)
+  {
+    if (l == 0)
+      maxPooling.Forward(input, output);
+    else
+      meanPooling.Forward(input, output);
+    gy = arma::randu<arma::mat>(output.n_rows, output.n_cols);
+    if (l == 0)
+      maxPooling.Backward(input, gy, g);
+    else
+      meanPooling.Backward(input, gy, g);
+    REQUIRE(g.n_rows == input.n_rows);
+    REQUIRE(g.n_cols == input.n_cols);
+
+    for (size_t i = 0; i < input.n_cols; ++i)
+    {
+      arma::mat pointOutput, pointG;
+      const arma::mat point = input.col(i);
+      const arma::mat pointGy = gy.col(i);
+      if (l == 0)
+      {
+        maxPooling.Forward(point, pointOutput);
+        maxPooling.Backward(point, pointGy, pointG);
+      }
+      else
+      {
+        meanPooling.Forward(point, pointOutput);
+        meanPooling.Backward(point, pointGy, pointG);
+      }
+      CheckMatrices(pointOutput, output.col(i));
+      CheckMatrices(pointG, g.col(i));
+    }
+  }
+
+  // Each window of the max pooling has one maximum, which gets its error.
+  maxPooling.Forward(input, output);
+  gy.ones(output.n_rows, output.n_cols);
+  maxPooling.Backward(input, gy, g);
+  REQUIRE(arma::accu(g) == Approx(output.n_elem));
+  REQUIRE(arma::accu(input % g) == Approx(arma::accu(output)));
+}
+
 /**
  * Test that the functions that can modify and access the parameters of the
  * Glimpse layer work.
@@ -4246,6 +4428,50 @@ TEST_CASE("ConvolutionLayerTestCase", "[ANNLayerTest]")
   REQUIRE(arma::accu(output) == 4156);
 }
 
+/**
+ * Make sure that the Convolution layer with Im2ColConvolution rules gives the
+ * same output, error and gradient as the layer with the default rules.
+ */
+TEST_CASE("Im2ColConvolutionLayerTest", "[ANNLayerTest]")
+{
+  typedef Convolution<Im2ColConvolution<ValidConvolution>,
+      Im2ColConvolution<FullConvolution>,
+      Im2ColConvolution<ValidConvolution>> Im2ColLayer;
+
+  // Three 7x6 points with 2 maps each; the padding keeps the output size.
+  arma::mat input = arma::randu(7 * 6 * 2, 3);
+  Convolution<> layer(2, 4, 3, 3, 1, 1, 1, 1, 7, 6);
+  Im2ColLayer im2colLayer(2, 4, 3, 3, 1, 1, 1, 1, 7, 6);
+  layer.Reset();
+  im2colLayer.Reset();
+  layer.Parameters().randu();
+  im2colLayer.Parameters() = layer.Parameters();
+
+  arma::mat output, im2colOutput;
+  layer.Forward(input, output);
+  im2colLayer.Forward(input, im2colOutput);
+  REQUIRE(im2colLayer.OutputWidth() == layer.OutputWidth());
+  REQUIRE(im2colLayer.OutputHeight() == layer.OutputHeight());
+  CheckMatrices(im2colOutput, output);
+
+  arma::mat error = arma::randu(output.n_rows, output.n_cols);
+  arma::mat delta, im2colDelta;
+  layer.Backward(input, error, delta);
+  im2colLayer.Backward(input, error, im2colDelta);
+  CheckMatrices(im2colDelta, delta);
+
+  // The default rules only keep the bias gradient of the last point, so the
+  // gradients are compared for a single point.
+  arma::mat point = input.col(0);
+  arma::mat pointError = error.col(0);
+  arma::mat gradient, im2colGradient;
+  layer.Forward(point, output);
+  im2colLayer.Forward(point, im2colOutput);
+  layer.Gradient(point, pointError, gradient);
+  im2colLayer.Gradient(point, pointError, im2colGradient);
+  CheckMatrices(im2colGradient, gradient);
+}
+
 TEST_CASE("BatchNormDeterministicTest", "[ANNLayerTest]")
 {
   FFN<> module;
@@ -4590,6 +4816,95 @@ TEST_CASE("SimpleMultiheadAttentionTest", "[ANNLayerTest]")
   REQUIRE(gradient.n_cols == module.Parameters().n_cols);
 }
 
+/**
+ * Compare the output of the MultiheadAttention layer with a direct computation
+ * of the masked attention of each head.
+ */
+TEST_CASE("MultiheadAttentionReferenceTest", "[ANNLayerTest]")
+{
+  const size_t tLen = 4;
+  const size_t sLen = 5;
+  const size_t embedDim = 6;
+  const size_t numHeads = 3;
+  const size_t headDim = embedDim / numHeads;
+  const size_t bsz = 2;
+
+  arma::mat attnMask = arma::zeros(tLen, sLen);
+  for (size_t i = 0; i < tLen; ++i)
+    for (size_t j = i + 2; j < sLen; ++j)
+      attnMask(i, j) = std::numeric_limits<double>::lowest();
+
+  arma::mat keyPaddingMask = arma::zeros(1, sLen);
+  keyPaddingMask(1) = std::numeric_limits<double>::lowest();
+
+  MultiheadAttention<> module(tLen, sLen, embedDim, numHeads);
+  module.AttentionMask() = attnMask;
+  module.KeyPaddingMask() = keyPaddingMask;
+  module.Parameters().randu();
+  module.Reset();
+
+  arma::mat input = arma::randu(embedDim * (tLen + 2 * sLen), bsz);
+  arma::mat output;
+  module.Forward(input, output);
+
+  // The weights and the biases, in the order of the parameters.
+  const size_t wtSize = embedDim * embedDim;
+  const arma::mat& parameters = module.Parameters();
+  const arma::mat queryWt(parameters.memptr(), embedDim, embedDim);
+  const arma::mat keyWt(parameters.memptr() + wtSize, embedDim, embedDim);
+  const arma::mat valueWt(parameters.memptr() + 2 * wtSize, embedDim,
+      embedDim);
+  const arma::mat outWt(parameters.memptr() + 3 * wtSize, embedDim, embedDim);
+  const arma::vec qBias(parameters.memptr() + 4 * wtSize, embedDim);
+  const arma::vec kBias(parameters.memptr() + 4 * wtSize + embedDim,
+      embedDim);
+  const arma::vec vBias(parameters.memptr() + 4 * wtSize + 2 * embedDim,
+      embedDim);
+  const arma::rowvec outBias(parameters.memptr() + 4 * wtSize + 3 * embedDim,
+      embedDim);
+
+  // The query, the key and the value of all the sequences follow each other
+  // in the input.
+  const arma::mat q(input.memptr(), embedDim, tLen * bsz);
+  const arma::mat k(input.memptr() + q.n_elem, embedDim, sLen * bsz);
+  const arma::mat v(input.memptr() + q.n_elem + k.n_elem, embedDim,
+      sLen * bsz);
+
+  arma::mat expected(embedDim * tLen, bsz);
+  for (size_t b = 0; b < bsz; ++b)
+  {
+    arma::mat qProj = arma::trans(queryWt * q.cols(b * tLen,
+        (b + 1) * tLen - 1) + arma::repmat(qBias, 1, tLen));
+    const arma::mat kProj = arma::trans(keyWt * k.cols(b * sLen,
+        (b + 1) * sLen - 1) + arma::repmat(kBias, 1, sLen));
+    const arma::mat vProj = arma::trans(valueWt * v.cols(b * sLen,
+        (b + 1) * sLen - 1) + arma::repmat(vBias, 1, sLen));
+    qProj /= std::sqrt(headDim);
+
+    arma::mat attn(tLen, embedDim);
+    for (size_t h = 0; h < numHeads; ++h)
+    {
+      const arma::span cols(h * headDim, (h + 1) * headDim - 1);
+      arma::mat score = qProj.cols(cols) * kProj.cols(cols).t() + attnMask +
+          arma::repmat(keyPaddingMask, tLen, 1);
+
+      // Softmax over each column.
+      for (size_t j = 0; j < sLen; ++j)
+      {
+        score.col(j) = arma::exp(score.col(j) - score.col(j).max());
+        score.col(j) /= arma::accu(score.col(j));
+      }
+
+      attn.cols(cols) = score * vProj.cols(cols);
+    }
+
+    expected.col(b) = arma::vectorise(arma::trans(attn * outWt +
+        arma::repmat(outBias, tLen, 1)));
+  }
+
+  CheckMatrices(output, expected, 1e-6);
+}
+
 /**
  * Jacobian MultiheadAttention module test.
  */
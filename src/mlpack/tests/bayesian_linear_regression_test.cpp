@@ -193,3 +193,91 @@ TEST_CASE("EqualtoRidge", "[BayesianLinearRegressionTest]")
 
   REQUIRE(trial <= 3);
 }
+
+// Check that training on statistics accumulated in blocks gives the same model
+// as training on all the points at once, even after a block is forgotten.
+TEST_CASE("BayesianLinearRegressionRefitTest",
+          "[BayesianLinearRegressionTest]")
+{
+  arma::mat matX;
+  arma::rowvec y;
+  GenerateProblem(matX, y, 400, 5, 0.5);
+  matX.each_col() += arma::linspace<arma::colvec>(1, 5, 5);
+
+  arma::mat extraX;
+  arma::rowvec extraY;
+  GenerateProblem(extraX, extraY, 50, 5, 2.0);
+
+  const bool options[4][2] = { { false, false }, { true, false },
+      { false, true }, { true, true } };
+  for (size_t i = 0; i < 4; ++i)
+  {
+    BayesianLinearRegression blr(options[i][0], options[i][1]);
+    blr.Train(matX, y);
+
+    BayesianLinearRegression streaming(options[i][0], options[i][1]);
+    for (size_t j = 0; j < matX.n_cols; j += 100)
+    {
+      streaming.Accumulate(matX.cols(j, j + 99), y.cols(j, j + 99));
+      if (j == 100)
+        streaming.Accumulate(extraX, extraY);
+    }
+    streaming.Forget(extraX, extraY);
+    REQUIRE(streaming.NumAccumulated() == 400);
+    streaming.Refit();
+
+    REQUIRE(streaming.Alpha() == Approx(blr.Alpha()).epsilon(1e-5));
+    REQUIRE(streaming.Beta() == Approx(blr.Beta()).epsilon(1e-5));
+    REQUIRE(streaming.ResponsesOffset() ==
+        Approx(blr.ResponsesOffset()).margin(1e-8));
+    REQUIRE(arma::approx_equal(streaming.Omega(), blr.Omega(), "reldiff",
+        1e-5));
+    if (options[i][0])
+    {
+      REQUIRE(arma::approx_equal(streaming.DataOffset(), blr.DataOffset(),
+          "reldiff", 1e-8));
+    }
+    if (options[i][1])
+    {
+      REQUIRE(arma::approx_equal(streaming.DataScale(), blr.DataScale(),
+          "reldiff", 1e-8));
+    }
+  }
+
+  BayesianLinearRegression empty;
+  REQUIRE_THROWS_AS(empty.Refit(), std::invalid_argument);
+  REQUIRE_THROWS_AS(empty.Forget(extraX, extraY), std::invalid_argument);
+}
+
+// Check that a rank-one update gives the posterior of the solution with one
+// more observation, at the updated point.
+TEST_CASE("BayesianLinearRegressionUpdateTest",
+          "[BayesianLinearRegressionTest]")
+{
+  arma::mat matX;
+  arma::rowvec y;
+  GenerateProblem(matX, y, 101, 5, 0.5);
+
+  BayesianLinearRegression blr(true, true);
+  REQUIRE_THROWS_AS(blr.Update(matX.col(0), y[0]), std::invalid_argument);
+  blr.Train(matX.cols(0, 99), y.cols(0, 99));
+  REQUIRE_THROWS_AS(blr.Update(arma::colvec(4, arma::fill::ones), 1.0),
+      std::invalid_argument);
+
+  // With s = x^T S x the variance of the prediction at the new point x, the
+  // new prediction is m + s (y - m) / (1 / beta + s), and the new variance of
+  // the solution at x is s / (1 + beta s).
+  const arma::mat point = matX.col(100);
+  arma::rowvec predictions, std;
+  blr.Predict(point, predictions, std);
+  const double s = std[0] * std[0] - blr.Variance();
+  const double expectedPrediction = predictions[0] + s *
+      (y[100] - predictions[0]) / (blr.Variance() + s);
+  const double expectedVariance = s / (1.0 + blr.Beta() * s);
+
+  blr.Update(point.col(0), y[100]);
+  blr.Predict(point, predictions, std);
+  REQUIRE(predictions[0] == Approx(expectedPrediction).epsilon(1e-8));
+  REQUIRE(std[0] * std[0] - blr.Variance() ==
+      Approx(expectedVariance).epsilon(1e-6));
+}
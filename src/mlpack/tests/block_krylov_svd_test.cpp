@@ -106,3 +106,49 @@ TEST_CASE("RandomizedBlockKrylovSVDNoisyLowRankTest", "[BlockKrylovSVDTest]")
   double error = arma::max(arma::abs(s1.subvec(0, rank) - s2.subvec(0, rank)));
   REQUIRE(error == Approx(0.0).margin(1e-4));
 }
+
+/**
+ * The randomized block krylov SVD of a sparse matrix, with or without implicit
+ * centering, should match the SVD of the dense matrix.
+ */
+TEST_CASE("RandomizedBlockKrylovSVDSparseTest", "[BlockKrylovSVDTest]")
+{
+  // A sparse matrix of rank at most 3.
+  arma::sp_mat data(50, 200);
+  for (size_t i = 0; i < 3; ++i)
+  {
+    data += arma::sprandu<arma::sp_mat>(50, 1, 0.3) *
+        arma::sprandu<arma::sp_mat>(1, 200, 0.3);
+  }
+  const arma::mat denseData(data);
+
+  arma::mat U1, U2, V1, V2;
+  arma::vec s1, s2;
+
+  arma::svd_econ(U1, s1, V1, denseData);
+
+  svd::RandomizedBlockKrylovSVD rSVD(2, 10);
+  rSVD.Apply(data, U2, s2, V2, 3);
+
+  double error = arma::norm(s2.head(3) - s1.head(3)) / arma::norm(s1.head(3));
+  REQUIRE(error == Approx(0.0).margin(1e-5));
+
+  arma::mat reconstruct = U2 * arma::diagmat(s2) * V2.t();
+  REQUIRE(arma::norm(denseData - reconstruct, "frob") /
+      arma::norm(denseData, "frob") == Approx(0.0).margin(1e-5));
+
+  // Now factorize the centered matrix, which is never formed.
+  arma::mat centeredData;
+  math::Center(denseData, centeredData);
+  arma::svd_econ(U1, s1, V1, centeredData);
+
+  const arma::vec rowMean = arma::mean(denseData, 1);
+  rSVD.Apply(data, U2, s2, V2, 4, rowMean);
+
+  error = arma::norm(s2.head(4) - s1.head(4)) / arma::norm(s1.head(4));
+  REQUIRE(error == Approx(0.0).margin(1e-5));
+
+  reconstruct = U2 * arma::diagmat(s2) * V2.t();
+  REQUIRE(arma::norm(centeredData - reconstruct, "frob") /
+      arma::norm(centeredData, "frob") == Approx(0.0).margin(1e-5));
+}
@@ -13,6 +13,7 @@
 
 #include <mlpack/core.hpp>
 #include <mlpack/methods/cf/cf.hpp>
+#include <mlpack/methods/cf/streaming_svd.hpp>
 #include <mlpack/methods/cf/decomposition_policies/batch_svd_method.hpp>
 #include <mlpack/methods/cf/decomposition_policies/bias_svd_method.hpp>
 #include <mlpack/methods/cf/decomposition_policies/randomized_svd_method.hpp>
@@ -117,6 +118,63 @@ void GetRecommendationsAllUsers()
   BOOST_REQUIRE_EQUAL(recommendations.n_cols, numUsers);
 }
 
+/**
+ * Make sure that GetMIPSRecommendations() gives the same recommendations as
+ * GetRecommendations(), and that it skips the excluded items.
+ */
+template<typename DecompositionPolicy,
+         typename NormalizationType = NoNormalization>
+void MIPSRecommendations()
+{
+  DecompositionPolicy decomposition;
+  const size_t numRecs = 5;
+
+  arma::mat dataset;
+  data::Load("GroupLensSmall.csv", dataset);
+
+  CFType<DecompositionPolicy, NormalizationType>
+      c(dataset, decomposition, 5, 5, 30);
+
+  arma::Mat<size_t> recommendations, mipsRecommendations;
+  c.GetRecommendations(numRecs, recommendations);
+  c.GetMIPSRecommendations(numRecs, mipsRecommendations);
+
+  BOOST_REQUIRE_EQUAL(mipsRecommendations.n_rows, numRecs);
+  BOOST_REQUIRE_EQUAL(mipsRecommendations.n_cols, recommendations.n_cols);
+
+  // The items may only differ where the ratings are tied, so compare the
+  // ratings.
+  for (size_t i = 0; i < recommendations.n_cols; ++i)
+  {
+    for (size_t p = 0; p < numRecs; ++p)
+    {
+      BOOST_REQUIRE_CLOSE(c.Predict(i, mipsRecommendations(p, i)),
+          c.Predict(i, recommendations(p, i)), 1e-5);
+    }
+  }
+
+  // Exclude the best item of each user; the other recommendations move up.
+  arma::sp_mat exclude(c.CleanedData().n_rows, c.CleanedData().n_cols);
+  for (size_t i = 0; i < recommendations.n_cols; ++i)
+    exclude(mipsRecommendations(0, i), i) = 1.0;
+
+  arma::Col<size_t> users = arma::linspace<arma::Col<size_t> >(0,
+      recommendations.n_cols - 1, recommendations.n_cols);
+  arma::Mat<size_t> excluded;
+  c.GetMIPSRecommendations(numRecs, excluded, users, exclude);
+
+  for (size_t i = 0; i < recommendations.n_cols; ++i)
+  {
+    for (size_t p = 0; p < numRecs; ++p)
+      BOOST_REQUIRE_NE(excluded(p, i), mipsRecommendations(0, i));
+    for (size_t p = 0; p + 1 < numRecs; ++p)
+    {
+      BOOST_REQUIRE_CLOSE(c.Predict(i, excluded(p, i)),
+          c.Predict(i, mipsRecommendations(p + 1, i)), 1e-5);
+    }
+  }
+}
+
 /**
  * Make sure that the recommendations are generated for queried users only.
  */
@@ -580,6 +638,32 @@ BOOST_AUTO_TEST_CASE(CFGetRecommendationsAllUsersSVDPPTest)
   GetRecommendationsAllUsers<SVDPlusPlusPolicy>();
 }
 
+/**
+ * Make sure that GetMIPSRecommendations() matches GetRecommendations(), for
+ * normalizations with per-user and per-item terms.
+ */
+BOOST_AUTO_TEST_CASE(CFMIPSRecommendationsRegSVDTest)
+{
+  MIPSRecommendations<RegSVDPolicy>();
+}
+
+BOOST_AUTO_TEST_CASE(CFMIPSRecommendationsNMFItemMeanTest)
+{
+  MIPSRecommendations<NMFPolicy, ItemMeanNormalization>();
+}
+
+BOOST_AUTO_TEST_CASE(CFMIPSRecommendationsSVDCompleteZScoreTest)
+{
+  MIPSRecommendations<SVDCompletePolicy, ZScoreNormalization>();
+}
+
+BOOST_AUTO_TEST_CASE(CFMIPSRecommendationsBatchSVDCombinedTest)
+{
+  MIPSRecommendations<BatchSVDPolicy, CombinedNormalization<
+      OverallMeanNormalization, UserMeanNormalization,
+      ItemMeanNormalization>>();
+}
+
 /**
  * Make sure that the recommendations are generated for queried users only
  * for randomized SVD.
@@ -840,6 +924,50 @@ BOOST_AUTO_TEST_CASE(CFBatchPredictSVDPPTest)
   BatchPredict<SVDPlusPlusPolicy>();
 }
 
+/**
+ * Make sure the ratings of a user for a set of items match the ratings given
+ * by GetRating().
+ */
+template<typename DecompositionPolicy>
+void RatingsOfUserForItems()
+{
+  DecompositionPolicy decomposition;
+  arma::mat dataset;
+  data::Load("GroupLensSmall.csv", dataset);
+
+  CFType<DecompositionPolicy> c(dataset, decomposition, 5, 5, 30);
+
+  arma::uvec items = arma::randi<arma::uvec>(50, arma::distr_param(0,
+      c.CleanedData().n_rows - 1));
+  for (size_t user = 0; user < 10; ++user)
+  {
+    arma::vec ratings;
+    c.Decomposition().GetRatingOfUser(user, items, ratings);
+
+    BOOST_REQUIRE_EQUAL(ratings.n_elem, items.n_elem);
+    for (size_t i = 0; i < items.n_elem; ++i)
+    {
+      BOOST_REQUIRE_CLOSE(ratings[i],
+          c.Decomposition().GetRating(user, items[i]), 1e-8);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(CFRatingsOfUserForItemsNMFTest)
+{
+  RatingsOfUserForItems<NMFPolicy>();
+}
+
+BOOST_AUTO_TEST_CASE(CFRatingsOfUserForItemsBiasSVDTest)
+{
+  RatingsOfUserForItems<BiasSVDPolicy>();
+}
+
+BOOST_AUTO_TEST_CASE(CFRatingsOfUserForItemsSVDPPTest)
+{
+  RatingsOfUserForItems<SVDPlusPlusPolicy>();
+}
+
 /**
  * Make sure we can train an already-trained model and it works okay for
  * randomized SVD.
@@ -1228,4 +1356,203 @@ BOOST_AUTO_TEST_CASE(CFPredictRegressionInterpolation)
             RegressionInterpolation>(2.0);
 }
 
+/**
+ * Make sure that the batch GetWeights() of an interpolation policy gives the
+ * same weights as the single-user one.
+ */
+template<typename InterpolationPolicy>
+void BatchInterpolation()
+{
+  arma::mat dataset;
+  data::Load("GroupLensSmall.csv", dataset);
+
+  RegSVDPolicy decomposition;
+  CFType<RegSVDPolicy> c(dataset, decomposition, 5, 5, 30);
+
+  arma::Col<size_t> users = arma::linspace<arma::Col<size_t> >(0,
+      c.CleanedData().n_cols - 1, c.CleanedData().n_cols);
+  arma::Mat<size_t> neighborhood;
+  arma::mat similarities;
+  c.Decomposition().template GetNeighborhood<EuclideanSearch>(users, 5,
+      neighborhood, similarities);
+
+  InterpolationPolicy interpolation(c.CleanedData());
+  arma::mat weights;
+  interpolation.GetWeights(weights, c.Decomposition(), users, neighborhood,
+      similarities, c.CleanedData());
+
+  BOOST_REQUIRE_EQUAL(weights.n_rows, neighborhood.n_rows);
+  BOOST_REQUIRE_EQUAL(weights.n_cols, users.n_elem);
+
+  arma::vec userWeights(neighborhood.n_rows);
+  for (size_t i = 0; i < users.n_elem; ++i)
+  {
+    interpolation.GetWeights(userWeights, c.Decomposition(), users(i),
+        neighborhood.col(i), similarities.col(i), c.CleanedData());
+    for (size_t j = 0; j < userWeights.n_elem; ++j)
+      BOOST_REQUIRE_CLOSE(weights(j, i), userWeights(j), 1e-3);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(CFBatchAverageInterpolationTest)
+{
+  BatchInterpolation<AverageInterpolation>();
+}
+
+BOOST_AUTO_TEST_CASE(CFBatchSimilarityInterpolationTest)
+{
+  BatchInterpolation<SimilarityInterpolation>();
+}
+
+BOOST_AUTO_TEST_CASE(CFBatchRegressionInterpolationTest)
+{
+  BatchInterpolation<RegressionInterpolation>();
+}
+
+/**
+ * Make sure that StreamingSVD learns a factorization from memory-mapped shards
+ * that are read chunk by chunk.
+ */
+/**
+ * Fold a new user and a new item whose ratings are given exactly by the
+ * factors of the model into it, and make sure these factors are recovered.
+ */
+template<typename DecompositionPolicy>
+void FoldIn()
+{
+  DecompositionPolicy decomposition;
+  arma::mat dataset;
+  data::Load("GroupLensSmall.csv", dataset);
+
+  CFType<DecompositionPolicy> c(dataset, decomposition, 5, 5, 30);
+
+  const size_t numItems = c.CleanedData().n_rows;
+  const size_t numUsers = c.CleanedData().n_cols;
+  const arma::mat w = c.Decomposition().W();
+  const arma::mat h = c.Decomposition().H();
+
+  // The new user has the factors of user 3 and rates the first 30 items; the
+  // new item has the factors of item 7 and is rated by the first 30 users.
+  arma::mat newRatings(3, 60);
+  for (size_t i = 0; i < 30; ++i)
+  {
+    newRatings(0, i) = numUsers;
+    newRatings(1, i) = i;
+    newRatings(2, i) = arma::as_scalar(w.row(i) * h.col(3));
+
+    newRatings(0, 30 + i) = i;
+    newRatings(1, 30 + i) = numItems;
+    newRatings(2, 30 + i) = arma::as_scalar(w.row(7) * h.col(i));
+  }
+
+  c.FoldIn(newRatings, 1e-10);
+
+  BOOST_REQUIRE_EQUAL(c.CleanedData().n_rows, numItems + 1);
+  BOOST_REQUIRE_EQUAL(c.CleanedData().n_cols, numUsers + 1);
+  BOOST_REQUIRE_EQUAL(c.Decomposition().W().n_rows, numItems + 1);
+  BOOST_REQUIRE_EQUAL(c.Decomposition().H().n_cols, numUsers + 1);
+
+  // The model itself is unchanged.
+  BOOST_REQUIRE_SMALL(arma::abs(c.Decomposition().W().rows(0, numItems - 1) -
+      w).max(), 1e-12);
+  BOOST_REQUIRE_SMALL(arma::abs(c.Decomposition().H().cols(0, numUsers - 1) -
+      h).max(), 1e-12);
+
+  BOOST_REQUIRE_SMALL(arma::abs(c.Decomposition().H().col(numUsers) -
+      h.col(3)).max(), 1e-5);
+  BOOST_REQUIRE_SMALL(arma::abs(c.Decomposition().W().row(numItems) -
+      w.row(7)).max(), 1e-5);
+
+  // The new user can be queried, and isn't recommended the items it rated.
+  arma::Col<size_t> users(1);
+  users(0) = numUsers;
+  arma::Mat<size_t> recommendations;
+  c.GetRecommendations(10, recommendations, users);
+  BOOST_REQUIRE_EQUAL(recommendations.n_cols, 1);
+  for (size_t i = 0; i < recommendations.n_rows; ++i)
+    BOOST_REQUIRE_GE(recommendations(i, 0), 30);
+
+  // The new users and items are kept by serialization.
+  CFType<DecompositionPolicy> cXml, cText, cBinary;
+  SerializeObjectAll(c, cXml, cText, cBinary);
+  CheckMatrices(c.Decomposition().W(), cXml.Decomposition().W(),
+      cBinary.Decomposition().W(), cText.Decomposition().W());
+  CheckMatrices(c.Decomposition().H(), cXml.Decomposition().H(),
+      cBinary.Decomposition().H(), cText.Decomposition().H());
+
+  // A rating which involves no new user or item is rejected.
+  arma::mat oldRating(3, 1);
+  oldRating(0, 0) = 0;
+  oldRating(1, 0) = 0;
+  oldRating(2, 0) = 1.0;
+  BOOST_REQUIRE_THROW(c.FoldIn(oldRating), std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE(CFFoldInBatchSVDTest)
+{
+  FoldIn<BatchSVDPolicy>();
+}
+
+BOOST_AUTO_TEST_CASE(CFFoldInRegSVDTest)
+{
+  FoldIn<RegSVDPolicy>();
+}
+
+BOOST_AUTO_TEST_CASE(StreamingSVDMappedShardsTest)
+{
+  arma::mat dataset;
+  data::Load("GroupLensSmall.csv", dataset);
+
+  // Split the dataset into two shards.
+  const size_t half = dataset.n_cols / 2;
+  data::SaveMapped("cf_shard_0.bin", arma::mat(dataset.cols(0, half - 1)),
+      true);
+  data::SaveMapped("cf_shard_1.bin",
+      arma::mat(dataset.cols(half, dataset.n_cols - 1)), true);
+
+  std::vector<std::string> files;
+  files.push_back("cf_shard_0.bin");
+  files.push_back("cf_shard_1.bin");
+
+  {
+    data::MappedChunkSource source(files, 1000);
+    BOOST_REQUIRE_EQUAL(source.NumColumns(), dataset.n_cols);
+
+    // Without shuffling, the chunks hold the columns in order.
+    data::PrefetchLoader<data::MappedChunkSource> loader(source);
+    arma::mat chunk, responses, all;
+    while (loader.Next(chunk, responses))
+    {
+      BOOST_REQUIRE_LE(chunk.n_cols, 1000);
+      all = arma::join_rows(all, chunk);
+    }
+    BOOST_REQUIRE_EQUAL(arma::accu(all != dataset), 0);
+
+    data::PrefetchLoader<data::MappedChunkSource> shuffledLoader(source, 2,
+        true);
+    StreamingSVD svd(5, 30, 0.01, 0.02);
+    const double rmse = svd.Train(shuffledLoader);
+
+    BOOST_REQUIRE_EQUAL(svd.UserFactors().n_rows, 5);
+    BOOST_REQUIRE_EQUAL(svd.UserFactors().n_cols,
+        (size_t) arma::max(dataset.row(0)) + 1);
+    BOOST_REQUIRE_EQUAL(svd.ItemFactors().n_cols,
+        (size_t) arma::max(dataset.row(1)) + 1);
+    BOOST_REQUIRE_LT(rmse, 1.1);
+
+    // The error of the trained model on the data is small too.
+    double error = 0.0;
+    for (size_t i = 0; i < dataset.n_cols; ++i)
+    {
+      const double e = dataset(2, i) - svd.Predict(dataset(0, i),
+          dataset(1, i));
+      error += e * e;
+    }
+    BOOST_REQUIRE_LT(std::sqrt(error / dataset.n_cols), 1.1);
+  }
+
+  remove("cf_shard_0.bin");
+  remove("cf_shard_1.bin");
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -11,6 +11,7 @@
  */
 #include <mlpack/core.hpp>
 #include <mlpack/bindings/cli/cli_option.hpp>
+#include <mlpack/bindings/cli/serve.hpp>
 #include <mlpack/core/kernels/gaussian_kernel.hpp>
 
 #include "catch.hpp"
@@ -628,3 +629,134 @@ TEST_CASE("DeleteAllocatedMemoryModelTest", "[CLIOptionTest]")
   DeleteAllocatedMemory<GaussianKernel*>((util::ParamData&) d,
       (const void*) NULL, (void*) NULL);
 }
+
+// Parameters of the program run by the --serve tests.
+static util::ParamData serveQuery, servePredictions;
+
+// The program run by the --serve tests: predict the sum of each point.
+static void ServeTestMain()
+{
+  const arma::mat& query = GetParam<arma::mat>(serveQuery);
+  if (query.n_rows != 2)
+    throw std::invalid_argument("the points must have 2 dimensions");
+
+  GetParam<arma::Row<size_t>>(servePredictions) =
+      arma::conv_to<arma::Row<size_t>>::from(arma::sum(query, 0));
+}
+
+// Set up the parameters of the --serve tests.
+static void SetUpServeTest()
+{
+  serveQuery.tname = TYPENAME(arma::mat);
+  serveQuery.value = boost::any(make_tuple(arma::mat(), string()));
+  serveQuery.input = true;
+  serveQuery.noTranspose = false;
+  serveQuery.loaded = false;
+
+  servePredictions.tname = TYPENAME(arma::Row<size_t>);
+  servePredictions.value = boost::any(make_tuple(arma::Row<size_t>(),
+      string()));
+  servePredictions.input = false;
+  servePredictions.noTranspose = false;
+}
+
+// Check that each CSV batch is answered, and that an invalid batch gets an
+// empty answer without stopping the server.
+TEST_CASE("ServeStreamCSVTest", "[CLIOptionTest]")
+{
+  SetUpServeTest();
+  std::vector<util::ParamData*> outputs = { &servePredictions };
+  std::istringstream input("1,2\n3,4\n\n5 6\n\n1,2,3\n\n1,x\n\n\n2,2\n");
+  std::ostringstream output;
+  ServeStream(input, output, &ServeTestMain, serveQuery, outputs, false);
+
+  REQUIRE(output.str() == "3\n7\n\n11\n\n\n\n4\n\n");
+}
+
+// Check that batches in binary framing are answered in binary framing.
+TEST_CASE("ServeStreamBinaryTest", "[CLIOptionTest]")
+{
+  SetUpServeTest();
+  std::vector<util::ParamData*> outputs = { &servePredictions };
+
+  // Batches are given with one point per row.
+  arma::mat batch1 = { { 1.0, 2.0 }, { 3.0, 4.0 }, { 5.0, 7.0 } };
+  arma::mat batch2 = { { 2.0, 2.0 } };
+  std::stringstream input;
+  WriteBatch(input, batch1, true);
+  WriteBatch(input, batch2, true);
+
+  std::stringstream output;
+  ServeStream(input, output, &ServeTestMain, serveQuery, outputs, true);
+
+  arma::mat answer;
+  REQUIRE(ReadBinaryBatch(output, answer));
+  REQUIRE(answer.n_rows == 3);
+  REQUIRE(answer.n_cols == 1);
+  REQUIRE(answer(0, 0) == 3.0);
+  REQUIRE(answer(1, 0) == 7.0);
+  REQUIRE(answer(2, 0) == 12.0);
+
+  REQUIRE(ReadBinaryBatch(output, answer));
+  REQUIRE(answer.n_rows == 1);
+  REQUIRE(answer(0, 0) == 4.0);
+
+  REQUIRE(!ReadBinaryBatch(output, answer));
+}
+
+// Check that a matrix parameter named "-" is read from the standard input, and
+// that matrices written to "-" (in each format) can be read back.
+TEST_CASE("StandardStreamMatrixTest", "[CLIOptionTest]")
+{
+  arma::mat m(4, 6, arma::fill::randu);
+
+  // Write the matrix to a buffer that plays the standard output, as
+  // Armadillo binary and in the columnar (mapped) layout.
+  std::stringstream binaryOutput, mappedOutput, csvOutput;
+  std::streambuf* oldBuffer = StandardOutputBuffer();
+  util::ParamData d;
+  d.value = boost::any(make_tuple(m, string("-")));
+  d.input = false;
+  d.noTranspose = false;
+
+  bool usesStandardStream = false;
+  UsesStandardStream<arma::mat>(d, NULL, (void*) &usesStandardStream);
+  REQUIRE(usesStandardStream == true);
+
+  StandardOutputBuffer() = binaryOutput.rdbuf();
+  OutputParam<arma::mat>(d, (const void*) NULL, (void*) NULL);
+  std::get<1>(*boost::any_cast<tuple<arma::mat, string>>(&d.value)) =
+      "-.mapped";
+  StandardOutputBuffer() = mappedOutput.rdbuf();
+  OutputParam<arma::mat>(d, (const void*) NULL, (void*) NULL);
+  std::get<1>(*boost::any_cast<tuple<arma::mat, string>>(&d.value)) = "-.csv";
+  StandardOutputBuffer() = csvOutput.rdbuf();
+  OutputParam<arma::mat>(d, (const void*) NULL, (void*) NULL);
+  StandardOutputBuffer() = oldBuffer;
+
+  // The binary and CSV outputs are transposed, like files.
+  arma::mat binary, csv;
+  REQUIRE(binary.load(binaryOutput, arma::arma_binary));
+  REQUIRE(csv.load(csvOutput, arma::csv_ascii));
+  CheckMatrices(binary, arma::mat(m.t()));
+  CheckMatrices(csv, arma::mat(m.t()));
+
+  // The columnar output is read back from the standard input, without being
+  // transposed.
+  util::ParamData in;
+  in.value = boost::any(make_tuple(arma::mat(), string("-")));
+  in.input = true;
+  in.loaded = false;
+  in.noTranspose = false;
+
+  std::streambuf* cinBuffer = std::cin.rdbuf(mappedOutput.rdbuf());
+  arma::mat& loaded = GetParam<arma::mat>(in);
+  std::cin.rdbuf(cinBuffer);
+  CheckMatrices(loaded, m);
+
+  // A parameter with a real file does not use the standard streams.
+  std::get<1>(*boost::any_cast<tuple<arma::mat, string>>(&d.value)) =
+      "test.csv";
+  UsesStandardStream<arma::mat>(d, NULL, (void*) &usesStandardStream);
+  REQUIRE(usesStandardStream == false);
+}
@@ -13,6 +13,7 @@
 
 #include <mlpack/core/cv/meta_info_extractor.hpp>
 #include <mlpack/core/cv/metrics/accuracy.hpp>
+#include <mlpack/core/cv/metrics/classification_metrics.hpp>
 #include <mlpack/core/cv/metrics/f1.hpp>
 #include <mlpack/core/cv/metrics/mse.hpp>
 #include <mlpack/core/cv/metrics/precision.hpp>
@@ -146,6 +147,92 @@ TEST_CASE("MulticlassClassificationMetricsTest", "[CVTest]")
           == Approx(macroaveragedF1).epsilon(1e-7));
 }
 
+/**
+ * A model that predicts fixed labels and counts the calls to Classify().
+ */
+class CountingClassifier
+{
+ public:
+  CountingClassifier(const arma::Row<size_t>& predictions) :
+      predictions(predictions), calls(0) { }
+
+  void Classify(const arma::mat& /* data */, arma::Row<size_t>& labels)
+  {
+    ++calls;
+    labels = predictions;
+  }
+
+  arma::Row<size_t> predictions;
+  size_t calls;
+};
+
+/**
+ * Make sure that ClassificationMetrics gives the values of the separate
+ * metrics, and classifies the data once.
+ */
+TEST_CASE("ClassificationMetricsTest", "[CVTest]")
+{
+  arma::mat data = arma::linspace<arma::rowvec>(1.0, 12.0, 12);
+  arma::Row<size_t> labels("0 1  0 1  2 2 1 2  3 3 3 3");
+  CountingClassifier model(arma::Row<size_t>("0 0  1 1  2 2 2 2  3 3 3 3"));
+
+  typedef ClassificationMetrics<Macro> MacroMetrics;
+  const arma::vec macro = MacroMetrics::Evaluate(model, data, labels);
+  REQUIRE(model.calls == 1);
+  REQUIRE(macro.n_elem == 4);
+  REQUIRE(macro[MacroMetrics::AccuracyIndex] ==
+      Approx(Accuracy::Evaluate(model, data, labels)).epsilon(1e-7));
+  REQUIRE(macro[MacroMetrics::PrecisionIndex] ==
+      Approx(Precision<Macro>::Evaluate(model, data, labels)).epsilon(1e-7));
+  REQUIRE(macro[MacroMetrics::RecallIndex] ==
+      Approx(Recall<Macro>::Evaluate(model, data, labels)).epsilon(1e-7));
+  REQUIRE(macro[MacroMetrics::F1Index] ==
+      Approx(F1<Macro>::Evaluate(model, data, labels)).epsilon(1e-7));
+
+  typedef ClassificationMetrics<Micro> MicroMetrics;
+  const arma::vec micro = MicroMetrics::Evaluate(model, data, labels);
+  for (size_t i = 0; i < micro.n_elem; ++i)
+    REQUIRE(micro[i] == Approx(9.0 / 12).epsilon(1e-7));
+
+  // Binary classification, with class 2 as the positive class.
+  typedef ClassificationMetrics<Binary, 2> BinaryMetrics;
+  const arma::vec binary = BinaryMetrics::Evaluate(model, data, labels);
+  REQUIRE(binary[BinaryMetrics::PrecisionIndex] ==
+      Approx(Precision<Binary, 2>::Evaluate(model, data, labels))
+      .epsilon(1e-7));
+  REQUIRE(binary[BinaryMetrics::RecallIndex] ==
+      Approx(Recall<Binary, 2>::Evaluate(model, data, labels)).epsilon(1e-7));
+  REQUIRE(binary[BinaryMetrics::F1Index] ==
+      Approx(F1<Binary, 2>::Evaluate(model, data, labels)).epsilon(1e-7));
+
+  // Predictions of the wrong size are rejected.
+  REQUIRE_THROWS_AS(MacroMetrics::Evaluate(arma::Row<size_t>("0 1"), labels),
+      std::invalid_argument);
+}
+
+/**
+ * Make sure that k-fold cross-validation averages each metric of a bundle.
+ */
+TEST_CASE("KFoldCVClassificationMetricsTest", "[CVTest]")
+{
+  // The same dataset as in KFoldCVAccuracyTest.
+  arma::mat data("0 1 2 3 100 101 102 103 104 5");
+  arma::Row<size_t> labels("0 0 0 0 1 1 1 1 1 1");
+  size_t numClasses = 2;
+
+  KFoldCV<NaiveBayesClassifier<>, ClassificationMetrics<Micro>> cv(10, data,
+      labels, numClasses, false);
+  const arma::vec results = cv.Evaluate();
+
+  REQUIRE(results.n_elem == 4);
+  for (size_t i = 0; i < results.n_elem; ++i)
+    REQUIRE(results[i] == Approx(0.9).epsilon(1e-7));
+
+  SimpleCV<NaiveBayesClassifier<>, ClassificationMetrics<Micro>> simpleCV(0.5,
+      data, labels, numClasses);
+  REQUIRE(simpleCV.Evaluate().n_elem == 4);
+}
+
 /**
  * Test the mean squared error.
  */
@@ -744,6 +831,46 @@ TEST_CASE("KFoldCVWithDTTestUnevenBinsWeighted", "[CVTest]")
   REQUIRE(accuracy > 0.7);
 }
 
+/**
+ * Training the folds in parallel should give the same results as training them
+ * one at a time, with and without weights.
+ */
+TEST_CASE("KFoldCVNumThreadsTest", "[CVTest]")
+{
+  arma::mat data;
+  arma::Row<size_t> labels;
+  data::DatasetInfo datasetInfo;
+  MockCategoricalData(data, labels, datasetInfo);
+  arma::rowvec weights(data.n_cols, arma::fill::randu);
+
+  size_t numClasses = 5;
+  size_t minimumLeafSize = 5;
+
+  KFoldCV<DecisionTree<InformationGain>, Accuracy> cv(7, data, datasetInfo,
+      labels, numClasses, false);
+  KFoldCV<DecisionTree<InformationGain>, Accuracy> weightedCV(7, data,
+      datasetInfo, labels, numClasses, weights, false);
+
+  cv.NumThreads() = 1;
+  weightedCV.NumThreads() = 1;
+  const double serialAccuracy = cv.Evaluate(minimumLeafSize);
+  const double serialWeightedAccuracy = weightedCV.Evaluate(minimumLeafSize);
+  arma::Row<size_t> serialPredictions;
+  cv.Model().Classify(data, serialPredictions);
+
+  cv.NumThreads() = 0;
+  weightedCV.NumThreads() = 0;
+  REQUIRE(cv.Evaluate(minimumLeafSize) ==
+      Approx(serialAccuracy).epsilon(1e-10));
+  REQUIRE(weightedCV.Evaluate(minimumLeafSize) ==
+      Approx(serialWeightedAccuracy).epsilon(1e-10));
+
+  // The model of the last fold is kept, as in the serial case.
+  arma::Row<size_t> predictions;
+  cv.Model().Classify(data, predictions);
+  REQUIRE(arma::accu(predictions != serialPredictions) == 0);
+}
+
 /**
  * Test Silhouette Score
  */
@@ -758,3 +885,74 @@ TEST_CASE("SilhouetteScoreTest", "[CVTest]")
   double silhouetteScore = SilhouetteScore::Overall(X, labels, metric);
   REQUIRE(silhouetteScore == Approx(0.1121684822489150).epsilon(1e-7));
 }
+
+/**
+ * Make sure that the blocked silhouette scores (with the matrix multiplication
+ * for the Euclidean distance, and with the generic metric path) match the
+ * scores computed from the full distance matrix, on more points than one block
+ * and with arbitrary label values.
+ */
+TEST_CASE("SilhouetteScoreBlockedTest", "[CVTest]")
+{
+  arma::mat X(3, 1500, arma::fill::randu);
+  arma::Row<size_t> labels(X.n_cols);
+  for (size_t i = 0; i < X.n_cols; ++i)
+  {
+    labels[i] = (X(0, i) < 0.3) ? 7 : (X(1, i) < 0.5) ? 2 :
+        std::numeric_limits<size_t>::max();
+  }
+  // A cluster with one point.
+  labels[10] = 100;
+
+  metric::EuclideanDistance euclidean;
+  metric::ManhattanDistance manhattan;
+  const arma::rowvec euclideanScores = SilhouetteScore::SamplesScore(X, labels,
+      euclidean);
+  const arma::rowvec manhattanScores = SilhouetteScore::SamplesScore(X, labels,
+      manhattan);
+  const arma::rowvec euclideanExpected = SilhouetteScore::SamplesScore(
+      PairwiseDistances(X, euclidean), labels);
+  const arma::rowvec manhattanExpected = SilhouetteScore::SamplesScore(
+      PairwiseDistances(X, manhattan), labels);
+
+  REQUIRE(euclideanScores.n_elem == X.n_cols);
+  REQUIRE(manhattanScores.n_elem == X.n_cols);
+  REQUIRE(euclideanScores[10] == 0.0);
+  for (size_t i = 0; i < X.n_cols; ++i)
+  {
+    REQUIRE(euclideanScores[i] ==
+        Approx(euclideanExpected[i]).epsilon(1e-5).margin(1e-8));
+    REQUIRE(manhattanScores[i] ==
+        Approx(manhattanExpected[i]).epsilon(1e-5).margin(1e-8));
+  }
+}
+
+/**
+ * Make sure that the sampled silhouette score is close to the overall score,
+ * and exact when every point is sampled.
+ */
+TEST_CASE("SilhouetteScoreApproximateTest", "[CVTest]")
+{
+  arma::mat X(2, 1000, arma::fill::randu);
+  X.cols(0, 499) += 3.0;
+  arma::Row<size_t> labels(X.n_cols);
+  labels.subvec(0, 499).fill(0);
+  labels.subvec(500, 999).fill(1);
+
+  metric::EuclideanDistance metric;
+  const double overall = SilhouetteScore::Overall(X, labels, metric);
+
+  double standardError;
+  const double estimate = SilhouetteScore::ApproximateOverall(X, labels,
+      metric, 200, standardError);
+  REQUIRE(standardError > 0.0);
+  REQUIRE(std::abs(estimate - overall) <= 5 * standardError);
+
+  const double exact = SilhouetteScore::ApproximateOverall(X, labels, metric,
+      X.n_cols, standardError);
+  REQUIRE(standardError == 0.0);
+  REQUIRE(exact == Approx(overall).epsilon(1e-10));
+
+  REQUIRE_THROWS_AS(SilhouetteScore::ApproximateOverall(X, labels, metric, 0,
+      standardError), std::invalid_argument);
+}
@@ -306,3 +306,97 @@ TEST_CASE("RandomPointSelectionTest", "[DBSCANTest]")
   // The number of assignments returned should be the same as points.
   REQUIRE(assignments.n_elem == points.n_cols);
 }
+
+/**
+ * Check that merging components during the range search gives the same
+ * clusters as the batch search.
+ */
+TEST_CASE("FusedModeTest", "[DBSCANTest]")
+{
+  arma::mat points(3, 300);
+
+  GaussianDistribution g1(3), g2(3), g3(3);
+  g1.Mean() = arma::vec("0.0 0.0 0.0");
+  g2.Mean() = arma::vec("6.0 6.0 8.0");
+  g3.Mean() = arma::vec("-6.0 1.0 -7.0");
+  for (size_t i = 0; i < 100; ++i)
+    points.col(i) = g1.Random();
+  for (size_t i = 100; i < 200; ++i)
+    points.col(i) = g2.Random();
+  for (size_t i = 200; i < 300; ++i)
+    points.col(i) = g3.Random();
+
+  DBSCAN<> batch(1.0, 3);
+  DBSCAN<> fused(1.0, 3, true, RangeSearch<>(), OrderedPointSelection(),
+      true);
+
+  arma::Row<size_t> batchAssignments, fusedAssignments;
+  const size_t batchClusters = batch.Cluster(points, batchAssignments);
+  const size_t fusedClusters = fused.Cluster(points, fusedAssignments);
+
+  REQUIRE(fusedClusters == batchClusters);
+  REQUIRE(fusedAssignments.n_elem == points.n_cols);
+
+  // The cluster labels may be permuted, so check that the two clusterings
+  // agree on whether each pair of points is in the same cluster.
+  for (size_t i = 0; i < points.n_cols; ++i)
+  {
+    REQUIRE((fusedAssignments[i] == SIZE_MAX) ==
+        (batchAssignments[i] == SIZE_MAX));
+    for (size_t j = i + 1; j < points.n_cols; ++j)
+    {
+      REQUIRE((fusedAssignments[i] == fusedAssignments[j]) ==
+          (batchAssignments[i] == batchAssignments[j]));
+    }
+  }
+}
+
+/**
+ * Check that clustering with several threads gives the same clusters as the
+ * single-threaded batch search, with both dual-tree and single-tree search.
+ */
+TEST_CASE("ParallelClusterTest", "[DBSCANTest]")
+{
+  arma::mat points(3, 300);
+
+  GaussianDistribution g1(3), g2(3), g3(3);
+  g1.Mean() = arma::vec("0.0 0.0 0.0");
+  g2.Mean() = arma::vec("6.0 6.0 8.0");
+  g3.Mean() = arma::vec("-6.0 1.0 -7.0");
+  for (size_t i = 0; i < 100; ++i)
+    points.col(i) = g1.Random();
+  for (size_t i = 100; i < 200; ++i)
+    points.col(i) = g2.Random();
+  for (size_t i = 200; i < 300; ++i)
+    points.col(i) = g3.Random();
+
+  DBSCAN<> serial(1.0, 3);
+  arma::Row<size_t> serialAssignments;
+  const size_t serialClusters = serial.Cluster(points, serialAssignments);
+
+  for (size_t singleMode = 0; singleMode < 2; ++singleMode)
+  {
+    DBSCAN<> parallel(1.0, 3, true, RangeSearch<>(false, singleMode == 1));
+    parallel.NumThreads() = 4;
+
+    arma::Row<size_t> parallelAssignments;
+    const size_t parallelClusters = parallel.Cluster(points,
+        parallelAssignments);
+
+    REQUIRE(parallelClusters == serialClusters);
+    REQUIRE(parallelAssignments.n_elem == points.n_cols);
+
+    // The cluster labels may be permuted, so check that the two clusterings
+    // agree on whether each pair of points is in the same cluster.
+    for (size_t i = 0; i < points.n_cols; ++i)
+    {
+      REQUIRE((parallelAssignments[i] == SIZE_MAX) ==
+          (serialAssignments[i] == SIZE_MAX));
+      for (size_t j = i + 1; j < points.n_cols; ++j)
+      {
+        REQUIRE((parallelAssignments[i] == parallelAssignments[j]) ==
+            (serialAssignments[i] == serialAssignments[j]));
+      }
+    }
+  }
+}
@@ -419,3 +419,45 @@ TEST_CASE("DecisionStumpTrainReturnEntropy", "[DecisionStumpTest]")
 
   REQUIRE(std::isfinite(gain) == true);
 }
+
+/**
+ * Make sure that a decision stump trained with the sort of each dimension
+ * computed by SortDimensions() is the same as one trained from scratch.
+ */
+TEST_CASE("DecisionStumpSortedIndicesTest", "[DecisionStumpTest]")
+{
+  const size_t numClasses = 3;
+
+  arma::mat trainingData = arma::randu<arma::mat>(4, 200);
+  // Add some repeated values, and a dimension with identical values.
+  trainingData.row(1) = arma::floor(5 * trainingData.row(1));
+  trainingData.row(3).fill(2.0);
+  arma::Row<size_t> labels(200);
+  for (size_t i = 0; i < 200; ++i)
+  {
+    labels[i] = (trainingData(0, i) > 0.6) ? 2 :
+        (size_t) trainingData(1, i) % 2;
+  }
+
+  DecisionStump<> other(trainingData, labels, numClasses, 5);
+
+  arma::umat sortedIndices;
+  DecisionStump<>::SortDimensions(trainingData, sortedIndices);
+  REQUIRE(sortedIndices.n_rows == 200);
+  REQUIRE(sortedIndices.n_cols == 4);
+
+  // Train with a few different sets of weights, as in boosting.
+  for (size_t trial = 0; trial < 3; ++trial)
+  {
+    const arma::rowvec weights = arma::randu<arma::rowvec>(200);
+
+    DecisionStump<> ds(other, trainingData, labels, numClasses, weights);
+    DecisionStump<> sortedDs(other, trainingData, sortedIndices, labels,
+        numClasses, weights);
+
+    REQUIRE(ds.SplitDimension() == sortedDs.SplitDimension());
+    REQUIRE(ds.Split().n_elem == sortedDs.Split().n_elem);
+    REQUIRE(arma::accu(ds.Split() != sortedDs.Split()) == 0);
+    REQUIRE(arma::accu(ds.BinLabels() != sortedDs.BinLabels()) == 0);
+  }
+}
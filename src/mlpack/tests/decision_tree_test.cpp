@@ -11,10 +11,12 @@
  */
 #include <mlpack/core.hpp>
 #include <mlpack/methods/decision_tree/decision_tree.hpp>
+#include <mlpack/methods/decision_tree/flat_decision_tree.hpp>
 #include <mlpack/methods/decision_tree/information_gain.hpp>
 #include <mlpack/methods/decision_tree/gini_gain.hpp>
 #include <mlpack/methods/decision_tree/random_dimension_select.hpp>
 #include <mlpack/methods/decision_tree/multiple_random_dimension_select.hpp>
+#include <mlpack/methods/decision_tree/quickscorer.hpp>
 
 #include "catch.hpp"
 #include "serialization.hpp"
@@ -376,6 +378,211 @@ TEST_CASE("BestBinaryNumericSplitNoGainTest", "[DecisionTreeTest]")
   REQUIRE(classProbabilities.n_elem == 0);
 }
 
+/**
+ * Check that the HistogramNumericSplit finds the obvious split.
+ */
+TEST_CASE("HistogramNumericSplitSimpleSplitTest", "[DecisionTreeTest]")
+{
+  arma::vec values("0.0 0.1 0.2 0.3 0.4 0.5 0.6 0.7 0.8 0.9 1.0");
+  arma::Row<size_t> labels("0 0 0 0 0 1 1 1 1 1 1");
+  arma::rowvec weights(labels.n_elem);
+  weights.ones();
+
+  arma::vec classProbabilities;
+  HistogramNumericSplit<GiniGain>::template AuxiliarySplitInfo<double> aux;
+
+  const double bestGain = GiniGain::Evaluate<false>(labels, 2, weights);
+  const double gain = HistogramNumericSplit<GiniGain>::SplitIfBetter<false>(
+      bestGain, values, labels, 2, weights, 3, 1e-7, classProbabilities,
+      aux);
+  const double weightedGain =
+      HistogramNumericSplit<GiniGain>::SplitIfBetter<true>(bestGain, values,
+      labels, 2, weights, 3, 1e-7, classProbabilities, aux);
+
+  REQUIRE(gain > bestGain);
+  REQUIRE(gain == weightedGain);
+  REQUIRE(gain == Approx(0.0).margin(1e-7));
+
+  REQUIRE(classProbabilities.n_elem == 1);
+  REQUIRE(classProbabilities[0] > 0.4);
+  REQUIRE(classProbabilities[0] < 0.5);
+
+  // With too few points there is no split.
+  classProbabilities.clear();
+  REQUIRE(HistogramNumericSplit<GiniGain>::SplitIfBetter<false>(bestGain,
+      values, labels, 2, weights, 8, 1e-7, classProbabilities, aux) ==
+      DBL_MAX);
+  REQUIRE(classProbabilities.n_elem == 0);
+}
+
+/**
+ * When there are fewer distinct values than bins, the HistogramNumericSplit
+ * finds the same split as the BestBinaryNumericSplit.
+ */
+TEST_CASE("HistogramNumericSplitFewValuesTest", "[DecisionTreeTest]")
+{
+  arma::vec values(1000);
+  arma::Row<size_t> labels(1000);
+  arma::rowvec weights(1000);
+  for (size_t i = 0; i < 1000; ++i)
+  {
+    values[i] = (double) math::RandInt(100);
+    labels[i] = (values[i] + math::RandInt(30) > 60) ? 1 : 0;
+    weights[i] = math::Random(0.5, 1.5);
+  }
+
+  arma::vec exactSplit, histogramSplit;
+  BestBinaryNumericSplit<GiniGain>::template AuxiliarySplitInfo<double>
+      exactAux;
+  HistogramNumericSplit<GiniGain>::template AuxiliarySplitInfo<double>
+      histogramAux;
+
+  const double bestGain = GiniGain::Evaluate<false>(labels, 2, weights);
+  const double exactGain =
+      BestBinaryNumericSplit<GiniGain>::SplitIfBetter<false>(bestGain, values,
+      labels, 2, weights, 5, 1e-7, exactSplit, exactAux);
+  const double histogramGain =
+      HistogramNumericSplit<GiniGain>::SplitIfBetter<false>(bestGain, values,
+      labels, 2, weights, 5, 1e-7, histogramSplit, histogramAux);
+
+  REQUIRE(histogramGain == Approx(exactGain).epsilon(1e-10));
+  REQUIRE(histogramSplit.n_elem == 1);
+  REQUIRE(histogramSplit[0] == Approx(exactSplit[0]).epsilon(1e-10));
+
+  // The same holds with weights.
+  const double bestWeightedGain = GiniGain::Evaluate<true>(labels, 2,
+      weights);
+  const double exactWeightedGain =
+      BestBinaryNumericSplit<GiniGain>::SplitIfBetter<true>(bestWeightedGain,
+      values, labels, 2, weights, 5, 1e-7, exactSplit, exactAux);
+  const double histogramWeightedGain =
+      HistogramNumericSplit<GiniGain>::SplitIfBetter<true>(bestWeightedGain,
+      values, labels, 2, weights, 5, 1e-7, histogramSplit, histogramAux);
+
+  REQUIRE(histogramWeightedGain == Approx(exactWeightedGain).epsilon(1e-10));
+  REQUIRE(histogramSplit[0] == Approx(exactSplit[0]).epsilon(1e-10));
+}
+
+/**
+ * With many distinct values, the HistogramNumericSplit finds a split close to
+ * the best one.
+ */
+TEST_CASE("HistogramNumericSplitManyValuesTest", "[DecisionTreeTest]")
+{
+  arma::vec values(20000, arma::fill::randu);
+  arma::Row<size_t> labels(20000);
+  for (size_t i = 0; i < values.n_elem; ++i)
+    labels[i] = (values[i] > 0.37) ? 1 : 0;
+  arma::rowvec weights;
+
+  arma::vec classProbabilities;
+  HistogramNumericSplit<GiniGain>::template AuxiliarySplitInfo<double> aux;
+
+  const double bestGain = GiniGain::Evaluate<false>(labels, 2, weights);
+  const double gain = HistogramNumericSplit<GiniGain>::SplitIfBetter<false>(
+      bestGain, values, labels, 2, weights, 10, 1e-7, classProbabilities,
+      aux);
+
+  REQUIRE(gain > bestGain);
+  REQUIRE(gain > -0.02);
+  REQUIRE(classProbabilities.n_elem == 1);
+  REQUIRE(classProbabilities[0] == Approx(0.37).margin(0.01));
+}
+
+/**
+ * Check that HistogramBins puts each value in the first bin whose boundary it
+ * does not exceed, and numbers the bins of all dimensions one after the other.
+ */
+TEST_CASE("HistogramBinsTest", "[DecisionTreeTest]")
+{
+  arma::mat data(3, 1000, arma::fill::randu);
+  data.row(1) = arma::floor(10 * data.row(1));
+  data.row(2).fill(4.0);
+
+  // Take the boundaries from the first half of the points only.
+  const arma::uvec indices = arma::regspace<arma::uvec>(0, 499);
+  HistogramBins<> bins(data, indices);
+
+  REQUIRE(bins.Dimensionality() == 3);
+  REQUIRE(bins.NumPoints() == 1000);
+  REQUIRE(bins.Offset(0) == 0);
+  for (size_t d = 0; d < 3; ++d)
+  {
+    const arma::vec& boundaries = bins.Boundaries(d);
+    REQUIRE(boundaries.n_elem < HistogramNumericSplit<GiniGain>::MaxBins);
+    REQUIRE(bins.Offset(d + 1) == bins.Offset(d) + boundaries.n_elem + 1);
+
+    for (size_t i = 0; i < data.n_cols; ++i)
+    {
+      const size_t bin = bins.Codes(d)[i];
+      REQUIRE(bin <= boundaries.n_elem);
+      if (bin < boundaries.n_elem)
+        REQUIRE(data(d, i) <= boundaries[bin]);
+      if (bin > 0)
+        REQUIRE(data(d, i) > boundaries[bin - 1]);
+    }
+  }
+  REQUIRE(bins.NumBins() == bins.Offset(3));
+
+  // Each of the ten values of the second dimension has its own bin.
+  REQUIRE(bins.Boundaries(1).n_elem == 9);
+}
+
+/**
+ * The HistogramNumericSplit finds the same split from the histogram of the
+ * values as from the values themselves, and puts it at a bin boundary.
+ */
+TEST_CASE("HistogramNumericSplitBinnedTest", "[DecisionTreeTest]")
+{
+  arma::mat data(1, 5000, arma::fill::randu);
+  arma::Row<size_t> labels(5000);
+  for (size_t i = 0; i < data.n_cols; ++i)
+    labels[i] = (data[i] > 0.6) ? 1 : ((data[i] > 0.2) ? 2 : 0);
+  arma::rowvec weights(data.n_cols, arma::fill::randu);
+
+  HistogramBins<> bins(data, arma::regspace<arma::uvec>(0, 4999));
+  const size_t numBins = bins.NumBins();
+  arma::Mat<size_t> binCounts(3, numBins, arma::fill::zeros);
+  arma::mat binWeights(3, numBins, arma::fill::zeros);
+  for (size_t i = 0; i < data.n_cols; ++i)
+  {
+    ++binCounts(labels[i], bins.Codes(0)[i]);
+    binWeights(labels[i], bins.Codes(0)[i]) += weights[i];
+  }
+
+  HistogramNumericSplit<GiniGain>::template AuxiliarySplitInfo<double> aux;
+  const arma::vec values = arma::trans(data.row(0));
+  for (size_t w = 0; w < 2; ++w)
+  {
+    const double bestGain = (w == 0) ?
+        GiniGain::Evaluate<false>(labels, 3, weights) :
+        GiniGain::Evaluate<true>(labels, 3, weights);
+
+    arma::vec valueSplit, binnedSplit;
+    const double gain = (w == 0) ?
+        HistogramNumericSplit<GiniGain>::SplitIfBetter<false>(bestGain, values,
+        labels, 3, weights, 10, 1e-7, valueSplit, aux) :
+        HistogramNumericSplit<GiniGain>::SplitIfBetter<true>(bestGain, values,
+        labels, 3, weights, 10, 1e-7, valueSplit, aux);
+    const double binnedGain = (w == 0) ?
+        HistogramNumericSplit<GiniGain>::SplitIfBetter<false>(bestGain,
+        binCounts, binWeights, bins.Boundaries(0), 10, 1e-7, binnedSplit,
+        aux) :
+        HistogramNumericSplit<GiniGain>::SplitIfBetter<true>(bestGain,
+        binCounts, binWeights, bins.Boundaries(0), 10, 1e-7, binnedSplit,
+        aux);
+
+    REQUIRE(gain > bestGain);
+    REQUIRE(binnedGain == Approx(gain).epsilon(1e-10));
+    REQUIRE(binnedSplit.n_elem == 1);
+    REQUIRE(arma::any(bins.Boundaries(0) == binnedSplit[0]));
+
+    // Both splits send the same points to the left.
+    for (size_t i = 0; i < data.n_cols; ++i)
+      REQUIRE((data[i] <= valueSplit[0]) == (data[i] <= binnedSplit[0]));
+  }
+}
+
 /**
  * Check that the AllCategoricalSplit will split when the split is obviously
  * better.
@@ -701,6 +908,92 @@ TEST_CASE("SimpleGeneralizationTest", "[DecisionTreeTest]")
   REQUIRE(wdcorrect > 0.75);
 }
 
+/**
+ * Make sure that a decision tree built with histogram splits generalizes.
+ */
+TEST_CASE("HistogramSplitGeneralizationTest", "[DecisionTreeTest]")
+{
+  arma::mat inputData;
+  if (!data::Load("vc2.csv", inputData))
+    FAIL("Cannot load test dataset vc2.csv!");
+
+  arma::Row<size_t> labels;
+  if (!data::Load("vc2_labels.txt", labels))
+    FAIL("Cannot load labels for vc2_labels.txt");
+
+  DecisionTree<GiniGain, HistogramNumericSplit> d(inputData, labels, 3, 10);
+
+  arma::mat testData;
+  if (!data::Load("vc2_test.csv", testData))
+    FAIL("Cannot load test dataset vc2_test.csv!");
+
+  arma::Mat<size_t> trueTestLabels;
+  if (!data::Load("vc2_test_labels.txt", trueTestLabels))
+    FAIL("Cannot load labels for vc2_test_labels.txt");
+
+  arma::Row<size_t> predictions;
+  d.Classify(testData, predictions);
+  REQUIRE(predictions.n_elem == testData.n_cols);
+
+  double correct = 0.0;
+  for (size_t i = 0; i < predictions.n_elem; ++i)
+    if (predictions[i] == trueTestLabels[i])
+      ++correct;
+  correct /= predictions.n_elem;
+
+  REQUIRE(correct > 0.75);
+}
+
+/**
+ * A decision tree with histogram splits trained on bins computed beforehand
+ * is the same as one that bins the data itself, and unit weights give the
+ * same tree as no weights.
+ */
+TEST_CASE("HistogramSplitBinnedTrainingTest", "[DecisionTreeTest]")
+{
+  arma::mat inputData;
+  if (!data::Load("vc2.csv", inputData))
+    FAIL("Cannot load test dataset vc2.csv!");
+
+  arma::Row<size_t> labels;
+  if (!data::Load("vc2_labels.txt", labels))
+    FAIL("Cannot load labels for vc2_labels.txt");
+
+  arma::mat testData;
+  if (!data::Load("vc2_test.csv", testData))
+    FAIL("Cannot load test dataset vc2_test.csv!");
+
+  // Train on every other point, with bins taken from those points only.
+  const arma::uvec indices = arma::regspace<arma::uvec>(0, 2,
+      inputData.n_cols - 1);
+  const arma::rowvec weights(inputData.n_cols, arma::fill::ones);
+  HistogramBins<> bins(inputData, indices);
+
+  DecisionTree<GiniGain, HistogramNumericSplit> d, binned, weighted;
+  d.Train(inputData, indices, labels, 3, 2);
+  binned.Train(inputData, indices, bins, labels, 3, 2);
+  weighted.Train(inputData, indices, bins, labels, 3, weights, 2);
+  REQUIRE(d.NumChildren() == 2);
+
+  arma::Row<size_t> predictions, binnedPredictions, weightedPredictions;
+  arma::mat probabilities, binnedProbabilities, weightedProbabilities;
+  d.Classify(testData, predictions, probabilities);
+  binned.Classify(testData, binnedPredictions, binnedProbabilities);
+  weighted.Classify(testData, weightedPredictions, weightedProbabilities);
+
+  REQUIRE(arma::all(predictions == binnedPredictions));
+  REQUIRE(arma::all(predictions == weightedPredictions));
+  REQUIRE(arma::approx_equal(probabilities, binnedProbabilities, "absdiff",
+      1e-12));
+  REQUIRE(arma::approx_equal(probabilities, weightedProbabilities, "absdiff",
+      1e-12));
+
+  // The bins must match the data.
+  HistogramBins<> otherBins(testData, arma::regspace<arma::uvec>(0, 9));
+  REQUIRE_THROWS_AS(binned.Train(inputData, indices, otherBins, labels, 3),
+      std::invalid_argument);
+}
+
 /**
  * Test that we can build a decision tree on a simple categorical dataset.
  */
@@ -1251,3 +1544,214 @@ TEST_CASE("DifferentMaximumDepthTest", "[DecisionTreeTest]")
   REQUIRE(d2.Child(0).NumChildren() == 2);
   REQUIRE(d2.Child(1).NumChildren() == 2);
 }
+
+/**
+ * Make sure that the FlatDecisionTree makes the same predictions as the
+ * DecisionTree it was built from, on numeric and categorical data.
+ */
+TEST_CASE("FlatDecisionTreeTest", "[DecisionTreeTest]")
+{
+  arma::mat dataset;
+  arma::Row<size_t> labels;
+  if (!data::Load("vc2.csv", dataset))
+    FAIL("Cannot load test dataset vc2.csv!");
+  if (!data::Load("vc2_labels.txt", labels))
+    FAIL("Cannot load labels for vc2_labels.txt");
+
+  arma::mat d;
+  arma::Row<size_t> l;
+  data::DatasetInfo di;
+  MockCategoricalData(d, l, di);
+
+  DecisionTree<> numericTree(dataset, labels, 3, 5);
+  DecisionTree<> categoricalTree(d, di, l, 5, 10);
+
+  const DecisionTree<>* trees[2] = { &numericTree, &categoricalTree };
+  const arma::mat* points[2] = { &dataset, &d };
+  for (size_t k = 0; k < 2; ++k)
+  {
+    const DecisionTree<>& tree = *trees[k];
+    FlatDecisionTree<DecisionTree<>> flatTree(tree);
+    REQUIRE(flatTree.NumLeaves() > 1);
+    REQUIRE(flatTree.NumNodes() > flatTree.NumLeaves());
+
+    arma::Row<size_t> predictions, flatPredictions;
+    arma::mat probabilities, flatProbabilities;
+    tree.Classify(*points[k], predictions, probabilities);
+    flatTree.Classify(*points[k], flatPredictions, flatProbabilities);
+
+    REQUIRE(flatPredictions.n_elem == points[k]->n_cols);
+    REQUIRE(flatProbabilities.n_rows == probabilities.n_rows);
+    REQUIRE(flatProbabilities.n_cols == probabilities.n_cols);
+    for (size_t i = 0; i < points[k]->n_cols; ++i)
+    {
+      REQUIRE(flatPredictions[i] == predictions[i]);
+      REQUIRE(flatTree.Classify(points[k]->col(i)) == predictions[i]);
+      for (size_t j = 0; j < probabilities.n_rows; ++j)
+        REQUIRE(flatProbabilities(j, i) == probabilities(j, i));
+    }
+  }
+}
+
+/**
+ * Make sure that the QuickScorer makes the same predictions as the numeric
+ * DecisionTree it was built from, and that it rejects categorical trees.
+ */
+TEST_CASE("QuickScorerTest", "[DecisionTreeTest]")
+{
+  // A tree grown fully on random labels has many more leaves than fit in one
+  // word of the bitvectors.
+  arma::mat dataset(4, 1000, arma::fill::randu);
+  arma::Row<size_t> labels =
+      arma::randi<arma::Row<size_t>>(1000, arma::distr_param(0, 2));
+
+  DecisionTree<> tree(dataset, labels, 3, 1);
+  QuickScorer scorer(tree);
+  REQUIRE(scorer.NumTrees() == 1);
+  REQUIRE(scorer.NumLeaves() > 64);
+  REQUIRE(scorer.NumNodes() == scorer.NumLeaves() - 1);
+  REQUIRE(scorer.NumClasses() == 3);
+
+  arma::Row<size_t> predictions, scorerPredictions;
+  arma::mat probabilities, scorerProbabilities;
+  tree.Classify(dataset, predictions, probabilities);
+  scorer.Classify(dataset, scorerPredictions, scorerProbabilities);
+
+  REQUIRE(scorerPredictions.n_elem == dataset.n_cols);
+  REQUIRE(scorerProbabilities.n_rows == probabilities.n_rows);
+  REQUIRE(scorerProbabilities.n_cols == probabilities.n_cols);
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+  {
+    REQUIRE(scorerPredictions[i] == predictions[i]);
+    REQUIRE(scorer.Classify(dataset.col(i)) == predictions[i]);
+    for (size_t j = 0; j < probabilities.n_rows; ++j)
+    {
+      REQUIRE(scorerProbabilities(j, i) ==
+          Approx(probabilities(j, i)).epsilon(1e-7).margin(1e-10));
+    }
+  }
+
+  // A tree with categorical splits can't be added, and the scorer is left
+  // unchanged.
+  arma::mat d;
+  arma::Row<size_t> l;
+  data::DatasetInfo di;
+  MockCategoricalData(d, l, di);
+  DecisionTree<> categoricalTree(d, di, l, 5, 10);
+  REQUIRE_THROWS_AS(QuickScorer(categoricalTree), std::invalid_argument);
+
+  const size_t numNodes = scorer.NumNodes();
+  REQUIRE_THROWS_AS(scorer.AddTree(categoricalTree), std::invalid_argument);
+  REQUIRE(scorer.NumTrees() == 1);
+  REQUIRE(scorer.NumNodes() == numNodes);
+  REQUIRE(scorer.Classify(dataset.col(0)) == predictions[0]);
+}
+
+/**
+ * Training nodes in parallel must give the same trees as training them
+ * serially.
+ */
+TEST_CASE("ParallelTrainDecisionTreeTest", "[DecisionTreeTest]")
+{
+  arma::mat dataset;
+  arma::Row<size_t> labels;
+  if (!data::Load("vc2.csv", dataset))
+    FAIL("Cannot load test dataset vc2.csv!");
+  if (!data::Load("vc2_labels.txt", labels))
+    FAIL("Cannot load labels for vc2_labels.txt");
+
+  arma::mat d;
+  arma::Row<size_t> l;
+  data::DatasetInfo di;
+  MockCategoricalData(d, l, di);
+
+  const size_t oldThreshold = DecisionTree<>::ParallelTrainThreshold();
+  DecisionTree<>::ParallelTrainThreshold() = std::max(dataset.n_cols,
+      d.n_cols) + 1;
+  DecisionTree<> numericTree(dataset, labels, 3, 5);
+  DecisionTree<> categoricalTree(d, di, l, 5, 10);
+
+  // Now every node is trained in parallel.
+  DecisionTree<>::ParallelTrainThreshold() = 0;
+  DecisionTree<> parallelNumericTree(dataset, labels, 3, 5);
+  DecisionTree<> parallelCategoricalTree(d, di, l, 5, 10);
+  DecisionTree<>::ParallelTrainThreshold() = oldThreshold;
+
+  arma::Row<size_t> predictions, parallelPredictions;
+  arma::mat probabilities, parallelProbabilities;
+  numericTree.Classify(dataset, predictions, probabilities);
+  parallelNumericTree.Classify(dataset, parallelPredictions,
+      parallelProbabilities);
+  REQUIRE(arma::accu(predictions != parallelPredictions) == 0);
+  REQUIRE(arma::approx_equal(probabilities, parallelProbabilities, "absdiff",
+      1e-10));
+
+  categoricalTree.Classify(d, predictions, probabilities);
+  parallelCategoricalTree.Classify(d, parallelPredictions,
+      parallelProbabilities);
+  REQUIRE(arma::accu(predictions != parallelPredictions) == 0);
+  REQUIRE(arma::approx_equal(probabilities, parallelProbabilities, "absdiff",
+      1e-10));
+}
+
+/**
+ * Training on indices into a dataset must give the same tree as training on a
+ * copy of the selected points.
+ */
+TEST_CASE("DecisionTreeIndexTrainTest", "[DecisionTreeTest]")
+{
+  arma::mat d;
+  arma::Row<size_t> l;
+  data::DatasetInfo di;
+  MockCategoricalData(d, l, di);
+
+  // Draw indices with repetitions, like a bootstrap sample.
+  arma::uvec indices = arma::randi<arma::uvec>(2000,
+      arma::distr_param(0, d.n_cols - 1));
+  arma::rowvec weights(d.n_cols, arma::fill::randu);
+
+  arma::mat sampleData = d.cols(indices);
+  arma::Row<size_t> sampleLabels = l.cols(indices);
+  arma::rowvec sampleWeights = weights.cols(indices);
+
+  DecisionTree<> tree(sampleData, di, sampleLabels, 5, 10);
+  DecisionTree<> indexTree;
+  indexTree.Train(d, indices, di, l, 5, 10);
+
+  DecisionTree<> weightedTree(sampleData, di, sampleLabels, 5, sampleWeights,
+      10);
+  DecisionTree<> weightedIndexTree;
+  weightedIndexTree.Train(d, indices, di, l, 5, weights, 10);
+
+  // The numeric-only overloads only see the two numeric dimensions.
+  arma::mat numericData = d.rows(0, 1);
+  arma::mat numericSampleData = numericData.cols(indices);
+  DecisionTree<> numericTree(numericSampleData, sampleLabels, 5, 10);
+  DecisionTree<> numericIndexTree;
+  numericIndexTree.Train(numericData, indices, l, 5, 10);
+
+  arma::Row<size_t> predictions, indexPredictions;
+  arma::mat probabilities, indexProbabilities;
+  tree.Classify(d, predictions, probabilities);
+  indexTree.Classify(d, indexPredictions, indexProbabilities);
+  REQUIRE(arma::accu(predictions != indexPredictions) == 0);
+  REQUIRE(arma::approx_equal(probabilities, indexProbabilities, "absdiff",
+      1e-10));
+
+  weightedTree.Classify(d, predictions, probabilities);
+  weightedIndexTree.Classify(d, indexPredictions, indexProbabilities);
+  REQUIRE(arma::accu(predictions != indexPredictions) == 0);
+  REQUIRE(arma::approx_equal(probabilities, indexProbabilities, "absdiff",
+      1e-10));
+
+  numericTree.Classify(numericData, predictions, probabilities);
+  numericIndexTree.Classify(numericData, indexPredictions, indexProbabilities);
+  REQUIRE(arma::accu(predictions != indexPredictions) == 0);
+  REQUIRE(arma::approx_equal(probabilities, indexProbabilities, "absdiff",
+      1e-10));
+
+  // An index past the end of the dataset is an error.
+  indices[0] = d.n_cols;
+  REQUIRE_THROWS_AS(indexTree.Train(d, indices, di, l, 5, 10),
+      std::invalid_argument);
+}
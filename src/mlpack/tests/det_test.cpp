@@ -487,6 +487,65 @@ TEST_CASE("TestFindBucket", "[DETTest]")
   delete testDTree;
 }
 
+// Check that two density estimation trees are the same.
+static void CheckSameDTree(const DTree<arma::mat>& a,
+                           const DTree<arma::mat>& b)
+{
+  REQUIRE(a.Start() == b.Start());
+  REQUIRE(a.End() == b.End());
+  REQUIRE(a.SubtreeLeaves() == b.SubtreeLeaves());
+  REQUIRE(a.LogNegError() == Approx(b.LogNegError()).epsilon(1e-12));
+  REQUIRE(a.Ratio() == Approx(b.Ratio()).epsilon(1e-12));
+  REQUIRE((a.Left() == NULL) == (b.Left() == NULL));
+  if (a.Left() != NULL)
+  {
+    REQUIRE(a.SplitDim() == b.SplitDim());
+    REQUIRE(a.SplitValue() == b.SplitValue());
+    REQUIRE(a.AlphaUpper() == Approx(b.AlphaUpper()).epsilon(1e-12));
+    CheckSameDTree(*a.Left(), *b.Left());
+    CheckSameDTree(*a.Right(), *b.Right());
+  }
+}
+
+/**
+ * Make sure that growing a tree on the indices of some of the points of a
+ * dataset, with the children grown as tasks, gives the same tree as growing it
+ * serially on a copy of those points.
+ */
+TEST_CASE("TestGrowIndices", "[DETTest]")
+{
+  const arma::mat data = arma::randu<arma::mat>(3, 1000);
+
+  // Leave out the points in [200, 400), like a cross-validation fold.
+  arma::Col<size_t> indices(800);
+  for (size_t i = 0; i < 200; ++i)
+    indices[i] = i;
+  for (size_t i = 400; i < 1000; ++i)
+    indices[i - 200] = i;
+  const arma::Col<size_t> originalIndices(indices);
+
+  arma::mat copy = data.cols(arma::conv_to<arma::uvec>::from(indices));
+  arma::Col<size_t> oldFromNew(copy.n_cols);
+  for (size_t i = 0; i < oldFromNew.n_elem; ++i)
+    oldFromNew[i] = i;
+
+  DTree<arma::mat> copyTree(copy);
+  const double copyAlpha = copyTree.Grow(copy, oldFromNew, false, 10, 5);
+
+  const size_t oldThreshold = DTree<arma::mat>::ParallelGrowThreshold();
+  DTree<arma::mat>::ParallelGrowThreshold() = 0;
+  DTree<arma::mat> indexTree(data, indices);
+  const double indexAlpha = indexTree.Grow(data, indices, false, 10, 5);
+  DTree<arma::mat>::ParallelGrowThreshold() = oldThreshold;
+
+  REQUIRE(copyAlpha == Approx(indexAlpha).epsilon(1e-12));
+  CheckSameDTree(copyTree, indexTree);
+
+  // The indices are reordered the same way the copy was.
+  for (size_t i = 0; i < indices.n_elem; ++i)
+    REQUIRE(indices[i] == originalIndices[oldFromNew[i]]);
+}
+
 // Test functions in dt_utils.hpp
 
 TEST_CASE("TestTrainer", "[DETTest]")
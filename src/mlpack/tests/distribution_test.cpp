@@ -1544,3 +1544,78 @@ TEST_CASE("DiagonalGaussianWeightedParametersReductionTest", "[DistributionTest]
     REQUIRE(d1.Covariance()(i) == Approx(d2.Covariance()(i)).epsilon(1e-7));
   }
 }
+
+/**
+ * Make sure the batch LogProbability() and Probability() overloads of each
+ * distribution agree with the probabilities of single observations.
+ */
+TEST_CASE("BatchLogProbabilityTest", "[DistributionTest]")
+{
+  arma::vec logProbabilities, probabilities;
+
+  // Discrete distribution with two dimensions.
+  std::vector<arma::vec> discreteProbabilities;
+  discreteProbabilities.push_back(arma::vec("0.1 0.4 0.5"));
+  discreteProbabilities.push_back(arma::vec("0.7 0.3"));
+  DiscreteDistribution discrete(discreteProbabilities);
+  arma::mat discreteObs(2, 100);
+  for (size_t i = 0; i < discreteObs.n_cols; ++i)
+  {
+    discreteObs(0, i) = RandInt(3);
+    discreteObs(1, i) = RandInt(2);
+  }
+
+  discrete.LogProbability(discreteObs, logProbabilities);
+  discrete.Probability(discreteObs, probabilities);
+  REQUIRE(logProbabilities.n_elem == discreteObs.n_cols);
+  REQUIRE(probabilities.n_elem == discreteObs.n_cols);
+  for (size_t i = 0; i < discreteObs.n_cols; ++i)
+  {
+    const arma::vec obs = discreteObs.col(i);
+    REQUIRE(logProbabilities[i] ==
+        Approx(discrete.LogProbability(obs)).epsilon(1e-10));
+    REQUIRE(probabilities[i] ==
+        Approx(discrete.Probability(obs)).epsilon(1e-10));
+  }
+
+  arma::mat obs(3, 100, arma::fill::randu);
+  obs += 0.1;
+
+  // Laplace distribution.
+  LaplaceDistribution laplace(arma::vec("0.5 0.2 0.7"), 1.3);
+  laplace.LogProbability(obs, logProbabilities);
+  laplace.Probability(obs, probabilities);
+  for (size_t i = 0; i < obs.n_cols; ++i)
+  {
+    const arma::vec x = obs.col(i);
+    REQUIRE(logProbabilities[i] ==
+        Approx(laplace.LogProbability(x)).epsilon(1e-10));
+    REQUIRE(probabilities[i] == Approx(laplace.Probability(x)).epsilon(1e-10));
+  }
+
+  // Diagonal Gaussian distribution.
+  DiagonalGaussianDistribution gaussian(arma::vec("0.5 0.2 0.7"),
+      arma::vec("0.3 1.2 0.8"));
+  gaussian.LogProbability(obs, logProbabilities);
+  for (size_t i = 0; i < obs.n_cols; ++i)
+  {
+    const arma::vec x = obs.col(i);
+    REQUIRE(logProbabilities[i] ==
+        Approx(gaussian.LogProbability(x)).epsilon(1e-10));
+  }
+
+  // Gamma distribution; dimensions are independent.
+  GammaDistribution gamma(arma::vec("2.0 3.1 0.7"), arma::vec("0.9 1.4 2.0"));
+  gamma.LogProbability(obs, logProbabilities);
+  gamma.Probability(obs, probabilities);
+  for (size_t i = 0; i < obs.n_cols; ++i)
+  {
+    double logProbability = 0.0;
+    for (size_t d = 0; d < obs.n_rows; ++d)
+      logProbability += gamma.LogProbability(obs(d, i), d);
+
+    REQUIRE(logProbabilities[i] == Approx(logProbability).epsilon(1e-10));
+    REQUIRE(probabilities[i] ==
+        Approx(std::exp(logProbability)).epsilon(1e-10));
+  }
+}
@@ -76,6 +76,33 @@ BOOST_AUTO_TEST_CASE(DrusillaSelectExhaustiveExactTest)
   }
 }
 
+// The exhaustive search should also be exact on float data.
+BOOST_AUTO_TEST_CASE(DrusillaSelectFloatExhaustiveExactTest)
+{
+  arma::fmat dataset = arma::randu<arma::fmat>(5, 100);
+
+  // Construct with one projection and 100 points in that projection.
+  DrusillaSelect<arma::fmat> ds(dataset, 100, 1);
+
+  arma::mat distances, distancesTrue;
+  arma::Mat<size_t> neighbors, neighborsTrue;
+
+  ds.Search(dataset, 5, neighbors, distances);
+
+  const arma::mat doubleDataset = arma::conv_to<arma::mat>::from(dataset);
+  KFN kfn(doubleDataset);
+  kfn.Search(doubleDataset, 5, neighborsTrue, distancesTrue);
+
+  BOOST_REQUIRE_EQUAL(neighborsTrue.n_cols, neighbors.n_cols);
+  BOOST_REQUIRE_EQUAL(neighborsTrue.n_rows, neighbors.n_rows);
+
+  for (size_t i = 0; i < distances.n_elem; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(neighbors[i], neighborsTrue[i]);
+    BOOST_REQUIRE_CLOSE(distances[i], distancesTrue[i], 1e-3);
+  }
+}
+
 // Test that we can call Train() after calling the constructor.
 BOOST_AUTO_TEST_CASE(RetrainTest)
 {
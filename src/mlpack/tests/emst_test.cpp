@@ -278,4 +278,48 @@ BOOST_AUTO_TEST_CASE(BallTreeTest)
   }
 }
 
+/**
+ * Make sure that computing the MST on several threads gives the same results
+ * as the serial naive computation, with and without trees.
+ */
+BOOST_AUTO_TEST_CASE(ParallelDualTreeVsNaive)
+{
+  arma::mat inputData;
+  if (!data::Load("test_data_3_1000.csv", inputData))
+    BOOST_FAIL("Cannot load test dataset test_data_3_1000.csv!");
+
+  DualTreeBoruvka<> naive(inputData, true);
+  DualTreeBoruvka<> parallelNaive(inputData, true);
+  parallelNaive.NumThreads() = 4;
+  DualTreeBoruvka<> dtb(inputData);
+  dtb.NumThreads() = 4;
+  DualTreeBoruvka<EuclideanDistance, arma::mat, StandardCoverTree>
+      ct(inputData);
+  ct.NumThreads() = 4;
+
+  arma::mat naiveResults, parallelNaiveResults, dualResults, coverResults;
+  naive.ComputeMST(naiveResults);
+  parallelNaive.ComputeMST(parallelNaiveResults);
+  dtb.ComputeMST(dualResults);
+  ct.ComputeMST(coverResults);
+
+  BOOST_REQUIRE_EQUAL(parallelNaiveResults.n_cols, naiveResults.n_cols);
+  BOOST_REQUIRE_EQUAL(dualResults.n_cols, naiveResults.n_cols);
+  BOOST_REQUIRE_EQUAL(coverResults.n_cols, naiveResults.n_cols);
+  for (size_t i = 0; i < naiveResults.n_cols; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(parallelNaiveResults(0, i), naiveResults(0, i));
+    BOOST_REQUIRE_EQUAL(parallelNaiveResults(1, i), naiveResults(1, i));
+    BOOST_REQUIRE_CLOSE(parallelNaiveResults(2, i), naiveResults(2, i), 1e-5);
+
+    BOOST_REQUIRE_EQUAL(dualResults(0, i), naiveResults(0, i));
+    BOOST_REQUIRE_EQUAL(dualResults(1, i), naiveResults(1, i));
+    BOOST_REQUIRE_CLOSE(dualResults(2, i), naiveResults(2, i), 1e-5);
+
+    BOOST_REQUIRE_EQUAL(coverResults(0, i), naiveResults(0, i));
+    BOOST_REQUIRE_EQUAL(coverResults(1, i), naiveResults(1, i));
+    BOOST_REQUIRE_CLOSE(coverResults(2, i), naiveResults(2, i), 1e-5);
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -127,6 +127,53 @@ BOOST_AUTO_TEST_CASE(DualTreeVsSingleTree)
   }
 }
 
+/**
+ * Make sure that search with several threads gives the same results as serial
+ * naive search, for every search mode.
+ */
+BOOST_AUTO_TEST_CASE(ParallelSearchVsNaive)
+{
+  arma::mat referenceData = arma::randu<arma::mat>(6, 1500);
+  arma::mat queryData = arma::randu<arma::mat>(6, 400);
+  PolynomialKernel pk(3.0, 1.0);
+
+  FastMKS<PolynomialKernel> naive(referenceData, pk, false, true);
+  arma::Mat<size_t> naiveIndices;
+  arma::mat naiveProducts;
+  naive.Search(queryData, 5, naiveIndices, naiveProducts);
+  arma::Mat<size_t> monoIndices;
+  arma::mat monoProducts;
+  naive.Search(5, monoIndices, monoProducts);
+
+  // Mode 0 is naive search, mode 1 single-tree search, and mode 2 dual-tree
+  // search.
+  for (size_t mode = 0; mode < 3; ++mode)
+  {
+    FastMKS<PolynomialKernel> f(referenceData, pk, (mode == 1), (mode == 0));
+    f.NumThreads() = 4;
+
+    arma::Mat<size_t> indices;
+    arma::mat products;
+    f.Search(queryData, 5, indices, products);
+
+    BOOST_REQUIRE_EQUAL(indices.n_rows, naiveIndices.n_rows);
+    BOOST_REQUIRE_EQUAL(indices.n_cols, naiveIndices.n_cols);
+    for (size_t i = 0; i < indices.n_elem; ++i)
+    {
+      BOOST_REQUIRE_EQUAL(indices[i], naiveIndices[i]);
+      BOOST_REQUIRE_CLOSE(products[i], naiveProducts[i], 1e-5);
+    }
+
+    // Now the monochromatic search.
+    f.Search(5, indices, products);
+    for (size_t i = 0; i < indices.n_elem; ++i)
+    {
+      BOOST_REQUIRE_EQUAL(indices[i], monoIndices[i]);
+      BOOST_REQUIRE_CLOSE(products[i], monoProducts[i], 1e-5);
+    }
+  }
+}
+
 /**
  * Test sparse FastMKS (how useful is this, I'm not sure).
  */
@@ -1130,4 +1177,87 @@ BOOST_AUTO_TEST_CASE(CopyAssignmentTest)
   }
 }
 
+/**
+ * Make sure that the self-kernels cached by IPMetric give the same distances as
+ * the uncached metric, and that points outside the cached dataset are still
+ * evaluated correctly.
+ */
+BOOST_AUTO_TEST_CASE(IPMetricSelfKernelCacheTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(5, 100);
+  arma::mat other = arma::randu<arma::mat>(5, 10);
+  PolynomialKernel pk(2.0, 1.0);
+
+  IPMetric<PolynomialKernel> metric(pk);
+  IPMetric<PolynomialKernel> cachedMetric(pk);
+  cachedMetric.CacheSelfKernels(dataset);
+
+  BOOST_REQUIRE(cachedMetric.SelfKernelsCached(dataset));
+  BOOST_REQUIRE(!cachedMetric.SelfKernelsCached(other));
+  BOOST_REQUIRE_EQUAL(cachedMetric.SelfKernels().n_elem, dataset.n_cols);
+
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+  {
+    BOOST_REQUIRE_CLOSE(cachedMetric.SelfKernel(dataset.col(i)),
+        pk.Evaluate(dataset.col(i), dataset.col(i)), 1e-5);
+
+    // Distances between points of the dataset use the cache.
+    const size_t j = (i + 1) % dataset.n_cols;
+    BOOST_REQUIRE_CLOSE(cachedMetric.Evaluate(dataset.col(i), dataset.col(j)),
+        metric.Evaluate(dataset.col(i), dataset.col(j)), 1e-5);
+
+    // Other points do not.
+    const size_t k = i % other.n_cols;
+    BOOST_REQUIRE_CLOSE(cachedMetric.Evaluate(dataset.col(i), other.col(k)),
+        metric.Evaluate(dataset.col(i), other.col(k)), 1e-5);
+    arma::vec point = dataset.col(i) + 1.0;
+    BOOST_REQUIRE_CLOSE(cachedMetric.Evaluate(point, dataset.col(j)),
+        metric.Evaluate(point, dataset.col(j)), 1e-5);
+  }
+
+  cachedMetric.ClearSelfKernels();
+  BOOST_REQUIRE(!cachedMetric.SelfKernelsCached(dataset));
+  BOOST_REQUIRE_EQUAL(cachedMetric.SelfKernels().n_elem, 0);
+}
+
+/**
+ * Make sure that the trees built with cached self-kernels, both on a dataset
+ * that is copied and on one that is moved, give the same results as naive
+ * search.
+ */
+BOOST_AUTO_TEST_CASE(CachedSelfKernelsVsNaive)
+{
+  arma::mat dataset = arma::randu<arma::mat>(5, 500);
+  PolynomialKernel pk(2.0, 1.0);
+
+  FastMKS<PolynomialKernel> naive(dataset, pk, false, true);
+  arma::Mat<size_t> naiveIndices;
+  arma::mat naiveKernels;
+  naive.Search(5, naiveIndices, naiveKernels);
+
+  FastMKS<PolynomialKernel> single(true);
+  single.Train(dataset, pk);
+  BOOST_REQUIRE(single.ReferenceTree()->Metric().SelfKernelsCached(
+      single.ReferenceTree()->Dataset()));
+
+  arma::mat datasetCopy(dataset);
+  FastMKS<PolynomialKernel> dual(false);
+  dual.Train(std::move(datasetCopy), pk);
+  BOOST_REQUIRE(dual.ReferenceTree()->Metric().SelfKernelsCached(
+      dual.ReferenceTree()->Dataset()));
+
+  arma::Mat<size_t> singleIndices, dualIndices;
+  arma::mat singleKernels, dualKernels;
+  single.Search(5, singleIndices, singleKernels);
+  dual.Search(5, dualIndices, dualKernels);
+
+  for (size_t i = 0; i < naiveIndices.n_elem; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(singleIndices[i], naiveIndices[i]);
+    BOOST_REQUIRE_EQUAL(dualIndices[i], naiveIndices[i]);
+    BOOST_REQUIRE_CLOSE(singleKernels[i], naiveKernels[i], 1e-5);
+    BOOST_REQUIRE_CLOSE(dualKernels[i], naiveKernels[i], 1e-5);
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -15,6 +15,8 @@
 #include <mlpack/methods/ann/layer/layer.hpp>
 #include <mlpack/methods/ann/loss_functions/mean_squared_error.hpp>
 #include <mlpack/methods/ann/ffn.hpp>
+#include <mlpack/methods/ann/quantized_ffn.hpp>
+#include <mlpack/methods/ann/static_ffn.hpp>
 #include <mlpack/methods/kmeans/kmeans.hpp>
 
 #include <ensmallen.hpp>
@@ -226,6 +228,288 @@ TEST_CASE("FFVanillaNetworkTest", "[FeedForwardNetworkTest]")
   TestNetwork<>(model1, dataset, labels, dataset, labels, 10, 0.2);
 }
 
+/**
+ * Make sure that a StaticFFN computes the same predictions, objective and
+ * gradient as an FFN with the same layers and parameters, and that it can be
+ * trained and copied.
+ */
+TEST_CASE("StaticFFNTest", "[FeedForwardNetworkTest]")
+{
+  // Load the dataset.
+  arma::mat trainData;
+  data::Load("thyroid_train.csv", trainData, true);
+
+  arma::mat trainLabels = trainData.row(trainData.n_rows - 1);
+  trainData.shed_row(trainData.n_rows - 1);
+
+  arma::mat testData;
+  data::Load("thyroid_test.csv", testData, true);
+
+  arma::mat testLabels = testData.row(testData.n_rows - 1);
+  testData.shed_row(testData.n_rows - 1);
+
+  typedef StaticFFN<NegativeLogLikelihood<>, RandomInitialization, Linear<>,
+      SigmoidLayer<>, Linear<>, LogSoftMax<>> StaticModelType;
+
+  FFN<NegativeLogLikelihood<> > model;
+  model.Add<Linear<> >(trainData.n_rows, 8);
+  model.Add<SigmoidLayer<> >();
+  model.Add<Linear<> >(8, 3);
+  model.Add<LogSoftMax<> >();
+  model.ResetParameters();
+
+  StaticModelType staticModel(Linear<>(trainData.n_rows, 8), SigmoidLayer<>(),
+      Linear<>(8, 3), LogSoftMax<>());
+  staticModel.ResetParameters();
+  REQUIRE(staticModel.Parameters().n_elem == model.Parameters().n_elem);
+  staticModel.Parameters() = model.Parameters();
+
+  arma::mat predictions, staticPredictions;
+  model.Predict(testData, predictions);
+  staticModel.Predict(testData, staticPredictions);
+  CheckMatrices(predictions, staticPredictions);
+
+  REQUIRE(staticModel.Evaluate(testData, testLabels) ==
+      Approx(model.Evaluate(testData, testLabels)).epsilon(1e-7));
+
+  arma::mat gradient, staticGradient;
+  model.Predictors() = trainData;
+  model.Responses() = trainLabels;
+  staticModel.Predictors() = trainData;
+  staticModel.Responses() = trainLabels;
+  const double objective = model.EvaluateWithGradient(model.Parameters(), 0,
+      gradient, 10);
+  const double staticObjective = staticModel.EvaluateWithGradient(
+      staticModel.Parameters(), 0, staticGradient, 10);
+  REQUIRE(staticObjective == Approx(objective).epsilon(1e-7));
+  CheckMatrices(gradient, staticGradient);
+
+  // Because 92% of the patients are not hyperthyroid the neural network must
+  // be significant better than 92%.
+  StaticModelType trainedModel(Linear<>(trainData.n_rows, 8), SigmoidLayer<>(),
+      Linear<>(8, 3), LogSoftMax<>());
+  TestNetwork<>(trainedModel, trainData, trainLabels, testData, testLabels, 10,
+      0.1);
+
+  // The copies must not use the memory of the original model.
+  StaticModelType* original = new StaticModelType(trainedModel);
+  arma::mat originalPredictions;
+  original->Predict(testData, originalPredictions);
+  StaticModelType copy(*original);
+  StaticModelType moved(std::move(*original));
+  delete original;
+
+  arma::mat copyPredictions, movedPredictions;
+  copy.Predict(testData, copyPredictions);
+  moved.Predict(testData, movedPredictions);
+  CheckMatrices(originalPredictions, copyPredictions);
+  CheckMatrices(originalPredictions, movedPredictions);
+}
+
+/**
+ * Make sure that a StaticFFN whose layers use arma::fmat computes the same
+ * predictions and gradient as the same network in double precision, up to the
+ * precision of a float, and that it can be trained.
+ */
+TEST_CASE("StaticFFNFloatTest", "[FeedForwardNetworkTest]")
+{
+  // Load the dataset.
+  arma::mat trainData;
+  data::Load("thyroid_train.csv", trainData, true);
+
+  arma::mat trainLabels = trainData.row(trainData.n_rows - 1);
+  trainData.shed_row(trainData.n_rows - 1);
+
+  arma::mat testData;
+  data::Load("thyroid_test.csv", testData, true);
+
+  arma::mat testLabels = testData.row(testData.n_rows - 1);
+  testData.shed_row(testData.n_rows - 1);
+
+  typedef StaticFFN<NegativeLogLikelihood<>, RandomInitialization, Linear<>,
+      SigmoidLayer<>, Linear<>, LogSoftMax<>> ModelType;
+  typedef StaticFFN<NegativeLogLikelihood<arma::fmat, arma::fmat>,
+      RandomInitialization, Linear<arma::fmat, arma::fmat>,
+      SigmoidLayer<arma::fmat, arma::fmat>, Linear<arma::fmat, arma::fmat>,
+      LogSoftMax<arma::fmat, arma::fmat>> FloatModelType;
+
+  static_assert(std::is_same<FloatModelType::MatType, arma::fmat>::value,
+      "The matrix type of the network must be the type of its layers.");
+
+  ModelType model(Linear<>(trainData.n_rows, 8), SigmoidLayer<>(),
+      Linear<>(8, 3), LogSoftMax<>());
+  model.ResetParameters();
+
+  FloatModelType floatModel(
+      Linear<arma::fmat, arma::fmat>(trainData.n_rows, 8),
+      SigmoidLayer<arma::fmat, arma::fmat>(),
+      Linear<arma::fmat, arma::fmat>(8, 3),
+      LogSoftMax<arma::fmat, arma::fmat>());
+  floatModel.ResetParameters();
+  REQUIRE(floatModel.Parameters().n_elem == model.Parameters().n_elem);
+  floatModel.Parameters() = arma::conv_to<arma::fmat>::from(
+      model.Parameters());
+
+  arma::fmat floatTrainData = arma::conv_to<arma::fmat>::from(trainData);
+  arma::fmat floatTrainLabels = arma::conv_to<arma::fmat>::from(trainLabels);
+  arma::fmat floatTestData = arma::conv_to<arma::fmat>::from(testData);
+  arma::fmat floatTestLabels = arma::conv_to<arma::fmat>::from(testLabels);
+
+  arma::mat predictions;
+  arma::fmat floatPredictions;
+  model.Predict(testData, predictions);
+  floatModel.Predict(floatTestData, floatPredictions);
+  CheckMatrices(predictions, arma::conv_to<arma::mat>::from(floatPredictions),
+      1e-2);
+
+  arma::mat gradient;
+  arma::fmat floatGradient;
+  model.Predictors() = trainData;
+  model.Responses() = trainLabels;
+  floatModel.Predictors() = floatTrainData;
+  floatModel.Responses() = floatTrainLabels;
+  const double objective = model.EvaluateWithGradient(model.Parameters(), 0,
+      gradient, 10);
+  const float floatObjective = floatModel.EvaluateWithGradient(
+      floatModel.Parameters(), 0, floatGradient, 10);
+  REQUIRE(floatObjective == Approx(objective).epsilon(1e-4));
+  CheckMatrices(gradient, arma::conv_to<arma::mat>::from(floatGradient),
+      1e-1);
+
+  // Because 92% of the patients are not hyperthyroid the neural network must
+  // be significant better than 92%.
+  FloatModelType trainedModel(
+      Linear<arma::fmat, arma::fmat>(trainData.n_rows, 8),
+      SigmoidLayer<arma::fmat, arma::fmat>(),
+      Linear<arma::fmat, arma::fmat>(8, 3),
+      LogSoftMax<arma::fmat, arma::fmat>());
+  TestNetwork<arma::fmat>(trainedModel, floatTrainData, floatTrainLabels,
+      floatTestData, floatTestLabels, 10, 0.1);
+}
+
+/**
+ * Make sure that a QuantizedLayer computes exactly the affine map when the
+ * weights and the inputs are integers in [-127, 127], so that the scales are
+ * 1 and nothing is rounded.
+ */
+TEST_CASE("QuantizedLayerExactTest", "[FeedForwardNetworkTest]")
+{
+  arma::mat filters = arma::round(arma::randu<arma::mat>(20, 5) * 200 - 100);
+  filters.row(0).fill(127);
+  arma::vec bias = arma::randu<arma::vec>(5);
+
+  arma::mat input = arma::round(arma::randu<arma::mat>(20, 7) * 200 - 100);
+  input(3, 2) = -127;
+
+  QuantizedLayer layer(filters, bias, 127.0);
+  REQUIRE(layer.InputScale() == Approx(1.0));
+  for (size_t i = 0; i < layer.OutputSize(); ++i)
+    REQUIRE(layer.WeightScales()[i] == Approx(1.0));
+
+  arma::mat output;
+  layer.Forward(input, output);
+
+  arma::mat expected = filters.t() * input;
+  expected.each_col() += bias;
+  CheckMatrices(output, expected);
+
+  // The same map applied to blocks of rows, as for Linear3D.
+  arma::mat input3d = arma::join_cols(input, -input);
+  layer.Forward(input3d, output);
+  REQUIRE(output.n_rows == 10);
+  CheckMatrices(output.rows(0, 4), expected);
+}
+
+/**
+ * Make sure that the quantized version of a Convolution layer computes its
+ * output up to the precision of the quantization.
+ */
+TEST_CASE("QuantizedConvolutionTest", "[FeedForwardNetworkTest]")
+{
+  Convolution<> conv(2, 3, 3, 3, 1, 2, 1, 0, 7, 6);
+  conv.Parameters().randn();
+  conv.Reset();
+
+  arma::mat input = arma::randu<arma::mat>(7 * 6 * 2, 4);
+  arma::mat output;
+  conv.Forward(input, output);
+
+  QuantizedLayer quantizedConv;
+  QuantizeVisitor(input, quantizedConv)(&conv);
+  REQUIRE(quantizedConv.IsConvolution());
+
+  arma::mat quantizedOutput;
+  quantizedConv.Forward(input, quantizedOutput);
+  REQUIRE(quantizedOutput.n_rows == output.n_rows);
+  REQUIRE(quantizedOutput.n_cols == output.n_cols);
+  REQUIRE(arma::abs(quantizedOutput - output).max() <=
+      0.02 * arma::abs(output).max());
+}
+
+/**
+ * Make sure that the int8 version of a trained network predicts almost the same
+ * as the network, and that it can be copied and serialized.
+ */
+TEST_CASE("QuantizedFFNTest", "[FeedForwardNetworkTest]")
+{
+  // Load the dataset.
+  arma::mat trainData;
+  data::Load("thyroid_train.csv", trainData, true);
+
+  arma::mat trainLabels = trainData.row(trainData.n_rows - 1);
+  trainData.shed_row(trainData.n_rows - 1);
+
+  arma::mat testData;
+  data::Load("thyroid_test.csv", testData, true);
+
+  arma::mat testLabels = testData.row(testData.n_rows - 1);
+  testData.shed_row(testData.n_rows - 1);
+
+  FFN<NegativeLogLikelihood<> > model;
+  model.Add<Linear<> >(trainData.n_rows, 8);
+  model.Add<SigmoidLayer<> >();
+  model.Add<Linear<> >(8, 3);
+  model.Add<LogSoftMax<> >();
+
+  ens::RMSProp opt(0.01, 32, 0.88, 1e-8, 10 * trainData.n_cols, -1);
+  model.Train(trainData, trainLabels, opt);
+
+  QuantizedFFN<> quantizedModel(model, trainData);
+  REQUIRE(quantizedModel.NumLayers() == 4);
+  REQUIRE(quantizedModel.NumQuantizedLayers() == 2);
+  REQUIRE(quantizedModel.Parameters().n_elem == 0);
+
+  arma::mat predictions, quantizedPredictions;
+  model.Predict(testData, predictions);
+  quantizedModel.Predict(testData, quantizedPredictions, 100);
+  REQUIRE(quantizedPredictions.n_rows == predictions.n_rows);
+  REQUIRE(quantizedPredictions.n_cols == predictions.n_cols);
+  REQUIRE(arma::abs(arma::exp(predictions) -
+      arma::exp(quantizedPredictions)).max() < 0.05);
+
+  // The predicted classes must almost always agree.
+  const arma::urowvec classes = arma::index_max(predictions, 0);
+  const arma::urowvec quantizedClasses = arma::index_max(
+      quantizedPredictions, 0);
+  REQUIRE(arma::accu(classes == quantizedClasses) >=
+      0.98 * testData.n_cols);
+
+  QuantizedFFN<> copy(quantizedModel);
+  QuantizedFFN<> xmlModel, textModel, binaryModel;
+  SerializeObjectAll(quantizedModel, xmlModel, textModel, binaryModel);
+
+  arma::mat copyPredictions, xmlPredictions, textPredictions,
+      binaryPredictions;
+  copy.Predict(testData, copyPredictions);
+  xmlModel.Predict(testData, xmlPredictions);
+  textModel.Predict(testData, textPredictions);
+  binaryModel.Predict(testData, binaryPredictions);
+  CheckMatrices(quantizedPredictions, copyPredictions);
+  CheckMatrices(quantizedPredictions, xmlPredictions);
+  CheckMatrices(quantizedPredictions, textPredictions);
+  CheckMatrices(quantizedPredictions, binaryPredictions);
+}
+
 TEST_CASE("ForwardBackwardTest", "[FeedForwardNetworkTest]")
 {
   arma::mat dataset;
@@ -492,6 +776,339 @@ TEST_CASE("FFNMiscTest", "[FeedForwardNetworkTest]")
   auto moveOperator = std::move(copiedModel);
 }
 
+/**
+ * Make sure that the results of the network don't change when the layers move
+ * their outputs into the arena, and when the arena grows for larger batches.
+ */
+TEST_CASE("FFNArenaTest", "[FeedForwardNetworkTest]")
+{
+  arma::mat data = arma::randu<arma::mat>(5, 23);
+  arma::mat responses = arma::randu<arma::mat>(2, 23);
+
+  FFN<MeanSquaredError<>> model;
+  model.Add<Linear<>>(5, 8);
+  model.Add<SigmoidLayer<>>();
+  model.Add<Linear<>>(8, 2);
+  model.ResetParameters();
+  model.Predictors() = data;
+  model.Responses() = responses;
+
+  // A copy of the untouched model gives the reference results.
+  FFN<MeanSquaredError<>> reference(model);
+  arma::mat referenceGradient;
+  const double referenceObjective = reference.EvaluateWithGradient(
+      reference.Parameters(), 16, referenceGradient, 7);
+  arma::mat referencePredictions;
+  reference.Predict(data, referencePredictions);
+
+  // Run batches of different sizes through the model, so that the arena is
+  // planned for single points and then grows.
+  arma::mat predictions;
+  model.Predict(data, predictions);
+  CheckMatrices(predictions, referencePredictions);
+
+  arma::mat gradient;
+  model.EvaluateWithGradient(model.Parameters(), 0, gradient, 16);
+  model.Evaluate(data, responses);
+  const double objective = model.EvaluateWithGradient(model.Parameters(), 16,
+      gradient, 7);
+  REQUIRE(objective == Approx(referenceObjective).epsilon(1e-7));
+  CheckMatrices(gradient, referenceGradient);
+
+  model.Predict(data, predictions);
+  CheckMatrices(predictions, referencePredictions);
+
+  // Adding a layer must plan the arena again.
+  model.Add<SigmoidLayer<>>();
+  reference.Add<SigmoidLayer<>>();
+  model.Predict(data, predictions);
+  model.Predict(data, predictions);
+  reference.Predict(data, referencePredictions);
+  CheckMatrices(predictions, referencePredictions);
+}
+
+/**
+ * Make sure that splitting the training batches across replicas of the network
+ * gives the objective and the gradient of the whole batch, for a loss that
+ * averages over the batch and for a loss that sums over it.
+ */
+TEST_CASE("FFNReplicasTest", "[FeedForwardNetworkTest]")
+{
+  arma::mat data = arma::randu<arma::mat>(5, 30);
+  arma::mat responses = arma::randu<arma::mat>(2, 30);
+
+  FFN<MeanSquaredError<>> model;
+  model.Add<Linear<>>(5, 8);
+  model.Add<SigmoidLayer<>>();
+  model.Add<Linear<>>(8, 2);
+  model.ResetParameters();
+  model.Predictors() = data;
+  model.Responses() = responses;
+
+  // The first pass sets the sizes of the layers before they are replicated.
+  arma::mat gradient;
+  model.EvaluateWithGradient(model.Parameters(), 0, gradient, 1);
+
+  FFN<MeanSquaredError<>> reference(model);
+  arma::mat referenceGradient;
+  const double referenceObjective = reference.EvaluateWithGradient(
+      reference.Parameters(), 3, referenceGradient, 27);
+
+  model.Replicas() = 4;
+  double objective = model.EvaluateWithGradient(model.Parameters(), 3,
+      gradient, 27);
+  REQUIRE(objective == Approx(referenceObjective).epsilon(1e-7));
+  CheckMatrices(gradient, referenceGradient);
+
+  // Once built, the replicas must follow the updates of the parameters.
+  model.Parameters() *= 0.5;
+  reference.Parameters() *= 0.5;
+  objective = model.EvaluateWithGradient(model.Parameters(), 3, gradient, 27);
+  reference.EvaluateWithGradient(reference.Parameters(), 3, referenceGradient,
+      27);
+  CheckMatrices(gradient, referenceGradient);
+
+  // More replicas than points.
+  objective = model.EvaluateWithGradient(model.Parameters(), 0, gradient, 3);
+  const double smallObjective = reference.EvaluateWithGradient(
+      reference.Parameters(), 0, referenceGradient, 3);
+  REQUIRE(objective == Approx(smallObjective).epsilon(1e-7));
+  CheckMatrices(gradient, referenceGradient);
+
+  arma::mat labels = arma::randi<arma::mat>(1, 30,
+      arma::distr_param(1, 3));
+  FFN<NegativeLogLikelihood<>> classifier;
+  classifier.Add<Linear<>>(5, 6);
+  classifier.Add<ReLULayer<>>();
+  classifier.Add<Linear<>>(6, 3);
+  classifier.Add<LogSoftMax<>>();
+  classifier.ResetParameters();
+  classifier.Predictors() = data;
+  classifier.Responses() = labels;
+  classifier.EvaluateWithGradient(classifier.Parameters(), 0, gradient, 1);
+
+  FFN<NegativeLogLikelihood<>> referenceClassifier(classifier);
+  const double referenceLoss = referenceClassifier.EvaluateWithGradient(
+      referenceClassifier.Parameters(), 0, referenceGradient, 30);
+
+  classifier.Replicas() = 3;
+  const double loss = classifier.EvaluateWithGradient(classifier.Parameters(),
+      0, gradient, 30);
+  REQUIRE(loss == Approx(referenceLoss).epsilon(1e-7));
+  CheckMatrices(gradient, referenceGradient);
+}
+
+/**
+ * Make sure that recomputing the outputs dropped by checkpointing gives the
+ * same objective and gradient as keeping all the outputs.
+ */
+TEST_CASE("FFNCheckpointTest", "[FeedForwardNetworkTest]")
+{
+  arma::mat data = arma::randu<arma::mat>(5, 40);
+  arma::mat labels = arma::randi<arma::mat>(1, 40, arma::distr_param(1, 3));
+
+  FFN<NegativeLogLikelihood<>> model;
+  model.Add<Linear<>>(5, 8);
+  model.Add<ReLULayer<>>();
+  model.Add<Linear<>>(8, 8);
+  model.Add<BatchNorm<>>(8);
+  model.Add<TanHLayer<>>();
+  model.Add<Linear<>>(8, 8);
+  model.Add<SigmoidLayer<>>();
+  model.Add<Linear<>>(8, 3);
+  model.Add<LogSoftMax<>>();
+  model.ResetParameters();
+  model.Predictors() = data;
+  model.Responses() = labels;
+
+  FFN<NegativeLogLikelihood<>> reference(model);
+  model.CheckpointInterval() = 4;
+
+  // The outputs are dropped once the arena is planned by the first pass; the
+  // batch sizes change to reallocate it.
+  const size_t batchSizes[] = { 10, 10, 25, 5, 40 };
+  arma::mat gradient, referenceGradient;
+  for (size_t i = 0; i < 5; ++i)
+  {
+    const double objective = model.EvaluateWithGradient(model.Parameters(), 0,
+        gradient, batchSizes[i]);
+    const double referenceObjective = reference.EvaluateWithGradient(
+        reference.Parameters(), 0, referenceGradient, batchSizes[i]);
+
+    REQUIRE(objective == Approx(referenceObjective).epsilon(1e-7));
+    CheckMatrices(gradient, referenceGradient);
+  }
+
+  // The replicas recompute the outputs of their parts too.
+  model.Replicas() = 2;
+  reference.Replicas() = 2;
+  model.EvaluateWithGradient(model.Parameters(), 0, gradient, 40);
+  reference.EvaluateWithGradient(reference.Parameters(), 0, referenceGradient,
+      40);
+  CheckMatrices(gradient, referenceGradient);
+
+  arma::mat predictions, referencePredictions;
+  model.Predict(data, predictions);
+  reference.Predict(data, referencePredictions);
+  CheckMatrices(predictions, referencePredictions);
+}
+
+/**
+ * Make sure that a LayerProfiler passed to Train() records every stage of
+ * every layer, and is detached afterwards.
+ */
+TEST_CASE("FFNLayerProfilerTest", "[FeedForwardNetworkTest]")
+{
+  arma::mat data = arma::randu<arma::mat>(5, 40);
+  arma::mat labels = arma::randi<arma::mat>(1, 40, arma::distr_param(1, 3));
+
+  FFN<NegativeLogLikelihood<>> model;
+  model.Add<Linear<>>(5, 8);
+  model.Add<SigmoidLayer<>>();
+  model.Add<Linear<>>(8, 3);
+  model.Add<LogSoftMax<>>();
+
+  // Two epochs of four batches.
+  ens::StandardSGD optimizer(0.01, 10, 80, -1);
+  LayerProfiler profiler;
+  model.Train(data, labels, optimizer, profiler);
+  REQUIRE(model.Profiler() == NULL);
+
+  REQUIRE(profiler.NumLayers() == 4);
+  REQUIRE(profiler.Name(0) == "linear");
+  REQUIRE(profiler.Name(1) == "sigmoid");
+  REQUIRE(profiler.Name(3) == "logsoftmax");
+  for (size_t i = 0; i < 4; ++i)
+  {
+    REQUIRE(profiler.Calls(i, LayerProfiler::FORWARD) == 8);
+    REQUIRE(profiler.Calls(i, LayerProfiler::GRADIENT) == 8);
+    REQUIRE(profiler.Calls(i, LayerProfiler::BACKWARD) == ((i == 0) ? 0 : 8));
+    REQUIRE(profiler.Time(i, LayerProfiler::FORWARD) >= 0.0);
+  }
+
+  REQUIRE(profiler.OutputMemory(0) == 8 * 10 * sizeof(double));
+  REQUIRE(profiler.DeltaMemory(2) == 8 * 10 * sizeof(double));
+  REQUIRE(profiler.OutputMemory(3) == 3 * 10 * sizeof(double));
+
+  std::ostringstream json;
+  profiler.PrintJSON(json);
+  REQUIRE(json.str().find("\"name\": \"sigmoid\"") != std::string::npos);
+
+  // A profiler can be attached by hand too; Predict() passes the points one
+  // by one.
+  profiler.Attach(model);
+  arma::mat predictions;
+  model.Predict(data, predictions);
+  profiler.Detach(model);
+  REQUIRE(profiler.Calls(0, LayerProfiler::FORWARD) == 40);
+  REQUIRE(profiler.Calls(0, LayerProfiler::GRADIENT) == 0);
+  REQUIRE(profiler.OutputMemory(3) == 3 * sizeof(double));
+}
+
+/**
+ * Make sure that a network can be trained on a dataset read in chunks by a
+ * PrefetchLoader.
+ */
+TEST_CASE("FFNPrefetchLoaderTest", "[FeedForwardNetworkTest]")
+{
+  arma::mat data = arma::randu<arma::mat>(4, 200);
+  arma::mat responses = arma::sum(data) / 4.0;
+
+  std::vector<std::string> predictorFiles, responseFiles;
+  for (size_t i = 0; i < 4; ++i)
+  {
+    predictorFiles.push_back("ffn_chunk_" + std::to_string(i) + ".csv");
+    responseFiles.push_back("ffn_chunk_resp_" + std::to_string(i) + ".csv");
+    data::Save(predictorFiles[i], arma::mat(data.cols(50 * i, 50 * i + 49)));
+    data::Save(responseFiles[i],
+        arma::mat(responses.cols(50 * i, 50 * i + 49)));
+  }
+
+  FFN<MeanSquaredError<>> model;
+  model.Add<Linear<>>(4, 8);
+  model.Add<SigmoidLayer<>>();
+  model.Add<Linear<>>(8, 1);
+  model.ResetParameters();
+  const double initialError = model.Evaluate(data, responses);
+
+  data::PrefetchLoader<data::FileChunkSource> loader(data::FileChunkSource(
+      predictorFiles, responseFiles), 2, true);
+  ens::RMSProp opt(0.01, 10, 0.88, 1e-8, 5 * 50, -1);
+  const double objective = model.Train(loader, opt, 3);
+
+  REQUIRE(std::isfinite(objective));
+  REQUIRE(model.Evaluate(data, responses) < initialError);
+
+  for (size_t i = 0; i < 4; ++i)
+  {
+    remove(predictorFiles[i].c_str());
+    remove(responseFiles[i].c_str());
+  }
+}
+
+/**
+ * Make sure that folding the BatchNorm layers and removing the Dropout layers
+ * of a network doesn't change its predictions.
+ */
+TEST_CASE("FFNOptimizeForInferenceTest", "[FeedForwardNetworkTest]")
+{
+  arma::mat data = arma::randu<arma::mat>(5, 20);
+  arma::mat responses = arma::randi<arma::mat>(1, 20,
+      arma::distr_param(1, 3));
+
+  FFN<NegativeLogLikelihood<>> model;
+  model.Add<Linear<>>(5, 8);
+  model.Add<BatchNorm<>>(8);
+  model.Add<ReLULayer<>>();
+  model.Add<Dropout<>>(0.3);
+  model.Add<Linear<>>(8, 3);
+  model.Add<LogSoftMax<>>();
+  model.ResetParameters();
+  model.Parameters().randn();
+  model.Predictors() = data;
+  model.Responses() = responses;
+
+  // A training pass moves the running mean and variance of BatchNorm.
+  arma::mat gradient;
+  model.EvaluateWithGradient(model.Parameters(), 0, gradient, 20);
+
+  arma::mat referencePredictions, predictions;
+  model.Predict(data, referencePredictions);
+  const size_t weights = model.Parameters().n_elem;
+
+  model.OptimizeForInference();
+  REQUIRE(model.Model().size() == 4);
+  REQUIRE(model.Parameters().n_elem == weights - 16);
+
+  // The second pass computes the ReLU layer in place.
+  for (size_t i = 0; i < 2; ++i)
+  {
+    model.Predict(data, predictions);
+    CheckMatrices(predictions, referencePredictions, 1e-6);
+  }
+
+  // The same for a convolution.
+  FFN<MeanSquaredError<>> convModel;
+  convModel.Add<Convolution<>>(1, 2, 3, 3, 1, 1, 0, 0, 6, 6);
+  convModel.Add<BatchNorm<>>(2);
+  convModel.Add<SigmoidLayer<>>();
+  convModel.Add<Linear<>>(2 * 4 * 4, 3);
+  convModel.ResetParameters();
+  convModel.Parameters().randn();
+  convModel.Predictors() = arma::randu<arma::mat>(36, 10);
+  convModel.Responses() = arma::randu<arma::mat>(3, 10);
+  convModel.EvaluateWithGradient(convModel.Parameters(), 0, gradient, 10);
+
+  convModel.Predict(convModel.Predictors(), referencePredictions);
+  convModel.OptimizeForInference();
+  REQUIRE(convModel.Model().size() == 3);
+  for (size_t i = 0; i < 2; ++i)
+  {
+    convModel.Predict(convModel.Predictors(), predictions);
+    CheckMatrices(predictions, referencePredictions, 1e-6);
+  }
+}
+
 /**
  * Test that serialization works ok.
  */
@@ -798,3 +1415,88 @@ TEST_CASE("RBFNetworkTest", "[FeedForwardNetworkTest]")
   // RBFN neural net with MeanSquaredError.
   TestNetwork<>(model1, dataset, labels1, dataset, labels, 10, 0.2);
 }
+
+/**
+ * Test that the const Predict() with one context per thread gives the same
+ * predictions as Predict(), and doesn't change the network.
+ */
+TEST_CASE("FFNInferenceContextPredictTest", "[FeedForwardNetworkTest]")
+{
+  arma::mat data(10, 50, arma::fill::randu);
+
+  FFN<NegativeLogLikelihood<> > model;
+  model.Add<Linear<> >(10, 8);
+  model.Add<SigmoidLayer<> >();
+  model.Add<Dropout<> >();
+  model.Add<Linear<> >(8, 3);
+  model.Add<LogSoftMax<> >();
+  model.ResetParameters();
+
+  arma::mat predictions;
+  model.Predict(data, predictions);
+  const arma::mat parameters = model.Parameters();
+
+  const FFN<NegativeLogLikelihood<> >& sharedModel = model;
+  std::vector<arma::mat> results(8);
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) results.size(); ++i)
+  {
+    InferenceContext<FFN<NegativeLogLikelihood<> > > context;
+    // Predict twice, to reuse the context.
+    sharedModel.Predict(data, results[i], context);
+    sharedModel.Predict(data, results[i], context);
+  }
+
+  for (size_t i = 0; i < results.size(); ++i)
+    CheckMatrices(results[i], predictions);
+  CheckMatrices(model.Parameters(), parameters);
+
+  // The context sees the changes of the parameters.
+  InferenceContext<FFN<NegativeLogLikelihood<> > > context;
+  model.Parameters() = parameters + 0.1;
+  arma::mat newPredictions, contextPredictions;
+  model.Predict(data, newPredictions);
+  model.Predict(data, contextPredictions, context);
+  CheckMatrices(contextPredictions, newPredictions);
+}
+
+/**
+ * Test that training and predicting with sparse predictors gives the same
+ * results as with the same predictors in a dense matrix.
+ */
+TEST_CASE("FFNSparsePredictorsTest", "[FeedForwardNetworkTest]")
+{
+  arma::sp_mat sparseData;
+  sparseData.sprandu(200, 60, 0.02);
+  const arma::mat data(sparseData);
+  const arma::mat responses(2, 60, arma::fill::randu);
+
+  FFN<MeanSquaredError<> > denseModel, sparseModel;
+  denseModel.Add<Linear<> >(200, 8);
+  denseModel.Add<SigmoidLayer<> >();
+  denseModel.Add<Linear<> >(8, 2);
+  sparseModel.Add<Linear<> >(200, 8);
+  sparseModel.Add<SigmoidLayer<> >();
+  sparseModel.Add<Linear<> >(8, 2);
+
+  // The same seed gives the same initial parameters and the same shuffles.
+  ens::StandardSGD opt(0.01, 10, 300, -1, true);
+  math::RandomSeed(3);
+  denseModel.Train(data, responses, opt);
+  math::RandomSeed(3);
+  sparseModel.Train(sparseData, responses, opt);
+
+  CheckMatrices(sparseModel.Parameters(), denseModel.Parameters());
+
+  arma::mat densePredictions, sparsePredictions;
+  denseModel.Predict(data, densePredictions);
+  sparseModel.Predict(sparseData, sparsePredictions);
+  CheckMatrices(sparsePredictions, densePredictions);
+
+  // Sparse predictors need a Linear<> first layer.
+  FFN<MeanSquaredError<> > model;
+  model.Add<SigmoidLayer<> >();
+  model.Add<Linear<> >(200, 2);
+  REQUIRE_THROWS_AS(model.Predict(sparseData, sparsePredictions),
+      std::invalid_argument);
+}
@@ -345,3 +345,69 @@ TEST_CASE("GANMemorySharingTest", "[GANNetworkTest]")
   CheckMatricesNotEqual(gan.Predictors().head_cols(trainData.n_cols),
       trainData);
 }
+
+/*
+ * Check that the single pass of the discriminator over the merged batch of real
+ * and generated points gives the loss of the two separate passes, and that no
+ * training step changes the size of the noise buffer.
+ */
+TEST_CASE("GANMergedBatchTest", "[GANNetworkTest]")
+{
+  const size_t batchSize = 4;
+  const size_t noiseDim = 2;
+
+  arma::mat trainData(1, 20);
+  trainData.imbue( [&]() { return arma::as_scalar(RandNormal(4, 0.5));});
+
+  FFN<SigmoidCrossEntropyError<> > discriminator;
+  discriminator.Add<Linear<> >(1, 6);
+  discriminator.Add<ReLULayer<> >();
+  discriminator.Add<Linear<> >(6, 1);
+
+  FFN<SigmoidCrossEntropyError<> > generator;
+  generator.Add<Linear<> >(noiseDim, 6);
+  generator.Add<SoftPlusLayer<> >();
+  generator.Add<Linear<> >(6, 1);
+
+  // A deterministic noise, so that the passes can be repeated by hand.
+  size_t counter = 0;
+  std::function<double ()> noiseFunction = [&counter]()
+      { return 0.25 * (double) (counter++ % 9) - 1.0; };
+
+  GaussianInitialization gaussian(0, 0.1);
+  GAN<FFN<SigmoidCrossEntropyError<> >,
+      GaussianInitialization,
+      std::function<double()> >
+  gan(generator, discriminator, gaussian, noiseFunction, noiseDim, batchSize,
+      1, 0, 1);
+  gan.ResetData(trainData);
+  gan.Reset();
+
+  counter = 0;
+  const double loss = gan.Evaluate(gan.Parameters(), 4, batchSize);
+
+  arma::mat noise(noiseDim, batchSize), generated, realOutput, fakeOutput;
+  counter = 0;
+  noise.imbue( [&]() { return noiseFunction(); } );
+  gan.Generator().Forward(noise, generated);
+  gan.Discriminator().Forward(arma::mat(trainData.cols(4, 4 + batchSize - 1)),
+      realOutput);
+  gan.Discriminator().Forward(generated, fakeOutput);
+
+  SigmoidCrossEntropyError<> lossFunction;
+  const double expected =
+      lossFunction.Forward(realOutput, arma::ones(1, batchSize)) +
+      lossFunction.Forward(fakeOutput, arma::zeros(1, batchSize));
+  REQUIRE(loss == Approx(expected).epsilon(1e-7));
+
+  // The training step evaluates the same objective.
+  const double* noiseMemory = gan.Generator().Predictors().memptr();
+  arma::mat gradient;
+  counter = 0;
+  const double trainLoss = gan.EvaluateWithGradient(gan.Parameters(), 4,
+      gradient, batchSize);
+  REQUIRE(trainLoss == Approx(expected).epsilon(1e-7));
+  REQUIRE(gradient.n_elem == gan.Parameters().n_elem);
+  REQUIRE(gan.Generator().Predictors().memptr() == noiseMemory);
+  REQUIRE(gan.Predictors().n_cols == trainData.n_cols + 2 * batchSize);
+}
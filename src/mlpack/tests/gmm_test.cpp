@@ -14,6 +14,8 @@
 
 #include <mlpack/methods/gmm/gmm.hpp>
 #include <mlpack/methods/gmm/diagonal_gmm.hpp>
+#include <mlpack/methods/gmm/online_em_fit.hpp>
+#include <mlpack/methods/gmm/distributed_em_fit.hpp>
 
 #include <mlpack/methods/gmm/no_constraint.hpp>
 #include <mlpack/methods/gmm/positive_definite_constraint.hpp>
@@ -22,6 +24,7 @@
 
 #include "test_catch_tools.hpp"
 #include "catch.hpp"
+#include "thread_reduction.hpp"
 
 using namespace mlpack;
 using namespace mlpack::gmm;
@@ -81,6 +84,88 @@ TEST_CASE("GMMProbabilityComponentTest", "[GMMTest]")
   REQUIRE(gmm.Probability("1.4 0", 1) == Approx(0.0067568972024).epsilon(1e-7));
 }
 
+/**
+ * Make sure that the probabilities and the labels computed for all the
+ * observations at once match the ones computed for each observation.
+ */
+TEST_CASE("GMMBatchProbabilityTest", "[GMMTest]")
+{
+  GMM gmm(2, 2);
+  gmm.Component(0) = distribution::GaussianDistribution("0 0", "1 0; 0 1");
+  gmm.Component(1) = distribution::GaussianDistribution("3 3", "2 1; 1 2");
+  gmm.Weights() = "0.3 0.7";
+
+  arma::mat observations("0 1 2 3 -1.0 1.4;"
+                         "0 1 2 3  5.3 0.0");
+
+  arma::vec probabilities, logProbabilities;
+  gmm.Probability(observations, probabilities);
+  gmm.LogProbability(observations, logProbabilities);
+  arma::Row<size_t> labels;
+  gmm.Classify(observations, labels);
+
+  REQUIRE(probabilities.n_elem == observations.n_cols);
+  REQUIRE(logProbabilities.n_elem == observations.n_cols);
+  REQUIRE(labels.n_elem == observations.n_cols);
+  for (size_t i = 0; i < observations.n_cols; ++i)
+  {
+    const arma::vec observation = observations.col(i);
+    REQUIRE(probabilities[i] ==
+        Approx(gmm.Probability(observation)).epsilon(1e-7));
+    REQUIRE(logProbabilities[i] ==
+        Approx(gmm.LogProbability(observation)).epsilon(1e-7));
+
+    const size_t expectedLabel = (gmm.LogProbability(observation, 0) >
+        gmm.LogProbability(observation, 1)) ? 0 : 1;
+    REQUIRE(labels[i] == expectedLabel);
+  }
+}
+
+/**
+ * Make sure that single-precision observations give the same probabilities and
+ * labels as the same observations in double precision, over several blocks.
+ */
+TEST_CASE("GMMFloatBatchProbabilityTest", "[GMMTest]")
+{
+  GMM gmm(3, 2);
+  gmm.Component(0) = distribution::GaussianDistribution("0 0", "1 0; 0 1");
+  gmm.Component(1) = distribution::GaussianDistribution("3 3", "2 1; 1 2");
+  gmm.Component(2) = distribution::GaussianDistribution("-2 4",
+      "1 -0.5; -0.5 3");
+  gmm.Weights() = "0.3 0.5 0.2";
+
+  arma::fmat observations = 3 * arma::randn<arma::fmat>(2, 2500);
+  const arma::mat doubleObservations =
+      arma::conv_to<arma::mat>::from(observations);
+
+  arma::fvec logProbabilities;
+  arma::vec doubleLogProbabilities;
+  gmm.LogProbability(observations, logProbabilities);
+  gmm.LogProbability(doubleObservations, doubleLogProbabilities);
+  arma::Row<size_t> labels, doubleLabels;
+  gmm.Classify(observations, labels);
+  gmm.Classify(doubleObservations, doubleLabels);
+
+  REQUIRE(logProbabilities.n_elem == observations.n_cols);
+  REQUIRE(labels.n_elem == observations.n_cols);
+  REQUIRE(doubleLogProbabilities.n_elem == observations.n_cols);
+  for (size_t i = 0; i < observations.n_cols; ++i)
+  {
+    REQUIRE(logProbabilities[i] ==
+        Approx(doubleLogProbabilities[i]).epsilon(1e-5));
+    REQUIRE(labels[i] == doubleLabels[i]);
+  }
+
+  // Check a few observations of each block against the single observation
+  // overloads.
+  for (size_t i = 0; i < observations.n_cols; i += 97)
+  {
+    const arma::vec observation = doubleObservations.col(i);
+    REQUIRE(doubleLogProbabilities[i] ==
+        Approx(gmm.LogProbability(observation)).epsilon(1e-7));
+  }
+}
+
 /**
  * Test training a model on only one Gaussian (randomly generated) in two
  * dimensions.  We will vary the dataset size from small to large.  The EM
@@ -122,6 +207,29 @@ TEST_CASE("GMMTrainEMOneGaussian", "[GMMTest]")
   }
 }
 
+/**
+ * Make sure that the E-step and the M-step give the exact mean and covariance
+ * of a single Gaussian when the observations span several blocks, the last of
+ * which is partial.
+ */
+TEST_CASE("GMMTrainEMOneGaussianSeveralBlocks", "[GMMTest]")
+{
+  arma::mat data;
+  data.randn(5, 2500);
+  data.each_col() += arma::vec("1.0 -2.0 3.0 0.5 -0.5");
+
+  GMM gmm(1, 5);
+  gmm.Train(data, 1);
+
+  arma::vec actualMean = arma::mean(data, 1);
+  arma::mat actualCovar = mlpack::math::ColumnCovariance(data,
+      1 /* biased estimator */);
+
+  REQUIRE(arma::norm(gmm.Component(0).Mean() - actualMean) < 1e-5);
+  REQUIRE(arma::norm(gmm.Component(0).Covariance() - actualCovar) < 1e-4);
+  REQUIRE(gmm.Weights()[0] == Approx(1.0).epsilon(1e-7));
+}
+
 /**
  * Test a training model on multiple Gaussians in higher dimensionality than
  * two.  We will hold the dataset size constant at 10k points.  The EM algorithm
@@ -876,6 +984,46 @@ TEST_CASE("DiagonalGMMProbabilityComponentTest", "[GMMTest]")
       Approx(8.60082772711e-05).epsilon(1e-7));
 }
 
+/**
+ * Make sure that single-precision observations give the same probabilities and
+ * labels as the same observations in double precision, over several blocks.
+ */
+TEST_CASE("DiagonalGMMFloatBatchProbabilityTest", "[GMMTest]")
+{
+  DiagonalGMM gmm(2, 2);
+  gmm.Component(0) = distribution::DiagonalGaussianDistribution("0 0", "1 1");
+  gmm.Component(1) = distribution::DiagonalGaussianDistribution("2 3", "3 2");
+  gmm.Weights() = "0.2 0.8";
+
+  arma::fmat observations = 3 * arma::randn<arma::fmat>(2, 2500);
+  const arma::mat doubleObservations =
+      arma::conv_to<arma::mat>::from(observations);
+
+  arma::fvec logProbabilities;
+  arma::vec doubleLogProbabilities;
+  gmm.LogProbability(observations, logProbabilities);
+  gmm.LogProbability(doubleObservations, doubleLogProbabilities);
+  arma::Row<size_t> labels, doubleLabels;
+  gmm.Classify(observations, labels);
+  gmm.Classify(doubleObservations, doubleLabels);
+
+  REQUIRE(logProbabilities.n_elem == observations.n_cols);
+  REQUIRE(labels.n_elem == observations.n_cols);
+  for (size_t i = 0; i < observations.n_cols; ++i)
+  {
+    REQUIRE(logProbabilities[i] ==
+        Approx(doubleLogProbabilities[i]).epsilon(1e-5));
+    REQUIRE(labels[i] == doubleLabels[i]);
+
+    const arma::vec observation = doubleObservations.col(i);
+    REQUIRE(doubleLogProbabilities[i] ==
+        Approx(gmm.LogProbability(observation)).epsilon(1e-7));
+    const size_t expectedLabel = (gmm.LogProbability(observation, 0) >
+        gmm.LogProbability(observation, 1)) ? 0 : 1;
+    REQUIRE(labels[i] == expectedLabel);
+  }
+}
+
 /**
  * Make sure we can train a model on only one Gaussian (randomly generated)
  * in two dimensions.  We will vary the dataset size from small to large.
@@ -1239,3 +1387,298 @@ TEST_CASE("DiagonalGMMLoadSaveTest", "[GMMTest]")
     }
   }
 }
+
+/**
+ * Create a shuffled dataset of two well-separated Gaussians with identity
+ * covariance, one with 3000 points centered at the origin and one with 2000
+ * points centered at (8, 8, 8).
+ */
+static void OnlineGMMData(arma::mat& data)
+{
+  data.randn(3, 5000);
+  data.cols(3000, 4999) += 8.0;
+  data = data.cols(arma::randperm(data.n_cols));
+}
+
+/**
+ * Check that the given means, covariances (as their diagonals), and weights
+ * are close to the parameters of the data created by OnlineGMMData().
+ */
+static void CheckOnlineGMMModel(const std::vector<arma::vec>& means,
+                                const std::vector<arma::vec>& diagCovs,
+                                const arma::vec& weights)
+{
+  REQUIRE(means.size() == 2);
+
+  // The Gaussians may be in either order.
+  const size_t first = (arma::accu(means[0]) < arma::accu(means[1])) ? 0 : 1;
+  const size_t second = 1 - first;
+
+  REQUIRE(arma::norm(means[first]) < 0.3);
+  REQUIRE(arma::norm(means[second] - 8.0) < 0.3);
+  REQUIRE(arma::abs(diagCovs[first] - 1.0).max() < 0.3);
+  REQUIRE(arma::abs(diagCovs[second] - 1.0).max() < 0.3);
+  REQUIRE(weights[first] == Approx(0.6).margin(0.05));
+  REQUIRE(weights[second] == Approx(0.4).margin(0.05));
+}
+
+/**
+ * A batch source that returns the columns of a matrix in order.
+ */
+class GMMBatchSource
+{
+ public:
+  GMMBatchSource(const arma::mat& data, const size_t batchSize) :
+      data(data), batchSize(batchSize), position(0) { }
+
+  bool NextBatch(arma::mat& batch)
+  {
+    if (position >= data.n_cols)
+      return false;
+
+    const size_t end = std::min(position + batchSize, (size_t) data.n_cols);
+    batch = data.cols(position, end - 1);
+    position = end;
+    return true;
+  }
+
+ private:
+  const arma::mat& data;
+  size_t batchSize;
+  size_t position;
+};
+
+/**
+ * Make sure that OnlineEMFit can be used as the fitter of GMM::Train().
+ */
+TEST_CASE("OnlineEMFitTrainTest", "[GMMTest]")
+{
+  arma::mat data;
+  OnlineGMMData(data);
+
+  GMM gmm(2, 3);
+  gmm.Train(data, 1, false, OnlineEMFit<>(250, 2));
+
+  std::vector<arma::vec> means, diagCovs;
+  for (size_t i = 0; i < 2; ++i)
+  {
+    means.push_back(gmm.Component(i).Mean());
+    diagCovs.push_back(arma::diagvec(gmm.Component(i).Covariance()));
+  }
+  CheckOnlineGMMModel(means, diagCovs, gmm.Weights());
+}
+
+/**
+ * Train a GMM from a stream of mini-batches, and then refresh it with more
+ * mini-batches of the same distribution.
+ */
+TEST_CASE("StreamingGMMTrainTest", "[GMMTest]")
+{
+  arma::mat data;
+  OnlineGMMData(data);
+
+  GMM gmm(2, 3);
+  OnlineEMFit<> fitter;
+  const arma::mat firstPart = data.cols(0, 2499);
+  const arma::mat secondPart = data.cols(2500, 4999);
+  GMMBatchSource source(firstPart, 250);
+  REQUIRE(gmm.Train(source, fitter) == 10);
+  REQUIRE(fitter.Steps() == 10);
+
+  // Now refresh the model; the fitter keeps its statistics.
+  GMMBatchSource source2(secondPart, 250);
+  REQUIRE(gmm.Train(source2, fitter, true) == 10);
+  REQUIRE(fitter.Steps() == 20);
+
+  std::vector<arma::vec> means, diagCovs;
+  for (size_t i = 0; i < 2; ++i)
+  {
+    means.push_back(gmm.Component(i).Mean());
+    diagCovs.push_back(arma::diagvec(gmm.Component(i).Covariance()));
+  }
+  CheckOnlineGMMModel(means, diagCovs, gmm.Weights());
+}
+
+/**
+ * Warm-start a DiagonalGMM trained with EM from a stream of mini-batches with
+ * a new fitter.
+ */
+TEST_CASE("StreamingDiagonalGMMWarmStartTest", "[GMMTest]")
+{
+  arma::mat data;
+  OnlineGMMData(data);
+
+  DiagonalGMM gmm(2, 3);
+  gmm.Train(data.cols(0, 999));
+
+  OnlineEMFit<kmeans::KMeans<>, DiagonalConstraint,
+      distribution::DiagonalGaussianDistribution> fitter(250);
+  const arma::mat stream = data.cols(1000, 4999);
+  GMMBatchSource source(stream, 500);
+  REQUIRE(gmm.Train(source, fitter, true) == 8);
+
+  std::vector<arma::vec> means, diagCovs;
+  for (size_t i = 0; i < 2; ++i)
+  {
+    means.push_back(gmm.Component(i).Mean());
+    diagCovs.push_back(gmm.Component(i).Covariance());
+  }
+  CheckOnlineGMMModel(means, diagCovs, gmm.Weights());
+}
+
+/**
+ * Make sure that OnlineEMFit rejects invalid parameters.
+ */
+TEST_CASE("OnlineEMFitInvalidParametersTest", "[GMMTest]")
+{
+  REQUIRE_THROWS_AS(OnlineEMFit<>(0), std::invalid_argument);
+  REQUIRE_THROWS_AS(OnlineEMFit<>(100, 1, 0.5), std::invalid_argument);
+  REQUIRE_THROWS_AS(OnlineEMFit<>(100, 1, 1.5), std::invalid_argument);
+}
+
+// Generate points from two Gaussians, and an initial model that is near them.
+void DistributedGMMData(arma::mat& data, GMM& initial)
+{
+  data.randn(2, 3000);
+  for (size_t i = 0; i < data.n_cols; i += 3)
+  {
+    data(0, i) = 2.0 * data(0, i) + 5.0;
+    data(1, i) = 0.5 * data(1, i) + 5.0;
+  }
+
+  initial = GMM(2, 2);
+  initial.Component(0) = distribution::GaussianDistribution(
+      arma::vec("0.5 0.5"), arma::eye<arma::mat>(2, 2));
+  initial.Component(1) = distribution::GaussianDistribution(
+      arma::vec("4.5 4.5"), arma::eye<arma::mat>(2, 2));
+  initial.Weights() = arma::vec("0.5 0.5");
+}
+
+// Check that the two given GMMs are the same.
+void CheckSameGMM(const GMM& a, const GMM& b, const double tolerance)
+{
+  for (size_t i = 0; i < 2; ++i)
+  {
+    REQUIRE(a.Weights()[i] == Approx(b.Weights()[i]).margin(tolerance));
+    for (size_t j = 0; j < 2; ++j)
+    {
+      REQUIRE(a.Component(i).Mean()[j] ==
+          Approx(b.Component(i).Mean()[j]).margin(tolerance));
+    }
+    for (size_t j = 0; j < 4; ++j)
+    {
+      REQUIRE(a.Component(i).Covariance()[j] ==
+          Approx(b.Component(i).Covariance()[j]).margin(tolerance));
+    }
+  }
+}
+
+/**
+ * Make sure that DistributedEMFit on a single process fits the same model as
+ * EMFit, and finds the Gaussians with its own initial clustering.
+ */
+TEST_CASE("DistributedEMFitLocalTest", "[GMMTest]")
+{
+  arma::mat data;
+  GMM initial;
+  DistributedGMMData(data, initial);
+
+  GMM gmm(initial), distributedGMM(initial);
+  gmm.Train(data, 1, true, EMFit<>(300, 1e-10));
+  distributedGMM.Train(data, 1, true, DistributedEMFit<>(300, 1e-10));
+  CheckSameGMM(gmm, distributedGMM, 1e-6);
+
+  // With the initial clustering, the Gaussians may be in any order.
+  GMM clusteredGMM(2, 2);
+  clusteredGMM.Train(data, 1, false, DistributedEMFit<>(300, 1e-10));
+  const size_t first = (clusteredGMM.Component(0).Mean()[0] <
+      clusteredGMM.Component(1).Mean()[0]) ? 0 : 1;
+  REQUIRE(arma::norm(clusteredGMM.Component(first).Mean()) < 0.2);
+  REQUIRE(arma::norm(clusteredGMM.Component(1 - first).Mean() -
+      arma::vec("5.0 5.0")) < 0.2);
+  REQUIRE(clusteredGMM.Weights()[first] == Approx(2.0 / 3.0).epsilon(0.05));
+}
+
+/**
+ * Make sure that DistributedEMFit on the shards of a dataset, with one thread
+ * standing for each process, fits the model of the whole dataset (with and
+ * without the probabilities of the points).
+ */
+TEST_CASE("DistributedEMFitShardsTest", "[GMMTest]")
+{
+  arma::mat data;
+  GMM initial;
+  DistributedGMMData(data, initial);
+  const arma::vec probabilities = 0.5 + 0.5 * arma::randu<arma::vec>(3000);
+
+  GMM gmm(initial), weightedGMM(initial);
+  gmm.Train(data, 1, true, DistributedEMFit<>(300, 1e-10));
+  weightedGMM.Train(data, probabilities, 1, true,
+      DistributedEMFit<>(300, 1e-10));
+
+  const size_t shards = 3;
+  std::vector<GMM> shardGMMs(shards, initial), weightedShardGMMs(shards,
+      initial);
+  ThreadReduction::Run(shards, [&](const size_t r)
+  {
+    const arma::uvec indices = arma::regspace<arma::uvec>(r, shards,
+        data.n_cols - 1);
+    const arma::mat shard = data.cols(indices);
+    const arma::vec shardProbabilities = probabilities.elem(indices);
+
+    DistributedEMFit<ThreadReduction> fitter(300, 1e-10);
+    shardGMMs[r].Train(shard, 1, true, fitter);
+    weightedShardGMMs[r].Train(shard, shardProbabilities, 1, true, fitter);
+  });
+
+  for (size_t r = 0; r < shards; ++r)
+  {
+    CheckSameGMM(shardGMMs[r], gmm, 1e-6);
+    CheckSameGMM(weightedShardGMMs[r], weightedGMM, 1e-6);
+  }
+}
+
+/**
+ * Make sure that the initial clustering of DistributedEMFit reduces with the
+ * reduction given to the fitter, even when it is not default-constructed.
+ */
+TEST_CASE("DistributedEMFitReductionInstanceTest", "[GMMTest]")
+{
+  arma::mat data;
+  GMM initial;
+  DistributedGMMData(data, initial);
+
+  // The default group now holds a single thread, so a clusterer reducing over
+  // it would not see the other shards.
+  ThreadReduction::Run(1, [](const size_t /* r */) { });
+
+  const size_t shards = 3;
+  std::vector<GMM> shardGMMs(shards, initial);
+  ThreadReduction::Run(shards, [&](const size_t r)
+  {
+    const arma::mat shard = data.cols(arma::regspace<arma::uvec>(r, shards,
+        data.n_cols - 1));
+
+    DistributedEMFit<ThreadReduction> fitter(300, 1e-10,
+        kmeans::DistributedKMeans<ThreadReduction>(),
+        PositiveDefiniteConstraint(), ThreadReduction(1));
+    shardGMMs[r].Train(shard, 1, false, fitter);
+  }, 1);
+
+  // Every process obtains the same model.
+  for (size_t r = 1; r < shards; ++r)
+    CheckSameGMM(shardGMMs[r], shardGMMs[0], 1e-10);
+}
+
+/**
+ * Make sure that DistributedEMFit rejects probabilities of the wrong size.
+ */
+TEST_CASE("DistributedEMFitInvalidProbabilitiesTest", "[GMMTest]")
+{
+  arma::mat data;
+  GMM initial;
+  DistributedGMMData(data, initial);
+
+  REQUIRE_THROWS_AS(initial.Train(data, arma::vec(10, arma::fill::ones), 1,
+      true, DistributedEMFit<>()), std::invalid_argument);
+}
@@ -0,0 +1,143 @@
+/**
+ * @file tests/gradient_boosting_test.cpp
+ *
+ * Tests for the GradientBoosting class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/methods/gradient_boosting/gradient_boosting.hpp>
+#include <mlpack/methods/decision_tree/multiple_random_dimension_select.hpp>
+
+#include "serialization_catch.hpp"
+#include "test_catch_tools.hpp"
+#include "catch.hpp"
+
+using namespace mlpack;
+using namespace mlpack::tree;
+
+/**
+ * Make sure that gradient boosting learns the three classes of the vc2
+ * dataset, and that the trees respect the maximum number of leaves.
+ */
+TEST_CASE("GradientBoostingMulticlassTest", "[GradientBoostingTest]")
+{
+  arma::mat dataset;
+  data::Load("vc2.csv", dataset);
+  arma::Row<size_t> labels;
+  data::Load("vc2_labels.txt", labels);
+
+  GradientBoosting<> gb;
+  const double loss = gb.Train(dataset, labels, 3, 50, 0.1, 8, 5);
+
+  REQUIRE(std::isfinite(loss));
+  REQUIRE(gb.NumClasses() == 3);
+  REQUIRE(gb.NumTrees() == 150);
+  for (size_t i = 0; i < gb.NumTrees(); ++i)
+    REQUIRE(gb.Tree(i).NumLeaves() <= 8);
+
+  arma::mat testDataset;
+  data::Load("vc2_test.csv", testDataset);
+  arma::Row<size_t> testLabels;
+  data::Load("vc2_test_labels.txt", testLabels);
+
+  arma::Row<size_t> predictions;
+  arma::mat probabilities;
+  gb.Classify(testDataset, predictions, probabilities);
+
+  REQUIRE(arma::accu(predictions == testLabels) >=
+      size_t(0.7 * testDataset.n_cols));
+  for (size_t i = 0; i < probabilities.n_cols; ++i)
+    REQUIRE(arma::accu(probabilities.col(i)) == Approx(1.0).epsilon(1e-7));
+
+  // Training should lower the loss below the loss of the priors.
+  GradientBoosting<> priors;
+  const double priorLoss = priors.Train(dataset, labels, 3, 0);
+  REQUIRE(loss < priorLoss);
+}
+
+/**
+ * Make sure that two-class problems use one tree per iteration, and that
+ * subsampling the dimensions still learns.
+ */
+TEST_CASE("GradientBoostingBinaryTest", "[GradientBoostingTest]")
+{
+  arma::mat dataset;
+  data::Load("vc2.csv", dataset);
+  arma::Row<size_t> labels;
+  data::Load("vc2_labels.txt", labels);
+  labels.transform([](const size_t l) { return (l == 0) ? 0 : 1; });
+
+  arma::mat testDataset;
+  data::Load("vc2_test.csv", testDataset);
+  arma::Row<size_t> testLabels;
+  data::Load("vc2_test_labels.txt", testLabels);
+  testLabels.transform([](const size_t l) { return (l == 0) ? 0 : 1; });
+
+  GradientBoosting<MultipleRandomDimensionSelect> gb(dataset, labels, 2, 50,
+      0.1, 8, 5, 1.0, MultipleRandomDimensionSelect(3));
+  REQUIRE(gb.NumTrees() == 50);
+
+  arma::Row<size_t> predictions;
+  gb.Classify(testDataset, predictions);
+  REQUIRE(arma::accu(predictions == testLabels) >=
+      size_t(0.7 * testDataset.n_cols));
+
+  // A single point gets the same prediction.
+  REQUIRE(gb.Classify(testDataset.col(0)) == predictions[0]);
+}
+
+/**
+ * Make sure that invalid arguments and untrained models are rejected.
+ */
+TEST_CASE("GradientBoostingInvalidTest", "[GradientBoostingTest]")
+{
+  arma::mat dataset(3, 10, arma::fill::randu);
+  arma::Row<size_t> labels(10, arma::fill::zeros);
+
+  GradientBoosting<> gb;
+  arma::Row<size_t> predictions;
+  REQUIRE_THROWS_AS(gb.Classify(dataset, predictions), std::invalid_argument);
+  REQUIRE_THROWS_AS(gb.Train(dataset, labels, 1), std::invalid_argument);
+  REQUIRE_THROWS_AS(gb.Train(dataset, labels.head(9), 2),
+      std::invalid_argument);
+
+  labels[0] = 2;
+  REQUIRE_THROWS_AS(gb.Train(dataset, labels, 2), std::invalid_argument);
+}
+
+/**
+ * Make sure we can serialize a gradient boosting model.
+ */
+TEST_CASE("GradientBoostingSerializationTest", "[GradientBoostingTest]")
+{
+  arma::mat dataset;
+  data::Load("vc2.csv", dataset);
+  arma::Row<size_t> labels;
+  data::Load("vc2_labels.txt", labels);
+
+  GradientBoosting<> gb(dataset, labels, 3, 10, 0.1, 8, 5);
+
+  arma::Row<size_t> beforePredictions;
+  arma::mat beforeProbabilities;
+  gb.Classify(dataset, beforePredictions, beforeProbabilities);
+
+  GradientBoosting<> xmlModel, textModel, binaryModel;
+  binaryModel.Train(dataset, labels, 3, 2);
+  SerializeObjectAll(gb, xmlModel, textModel, binaryModel);
+
+  arma::Row<size_t> xmlPredictions, textPredictions, binaryPredictions;
+  arma::mat xmlProbabilities, textProbabilities, binaryProbabilities;
+
+  xmlModel.Classify(dataset, xmlPredictions, xmlProbabilities);
+  textModel.Classify(dataset, textPredictions, textProbabilities);
+  binaryModel.Classify(dataset, binaryPredictions, binaryProbabilities);
+
+  CheckMatrices(beforePredictions, xmlPredictions, textPredictions,
+      binaryPredictions);
+  CheckMatrices(beforeProbabilities, xmlProbabilities, textProbabilities,
+      binaryProbabilities);
+}
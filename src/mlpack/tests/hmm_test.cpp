@@ -10,6 +10,7 @@
  */
 #include <mlpack/core.hpp>
 #include <mlpack/methods/hmm/hmm.hpp>
+#include <mlpack/methods/hmm/online_viterbi.hpp>
 #include <mlpack/methods/gmm/gmm.hpp>
 #include <mlpack/methods/gmm/diagonal_gmm.hpp>
 
@@ -528,6 +529,62 @@ TEST_CASE("DiscreteHMMLogLikelihoodTest", "[HMMTest]")
       Approx(-24.51556128368).epsilon(1e-7));
 }
 
+/**
+ * Make sure that the forward-backward algorithm gives the log-likelihood found
+ * by summing over every possible state sequence, even when the emission
+ * probabilities are far too small to be represented outside of log space.
+ */
+TEST_CASE("HMMForwardBackwardTinyEmissionsTest", "[HMMTest]")
+{
+  arma::vec initial("0.5 0.2 0.3");
+  arma::mat transition("0.5 0.0 0.1;"
+                       "0.2 0.6 0.2;"
+                       "0.3 0.4 0.7");
+  std::vector<GaussianDistribution> emission(3);
+  emission[0] = GaussianDistribution("0.0", "1.0");
+  emission[1] = GaussianDistribution("50.0", "1.0");
+  emission[2] = GaussianDistribution("100.0", "1.0");
+
+  HMM<GaussianDistribution> hmm(initial, transition, emission);
+
+  const arma::mat obs("-200.0 300.0 60.0 -150.0");
+
+  arma::mat stateLogProb, forwardLogProb, backwardLogProb;
+  arma::vec logScales;
+  const double logLikelihood = hmm.LogEstimate(obs, stateLogProb,
+      forwardLogProb, backwardLogProb, logScales);
+
+  // Sum over all 3^4 state sequences.
+  double expected = -std::numeric_limits<double>::infinity();
+  for (size_t path = 0; path < 81; ++path)
+  {
+    size_t code = path;
+    size_t previous = 0;
+    double pathLogProb = 0.0;
+    for (size_t t = 0; t < obs.n_cols; ++t)
+    {
+      const size_t state = code % 3;
+      code /= 3;
+      pathLogProb += (t == 0) ? std::log(initial[state]) :
+          std::log(transition(state, previous));
+      pathLogProb += emission[state].LogProbability(obs.col(t));
+      previous = state;
+    }
+
+    expected = math::LogAdd(expected, pathLogProb);
+  }
+
+  REQUIRE(std::isfinite(logLikelihood));
+  REQUIRE(logLikelihood == Approx(expected).epsilon(1e-10));
+
+  // The state probabilities must still sum to 1 at each time step.
+  for (size_t t = 0; t < obs.n_cols; ++t)
+  {
+    REQUIRE(arma::accu(arma::exp(stateLogProb.col(t))) ==
+        Approx(1.0).epsilon(1e-7));
+  }
+}
+
 /**
  * A simple test to make sure HMMs with Gaussian output distributions work.
  */
@@ -1258,6 +1315,189 @@ TEST_CASE("HMMTrainReturnLogLikelihood", "[HMMTest]")
   REQUIRE(std::isfinite(loglik) == true);
 }
 
+/**
+ * Make sure that Baum-Welch training gives the same model with one thread and
+ * with several threads.
+ */
+TEST_CASE("HMMTrainThreadsTest", "[HMMTest]")
+{
+  arma::vec initial("0.6 0.4");
+  arma::mat transition("0.8 0.3; 0.2 0.7");
+  std::vector<GaussianDistribution> emission(2);
+  emission[0] = GaussianDistribution("0.0 0.0", "1.0 0.0; 0.0 1.0");
+  emission[1] = GaussianDistribution("3.0 3.0", "1.0 0.5; 0.5 1.0");
+  HMM<GaussianDistribution> trueHMM(initial, transition, emission);
+
+  std::vector<arma::mat> observations(50);
+  arma::Row<size_t> states;
+  for (size_t i = 0; i < observations.size(); ++i)
+    trueHMM.Generate(20, observations[i], states);
+
+  HMM<GaussianDistribution> hmm1(2, GaussianDistribution(2));
+  hmm1.Transition() = "0.5 0.5; 0.5 0.5";
+  hmm1.Emission()[0] = GaussianDistribution("-1.0 -1.0", "2.0 0.0; 0.0 2.0");
+  hmm1.Emission()[1] = GaussianDistribution("4.0 4.0", "2.0 0.0; 0.0 2.0");
+  HMM<GaussianDistribution> hmm4(hmm1);
+
+  hmm1.NumThreads() = 1;
+  hmm4.NumThreads() = 4;
+  REQUIRE(hmm4.NumThreads() == 4);
+
+  const double loglik1 = hmm1.Train(observations);
+  const double loglik4 = hmm4.Train(observations);
+
+  REQUIRE(loglik4 == Approx(loglik1).epsilon(1e-6));
+  CheckMatrices(hmm4.Transition(), hmm1.Transition(), 1e-2);
+  for (size_t j = 0; j < 2; ++j)
+  {
+    CheckMatrices(hmm4.Emission()[j].Mean(), hmm1.Emission()[j].Mean(), 1e-2);
+    CheckMatrices(hmm4.Emission()[j].Covariance(),
+        hmm1.Emission()[j].Covariance(), 1e-2);
+  }
+}
+
+/**
+ * Build a Gaussian HMM with four states and generate a sequence from it, for
+ * the Viterbi decoding tests.
+ */
+static HMM<GaussianDistribution> ViterbiTestHMM(arma::mat& observations,
+                                                const size_t length)
+{
+  arma::vec initial("0.4 0.3 0.2 0.1");
+  arma::mat transition("0.7 0.1 0.1 0.1;"
+                       "0.1 0.7 0.1 0.2;"
+                       "0.1 0.1 0.7 0.1;"
+                       "0.1 0.1 0.1 0.6");
+  std::vector<GaussianDistribution> emission(4);
+  emission[0] = GaussianDistribution("0.0 0.0", "1.0 0.0; 0.0 1.0");
+  emission[1] = GaussianDistribution("1.5 0.0", "1.0 0.3; 0.3 1.0");
+  emission[2] = GaussianDistribution("0.0 1.5", "1.0 0.0; 0.0 2.0");
+  emission[3] = GaussianDistribution("1.5 1.5", "0.5 0.0; 0.0 0.5");
+  HMM<GaussianDistribution> hmm(initial, transition, emission);
+
+  arma::Row<size_t> states;
+  hmm.Generate(length, observations, states);
+  return hmm;
+}
+
+/**
+ * With an infinite beam, the beam-pruned Viterbi algorithm is exact.
+ */
+TEST_CASE("HMMBeamPredictInfiniteBeamTest", "[HMMTest]")
+{
+  arma::mat observations;
+  HMM<GaussianDistribution> hmm = ViterbiTestHMM(observations, 300);
+
+  arma::Row<size_t> exact, beam;
+  const double exactLogLikelihood = hmm.Predict(observations, exact);
+  const double beamLogLikelihood = hmm.Predict(observations, beam,
+      std::numeric_limits<double>::infinity());
+
+  REQUIRE(beamLogLikelihood == Approx(exactLogLikelihood).epsilon(1e-10));
+  REQUIRE(beam.n_elem == exact.n_elem);
+  for (size_t i = 0; i < exact.n_elem; ++i)
+    REQUIRE(beam[i] == exact[i]);
+
+  // A narrow beam can only find a less likely path.
+  const double narrowLogLikelihood = hmm.Predict(observations, beam, 1.0);
+  REQUIRE(beam.n_elem == exact.n_elem);
+  REQUIRE(narrowLogLikelihood <= exactLogLikelihood + 1e-8);
+}
+
+/**
+ * Pushing the observations one at a time into the decoder, without a lag, gives
+ * the exact Viterbi path.
+ */
+TEST_CASE("OnlineViterbiNoLagTest", "[HMMTest]")
+{
+  arma::mat observations;
+  HMM<GaussianDistribution> hmm = ViterbiTestHMM(observations, 200);
+
+  arma::Row<size_t> exact;
+  const double logLikelihood = hmm.Predict(observations, exact);
+
+  OnlineViterbi<GaussianDistribution> decoder(hmm);
+  arma::Row<size_t> states;
+  for (size_t t = 0; t < observations.n_cols; ++t)
+  {
+    decoder.Push(observations.col(t), states);
+    REQUIRE(states.n_elem == 0);
+  }
+
+  REQUIRE(decoder.Steps() == observations.n_cols);
+  REQUIRE(decoder.LogLikelihood() == Approx(logLikelihood).epsilon(1e-10));
+
+  decoder.Flush(states);
+  REQUIRE(decoder.Steps() == 0);
+  REQUIRE(states.n_elem == exact.n_elem);
+  for (size_t i = 0; i < exact.n_elem; ++i)
+    REQUIRE(states[i] == exact[i]);
+}
+
+/**
+ * With a lag, the states are decided while the observations are pushed, and a
+ * lag as long as the sequence gives the exact path.
+ */
+TEST_CASE("OnlineViterbiLagTest", "[HMMTest]")
+{
+  arma::mat observations;
+  HMM<GaussianDistribution> hmm = ViterbiTestHMM(observations, 200);
+
+  arma::Row<size_t> exact;
+  hmm.Predict(observations, exact);
+
+  const size_t lags[] = { 5, 200 };
+  for (const size_t lag : lags)
+  {
+    OnlineViterbi<GaussianDistribution> decoder(hmm, lag);
+    arma::Row<size_t> decided(observations.n_cols);
+    size_t count = 0;
+    arma::Row<size_t> states;
+    for (size_t begin = 0; begin < observations.n_cols; begin += 30)
+    {
+      const size_t end = std::min(begin + 30,
+          (size_t) observations.n_cols) - 1;
+      decoder.Push(observations.cols(begin, end), states);
+
+      // Every state older than the lag is decided.
+      const size_t pushed = end + 1;
+      REQUIRE(decoder.Decided() == ((pushed > lag) ? pushed - lag : 0));
+      REQUIRE(states.n_elem + count == decoder.Decided());
+      for (size_t i = 0; i < states.n_elem; ++i)
+        decided[count++] = states[i];
+    }
+
+    decoder.Flush(states);
+    REQUIRE(count + states.n_elem == observations.n_cols);
+    for (size_t i = 0; i < states.n_elem; ++i)
+      decided[count++] = states[i];
+
+    // The full lag gives the exact path.  A short lag usually agrees with the
+    // exact path almost everywhere.
+    size_t differences = 0;
+    for (size_t i = 0; i < exact.n_elem; ++i)
+      if (decided[i] != exact[i])
+        ++differences;
+
+    if (lag == 200)
+      REQUIRE(differences == 0);
+    else
+      REQUIRE(differences < 40);
+  }
+}
+
+/**
+ * A negative beam width is invalid.
+ */
+TEST_CASE("OnlineViterbiInvalidBeamTest", "[HMMTest]")
+{
+  arma::mat observations;
+  HMM<GaussianDistribution> hmm = ViterbiTestHMM(observations, 10);
+
+  REQUIRE_THROWS_AS(OnlineViterbi<GaussianDistribution>(hmm, 0, -1.0),
+      std::invalid_argument);
+}
+
 /********************************************/
 /** DiagonalGMM Hidden Markov Models Tests **/
 /********************************************/
@@ -1857,3 +2097,64 @@ TEST_CASE("DiagonalGMMHMMLoadSaveTest", "[HMMTest]")
     }
   }
 }
+
+/**
+ * Make sure that the log-likelihoods of a batch of sequences, in double and in
+ * single precision, match the log-likelihood of each sequence.
+ */
+TEST_CASE("HMMBatchLogLikelihoodTest", "[HMMTest]")
+{
+  std::vector<GaussianDistribution> emission;
+  emission.push_back(GaussianDistribution("5.0 5.0", "1.0 0.0; 0.0 1.0"));
+  emission.push_back(GaussianDistribution("-5.0 -5.0", "1.0 0.5; 0.5 1.0"));
+  HMM<GaussianDistribution> hmm(arma::vec("0.6 0.4"),
+      arma::mat("0.75 0.25; 0.25 0.75"), emission);
+
+  std::vector<GMM> gmms(2, GMM(2, 2));
+  gmms[0].Component(0) = GaussianDistribution("4.0 4.0", "1.0 0.0; 0.0 1.0");
+  gmms[0].Component(1) = GaussianDistribution("6.0 5.0", "2.0 0.3; 0.3 1.0");
+  gmms[0].Weights() = "0.4 0.6";
+  gmms[1].Component(0) = GaussianDistribution("-5.0 -5.0",
+      "1.0 0.0; 0.0 1.0");
+  gmms[1].Component(1) = GaussianDistribution("-3.0 -6.0",
+      "1.0 0.8; 0.8 1.0");
+  gmms[1].Weights() = "0.7 0.3";
+  HMM<GMM> gmmHMM(arma::vec("0.6 0.4"), arma::mat("0.75 0.25; 0.25 0.75"),
+      gmms);
+
+  // Sequences of different lengths, in single precision and in double
+  // precision.
+  std::vector<arma::fmat> sequences(40);
+  std::vector<arma::mat> doubleSequences(40);
+  for (size_t i = 0; i < sequences.size(); ++i)
+  {
+    arma::mat dataSeq;
+    arma::Row<size_t> stateSeq;
+    hmm.Generate(10 + 7 * i, dataSeq, stateSeq);
+    sequences[i] = arma::conv_to<arma::fmat>::from(dataSeq);
+    doubleSequences[i] = arma::conv_to<arma::mat>::from(sequences[i]);
+  }
+
+  arma::vec logLikelihoods, doubleLogLikelihoods;
+  hmm.LogLikelihood(sequences, logLikelihoods);
+  hmm.LogLikelihood(doubleSequences, doubleLogLikelihoods);
+  arma::vec gmmLogLikelihoods;
+  gmmHMM.LogLikelihood(sequences, gmmLogLikelihoods);
+
+  REQUIRE(logLikelihoods.n_elem == sequences.size());
+  REQUIRE(doubleLogLikelihoods.n_elem == sequences.size());
+  REQUIRE(gmmLogLikelihoods.n_elem == sequences.size());
+  for (size_t i = 0; i < sequences.size(); ++i)
+  {
+    const double expected = hmm.LogLikelihood(doubleSequences[i]);
+    REQUIRE(logLikelihoods[i] == Approx(expected).epsilon(1e-10));
+    REQUIRE(doubleLogLikelihoods[i] == Approx(expected).epsilon(1e-10));
+    REQUIRE(gmmLogLikelihoods[i] ==
+        Approx(gmmHMM.LogLikelihood(doubleSequences[i])).epsilon(1e-10));
+  }
+
+  // A sequence of the wrong dimensionality is an error.
+  sequences[3] = arma::randu<arma::fmat>(3, 10);
+  REQUIRE_THROWS_AS(hmm.LogLikelihood(sequences, logLikelihoods),
+      std::runtime_error);
+}
@@ -0,0 +1,196 @@
+/**
+ * @file tests/hnsw_test.cpp
+ *
+ * Test the HNSW approximate nearest neighbor index.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/core/kernels/linear_kernel.hpp>
+#include <mlpack/core/metrics/ip_metric.hpp>
+#include <mlpack/methods/hnsw/hnsw.hpp>
+#include <mlpack/methods/neighbor_search/neighbor_search.hpp>
+
+#include "serialization_catch.hpp"
+#include "test_catch_tools.hpp"
+#include "catch.hpp"
+
+using namespace mlpack;
+using namespace mlpack::neighbor;
+
+/**
+ * Return the fraction of the true neighbors that were found.
+ */
+static double HNSWRecall(const arma::Mat<size_t>& trueNeighbors,
+                         const arma::Mat<size_t>& neighbors)
+{
+  size_t found = 0;
+  for (size_t i = 0; i < neighbors.n_cols; ++i)
+    for (size_t j = 0; j < trueNeighbors.n_rows; ++j)
+      if (arma::any(neighbors.col(i) == trueNeighbors(j, i)))
+        ++found;
+
+  return (double) found / (double) trueNeighbors.n_elem;
+}
+
+/**
+ * The approximate neighbors should nearly all be the true neighbors.
+ */
+TEST_CASE("HNSWRecallTest", "[HNSWTest]")
+{
+  arma::mat dataset(5, 2000, arma::fill::randu);
+  arma::mat queries(5, 100, arma::fill::randu);
+
+  KNN knn(dataset);
+  arma::Mat<size_t> trueNeighbors;
+  arma::mat trueDistances;
+  knn.Search(queries, 5, trueNeighbors, trueDistances);
+
+  HNSW<> hnsw(dataset, 16, 100, 50);
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  hnsw.Search(queries, 5, neighbors, distances);
+
+  REQUIRE(neighbors.n_rows == 5);
+  REQUIRE(neighbors.n_cols == 100);
+  REQUIRE(HNSWRecall(trueNeighbors, neighbors) >= 0.9);
+
+  // The distances are exact distances to the returned points.
+  for (size_t i = 0; i < neighbors.n_cols; ++i)
+  {
+    for (size_t j = 0; j < neighbors.n_rows; ++j)
+    {
+      REQUIRE(distances(j, i) == Approx(metric::EuclideanDistance::Evaluate(
+          queries.col(i), dataset.col(neighbors(j, i)))).epsilon(1e-7));
+      if (j > 0)
+        REQUIRE(distances(j, i) >= distances(j - 1, i));
+    }
+  }
+}
+
+/**
+ * Searching with the reference set should return each point as its own
+ * nearest neighbor.
+ */
+TEST_CASE("HNSWSelfSearchTest", "[HNSWTest]")
+{
+  arma::mat dataset(3, 500, arma::fill::randu);
+
+  HNSW<> hnsw(dataset);
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  hnsw.Search(dataset, 1, neighbors, distances);
+
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+  {
+    REQUIRE(neighbors(0, i) == i);
+    REQUIRE(distances(0, i) == Approx(0.0).margin(1e-10));
+  }
+}
+
+/**
+ * The graph built by concurrent insertions must respect the link limits, and
+ * every link in a layer must go to a point of that layer.
+ */
+TEST_CASE("HNSWGraphStructureTest", "[HNSWTest]")
+{
+  arma::mat dataset(4, 3000, arma::fill::randu);
+
+  HNSW<> hnsw(8, 50);
+  hnsw.Train(dataset);
+
+  REQUIRE(hnsw.Level(hnsw.EntryPoint()) == hnsw.MaxLevel());
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+  {
+    REQUIRE(hnsw.Level(i) <= hnsw.MaxLevel());
+    for (size_t l = 0; l <= hnsw.Level(i); ++l)
+    {
+      const std::vector<size_t>& links = hnsw.Links(i, l);
+      REQUIRE(links.size() <= ((l == 0) ? 16 : 8));
+      for (size_t j = 0; j < links.size(); ++j)
+      {
+        REQUIRE(links[j] != i);
+        REQUIRE(hnsw.Level(links[j]) >= l);
+      }
+    }
+
+    // Every point but the first is linked in the bottom layer.
+    if (i > 0)
+      REQUIRE(hnsw.Links(i, 0).size() > 0);
+  }
+}
+
+/**
+ * The index should work with the inner-product metric too.
+ */
+TEST_CASE("HNSWIPMetricTest", "[HNSWTest]")
+{
+  arma::mat dataset(5, 1000, arma::fill::randu);
+  arma::mat queries(5, 50, arma::fill::randu);
+
+  // With the linear kernel the induced metric is the Euclidean distance.
+  KNN knn(dataset);
+  arma::Mat<size_t> trueNeighbors;
+  arma::mat trueDistances;
+  knn.Search(queries, 3, trueNeighbors, trueDistances);
+
+  HNSW<metric::IPMetric<kernel::LinearKernel>> hnsw(dataset);
+  hnsw.NumThreads() = 1;
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  hnsw.Search(queries, 3, neighbors, distances);
+
+  REQUIRE(HNSWRecall(trueNeighbors, neighbors) >= 0.9);
+}
+
+/**
+ * Invalid parameters must be rejected.
+ */
+TEST_CASE("HNSWInvalidParametersTest", "[HNSWTest]")
+{
+  arma::mat dataset(3, 100, arma::fill::randu);
+
+  REQUIRE_THROWS_AS(HNSW<>(dataset, 1), std::invalid_argument);
+  REQUIRE_THROWS_AS(HNSW<>(dataset, 16, 0), std::invalid_argument);
+
+  HNSW<> hnsw(dataset);
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  REQUIRE_THROWS_AS(hnsw.Search(dataset, 101, neighbors, distances),
+      std::runtime_error);
+  arma::mat queries(4, 10, arma::fill::randu);
+  REQUIRE_THROWS_AS(hnsw.Search(queries, 1, neighbors, distances),
+      std::runtime_error);
+}
+
+/**
+ * Make sure the graph gives the same results after serialization.
+ */
+TEST_CASE("HNSWSerializationTest", "[HNSWTest]")
+{
+  arma::mat dataset(4, 500, arma::fill::randu);
+  arma::mat queries(4, 50, arma::fill::randu);
+
+  HNSW<> hnsw(dataset, 8, 50, 20);
+  HNSW<> hnswXml, hnswText, hnswBinary(4);
+  hnswBinary.Train(arma::mat(4, 100, arma::fill::randu));
+
+  SerializeObjectAll(hnsw, hnswXml, hnswText, hnswBinary);
+
+  REQUIRE(hnswXml.MaxLevel() == hnsw.MaxLevel());
+  REQUIRE(hnswText.EntryPoint() == hnsw.EntryPoint());
+  REQUIRE(hnswBinary.Ef() == hnsw.Ef());
+
+  arma::Mat<size_t> neighbors, xmlNeighbors, textNeighbors, binaryNeighbors;
+  arma::mat distances, xmlDistances, textDistances, binaryDistances;
+  hnsw.Search(queries, 5, neighbors, distances);
+  hnswXml.Search(queries, 5, xmlNeighbors, xmlDistances);
+  hnswText.Search(queries, 5, textNeighbors, textDistances);
+  hnswBinary.Search(queries, 5, binaryNeighbors, binaryDistances);
+
+  CheckMatrices(neighbors, xmlNeighbors, textNeighbors, binaryNeighbors);
+  CheckMatrices(distances, xmlDistances, textDistances, binaryDistances);
+}
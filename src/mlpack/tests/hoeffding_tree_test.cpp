@@ -16,12 +16,15 @@
 #include <mlpack/methods/hoeffding_trees/hoeffding_categorical_split.hpp>
 #include <mlpack/methods/hoeffding_trees/binary_numeric_split.hpp>
 #include <mlpack/methods/hoeffding_trees/hoeffding_tree_model.hpp>
+#include <mlpack/methods/hoeffding_trees/concurrent_hoeffding_trainer.hpp>
 
 #include "catch.hpp"
 #include "test_catch_tools.hpp"
 #include "serialization_catch.hpp"
 
+#include <atomic>
 #include <stack>
+#include <thread>
 
 using namespace std;
 using namespace arma;
@@ -1465,3 +1468,165 @@ TEST_CASE("HoeffdingTreeModelSerializationTest", "[HoeffdingTreeTest]")
     }
   }
 }
+
+/**
+ * Generate the three-class numeric dataset used by the tests below.
+ */
+static void StreamingTestData(arma::mat& dataset, arma::Row<size_t>& labels)
+{
+  dataset.set_size(3, 9000);
+  labels.set_size(9000);
+  for (size_t i = 0; i < 9000; i += 3)
+  {
+    dataset(0, i) = mlpack::math::Random();
+    dataset(1, i) = mlpack::math::Random();
+    dataset(2, i) = mlpack::math::Random();
+    labels[i] = 0;
+
+    dataset(0, i + 1) = mlpack::math::Random();
+    dataset(1, i + 1) = mlpack::math::Random() - 1.0;
+    dataset(2, i + 1) = mlpack::math::Random() + 0.5;
+    labels[i + 1] = 2;
+
+    dataset(0, i + 2) = mlpack::math::Random();
+    dataset(1, i + 2) = mlpack::math::Random() + 1.0;
+    dataset(2, i + 2) = mlpack::math::Random() + 0.8;
+    labels[i + 2] = 1;
+  }
+}
+
+/**
+ * Streaming training on blocks of points, which trains the leaves in parallel,
+ * must give the same tree as training on the points one at a time.
+ */
+TEST_CASE("HoeffdingTreeStreamingBlocksTest", "[HoeffdingTreeTest]")
+{
+  arma::mat dataset;
+  arma::Row<size_t> labels;
+  StreamingTestData(dataset, labels);
+  data::DatasetInfo info(3); // All features are numeric.
+
+  typedef HoeffdingTree<GiniImpurity, HoeffdingDoubleNumericSplit> TreeType;
+  TreeType pointTree(info, 3);
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+    pointTree.Train(dataset.col(i), labels[i]);
+
+  TreeType blockTree(info, 3);
+  for (size_t i = 0; i < dataset.n_cols; i += 1000)
+  {
+    const arma::mat block = dataset.cols(i, i + 999);
+    const arma::Row<size_t> blockLabels = labels.cols(i, i + 999);
+    blockTree.Train(block, blockLabels, false);
+  }
+
+  REQUIRE(pointTree.NumChildren() > 0);
+  REQUIRE(blockTree.NumDescendants() == pointTree.NumDescendants());
+  REQUIRE(blockTree.SplitDimension() == pointTree.SplitDimension());
+
+  arma::Row<size_t> pointPredictions, blockPredictions;
+  pointTree.Classify(dataset, pointPredictions);
+  blockTree.Classify(dataset, blockPredictions);
+  REQUIRE(arma::accu(pointPredictions != blockPredictions) == 0);
+}
+
+/**
+ * Train a tree from several threads at once with the
+ * ConcurrentHoeffdingTrainer.
+ */
+TEST_CASE("ConcurrentHoeffdingTrainerTest", "[HoeffdingTreeTest]")
+{
+  arma::mat dataset;
+  arma::Row<size_t> labels;
+  StreamingTestData(dataset, labels);
+  data::DatasetInfo info(3); // All features are numeric.
+
+  typedef HoeffdingTree<GiniImpurity, HoeffdingDoubleNumericSplit> TreeType;
+  TreeType tree(info, 3);
+  {
+    ConcurrentHoeffdingTrainer<TreeType> trainer(tree, 100, 4);
+    REQUIRE(trainer.NumShards() == 4);
+    REQUIRE(trainer.BatchSize() == 100);
+
+    #pragma omp parallel for
+    for (omp_size_t i = 0; i < (omp_size_t) dataset.n_cols; ++i)
+      trainer.Train(dataset.col(i), labels[i]);
+
+    trainer.Flush();
+    REQUIRE(trainer.Buffered() == 0);
+  }
+
+  REQUIRE(tree.NumChildren() > 0);
+  arma::Row<size_t> predictions;
+  tree.Classify(dataset, predictions);
+  REQUIRE(arma::accu(predictions == labels) > 6000);
+
+  REQUIRE_THROWS_AS(ConcurrentHoeffdingTrainer<TreeType>(tree, 0),
+      std::invalid_argument);
+}
+
+/**
+ * Classify with a tree while another thread trains it in streaming mode; the
+ * readers must always get a valid prediction, and the trained tree must be the
+ * same as without readers.
+ */
+TEST_CASE("HoeffdingTreeClassifyDuringTrainingTest", "[HoeffdingTreeTest]")
+{
+  arma::mat dataset;
+  arma::Row<size_t> labels;
+  StreamingTestData(dataset, labels);
+  data::DatasetInfo info(3); // All features are numeric.
+
+  typedef HoeffdingTree<GiniImpurity, HoeffdingDoubleNumericSplit> TreeType;
+  TreeType referenceTree(info, 3);
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+    referenceTree.Train(dataset.col(i), labels[i]);
+
+  TreeType tree(info, 3);
+  std::atomic<bool> done(false);
+  std::thread trainer([&]()
+  {
+    for (size_t i = 0; i < dataset.n_cols; i += 500)
+    {
+      // Alternate between blocks, which train the leaves in parallel, and
+      // single points.
+      if ((i / 500) % 2 == 0)
+      {
+        const arma::mat block = dataset.cols(i, i + 499);
+        const arma::Row<size_t> blockLabels = labels.cols(i, i + 499);
+        tree.Train(block, blockLabels, false);
+      }
+      else
+      {
+        for (size_t j = i; j < i + 500; ++j)
+          tree.Train(dataset.col(j), labels[j]);
+      }
+    }
+    done = true;
+  });
+
+  size_t invalid = 0;
+  size_t rounds = 0;
+  arma::Row<size_t> predictions;
+  arma::rowvec probabilities;
+  while (!done || rounds == 0)
+  {
+    tree.Classify(dataset.cols(0, 99), predictions, probabilities);
+    invalid += arma::accu(predictions >= 3);
+    invalid += arma::accu(probabilities < 0.0);
+    invalid += arma::accu(probabilities > 1.0);
+    ++rounds;
+  }
+  trainer.join();
+
+  REQUIRE(invalid == 0);
+  REQUIRE(tree.NumDescendants() == referenceTree.NumDescendants());
+
+  arma::Row<size_t> referencePredictions;
+  arma::rowvec referenceProbabilities;
+  tree.Classify(dataset, predictions, probabilities);
+  referenceTree.Classify(dataset, referencePredictions,
+      referenceProbabilities);
+  REQUIRE(arma::accu(predictions != referencePredictions) == 0);
+  REQUIRE(arma::approx_equal(probabilities, referenceProbabilities, "absdiff",
+      1e-10));
+}
@@ -402,4 +402,102 @@ BOOST_AUTO_TEST_CASE(HPTGradientDescentTest)
   BOOST_REQUIRE_CLOSE(zOptimized, zMin, 1e-4);
 }
 
+/**
+ * A function of two categorical parameters that records how many times it was
+ * evaluated with each training fraction.
+ */
+class CountingFunction
+{
+ public:
+  double Evaluate(const arma::mat& parameters, const double fraction)
+  {
+    ++evaluations[fraction];
+    return std::pow(parameters(0) - 3.0, 2.0) + std::pow(parameters(1) - 1.0,
+        2.0);
+  }
+
+  std::map<double, size_t> evaluations;
+};
+
+/**
+ * Test that successive halving discards combinations between rounds and
+ * evaluates the remaining ones on all of the data.
+ */
+BOOST_AUTO_TEST_CASE(SuccessiveHalvingTest)
+{
+  CountingFunction function;
+  SuccessiveHalving optimizer(1.0 / 9.0, 3);
+
+  std::vector<bool> categoricalDimensions(2, true);
+  arma::Row<size_t> numCategories("7 4");
+  arma::mat bestParameters;
+
+  const double objective = optimizer.Optimize(function, bestParameters,
+      categoricalDimensions, numCategories);
+
+  BOOST_REQUIRE_SMALL(objective, 1e-10);
+  BOOST_REQUIRE_EQUAL(bestParameters.n_elem, 2);
+  BOOST_REQUIRE_CLOSE(bestParameters(0), 3.0, 1e-5);
+  BOOST_REQUIRE_CLOSE(bestParameters(1), 1.0, 1e-5);
+
+  // All 28 combinations in the first round, then 10, then 4.
+  BOOST_REQUIRE_EQUAL(function.evaluations.size(), 3);
+  BOOST_REQUIRE_EQUAL(function.evaluations.begin()->second, 28);
+  BOOST_REQUIRE_EQUAL(function.evaluations[1.0], 4);
+
+  // Non-categorical dimensions can't be searched.
+  categoricalDimensions[1] = false;
+  BOOST_REQUIRE_THROW(optimizer.Optimize(function, bestParameters,
+      categoricalDimensions, numCategories), std::invalid_argument);
+}
+
+/**
+ * With a minimum fraction of 1, successive halving is a grid search, so it
+ * should find the same hyper-parameters as GridSearch.
+ */
+BOOST_AUTO_TEST_CASE(HPTSuccessiveHalvingTest)
+{
+  arma::mat xs;
+  arma::rowvec ys;
+  double validationSize;
+  InitProneToOverfittingData(xs, ys, validationSize);
+
+  bool transposeData = true;
+  bool useCholesky = false;
+  arma::vec lambda1Set("0 0.001 0.01 0.1 1.0 10.0 100.0");
+  arma::vec lambda2Set("0.0 0.05 0.5 5.0");
+
+  double expectedLambda1, expectedLambda2, expectedObjective;
+  FindLARSBestLambdas(xs, ys, validationSize, transposeData, useCholesky,
+      lambda1Set, lambda2Set, expectedLambda1, expectedLambda2,
+      expectedObjective);
+
+  double actualLambda1, actualLambda2;
+  HyperParameterTuner<LARS, MSE, SimpleCV, SuccessiveHalving>
+      hpt(validationSize, xs, ys);
+  hpt.Optimizer().MinFraction() = 1.0;
+  std::tie(actualLambda1, actualLambda2) = hpt.Optimize(Fixed(transposeData),
+      Fixed(useCholesky), lambda1Set, lambda2Set);
+
+  BOOST_REQUIRE_CLOSE(expectedObjective, hpt.BestObjective(), 1e-5);
+  BOOST_REQUIRE_CLOSE(expectedLambda1, actualLambda1, 1e-5);
+  BOOST_REQUIRE_CLOSE(expectedLambda2, actualLambda2, 1e-5);
+
+  // With smaller fractions, the best model is still trained on all of the
+  // training data, so its performance is the returned objective.
+  hpt.Optimizer().MinFraction() = 0.25;
+  std::tie(actualLambda1, actualLambda2) = hpt.Optimize(Fixed(transposeData),
+      Fixed(useCholesky), lambda1Set, lambda2Set);
+
+  SimpleCV<LARS, MSE> cv(validationSize, xs, ys);
+  BOOST_REQUIRE_CLOSE(cv.Evaluate(transposeData, useCholesky, actualLambda1,
+      actualLambda2), hpt.BestObjective(), 1e-5);
+
+  size_t validationFirstColumn = round(xs.n_cols * (1.0 - validationSize));
+  arma::mat validationXs = xs.cols(validationFirstColumn, xs.n_cols - 1);
+  arma::rowvec validationYs = ys.cols(validationFirstColumn, ys.n_cols - 1);
+  double objective = MSE::Evaluate(hpt.BestModel(), validationXs, validationYs);
+  BOOST_REQUIRE_CLOSE(hpt.BestObjective(), objective, 1e-5);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -109,6 +109,67 @@ TEST_CASE("LoadVectorImageAPITest", "[ImageLoadTest]")
   REQUIRE(matrix.n_cols == 2);
 }
 
+/**
+ * Test that images are resized and normalized while they are loaded.
+ */
+TEST_CASE("LoadVectorResizedImageTest", "[ImageLoadTest]")
+{
+  std::vector<std::string> files = {"test_image.png", "test_image.png",
+      "test_image.png"};
+
+  arma::mat original;
+  data::ImageInfo info;
+  REQUIRE(data::Load(files, original, info, false) == true);
+
+  // Normalizing without resizing only scales the values.
+  arma::mat normalized;
+  data::ImageInfo normalizedInfo;
+  REQUIRE(data::Load(files, normalized, normalizedInfo, false, 0, 0, true)
+      == true);
+  REQUIRE(normalizedInfo.Width() == 50);
+  REQUIRE(normalizedInfo.Height() == 50);
+  CheckMatrices(normalized, arma::mat(original / 255.0));
+
+  arma::mat resized;
+  data::ImageInfo resizedInfo;
+  REQUIRE(data::Load(files, resized, resizedInfo, false, 25, 20, true)
+      == true);
+  REQUIRE(resizedInfo.Width() == 25);
+  REQUIRE(resizedInfo.Height() == 20);
+  REQUIRE(resizedInfo.Channels() == 3);
+  REQUIRE(resized.n_rows == 25 * 20 * 3);
+  REQUIRE(resized.n_cols == 3);
+  REQUIRE(resized.min() >= 0.0);
+  REQUIRE(resized.max() <= 1.0);
+
+  // Every column holds the same image.
+  CheckMatrices(arma::mat(resized.col(1)), arma::mat(resized.col(0)));
+  CheckMatrices(arma::mat(resized.col(2)), arma::mat(resized.col(0)));
+}
+
+/**
+ * Test that images of different sizes can't be loaded together without
+ * resizing them.
+ */
+TEST_CASE("LoadVectorDifferentSizeImageTest", "[ImageLoadTest]")
+{
+  data::ImageInfo saveInfo(5, 5, 3, 90);
+  arma::Mat<unsigned char> im = arma::randi<arma::Mat<unsigned char>>(
+      5 * 5 * 3, 1);
+  REQUIRE(data::Save("APITest.bmp", im, saveInfo, false) == true);
+
+  std::vector<std::string> files = {"test_image.png", "APITest.bmp"};
+  arma::Mat<unsigned char> matrix;
+  data::ImageInfo info;
+  REQUIRE(data::Load(files, matrix, info, false) == false);
+
+  // With resizing, both images have the same size.
+  REQUIRE(data::Load(files, matrix, info, false, 10, 10) == true);
+  REQUIRE(matrix.n_rows == 10 * 10 * 3);
+  REQUIRE(matrix.n_cols == 2);
+  remove("APITest.bmp");
+}
+
 /**
  * Test if the image is saved correctly using API for arma mat.
  */
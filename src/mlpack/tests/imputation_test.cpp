@@ -313,3 +313,80 @@ TEST_CASE("DatasetMapperPointerMapping", "[ImputationTest]")
   REQUIRE(dm.UnmapString(1, 0) == &b);
   REQUIRE(dm.UnmapString(2, 0) == &c);
 }
+
+/**
+ * Impute several dimensions one at a time and all at once with the given
+ * strategy, and make sure the results are the same.
+ */
+template<typename StrategyType>
+void CheckBatchImputation(StrategyType strategy, const bool columnMajor)
+{
+  arma::mat input = arma::randu<arma::mat>(20, 500);
+  // Mark some values as missing, with both NaN and a mapped value.
+  input.elem(arma::find(input < 0.1)).fill(-1.0);
+  input.elem(arma::find(input > 0.95)).fill(
+      std::numeric_limits<double>::quiet_NaN());
+  if (!columnMajor)
+    arma::inplace_trans(input);
+
+  const std::vector<size_t> dimensions = { 0, 3, 4, 11, 19 };
+  const std::vector<double> mappedValues(dimensions.size(), -1.0);
+
+  arma::mat expected(input);
+  for (size_t k = 0; k < dimensions.size(); ++k)
+    strategy.Impute(expected, mappedValues[k], dimensions[k], columnMajor);
+
+  strategy.Impute(input, mappedValues, dimensions, columnMajor);
+
+  // The other dimensions still hold NaNs, which can't be compared.
+  expected.elem(arma::find_nonfinite(expected)).zeros();
+  input.elem(arma::find_nonfinite(input)).zeros();
+  CheckMatrices(expected, input);
+}
+
+/**
+ * Make sure each strategy gives the same results when imputing several
+ * dimensions at once.
+ */
+TEST_CASE("BatchImputationTest", "[ImputationTest]")
+{
+  for (const bool columnMajor : { true, false })
+  {
+    CheckBatchImputation(MeanImputation<double>(), columnMajor);
+    CheckBatchImputation(MedianImputation<double>(), columnMajor);
+    CheckBatchImputation(CustomImputation<double>(42.0), columnMajor);
+    CheckBatchImputation(ListwiseDeletion<double>(), columnMajor);
+  }
+}
+
+/**
+ * Make sure the Imputer maps the missing value of each dimension when imputing
+ * several dimensions at once.
+ */
+TEST_CASE("ImputerBatchImputationTest", "[ImputationTest]")
+{
+  fstream f;
+  f.open("test_file.csv", fstream::out);
+  f << "a, 2, 3"  << endl;
+  f << "5, 6, a"  << endl;
+  f << "8, a, 9"  << endl;
+  f << "1, 2, 3"  << endl;
+  f.close();
+
+  arma::mat input;
+  std::set<string> mappingValues;
+  mappingValues.insert("a");
+  MissingPolicy miss(mappingValues);
+  DatasetMapper<MissingPolicy> info(miss);
+  REQUIRE(data::Load("test_file.csv", input, info) == true);
+  remove("test_file.csv");
+
+  Imputer<double, DatasetMapper<MissingPolicy>, MeanImputation<double>>
+      imputer(info);
+  imputer.Impute(input, "a", std::vector<size_t>({ 0, 1, 2 }));
+
+  REQUIRE(input(0, 0) == Approx(14.0 / 3.0).epsilon(1e-7));
+  REQUIRE(input(1, 2) == Approx(10.0 / 3.0).epsilon(1e-7));
+  REQUIRE(input(2, 1) == Approx(5.0).epsilon(1e-7));
+  REQUIRE(input(1, 0) == Approx(2.0).epsilon(1e-7));
+}
@@ -1233,3 +1233,90 @@ TEST_CASE_METHOD(IOTestDestroyer, "CppNameTest",
   REQUIRE(IO::Parameters().at("help").cppType == "bool");
   REQUIRE(IO::Parameters().at("double").cppType == "double");
 }
+
+/**
+ * Make sure that each context has its own parameters, restored from the shared
+ * stored settings, even when the contexts are used at the same time from
+ * different threads.
+ */
+TEST_CASE_METHOD(IOTestDestroyer, "ThreadSettingsTest",
+                "[IOTest]")
+{
+  AddRequiredCLIOptions();
+
+  PARAM_INT_IN("int", "Test int", "i", 0);
+  IO::StoreSettings("thread_settings_test");
+
+  IO::RestoreSettings("thread_settings_test");
+  IO::GetParam<int>("int") = 42;
+
+  std::vector<int> values(4, -1);
+  std::vector<bool> passed(4, true);
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < 4; ++i)
+  {
+    threads.push_back(std::thread([i, &values, &passed]()
+    {
+      IO::Context context;
+      IO::RestoreSettings("thread_settings_test");
+      passed[i] = IO::HasParam("int");
+      IO::GetParam<int>("int") += (int) i + 1;
+      IO::SetPassed("int");
+      values[i] = IO::GetParam<int>("int");
+      IO::ClearSettings();
+    }));
+  }
+
+  for (size_t i = 0; i < threads.size(); ++i)
+    threads[i].join();
+
+  // The threads must not have seen or modified the value on this thread.
+  for (size_t i = 0; i < 4; ++i)
+  {
+    REQUIRE(passed[i] == false);
+    REQUIRE(values[i] == (int) i + 1);
+  }
+
+  REQUIRE(IO::GetParam<int>("int") == 42);
+  REQUIRE(!IO::HasParam("int"));
+}
+
+/**
+ * Make sure that a context hides the parameters of the enclosing one for as
+ * long as it lives, and that the enclosing parameters are untouched when it is
+ * destroyed.
+ */
+TEST_CASE_METHOD(IOTestDestroyer, "NestedContextTest",
+                "[IOTest]")
+{
+  AddRequiredCLIOptions();
+
+  PARAM_INT_IN("int", "Test int", "i", 0);
+  IO::StoreSettings("nested_context_test");
+
+  IO::RestoreSettings("nested_context_test");
+  IO::GetParam<int>("int") = 3;
+  IO::SetPassed("int");
+
+  {
+    IO::Context outer;
+    REQUIRE(IO::Parameters().count("int") == 0);
+
+    IO::RestoreSettings("nested_context_test");
+    REQUIRE(!IO::HasParam("int"));
+    IO::GetParam<int>("int") = 5;
+
+    {
+      IO::Context inner;
+      IO::RestoreSettings("nested_context_test");
+      REQUIRE(IO::GetParam<int>("int") == 0);
+      IO::GetParam<int>("int") = 7;
+    }
+
+    // The outer context is bound again.
+    REQUIRE(IO::GetParam<int>("int") == 5);
+  }
+
+  REQUIRE(IO::HasParam("int"));
+  REQUIRE(IO::GetParam<int>("int") == 3);
+}
@@ -0,0 +1,200 @@
+/**
+ * @file tests/ivf_pq_test.cpp
+ *
+ * Test the IVFPQ approximate nearest neighbor index.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/methods/ivf_pq/ivf_pq.hpp>
+#include <mlpack/methods/neighbor_search/neighbor_search.hpp>
+
+#include "serialization_catch.hpp"
+#include "test_catch_tools.hpp"
+#include "catch.hpp"
+
+using namespace mlpack;
+using namespace mlpack::neighbor;
+
+/**
+ * Return the fraction of queries whose true nearest neighbor is among the
+ * approximate neighbors.
+ */
+static double Recall(const arma::Mat<size_t>& trueNeighbors,
+                     const arma::Mat<size_t>& neighbors)
+{
+  size_t found = 0;
+  for (size_t i = 0; i < neighbors.n_cols; ++i)
+    if (arma::any(neighbors.col(i) == trueNeighbors(0, i)))
+      ++found;
+
+  return (double) found / (double) neighbors.n_cols;
+}
+
+/**
+ * When every list is probed, the true nearest neighbor should nearly always be
+ * among the ten approximate neighbors.
+ */
+TEST_CASE("IVFPQRecallTest", "[IVFPQTest]")
+{
+  arma::mat dataset(8, 2000, arma::fill::randu);
+  arma::mat queries(8, 100, arma::fill::randu);
+
+  KNN knn(dataset);
+  arma::Mat<size_t> trueNeighbors;
+  arma::mat trueDistances;
+  knn.Search(queries, 1, trueNeighbors, trueDistances);
+
+  IVFPQ<> ivfpq(dataset, 16, 4, 64, 16);
+  REQUIRE(ivfpq.NumPoints() == 2000);
+  REQUIRE(ivfpq.ListOffsets().n_elem == 17);
+  REQUIRE(ivfpq.ListOffsets()[16] == 2000);
+  REQUIRE(ivfpq.Codes().n_rows == 4);
+  REQUIRE(ivfpq.Codes().n_cols == 2000);
+  REQUIRE(ivfpq.Codebooks().n_rows == 2);
+  REQUIRE(ivfpq.Codebooks().n_cols == 64);
+  REQUIRE(ivfpq.Codebooks().n_slices == 4);
+
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  ivfpq.Search(queries, 10, neighbors, distances);
+
+  REQUIRE(neighbors.n_rows == 10);
+  REQUIRE(neighbors.n_cols == 100);
+  for (size_t i = 0; i < neighbors.n_cols; ++i)
+  {
+    for (size_t j = 0; j < neighbors.n_rows; ++j)
+    {
+      REQUIRE(neighbors(j, i) < 2000);
+      if (j > 0)
+        REQUIRE(distances(j, i) >= distances(j - 1, i));
+    }
+  }
+
+  REQUIRE(Recall(trueNeighbors, neighbors) >= 0.75);
+}
+
+/**
+ * Probing more lists can only find more candidates, so the recall should not
+ * get worse.
+ */
+TEST_CASE("IVFPQProbesTest", "[IVFPQTest]")
+{
+  arma::mat dataset(8, 2000, arma::fill::randu);
+  arma::mat queries(8, 100, arma::fill::randu);
+
+  KNN knn(dataset);
+  arma::Mat<size_t> trueNeighbors;
+  arma::mat trueDistances;
+  knn.Search(queries, 1, trueNeighbors, trueDistances);
+
+  IVFPQ<> ivfpq(dataset, 16, 4, 64, 1);
+  arma::Mat<size_t> neighbors1, neighbors16;
+  arma::mat distances;
+  ivfpq.Search(queries, 10, neighbors1, distances);
+  ivfpq.NumProbes() = 16;
+  ivfpq.Search(queries, 10, neighbors16, distances);
+
+  REQUIRE(Recall(trueNeighbors, neighbors16) >=
+      Recall(trueNeighbors, neighbors1));
+}
+
+/**
+ * If the probed list holds fewer than k points, the remaining neighbors must be
+ * marked as invalid.
+ */
+TEST_CASE("IVFPQUnfilledNeighborsTest", "[IVFPQTest]")
+{
+  arma::mat dataset(4, 200, arma::fill::randu);
+
+  IVFPQ<> ivfpq(dataset, 10, 2, 16, 1);
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  ivfpq.Search(dataset.cols(0, 9), 200, neighbors, distances);
+
+  for (size_t i = 0; i < neighbors.n_cols; ++i)
+  {
+    REQUIRE(neighbors(0, i) < 200);
+    REQUIRE(neighbors(199, i) == 200);
+    REQUIRE(distances(199, i) == DBL_MAX);
+  }
+}
+
+/**
+ * Training on a sample and on float data should work too.
+ */
+TEST_CASE("IVFPQFloatSampleTest", "[IVFPQTest]")
+{
+  arma::fmat dataset(8, 2000, arma::fill::randu);
+  arma::fmat queries(8, 100, arma::fill::randu);
+
+  KNNType<metric::EuclideanDistance, tree::KDTree, arma::fmat> knn(dataset);
+  arma::Mat<size_t> trueNeighbors;
+  arma::mat trueDistances;
+  knn.Search(queries, 1, trueNeighbors, trueDistances);
+
+  IVFPQ<arma::fmat> ivfpq(dataset, 16, 4, 64, 16, 1000);
+  REQUIRE(ivfpq.NumPoints() == 2000);
+
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  ivfpq.Search(queries, 10, neighbors, distances);
+
+  REQUIRE(Recall(trueNeighbors, neighbors) >= 0.75);
+}
+
+/**
+ * Invalid parameters must be rejected.
+ */
+TEST_CASE("IVFPQInvalidParametersTest", "[IVFPQTest]")
+{
+  arma::mat dataset(10, 500, arma::fill::randu);
+
+  // 10 dimensions can't be split into 4 subspaces.
+  REQUIRE_THROWS_AS(IVFPQ<>(dataset, 8, 4, 16), std::invalid_argument);
+  // Codes are stored in one byte.
+  REQUIRE_THROWS_AS(IVFPQ<>(dataset, 8, 5, 300), std::invalid_argument);
+  // Not enough points to train the codebooks.
+  REQUIRE_THROWS_AS(IVFPQ<>(dataset, 8, 5, 256, 8, 100),
+      std::invalid_argument);
+
+  // Searching an untrained model or with the wrong dimensionality fails.
+  IVFPQ<> ivfpq;
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  REQUIRE_THROWS_AS(ivfpq.Search(dataset, 1, neighbors, distances),
+      std::runtime_error);
+
+  ivfpq = IVFPQ<>(dataset, 8, 5, 16);
+  arma::mat queries(5, 10, arma::fill::randu);
+  REQUIRE_THROWS_AS(ivfpq.Search(queries, 1, neighbors, distances),
+      std::runtime_error);
+}
+
+/**
+ * Make sure the model gives the same results after serialization.
+ */
+TEST_CASE("IVFPQSerializationTest", "[IVFPQTest]")
+{
+  arma::mat dataset(8, 1000, arma::fill::randu);
+  arma::mat queries(8, 50, arma::fill::randu);
+
+  IVFPQ<> ivfpq(dataset, 8, 4, 32, 4);
+  IVFPQ<> ivfpqXml, ivfpqText, ivfpqBinary(4, 2, 16);
+  ivfpqBinary.Train(arma::mat(8, 100, arma::fill::randu));
+
+  SerializeObjectAll(ivfpq, ivfpqXml, ivfpqText, ivfpqBinary);
+
+  arma::Mat<size_t> neighbors, xmlNeighbors, textNeighbors, binaryNeighbors;
+  arma::mat distances, xmlDistances, textDistances, binaryDistances;
+  ivfpq.Search(queries, 5, neighbors, distances);
+  ivfpqXml.Search(queries, 5, xmlNeighbors, xmlDistances);
+  ivfpqText.Search(queries, 5, textNeighbors, textDistances);
+  ivfpqBinary.Search(queries, 5, binaryNeighbors, binaryDistances);
+
+  CheckMatrices(neighbors, xmlNeighbors, textNeighbors, binaryNeighbors);
+  CheckMatrices(distances, xmlDistances, textDistances, binaryDistances);
+}
@@ -1301,4 +1301,139 @@ BOOST_AUTO_TEST_CASE(GaussianBreadthDualKDTreeMonteCarloKDE)
   BOOST_REQUIRE_GT(correctResults, 70);
 }
 
+/**
+ * Make sure that evaluation on several threads stays within the relative error
+ * tolerance, for both algorithms and for monochromatic evaluation.
+ */
+BOOST_AUTO_TEST_CASE(ParallelKDETest)
+{
+  arma::mat reference = arma::randu(2, 2000);
+  arma::mat query = arma::randu(2, 500);
+  const double relError = 0.01;
+
+  GaussianKernel kernel(0.3);
+  arma::vec bfEstimations(query.n_cols, arma::fill::zeros);
+  BruteForceKDE<GaussianKernel>(reference, query, bfEstimations, kernel);
+  arma::vec bfMonoEstimations(reference.n_cols, arma::fill::zeros);
+  BruteForceKDE<GaussianKernel>(reference, reference, bfMonoEstimations,
+      kernel);
+  // Monochromatic evaluation leaves out the point itself.
+  bfMonoEstimations = (bfMonoEstimations * reference.n_cols - 1.0) /
+      reference.n_cols;
+
+  const KDEMode modes[] = { KDEMode::DUAL_TREE_MODE,
+                            KDEMode::SINGLE_TREE_MODE };
+  for (size_t m = 0; m < 2; ++m)
+  {
+    KDE<GaussianKernel, EuclideanDistance, arma::mat, KDTree>
+        kde(relError, 0.0, kernel, modes[m]);
+    kde.NumThreads() = 4;
+    kde.Train(reference);
+
+    arma::vec estimations;
+    kde.Evaluate(query, estimations);
+    for (size_t i = 0; i < query.n_cols; ++i)
+      BOOST_REQUIRE_CLOSE(estimations[i], bfEstimations[i], relError * 100);
+
+    kde.Evaluate(estimations);
+    for (size_t i = 0; i < reference.n_cols; ++i)
+    {
+      BOOST_REQUIRE_CLOSE(estimations[i], bfMonoEstimations[i],
+          relError * 100);
+    }
+  }
+
+  // The cover tree has more than two children per node.
+  KDE<GaussianKernel, EuclideanDistance, arma::mat, StandardCoverTree>
+      kde(relError, 0.0, kernel);
+  kde.NumThreads() = 4;
+  kde.Train(reference);
+
+  arma::vec estimations;
+  kde.Evaluate(query, estimations);
+  for (size_t i = 0; i < query.n_cols; ++i)
+    BOOST_REQUIRE_CLOSE(estimations[i], bfEstimations[i], relError * 100);
+}
+
+/**
+ * Make sure the series expansion of a node approximates the sum of the kernel
+ * values of its descendants within the truncation error bound.
+ */
+BOOST_AUTO_TEST_CASE(GaussianSeriesTest)
+{
+  arma::mat reference = arma::randu(3, 200);
+  arma::mat query = arma::randu(3, 50) + 0.5;
+  typedef KDTree<EuclideanDistance, KDEStat, arma::mat> Tree;
+  Tree tree(reference);
+
+  GaussianKernel kernel(2.0);
+  for (size_t order = 1; order <= 8; ++order)
+  {
+    GaussianSeries series(3, order, kernel.Bandwidth());
+    BOOST_REQUIRE_EQUAL(series.NumTerms(),
+        (size_t) GaussianSeries::NumTerms(3, order));
+
+    series.ComputeCoefficients(tree);
+    BOOST_REQUIRE(series.HasCoefficients(tree.Stat()));
+
+    for (size_t i = 0; i < query.n_cols; ++i)
+    {
+      double exact = 0.0;
+      for (size_t j = 0; j < tree.NumDescendants(); ++j)
+      {
+        exact += kernel.Evaluate(arma::norm(query.col(i) -
+            tree.Dataset().col(tree.Descendant(j)), 2));
+      }
+
+      const double error = series.TruncationError(
+          series.CenterDistance(query.col(i), tree.Stat()), tree.Stat());
+      BOOST_REQUIRE_LE(std::abs(series.Evaluate(query.col(i), tree.Stat()) -
+          exact), tree.NumDescendants() * error + 1e-10);
+    }
+  }
+}
+
+/**
+ * Make sure that KDE with series expansions stays within the relative error
+ * tolerance, for both algorithms and for monochromatic evaluation.
+ */
+BOOST_AUTO_TEST_CASE(GaussianSeriesKDETest)
+{
+  arma::mat reference = arma::randu(2, 2000);
+  arma::mat query = arma::randu(2, 300);
+  const double relError = 0.01;
+
+  GaussianKernel kernel(0.8);
+  arma::vec bfEstimations(query.n_cols, arma::fill::zeros);
+  BruteForceKDE<GaussianKernel>(reference, query, bfEstimations, kernel);
+  arma::vec bfMonoEstimations(reference.n_cols, arma::fill::zeros);
+  BruteForceKDE<GaussianKernel>(reference, reference, bfMonoEstimations,
+      kernel);
+  // Monochromatic evaluation leaves out the point itself.
+  bfMonoEstimations = (bfMonoEstimations * reference.n_cols - 1.0) /
+      reference.n_cols;
+
+  const KDEMode modes[] = { KDEMode::DUAL_TREE_MODE,
+                            KDEMode::SINGLE_TREE_MODE };
+  for (size_t m = 0; m < 2; ++m)
+  {
+    KDE<GaussianKernel, EuclideanDistance, arma::mat, KDTree>
+        kde(relError, 0.0, kernel, modes[m]);
+    kde.SeriesOrder() = 6;
+    kde.Train(reference);
+
+    arma::vec estimations;
+    kde.Evaluate(query, estimations);
+    for (size_t i = 0; i < query.n_cols; ++i)
+      BOOST_REQUIRE_CLOSE(estimations[i], bfEstimations[i], relError * 100);
+
+    kde.Evaluate(estimations);
+    for (size_t i = 0; i < reference.n_cols; ++i)
+    {
+      BOOST_REQUIRE_CLOSE(estimations[i], bfMonoEstimations[i],
+          relError * 100);
+    }
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -20,6 +20,7 @@
 #include <mlpack/core/kernels/spherical_kernel.hpp>
 #include <mlpack/core/kernels/pspectrum_string_kernel.hpp>
 #include <mlpack/core/kernels/cauchy_kernel.hpp>
+#include <mlpack/core/kernels/kernel_matrix.hpp>
 #include <mlpack/core/metrics/lmetric.hpp>
 #include <mlpack/core/metrics/mahalanobis_distance.hpp>
 
@@ -620,6 +621,68 @@ TEST_CASE("PSpectrumStringEvaluateTest", "[KernelTest]")
   REQUIRE(p.Evaluate(b, a) == Approx(11.0).epsilon(1e-7));
 }
 
+/**
+ * Check the Gram matrices of the p-spectrum kernel against Evaluate(), for
+ * substrings that are encoded exactly and for hashed (long) substrings.
+ */
+TEST_CASE("PSpectrumStringGramTest", "[KernelTest]")
+{
+  // Random DNA-like reads, with some separators.
+  const char symbols[] = "ACGTacgt -";
+  std::vector<std::vector<std::string> > dataset(2);
+  for (size_t d = 0; d < 2; ++d)
+  {
+    for (size_t i = 0; i < 40; ++i)
+    {
+      std::string read;
+      const size_t length = math::RandInt(0, 80);
+      for (size_t j = 0; j < length; ++j)
+        read += symbols[math::RandInt(0, 10)];
+      dataset[d].push_back(read);
+    }
+  }
+  // Two strings sharing three substrings of length 15.
+  dataset[1][0] = "acgtacgtacgtacgtt";
+  dataset[1][1] = "TTACGTACGTACGTACGTT";
+
+  const size_t lengths[] = { 1, 3, 12, 15 };
+  for (size_t l = 0; l < 4; ++l)
+  {
+    PSpectrumStringKernel p(dataset, lengths[l]);
+
+    arma::mat gram, crossGram;
+    p.Gram(0, 0, gram);
+    p.Gram(0, 1, crossGram);
+    REQUIRE(gram.n_rows == 40);
+    REQUIRE(gram.n_cols == 40);
+    REQUIRE(crossGram.n_rows == 40);
+    REQUIRE(crossGram.n_cols == 40);
+
+    for (size_t i = 0; i < 40; ++i)
+    {
+      for (size_t j = 0; j < 40; ++j)
+      {
+        arma::vec a = { 0.0, (double) i };
+        arma::vec b = { 0.0, (double) j };
+        arma::vec c = { 1.0, (double) j };
+        REQUIRE(gram(i, j) == p.Evaluate(a, b));
+        REQUIRE(crossGram(i, j) == p.Evaluate(a, c));
+      }
+    }
+
+    arma::vec a = { 1.0, 0.0 };
+    arma::vec b = { 1.0, 1.0 };
+    if (lengths[l] == 15)
+      REQUIRE(p.Evaluate(a, b) == Approx(3.0).epsilon(1e-7));
+
+    REQUIRE_THROWS_AS(p.Gram(0, 2, gram), std::invalid_argument);
+  }
+
+  // Long substrings are hashed, so they cannot be listed.
+  PSpectrumStringKernel p(dataset, 13);
+  REQUIRE_THROWS_AS(p.Counts(), std::invalid_argument);
+}
+
 /**
  * Cauchy Kernel test.
  */
@@ -632,3 +695,60 @@ TEST_CASE("CauchyKernelTest", "[KernelTest]")
   REQUIRE(ck.Evaluate(a, b) == Approx(0.92592588).epsilon(1e-7));
   REQUIRE(ck.Evaluate(b, a) == Approx(0.92592588).epsilon(1e-7));
 }
+
+/**
+ * Check the kernel matrices built by KernelMatrix() against direct kernel
+ * evaluations, with enough points for several blocks.
+ */
+template<typename KernelType>
+void CheckKernelMatrix(KernelType& kernel)
+{
+  arma::mat a = arma::randu<arma::mat>(4, 300);
+  arma::mat b = arma::randu<arma::mat>(4, 550);
+
+  arma::mat symmetric, bichromatic;
+  KernelMatrix(kernel, a, symmetric);
+  KernelMatrix(kernel, a, b, bichromatic);
+
+  REQUIRE(symmetric.n_rows == 300);
+  REQUIRE(symmetric.n_cols == 300);
+  REQUIRE(bichromatic.n_rows == 300);
+  REQUIRE(bichromatic.n_cols == 550);
+
+  for (size_t j = 0; j < a.n_cols; ++j)
+  {
+    for (size_t i = 0; i < a.n_cols; ++i)
+    {
+      REQUIRE(symmetric(i, j) == Approx(kernel.Evaluate(a.col(i),
+          a.col(j))).epsilon(1e-7).margin(1e-10));
+    }
+  }
+
+  for (size_t j = 0; j < b.n_cols; ++j)
+  {
+    for (size_t i = 0; i < a.n_cols; ++i)
+    {
+      REQUIRE(bichromatic(i, j) == Approx(kernel.Evaluate(a.col(i),
+          b.col(j))).epsilon(1e-7).margin(1e-10));
+    }
+  }
+}
+
+TEST_CASE("KernelMatrixTest", "[KernelTest]")
+{
+  // Shift-invariant kernels, through the squared distances.
+  GaussianKernel gk(0.5);
+  CheckKernelMatrix(gk);
+  LaplacianKernel lk(0.3);
+  CheckKernelMatrix(lk);
+  CauchyKernel ck(0.7);
+  CheckKernelMatrix(ck);
+  EpanechnikovKernel ek(0.8);
+  CheckKernelMatrix(ek);
+
+  // Other kernels, through Evaluate().
+  PolynomialKernel pk(2.0, 1.0);
+  CheckKernelMatrix(pk);
+  LinearKernel linear;
+  CheckKernelMatrix(linear);
+}
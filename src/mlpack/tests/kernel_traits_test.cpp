@@ -55,3 +55,22 @@ TEST_CASE("IsNormalizedTest", "[KernelTraitsTest]")
   REQUIRE((bool) KernelTraits<PolynomialKernel>::IsNormalized == false);
   REQUIRE((bool) KernelTraits<PSpectrumStringKernel>::IsNormalized == false);
 }
+
+TEST_CASE("IsShiftInvariantTest", "[KernelTraitsTest]")
+{
+  // If the type is not a valid kernel, it should be false (default value).
+  REQUIRE((bool) KernelTraits<int>::IsShiftInvariant == false);
+
+  // Shift-invariant kernels.
+  REQUIRE((bool) KernelTraits<EpanechnikovKernel>::IsShiftInvariant == true);
+  REQUIRE((bool) KernelTraits<GaussianKernel>::IsShiftInvariant == true);
+  REQUIRE((bool) KernelTraits<LaplacianKernel>::IsShiftInvariant == true);
+  REQUIRE((bool) KernelTraits<SphericalKernel>::IsShiftInvariant == true);
+  REQUIRE((bool) KernelTraits<TriangularKernel>::IsShiftInvariant == true);
+  REQUIRE((bool) KernelTraits<CauchyKernel>::IsShiftInvariant == true);
+
+  // Other kernels.
+  REQUIRE((bool) KernelTraits<CosineDistance>::IsShiftInvariant == false);
+  REQUIRE((bool) KernelTraits<LinearKernel>::IsShiftInvariant == false);
+  REQUIRE((bool) KernelTraits<PolynomialKernel>::IsShiftInvariant == false);
+}
@@ -12,17 +12,23 @@
 #include <mlpack/methods/kmeans/kmeans.hpp>
 #include <mlpack/methods/kmeans/allow_empty_clusters.hpp>
 #include <mlpack/methods/kmeans/refined_start.hpp>
+#include <mlpack/methods/kmeans/kmeans_parallel_initialization.hpp>
 #include <mlpack/methods/kmeans/elkan_kmeans.hpp>
 #include <mlpack/methods/kmeans/hamerly_kmeans.hpp>
 #include <mlpack/methods/kmeans/pelleg_moore_kmeans.hpp>
 #include <mlpack/methods/kmeans/dual_tree_kmeans.hpp>
+#include <mlpack/methods/kmeans/minibatch_kmeans.hpp>
+#include <mlpack/methods/kmeans/spherical_kmeans.hpp>
+#include <mlpack/methods/kmeans/closest_centroids.hpp>
 #include <mlpack/methods/kmeans/sample_initialization.hpp>
 #include <mlpack/methods/kmeans/random_partition.hpp>
+#include <mlpack/methods/kmeans/distributed_kmeans.hpp>
 
 #include <mlpack/core/tree/cover_tree/cover_tree.hpp>
 #include <mlpack/methods/neighbor_search/neighbor_search.hpp>
 
 #include "catch.hpp"
+#include "thread_reduction.hpp"
 #include <mlpack/methods/kmeans/kill_empty_clusters.hpp>
 
 using namespace mlpack;
@@ -486,6 +492,75 @@ TEST_CASE("RefinedStartTest", "[KMeansTest]")
   REQUIRE(distortion < 14000.0);
 }
 
+/**
+ * Make sure that the k-means|| initialization places one centroid near each of
+ * several well-separated Gaussians, even when they have very different sizes.
+ */
+TEST_CASE("KMeansParallelInitializationTest", "[KMeansTest]")
+{
+  arma::mat centroids(" 0 20 -20   0  20;"
+                      " 0  0   0  20  20;"
+                      " 0  0  10 -10   0");
+  arma::mat data(3, 3000);
+  data.randn();
+  for (size_t i = 1000; i < 1200; ++i)
+    data.col(i) += centroids.col(1);
+  for (size_t i = 1200; i < 1700; ++i)
+    data.col(i) += centroids.col(2);
+  for (size_t i = 1700; i < 1750; ++i)
+    data.col(i) += centroids.col(3);
+  for (size_t i = 1750; i < 3000; ++i)
+    data.col(i) += centroids.col(4);
+
+  KMeansParallelInitialization kmpi;
+  REQUIRE(kmpi.Rounds() == 5);
+  REQUIRE(kmpi.Oversampling() == Approx(2.0));
+
+  arma::mat resultingCentroids;
+  kmpi.Cluster(data, 5, resultingCentroids);
+
+  REQUIRE(resultingCentroids.n_rows == 3);
+  REQUIRE(resultingCentroids.n_cols == 5);
+
+  // Each true centroid must have a resulting centroid close to it.
+  for (size_t i = 0; i < 5; ++i)
+  {
+    double minDistance = DBL_MAX;
+    for (size_t j = 0; j < 5; ++j)
+      minDistance = std::min(minDistance, metric::EuclideanDistance::Evaluate(
+          centroids.col(i), resultingCentroids.col(j)));
+
+    REQUIRE(minDistance < 2.0);
+  }
+}
+
+/**
+ * Make sure that KMeans clusters the simple dataset correctly with the
+ * k-means|| initialization.
+ */
+TEST_CASE("KMeansParallelKMeansTest", "[KMeansTest]")
+{
+  KMeans<EuclideanDistance, KMeansParallelInitialization> kmeans;
+
+  arma::Row<size_t> assignments;
+  kmeans.Cluster((arma::mat) trans(kMeansData), 3, assignments);
+
+  const size_t firstClass = assignments(0);
+  for (size_t i = 1; i < 13; ++i)
+    REQUIRE(assignments(i) == firstClass);
+
+  const size_t secondClass = assignments(13);
+  REQUIRE(firstClass != secondClass);
+  for (size_t i = 13; i < 20; ++i)
+    REQUIRE(assignments(i) == secondClass);
+
+  const size_t thirdClass = assignments(20);
+  REQUIRE(firstClass != thirdClass);
+  REQUIRE(secondClass != thirdClass);
+  for (size_t i = 20; i < 30; ++i)
+    REQUIRE(assignments(i) == thirdClass);
+}
+
 #ifdef ARMA_HAS_SPMAT
 /**
  * Make sure sparse k-means works okay.
@@ -531,6 +606,80 @@ TEST_CASE("SparseKMeansTest", "[KMeansTest]")
   REQUIRE(assignments[11] == clusterTwo);
 }
 
+/**
+ * Make sure that the closest centroids of a sparse dataset, computed from its
+ * nonzero values, are the same as those of the dense dataset.
+ */
+TEST_CASE("SparseClosestCentroidsTest", "[KMeansTest]")
+{
+  arma::sp_mat data;
+  data.sprandu(300, 1000, 0.02);
+  const arma::mat denseData(data);
+  arma::mat centroids(300, 8, arma::fill::randu);
+  centroids *= 0.1;
+
+  metric::EuclideanDistance metric;
+  ClosestCentroids<metric::EuclideanDistance, arma::sp_mat> sparseClosest(
+      data, centroids, metric);
+  ClosestCentroids<metric::EuclideanDistance, arma::mat> denseClosest(
+      denseData, centroids, metric);
+
+  arma::Col<size_t> sparseAssignments, denseAssignments;
+  sparseClosest.Assign(0, data.n_cols, sparseAssignments);
+  denseClosest.Assign(0, data.n_cols, denseAssignments);
+  REQUIRE(arma::all(sparseAssignments == denseAssignments));
+
+  // A full clustering gives the same centroids.
+  KMeans<metric::EuclideanDistance, RandomPartition, MaxVarianceNewCluster,
+         NaiveKMeans, arma::sp_mat> sparseKMeans;
+  KMeans<> denseKMeans;
+  arma::mat sparseCentroids(centroids), newDenseCentroids(centroids);
+  sparseKMeans.Cluster(data, 8, sparseCentroids, true);
+  denseKMeans.Cluster(denseData, 8, newDenseCentroids, true);
+  for (size_t i = 0; i < centroids.n_elem; ++i)
+  {
+    REQUIRE(sparseCentroids[i] ==
+        Approx(newDenseCentroids[i]).epsilon(1e-7).margin(1e-10));
+  }
+}
+
+/**
+ * Make sure that spherical k-means clusters sparse points by direction
+ * regardless of their norms, and returns centroids of unit length.
+ */
+TEST_CASE("SphericalKMeansTest", "[KMeansTest]")
+{
+  // Two groups of points along two directions, with very different norms.
+  arma::sp_mat data(1000, 40);
+  for (size_t i = 0; i < 40; ++i)
+  {
+    const double scale = (i % 4 == 0) ? 100.0 : 1.0 + 0.1 * i;
+    const size_t first = (i < 20) ? 10 : 700;
+    data(first, i) = scale;
+    data(first + 1, i) = scale * 0.5;
+    data(first + 2 + (i % 3), i) = scale * 0.2;
+  }
+
+  // Start from one small point of each group; Euclidean k-means would instead
+  // separate the points of large norm from the others.
+  arma::Row<size_t> assignments;
+  arma::mat centroids(1000, 2);
+  centroids.col(0) = arma::vec(data.col(1));
+  centroids.col(1) = arma::vec(data.col(21));
+  KMeans<metric::EuclideanDistance, SampleInitialization,
+         MaxVarianceNewCluster, SphericalKMeans, arma::sp_mat> kmeans;
+  kmeans.Cluster(data, 2, assignments, centroids, false, true);
+
+  for (size_t i = 0; i < 20; ++i)
+    REQUIRE(assignments[i] == assignments[0]);
+  for (size_t i = 20; i < 40; ++i)
+    REQUIRE(assignments[i] == assignments[20]);
+  REQUIRE(assignments[0] != assignments[20]);
+
+  for (size_t i = 0; i < centroids.n_cols; ++i)
+    REQUIRE(arma::norm(centroids.col(i), 2) == Approx(1.0).epsilon(1e-7));
+}
+
 #endif // ARMA_HAS_SPMAT
 
 TEST_CASE("ElkanTest", "[KMeansTest]")
@@ -668,6 +817,46 @@ TEST_CASE("DTNNTest", "[KMeansTest]")
   }
 }
 
+/**
+ * Make sure that the dual-tree iterations give the same centroids as the naive
+ * ones while the tree on the centroids is refitted instead of rebuilt.
+ */
+TEST_CASE("DTNNRefitTest", "[KMeansTest]")
+{
+  arma::mat dataset(5, 2000, arma::fill::randn);
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+    dataset.col(i) += 10.0 * (i % 8);
+
+  arma::mat centroids = dataset.cols(0, 15);
+  metric::EuclideanDistance metric;
+  NaiveKMeans<metric::EuclideanDistance, arma::mat> naive(dataset, metric);
+  DefaultDualTreeKMeans<metric::EuclideanDistance, arma::mat> dtnn(dataset,
+      metric);
+
+  arma::mat naiveCentroids(centroids), dtnnCentroids(centroids);
+  arma::mat newNaiveCentroids, newDtnnCentroids;
+  arma::Col<size_t> naiveCounts, dtnnCounts;
+  const size_t iterations = 30;
+  for (size_t i = 0; i < iterations; ++i)
+  {
+    naive.Iterate(naiveCentroids, newNaiveCentroids, naiveCounts);
+    dtnn.Iterate(dtnnCentroids, newDtnnCentroids, dtnnCounts);
+
+    REQUIRE(arma::all(naiveCounts == dtnnCounts));
+    for (size_t j = 0; j < newNaiveCentroids.n_elem; ++j)
+    {
+      REQUIRE(newDtnnCentroids[j] ==
+          Approx(newNaiveCentroids[j]).epsilon(1e-7).margin(1e-10));
+    }
+
+    naiveCentroids = newNaiveCentroids;
+    dtnnCentroids = newDtnnCentroids;
+  }
+
+  // Once the centroids barely move, the tree is no longer rebuilt.
+  REQUIRE(dtnn.CentroidTreeBuilds() < iterations / 2);
+}
+
 TEST_CASE("DTNNCoverTreeTest", "[KMeansTest]")
 {
   const size_t trials = 5;
@@ -700,6 +889,145 @@ TEST_CASE("DTNNCoverTreeTest", "[KMeansTest]")
   }
 }
 
+/**
+ * Make sure that the closest centroids found with a matrix multiplication are
+ * the same as those found with the metric, even with exact ties.
+ */
+TEST_CASE("ClosestCentroidsTest", "[KMeansTest]")
+{
+  arma::mat dataset = arma::randu<arma::mat>(20, 1000);
+
+  // Some centroids are points of the dataset, and two are duplicates of each
+  // other, so that there are distances of 0 and exact ties.
+  arma::mat centroids = arma::randu<arma::mat>(20, 50);
+  centroids.cols(0, 9) = dataset.cols(100, 109);
+  centroids.col(10) = centroids.col(20);
+
+  EuclideanDistance metric;
+  ClosestCentroids<EuclideanDistance, arma::mat> closest(dataset, centroids,
+      metric);
+  arma::Col<size_t> assignments;
+  closest.Assign(37, 1000, assignments);
+  REQUIRE(assignments.n_elem == 963);
+
+  for (size_t i = 37; i < 1000; ++i)
+  {
+    double minDistance = DBL_MAX;
+    size_t closestCluster = 0;
+    for (size_t j = 0; j < centroids.n_cols; ++j)
+    {
+      const double distance = metric.Evaluate(dataset.col(i),
+          centroids.col(j));
+      if (distance < minDistance)
+      {
+        minDistance = distance;
+        closestCluster = j;
+      }
+    }
+
+    REQUIRE(assignments[i - 37] == closestCluster);
+  }
+
+  for (size_t i = 0; i < 10; ++i)
+    REQUIRE(assignments[100 + i - 37] == i);
+}
+
+/**
+ * Generate three well-separated Gaussian clusters, with initial centroids taken
+ * from each cluster.
+ */
+static void MiniBatchData(arma::mat& dataset,
+                          arma::mat& trueCentroids,
+                          arma::mat& initialCentroids)
+{
+  trueCentroids = { { 0.0, 10.0, -10.0 },
+                    { 0.0, 10.0,  10.0 } };
+  dataset.randn(2, 3000);
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+    dataset.col(i) += trueCentroids.col(i % 3);
+
+  initialCentroids = dataset.cols(0, 2);
+}
+
+/**
+ * Make sure that mini-batch k-means finds well-separated clusters.
+ */
+TEST_CASE("MiniBatchKMeansTest", "[KMeansTest]")
+{
+  arma::mat dataset, trueCentroids, centroids;
+  MiniBatchData(dataset, trueCentroids, centroids);
+
+  KMeans<EuclideanDistance, SampleInitialization, MaxVarianceNewCluster,
+      MiniBatchKMeans> km(200);
+  arma::Row<size_t> assignments;
+  km.Cluster(dataset, 3, assignments, centroids, false, true);
+
+  for (size_t i = 0; i < 3; ++i)
+  {
+    REQUIRE(arma::norm(centroids.col(i) - trueCentroids.col(i)) < 0.2);
+    for (size_t j = i; j < dataset.n_cols; j += 3)
+      REQUIRE(assignments[j] == i);
+  }
+}
+
+/**
+ * A batch source for the streaming k-means API that hands out the columns of a
+ * matrix in fixed-size batches.
+ */
+class TestBatchSource
+{
+ public:
+  TestBatchSource(const arma::mat& data, const size_t batchSize) :
+      data(data), batchSize(batchSize), position(0) { }
+
+  bool NextBatch(arma::mat& batch)
+  {
+    if (position >= data.n_cols)
+      return false;
+
+    const size_t end = std::min(position + batchSize, (size_t) data.n_cols);
+    batch = data.cols(position, end - 1);
+    position = end;
+    return true;
+  }
+
+  size_t Position() const { return position; }
+
+ private:
+  const arma::mat& data;
+  size_t batchSize;
+  size_t position;
+};
+
+/**
+ * Make sure that streaming mini-batch k-means consumes the whole source and
+ * finds well-separated clusters.
+ */
+TEST_CASE("StreamingMiniBatchKMeansTest", "[KMeansTest]")
+{
+  arma::mat dataset, trueCentroids, centroids;
+  MiniBatchData(dataset, trueCentroids, centroids);
+
+  KMeans<> km(0);
+  TestBatchSource source(dataset, 250);
+  km.Cluster(source, 3, centroids, true);
+
+  REQUIRE(source.Position() == dataset.n_cols);
+  for (size_t i = 0; i < 3; ++i)
+    REQUIRE(arma::norm(centroids.col(i) - trueCentroids.col(i)) < 0.2);
+
+  // Without an initial guess the first batch is used for initialization; only
+  // check that the requested number of batches was used.
+  KMeans<> limited(2);
+  TestBatchSource limitedSource(dataset, 250);
+  arma::mat limitedCentroids;
+  limited.Cluster(limitedSource, 3, limitedCentroids);
+
+  REQUIRE(limitedSource.Position() == 500);
+  REQUIRE(limitedCentroids.n_rows == 2);
+  REQUIRE(limitedCentroids.n_cols == 3);
+}
+
 /**
  * Make sure that the sample initialization strategy successfully samples points
  * from the dataset.
@@ -733,3 +1061,223 @@ TEST_CASE("SampleInitializationTest", "[KMeansTest]")
     REQUIRE(j < dataset.n_cols);
   }
 }
+
+// Split the given dataset into the given number of shards, point i going to
+// shard i % shards.
+std::vector<arma::mat> SplitShards(const arma::mat& dataset,
+                                   const size_t shards)
+{
+  std::vector<arma::mat> result(shards);
+  for (size_t r = 0; r < shards; ++r)
+  {
+    result[r] = dataset.cols(arma::regspace<arma::uvec>(r, shards,
+        dataset.n_cols - 1));
+  }
+  return result;
+}
+
+// Check that k-means with the given step on the shards of a dataset, with one
+// thread standing for each process, gives the clustering of the whole
+// dataset.
+template<template<class, class> class LloydStepType>
+void CheckDistributedKMeans()
+{
+  arma::mat dataset(3, 3000);
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+    dataset.col(i) = 5.0 * (i % 3) + arma::randn<arma::vec>(3);
+  const arma::mat initialCentroids = dataset.cols(0, 3);
+
+  arma::mat centroids = initialCentroids;
+  arma::Row<size_t> assignments;
+  KMeans<EuclideanDistance, SampleInitialization, AllowEmptyClusters,
+      LloydStepType> kmeans;
+  kmeans.Cluster(dataset, 4, assignments, centroids, false, true);
+
+  const size_t shards = 4;
+  const std::vector<arma::mat> shardData = SplitShards(dataset, shards);
+  std::vector<arma::mat> shardCentroids(shards, initialCentroids);
+  std::vector<arma::Row<size_t>> shardAssignments(shards);
+  ThreadReduction::Run(shards, [&](const size_t r)
+  {
+    DistributedKMeans<ThreadReduction, LloydStepType> distributed;
+    distributed.Cluster(shardData[r], 4, shardAssignments[r],
+        shardCentroids[r], false, true);
+  });
+
+  for (size_t r = 0; r < shards; ++r)
+  {
+    REQUIRE(shardCentroids[r].n_cols == 4);
+    for (size_t i = 0; i < centroids.n_elem; ++i)
+      REQUIRE(shardCentroids[r][i] == Approx(centroids[i]).margin(1e-8));
+
+    for (size_t i = 0; i < shardAssignments[r].n_elem; ++i)
+      REQUIRE(shardAssignments[r][i] == assignments[r + i * shards]);
+  }
+}
+
+/**
+ * Make sure that distributed k-means with the naive step finds the clustering
+ * of the whole dataset.
+ */
+TEST_CASE("DistributedNaiveKMeansTest", "[KMeansTest]")
+{
+  CheckDistributedKMeans<NaiveKMeans>();
+}
+
+/**
+ * Make sure that distributed k-means with Elkan's step finds the clustering of
+ * the whole dataset, although the centroids given to each step are not those
+ * it computed.
+ */
+TEST_CASE("DistributedElkanKMeansTest", "[KMeansTest]")
+{
+  CheckDistributedKMeans<ElkanKMeans>();
+}
+
+// An initial partition policy taking the first points of the dataset.
+class FirstPointsInitialization
+{
+ public:
+  template<typename MatType>
+  static void Cluster(const MatType& data,
+                      const size_t clusters,
+                      arma::mat& centroids)
+  {
+    centroids = data.cols(0, clusters - 1);
+  }
+};
+
+// An initial partition policy assigning point i to cluster i % clusters.
+class ModuloPartition
+{
+ public:
+  template<typename MatType>
+  static void Cluster(const MatType& data,
+                      const size_t clusters,
+                      arma::Row<size_t>& assignments)
+  {
+    assignments.set_size(data.n_cols);
+    for (size_t i = 0; i < data.n_cols; ++i)
+      assignments[i] = i % clusters;
+  }
+};
+
+/**
+ * Make sure that DistributedInitialization gives the centroids of the first
+ * process to every process, or the means of the assigned points of all
+ * processes.
+ */
+TEST_CASE("DistributedInitializationTest", "[KMeansTest]")
+{
+  const size_t shards = 3;
+  std::vector<arma::mat> shardData(shards);
+  for (size_t r = 0; r < shards; ++r)
+    shardData[r] = arma::randu<arma::mat>(2, 10 + r);
+
+  std::vector<arma::mat> sampled(shards), partitioned(shards);
+  ThreadReduction::Run(shards, [&](const size_t r)
+  {
+    DistributedInitialization<FirstPointsInitialization, ThreadReduction>
+        sampler;
+    sampler.Cluster(shardData[r], 3, sampled[r]);
+
+    DistributedInitialization<ModuloPartition, ThreadReduction> partitioner;
+    partitioner.Cluster(shardData[r], 3, partitioned[r]);
+  });
+
+  // The expected means of the assigned points.
+  arma::mat sums(2, 3, arma::fill::zeros);
+  arma::vec counts(3, arma::fill::zeros);
+  for (size_t r = 0; r < shards; ++r)
+  {
+    for (size_t i = 0; i < shardData[r].n_cols; ++i)
+    {
+      sums.col(i % 3) += shardData[r].col(i);
+      counts[i % 3]++;
+    }
+  }
+
+  for (size_t r = 0; r < shards; ++r)
+  {
+    for (size_t c = 0; c < 3; ++c)
+    {
+      for (size_t d = 0; d < 2; ++d)
+      {
+        REQUIRE(sampled[r](d, c) == shardData[0](d, c));
+        REQUIRE(partitioned[r](d, c) ==
+            Approx(sums(d, c) / counts[c]).epsilon(1e-10));
+      }
+    }
+  }
+}
+
+/**
+ * Make sure that the reduction given to the initialization of distributed
+ * k-means is also the one used by its iterations: two groups of threads, each
+ * with its own reduction, cluster the shards of two datasets at the same time.
+ */
+TEST_CASE("DistributedKMeansReductionInstanceTest", "[KMeansTest]")
+{
+  const size_t shards = 3;
+  std::vector<arma::mat> datasets(2);
+  std::vector<arma::mat> centroids(2);
+  std::vector<arma::Row<size_t>> assignments(2);
+  for (size_t g = 0; g < 2; ++g)
+  {
+    datasets[g].set_size(2, 600);
+    for (size_t i = 0; i < datasets[g].n_cols; ++i)
+      datasets[g].col(i) = (4.0 + g) * (i % 3) + arma::randn<arma::vec>(2);
+
+    // The first points of the first shard are the initial centroids.
+    centroids[g] = datasets[g].cols(arma::uvec({ 0, shards, 2 * shards }));
+    KMeans<EuclideanDistance, SampleInitialization, AllowEmptyClusters> kmeans;
+    kmeans.Cluster(datasets[g], 3, assignments[g], centroids[g], false, true);
+  }
+
+  // The default group now holds a single thread, so a step reducing over it
+  // would not see the other shards.
+  ThreadReduction::Run(1, [](const size_t /* r */) { });
+
+  typedef DistributedInitialization<FirstPointsInitialization, ThreadReduction>
+      InitializationType;
+  std::vector<std::vector<arma::mat>> shardCentroids(2,
+      std::vector<arma::mat>(shards));
+  std::vector<std::vector<arma::Row<size_t>>> shardAssignments(2,
+      std::vector<arma::Row<size_t>>(shards));
+  std::vector<std::thread> groups;
+  for (size_t g = 0; g < 2; ++g)
+  {
+    groups.push_back(std::thread([&, g]()
+    {
+      const std::vector<arma::mat> shardData = SplitShards(datasets[g],
+          shards);
+      ThreadReduction::Run(shards, [&](const size_t r)
+      {
+        KMeans<EuclideanDistance, InitializationType, AllowEmptyClusters,
+            DistributedStep<ThreadReduction>::Type> kmeans(1000,
+            EuclideanDistance(), InitializationType(
+            FirstPointsInitialization(), ThreadReduction(g + 1)));
+        kmeans.Cluster(shardData[r], 3, shardAssignments[g][r],
+            shardCentroids[g][r]);
+      }, g + 1);
+    }));
+  }
+  for (size_t g = 0; g < 2; ++g)
+    groups[g].join();
+
+  for (size_t g = 0; g < 2; ++g)
+  {
+    for (size_t r = 0; r < shards; ++r)
+    {
+      REQUIRE(shardCentroids[g][r].n_cols == 3);
+      for (size_t i = 0; i < centroids[g].n_elem; ++i)
+      {
+        REQUIRE(shardCentroids[g][r][i] ==
+            Approx(centroids[g][i]).margin(1e-8));
+      }
+
+      for (size_t i = 0; i < shardAssignments[g][r].n_elem; ++i)
+        REQUIRE(shardAssignments[g][r][i] == assignments[g][r + i * shards]);
+    }
+  }
+}
@@ -12,9 +12,13 @@
 #include <mlpack/methods/neighbor_search/neighbor_search.hpp>
 #include <mlpack/methods/neighbor_search/unmap.hpp>
 #include <mlpack/methods/neighbor_search/ns_model.hpp>
+#include <mlpack/methods/neighbor_search/sharded_ns_model.hpp>
 #include <mlpack/core/tree/cover_tree.hpp>
+#include <mlpack/core/tree/parallel_dual_tree_traversal.hpp>
 #include <mlpack/core/tree/example_tree.hpp>
+#include <mlpack/core/metrics/mahalanobis_search.hpp>
 #include "test_catch_tools.hpp"
+#include "serialization_catch.hpp"
 #include "catch.hpp"
 
 using namespace mlpack;
@@ -23,6 +27,8 @@ using namespace mlpack::tree;
 using namespace mlpack::metric;
 using namespace mlpack::bound;
 
+typedef NSModel<NearestNeighborSort> KNNModel;
+
 /**
  * Test that Unmap() works in the dual-tree case (see unmap.hpp).
  */
@@ -718,6 +724,842 @@ TEST_CASE("KNNDualTreeVsNaive2", "[KNNTest]")
   }
 }
 
+/**
+ * Make sure that the parallel dual-tree traversal (where disjoint query
+ * subtrees are traversed on different threads) gives the same results as naive
+ * search, for both the monochromatic and bichromatic cases, and for a few
+ * different types of trees.
+ */
+template<template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void ParallelDualTreeVsNaive(const arma::mat& referenceData,
+                             const arma::mat& queryData)
+{
+  NeighborSearch<NearestNeighborSort, EuclideanDistance, arma::mat, TreeType>
+      treeSearch(referenceData);
+  KNN naive(referenceData, NAIVE_MODE);
+
+  arma::Mat<size_t> neighborsTree, neighborsNaive;
+  arma::mat distancesTree, distancesNaive;
+
+  treeSearch.Search(queryData, 10, neighborsTree, distancesTree);
+  naive.Search(queryData, 10, neighborsNaive, distancesNaive);
+
+  REQUIRE(neighborsTree.n_rows == neighborsNaive.n_rows);
+  REQUIRE(neighborsTree.n_cols == neighborsNaive.n_cols);
+  for (size_t i = 0; i < neighborsTree.n_elem; ++i)
+  {
+    REQUIRE(neighborsTree[i] == neighborsNaive[i]);
+    REQUIRE(distancesTree[i] == Approx(distancesNaive[i]).epsilon(1e-7));
+  }
+
+  treeSearch.Search(10, neighborsTree, distancesTree);
+  naive.Search(10, neighborsNaive, distancesNaive);
+
+  for (size_t i = 0; i < neighborsTree.n_elem; ++i)
+  {
+    REQUIRE(neighborsTree[i] == neighborsNaive[i]);
+    REQUIRE(distancesTree[i] == Approx(distancesNaive[i]).epsilon(1e-7));
+  }
+}
+
+TEST_CASE("KNNParallelDualTreeVsNaive", "[KNNTest]")
+{
+  #ifdef HAS_OPENMP
+  const int oldThreads = omp_get_max_threads();
+  omp_set_num_threads(4);
+  #endif
+
+  arma::mat referenceData = arma::randu<arma::mat>(4, 2000);
+  arma::mat queryData = arma::randu<arma::mat>(4, 1500);
+
+  ParallelDualTreeVsNaive<KDTree>(referenceData, queryData);
+  ParallelDualTreeVsNaive<BallTree>(referenceData, queryData);
+  ParallelDualTreeVsNaive<StandardCoverTree>(referenceData, queryData);
+  ParallelDualTreeVsNaive<RStarTree>(referenceData, queryData);
+  ParallelDualTreeVsNaive<Octree>(referenceData, queryData);
+  // Spill trees may hold a point in two nodes, so each thread has its own
+  // candidate lists.
+  ParallelDualTreeVsNaive<SPTree>(referenceData, queryData);
+
+  #ifdef HAS_OPENMP
+  omp_set_num_threads(oldThreads);
+  #endif
+}
+
+/**
+ * Make sure that parallel single-tree search, where the query set is split
+ * into blocks that are searched on different threads, gives the same results
+ * as naive search, for any number of threads.
+ */
+TEST_CASE("KNNParallelSingleTreeVsNaive", "[KNNTest]")
+{
+  arma::mat referenceData = arma::randu<arma::mat>(5, 1000);
+  arma::mat queryData = arma::randu<arma::mat>(5, 777);
+
+  KNN naive(referenceData, NAIVE_MODE);
+  arma::Mat<size_t> neighborsNaive;
+  arma::mat distancesNaive;
+  naive.Search(queryData, 7, neighborsNaive, distancesNaive);
+
+  KNN knn(referenceData, SINGLE_TREE_MODE);
+  for (size_t threads = 1; threads <= 5; ++threads)
+  {
+    knn.NumThreads() = threads;
+
+    arma::Mat<size_t> neighborsTree;
+    arma::mat distancesTree;
+    knn.Search(queryData, 7, neighborsTree, distancesTree);
+
+    REQUIRE(neighborsTree.n_rows == neighborsNaive.n_rows);
+    REQUIRE(neighborsTree.n_cols == neighborsNaive.n_cols);
+    for (size_t i = 0; i < neighborsTree.n_elem; ++i)
+    {
+      REQUIRE(neighborsTree[i] == neighborsNaive[i]);
+      REQUIRE(distancesTree[i] == Approx(distancesNaive[i]).epsilon(1e-7));
+    }
+  }
+}
+
+/**
+ * Make sure that the parallel breadth-first traverser, with one set of rules
+ * per thread, finds the same neighbors as naive search once the results of
+ * all the rules are combined.
+ */
+TEST_CASE("KNNParallelBreadthFirstVsNaive", "[KNNTest]")
+{
+  typedef KDTree<EuclideanDistance, NeighborSearchStat<NearestNeighborSort>,
+      arma::mat> TreeType;
+  typedef NeighborSearchRules<NearestNeighborSort, EuclideanDistance, TreeType>
+      RuleType;
+
+  arma::mat referenceData = arma::randu<arma::mat>(4, 2000);
+  arma::mat queryData = arma::randu<arma::mat>(4, 1500);
+  TreeType referenceTree(referenceData, 10);
+  TreeType queryTree(queryData, 10);
+
+  KNN naive(referenceTree.Dataset(), NAIVE_MODE);
+  arma::Mat<size_t> neighborsNaive;
+  arma::mat distancesNaive;
+  naive.Search(queryTree.Dataset(), 5, neighborsNaive, distancesNaive);
+
+  EuclideanDistance metric;
+  for (size_t threads = 1; threads <= 4; ++threads)
+  {
+    // Reset the statistics of the query tree.
+    std::stack<TreeType*> stack;
+    stack.push(&queryTree);
+    while (!stack.empty())
+    {
+      TreeType* node = stack.top();
+      stack.pop();
+      node->Stat().Reset();
+      for (size_t i = 0; i < node->NumChildren(); ++i)
+        stack.push(&node->Child(i));
+    }
+
+    std::vector<RuleType> rules(threads, RuleType(referenceTree.Dataset(),
+        queryTree.Dataset(), 5, metric));
+    TreeType::ParallelBreadthFirstDualTreeTraverser<RuleType> traverser(rules);
+    traverser.Traverse(queryTree, referenceTree);
+
+    // Every query point is in the results of the rules that evaluated its
+    // leaf; the other rules have no candidates for it.
+    arma::Mat<size_t> neighborsTree(5, queryData.n_cols);
+    arma::mat distancesTree(5, queryData.n_cols);
+    distancesTree.fill(DBL_MAX);
+    for (size_t t = 0; t < threads; ++t)
+    {
+      arma::Mat<size_t> neighbors;
+      arma::mat distances;
+      rules[t].GetResults(neighbors, distances);
+      for (size_t q = 0; q < queryData.n_cols; ++q)
+      {
+        if (distances(0, q) < distancesTree(0, q))
+        {
+          neighborsTree.col(q) = neighbors.col(q);
+          distancesTree.col(q) = distances.col(q);
+        }
+      }
+    }
+
+    for (size_t i = 0; i < neighborsTree.n_elem; ++i)
+    {
+      REQUIRE(neighborsTree[i] == neighborsNaive[i]);
+      REQUIRE(distancesTree[i] == Approx(distancesNaive[i]).epsilon(1e-7));
+    }
+  }
+}
+
+/**
+ * Make sure that the generic parallel dual-tree traversal, which splits the
+ * NeighborSearchRules between threads and merges them back, gives the same
+ * results as naive search.
+ */
+TEST_CASE("KNNGenericParallelDualTreeVsNaive", "[KNNTest]")
+{
+  typedef KDTree<EuclideanDistance, NeighborSearchStat<NearestNeighborSort>,
+      arma::mat> TreeType;
+  typedef NeighborSearchRules<NearestNeighborSort, EuclideanDistance, TreeType>
+      RuleType;
+
+  arma::mat referenceData = arma::randu<arma::mat>(3, 2000);
+  arma::mat queryData = arma::randu<arma::mat>(3, 1000);
+  TreeType referenceTree(referenceData, 15);
+
+  KNN naive(referenceTree.Dataset(), NAIVE_MODE);
+
+  EuclideanDistance metric;
+  for (size_t threads = 1; threads <= 4; ++threads)
+  {
+    TreeType queryTree(queryData, 15);
+    arma::Mat<size_t> neighborsNaive;
+    arma::mat distancesNaive;
+    naive.Search(queryTree.Dataset(), 4, neighborsNaive, distancesNaive);
+
+    RuleType rules(referenceTree.Dataset(), queryTree.Dataset(), 4, metric);
+    ParallelDualTreeTraversal<TreeType::DualTreeTraverser>(queryTree,
+        referenceTree, rules, threads);
+
+    arma::Mat<size_t> neighborsTree;
+    arma::mat distancesTree;
+    rules.GetResults(neighborsTree, distancesTree);
+
+    REQUIRE(rules.BaseCases() > 0);
+    for (size_t i = 0; i < neighborsTree.n_elem; ++i)
+    {
+      REQUIRE(neighborsTree[i] == neighborsNaive[i]);
+      REQUIRE(distancesTree[i] == Approx(distancesNaive[i]).epsilon(1e-7));
+    }
+  }
+}
+
+/**
+ * Make sure that a budget of base cases bounds the work done for each query
+ * point, and that the query points that didn't run out of budget get exact
+ * results.
+ */
+TEST_CASE("KNNMaxBaseCasesTest", "[KNNTest]")
+{
+  arma::mat referenceData = arma::randu<arma::mat>(5, 3000);
+  arma::mat queryData = arma::randu<arma::mat>(5, 500);
+
+  KNN naive(referenceData, NAIVE_MODE);
+  arma::Mat<size_t> neighborsNaive;
+  arma::mat distancesNaive;
+  naive.Search(queryData, 5, neighborsNaive, distancesNaive);
+
+  const NeighborSearchMode modes[] = { SINGLE_TREE_MODE,
+      GREEDY_SINGLE_TREE_MODE };
+  for (const NeighborSearchMode mode : modes)
+  {
+    KNN knn(referenceData, mode);
+    knn.MaxBaseCases() = 60;
+
+    arma::Mat<size_t> neighbors;
+    arma::mat distances;
+    knn.Search(queryData, 5, neighbors, distances);
+
+    REQUIRE(knn.BaseCases() <= 60 * queryData.n_cols);
+    if (mode == SINGLE_TREE_MODE)
+      REQUIRE(knn.TruncatedQueries().size() > 0);
+
+    std::vector<bool> truncated(queryData.n_cols, false);
+    for (size_t i = 0; i < knn.TruncatedQueries().size(); ++i)
+      truncated[knn.TruncatedQueries()[i]] = true;
+
+    for (size_t i = 0; i < queryData.n_cols; ++i)
+    {
+      // Even truncated results must hold valid neighbors.
+      for (size_t j = 0; j < 5; ++j)
+        REQUIRE(neighbors(j, i) < referenceData.n_cols);
+
+      if (mode == SINGLE_TREE_MODE && !truncated[i])
+      {
+        for (size_t j = 0; j < 5; ++j)
+        {
+          REQUIRE(neighbors(j, i) == neighborsNaive(j, i));
+          REQUIRE(distances(j, i) ==
+              Approx(distancesNaive(j, i)).epsilon(1e-7));
+        }
+      }
+    }
+
+    // A large enough budget gives exact results.
+    knn.MaxBaseCases() = referenceData.n_cols;
+    knn.Search(queryData, 5, neighbors, distances);
+    REQUIRE(knn.TruncatedQueries().size() == 0);
+    if (mode == SINGLE_TREE_MODE)
+    {
+      for (size_t i = 0; i < neighbors.n_elem; ++i)
+        REQUIRE(neighbors[i] == neighborsNaive[i]);
+    }
+  }
+}
+
+//! Compare dual-tree search with block base cases against naive search.
+template<typename SortPolicy, typename MetricType, template<typename,
+    typename, typename> class TreeType>
+void BlockBaseCasesVsNaive(const arma::mat& referenceData,
+                           const arma::mat& queryData)
+{
+  typedef NeighborSearch<SortPolicy, MetricType, arma::mat, TreeType>
+      SearchType;
+
+  SearchType naive(referenceData, NAIVE_MODE);
+  arma::Mat<size_t> neighborsNaive;
+  arma::mat distancesNaive;
+  naive.Search(queryData, 5, neighborsNaive, distancesNaive);
+
+  SearchType search(referenceData, DUAL_TREE_MODE);
+  search.BlockBaseCases() = true;
+  arma::Mat<size_t> neighborsTree;
+  arma::mat distancesTree;
+  search.Search(queryData, 5, neighborsTree, distancesTree);
+
+  REQUIRE(neighborsTree.n_rows == neighborsNaive.n_rows);
+  REQUIRE(neighborsTree.n_cols == neighborsNaive.n_cols);
+  for (size_t i = 0; i < neighborsTree.n_elem; ++i)
+  {
+    REQUIRE(neighborsTree[i] == neighborsNaive[i]);
+    REQUIRE(distancesTree[i] == Approx(distancesNaive[i]).epsilon(1e-7));
+  }
+
+  // Monochromatic search must not return the query points themselves.
+  naive.Search(5, neighborsNaive, distancesNaive);
+  search.Search(5, neighborsTree, distancesTree);
+  for (size_t i = 0; i < neighborsTree.n_elem; ++i)
+  {
+    REQUIRE(neighborsTree[i] == neighborsNaive[i]);
+    REQUIRE(distancesTree[i] == Approx(distancesNaive[i]).epsilon(1e-7));
+  }
+}
+
+/**
+ * Make sure that evaluating pairs of leaves as blocks gives the same results as
+ * naive search, for both the matrix multiplication (Euclidean) and the batched
+ * (other LMetrics) block computations.
+ */
+TEST_CASE("KNNBlockBaseCasesVsNaive", "[KNNTest]")
+{
+  // Offset the data so that the norms are large compared to the distances.
+  arma::mat referenceData = arma::randu<arma::mat>(40, 1200) + 10.0;
+  arma::mat queryData = arma::randu<arma::mat>(40, 300) + 10.0;
+
+  BlockBaseCasesVsNaive<NearestNeighborSort, EuclideanDistance, KDTree>(
+      referenceData, queryData);
+  BlockBaseCasesVsNaive<NearestNeighborSort, SquaredEuclideanDistance,
+      BallTree>(referenceData, queryData);
+  BlockBaseCasesVsNaive<NearestNeighborSort, ManhattanDistance, KDTree>(
+      referenceData, queryData);
+  BlockBaseCasesVsNaive<FurthestNeighborSort, EuclideanDistance, KDTree>(
+      referenceData, queryData);
+  BlockBaseCasesVsNaive<NearestNeighborSort, LMetric<3, true>, BallTree>(
+      referenceData, queryData);
+}
+
+//! Compare tree-based search on single-precision data against naive search.
+template<template<typename, typename, typename> class TreeType>
+void FloatTreeVsNaive(const arma::fmat& referenceData,
+                      const arma::fmat& queryData)
+{
+  typedef NeighborSearch<NearestNeighborSort, EuclideanDistance, arma::fmat,
+      TreeType> SearchType;
+
+  SearchType naive(referenceData, NAIVE_MODE);
+  arma::Mat<size_t> neighborsNaive;
+  arma::mat distancesNaive;
+  naive.Search(queryData, 3, neighborsNaive, distancesNaive);
+
+  SearchType dualTree(referenceData);
+  SearchType singleTree(referenceData, SINGLE_TREE_MODE);
+  arma::Mat<size_t> neighborsDual, neighborsSingle;
+  arma::mat distancesDual, distancesSingle;
+  dualTree.Search(queryData, 3, neighborsDual, distancesDual);
+  singleTree.Search(queryData, 3, neighborsSingle, distancesSingle);
+
+  CheckMatrices(neighborsDual, neighborsNaive);
+  CheckMatrices(neighborsSingle, neighborsNaive);
+  CheckMatrices(distancesDual, distancesNaive);
+  CheckMatrices(distancesSingle, distancesNaive);
+}
+
+/**
+ * Make sure that neighbor search works with single-precision datasets.
+ */
+TEST_CASE("KNNFloatTreesVsNaive", "[KNNTest]")
+{
+  arma::fmat referenceData = arma::randu<arma::fmat>(4, 800);
+  arma::fmat queryData = arma::randu<arma::fmat>(4, 200);
+
+  FloatTreeVsNaive<KDTree>(referenceData, queryData);
+  FloatTreeVsNaive<BallTree>(referenceData, queryData);
+  FloatTreeVsNaive<StandardCoverTree>(referenceData, queryData);
+  FloatTreeVsNaive<RStarTree>(referenceData, queryData);
+}
+
+/**
+ * Make sure that distances stored in single precision are rounded towards the
+ * worst distance, so that stored bounds are never too tight.
+ */
+TEST_CASE("KNNStoredDistanceTest", "[KNNTest]")
+{
+  typedef StoredDistance<NearestNeighborSort, float> NearestDistance;
+  typedef StoredDistance<FurthestNeighborSort, float> FurthestDistance;
+
+  const double distance = 0.1;
+  REQUIRE((double) NearestDistance::Store(distance) > distance);
+  REQUIRE((double) FurthestDistance::Store(distance) < distance);
+  REQUIRE(NearestDistance::Store(0.5) == 0.5f);
+  REQUIRE(FurthestDistance::Store(0.5) == 0.5f);
+
+  REQUIRE(NearestDistance::Store(DBL_MAX) == FLT_MAX);
+  REQUIRE(NearestDistance::Load(FLT_MAX) == DBL_MAX);
+  REQUIRE(FurthestDistance::Store(0.0) == 0.0f);
+
+  NeighborSearchStat<NearestNeighborSort, float> stat;
+  REQUIRE(stat.FirstBound() == FLT_MAX);
+  REQUIRE(sizeof(stat) < sizeof(NeighborSearchStat<NearestNeighborSort>));
+}
+
+/**
+ * Make sure that a single-precision KNNModel gives the same results as naive
+ * single-precision search, on double-precision data, and keeps them when it is
+ * serialized.
+ */
+TEST_CASE("KNNModelSinglePrecisionTest", "[KNNTest]")
+{
+  arma::mat referenceData = arma::randu<arma::mat>(4, 600);
+  arma::mat queryData = arma::randu<arma::mat>(4, 100);
+
+  NeighborSearch<NearestNeighborSort, EuclideanDistance, arma::fmat> naive(
+      arma::conv_to<arma::fmat>::from(referenceData), NAIVE_MODE);
+  arma::Mat<size_t> naiveNeighbors;
+  arma::mat naiveDistances;
+  naive.Search(arma::conv_to<arma::fmat>::from(queryData), 5, naiveNeighbors,
+      naiveDistances);
+
+  const KNNModel::TreeTypes treeTypes[] = { KNNModel::KD_TREE,
+      KNNModel::COVER_TREE, KNNModel::R_STAR_TREE, KNNModel::BALL_TREE };
+  const NeighborSearchMode modes[] = { DUAL_TREE_MODE, SINGLE_TREE_MODE };
+  for (size_t t = 0; t < 4; ++t)
+  {
+    for (size_t m = 0; m < 2; ++m)
+    {
+      KNNModel model(treeTypes[t], false, true);
+      model.BuildModel(arma::mat(referenceData), 20, modes[m]);
+      REQUIRE(model.DatasetSize() == arma::size(referenceData));
+
+      arma::Mat<size_t> neighbors;
+      arma::mat distances;
+      SearchStatistics statistics;
+      model.Search(queryData, 5, neighbors, distances, statistics);
+
+      CheckMatrices(neighbors, naiveNeighbors);
+      CheckMatrices(distances, naiveDistances);
+    }
+  }
+
+  KNNModel model(KNNModel::KD_TREE, false, true);
+  model.BuildModel(arma::mat(referenceData), 20, DUAL_TREE_MODE);
+  KNNModel xmlModel, textModel, binaryModel;
+  SerializeObjectAll(model, xmlModel, textModel, binaryModel);
+
+  KNNModel* models[] = { &xmlModel, &textModel, &binaryModel };
+  for (size_t i = 0; i < 3; ++i)
+  {
+    REQUIRE(models[i]->SinglePrecision());
+    arma::Mat<size_t> neighbors;
+    arma::mat distances;
+    models[i]->Search(arma::mat(queryData), 5, neighbors, distances);
+    CheckMatrices(neighbors, naiveNeighbors);
+    CheckMatrices(distances, naiveDistances);
+  }
+
+  // Trees that don't support single precision can't be built.
+  KNNModel rTreeModel(KNNModel::R_TREE, false, true);
+  REQUIRE_THROWS_AS(rTreeModel.BuildModel(arma::mat(referenceData), 20,
+      DUAL_TREE_MODE), std::invalid_argument);
+}
+
+/**
+ * Make sure that inserting points into and removing points from an R* tree
+ * gives the same results as naive search on the remaining points, both when
+ * the tree is updated in place and when it is rebuilt.
+ */
+TEST_CASE("KNNRStarTreeInsertRemoveTest", "[KNNTest]")
+{
+  typedef NeighborSearch<NearestNeighborSort, EuclideanDistance, arma::mat,
+      RStarTree> KNNType;
+
+  arma::mat referenceData = arma::randu<arma::mat>(3, 500);
+  arma::mat newData = arma::randu<arma::mat>(3, 100);
+  arma::mat queryData = arma::randu<arma::mat>(3, 50);
+
+  // With a large ratio the tree is never rebuilt; with a small one it is.
+  const double ratios[] = { 10.0, 0.05 };
+  for (size_t r = 0; r < 2; ++r)
+  {
+    KNNType knn(referenceData);
+    knn.RebuildRatio() = ratios[r];
+    knn.Insert(newData);
+    REQUIRE(knn.ReferenceSet().n_cols == 600);
+
+    // Remove every third point.
+    std::vector<size_t> kept;
+    for (size_t i = 0; i < 600; ++i)
+    {
+      if (i % 3 == 0)
+        REQUIRE(knn.Remove(i));
+      else
+        kept.push_back(i);
+    }
+    REQUIRE(!knn.Remove(0));
+
+    arma::mat allData = arma::join_rows(referenceData, newData);
+    KNN naive(allData.cols(arma::conv_to<arma::uvec>::from(kept)),
+        NAIVE_MODE);
+
+    arma::Mat<size_t> neighbors, naiveNeighbors;
+    arma::mat distances, naiveDistances;
+    knn.Search(queryData, 5, neighbors, distances);
+    naive.Search(queryData, 5, naiveNeighbors, naiveDistances);
+
+    for (size_t i = 0; i < neighbors.n_elem; ++i)
+    {
+      REQUIRE(neighbors[i] == kept[naiveNeighbors[i]]);
+      REQUIRE(distances[i] == Approx(naiveDistances[i]).epsilon(1e-7));
+    }
+  }
+}
+
+/**
+ * Make sure that inserting points into and removing points from a cover tree
+ * gives the same results as naive search on the remaining points, in both
+ * single-tree and dual-tree mode, and both when the tree is updated in place
+ * and when it is rebuilt.
+ */
+TEST_CASE("KNNCoverTreeInsertRemoveTest", "[KNNTest]")
+{
+  typedef NeighborSearch<NearestNeighborSort, EuclideanDistance, arma::mat,
+      StandardCoverTree> KNNType;
+
+  arma::mat referenceData = arma::randu<arma::mat>(3, 500);
+  arma::mat newData = arma::randu<arma::mat>(3, 100);
+  arma::mat queryData = arma::randu<arma::mat>(3, 50);
+
+  const NeighborSearchMode modes[] = { SINGLE_TREE_MODE, DUAL_TREE_MODE };
+  const double ratios[] = { 10.0, 0.05 };
+  for (size_t m = 0; m < 2; ++m)
+  {
+    KNNType knn(referenceData, modes[m]);
+    knn.RebuildRatio() = ratios[m];
+    knn.Insert(newData);
+    REQUIRE(knn.ReferenceSet().n_cols == 600);
+    REQUIRE(knn.ReferenceTree().NumDescendants() == 600);
+
+    // Remove every third point; this includes the root point.
+    std::vector<size_t> kept;
+    for (size_t i = 0; i < 600; ++i)
+    {
+      if (i % 3 == 0)
+        REQUIRE(knn.Remove(i));
+      else
+        kept.push_back(i);
+    }
+    REQUIRE(!knn.Remove(0));
+
+    arma::mat allData = arma::join_rows(referenceData, newData);
+    KNN naive(allData.cols(arma::conv_to<arma::uvec>::from(kept)),
+        NAIVE_MODE);
+
+    arma::Mat<size_t> neighbors, naiveNeighbors;
+    arma::mat distances, naiveDistances;
+    knn.Search(queryData, 5, neighbors, distances);
+    naive.Search(queryData, 5, naiveNeighbors, naiveDistances);
+
+    for (size_t i = 0; i < neighbors.n_elem; ++i)
+    {
+      REQUIRE(neighbors[i] == kept[naiveNeighbors[i]]);
+      REQUIRE(distances[i] == Approx(naiveDistances[i]).epsilon(1e-7));
+    }
+  }
+}
+
+/**
+ * Make sure that inserting points into a kd-tree model rebuilds it with the
+ * original indices, and that removing points from it is not allowed.
+ */
+TEST_CASE("KNNKDTreeInsertTest", "[KNNTest]")
+{
+  arma::mat referenceData = arma::randu<arma::mat>(3, 300);
+  arma::mat newData = arma::randu<arma::mat>(3, 100);
+
+  KNN knn(referenceData);
+  knn.Insert(newData);
+
+  KNN naive(arma::join_rows(referenceData, newData), NAIVE_MODE);
+
+  arma::Mat<size_t> neighbors, naiveNeighbors;
+  arma::mat distances, naiveDistances;
+  knn.Search(5, neighbors, distances);
+  naive.Search(5, naiveNeighbors, naiveDistances);
+
+  CheckMatrices(neighbors, naiveNeighbors);
+  CheckMatrices(distances, naiveDistances);
+
+  REQUIRE_THROWS_AS(knn.Remove(0), std::invalid_argument);
+}
+
+/**
+ * Make sure that after the reference points of a kd-tree are moved in place,
+ * refitting the tree gives the same results as naive search on the moved
+ * points.
+ */
+TEST_CASE("KNNKDTreeRefitTest", "[KNNTest]")
+{
+  arma::mat referenceData = arma::randu<arma::mat>(3, 500);
+  arma::mat queryData = arma::randu<arma::mat>(3, 50);
+  arma::mat transformation = arma::randu<arma::mat>(3, 3);
+
+  KNN knn(referenceData);
+  knn.ReferenceTree().Dataset() = transformation *
+      knn.ReferenceTree().Dataset();
+  knn.Refit();
+
+  KNN naive(transformation * referenceData, NAIVE_MODE);
+
+  arma::Mat<size_t> neighbors, naiveNeighbors;
+  arma::mat distances, naiveDistances;
+  knn.Search(5, neighbors, distances);
+  naive.Search(5, naiveNeighbors, naiveDistances);
+
+  CheckMatrices(neighbors, naiveNeighbors);
+  CheckMatrices(distances, naiveDistances);
+
+  knn.Search(queryData, 5, neighbors, distances);
+  naive.Search(queryData, 5, naiveNeighbors, naiveDistances);
+
+  CheckMatrices(neighbors, naiveNeighbors);
+  CheckMatrices(distances, naiveDistances);
+}
+
+/**
+ * Trees that can't be refit are rebuilt by Refit().
+ */
+TEST_CASE("KNNRStarTreeRefitTest", "[KNNTest]")
+{
+  typedef NeighborSearch<NearestNeighborSort, EuclideanDistance, arma::mat,
+      RStarTree> KNNType;
+
+  arma::mat referenceData = arma::randu<arma::mat>(3, 300);
+  arma::mat queryData = arma::randu<arma::mat>(3, 50);
+
+  KNNType knn(referenceData);
+  knn.ReferenceTree().Dataset() *= 2.0;
+  knn.Refit();
+
+  KNN naive(2.0 * referenceData, NAIVE_MODE);
+
+  arma::Mat<size_t> neighbors, naiveNeighbors;
+  arma::mat distances, naiveDistances;
+  knn.Search(queryData, 5, neighbors, distances);
+  naive.Search(queryData, 5, naiveNeighbors, naiveDistances);
+
+  CheckMatrices(neighbors, naiveNeighbors);
+  CheckMatrices(distances, naiveDistances);
+}
+
+/**
+ * Make sure that inserting points into a KNNModel works for both tree types
+ * that are updated in place and tree types that are rebuilt.
+ */
+TEST_CASE("KNNModelInsertTest", "[KNNTest]")
+{
+  arma::mat referenceData = arma::randu<arma::mat>(3, 300);
+  arma::mat newData = arma::randu<arma::mat>(3, 100);
+  arma::mat queryData = arma::randu<arma::mat>(3, 50);
+
+  KNN naive(arma::join_rows(referenceData, newData), NAIVE_MODE);
+  arma::Mat<size_t> naiveNeighbors;
+  arma::mat naiveDistances;
+  naive.Search(queryData, 5, naiveNeighbors, naiveDistances);
+
+  const KNNModel::TreeTypes treeTypes[] = { KNNModel::KD_TREE,
+      KNNModel::COVER_TREE, KNNModel::R_TREE, KNNModel::SPILL_TREE };
+  for (size_t t = 0; t < 4; ++t)
+  {
+    KNNModel model(treeTypes[t]);
+    model.BuildModel(std::move(arma::mat(referenceData)), 10, DUAL_TREE_MODE);
+    model.Insert(std::move(arma::mat(newData)));
+
+    arma::Mat<size_t> neighbors;
+    arma::mat distances;
+    model.Search(std::move(arma::mat(queryData)), 5, neighbors, distances);
+
+    CheckMatrices(neighbors, naiveNeighbors);
+    CheckMatrices(distances, naiveDistances);
+  }
+}
+
+/**
+ * Make sure that the query cache returns the same results as a search without
+ * it, and that it is invalidated when the reference set changes.
+ */
+TEST_CASE("KNNQueryCacheTest", "[KNNTest]")
+{
+  arma::mat referenceData = arma::randu<arma::mat>(3, 300);
+  arma::mat queryData = arma::randu<arma::mat>(3, 40);
+
+  KNN knn(referenceData);
+  KNN uncached(referenceData);
+  knn.Cache().MaxSize(30);
+
+  arma::Mat<size_t> neighbors, uncachedNeighbors;
+  arma::mat distances, uncachedDistances;
+  uncached.Search(queryData, 5, uncachedNeighbors, uncachedDistances);
+
+  // The first search can't use the cache, and only the last 30 queries fit.
+  knn.Search(queryData, 5, neighbors, distances);
+  REQUIRE(knn.Cache().Hits() == 0);
+  REQUIRE(knn.Cache().Size() == 30);
+  CheckMatrices(neighbors, uncachedNeighbors);
+  CheckMatrices(distances, uncachedDistances);
+
+  // Now 30 queries are found in the cache and 10 are searched again.
+  knn.Search(queryData, 5, neighbors, distances);
+  REQUIRE(knn.Cache().Hits() == 30);
+  REQUIRE(knn.Cache().Misses() == 50);
+  CheckMatrices(neighbors, uncachedNeighbors);
+  CheckMatrices(distances, uncachedDistances);
+
+  // A different k can't use the cached results.
+  knn.Search(queryData.cols(0, 9), 3, neighbors, distances);
+  REQUIRE(knn.Cache().Hits() == 30);
+  CheckMatrices(neighbors,
+      arma::Mat<size_t>(uncachedNeighbors.submat(0, 0, 2, 9)));
+
+  // Adding points must invalidate the cache.
+  arma::mat newData = arma::randu<arma::mat>(3, 100);
+  knn.Insert(newData);
+  uncached.Insert(newData);
+  REQUIRE(knn.Cache().Size() == 0);
+
+  knn.Search(queryData, 5, neighbors, distances);
+  uncached.Search(queryData, 5, uncachedNeighbors, uncachedDistances);
+  CheckMatrices(neighbors, uncachedNeighbors);
+  CheckMatrices(distances, uncachedDistances);
+}
+
+/**
+ * Make sure that the search statistics are consistent with the other counters
+ * for naive, single-tree and dual-tree search.
+ */
+TEST_CASE("KNNSearchStatisticsTest", "[KNNTest]")
+{
+  arma::mat referenceData = arma::randu<arma::mat>(3, 1000);
+  arma::mat queryData = arma::randu<arma::mat>(3, 200);
+
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+
+  KNN naive(referenceData, NAIVE_MODE);
+  naive.Search(queryData, 3, neighbors, distances);
+  REQUIRE(naive.Statistics().BaseCases() == 200 * 1000);
+  REQUIRE(naive.Statistics().NodesVisited() == 0);
+  REQUIRE(naive.Statistics().ReferenceLeaves() == 0);
+
+  const NeighborSearchMode modes[] = { SINGLE_TREE_MODE, DUAL_TREE_MODE };
+  for (size_t m = 0; m < 2; ++m)
+  {
+    KNN knn(referenceData, modes[m]);
+    knn.Search(queryData, 3, neighbors, distances);
+
+    const SearchStatistics& statistics = knn.Statistics();
+    REQUIRE(statistics.BaseCases() == knn.BaseCases());
+    REQUIRE(statistics.Scores() == knn.Scores());
+    REQUIRE(statistics.BaseCases() < 200 * 1000);
+    REQUIRE(statistics.BoundPrunes() + statistics.TraversalInfoPrunes() > 0);
+    REQUIRE(statistics.ReferenceLeaves() > 0);
+    REQUIRE(statistics.AverageLeafSize() > 0.0);
+    REQUIRE(statistics.AverageLeafSize() <= 20.0);
+    REQUIRE(statistics.SearchTime() >= 0.0);
+
+    if (modes[m] == DUAL_TREE_MODE)
+    {
+      REQUIRE(statistics.NodesVisited() > 0);
+      REQUIRE(statistics.TreeBuildingTime() >= 0.0);
+    }
+    else
+    {
+      REQUIRE(statistics.TreeBuildingTime() == 0.0);
+    }
+  }
+}
+
+/**
+ * Check the base case and score times and the maximum recursion depth that the
+ * traversers of the given tree type report to a caller-owned SearchStatistics.
+ */
+template<template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void CheckSearchTimesAndDepth(const arma::mat& referenceData,
+                              const arma::mat& queryData)
+{
+  typedef NeighborSearch<NearestNeighborSort, EuclideanDistance, arma::mat,
+      TreeType> KNNType;
+
+  const NeighborSearchMode modes[] = { SINGLE_TREE_MODE, DUAL_TREE_MODE };
+  for (size_t m = 0; m < 2; ++m)
+  {
+    KNNType knn(referenceData, modes[m]);
+    knn.NumThreads() = 1;
+
+    arma::Mat<size_t> neighbors;
+    arma::mat distances;
+    SearchStatistics statistics;
+    knn.Search(queryData, 3, neighbors, distances, statistics);
+
+    REQUIRE(statistics.MaxDepth() > 1);
+    REQUIRE(statistics.MaxDepth() <= referenceData.n_cols + queryData.n_cols);
+    REQUIRE(statistics.BaseCaseTime() > 0.0);
+    REQUIRE(statistics.ScoreTime() > 0.0);
+
+    // With one thread, the timed batches are disjoint parts of the search.
+    REQUIRE(statistics.BaseCaseTime() + statistics.ScoreTime() <=
+        statistics.SearchTime() + 1e-6);
+  }
+}
+
+/**
+ * Make sure that the traversers of every tree type measure the time spent in
+ * base cases and in scoring and their recursion depth, and that the naive
+ * search only reports base case time.
+ */
+TEST_CASE("KNNSearchTimesAndDepthTest", "[KNNTest]")
+{
+  arma::mat referenceData = arma::randu<arma::mat>(3, 1000);
+  arma::mat queryData = arma::randu<arma::mat>(3, 200);
+
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  SearchStatistics statistics;
+  KNN naive(referenceData, NAIVE_MODE);
+  naive.Search(queryData, 3, neighbors, distances, statistics);
+  REQUIRE(statistics.MaxDepth() == 0);
+  REQUIRE(statistics.BaseCaseTime() > 0.0);
+  REQUIRE(statistics.ScoreTime() == 0.0);
+
+  CheckSearchTimesAndDepth<KDTree>(referenceData, queryData);
+  CheckSearchTimesAndDepth<BallTree>(referenceData, queryData);
+  CheckSearchTimesAndDepth<StandardCoverTree>(referenceData, queryData);
+  CheckSearchTimesAndDepth<RTree>(referenceData, queryData);
+  CheckSearchTimesAndDepth<Octree>(referenceData, queryData);
+  CheckSearchTimesAndDepth<SPTree>(referenceData, queryData);
+}
+
 /**
  * Test the single-tree nearest-neighbors method with the naive method.  This
  * uses only a reference dataset.
@@ -1814,3 +2656,308 @@ TEST_CASE("KNNSpillTreeSearchEnoughResults", "[KNNTest]")
   REQUIRE(arma::accu(distancesGreedy < 0.0 || distancesGreedy > std::sqrt(3.0))
       == 0);
 }
+
+/**
+ * Make sure that the const Search() overloads give the same results as the
+ * other overloads, also when they are called concurrently on the same object,
+ * and that they don't modify the object.
+ */
+TEST_CASE("KNNConstConcurrentSearchTest", "[KNNTest]")
+{
+  arma::mat referenceData = arma::randu<arma::mat>(3, 1000);
+  arma::mat queryData = arma::randu<arma::mat>(3, 200);
+
+  const NeighborSearchMode modes[] = { NAIVE_MODE, SINGLE_TREE_MODE,
+      DUAL_TREE_MODE, GREEDY_SINGLE_TREE_MODE };
+  for (size_t m = 0; m < 4; ++m)
+  {
+    KNN knn(referenceData, modes[m]);
+
+    arma::Mat<size_t> neighbors, monoNeighbors;
+    arma::mat distances, monoDistances;
+    knn.Search(queryData, 3, neighbors, distances);
+    knn.Search(3, monoNeighbors, monoDistances);
+    const size_t baseCases = knn.BaseCases();
+
+    const KNN& constKnn = knn;
+    std::vector<arma::Mat<size_t>> threadNeighbors(8), threadMonoNeighbors(8);
+    std::vector<arma::mat> threadDistances(8), threadMonoDistances(8);
+    std::vector<SearchStatistics> statistics(8), monoStatistics(8);
+
+    #pragma omp parallel for
+    for (omp_size_t i = 0; i < 8; ++i)
+    {
+      constKnn.Search(queryData, 3, threadNeighbors[i], threadDistances[i],
+          statistics[i]);
+      constKnn.Search(3, threadMonoNeighbors[i], threadMonoDistances[i],
+          monoStatistics[i]);
+    }
+
+    for (size_t i = 0; i < 8; ++i)
+    {
+      CheckMatrices(threadNeighbors[i], neighbors);
+      CheckMatrices(threadDistances[i], distances);
+      CheckMatrices(threadMonoNeighbors[i], monoNeighbors);
+      CheckMatrices(threadMonoDistances[i], monoDistances);
+      REQUIRE(statistics[i].BaseCases() > 0);
+      REQUIRE(monoStatistics[i].BaseCases() > 0);
+    }
+
+    // The counters of the last non-const search are unchanged.
+    REQUIRE(knn.BaseCases() == baseCases);
+  }
+}
+
+/**
+ * Make sure that searching with a Mahalanobis distance through the transformed
+ * points gives the neighbors and distances of a brute-force search with the
+ * distance, for positive definite and for singular covariances.
+ */
+TEST_CASE("KNNMahalanobisSearchTest", "[KNNTest]")
+{
+  arma::mat referenceSet(4, 300, arma::fill::randu);
+  arma::mat querySet(4, 40, arma::fill::randu);
+
+  for (size_t trial = 0; trial < 2; ++trial)
+  {
+    // The second covariance has rank 2.
+    arma::mat factor(trial == 0 ? 4 : 2, 4, arma::fill::randn);
+    arma::mat covariance = factor.t() * factor;
+    if (trial == 0)
+      covariance += 0.1 * arma::eye<arma::mat>(4, 4);
+
+    MahalanobisDistance<> distance(covariance);
+    MahalanobisSearch<KNN> knn(referenceSet, distance);
+    REQUIRE(arma::approx_equal(knn.Transformation().t() *
+        knn.Transformation(), covariance, "absdiff", 1e-8));
+
+    arma::Mat<size_t> neighbors;
+    arma::mat distances;
+    knn.Search(querySet, 3, neighbors, distances);
+
+    for (size_t q = 0; q < querySet.n_cols; ++q)
+    {
+      arma::vec trueDistances(referenceSet.n_cols);
+      for (size_t r = 0; r < referenceSet.n_cols; ++r)
+      {
+        trueDistances[r] = distance.Evaluate(querySet.col(q),
+            referenceSet.col(r));
+      }
+      const arma::vec sorted = arma::sort(trueDistances);
+
+      for (size_t i = 0; i < 3; ++i)
+      {
+        REQUIRE(distances(i, q) == Approx(sorted[i]).epsilon(1e-6)
+            .margin(1e-6));
+        REQUIRE(trueDistances[neighbors(i, q)] ==
+            Approx(distances(i, q)).epsilon(1e-6).margin(1e-6));
+      }
+    }
+
+    // The monochromatic search passes through unchanged.
+    knn.Search(1, neighbors, distances);
+    REQUIRE(neighbors.n_cols == referenceSet.n_cols);
+  }
+}
+
+/**
+ * Make sure that the search of a sharded reference set gives the neighbors of
+ * the unsharded search, with and without pruning, for nearest and furthest
+ * neighbors.
+ */
+TEST_CASE("ShardedNSModelSearchTest", "[KNNTest]")
+{
+  arma::mat referenceSet(3, 1000, arma::fill::randu);
+  arma::mat querySet(3, 200, arma::fill::randu);
+  // Make the shards spatially coherent, so that pruning has an effect.
+  referenceSet = referenceSet.cols(arma::sort_index(referenceSet.row(0)));
+
+  arma::Mat<size_t> trueNeighbors, neighbors;
+  arma::mat trueDistances, distances;
+
+  KNN knn(referenceSet);
+  knn.Search(querySet, 5, trueNeighbors, trueDistances);
+
+  ShardedNSModel<NearestNeighborSort> model;
+  model.BuildModel(referenceSet, 7, 20, DUAL_TREE_MODE);
+  REQUIRE(model.NumShards() == 7);
+  REQUIRE(model.NumPoints() == referenceSet.n_cols);
+
+  for (size_t prune = 0; prune < 2; ++prune)
+  {
+    model.Search(querySet, 5, neighbors, distances, prune == 1);
+    CheckMatrices(neighbors, trueNeighbors);
+    CheckMatrices(distances, trueDistances);
+  }
+
+  KFN kfn(referenceSet);
+  kfn.Search(querySet, 5, trueNeighbors, trueDistances);
+
+  ShardedNSModel<FurthestNeighborSort> kfnModel(
+      NSModel<FurthestNeighborSort>::BALL_TREE);
+  kfnModel.BuildModel(referenceSet, 4, 20, SINGLE_TREE_MODE);
+  for (size_t prune = 0; prune < 2; ++prune)
+  {
+    kfnModel.Search(querySet, 5, neighbors, distances, prune == 1);
+    CheckMatrices(neighbors, trueNeighbors);
+    CheckMatrices(distances, trueDistances);
+  }
+
+  // More neighbors than points are an error.
+  REQUIRE_THROWS_AS(model.Search(querySet, 1001, neighbors, distances),
+      std::invalid_argument);
+}
+
+/**
+ * Make sure that shards built separately (with a random basis or with fewer
+ * points than neighbors) can be added, and that the merged lists of the
+ * shards are those of the unsharded search.
+ */
+TEST_CASE("ShardedNSModelAddShardTest", "[KNNTest]")
+{
+  arma::mat referenceSet(4, 300, arma::fill::randu);
+  arma::mat querySet(4, 50, arma::fill::randu);
+
+  arma::Mat<size_t> trueNeighbors;
+  arma::mat trueDistances;
+  KNN knn(referenceSet);
+  knn.Search(querySet, 6, trueNeighbors, trueDistances);
+
+  // The last shard has fewer points than neighbors.
+  const size_t sizes[] = { 150, 146, 4 };
+  ShardedNSModel<NearestNeighborSort> model;
+  std::vector<arma::Mat<size_t>> shardNeighbors;
+  std::vector<arma::mat> shardDistances;
+  std::vector<size_t> offsets;
+  size_t begin = 0;
+  for (size_t s = 0; s < 3; ++s)
+  {
+    NSModel<NearestNeighborSort> shard(
+        NSModel<NearestNeighborSort>::KD_TREE, s == 1);
+    arma::mat shardSet = referenceSet.cols(begin, begin + sizes[s] - 1);
+    shard.BuildModel(std::move(shardSet), 10, DUAL_TREE_MODE);
+
+    shardNeighbors.push_back(arma::Mat<size_t>());
+    shardDistances.push_back(arma::mat());
+    SearchStatistics statistics;
+    shard.Search(querySet, std::min((size_t) 6, sizes[s]),
+        shardNeighbors.back(), shardDistances.back(), statistics);
+    offsets.push_back(begin);
+
+    model.AddShard(std::move(shard));
+    begin += sizes[s];
+  }
+
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  for (size_t prune = 0; prune < 2; ++prune)
+  {
+    model.Search(querySet, 6, neighbors, distances, prune == 1);
+    CheckMatrices(neighbors, trueNeighbors);
+    CheckMatrices(distances, trueDistances);
+  }
+
+  ShardedNSModel<NearestNeighborSort>::Merge(shardNeighbors, shardDistances,
+      offsets, 6, neighbors, distances);
+  CheckMatrices(neighbors, trueNeighbors);
+  CheckMatrices(distances, trueDistances);
+
+  // Merging more neighbors than the shards hold pads the lists.
+  ShardedNSModel<NearestNeighborSort>::Merge(
+      std::vector<arma::Mat<size_t>>(1, shardNeighbors[2]),
+      std::vector<arma::mat>(1, shardDistances[2]),
+      std::vector<size_t>(1, 296), 5, neighbors, distances);
+  REQUIRE(neighbors(3, 0) >= 296);
+  REQUIRE(neighbors(4, 0) == size_t() - 1);
+  REQUIRE(distances(4, 0) == DBL_MAX);
+}
+
+/**
+ * Make sure that a serialized ShardedNSModel gives the same results.
+ */
+TEST_CASE("ShardedNSModelSerializationTest", "[KNNTest]")
+{
+  arma::mat referenceSet(3, 400, arma::fill::randu);
+  arma::mat querySet(3, 40, arma::fill::randu);
+
+  ShardedNSModel<NearestNeighborSort> model(
+      NSModel<NearestNeighborSort>::COVER_TREE);
+  model.BuildModel(referenceSet, 3, 20, DUAL_TREE_MODE);
+
+  ShardedNSModel<NearestNeighborSort> xmlModel, textModel, binaryModel;
+  SerializeObjectAll(model, xmlModel, textModel, binaryModel);
+
+  arma::Mat<size_t> neighbors, otherNeighbors;
+  arma::mat distances, otherDistances;
+  model.Search(querySet, 3, neighbors, distances);
+
+  ShardedNSModel<NearestNeighborSort>* models[] =
+      { &xmlModel, &textModel, &binaryModel };
+  for (size_t i = 0; i < 3; ++i)
+  {
+    REQUIRE(models[i]->NumShards() == 3);
+    REQUIRE(models[i]->TreeType() == NSModel<NearestNeighborSort>::COVER_TREE);
+    models[i]->Search(querySet, 3, otherNeighbors, otherDistances);
+    CheckMatrices(neighbors, otherNeighbors);
+    CheckMatrices(distances, otherDistances);
+  }
+}
+
+/**
+ * Make sure that an automatically chosen model gives exact results, and that
+ * its choice is saved with it.
+ */
+TEST_CASE("KNNModelAutoBuildTest", "[KNNTest]")
+{
+  typedef NSModel<NearestNeighborSort> KNNModel;
+
+  arma::mat referenceSet(3, 1500, arma::fill::randu);
+  arma::mat querySet(3, 200, arma::fill::randu);
+
+  KNN knn(referenceSet);
+  arma::Mat<size_t> trueNeighbors, neighbors;
+  arma::mat trueDistances, distances;
+  knn.Search(querySet, 5, trueNeighbors, trueDistances);
+
+  // With no time budget, only the first candidate is tried; with a budget,
+  // a sample smaller than the reference set is searched.
+  const double budgets[] = { 0.0, 10.0 };
+  for (size_t i = 0; i < 2; ++i)
+  {
+    KNNModel model;
+    model.AutoBuildModel(arma::mat(referenceSet), querySet, 5, 0, budgets[i],
+        500);
+    REQUIRE(model.Dataset().n_cols == 1500);
+    if (i == 0)
+    {
+      REQUIRE(model.TreeType() == KNNModel::KD_TREE);
+      REQUIRE(model.LeafSize() == 20);
+      REQUIRE(model.SearchMode() == DUAL_TREE_MODE);
+    }
+    // Greedy search is approximate, so it is only tried with a nonzero
+    // epsilon.
+    REQUIRE(model.SearchMode() != GREEDY_SINGLE_TREE_MODE);
+
+    model.Search(arma::mat(querySet), 5, neighbors, distances);
+    CheckMatrices(trueNeighbors, neighbors);
+    CheckMatrices(trueDistances, distances);
+
+    KNNModel xmlModel, textModel, binaryModel;
+    SerializeObjectAll(model, xmlModel, textModel, binaryModel);
+    KNNModel* models[] = { &xmlModel, &textModel, &binaryModel };
+    for (size_t j = 0; j < 3; ++j)
+    {
+      REQUIRE(models[j]->TreeType() == model.TreeType());
+      REQUIRE(models[j]->LeafSize() == model.LeafSize());
+      REQUIRE(models[j]->SearchMode() == model.SearchMode());
+    }
+  }
+
+  // Monochromatic search is timed if there is no query set.
+  KNNModel model;
+  model.AutoBuildModel(arma::mat(referenceSet), arma::mat(), 5, 0, 1.0, 500);
+  knn.Search(5, trueNeighbors, trueDistances);
+  model.Search(5, neighbors, distances);
+  CheckMatrices(trueNeighbors, neighbors);
+  CheckMatrices(trueDistances, distances);
+}
@@ -143,6 +143,71 @@ BOOST_AUTO_TEST_CASE(SingleTreeSearch)
   BOOST_REQUIRE_LT(numQueriesFail, maxNumQueriesFail);
 }
 
+// Test that naive and single-tree rank-approximate search with several threads
+// still give the rank guarantee.
+BOOST_AUTO_TEST_CASE(ParallelGuaranteeTest)
+{
+  arma::mat refData;
+  arma::mat queryData;
+
+  data::Load("rann_test_r_3_900.csv", refData, true);
+  data::Load("rann_test_q_3_100.csv", queryData, true);
+
+  arma::Mat<size_t> qrRanks;
+  data::Load("rann_test_qr_ranks.csv", qrRanks, true, false); // No transpose.
+
+  for (size_t mode = 0; mode < 2; ++mode)
+  {
+    RASearch<> rann(refData, (mode == 0), (mode == 1), 1.0, 0.95, false,
+        false);
+    rann.NumThreads() = 4;
+    BOOST_REQUIRE_EQUAL(rann.NumThreads(), 4);
+
+    arma::Mat<size_t> neighbors;
+    arma::mat distances;
+
+    size_t numRounds = 1000;
+    arma::Col<size_t> numSuccessRounds(queryData.n_cols);
+    numSuccessRounds.fill(0);
+
+    // 1% of 900 is 9, so the rank is expected to be less than 10.
+    size_t expectedRankErrorUB = 10;
+
+    for (size_t rounds = 0; rounds < numRounds; rounds++)
+    {
+      rann.Search(queryData, 1, neighbors, distances);
+
+      BOOST_REQUIRE_EQUAL(neighbors.n_cols, queryData.n_cols);
+      for (size_t i = 0; i < queryData.n_cols; ++i)
+      {
+        BOOST_REQUIRE_LT(neighbors(0, i), refData.n_cols);
+        BOOST_REQUIRE_CLOSE(distances(0, i), metric::EuclideanDistance::
+            Evaluate(queryData.col(i), refData.col(neighbors(0, i))), 1e-5);
+        if (qrRanks(i, neighbors(0, i)) < expectedRankErrorUB)
+          numSuccessRounds[i]++;
+      }
+
+      neighbors.reset();
+      distances.reset();
+    }
+
+    // Find the 95%-tile threshold so that 95% of the queries should pass this
+    // threshold.
+    size_t threshold = floor(numRounds *
+        (0.95 - (1.96 * sqrt(0.95 * 0.05 / numRounds))));
+    size_t numQueriesFail = 0;
+    for (size_t i = 0; i < queryData.n_cols; ++i)
+      if (numSuccessRounds[i] < threshold)
+        numQueriesFail++;
+
+    // Assert that at most 5% of the queries fall out of this threshold.
+    // 5% of 100 queries is 5.
+    size_t maxNumQueriesFail = 6;
+
+    BOOST_REQUIRE_LT(numQueriesFail, maxNumQueriesFail);
+  }
+}
+
 // Test dual-tree rank-approximate search (harder to test because of the
 // randomness involved).
 BOOST_AUTO_TEST_CASE(DualTreeSearch)
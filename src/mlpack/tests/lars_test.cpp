@@ -459,3 +459,69 @@ TEST_CASE("LARSCopyConstructorTest", "[LARSTest]")
   // The output of both models should be the same.
   CheckMatrices(predictions, predictionsFromCopiedModel);
 }
+
+/**
+ * Make sure that the blocked Gram matrix computation gives X^T X for both
+ * column-major and row-major data, and for blocks that don't divide the
+ * dimensionality.
+ */
+TEST_CASE("LARSComputeGramTest", "[LARSTest]")
+{
+  arma::mat X = arma::randn(23, 100);
+  const arma::mat expected = X * trans(X);
+
+  arma::mat gram;
+  LARS::ComputeGram(X, gram, true, 5);
+  CheckMatrices(gram, expected);
+
+  arma::mat rowMajorGram;
+  LARS::ComputeGram(trans(X), rowMajorGram, false, 7);
+  CheckMatrices(rowMajorGram, expected);
+
+  // A single block.
+  LARS::ComputeGram(X, gram, true, 100);
+  CheckMatrices(gram, expected);
+}
+
+/**
+ * Make sure that training on several responses at once gives the same paths
+ * as training on each response separately.
+ */
+void LARSMultipleResponsesTest(const bool useCholesky)
+{
+  arma::mat X = arma::randn(20, 300);
+  arma::mat Y = arma::randn(15, 20) * X;
+
+  LARS lars(useCholesky, 0.1, 0.05);
+  arma::mat betas;
+  const double error = lars.Train(X, Y, betas);
+
+  REQUIRE(betas.n_rows == 20);
+  REQUIRE(betas.n_cols == 15);
+
+  double totalError = 0.0;
+  for (size_t i = 0; i < Y.n_rows; ++i)
+  {
+    LARS single(useCholesky, 0.1, 0.05);
+    arma::vec beta;
+    totalError += single.Train(X, Y.row(i), beta);
+    CheckMatrices(arma::mat(betas.col(i)), beta);
+  }
+
+  REQUIRE(error == Approx(totalError).epsilon(1e-7));
+
+  // The model is the one of the last response.
+  arma::rowvec predictions;
+  lars.Predict(X, predictions);
+  CheckMatrices(predictions, arma::mat(trans(betas.col(14)) * X));
+}
+
+TEST_CASE("LARSMultipleResponsesTest", "[LARSTest]")
+{
+  LARSMultipleResponsesTest(false);
+}
+
+TEST_CASE("LARSMultipleResponsesCholeskyTest", "[LARSTest]")
+{
+  LARSMultipleResponsesTest(true);
+}
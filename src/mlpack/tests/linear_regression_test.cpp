@@ -266,3 +266,95 @@ TEST_CASE("LinearRegressionTrainReturnObjective", "[LinearRegressionTest]")
 
   REQUIRE(std::isfinite(error) == true);
 }
+
+/**
+ * Make sure that the blocked normal equations give the same weighted model as
+ * the explicit design matrix.
+ */
+TEST_CASE("LinearRegressionBlockedTrainTest", "[LinearRegressionTest]")
+{
+  arma::mat predictors = arma::randu<arma::mat>(5, 1000);
+  arma::rowvec responses = arma::randu<arma::rowvec>(1000);
+  arma::rowvec weights = arma::randu<arma::rowvec>(1000);
+
+  LinearRegression lr;
+  lr.Lambda() = 0.1;
+  lr.BlockSize() = 7;
+  lr.Train(predictors, responses, weights);
+
+  // Solve with the explicit weighted design matrix, with a row of ones.
+  arma::mat p = arma::join_cols(arma::ones<arma::rowvec>(1000), predictors);
+  p.each_row() %= arma::sqrt(weights);
+  const arma::rowvec r = arma::sqrt(weights) % responses;
+  const arma::vec correct = arma::solve(p * p.t() + 0.1 *
+      arma::eye<arma::mat>(6, 6), p * r.t());
+
+  REQUIRE(lr.Parameters().n_elem == 6);
+  for (size_t i = 0; i < 6; ++i)
+    REQUIRE(lr.Parameters()[i] == Approx(correct[i]).epsilon(1e-7));
+
+  // Without the intercept, the same holds.
+  lr.Train(predictors, responses, weights, false);
+  arma::mat q = predictors;
+  q.each_row() %= arma::sqrt(weights);
+  const arma::vec correctNoIntercept = arma::solve(q * q.t() + 0.1 *
+      arma::eye<arma::mat>(5, 5), q * r.t());
+
+  REQUIRE(lr.Parameters().n_elem == 5);
+  for (size_t i = 0; i < 5; ++i)
+  {
+    REQUIRE(lr.Parameters()[i] ==
+        Approx(correctNoIntercept[i]).epsilon(1e-7));
+  }
+}
+
+/**
+ * Make sure that training over the chunks of a loader, with weights in the
+ * second row of the responses, gives the same model as training in memory.
+ */
+TEST_CASE("LinearRegressionLoaderTrainTest", "[LinearRegressionTest]")
+{
+  arma::mat predictors = arma::randu<arma::mat>(4, 400);
+  arma::rowvec responses = arma::randu<arma::rowvec>(400);
+  arma::rowvec weights = arma::randu<arma::rowvec>(400) + 0.5;
+
+  std::vector<std::string> predictorFiles, responseFiles;
+  for (size_t i = 0; i < 4; ++i)
+  {
+    predictorFiles.push_back("lr_chunk_" + std::to_string(i) + ".bin");
+    responseFiles.push_back("lr_chunk_responses_" + std::to_string(i) +
+        ".bin");
+    data::Save(predictorFiles[i],
+        arma::mat(predictors.cols(100 * i, 100 * i + 99)));
+    data::Save(responseFiles[i], arma::mat(arma::join_cols(
+        responses.cols(100 * i, 100 * i + 99),
+        weights.cols(100 * i, 100 * i + 99))));
+  }
+
+  data::PrefetchLoader<data::FileChunkSource> loader(data::FileChunkSource(
+      predictorFiles, responseFiles));
+
+  LinearRegression lr, memoryLr;
+  const double error = lr.Train(loader);
+  memoryLr.Train(predictors, responses, weights);
+
+  for (size_t i = 0; i < 4; ++i)
+  {
+    remove(predictorFiles[i].c_str());
+    remove(responseFiles[i].c_str());
+  }
+
+  REQUIRE(lr.Parameters().n_elem == 5);
+  for (size_t i = 0; i < 5; ++i)
+  {
+    REQUIRE(lr.Parameters()[i] ==
+        Approx(memoryLr.Parameters()[i]).epsilon(1e-5));
+  }
+
+  // The returned error is the weighted mean squared error.
+  arma::rowvec predictions;
+  lr.Predict(predictors, predictions);
+  const double correctError = arma::accu(weights % arma::square(responses -
+      predictions)) / arma::accu(weights);
+  REQUIRE(error == Approx(correctError).epsilon(1e-5));
+}
@@ -466,6 +466,76 @@ BOOST_AUTO_TEST_CASE(LinearSVMFunctionSeparableGradient)
   }
 }
 
+/**
+ * Make sure that the blocked and parallel loss and gradient on sparse data
+ * match the ones on the same dense data, for batches that span several
+ * blocks.
+ */
+BOOST_AUTO_TEST_CASE(LinearSVMFunctionSparseBlockedGradient)
+{
+  const size_t points = 1000;
+  const size_t inputSize = 50;
+  const size_t numClasses = 5;
+
+  arma::sp_mat data;
+  data.sprandu(inputSize, points, 0.1);
+  const arma::mat denseData(data);
+
+  arma::Row<size_t> labels(points);
+  for (size_t i = 0; i < points; ++i)
+    labels(i) = math::RandInt(0, numClasses);
+
+  LinearSVMFunction<arma::sp_mat> svmf(data, labels, numClasses, 0.01, 1.0,
+      true);
+  LinearSVMFunction<arma::mat> denseSvmf(denseData, labels, numClasses, 0.01,
+      1.0, true);
+  svmf.BlockSize() = 7;
+  denseSvmf.BlockSize() = points;
+
+  arma::mat parameters;
+  parameters.randu(inputSize + 1, numClasses);
+
+  const size_t batchSizes[] = { 1, 30, 333, points };
+  for (const size_t batchSize : batchSizes)
+  {
+    for (size_t firstId = 0; firstId + batchSize <= points; firstId += 333)
+    {
+      arma::mat gradient, denseGradient;
+      const double loss = svmf.EvaluateWithGradient(parameters, firstId,
+          gradient, batchSize);
+      const double denseLoss = denseSvmf.EvaluateWithGradient(parameters,
+          firstId, denseGradient, batchSize);
+
+      BOOST_REQUIRE_CLOSE(loss, denseLoss, 1e-5);
+      BOOST_REQUIRE_CLOSE(svmf.Evaluate(parameters, firstId, batchSize),
+          denseLoss, 1e-5);
+      BOOST_REQUIRE_EQUAL(gradient.n_rows, denseGradient.n_rows);
+      BOOST_REQUIRE_EQUAL(gradient.n_cols, denseGradient.n_cols);
+      for (size_t j = 0; j < gradient.n_elem; ++j)
+      {
+        if (std::abs(denseGradient[j]) < 1e-10)
+          BOOST_REQUIRE_SMALL(gradient[j], 1e-10);
+        else
+          BOOST_REQUIRE_CLOSE(gradient[j], denseGradient[j], 1e-5);
+      }
+    }
+  }
+
+  // The full loss and gradient are the same too.
+  arma::mat gradient, denseGradient;
+  svmf.Gradient(parameters, gradient);
+  denseSvmf.Gradient(parameters, denseGradient);
+  BOOST_REQUIRE_CLOSE(svmf.Evaluate(parameters),
+      denseSvmf.Evaluate(parameters), 1e-5);
+  for (size_t j = 0; j < gradient.n_elem; ++j)
+  {
+    if (std::abs(denseGradient[j]) < 1e-10)
+      BOOST_REQUIRE_SMALL(gradient[j], 1e-10);
+    else
+      BOOST_REQUIRE_CLOSE(gradient[j], denseGradient[j], 1e-5);
+  }
+}
+
 /**
  * Test training of linear svm on a simple dataset using
  * L-BFGS optimizer
@@ -100,6 +100,44 @@ BOOST_AUTO_TEST_CASE(LMNNImpostorsTest)
   BOOST_REQUIRE_EQUAL(impostors(0, 5), 2);
 }
 
+/**
+ * The impostors found with the trees reused (and refit) between calls should
+ * be the same as the ones found by a new Constraints object, as the dataset is
+ * transformed.
+ */
+BOOST_AUTO_TEST_CASE(LMNNImpostorsReuseTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(4, 300);
+  arma::Row<size_t> labels = arma::randi<arma::Row<size_t>>(300,
+      arma::distr_param(0, 2));
+
+  Constraints<> constraint(dataset, labels, 3);
+  constraint.RebuildInterval() = 3;
+
+  arma::mat transformed = dataset;
+  for (size_t t = 0; t < 6; ++t)
+  {
+    if (t > 0)
+      transformed = (arma::eye(4, 4) + 0.2 * arma::randu(4, 4)) * transformed;
+
+    arma::vec norm(transformed.n_cols);
+    for (size_t i = 0; i < transformed.n_cols; ++i)
+      norm(i) = arma::norm(transformed.col(i));
+
+    arma::Mat<size_t> impostors(3, transformed.n_cols);
+    arma::mat distances(3, transformed.n_cols);
+    constraint.Impostors(impostors, distances, transformed, labels, norm);
+
+    Constraints<> fresh(transformed, labels, 3);
+    arma::Mat<size_t> freshImpostors(3, transformed.n_cols);
+    arma::mat freshDistances(3, transformed.n_cols);
+    fresh.Impostors(freshImpostors, freshDistances, transformed, labels, norm);
+
+    CheckMatrices(impostors, freshImpostors);
+    CheckMatrices(distances, freshDistances);
+  }
+}
+
 //
 // Tests for the LMNNFunction
 //
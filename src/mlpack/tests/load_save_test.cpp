@@ -9,10 +9,19 @@
  * 3-clause BSD license along with mlpack.  If not, see
  * http://www.opensource.org/licenses/BSD-3-Clause for more information.
  */
+#include <atomic>
+#include <chrono>
+#include <iomanip>
 #include <sstream>
+#include <thread>
 
 #include <mlpack/core.hpp>
+#include <mlpack/core/data/async_checkpointer.hpp>
+#include <mlpack/core/data/chunked_reader.hpp>
 #include <mlpack/core/data/load_arff.hpp>
+#include <mlpack/core/data/load_numeric_csv.hpp>
+#include <mlpack/core/data/mapped_matrix.hpp>
+#include <mlpack/core/data/prefetch_loader.hpp>
 #include <mlpack/core/data/map_policies/missing_policy.hpp>
 #include "catch.hpp"
 #include "test_catch_tools.hpp"
@@ -2292,6 +2301,56 @@ TEST_CASE("CategoryCaseTest", "[LoadSaveTest]")
   remove("test.arff");
 }
 
+/**
+ * Load an ARFF file with more lines than are parsed at once, with quoted and
+ * escaped categories, and make sure that new categories are mapped in the order
+ * they appear in the file.
+ */
+TEST_CASE("LargeARFFCategoricalTest", "[LoadSaveTest]")
+{
+  const size_t points = 10000;
+
+  fstream f;
+  f.open("test.arff", fstream::out);
+  f << "@relation test" << endl;
+  f << "@attribute one {a, b, c}" << endl;
+  f << "@attribute two string" << endl;
+  f << "@attribute three numeric" << endl;
+  f << "@data" << endl;
+  for (size_t i = 0; i < points; ++i)
+  {
+    f << "abc"[i % 3] << ", ";
+    // Every 500 points, a new category appears in the second dimension.
+    if (i % 2 == 0)
+      f << "\"cat, " << (i / 500) << "\", ";
+    else
+      f << "cat\\, " << (i / 500) << ", ";
+    f << (0.5 * i) << endl;
+  }
+  f.close();
+
+  arma::mat dataset;
+  DatasetInfo info;
+  data::Load("test.arff", dataset, info, true);
+
+  REQUIRE(dataset.n_rows == 3);
+  REQUIRE(dataset.n_cols == points);
+  REQUIRE(info.NumMappings(0) == 3);
+  REQUIRE(info.NumMappings(1) == points / 500);
+
+  for (size_t i = 0; i < points; ++i)
+  {
+    REQUIRE(dataset(0, i) == (double) (i % 3));
+    REQUIRE(dataset(1, i) == (double) (i / 500));
+    REQUIRE(dataset(2, i) == Approx(0.5 * i).epsilon(1e-7));
+  }
+
+  REQUIRE(info.UnmapString(0, 1) == "cat, 0");
+  REQUIRE(info.UnmapString(19, 1) == "cat, 19");
+
+  remove("test.arff");
+}
+
 /**
  * Test that a CSV with the wrong number of columns fails.
  */
@@ -2466,3 +2525,644 @@ TEST_CASE("DatasetMapperNonUniqueTest", "[LoadSaveTest]")
   REQUIRE(dm.UnmapString(nan, 0, 1) == "goodbye");
   REQUIRE(dm.UnmapString(nan, 0, 2) == "cheese");
 }
+
+/**
+ * Make sure a matrix saved with SaveMapped() can be mapped back without
+ * changing it.
+ */
+TEST_CASE("MappedMatrixTest", "[LoadSaveTest]")
+{
+  arma::mat test(7, 103, arma::fill::randu);
+  REQUIRE(data::SaveMapped("test_mapped.bin", test) == true);
+
+  {
+    data::MappedMatrix<double> mapped("test_mapped.bin");
+    REQUIRE(mapped.Matrix().n_rows == test.n_rows);
+    REQUIRE(mapped.Matrix().n_cols == test.n_cols);
+    CheckMatrices(mapped.Matrix(), test);
+
+    // The alias must use the mapped memory.
+    arma::mat* alias = mapped.Alias();
+    REQUIRE(alias->memptr() == mapped.Matrix().memptr());
+    delete alias;
+
+    // Writing to the matrix must not change the file.
+    mapped.Matrix()(0, 0) = -1.0;
+  }
+
+  data::MappedMatrix<double> mapped("test_mapped.bin");
+  CheckMatrices(mapped.Matrix(), test);
+
+  // The element type must match.
+  REQUIRE_THROWS_AS(data::MappedMatrix<float>("test_mapped.bin"),
+      std::runtime_error);
+
+  remove("test_mapped.bin");
+}
+
+/**
+ * Make sure the DatasetInfo and labels saved with a mapped matrix can be loaded
+ * back, and that data::Load() recognizes mapped matrix files.
+ */
+TEST_CASE("MappedMatrixMetadataTest", "[LoadSaveTest]")
+{
+  std::fstream f;
+  f.open("test_mapped.csv", std::fstream::out);
+  f << "1, 2, hello" << std::endl;
+  f << "3, 4, goodbye" << std::endl;
+  f << "5, 6, hello" << std::endl;
+  f.close();
+
+  arma::mat dataset;
+  DatasetInfo info;
+  REQUIRE(data::Load("test_mapped.csv", dataset, info) == true);
+  remove("test_mapped.csv");
+
+  arma::Row<size_t> labels("0 1 1");
+  REQUIRE(data::SaveMapped("test_mapped.bin", dataset, info, labels) == true);
+
+  {
+    data::MappedMatrix<double> mapped("test_mapped.bin");
+    CheckMatrices(mapped.Matrix(), dataset);
+    REQUIRE(mapped.HasMetadata());
+
+    DatasetInfo loadedInfo;
+    arma::Row<size_t> loadedLabels;
+    mapped.LoadMetadata(loadedInfo, loadedLabels);
+
+    REQUIRE(loadedInfo.Dimensionality() == 3);
+    REQUIRE(loadedInfo.Type(0) == Datatype::numeric);
+    REQUIRE(loadedInfo.Type(1) == Datatype::numeric);
+    REQUIRE(loadedInfo.Type(2) == Datatype::categorical);
+    REQUIRE(loadedInfo.NumMappings(2) == 2);
+    REQUIRE(loadedInfo.UnmapString(dataset(2, 1), 2) == "goodbye");
+    REQUIRE(arma::accu(loadedLabels != labels) == 0);
+  }
+
+  // data::Load() must not transpose the matrix.
+  arma::mat loaded;
+  REQUIRE(data::Load("test_mapped.bin", loaded) == true);
+  CheckMatrices(loaded, dataset);
+
+  DatasetInfo loadedInfo;
+  REQUIRE(data::Load("test_mapped.bin", loaded, loadedInfo) == true);
+  CheckMatrices(loaded, dataset);
+  REQUIRE(loadedInfo.Type(2) == Datatype::categorical);
+
+  // Without metadata, the DatasetInfo is all numeric.
+  arma::mat test(4, 10, arma::fill::randu);
+  REQUIRE(data::SaveMapped("test_mapped.bin", test) == true);
+  REQUIRE(!data::MappedMatrix<double>("test_mapped.bin").HasMetadata());
+  REQUIRE(data::Load("test_mapped.bin", loaded, loadedInfo) == true);
+  CheckMatrices(loaded, test);
+  REQUIRE(loadedInfo.Dimensionality() == 4);
+  REQUIRE(loadedInfo.Type(2) == Datatype::numeric);
+
+  // The element type must match.
+  arma::fmat floatLoaded;
+  REQUIRE(data::Load("test_mapped.bin", floatLoaded) == false);
+
+  remove("test_mapped.bin");
+}
+
+/**
+ * Make sure MappedMatrix fails on a file that was not written by SaveMapped().
+ */
+TEST_CASE("MappedMatrixInvalidFileTest", "[LoadSaveTest]")
+{
+  std::fstream f;
+  f.open("test_mapped.txt", std::fstream::out);
+  f << "1 2 3 4" << std::endl;
+  f << "5 6 7 8" << std::endl;
+  f.close();
+
+  REQUIRE_THROWS_AS(data::MappedMatrix<double>("test_mapped.txt"),
+      std::runtime_error);
+  REQUIRE_THROWS_AS(data::MappedMatrix<double>("nonexistent_mapped.bin"),
+      std::runtime_error);
+
+  remove("test_mapped.txt");
+}
+
+/**
+ * Make sure MappedMatrix rejects a header whose sizes would overflow when
+ * multiplied, or that describe more elements than the file holds.
+ */
+TEST_CASE("MappedMatrixOverflowHeaderTest", "[LoadSaveTest]")
+{
+  arma::mat test(4, 5, arma::fill::randu);
+  REQUIRE(data::SaveMapped("test_mapped.bin", test));
+
+  // nRows and nCols follow the 8-byte magic string and the element size.
+  // 2^32 * 2^32 wraps to 0 in 64 bits.
+  const uint64_t sizes[2] = { uint64_t(1) << 32, uint64_t(1) << 32 };
+  std::fstream f("test_mapped.bin",
+      std::fstream::in | std::fstream::out | std::fstream::binary);
+  f.seekp(16);
+  f.write((const char*) sizes, sizeof(sizes));
+  f.close();
+
+  REQUIRE_THROWS_AS(data::MappedMatrix<double>("test_mapped.bin"),
+      std::runtime_error);
+
+  // This product does not overflow, but the file is far too small.
+  const uint64_t bigSizes[2] = { uint64_t(1) << 20, uint64_t(1) << 20 };
+  f.open("test_mapped.bin",
+      std::fstream::in | std::fstream::out | std::fstream::binary);
+  f.seekp(16);
+  f.write((const char*) bigSizes, sizeof(bigSizes));
+  f.close();
+
+  REQUIRE_THROWS_AS(data::MappedMatrix<double>("test_mapped.bin"),
+      std::runtime_error);
+
+  remove("test_mapped.bin");
+}
+
+/**
+ * Make sure PrefetchLoader returns every chunk of a FileChunkSource, in order
+ * or shuffled, on each pass.
+ */
+TEST_CASE("PrefetchLoaderTest", "[LoadSaveTest]")
+{
+  std::vector<arma::mat> chunks, chunkResponses;
+  std::vector<std::string> predictorFiles, responseFiles;
+  for (size_t i = 0; i < 5; ++i)
+  {
+    chunks.push_back(arma::randu<arma::mat>(3, 4 + i));
+    chunkResponses.push_back(arma::randu<arma::mat>(1, 4 + i));
+    predictorFiles.push_back("test_chunk_" + std::to_string(i) + ".csv");
+    responseFiles.push_back("test_chunk_resp_" + std::to_string(i) + ".csv");
+    REQUIRE(data::Save(predictorFiles[i], chunks[i]) == true);
+    REQUIRE(data::Save(responseFiles[i], chunkResponses[i]) == true);
+  }
+
+  PrefetchLoader<FileChunkSource> loader(FileChunkSource(predictorFiles,
+      responseFiles), 1);
+  REQUIRE(loader.NumChunks() == 5);
+
+  arma::mat predictors, responses;
+  for (size_t pass = 0; pass < 2; ++pass)
+  {
+    for (size_t i = 0; i < 5; ++i)
+    {
+      REQUIRE(loader.Next(predictors, responses) == true);
+      CheckMatrices(predictors, chunks[i]);
+      CheckMatrices(responses, chunkResponses[i]);
+    }
+
+    REQUIRE(loader.Next(predictors, responses) == false);
+    loader.Reset();
+  }
+
+  // A shuffled pass returns each chunk once; the chunks have different sizes.
+  PrefetchLoader<FileChunkSource> shuffledLoader(FileChunkSource(
+      predictorFiles, responseFiles), 2, true);
+  std::vector<bool> seen(5, false);
+  while (shuffledLoader.Next(predictors, responses))
+  {
+    const size_t i = predictors.n_cols - 4;
+    REQUIRE(seen[i] == false);
+    seen[i] = true;
+    CheckMatrices(predictors, chunks[i]);
+  }
+
+  for (size_t i = 0; i < 5; ++i)
+    REQUIRE(seen[i] == true);
+
+  // Destroying a loader that is still prefetching must not block.
+  {
+    PrefetchLoader<FileChunkSource> unusedLoader(FileChunkSource(
+        predictorFiles, responseFiles), 1);
+  }
+
+  for (size_t i = 0; i < 5; ++i)
+  {
+    remove(predictorFiles[i].c_str());
+    remove(responseFiles[i].c_str());
+  }
+}
+
+/**
+ * Make sure an error of the source is thrown by PrefetchLoader::Next(), after
+ * the chunks that were loaded before it.
+ */
+TEST_CASE("PrefetchLoaderErrorTest", "[LoadSaveTest]")
+{
+  arma::mat chunk = arma::randu<arma::mat>(3, 5);
+  REQUIRE(data::Save("test_chunk.csv", chunk) == true);
+
+  std::vector<std::string> predictorFiles = { "test_chunk.csv",
+      "nonexistent_chunk.csv" };
+  std::vector<std::string> responseFiles = { "test_chunk.csv",
+      "test_chunk.csv" };
+  PrefetchLoader<FileChunkSource> loader(FileChunkSource(predictorFiles,
+      responseFiles));
+
+  arma::mat predictors, responses;
+  REQUIRE(loader.Next(predictors, responses) == true);
+  CheckMatrices(predictors, chunk);
+  REQUIRE_THROWS_AS(loader.Next(predictors, responses), std::runtime_error);
+  REQUIRE(loader.Next(predictors, responses) == false);
+
+  REQUIRE_THROWS_AS(FileChunkSource(predictorFiles, { "test_chunk.csv" }),
+      std::invalid_argument);
+
+  remove("test_chunk.csv");
+}
+
+/**
+ * Make sure that the parallel numeric parser gives the same matrix that was
+ * written, in both layouts, and that data::Load() uses it.
+ */
+TEST_CASE("LoadNumericCSVTest", "[LoadSaveTest]")
+{
+  arma::mat dataset(4, 5000, arma::fill::randn);
+
+  std::fstream f;
+  f.open("test_numeric.csv", std::fstream::out);
+  f << std::setprecision(17);
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+  {
+    for (size_t j = 0; j < dataset.n_rows; ++j)
+      f << (j == 0 ? "" : (j % 2 == 0 ? ", " : ",")) << dataset(j, i);
+    f << '\n';
+  }
+  f.close();
+
+  arma::mat loaded;
+  REQUIRE(LoadNumericCSV("test_numeric.csv", loaded, true, true));
+  REQUIRE(loaded.n_rows == dataset.n_rows);
+  REQUIRE(loaded.n_cols == dataset.n_cols);
+  CheckMatrices(loaded, dataset);
+
+  arma::mat loadedTrans;
+  REQUIRE(LoadNumericCSV("test_numeric.csv", loadedTrans, true, false));
+  CheckMatrices(loadedTrans, dataset.t());
+
+  arma::mat test;
+  REQUIRE(data::Load("test_numeric.csv", test));
+  CheckMatrices(test, dataset);
+
+  remove("test_numeric.csv");
+}
+
+/**
+ * Make sure the parallel numeric parser handles whitespace-separated files
+ * with carriage returns and no final newline.
+ */
+TEST_CASE("LoadNumericTXTTest", "[LoadSaveTest]")
+{
+  std::fstream f;
+  f.open("test_numeric.txt", std::fstream::out | std::fstream::binary);
+  f << "1 2\t 3\r\n";
+  f << "  4  5 6 \r\n";
+  f << "7\t8\t9";
+  f.close();
+
+  arma::mat test;
+  REQUIRE(LoadNumericCSV("test_numeric.txt", test, false, true));
+  REQUIRE(test.n_rows == 3);
+  REQUIRE(test.n_cols == 3);
+  for (size_t i = 0; i < 9; ++i)
+    REQUIRE(test[i] == Approx(double(i + 1)).epsilon(1e-7));
+
+  remove("test_numeric.txt");
+}
+
+/**
+ * Make sure that FirstTouch() zeroes every element, with contiguous ranges of
+ * columns or with interleaved pages, including a partial last page.
+ */
+TEST_CASE("FirstTouchTest", "[LoadSaveTest]")
+{
+  for (size_t interleave = 0; interleave < 2; ++interleave)
+  {
+    arma::mat matrix(7, 1001, arma::fill::randu);
+    FirstTouch(matrix, interleave == 1);
+    REQUIRE(matrix.n_rows == 7);
+    REQUIRE(matrix.n_cols == 1001);
+    REQUIRE(arma::all(arma::vectorise(matrix) == 0.0));
+
+    arma::Mat<unsigned char> bytes(3, 5000, arma::fill::ones);
+    FirstTouch(bytes, interleave == 1);
+    REQUIRE(arma::accu(bytes) == 0);
+  }
+}
+
+/**
+ * Make sure the parallel numeric parser refuses files it cannot handle.
+ */
+TEST_CASE("LoadNumericCSVFallbackTest", "[LoadSaveTest]")
+{
+  std::fstream f;
+  f.open("test_numeric.csv", std::fstream::out);
+  f << "1, 2, 3" << std::endl;
+  f << "4, 5" << std::endl;
+  f << "7, 8, 9" << std::endl;
+  f.close();
+
+  arma::mat test;
+  REQUIRE(!LoadNumericCSV("test_numeric.csv", test, true, true));
+
+  f.open("test_numeric.csv", std::fstream::out);
+  f << "1, 2, 3" << std::endl;
+  f << "4, , 6" << std::endl;
+  f.close();
+
+  REQUIRE(!LoadNumericCSV("test_numeric.csv", test, true, true));
+
+  f.open("test_numeric.csv", std::fstream::out);
+  f << "1, 2, 3" << std::endl;
+  f << "4, 5a, 6" << std::endl;
+  f.close();
+
+  REQUIRE(!LoadNumericCSV("test_numeric.csv", test, true, true));
+
+  // Empty lines are left to Armadillo too.
+  f.open("test_numeric.csv", std::fstream::out);
+  f << "1, 2, 3" << std::endl;
+  f << std::endl;
+  f << "4, 5, 6" << std::endl;
+  f.close();
+
+  REQUIRE(!LoadNumericCSV("test_numeric.csv", test, true, true));
+
+  remove("test_numeric.csv");
+}
+
+/**
+ * Make sure the chunks of a ChunkedReader over a CSV file with a categorical
+ * dimension together give the same matrix and mappings as data::Load().
+ */
+TEST_CASE("ChunkedReaderCSVTest", "[LoadSaveTest]")
+{
+  std::fstream f;
+  f.open("test_chunked.csv", std::fstream::out);
+  const char* words[] = { "apple", "banana", "cherry" };
+  for (size_t i = 0; i < 10; ++i)
+    f << i << ", " << (2.5 * i) << ", " << words[(i * 7) % 3] << std::endl;
+  f.close();
+
+  arma::mat dataset;
+  DatasetInfo info;
+  REQUIRE(data::Load("test_chunked.csv", dataset, info) == true);
+
+  ChunkedReader reader("test_chunked.csv", 3);
+  REQUIRE(reader.NumChunks() == 4);
+  REQUIRE(reader.NumColumns() == 10);
+  REQUIRE(reader.Dimensionality() == 3);
+  REQUIRE(reader.Info().Type(2) == Datatype::categorical);
+  REQUIRE(reader.Info().NumMappings(2) == 3);
+  for (size_t i = 0; i < 3; ++i)
+  {
+    REQUIRE(reader.Info().UnmapString(i, 2) ==
+        info.UnmapString(i, 2));
+  }
+
+  arma::mat chunk, all;
+  size_t chunks = 0;
+  while (reader.Next(chunk))
+  {
+    REQUIRE(chunk.n_cols <= 3);
+    all = arma::join_rows(all, chunk);
+    ++chunks;
+  }
+  REQUIRE(chunks == 4);
+  CheckMatrices(all, dataset);
+
+  // Chunks can also be read in any order.
+  arma::mat responses;
+  reader.Load(2, chunk, responses);
+  CheckMatrices(chunk, dataset.cols(6, 8));
+  REQUIRE(responses.n_elem == 0);
+
+  reader.Reset();
+  REQUIRE(reader.Next(chunk));
+  CheckMatrices(chunk, dataset.cols(0, 2));
+
+  remove("test_chunked.csv");
+}
+
+/**
+ * Make sure a ChunkedReader can read Armadillo binary and mapped matrix files.
+ */
+TEST_CASE("ChunkedReaderBinaryTest", "[LoadSaveTest]")
+{
+  arma::mat dataset(5, 23, arma::fill::randu);
+  REQUIRE(data::Save("test_chunked.bin", dataset) == true);
+  REQUIRE(data::SaveMapped("test_chunked_mapped.bin", dataset) == true);
+
+  const char* files[] = { "test_chunked.bin", "test_chunked_mapped.bin" };
+  for (size_t f = 0; f < 2; ++f)
+  {
+    ChunkedReader reader(files[f], 10);
+    REQUIRE(reader.NumChunks() == 3);
+    REQUIRE(reader.NumColumns() == 23);
+    REQUIRE(reader.Dimensionality() == 5);
+
+    arma::mat chunk, all;
+    while (reader.Next(chunk))
+      all = arma::join_rows(all, chunk);
+    CheckMatrices(all, dataset);
+  }
+
+  remove("test_chunked.bin");
+  remove("test_chunked_mapped.bin");
+
+  // A ChunkedReader can't be used on unknown formats.
+  REQUIRE_THROWS_AS(ChunkedReader("test_chunked.xyz", 10),
+      std::runtime_error);
+  REQUIRE_THROWS_AS(ChunkedReader("test_chunked.csv", 0),
+      std::invalid_argument);
+}
+
+/**
+ * Make sure that the AsyncCheckpointer writes snapshots taken at the time of
+ * Save(), keeps only the last checkpoints, and reports write errors.
+ */
+TEST_CASE("AsyncCheckpointerTest", "[LoadSaveTest]")
+{
+  std::vector<arma::mat> matrices(4);
+  {
+    AsyncCheckpointer checkpointer("test_checkpoint.xml", 2);
+    for (size_t i = 0; i < matrices.size(); ++i)
+    {
+      arma::mat matrix(3, 4, arma::fill::randu);
+      matrices[i] = matrix;
+      checkpointer.Save("matrix", matrix);
+
+      // The checkpoint must not see changes made after Save().
+      matrix.fill(-1.0);
+      checkpointer.Wait();
+    }
+    REQUIRE(checkpointer.NumSkipped() == 0);
+
+    const std::vector<std::string> checkpoints = checkpointer.Checkpoints();
+    REQUIRE(checkpoints.size() == 2);
+    REQUIRE(checkpoints[0] == "test_checkpoint-3.xml");
+    REQUIRE(checkpoints[1] == "test_checkpoint-4.xml");
+    REQUIRE(!std::ifstream("test_checkpoint-1.xml").good());
+    REQUIRE(!std::ifstream("test_checkpoint-2.xml").good());
+
+    for (size_t i = 0; i < 2; ++i)
+    {
+      arma::mat matrix;
+      REQUIRE(data::Load(checkpoints[i], "matrix", matrix));
+      CheckMatrices(matrix, matrices[i + 2]);
+    }
+
+    // The destructor writes the last checkpoint.
+    checkpointer.Save("matrix", matrices[0]);
+  }
+
+  arma::mat matrix;
+  REQUIRE(data::Load("test_checkpoint-5.xml", "matrix", matrix));
+  CheckMatrices(matrix, matrices[0]);
+  REQUIRE(!std::ifstream("test_checkpoint-3.xml").good());
+  remove("test_checkpoint-4.xml");
+  remove("test_checkpoint-5.xml");
+
+  // The error of a failed write is thrown by the next call.
+  AsyncCheckpointer checkpointer("nonexistent_directory/checkpoint.xml");
+  checkpointer.Save("matrix", matrix);
+  REQUIRE_THROWS_AS(checkpointer.Wait(), std::runtime_error);
+  REQUIRE(checkpointer.Checkpoints().empty());
+
+  REQUIRE_THROWS_AS(AsyncCheckpointer("test_checkpoint", 2),
+      std::invalid_argument);
+  REQUIRE_THROWS_AS(AsyncCheckpointer("test_checkpoint.xml", 0),
+      std::invalid_argument);
+}
+
+// A model that counts its live copies and is slow to serialize.
+class CountedModel
+{
+ public:
+  CountedModel() : value(0) { Count(); }
+  CountedModel(const CountedModel& other) : value(other.value) { Count(); }
+  ~CountedModel() { --live; }
+
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */)
+  {
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    ar & BOOST_SERIALIZATION_NVP(value);
+  }
+
+  //! Record a new live copy.
+  static void Count()
+  {
+    const int current = ++live;
+    int previous = maxLive;
+    while (current > previous &&
+        !maxLive.compare_exchange_weak(previous, current)) { }
+  }
+
+  int value;
+  static std::atomic<int> live;
+  static std::atomic<int> maxLive;
+};
+
+std::atomic<int> CountedModel::live(0);
+std::atomic<int> CountedModel::maxLive(0);
+
+/**
+ * Make sure that the AsyncCheckpointer keeps at most two copies of a model when
+ * checkpoints are requested faster than they are written.
+ */
+TEST_CASE("AsyncCheckpointerCopiesTest", "[LoadSaveTest]")
+{
+  {
+    CountedModel model;
+    AsyncCheckpointer checkpointer("test_checkpoint_copies.xml", 1);
+    for (int i = 0; i < 20; ++i)
+    {
+      model.value = i;
+      checkpointer.Save("model", model);
+    }
+    checkpointer.Wait();
+    REQUIRE(checkpointer.NumSkipped() > 0);
+
+    // The model itself, the copy being written and the waiting copy.
+    REQUIRE(CountedModel::maxLive <= 3);
+
+    CountedModel loaded;
+    REQUIRE(data::Load(checkpointer.Checkpoints().back(), "model", loaded));
+    REQUIRE(loaded.value == 19);
+
+    remove(checkpointer.Checkpoints().back().c_str());
+  }
+  REQUIRE(CountedModel::live == 0);
+}
+
+/**
+ * Make sure that a StringPool maps distinct strings to consecutive indices and
+ * back.
+ */
+TEST_CASE("StringPoolTest", "[LoadSaveTest]")
+{
+  StringPool pool;
+  size_t index = 0;
+  REQUIRE(pool.Size() == 0);
+  REQUIRE(!pool.Find("", index));
+
+  // Enough strings to rehash the table several times; every third one is a
+  // repeat.
+  for (size_t i = 0; i < 3000; ++i)
+  {
+    const size_t j = (i % 3 == 2) ? i - 1 : i;
+    const std::string str = std::to_string(j);
+    const size_t expected = j - j / 3;
+    REQUIRE(pool.Insert(str) == expected);
+  }
+  REQUIRE(pool.Size() == 2000);
+  REQUIRE(pool.Insert("") == 2000);
+
+  REQUIRE(pool.Find("10", index));
+  REQUIRE(index == 7);
+  REQUIRE(pool.String(7) == "10");
+  REQUIRE(pool.Find("", index));
+  REQUIRE(index == 2000);
+  REQUIRE(pool.String(2000) == "");
+  REQUIRE(!pool.Find("-1", index));
+
+  pool.Clear();
+  REQUIRE(pool.Size() == 0);
+  REQUIRE(!pool.Find("10", index));
+  REQUIRE(pool.Insert("10") == 0);
+}
+
+/**
+ * Make sure that the pooled mappings of a DatasetInfo survive serialization.
+ */
+TEST_CASE("DatasetInfoManyCategoriesSerializationTest", "[LoadSaveTest]")
+{
+  DatasetInfo info(2);
+  for (size_t i = 0; i < 5000; ++i)
+    info.MapString<double>("category " + std::to_string(i % 2500), 1);
+  REQUIRE(info.NumMappings(0) == 0);
+  REQUIRE(info.NumMappings(1) == 2500);
+
+  REQUIRE(data::Save("test_dataset_info.bin", "info", info, true));
+  DatasetInfo loaded;
+  REQUIRE(data::Load("test_dataset_info.bin", "info", loaded, true));
+  remove("test_dataset_info.bin");
+
+  REQUIRE(loaded.Dimensionality() == 2);
+  REQUIRE(loaded.Type(0) == Datatype::numeric);
+  REQUIRE(loaded.Type(1) == Datatype::categorical);
+  REQUIRE(loaded.NumMappings(1) == 2500);
+  for (size_t i = 0; i < 2500; ++i)
+  {
+    REQUIRE(loaded.UnmapString(i, 1) == "category " + std::to_string(i));
+    REQUIRE(loaded.UnmapValue("category " + std::to_string(i), 1) == i);
+    REQUIRE(loaded.NumUnmappings(i, 1) == 1);
+  }
+  REQUIRE_THROWS_AS(loaded.UnmapString(2500, 1), std::invalid_argument);
+  REQUIRE_THROWS_AS(loaded.UnmapString(0, 1, 1), std::invalid_argument);
+
+  // New strings are appended after the loaded ones.
+  REQUIRE(loaded.MapString<size_t>("category 7", 1) == 7);
+  REQUIRE(loaded.MapString<size_t>("new category", 1) == 2500);
+}
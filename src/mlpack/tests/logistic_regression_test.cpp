@@ -1057,4 +1057,77 @@ BOOST_AUTO_TEST_CASE(IncrementalTraining)
   BOOST_REQUIRE_CLOSE(acc, 100.0, 3.0); // 3% error tolerance.
 }
 
+/**
+ * Make sure the sparse batch gradient matches the dense batch gradient on the
+ * features which appear in the batch, and leaves the other features empty.
+ */
+BOOST_AUTO_TEST_CASE(LogisticRegressionFunctionSparseGradientTest)
+{
+  arma::sp_mat dataset;
+  dataset.sprandu(100, 200, 0.02);
+  arma::mat denseDataset(dataset);
+  arma::Row<size_t> labels(200);
+  for (size_t i = 0; i < 200; ++i)
+    labels[i] = math::RandInt(0, 2);
+
+  LogisticRegressionFunction<arma::sp_mat> lrf(dataset, labels, 0.5);
+  LogisticRegressionFunction<> denseLrf(denseDataset, labels, 0.5);
+  LogisticRegressionFunction<arma::sp_mat> unregularized(dataset, labels, 0.0);
+
+  const arma::mat parameters = arma::randu<arma::mat>(1, 101);
+  for (size_t begin = 0; begin < 200; begin += 10)
+  {
+    arma::sp_mat gradient;
+    arma::mat denseGradient;
+    lrf.Gradient(parameters, begin, gradient, 10);
+    denseLrf.Gradient(parameters, begin, denseGradient, 10);
+
+    BOOST_REQUIRE_EQUAL(gradient.n_rows, 1);
+    BOOST_REQUIRE_EQUAL(gradient.n_cols, 101);
+
+    // The intercept always has a gradient.
+    BOOST_REQUIRE_CLOSE(gradient(0, 0), denseGradient(0, 0), 1e-5);
+
+    const arma::sp_mat batch = dataset.cols(begin, begin + 9);
+    for (size_t i = 0; i < 100; ++i)
+    {
+      if (arma::accu(arma::abs(batch.row(i))) == 0.0)
+        BOOST_REQUIRE_SMALL((double) gradient(0, i + 1), 1e-10);
+      else
+        BOOST_REQUIRE_CLOSE(gradient(0, i + 1), denseGradient(0, i + 1), 1e-5);
+    }
+
+    // Without regularization, the objective of the batch is the same.
+    BOOST_REQUIRE_CLOSE(unregularized.EvaluateWithGradient(parameters, begin,
+        gradient, 10), denseLrf.Evaluate(parameters, begin, 10) -
+        0.5 * (10 / (2.0 * 200)) * arma::dot(parameters.tail_cols(100),
+        parameters.tail_cols(100)), 1e-5);
+  }
+}
+
+/**
+ * Train sparse logistic regression with the sparse gradients of ParallelSGD
+ * and make sure the model is accurate.
+ */
+BOOST_AUTO_TEST_CASE(LogisticRegressionSparseParallelSGDTest)
+{
+  // The label only depends on the sign of the first feature; a few other
+  // random features are present in each point.
+  arma::sp_mat dataset(50, 1000);
+  arma::Row<size_t> responses(1000);
+  for (size_t i = 0; i < 1000; ++i)
+  {
+    responses[i] = i % 2;
+    dataset(0, i) = (i % 2 == 0) ? -1.0 : 1.0;
+    dataset(math::RandInt(1, 50), i) = math::Random();
+  }
+
+  LogisticRegression<arma::sp_mat> lr(dataset.n_rows, 0.0);
+  ens::ParallelSGD<ens::ConstantStep> psgd(50000, 1000, 1e-10, true,
+      ens::ConstantStep(0.1));
+  lr.Train(dataset, responses, psgd);
+
+  BOOST_REQUIRE_GT(lr.ComputeAccuracy(dataset, responses), 98.0);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
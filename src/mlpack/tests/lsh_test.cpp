@@ -985,4 +985,70 @@ BOOST_AUTO_TEST_CASE(SparseLSHTest)
   }
 }
 
+/**
+ * Make sure that the rows of the second hash table are packed correctly: the
+ * offsets never decrease, each row holds at most bucketSize valid point
+ * indices, and every point is held at most once per table.
+ */
+BOOST_AUTO_TEST_CASE(BucketLayoutTest)
+{
+  const size_t numTables = 6;
+  const size_t bucketSize = 10;
+  arma::mat rdata = arma::randu<arma::mat>(4, 800);
+
+  LSHSearch<> lsh(rdata, 3, numTables, 0.5, 99901, bucketSize);
+
+  const arma::Col<size_t>& offsets = lsh.BucketOffsets();
+  const arma::Col<size_t>& contents = lsh.BucketContents();
+
+  BOOST_REQUIRE_GT(offsets.n_elem, 1);
+  BOOST_REQUIRE_EQUAL(offsets[0], 0);
+  BOOST_REQUIRE_EQUAL(offsets[offsets.n_elem - 1], contents.n_elem);
+  BOOST_REQUIRE_LE(contents.n_elem, numTables * rdata.n_cols);
+
+  for (size_t i = 0; i + 1 < offsets.n_elem; ++i)
+  {
+    BOOST_REQUIRE_LE(offsets[i], offsets[i + 1]);
+    BOOST_REQUIRE_LE(offsets[i + 1] - offsets[i], bucketSize);
+  }
+
+  arma::Col<size_t> counts(rdata.n_cols, arma::fill::zeros);
+  for (size_t i = 0; i < contents.n_elem; ++i)
+  {
+    BOOST_REQUIRE_LT(contents[i], rdata.n_cols);
+    ++counts[contents[i]];
+  }
+
+  BOOST_REQUIRE_LE(counts.max(), numTables);
+}
+
+/**
+ * Make sure that the queries are hashed the same way whatever block of
+ * queries they are projected with, by searching a query set that spans
+ * several blocks, and then searching its last queries alone.
+ */
+BOOST_AUTO_TEST_CASE(QueryBlockTest)
+{
+  arma::mat rdata = arma::randu<arma::mat>(4, 1000);
+  arma::mat qdata = arma::randu<arma::mat>(4, 2500);
+
+  LSHSearch<> lsh(rdata, 4, 10, 0.5);
+
+  arma::Mat<size_t> neighbors, subsetNeighbors;
+  arma::mat distances, subsetDistances;
+  lsh.Search(qdata, 3, neighbors, distances, 0, 2);
+  lsh.Search(arma::mat(qdata.cols(1500, 2499)), 3, subsetNeighbors,
+      subsetDistances, 0, 2);
+
+  for (size_t i = 0; i < subsetNeighbors.n_cols; ++i)
+  {
+    for (size_t j = 0; j < subsetNeighbors.n_rows; ++j)
+    {
+      BOOST_REQUIRE_EQUAL(subsetNeighbors(j, i), neighbors(j, 1500 + i));
+      BOOST_REQUIRE_CLOSE(subsetDistances(j, i), distances(j, 1500 + i),
+          1e-5);
+    }
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END();
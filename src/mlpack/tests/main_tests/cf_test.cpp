@@ -714,4 +714,61 @@ BOOST_AUTO_TEST_CASE(CFNormalizationTest)
   BOOST_REQUIRE(arma::any(arma::vectorise(output1 != output3)));
 }
 
+/**
+ * Ensure that new users can be folded into a saved model and queried.
+ */
+BOOST_AUTO_TEST_CASE(CFFoldInTest)
+{
+  mat dataset;
+  data::Load("GroupLensSmall.csv", dataset);
+
+  SetInputParam("training", dataset);
+  SetInputParam("max_iterations", int(10));
+  SetInputParam("algorithm", std::string("RegSVD"));
+
+  mlpackMain();
+
+  // Reset passed parameters.
+  IO::GetSingleton().Parameters()["training"].wasPassed = false;
+  IO::GetSingleton().Parameters()["max_iterations"].wasPassed = false;
+  IO::GetSingleton().Parameters()["algorithm"].wasPassed = false;
+
+  // The new user has the ratings of user 0.
+  const size_t newUser = (size_t) arma::max(dataset.row(0)) + 1;
+  mat foldIn = dataset.cols(arma::find(dataset.row(0) == 0));
+  foldIn.row(0).fill(newUser);
+
+  Mat<size_t> query(1, 1);
+  query(0, 0) = newUser;
+
+  SetInputParam("input_model",
+      std::move(IO::GetParam<CFModel*>("output_model")));
+  SetInputParam("fold_in", std::move(foldIn));
+  SetInputParam("query", std::move(query));
+  SetInputParam("recommendations", 5);
+
+  mlpackMain();
+
+  const arma::Mat<size_t> output = IO::GetParam<arma::Mat<size_t>>("output");
+  BOOST_REQUIRE_EQUAL(output.n_rows, 5);
+  BOOST_REQUIRE_EQUAL(output.n_cols, 1);
+}
+
+/**
+ * Ensure that fold_in_lambda is non-negative.
+ */
+BOOST_AUTO_TEST_CASE(CFFoldInLambdaBoundTest)
+{
+  mat dataset;
+  data::Load("GroupLensSmall.csv", dataset);
+
+  SetInputParam("training", dataset);
+  SetInputParam("fold_in", dataset);
+  SetInputParam("fold_in_lambda", -1.0);
+
+  Log::Fatal.ignoreInput = true;
+  BOOST_REQUIRE_THROW(mlpackMain(), std::runtime_error);
+  Log::Fatal.ignoreInput = false;
+}
+
 BOOST_AUTO_TEST_SUITE_END();
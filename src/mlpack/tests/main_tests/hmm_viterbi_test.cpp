@@ -244,3 +244,61 @@ TEST_CASE_METHOD(HMMViterbiTestFixture,
   REQUIRE(out.n_rows == 1);
   REQUIRE(out.n_cols == observations.n_cols);
 }
+
+TEST_CASE_METHOD(HMMViterbiTestFixture,
+                 "HMMViterbiLagAndBeamTest",
+                 "[HMMViterbiMainTest][BindingTests]")
+{
+  // Create a Gaussian HMM with well-separated states, so that approximate
+  // decoding finds the exact path.
+  HMMModel* h = new HMMModel(GaussianHMM);
+  *(h->GaussianHMM()) = HMM<GaussianDistribution>(3, GaussianDistribution(1));
+  h->GaussianHMM()->Transition() = arma::mat("0.8 0.1 0.1;"
+                                          "0.1 0.8 0.1;"
+                                          "0.1 0.1 0.8");
+  h->GaussianHMM()->Emission()[0] = GaussianDistribution("0.0", "1.0");
+  h->GaussianHMM()->Emission()[1] = GaussianDistribution("10.0", "1.0");
+  h->GaussianHMM()->Emission()[2] = GaussianDistribution("20.0", "1.0");
+
+  // Enough observations for several blocks.
+  arma::mat observations;
+  arma::Row<size_t> states;
+  h->GaussianHMM()->Generate(2500, observations, states);
+
+  arma::Row<size_t> expected;
+  h->GaussianHMM()->Predict(observations, expected);
+
+  SetInputParam("input_model", h);
+  SetInputParam("input", observations);
+  SetInputParam("lag", 20);
+  SetInputParam("beam_width", 30.0);
+
+  mlpackMain();
+
+  arma::Mat<size_t> out = IO::GetParam<arma::Mat<size_t> >("output");
+  REQUIRE(out.n_rows == 1);
+  REQUIRE(out.n_cols == observations.n_cols);
+  for (size_t i = 0; i < out.n_cols; ++i)
+    REQUIRE(out[i] == expected[i]);
+}
+
+TEST_CASE_METHOD(HMMViterbiTestFixture,
+                 "HMMViterbiNegativeLagTest",
+                 "[HMMViterbiMainTest][BindingTests]")
+{
+  arma::mat inp;
+  data::Load("obs1.csv", inp);
+  std::vector<arma::mat> trainSeq = {inp};
+
+  HMMModel* h = new HMMModel(DiscreteHMM);
+  h->PerformAction<InitHMMModel, std::vector<arma::mat>>(&trainSeq);
+  h->PerformAction<TrainHMMModel, std::vector<arma::mat>>(&trainSeq);
+
+  SetInputParam("input_model", h);
+  SetInputParam("input", inp);
+  SetInputParam("lag", -1);
+
+  Log::Fatal.ignoreInput = true;
+  REQUIRE_THROWS_AS(mlpackMain(), std::runtime_error);
+  Log::Fatal.ignoreInput = false;
+}
@@ -86,6 +86,25 @@ TEST_CASE_METHOD(ImageConverterTestFixture, "SaveImageTest",
     REQUIRE(testimage[i] == Approx(output[i]).epsilon(1e-7));
 }
 
+/**
+ * Check that images are resized and normalized when height and width are given
+ * while loading.
+ */
+TEST_CASE_METHOD(ImageConverterTestFixture, "LoadResizedImageTest",
+                 "[ImageConverterMainTest][BindingTests]")
+{
+  SetInputParam<vector<string>>("input", {"test_image.png", "test_image.png"});
+  SetInputParam("height", 20);
+  SetInputParam("width", 30);
+  SetInputParam("normalize", true);
+
+  mlpackMain();
+  arma::mat output = IO::GetParam<arma::mat>("output");
+  REQUIRE(output.n_rows == 30 * 20 * 3);
+  REQUIRE(output.n_cols == 2);
+  REQUIRE(output.max() <= 1.0);
+}
+
 /**
  * Check whether binding throws error if height, width or channel are not
  * specified.
@@ -698,3 +698,58 @@ TEST_CASE_METHOD(KNNTestFixture, "KNNDifferentLeafSizes",
   REQUIRE(IO::GetParam<KNNModel*>("output_model")->LeafSize() == (int) 10);
   delete output_model;
 }
+
+/**
+ * Ensure that the number of threads given to the binding is used by the model,
+ * and that the results do not depend on it.
+ */
+TEST_CASE_METHOD(KNNTestFixture, "KNNThreadsTest",
+                 "[KNNMainTest][BindingTests]")
+{
+  arma::mat referenceData;
+  referenceData.randu(3, 200); // 200 points in 3 dimensions.
+  arma::mat queryData;
+  queryData.randu(3, 100); // 100 points in 3 dimensions.
+
+  SetInputParam("reference", referenceData);
+  SetInputParam("query", queryData);
+  SetInputParam("k", (int) 5);
+  SetInputParam("algorithm", std::string("single_tree"));
+
+  mlpackMain();
+
+  arma::Mat<size_t> neighbors = IO::GetParam<arma::Mat<size_t>>("neighbors");
+  arma::mat distances = IO::GetParam<arma::mat>("distances");
+
+  bindings::tests::CleanMemory();
+  IO::GetSingleton().Parameters()["reference"].wasPassed = false;
+  IO::GetSingleton().Parameters()["query"].wasPassed = false;
+
+  SetInputParam("reference", std::move(referenceData));
+  SetInputParam("query", std::move(queryData));
+  SetInputParam("threads", (int) 3);
+
+  mlpackMain();
+
+  REQUIRE(IO::GetParam<KNNModel*>("output_model")->NumThreads() == 3);
+  CheckMatrices(neighbors, IO::GetParam<arma::Mat<size_t>>("neighbors"));
+  CheckMatrices(distances, IO::GetParam<arma::mat>("distances"));
+}
+
+/**
+ * Ensure that a negative number of threads is rejected.
+ */
+TEST_CASE_METHOD(KNNTestFixture, "KNNInvalidThreadsTest",
+                 "[KNNMainTest][BindingTests]")
+{
+  arma::mat referenceData;
+  referenceData.randu(3, 100); // 100 points in 3 dimensions.
+
+  SetInputParam("reference", std::move(referenceData));
+  SetInputParam("k", (int) 5);
+  SetInputParam("threads", (int) -1);
+
+  Log::Fatal.ignoreInput = true;
+  REQUIRE_THROWS_AS(mlpackMain(), std::runtime_error);
+  Log::Fatal.ignoreInput = false;
+}
@@ -106,6 +106,41 @@ BOOST_AUTO_TEST_CASE(NMFMultdivShapeTest)
   BOOST_REQUIRE_EQUAL(h.n_cols, 10);
 }
 
+/**
+ * Ensure the resulting matrices W, H have expected shape when the input is
+ * factorized as a sparse matrix.  Multdiv update rule.
+ */
+BOOST_AUTO_TEST_CASE(NMFSparseMultdivShapeTest)
+{
+  sp_mat sv;
+  sv.sprandu(8, 10, 0.4);
+  // Ensure there is at least one nonzero element in every row and column.
+  for (size_t i = 0; i < 8; ++i)
+    sv(i, i) += 0.1;
+  mat v(sv);
+  int r = 5;
+
+  SetInputParam("update_rules", std::string("multdiv"));
+  SetInputParam("input", std::move(v));
+  SetInputParam("rank", r);
+  SetInputParam("sparse", true);
+
+  // Perform NMF.
+  mlpackMain();
+
+  // Get resulting matrices.
+  const mat& w = IO::GetParam<mat>("w");
+  const mat& h = IO::GetParam<mat>("h");
+
+  // Check the shapes of W and H.
+  BOOST_REQUIRE_EQUAL(w.n_rows, 8);
+  BOOST_REQUIRE_EQUAL(w.n_cols, 5);
+  BOOST_REQUIRE_EQUAL(h.n_rows, 5);
+  BOOST_REQUIRE_EQUAL(h.n_cols, 10);
+  BOOST_REQUIRE(w.is_finite());
+  BOOST_REQUIRE(h.is_finite());
+}
+
 /**
  * Ensure the resulting matrices W, H have expected shape.
  * Als update rule.
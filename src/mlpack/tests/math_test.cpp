@@ -10,8 +10,10 @@
  * http://www.opensource.org/licenses/BSD-3-Clause for more information.
  */
 #include <mlpack/core/math/clamp.hpp>
+#include <mlpack/core/math/moments.hpp>
 #include <mlpack/core/math/random.hpp>
 #include <mlpack/core/math/range.hpp>
+#include <thread>
 #include "catch.hpp"
 #include "test_catch_tools.hpp"
 
@@ -1006,3 +1008,203 @@ TEST_CASE("InplaceSparseShuffleWeightsTest", "[MathTest]")
     REQUIRE(weightCounts[i] == 1);
   }
 }
+
+/**
+ * Make sure the counter-based generator is reproducible, uniform, and gives
+ * different streams for different keys.
+ */
+TEST_CASE("RandomCounterTest", "[MathTest]")
+{
+  const size_t n = 100000;
+  double sum = 0.0;
+  size_t equal = 0;
+  for (size_t i = 0; i < n; ++i)
+  {
+    const double value = RandomCounter(42, i);
+    REQUIRE(value >= 0.0);
+    REQUIRE(value < 1.0);
+    REQUIRE(value == RandomCounter(42, i));
+
+    sum += value;
+    if (RandCounter(42, i) == RandCounter(43, i))
+      ++equal;
+  }
+
+  REQUIRE(sum / n == Approx(0.5).margin(0.01));
+  REQUIRE(equal == 0);
+}
+
+/**
+ * RandomFill() and RandNormalFill() should give numbers of the right
+ * distribution, and the same numbers for the same seed.
+ */
+TEST_CASE("RandomFillTest", "[MathTest]")
+{
+  math::RandomSeed(12);
+  arma::mat x(100, 1001);
+  RandomFill(x, 2.0, 4.0);
+
+  REQUIRE(x.min() >= 2.0);
+  REQUIRE(x.max() < 4.0);
+  REQUIRE(arma::mean(arma::vectorise(x)) == Approx(3.0).epsilon(0.01));
+
+  arma::vec y(100001);
+  RandNormalFill(y, 1.0, 2.0);
+
+  REQUIRE(arma::mean(y) == Approx(1.0).epsilon(0.02));
+  REQUIRE(arma::stddev(y) == Approx(2.0).epsilon(0.02));
+
+  // Reseeding gives the same numbers.
+  math::RandomSeed(12);
+  arma::mat x2(100, 1001);
+  RandomFill(x2, 2.0, 4.0);
+  arma::vec y2(100001);
+  RandNormalFill(y2, 1.0, 2.0);
+
+  CheckMatrices(x, x2);
+  REQUIRE(arma::approx_equal(y, y2, "absdiff", 1e-12));
+}
+
+#ifdef HAS_OPENMP
+
+/**
+ * Each thread of a parallel region should draw from its own stream, and the
+ * streams should be reproducible for a given seed.
+ */
+TEST_CASE("ThreadRandomStreamsTest", "[MathTest]")
+{
+  const size_t numThreads = 4;
+  arma::mat draws(100, numThreads), draws2(100, numThreads);
+
+  math::RandomSeed(7);
+  #pragma omp parallel num_threads(numThreads)
+  {
+    const size_t thread = omp_get_thread_num();
+    for (size_t i = 0; i < draws.n_rows; ++i)
+      draws(i, thread) = math::Random();
+  }
+
+  math::RandomSeed(7);
+  #pragma omp parallel num_threads(numThreads)
+  {
+    const size_t thread = omp_get_thread_num();
+    for (size_t i = 0; i < draws2.n_rows; ++i)
+      draws2(i, thread) = math::Random();
+  }
+
+  // The same seed gives the same numbers for each thread (if the runtime gave
+  // us fewer threads, the unused columns are never written).
+  const size_t usedThreads = std::min(numThreads,
+      (size_t) omp_get_max_threads());
+  for (size_t t = 0; t < usedThreads; ++t)
+  {
+    CheckMatrices(arma::mat(draws.col(t)), arma::mat(draws2.col(t)));
+
+    // The master thread uses the global stream, which is the same stream a
+    // serial caller sees.
+    if (t == 0)
+    {
+      math::RandomSeed(7);
+      for (size_t i = 0; i < draws.n_rows; ++i)
+        REQUIRE(draws(i, 0) == math::Random());
+    }
+
+    // Different threads draw different numbers.
+    for (size_t u = 0; u < t; ++u)
+      REQUIRE(arma::accu(draws.col(t) == draws.col(u)) == 0);
+  }
+}
+
+#endif
+
+/**
+ * Threads that are not OpenMP workers (here, std::thread workers, whose OpenMP
+ * thread number is 0) should not share the global stream either: each should
+ * draw its own numbers, and the thread that called RandomSeed() should still
+ * see the global stream.
+ */
+TEST_CASE("ForeignThreadRandomStreamsTest", "[MathTest]")
+{
+  const size_t numThreads = 3;
+  arma::mat draws(100, numThreads + 1);
+
+  math::RandomSeed(11);
+  std::vector<std::thread> workers;
+  for (size_t t = 0; t < numThreads; ++t)
+  {
+    workers.push_back(std::thread([t, &draws]()
+    {
+      for (size_t i = 0; i < draws.n_rows; ++i)
+        draws(i, t + 1) = math::Random();
+    }));
+  }
+  for (size_t i = 0; i < draws.n_rows; ++i)
+    draws(i, 0) = math::Random();
+  for (size_t t = 0; t < numThreads; ++t)
+    workers[t].join();
+
+  // The calling thread drew from the global stream.
+  math::RandomSeed(11);
+  for (size_t i = 0; i < draws.n_rows; ++i)
+    REQUIRE(draws(i, 0) == math::Random());
+
+  // Every thread drew different numbers.
+  for (size_t t = 1; t <= numThreads; ++t)
+    for (size_t u = 0; u < t; ++u)
+      REQUIRE(arma::accu(draws.col(t) == draws.col(u)) == 0);
+}
+
+/**
+ * Make sure that the single-pass moments match the direct computation, however
+ * the points are split.
+ */
+TEST_CASE("MomentsTest", "[MathTest]")
+{
+  // Skewed data with a large offset, where the naive sums lose precision.
+  arma::mat data = arma::pow(arma::randn<arma::mat>(3, 20000), 2) + 1e4;
+  data.row(2) *= -3.0;
+
+  math::Moments moments;
+  moments.Update(data);
+
+  math::Moments chunked(3);
+  for (size_t c = 0; c < data.n_cols; c += 7000)
+    chunked.Update(data.cols(c, std::min(c + 6999, (size_t) data.n_cols - 1)));
+
+  // Merge the moments of the two halves.
+  math::Moments first, second;
+  first.Update(data.cols(0, 4999));
+  second.Update(data.cols(5000, data.n_cols - 1));
+  first.Merge(second);
+
+  const math::Moments* accumulators[] = { &moments, &chunked, &first };
+  for (size_t a = 0; a < 3; ++a)
+  {
+    const math::Moments& m = *accumulators[a];
+    REQUIRE(m.Count() == data.n_cols);
+    for (size_t d = 0; d < 3; ++d)
+    {
+      const arma::rowvec x = data.row(d);
+      const double n = x.n_elem;
+      const double mean = arma::mean(x);
+      const double m2 = arma::accu(arma::pow(x - mean, 2));
+      const double m3 = arma::accu(arma::pow(x - mean, 3));
+      const double m4 = arma::accu(arma::pow(x - mean, 4));
+
+      REQUIRE(m.Mean()[d] == Approx(mean).epsilon(1e-12));
+      REQUIRE(m.Min()[d] == arma::min(x));
+      REQUIRE(m.Max()[d] == arma::max(x));
+      REQUIRE(m.Variance()[d] == Approx(arma::var(x)).epsilon(1e-8));
+      REQUIRE(m.Variance(true)[d] == Approx(arma::var(x, 1)).epsilon(1e-8));
+      REQUIRE(m.Skewness(true)[d] ==
+          Approx(m3 / (n * std::pow(m2 / n, 1.5))).epsilon(1e-6));
+      REQUIRE(m.Kurtosis(true)[d] ==
+          Approx(n * m4 / (m2 * m2) - 3).epsilon(1e-6));
+    }
+  }
+
+  REQUIRE_THROWS_AS(moments.Update(arma::mat(2, 10)), std::invalid_argument);
+  math::Moments other;
+  other.Update(arma::mat(4, 10, arma::fill::randu));
+  REQUIRE_THROWS_AS(moments.Merge(other), std::invalid_argument);
+}
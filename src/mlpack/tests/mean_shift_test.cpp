@@ -162,3 +162,58 @@ TEST_CASE("GaussianClustering", "[MeanShiftTest]")
 
   REQUIRE(success == true);
 }
+
+/**
+ * With and without the kernel, and with every point as a seed, the centroids
+ * should be at least a radius apart, every point should be assigned to its
+ * nearest centroid, and clustering again into the same matrices should give
+ * the same result.
+ */
+template<bool UseKernel>
+void MeanShiftDistinctCentroidsTest()
+{
+  arma::mat dataset = trans(meanShiftData);
+  MeanShift<UseKernel> meanShift(2.0);
+
+  arma::Row<size_t> assignments;
+  arma::mat centroids;
+  meanShift.Cluster(dataset, assignments, centroids, true, false);
+
+  REQUIRE(centroids.n_cols == 3);
+  for (size_t i = 0; i < centroids.n_cols; ++i)
+  {
+    for (size_t j = i + 1; j < centroids.n_cols; ++j)
+    {
+      REQUIRE(metric::EuclideanDistance::Evaluate(centroids.col(i),
+          centroids.col(j)) >= 2.0);
+    }
+  }
+
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+  {
+    const double assigned = metric::EuclideanDistance::Evaluate(
+        dataset.col(i), centroids.col(assignments[i]));
+    for (size_t j = 0; j < centroids.n_cols; ++j)
+    {
+      REQUIRE(assigned <= metric::EuclideanDistance::Evaluate(dataset.col(i),
+          centroids.col(j)));
+    }
+  }
+
+  arma::Row<size_t> newAssignments;
+  arma::mat newCentroids = centroids;
+  meanShift.Cluster(dataset, newAssignments, newCentroids, true, false);
+  CheckMatrices(centroids, newCentroids);
+  CheckMatrices(arma::Mat<size_t>(assignments),
+      arma::Mat<size_t>(newAssignments));
+}
+
+TEST_CASE("MeanShiftDistinctCentroidsTest", "[MeanShiftTest]")
+{
+  MeanShiftDistinctCentroidsTest<false>();
+}
+
+TEST_CASE("MeanShiftKernelDistinctCentroidsTest", "[MeanShiftTest]")
+{
+  MeanShiftDistinctCentroidsTest<true>();
+}
@@ -97,6 +97,48 @@ TEST_CASE("LINFMetricTest", "[MetricTest]")
       Approx(lMetric.Evaluate(a2, b2)).epsilon(1e-7));
 }
 
+//! Make sure the batched Evaluate() matches the pairwise Evaluate().
+template<typename MetricType>
+void CheckBatchEvaluate()
+{
+  arma::vec query(13, arma::fill::randn);
+  arma::mat block(13, 37, arma::fill::randn);
+
+  arma::vec distances;
+  MetricType::Evaluate(query, block, distances);
+
+  REQUIRE(distances.n_elem == block.n_cols);
+  for (size_t i = 0; i < block.n_cols; ++i)
+  {
+    REQUIRE(distances[i] ==
+        Approx(MetricType::Evaluate(query, block.col(i))).epsilon(1e-7));
+  }
+
+  // Subviews of columns must work too.
+  MetricType::Evaluate(block.col(3), block.cols(10, 19), distances);
+  REQUIRE(distances.n_elem == 10);
+  for (size_t i = 0; i < 10; ++i)
+  {
+    REQUIRE(distances[i] == Approx(MetricType::Evaluate(block.col(3),
+        block.col(10 + i))).epsilon(1e-7));
+  }
+}
+
+/**
+ * Test the batched evaluation of one point against a block of points for the
+ * specialized and the generic LMetrics.
+ */
+TEST_CASE("LMetricBatchEvaluateTest", "[MetricTest]")
+{
+  CheckBatchEvaluate<ManhattanDistance>();
+  CheckBatchEvaluate<LMetric<1, true>>();
+  CheckBatchEvaluate<SquaredEuclideanDistance>();
+  CheckBatchEvaluate<EuclideanDistance>();
+  CheckBatchEvaluate<ChebyshevDistance>();
+  CheckBatchEvaluate<LMetric<3, true>>();
+  CheckBatchEvaluate<LMetric<5, false>>();
+}
+
 /**
  * Simple test for IoU metric.
  */
@@ -302,6 +344,97 @@ TEST_CASE("NMSMetricTest", "[MetricTest]")
   CheckMatrices(desiredBoundingBox, selectedBoundingBox);
 }
 
+/**
+ * Make sure that the batched IoU gives the same results as the IoU of each
+ * pair of bounding boxes.
+ */
+TEST_CASE("IoUBatchEvaluateTest", "[MetricTest]")
+{
+  // Bounding boxes represent {x0, y0, h, w}.
+  arma::mat a(4, 30, arma::fill::randu);
+  arma::mat b(4, 20, arma::fill::randu);
+  a *= 50.0;
+  b *= 50.0;
+  a.rows(2, 3) += 1.0;
+  b.rows(2, 3) += 1.0;
+
+  arma::mat iou;
+  IoU<>::Evaluate(a, b, iou);
+  REQUIRE(iou.n_rows == 30);
+  REQUIRE(iou.n_cols == 20);
+  for (size_t i = 0; i < a.n_cols; ++i)
+  {
+    for (size_t j = 0; j < b.n_cols; ++j)
+    {
+      const arma::vec boxA = a.col(i);
+      const arma::vec boxB = b.col(j);
+      REQUIRE(iou(i, j) ==
+          Approx(IoU<>::Evaluate(boxA, boxB)).epsilon(1e-10));
+    }
+  }
+
+  // Bounding boxes represent {x0, y0, x1, y1}.
+  a.rows(2, 3) += a.rows(0, 1);
+  b.rows(2, 3) += b.rows(0, 1);
+  IoU<true>::Evaluate(a, b, iou);
+  for (size_t i = 0; i < a.n_cols; ++i)
+  {
+    for (size_t j = 0; j < b.n_cols; ++j)
+    {
+      const arma::vec boxA = a.col(i);
+      const arma::vec boxB = b.col(j);
+      REQUIRE(iou(i, j) ==
+          Approx(IoU<true>::Evaluate(boxA, boxB)).epsilon(1e-10));
+    }
+  }
+}
+
+/**
+ * Compare NMS on many random bounding boxes (so that the bitmask spans several
+ * words) with a simple greedy implementation.
+ */
+TEST_CASE("NMSManyBoxesTest", "[MetricTest]")
+{
+  // Bounding boxes represent {x0, y0, x1, y1}.
+  const size_t n = 300;
+  arma::mat bbox(4, n, arma::fill::randu);
+  bbox *= 100.0;
+  bbox.rows(2, 3) = bbox.rows(0, 1) + 5.0 + 20.0 * bbox.rows(2, 3) / 100.0;
+  arma::vec confidenceScores(n, arma::fill::randu);
+
+  arma::uvec selectedIndices;
+  NMS<true>::Evaluate(bbox, confidenceScores, selectedIndices, 0.3);
+
+  // Greedy reference.
+  arma::uvec order = arma::sort_index(confidenceScores, "descend");
+  std::vector<size_t> desired;
+  for (size_t i = 0; i < n; ++i)
+  {
+    const arma::vec box = bbox.col(order[i]);
+    bool suppressed = false;
+    for (size_t k = 0; k < desired.size() && !suppressed; ++k)
+    {
+      const arma::vec other = bbox.col(desired[k]);
+      const double width = std::max(0.0, std::min(box[2], other[2]) -
+          std::max(box[0], other[0]));
+      const double height = std::max(0.0, std::min(box[3], other[3]) -
+          std::max(box[1], other[1]));
+      const double intersection = width * height;
+      const double iou = intersection / ((box[2] - box[0]) * (box[3] -
+          box[1]) + (other[2] - other[0]) * (other[3] - other[1]) -
+          intersection);
+      suppressed = (iou > 0.3);
+    }
+
+    if (!suppressed)
+      desired.push_back(order[i]);
+  }
+
+  REQUIRE(selectedIndices.n_elem == desired.size());
+  for (size_t i = 0; i < desired.size(); ++i)
+    REQUIRE(selectedIndices[i] == desired[i]);
+}
+
 /**
  *
  */
@@ -359,3 +492,60 @@ TEST_CASE("BLEUScoreTest", "[MetricTest]")
         Approx(expectedPrecision[i]).epsilon(1e-4));
   }
 }
+
+/**
+ * Check that BLEU does not depend on the order of the sentences of the corpus,
+ * on many sentences (processed in parallel), and for orders too long for the
+ * n-grams to be encoded in 64 bits.
+ */
+TEST_CASE("BLEUScoreCorpusTest", "[MetricTest]")
+{
+  typedef typename std::vector<std::string> WordVector;
+  std::vector<std::vector<WordVector>> referenceCorpus;
+  std::vector<WordVector> translationCorpus;
+  for (size_t s = 0; s < 1000; ++s)
+  {
+    translationCorpus.push_back(WordVector());
+    const size_t length = mlpack::math::RandInt(1, 20);
+    for (size_t i = 0; i < length; ++i)
+    {
+      translationCorpus.back().push_back(
+          std::to_string(mlpack::math::RandInt(0, 8)));
+    }
+
+    // Each reference is a perturbed copy of the translation.
+    referenceCorpus.push_back(std::vector<WordVector>(3,
+        translationCorpus.back()));
+    for (size_t r = 0; r < 3; ++r)
+      for (size_t i = 0; i < length; ++i)
+        if (mlpack::math::Random() < 0.3)
+          referenceCorpus.back()[r][i] = "x";
+  }
+
+  BLEU<> bleu(4);
+  const float score = bleu.Evaluate(referenceCorpus, translationCorpus);
+  const std::vector<float> precisions = bleu.Precisions();
+  REQUIRE(score > 0.0);
+  REQUIRE(score < 1.0);
+
+  // Reverse the corpus.
+  std::reverse(referenceCorpus.begin(), referenceCorpus.end());
+  std::reverse(translationCorpus.begin(), translationCorpus.end());
+  REQUIRE(bleu.Evaluate(referenceCorpus, translationCorpus) ==
+      Approx(score).epsilon(1e-5));
+  for (size_t i = 0; i < 4; ++i)
+    REQUIRE(bleu.Precisions()[i] == Approx(precisions[i]).epsilon(1e-5));
+
+  // N-grams of 40 tokens out of 30 distinct ones cannot be encoded in 64
+  // bits; a translation identical to one of its references is still perfect.
+  WordVector sentence;
+  for (size_t i = 0; i < 60; ++i)
+    sentence.push_back("w" + std::to_string(i % 30));
+  std::vector<std::vector<WordVector>> longReferences = {{ sentence,
+      WordVector(sentence.begin(), sentence.begin() + 50) }};
+  std::vector<WordVector> longTranslations = { sentence };
+
+  BLEU<> longBLEU(40);
+  REQUIRE(longBLEU.Evaluate(longReferences, longTranslations) ==
+      Approx(1.0).epsilon(1e-5));
+}
@@ -355,4 +355,47 @@ BOOST_AUTO_TEST_CASE(NaiveBayesClassifierHighDimensionsTest)
     BOOST_REQUIRE_EQUAL(calcVec(i), testLabels(i));
 }
 
+/**
+ * Make sure that training on sparse data gives the same model and the same
+ * predictions as training on the same data in dense form, for both algorithms.
+ */
+BOOST_AUTO_TEST_CASE(NaiveBayesClassifierSparseTest)
+{
+  const size_t classes = 3;
+  arma::sp_mat sparseData;
+  sparseData.sprandu(200, 300, 0.05);
+  const arma::mat denseData(sparseData);
+  arma::Row<size_t> labels = arma::randi<arma::Row<size_t>>(300,
+      arma::distr_param(0, classes - 1));
+
+  arma::sp_mat sparseTest;
+  sparseTest.sprandu(200, 50, 0.05);
+  const arma::mat denseTest(sparseTest);
+
+  for (size_t incremental = 0; incremental < 2; ++incremental)
+  {
+    NaiveBayesClassifier<> dense(denseData, labels, classes, incremental);
+    NaiveBayesClassifier<> sparse(sparseData, labels, classes, incremental);
+
+    // Train a second time, so that the incremental algorithm merges into a
+    // model that isn't empty.
+    dense.Train(denseData.cols(0, 99), labels.cols(0, 99), classes,
+        incremental);
+    sparse.Train(arma::sp_mat(sparseData.cols(0, 99)), labels.cols(0, 99),
+        classes, incremental);
+
+    CheckMatrices(dense.Probabilities(), sparse.Probabilities());
+    CheckMatrices(dense.Means(), sparse.Means(), 1e-5);
+    CheckMatrices(dense.Variances(), sparse.Variances(), 1e-5);
+
+    arma::Row<size_t> densePredictions, sparsePredictions;
+    arma::mat denseProbs, sparseProbs;
+    dense.Classify(denseTest, densePredictions, denseProbs);
+    sparse.Classify(sparseTest, sparsePredictions, sparseProbs);
+
+    CheckMatrices(densePredictions, sparsePredictions);
+    CheckMatrices(denseProbs, sparseProbs, 1e-5);
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -16,6 +16,7 @@
 #include <ensmallen.hpp>
 
 #include "catch.hpp"
+#include "test_catch_tools.hpp"
 
 using namespace mlpack;
 using namespace mlpack::metric;
@@ -246,6 +247,80 @@ TEST_CASE("SoftmaxSeparableGradient", "[NCATesT]")
   REQUIRE(gradient(1, 1) == Approx(-2.0 * -0.1435886).epsilon(0.0001));
 }
 
+/**
+ * The blocked non-separable gradient should not depend on the block size, and
+ * it should match the separable gradient taken over the whole dataset.
+ */
+TEST_CASE("SoftmaxBlockedGradient", "[NCATesT]")
+{
+  arma::mat data = arma::randu<arma::mat>(3, 150);
+  arma::Row<size_t> labels = arma::randi<arma::Row<size_t>>(150,
+      arma::distr_param(0, 2));
+
+  SoftmaxErrorFunction<SquaredEuclideanDistance> sef(data, labels);
+
+  arma::mat coordinates = 2.0 * arma::randu<arma::mat>(3, 3);
+
+  // The separable objective and gradient over all points are the same as the
+  // non-separable versions.
+  arma::mat separableGradient;
+  sef.Gradient(coordinates, 0, separableGradient, data.n_cols);
+  const double separableObjective = sef.Evaluate(coordinates, 0, data.n_cols);
+
+  REQUIRE(sef.Evaluate(coordinates) ==
+      Approx(separableObjective).epsilon(1e-7));
+
+  const size_t blockSizes[] = { 1, 7, 64, 1000 };
+  for (const size_t blockSize : blockSizes)
+  {
+    sef.BlockSize() = blockSize;
+
+    arma::mat gradient;
+    sef.Gradient(coordinates, gradient);
+
+    CheckMatrices(gradient, separableGradient, 1e-5);
+  }
+}
+
+/**
+ * When points far away from each other in the stretched space contribute
+ * nothing, the truncated objective should give the same results as the full
+ * objective.
+ */
+TEST_CASE("SoftmaxTruncatedObjective", "[NCATesT]")
+{
+  // Three clusters that are far apart; each has points of every class.
+  arma::mat data = arma::randu<arma::mat>(2, 60);
+  data.cols(20, 39) += 20.0;
+  data.cols(40, 59) -= 20.0;
+  arma::Row<size_t> labels = arma::randi<arma::Row<size_t>>(60,
+      arma::distr_param(0, 2));
+
+  SoftmaxErrorFunction<SquaredEuclideanDistance> sef(data, labels);
+
+  arma::mat coordinates = arma::eye<arma::mat>(2, 2);
+  const double objective = sef.Evaluate(coordinates);
+  arma::mat gradient;
+  sef.Gradient(coordinates, gradient);
+
+  // Every point has its whole cluster as neighbors.
+  sef.NumNeighbors() = 25;
+  const double truncatedObjective = sef.Evaluate(coordinates);
+  arma::mat truncatedGradient;
+  sef.Gradient(coordinates, truncatedGradient);
+
+  REQUIRE(truncatedObjective == Approx(objective).epsilon(1e-7));
+  CheckMatrices(truncatedGradient, gradient, 1e-5);
+
+  // With fewer neighbors, some p_ij are skipped, so the objective changes.
+  sef.NumNeighbors() = 3;
+  REQUIRE(sef.Evaluate(coordinates) != Approx(objective).epsilon(1e-7));
+
+  // Setting the number of neighbors back to 0 gives the exact objective again.
+  sef.NumNeighbors() = 0;
+  REQUIRE(sef.Evaluate(coordinates) == Approx(objective).epsilon(1e-10));
+}
+
 //
 // Tests for the NCA algorithm.
 //
@@ -318,3 +393,31 @@ TEST_CASE("NCALBFGSSimpleDataset", "[NCATesT]")
   // norm is close to 0.
   REQUIRE(arma::norm(finalGradient, 2) < 1e-6);
 }
+
+/**
+ * NCA with L-BFGS and the truncated objective should still separate the simple
+ * dataset.
+ */
+TEST_CASE("NCALBFGSTruncatedSimpleDataset", "[NCATesT]")
+{
+  // Useful but simple dataset with six points and two classes.
+  arma::mat data           = "-0.1 -0.1 -0.1  0.1  0.1  0.1;"
+                             " 1.0  0.0 -1.0  1.0  0.0 -1.0 ";
+  arma::Row<size_t> labels = " 0    0    0    1    1    1   ";
+
+  NCA<SquaredEuclideanDistance, L_BFGS> nca(data, labels);
+  nca.Optimizer().NumBasis() = 5;
+  nca.ErrorFunction().NumNeighbors() = 3;
+
+  arma::mat outputMatrix;
+  nca.LearnDistance(outputMatrix);
+
+  // Check the exact objective.
+  SoftmaxErrorFunction<SquaredEuclideanDistance> sef(data, labels);
+
+  double initObj = sef.Evaluate(arma::eye<arma::mat>(2, 2));
+  double finalObj = sef.Evaluate(outputMatrix);
+
+  REQUIRE(finalObj < initObj);
+  REQUIRE(finalObj == Approx(-6.0).epsilon(1e-3));
+}
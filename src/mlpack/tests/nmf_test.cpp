@@ -16,6 +16,9 @@
 #include <mlpack/methods/amf/update_rules/nmf_mult_div.hpp>
 #include <mlpack/methods/amf/update_rules/nmf_als.hpp>
 #include <mlpack/methods/amf/update_rules/nmf_mult_dist.hpp>
+#include <mlpack/methods/amf/update_rules/weighted_als.hpp>
+#include <mlpack/methods/amf/init_rules/random_init.hpp>
+#include <mlpack/methods/amf/termination_policies/max_iteration_termination.hpp>
 
 #include <boost/test/unit_test.hpp>
 #include "test_tools.hpp"
@@ -188,6 +191,60 @@ BOOST_AUTO_TEST_CASE(SparseNMFAcolDistTest)
  * input matrix, with a sparse input matrix.  This uses the random
  * initialization and alternating least squares update rule.
  */
+/**
+ * Check the divergence update rules against their element-wise formulas, and
+ * make sure the sparse rules, which only evaluate W * H at the nonzeros of V,
+ * give the same results as the dense rules.
+ */
+BOOST_AUTO_TEST_CASE(SparseNMFDivUpdateTest)
+{
+  sp_mat v;
+  v.sprandu(30, 40, 0.2);
+  mat dv(v);
+  const mat w = randu<mat>(30, 5) + 0.1;
+  const mat h = randu<mat>(5, 40) + 0.1;
+
+  // The element-wise formula for W.
+  const mat wh = w * h;
+  mat expectedW(w.n_rows, w.n_cols);
+  for (size_t i = 0; i < w.n_rows; ++i)
+  {
+    for (size_t a = 0; a < w.n_cols; ++a)
+    {
+      double sum = 0.0;
+      for (size_t mu = 0; mu < h.n_cols; ++mu)
+        sum += h(a, mu) * dv(i, mu) / wh(i, mu);
+      expectedW(i, a) = w(i, a) * sum / accu(h.row(a));
+    }
+  }
+
+  mat denseW(w), sparseW(w);
+  NMFMultiplicativeDivergenceUpdate::WUpdate(dv, denseW, h);
+  NMFMultiplicativeDivergenceUpdate::WUpdate(v, sparseW, h);
+  BOOST_REQUIRE_SMALL(norm(denseW - expectedW, "fro"), 1e-10);
+  BOOST_REQUIRE_SMALL(norm(sparseW - expectedW, "fro"), 1e-10);
+
+  // The element-wise formula for H, with the updated W.
+  const mat newWH = expectedW * h;
+  mat expectedH(h.n_rows, h.n_cols);
+  for (size_t a = 0; a < h.n_rows; ++a)
+  {
+    for (size_t mu = 0; mu < h.n_cols; ++mu)
+    {
+      double sum = 0.0;
+      for (size_t i = 0; i < w.n_rows; ++i)
+        sum += expectedW(i, a) * dv(i, mu) / newWH(i, mu);
+      expectedH(a, mu) = h(a, mu) * sum / accu(expectedW.col(a));
+    }
+  }
+
+  mat denseH(h), sparseH(h);
+  NMFMultiplicativeDivergenceUpdate::HUpdate(dv, expectedW, denseH);
+  NMFMultiplicativeDivergenceUpdate::HUpdate(v, expectedW, sparseH);
+  BOOST_REQUIRE_SMALL(norm(denseH - expectedH, "fro"), 1e-10);
+  BOOST_REQUIRE_SMALL(norm(sparseH - expectedH, "fro"), 1e-10);
+}
+
 BOOST_AUTO_TEST_CASE(SparseNMFALSTest)
 {
   // We have to ensure that the residues aren't NaNs.  This can happen when a
@@ -305,4 +362,83 @@ BOOST_AUTO_TEST_CASE(NonNegNMFALSTest)
       && arma::all(arma::vectorise(h) >= 0));
 }
 
+/**
+ * Build a sparse matrix with a sample of the entries of a low-rank matrix.
+ */
+static void LowRankRatings(sp_mat& v, mat& full)
+{
+  mat w = randu<mat>(100, 5);
+  mat h = randu<mat>(5, 80);
+  full = w * h;
+
+  v.zeros(100, 80);
+  for (size_t i = 0; i < full.n_elem; ++i)
+  {
+    if (math::Random() < 0.3)
+      v(i) = full(i);
+  }
+}
+
+/**
+ * Check that weighted ALS, with exact solves and with conjugate gradient,
+ * fits the observed entries of a sparse low-rank matrix.
+ */
+BOOST_AUTO_TEST_CASE(WeightedALSTest)
+{
+  sp_mat v;
+  mat full;
+  LowRankRatings(v, full);
+
+  for (size_t cgIterations = 0; cgIterations <= 5; cgIterations += 5)
+  {
+    mat w, h;
+    MaxIterationTermination mit(100);
+    AMF<MaxIterationTermination, RandomInitialization, WeightedALSUpdate>
+        als(mit, RandomInitialization(),
+        WeightedALSUpdate(1e-4, false, 0.0, cgIterations));
+    als.Apply(v, 5, w, h);
+
+    double error = 0.0;
+    for (sp_mat::const_iterator it = v.begin(); it != v.end(); ++it)
+    {
+      const double e = (*it) - dot(w.row(it.row()), h.col(it.col()));
+      error += e * e;
+    }
+
+    BOOST_REQUIRE_SMALL(std::sqrt(error / v.n_nonzero), 0.05);
+  }
+}
+
+/**
+ * Check that implicit weighted ALS predicts higher preferences for the
+ * observed entries than for the others.
+ */
+BOOST_AUTO_TEST_CASE(ImplicitWeightedALSTest)
+{
+  sp_mat v;
+  mat full;
+  LowRankRatings(v, full);
+
+  mat w, h;
+  MaxIterationTermination mit(20);
+  AMF<MaxIterationTermination, RandomInitialization, WeightedALSUpdate>
+      als(mit, RandomInitialization(), WeightedALSUpdate(0.1, true, 10.0));
+  als.Apply(v, 5, w, h);
+
+  const mat predictions = w * h;
+  BOOST_REQUIRE(predictions.is_finite());
+
+  double observed = 0.0, unobserved = 0.0;
+  for (size_t i = 0; i < predictions.n_elem; ++i)
+  {
+    if (v(i) != 0.0)
+      observed += predictions(i);
+    else
+      unobserved += predictions(i);
+  }
+
+  BOOST_REQUIRE_GT(observed / v.n_nonzero,
+      unobserved / (predictions.n_elem - v.n_nonzero));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
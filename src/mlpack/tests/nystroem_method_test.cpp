@@ -202,4 +202,36 @@ BOOST_AUTO_TEST_CASE(GermanTest)
   }
 }
 
+/**
+ * Make sure that RandomSelection selects distinct points when there are enough
+ * of them, and that every point can be selected.
+ */
+BOOST_AUTO_TEST_CASE(RandomSelectionDistinctTest)
+{
+  arma::mat data = arma::randu<arma::mat>(2, 50);
+
+  arma::Col<size_t> counts(50, arma::fill::zeros);
+  for (size_t trial = 0; trial < 100; ++trial)
+  {
+    const arma::Col<size_t> selected = RandomSelection::Select(data, 40);
+    BOOST_REQUIRE_EQUAL(selected.n_elem, 40);
+
+    const arma::Col<size_t> unique = arma::unique(selected);
+    BOOST_REQUIRE_EQUAL(unique.n_elem, 40);
+    BOOST_REQUIRE_LT(unique.max(), 50);
+
+    for (size_t i = 0; i < selected.n_elem; ++i)
+      counts[selected[i]]++;
+  }
+
+  // Each point is selected 80 times on average.
+  for (size_t i = 0; i < counts.n_elem; ++i)
+    BOOST_REQUIRE_GT(counts[i], 40);
+
+  // With more points than the dataset has, every point is still valid.
+  const arma::Col<size_t> selected = RandomSelection::Select(data, 60);
+  BOOST_REQUIRE_EQUAL(selected.n_elem, 60);
+  BOOST_REQUIRE_LT(selected.max(), 50);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
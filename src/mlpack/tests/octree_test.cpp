@@ -323,6 +323,27 @@ TEST_CASE("OcTreeTestMoveConstructorTest", "[OctreeTest]")
   CheckSameNode(tcopy, t2);
 }
 
+/**
+ * Make sure that building an octree in parallel gives exactly the same tree
+ * (and permutation) as building it serially.
+ */
+TEST_CASE("OctreeParallelBuildTest", "[OctreeTest]")
+{
+  arma::mat dataset(3, 5000, arma::fill::randu);
+  const size_t oldThreshold = Octree<>::ParallelBuildThreshold();
+
+  std::vector<size_t> serialOldFromNew, parallelOldFromNew;
+  Octree<>::ParallelBuildThreshold() = std::numeric_limits<size_t>::max();
+  Octree<> serialTree(dataset, serialOldFromNew, 10);
+  Octree<>::ParallelBuildThreshold() = 50;
+  Octree<> parallelTree(dataset, parallelOldFromNew, 10);
+  Octree<>::ParallelBuildThreshold() = oldThreshold;
+
+  REQUIRE(serialOldFromNew == parallelOldFromNew);
+  CheckMatrices(serialTree.Dataset(), parallelTree.Dataset());
+  CheckSameNode(serialTree, parallelTree);
+}
+
 /**
  * Test serialization.
  */
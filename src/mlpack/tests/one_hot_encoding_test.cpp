@@ -13,6 +13,9 @@
 #include "test_catch_tools.hpp"
 #include "catch.hpp"
 #include <mlpack/core/data/one_hot_encoding.hpp>
+#include <mlpack/core/data/preprocessing_pipeline.hpp>
+#include <mlpack/core/data/imputation_methods/mean_imputation.hpp>
+#include <mlpack/core/data/scaler_methods/standard_scaler.hpp>
 
 using namespace mlpack;
 using namespace mlpack::data;
@@ -229,3 +232,75 @@ TEST_CASE("OneHotEncodingDatasetinfoTest", "[OneHotEncodingTest]")
 
   remove("test.csv");
 }
+
+/**
+ * Test that sparse one-hot encoding gives the same result as dense encoding.
+ */
+TEST_CASE("OneHotEncodingSparseOutputTest", "[OneHotEncodingTest]")
+{
+  // Dimension 1 has many categories, and dimension 2 has zeros.
+  arma::mat input(3, 1000);
+  for (size_t i = 0; i < input.n_cols; ++i)
+  {
+    input(0, i) = i % 3;
+    input(1, i) = (i * 7) % 250;
+    input(2, i) = (i % 5 == 0) ? 0.0 : 0.5 * i;
+  }
+
+  arma::mat output;
+  arma::sp_mat sparseOutput;
+  arma::Col<size_t> indices("0 1");
+  data::OneHotEncoding(input, indices, output);
+  data::OneHotEncoding(input, indices, sparseOutput);
+
+  REQUIRE(output.n_rows == 3 + 250 + 1);
+  REQUIRE(sparseOutput.n_rows == output.n_rows);
+  REQUIRE(sparseOutput.n_cols == output.n_cols);
+  REQUIRE(sparseOutput.n_nonzero == 2 * 1000 + 800);
+  CheckMatrices(output, arma::mat(sparseOutput));
+}
+
+/**
+ * Test that the preprocessing pipeline imputes, scales and encodes a dataset
+ * like the separate steps do.
+ */
+TEST_CASE("PreprocessingPipelineTest", "[OneHotEncodingTest]")
+{
+  const double nan = std::numeric_limits<double>::quiet_NaN();
+  arma::mat input = { { 1.0, nan, 3.0, 4.0, 5.0, nan },
+                      { 2.0, 4.0, 6.0, 8.0, 10.0, 12.0 },
+                      { 0.0, 1.0, 0.0, 2.0, 2.0, 1.0 } };
+
+  // Do each step on its own.
+  arma::mat expected = input;
+  MeanImputation<double> imputation;
+  imputation.Impute(expected, nan, 0);
+  StandardScaler scaler;
+  arma::mat numeric = expected.rows(0, 1);
+  arma::mat scaledNumeric;
+  scaler.Fit(numeric);
+  scaler.Transform(numeric, scaledNumeric);
+  expected.rows(0, 1) = scaledNumeric;
+  arma::mat expectedOutput;
+  data::OneHotEncoding(expected, arma::Col<size_t>("2"), expectedOutput);
+
+  PreprocessingPipeline<MeanImputation<double>, StandardScaler> pipeline(
+      arma::Col<size_t>("0"), arma::Col<size_t>("2"));
+  arma::mat dataset = input;
+  arma::sp_mat output;
+  pipeline.Apply(dataset, output);
+
+  REQUIRE(output.n_rows == 5);
+  REQUIRE(output.n_cols == 6);
+  CheckMatrices(arma::mat(output), expectedOutput);
+
+  // The dataset holds the imputed data.
+  REQUIRE(dataset(0, 1) == Approx(3.25).epsilon(1e-7));
+  REQUIRE(dataset(1, 1) == Approx(4.0).epsilon(1e-7));
+
+  // An invalid dimension is reported.
+  PreprocessingPipeline<MeanImputation<double>, StandardScaler> badPipeline(
+      arma::Col<size_t>(), arma::Col<size_t>("3"));
+  dataset = input;
+  REQUIRE_THROWS_AS(badPipeline.Apply(dataset, output), std::invalid_argument);
+}
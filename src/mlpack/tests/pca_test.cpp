@@ -13,6 +13,7 @@
 #include <mlpack/core.hpp>
 #include <mlpack/methods/pca/pca.hpp>
 #include <mlpack/methods/pca/decomposition_policies/exact_svd_method.hpp>
+#include <mlpack/methods/pca/decomposition_policies/incremental_pca_method.hpp>
 #include <mlpack/methods/pca/decomposition_policies/quic_svd_method.hpp>
 #include <mlpack/methods/pca/decomposition_policies/randomized_svd_method.hpp>
 #include <mlpack/methods/pca/decomposition_policies/randomized_block_krylov_method.hpp>
@@ -181,6 +182,46 @@ void PCAVarianceRetained()
 /**
  * Compare the output of our exact PCA implementation with Armadillo's.
  */
+/**
+ * Make sure that PCA on a sparse matrix, which is never densified, gives the
+ * same transformed data as the exact PCA of the dense matrix, using the
+ * specified decomposition policy.
+ */
+template<typename DecompositionPolicy>
+void SparsePCA(const bool scaleData = false)
+{
+  // A sparse matrix of rank at most 3; once centered, its rank is at most 4.
+  sp_mat data(30, 300);
+  for (size_t i = 0; i < 3; ++i)
+    data += sprandu<sp_mat>(30, 1, 0.4) * sprandu<sp_mat>(1, 300, 0.4);
+
+  mat correct(data);
+  PCA<ExactSVDPolicy> exactPCA(scaleData);
+  exactPCA.Apply(correct, 4);
+
+  mat transformedData;
+  PCA<DecompositionPolicy> p(scaleData);
+  const double varRetained = p.Apply(data, transformedData, 4);
+
+  REQUIRE(varRetained == Approx(1.0).epsilon(1e-5));
+  REQUIRE(transformedData.n_rows == 4);
+  REQUIRE(transformedData.n_cols == 300);
+
+  for (size_t i = 0; i < 4; ++i)
+  {
+    // The principal components are only known up to their sign.
+    if (accu(abs(correct.row(i) + transformedData.row(i))) <
+        accu(abs(correct.row(i) - transformedData.row(i))))
+      transformedData.row(i) *= -1;
+
+    for (size_t j = 0; j < 300; ++j)
+    {
+      REQUIRE(transformedData(i, j) ==
+          Approx(correct(i, j)).epsilon(1e-5).margin(1e-5));
+    }
+  }
+}
+
 TEST_CASE("ArmaComparisonExactPCATest", "[PCATest]")
 {
   ArmaComparisonPCA<ExactSVDPolicy>();
@@ -204,6 +245,16 @@ TEST_CASE("ArmaComparisonRandomizedPCATest", "[PCATest]")
   ArmaComparisonPCA<RandomizedSVDPolicy>();
 }
 
+/**
+ * Compare the output of our incremental PCA implementation with Armadillo's,
+ * with batches that don't divide the number of points.
+ */
+TEST_CASE("ArmaComparisonIncrementalPCATest", "[PCATest]")
+{
+  IncrementalPCAPolicy decomposition(73);
+  ArmaComparisonPCA<IncrementalPCAPolicy>(false, decomposition);
+}
+
 /**
  * Test that dimensionality reduction with exact-svd PCA works the same way
  * MATLAB does (which should be correct!).
@@ -333,3 +384,87 @@ TEST_CASE("PCAScalingTest", "[PCATest]")
   // The eigenvalues should sum to three.
   REQUIRE(accu(eigval) == Approx(3.0).epsilon(0.001));
 }
+
+/**
+ * Test sparse PCA with the randomized SVD policy.
+ */
+TEST_CASE("RandomizedSparsePCATest", "[PCATest]")
+{
+  SparsePCA<RandomizedSVDPolicy>();
+  SparsePCA<RandomizedSVDPolicy>(true);
+}
+
+/**
+ * Test sparse PCA with the randomized block krylov SVD policy.
+ */
+TEST_CASE("RandomizedBlockKrylovSparsePCATest", "[PCATest]")
+{
+  SparsePCA<RandomizedBlockKrylovSVDPolicy>();
+  SparsePCA<RandomizedBlockKrylovSVDPolicy>(true);
+}
+
+/**
+ * Make sure that incremental PCA over the chunks of a loader keeps the
+ * principal components of a low-rank dataset, and that its projection matches
+ * the exact PCA.
+ */
+TEST_CASE("IncrementalPCALoaderTest", "[PCATest]")
+{
+  // The points lie on a 3-dimensional affine subspace.
+  mat data = randn<mat>(10, 3) * randn<mat>(3, 400);
+  data.each_col() += randu<vec>(10);
+
+  std::vector<std::string> predictorFiles, responseFiles;
+  for (size_t i = 0; i < 4; ++i)
+  {
+    predictorFiles.push_back("ipca_chunk_" + std::to_string(i) + ".csv");
+    responseFiles.push_back("ipca_chunk_responses_" + std::to_string(i) +
+        ".csv");
+    data::Save(predictorFiles[i], mat(data.cols(100 * i, 100 * i + 99)));
+    data::Save(responseFiles[i], mat(1, 100, fill::zeros));
+  }
+
+  data::PrefetchLoader<data::FileChunkSource> loader(data::FileChunkSource(
+      predictorFiles, responseFiles));
+
+  PCA<IncrementalPCAPolicy> p;
+  vec eigVal;
+  mat eigvec;
+  p.Apply(loader, eigVal, eigvec, 4);
+
+  REQUIRE(eigvec.n_rows == 10);
+  REQUIRE(eigvec.n_cols == 4);
+  REQUIRE(p.Decomposition().NumPoints() == 400);
+  REQUIRE(approx_equal(p.Decomposition().Mean(), vec(mean(data, 1)),
+      "absdiff", 1e-8));
+
+  mat correct(data), correctVec;
+  vec correctVal;
+  PCA<ExactSVDPolicy> exactPCA;
+  exactPCA.Apply(data, correct, correctVal, correctVec);
+
+  for (size_t i = 0; i < 3; ++i)
+    REQUIRE(eigVal[i] == Approx(correctVal[i]).epsilon(1e-6));
+  REQUIRE(eigVal[3] == Approx(0.0).margin(1e-8));
+
+  mat transformed;
+  p.Decomposition().Transform(data, transformed);
+  for (size_t i = 0; i < 3; ++i)
+  {
+    // The principal components are only known up to their sign.
+    if (dot(correct.row(i), transformed.row(i)) < 0)
+      transformed.row(i) *= -1;
+
+    for (size_t j = 0; j < data.n_cols; ++j)
+    {
+      REQUIRE(transformed(i, j) ==
+          Approx(correct(i, j)).epsilon(1e-5).margin(1e-6));
+    }
+  }
+
+  for (size_t i = 0; i < 4; ++i)
+  {
+    remove(predictorFiles[i].c_str());
+    remove(responseFiles[i].c_str());
+  }
+}
@@ -255,4 +255,65 @@ BOOST_AUTO_TEST_CASE(SecondaryConstructor)
   Perceptron<> p2(p1);
 }
 
+/**
+ * Make sure that training with iterative parameter mixing over several shards
+ * converges on linearly separable data.
+ */
+BOOST_AUTO_TEST_CASE(ParameterMixingTest)
+{
+  // Three well-separated Gaussian clusters.
+  mat trainData(2, 600);
+  Row<size_t> labels(600);
+  for (size_t i = 0; i < trainData.n_cols; ++i)
+  {
+    labels[i] = i % 3;
+    trainData.col(i) = 0.3 * randn<vec>(2);
+    trainData(labels[i] == 2 ? 1 : 0, i) += (labels[i] == 0) ? -5.0 : 5.0;
+  }
+
+  Perceptron<> p(3, 2, 1000);
+  p.NumShards() = 4;
+  p.Train(trainData, labels, 3);
+
+  Row<size_t> predictedLabels;
+  p.Classify(trainData, predictedLabels);
+  BOOST_REQUIRE_EQUAL(predictedLabels.n_elem, trainData.n_cols);
+
+  size_t correct = 0;
+  for (size_t i = 0; i < labels.n_elem; ++i)
+  {
+    if (predictedLabels[i] == labels[i])
+      ++correct;
+  }
+  BOOST_REQUIRE_GE(correct, 597);
+}
+
+/**
+ * Make sure that a perceptron trained on sparse data gives the same model and
+ * predictions as one trained on the same dense data.
+ */
+BOOST_AUTO_TEST_CASE(SparsePerceptronTest)
+{
+  sp_mat sparseData;
+  sparseData.sprandu(50, 200, 0.1);
+  mat denseData(sparseData);
+
+  Row<size_t> labels(200);
+  for (size_t i = 0; i < labels.n_elem; ++i)
+    labels[i] = (accu(denseData.col(i).head(25)) >
+        accu(denseData.col(i).tail(25))) ? 1 : 0;
+
+  Perceptron<> denseP(denseData, labels, 2, 20);
+  Perceptron<SimpleWeightUpdate, ZeroInitialization, sp_mat> sparseP(
+      sparseData, labels, 2, 20);
+
+  CheckMatrices(denseP.Weights(), sparseP.Weights());
+  CheckMatrices(denseP.Biases(), sparseP.Biases());
+
+  Row<size_t> densePredictions, sparsePredictions;
+  denseP.Classify(denseData, densePredictions);
+  sparseP.Classify(sparseData, sparsePredictions);
+  CheckMatrices(densePredictions, sparsePredictions);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -126,6 +126,52 @@ BOOST_AUTO_TEST_CASE(CartPoleWithDQN)
   BOOST_REQUIRE(converged);
 }
 
+/**
+ * Run DQN on several Cart Pole environments in lockstep, and check that each
+ * step of each environment is counted and stored once.
+ */
+BOOST_AUTO_TEST_CASE(CartPoleWithVectorDQN)
+{
+  SimpleDQN<> network(4, 32, 32, 2);
+  GreedyPolicy<CartPole> policy(1.0, 1000, 0.1, 0.99);
+  RandomReplay<CartPole> replayMethod(10, 100000);
+
+  TrainingConfig config;
+  config.StepSize() = 0.01;
+  config.Discount() = 0.9;
+  config.TargetNetworkSyncInterval() = 100;
+  config.ExplorationSteps() = 100;
+
+  QLearning<CartPole, decltype(network), AdamUpdate, decltype(policy)>
+      agent(config, network, policy, replayMethod);
+
+  VectorEnvironment<CartPole> environments(8, CartPole(50));
+  size_t storedSteps = 0;
+  for (size_t e = 0; e < 5; ++e)
+  {
+    const arma::vec returns = agent.Episodes(environments);
+    BOOST_REQUIRE_EQUAL(returns.n_elem, 8);
+
+    // Each step of Cart Pole gives a reward of 1.
+    for (size_t i = 0; i < returns.n_elem; ++i)
+    {
+      BOOST_REQUIRE_GT(returns[i], 0.0);
+      BOOST_REQUIRE_LE(returns[i], 50.0);
+    }
+    storedSteps += (size_t) arma::accu(returns);
+
+    BOOST_REQUIRE_EQUAL(agent.TotalSteps(), storedSteps);
+    BOOST_REQUIRE_EQUAL(replayMethod.Size(), storedSteps);
+  }
+
+  // The n-step buffer can't be shared by the environments.
+  RandomReplay<CartPole> nStepReplay(10, 1000, 3);
+  QLearning<CartPole, decltype(network), AdamUpdate, decltype(policy)>
+      nStepAgent(config, network, policy, nStepReplay);
+  BOOST_REQUIRE_THROW(nStepAgent.Episodes(environments),
+      std::invalid_argument);
+}
+
 //! Test DQN in Cart Pole task with Prioritized Replay.
 BOOST_AUTO_TEST_CASE(CartPoleWithDQNPrioritizedReplay)
 {
@@ -144,6 +144,48 @@ BOOST_AUTO_TEST_CASE(QDAFNMultipleNeighbors)
   }
 }
 
+/**
+ * Make sure that a QDAFN model on float data, searched with more queries than
+ * fit in one batch, returns valid neighbors with their correct distances, and
+ * approximates the true furthest neighbors as well as on double data.
+ */
+BOOST_AUTO_TEST_CASE(QDAFNFloatBatchTest)
+{
+  arma::fmat uniformSet = arma::randu<arma::fmat>(25, 1000);
+  arma::fmat querySet = arma::randu<arma::fmat>(25, 5000);
+
+  QDAFN<arma::fmat> qdafn(uniformSet, 10, 30);
+
+  arma::Mat<size_t> qdafnNeighbors;
+  arma::mat qdafnDistances;
+
+  qdafn.Search(querySet, 1, qdafnNeighbors, qdafnDistances);
+
+  BOOST_REQUIRE_EQUAL(qdafnNeighbors.n_rows, 1);
+  BOOST_REQUIRE_EQUAL(qdafnNeighbors.n_cols, 5000);
+  BOOST_REQUIRE_EQUAL(qdafnDistances.n_rows, 1);
+  BOOST_REQUIRE_EQUAL(qdafnDistances.n_cols, 5000);
+
+  // Get the actual furthest neighbors.
+  KFN kfn(arma::conv_to<arma::mat>::from(uniformSet));
+  arma::Mat<size_t> trueNeighbors;
+  arma::mat trueDistances;
+  kfn.Search(arma::conv_to<arma::mat>::from(querySet), 1, trueNeighbors,
+      trueDistances);
+
+  size_t successes = 0;
+  for (size_t i = 0; i < 5000; ++i)
+  {
+    BOOST_REQUIRE_LT(qdafnNeighbors(0, i), 1000);
+    BOOST_REQUIRE_CLOSE(qdafnDistances(0, i), arma::norm(querySet.col(i) -
+        uniformSet.col(qdafnNeighbors(0, i))), 1e-3);
+    if (0.9 * trueDistances(0, i) <= qdafnDistances(0, i))
+      ++successes;
+  }
+
+  BOOST_REQUIRE_GE(successes, 3475);
+}
+
 /**
  * Test re-training method.
  */
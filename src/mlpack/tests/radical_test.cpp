@@ -58,4 +58,61 @@ BOOST_AUTO_TEST_CASE(Radical_Test_Radical3D)
   BOOST_REQUIRE_CLOSE(valBest, valEst, 2.0);
 }
 
+/**
+ * Make sure that the unmixing matrix recovers the independent components from
+ * the data.
+ */
+BOOST_AUTO_TEST_CASE(RadicalUnmixingMatrixTest)
+{
+  mat matX;
+  data::Load("data_3d_mixed.txt", matX);
+
+  Radical rad(0.175, 5, 100, matX.n_rows - 1);
+
+  mat matY;
+  mat matW;
+  rad.DoRadical(matX, matY, matW);
+
+  const mat matWX = matW * matX;
+  BOOST_REQUIRE_EQUAL(matWX.n_rows, matY.n_rows);
+  BOOST_REQUIRE_EQUAL(matWX.n_cols, matY.n_cols);
+  for (uword i = 0; i < matY.n_elem; ++i)
+    BOOST_REQUIRE_SMALL(matWX[i] - matY[i], 1e-8);
+}
+
+/**
+ * Make sure that RADICAL with the approximate entropy estimator still finds
+ * components about as independent as the true ones.
+ */
+BOOST_AUTO_TEST_CASE(RadicalApproximateEntropyTest)
+{
+  mat matX;
+  data::Load("data_3d_mixed.txt", matX);
+
+  Radical rad(0.175, 5, 100, matX.n_rows - 1, 0, true);
+  BOOST_REQUIRE_EQUAL(rad.ApproximateEntropy(), true);
+
+  mat matY;
+  mat matW;
+  rad.DoRadical(matX, matY, matW);
+
+  double valEst = 0;
+  for (uword i = 0; i < matY.n_rows; ++i)
+  {
+    vec y = trans(matY.row(i));
+    valEst += rad.Vasicek(y);
+  }
+
+  mat matS;
+  data::Load("data_3d_ind.txt", matS);
+  double valBest = 0;
+  for (uword i = 0; i < matS.n_rows; ++i)
+  {
+    vec s = trans(matS.row(i));
+    valBest += rad.Vasicek(s);
+  }
+
+  BOOST_REQUIRE_CLOSE(valBest, valEst, 3.0);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -11,6 +11,8 @@
  */
 #include <mlpack/core.hpp>
 #include <mlpack/methods/random_forest/random_forest.hpp>
+#include <mlpack/methods/random_forest/flat_random_forest.hpp>
+#include <mlpack/methods/random_forest/lazy_random_forest.hpp>
 #include <mlpack/methods/decision_tree/random_dimension_select.hpp>
 
 #include "serialization_catch.hpp"
@@ -150,6 +152,32 @@ TEST_CASE("UnweightedNumericLearningTest", "[RandomForestTest]")
   REQUIRE(rfCorrect >= size_t(0.7 * testDataset.n_cols));
 }
 
+/**
+ * Make sure that a random forest built with histogram splits learns as well as
+ * one built with exact splits.
+ */
+TEST_CASE("HistogramSplitNumericLearningTest", "[RandomForestTest]")
+{
+  arma::mat dataset;
+  data::Load("vc2.csv", dataset);
+  arma::Row<size_t> labels;
+  data::Load("vc2_labels.txt", labels);
+
+  RandomForest<GiniGain, MultipleRandomDimensionSelect, HistogramNumericSplit>
+      rf(dataset, labels, 3, 20 /* 20 trees */, 1, 1e-7);
+
+  arma::mat testDataset;
+  data::Load("vc2_test.csv", testDataset);
+  arma::Row<size_t> testLabels;
+  data::Load("vc2_test_labels.txt", testLabels);
+
+  arma::Row<size_t> predictions;
+  rf.Classify(testDataset, predictions);
+
+  const size_t correct = arma::accu(predictions == testLabels);
+  REQUIRE(correct >= size_t(0.7 * testDataset.n_cols));
+}
+
 /**
  * Test weighted numeric learning, making sure that we get better performance
  * than a single decision tree.
@@ -484,3 +512,195 @@ TEST_CASE("DifferentTreesTest", "[RandomForestTest]")
 
   REQUIRE(success == true);
 }
+
+/**
+ * Make sure that the FlatRandomForest makes the same predictions as the
+ * RandomForest it was built from.
+ */
+TEST_CASE("FlatRandomForestTest", "[RandomForestTest]")
+{
+  arma::mat dataset;
+  data::Load("vc2.csv", dataset);
+  arma::Row<size_t> labels;
+  data::Load("vc2_labels.txt", labels);
+
+  RandomForest<> rf(dataset, labels, 3, 10 /* 10 trees */, 1, 1e-7);
+  FlatRandomForest<RandomForest<>> flatForest(rf);
+  REQUIRE(flatForest.NumTrees() == rf.NumTrees());
+
+  arma::mat testDataset;
+  data::Load("vc2_test.csv", testDataset);
+
+  arma::Row<size_t> predictions;
+  arma::mat probabilities;
+  flatForest.Classify(testDataset, predictions, probabilities);
+  REQUIRE(predictions.n_elem == testDataset.n_cols);
+  REQUIRE(probabilities.n_cols == testDataset.n_cols);
+
+  for (size_t i = 0; i < testDataset.n_cols; ++i)
+  {
+    size_t prediction;
+    arma::vec pointProbabilities;
+    rf.Classify(testDataset.col(i), prediction, pointProbabilities);
+
+    REQUIRE(predictions[i] == prediction);
+    REQUIRE(flatForest.Classify(testDataset.col(i)) == prediction);
+    for (size_t j = 0; j < pointProbabilities.n_elem; ++j)
+      REQUIRE(probabilities(j, i) == Approx(pointProbabilities[j]).epsilon(
+          1e-7));
+  }
+
+  // An empty flat forest can't classify.
+  FlatRandomForest<RandomForest<>> emptyForest;
+  REQUIRE_THROWS_AS(emptyForest.Classify(testDataset, predictions),
+      std::invalid_argument);
+}
+
+/**
+ * Make sure that a RandomForest compiled into a QuickScorer makes the same
+ * predictions as the forest.
+ */
+TEST_CASE("RandomForestCompileTest", "[RandomForestTest]")
+{
+  arma::mat dataset;
+  data::Load("vc2.csv", dataset);
+  arma::Row<size_t> labels;
+  data::Load("vc2_labels.txt", labels);
+
+  RandomForest<> rf(dataset, labels, 3, 10 /* 10 trees */, 1, 1e-7);
+  QuickScorer scorer;
+  rf.Compile(scorer);
+  REQUIRE(scorer.NumTrees() == rf.NumTrees());
+
+  arma::mat testDataset;
+  data::Load("vc2_test.csv", testDataset);
+
+  arma::Row<size_t> predictions;
+  arma::mat probabilities;
+  scorer.Classify(testDataset, predictions, probabilities);
+  REQUIRE(predictions.n_elem == testDataset.n_cols);
+  REQUIRE(probabilities.n_cols == testDataset.n_cols);
+
+  for (size_t i = 0; i < testDataset.n_cols; ++i)
+  {
+    size_t prediction;
+    arma::vec pointProbabilities;
+    rf.Classify(testDataset.col(i), prediction, pointProbabilities);
+
+    REQUIRE(predictions[i] == prediction);
+    REQUIRE(scorer.Classify(testDataset.col(i)) == prediction);
+    for (size_t j = 0; j < pointProbabilities.n_elem; ++j)
+      REQUIRE(probabilities(j, i) == Approx(pointProbabilities[j]).epsilon(
+          1e-7).margin(1e-10));
+  }
+
+  // Compiling again replaces the trees of the scorer.
+  rf.Compile(scorer);
+  REQUIRE(scorer.NumTrees() == rf.NumTrees());
+}
+
+/**
+ * Make sure that a LazyRandomForest only loads the trees it uses and makes the
+ * same predictions as the RandomForest it was saved from.
+ */
+TEST_CASE("LazyRandomForestTest", "[RandomForestTest]")
+{
+  arma::mat dataset;
+  data::Load("vc2.csv", dataset);
+  arma::Row<size_t> labels;
+  data::Load("vc2_labels.txt", labels);
+
+  RandomForest<> rf(dataset, labels, 3, 10 /* 10 trees */, 1, 1e-7);
+  LazyRandomForest<RandomForest<>>::Save(rf, "lazy_forest.bin");
+
+  LazyRandomForest<RandomForest<>> lazyForest("lazy_forest.bin");
+  REQUIRE(lazyForest.NumTrees() == rf.NumTrees());
+  for (size_t i = 0; i < lazyForest.NumTrees(); ++i)
+    REQUIRE(!lazyForest.IsLoaded(i));
+
+  // Using one tree loads only that tree.
+  REQUIRE(lazyForest.Tree(3).NumChildren() == rf.Tree(3).NumChildren());
+  REQUIRE(lazyForest.IsLoaded(3));
+  REQUIRE(!lazyForest.IsLoaded(2));
+
+  arma::mat testDataset;
+  data::Load("vc2_test.csv", testDataset);
+
+  arma::Row<size_t> predictions;
+  arma::mat probabilities;
+  lazyForest.Classify(testDataset, predictions, probabilities);
+  REQUIRE(predictions.n_elem == testDataset.n_cols);
+  REQUIRE(probabilities.n_cols == testDataset.n_cols);
+  for (size_t i = 0; i < lazyForest.NumTrees(); ++i)
+    REQUIRE(lazyForest.IsLoaded(i));
+
+  for (size_t i = 0; i < testDataset.n_cols; ++i)
+  {
+    size_t prediction;
+    arma::vec pointProbabilities;
+    rf.Classify(testDataset.col(i), prediction, pointProbabilities);
+
+    REQUIRE(predictions[i] == prediction);
+    REQUIRE(lazyForest.Classify(testDataset.col(i)) == prediction);
+    for (size_t j = 0; j < pointProbabilities.n_elem; ++j)
+      REQUIRE(probabilities(j, i) == Approx(pointProbabilities[j]).epsilon(
+          1e-7));
+  }
+
+  // Files that weren't written by Save() can't be opened.
+  REQUIRE_THROWS_AS(LazyRandomForest<RandomForest<>>("vc2_labels.txt"),
+      std::runtime_error);
+
+  remove("lazy_forest.bin");
+}
+
+/**
+ * Make sure that a tree that can't be deserialized makes Tree() and batch
+ * classification throw, instead of terminating, and leaves the other trees
+ * usable.
+ */
+TEST_CASE("LazyRandomForestDamagedTreeTest", "[RandomForestTest]")
+{
+  arma::mat dataset;
+  data::Load("vc2.csv", dataset);
+  arma::Row<size_t> labels;
+  data::Load("vc2_labels.txt", labels);
+
+  RandomForest<> rf(dataset, labels, 3, 10 /* 10 trees */, 1, 1e-7);
+  LazyRandomForest<RandomForest<>>::Save(rf, "lazy_forest_damaged.bin");
+
+  // Cut tree 5 down to its first four bytes by moving the start of tree 6;
+  // the index entries are 8 little-endian bytes after a 16 byte header.
+  std::fstream file("lazy_forest_damaged.bin",
+      std::ios::in | std::ios::out | std::ios::binary);
+  unsigned char bytes[8];
+  file.seekg(16 + 8 * 5);
+  file.read((char*) bytes, 8);
+  uint64_t offset = 0;
+  for (size_t i = 0; i < 8; ++i)
+    offset |= uint64_t(bytes[i]) << (8 * i);
+  offset += 4;
+  for (size_t i = 0; i < 8; ++i)
+    bytes[i] = (unsigned char) ((offset >> (8 * i)) & 0xFF);
+  file.seekp(16 + 8 * 6);
+  file.write((char*) bytes, 8);
+  file.close();
+
+  LazyRandomForest<RandomForest<>> lazyForest("lazy_forest_damaged.bin");
+  REQUIRE(lazyForest.NumTrees() == 10);
+
+  arma::mat testDataset;
+  data::Load("vc2_test.csv", testDataset);
+  arma::Row<size_t> predictions;
+  arma::mat probabilities;
+  REQUIRE_THROWS_AS(lazyForest.Classify(testDataset, predictions,
+      probabilities), std::runtime_error);
+  REQUIRE_THROWS_AS(lazyForest.Tree(5), std::runtime_error);
+  REQUIRE(!lazyForest.IsLoaded(5));
+
+  // The other trees still load.
+  REQUIRE(lazyForest.Tree(0).NumChildren() == rf.Tree(0).NumChildren());
+  REQUIRE(lazyForest.IsLoaded(9));
+
+  remove("lazy_forest_damaged.bin");
+}
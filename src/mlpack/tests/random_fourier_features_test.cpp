@@ -0,0 +1,104 @@
+/**
+ * @file tests/random_fourier_features_test.cpp
+ *
+ * Test the RandomFourierFeatures class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/methods/random_fourier_features/random_fourier_features.hpp>
+
+#include "catch.hpp"
+#include "test_catch_tools.hpp"
+#include "serialization_catch.hpp"
+
+using namespace mlpack;
+using namespace mlpack::kernel;
+
+/**
+ * Make sure that the inner products of the features approximate the kernel.
+ */
+template<typename KernelType>
+void CheckApproximation(const KernelType& kernel)
+{
+  arma::mat data = arma::randu<arma::mat>(3, 50);
+
+  RandomFourierFeatures<KernelType> rff(kernel, 20000);
+  rff.Train(data.n_rows);
+
+  arma::mat features;
+  rff.Transform(data, features);
+
+  REQUIRE(features.n_rows == 20000);
+  REQUIRE(features.n_cols == 50);
+
+  KernelType k(kernel);
+  const arma::mat approximation = features.t() * features;
+  for (size_t j = 0; j < data.n_cols; ++j)
+  {
+    for (size_t i = 0; i < data.n_cols; ++i)
+    {
+      REQUIRE(approximation(i, j) == Approx(k.Evaluate(data.col(i),
+          data.col(j))).margin(0.05));
+    }
+  }
+}
+
+TEST_CASE("RandomFourierGaussianTest", "[RandomFourierFeaturesTest]")
+{
+  CheckApproximation(GaussianKernel(0.5));
+}
+
+TEST_CASE("RandomFourierLaplacianTest", "[RandomFourierFeaturesTest]")
+{
+  CheckApproximation(LaplacianKernel(0.5));
+}
+
+TEST_CASE("RandomFourierCauchyTest", "[RandomFourierFeaturesTest]")
+{
+  CheckApproximation(CauchyKernel(0.5));
+}
+
+/**
+ * Transform() should fail before Train(), and with data of the wrong
+ * dimensionality.
+ */
+TEST_CASE("RandomFourierInvalidTest", "[RandomFourierFeaturesTest]")
+{
+  arma::mat data = arma::randu<arma::mat>(3, 10);
+  arma::mat features;
+
+  REQUIRE_THROWS_AS(RandomFourierFeatures<GaussianKernel>(GaussianKernel(),
+      0), std::invalid_argument);
+
+  RandomFourierFeatures<GaussianKernel> rff;
+  REQUIRE_THROWS_AS(rff.Transform(data, features), std::runtime_error);
+
+  rff.Train(4);
+  REQUIRE_THROWS_AS(rff.Transform(data, features), std::invalid_argument);
+}
+
+/**
+ * A serialized feature map should give the same features.
+ */
+TEST_CASE("RandomFourierSerializationTest", "[RandomFourierFeaturesTest]")
+{
+  arma::mat data = arma::randu<arma::mat>(3, 10);
+
+  RandomFourierFeatures<GaussianKernel> rff(GaussianKernel(2.0), 50);
+  rff.Train(data.n_rows);
+
+  RandomFourierFeatures<GaussianKernel> xmlRff, textRff, binaryRff;
+  SerializeObjectAll(rff, xmlRff, textRff, binaryRff);
+
+  arma::mat features, xmlFeatures, textFeatures, binaryFeatures;
+  rff.Transform(data, features);
+  xmlRff.Transform(data, xmlFeatures);
+  textRff.Transform(data, textFeatures);
+  binaryRff.Transform(data, binaryFeatures);
+
+  CheckMatrices(features, xmlFeatures, textFeatures, binaryFeatures);
+}
@@ -60,3 +60,85 @@ TEST_CASE("RandomizedSVDReconstructionError", "[RandomizedSVDTest]")
       arma::norm(centeredData, "frob");
   REQUIRE(error == Approx(0.0).margin(1e-5));
 }
+
+/**
+ * The randomized SVD of a sparse matrix should match the SVD of the centered
+ * dense matrix.
+ */
+TEST_CASE("RandomizedSVDSparseReconstructionError", "[RandomizedSVDTest]")
+{
+  // A sparse matrix of rank at most 3; once centered, its rank is at most 4.
+  arma::sp_mat data(50, 200);
+  for (size_t i = 0; i < 3; ++i)
+  {
+    data += arma::sprandu<arma::sp_mat>(50, 1, 0.3) *
+        arma::sprandu<arma::sp_mat>(1, 200, 0.3);
+  }
+
+  arma::mat centeredData;
+  math::Center(arma::mat(data), centeredData);
+
+  arma::mat U1, U2, V1, V2;
+  arma::vec s1, s2;
+
+  arma::svd_econ(U1, s1, V1, centeredData);
+
+  svd::RandomizedSVD rSVD(0, 10);
+  rSVD.Apply(data, U2, s2, V2, 4);
+
+  REQUIRE(s2.n_elem >= 4);
+  const double error = arma::norm(s2.head(4) - s1.head(4)) /
+      arma::norm(s1.head(4));
+  REQUIRE(error == Approx(0.0).margin(1e-5));
+
+  arma::mat reconstruct = U2 * arma::diagmat(s2) * V2.t();
+  REQUIRE(arma::norm(centeredData - reconstruct, "frob") /
+      arma::norm(centeredData, "frob") == Approx(0.0).margin(1e-5));
+}
+
+/**
+ * The single-pass randomized SVD over the chunks of a loader should recover
+ * the SVD of a low-rank centered matrix.
+ */
+TEST_CASE("RandomizedSVDSinglePassTest", "[RandomizedSVDTest]")
+{
+  const arma::mat data = arma::randn<arma::mat>(20, 3) *
+      arma::randn<arma::mat>(3, 200);
+
+  std::vector<std::string> predictorFiles, responseFiles;
+  for (size_t i = 0; i < 4; ++i)
+  {
+    predictorFiles.push_back("rsvd_chunk_" + std::to_string(i) + ".csv");
+    responseFiles.push_back("rsvd_chunk_responses_" + std::to_string(i) +
+        ".csv");
+    data::Save(predictorFiles[i], arma::mat(data.cols(50 * i,
+        50 * i + 49)));
+    data::Save(responseFiles[i], arma::mat(1, 50, arma::fill::zeros));
+  }
+
+  data::PrefetchLoader<data::FileChunkSource> loader(data::FileChunkSource(
+      predictorFiles, responseFiles));
+
+  arma::mat centeredData;
+  math::Center(data, centeredData);
+
+  arma::mat U, V;
+  arma::vec s;
+  svd::RandomizedSVD rSVD;
+  rSVD.Apply(loader, U, s, V, 4, true);
+
+  REQUIRE(U.n_cols == 4);
+  REQUIRE(s.n_elem == 4);
+  REQUIRE(V.n_rows == 200);
+  REQUIRE(V.n_cols == 4);
+
+  const arma::mat reconstruct = U * arma::diagmat(s) * V.t();
+  REQUIRE(arma::norm(centeredData - reconstruct, "frob") /
+      arma::norm(centeredData, "frob") == Approx(0.0).margin(1e-5));
+
+  for (size_t i = 0; i < 4; ++i)
+  {
+    remove(predictorFiles[i].c_str());
+    remove(responseFiles[i].c_str());
+  }
+}
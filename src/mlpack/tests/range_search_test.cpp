@@ -13,6 +13,7 @@
 #include <mlpack/methods/range_search/range_search.hpp>
 #include <mlpack/core/tree/cover_tree.hpp>
 #include <mlpack/methods/range_search/rs_model.hpp>
+#include <mlpack/core/metrics/mahalanobis_search.hpp>
 
 #include "catch.hpp"
 #include "test_catch_tools.hpp"
@@ -1698,3 +1699,134 @@ TEST_CASE("MoveOperatorNaiveTest", "[RangeSearchTest]")
     }
   }
 }
+
+/**
+ * Make sure that the callback and compressed sparse row overloads of Search()
+ * give the same results as the vector overload, with every search mode.
+ */
+TEST_CASE("RangeSearchCallbackAndCSRTest", "[RangeSearchTest]")
+{
+  arma::mat referenceData = arma::randu<arma::mat>(3, 300);
+  arma::mat queryData = arma::randu<arma::mat>(3, 100);
+  const math::Range range(0.1, 0.3);
+
+  for (size_t mode = 0; mode < 3; ++mode)
+  {
+    RangeSearch<> rs(referenceData, mode == 0, mode == 1);
+
+    vector<vector<size_t>> neighbors;
+    vector<vector<double>> distances;
+    rs.Search(queryData, range, neighbors, distances);
+
+    vector<vector<pair<double, size_t>>> sortedResults;
+    SortResults(neighbors, distances, sortedResults);
+
+    // Collect the results from the callback.
+    vector<vector<size_t>> callbackNeighbors(queryData.n_cols);
+    vector<vector<double>> callbackDistances(queryData.n_cols);
+    rs.Search(queryData, range, [&](const size_t queryIndex,
+                                    const size_t referenceIndex,
+                                    const double distance)
+    {
+      callbackNeighbors[queryIndex].push_back(referenceIndex);
+      callbackDistances[queryIndex].push_back(distance);
+    });
+
+    vector<vector<pair<double, size_t>>> sortedCallbackResults;
+    SortResults(callbackNeighbors, callbackDistances, sortedCallbackResults);
+
+    // Get the compressed sparse row results.
+    arma::Col<size_t> offsets, csrNeighbors;
+    arma::vec csrDistances;
+    rs.Search(queryData, range, offsets, csrNeighbors, csrDistances);
+
+    REQUIRE(offsets.n_elem == queryData.n_cols + 1);
+    REQUIRE(offsets[queryData.n_cols] == csrNeighbors.n_elem);
+    REQUIRE(csrDistances.n_elem == csrNeighbors.n_elem);
+
+    for (size_t i = 0; i < queryData.n_cols; ++i)
+    {
+      REQUIRE(sortedCallbackResults[i].size() == sortedResults[i].size());
+      REQUIRE(offsets[i + 1] - offsets[i] == sortedResults[i].size());
+
+      vector<pair<double, size_t>> csrResults;
+      for (size_t j = offsets[i]; j < offsets[i + 1]; ++j)
+        csrResults.push_back(make_pair(csrDistances[j], csrNeighbors[j]));
+      sort(csrResults.begin(), csrResults.end());
+
+      for (size_t j = 0; j < sortedResults[i].size(); ++j)
+      {
+        REQUIRE(sortedCallbackResults[i][j].second ==
+            sortedResults[i][j].second);
+        REQUIRE(sortedCallbackResults[i][j].first ==
+            Approx(sortedResults[i][j].first).epsilon(1e-7));
+        REQUIRE(csrResults[j].second == sortedResults[i][j].second);
+        REQUIRE(csrResults[j].first ==
+            Approx(sortedResults[i][j].first).epsilon(1e-7));
+      }
+    }
+
+    // The monochromatic callback search should not return any point itself.
+    size_t numResults = 0;
+    rs.Search(range, [&](const size_t queryIndex,
+                         const size_t referenceIndex,
+                         const double /* distance */)
+    {
+      REQUIRE(queryIndex != referenceIndex);
+      ++numResults;
+    });
+
+    vector<vector<size_t>> monoNeighbors;
+    vector<vector<double>> monoDistances;
+    rs.Search(range, monoNeighbors, monoDistances);
+    size_t expectedResults = 0;
+    for (size_t i = 0; i < monoNeighbors.size(); ++i)
+      expectedResults += monoNeighbors[i].size();
+
+    REQUIRE(numResults == expectedResults);
+  }
+}
+
+/**
+ * Make sure that range search with a Mahalanobis distance through the
+ * transformed points finds the points in range of a brute-force search.
+ */
+TEST_CASE("RangeSearchMahalanobisTest", "[RangeSearchTest]")
+{
+  arma::mat referenceSet(3, 200, arma::fill::randu);
+  arma::mat querySet(3, 30, arma::fill::randu);
+  arma::mat factor(3, 3, arma::fill::randn);
+  MahalanobisDistance<> distance(factor.t() * factor +
+      0.1 * arma::eye<arma::mat>(3, 3));
+
+  MahalanobisSearch<RangeSearch<>> rs(referenceSet, distance);
+  const Range range(0.1, 0.6);
+  vector<vector<size_t>> neighbors;
+  vector<vector<double>> distances;
+  rs.Search(querySet, range, neighbors, distances);
+
+  REQUIRE(neighbors.size() == querySet.n_cols);
+  for (size_t q = 0; q < querySet.n_cols; ++q)
+  {
+    // Points too close to the bounds of the range may go either way.
+    size_t count = 0;
+    for (size_t r = 0; r < referenceSet.n_cols; ++r)
+    {
+      const double d = distance.Evaluate(querySet.col(q),
+          referenceSet.col(r));
+      if (d > range.Lo() + 1e-8 && d < range.Hi() - 1e-8)
+      {
+        REQUIRE(std::find(neighbors[q].begin(), neighbors[q].end(), r) !=
+            neighbors[q].end());
+        ++count;
+      }
+    }
+    REQUIRE(neighbors[q].size() >= count);
+
+    for (size_t i = 0; i < neighbors[q].size(); ++i)
+    {
+      REQUIRE(distances[q][i] == Approx(distance.Evaluate(querySet.col(q),
+          referenceSet.col(neighbors[q][i]))).epsilon(1e-6).margin(1e-8));
+    }
+  }
+}
@@ -211,6 +211,47 @@ TEST_CASE("ssRBMClassificationTest", "[RBMNetworkTest]")
   REQUIRE(ssRbmClassificationAccuracy >= 76.18 - 3.0);
 }
 
+/*
+ * Make sure the samples of the hidden layer follow its mean, and that the
+ * persistent chains of the negative samples give reproducible gradients.
+ */
+TEST_CASE("BinaryRBMSamplingTest", "[RBMNetworkTest]")
+{
+  arma::mat data = arma::randu<arma::mat>(6, 20);
+  GaussianInitialization gaussian(0, 0.5);
+
+  // The constructor draws the key of the sampling stream.
+  math::RandomSeed(7);
+  RBM<GaussianInitialization> model(data, gaussian, 6, 4, 5, 2, 3, 2, 8, 1,
+      true);
+  math::RandomSeed(7);
+  RBM<GaussianInitialization> copy(data, gaussian, 6, 4, 5, 2, 3, 2, 8, 1,
+      true);
+  model.Reset();
+  copy.Reset();
+  copy.Parameters() = model.Parameters();
+
+  arma::mat gradient, copyGradient;
+  for (size_t i = 0; i < 4; ++i)
+  {
+    model.Gradient(model.Parameters(), 5 * i, gradient, 5);
+    copy.Gradient(copy.Parameters(), 5 * i, copyGradient, 5);
+    REQUIRE(gradient.n_elem == model.Parameters().n_elem);
+    REQUIRE(gradient.is_finite());
+    REQUIRE(arma::approx_equal(gradient, copyGradient, "absdiff", 1e-10));
+  }
+
+  arma::mat mean, samples;
+  const arma::mat input = arma::repmat(data.col(0), 1, 20000);
+  model.HiddenMean(input, mean);
+  model.SampleHidden(input, samples);
+  REQUIRE(arma::all(arma::vectorise((samples == 0) + (samples == 1)) == 1));
+
+  const arma::vec frequency = arma::mean(samples, 1);
+  for (size_t i = 0; i < frequency.n_elem; ++i)
+    REQUIRE(frequency[i] == Approx(mean(i, 0)).margin(0.02));
+}
+
 template<typename MatType = arma::mat>
 void BuildVanillaNetwork(MatType& trainData,
                          const size_t hiddenLayerSize)
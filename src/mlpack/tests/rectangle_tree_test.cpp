@@ -1359,3 +1359,124 @@ TEST_CASE("RectangleTreeMoveDatasetTest", "[RectangleTreeTraitsTest]")
   REQUIRE(tree.Dataset().n_rows == 3);
   REQUIRE(tree.Dataset().n_cols == 1000);
 }
+
+/**
+ * Check that a bulk-loaded tree is valid and gives the same nearest neighbors
+ * as a naive search, with both single-tree and dual-tree search.
+ */
+template<template<typename, typename, typename> class TreeType>
+void CheckBulkLoadedTree(const arma::mat& dataset)
+{
+  typedef TreeType<EuclideanDistance, NeighborSearchStat<NearestNeighborSort>,
+      arma::mat> Tree;
+  Tree tree(dataset, BulkLoadTag(), 20, 6, 5, 2);
+
+  REQUIRE(tree.NumDescendants() == dataset.n_cols);
+
+  CheckContainment(tree);
+  CheckExactContainment(tree);
+  CheckHierarchy(tree);
+  CheckNumDescendants(tree);
+  CheckFills(tree);
+  REQUIRE(GetMinLevel(tree) == GetMaxLevel(tree));
+
+  arma::Mat<size_t> neighbors1, neighbors2, neighbors3;
+  arma::mat distances1, distances2, distances3;
+
+  KNN naive(dataset, NAIVE_MODE);
+  naive.Search(5, neighbors1, distances1);
+
+  NeighborSearch<NearestNeighborSort, metric::LMetric<2, true>, arma::mat,
+      TreeType> knn(std::move(tree), SINGLE_TREE_MODE);
+  knn.Search(5, neighbors2, distances2);
+
+  knn.SearchMode() = DUAL_TREE_MODE;
+  knn.Search(5, neighbors3, distances3);
+
+  for (size_t i = 0; i < neighbors1.n_elem; ++i)
+  {
+    REQUIRE(neighbors1[i] == neighbors2[i]);
+    REQUIRE(distances1[i] == distances2[i]);
+    REQUIRE(neighbors1[i] == neighbors3[i]);
+    REQUIRE(distances1[i] == distances3[i]);
+  }
+}
+
+// Make sure that bulk-loaded trees are valid, balanced, and give correct
+// search results.
+TEST_CASE("RTreeBulkLoadTest", "[RectangleTreeTraitsTest]")
+{
+  arma::mat dataset = arma::randu<arma::mat>(8, 1000);
+  CheckBulkLoadedTree<RTree>(dataset);
+}
+
+TEST_CASE("RStarTreeBulkLoadTest", "[RectangleTreeTraitsTest]")
+{
+  arma::mat dataset = arma::randu<arma::mat>(3, 1000);
+  CheckBulkLoadedTree<RStarTree>(dataset);
+}
+
+TEST_CASE("XTreeBulkLoadTest", "[RectangleTreeTraitsTest]")
+{
+  arma::mat dataset = arma::randu<arma::mat>(8, 1000);
+  CheckBulkLoadedTree<XTree>(dataset);
+}
+
+TEST_CASE("HilbertRTreeBulkLoadTest", "[RectangleTreeTraitsTest]")
+{
+  arma::mat dataset = arma::randu<arma::mat>(8, 1000);
+  CheckBulkLoadedTree<HilbertRTree>(dataset);
+
+  // The points and nodes must be ordered by their Hilbert values, as if they
+  // had been inserted.
+  typedef HilbertRTree<EuclideanDistance,
+      NeighborSearchStat<NearestNeighborSort>, arma::mat> TreeType;
+  TreeType tree(dataset, BulkLoadTag(), 20, 6, 5, 2);
+
+  CheckHilbertOrdering(tree);
+  CheckDiscreteHilbertValueSync(tree);
+}
+
+// A dataset that fits in one leaf should give a single bulk-loaded node.
+TEST_CASE("RectangleTreeBulkLoadLeafTest", "[RectangleTreeTraitsTest]")
+{
+  arma::mat dataset = arma::randu<arma::mat>(5, 15);
+
+  RTree<EuclideanDistance, EmptyStatistic, arma::mat> rTree(dataset,
+      BulkLoadTag());
+  HilbertRTree<EuclideanDistance, EmptyStatistic, arma::mat> hilbertRTree(
+      dataset, BulkLoadTag());
+
+  REQUIRE(rTree.IsLeaf());
+  REQUIRE(rTree.Count() == 15);
+  CheckExactContainment(rTree);
+
+  REQUIRE(hilbertRTree.IsLeaf());
+  REQUIRE(hilbertRTree.Count() == 15);
+  CheckHilbertOrdering(hilbertRTree);
+  CheckDiscreteHilbertValueSync(hilbertRTree);
+}
+
+// Points can still be inserted into and deleted from a bulk-loaded tree.
+TEST_CASE("RectangleTreeBulkLoadInsertionTest", "[RectangleTreeTraitsTest]")
+{
+  arma::mat dataset = arma::randu<arma::mat>(8, 1000);
+
+  typedef RStarTree<EuclideanDistance, NeighborSearchStat<NearestNeighborSort>,
+      arma::mat> TreeType;
+  TreeType tree(dataset, BulkLoadTag(), 20, 6, 5, 2);
+
+  // Delete and reinsert some points.
+  for (size_t i = 0; i < 100; ++i)
+    REQUIRE(tree.DeletePoint(i));
+  REQUIRE(tree.NumDescendants() == 900);
+  for (size_t i = 0; i < 100; ++i)
+    tree.InsertPoint(i);
+
+  REQUIRE(tree.NumDescendants() == 1000);
+  CheckContainment(tree);
+  CheckExactContainment(tree);
+  CheckHierarchy(tree);
+  CheckNumDescendants(tree);
+  REQUIRE(GetMinLevel(tree) == GetMaxLevel(tree));
+}
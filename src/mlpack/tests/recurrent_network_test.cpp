@@ -22,6 +22,7 @@
 #include "catch.hpp"
 #include "serialization_catch.hpp"
 #include "custom_layer.hpp"
+#include "ann_test_tools.hpp"
 
 using namespace mlpack;
 using namespace mlpack::ann;
@@ -974,6 +975,73 @@ TEST_CASE("GRUBatchSizeTest", "[RecurrentNetworkTest]")
   BatchSizeTest<GRU<>>();
 }
 
+/**
+ * Make sure that stepping through sequences with RNN::Step() gives the same
+ * outputs as RNN::Predict(), and that the state of the sequences can be saved
+ * and restored.
+ */
+template<typename RecurrentLayerType>
+void StepTest()
+{
+  const size_t rho = 8;
+  arma::cube input(3, 4, rho, arma::fill::randu);
+
+  RNN<> model(rho);
+  model.Add<Linear<>>(3, 6);
+  model.Add<SigmoidLayer<>>();
+  model.Add<RecurrentLayerType>(6, 6);
+  model.Add<Linear<>>(6, 2);
+  model.Reset();
+
+  arma::cube predictions;
+  model.Predict(input, predictions);
+
+  // Step through the sequences, and save their state halfway.
+  std::vector<arma::mat> halfway;
+  arma::mat output;
+  for (size_t t = 0; t < rho; ++t)
+  {
+    model.Step(input.slice(t), output);
+    CheckMatrices(output, predictions.slice(t));
+    if (t == rho / 2 - 1)
+      halfway = model.StepState();
+  }
+
+  // Step through other sequences, then continue the first ones.
+  model.ResetStepState();
+  model.Step(arma::mat(3, 4, arma::fill::randu), output);
+  model.StepState() = halfway;
+  for (size_t t = rho / 2; t < rho; ++t)
+  {
+    model.Step(input.slice(t), output);
+    CheckMatrices(output, predictions.slice(t));
+  }
+}
+
+/**
+ * Ensure that LSTMs can be stepped through.
+ */
+TEST_CASE("LSTMStepTest", "[RecurrentNetworkTest]")
+{
+  StepTest<LSTM<>>();
+}
+
+/**
+ * Ensure that fast LSTMs can be stepped through.
+ */
+TEST_CASE("FastLSTMStepTest", "[RecurrentNetworkTest]")
+{
+  StepTest<FastLSTM<>>();
+}
+
+/**
+ * Ensure that GRUs can be stepped through.
+ */
+TEST_CASE("GRUStepTest", "[RecurrentNetworkTest]")
+{
+  StepTest<GRU<>>();
+}
+
 /**
  * Make sure the RNN can be properly serialized.
  */
@@ -1410,6 +1478,50 @@ TEST_CASE("BRNNTrainReturnObjective", "[RecurrentNetworkTest]")
   REQUIRE(std::isfinite(objVal) == true);
 }
 
+/**
+ * BRNN numerical gradient test; the two directions are back-propagated at the
+ * same time, and each must only write to its half of the gradient.
+ */
+TEST_CASE("GradientBRNNTest", "[RecurrentNetworkTest]")
+{
+  struct GradientFunction
+  {
+    GradientFunction() :
+        input(arma::randu(3, 2, 5)),
+        target(arma::cube(1, 2, 5))
+    {
+      const size_t rho = 5;
+      for (size_t i = 0; i < target.n_elem; ++i)
+        target[i] = math::RandInt(1, 7);
+
+      model = new BRNN<>(rho);
+      model->Predictors() = input;
+      model->Responses() = target;
+      model->Add<IdentityLayer<> >();
+      model->Add<Linear<> >(3, 4);
+      model->Add<LSTM<> >(4, 4, rho);
+      model->Add<Linear<> >(4, 3);
+    }
+
+    ~GradientFunction()
+    {
+      delete model;
+    }
+
+    double Gradient(arma::mat& gradient) const
+    {
+      return model->EvaluateWithGradient(model->Parameters(), 0, gradient, 2);
+    }
+
+    arma::mat& Parameters() { return model->Parameters(); }
+
+    BRNN<>* model;
+    arma::cube input, target;
+  } function;
+
+  REQUIRE(CheckGradient(function) <= 1e-4);
+}
+
 /**
  * Test that RNN::Train() does not give an error for large rho.
  */
@@ -315,3 +315,82 @@ TEST_CASE("RegularizedSVDFunctionOptimizeHOGWILD", "[RegularizedSVDTest]")
 }
 
 #endif
+
+TEST_CASE("SGDScheduleVisitsEachRatingOnce", "[RegularizedSVDTest]")
+{
+  const size_t numUsers = 70;
+  const size_t numItems = 40;
+  arma::mat data = arma::randu(3, 1000);
+  data.row(0) = floor(data.row(0) * numUsers);
+  data.row(1) = floor(data.row(1) * numItems);
+
+  const amf::SGDSchedule::Mode modes[] = { amf::SGDSchedule::STRATIFIED,
+      amf::SGDSchedule::HOGWILD };
+  for (const amf::SGDSchedule::Mode mode : modes)
+  {
+    amf::SGDSchedule schedule(mode, 4);
+    schedule.Reset(data, numUsers, numItems);
+
+    // Each rating is visited by one thread only, so the counts don't race.
+    arma::Col<size_t> visits(data.n_cols, arma::fill::zeros);
+    for (size_t epoch = 0; epoch < 3; ++epoch)
+      schedule.Epoch([&](const size_t i) { ++visits[i]; });
+
+    for (size_t i = 0; i < visits.n_elem; ++i)
+      REQUIRE(visits[i] == 3);
+  }
+}
+
+TEST_CASE("RegularizedSVDFunctionOptimizeStratified", "[RegularizedSVDTest]")
+{
+  // Define useful constants.
+  const size_t numUsers = 50;
+  const size_t numItems = 50;
+  const size_t numRatings = 100;
+  const size_t rank = 10;
+  const double lambda = 0.01;
+
+  // Initiate random parameters.
+  arma::mat parameters = arma::randu(rank, numUsers + numItems);
+
+  // Make a random rating dataset.
+  arma::mat data = arma::randu(3, numRatings);
+  data.row(0) = floor(data.row(0) * numUsers);
+  data.row(1) = floor(data.row(1) * numItems);
+
+  // Manually set last row to maximum user and maximum item.
+  data(0, numRatings - 1) = numUsers - 1;
+  data(1, numRatings - 1) = numItems - 1;
+
+  // Make rating entries based on the parameters.
+  for (size_t i = 0; i < numRatings; ++i)
+  {
+    data(2, i) = arma::dot(parameters.col(data(0, i)),
+                           parameters.col(numUsers + data(1, i)));
+  }
+
+  // The specialization for ExponentialBackoff visits the ratings with a
+  // stratified schedule.
+  RegularizedSVDFunction<arma::mat> rSVDFunc(data, rank, lambda);
+  ExponentialBackoff decayPolicy(100000, 0.01, 0.9);
+  ParallelSGD<ExponentialBackoff> optimizer(0, rSVDFunc.NumFunctions(), 1e-5,
+      true, decayPolicy);
+
+  arma::mat optParameters = arma::randu(rank, numUsers + numItems);
+  optimizer.Optimize(rSVDFunc, optParameters);
+
+  // Get predicted ratings from optimized parameters.
+  arma::mat predictedData(1, numRatings);
+  for (size_t i = 0; i < numRatings; ++i)
+  {
+    predictedData(0, i) = arma::dot(optParameters.col(data(0, i)),
+                                    optParameters.col(numUsers + data(1, i)));
+  }
+
+  // Calculate relative error.
+  const double relativeError = arma::norm(data.row(2) - predictedData, "frob") /
+                               arma::norm(data, "frob");
+
+  // Relative error should be small.
+  REQUIRE(relativeError == Approx(0.0).margin(1e-2));
+}
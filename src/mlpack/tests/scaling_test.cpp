@@ -172,3 +172,62 @@ TEST_CASE("ZCAWhiteningTest", "[ScalingTest]")
   scale.InverseTransform(output, temp);
   CheckMatrices(dataset, temp);
 }
+
+/**
+ * Fit the given scaler on random data with Fit(), and another one batch by
+ * batch with PartialFit(), and make sure they transform the data in the same
+ * way (up to the signs of the eigenvectors, for PCA whitening); then make sure
+ * the in-place Transform() gives the same result.
+ */
+template<typename ScalerType>
+void CheckPartialFit(ScalerType scale, ScalerType partialScale)
+{
+  arma::mat data = arma::randu<arma::mat>(4, 1000);
+  data.row(1) *= 100.0;
+  data.row(2) -= 10.0;
+
+  scale.Fit(data);
+  // Uneven batches, including an empty one.
+  partialScale.PartialFit(arma::mat(data.cols(0, 0)));
+  partialScale.PartialFit(arma::mat(data.cols(1, 299)));
+  partialScale.PartialFit(arma::mat(4, 0));
+  partialScale.PartialFit(arma::mat(data.cols(300, 999)));
+
+  arma::mat output, partialOutput;
+  scale.Transform(data, output);
+  partialScale.Transform(data, partialOutput);
+  CheckMatrices(arma::abs(output), arma::abs(partialOutput), 1e-5);
+
+  arma::mat inPlace(data);
+  scale.Transform(inPlace);
+  CheckMatrices(output, inPlace);
+}
+
+/**
+ * Test that PartialFit() on batches gives the same scalers as Fit().
+ */
+TEST_CASE("PartialFitTest", "[ScalingTest]")
+{
+  CheckPartialFit(StandardScaler(), StandardScaler());
+  CheckPartialFit(MinMaxScaler(-1, 1), MinMaxScaler(-1, 1));
+  CheckPartialFit(MaxAbsScaler(), MaxAbsScaler());
+  CheckPartialFit(MeanNormalization(), MeanNormalization());
+  CheckPartialFit(PCAWhitening(), PCAWhitening());
+  CheckPartialFit(ZCAWhitening(), ZCAWhitening());
+}
+
+/**
+ * Test that PartialFit() throws if the dimensionality changes.
+ */
+TEST_CASE("PartialFitDimensionalityTest", "[ScalingTest]")
+{
+  StandardScaler scale;
+  scale.PartialFit(arma::mat(3, 10, arma::fill::randu));
+  REQUIRE_THROWS_AS(scale.PartialFit(arma::mat(4, 10, arma::fill::randu)),
+      std::invalid_argument);
+
+  PCAWhitening pca;
+  pca.PartialFit(arma::mat(3, 10, arma::fill::randu));
+  REQUIRE_THROWS_AS(pca.PartialFit(arma::mat(4, 10, arma::fill::randu)),
+      std::invalid_argument);
+}
@@ -20,6 +20,7 @@
 #include <boost/archive/binary_iarchive.hpp>
 #include <boost/archive/binary_oarchive.hpp>
 #include <mlpack/core.hpp>
+#include <mlpack/core/data/portable_binary_archive.hpp>
 
 #include <boost/test/unit_test.hpp>
 #include "test_tools.hpp"
@@ -111,6 +112,8 @@ void TestAllArmadilloSerialization(arma::Cube<CubeType>& x)
       boost::archive::text_oarchive>(x);
   TestArmadilloSerialization<CubeType, boost::archive::binary_iarchive,
       boost::archive::binary_oarchive>(x);
+  TestArmadilloSerialization<CubeType, data::PortableBinaryIArchive,
+      data::PortableBinaryOArchive>(x);
 }
 
 // Test function for loading and saving Armadillo objects.
@@ -185,6 +188,8 @@ void TestAllArmadilloSerialization(MatType& x)
       boost::archive::text_oarchive>(x);
   TestArmadilloSerialization<MatType, boost::archive::binary_iarchive,
       boost::archive::binary_oarchive>(x);
+  TestArmadilloSerialization<MatType, data::PortableBinaryIArchive,
+      data::PortableBinaryOArchive>(x);
 }
 
 // Save and load an mlpack object.
@@ -1064,6 +1064,11 @@ BOOST_AUTO_TEST_CASE(LSHTest)
   for (size_t i = 0; i < lsh.SecondHashTable().size(); ++i)
   CheckMatrices(lsh.SecondHashTable()[i], xmlLsh.SecondHashTable()[i],
       textLsh.SecondHashTable()[i], binaryLsh.SecondHashTable()[i]);
+
+  CheckMatrices(lsh.BucketOffsets(), xmlLsh.BucketOffsets(),
+      textLsh.BucketOffsets(), binaryLsh.BucketOffsets());
+  CheckMatrices(lsh.BucketContents(), xmlLsh.BucketContents(),
+      textLsh.BucketContents(), binaryLsh.BucketContents());
 }
 
 // Make sure serialization works for the decision stump.
@@ -1633,4 +1638,44 @@ BOOST_AUTO_TEST_CASE(BayesianLinearRegressionTest)
   CheckMatrices(pred, xmlPred, textPred, binaryPred);
 }
 
+/**
+ * Make sure a model saved with data::Save() in the portable binary format gives
+ * the same results after loading.
+ */
+BOOST_AUTO_TEST_CASE(PortableBinaryModelTest)
+{
+  using neighbor::KNN;
+
+  arma::mat dataset = arma::randu<arma::mat>(5, 2000);
+  KNN knn(dataset);
+  BOOST_REQUIRE(data::Save("knn_model.pbin", "knn", knn));
+
+  KNN loadedKnn;
+  BOOST_REQUIRE(data::Load("knn_model.pbin", "knn", loadedKnn));
+  remove("knn_model.pbin");
+
+  arma::mat querySet = arma::randu<arma::mat>(5, 500);
+  arma::mat distances, loadedDistances;
+  arma::Mat<size_t> neighbors, loadedNeighbors;
+  knn.Search(querySet, 5, neighbors, distances);
+  loadedKnn.Search(querySet, 5, loadedNeighbors, loadedDistances);
+
+  CheckMatrices(distances, loadedDistances);
+  CheckMatrices(neighbors, loadedNeighbors);
+}
+
+/**
+ * Make sure files that aren't portable binary archives are not loaded.
+ */
+BOOST_AUTO_TEST_CASE(PortableBinaryInvalidFileTest)
+{
+  arma::mat m = arma::randu<arma::mat>(10, 10);
+  BOOST_REQUIRE(data::Save("matrix.bin", "m", m, false, data::format::binary));
+
+  arma::mat loaded;
+  BOOST_REQUIRE(!data::Load("matrix.bin", "m", loaded, false,
+      data::format::portable_binary));
+  remove("matrix.bin");
+}
+
 BOOST_AUTO_TEST_SUITE_END();
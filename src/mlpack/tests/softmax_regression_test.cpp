@@ -674,3 +674,91 @@ TEST_CASE("SoftmaxRegressionComputeProbabilitiesAndLabelsTest",
     REQUIRE(testLabels(i) == labels(i));
   }
 }
+
+/**
+ * Make sure the sparse batch gradient matches the dense batch gradient on the
+ * intercepts and the features which appear in the batch, and leaves the other
+ * features empty.
+ */
+TEST_CASE("SoftmaxRegressionFunctionSparseGradient", "[SoftmaxRegressionTest]")
+{
+  const size_t points = 200;
+  const size_t inputSize = 100;
+  const size_t numClasses = 4;
+
+  arma::sp_mat data;
+  data.sprandu(inputSize, points, 0.02);
+  const arma::mat denseData(data);
+
+  arma::Row<size_t> labels(points);
+  for (size_t i = 0; i < points; ++i)
+    labels(i) = math::RandInt(0, numClasses);
+
+  SoftmaxRegressionFunctionType<arma::sp_mat> srf(data, labels, numClasses,
+      0.5, true);
+  SoftmaxRegressionFunction denseSrf(denseData, labels, numClasses, 0.5, true);
+
+  const arma::mat parameters = srf.GetInitialPoint();
+  for (size_t start = 0; start < points; start += 10)
+  {
+    arma::sp_mat gradient;
+    arma::mat denseGradient;
+    srf.Gradient(parameters, start, gradient, 10);
+    denseSrf.Gradient(parameters, start, denseGradient, 10);
+
+    REQUIRE(gradient.n_rows == denseGradient.n_rows);
+    REQUIRE(gradient.n_cols == denseGradient.n_cols);
+
+    const arma::sp_mat batch = data.cols(start, start + 9);
+    for (size_t c = 0; c < numClasses; ++c)
+    {
+      REQUIRE(gradient(c, 0) == Approx(denseGradient(c, 0)).epsilon(1e-7));
+      for (size_t i = 0; i < inputSize; ++i)
+      {
+        if (arma::accu(arma::abs(batch.row(i))) == 0.0)
+        {
+          REQUIRE((double) gradient(c, i + 1) == 0.0);
+        }
+        else
+        {
+          REQUIRE(gradient(c, i + 1) ==
+              Approx(denseGradient(c, i + 1)).epsilon(1e-7));
+        }
+      }
+    }
+  }
+}
+
+/**
+ * Make sure that training on sparse data gives the same model as training on
+ * the same dense data.
+ */
+TEST_CASE("SoftmaxRegressionSparseTrainTest", "[SoftmaxRegressionTest]")
+{
+  arma::sp_mat dataset;
+  dataset.sprandu(10, 1000, 0.3);
+  const arma::mat denseDataset(dataset);
+  arma::Row<size_t> labels(1000);
+  for (size_t i = 0; i < 1000; ++i)
+    labels[i] = math::RandInt(0, 3);
+
+  SoftmaxRegression sr(dataset.n_rows, 3, true);
+  SoftmaxRegression srSparse(dataset.n_rows, 3, true);
+  srSparse.Parameters() = sr.Parameters();
+
+  sr.Train(denseDataset, labels, 3);
+  srSparse.Train(dataset, labels, 3);
+
+  REQUIRE(sr.Parameters().n_elem == srSparse.Parameters().n_elem);
+  for (size_t i = 0; i < sr.Parameters().n_elem; ++i)
+  {
+    REQUIRE(srSparse.Parameters()[i] ==
+        Approx(sr.Parameters()[i]).epsilon(1e-3).margin(1e-5));
+  }
+
+  // The classifications of the dense and sparse points must match.
+  arma::Row<size_t> predictions, sparsePredictions;
+  srSparse.Classify(denseDataset, predictions);
+  srSparse.Classify(dataset, sparsePredictions);
+  REQUIRE(arma::accu(predictions != sparsePredictions) == 0);
+}
@@ -274,3 +274,53 @@ TEST_CASE("SparseAutoencoderFunctionGradient", "[SparseAutoencoderTest]")
     }
   }
 }
+
+/**
+ * Make sure that EvaluateWithGradient() gives the same results as Evaluate()
+ * and Gradient(), and that the mini-batch objectives are consistent with the
+ * objective on the whole dataset.
+ */
+TEST_CASE("SparseAutoencoderFunctionEvaluateWithGradient",
+          "[SparseAutoencoderTest]")
+{
+  const size_t vSize = 5;
+  const size_t hSize = 3;
+
+  arma::mat data;
+  data.randu(vSize, 20);
+
+  SparseAutoencoderFunction saf(data, vSize, hSize, 0.01, 0.5, 0.1);
+  const arma::mat parameters = saf.GetInitialPoint();
+
+  arma::mat gradient, gradientWith;
+  const double cost = saf.Evaluate(parameters);
+  saf.Gradient(parameters, gradient);
+  const double costWith = saf.EvaluateWithGradient(parameters, gradientWith);
+
+  REQUIRE(costWith == Approx(cost).epsilon(1e-7));
+  REQUIRE(gradientWith.n_rows == gradient.n_rows);
+  REQUIRE(gradientWith.n_cols == gradient.n_cols);
+  for (size_t i = 0; i < gradient.n_elem; ++i)
+    REQUIRE(gradientWith[i] == Approx(gradient[i]).margin(1e-10));
+
+  // A mini-batch with all the points is the whole objective.
+  arma::mat batchGradient;
+  REQUIRE(saf.Evaluate(parameters, 0, data.n_cols) ==
+      Approx(cost).epsilon(1e-7));
+  saf.Gradient(parameters, 0, batchGradient, data.n_cols);
+  for (size_t i = 0; i < gradient.n_elem; ++i)
+    REQUIRE(batchGradient[i] == Approx(gradient[i]).margin(1e-10));
+
+  // A mini-batch is the objective of a function on those points only.
+  SparseAutoencoderFunction safBatch(data.cols(5, 9), vSize, hSize, 0.01, 0.5,
+      0.1);
+  REQUIRE(saf.EvaluateWithGradient(parameters, 5, batchGradient, 5) ==
+      Approx(safBatch.Evaluate(parameters)).epsilon(1e-7));
+  safBatch.Gradient(parameters, gradient);
+  for (size_t i = 0; i < gradient.n_elem; ++i)
+    REQUIRE(batchGradient[i] == Approx(gradient[i]).margin(1e-10));
+
+  // Shuffling doesn't change the objective on the whole dataset.
+  saf.Shuffle();
+  REQUIRE(saf.Evaluate(parameters) == Approx(cost).epsilon(1e-7));
+}
@@ -304,3 +304,37 @@ TEST_CASE("SpillTreeMoveDatasetTest", "[SpillTreeTest]")
   REQUIRE(tree.Dataset().n_rows == 3);
   REQUIRE(tree.Dataset().n_cols == 1000);
 }
+
+//! Make sure the two spill trees hold the same points in the same nodes.
+template<typename TreeType>
+void CheckSameSpillTree(const TreeType& a, const TreeType& b)
+{
+  REQUIRE(a.NumChildren() == b.NumChildren());
+  REQUIRE(a.NumPoints() == b.NumPoints());
+  REQUIRE(a.NumDescendants() == b.NumDescendants());
+  REQUIRE(a.Overlap() == b.Overlap());
+  for (size_t i = 0; i < a.NumDescendants(); ++i)
+    REQUIRE(a.Descendant(i) == b.Descendant(i));
+
+  for (size_t i = 0; i < a.NumChildren(); ++i)
+    CheckSameSpillTree(a.Child(i), b.Child(i));
+}
+
+/**
+ * Make sure that building a spill tree in parallel gives exactly the same tree
+ * as building it serially.
+ */
+TEST_CASE("SpillTreeParallelBuildTest", "[SpillTreeTest]")
+{
+  arma::mat dataset = arma::randu<arma::mat>(3, 5000);
+  typedef SPTree<EuclideanDistance, EmptyStatistic, arma::mat> TreeType;
+  const size_t oldThreshold = TreeType::ParallelBuildThreshold();
+
+  TreeType::ParallelBuildThreshold() = std::numeric_limits<size_t>::max();
+  TreeType serialTree(dataset, 0.05);
+  TreeType::ParallelBuildThreshold() = 50;
+  TreeType parallelTree(dataset, 0.05);
+  TreeType::ParallelBuildThreshold() = oldThreshold;
+
+  CheckSameSpillTree(serialTree, parallelTree);
+}
@@ -212,3 +212,89 @@ TEST_CASE("SplitLabeledDataLargerTest", "[SplitDataTest]")
 
   CheckDuplication(std::get<2>(value), std::get<3>(value));
 }
+
+/**
+ * Make sure SplitIndices() gives the same split as Split() for the same seed.
+ */
+TEST_CASE("SplitIndicesTest", "[SplitDataTest]")
+{
+  mat input(3, 497);
+  input.randu();
+
+  math::RandomSeed(42);
+  const auto value = Split(input, 0.3);
+
+  math::RandomSeed(42);
+  uvec trainIndices, testIndices;
+  SplitIndices(input.n_cols, trainIndices, testIndices, 0.3);
+
+  REQUIRE(trainIndices.n_elem == 497 - size_t(0.3 * 497));
+  REQUIRE(testIndices.n_elem == size_t(0.3 * 497));
+  CheckMatrices(std::get<0>(value), mat(input.cols(trainIndices)));
+  CheckMatrices(std::get<1>(value), mat(input.cols(testIndices)));
+}
+
+/**
+ * Make sure SplitInPlace() only reorders the points and their labels.
+ */
+TEST_CASE("SplitInPlaceTest", "[SplitDataTest]")
+{
+  const mat original = randu<mat>(4, 497);
+  mat input(original);
+  Row<size_t> labels = arma::linspace<Row<size_t>>(0, input.n_cols - 1,
+      input.n_cols);
+
+  const size_t trainSize = SplitInPlace(input, labels, 0.3);
+  REQUIRE(trainSize == 497 - size_t(0.3 * 497));
+  REQUIRE(input.n_cols == 497);
+
+  // Each point is still with its label, and no point is duplicated.
+  CompareData(original, input, labels);
+  CheckDuplication(Row<size_t>(labels.subvec(0, trainSize - 1)),
+      Row<size_t>(labels.subvec(trainSize, labels.n_elem - 1)));
+
+  // Without shuffling, nothing moves.
+  mat unshuffled(original);
+  REQUIRE(SplitInPlace(unshuffled, 0.3, false) == trainSize);
+  CheckMatrices(original, unshuffled);
+}
+
+/**
+ * Make sure StratifiedSplitInPlace() splits each class with the given ratio.
+ */
+TEST_CASE("StratifiedSplitInPlaceTest", "[SplitDataTest]")
+{
+  // Three classes of different sizes; the first row holds the original index.
+  Row<size_t> labels(600);
+  labels.subvec(0, 99).fill(0);
+  labels.subvec(100, 399).fill(1);
+  labels.subvec(400, 599).fill(2);
+  mat input(2, 600);
+  input.row(0) = arma::linspace<rowvec>(0, 599, 600);
+  input.row(1) = conv_to<rowvec>::from(labels);
+
+  for (const bool shuffle : { true, false })
+  {
+    mat data(input);
+    Row<size_t> dataLabels(labels);
+    const size_t trainSize = StratifiedSplitInPlace(data, dataLabels, 0.25,
+        shuffle);
+    REQUIRE(trainSize == 75 + 225 + 150);
+
+    // The labels still match the points.
+    for (size_t i = 0; i < data.n_cols; ++i)
+      REQUIRE(size_t(data(1, i)) == dataLabels[i]);
+
+    const Row<size_t> trainLabels = dataLabels.subvec(0, trainSize - 1);
+    const Row<size_t> testLabels = dataLabels.subvec(trainSize, 599);
+    REQUIRE(accu(testLabels == 0) == 25);
+    REQUIRE(accu(testLabels == 1) == 75);
+    REQUIRE(accu(testLabels == 2) == 50);
+    REQUIRE(accu(trainLabels == 1) == 225);
+
+    // No point is lost or duplicated.
+    const Row<size_t> indices = conv_to<Row<size_t>>::from(data.row(0));
+    CheckDuplication(Row<size_t>(indices.subvec(0, trainSize - 1)),
+        Row<size_t>(indices.subvec(trainSize, 599)));
+  }
+}
@@ -18,6 +18,7 @@
 #include <mlpack/core/data/string_encoding_policies/dictionary_encoding_policy.hpp>
 #include <mlpack/core/data/string_encoding_policies/bag_of_words_encoding_policy.hpp>
 #include <mlpack/core/data/string_encoding_policies/tf_idf_encoding_policy.hpp>
+#include <mlpack/core/data/hashing_encoding.hpp>
 #include <boost/test/unit_test.hpp>
 #include <memory>
 #include "test_catch_tools.hpp"
@@ -1423,3 +1424,184 @@ TEST_CASE("SplitByAnyOfTfIdfEncodingSerialization", "[StringEncodingTest]")
 
   CheckMatrices(output, xmlOutput, textOutput, binaryOutput);
 }
+
+/**
+ * Test that encoding a large corpus labels the tokens in the order they first
+ * appear, and that sparse and dense outputs hold the same values.
+ */
+TEST_CASE("LargeCorpusSparseEncodingTest", "[StringEncodingTest]")
+{
+  using DictionaryType = StringEncodingDictionary<boost::string_view>;
+
+  // Build lines out of the words of the usual input, with new words showing up
+  // all through the corpus.
+  std::vector<std::string> words;
+  SplitByAnyOf tokenizer(" ,.");
+  for (const std::string& line : stringEncodingInput)
+  {
+    boost::string_view strView(line);
+    boost::string_view token = tokenizer(strView);
+    while (!tokenizer.IsTokenEmpty(token))
+    {
+      words.push_back(token.to_string());
+      token = tokenizer(strView);
+    }
+  }
+
+  std::vector<std::string> input(5000);
+  for (size_t i = 0; i < input.size(); ++i)
+  {
+    for (size_t j = 0; j < 1 + i % 7; ++j)
+      input[i] += words[(i * 13 + j * 7) % words.size()] + " ";
+    input[i] += "word" + std::to_string(i / 10);
+  }
+
+  // Find the expected labels.
+  std::unordered_map<std::string, size_t> labels;
+  for (const std::string& line : input)
+  {
+    boost::string_view strView(line);
+    boost::string_view token = tokenizer(strView);
+    while (!tokenizer.IsTokenEmpty(token))
+    {
+      const size_t label = labels.size() + 1;
+      if (labels.count(token.to_string()) == 0)
+        labels[token.to_string()] = label;
+      token = tokenizer(strView);
+    }
+  }
+
+  arma::mat output;
+  arma::sp_mat sparseOutput;
+  BagOfWordsEncoding<SplitByAnyOf::TokenType> encoder;
+  encoder.Encode(input, output, tokenizer);
+  BagOfWordsEncoding<SplitByAnyOf::TokenType> sparseEncoder;
+  sparseEncoder.Encode(input, sparseOutput, tokenizer);
+
+  const DictionaryType& dictionary = encoder.Dictionary();
+  REQUIRE(dictionary.Size() == labels.size());
+  for (const std::pair<const std::string, size_t>& label : labels)
+  {
+    REQUIRE(dictionary.Value(label.first) == label.second);
+    REQUIRE(sparseEncoder.Dictionary().Value(label.first) == label.second);
+  }
+
+  REQUIRE(output.n_rows == labels.size());
+  REQUIRE(output.n_cols == input.size());
+  CheckMatrices(output, arma::mat(sparseOutput));
+
+  TfIdfEncoding<SplitByAnyOf::TokenType> tfIdfEncoder;
+  tfIdfEncoder.Encode(input, output, tokenizer);
+  TfIdfEncoding<SplitByAnyOf::TokenType> sparseTfIdfEncoder;
+  sparseTfIdfEncoder.Encode(input, sparseOutput, tokenizer);
+  CheckMatrices(output, arma::mat(sparseOutput));
+
+  DictionaryEncoding<SplitByAnyOf::TokenType> dictionaryEncoder;
+  dictionaryEncoder.Encode(input, output, tokenizer);
+  DictionaryEncoding<SplitByAnyOf::TokenType> sparseDictionaryEncoder;
+  sparseDictionaryEncoder.Encode(input, sparseOutput, tokenizer);
+  REQUIRE(output.n_rows == 7 + 1);
+  CheckMatrices(output, arma::mat(sparseOutput));
+}
+
+/**
+ * Make sure that the hashing encoding counts every token once, and gives the
+ * same row to the same tokens.
+ */
+TEST_CASE("HashingEncodingTest", "[StringEncodingTest]")
+{
+  HashingEncoding encoder(1 << 16, false);
+  SplitByAnyOf tokenizer(" .,\"");
+  arma::sp_mat output;
+
+  encoder.Encode(stringEncodingInput, output, tokenizer);
+
+  REQUIRE(output.n_rows == (1 << 16));
+  REQUIRE(output.n_cols == stringEncodingInput.size());
+
+  // Without the alternate sign, each column sums to its number of tokens.
+  BagOfWordsEncoding<SplitByAnyOf::TokenType> bagOfWords;
+  arma::mat counts;
+  bagOfWords.Encode(stringEncodingInput, counts, tokenizer);
+  for (size_t i = 0; i < output.n_cols; ++i)
+    REQUIRE(arma::accu(output.col(i)) == Approx(arma::accu(counts.col(i))));
+
+  // Encoding a single token gives its row.
+  arma::sp_mat machine, twice;
+  encoder.Encode({ "machine" }, machine, tokenizer);
+  encoder.Encode({ "machine machine" }, twice, tokenizer);
+  REQUIRE(machine.n_nonzero == 1);
+  const size_t row = machine.begin().row();
+  REQUIRE((double) twice(row, 0) == Approx(2.0));
+
+  // "machine" appears once in the first line, and three times in the second.
+  REQUIRE((double) output(row, 0) >= 1.0);
+  REQUIRE((double) output(row, 1) >= 3.0);
+}
+
+/**
+ * Make sure that the alternate sign keeps the magnitudes of the counts.
+ */
+TEST_CASE("HashingEncodingAlternateSignTest", "[StringEncodingTest]")
+{
+  HashingEncoding encoder(1 << 20);
+  CharExtract tokenizer;
+  arma::sp_mat output;
+
+  encoder.Encode({ "aab", "b" }, output, tokenizer);
+
+  arma::sp_mat a, b;
+  encoder.Encode({ "a" }, a, tokenizer);
+  encoder.Encode({ "b" }, b, tokenizer);
+  REQUIRE(a.n_nonzero == 1);
+  REQUIRE(b.n_nonzero == 1);
+
+  const size_t rowA = a.begin().row();
+  const size_t rowB = b.begin().row();
+  REQUIRE(rowA != rowB);
+  REQUIRE((double) output(rowA, 0) == Approx(2.0 * (double) a(rowA, 0)));
+  REQUIRE((double) output(rowB, 0) == Approx((double) b(rowB, 0)));
+  REQUIRE((double) output(rowB, 1) == Approx((double) b(rowB, 0)));
+  REQUIRE(std::abs((double) a(rowA, 0)) == Approx(1.0));
+}
+
+/**
+ * Make sure that the same categorical value in two fields gives two different
+ * features.
+ */
+TEST_CASE("HashingEncodingCategoricalTest", "[StringEncodingTest]")
+{
+  HashingEncoding encoder(1 << 20, false);
+  arma::sp_mat output;
+
+  encoder.Encode({ { "red", "red" }, { "red", "blue" } }, output);
+
+  REQUIRE(output.n_rows == (1 << 20));
+  REQUIRE(output.n_cols == 2);
+  REQUIRE(arma::accu(output.col(0)) == Approx(2.0));
+  REQUIRE(arma::accu(output.col(1)) == Approx(2.0));
+
+  // The two fields of the first item are different features, and the first
+  // field of both items is the same feature.
+  REQUIRE(output.col(0).n_nonzero == 2);
+  REQUIRE(output.col(1).n_nonzero == 2);
+  REQUIRE(arma::accu(output.col(0) % output.col(1)) == Approx(1.0));
+}
+
+/**
+ * Serialization test for the hashing encoding.
+ */
+TEST_CASE("HashingEncodingSerialization", "[StringEncodingTest]")
+{
+  HashingEncoding encoder(1000, false);
+  HashingEncoding xmlEncoder, textEncoder, binaryEncoder;
+
+  SerializeObjectAll(encoder, xmlEncoder, textEncoder, binaryEncoder);
+
+  REQUIRE(xmlEncoder.Dimensionality() == 1000);
+  REQUIRE(textEncoder.Dimensionality() == 1000);
+  REQUIRE(binaryEncoder.Dimensionality() == 1000);
+  REQUIRE(xmlEncoder.AlternateSign() == false);
+  REQUIRE(textEncoder.AlternateSign() == false);
+  REQUIRE(binaryEncoder.AlternateSign() == false);
+}
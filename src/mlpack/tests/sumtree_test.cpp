@@ -88,3 +88,39 @@ TEST_CASE("BatchUpdate", "[SumTreeTest]")
   CHECK(sumtree.FindPrefixSum(2.8) <= 3);
   CHECK(sumtree.FindPrefixSum(3.0) <= 3);
 }
+
+/**
+ * Test that a batch update of some of the elements gives the same tree as
+ * setting them one by one, and that the batch search over many masses gives
+ * the indices of the search over each mass.
+ */
+TEST_CASE("BatchFindPrefixSum", "[SumTreeTest]")
+{
+  SumTree<double> sumtree(64), reference(64);
+  for (size_t i = 0; i < 50; ++i)
+  {
+    sumtree.Set(i, 1.0 + i % 5);
+    reference.Set(i, 1.0 + i % 5);
+  }
+
+  arma::ucolvec indices = {3, 17, 49, 17};
+  arma::colvec data = {0.5, 2.5, 7.0, 4.0};
+  sumtree.BatchUpdate(indices, data);
+  for (size_t i = 0; i < indices.n_elem; ++i)
+    reference.Set(indices[i], data[i]);
+
+  REQUIRE(sumtree.Sum() == Approx(reference.Sum()).epsilon(1e-10));
+  for (size_t i = 0; i < 64; i += 7)
+  {
+    REQUIRE(sumtree.Sum(i, 64) ==
+        Approx(reference.Sum(i, 64)).epsilon(1e-10));
+  }
+
+  arma::colvec masses = arma::randu<arma::colvec>(100) * sumtree.Sum();
+  arma::ucolvec found;
+  sumtree.FindPrefixSum(masses, found);
+
+  REQUIRE(found.n_elem == masses.n_elem);
+  for (size_t i = 0; i < masses.n_elem; ++i)
+    REQUIRE(found[i] == sumtree.FindPrefixSum(masses[i]));
+}
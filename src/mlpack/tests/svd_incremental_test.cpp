@@ -2,8 +2,8 @@
  * @file tests/svd_incremental_test.cpp
  * @author Sumedh Ghaisas
  *
- * Tests for SVDIncompleteIncrementalLearning and
- * SVDCompleteIncrementalLearning.
+ * Tests for SVDIncompleteIncrementalLearning, SVDCompleteIncrementalLearning
+ * and SVDParallelIncrementalLearning.
  *
  * mlpack is free software; you may redistribute it and/or modify it under the
  * terms of the 3-clause BSD license.  You should have received a copy of the
@@ -14,10 +14,12 @@
 #include <mlpack/methods/amf/amf.hpp>
 #include <mlpack/methods/amf/update_rules/svd_incomplete_incremental_learning.hpp>
 #include <mlpack/methods/amf/update_rules/svd_complete_incremental_learning.hpp>
+#include <mlpack/methods/amf/update_rules/svd_parallel_incremental_learning.hpp>
 #include <mlpack/methods/amf/init_rules/random_init.hpp>
 #include <mlpack/methods/amf/termination_policies/incomplete_incremental_termination.hpp>
 #include <mlpack/methods/amf/termination_policies/complete_incremental_termination.hpp>
 #include <mlpack/methods/amf/termination_policies/simple_tolerance_termination.hpp>
+#include <mlpack/methods/amf/termination_policies/max_iteration_termination.hpp>
 #include <mlpack/methods/amf/termination_policies/validation_rmse_termination.hpp>
 
 #include "catch.hpp"
@@ -142,3 +144,50 @@ TEST_CASE("SVDIncompleteIncrementalRegularizationTest", "[SVDIncrementalTest]")
 
   REQUIRE(regularizedRMSE < regularRMSE + 0.105);
 }
+
+/**
+ * Make sure that the parallel incremental learning fits the observed entries of
+ * a low-rank matrix, with both schedules.
+ */
+TEST_CASE("SVDParallelIncrementalFitTest", "[SVDIncrementalTest]")
+{
+  const mat w = randu<mat>(100, 2);
+  const mat h = randu<mat>(2, 80);
+  const mat full = w * h;
+
+  // Keep about a quarter of the entries.
+  sp_mat data(100, 80);
+  for (size_t j = 0; j < full.n_cols; ++j)
+    for (size_t i = 0; i < full.n_rows; ++i)
+      if (math::Random() < 0.25)
+        data(i, j) = full(i, j);
+
+  const SGDSchedule::Mode modes[] = { SGDSchedule::STRATIFIED,
+      SGDSchedule::HOGWILD };
+  for (const SGDSchedule::Mode mode : modes)
+  {
+    SpecificRandomInitialization sri(data.n_rows, 2, data.n_cols);
+    AMF<MaxIterationTermination, SpecificRandomInitialization,
+        SVDParallelIncrementalLearning> amf(MaxIterationTermination(300), sri,
+        SVDParallelIncrementalLearning(0.02, 0, 0, mode, 4));
+
+    mat m1, m2;
+    sri.Initialize(data, 2, m1, m2);
+    double initialError = 0.0, finalError = 0.0;
+    for (sp_mat::const_iterator it = data.begin(); it != data.end(); ++it)
+    {
+      const double e = *it - dot(m1.row(it.row()), m2.col(it.col()));
+      initialError += e * e;
+    }
+
+    amf.Apply(data, 2, m1, m2);
+    REQUIRE(amf.TerminationPolicy().Iteration() == 300);
+    for (sp_mat::const_iterator it = data.begin(); it != data.end(); ++it)
+    {
+      const double e = *it - dot(m1.row(it.row()), m2.col(it.col()));
+      finalError += e * e;
+    }
+
+    REQUIRE(finalError < 0.1 * initialError);
+  }
+}
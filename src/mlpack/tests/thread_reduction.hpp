@@ -0,0 +1,134 @@
+/**
+ * @file tests/thread_reduction.hpp
+ *
+ * A reduction over threads, which stands for the processes of a distributed
+ * job in the tests of DistributedKMeans and DistributedEMFit.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_TESTS_THREAD_REDUCTION_HPP
+#define MLPACK_TESTS_THREAD_REDUCTION_HPP
+
+#include <mlpack/core.hpp>
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+/**
+ * A reduction over the threads started by ThreadReduction::Run(); the rank of
+ * each thread is its index.  Every thread obtains the same sums (so the
+ * threads stay in step even though the order of the additions varies).
+ * Several groups of threads can run at the same time, each with the
+ * reductions of its own group, like MPI processes with several communicators.
+ */
+class ThreadReduction
+{
+ public:
+  //! The number of groups of threads.
+  static const size_t MaxGroups = 4;
+
+  //! Create a reduction over the threads of the given group.
+  ThreadReduction(const size_t group = 0) : group(group) { }
+
+  //! Replace the given values with their sum over all threads.
+  void Sum(double* values, const size_t n) const
+  {
+    State& state = GetState(group);
+    std::unique_lock<std::mutex> lock(state.mutex);
+    if (state.arrived == 0)
+      state.sums.assign(n, 0.0);
+    for (size_t i = 0; i < n; ++i)
+      state.sums[i] += values[i];
+
+    // The last thread to arrive publishes the sums and wakes the others; the
+    // next sums can only be published once every thread has arrived again,
+    // so the published sums stay valid until they are all copied.
+    const size_t generation = state.generation;
+    if (++state.arrived == state.threads)
+    {
+      state.result.swap(state.sums);
+      state.arrived = 0;
+      ++state.generation;
+      state.condition.notify_all();
+    }
+    else
+    {
+      state.condition.wait(lock,
+          [&]() { return state.generation != generation; });
+    }
+
+    std::copy(state.result.begin(), state.result.begin() + n, values);
+  }
+
+  //! Replace the given values with those of the first thread.
+  void Broadcast(double* values, const size_t n) const
+  {
+    if (Rank() != 0)
+      std::fill(values, values + n, 0.0);
+    Sum(values, n);
+  }
+
+  //! Get the rank of the calling thread.
+  static size_t& Rank()
+  {
+    static thread_local size_t rank = 0;
+    return rank;
+  }
+
+  //! Get the group of the threads this reduction is over.
+  size_t Group() const { return group; }
+
+  /**
+   * Call the given function with each rank in [0, threads), each in its own
+   * thread of the given group, and wait for all of them.
+   */
+  template<typename FunctionType>
+  static void Run(const size_t threads,
+                  FunctionType function,
+                  const size_t group = 0)
+  {
+    GetState(group).threads = threads;
+    GetState(group).arrived = 0;
+
+    std::vector<std::thread> workers;
+    for (size_t r = 0; r < threads; ++r)
+    {
+      workers.push_back(std::thread([r, &function]()
+      {
+        Rank() = r;
+        function(r);
+      }));
+    }
+
+    for (size_t r = 0; r < threads; ++r)
+      workers[r].join();
+  }
+
+ private:
+  //! The state shared by all threads.
+  struct State
+  {
+    std::mutex mutex;
+    std::condition_variable condition;
+    size_t threads = 1;
+    size_t arrived = 0;
+    size_t generation = 0;
+    std::vector<double> sums;
+    std::vector<double> result;
+  };
+
+  static State& GetState(const size_t group)
+  {
+    static State states[MaxGroups];
+    return states[group];
+  }
+
+  //! The group of the threads.
+  size_t group;
+};
+
+#endif
@@ -0,0 +1,105 @@
+/**
+ * @file tests/threads_test.cpp
+ *
+ * Tests for util::Threads() and util::ThreadLimit.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+
+#include <thread>
+
+#include "catch.hpp"
+
+using namespace mlpack;
+using namespace mlpack::util;
+
+/**
+ * Count the threads that run a parallel region started by the calling thread.
+ */
+size_t CountThreads()
+{
+  size_t threads = 0;
+  #pragma omp parallel reduction(+:threads)
+  threads += 1;
+  return threads;
+}
+
+/**
+ * Make sure that explicit requests are returned as-is, and that the default
+ * is the number of threads of a parallel region.
+ */
+TEST_CASE("ThreadsRequestTest", "[ThreadsTest]")
+{
+#ifdef HAS_OPENMP
+  REQUIRE(Threads(3) == 3);
+  REQUIRE(Threads() == (size_t) omp_get_max_threads());
+#else
+  REQUIRE(Threads(3) == 1);
+  REQUIRE(Threads() == 1);
+#endif
+
+  REQUIRE(Threads() >= 1);
+  REQUIRE(CountThreads() <= Threads());
+}
+
+/**
+ * Make sure that nested limits apply to parallel regions and are restored.
+ */
+TEST_CASE("ThreadLimitScopeTest", "[ThreadsTest]")
+{
+  const size_t defaultThreads = Threads();
+  {
+    ThreadLimit limit(2);
+#ifdef HAS_OPENMP
+    REQUIRE(Threads() == 2);
+#endif
+    REQUIRE(CountThreads() <= 2);
+
+    {
+      ThreadLimit innerLimit(1);
+      REQUIRE(Threads() == 1);
+      REQUIRE(CountThreads() == 1);
+
+      // A limit of 0 leaves the limit unchanged.
+      ThreadLimit noLimit(0);
+      REQUIRE(Threads() == 1);
+    }
+
+#ifdef HAS_OPENMP
+    REQUIRE(Threads() == 2);
+#endif
+  }
+
+  REQUIRE(Threads() == defaultThreads);
+}
+
+/**
+ * Make sure that the limits of different threads are independent.
+ */
+TEST_CASE("ThreadLimitPerThreadTest", "[ThreadsTest]")
+{
+  const size_t defaultThreads = Threads();
+  size_t threads[2] = { 0, 0 };
+
+  std::vector<std::thread> workers;
+  for (size_t t = 0; t < 2; ++t)
+  {
+    workers.push_back(std::thread([t, &threads]()
+    {
+      ThreadLimit limit(t + 1);
+      threads[t] = Threads();
+    }));
+  }
+  for (size_t t = 0; t < 2; ++t)
+    workers[t].join();
+
+#ifdef HAS_OPENMP
+  REQUIRE(threads[0] == 1);
+  REQUIRE(threads[1] == 2);
+#endif
+  REQUIRE(Threads() == defaultThreads);
+}
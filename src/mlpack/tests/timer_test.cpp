@@ -147,4 +147,81 @@ BOOST_AUTO_TEST_CASE(DisabledTimingTest)
   BOOST_REQUIRE(Timer::Get("test_timer") == std::chrono::microseconds(0));
 }
 
+//! Recurse with a profiled scope.
+static size_t ProfiledRecursion(const size_t depth)
+{
+  MLPACK_PROFILE_SCOPE("profiler_test_recursion");
+  return (depth == 0) ? 0 : 1 + ProfiledRecursion(depth - 1);
+}
+
+//! Enter nested profiled scopes the given number of times.
+static void ProfiledLoop(const size_t iterations)
+{
+  for (size_t i = 0; i < iterations; ++i)
+  {
+    MLPACK_PROFILE_SCOPE("profiler_test_outer");
+    {
+      MLPACK_PROFILE_SCOPE("profiler_test_inner");
+      ProfiledRecursion(3);
+    }
+  }
+}
+
+//! Find the top-level scope with the given name.
+static const Profiler::Node* FindScope(const Profiler::Node& root,
+                                       const std::string& name)
+{
+  for (const Profiler::Node& child : root.children)
+    if (child.name == name)
+      return &child;
+  return NULL;
+}
+
+/**
+ * Make sure the profiler counts the calls of nested scopes, merges the threads,
+ * and doesn't record anything when it is disabled.
+ */
+BOOST_AUTO_TEST_CASE(ProfilerTest)
+{
+  Profiler::Disable();
+  Profiler::Reset();
+  ProfiledLoop(10);
+  const Profiler::Node* outer = FindScope(Profiler::Report(),
+      "profiler_test_outer");
+  BOOST_REQUIRE(outer == NULL || outer->calls == 0);
+
+  Profiler::Enable();
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < 3; ++i)
+    threads.push_back(std::thread(ProfiledLoop, 100));
+  for (size_t i = 0; i < 3; ++i)
+    threads[i].join();
+  Profiler::Disable();
+
+  const Profiler::Node root = Profiler::Report();
+  outer = FindScope(root, "profiler_test_outer");
+  BOOST_REQUIRE(outer != NULL);
+  BOOST_REQUIRE_EQUAL(outer->calls, 300U);
+  BOOST_REQUIRE_EQUAL(outer->threads, 3U);
+  BOOST_REQUIRE_EQUAL(outer->children.size(), 1U);
+
+  const Profiler::Node& inner = outer->children[0];
+  BOOST_REQUIRE_EQUAL(inner.name, "profiler_test_inner");
+  BOOST_REQUIRE_EQUAL(inner.calls, 300U);
+  BOOST_REQUIRE(inner.time <= outer->time);
+
+  // The recursive calls are counted by the outermost call of the scope.
+  BOOST_REQUIRE_EQUAL(inner.children.size(), 1U);
+  BOOST_REQUIRE_EQUAL(inner.children[0].calls, 1200U);
+  BOOST_REQUIRE(inner.children[0].children.empty());
+
+  const std::string json = Profiler::ToJSON();
+  BOOST_REQUIRE(json.find("\"name\": \"profiler_test_inner\"") !=
+      std::string::npos);
+
+  Profiler::Reset();
+  outer = FindScope(Profiler::Report(), "profiler_test_outer");
+  BOOST_REQUIRE_EQUAL(outer->calls, 0U);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -15,6 +15,9 @@
 #include <mlpack/core/metrics/mahalanobis_distance.hpp>
 #include <mlpack/core/tree/cover_tree/cover_tree.hpp>
 #include <mlpack/core/tree/rectangle_tree.hpp>
+#include <mlpack/core/data/mapped_matrix.hpp>
+#include <boost/archive/binary_iarchive.hpp>
+#include <boost/archive/binary_oarchive.hpp>
 
 #include <queue>
 #include <stack>
@@ -1040,6 +1043,86 @@ TEST_CASE("HRectBoundDiameter", "[TreeTest]")
   REQUIRE(d.Diameter() == Approx(0.0).margin(1e-5));
 }
 
+/**
+ * Ensure that the batch distances of HRectBound are the same as the distances
+ * to each bound, and that those match distances computed by hand.
+ */
+TEST_CASE("HRectBoundBatchDistances", "[TreeTest]")
+{
+  const size_t dim = 7;
+  HRectBound<EuclideanDistance> b(dim);
+  b |= arma::randu<arma::mat>(dim, 5);
+
+  // Some of the other bounds overlap this one, and some of them do not.
+  std::vector<HRectBound<EuclideanDistance>> others(10,
+      HRectBound<EuclideanDistance>(dim));
+  std::vector<const HRectBound<EuclideanDistance>*> pointers;
+  for (size_t j = 0; j < others.size(); ++j)
+  {
+    others[j] |= arma::randu<arma::mat>(dim, 3) + 0.3 * j;
+    pointers.push_back(&others[j]);
+  }
+
+  arma::vec minDistances, rangeMin, rangeMax;
+  b.MinDistance(pointers, minDistances);
+  b.RangeDistance(pointers, rangeMin, rangeMax);
+
+  REQUIRE(minDistances.n_elem == others.size());
+  REQUIRE(rangeMin.n_elem == others.size());
+  REQUIRE(rangeMax.n_elem == others.size());
+  for (size_t j = 0; j < others.size(); ++j)
+  {
+    double minSum = 0.0, maxSum = 0.0;
+    for (size_t d = 0; d < dim; ++d)
+    {
+      const double lo = std::max(0.0, std::max(others[j][d].Lo() - b[d].Hi(),
+          b[d].Lo() - others[j][d].Hi()));
+      const double hi = std::max(others[j][d].Hi() - b[d].Lo(),
+          b[d].Hi() - others[j][d].Lo());
+      minSum += lo * lo;
+      maxSum += hi * hi;
+    }
+
+    REQUIRE(b.MinDistance(others[j]) ==
+        Approx(std::sqrt(minSum)).margin(1e-10));
+    REQUIRE(b.MaxDistance(others[j]) ==
+        Approx(std::sqrt(maxSum)).epsilon(1e-10));
+    REQUIRE(minDistances[j] == Approx(b.MinDistance(others[j])).margin(1e-10));
+    REQUIRE(rangeMin[j] ==
+        Approx(b.RangeDistance(others[j]).Lo()).margin(1e-10));
+    REQUIRE(rangeMax[j] ==
+        Approx(b.RangeDistance(others[j]).Hi()).epsilon(1e-10));
+    REQUIRE(rangeMax[j] == Approx(b.MaxDistance(others[j])).epsilon(1e-10));
+  }
+}
+
+/**
+ * Ensure that the batch distances of BallBound are the same as the distances
+ * to each bound.
+ */
+TEST_CASE("BallBoundBatchDistances", "[TreeTest]")
+{
+  BallBound<> b(0.5, arma::vec("0 0 0"));
+  std::vector<BallBound<>> others;
+  for (size_t j = 0; j < 5; ++j)
+    others.push_back(BallBound<>(0.2, arma::vec(3).fill(0.3 * j)));
+
+  std::vector<const BallBound<>*> pointers;
+  for (size_t j = 0; j < others.size(); ++j)
+    pointers.push_back(&others[j]);
+
+  arma::vec minDistances, rangeMin, rangeMax;
+  b.MinDistance(pointers, minDistances);
+  b.RangeDistance(pointers, rangeMin, rangeMax);
+
+  for (size_t j = 0; j < others.size(); ++j)
+  {
+    REQUIRE(minDistances[j] == Approx(b.MinDistance(others[j])).margin(1e-10));
+    REQUIRE(rangeMin[j] == Approx(b.MinDistance(others[j])).margin(1e-10));
+    REQUIRE(rangeMax[j] == Approx(b.MaxDistance(others[j])).epsilon(1e-10));
+  }
+}
+
 /**
  * It seems as though Bill has stumbled across a bug where
  * BinarySpaceTree<>::count() returns something different than
@@ -1665,6 +1748,100 @@ TEST_CASE("BallTreeTest", "[TreeTest]")
   }
 }
 
+//! Ensure that two trees have exactly the same structure and bounds.
+template<typename TreeType, typename OtherTreeType>
+void CheckSameTree(const TreeType& a, const OtherTreeType& b)
+{
+  REQUIRE(a.Begin() == b.Begin());
+  REQUIRE(a.Count() == b.Count());
+  REQUIRE(a.NumChildren() == b.NumChildren());
+  REQUIRE(a.FurthestDescendantDistance() == b.FurthestDescendantDistance());
+  REQUIRE(a.ParentDistance() == b.ParentDistance());
+
+  arma::vec aCenter, bCenter;
+  a.Center(aCenter);
+  b.Center(bCenter);
+  REQUIRE(arma::all(aCenter == bCenter));
+
+  for (size_t i = 0; i < a.NumChildren(); ++i)
+    CheckSameTree(a.Child(i), b.Child(i));
+}
+
+//! Build a tree serially and in parallel, and make sure nothing differs.
+template<typename TreeType>
+void CheckParallelBuild(const arma::mat& dataset)
+{
+  const size_t oldThreshold = TreeType::ParallelBuildThreshold();
+
+  std::vector<size_t> serialOldFromNew, parallelOldFromNew;
+  TreeType::ParallelBuildThreshold() = std::numeric_limits<size_t>::max();
+  TreeType serialTree(dataset, serialOldFromNew);
+  TreeType::ParallelBuildThreshold() = 50;
+  TreeType parallelTree(dataset, parallelOldFromNew);
+  TreeType::ParallelBuildThreshold() = oldThreshold;
+
+  REQUIRE(serialOldFromNew == parallelOldFromNew);
+  REQUIRE(arma::all(arma::vectorise(serialTree.Dataset() ==
+      parallelTree.Dataset())));
+  CheckSameTree(serialTree, parallelTree);
+}
+
+/**
+ * Make sure that building KD-trees and ball trees in parallel gives exactly the
+ * same tree (and permutation) as building them serially.
+ */
+TEST_CASE("BinarySpaceTreeParallelBuildTest", "[TreeTest]")
+{
+  arma::mat dataset(4, 5000, arma::fill::randu);
+
+  CheckParallelBuild<KDTree<EuclideanDistance, EmptyStatistic, arma::mat>>(
+      dataset);
+  CheckParallelBuild<BallTree<EuclideanDistance, EmptyStatistic, arma::mat>>(
+      dataset);
+  CheckParallelBuild<BinarySpaceTree<EuclideanDistance, EmptyStatistic,
+      arma::mat, HRectBound, MeanSplit>>(dataset);
+}
+
+/**
+ * Make sure that a tree saved with SaveStructure() can be loaded on top of a
+ * memory-mapped dataset without copying it.
+ */
+TEST_CASE("BinarySpaceTreeMappedStructureTest", "[TreeTest]")
+{
+  typedef KDTree<EuclideanDistance, EmptyStatistic, arma::mat> TreeType;
+
+  arma::mat dataset(5, 1000, arma::fill::randu);
+  TreeType tree(dataset);
+
+  REQUIRE(data::SaveMapped("tree_mapped.bin", tree.Dataset()) == true);
+  std::ostringstream oss;
+  {
+    boost::archive::binary_oarchive boa(oss);
+    tree.SaveStructure(boa);
+  }
+
+  {
+    data::MappedMatrix<double> mapped("tree_mapped.bin");
+    std::istringstream iss(oss.str());
+    boost::archive::binary_iarchive bia(iss);
+    TreeType loadedTree(bia, mapped.Alias());
+
+    REQUIRE(loadedTree.Dataset().memptr() == mapped.Matrix().memptr());
+    CheckMatrices(loadedTree.Dataset(), tree.Dataset());
+    CheckSameTree(tree, loadedTree);
+  }
+
+  // A dataset that is too small can't be used.
+  {
+    std::istringstream iss(oss.str());
+    boost::archive::binary_iarchive bia(iss);
+    REQUIRE_THROWS_AS(TreeType(bia, new arma::mat(5, 10, arma::fill::randu)),
+        std::invalid_argument);
+  }
+
+  remove("tree_mapped.bin");
+}
+
 /**
  * Ensure that we can build a ball tree with a custom instantiated metric type.
  */
@@ -1806,6 +1983,114 @@ TEST_CASE("BinarySpaceTreeMoveConstructorTest", "[TreeTest]")
   REQUIRE(tree2.NumChildren() == 2);
 }
 
+//! Make sure that all the descendants of the root are in its block, in
+//! depth-first order.
+template<typename TreeType>
+void CheckContiguousLayout(const TreeType& root)
+{
+  std::vector<const TreeType*> nodes;
+  std::stack<const TreeType*> stack;
+  stack.push(&root);
+  while (!stack.empty())
+  {
+    const TreeType* node = stack.top();
+    stack.pop();
+    if (node != &root)
+      nodes.push_back(node);
+
+    if (node->Right())
+      stack.push(node->Right());
+    if (node->Left())
+      stack.push(node->Left());
+  }
+
+  const TreeType* block = (const TreeType*) root.NodeAllocator().Nodes();
+  REQUIRE(root.NodeAllocator().NumNodes() == nodes.size());
+  for (size_t i = 0; i < nodes.size(); ++i)
+  {
+    REQUIRE(nodes[i] == block + i);
+    REQUIRE(nodes[i]->NodeAllocator().Nodes() == NULL);
+    REQUIRE(&nodes[i]->Dataset() == &root.Dataset());
+  }
+}
+
+/**
+ * Make sure that a tree with the ContiguousNodeAllocator is the same tree as
+ * with the default allocator, and that its nodes stay packed when the tree is
+ * copied, moved, or loaded.
+ */
+TEST_CASE("BinarySpaceTreeContiguousNodeAllocatorTest", "[TreeTest]")
+{
+  typedef KDTree<EuclideanDistance, EmptyStatistic, arma::mat> TreeType;
+  typedef BinarySpaceTree<EuclideanDistance, EmptyStatistic, arma::mat,
+      HRectBound, MidpointSplit, ContiguousNodeAllocator> ContiguousTreeType;
+
+  arma::mat dataset(4, 3000, arma::fill::randu);
+  std::vector<size_t> oldFromNew, contiguousOldFromNew;
+  TreeType tree(dataset, oldFromNew, 10);
+  ContiguousTreeType contiguousTree(dataset, contiguousOldFromNew, 10);
+
+  REQUIRE(oldFromNew == contiguousOldFromNew);
+  CheckSameTree(tree, contiguousTree);
+  CheckContiguousLayout(contiguousTree);
+
+  // Copying packs the copy into its own block.
+  ContiguousTreeType copy(contiguousTree);
+  REQUIRE(copy.NodeAllocator().Nodes() !=
+      contiguousTree.NodeAllocator().Nodes());
+  CheckSameTree(tree, copy);
+  CheckContiguousLayout(copy);
+
+  ContiguousTreeType assigned(arma::mat(4, 50, arma::fill::randu));
+  assigned = copy;
+  CheckSameTree(tree, assigned);
+  CheckContiguousLayout(assigned);
+
+  // Moving takes the block.
+  const void* block = copy.NodeAllocator().Nodes();
+  ContiguousTreeType moved(std::move(copy));
+  REQUIRE(moved.NodeAllocator().Nodes() == block);
+  REQUIRE(copy.NodeAllocator().Nodes() == NULL);
+  REQUIRE(copy.NumChildren() == 0);
+  CheckSameTree(tree, moved);
+  CheckContiguousLayout(moved);
+
+  assigned = std::move(moved);
+  REQUIRE(assigned.NodeAllocator().Nodes() == block);
+  REQUIRE(moved.NodeAllocator().Nodes() == NULL);
+  CheckSameTree(tree, assigned);
+  CheckContiguousLayout(assigned);
+
+  // Loading packs the loaded tree, even on top of an existing tree.
+  std::ostringstream oss;
+  {
+    boost::archive::binary_oarchive boa(oss);
+    boa << contiguousTree;
+  }
+
+  {
+    std::istringstream iss(oss.str());
+    boost::archive::binary_iarchive bia(iss);
+    bia >> assigned;
+  }
+  CheckSameTree(tree, assigned);
+  CheckContiguousLayout(assigned);
+
+  std::ostringstream structureStream;
+  {
+    boost::archive::binary_oarchive boa(structureStream);
+    contiguousTree.SaveStructure(boa);
+  }
+
+  {
+    std::istringstream iss(structureStream.str());
+    boost::archive::binary_iarchive bia(iss);
+    ContiguousTreeType loaded(bia, new arma::mat(contiguousTree.Dataset()));
+    CheckSameTree(tree, loaded);
+    CheckContiguousLayout(loaded);
+  }
+}
+
 template<typename TreeType>
 void RecurseTreeCountLeaves(const TreeType& node, arma::vec& counts)
 {
@@ -2122,6 +2407,42 @@ TEST_CASE("CoverTreeMoveDatasetTest", "[TreeTest]")
   REQUIRE(t2.Dataset().n_cols == 1000);
 }
 
+//! Make sure the two cover trees have the same structure.
+template<typename TreeType>
+void CheckSameCoverTree(const TreeType& a, const TreeType& b)
+{
+  REQUIRE(a.Point() == b.Point());
+  REQUIRE(a.Scale() == b.Scale());
+  REQUIRE(a.NumChildren() == b.NumChildren());
+  REQUIRE(a.NumDescendants() == b.NumDescendants());
+  REQUIRE(a.ParentDistance() == b.ParentDistance());
+  REQUIRE(a.FurthestDescendantDistance() == b.FurthestDescendantDistance());
+
+  for (size_t i = 0; i < a.NumChildren(); ++i)
+    CheckSameCoverTree(a.Child(i), b.Child(i));
+}
+
+/**
+ * Make sure that computing the distances in parallel while building a cover
+ * tree gives exactly the same tree.
+ */
+TEST_CASE("CoverTreeParallelBuildTest", "[TreeTest]")
+{
+  typedef StandardCoverTree<EuclideanDistance, EmptyStatistic, arma::mat>
+      TreeType;
+  arma::mat dataset(4, 3000, arma::fill::randu);
+
+  const size_t oldThreshold = TreeType::ParallelBuildThreshold();
+  TreeType::ParallelBuildThreshold() = std::numeric_limits<size_t>::max();
+  TreeType serialTree(dataset);
+  TreeType::ParallelBuildThreshold() = 50;
+  TreeType parallelTree(dataset);
+  TreeType::ParallelBuildThreshold() = oldThreshold;
+
+  REQUIRE(serialTree.DistanceComps() == parallelTree.DistanceComps());
+  CheckSameCoverTree(serialTree, parallelTree);
+}
+
 /**
  * Make sure copy constructor works right for the binary space tree.
  */
@@ -2287,3 +2608,57 @@ TEST_CASE("CoverTreeDescendantTest", "[TreeTest]")
   // using the recursive function above.
   CheckDescendants(&tree);
 }
+
+/**
+ * Make sure that a cover tree stays valid while points are inserted into it
+ * and removed from it, including the root point.
+ */
+TEST_CASE("CoverTreeInsertDeletePointTest", "[TreeTest]")
+{
+  typedef StandardCoverTree<EuclideanDistance, EmptyStatistic, arma::mat>
+      TreeType;
+
+  arma::mat dataset = arma::randu<arma::mat>(3, 300);
+  // Add some duplicate points too.
+  dataset.cols(250, 299) = dataset.cols(0, 49);
+
+  TreeType tree(arma::mat(dataset.cols(0, 199)));
+  tree.Dataset().insert_cols(200, dataset.cols(200, 299));
+  for (size_t i = 200; i < 300; ++i)
+    tree.InsertPoint(i);
+
+  REQUIRE(tree.NumDescendants() == 300);
+  CheckSelfChild<TreeType>(tree);
+  CheckCovering<TreeType, LMetric<2, true>>(tree);
+  CheckDescendants(&tree);
+
+  // Remove the root point first, then every third point.
+  const size_t root = tree.Point();
+  REQUIRE(tree.DeletePoint(root));
+  REQUIRE(!tree.DeletePoint(root));
+  size_t held = 299;
+  for (size_t i = 0; i < 300; i += 3)
+  {
+    if (i != root)
+    {
+      REQUIRE(tree.DeletePoint(i));
+      --held;
+    }
+  }
+
+  REQUIRE(tree.NumDescendants() == held);
+  REQUIRE(tree.Dataset().n_cols == 300);
+  CheckSelfChild<TreeType>(tree);
+  CheckCovering<TreeType, LMetric<2, true>>(tree);
+  CheckDescendants(&tree);
+
+  arma::vec counts;
+  counts.zeros(300);
+  RecurseTreeCountLeaves(tree, counts);
+  for (size_t i = 0; i < 300; ++i)
+    REQUIRE(counts[i] == ((i % 3 == 0 || i == root) ? 0 : 1));
+
+  // The last point of a tree can't be removed.
+  TreeType single(arma::mat(dataset.cols(0, 0)));
+  REQUIRE(!single.DeletePoint(0));
+}
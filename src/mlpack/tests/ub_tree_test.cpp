@@ -47,6 +47,50 @@ TEST_CASE("AddressTest", "[UBTreeTest]")
   }
 }
 
+/**
+ * Make sure that addresses are one-to-one and keep the ordering of the points
+ * when the bits of a coordinate don't fall on the boundaries of the address
+ * elements.
+ */
+template<typename ElemType>
+void CheckAddresses(const size_t dimensionality)
+{
+  typedef typename std::conditional<sizeof(ElemType) * CHAR_BIT <= 32,
+                                    uint32_t,
+                                    uint64_t>::type AddressElemType;
+  arma::Mat<ElemType> dataset(dimensionality, 200, arma::fill::randu);
+  dataset -= 0.5;
+  arma::Col<AddressElemType> address(dataset.n_rows);
+  arma::Col<AddressElemType> lastAddress(dataset.n_rows);
+  arma::Col<ElemType> point(dataset.n_rows);
+
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+  {
+    addr::PointToAddress(address, dataset.col(i));
+    addr::AddressToPoint(point, address);
+
+    for (size_t k = 0; k < dataset.n_rows; ++k)
+      REQUIRE(dataset(k, i) == Approx(point[k]).epsilon(1e-6));
+
+    // The first coordinate gives the highest bit of the address.
+    if (i > 0 && (dataset(0, i) < 0) != (dataset(0, i - 1) < 0))
+    {
+      REQUIRE(addr::CompareAddresses(address, lastAddress) ==
+          ((dataset(0, i) < 0) ? -1 : 1));
+    }
+    lastAddress = address;
+  }
+}
+
+TEST_CASE("AddressDimensionalityTest", "[UBTreeTest]")
+{
+  for (size_t d = 1; d <= 7; d += 2)
+  {
+    CheckAddresses<double>(d);
+    CheckAddresses<float>(d);
+  }
+}
+
 template<typename TreeType>
 void CheckSplit(const TreeType& tree)
 {
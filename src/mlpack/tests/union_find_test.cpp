@@ -10,6 +10,7 @@
  * http://www.opensource.org/licenses/BSD-3-Clause for more information.
  */
 #include <mlpack/methods/emst/union_find.hpp>
+#include <mlpack/methods/emst/concurrent_union_find.hpp>
 
 #include <mlpack/core.hpp>
 #include <boost/test/unit_test.hpp>
@@ -51,4 +52,67 @@ BOOST_AUTO_TEST_CASE(TestUnion)
   BOOST_REQUIRE(testUnionFind.Find(6) == testUnionFind.Find(3));
 }
 
+/**
+ * Make sure that the concurrent union-find gives the same components as the
+ * sequential one.
+ */
+BOOST_AUTO_TEST_CASE(TestConcurrentUnion)
+{
+  static const size_t testSize = 10;
+  ConcurrentUnionFind testUnionFind(testSize);
+
+  for (size_t i = 0; i < testSize; ++i)
+    BOOST_REQUIRE(testUnionFind.Find(i) == i);
+
+  testUnionFind.Union(0, 1);
+  testUnionFind.Union(2, 3);
+  testUnionFind.Union(0, 2);
+  testUnionFind.Union(5, 0);
+  testUnionFind.Union(0, 6);
+
+  BOOST_REQUIRE(testUnionFind.Find(0) == testUnionFind.Find(1));
+  BOOST_REQUIRE(testUnionFind.Find(2) == testUnionFind.Find(3));
+  BOOST_REQUIRE(testUnionFind.Find(1) == testUnionFind.Find(5));
+  BOOST_REQUIRE(testUnionFind.Find(6) == testUnionFind.Find(3));
+  BOOST_REQUIRE(testUnionFind.Find(4) != testUnionFind.Find(0));
+}
+
+/**
+ * Merge many random pairs from several threads at once, and check the
+ * components against the sequential union-find.
+ */
+BOOST_AUTO_TEST_CASE(TestConcurrentUnionThreads)
+{
+  static const size_t testSize = 10000;
+  arma::Mat<size_t> pairs = arma::randi<arma::Mat<size_t>>(2, 8000,
+      arma::distr_param(0, testSize - 1));
+
+  UnionFind sequential(testSize);
+  for (size_t i = 0; i < pairs.n_cols; ++i)
+    sequential.Union(pairs(0, i), pairs(1, i));
+
+  ConcurrentUnionFind concurrent(testSize);
+  #pragma omp parallel for num_threads(4)
+  for (omp_size_t i = 0; i < (omp_size_t) pairs.n_cols; ++i)
+    concurrent.Union(pairs(0, i), pairs(1, i));
+
+  // The roots may differ, but each sequential component must map to exactly
+  // one concurrent component, and the other way around.
+  std::map<size_t, size_t> sequentialToConcurrent, concurrentToSequential;
+  for (size_t i = 0; i < testSize; ++i)
+  {
+    const size_t sequentialRoot = sequential.Find(i);
+    const size_t concurrentRoot = concurrent.Find(i);
+    if (sequentialToConcurrent.count(sequentialRoot) == 0)
+      sequentialToConcurrent[sequentialRoot] = concurrentRoot;
+    if (concurrentToSequential.count(concurrentRoot) == 0)
+      concurrentToSequential[concurrentRoot] = sequentialRoot;
+
+    BOOST_REQUIRE_EQUAL(sequentialToConcurrent[sequentialRoot],
+        concurrentRoot);
+    BOOST_REQUIRE_EQUAL(concurrentToSequential[concurrentRoot],
+        sequentialRoot);
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END();